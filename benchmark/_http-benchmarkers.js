@@ -75,6 +75,51 @@ class WrkBenchmarker {
   }
 }
 
+/**
+ * The load generator in tools/http_loadgen, which is built along with node.
+ * Besides the throughput, it reports the percentiles of the latency.
+ */
+class HttpLoadgenBenchmarker {
+  constructor() {
+    this.name = 'http_loadgen';
+    this.executable = path.resolve(__dirname, '..', 'out', 'Release',
+                                   process.platform === 'win32' ?
+                                   'http_loadgen.exe' :
+                                   'http_loadgen');
+    this.present = fs.existsSync(this.executable);
+  }
+
+  create(options) {
+    const args = [
+      '-d', options.duration,
+      '-c', options.connections,
+      '-p', options.pipelining || 1,
+      `http://127.0.0.1:${options.port}${options.path}`
+    ];
+    const child = child_process.spawn(this.executable, args);
+    return child;
+  }
+
+  processResults(output) {
+    let result;
+    try {
+      result = JSON.parse(output);
+    } catch (err) {
+      return undefined;
+    }
+    if (!result || !isFinite(result.throughput)) {
+      return undefined;
+    } else {
+      return result.throughput;
+    }
+  }
+
+  // The 99th percentile of the latency in milliseconds.
+  processLatency(output) {
+    return JSON.parse(output).latency.p99;
+  }
+}
+
 /**
  * Simple, single-threaded benchmarker for testing if the benchmark
  * works
@@ -110,6 +155,7 @@ class TestDoubleBenchmarker {
 }
 
 const http_benchmarkers = [
+  new HttpLoadgenBenchmarker(),
   new WrkBenchmarker(),
   new AutocannonBenchmarker(),
   new TestDoubleBenchmarker()
@@ -177,7 +223,10 @@ exports.run = function(options, callback) {
       return;
     }
 
-    callback(null, code, options.benchmarker, result, elapsed);
+    const latency = benchmarker.processLatency ?
+                    benchmarker.processLatency(stdout) :
+                    undefined;
+    callback(null, code, options.benchmarker, result, elapsed, latency);
   });
 
 };
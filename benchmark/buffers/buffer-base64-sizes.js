@@ -0,0 +1,32 @@
+'use strict';
+const common = require('../common.js');
+
+const bench = common.createBenchmark(main, {
+  op: ['encode', 'decode', 'decode-url'],
+  len: [64, 1024, 64 * 1024, 8 * 1024 * 1024],
+  n: [1024 * 1024 * 1024]
+});
+
+function main(conf) {
+  const len = +conf.len;
+  // Keep the amount of data processed about the same across sizes.
+  const n = Math.max(1, Math.floor(+conf.n / len));
+  const data = Buffer.allocUnsafe(len);
+  for (var i = 0; i < len; i++) data[i] = i * 37;
+  var encoded = data.toString('base64');
+  if (conf.op === 'decode-url')
+    encoded = encoded.replace(/\+/g, '-').replace(/\//g, '_');
+  // eslint-disable-next-line no-unescaped-regexp-dot
+  encoded.match(/./);  // Flatten the string.
+  const out = Buffer.allocUnsafe(len);
+
+  if (conf.op === 'encode') {
+    bench.start();
+    for (i = 0; i < n; i++) data.toString('base64');
+    bench.end(n);
+  } else {
+    bench.start();
+    for (i = 0; i < n; i++) out.base64Write(encoded, 0, len);
+    bench.end(n);
+  }
+}
@@ -0,0 +1,41 @@
+'use strict';
+const common = require('../common.js');
+
+const bench = common.createBenchmark(main, {
+  method: ['compareMany', 'compare'],
+  keys: [16, 1024],
+  size: [8, 32, 256],
+  n: [1e4]
+});
+
+function main(conf) {
+  const n = +conf.n;
+  const size = +conf.size;
+  const keys = new Array(+conf.keys);
+  for (var i = 0; i < keys.length; i++) {
+    keys[i] = Buffer.alloc(size, 'a');
+    keys[i].writeUInt32BE(i, size - 4);
+  }
+  const key = Buffer.alloc(size, 'a');
+  const results = new Int8Array(keys.length);
+
+  var j;
+  switch (conf.method) {
+    case 'compareMany':
+      bench.start();
+      for (i = 0; i < n; i++)
+        Buffer.compareMany(key, keys, results);
+      bench.end(n);
+      break;
+    case 'compare':
+      bench.start();
+      for (i = 0; i < n; i++) {
+        for (j = 0; j < keys.length; j++)
+          results[j] = Buffer.compare(key, keys[j]);
+      }
+      bench.end(n);
+      break;
+    default:
+      throw new Error('Unexpected method');
+  }
+}
@@ -23,7 +23,7 @@
 var common = require('../common.js');
 
 var bench = common.createBenchmark(main, {
-  size: [16, 512, 1024, 4096, 16386],
+  size: [8, 16, 32, 512, 1024, 4096, 16386],
   millions: [1]
 });
 
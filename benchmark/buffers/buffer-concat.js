@@ -2,7 +2,7 @@
 const common = require('../common.js');
 
 const bench = common.createBenchmark(main, {
-  pieces: [1, 4, 16],
+  pieces: [1, 4, 16, 256],
   pieceSize: [1, 16, 256],
   withTotalLength: [0, 1],
   n: [1024]
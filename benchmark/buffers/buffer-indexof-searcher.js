@@ -0,0 +1,42 @@
+'use strict';
+const common = require('../common.js');
+const Searcher = require('buffer').Searcher;
+
+// Splitting a multipart body on its boundary, many small parts at a time.
+const bench = common.createBenchmark(main, {
+  method: ['indexOf', 'Searcher'],
+  boundary: ['\r\n', '\r\n--------------------------974767299852498929531610'],
+  partSize: [64, 1024, 64 * 1024],
+  n: [1e3]
+});
+
+function main(conf) {
+  const n = +conf.n;
+  const partSize = +conf.partSize;
+  const boundary = conf.boundary;
+  const part = Buffer.alloc(partSize, 'x-www-form-urlencoded data ');
+  const parts = [];
+  for (var i = 0; i < 100; i++)
+    parts.push(part, Buffer.from(boundary));
+  const body = Buffer.concat(parts);
+  const searcher = new Searcher(boundary);
+
+  var pos;
+  bench.start();
+  if (conf.method === 'Searcher') {
+    for (i = 0; i < n; i++) {
+      pos = 0;
+      while ((pos = searcher.indexOf(body, pos)) !== -1) {
+        pos += searcher.length;
+      }
+    }
+  } else {
+    for (i = 0; i < n; i++) {
+      pos = 0;
+      while ((pos = body.indexOf(boundary, pos)) !== -1) {
+        pos += boundary.length;
+      }
+    }
+  }
+  bench.end(n);
+}
@@ -27,12 +27,24 @@ function Benchmark(fn, configs, options) {
   this._time = [0, 0];
   // Used to make sure a benchmark only start a timer once
   this._started = false;
+  // The counters of the current run, see _startCounters()
+  this._counters = null;
+  // Whether the current run is a warmup, and what starts the next one, when
+  // running in process
+  this._warmup = false;
+  this._next = null;
 
-  // this._run will use fork() to create a new process for each configuration
-  // combination.
   if (process.env.hasOwnProperty('NODE_RUN_BENCHMARK_FN')) {
-    process.nextTick(() => fn(this.config));
+    process.nextTick(() => {
+      this._startCounters();
+      fn(this.config);
+    });
+  } else if (process.env.NODE_BENCHMARK_IN_PROCESS) {
+    // this._runInProcess will run all configurations in this process.
+    process.nextTick(() => this._runInProcess(fn));
   } else {
+    // this._run will use fork() to create a new process for each
+    // configuration combination.
     process.nextTick(() => this._run());
   }
 }
@@ -116,7 +128,7 @@ Benchmark.prototype.http = function(options, cb) {
                              self.extra_options.benchmarker ||
                              exports.default_http_benchmarker;
   http_benchmarkers.run(http_options, function(error, code, used_benchmarker,
-                                               result, elapsed) {
+                                               result, elapsed, latency) {
     if (cb) {
       cb(code);
     }
@@ -125,7 +137,7 @@ Benchmark.prototype.http = function(options, cb) {
       process.exit(code || 1);
     }
     self.config.benchmarker = used_benchmarker;
-    self.report(result, elapsed);
+    self.report(result, elapsed, latency);
   });
 };
 
@@ -175,11 +187,102 @@ Benchmark.prototype._run = function() {
   })(0);
 };
 
+// Runs the configurations one after the other in this process, each first
+// NODE_BENCHMARK_WARMUP times without reporting the result. This is for
+// benchmarks that leave nothing behind that would affect the next run, and
+// saves starting a process for every configuration. With --expose-gc, the
+// heap is collected before every run.
+Benchmark.prototype._runInProcess = function(fn) {
+  const self = this;
+  const warmup = +process.env.NODE_BENCHMARK_WARMUP || 0;
+  if (!Number.isInteger(warmup) || warmup < 0) {
+    console.error('bad NODE_BENCHMARK_WARMUP: ' +
+                  process.env.NODE_BENCHMARK_WARMUP);
+    process.exit(1);
+  }
+  if (process.send) {
+    process.send({
+      type: 'config',
+      name: this.name,
+      queueLength: this.queue.length
+    });
+  }
+
+  var queueIndex = 0;
+  var runs = 0;
+  this._next = function() {
+    if (++runs > warmup) {
+      runs = 0;
+      queueIndex++;
+    }
+    if (queueIndex < self.queue.length)
+      setImmediate(run);
+  };
+
+  function run() {
+    self.config = self.queue[queueIndex];
+    self._started = false;
+    self._warmup = runs < warmup;
+    if (typeof global.gc === 'function')
+      global.gc();
+    self._startCounters();
+    fn(self.config);
+  }
+  run();
+};
+
+// With NODE_BENCHMARK_COUNTERS, a run reports what it allocated on the heap,
+// the collections and the system resources that it took along with its rate.
+Benchmark.prototype._startCounters = function() {
+  if (!process.env.NODE_BENCHMARK_COUNTERS)
+    return;
+  const v8 = require('v8');
+  // Enough to not miss any collection between two reads in most cases; the
+  // counters say how many were missed.
+  v8.startGCTracking({ bufferSize: 16384 });
+  v8.readGCEvents();
+  this._counters = {
+    heapUsed: process.memoryUsage.heap().heapUsed,
+    resourceUsage: process.resourceUsage()
+  };
+};
+
+Benchmark.prototype._readCounters = function() {
+  const start = this._counters;
+  if (start === null)
+    return undefined;
+  const v8 = require('v8');
+  const heapUsed = process.memoryUsage.heap().heapUsed;
+  const resourceUsage = process.resourceUsage();
+  const gc = v8.readGCEvents();
+  // What the heap grew by, plus what collections took out of it.
+  var allocated = heapUsed - start.heapUsed;
+  var gcTime = 0;
+  for (const event of gc.events) {
+    allocated += event.usedHeapSizeBefore - event.usedHeapSizeAfter;
+    gcTime += event.duration;
+  }
+  const diff = (key) => resourceUsage[key] - start.resourceUsage[key];
+  return {
+    allocated,
+    gcCount: gc.events.length + gc.dropped,
+    gcDropped: gc.dropped,
+    gcTime,
+    voluntaryContextSwitches: diff('voluntaryContextSwitches'),
+    involuntaryContextSwitches: diff('involuntaryContextSwitches'),
+    fsRead: diff('fsRead'),
+    fsWrite: diff('fsWrite'),
+    minorPageFault: diff('minorPageFault'),
+    majorPageFault: diff('majorPageFault')
+  };
+};
+
 Benchmark.prototype.start = function() {
   if (this._started) {
     throw new Error('Called start more than once in a single benchmark');
   }
   this._started = true;
+  this._startCounters();
   this._time = process.hrtime();
 };
 
@@ -212,9 +315,24 @@ function formatResult(data) {
   var rate = data.rate.toString().split('.');
   rate[0] = rate[0].replace(/(\d)(?=(\d\d\d)+(?!\d))/g, '$1,');
   rate = (rate[1] ? rate.join('.') : rate[0]);
-  return `${data.name}${conf}: ${rate}`;
+  var result = `${data.name}${conf}: ${rate}`;
+  if (data.latency !== undefined)
+    result += ` (p99 ${data.latency} ms)`;
+  if (data.counters !== undefined)
+    result += ` (${formatCounters(data.counters)})`;
+  return result;
 }
 
+function formatCounters(counters) {
+  const contextSwitches = counters.voluntaryContextSwitches +
+                          counters.involuntaryContextSwitches;
+  return `allocated ${counters.allocated} bytes, ` +
+         `${counters.gcCount} gcs in ${counters.gcTime.toFixed(2)} ms, ` +
+         `${contextSwitches} context switches, ` +
+         `${counters.fsRead} fs reads, ${counters.fsWrite} fs writes`;
+}
+exports.formatCounters = formatCounters;
+
 function sendResult(data) {
   if (process.send) {
     // If forked, report by process send
@@ -226,12 +344,21 @@ function sendResult(data) {
 }
 exports.sendResult = sendResult;
 
-Benchmark.prototype.report = function(rate, elapsed) {
-  sendResult({
-    name: this.name,
-    conf: this.config,
-    rate: rate,
-    time: elapsed[0] + elapsed[1] / 1e9,
-    type: 'report'
-  });
+// `latency` is the 99th percentile of the latency in milliseconds, which
+// only some http benchmarkers measure.
+Benchmark.prototype.report = function(rate, elapsed, latency) {
+  const counters = this._readCounters();
+  if (!this._warmup) {
+    sendResult({
+      name: this.name,
+      conf: this.config,
+      rate: rate,
+      time: elapsed[0] + elapsed[1] / 1e9,
+      latency: latency,
+      counters: counters,
+      type: 'report'
+    });
+  }
+  if (this._next)
+    this._next();
 };
@@ -12,7 +12,8 @@ const cli = CLI(`usage: ./node compare.js [options] [--] <category> ...
   Run each benchmark in the <category> directory many times using two different
   node versions. More than one <category> directory can be specified.
   The output is formatted as csv, which can be processed using for
-  example 'compare.R'.
+  example 'compare.R'. The p99 column holds the 99th percentile of the
+  latency in ms for http benchmarks that measure it, and NA otherwise.
 
   --new      ./new-node-binary  new node binary (required)
   --old      ./old-node-binary  old node binary (required)
@@ -56,7 +57,7 @@ for (const filename of benchmarks) {
 // queue.length = binary.length * runs * benchmarks.length
 
 // Print csv header
-console.log('"binary", "filename", "configuration", "rate", "time"');
+console.log('"binary", "filename", "configuration", "rate", "time", "p99"');
 
 const kStartOfQueue = 0;
 
@@ -85,8 +86,9 @@ if (showProgress) {
       // Escape quotes (") for correct csv formatting
       conf = conf.replace(/"/g, '""');
 
+      const p99 = data.latency === undefined ? 'NA' : data.latency;
       console.log(`"${job.binary}", "${job.filename}", "${conf}", ` +
-                  `${data.rate}, ${data.time}`);
+                  `${data.rate}, ${data.time}, ${p99}`);
       if (showProgress) {
         // One item in the subqueue has been completed.
         progress.completeConfig(data);
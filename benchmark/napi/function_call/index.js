@@ -0,0 +1,50 @@
+// show the difference between calling a short js function
+// relative to a comparable C++ function, called through either the
+// V8 API directly or through N-API.
+// Reports millions of calls per second.
+'use strict';
+
+const assert = require('assert');
+const common = require('../../common.js');
+
+// this fails when we try to open with a different version of node,
+// which is quite common for benchmarks.  so in that case, just
+// abort quietly.
+
+try {
+  var binding = require('./build/Release/binding');
+} catch (er) {
+  console.error('napi/function_call/index.js Binding failed to load');
+  process.exit(0);
+}
+const cxx = binding.hello;
+
+var c = 0;
+function js() {
+  return c++;
+}
+
+assert(js() === cxx());
+
+const bench = common.createBenchmark(main, {
+  type: ['js', 'cxx', 'napi'],
+  millions: [1, 10, 50]
+}, { flags: ['--napi-modules'] });
+
+function main(conf) {
+  const n = +conf.millions * 1e6;
+
+  var fn = js;
+  if (conf.type === 'cxx') {
+    fn = cxx;
+  } else if (conf.type === 'napi') {
+    // N-API modules only load when --napi-modules is passed, which is only
+    // the case in the benchmark's child processes.
+    fn = require('./build/Release/napi_binding').hello;
+  }
+  bench.start();
+  for (var i = 0; i < n; i++) {
+    fn();
+  }
+  bench.end(+conf.millions);
+}
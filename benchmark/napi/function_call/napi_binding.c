@@ -0,0 +1,21 @@
+#include <node_api.h>
+
+static int32_t c = 0;
+
+static napi_value Hello(napi_env env, napi_callback_info info) {
+  napi_value result;
+  napi_status status = napi_create_number(env, c++, &result);
+  if (status != napi_ok) return NULL;
+  return result;
+}
+
+static void Init(napi_env env,
+                 napi_value exports,
+                 napi_value module,
+                 void* priv) {
+  napi_value fn;
+  if (napi_create_function(env, "hello", Hello, NULL, &fn) != napi_ok) return;
+  napi_set_named_property(env, exports, "hello", fn);
+}
+
+NAPI_MODULE(napi_binding, Init)
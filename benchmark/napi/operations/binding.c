@@ -0,0 +1,163 @@
+#include <node_api.h>
+#include <stdlib.h>
+
+// Each method runs the measured N-API operation `n` times in a native loop,
+// so that the JS-to-native transition is not part of the measurement.
+
+#define CHECK(the_call)                                                      \
+  do {                                                                       \
+    if ((the_call) != napi_ok) {                                             \
+      napi_throw_error(env, #the_call " failed");                            \
+      return NULL;                                                           \
+    }                                                                        \
+  } while (0)
+
+static napi_ref wrapped_constructor;
+
+static uint32_t GetCountAndTarget(napi_env env,
+                                  napi_callback_info info,
+                                  napi_value* target) {
+  size_t argc = 2;
+  napi_value argv[2];
+  uint32_t n = 0;
+  if (napi_get_cb_info(env, info, &argc, argv, NULL, NULL) != napi_ok ||
+      napi_get_value_uint32(env, argv[0], &n) != napi_ok) {
+    return 0;
+  }
+  if (target != NULL) {
+    *target = argv[1];
+  }
+  return n;
+}
+
+static napi_value GetNamedProperty(napi_env env, napi_callback_info info) {
+  napi_value target, value;
+  uint32_t i, n = GetCountAndTarget(env, info, &target);
+  for (i = 0; i < n; i++) {
+    napi_handle_scope scope;
+    CHECK(napi_open_handle_scope(env, &scope));
+    CHECK(napi_get_named_property(env, target, "x", &value));
+    CHECK(napi_close_handle_scope(env, scope));
+  }
+  return NULL;
+}
+
+static napi_value GetAtomProperty(napi_env env, napi_callback_info info) {
+  napi_value target, value;
+  napi_atom atom;
+  uint32_t i, n = GetCountAndTarget(env, info, &target);
+  CHECK(napi_create_atom(env, "x", (size_t)-1, &atom));
+  for (i = 0; i < n; i++) {
+    napi_handle_scope scope;
+    CHECK(napi_open_handle_scope(env, &scope));
+    CHECK(napi_get_atom_property(env, target, atom, &value));
+    CHECK(napi_close_handle_scope(env, scope));
+  }
+  return NULL;
+}
+
+static napi_value SetNamedProperty(napi_env env, napi_callback_info info) {
+  napi_value target, value;
+  uint32_t i, n = GetCountAndTarget(env, info, &target);
+  CHECK(napi_get_boolean(env, true, &value));
+  for (i = 0; i < n; i++) {
+    napi_handle_scope scope;
+    CHECK(napi_open_handle_scope(env, &scope));
+    CHECK(napi_set_named_property(env, target, "x", value));
+    CHECK(napi_close_handle_scope(env, scope));
+  }
+  return NULL;
+}
+
+static void FreeWrapped(napi_env env, void* data, void* hint) {
+  free(data);
+}
+
+static napi_value WrappedConstructor(napi_env env, napi_callback_info info) {
+  napi_value this_arg;
+  CHECK(napi_get_cb_info(env, info, NULL, NULL, &this_arg, NULL));
+  CHECK(napi_wrap(env, this_arg, malloc(sizeof(int)), FreeWrapped, NULL,
+                  NULL));
+  return this_arg;
+}
+
+static napi_value Wrap(napi_env env, napi_callback_info info) {
+  napi_value constructor, instance;
+  uint32_t i, n = GetCountAndTarget(env, info, NULL);
+  CHECK(napi_get_reference_value(env, wrapped_constructor, &constructor));
+  for (i = 0; i < n; i++) {
+    napi_handle_scope scope;
+    CHECK(napi_open_handle_scope(env, &scope));
+    CHECK(napi_new_instance(env, constructor, 0, NULL, &instance));
+    CHECK(napi_close_handle_scope(env, scope));
+  }
+  return NULL;
+}
+
+static napi_value Unwrap(napi_env env, napi_callback_info info) {
+  napi_value constructor, instance;
+  void* data;
+  uint32_t i, n = GetCountAndTarget(env, info, NULL);
+  CHECK(napi_get_reference_value(env, wrapped_constructor, &constructor));
+  CHECK(napi_new_instance(env, constructor, 0, NULL, &instance));
+  for (i = 0; i < n; i++) {
+    CHECK(napi_unwrap(env, instance, &data));
+  }
+  return NULL;
+}
+
+static napi_value Reference(napi_env env, napi_callback_info info) {
+  napi_value target;
+  napi_ref ref;
+  uint32_t i, n = GetCountAndTarget(env, info, &target);
+  for (i = 0; i < n; i++) {
+    CHECK(napi_create_reference(env, target, 1, &ref));
+    CHECK(napi_delete_reference(env, ref));
+  }
+  return NULL;
+}
+
+static napi_value CreateBuffer(napi_env env, napi_callback_info info) {
+  napi_value target, buffer;
+  uint32_t i, size, n = GetCountAndTarget(env, info, &target);
+  void* data;
+  CHECK(napi_get_value_uint32(env, target, &size));
+  for (i = 0; i < n; i++) {
+    napi_handle_scope scope;
+    CHECK(napi_open_handle_scope(env, &scope));
+    CHECK(napi_create_buffer(env, size, &data, &buffer));
+    CHECK(napi_close_handle_scope(env, scope));
+  }
+  return NULL;
+}
+
+#define DECLARE_METHOD(name, func)                                           \
+  { (name), 0, (func), 0, 0, 0, napi_default, 0 }
+
+static void Init(napi_env env,
+                 napi_value exports,
+                 napi_value module,
+                 void* priv) {
+  napi_value constructor;
+  napi_property_descriptor methods[] = {
+    DECLARE_METHOD("get_named_property", GetNamedProperty),
+    DECLARE_METHOD("get_atom_property", GetAtomProperty),
+    DECLARE_METHOD("set_named_property", SetNamedProperty),
+    DECLARE_METHOD("wrap", Wrap),
+    DECLARE_METHOD("unwrap", Unwrap),
+    DECLARE_METHOD("reference", Reference),
+    DECLARE_METHOD("create_buffer", CreateBuffer),
+  };
+
+  if (napi_define_class(env, "Wrapped", WrappedConstructor, NULL, 0, NULL,
+                        &constructor) != napi_ok ||
+      napi_create_reference(env, constructor, 1,
+                            &wrapped_constructor) != napi_ok) {
+    return;
+  }
+
+  napi_define_properties(env, exports,
+                         sizeof(methods) / sizeof(*methods), methods);
+}
+
+NAPI_MODULE(binding, Init)
@@ -0,0 +1,41 @@
+// Measures the cost of individual N-API operations. Each operation is
+// repeated in a native loop, so the results do not include the cost of
+// calling into the binding.
+// Reports millions of operations per second.
+'use strict';
+
+const common = require('../../common.js');
+
+const bench = common.createBenchmark(main, {
+  op: [
+    'get_named_property',
+    'get_atom_property',
+    'set_named_property',
+    'wrap',
+    'unwrap',
+    'reference',
+    'create_buffer'
+  ],
+  millions: [1, 10]
+}, { flags: ['--napi-modules'] });
+
+function main(conf) {
+  // This fails when we try to open with a different version of node,
+  // which is quite common for benchmarks. So in that case, just abort
+  // quietly.
+  var binding;
+  try {
+    binding = require('./build/Release/binding');
+  } catch (er) {
+    console.error('napi/operations/index.js Binding failed to load');
+    process.exit(0);
+  }
+
+  const n = +conf.millions * 1e6;
+  const fn = binding[conf.op];
+  const target = conf.op === 'create_buffer' ? 64 : { x: 1 };
+
+  bench.start();
+  fn(n, target);
+  bench.end(+conf.millions);
+}
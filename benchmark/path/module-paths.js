@@ -0,0 +1,64 @@
+'use strict';
+var common = require('../common.js');
+var path = require('path');
+
+// The calls that module resolution and fs make, on paths like theirs, most
+// of which are absolute and normalized already. Compare two builds with
+// benchmark/compare.js to see what a change to the path functions does.
+var bench = common.createBenchmark(main, {
+  op: ['resolve', 'resolve-request', 'join', 'normalize', 'relative'],
+  type: ['posix', 'win32'],
+  n: [1e6]
+});
+
+var paths = {
+  posix: [
+    '/home/user/app/node_modules/express/lib/router/index.js',
+    '/home/user/app/node_modules/express/lib/router/../utils.js',
+    '/home/user/app/lib',
+    '/home/user/app/node_modules/.bin/'
+  ],
+  win32: [
+    'C:\\Users\\user\\app\\node_modules\\express\\lib\\router\\index.js',
+    'C:\\Users\\user\\app\\node_modules\\express\\lib\\router\\..\\utils.js',
+    'C:\\Users\\user\\app\\lib',
+    'C:\\Users\\user\\app\\node_modules\\.bin\\'
+  ]
+};
+var requests = ['./utils', '../lib/view.js', 'node_modules', 'index.js'];
+
+function main(conf) {
+  var n = +conf.n;
+  var p = path[conf.type];
+  var dirs = paths[conf.type];
+  var fn;
+  switch (conf.op) {
+    case 'resolve':
+      fn = function(i) { return p.resolve(dirs[i & 3]); };
+      break;
+    case 'resolve-request':
+      fn = function(i) { return p.resolve(dirs[i & 3], requests[i & 3]); };
+      break;
+    case 'join':
+      fn = function(i) {
+        return p.join(dirs[i & 3], 'node_modules', requests[i & 3]);
+      };
+      break;
+    case 'normalize':
+      fn = function(i) { return p.normalize(dirs[i & 3]); };
+      break;
+    case 'relative':
+      fn = function(i) { return p.relative(dirs[i & 3], dirs[(i + 1) & 3]); };
+      break;
+    default:
+      throw new Error('Unexpected op');
+  }
+
+  for (var i = 0; i < n; i++)
+    fn(i);
+
+  bench.start();
+  for (i = 0; i < n; i++)
+    fn(i);
+  bench.end(n);
+}
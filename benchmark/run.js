@@ -3,6 +3,7 @@
 const path = require('path');
 const fork = require('child_process').fork;
 const CLI = require('./_cli.js');
+const formatCounters = require('./common.js').formatCounters;
 
 const cli = CLI(`usage: ./node run.js [options] [--] <category> ...
   Run each benchmark in the <category> directory a single time, more than one
@@ -30,8 +31,19 @@ if (!validFormats.includes(format)) {
   return;
 }
 
+// See NODE_BENCHMARK_COUNTERS in benchmark/common.js.
+const counterKeys = [
+  'allocated', 'gcCount', 'gcTime',
+  'voluntaryContextSwitches', 'involuntaryContextSwitches',
+  'fsRead', 'fsWrite', 'minorPageFault', 'majorPageFault'
+];
+const counters = !!process.env.NODE_BENCHMARK_COUNTERS;
+
 if (format === 'csv') {
-  console.log('"filename", "configuration", "rate", "time"');
+  var header = '"filename", "configuration", "rate", "time"';
+  if (counters)
+    header += counterKeys.map((key) => `, "${key}"`).join('');
+  console.log(header);
 }
 
 (function recursive(i) {
@@ -57,11 +69,16 @@ if (format === 'csv') {
     if (format === 'csv') {
       // Escape quotes (") for correct csv formatting
       conf = conf.replace(/"/g, '""');
-      console.log(`"${data.name}", "${conf}", ${data.rate}, ${data.time}`);
+      var line = `"${data.name}", "${conf}", ${data.rate}, ${data.time}`;
+      if (counters)
+        line += counterKeys.map((key) => `, ${data.counters[key]}`).join('');
+      console.log(line);
     } else {
       var rate = data.rate.toString().split('.');
       rate[0] = rate[0].replace(/(\d)(?=(\d\d\d)+(?!\d))/g, '$1,');
       rate = (rate[1] ? rate.join('.') : rate[0]);
+      if (data.counters !== undefined)
+        rate += ` (${formatCounters(data.counters)})`;
       console.log(`${data.name} ${conf}: ${rate}`);
     }
   });
@@ -24,8 +24,13 @@
 const net = require('net');
 const util = require('util');
 const EventEmitter = require('events');
+const Timer = process.binding('timer_wrap').Timer;
 const debug = util.debuglog('http');
 
+const kFreeSince = Symbol('freeSince');
+const kIdleQueue = Symbol('idleQueue');
+const kSweepTimer = Symbol('sweepTimer');
+
 // New Agent code.
 
 // The largest departure from the previous implementation is that
@@ -60,6 +65,10 @@ function Agent(options) {
   self.keepAlive = self.options.keepAlive || false;
   self.maxSockets = self.options.maxSockets || Agent.defaultMaxSockets;
   self.maxFreeSockets = self.options.maxFreeSockets || 256;
+  self.freeSocketTimeout = self.options.freeSocketTimeout || 0;
+  self.poolStats = { hits: 0, misses: 0, expired: 0 };
+  self[kIdleQueue] = [];
+  self[kSweepTimer] = null;
 
   self.on('free', function(socket, options) {
     var name = self.getName(options);
@@ -96,6 +105,8 @@ function Agent(options) {
           socket._httpMessage = null;
           self.removeSocket(socket, options);
           freeSockets.push(socket);
+          if (self.freeSocketTimeout > 0)
+            trackIdleSocket(self, socket, name);
         }
       } else {
         socket.destroy();
@@ -106,6 +117,57 @@ function Agent(options) {
 
 util.inherits(Agent, EventEmitter);
 
+// Free sockets are reused last in, first out, so the ones that stay in the
+// pool are the ones that have been idle the longest. Instead of a timer per
+// socket, every agent keeps a single queue of the sockets in the order they
+// became free, and a single timer for the oldest of them.
+function trackIdleSocket(agent, socket, name) {
+  const since = Timer.now();
+  socket[kFreeSince] = since;
+  agent[kIdleQueue].push({ socket, name, since });
+  if (agent[kSweepTimer] === null)
+    scheduleSweep(agent, agent.freeSocketTimeout);
+}
+
+function scheduleSweep(agent, delay) {
+  agent[kSweepTimer] = setTimeout(sweepIdleSockets, delay, agent);
+  agent[kSweepTimer].unref();
+}
+
+function sweepIdleSockets(agent) {
+  agent[kSweepTimer] = null;
+  const queue = agent[kIdleQueue];
+  const timeout = agent.freeSocketTimeout;
+  const now = Timer.now();
+  while (queue.length > 0) {
+    const entry = queue[0];
+    // Skip the entries of sockets that were reused or closed since.
+    if (timeout > 0 && entry.socket[kFreeSince] === entry.since) {
+      const remaining = entry.since + timeout - now;
+      if (remaining > 0)
+        return scheduleSweep(agent, remaining);
+      expireIdleSocket(agent, entry.socket, entry.name);
+    }
+    queue.shift();
+  }
+}
+
+function expireIdleSocket(agent, socket, name) {
+  debug('expire free socket', name);
+  socket[kFreeSince] = undefined;
+  const freeSockets = agent.freeSockets[name];
+  // It is the oldest socket in its pool and therefore usually the first.
+  const index = freeSockets ? freeSockets.indexOf(socket) : -1;
+  if (index === -1)
+    return;
+  freeSockets.splice(index, 1);
+  // don't leak
+  if (freeSockets.length === 0)
+    delete agent.freeSockets[name];
+  agent.poolStats.expired++;
+  socket.destroy();
+}
+
 Agent.defaultMaxSockets = Infinity;
 
 Agent.prototype.createConnection = net.createConnection;
@@ -160,8 +222,10 @@ Agent.prototype.addRequest = function addRequest(req, options) {
   var sockLen = freeLen + this.sockets[name].length;
 
   if (freeLen) {
-    // we have a free socket, so use that.
-    var socket = this.freeSockets[name].shift();
+    // we have a free socket, so use the one that was used last.
+    var socket = this.freeSockets[name].pop();
+    socket[kFreeSince] = undefined;
+    this.poolStats.hits++;
     debug('have free socket');
 
     // don't leak
@@ -172,6 +236,7 @@ Agent.prototype.addRequest = function addRequest(req, options) {
     req.onSocket(socket);
     this.sockets[name].push(socket);
   } else if (sockLen < this.maxSockets) {
+    this.poolStats.misses++;
     debug('call onSocket', sockLen, freeLen);
     // If we are under maxSockets create a new one.
     this.createSocket(req, options, function(err, newSocket) {
@@ -184,6 +249,7 @@ Agent.prototype.addRequest = function addRequest(req, options) {
       req.onSocket(newSocket);
     });
   } else {
+    this.poolStats.misses++;
     debug('wait for socket');
     // We are over limit so we'll add it to the queue.
     if (!this.requests[name]) {
@@ -266,8 +332,11 @@ Agent.prototype.removeSocket = function removeSocket(s, options) {
   var sets = [this.sockets];
 
   // If the socket was destroyed, remove it from the free buffers too.
-  if (!s.writable)
+  if (!s.writable) {
     sets.push(this.freeSockets);
+    if (s[kFreeSince] !== undefined)
+      s[kFreeSince] = undefined;
+  }
 
   for (var sk = 0; sk < sets.length; sk++) {
     var sockets = sets[sk];
@@ -300,6 +369,11 @@ Agent.prototype.removeSocket = function removeSocket(s, options) {
 };
 
 Agent.prototype.destroy = function destroy() {
+  if (this[kSweepTimer] !== null) {
+    clearTimeout(this[kSweepTimer]);
+    this[kSweepTimer] = null;
+  }
+  this[kIdleQueue] = [];
   var sets = [this.freeSockets, this.sockets];
   for (var s = 0; s < sets.length; s++) {
     var set = sets[s];
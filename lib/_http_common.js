@@ -39,12 +39,10 @@ const kOnHeadersComplete = HTTPParser.kOnHeadersComplete | 0;
 const kOnBody = HTTPParser.kOnBody | 0;
 const kOnMessageComplete = HTTPParser.kOnMessageComplete | 0;
 const kOnExecute = HTTPParser.kOnExecute | 0;
+const kOnMessages = HTTPParser.kOnMessages | 0;
 
-// Only called in the slow case where slow means
-// that the request headers were either fragmented
-// across multiple TCP packets or too large to be
-// processed in a single run. This method is also
-// called to process trailing HTTP headers.
+// Only called to process trailing HTTP headers. The headers of a message
+// are all passed to parserOnHeadersComplete(), however many there are.
 function parserOnHeaders(headers, url) {
   // Once we exceeded headers limit - stop collecting them
   if (this.maxHeaderPairs <= 0 ||
@@ -165,6 +163,41 @@ function parserOnMessageComplete() {
 }
 
 
+// Called with the arguments of parserOnHeadersComplete() for a run of
+// pipelined requests without a body, one after the other, and with how many
+// of those arguments belong to requests that are complete. Only the last
+// request may not be; it ends in a later call to execute(). The socket is
+// corked until the next tick, so that responses written right away go out
+// together.
+function parserOnMessages(messages, complete) {
+  var parser = this;
+  var socket = parser.socket;
+
+  if (socket) {
+    socket.cork();
+    process.nextTick(socketUncorkNT, socket);
+  }
+  for (var i = 0; i < messages.length; i += 9) {
+    parserOnHeadersComplete.call(parser,
+                                 messages[i],
+                                 messages[i + 1],
+                                 messages[i + 2],
+                                 messages[i + 3],
+                                 messages[i + 4],
+                                 messages[i + 5],
+                                 messages[i + 6],
+                                 messages[i + 7],
+                                 messages[i + 8]);
+    if (i < complete)
+      parserOnMessageComplete.call(parser);
+  }
+}
+
+function socketUncorkNT(socket) {
+  socket.uncork();
+}
+
+
 var parsers = new FreeList('parsers', 1000, function() {
   var parser = new HTTPParser(HTTPParser.REQUEST);
 
@@ -186,6 +219,7 @@ var parsers = new FreeList('parsers', 1000, function() {
   parser[kOnBody] = parserOnBody;
   parser[kOnMessageComplete] = parserOnMessageComplete;
   parser[kOnExecute] = null;
+  parser[kOnMessages] = parserOnMessages;
 
   return parser;
 });
@@ -24,6 +24,15 @@
 const util = require('util');
 const Stream = require('stream');
 
+const kHeaders = Symbol('kHeaders');
+const kHeadersCount = Symbol('kHeadersCount');
+const kTrailers = Symbol('kTrailers');
+const kTrailersCount = Symbol('kTrailersCount');
+const kTarget = Symbol('kTarget');
+
+const parseRequestTarget = process.binding('url').parseRequestTarget;
+const targetFields = new Int32Array(4);
+
 function readStart(socket) {
   if (socket && !socket._paused && socket.readable)
     socket.resume();
@@ -52,9 +61,11 @@ function IncomingMessage(socket) {
   this.httpVersionMinor = null;
   this.httpVersion = null;
   this.complete = false;
-  this.headers = {};
+  this[kHeaders] = null;
+  this[kHeadersCount] = 0;
   this.rawHeaders = [];
-  this.trailers = {};
+  this[kTrailers] = null;
+  this[kTrailersCount] = 0;
   this.rawTrailers = [];
 
   this.readable = true;
@@ -64,6 +75,7 @@ function IncomingMessage(socket) {
   // request (server) only
   this.url = '';
   this.method = null;
+  this[kTarget] = null;
 
   // response (client) only
   this.statusCode = null;
@@ -80,6 +92,85 @@ function IncomingMessage(socket) {
 util.inherits(IncomingMessage, Stream.Readable);
 
 
+// `headers` and `trailers` are made from rawHeaders and rawTrailers when they
+// are first looked at. Many requests are handled without that happening.
+Object.defineProperty(IncomingMessage.prototype, 'headers', {
+  configurable: true,
+  enumerable: true,
+  get: function() {
+    if (!this[kHeaders]) {
+      this[kHeaders] = {};
+      addHeaderLines(this, this.rawHeaders, this[kHeadersCount],
+                     this[kHeaders]);
+    }
+    return this[kHeaders];
+  },
+  set: function(val) {
+    this[kHeaders] = val;
+  }
+});
+
+Object.defineProperty(IncomingMessage.prototype, 'trailers', {
+  configurable: true,
+  enumerable: true,
+  get: function() {
+    if (!this[kTrailers]) {
+      this[kTrailers] = {};
+      addHeaderLines(this, this.rawTrailers, this[kTrailersCount],
+                     this[kTrailers]);
+    }
+    return this[kTrailers];
+  },
+  set: function(val) {
+    this[kTrailers] = val;
+  }
+});
+
+
+// `pathname` and `query` are split from `url` when they are first looked at,
+// and again after `url` has been changed.
+function getTarget(msg) {
+  var target = msg[kTarget];
+  var url = '' + msg.url;
+  if (target === null || target.url !== url) {
+    parseRequestTarget(url, targetFields);
+    target = msg[kTarget] = {
+      url: url,
+      pathname: null,
+      query: null
+    };
+    if (targetFields[0] !== -1) {
+      target.pathname = targetFields[0] === targetFields[1] ?
+        '/' : url.slice(targetFields[0], targetFields[1]);
+    }
+    if (targetFields[2] !== -1)
+      target.query = url.slice(targetFields[2], targetFields[3]);
+  }
+  return target;
+}
+
+function defineTargetProperty(name) {
+  Object.defineProperty(IncomingMessage.prototype, name, {
+    configurable: true,
+    enumerable: true,
+    get: function() {
+      return getTarget(this)[name];
+    },
+    set: function(val) {
+      Object.defineProperty(this, name, {
+        configurable: true,
+        enumerable: true,
+        writable: true,
+        value: val
+      });
+    }
+  });
+}
+
+defineTargetProperty('pathname');
+defineTargetProperty('query');
+
+
 IncomingMessage.prototype.setTimeout = function setTimeout(msecs, callback) {
   if (callback)
     this.on('timeout', callback);
@@ -121,15 +212,23 @@ function _addHeaderLines(headers, n) {
     var dest;
     if (this.complete) {
       this.rawTrailers = headers;
-      dest = this.trailers;
+      this[kTrailersCount] = n;
+      dest = this[kTrailers];
     } else {
       this.rawHeaders = headers;
-      dest = this.headers;
+      this[kHeadersCount] = n;
+      dest = this[kHeaders];
     }
 
-    for (var i = 0; i < n; i += 2) {
-      this._addHeaderLine(headers[i], headers[i + 1], dest);
-    }
+    // Otherwise the getter adds them when `headers` or `trailers` is used.
+    if (dest)
+      addHeaderLines(this, headers, n, dest);
+  }
+}
+
+function addHeaderLines(msg, headers, n, dest) {
+  for (var i = 0; i < n; i += 2) {
+    msg._addHeaderLine(headers[i], headers[i + 1], dest);
   }
 }
 
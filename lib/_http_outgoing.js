@@ -30,6 +30,7 @@ const Buffer = require('buffer').Buffer;
 const common = require('_http_common');
 const checkIsHttpToken = common._checkIsHttpToken;
 const checkInvalidHeaderChar = common._checkInvalidHeaderChar;
+const serializeHeaders = process.binding('http_parser').serializeHeaders;
 const outHeadersKey = require('internal/http').outHeadersKey;
 
 const CRLF = common.CRLF;
@@ -301,7 +302,7 @@ function _storeHeader(firstLine, headers) {
     expect: false,
     trailer: false,
     upgrade: false,
-    header: firstLine
+    headers: []
   };
 
   var field;
@@ -356,13 +357,18 @@ function _storeHeader(firstLine, headers) {
     }
   }
 
+  // Headers from the user other than those set with setHeader() still need
+  // to be validated.
+  var validated = headers === this[outHeadersKey] ?
+    0 : state.headers.length / 2;
+
   // Are we upgrading the connection?
   if (state.connUpgrade && state.upgrade)
     this.upgrading = true;
 
   // Date header
   if (this.sendDate && !state.date) {
-    state.header += 'Date: ' + utcDate() + CRLF;
+    state.headers.push('Date', utcDate());
   }
 
   // Force the connection to close when the response is a 204 No Content or
@@ -392,10 +398,10 @@ function _storeHeader(firstLine, headers) {
     var shouldSendKeepAlive = this.shouldKeepAlive &&
         (state.contLen || this.useChunkedEncodingByDefault || this.agent);
     if (shouldSendKeepAlive) {
-      state.header += 'Connection: keep-alive\r\n';
+      state.headers.push('Connection', 'keep-alive');
     } else {
       this._last = true;
-      state.header += 'Connection: close\r\n';
+      state.headers.push('Connection', 'close');
     }
   }
 
@@ -409,9 +415,9 @@ function _storeHeader(firstLine, headers) {
       if (!state.trailer &&
           !this._removedContLen &&
           typeof this._contentLength === 'number') {
-        state.header += 'Content-Length: ' + this._contentLength + CRLF;
+        state.headers.push('Content-Length', '' + this._contentLength);
       } else if (!this._removedTE) {
-        state.header += 'Transfer-Encoding: chunked\r\n';
+        state.headers.push('Transfer-Encoding', 'chunked');
         this.chunkedEncoding = true;
       } else {
         // We should only be able to get here if both Content-Length and
@@ -422,7 +428,11 @@ function _storeHeader(firstLine, headers) {
     }
   }
 
-  this._header = state.header + CRLF;
+  // The header block is put together in C++, in one go. Only when that fails,
+  // because a header is invalid or has characters above U+00FF, it is built
+  // here, which also throws the error for the first invalid header.
+  this._header = serializeHeaders(firstLine, state.headers, validated) ||
+                 buildHeader(firstLine, state.headers, validated);
   this._headerSent = false;
 
   // wait until the first body chunk, or close(), is sent to flush,
@@ -431,22 +441,39 @@ function _storeHeader(firstLine, headers) {
 }
 
 function storeHeader(self, state, key, value, validate) {
-  if (validate) {
-    if (typeof key !== 'string' || !key || !checkIsHttpToken(key)) {
-      throw new TypeError(
-        'Header name must be a valid HTTP Token ["' + key + '"]');
-    }
-    if (value === undefined) {
-      throw new Error('Header "%s" value must not be undefined', key);
-    } else if (checkInvalidHeaderChar(value)) {
-      debug('Header "%s" contains invalid characters', key);
-      throw new TypeError('The header content contains invalid characters');
-    }
-  }
-  state.header += key + ': ' + escapeHeaderValue(value) + CRLF;
+  // An undefined value that is to be validated is kept as is, so that
+  // buildHeader() can report it.
+  if (typeof value !== 'string' && (value !== undefined || !validate))
+    value = '' + value;
+  state.headers.push(key, value);
   matchHeader(self, state, key, value);
 }
 
+function checkStoredHeader(key, value) {
+  if (typeof key !== 'string' || !key || !checkIsHttpToken(key)) {
+    throw new TypeError(
+      'Header name must be a valid HTTP Token ["' + key + '"]');
+  }
+  if (value === undefined) {
+    throw new Error('Header "%s" value must not be undefined', key);
+  } else if (checkInvalidHeaderChar(value)) {
+    debug('Header "%s" contains invalid characters', key);
+    throw new TypeError('The header content contains invalid characters');
+  }
+}
+
+function buildHeader(firstLine, headers, validated) {
+  var header = firstLine;
+  for (var i = 0; i < headers.length; i += 2) {
+    var key = headers[i];
+    var value = headers[i + 1];
+    if (i < validated * 2)
+      checkStoredHeader(key, value);
+    header += key + ': ' + escapeHeaderValue(value) + CRLF;
+  }
+  return header + CRLF;
+}
+
 function matchConnValue(self, state, value) {
   var sawClose = false;
   var m = RE_CONN_VALUES.exec(value);
@@ -621,6 +648,20 @@ Object.defineProperty(OutgoingMessage.prototype, 'headersSent', {
 
 
 const crlf_buf = Buffer.from('\r\n');
+
+// The size lines of small chunks are made once, when they are first needed.
+const kMaxCachedChunkSize = 1024;
+const chunkSizeLines = [];
+
+function chunkSizeLine(len) {
+  if (len > kMaxCachedChunkSize)
+    return len.toString(16) + CRLF;
+  var line = chunkSizeLines[len];
+  if (line === undefined)
+    line = chunkSizeLines[len] = len.toString(16) + CRLF;
+  return line;
+}
+
 OutgoingMessage.prototype.write = function write(chunk, encoding, callback) {
   if (this.finished) {
     var err = new Error('write after end');
@@ -655,7 +696,7 @@ OutgoingMessage.prototype.write = function write(chunk, encoding, callback) {
         encoding !== 'base64' &&
         encoding !== 'latin1') {
       len = Buffer.byteLength(chunk, encoding);
-      chunk = len.toString(16) + CRLF + chunk + CRLF;
+      chunk = chunkSizeLine(len) + chunk + CRLF;
       ret = this._send(chunk, encoding, callback);
     } else {
       // buffer, or a non-toString-friendly encoding
@@ -669,8 +710,7 @@ OutgoingMessage.prototype.write = function write(chunk, encoding, callback) {
         process.nextTick(connectionCorkNT, this.connection);
       }
 
-      this._send(len.toString(16), 'latin1', null);
-      this._send(crlf_buf, null, null);
+      this._send(chunkSizeLine(len), 'latin1', null);
       this._send(chunk, encoding, null);
       ret = this._send(crlf_buf, null, callback);
     }
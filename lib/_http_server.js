@@ -35,6 +35,7 @@ const chunkExpression = common.chunkExpression;
 const httpSocketSetup = common.httpSocketSetup;
 const OutgoingMessage = require('_http_outgoing').OutgoingMessage;
 const { outHeadersKey, ondrain } = require('internal/http');
+const counters = require('internal/counters');
 
 const STATUS_CODES = {
   100: 'Continue',
@@ -124,6 +125,7 @@ ServerResponse.prototype._finish = function _finish() {
   DTRACE_HTTP_SERVER_RESPONSE(this.connection);
   LTTNG_HTTP_SERVER_RESPONSE(this.connection);
   COUNTER_HTTP_SERVER_RESPONSE();
+  counters.values[counters.kHttpServerResponses]++;
   OutgoingMessage.prototype._finish.call(this);
 };
 
@@ -343,13 +345,12 @@ function connectionListener(socket) {
   // Override on to unconsume on `data`, `readable` listeners
   socket.on = socketOnWrap;
 
-  // We only consume the socket if it has never been consumed before.
-  var external = socket._handle._externalStream;
-  if (!socket._handle._consumed && external) {
+  // Have the parser read straight from the socket's handle, whether it is
+  // TCP, a pipe, TLS or a JS stream. consume() refuses a handle that has been
+  // consumed before.
+  var external = socket._handle && socket._handle._externalStream;
+  if (external && parser.consume(external))
     parser._consumed = true;
-    socket._handle._consumed = true;
-    parser.consume(external);
-  }
   parser[kOnExecute] =
     onParserExecute.bind(undefined, this, socket, parser, state);
 
@@ -510,6 +511,11 @@ function resOnFinish(req, res, socket, state) {
   if (!req._consuming && !req._readableState.resumeScheduled)
     req._dump();
 
+  if (socket._httpMessage !== res) {
+    // resOnPrefinish() has passed the socket on already.
+    return;
+  }
+
   res.detachSocket(socket);
 
   if (res._last) {
@@ -523,6 +529,36 @@ function resOnFinish(req, res, socket, state) {
   }
 }
 
+// A response that has handed all of its data to a corked socket passes the
+// socket on to the next response right away, instead of when the data has
+// been written, so that the responses to a batch of pipelined requests go
+// out in one write.
+function resOnPrefinish(res, socket, state) {
+  if (res._last ||
+      socket._httpMessage !== res ||
+      !socket._writableState.corked) {
+    return;
+  }
+
+  res.detachSocket(socket);
+  var m = state.outgoing.shift();
+  if (m) {
+    m.assignSocket(socket);
+  }
+}
+
+// Looks for an Expect header in req.rawHeaders, so that req.headers is only
+// made for the requests that have one.
+function hasExpectHeader(req) {
+  var headers = req.rawHeaders;
+  for (var i = 0; i < headers.length; i += 2) {
+    var name = headers[i];
+    if (name.length === 6 && name.toLowerCase() === 'expect')
+      return true;
+  }
+  return false;
+}
+
 // The following callback is issued after the headers have been read on a
 // new message. In this callback we setup the response object and pass it
 // to the user.
@@ -550,6 +586,7 @@ function parserOnIncoming(server, socket, state, req, keepAlive) {
   DTRACE_HTTP_SERVER_REQUEST(req, socket);
   LTTNG_HTTP_SERVER_REQUEST(req, socket);
   COUNTER_HTTP_SERVER_REQUEST();
+  counters.values[counters.kHttpServerRequests]++;
 
   if (socket._httpMessage) {
     // There are already pending outgoing res, append.
@@ -561,8 +598,10 @@ function parserOnIncoming(server, socket, state, req, keepAlive) {
   // When we're finished writing the response, check if this is the last
   // response, if so destroy the socket.
   res.on('finish', resOnFinish.bind(undefined, req, res, socket, state));
+  res.on('prefinish', resOnPrefinish.bind(undefined, res, socket, state));
 
-  if (req.headers.expect !== undefined &&
+  if (hasExpectHeader(req) &&
+      req.headers.expect !== undefined &&
       (req.httpVersionMajor === 1 && req.httpVersionMinor === 1)) {
     if (continueExpression.test(req.headers.expect)) {
       res._expect_continue = true;
@@ -35,6 +35,7 @@ var StringDecoder;
 util.inherits(Readable, Stream);
 
 const kProxyEvents = ['error', 'close', 'destroy', 'pause', 'resume'];
+const emit = EE.prototype.emit;
 
 function prependListener(emitter, event, fn) {
   // Sadly this is not cacheable as some libraries bundle their own
@@ -142,6 +143,21 @@ function Readable(options) {
 Readable.prototype.push = function(chunk, encoding) {
   var state = this._readableState;
 
+  // Sockets and files mostly push Buffers into a flowing stream that has
+  // nothing buffered. Hand those straight to the 'data' listener and ask for
+  // the next chunk without going through readableAddChunk() and read(0).
+  if (state.flowing && state.length === 0 && !state.sync &&
+      !state.ended && !state.objectMode && state.decoder === null &&
+      chunk instanceof Buffer && chunk.length > 0) {
+    state.reading = false;
+    emitData(this, chunk);
+    if (!readMoreFlowing(this, state)) {
+      this.read(0);
+      maybeReadMore(this, state);
+    }
+    return needMoreData(state);
+  }
+
   if (!state.objectMode && typeof chunk === 'string') {
     encoding = encoding || state.defaultEncoding;
     if (encoding !== state.encoding) {
@@ -192,7 +208,7 @@ function readableAddChunk(stream, state, chunk, encoding, addToFront) {
       if (!skipAdd) {
         // if we want the data now, just emit it.
         if (state.flowing && state.length === 0 && !state.sync) {
-          stream.emit('data', chunk);
+          emitData(stream, chunk);
           stream.read(0);
         } else {
           // update the buffer info.
@@ -217,6 +233,28 @@ function readableAddChunk(stream, state, chunk, encoding, addToFront) {
 }
 
 
+// What read(0) does for a stream whose buffer is still empty after a chunk
+// went to the 'data' listener. Returns false if the listener changed the
+// state in a way that read(0) has to deal with. There is no maybeReadMore()
+// to schedule: _read() is in progress, or it pushed synchronously, and push()
+// scheduled one itself.
+function readMoreFlowing(stream, state) {
+  if (state.length !== 0 || state.ended || state.highWaterMark === 0 ||
+      stream.read !== Readable.prototype.read) {
+    return false;
+  }
+  if (!state.reading) {
+    state.reading = true;
+    state.sync = true;
+    state.needReadable = true;
+    stream._read(state.highWaterMark);
+    state.sync = false;
+  }
+  state.needReadable = true;
+  return true;
+}
+
+
 // if it's past the high water mark, we can push in some more.
 // Also, if we have no data yet, we can stand some
 // more bytes.  This is to work around cases where hwm=0,
@@ -397,11 +435,26 @@ Readable.prototype.read = function(n) {
   }
 
   if (ret !== null)
-    this.emit('data', ret);
+    emitData(this, ret);
 
   return ret;
 };
 
+// Every chunk of a flowing stream goes through here, and most streams have a
+// single 'data' listener. Call it directly unless emit() was overridden or
+// there is a domain to enter, which emit() takes care of.
+function emitData(stream, chunk) {
+  const events = stream._events;
+  const handler = events ? events.data : undefined;
+  if (typeof handler === 'function' &&
+      stream.emit === emit &&
+      !stream.domain) {
+    handler.call(stream, chunk);
+  } else {
+    stream.emit('data', chunk);
+  }
+}
+
 function chunkInvalid(state, chunk) {
   var er = null;
   if (!(chunk instanceof Buffer) &&
@@ -35,8 +35,8 @@ function StreamWrap(stream) {
   handle.onshutdown = function(req) {
     return self.doShutdown(req);
   };
-  handle.onwrite = function(req, bufs) {
-    return self.doWrite(req, bufs);
+  handle.onwrite = function(req, data) {
+    return self.doWrite(req, data);
   };
 
   this.stream.pause();
@@ -108,45 +108,35 @@ StreamWrap.prototype.doShutdown = function doShutdown(req) {
   return 0;
 };
 
-StreamWrap.prototype.doWrite = function doWrite(req, bufs) {
+// All of the data of a writev() comes as one Buffer.
+StreamWrap.prototype.doWrite = function doWrite(req, data) {
   const self = this;
   const handle = self._handle;
 
-  var pending = bufs.length;
-
   // Queue the request to be able to cancel it
   const item = self._enqueue('write', req);
 
-  self.stream.cork();
-  for (var n = 0; n < bufs.length; n++)
-    self.stream.write(bufs[n], done);
-  self.stream.uncork();
-
-  function done(err) {
-    if (!err && --pending !== 0)
+  self.stream.write(data, function done(err) {
+    // Do not invoke callback twice
+    if (!self._dequeue(item))
       return;
 
-    // Ensure that this is called once in case of error
-    pending = 0;
-
-    // Ensure that write was dispatched
-    setImmediate(function() {
-      // Do not invoke callback twice
-      if (!self._dequeue(item))
-        return;
-
-      var errCode = 0;
-      if (err) {
-        if (err.code && uv['UV_' + err.code])
-          errCode = uv['UV_' + err.code];
-        else
-          errCode = uv.UV_EPIPE;
-      }
+    var errCode = 0;
+    if (err) {
+      if (err.code && uv['UV_' + err.code])
+        errCode = uv['UV_' + err.code];
+      else
+        errCode = uv.UV_EPIPE;
+    }
 
-      handle.doAfterWrite(req);
-      handle.finishWrite(req, errCode);
-    });
-  }
+    // Only if the write has been dispatched, which it has not been if this
+    // is called from within onwrite.
+    if (!handle.afterWrite(req, errCode)) {
+      setImmediate(function() {
+        handle.afterWrite(req, errCode);
+      });
+    }
+  });
 
   return 0;
 };
@@ -21,6 +21,7 @@
 
 'use strict';
 
+const Buffer = require('buffer').Buffer;
 const tls = require('tls');
 
 const SSL_OP_CIPHER_SERVER_PREFERENCE =
@@ -55,6 +56,78 @@ function SecureContext(secureProtocol, secureOptions, context) {
 exports.SecureContext = SecureContext;
 
 
+function addCACerts(context, ca) {
+  if (Array.isArray(ca)) {
+    for (var i = 0; i < ca.length; i++)
+      context.addCACert(ca[i]);
+  } else {
+    context.addCACert(ca);
+  }
+}
+
+
+var nextCAStoreId = 0;
+
+// A set of CA certificates that any number of secure contexts can use as
+// their `ca` option, without parsing or keeping a copy of them each.
+function CAStore(ca) {
+  if (!(this instanceof CAStore))
+    return new CAStore(ca);
+
+  this.context = new NativeSecureContext();
+  this.context.init();
+  addCACerts(this.context, ca);
+  this._id = nextCAStoreId++;
+}
+
+// Identifies the store in the names of agent connection pools.
+CAStore.prototype.toString = function toString() {
+  return `[CAStore ${this._id}]`;
+};
+
+exports.CAStore = CAStore;
+
+exports.createCAStore = function createCAStore(ca) {
+  return new CAStore(ca);
+};
+
+
+function positiveInteger(value, name, defaultValue) {
+  if (value === undefined)
+    return defaultValue;
+  if (!Number.isSafeInteger(value) || value <= 0)
+    throw new TypeError(
+      `dynamicRecordSizing.${name} must be a positive integer`);
+  return value;
+}
+
+// Returns the record sizing parameters for the dynamicRecordSizing option, or
+// null when it is disabled. Connections start out writing records that fit in
+// a single TCP segment, so the peer can decrypt the first bytes of a response
+// without waiting for a full 16 KB record, and switch to full-size records
+// once `threshold` bytes have been written. They return to small records
+// after being idle for `idleTimeout` milliseconds.
+function normalizeRecordSizing(options) {
+  if (options === undefined || options === null || options === false)
+    return null;
+  if (options === true)
+    options = {};
+  else if (typeof options !== 'object')
+    throw new TypeError('dynamicRecordSizing must be a boolean or an object');
+
+  const sizing = {
+    recordSize: positiveInteger(options.recordSize, 'recordSize', 1369),
+    threshold: positiveInteger(options.threshold, 'threshold', 1024 * 1024),
+    idleTimeout: positiveInteger(options.idleTimeout, 'idleTimeout', 1000)
+  };
+  if (sizing.recordSize > 16384)
+    throw new RangeError(
+      'dynamicRecordSizing.recordSize must not exceed 16384');
+  return sizing;
+}
+exports.normalizeRecordSizing = normalizeRecordSizing;
+
+
 exports.createSecureContext = function createSecureContext(options, context) {
   if (!options) options = {};
 
@@ -69,14 +142,10 @@ exports.createSecureContext = function createSecureContext(options, context) {
 
   // NOTE: It's important to add CA before the cert to be able to load
   // cert's issuer in C++ code.
-  if (options.ca) {
-    if (Array.isArray(options.ca)) {
-      for (i = 0; i < options.ca.length; i++) {
-        c.context.addCACert(options.ca[i]);
-      }
-    } else {
-      c.context.addCACert(options.ca);
-    }
+  if (options.ca instanceof CAStore) {
+    c.context.useCertStore(options.ca.context);
+  } else if (options.ca) {
+    addCACerts(c.context, options.ca);
   } else {
     c.context.addRootCerts();
   }
@@ -162,6 +231,8 @@ exports.createSecureContext = function createSecureContext(options, context) {
     c.context.setFreeListLength(0);
   }
 
+  c.dynamicRecordSizing = normalizeRecordSizing(options.dynamicRecordSizing);
+
   return c;
 };
 
@@ -191,3 +262,34 @@ exports.translatePeerCertificate = function translatePeerCertificate(c) {
   }
   return c;
 };
+
+
+function copyCertificateValue(value) {
+  if (value === null || typeof value !== 'object')
+    return value;
+  if (value instanceof Buffer)
+    return Buffer.from(value);
+  if (Array.isArray(value))
+    return value.map(copyCertificateValue);
+  const copy = Object.create(Object.getPrototypeOf(value));
+  for (const key of Object.keys(value))
+    copy[key] = copyCertificateValue(value[key]);
+  return copy;
+}
+
+
+// Deep copies a translated certificate, and the chain of issuers it links
+// to, so that a cached certificate can be handed out more than once.
+exports.copyPeerCertificate = function copyPeerCertificate(c) {
+  const copy = {};
+  for (const key of Object.keys(c)) {
+    const value = c[key];
+    if (key !== 'issuerCertificate')
+      copy[key] = copyCertificateValue(value);
+    else if (value === c)
+      copy[key] = copy;
+    else
+      copy[key] = value && copyPeerCertificate(value);
+  }
+  return copy;
+};
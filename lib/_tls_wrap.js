@@ -456,6 +456,9 @@ TLSSocket.prototype._init = function(socket, wrap) {
       if (this.server.listenerCount('OCSPRequest') > 0)
         ssl.enableCertCb();
     }
+
+    if (options.asyncHandshake)
+      ssl.enableAsyncHandshake();
   } else {
     ssl.onhandshakestart = function() {};
     ssl.onhandshakedone = () => this._finishInit();
@@ -465,6 +468,9 @@ TLSSocket.prototype._init = function(socket, wrap) {
       ssl.setSession(options.session);
   }
 
+  if (ssl._secureContext.dynamicRecordSizing)
+    setRecordSizing(ssl, ssl._secureContext.dynamicRecordSizing);
+
   ssl.onerror = function(err) {
     if (self._writableState.errorEmitted)
       return;
@@ -576,6 +582,19 @@ TLSSocket.prototype.setMaxSendFragment = function setMaxSendFragment(size) {
   return this._handle.setMaxSendFragment(size) === 1;
 };
 
+function setRecordSizing(ssl, sizing) {
+  if (sizing)
+    ssl.setDynamicRecordSizing(sizing.recordSize,
+                               sizing.threshold,
+                               sizing.idleTimeout);
+  else
+    ssl.setDynamicRecordSizing(0, 0, 0);
+}
+
+TLSSocket.prototype.setDynamicRecordSizing = function(options) {
+  setRecordSizing(this._handle, common.normalizeRecordSizing(options));
+};
+
 TLSSocket.prototype.getTLSTicket = function getTLSTicket() {
   return this._handle.getTLSTicket();
 };
@@ -659,13 +678,34 @@ TLSSocket.prototype.setSession = function(session) {
   this._handle.setSession(session);
 };
 
+// Converted peer certificates are cached per secure context, by the
+// fingerprints of the certificates that they were converted from.
+const kMaxCachedPeerCertificates = 1024;
+
 TLSSocket.prototype.getPeerCertificate = function(detailed) {
-  if (this._handle) {
+  if (!this._handle)
+    return null;
+
+  const context = this._handle._secureContext;
+  const key = context && this._handle.getPeerCertificateKey(detailed === true);
+  if (!key) {
     return common.translatePeerCertificate(
         this._handle.getPeerCertificate(detailed));
   }
 
-  return null;
+  if (context._peerCertificates === undefined)
+    context._peerCertificates = new Map();
+  const cache = context._peerCertificates;
+  const cacheKey = detailed === true ? `detailed ${key}` : key;
+  var cert = cache.get(cacheKey);
+  if (cert === undefined) {
+    cert = common.translatePeerCertificate(
+        this._handle.getPeerCertificate(detailed));
+    if (cache.size >= kMaxCachedPeerCertificates)
+      cache.clear();
+    cache.set(cacheKey, cert);
+  }
+  return common.copyPeerCertificate(cert);
 };
 
 TLSSocket.prototype.getSession = function() {
@@ -807,7 +847,8 @@ function Server(options, listener) {
     secureOptions: self.secureOptions,
     honorCipherOrder: self.honorCipherOrder,
     crl: self.crl,
-    sessionIdContext: self.sessionIdContext
+    sessionIdContext: self.sessionIdContext,
+    dynamicRecordSizing: self.dynamicRecordSizing
   });
   this._sharedCreds = sharedCreds;
 
@@ -825,6 +866,17 @@ function Server(options, listener) {
     sharedCreds.context.setTicketKeys(self.ticketKeys);
   }
 
+  if (self.ticketKeyRotation !== undefined) {
+    if (!Number.isInteger(self.ticketKeyRotation) ||
+        self.ticketKeyRotation <= 0) {
+      throw new TypeError('ticketKeyRotation must be a positive integer');
+    }
+    if (!self.ticketKeySecret)
+      self.ticketKeySecret = require('crypto').randomBytes(32);
+    sharedCreds.context.enableTicketKeyRotation(self.ticketKeySecret,
+                                                self.ticketKeyRotation);
+  }
+
   // constructor call
   net.Server.call(this, function(raw_socket) {
     var socket = new TLSSocket(raw_socket, {
@@ -836,7 +888,8 @@ function Server(options, listener) {
       handshakeTimeout: timeout,
       NPNProtocols: self.NPNProtocols,
       ALPNProtocols: self.ALPNProtocols,
-      SNICallback: options.SNICallback || SNICallback
+      SNICallback: options.SNICallback || SNICallback,
+      asyncHandshake: self.asyncHandshake
     });
 
     socket.on('secure', function() {
@@ -892,14 +945,22 @@ exports.createServer = function(options, listener) {
 
 
 Server.prototype._getServerData = function() {
-  return {
+  var data = {
     ticketKeys: this.getTicketKeys().toString('hex')
   };
+  if (this.ticketKeyRotation !== undefined)
+    data.ticketKeySecret = Buffer.from(this.ticketKeySecret).toString('hex');
+  return data;
 };
 
 
 Server.prototype._setServerData = function(data) {
   this.setTicketKeys(Buffer.from(data.ticketKeys, 'hex'));
+  if (this.ticketKeyRotation !== undefined && data.ticketKeySecret) {
+    this.ticketKeySecret = Buffer.from(data.ticketKeySecret, 'hex');
+    this._sharedCreds.context.enableTicketKeyRotation(this.ticketKeySecret,
+                                                      this.ticketKeyRotation);
+  }
 };
 
 
@@ -916,6 +977,7 @@ Server.prototype.setTicketKeys = function setTicketKeys(keys) {
 Server.prototype.setOptions = function(options) {
   this.requestCert = options.requestCert === true;
   this.rejectUnauthorized = options.rejectUnauthorized !== false;
+  this.asyncHandshake = options.asyncHandshake === true;
 
   if (options.pfx) this.pfx = options.pfx;
   if (options.key) this.key = options.key;
@@ -928,8 +990,13 @@ Server.prototype.setOptions = function(options) {
   if (options.ecdhCurve !== undefined)
     this.ecdhCurve = options.ecdhCurve;
   if (options.dhparam) this.dhparam = options.dhparam;
+  if (options.dynamicRecordSizing !== undefined)
+    this.dynamicRecordSizing = options.dynamicRecordSizing;
   if (options.sessionTimeout) this.sessionTimeout = options.sessionTimeout;
   if (options.ticketKeys) this.ticketKeys = options.ticketKeys;
+  if (options.ticketKeyRotation !== undefined)
+    this.ticketKeyRotation = options.ticketKeyRotation;
+  if (options.ticketKeySecret) this.ticketKeySecret = options.ticketKeySecret;
   var secureOptions = options.secureOptions || 0;
   if (options.honorCipherOrder !== undefined)
     this.honorCipherOrder = !!options.honorCipherOrder;
@@ -52,19 +52,16 @@ binding.setupBufferJS(Buffer.prototype, bindingObj);
 
 // |binding.zeroFill| can be undefined when running inside an isolate where we
 // do not own the ArrayBuffer allocator.  Zero fill is always on in that case.
-const zeroFill = bindingObj.zeroFill || [0];
+const ownsAllocator = bindingObj.zeroFill !== undefined;
 
 function createUnsafeBuffer(size) {
   return new FastBuffer(createUnsafeArrayBuffer(size));
 }
 
 function createUnsafeArrayBuffer(size) {
-  zeroFill[0] = 0;
-  try {
+  if (!ownsAllocator)
     return new ArrayBuffer(size);
-  } finally {
-    zeroFill[0] = 1;
-  }
+  return binding.createUnsafeArrayBuffer(+size);
 }
 
 function createPool() {
@@ -223,9 +220,14 @@ function allocate(size) {
 function fromString(string, encoding) {
   var length;
   if (typeof encoding !== 'string' || encoding.length === 0) {
-    encoding = 'utf8';
     if (string.length === 0)
       return new FastBuffer();
+    // A UTF-16 code unit takes at most three bytes of UTF-8, so a string that
+    // fits into the pool that way is written there without measuring it.
+    const maxLength = string.length * 3;
+    if (maxLength < (Buffer.poolSize >>> 1))
+      return fromUtf8StringIntoPool(string, maxLength);
+    encoding = 'utf8';
     length = binding.byteLengthUtf8(string);
   } else {
     length = byteLength(string, encoding, true);
@@ -251,6 +253,17 @@ function fromString(string, encoding) {
   return b;
 }
 
+function fromUtf8StringIntoPool(string, maxLength) {
+  if (maxLength > (poolSize - poolOffset))
+    createPool();
+  const room = new FastBuffer(allocPool, poolOffset, maxLength);
+  const actual = room.utf8Write(string, 0, maxLength);
+  const b = new FastBuffer(allocPool, poolOffset, actual);
+  poolOffset += actual;
+  alignPool();
+  return b;
+}
+
 function fromArrayLike(obj) {
   const length = obj.length;
   const b = allocate(length);
@@ -329,6 +342,24 @@ Buffer.isBuffer = function isBuffer(b) {
 };
 
 
+// Buffers this short are compared in JS, which is quicker than the call
+// into C++ for them.
+const kInlineCompareLength = 32;
+
+function compareBuffers(a, b) {
+  const aLength = a.length;
+  const bLength = b.length;
+  const length = aLength < bLength ? aLength : bLength;
+  if (length > kInlineCompareLength)
+    return compare_(a, b);
+  for (var i = 0; i < length; i++) {
+    if (a[i] !== b[i])
+      return a[i] < b[i] ? -1 : 1;
+  }
+  return aLength < bLength ? -1 : aLength > bLength ? 1 : 0;
+}
+
+
 Buffer.compare = function compare(a, b) {
   if (!isUint8Array(a) || !isUint8Array(b)) {
     throw new TypeError('Arguments must be Buffers or Uint8Arrays');
@@ -338,7 +369,30 @@ Buffer.compare = function compare(a, b) {
     return 0;
   }
 
-  return binding.compare(a, b);
+  return compareBuffers(a, b);
+};
+
+
+Buffer.compareMany = function compareMany(buf, list, results) {
+  if (!isUint8Array(buf))
+    throw new TypeError('"buf" argument must be a Buffer or Uint8Array');
+  if (!Array.isArray(list)) {
+    throw new TypeError('"list" argument must be an Array of Buffer or ' +
+                        'Uint8Array instances');
+  }
+  if (results === undefined) {
+    results = new Int8Array(list.length);
+  } else if (!(results instanceof Int8Array)) {
+    throw new TypeError('"results" argument must be an Int8Array');
+  } else if (results.length < list.length) {
+    throw new RangeError('"results" argument must be at least as long ' +
+                         'as "list"');
+  }
+  if (!binding.compareMany(buf, list, results)) {
+    throw new TypeError('"list" argument must be an Array of Buffer or ' +
+                        'Uint8Array instances');
+  }
+  return results;
 };
 
 
@@ -368,14 +422,10 @@ Buffer.concat = function(list, length) {
   }
 
   var buffer = Buffer.allocUnsafe(length);
-  var pos = 0;
-  for (i = 0; i < list.length; i++) {
-    var buf = list[i];
-    if (!isUint8Array(buf))
-      throw new TypeError(kConcatErrMsg);
-    binding.copy(buf, buffer, pos);
-    pos += buf.length;
-  }
+  // Copies all of `list` in one call, instead of one call per element.
+  var pos = binding.concat(list, buffer);
+  if (pos === -1)
+    throw new TypeError(kConcatErrMsg);
 
   // Note: `length` is always equal to `buffer.length` at this point
   if (pos < length) {
@@ -574,7 +624,10 @@ Buffer.prototype.equals = function equals(b) {
   if (this === b)
     return true;
 
-  return binding.compare(this, b) === 0;
+  if (this.length !== b.length)
+    return false;
+
+  return compareBuffers(this, b) === 0;
 };
 
 
@@ -597,7 +650,7 @@ Buffer.prototype.compare = function compare(target,
   if (!isUint8Array(target))
     throw new TypeError('Argument must be a Buffer or Uint8Array');
   if (arguments.length === 1)
-    return compare_(this, target);
+    return compareBuffers(this, target);
 
   if (start === undefined)
     start = 0;
@@ -726,6 +779,321 @@ Buffer.prototype.includes = function includes(val, byteOffset, encoding) {
 };
 
 
+// Searches many buffers for the same value, which is converted to bytes
+// and checked once up front. The native searcher keeps the shift tables it
+// builds between searches.
+class Searcher {
+  constructor(value, encoding) {
+    if (typeof value === 'string') {
+      if (encoding !== undefined && !Buffer.isEncoding(encoding))
+        throw new TypeError('"encoding" must be a valid string encoding');
+      value = Buffer.from(value, encoding);
+    } else if (!isUint8Array(value)) {
+      throw new TypeError('"value" argument must be string, Buffer or ' +
+                          'Uint8Array');
+    }
+    if (value.length === 0)
+      throw new RangeError('"value" argument must not be empty');
+    this._length = value.length;
+    // UTF-16 matches have to start on a character boundary. The native
+    // searcher copies `value`, so later changes to it don't change what's
+    // searched for.
+    this._handle = new binding.Searcher(
+        value, internalUtil.normalizeEncoding(encoding) === 'utf16le');
+  }
+
+  get length() {
+    return this._length;
+  }
+
+  indexOf(buffer, byteOffset) {
+    return this._handle.indexOf(buffer, searchOffset(buffer, byteOffset, true),
+                                true);
+  }
+
+  lastIndexOf(buffer, byteOffset) {
+    return this._handle.indexOf(buffer, searchOffset(buffer, byteOffset, false),
+                                false);
+  }
+
+  includes(buffer, byteOffset) {
+    return this.indexOf(buffer, byteOffset) !== -1;
+  }
+
+  // Like String.prototype.split(), the parts between matches, at most
+  // `limit` of them. The parts share memory with `buffer`.
+  split(buffer, limit) {
+    limit = limit === undefined ? 0xffffffff : limit >>> 0;
+    const parts = [];
+    if (limit === 0)
+      return parts;
+    const matches = this._handle.findAll(buffer, limit);
+    let start = 0;
+    for (var i = 0; i < matches.length; i++) {
+      parts.push(new FastBuffer(buffer.buffer, buffer.byteOffset + start,
+                                matches[i] - start));
+      start = matches[i] + this._length;
+    }
+    if (parts.length < limit) {
+      parts.push(new FastBuffer(buffer.buffer, buffer.byteOffset + start,
+                                buffer.length - start));
+    }
+    return parts;
+  }
+}
+
+// The byte offset argument of Searcher methods, handled the same way as by
+// buf.indexOf() and buf.lastIndexOf().
+function searchOffset(buffer, byteOffset, dir) {
+  if (byteOffset > 0x7fffffff) {
+    byteOffset = 0x7fffffff;
+  } else if (byteOffset < -0x80000000) {
+    byteOffset = -0x80000000;
+  }
+  byteOffset = +byteOffset;
+  if (byteOffset !== byteOffset) {
+    byteOffset = dir ? 0 : (buffer.length - 1);
+  }
+  return byteOffset;
+}
+exports.Searcher = Searcher;
+
+
+// A sequence of buffers that reads like one, for data that arrives in
+// chunks. Chunks are kept as they are instead of being concatenated, and
+// the ones that consume() is done with are let go of.
+class Rope {
+  constructor() {
+    this._chunks = [];
+    this._length = 0;
+    // The offset into the chunk that _locate() found last.
+    this._local = 0;
+  }
+
+  get length() {
+    return this._length;
+  }
+
+  append(chunk) {
+    if (!isUint8Array(chunk))
+      throw new TypeError('"chunk" argument must be a Buffer or Uint8Array');
+    if (chunk.length === 0)
+      return this;
+    if (!(chunk instanceof Buffer))
+      chunk = new FastBuffer(chunk.buffer, chunk.byteOffset, chunk.length);
+    this._chunks.push(chunk);
+    this._length += chunk.length;
+    return this;
+  }
+
+  consume(n) {
+    n = +n;
+    if (!(n > 0))
+      return this;
+    if (n >= this._length) {
+      this._chunks = [];
+      this._length = 0;
+      return this;
+    }
+    n = Math.floor(n);
+    const i = this._locate(n);
+    const chunks = this._chunks;
+    if (this._local > 0)
+      chunks[i] = chunks[i].slice(this._local);
+    chunks.splice(0, i);
+    this._length -= n;
+    return this;
+  }
+
+  // The bytes from `start` to `end`. A range within one chunk shares its
+  // memory, and any other one is copied.
+  slice(start, end) {
+    const length = this._length;
+    start = ropeOffset(start, 0, length);
+    end = ropeOffset(end, length, length);
+    if (start >= end)
+      return new FastBuffer();
+    const i = this._locate(start);
+    const chunk = this._chunks[i];
+    const local = this._local;
+    if (local + end - start <= chunk.length)
+      return chunk.slice(local, local + end - start);
+    const buf = allocate(end - start);
+    this._copy(buf, i, local, end - start);
+    return buf;
+  }
+
+  toString(encoding, start, end) {
+    return this.slice(start, end).toString(encoding);
+  }
+
+  indexOf(value, byteOffset, encoding) {
+    if (typeof byteOffset === 'string') {
+      encoding = byteOffset;
+      byteOffset = 0;
+    }
+    if (typeof value === 'string') {
+      if (encoding !== undefined && !Buffer.isEncoding(encoding))
+        throw new TypeError('"encoding" must be a valid string encoding');
+      value = Buffer.from(value, encoding);
+    } else if (typeof value === 'number') {
+      const byte = new FastBuffer(1);
+      byte[0] = value;
+      value = byte;
+    } else if (!isUint8Array(value)) {
+      throw new TypeError('"val" argument must be string, number, Buffer ' +
+                          'or Uint8Array');
+    }
+    const length = this._length;
+    let offset = ropeOffset(byteOffset, 0, length);
+    if (value.length === 0)
+      return offset;
+    if (offset >= length)
+      return -1;
+
+    const chunks = this._chunks;
+    const n = value.length;
+    var i = this._locate(offset);
+    for (var local = this._local; i < chunks.length; i++, local = 0) {
+      const chunk = chunks[i];
+      const base = offset - local;
+      let found = chunk.indexOf(value, local);
+      if (found !== -1)
+        return base + found;
+      // Matches that start in this chunk and end in a later one. Only the
+      // last n - 1 bytes of the chunk and the n - 1 after them are copied.
+      const end = base + chunk.length;
+      if (n > 1 && end < length) {
+        const from = Math.max(offset, end - n + 1);
+        found = this.slice(from, end + n - 1).indexOf(value);
+        if (found !== -1)
+          return from + found;
+      }
+      offset = end;
+    }
+    return -1;
+  }
+
+  includes(value, byteOffset, encoding) {
+    return this.indexOf(value, byteOffset, encoding) !== -1;
+  }
+
+  readUInt8(offset) {
+    return ropeRead(this, offset, 1, 'readUInt8');
+  }
+
+  readUInt16LE(offset) {
+    return ropeRead(this, offset, 2, 'readUInt16LE');
+  }
+
+  readUInt16BE(offset) {
+    return ropeRead(this, offset, 2, 'readUInt16BE');
+  }
+
+  readUInt32LE(offset) {
+    return ropeRead(this, offset, 4, 'readUInt32LE');
+  }
+
+  readUInt32BE(offset) {
+    return ropeRead(this, offset, 4, 'readUInt32BE');
+  }
+
+  readInt8(offset) {
+    return ropeRead(this, offset, 1, 'readInt8');
+  }
+
+  readInt16LE(offset) {
+    return ropeRead(this, offset, 2, 'readInt16LE');
+  }
+
+  readInt16BE(offset) {
+    return ropeRead(this, offset, 2, 'readInt16BE');
+  }
+
+  readInt32LE(offset) {
+    return ropeRead(this, offset, 4, 'readInt32LE');
+  }
+
+  readInt32BE(offset) {
+    return ropeRead(this, offset, 4, 'readInt32BE');
+  }
+
+  // The index of the chunk that holds byte `offset`, which has to be less
+  // than the length. The offset into that chunk is left in _local.
+  _locate(offset) {
+    const chunks = this._chunks;
+    var i = 0;
+    while (offset >= chunks[i].length)
+      offset -= chunks[i++].length;
+    this._local = offset;
+    return i;
+  }
+
+  // Copies `length` bytes to `target`, starting at `local` in chunk `i`.
+  _copy(target, i, local, length) {
+    const chunks = this._chunks;
+    var pos = 0;
+    while (pos < length) {
+      const chunk = chunks[i++];
+      const n = Math.min(chunk.length - local, length - pos);
+      binding.copy(chunk, target, pos, local, local + n);
+      pos += n;
+      local = 0;
+    }
+  }
+}
+
+// Room for a number that straddles chunks.
+const ropeScratch = new FastBuffer(4);
+
+function ropeRead(rope, offset, size, method) {
+  offset = offset >>> 0;
+  if (offset + size > rope._length)
+    throw new RangeError('Index out of range');
+  const i = rope._locate(offset);
+  const chunk = rope._chunks[i];
+  if (rope._local + size <= chunk.length)
+    return chunk[method](rope._local, true);
+  rope._copy(ropeScratch, i, rope._local, size);
+  return ropeScratch[method](0, true);
+}
+
+// An offset from the start, or from the end if it is negative, within
+// [0, length].
+function ropeOffset(offset, defaultValue, length) {
+  if (offset === undefined)
+    return defaultValue;
+  offset = Math.trunc(+offset) || 0;
+  if (offset < 0)
+    return Math.max(0, length + offset);
+  return Math.min(offset, length);
+}
+exports.Rope = Rope;
+
+
+// Decodes `buf` into a string that takes over its memory, when the encoding
+// is one that strings store as is. `buf` is detached then. Otherwise, this
+// is the same as buf.toString(encoding).
+function moveToString(buf, encoding) {
+  if (!isUint8Array(buf))
+    throw new TypeError('"buf" argument must be a Buffer or Uint8Array');
+  const normalizedEncoding = internalUtil.normalizeEncoding(encoding);
+  if (normalizedEncoding === undefined)
+    throw new TypeError('Unknown encoding: ' + encoding);
+
+  if (normalizedEncoding === 'latin1' ||
+      normalizedEncoding === 'ascii' ||
+      normalizedEncoding === 'utf16le') {
+    const string = binding.moveToString(buf, normalizedEncoding);
+    if (string !== undefined)
+      return string;
+  }
+  return new FastBuffer(buf.buffer, buf.byteOffset, buf.length)
+    .toString(normalizedEncoding);
+}
+exports.moveToString = moveToString;
+
+
 // Usage:
 //    buffer.fill(number[, offset[, end]])
 //    buffer.fill(buffer[, offset[, end]])
@@ -1437,4 +1805,5 @@ Buffer.prototype.toLocaleString = Buffer.prototype.toString;
 // dependency on Buffer.
 const internalBuffer = require('internal/buffer');
 exports.transcode = internalBuffer.transcode;
+exports.Transcoder = internalBuffer.Transcoder;
 internalBuffer.FastBuffer = FastBuffer;
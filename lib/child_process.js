@@ -98,12 +98,12 @@ exports.fork = function(modulePath /*, args, options*/) {
 };
 
 
-exports._forkChild = function(fd) {
+exports._forkChild = function(fd, serializationMode, batchHandles) {
   // set process.send()
   var p = new Pipe(true);
   p.open(fd);
   p.unref();
-  const control = setupChannel(process, p);
+  const control = setupChannel(process, p, serializationMode, batchHandles);
   process.on('newListener', function onNewListener(name) {
     if (name === 'message' || name === 'disconnect') control.ref();
   });
@@ -188,6 +188,7 @@ exports.execFile = function(file /*, args, options, callback*/) {
     gid: options.gid,
     uid: options.uid,
     shell: options.shell,
+    vfork: options.vfork,
     windowsVerbatimArguments: !!options.windowsVerbatimArguments
   });
 
@@ -378,6 +379,12 @@ function normalizeSpawnArguments(file, args, options) {
     throw new TypeError('"detached" must be a boolean');
   }
 
+  // Validate vfork, if present.
+  if (options.vfork != null &&
+      typeof options.vfork !== 'boolean') {
+    throw new TypeError('"vfork" must be a boolean');
+  }
+
   // Validate the uid, if present.
   if (options.uid != null && !Number.isInteger(options.uid)) {
     throw new TypeError('"uid" must be an integer');
@@ -466,10 +473,13 @@ var spawn = exports.spawn = function(/*file, args, options*/) {
     cwd: options.cwd,
     windowsVerbatimArguments: !!options.windowsVerbatimArguments,
     detached: !!options.detached,
+    vfork: !!options.vfork,
     envPairs: opts.envPairs,
     stdio: options.stdio,
     uid: options.uid,
-    gid: options.gid
+    gid: options.gid,
+    serialization: options.serialization,
+    batchHandles: options.batchHandles
   });
 
   return child;
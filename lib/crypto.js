@@ -32,6 +32,7 @@ exports.DEFAULT_ENCODING = 'buffer';
 const constants = process.binding('constants').crypto;
 const binding = process.binding('crypto');
 const randomBytes = binding.randomBytes;
+const kRandomPoolMaxRequest = binding.kRandomPoolMaxRequest;
 const getCiphers = binding.getCiphers;
 const getHashes = binding.getHashes;
 const getCurves = binding.getCurves;
@@ -124,6 +125,55 @@ Hmac.prototype._flush = Hash.prototype._flush;
 Hmac.prototype._transform = Hash.prototype._transform;
 
 
+function oneShotDigest(algorithm, key, data, outputEncoding, callback) {
+  outputEncoding = outputEncoding || exports.DEFAULT_ENCODING;
+  if (typeof callback !== 'function') {
+    return binding.oneShotDigest(algorithm, key, data, 'utf8',
+                                 `${outputEncoding}`);
+  }
+
+  // The threadpool reads the input in place, so it has to be a Buffer.
+  if (typeof data === 'string')
+    data = Buffer.from(data, 'utf8');
+  binding.oneShotDigest(algorithm, key, data, 'utf8', undefined,
+                        function(err, digest) {
+                          if (err)
+                            return callback(err);
+                          if (outputEncoding !== 'buffer')
+                            digest = digest.toString(outputEncoding);
+                          callback(null, digest);
+                        });
+}
+
+
+exports.hash = function hash(algorithm, data, outputEncoding, callback) {
+  if (typeof outputEncoding === 'function') {
+    callback = outputEncoding;
+    outputEncoding = undefined;
+  }
+  return oneShotDigest(algorithm, undefined, data, outputEncoding, callback);
+};
+
+
+exports.hmac = function hmac(algorithm, key, data, outputEncoding, callback) {
+  if (typeof outputEncoding === 'function') {
+    callback = outputEncoding;
+    outputEncoding = undefined;
+  }
+  return oneShotDigest(algorithm, toBuf(key), data, outputEncoding, callback);
+};
+
+
+exports.hashBatch = function hashBatch(algorithm, data) {
+  return binding.digestBatch(algorithm, undefined, data);
+};
+
+
+exports.hmacBatch = function hmacBatch(algorithm, key, data) {
+  return binding.digestBatch(algorithm, toBuf(key), data);
+};
+
+
 function getDecoder(decoder, encoding) {
   encoding = internalUtil.normalizeEncoding(encoding);
   decoder = decoder || new StringDecoder(encoding);
@@ -161,10 +211,26 @@ Cipher.prototype._flush = function _flush(callback) {
   callback();
 };
 
-Cipher.prototype.update = function update(data, inputEncoding, outputEncoding) {
+// Buffers at least this large are encrypted or decrypted on the threadpool
+// when update() is given a callback. Below it, the round trip costs more than
+// the cipher does.
+const kAsyncCipherThreshold = 64 * 1024;
+
+Cipher.prototype.update = function update(data, inputEncoding, outputEncoding,
+                                          callback) {
+  if (typeof inputEncoding === 'function') {
+    callback = inputEncoding;
+    inputEncoding = undefined;
+  } else if (typeof outputEncoding === 'function') {
+    callback = outputEncoding;
+    outputEncoding = undefined;
+  }
   inputEncoding = inputEncoding || exports.DEFAULT_ENCODING;
   outputEncoding = outputEncoding || exports.DEFAULT_ENCODING;
 
+  if (typeof callback === 'function')
+    return updateAsync(this, data, inputEncoding, outputEncoding, callback);
+
   var ret = this._handle.update(data, inputEncoding);
 
   if (outputEncoding && outputEncoding !== 'buffer') {
@@ -176,9 +242,57 @@ Cipher.prototype.update = function update(data, inputEncoding, outputEncoding) {
 };
 
 
-Cipher.prototype.final = function final(outputEncoding) {
+function updateAsync(self, data, inputEncoding, outputEncoding, callback) {
+  if (typeof data === 'string' || data.length < kAsyncCipherThreshold) {
+    var ret;
+    try {
+      ret = self.update(data, inputEncoding, outputEncoding);
+    } catch (err) {
+      process.nextTick(callback, err);
+      return;
+    }
+    process.nextTick(callback, null, ret);
+    return;
+  }
+
+  self._handle.updateAsync(data, function(err, ret) {
+    if (err)
+      return callback(err);
+    if (outputEncoding !== 'buffer') {
+      try {
+        self._decoder = getDecoder(self._decoder, outputEncoding);
+      } catch (err) {
+        return callback(err);
+      }
+      ret = self._decoder.write(ret);
+    }
+    callback(null, ret);
+  });
+}
+
+
+Cipher.prototype.final = function final(outputEncoding, callback) {
+  if (typeof outputEncoding === 'function') {
+    callback = outputEncoding;
+    outputEncoding = undefined;
+  }
   outputEncoding = outputEncoding || exports.DEFAULT_ENCODING;
-  var ret = this._handle.final();
+
+  var ret;
+  // At most one block is left to process, so this never needs the
+  // threadpool.
+  if (typeof callback === 'function') {
+    try {
+      ret = this.final(outputEncoding);
+    } catch (err) {
+      process.nextTick(callback, err);
+      return;
+    }
+    process.nextTick(callback, null, ret);
+    return;
+  }
+
+  ret = this._handle.final();
 
   if (outputEncoding && outputEncoding !== 'buffer') {
     this._decoder = getDecoder(this._decoder, outputEncoding);
@@ -281,6 +395,32 @@ Decipheriv.prototype.setAuthTag = Cipher.prototype.setAuthTag;
 Decipheriv.prototype.setAAD = Cipher.prototype.setAAD;
 
 
+exports.createAEAD = exports.AEAD = AEAD;
+function AEAD(algorithm, key, options) {
+  if (!(this instanceof AEAD))
+    return new AEAD(algorithm, key, options);
+
+  var authTagLength = 16;
+  if (options && options.authTagLength !== undefined)
+    authTagLength = options.authTagLength;
+  this._handle = new binding.AEAD();
+  this._handle.init(algorithm, toBuf(key), authTagLength);
+  this.authTagLength = authTagLength;
+}
+
+AEAD.prototype.seal = function seal(iv, data, aad) {
+  if (aad !== undefined)
+    aad = toBuf(aad);
+  return this._handle.seal(toBuf(iv), toBuf(data), aad);
+};
+
+AEAD.prototype.open = function open(iv, data, aad) {
+  if (aad !== undefined)
+    aad = toBuf(aad);
+  return this._handle.open(toBuf(iv), toBuf(data), aad);
+};
+
+
 exports.createSign = exports.Sign = Sign;
 function Sign(algorithm, options) {
   if (!(this instanceof Sign))
@@ -300,7 +440,12 @@ Sign.prototype._write = function _write(chunk, encoding, callback) {
 
 Sign.prototype.update = Hash.prototype.update;
 
-Sign.prototype.sign = function sign(options, encoding) {
+Sign.prototype.sign = function sign(options, encoding, callback) {
+  if (typeof encoding === 'function') {
+    callback = encoding;
+    encoding = undefined;
+  }
+
   if (!options)
     throw new Error('No key provided to sign');
 
@@ -326,10 +471,23 @@ Sign.prototype.sign = function sign(options, encoding) {
     }
   }
 
+  encoding = encoding || exports.DEFAULT_ENCODING;
+
+  if (typeof callback === 'function') {
+    this._handle.sign(toBuf(key), passphrase, rsaPadding, pssSaltLength,
+                      function(err, ret) {
+                        if (err)
+                          return callback(err);
+                        if (encoding && encoding !== 'buffer')
+                          ret = ret.toString(encoding);
+                        callback(null, ret);
+                      });
+    return;
+  }
+
   var ret = this._handle.sign(toBuf(key), passphrase, rsaPadding,
                               pssSaltLength);
 
-  encoding = encoding || exports.DEFAULT_ENCODING;
   if (encoding && encoding !== 'buffer')
     ret = ret.toString(encoding);
 
@@ -353,7 +511,13 @@ util.inherits(Verify, stream.Writable);
 Verify.prototype._write = Sign.prototype._write;
 Verify.prototype.update = Sign.prototype.update;
 
-Verify.prototype.verify = function verify(options, signature, sigEncoding) {
+Verify.prototype.verify = function verify(options, signature, sigEncoding,
+                                          callback) {
+  if (typeof sigEncoding === 'function') {
+    callback = sigEncoding;
+    sigEncoding = undefined;
+  }
+
   var key = options.key || options;
   sigEncoding = sigEncoding || exports.DEFAULT_ENCODING;
 
@@ -376,6 +540,12 @@ Verify.prototype.verify = function verify(options, signature, sigEncoding) {
     }
   }
 
+  if (typeof callback === 'function') {
+    this._handle.verify(toBuf(key), toBuf(signature, sigEncoding),
+                        rsaPadding, pssSaltLength, callback);
+    return;
+  }
+
   return this._handle.verify(toBuf(key), toBuf(signature, sigEncoding),
                              rsaPadding, pssSaltLength);
 };
@@ -450,6 +620,38 @@ function DiffieHellman(sizeOrKey, keyEncoding, generator, genEncoding) {
 }
 
 
+exports.generateDiffieHellman = function generateDiffieHellman(primeLength,
+                                                               generator,
+                                                               callback) {
+  if (typeof generator === 'function') {
+    callback = generator;
+    generator = undefined;
+  }
+
+  if (primeLength !== (primeLength | 0))
+    throw new TypeError('"primeLength" argument must be an integer');
+  if (generator === undefined)
+    generator = DH_GENERATOR;
+  else if (generator !== (generator | 0))
+    throw new TypeError('"generator" argument must be an integer');
+  if (typeof callback !== 'function')
+    throw new TypeError('"callback" argument must be a function');
+
+  const dh = Object.create(DiffieHellman.prototype);
+  dh._handle = new binding.DiffieHellman();
+  dh._handle.generateParameters(primeLength, generator, function(err) {
+    if (err)
+      return callback(err);
+    Object.defineProperty(dh, 'verifyError', {
+      enumerable: true,
+      value: dh._handle.verifyError,
+      writable: false
+    });
+    callback(null, dh);
+  });
+};
+
+
 exports.DiffieHellmanGroup =
     exports.createDiffieHellmanGroup =
     exports.getDiffieHellman = DiffieHellmanGroup;
@@ -470,9 +672,25 @@ DiffieHellmanGroup.prototype.generateKeys =
     DiffieHellman.prototype.generateKeys =
     dhGenerateKeys;
 
-function dhGenerateKeys(encoding) {
-  var keys = this._handle.generateKeys();
+function dhGenerateKeys(encoding, callback) {
+  if (typeof encoding === 'function') {
+    callback = encoding;
+    encoding = undefined;
+  }
   encoding = encoding || exports.DEFAULT_ENCODING;
+
+  if (typeof callback === 'function') {
+    this._handle.generateKeys(function(err, keys) {
+      if (err)
+        return callback(err);
+      if (encoding && encoding !== 'buffer')
+        keys = keys.toString(encoding);
+      callback(null, keys);
+    });
+    return;
+  }
+
+  var keys = this._handle.generateKeys();
   if (encoding && encoding !== 'buffer')
     keys = keys.toString(encoding);
   return keys;
@@ -575,7 +793,31 @@ ECDH.prototype.setPrivateKey = DiffieHellman.prototype.setPrivateKey;
 ECDH.prototype.setPublicKey = DiffieHellman.prototype.setPublicKey;
 ECDH.prototype.getPrivateKey = DiffieHellman.prototype.getPrivateKey;
 
-ECDH.prototype.generateKeys = function generateKeys(encoding, format) {
+ECDH.prototype.generateKeys = function generateKeys(encoding, format,
+                                                    callback) {
+  if (typeof encoding === 'function') {
+    callback = encoding;
+    encoding = undefined;
+  } else if (typeof format === 'function') {
+    callback = format;
+    format = undefined;
+  }
+
+  if (typeof callback === 'function') {
+    this._handle.generateKeys((err) => {
+      if (err)
+        return callback(err);
+      var key;
+      try {
+        key = this.getPublicKey(encoding, format);
+      } catch (err) {
+        return callback(err);
+      }
+      callback(null, key);
+    });
+    return;
+  }
+
   this._handle.generateKeys();
 
   return this.getPublicKey(encoding, format);
@@ -658,6 +900,65 @@ function pbkdf2(password, salt, iterations, keylen, digest, callback) {
 }
 
 
+const kScryptDefaults = { N: 16384, r: 8, p: 1, maxmem: 32 << 20 };
+
+exports.scrypt = function scrypt(password, salt, keylen, options, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = undefined;
+  }
+
+  if (typeof callback !== 'function')
+    throw new TypeError('"callback" argument must be a function');
+
+  return scryptImpl(password, salt, keylen, options, callback);
+};
+
+
+exports.scryptSync = function scryptSync(password, salt, keylen, options) {
+  return scryptImpl(password, salt, keylen, options);
+};
+
+
+function scryptImpl(password, salt, keylen, options, callback) {
+  password = toBuf(password);
+  salt = toBuf(salt);
+  if (!Buffer.isBuffer(password) && !ArrayBuffer.isView(password))
+    throw new TypeError('"password" must be a string or a buffer');
+  if (!Buffer.isBuffer(salt) && !ArrayBuffer.isView(salt))
+    throw new TypeError('"salt" must be a string or a buffer');
+  if (!Number.isInteger(keylen) || keylen < 0 || keylen > kMaxUint32)
+    throw new TypeError('"keylen" must be a non-negative integer');
+
+  const params = Object.assign({}, kScryptDefaults, options);
+  for (const name of ['N', 'r', 'p']) {
+    const value = params[name];
+    if (!Number.isSafeInteger(value) || value < 1 ||
+        (name !== 'N' && value > kMaxUint32)) {
+      throw new TypeError(`"${name}" must be a positive integer`);
+    }
+  }
+  if (!Number.isSafeInteger(params.maxmem) || params.maxmem < 0)
+    throw new TypeError('"maxmem" must be a non-negative integer');
+
+  const encoding = exports.DEFAULT_ENCODING;
+  if (callback && encoding !== 'buffer') {
+    const next = callback;
+    callback = (err, key) => next(err, key && key.toString(encoding));
+  }
+  const key = binding.scrypt(password, salt, keylen, params.N, params.r,
+                             params.p, params.maxmem, callback);
+  if (key !== undefined && encoding !== 'buffer')
+    return key.toString(encoding);
+  return key;
+}
+
+
+exports.getKdfPoolInfo = function getKdfPoolInfo() {
+  return binding.getKdfPoolInfo();
+};
+
+
 exports.Certificate = Certificate;
 
 function Certificate() {
@@ -738,6 +1039,12 @@ function randomFill(buf, offset, size, cb) {
 }
 exports.randomFill = randomFill;
 
+exports.getRandomPoolInfo = function getRandomPoolInfo() {
+  const info = binding.getRandomPoolInfo();
+  info.maxRequestSize = kRandomPoolMaxRequest;
+  return info;
+};
+
 function assertOffset(offset, length) {
   if (typeof offset !== 'number' || offset !== offset) {
     throw new TypeError('offset must be a number');
@@ -35,6 +35,13 @@ const BIND_STATE_UNBOUND = 0;
 const BIND_STATE_BINDING = 1;
 const BIND_STATE_BOUND = 2;
 
+const CONNECT_STATE_DISCONNECTED = 0;
+const CONNECT_STATE_CONNECTING = 1;
+const CONNECT_STATE_CONNECTED = 2;
+
+// Each datagram of a batch after the first needs a 64 KiB receive buffer.
+const MAX_RECV_BATCH_SIZE = 64;
+
 // lazily loaded
 var cluster = null;
 var dns = null;
@@ -72,6 +79,8 @@ function newHandle(type) {
     handle.lookup = lookup6;
     handle.bind = handle.bind6;
     handle.send = handle.send6;
+    handle.sendBatch = handle.sendBatch6;
+    handle.connect = handle.connect6;
     return handle;
   }
 
@@ -111,12 +120,25 @@ function Socket(type, listener) {
   this._handle = handle;
   this._receiving = false;
   this._bindState = BIND_STATE_UNBOUND;
+  this._connectState = CONNECT_STATE_DISCONNECTED;
+  this._remote = null;
   this.type = type;
   this.fd = null; // compatibility hack
 
   // If true - UV_UDP_REUSEADDR flag will be set
   this._reuseAddr = options && options.reuseAddr;
 
+  // How many datagrams are read and passed to 'message' listeners at once.
+  this._recvBatchSize = 0;
+  if (options && options.recvBatchSize !== undefined) {
+    const size = options.recvBatchSize;
+    if (!Number.isInteger(size) || size < 1 || size > MAX_RECV_BATCH_SIZE) {
+      throw new RangeError('"recvBatchSize" option must be an integer ' +
+                           `from 1 to ${MAX_RECV_BATCH_SIZE}`);
+    }
+    this._recvBatchSize = size;
+  }
+
   if (typeof listener === 'function')
     this.on('message', listener);
 }
@@ -130,8 +152,9 @@ function createSocket(type, listener) {
 
 function startListening(socket) {
   socket._handle.onmessage = onMessage;
+  socket._handle.onmessages = onMessages;
   // Todo: handle errors
-  socket._handle.recvStart();
+  socket._handle.recvStart(socket._recvBatchSize);
   socket._receiving = true;
   socket._bindState = BIND_STATE_BOUND;
   socket.fd = -42; // compatibility hack
@@ -145,6 +168,8 @@ function replaceHandle(self, newHandle) {
   newHandle.lookup = self._handle.lookup;
   newHandle.bind = self._handle.bind;
   newHandle.send = self._handle.send;
+  newHandle.sendBatch = self._handle.sendBatch;
+  newHandle.connect = self._handle.connect;
   newHandle.owner = self;
 
   // Replace the existing handle by the handle we got from master.
@@ -298,6 +323,26 @@ function fixBufferList(list) {
 }
 
 
+function toBufferList(buffer) {
+  let list;
+
+  if (!Array.isArray(buffer)) {
+    if (typeof buffer === 'string') {
+      list = [ Buffer.from(buffer) ];
+    } else if (!isUint8Array(buffer)) {
+      throw new TypeError('First argument must be a Buffer, ' +
+                          'Uint8Array or string');
+    } else {
+      list = [ buffer ];
+    }
+  } else if (!(list = fixBufferList(buffer))) {
+    throw new TypeError('Buffer list arguments must be buffers or strings');
+  }
+
+  return list;
+}
+
+
 function enqueue(self, toEnqueue) {
   // If the send queue hasn't been initialized yet, do it, and install an
   // event handler that flushes the send queue after binding is done.
@@ -349,7 +394,8 @@ Socket.prototype.send = function(buffer,
                                  port,
                                  address,
                                  callback) {
-  let list;
+  if (this._connectState !== CONNECT_STATE_DISCONNECTED)
+    return sendConnected(this, buffer, offset, length, port, address, callback);
 
   if (address || (port && typeof port !== 'function')) {
     buffer = sliceBuffer(buffer, offset, length);
@@ -359,18 +405,7 @@ Socket.prototype.send = function(buffer,
     address = length;
   }
 
-  if (!Array.isArray(buffer)) {
-    if (typeof buffer === 'string') {
-      list = [ Buffer.from(buffer) ];
-    } else if (!isUint8Array(buffer)) {
-      throw new TypeError('First argument must be a Buffer, ' +
-                          'Uint8Array or string');
-    } else {
-      list = [ buffer ];
-    }
-  } else if (!(list = fixBufferList(buffer))) {
-    throw new TypeError('Buffer list arguments must be buffers or strings');
-  }
+  const list = toBufferList(buffer);
 
   port = port >>> 0;
   if (port === 0 || port > 65535)
@@ -456,6 +491,256 @@ function afterSend(err, sent) {
   this.callback(err, sent);
 }
 
+Socket.prototype.connect = function(port, address, callback) {
+  port = port >>> 0;
+  if (port === 0 || port > 65535)
+    throw new RangeError('Port should be > 0 and < 65536');
+
+  if (typeof address === 'function') {
+    callback = address;
+    address = undefined;
+  } else if (address && typeof address !== 'string') {
+    throw new TypeError('Invalid arguments: address must be a nonempty ' +
+                        'string or falsy');
+  }
+
+  if (this._connectState !== CONNECT_STATE_DISCONNECTED)
+    throw new Error('Socket is already connected');
+
+  this._healthCheck();
+
+  if (typeof callback === 'function')
+    this.once('connect', callback);
+
+  this._connectState = CONNECT_STATE_CONNECTING;
+  this._connectQueue = [];
+
+  if (this._bindState === BIND_STATE_UNBOUND)
+    this.bind({port: 0, exclusive: true}, null);
+
+  if (this._bindState !== BIND_STATE_BOUND) {
+    enqueue(this, startConnect.bind(null, this, port, address));
+    return;
+  }
+
+  startConnect(this, port, address);
+};
+
+
+function startConnect(self, port, address) {
+  self._handle.lookup(address, (ex, ip) => {
+    doConnect(ex, self, ip, address, port);
+  });
+}
+
+
+function doConnect(ex, self, ip, address, port) {
+  if (!self._handle)
+    return;
+
+  if (!ex) {
+    const err = self._handle.connect(ip, port);
+    if (err)
+      ex = exceptionWithHostPort(err, 'connect', address, port);
+  }
+
+  const queue = self._connectQueue;
+  self._connectQueue = undefined;
+
+  if (ex) {
+    self._connectState = CONNECT_STATE_DISCONNECTED;
+    for (var i = 0; i < queue.length; i++)
+      queue[i](ex);
+    self.emit('error', ex);
+    return;
+  }
+
+  self._connectState = CONNECT_STATE_CONNECTED;
+  self._remote = {
+    address: ip,
+    family: self.type === 'udp6' ? 'IPv6' : 'IPv4',
+    port
+  };
+  for (var j = 0; j < queue.length; j++)
+    queue[j](null);
+
+  self.emit('connect');
+}
+
+
+Socket.prototype.remoteAddress = function() {
+  this._healthCheck();
+
+  if (this._connectState !== CONNECT_STATE_CONNECTED)
+    throw new Error('Socket is not connected');
+
+  return {
+    address: this._remote.address,
+    family: this._remote.family,
+    port: this._remote.port
+  };
+};
+
+
+// valid combinations once connect() is called
+// send(buffer, offset, length, callback)
+// send(buffer, offset, length)
+// send(bufferOrList, callback)
+// send(bufferOrList)
+function sendConnected(self, buffer, offset, length, port, address, callback) {
+  let extra;
+  if (typeof offset === 'number' && typeof length === 'number') {
+    buffer = sliceBuffer(buffer, offset, length);
+    callback = port;
+    extra = address;
+  } else {
+    callback = offset;
+    extra = length;
+  }
+
+  if ((callback !== undefined && typeof callback !== 'function') ||
+      extra !== undefined) {
+    throw new Error('Socket is connected, send() takes no port or address');
+  }
+
+  const list = toBufferList(buffer);
+
+  self._healthCheck();
+
+  if (list.length === 0)
+    list.push(Buffer.alloc(0));
+
+  if (self._connectState !== CONNECT_STATE_CONNECTED) {
+    self._connectQueue.push((ex) => {
+      if (!ex)
+        doSendConnected(self, list, callback);
+      else if (callback)
+        callback(ex);
+    });
+    return;
+  }
+
+  doSendConnected(self, list, callback);
+}
+
+
+function doSendConnected(self, list, callback) {
+  if (!self._handle)
+    return;
+
+  var req = new SendWrap();
+  req.list = list;  // Keep reference alive.
+  req.address = self._remote.address;
+  req.port = self._remote.port;
+  if (callback) {
+    req.callback = callback;
+    req.oncomplete = afterSend;
+  }
+  var err = self._handle.sendConnected(req, list, list.length, !!callback);
+  if (err) {
+    if (callback) {
+      const ex = exceptionWithHostPort(err, 'send', req.address, req.port);
+      process.nextTick(callback, ex);
+    }
+  } else if (req.async === false && callback) {
+    var sent = 0;
+    for (var i = 0; i < list.length; i++)
+      sent += list[i].length;
+    process.nextTick(callback, null, sent);
+  }
+}
+
+
+// sendBatch(messages, port, address, callback)
+// sendBatch(messages, port, address)
+// sendBatch(messages, port, callback)
+// sendBatch(messages, port)
+Socket.prototype.sendBatch = function(messages, port, address, callback) {
+  if (!Array.isArray(messages))
+    throw new TypeError('"messages" argument must be an array');
+
+  const list = fixBufferList(messages);
+  if (!list)
+    throw new TypeError('Messages must be buffers or strings');
+
+  port = port >>> 0;
+  if (port === 0 || port > 65535)
+    throw new RangeError('Port should be > 0 and < 65536');
+
+  if (typeof callback !== 'function')
+    callback = undefined;
+
+  if (typeof address === 'function') {
+    callback = address;
+    address = undefined;
+  } else if (address && typeof address !== 'string') {
+    throw new TypeError('Invalid arguments: address must be a nonempty ' +
+                        'string or falsy');
+  }
+
+  this._healthCheck();
+
+  if (this._bindState === BIND_STATE_UNBOUND)
+    this.bind({port: 0, exclusive: true}, null);
+
+  if (this._bindState !== BIND_STATE_BOUND) {
+    enqueue(this, this.sendBatch.bind(this, list, port, address, callback));
+    return;
+  }
+
+  const afterDns = (ex, ip) => {
+    doSendBatch(ex, this, ip, list, address, port, callback);
+  };
+
+  this._handle.lookup(address, afterDns);
+};
+
+
+function doSendBatch(ex, self, ip, list, address, port, callback) {
+  if (ex) {
+    if (typeof callback === 'function') {
+      callback(ex);
+      return;
+    }
+
+    self.emit('error', ex);
+    return;
+  } else if (!self._handle) {
+    return;
+  }
+
+  if (list.length === 0) {
+    if (callback)
+      process.nextTick(callback, null, 0);
+    return;
+  }
+
+  var req = new SendWrap();
+  req.list = list;  // Keep reference alive.
+  req.address = address;
+  req.port = port;
+  req.callback = callback;
+  req.oncomplete = afterSendBatch;
+  var err = self._handle.sendBatch(req, list, port, ip);
+  if (err) {
+    if (callback) {
+      const ex = exceptionWithHostPort(err, 'send', address, port);
+      process.nextTick(callback, ex);
+    }
+  } else if (req.async === false && callback) {
+    // Everything was sent right away.
+    var sent = 0;
+    for (var i = 0; i < list.length; i++)
+      sent += list[i].length;
+    process.nextTick(callback, null, sent);
+  }
+}
+
+function afterSendBatch(err, sent) {
+  if (this.callback)
+    afterSend.call(this, err, sent);
+}
+
 Socket.prototype.close = function(callback) {
   if (typeof callback === 'function')
     this.on('close', callback);
@@ -515,6 +800,21 @@ Socket.prototype.setTTL = function(arg) {
 };
 
 
+Socket.prototype.setSegmentSize = function(size) {
+  if (!Number.isInteger(size) || size < 0 || size > 65535)
+    throw new RangeError('Segment size must be an integer from 0 to 65535');
+
+  this._healthCheck();
+
+  var err = this._handle.setSegmentSize(size);
+  if (err) {
+    throw errnoException(err, 'setSegmentSize');
+  }
+
+  return size;
+};
+
+
 Socket.prototype.setMulticastTTL = function(arg) {
   if (typeof arg !== 'number') {
     throw new TypeError('Argument must be a number');
@@ -595,6 +895,22 @@ function onMessage(nread, handle, buf, rinfo) {
 }
 
 
+function onMessages(handle, buf, ends, rinfos) {
+  var self = handle.owner;
+  var start = 0;
+  for (var i = 0; i < ends.length; i++) {
+    // A listener may have closed the socket.
+    if (self._handle !== handle)
+      return;
+    var end = ends[i];
+    var rinfo = rinfos[i];
+    rinfo.size = end - start; // compatibility
+    self.emit('message', buf.slice(start, end), rinfo);
+    start = end;
+  }
+}
+
+
 Socket.prototype.ref = function() {
   if (this._handle)
     this._handle.ref();
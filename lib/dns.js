@@ -21,6 +21,7 @@
 
 'use strict';
 
+const os = require('os');
 const util = require('util');
 
 const cares = process.binding('cares_wrap');
@@ -30,6 +31,8 @@ const internalNet = require('internal/net');
 const GetAddrInfoReqWrap = cares.GetAddrInfoReqWrap;
 const GetNameInfoReqWrap = cares.GetNameInfoReqWrap;
 const QueryReqWrap = cares.QueryReqWrap;
+const ChannelWrap = cares.ChannelWrap;
+const TimerWrap = process.binding('timer_wrap').Timer;
 
 const isIP = cares.isIP;
 const isLegalPort = internalNet.isLegalPort;
@@ -89,6 +92,243 @@ function makeAsync(callback) {
 }
 
 
+// Results of lookup(), resolve4() and resolve6() by their query, when
+// setCache() turned caching on. A Map keeps insertion order, so the least
+// recently used entry is the first one.
+const queryCache = new Map();
+var cacheTtl = 0;
+var cacheStaleTtl = 0;
+var cacheMaxEntries = 1000;
+
+
+function CacheEntry(key) {
+  this.key = key;
+  this.result = null;
+  this.ttls = undefined;
+  this.received = 0;
+  this.expires = 0;
+  // The requests waiting for the query in flight, if there is one.
+  this.waiters = null;
+}
+
+
+function cachedTtls(entry, now) {
+  if (entry.ttls === undefined)
+    return undefined;
+  const elapsed = Math.floor((now - entry.received) / 1000);
+  return entry.ttls.map((ttl) => Math.max(ttl - elapsed, 0));
+}
+
+
+// Answers `req` from the cache entry for `key`, or with the query for it that
+// is in flight, or with a new query that `start(entry)` sends. Returns the
+// error code of `start` when there is nothing to answer with.
+function cachedQuery(key, req, start) {
+  const now = TimerWrap.now();
+  var entry = queryCache.get(key);
+  if (entry !== undefined) {
+    queryCache.delete(key);
+    queryCache.set(key, entry);
+    if (entry.result !== null && now < entry.expires + cacheStaleTtl) {
+      // Past its TTL, the entry is still used while it is queried again.
+      if (now >= entry.expires && entry.waiters === null) {
+        entry.waiters = [];
+        if (start(entry) !== 0)
+          entry.waiters = null;
+      }
+      req.oncomplete(null, entry.result.slice(), cachedTtls(entry, now));
+      return 0;
+    }
+  } else {
+    entry = new CacheEntry(key);
+    queryCache.set(key, entry);
+    if (queryCache.size > cacheMaxEntries)
+      queryCache.delete(queryCache.keys().next().value);
+  }
+
+  if (entry.waiters !== null) {
+    entry.waiters.push(req);
+    return 0;
+  }
+  // `start` can answer right away, from the hosts file for example.
+  entry.waiters = [req];
+  const err = start(entry);
+  if (err) {
+    entry.waiters = null;
+    if (entry.result === null)
+      queryCache.delete(key);
+  }
+  return err;
+}
+
+
+function settleQuery(entry, err, result, ttls, ttl) {
+  const now = TimerWrap.now();
+  const waiters = entry.waiters;
+  entry.waiters = null;
+  if (err) {
+    // Errors are not kept, a stale result is until it is too old.
+    if (now >= entry.expires + cacheStaleTtl &&
+        queryCache.get(entry.key) === entry) {
+      queryCache.delete(entry.key);
+    }
+  } else {
+    entry.result = result;
+    entry.ttls = ttls;
+    entry.received = now;
+    entry.expires = now + ttl;
+  }
+
+  for (var i = 0; i < waiters.length; i++) {
+    if (err)
+      waiters[i].oncomplete(err);
+    else
+      waiters[i].oncomplete(null, result.slice(), ttls && ttls.slice());
+  }
+}
+
+
+function oncachedlookup(err, addresses) {
+  settleQuery(this.entry, err, addresses, undefined, cacheTtl);
+}
+
+
+function oncachedresolve(err, result, ttls) {
+  // Kept as long as the record with the shortest TTL, up to `cacheTtl`.
+  var ttl = cacheTtl;
+  if (!err) {
+    for (var i = 0; i < ttls.length; i++)
+      ttl = Math.min(ttl, ttls[i] * 1000);
+  }
+  settleQuery(this.entry, err, result, ttls, ttl);
+}
+
+
+// setCache({ ttl, staleTtl, maxEntries })
+function setCache(options) {
+  if (options === null || typeof options !== 'object')
+    throw new TypeError('"options" argument must be an object');
+
+  const ttl = options.ttl === undefined ? 0 : options.ttl;
+  const staleTtl = options.staleTtl === undefined ? 0 : options.staleTtl;
+  const maxEntries =
+    options.maxEntries === undefined ? 1000 : options.maxEntries;
+  if (!Number.isSafeInteger(ttl) || ttl < 0)
+    throw new TypeError('Invalid argument: ttl must be a non-negative integer');
+  if (!Number.isSafeInteger(staleTtl) || staleTtl < 0) {
+    throw new TypeError(
+      'Invalid argument: staleTtl must be a non-negative integer');
+  }
+  if (!Number.isSafeInteger(maxEntries) || maxEntries < 1) {
+    throw new TypeError(
+      'Invalid argument: maxEntries must be a positive integer');
+  }
+
+  cacheTtl = ttl;
+  cacheStaleTtl = staleTtl;
+  cacheMaxEntries = maxEntries;
+  queryCache.clear();
+}
+
+
+// The address families that have an address other than loopback, or both when
+// neither has one, for AI_ADDRCONFIG.
+function configuredFamilies() {
+  const interfaces = os.networkInterfaces();
+  var ipv4 = false;
+  var ipv6 = false;
+  for (const name in interfaces) {
+    for (const address of interfaces[name]) {
+      if (address.internal)
+        continue;
+      if (address.family === 'IPv4')
+        ipv4 = true;
+      else if (address.family === 'IPv6')
+        ipv6 = true;
+    }
+  }
+  return ipv4 === ipv6 ? 0 : ipv4 ? 4 : 6;
+}
+
+
+function onhostbyname(err, addresses) {
+  const lookup = this.lookup;
+  if (err) {
+    if (lookup.err === null)
+      lookup.err = err === 'ENODATA' ? 'ENOTFOUND' : err;
+  } else if (this.family === 4 && lookup.mapped) {
+    lookup.addresses[this.index] = addresses.map((ip) => `::ffff:${ip}`);
+  } else {
+    lookup.addresses[this.index] = addresses;
+  }
+
+  if (--lookup.pending > 0)
+    return;
+  if (lookup.mapped && lookup.addresses[0] === null && !lookup.done) {
+    // No IPv6 addresses, AI_V4MAPPED maps the IPv4 ones.
+    lookup.done = true;
+    lookup.err = null;
+    lookup.pending = 1;
+    sendHostByName(lookup, lookup.hostname, 4, 0);
+    return;
+  }
+
+  const results = [];
+  for (const list of lookup.addresses) {
+    if (list !== null)
+      results.push(...list);
+  }
+  if (results.length > 0)
+    lookup.req.oncomplete(0, results);
+  else
+    lookup.req.oncomplete(lookup.err || 'ENOTFOUND');
+}
+
+
+function sendHostByName(lookup, hostname, family, index) {
+  const query = new QueryReqWrap();
+  query.lookup = lookup;
+  query.family = family;
+  query.index = index;
+  query.oncomplete = onhostbyname;
+  return cares.getHostByName(query, hostname, family);
+}
+
+
+// Looks `hostname` up the way getaddrinfo() does, in the hosts file and over
+// DNS with the search domains and lookup order of the system configuration,
+// but on the c-ares channel rather than on the threadpool. Like the
+// getaddrinfo binding, calls `req.oncomplete(err, addresses)` with the IPv4
+// addresses first.
+function caresGetAddrInfo(req, hostname, family, hints) {
+  if (family === 0 && (hints & cares.AI_ADDRCONFIG))
+    family = configuredFamilies();
+
+  const lookup = {
+    req,
+    hostname,
+    addresses: [null, null],
+    err: null,
+    pending: family === 0 ? 2 : 1,
+    mapped: family === 6 && (hints & cares.AI_V4MAPPED) !== 0,
+    done: false
+  };
+  var err = 0;
+  if (family !== 6)
+    err = sendHostByName(lookup, hostname, 4, 0);
+  if (family !== 4 && err === 0)
+    err = sendHostByName(lookup, hostname, 6, family === 0 ? 1 : 0);
+  return err;
+}
+
+
+function getAddrInfo(req, hostname, family, hints, resolver) {
+  if (resolver === 'cares')
+    return caresGetAddrInfo(req, hostname, family, hints);
+  return cares.getaddrinfo(req, hostname, family, hints);
+}
+
+
 function onlookup(err, addresses) {
   if (err) {
     return this.callback(errnoException(err, 'getaddrinfo', this.hostname));
@@ -124,6 +364,7 @@ function lookup(hostname, options, callback) {
   var hints = 0;
   var family = -1;
   var all = false;
+  var resolver = 'getaddrinfo';
 
   // Parse arguments
   if (hostname && typeof hostname !== 'string') {
@@ -138,6 +379,8 @@ function lookup(hostname, options, callback) {
     hints = options.hints >>> 0;
     family = options.family >>> 0;
     all = options.all === true;
+    if (options.resolver !== undefined)
+      resolver = options.resolver;
 
     if (hints !== 0 &&
         hints !== cares.AI_ADDRCONFIG &&
@@ -152,6 +395,11 @@ function lookup(hostname, options, callback) {
   if (family !== 0 && family !== 4 && family !== 6)
     throw new TypeError('Invalid argument: family must be 4 or 6');
 
+  if (resolver !== 'getaddrinfo' && resolver !== 'cares') {
+    throw new TypeError(
+      'Invalid argument: resolver must be "getaddrinfo" or "cares"');
+  }
+
   callback = makeAsync(callback);
 
   if (!hostname) {
@@ -173,13 +421,36 @@ function lookup(hostname, options, callback) {
     return {};
   }
 
+  var err;
+  if (cacheTtl > 0) {
+    const cached = {
+      callback,
+      family,
+      hostname,
+      oncomplete: all ? onlookupall : onlookup
+    };
+    const key = `${resolver}:${family}:${hints}:${hostname}`;
+    err = cachedQuery(key, cached, (entry) => {
+      const req = new GetAddrInfoReqWrap();
+      req.entry = entry;
+      req.oncomplete = oncachedlookup;
+      return getAddrInfo(req, hostname, family, hints, resolver);
+    });
+    if (err) {
+      callback(errnoException(err, 'getaddrinfo', hostname));
+      return {};
+    }
+    callback.immediately = true;
+    return cached;
+  }
+
   var req = new GetAddrInfoReqWrap();
   req.callback = callback;
   req.family = family;
   req.hostname = hostname;
   req.oncomplete = all ? onlookupall : onlookup;
 
-  var err = cares.getaddrinfo(req, hostname, family, hints);
+  err = getAddrInfo(req, hostname, family, hints, resolver);
   if (err) {
     callback(errnoException(err, 'getaddrinfo', hostname));
     return {};
@@ -240,10 +511,16 @@ function onresolve(err, result, ttls) {
 }
 
 
+// The channel of a Resolver, or the default one of the binding.
+function channelOf(self) {
+  return self instanceof Resolver ? self._handle : cares;
+}
+
+
 function resolver(bindingName) {
-  var binding = cares[bindingName];
+  const cacheable = bindingName === 'queryA' || bindingName === 'queryAaaa';
 
-  return function query(name, /* options, */ callback) {
+  function query(name, /* options, */ callback) {
     var options;
     if (arguments.length > 2) {
       options = callback;
@@ -257,17 +534,39 @@ function resolver(bindingName) {
     }
 
     callback = makeAsync(callback);
-    var req = new QueryReqWrap();
-    req.bindingName = bindingName;
-    req.callback = callback;
-    req.hostname = name;
-    req.oncomplete = onresolve;
-    req.ttl = !!(options && options.ttl);
-    var err = binding(req, name);
+    const channel = channelOf(this);
+    var req, err;
+    if (cacheable && cacheTtl > 0 && channel === cares) {
+      req = {
+        bindingName,
+        callback,
+        hostname: name,
+        oncomplete: onresolve,
+        ttl: !!(options && options.ttl)
+      };
+      err = cachedQuery(`${bindingName}:${name}`, req, (entry) => {
+        const query = new QueryReqWrap();
+        query.entry = entry;
+        query.oncomplete = oncachedresolve;
+        return cares[bindingName](query, name);
+      });
+    } else {
+      req = new QueryReqWrap();
+      req.bindingName = bindingName;
+      req.callback = callback;
+      req.hostname = name;
+      req.oncomplete = onresolve;
+      req.ttl = !!(options && options.ttl);
+      // Keeps the channel alive while the query is in flight.
+      req.channel = channel;
+      err = channel[bindingName](req, name);
+    }
     if (err) throw errnoException(err, bindingName);
     callback.immediately = true;
     return req;
-  };
+  }
+  query.bindingName = bindingName;
+  return query;
 }
 
 
@@ -297,22 +596,86 @@ function resolve(hostname, type_, callback_) {
   }
 
   if (typeof resolver === 'function') {
-    return resolver(hostname, callback);
+    return resolver.call(this, hostname, callback);
   } else {
     throw new Error(`Unknown type "${type_}"`);
   }
 }
 
 
+function onresolvebatch(err, answers, ttls) {
+  const results = new Array(answers.length);
+  for (var i = 0; i < answers.length; i++) {
+    const name = this.names[i];
+    const type = this.types[i];
+    var records = answers[i];
+    var error = null;
+    if (typeof records === 'string') {
+      error = errnoException(records, resolveMap[type].bindingName, name);
+      records = null;
+    } else if (this.ttl && ttls[i] !== undefined) {
+      const recordTtls = ttls[i];
+      records = records.map((address, index) =>
+        ({ address, ttl: recordTtls[index] }));
+    }
+    results[i] = { name, type, error, records };
+  }
+  this.callback(null, results);
+}
+
+
+// resolveBatch(queries, [options,] callback), where queries are
+// [name, rrtype] pairs.
+function resolveBatch(queries, options, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = undefined;
+  }
+
+  if (!Array.isArray(queries)) {
+    throw new Error('"queries" argument must be an array');
+  } else if (typeof callback !== 'function') {
+    throw new Error('"callback" argument must be a function');
+  }
+
+  const names = new Array(queries.length);
+  const types = new Array(queries.length);
+  for (var i = 0; i < queries.length; i++) {
+    const query = queries[i];
+    if (!Array.isArray(query) || typeof query[0] !== 'string')
+      throw new Error('Each query must be a [name, rrtype] array');
+    const type = query[1] === undefined ? 'A' : query[1];
+    if (typeof resolveMap[type] !== 'function')
+      throw new Error(`Unknown type "${type}"`);
+    names[i] = query[0];
+    types[i] = type;
+  }
+
+  callback = makeAsync(callback);
+  const channel = channelOf(this);
+  const req = new QueryReqWrap();
+  req.callback = callback;
+  req.names = names;
+  req.types = types;
+  req.ttl = !!(options && options.ttl);
+  req.channel = channel;
+  req.oncomplete = onresolvebatch;
+  channel.queryBatch(req, names, types);
+  callback.immediately = true;
+  return req;
+}
+
+
 function getServers() {
-  return cares.getServers();
+  return channelOf(this).getServers();
 }
 
 
 function setServers(servers) {
+  const channel = channelOf(this);
   // cache the original servers because in the event of an error setting the
   // servers cares won't have any servers available for resolution
-  const orig = cares.getServers();
+  const orig = channel.getServers();
   const newSet = [];
 
   servers.forEach((serv) => {
@@ -337,23 +700,77 @@ function setServers(servers) {
     throw new Error(`IP address is not properly formatted: ${serv}`);
   });
 
-  const errorNumber = cares.setServers(newSet);
+  const errorNumber = channel.setServers(newSet);
 
   if (errorNumber !== 0) {
     // reset the servers to the old servers, because ares probably unset them
-    cares.setServers(orig.join(','));
+    channel.setServers(orig.map((serv) => [isIP(serv), serv]));
 
     var err = cares.strerror(errorNumber);
     throw new Error(`c-ares failed to set servers: "${err}" [${servers}]`);
   }
+
+  // Other servers may give other answers.
+  if (channel === cares)
+    queryCache.clear();
 }
 
+
+// A resolver with its own servers, timeout and tries. Its queries do not
+// wait for those of other resolvers.
+class Resolver {
+  constructor(options) {
+    var timeout = -1;
+    var tries = -1;
+    if (options !== undefined) {
+      if (options === null || typeof options !== 'object')
+        throw new TypeError('"options" argument must be an object');
+      if (options.timeout !== undefined) {
+        timeout = options.timeout;
+        if (!Number.isInteger(timeout) || timeout < -1 || timeout > 0x7fffffff)
+          throw new TypeError('Invalid argument: timeout must be an integer');
+      }
+      if (options.tries !== undefined) {
+        tries = options.tries;
+        if (!Number.isInteger(tries) || tries < 1 || tries > 0x7fffffff) {
+          throw new TypeError(
+            'Invalid argument: tries must be a positive integer');
+        }
+      }
+    }
+    this._handle = new ChannelWrap(timeout, tries);
+  }
+
+  cancel() {
+    this._handle.cancel();
+  }
+}
+
+Resolver.prototype.getServers = getServers;
+Resolver.prototype.setServers = setServers;
+Resolver.prototype.resolve = resolve;
+Resolver.prototype.resolveBatch = resolveBatch;
+Resolver.prototype.resolve4 = resolveMap.A;
+Resolver.prototype.resolve6 = resolveMap.AAAA;
+Resolver.prototype.resolveCname = resolveMap.CNAME;
+Resolver.prototype.resolveMx = resolveMap.MX;
+Resolver.prototype.resolveNs = resolveMap.NS;
+Resolver.prototype.resolveTxt = resolveMap.TXT;
+Resolver.prototype.resolveSrv = resolveMap.SRV;
+Resolver.prototype.resolvePtr = resolveMap.PTR;
+Resolver.prototype.resolveNaptr = resolveMap.NAPTR;
+Resolver.prototype.resolveSoa = resolveMap.SOA;
+Resolver.prototype.reverse = resolver('getHostByAddr');
+
 module.exports = {
+  Resolver,
   lookup,
   lookupService,
   getServers,
   setServers,
+  setCache,
   resolve,
+  resolveBatch,
   resolve4: resolveMap.A,
   resolve6: resolveMap.AAAA,
   resolveCname: resolveMap.CNAME,
@@ -364,7 +781,7 @@ module.exports = {
   resolvePtr: resolveMap.PTR,
   resolveNaptr: resolveMap.NAPTR,
   resolveSoa: resolveMap.SOA,
-  reverse: resolver('getHostByAddr'),
+  reverse: Resolver.prototype.reverse,
 
   // uv_getaddrinfo flags
   ADDRCONFIG: cares.AI_ADDRCONFIG,
@@ -32,11 +32,12 @@ const { isUint8Array } = process.binding('util');
 
 const binding = process.binding('fs');
 const fs = exports;
-const Buffer = require('buffer').Buffer;
+const { Buffer, kMaxLength } = require('buffer');
 const Stream = require('stream').Stream;
 const EventEmitter = require('events');
 const FSReqWrap = binding.FSReqWrap;
-const FSEvent = process.binding('fs_event_wrap').FSEvent;
+const fsEventBinding = process.binding('fs_event_wrap');
+const FSEvent = fsEventBinding.FSEvent;
 const internalFS = require('internal/fs');
 const internalURL = require('internal/url');
 const internalUtil = require('internal/util');
@@ -54,7 +55,6 @@ const Readable = Stream.Readable;
 const Writable = Stream.Writable;
 
 const kMinPoolSpace = 128;
-const kMaxLength = require('buffer').kMaxLength;
 
 const isWindows = process.platform === 'win32';
 
@@ -328,166 +328,25 @@ fs.readFile = function(path, options, callback) {
   if (!nullCheck(path, callback))
     return;
 
-  var context = new ReadFileContext(callback, options.encoding);
-  context.isUserFd = isFd(path); // file descriptor ownership
-  var req = new FSReqWrap();
-  req.context = context;
-  req.oncomplete = readFileAfterOpen;
-
-  if (context.isUserFd) {
-    process.nextTick(function() {
-      req.oncomplete(null, path);
-    });
-    return;
-  }
-
-  binding.open(pathModule._makeLong(path),
-               stringToFlags(options.flag || 'r'),
-               0o666,
-               req);
-};
-
-const kReadFileBufferLength = 8 * 1024;
-
-function ReadFileContext(callback, encoding) {
-  this.fd = undefined;
-  this.isUserFd = undefined;
-  this.size = undefined;
-  this.callback = callback;
-  this.buffers = null;
-  this.buffer = null;
-  this.pos = 0;
-  this.encoding = encoding;
-  this.err = null;
-}
-
-ReadFileContext.prototype.read = function() {
-  var buffer;
-  var offset;
-  var length;
-
-  if (this.size === 0) {
-    buffer = this.buffer = Buffer.allocUnsafeSlow(kReadFileBufferLength);
-    offset = 0;
-    length = kReadFileBufferLength;
-  } else {
-    buffer = this.buffer;
-    offset = this.pos;
-    length = this.size - this.pos;
-  }
-
+  // The whole file is read by a single request on the thread pool.
   var req = new FSReqWrap();
   req.oncomplete = readFileAfterRead;
-  req.context = this;
+  req.callback = callback;
+  req.encoding = options.encoding;
 
-  binding.read(this.fd, buffer, offset, length, -1, req);
+  binding.readFile(isFd(path) ? path : pathModule._makeLong(path),
+                   stringToFlags(options.flag || 'r'),
+                   req);
 };
 
-ReadFileContext.prototype.close = function(err) {
-  var req = new FSReqWrap();
-  req.oncomplete = readFileAfterClose;
-  req.context = this;
-  this.err = err;
-
-  if (this.isUserFd) {
-    process.nextTick(function() {
-      req.oncomplete(null);
-    });
-    return;
-  }
-
-  binding.close(this.fd, req);
-};
-
-function readFileAfterOpen(err, fd) {
-  var context = this.context;
-
-  if (err) {
-    context.callback(err);
-    return;
-  }
-
-  context.fd = fd;
-
-  var req = new FSReqWrap();
-  req.oncomplete = readFileAfterStat;
-  req.context = context;
-  binding.fstat(fd, req);
-}
-
-function readFileAfterStat(err) {
-  var context = this.context;
-
+function readFileAfterRead(err, buffer) {
   if (err)
-    return context.close(err);
-
-  // Use stats array directly to avoid creating an fs.Stats instance just for
-  // our internal use.
-  var size;
-  if ((statValues[1/*mode*/] & S_IFMT) === S_IFREG)
-    size = context.size = statValues[8/*size*/];
-  else
-    size = context.size = 0;
+    return this.callback(err);
 
-  if (size === 0) {
-    context.buffers = [];
-    context.read();
-    return;
-  }
-
-  if (size > kMaxLength) {
-    err = new RangeError('File size is greater than possible Buffer: ' +
-                         `0x${kMaxLength.toString(16)} bytes`);
-    return context.close(err);
-  }
+  if (this.encoding)
+    return tryToString(buffer, this.encoding, this.callback);
 
-  context.buffer = Buffer.allocUnsafeSlow(size);
-  context.read();
-}
-
-function readFileAfterRead(err, bytesRead) {
-  var context = this.context;
-
-  if (err)
-    return context.close(err);
-
-  if (bytesRead === 0)
-    return context.close();
-
-  context.pos += bytesRead;
-
-  if (context.size !== 0) {
-    if (context.pos === context.size)
-      context.close();
-    else
-      context.read();
-  } else {
-    // unknown size, just read until we don't get bytes.
-    context.buffers.push(context.buffer.slice(0, bytesRead));
-    context.read();
-  }
-}
-
-function readFileAfterClose(err) {
-  var context = this.context;
-  var buffer = null;
-  var callback = context.callback;
-
-  if (context.err || err)
-    return callback(context.err || err);
-
-  if (context.size === 0)
-    buffer = Buffer.concat(context.buffers, context.pos);
-  else if (context.pos < context.size)
-    buffer = context.buffer.slice(0, context.pos);
-  else
-    buffer = context.buffer;
-
-  if (context.encoding) {
-    return tryToString(buffer, context.encoding, callback);
-  }
-
-  callback(null, buffer);
+  this.callback(null, buffer);
 }
 
 function tryToString(buf, encoding, callback) {
@@ -753,6 +612,38 @@ fs.renameSync = function(oldPath, newPath) {
                         pathModule._makeLong(newPath));
 };
 
+fs.copyFile = function(src, dest, flags, callback) {
+  if (typeof flags === 'function') {
+    callback = flags;
+    flags = 0;
+  }
+  callback = makeCallback(callback);
+  if (handleError((src = getPathFromURL(src)), callback))
+    return;
+
+  if (handleError((dest = getPathFromURL(dest)), callback))
+    return;
+
+  if (!nullCheck(src, callback)) return;
+  if (!nullCheck(dest, callback)) return;
+  var req = new FSReqWrap();
+  req.oncomplete = callback;
+  binding.copyFile(pathModule._makeLong(src),
+                   pathModule._makeLong(dest),
+                   flags === undefined ? 0 : flags,
+                   req);
+};
+
+fs.copyFileSync = function(src, dest, flags) {
+  handleError((src = getPathFromURL(src)));
+  handleError((dest = getPathFromURL(dest)));
+  nullCheck(src);
+  nullCheck(dest);
+  binding.copyFile(pathModule._makeLong(src),
+                   pathModule._makeLong(dest),
+                   flags === undefined ? 0 : flags);
+};
+
 fs.truncate = function(path, len, callback) {
   if (typeof path === 'number') {
     return fs.ftruncate(path, len, callback);
@@ -879,6 +770,14 @@ fs.readdir = function(path, options, callback) {
     return;
   if (!nullCheck(path, callback)) return;
   var req = new FSReqWrap();
+  if (options.withFileTypes) {
+    req.oncomplete = function(err, names, types) {
+      if (err) return callback(err);
+      callback(null, direntsFromTypes(names, types));
+    };
+    binding.readdirTypes(pathModule._makeLong(path), options.encoding, req);
+    return;
+  }
   req.oncomplete = callback;
   binding.readdir(pathModule._makeLong(path), options.encoding, req);
 };
@@ -887,9 +786,181 @@ fs.readdirSync = function(path, options) {
   options = getOptions(options, {});
   handleError((path = getPathFromURL(path)));
   nullCheck(path);
+  if (options.withFileTypes) {
+    const result = binding.readdirTypes(pathModule._makeLong(path),
+                                        options.encoding);
+    return direntsFromTypes(result[0], result[1]);
+  }
   return binding.readdir(pathModule._makeLong(path), options.encoding);
 };
 
+function Dirent(name, type) {
+  this.name = name;
+  this._type = type;
+}
+
+Dirent.prototype.isDirectory = function() {
+  return this._type === binding.UV_DIRENT_DIR;
+};
+
+Dirent.prototype.isFile = function() {
+  return this._type === binding.UV_DIRENT_FILE;
+};
+
+Dirent.prototype.isSymbolicLink = function() {
+  return this._type === binding.UV_DIRENT_LINK;
+};
+
+Dirent.prototype.isFIFO = function() {
+  return this._type === binding.UV_DIRENT_FIFO;
+};
+
+Dirent.prototype.isSocket = function() {
+  return this._type === binding.UV_DIRENT_SOCKET;
+};
+
+Dirent.prototype.isCharacterDevice = function() {
+  return this._type === binding.UV_DIRENT_CHAR;
+};
+
+Dirent.prototype.isBlockDevice = function() {
+  return this._type === binding.UV_DIRENT_BLOCK;
+};
+
+fs.Dirent = Dirent;
+
+function direntsFromTypes(names, types) {
+  const dirents = new Array(names.length);
+  for (var i = 0; i < names.length; i++)
+    dirents[i] = new Dirent(names[i], types[i]);
+  return dirents;
+}
+
+const kDirBufferSize = 32;
+
+// An open directory that is read a batch of entries at a time. Operations
+// are queued so that only one of them runs on the handle at a time.
+function Dir(handle, path, options) {
+  this.path = path;
+  this._handle = handle;
+  this._encoding = options.encoding;
+  this._bufferSize = options.bufferSize || kDirBufferSize;
+  this._buffer = [];
+  this._queue = [];
+  this._busy = false;
+  this._closed = false;
+}
+
+Dir.prototype._run = function(op) {
+  if (this._busy) {
+    this._queue.push(op);
+    return;
+  }
+  this._busy = true;
+  op(() => {
+    this._busy = false;
+    if (this._queue.length > 0)
+      this._run(this._queue.shift());
+  });
+};
+
+Dir.prototype._checkOpen = function() {
+  if (this._closed)
+    throw new Error('Directory handle was closed');
+};
+
+Dir.prototype.read = function(callback) {
+  callback = makeCallback(callback);
+  this._checkOpen();
+  this._run((done) => {
+    if (this._buffer.length > 0) {
+      done();
+      process.nextTick(callback, null, this._buffer.shift());
+      return;
+    }
+    var req = new FSReqWrap();
+    req.handle = this._handle;
+    req.oncomplete = (err, names, types) => {
+      done();
+      if (err) return callback(err);
+      this._buffer = direntsFromTypes(names, types);
+      callback(null, this._buffer.length > 0 ? this._buffer.shift() : null);
+    };
+    this._handle.read(this._encoding, this._bufferSize, req);
+  });
+};
+
+Dir.prototype.readSync = function() {
+  this._checkOpen();
+  if (this._busy)
+    throw new Error('Directory handle is busy with an asynchronous operation');
+  if (this._buffer.length === 0) {
+    const result = this._handle.read(this._encoding, this._bufferSize);
+    this._buffer = direntsFromTypes(result[0], result[1]);
+  }
+  return this._buffer.length > 0 ? this._buffer.shift() : null;
+};
+
+Dir.prototype.close = function(callback) {
+  callback = makeCallback(callback);
+  this._checkOpen();
+  this._closed = true;
+  this._run((done) => {
+    var req = new FSReqWrap();
+    req.handle = this._handle;
+    req.oncomplete = (err) => {
+      done();
+      callback(err);
+    };
+    this._handle.close(req);
+  });
+};
+
+Dir.prototype.closeSync = function() {
+  this._checkOpen();
+  if (this._busy)
+    throw new Error('Directory handle is busy with an asynchronous operation');
+  this._closed = true;
+  this._handle.close();
+};
+
+fs.Dir = Dir;
+
+function getDirOptions(options) {
+  options = getOptions(options, {});
+  if (options.bufferSize !== undefined &&
+      (!Number.isSafeInteger(options.bufferSize) ||
+       options.bufferSize < 1 || options.bufferSize > 4096)) {
+    throw new RangeError('"bufferSize" must be an integer between 1 and 4096');
+  }
+  return options;
+}
+
+fs.opendir = function(path, options, callback) {
+  callback = makeCallback(typeof options === 'function' ? options : callback);
+  options = getDirOptions(options);
+  if (handleError((path = getPathFromURL(path)), callback))
+    return;
+  if (!nullCheck(path, callback)) return;
+  const handle = new binding.DirHandle();
+  var req = new FSReqWrap();
+  req.handle = handle;
+  req.oncomplete = function(err) {
+    if (err) return callback(err);
+    callback(null, new Dir(handle, path, options));
+  };
+  handle.open(pathModule._makeLong(path), req);
+};
+
+fs.opendirSync = function(path, options) {
+  options = getDirOptions(options);
+  handleError((path = getPathFromURL(path)));
+  nullCheck(path);
+  const handle = new binding.DirHandle();
+  handle.open(pathModule._makeLong(path));
+  return new Dir(handle, path, options);
+};
+
 fs.fstat = function(fd, callback) {
   var req = new FSReqWrap();
   req.oncomplete = makeStatsCallback(callback);
@@ -921,6 +992,40 @@ fs.fstatSync = function(fd) {
   return statsFromValues();
 };
 
+const mmapAdvice = {
+  normal: binding.MMAP_ADVICE_NORMAL,
+  random: binding.MMAP_ADVICE_RANDOM,
+  sequential: binding.MMAP_ADVICE_SEQUENTIAL,
+  willneed: binding.MMAP_ADVICE_WILLNEED
+};
+
+fs.mmapSync = function(fd, options) {
+  if (typeof fd !== 'number' || (fd | 0) !== fd || fd < 0)
+    throw new TypeError('"fd" must be a file descriptor');
+  options = getOptions(options, {});
+
+  const offset = options.offset === undefined ? 0 : options.offset;
+  if (!Number.isSafeInteger(offset) || offset < 0)
+    throw new RangeError('"offset" must be a non-negative integer');
+
+  const size = fs.fstatSync(fd).size;
+  const length = options.length === undefined ?
+    Math.max(size - offset, 0) : options.length;
+  if (!Number.isSafeInteger(length) || length < 0 || length > kMaxLength) {
+    throw new RangeError(
+      `"length" must be an integer between 0 and ${kMaxLength}`);
+  }
+  // Touching pages past the end of the file raises SIGBUS.
+  if (length > 0 && offset + length > size)
+    throw new RangeError('"offset" and "length" must be within the file');
+
+  const advice = options.advice === undefined ? 'normal' : options.advice;
+  if (!mmapAdvice.hasOwnProperty(advice))
+    throw new TypeError(`Unknown advice: ${advice}`);
+
+  return binding.mmap(fd, offset, length, mmapAdvice[advice]).buffer;
+};
+
 fs.lstatSync = function(path) {
   handleError((path = getPathFromURL(path)));
   nullCheck(path);
@@ -935,6 +1040,127 @@ fs.statSync = function(path) {
   return statsFromValues();
 };
 
+function statBatchPaths(paths, callback) {
+  if (!Array.isArray(paths))
+    throw new TypeError('"paths" argument must be an array');
+  const result = new Array(paths.length);
+  for (var i = 0; i < paths.length; i++) {
+    var path = getPathFromURL(paths[i]);
+    if (handleError(path, callback) || !nullCheck(path, callback))
+      return;
+    result[i] = pathModule._makeLong(path);
+  }
+  return result;
+}
+
+// Every stat is 14 fields in the packed array, see FillStatsArray().
+function statsFromFields(fields, o) {
+  return new Stats(fields[o], fields[o + 1], fields[o + 2],
+                   fields[o + 3], fields[o + 4], fields[o + 5],
+                   fields[o + 6] < 0 ? undefined : fields[o + 6],
+                   fields[o + 7], fields[o + 8],
+                   fields[o + 9] < 0 ? undefined : fields[o + 9],
+                   fields[o + 10], fields[o + 11], fields[o + 12],
+                   fields[o + 13]);
+}
+
+function statsFromBatch(fields, errors) {
+  const count = fields.length / 14;
+  const stats = new Array(count);
+  for (var i = 0; i < count; i++) {
+    if (errors[i] !== undefined)
+      stats[i] = errors[i];
+    else
+      stats[i] = statsFromFields(fields, i * 14);
+  }
+  return stats;
+}
+
+fs.statBatch = function(paths, options, callback) {
+  callback = makeCallback(typeof options === 'function' ? options : callback);
+  options = getOptions(options, {});
+  paths = statBatchPaths(paths, callback);
+  if (paths === undefined)
+    return;
+  var req = new FSReqWrap();
+  req.oncomplete = function(err, fields, errors) {
+    callback(null, statsFromBatch(fields, errors));
+  };
+  binding.statBatch(paths, options.followSymlinks !== false, req);
+};
+
+fs.statBatchSync = function(paths, options) {
+  options = getOptions(options, {});
+  paths = statBatchPaths(paths);
+  const result = binding.statBatch(paths, options.followSymlinks !== false);
+  return statsFromBatch(result[0], result[1]);
+};
+
+// Packs the operations the way IOBatch in node_file.cc expects them: kind,
+// fd, offset, length and position for each, with the buffers alongside.
+function ioBatchOps(ops) {
+  if (!Array.isArray(ops))
+    throw new TypeError('"ops" argument must be an array');
+  const fields = new Float64Array(ops.length * 5);
+  const buffers = new Array(ops.length);
+  for (var i = 0; i < ops.length; i++) {
+    const op = ops[i];
+    if (op === null || typeof op !== 'object')
+      throw new TypeError('Every operation must be an object');
+    var kind;
+    if (op.type === 'read')
+      kind = binding.kIOBatchRead;
+    else if (op.type === 'write')
+      kind = binding.kIOBatchWrite;
+    else
+      throw new TypeError('"type" must be \'read\' or \'write\'');
+    if (typeof op.fd !== 'number' || (op.fd | 0) !== op.fd || op.fd < 0)
+      throw new TypeError('"fd" must be a file descriptor');
+    if (!isUint8Array(op.buffer))
+      throw new TypeError('"buffer" must be a Buffer or Uint8Array');
+    const offset = op.offset === undefined ? 0 : op.offset;
+    if (!Number.isSafeInteger(offset) || offset < 0 ||
+        offset > op.buffer.length) {
+      throw new RangeError('"offset" is outside of the buffer');
+    }
+    const length = op.length === undefined ?
+      op.buffer.length - offset : op.length;
+    if (!Number.isSafeInteger(length) || length < 0 ||
+        offset + length > op.buffer.length) {
+      throw new RangeError('"length" is outside of the buffer');
+    }
+    const position = op.position === undefined || op.position === null ?
+      -1 : op.position;
+    if (!Number.isSafeInteger(position) || position < -1)
+      throw new TypeError('"position" must be a non-negative integer or null');
+    fields[i * 5] = kind;
+    fields[i * 5 + 1] = op.fd;
+    fields[i * 5 + 2] = offset;
+    fields[i * 5 + 3] = length;
+    fields[i * 5 + 4] = position;
+    buffers[i] = op.buffer;
+  }
+  return { fields, buffers };
+}
+
+fs.ioBatch = function(ops, callback) {
+  callback = makeCallback(callback);
+  const { fields, buffers } = ioBatchOps(ops);
+  var req = new FSReqWrap();
+  // Keep the buffers alive until the operations are done.
+  req.buffers = buffers;
+  req.oncomplete = function(err, results, errors) {
+    callback(null, { results, errors });
+  };
+  binding.ioBatch(fields, buffers, req);
+};
+
+fs.ioBatchSync = function(ops) {
+  const { fields, buffers } = ioBatchOps(ops);
+  const result = binding.ioBatch(fields, buffers);
+  return { results: result[0], errors: result[1] };
+};
+
 fs.readlink = function(path, options, callback) {
   callback = makeCallback(typeof options === 'function' ? options : callback);
   options = getOptions(options, {});
@@ -1329,11 +1555,69 @@ fs.appendFileSync = function(path, data, options) {
   fs.writeFileSync(path, data, options);
 };
 
-function FSWatcher() {
+// On Linux, the watchers that are recursive or debounced share one inotify
+// instance rather than opening one each. The events of all of them arrive in
+// one array of (id, eventType, filename) triples, see InotifyWatcher.
+const sharedWatchers = new Map();
+var nextSharedWatcherId = 1;
+var sharedWatcherSetUp = false;
+
+function onSharedWatcherEvents(events) {
+  for (var i = 0; i < events.length; i += 3) {
+    // Closed by the listener of an earlier event.
+    const handle = sharedWatchers.get(events[i]);
+    if (handle === undefined)
+      continue;
+    const eventType = events[i + 1];
+    if (typeof eventType === 'number')
+      handle.onchange(eventType, '', events[i + 2]);
+    else
+      handle.onchange(0, eventType, events[i + 2]);
+  }
+}
+
+function SharedFSEvent() {
+  this._id = 0;
+  this.onchange = null;
+  this.owner = null;
+}
+
+SharedFSEvent.prototype.start = function(filename,
+                                         persistent,
+                                         recursive,
+                                         encoding,
+                                         debounce) {
+  if (!sharedWatcherSetUp) {
+    fsEventBinding.setupSharedWatcher(onSharedWatcherEvents);
+    sharedWatcherSetUp = true;
+  }
+  const id = nextSharedWatcherId++;
+  const err = fsEventBinding.startSharedWatcher(id,
+                                                filename,
+                                                persistent,
+                                                recursive,
+                                                encoding,
+                                                debounce);
+  if (err === 0) {
+    this._id = id;
+    sharedWatchers.set(id, this);
+  }
+  return err;
+};
+
+SharedFSEvent.prototype.close = function() {
+  if (this._id === 0)
+    return;
+  sharedWatchers.delete(this._id);
+  fsEventBinding.stopSharedWatcher(this._id);
+  this._id = 0;
+};
+
+function FSWatcher(shared) {
   EventEmitter.call(this);
 
   var self = this;
-  this._handle = new FSEvent();
+  this._handle = shared ? new SharedFSEvent() : new FSEvent();
   this._handle.owner = this;
 
   this._handle.onchange = function(status, eventType, filename) {
@@ -1355,13 +1639,15 @@ util.inherits(FSWatcher, EventEmitter);
 FSWatcher.prototype.start = function(filename,
                                      persistent,
                                      recursive,
-                                     encoding) {
+                                     encoding,
+                                     debounce) {
   handleError((filename = getPathFromURL(filename)));
   nullCheck(filename);
   var err = this._handle.start(pathModule._makeLong(filename),
                                persistent,
                                recursive,
-                               encoding);
+                               encoding,
+                               debounce);
   if (err) {
     this._handle.close();
     const error = errnoException(err, `watch ${filename}`);
@@ -1388,12 +1674,21 @@ fs.watch = function(filename, options, listener) {
 
   if (options.persistent === undefined) options.persistent = true;
   if (options.recursive === undefined) options.recursive = false;
+  if (options.debounce !== undefined) {
+    if (!Number.isInteger(options.debounce) || options.debounce < 0 ||
+        options.debounce > 0xffffffff) {
+      throw new RangeError('"debounce" must be a non-negative integer');
+    }
+  }
 
-  const watcher = new FSWatcher();
+  const watcher = new FSWatcher(process.platform === 'linux' &&
+                                (options.recursive ||
+                                 options.debounce !== undefined));
   watcher.start(filename,
                 options.persistent,
                 options.recursive,
-                options.encoding);
+                options.encoding,
+                options.debounce || 0);
 
   if (listener) {
     watcher.addListener('change', listener);
@@ -1409,37 +1704,119 @@ function emitStop(self) {
   self.emit('stop');
 }
 
-function statsFromPrevValues() {
-  return new Stats(statValues[14], statValues[15], statValues[16],
-                   statValues[17], statValues[18], statValues[19],
-                   statValues[20] < 0 ? undefined : statValues[20],
-                   statValues[21], statValues[22],
-                   statValues[23] < 0 ? undefined : statValues[23],
-                   statValues[24], statValues[25], statValues[26],
-                   statValues[27]);
+// The StatWatchers with the same interval are polled together from one
+// timer, and their files stat()ed kStatPollBatchSize at a time in the thread
+// pool, rather than each of them from a uv_fs_poll_t of its own. Whether a
+// file changed is decided the way uv_fs_poll_t decides it, so that the same
+// events are emitted.
+const kStatPollBatchSize = 256;
+const statPollGroups = new Map();
+const zeroStatFields = new Float64Array(14);
+
+function StatPollGroup(interval) {
+  this.interval = interval;
+  this.watchers = new Set();
+  // The watchers that have not been stat()ed yet, which is done right away
+  // rather than with the next round.
+  this.joining = [];
+  this.timer = null;
+  this.pending = 0;
+  this.roundStart = 0;
 }
-function StatWatcher() {
-  EventEmitter.call(this);
 
-  var self = this;
-  this._handle = new binding.StatWatcher();
+StatPollGroup.prototype.add = function(watcher) {
+  this.watchers.add(watcher);
+  if (this.joining.push(watcher) === 1)
+    process.nextTick(pollJoining, this);
+  this.updateRef();
+};
+
+StatPollGroup.prototype.remove = function(watcher) {
+  this.watchers.delete(watcher);
+  if (this.watchers.size === 0) {
+    if (this.timer !== null) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+    statPollGroups.delete(this.interval);
+  } else {
+    this.updateRef();
+  }
+};
 
-  // uv_fs_poll is a little more powerful than ev_stat but we curb it for
-  // the sake of backwards compatibility
-  var oldStatus = -1;
+StatPollGroup.prototype.updateRef = function() {
+  if (this.timer === null)
+    return;
+  for (const watcher of this.watchers) {
+    if (watcher._persistent) {
+      this.timer.ref();
+      return;
+    }
+  }
+  this.timer.unref();
+};
 
-  this._handle.onchange = function(newStatus) {
-    if (oldStatus === -1 &&
-        newStatus === -1 &&
-        statValues[2/*new nlink*/] === statValues[16/*old nlink*/]) return;
+function pollJoining(group) {
+  const watchers = group.joining.filter((watcher) => watcher._group === group);
+  group.joining = [];
+  statWatchedFiles(group, watchers, () => {
+    // The first of them starts the rounds.
+    if (group.timer === null && group.pending === 0 &&
+        group.watchers.size > 0) {
+      group.roundStart = Date.now();
+      scheduleStatPoll(group);
+    }
+  });
+}
 
-    oldStatus = newStatus;
-    self.emit('change', statsFromValues(), statsFromPrevValues());
-  };
+function pollStatGroup(group) {
+  group.timer = null;
+  group.roundStart = Date.now();
+  group.pending++;
+  statWatchedFiles(group, Array.from(group.watchers), () => {
+    if (--group.pending === 0 && group.watchers.size > 0)
+      scheduleStatPoll(group);
+  });
+}
 
-  this._handle.onstop = function() {
-    process.nextTick(emitStop, self);
-  };
+// Keeps to the schedule of the first round, whatever the stat()s took.
+function scheduleStatPoll(group) {
+  const interval = Math.max(group.interval, 1);
+  const delay = interval - (Date.now() - group.roundStart) % interval;
+  group.timer = setTimeout(pollStatGroup, delay, group);
+  group.updateRef();
+}
+
+function statWatchedFiles(group, watchers, callback) {
+  var pending = Math.ceil(watchers.length / kStatPollBatchSize);
+  if (pending === 0)
+    return callback();
+  for (var i = 0; i < watchers.length; i += kStatPollBatchSize) {
+    const batch = watchers.slice(i, i + kStatPollBatchSize);
+    const req = new FSReqWrap();
+    req.oncomplete = function(err, fields, errors) {
+      for (var j = 0; j < batch.length; j++) {
+        // Stopped by a listener, or before the stat() was done.
+        if (batch[j]._group === group)
+          batch[j]._update(fields, j * 14, errors[j]);
+      }
+      if (--pending === 0)
+        callback();
+    };
+    binding.statBatch(batch.map((watcher) => watcher._filename), true, req);
+  }
+}
+
+function StatWatcher() {
+  EventEmitter.call(this);
+
+  this._filename = null;
+  this._persistent = true;
+  this._group = null;
+  // The last successful stat(), and 0 before the first stat(), 1 after a
+  // successful one or the error code of a failed one, like uv_fs_poll_t.
+  this._stat = new Float64Array(14);
+  this._status = 0;
 }
 util.inherits(StatWatcher, EventEmitter);
 
@@ -1447,15 +1824,63 @@ util.inherits(StatWatcher, EventEmitter);
 StatWatcher.prototype.start = function(filename, persistent, interval) {
   handleError((filename = getPathFromURL(filename)));
   nullCheck(filename);
-  this._handle.start(pathModule._makeLong(filename), persistent, interval);
+  this._filename = pathModule._makeLong(filename);
+  this._persistent = !!persistent;
+  interval = interval >>> 0;
+  var group = statPollGroups.get(interval);
+  if (group === undefined) {
+    group = new StatPollGroup(interval);
+    statPollGroups.set(interval, group);
+  }
+  this._group = group;
+  group.add(this);
 };
 
 
 StatWatcher.prototype.stop = function() {
-  this._handle.stop();
+  if (this._group !== null) {
+    this._group.remove(this);
+    this._group = null;
+  }
+  process.nextTick(emitStop, this);
+};
+
+
+StatWatcher.prototype._update = function(fields, offset, err) {
+  if (err !== undefined) {
+    if (this._status !== err.errno) {
+      this._status = err.errno;
+      this.emit('change', statsFromFields(zeroStatFields, 0),
+                statsFromFields(this._stat, 0));
+    }
+    return;
+  }
+
+  const changed = this._status < 0 ||
+                  (this._status !== 0 &&
+                   !statFieldsEqual(this._stat, fields, offset));
+  const prev = changed ? statsFromFields(this._stat, 0) : null;
+  this._stat.set(fields.subarray(offset, offset + 14));
+  this._status = 1;
+  if (changed)
+    this.emit('change', statsFromFields(this._stat, 0), prev);
 };
 
 
+// The fields that uv_fs_poll_t compares: dev, mode, uid, gid, ino, size,
+// mtime, ctime and birthtime.
+const kComparedStatFields = [0, 1, 3, 4, 7, 8, 11, 12, 13];
+
+function statFieldsEqual(stat, fields, offset) {
+  for (var i = 0; i < kComparedStatFields.length; i++) {
+    const field = kComparedStatFields[i];
+    if (stat[field] !== fields[offset + field])
+      return false;
+  }
+  return true;
+}
+
+
 const statWatchers = new Map();
 
 fs.watchFile = function(filename, options, listener) {
@@ -2050,6 +2475,18 @@ function WriteStream(path, options) {
     this.pos = this.start;
   }
 
+  // Coalescing: small writes are held back for up to flushInterval ms, or
+  // until flushThreshold bytes have queued up, and then written together.
+  this.flushInterval = options.flushInterval === undefined ?
+    0 : options.flushInterval;
+  if (!Number.isSafeInteger(this.flushInterval) || this.flushInterval < 0)
+    throw new TypeError('"flushInterval" must be a non-negative integer');
+  this.flushThreshold = options.flushThreshold === undefined ?
+    this._writableState.highWaterMark : options.flushThreshold;
+  if (!Number.isSafeInteger(this.flushThreshold) || this.flushThreshold < 0)
+    throw new TypeError('"flushThreshold" must be a non-negative integer');
+  this._flushTimer = null;
+
   if (options.encoding)
     this.setDefaultEncoding(options.encoding);
 
@@ -2083,6 +2520,52 @@ WriteStream.prototype.open = function() {
 };
 
 
+// Writes are coalesced by corking the stream while they queue up. Writable
+// hands everything that was buffered to _writev() in one go when the stream
+// is uncorked, and end() uncorks it for good.
+WriteStream.prototype.write = function(chunk, encoding, cb) {
+  if (this.flushInterval === 0)
+    return Writable.prototype.write.call(this, chunk, encoding, cb);
+
+  if (this._flushTimer === null && !this._writableState.ending) {
+    this.cork();
+    this._flushTimer = setTimeout(flushWriteStream, this.flushInterval, this);
+  }
+  const ret = Writable.prototype.write.call(this, chunk, encoding, cb);
+  if (this._flushTimer !== null &&
+      this._writableState.length >= this.flushThreshold) {
+    this.flush();
+  }
+  return ret;
+};
+
+
+function flushWriteStream(stream) {
+  stream._flushTimer = null;
+  stream.uncork();
+}
+
+
+// Writes out the chunks coalescing has held back.
+WriteStream.prototype.flush = function() {
+  if (this._flushTimer === null)
+    return;
+  clearTimeout(this._flushTimer);
+  flushWriteStream(this);
+};
+
+
+WriteStream.prototype.end = function(chunk, encoding, cb) {
+  const ret = Writable.prototype.end.call(this, chunk, encoding, cb);
+  // end() has uncorked the stream, the timer has nothing left to do.
+  if (this._flushTimer !== null) {
+    clearTimeout(this._flushTimer);
+    this._flushTimer = null;
+  }
+  return ret;
+};
+
+
 WriteStream.prototype._write = function(data, encoding, cb) {
   if (!(data instanceof Buffer))
     return this.emit('error', new Error('Invalid data'));
@@ -2153,12 +2636,396 @@ WriteStream.prototype._writev = function(data, cb) {
 };
 
 
-WriteStream.prototype.destroy = ReadStream.prototype.destroy;
+WriteStream.prototype.destroy = function() {
+  if (this._flushTimer !== null) {
+    clearTimeout(this._flushTimer);
+    this._flushTimer = null;
+  }
+  ReadStream.prototype.destroy.call(this);
+};
 WriteStream.prototype.close = ReadStream.prototype.close;
 
 // There is no shutdown() for files.
 WriteStream.prototype.destroySoon = WriteStream.prototype.end;
 
+
+// Log sinks format their records as JSON lines in C++ and write them from the
+// thread pool, a buffer at a time, see node_log_sink.cc. What is buffered is
+// written out kLogSinkHighWaterMark bytes at a time, and within flushInterval
+// ms of being logged.
+const kLogSinkHighWaterMark = 64 * 1024;
+const kLogSinkFlushInterval = 100;
+var logSinkBinding;
+
+fs.createLogSink = function(file, options) {
+  return new LogSink(file, options);
+};
+
+fs.LogSink = LogSink;
+function LogSink(file, options) {
+  if (!(this instanceof LogSink))
+    return new LogSink(file, options);
+
+  EventEmitter.call(this);
+
+  options = getOptions(options, {});
+  const highWaterMark = options.highWaterMark === undefined ?
+    kLogSinkHighWaterMark : options.highWaterMark;
+  if (!Number.isSafeInteger(highWaterMark) || highWaterMark < 1 ||
+      highWaterMark > 0xffffffff)
+    throw new TypeError('"highWaterMark" must be a positive integer');
+  this.flushInterval = options.flushInterval === undefined ?
+    kLogSinkFlushInterval : options.flushInterval;
+  if (!Number.isSafeInteger(this.flushInterval) || this.flushInterval < 0)
+    throw new TypeError('"flushInterval" must be a non-negative integer');
+
+  if (typeof file === 'number') {
+    this.fd = file;
+    this._ownsFd = false;
+  } else {
+    const flags = options.flags === undefined ? 'a' : options.flags;
+    const mode = options.mode === undefined ? 0o666 : options.mode;
+    this.fd = fs.openSync(file, flags, mode);
+    this._ownsFd = true;
+  }
+  if (this.fd >>> 0 !== this.fd)
+    throw new TypeError('"file" must be a path or a file descriptor');
+
+  if (logSinkBinding === undefined)
+    logSinkBinding = process.binding('log_sink');
+  this._handle = new logSinkBinding.LogSink(this.fd, highWaterMark);
+  this._handle.onwrite = onLogSinkWrite;
+  this._handle.owner = this;
+  this._timer = null;
+  this._flushCallbacks = [];
+  this._onexit = () => this._handle.flushSync();
+  this._error = null;
+  this.bytesWritten = 0;
+  this.closed = false;
+  process.on('exit', this._onexit);
+}
+util.inherits(LogSink, EventEmitter);
+
+
+function onLogSinkWrite(err, bytesWritten) {
+  const sink = this.owner;
+  sink.bytesWritten = bytesWritten;
+  const error = err === 0 ? null : errnoException(err, 'write');
+  const callbacks = sink._flushCallbacks;
+  while (callbacks.length > 0 &&
+         (error !== null || callbacks[0].target <= bytesWritten)) {
+    callbacks.shift().callback(error);
+  }
+  if (error !== null && sink._error === null) {
+    sink._error = error;
+    sink.emit('error', error);
+  }
+}
+
+
+function flushLogSink(sink) {
+  sink._timer = null;
+  sink._handle.flush();
+}
+
+
+LogSink.prototype._logged = function(buffered) {
+  if (buffered > 0 && this._timer === null) {
+    this._timer = setTimeout(flushLogSink, this.flushInterval, this);
+    this._timer.unref();
+  }
+};
+
+
+LogSink.prototype._checkOpen = function() {
+  if (this.closed)
+    throw new Error('LogSink is closed');
+};
+
+
+// Logs the enumerable own properties of |record| as one JSON line.
+LogSink.prototype.log = function(record) {
+  this._checkOpen();
+  if (record === null || typeof record !== 'object')
+    throw new TypeError('"record" must be an object');
+  this._logged(this._handle.log(record));
+};
+
+
+// Logs keys[i]: values[i] as one JSON line. The same keys array can be
+// passed for every record.
+LogSink.prototype.logFields = function(keys, values) {
+  this._checkOpen();
+  if (!Array.isArray(keys) || !Array.isArray(values))
+    throw new TypeError('"keys" and "values" must be arrays');
+  if (keys.length !== values.length)
+    throw new RangeError('"keys" and "values" must have the same length');
+  this._logged(this._handle.logFields(keys, values));
+};
+
+
+// Logs a line that is formatted already.
+LogSink.prototype.write = function(line) {
+  this._checkOpen();
+  if (typeof line !== 'string')
+    throw new TypeError('"line" must be a string');
+  this._logged(this._handle.logRaw(line));
+};
+
+
+LogSink.prototype.flush = function(callback) {
+  if (this._timer !== null) {
+    clearTimeout(this._timer);
+    this._timer = null;
+  }
+  const target = this._handle.flush();
+  if (typeof callback !== 'function')
+    return;
+  if (this._error !== null || target <= this.bytesWritten)
+    process.nextTick(callback, this._error);
+  else
+    this._flushCallbacks.push({ target, callback });
+};
+
+
+LogSink.prototype.flushSync = function() {
+  if (this._timer !== null) {
+    clearTimeout(this._timer);
+    this._timer = null;
+  }
+  const err = this._handle.flushSync();
+  if (err !== 0)
+    throw errnoException(err, 'write');
+};
+
+
+LogSink.prototype.close = function(callback) {
+  if (this.closed) {
+    if (typeof callback === 'function')
+      process.nextTick(callback, null);
+    return;
+  }
+  this.closed = true;
+  process.removeListener('exit', this._onexit);
+  this.flush((err) => {
+    if (!this._ownsFd) {
+      if (typeof callback === 'function')
+        callback(err);
+      return;
+    }
+    fs.close(this.fd, (closeErr) => {
+      if (typeof callback === 'function')
+        callback(err || closeErr);
+    });
+  });
+};
+
+// Promise versions of the most common calls. The bindings settle a native
+// promise when given an FSReqPromise, so there is no callback closure and no
+// wrapping promise per call. The settle functions below are shared by all
+// requests and find what they need on `this`.
+const FSReqPromise = binding.FSReqPromise;
+
+FSReqPromise.prototype.oncomplete = function(err, value) {
+  if (err)
+    this.reject(err);
+  else
+    this.resolve(value);
+};
+
+function settleStats(err) {
+  if (err)
+    this.reject(err);
+  else
+    this.resolve(statsFromValues());
+}
+
+function settleDirents(err, names, types) {
+  if (err)
+    this.reject(err);
+  else
+    this.resolve(direntsFromTypes(names, types));
+}
+
+function settleRead(err, bytesRead) {
+  if (err)
+    this.reject(err);
+  else
+    this.resolve({ bytesRead, buffer: this.buffer });
+}
+
+function settleWrite(err, bytesWritten) {
+  if (err)
+    this.reject(err);
+  else
+    this.resolve({ bytesWritten, buffer: this.buffer });
+}
+
+function settleReadFile(err, buffer) {
+  if (err)
+    return this.reject(err);
+  if (!this.encoding)
+    return this.resolve(buffer);
+  try {
+    this.resolve(buffer.toString(this.encoding));
+  } catch (err) {
+    this.reject(err);
+  }
+}
+
+function promisePath(path) {
+  handleError((path = getPathFromURL(path)));
+  nullCheck(path);
+  return pathModule._makeLong(path);
+}
+
+fs.promises = {
+  access(path, mode) {
+    const req = new FSReqPromise();
+    binding.access(promisePath(path),
+                   mode === undefined ? fs.F_OK : mode | 0,
+                   req);
+    return req.promise;
+  },
+
+  open(path, flags, mode) {
+    const req = new FSReqPromise();
+    binding.open(promisePath(path),
+                 stringToFlags(flags === undefined ? 'r' : flags),
+                 modeNum(mode, 0o666),
+                 req);
+    return req.promise;
+  },
+
+  close(fd) {
+    const req = new FSReqPromise();
+    binding.close(fd, req);
+    return req.promise;
+  },
+
+  read(fd, buffer, offset, length, position) {
+    const req = new FSReqPromise();
+    req.buffer = buffer;
+    if (length === 0) {
+      req.resolve({ bytesRead: 0, buffer });
+      return req.promise;
+    }
+    req.oncomplete = settleRead;
+    binding.read(fd, buffer, offset, length, position, req);
+    return req.promise;
+  },
+
+  write(fd, buffer, offset, length, position) {
+    const req = new FSReqPromise();
+    req.buffer = buffer;
+    req.oncomplete = settleWrite;
+    if (isUint8Array(buffer)) {
+      if (typeof offset !== 'number')
+        offset = 0;
+      if (typeof length !== 'number')
+        length = buffer.length - offset;
+      if (typeof position !== 'number')
+        position = null;
+      binding.writeBuffer(fd, buffer, offset, length, position, req);
+    } else {
+      // write(fd, string[, position[, encoding]])
+      if (typeof buffer !== 'string')
+        buffer += '';
+      binding.writeString(fd, buffer, offset, length || 'utf8', req);
+    }
+    return req.promise;
+  },
+
+  ftruncate(fd, len) {
+    const req = new FSReqPromise();
+    binding.ftruncate(fd, len === undefined ? 0 : len, req);
+    return req.promise;
+  },
+
+  fsync(fd) {
+    const req = new FSReqPromise();
+    binding.fsync(fd, req);
+    return req.promise;
+  },
+
+  rename(oldPath, newPath) {
+    const req = new FSReqPromise();
+    binding.rename(promisePath(oldPath), promisePath(newPath), req);
+    return req.promise;
+  },
+
+  copyFile(src, dest, flags) {
+    const req = new FSReqPromise();
+    binding.copyFile(promisePath(src),
+                     promisePath(dest),
+                     flags === undefined ? 0 : flags,
+                     req);
+    return req.promise;
+  },
+
+  unlink(path) {
+    const req = new FSReqPromise();
+    binding.unlink(promisePath(path), req);
+    return req.promise;
+  },
+
+  mkdir(path, mode) {
+    const req = new FSReqPromise();
+    binding.mkdir(promisePath(path), modeNum(mode, 0o777), req);
+    return req.promise;
+  },
+
+  rmdir(path) {
+    const req = new FSReqPromise();
+    binding.rmdir(promisePath(path), req);
+    return req.promise;
+  },
+
+  readdir(path, options) {
+    options = getOptions(options, {});
+    const req = new FSReqPromise();
+    if (options.withFileTypes) {
+      req.oncomplete = settleDirents;
+      binding.readdirTypes(promisePath(path), options.encoding, req);
+    } else {
+      binding.readdir(promisePath(path), options.encoding, req);
+    }
+    return req.promise;
+  },
+
+  stat(path) {
+    const req = new FSReqPromise();
+    req.oncomplete = settleStats;
+    binding.stat(promisePath(path), req);
+    return req.promise;
+  },
+
+  lstat(path) {
+    const req = new FSReqPromise();
+    req.oncomplete = settleStats;
+    binding.lstat(promisePath(path), req);
+    return req.promise;
+  },
+
+  fstat(fd) {
+    const req = new FSReqPromise();
+    req.oncomplete = settleStats;
+    binding.fstat(fd, req);
+    return req.promise;
+  },
+
+  readFile(path, options) {
+    options = getOptions(options, { flag: 'r' });
+    const req = new FSReqPromise();
+    req.oncomplete = settleReadFile;
+    req.encoding = options.encoding;
+    binding.readFile(isFd(path) ? path : promisePath(path),
+                     stringToFlags(options.flag || 'r'),
+                     req);
+    return req.promise;
+  }
+};
+
 // SyncWriteStream is internal. DO NOT USE.
 // This undocumented API was never intended to be made public.
 var SyncWriteStream = internalFS.SyncWriteStream;
@@ -0,0 +1,902 @@
+'use strict';
+
+const EventEmitter = require('events');
+const net = require('net');
+const url = require('url');
+const util = require('util');
+const Buffer = require('buffer').Buffer;
+const Duplex = require('stream').Duplex;
+const StreamWrap = require('_stream_wrap').StreamWrap;
+const binding = process.binding('http2');
+const SessionHandle = binding.Http2Session;
+const debug = util.debuglog('http2');
+
+const kOnHeaders = SessionHandle.kOnHeaders;
+const kOnData = SessionHandle.kOnData;
+const kOnStreamEnd = SessionHandle.kOnStreamEnd;
+const kOnStreamClose = SessionHandle.kOnStreamClose;
+const kOnStreamDrain = SessionHandle.kOnStreamDrain;
+const kOnSettings = SessionHandle.kOnSettings;
+const kOnPingAck = SessionHandle.kOnPingAck;
+const kOnGoaway = SessionHandle.kOnGoaway;
+const kOnError = SessionHandle.kOnError;
+
+const kHandle = Symbol('handle');
+const kOwner = Symbol('owner');
+const kSocket = Symbol('socket');
+const kSession = Symbol('session');
+const kServer = Symbol('server');
+const kStreams = Symbol('streams');
+const kPendingRequests = Symbol('pendingRequests');
+const kPings = Symbol('pings');
+const kSettings = Symbol('settings');
+const kClosing = Symbol('closing');
+const kOptions = Symbol('options');
+const kAuthority = Symbol('authority');
+const kProtocol = Symbol('protocol');
+const kId = Symbol('id');
+const kUnacked = Symbol('unacked');
+const kWriteCallback = Symbol('writeCallback');
+const kEndSent = Symbol('endSent');
+const kTrailers = Symbol('trailers');
+const kClosedLocally = Symbol('closedLocally');
+const kRequest = Symbol('request');
+const kError = Symbol('error');
+
+const errorCodes = binding.errorCodes;
+const errorNames = [];
+Object.keys(errorCodes).forEach((name) => {
+  errorNames[errorCodes[name]] = name;
+});
+
+const constants = Object.assign({
+  FLAG_END_STREAM: 0x1
+}, errorCodes);
+
+// A stream's write() calls back right away while no more than this much of
+// its data waits for the peer's flow control windows.
+const kStreamHighWaterMark = 64 * 1024;
+
+const kSettingsNames = [
+  'headerTableSize',
+  'enablePush',
+  'maxConcurrentStreams',
+  'initialWindowSize',
+  'maxFrameSize',
+  'maxHeaderListSize'
+];
+
+const kSettingsRanges = {
+  headerTableSize: [0, 2 ** 32 - 1],
+  maxConcurrentStreams: [0, 2 ** 32 - 1],
+  initialWindowSize: [0, 2 ** 31 - 1],
+  maxFrameSize: [16384, 2 ** 24 - 1],
+  maxHeaderListSize: [0, 2 ** 32 - 1]
+};
+
+const kDefaultSettings = {
+  headerTableSize: 4096,
+  enablePush: false,
+  maxConcurrentStreams: 100,
+  initialWindowSize: 65535,
+  maxFrameSize: 16384,
+  maxHeaderListSize: 65535
+};
+
+// Headers that belong to HTTP/1 connections (RFC 7540, 8.1.2.2).
+const kConnectionHeaders = new Set([
+  'connection',
+  'keep-alive',
+  'proxy-connection',
+  'transfer-encoding',
+  'upgrade'
+]);
+
+const kPseudoHeaders = new Set([':method', ':scheme', ':path', ':authority',
+                                ':status']);
+
+let tls;
+function lazyTls() {
+  if (tls === undefined)
+    tls = require('tls');
+  return tls;
+}
+
+
+function getDefaultSettings() {
+  return Object.assign({}, kDefaultSettings);
+}
+
+function validateSettings(settings) {
+  if (settings === null || typeof settings !== 'object')
+    throw new TypeError('"settings" must be an object');
+  kSettingsNames.forEach((name) => {
+    const value = settings[name];
+    if (value === undefined)
+      return;
+    if (name === 'enablePush') {
+      if (typeof value !== 'boolean')
+        throw new TypeError('"enablePush" must be a boolean');
+      return;
+    }
+    const range = kSettingsRanges[name];
+    if (!Number.isInteger(value) || value < range[0] || value > range[1]) {
+      throw new RangeError(`"${name}" must be an integer from ${range[0]} ` +
+                           `to ${range[1]}`);
+    }
+  });
+}
+
+function settingsToArray(settings) {
+  return kSettingsNames.map((name) => {
+    const value = settings[name];
+    if (typeof value === 'boolean')
+      return value ? 1 : 0;
+    return value;
+  });
+}
+
+function settingsFromArray(array) {
+  const settings = {};
+  kSettingsNames.forEach((name, i) => {
+    settings[name] = name === 'enablePush' ? array[i] === 1 : array[i];
+  });
+  return settings;
+}
+
+
+// Turns a headers object into the flat list of names and values that the
+// binding takes, with the pseudo-headers first.
+function toHeaderList(headers) {
+  const pseudo = [];
+  const regular = [];
+  const names = Object.keys(headers);
+  for (var i = 0; i < names.length; i++) {
+    const name = names[i].toLowerCase();
+    const value = headers[names[i]];
+    if (value === undefined || value === null)
+      continue;
+    if (name[0] === ':') {
+      if (!kPseudoHeaders.has(name))
+        throw new TypeError(`"${name}" is not a valid pseudo-header`);
+      if (Array.isArray(value))
+        throw new TypeError(`Header "${name}" must have a single value`);
+      pseudo.push(name, String(value));
+      continue;
+    }
+    if (kConnectionHeaders.has(name) ||
+        (name === 'te' && String(value) !== 'trailers')) {
+      throw new TypeError(`Header "${name}" is not valid in HTTP/2`);
+    }
+    if (Array.isArray(value)) {
+      for (var j = 0; j < value.length; j++)
+        regular.push(name, String(value[j]));
+    } else {
+      regular.push(name, String(value));
+    }
+  }
+  return pseudo.concat(regular);
+}
+
+// Turns the binding's flat list back into an object. Repeated headers are
+// joined like the HTTP/1 parser joins them, except that set-cookie headers
+// become an array and cookie headers are joined with '; ' (RFC 7540,
+// 8.1.2.5).
+function toHeaderObject(list) {
+  const headers = Object.create(null);
+  for (var i = 0; i < list.length; i += 2) {
+    const name = list[i];
+    const value = list[i + 1];
+    const existing = headers[name];
+    if (existing === undefined) {
+      headers[name] = name === 'set-cookie' ? [value] : value;
+    } else if (name === 'set-cookie') {
+      existing.push(value);
+    } else if (name === 'cookie') {
+      headers[name] = `${existing}; ${value}`;
+    } else {
+      headers[name] = `${existing}, ${value}`;
+    }
+  }
+  return headers;
+}
+
+
+function streamError(code) {
+  const err = new Error('Stream closed with error code ' +
+                        (errorNames[code] || code));
+  err.code = 'ERR_HTTP2_STREAM_ERROR';
+  err.errno = code;
+  return err;
+}
+
+function sessionError(code) {
+  const err = new Error('Session closed with error code ' +
+                        (errorNames[code] || code));
+  err.code = 'ERR_HTTP2_SESSION_ERROR';
+  err.errno = code;
+  return err;
+}
+
+
+// Callbacks of the native session. `this` is the handle.
+
+function onHeaders(id, category, list, endStream) {
+  const session = this[kOwner];
+  const headers = toHeaderObject(list);
+  const flags = endStream ? constants.FLAG_END_STREAM : 0;
+  debug('session %d headers on stream %d', session.type, id);
+
+  if (category === SessionHandle.HEADERS_REQUEST) {
+    const stream = new ServerHttp2Stream(session, id, headers);
+    session[kStreams].set(id, stream);
+    session.emit('stream', stream, headers, flags);
+    return;
+  }
+
+  const stream = session[kStreams].get(id);
+  if (stream === undefined)
+    return;
+  if (category === SessionHandle.HEADERS_RESPONSE)
+    stream.emit('response', headers, flags);
+  else if (category === SessionHandle.HEADERS_INFORMATIONAL)
+    stream.emit('headers', headers, flags);
+  else
+    stream.emit('trailers', headers, flags);
+}
+
+function onData(id, chunk) {
+  const stream = this[kOwner][kStreams].get(id);
+  // Data for streams that are gone does not have to wait for anyone.
+  if (stream === undefined)
+    return this.consumeData(id, chunk.length);
+  stream[kUnacked] += chunk.length;
+  if (stream.push(chunk))
+    acknowledge(stream);
+}
+
+function onStreamEnd(id) {
+  const stream = this[kOwner][kStreams].get(id);
+  if (stream !== undefined)
+    stream.push(null);
+}
+
+function onStreamClose(id, code) {
+  const session = this[kOwner];
+  const stream = session[kStreams].get(id);
+  if (stream !== undefined) {
+    let error = stream[kError];
+    if (code !== constants.NO_ERROR && !stream[kClosedLocally])
+      error = streamError(code);
+    closeStream(stream, code, error);
+  }
+  if (session instanceof ClientHttp2Session)
+    submitPendingRequests(session);
+  maybeFinishClose(session);
+}
+
+function onStreamDrain(id) {
+  const stream = this[kOwner][kStreams].get(id);
+  if (stream === undefined)
+    return;
+  const callback = stream[kWriteCallback];
+  if (callback !== null) {
+    stream[kWriteCallback] = null;
+    callback();
+  }
+}
+
+function onSettings(ack) {
+  const session = this[kOwner];
+  if (ack)
+    session.emit('localSettings', session.localSettings);
+  else
+    session.emit('remoteSettings', session.remoteSettings);
+}
+
+function onPingAck(payload) {
+  const session = this[kOwner];
+  const pings = session[kPings];
+  for (var i = 0; i < pings.length; i++) {
+    if (!pings[i].payload.equals(payload))
+      continue;
+    const ping = pings.splice(i, 1)[0];
+    const elapsed = process.hrtime(ping.start);
+    ping.callback(null, elapsed[0] * 1e3 + elapsed[1] / 1e6, payload);
+    return;
+  }
+}
+
+function onGoaway(code, lastStreamId, data) {
+  const session = this[kOwner];
+  session.emit('goaway', code, lastStreamId, data);
+  if (code === constants.NO_ERROR)
+    session.close();
+  else
+    session.destroy(sessionError(code));
+}
+
+function onError(code) {
+  this[kOwner].destroy(sessionError(code));
+}
+
+
+function acknowledge(stream) {
+  const unacked = stream[kUnacked];
+  if (unacked === 0)
+    return;
+  stream[kUnacked] = 0;
+  stream[kSession][kHandle].consumeData(stream[kId], unacked);
+}
+
+function closeStream(stream, code, error) {
+  if (stream.destroyed)
+    return;
+  stream.destroyed = true;
+  stream.rstCode = code;
+  stream[kSession][kStreams].delete(stream[kId]);
+  stream[kWriteCallback] = null;
+  if (!stream._readableState.ended)
+    stream.emit('aborted');
+  process.nextTick(emitStreamClose, stream, error);
+}
+
+function emitStreamClose(stream, error) {
+  if (error)
+    stream.emit('error', error);
+  stream.emit('close', stream.rstCode);
+}
+
+function onStreamFinish() {
+  if (this[kEndSent] || this.destroyed)
+    return;
+  // A request that is still waiting for its stream id.
+  if (this[kId] === undefined)
+    return this.once('ready', onStreamFinish);
+  const trailers = this[kTrailers];
+  // A response without a body still needs its headers.
+  if (this.sentHeaders === undefined) {
+    this.respond(undefined, { endStream: trailers === undefined });
+    if (this[kEndSent])
+      return;
+  }
+  this[kEndSent] = true;
+  this[kSession][kHandle].end(
+    this[kId], trailers === undefined ? undefined : toHeaderList(trailers));
+}
+
+function maybeFinishClose(session) {
+  if (session[kClosing] && session[kStreams].size === 0 &&
+      session[kPendingRequests].length === 0) {
+    session.destroy();
+  }
+}
+
+
+class Http2Stream extends Duplex {
+  constructor(session, options) {
+    super(Object.assign({ allowHalfOpen: true }, options));
+    this[kSession] = session;
+    this[kId] = undefined;
+    this[kUnacked] = 0;
+    this[kWriteCallback] = null;
+    this[kEndSent] = false;
+    this[kTrailers] = undefined;
+    this[kClosedLocally] = false;
+    this[kError] = null;
+    this.destroyed = false;
+    this.rstCode = undefined;
+    this.sentHeaders = undefined;
+    this.on('finish', onStreamFinish);
+  }
+
+  get id() {
+    return this[kId];
+  }
+
+  get session() {
+    return this[kSession];
+  }
+
+  _write(chunk, encoding, callback) {
+    if (this.destroyed)
+      return callback(new Error('The stream has been destroyed'));
+    const queued = this[kSession][kHandle].write(this[kId], chunk);
+    if (queued < 0)
+      return callback(new Error('The stream does not accept data'));
+    if (queued <= kStreamHighWaterMark)
+      return callback();
+    // Called from onStreamDrain().
+    this[kWriteCallback] = callback;
+  }
+
+  _read() {
+    if (this[kId] !== undefined)
+      acknowledge(this);
+  }
+
+  // Ends the writable side with a block of trailing headers.
+  sendTrailers(headers) {
+    if (headers === null || typeof headers !== 'object')
+      throw new TypeError('"headers" must be an object');
+    this[kTrailers] = headers;
+    this.end();
+  }
+
+  // Resets the stream with RST_STREAM.
+  close(code, callback) {
+    if (typeof code === 'function') {
+      callback = code;
+      code = undefined;
+    }
+    if (code === undefined)
+      code = constants.NO_ERROR;
+    if (!Number.isInteger(code) || code < 0 || code > 2 ** 32 - 1)
+      throw new TypeError('"code" must be an unsigned 32-bit integer');
+    if (typeof callback === 'function')
+      this.once('close', callback);
+    if (this.destroyed)
+      return;
+    this[kClosedLocally] = true;
+    if (this[kId] === undefined)
+      return closeStream(this, code, null);
+    this[kSession][kHandle].rstStream(this[kId], code);
+  }
+
+  destroy(error) {
+    if (this.destroyed)
+      return;
+    this[kClosedLocally] = true;
+    this[kError] = error || null;
+    if (this[kId] === undefined || this[kSession].destroyed)
+      return closeStream(this, constants.CANCEL, this[kError]);
+    // onStreamClose() reports the error once the reset is through.
+    this[kSession][kHandle].rstStream(this[kId], constants.CANCEL);
+  }
+}
+
+
+class ServerHttp2Stream extends Http2Stream {
+  constructor(session, id, headers) {
+    super(session);
+    this[kId] = id;
+    this[kRequest] = headers;
+  }
+
+  get headersSent() {
+    return this.sentHeaders !== undefined;
+  }
+
+  respond(headers, options) {
+    if (this.sentHeaders !== undefined)
+      throw new Error('Response has already been initiated');
+    headers = Object.assign({ ':status': 200 }, headers);
+    options = Object.assign({ endStream: false }, options);
+    const status = +headers[':status'];
+    if (!Number.isInteger(status) || status < 200 || status > 599)
+      throw new RangeError(`Invalid status code: ${headers[':status']}`);
+
+    // Responses to HEAD requests, and these statuses, have no body.
+    const endStream = options.endStream || status === 204 ||
+                      status === 304 || this[kRequest][':method'] === 'HEAD';
+    const list = toHeaderList(headers);
+    this.sentHeaders = headers;
+    if (this.destroyed)
+      return;
+    if (endStream)
+      this[kEndSent] = true;
+    this[kSession][kHandle].respond(this[kId], list, endStream);
+    if (endStream)
+      this.end();
+  }
+
+  // Sends an informational (1xx) response ahead of the final one.
+  additionalHeaders(headers) {
+    if (this.sentHeaders !== undefined)
+      throw new Error('Response has already been initiated');
+    if (headers === null || typeof headers !== 'object')
+      throw new TypeError('"headers" must be an object');
+    const status = +headers[':status'];
+    if (!Number.isInteger(status) || status < 100 || status > 199)
+      throw new RangeError(`Invalid status code: ${headers[':status']}`);
+    if (!this.destroyed)
+      this[kSession][kHandle].respond(this[kId], toHeaderList(headers), false);
+  }
+
+  _write(chunk, encoding, callback) {
+    if (this.sentHeaders === undefined)
+      this.respond();
+    super._write(chunk, encoding, callback);
+  }
+}
+
+
+class ClientHttp2Stream extends Http2Stream {
+  constructor(session, headers, endStream) {
+    super(session);
+    this.sentHeaders = headers;
+    this[kOptions] = { list: toHeaderList(headers), endStream };
+    if (endStream) {
+      this[kEndSent] = true;
+      this.end();
+    }
+  }
+
+  _write(chunk, encoding, callback) {
+    if (this[kId] === undefined)
+      return this.once('ready', () => this._write(chunk, encoding, callback));
+    super._write(chunk, encoding, callback);
+  }
+}
+
+// Requests wait for the session to connect, and for the peer to allow
+// another stream.
+function submitPendingRequests(session) {
+  const pending = session[kPendingRequests];
+  while (pending.length > 0 && !session.destroyed && session.connected) {
+    const stream = pending[0];
+    if (stream.destroyed) {
+      pending.shift();
+      continue;
+    }
+    const options = stream[kOptions];
+    const id = session[kHandle].request(options.list, options.endStream);
+    if (id === 0)
+      return;
+    pending.shift();
+    if (id < 0) {
+      const err = new Error('The session does not accept new streams');
+      err.code = 'ERR_HTTP2_GOAWAY_SESSION';
+      closeStream(stream, constants.REFUSED_STREAM, err);
+      continue;
+    }
+    stream[kId] = id;
+    session[kStreams].set(id, stream);
+    stream.emit('ready');
+  }
+  maybeFinishClose(session);
+}
+
+
+function socketOnError(error) {
+  const session = this[kSession];
+  if (session !== undefined)
+    session.destroy(error);
+}
+
+function socketOnClose() {
+  const session = this[kSession];
+  if (session !== undefined)
+    session.destroy();
+}
+
+class Http2Session extends EventEmitter {
+  constructor(type, options, socket) {
+    super();
+    options = Object.assign({}, options);
+    const settings = Object.assign(getDefaultSettings(), options.settings);
+    validateSettings(settings);
+
+    // The native side needs a StreamBase to read from and write to.
+    if (!(socket._handle && socket._handle._externalStream))
+      socket = new StreamWrap(socket);
+
+    this[kSocket] = socket;
+    this[kStreams] = new Map();
+    this[kPendingRequests] = [];
+    this[kPings] = [];
+    this[kSettings] = settings;
+    this[kClosing] = false;
+    this.destroyed = false;
+    this.connected = false;
+
+    const handle = new SessionHandle(type, settingsToArray(settings));
+    handle[kOwner] = this;
+    handle[kOnHeaders] = onHeaders;
+    handle[kOnData] = onData;
+    handle[kOnStreamEnd] = onStreamEnd;
+    handle[kOnStreamClose] = onStreamClose;
+    handle[kOnStreamDrain] = onStreamDrain;
+    handle[kOnSettings] = onSettings;
+    handle[kOnPingAck] = onPingAck;
+    handle[kOnGoaway] = onGoaway;
+    handle[kOnError] = onError;
+    this[kHandle] = handle;
+
+    socket[kSession] = this;
+    socket.on('error', socketOnError);
+    socket.on('close', socketOnClose);
+  }
+
+  get type() {
+    return this instanceof ServerHttp2Session ?
+      SessionHandle.SERVER : SessionHandle.CLIENT;
+  }
+
+  get socket() {
+    return this[kSocket];
+  }
+
+  get localSettings() {
+    return settingsFromArray(this[kHandle].getLocalSettings());
+  }
+
+  get remoteSettings() {
+    return settingsFromArray(this[kHandle].getRemoteSettings());
+  }
+
+  get state() {
+    const state = this[kHandle].getState();
+    return {
+      sendWindowSize: state[0],
+      receiveWindowSize: state[1],
+      streamCount: state[2],
+      lastPeerStreamId: state[3],
+      writeQueueSize: state[4]
+    };
+  }
+
+  // Starts the native session on the connected socket.
+  _start() {
+    if (this.destroyed)
+      return;
+    if (!this[kHandle].consume(this[kSocket]._handle._externalStream)) {
+      return this.destroy(new Error('The socket is already in use by ' +
+                                    'another consumer'));
+    }
+    this.connected = true;
+    this.emit('connect', this, this[kSocket]);
+  }
+
+  settings(settings) {
+    validateSettings(settings);
+    if (this.destroyed)
+      throw new Error('The session has been destroyed');
+    this[kSettings] = Object.assign({}, this[kSettings], settings);
+    this[kHandle].settings(settingsToArray(this[kSettings]));
+  }
+
+  ping(payload, callback) {
+    if (typeof payload === 'function') {
+      callback = payload;
+      payload = undefined;
+    }
+    if (typeof callback !== 'function')
+      throw new TypeError('"callback" must be a function');
+    if (payload === undefined) {
+      payload = Buffer.alloc(8);
+      payload.writeDoubleBE(Math.random(), 0);
+    }
+    if (!Buffer.isBuffer(payload) || payload.length !== 8)
+      throw new TypeError('"payload" must be a Buffer of 8 bytes');
+    if (this.destroyed)
+      throw new Error('The session has been destroyed');
+    this[kPings].push({ payload, callback, start: process.hrtime() });
+    if (this.connected)
+      this[kHandle].ping(payload);
+    else
+      this.once('connect', () => this[kHandle].ping(payload));
+  }
+
+  // Stops accepting new streams with a GOAWAY, and closes the session once
+  // the streams that are open have completed.
+  close(callback) {
+    if (typeof callback === 'function')
+      this.once('close', callback);
+    if (this[kClosing] || this.destroyed)
+      return;
+    this[kClosing] = true;
+    if (this.connected)
+      this[kHandle].goaway(constants.NO_ERROR);
+    maybeFinishClose(this);
+  }
+
+  destroy(error) {
+    if (this.destroyed)
+      return;
+    this.destroyed = true;
+    debug('session %d destroy', this.type);
+
+    for (const stream of this[kStreams].values())
+      closeStream(stream, constants.CANCEL, null);
+    for (const stream of this[kPendingRequests])
+      closeStream(stream, constants.CANCEL, null);
+    this[kPendingRequests] = [];
+    const pings = this[kPings];
+    this[kPings] = [];
+    for (const ping of pings) {
+      const err = new Error('The session was destroyed before the ping ' +
+                            'was acknowledged');
+      err.code = 'ERR_HTTP2_PING_CANCEL';
+      process.nextTick(ping.callback, err);
+    }
+
+    // What the session has queued, like a GOAWAY, is written before the
+    // socket ends.
+    this[kHandle].destroy();
+    const socket = this[kSocket];
+    if (!socket.destroyed)
+      socket.destroySoon();
+    process.nextTick(emitSessionClose, this, error);
+  }
+}
+
+function emitSessionClose(session, error) {
+  if (error)
+    session.emit('error', error);
+  session.emit('close');
+}
+
+
+class ServerHttp2Session extends Http2Session {
+  constructor(options, socket, server) {
+    super(SessionHandle.SERVER, options, socket);
+    this[kServer] = server;
+  }
+
+  get server() {
+    return this[kServer];
+  }
+}
+
+class ClientHttp2Session extends Http2Session {
+  constructor(options, socket, protocol, authority) {
+    super(SessionHandle.CLIENT, options, socket);
+    this[kProtocol] = protocol;
+    this[kAuthority] = authority;
+  }
+
+  request(headers, options) {
+    if (this.destroyed || this[kClosing])
+      throw new Error('The session is closed');
+    headers = Object.assign({
+      ':method': 'GET',
+      ':scheme': this[kProtocol],
+      ':authority': this[kAuthority],
+      ':path': '/'
+    }, headers);
+    if (headers[':method'] === 'CONNECT') {
+      headers[':scheme'] = undefined;
+      headers[':path'] = undefined;
+    }
+    options = Object.assign({ endStream: false }, options);
+    const stream = new ClientHttp2Stream(this, headers, !!options.endStream);
+    this[kPendingRequests].push(stream);
+    submitPendingRequests(this);
+    return stream;
+  }
+}
+
+function onClientConnect() {
+  const session = this[kSession];
+  if (session === undefined)
+    return;
+  if (this.encrypted && this.alpnProtocol !== 'h2') {
+    const err = new Error('The server does not speak HTTP/2');
+    err.code = 'ERR_HTTP2_ALPN_FAILED';
+    return session.destroy(err);
+  }
+  session._start();
+  if (session[kClosing])
+    session[kHandle].goaway(constants.NO_ERROR);
+  submitPendingRequests(session);
+}
+
+function connect(authority, options, listener) {
+  if (typeof options === 'function') {
+    listener = options;
+    options = undefined;
+  }
+  options = Object.assign({}, options);
+  if (typeof authority === 'string')
+    authority = url.parse(authority);
+  if (authority === null || typeof authority !== 'object')
+    throw new TypeError('"authority" must be a string, URL or object');
+
+  const protocol = authority.protocol || options.protocol || 'https:';
+  if (protocol !== 'http:' && protocol !== 'https:')
+    throw new Error(`Protocol "${protocol}" not supported`);
+  const host = authority.hostname || authority.host || 'localhost';
+  const port = +(authority.port || (protocol === 'http:' ? 80 : 443));
+
+  let socket;
+  let event;
+  if (typeof options.createConnection === 'function') {
+    socket = options.createConnection(authority, options);
+    event = 'connect';
+  } else if (protocol === 'http:') {
+    socket = net.connect(port, host);
+    event = 'connect';
+  } else {
+    socket = lazyTls().connect(port, host, Object.assign({
+      ALPNProtocols: ['h2'],
+      servername: net.isIP(host) ? undefined : host
+    }, options));
+    event = 'secureConnect';
+  }
+
+  const session = new ClientHttp2Session(options,
+                                         socket,
+                                         protocol.slice(0, -1),
+                                         `${host}:${port}`);
+  if (typeof listener === 'function')
+    session.once('connect', listener);
+  if (socket.connecting === false && event === 'connect')
+    process.nextTick(onClientConnect.bind(session.socket));
+  else
+    socket.once(event, onClientConnect);
+  return session;
+}
+
+
+function sessionOnStream(stream, headers, flags) {
+  this[kServer].emit('stream', stream, headers, flags);
+}
+
+function sessionOnError(error) {
+  const server = this[kServer];
+  if (server.listenerCount('sessionError') > 0)
+    server.emit('sessionError', error, this);
+}
+
+function connectionListener(socket) {
+  debug('new connection');
+  if (socket.encrypted && socket.alpnProtocol !== 'h2') {
+    if (!this.emit('unknownProtocol', socket))
+      socket.destroy();
+    return;
+  }
+  const session = new ServerHttp2Session(this[kOptions], socket, this);
+  session.on('stream', sessionOnStream);
+  session.on('error', sessionOnError);
+  this.emit('session', session);
+  session._start();
+}
+
+function setupServer(server, options, onStream) {
+  server[kOptions] = options;
+  if (typeof onStream === 'function')
+    server.on('stream', onStream);
+}
+
+class Http2Server extends net.Server {
+  constructor(options, onStream) {
+    super(connectionListener);
+    setupServer(this, options, onStream);
+  }
+}
+
+function createServer(options, onStream) {
+  if (typeof options === 'function') {
+    onStream = options;
+    options = undefined;
+  }
+  options = Object.assign({}, options);
+  validateSettings(Object.assign({}, options.settings));
+  return new Http2Server(options, onStream);
+}
+
+function createSecureServer(options, onStream) {
+  if (options === null || typeof options !== 'object')
+    throw new TypeError('"options" must be an object');
+  options = Object.assign({ ALPNProtocols: ['h2'] }, options);
+  validateSettings(Object.assign({}, options.settings));
+  const server = new (lazyTls().Server)(options, connectionListener);
+  setupServer(server, options, onStream);
+  return server;
+}
+
+
+module.exports = {
+  constants,
+  getDefaultSettings,
+  createServer,
+  createSecureServer,
+  connect,
+  Http2Session,
+  ServerHttp2Session,
+  ClientHttp2Session,
+  Http2Stream,
+  ServerHttp2Stream,
+  ClientHttp2Stream
+};
@@ -0,0 +1,87 @@
+'use strict';
+
+const EventEmitter = require('events');
+
+const hasInspector = process.config.variables.v8_enable_inspector === 1;
+if (!hasInspector)
+  throw new Error('The inspector is not available');
+
+const { Connection } = process.binding('inspector');
+
+const connectionSymbol = Symbol('connectionProperty');
+const messageCallbacksSymbol = Symbol('messageCallbacks');
+const nextIdSymbol = Symbol('nextId');
+const onMessageSymbol = Symbol('onMessage');
+
+// A session of the inspector protocol within the process. Messages are
+// dispatched synchronously on the main thread, so the callback of post() is
+// called before post() returns for nearly all methods.
+class Session extends EventEmitter {
+  constructor() {
+    super();
+    this[connectionSymbol] = null;
+    this[nextIdSymbol] = 1;
+    this[messageCallbacksSymbol] = new Map();
+  }
+
+  connect() {
+    if (this[connectionSymbol] !== null)
+      throw new Error('Already connected');
+    this[connectionSymbol] =
+        new Connection((message) => this[onMessageSymbol](message));
+  }
+
+  [onMessageSymbol](message) {
+    const parsed = JSON.parse(message);
+    if (parsed.id) {
+      const callback = this[messageCallbacksSymbol].get(parsed.id);
+      this[messageCallbacksSymbol].delete(parsed.id);
+      if (callback !== undefined) {
+        callback(parsed.error ? new Error(parsed.error.message) : null,
+                 parsed.result);
+      }
+    } else {
+      this.emit(parsed.method, parsed);
+      this.emit('inspectorNotification', parsed);
+    }
+  }
+
+  post(method, params, callback) {
+    if (typeof method !== 'string')
+      throw new TypeError('"method" argument must be a string');
+    if (callback === undefined && typeof params === 'function') {
+      callback = params;
+      params = null;
+    }
+    if (params !== null && params !== undefined && typeof params !== 'object')
+      throw new TypeError('"params" argument must be an object');
+    if (callback !== undefined && typeof callback !== 'function')
+      throw new TypeError('"callback" argument must be a function');
+    if (this[connectionSymbol] === null)
+      throw new Error('Session is not connected');
+
+    const id = this[nextIdSymbol]++;
+    const message = { id, method };
+    if (params)
+      message.params = params;
+    if (callback !== undefined)
+      this[messageCallbacksSymbol].set(id, callback);
+    this[connectionSymbol].dispatch(JSON.stringify(message));
+  }
+
+  disconnect() {
+    if (this[connectionSymbol] === null)
+      return;
+    this[connectionSymbol].disconnect();
+    this[connectionSymbol] = null;
+    const remainingCallbacks = this[messageCallbacksSymbol].values();
+    this[messageCallbacksSymbol] = new Map();
+    for (const callback of remainingCallbacks) {
+      process.nextTick(callback, new Error('Session was closed'));
+    }
+  }
+}
+
+module.exports = {
+  Session
+};
@@ -0,0 +1,108 @@
+'use strict';
+
+// Serves the files of the archive of --app-archive to lib/module.js, which
+// mounts it at the path of the archive: with --app-archive=/srv/app.nar,
+// require('/srv/app.nar/lib/a') loads lib/a.js out of the archive. The archive
+// is mapped into memory once, so that resolving and loading the modules in it
+// does not touch the file system. An archive is laid out as:
+//
+//   magic    the 8 bytes 'NODEAR01'
+//   uint32le length of the index
+//   index    JSON of { wrapper, files: { [path]: [offset, size, cache...] } }
+//   data     the contents of the files, and their code caches
+//
+// The paths of the index are relative to the root of the archive and use '/'.
+// The offsets are relative to the start of the data. A .js file can also have
+// the offset and size of the V8 code cache of its module wrapper, which was
+// Module.wrap('') === wrapper when the archive was made.
+// tools/pack_app_archive.js makes archives.
+
+const Buffer = require('buffer').Buffer;
+const path = require('path');
+
+const MAGIC = 'NODEAR01';
+const HEADER_LENGTH = MAGIC.length + 4;
+const UV_ENOENT = process.binding('uv').UV_ENOENT;
+
+const configPath = process.binding('config').appArchive;
+const root = configPath !== undefined ? path.resolve(configPath) : undefined;
+
+var binding;
+var arrayBuffer;
+var dataStart;
+var wrapper;
+const files = new Map();
+const directories = new Set();
+
+function open() {
+  binding = process.binding('app_archive');
+  arrayBuffer = binding.map(root);
+  const buffer = Buffer.from(arrayBuffer);
+  if (buffer.length < HEADER_LENGTH ||
+      buffer.toString('latin1', 0, MAGIC.length) !== MAGIC) {
+    throw new Error(`${root} is not an application archive`);
+  }
+  const indexLength = buffer.readUInt32LE(MAGIC.length);
+  dataStart = HEADER_LENGTH + indexLength;
+  const index = JSON.parse(buffer.toString('utf8', HEADER_LENGTH, dataStart));
+  wrapper = index.wrapper;
+
+  directories.add('');
+  for (const name of Object.keys(index.files)) {
+    files.set(name, index.files[name]);
+    for (var i = name.lastIndexOf('/'); i > 0; i = name.lastIndexOf('/', i - 1))
+      directories.add(name.slice(0, i));
+  }
+}
+
+if (root !== undefined)
+  open();
+
+// Returns the path of |filename| in the archive, or null if it is outside.
+// |filename| must be absolute and normalized.
+function relative(filename) {
+  if (root === undefined || !filename.startsWith(root))
+    return null;
+  if (filename.length === root.length)
+    return '';
+  if (filename[root.length] !== path.sep)
+    return null;
+  const name = filename.slice(root.length + 1);
+  return path.sep === '/' ? name : name.replace(/\\/g, '/');
+}
+
+// Like internalModuleStat(): 0 for a file, 1 for a directory and a negative
+// error code if there is neither at |filename| in the archive.
+function stat(filename) {
+  const name = relative(filename);
+  if (files.has(name))
+    return 0;
+  return directories.has(name) ? 1 : UV_ENOENT;
+}
+
+// Returns the contents of |filename| as a string, or undefined if the archive
+// has no such file.
+function readFile(filename) {
+  const entry = files.get(relative(filename));
+  if (entry === undefined)
+    return undefined;
+  return binding.source(arrayBuffer, dataStart + entry[0], entry[1]);
+}
+
+// Returns the code cache of |filename| for the module wrapper |emptyWrapper|,
+// which is what it makes of an empty source, or undefined if there is none.
+function codeCache(filename, emptyWrapper) {
+  const entry = files.get(relative(filename));
+  if (entry === undefined || entry.length < 4 || emptyWrapper !== wrapper)
+    return undefined;
+  return Buffer.from(arrayBuffer, dataStart + entry[2], entry[3]);
+}
+
+module.exports = {
+  enabled: root !== undefined,
+  root,
+  contains: (filename) => relative(filename) !== null,
+  stat,
+  readFile,
+  codeCache
+};
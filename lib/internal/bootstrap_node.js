@@ -37,7 +37,10 @@
 
     _process.setup_hrtime();
     _process.setup_cpuUsage();
+    _process.setupResourceUsage();
     _process.setupMemoryUsage();
+    _process.setupLoopMetrics();
+    _process.setupCounters();
     _process.setupConfig(NativeModule._source);
     NativeModule.require('internal/process/warning').setup();
     NativeModule.require('internal/process/next_tick').setup();
@@ -70,7 +73,13 @@
     // others like the debugger or running --eval arguments. Here we decide
     // which mode we run in.
 
-    if (NativeModule.exists('_third_party_main')) {
+    if (!process.binding('worker').isMainThread) {
+      // A worker thread runs the file it was started with, see
+      // lib/internal/worker.js.
+      NativeModule.require('internal/worker').setupChild();
+      NativeModule.require('module').runMain();
+
+    } else if (NativeModule.exists('_third_party_main')) {
       // To allow people to extend Node in different ways, this hook allows
       // one to drop a file lib/_third_party_main.js into the build
       // directory which will be executed instead of Node's normal loading.
@@ -462,6 +471,8 @@
   // node binary, so they can be loaded faster.
 
   const ContextifyScript = process.binding('contextify').ContextifyScript;
+  // The V8 code caches of the core modules, if the build has them.
+  const codeCache = process.binding('code_cache');
   function runInThisContext(code, options) {
     const script = new ContextifyScript(code, options);
     return script.runInThisContext();
@@ -552,7 +563,8 @@
       const fn = runInThisContext(source, {
         filename: this.filename,
         lineOffset: 0,
-        displayErrors: true
+        displayErrors: true,
+        cachedData: codeCache.get(this.id)
       });
       fn(this.exports, NativeModule.require, this, this.filename);
 
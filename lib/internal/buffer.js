@@ -22,14 +22,68 @@ function transcode(source, fromEncoding, toEncoding) {
   const result = icu.transcode(source, fromEncoding, toEncoding);
   if (typeof result !== 'number')
     return result;
+  throwTranscodeError(result);
+}
 
-  const code = icu.icuErrName(result);
+function throwTranscodeError(errno) {
+  const code = icu.icuErrName(errno);
   const err = new Error(`Unable to transcode Buffer [${code}]`);
   err.code = code;
-  err.errno = result;
+  err.errno = errno;
   throw err;
 }
 
+// ICU converter names of the encodings that Buffers use. Other names go to
+// ICU as they are.
+const converterNames = {
+  ascii: 'us-ascii',
+  latin1: 'iso8859-1',
+  utf16le: 'utf16le',
+  utf8: 'utf-8'
+};
+
+function converterName(encoding) {
+  if (typeof encoding !== 'string')
+    throw new TypeError('"encoding" argument must be a string');
+  const normalized = normalizeEncoding(encoding);
+  const name = normalized === undefined ?
+    encoding : converterNames[normalized];
+  if (name === undefined)
+    throw new TypeError(`Unknown encoding: ${encoding}`);
+  return name;
+}
+
+// Transcodes input that comes in chunks. Characters split between chunks
+// come out whole in the Buffer returned for the later chunk.
+class Transcoder {
+  constructor(fromEncoding, toEncoding) {
+    const from = converterName(fromEncoding);
+    const to = converterName(toEncoding);
+    this._handle = new icu.Transcoder();
+    const result = this._handle.open(from, to);
+    if (result !== 0)
+      throwTranscodeError(result);
+  }
+
+  write(chunk) {
+    return convert(this, chunk, false);
+  }
+
+  end(chunk) {
+    return convert(this, chunk === undefined ? Buffer.alloc(0) : chunk, true);
+  }
+}
+
+function convert(transcoder, chunk, flush) {
+  if (!isUint8Array(chunk))
+    throw new TypeError('"chunk" argument must be a Buffer or Uint8Array');
+  const result = transcoder._handle.convert(chunk, flush);
+  if (typeof result !== 'number')
+    return result;
+  throwTranscodeError(result);
+}
+
 module.exports = {
-  transcode
+  transcode,
+  Transcoder
 };
@@ -1,6 +1,5 @@
 'use strict';
 
-const StringDecoder = require('string_decoder').StringDecoder;
 const EventEmitter = require('events');
 const net = require('net');
 const dgram = require('dgram');
@@ -15,6 +14,7 @@ const TTY = process.binding('tty_wrap').TTY;
 const TCP = process.binding('tcp_wrap').TCP;
 const UDP = process.binding('udp_wrap').UDP;
 const SocketList = require('internal/socket_list');
+const serialization = require('internal/child_process/serialization');
 const { isUint8Array } = process.binding('util');
 const { convertToValidSignal } = require('internal/util');
 
@@ -32,6 +32,13 @@ const handleConversion = {
       return handle;
     },
 
+    postSend: function(handle, options, target) {
+      // Unlike sockets, native handles are only closed after being sent when
+      // asked to, as the cluster module does for the connections it passes.
+      if (options.keepOpen === false)
+        handleConversion['net.Socket'].postSend(handle, options, target);
+    },
+
     got: function(message, handle, emit) {
       emit(handle);
     }
@@ -257,6 +264,13 @@ ChildProcess.prototype.spawn = function(options) {
   if (options === null || typeof options !== 'object')
     throw new TypeError('"options" must be an object');
 
+  const serializationMode = options.serialization || 'json';
+  if (serializationMode !== 'json' && serializationMode !== 'advanced')
+    throw new TypeError('"serialization" must be "json" or "advanced"');
+
+  // Windows pipes pass one handle at a time and rely on the ACKs.
+  const batchHandles = !!options.batchHandles && process.platform !== 'win32';
+
   // If no `stdio` option was given - use default
   var stdio = options.stdio || 'pipe';
 
@@ -274,6 +288,10 @@ ChildProcess.prototype.spawn = function(options) {
       throw new TypeError('"envPairs" must be an array');
 
     options.envPairs.push('NODE_CHANNEL_FD=' + ipcFd);
+    options.envPairs.push('NODE_CHANNEL_SERIALIZATION_MODE=' +
+                          serializationMode);
+    if (batchHandles)
+      options.envPairs.push('NODE_CHANNEL_BATCH_HANDLES=1');
   }
 
   if (typeof options.file === 'string')
@@ -355,7 +373,8 @@ ChildProcess.prototype.spawn = function(options) {
     this.stdio.push(stdio[i].socket === undefined ? null : stdio[i].socket);
 
   // Add .send() method and start listening for IPC data
-  if (ipc !== undefined) setupChannel(this, ipc);
+  if (ipc !== undefined)
+    setupChannel(this, ipc, serializationMode, batchHandles);
 
   return err;
 };
@@ -421,7 +440,11 @@ class Control extends EventEmitter {
   }
 }
 
-function setupChannel(target, channel) {
+// The most handles that go in one NODE_HANDLES message, as many as libuv
+// takes with one read.
+const kMaxBatchHandles = 64;
+
+function setupChannel(target, channel, serializationMode, batchHandles) {
   target.channel = channel;
 
   // _channel can be deprecated in version 8
@@ -436,40 +459,46 @@ function setupChannel(target, channel) {
 
   const control = new Control(channel);
 
-  var decoder = new StringDecoder('utf8');
-  var jsonBuffer = '';
-  channel.buffering = false;
+  const {
+    initMessageChannel,
+    parseChannelMessages,
+    writeChannelMessage,
+    writeChannelHandles
+  } = serialization[serializationMode];
+
+  // Handles arrive with the first byte of the message that they belong to,
+  // which is not always complete in the same read, so they wait here in
+  // order. A NODE_HANDLES message can come with several at once.
+  const receivedHandles = [];
+
+  initMessageChannel(channel);
   channel.onread = function(nread, pool, recvHandle) {
+    if (Array.isArray(recvHandle))
+      receivedHandles.push.apply(receivedHandles, recvHandle);
+    else if (recvHandle !== undefined)
+      receivedHandles.push(recvHandle);
+
     // TODO(bnoordhuis) Check that nread > 0.
     if (pool) {
-      // Linebreak is used as a message end sign
-      var chunks = decoder.write(pool).split('\n');
-      var numCompleteChunks = chunks.length - 1;
-      // Last line does not have trailing linebreak
-      var incompleteChunk = chunks[numCompleteChunks];
-      if (numCompleteChunks === 0) {
-        jsonBuffer += incompleteChunk;
-        this.buffering = jsonBuffer.length !== 0;
-        return;
-      }
-      chunks[0] = jsonBuffer + chunks[0];
-
-      for (var i = 0; i < numCompleteChunks; i++) {
-        var message = JSON.parse(chunks[i]);
-
-        // There will be at most one NODE_HANDLE message in every chunk we
-        // read because SCM_RIGHTS messages don't get coalesced. Make sure
-        // that we deliver the handle with the right message however.
-        if (message && message.cmd === 'NODE_HANDLE')
-          handleMessage(target, message, recvHandle);
-        else
+      parseChannelMessages(channel, pool, function(message) {
+        if (message && message.cmd === 'NODE_HANDLE') {
+          handleMessage(target, message, receivedHandles.shift());
+        } else if (message && message.cmd === 'NODE_HANDLES' &&
+                   Array.isArray(message.msgs)) {
+          handleMessage(target,
+                        message,
+                        receivedHandles.splice(0, message.msgs.length));
+        } else {
           handleMessage(target, message, undefined);
-      }
-      jsonBuffer = incompleteChunk;
-      this.buffering = jsonBuffer.length !== 0;
-
+        }
+      });
     } else {
       this.buffering = false;
+      for (var i = 0; i < receivedHandles.length; i++) {
+        if (receivedHandles[i])
+          receivedHandles[i].close();
+      }
+      receivedHandles.length = 0;
       target.disconnect();
       channel.onread = nop;
       channel.close();
@@ -506,6 +535,13 @@ function setupChannel(target, channel) {
       return;
     }
 
+    // Batched handles are not acknowledged, the sender does not wait.
+    if (message.cmd === 'NODE_HANDLES' && Array.isArray(handle)) {
+      for (var j = 0; j < message.msgs.length; j++)
+        receiveHandle(message.msgs[j], handle[j]);
+      return;
+    }
+
     if (message.cmd !== 'NODE_HANDLE') return;
 
     // Acknowledge handle receival. Don't emit error events (for example if
@@ -514,6 +550,10 @@ function setupChannel(target, channel) {
     // a message.
     target._send({ cmd: 'NODE_HANDLE_ACK' }, null, true);
 
+    receiveHandle(message, handle);
+  });
+
+  function receiveHandle(message, handle) {
     var obj = handleConversion[message.type];
 
     // Update simultaneous accepts on Windows
@@ -523,10 +563,112 @@ function setupChannel(target, channel) {
     }
 
     // Convert handle object
-    obj.got.call(this, message, handle, function(handle) {
+    obj.got.call(target, message, handle, function(handle) {
       handleMessage(target, message.msg, handle);
     });
-  });
+  }
+
+  // With batchHandles, handles are sent without waiting for a
+  // NODE_HANDLE_ACK for each. Those sent in the same tick, up to
+  // kMaxBatchHandles, go together in one NODE_HANDLES message and, where
+  // the pipe allows, one sendmsg().
+  var batch = null;
+
+  function batchHandle(message, handle, options, callback) {
+    var obj = handleConversion[message.type];
+    handle = obj.send.call(target, message, handle, options);
+
+    // As below, send just the message if there is no handle to send.
+    if (!handle)
+      return target._send(message.msg, null, options, callback);
+
+    if (batch === null) {
+      batch = [];
+      process.nextTick(flushHandles);
+    }
+    batch.push({
+      callback: callback,
+      handle: handle,
+      options: options,
+      message: message,
+      obj: obj
+    });
+    if (batch.length === kMaxBatchHandles)
+      flushHandles();
+
+    return channel.writeQueueSize < (65536 * 2);
+  }
+
+  function flushHandles() {
+    var entries = batch;
+    if (entries === null)
+      return;
+    batch = null;
+    writeHandles(entries);
+  }
+
+  function writeHandles(entries) {
+    var message = {
+      cmd: 'NODE_HANDLES',
+      msgs: entries.map((entry) => entry.message)
+    };
+    var req = new WriteWrap();
+    req.async = false;
+
+    var err;
+    if (entries.length === 1) {
+      err = writeChannelMessage(channel, req, message, entries[0].handle);
+    } else {
+      err = writeChannelHandles(channel,
+                                req,
+                                message,
+                                entries.map((entry) => entry.handle));
+      // Earlier writes are still queued or the pipe is full. libuv can
+      // queue the handles one at a time instead.
+      if (err === uv.UV_EAGAIN) {
+        for (var i = 0; i < entries.length; i++)
+          writeHandles([entries[i]]);
+        return;
+      }
+    }
+
+    if (err === 0) {
+      req.oncomplete = function() {
+        if (this.async === true)
+          control.unref();
+        for (var i = 0; i < entries.length; i++) {
+          var entry = entries[i];
+          // The other process has its own copy of the handle now.
+          if (entry.obj.postSend)
+            entry.obj.postSend(entry.handle, entry.options);
+          if (typeof entry.callback === 'function')
+            entry.callback(null);
+        }
+      };
+      if (req.async === true) {
+        control.ref();
+      } else {
+        process.nextTick(function() { req.oncomplete(); });
+      }
+      return;
+    }
+
+    for (var k = 0; k < entries.length; k++) {
+      var entry = entries[k];
+      // Cleanup handle on error
+      if (entry.obj.postSend)
+        entry.obj.postSend(entry.handle, entry.options);
+
+      if (!entry.options.swallowErrors) {
+        const ex = errnoException(err, 'write');
+        if (typeof entry.callback === 'function') {
+          process.nextTick(entry.callback, ex);
+        } else {
+          target.emit('error', ex);  // FIXME(bnoordhuis) Defer to next tick.
+        }
+      }
+    }
+  }
 
   target.send = function(message, handle, options, callback) {
     if (typeof handle === 'function') {
@@ -589,6 +731,9 @@ function setupChannel(target, channel) {
         throw new TypeError('This handle type can\'t be sent');
       }
 
+      if (batchHandles)
+        return batchHandle(message, handle, options, callback);
+
       // Queue-up message and handle if we haven't received ACK yet.
       if (this._handleQueue) {
         this._handleQueue.push({
@@ -627,13 +772,15 @@ function setupChannel(target, channel) {
         message: message,
       });
       return this._handleQueue.length === 1;
+    } else if (batch !== null) {
+      // Keep the message behind the handles that were sent before it.
+      flushHandles();
     }
 
     var req = new WriteWrap();
     req.async = false;
 
-    var string = JSON.stringify(message) + '\n';
-    var err = channel.writeUtf8String(req, string, handle);
+    var err = writeChannelMessage(channel, req, message, handle);
 
     if (err === 0) {
       if (handle) {
@@ -690,6 +837,9 @@ function setupChannel(target, channel) {
       return;
     }
 
+    // Send the handles of this tick first.
+    flushHandles();
+
     // Do not allow any new messages to be written.
     this.connected = false;
 
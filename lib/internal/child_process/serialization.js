@@ -0,0 +1,120 @@
+'use strict';
+
+const { Buffer } = require('buffer');
+const { StringDecoder } = require('string_decoder');
+const v8 = require('v8');
+
+const kMessageBuffer = Symbol('kMessageBuffer');
+const kMessageBufferSize = Symbol('kMessageBufferSize');
+const kStringDecoder = Symbol('kStringDecoder');
+const kJSONBuffer = Symbol('kJSONBuffer');
+const kLengthPlaceholder = Buffer.alloc(4);
+
+// Each serialization mode knows how to frame messages on an IPC channel.
+// `parseChannelMessages()` calls `onMessage` for every complete message in
+// `readData` and sets `channel.buffering` while part of one is pending.
+// `writeChannelHandles()` sends one message with several handles, see
+// `writeHandles()` in src/stream_base.cc.
+
+// Messages are newline-terminated JSON strings.
+const json = {
+  initMessageChannel(channel) {
+    channel[kStringDecoder] = new StringDecoder('utf8');
+    channel[kJSONBuffer] = '';
+    channel.buffering = false;
+  },
+
+  parseChannelMessages(channel, readData, onMessage) {
+    // Linebreak is used as a message end sign
+    const chunks = channel[kStringDecoder].write(readData).split('\n');
+    const numCompleteChunks = chunks.length - 1;
+    // Last line does not have trailing linebreak
+    const incompleteChunk = chunks[numCompleteChunks];
+    if (numCompleteChunks === 0) {
+      channel[kJSONBuffer] += incompleteChunk;
+      channel.buffering = channel[kJSONBuffer].length !== 0;
+      return;
+    }
+    chunks[0] = channel[kJSONBuffer] + chunks[0];
+    channel[kJSONBuffer] = incompleteChunk;
+    channel.buffering = incompleteChunk.length !== 0;
+
+    for (var i = 0; i < numCompleteChunks; i++)
+      onMessage(JSON.parse(chunks[i]));
+  },
+
+  writeChannelMessage(channel, req, message, handle) {
+    const string = JSON.stringify(message) + '\n';
+    return channel.writeUtf8String(req, string, handle);
+  },
+
+  writeChannelHandles(channel, req, message, handles) {
+    const buffer = Buffer.from(JSON.stringify(message) + '\n');
+    return channel.writeHandles(req, buffer, handles);
+  }
+};
+
+// Messages are written with the V8 serializer and prefixed with their
+// length as a 32-bit big-endian integer, so that a reader only has to look
+// at the first four bytes of a frame to know whether all of it is there.
+const advanced = {
+  initMessageChannel(channel) {
+    channel[kMessageBuffer] = [];
+    channel[kMessageBufferSize] = 0;
+    channel.buffering = false;
+  },
+
+  parseChannelMessages(channel, readData, onMessage) {
+    var chunks = channel[kMessageBuffer];
+    var size = channel[kMessageBufferSize] + readData.length;
+    chunks.push(readData);
+
+    while (size >= 4) {
+      var first = chunks[0];
+      if (first.length < 4) {
+        first = Buffer.concat(chunks, size);
+        chunks = [first];
+      }
+      const frameSize = first.readUInt32BE(0) + 4;
+      if (size < frameSize)
+        break;
+
+      // Only copy once the whole frame has arrived.
+      const frame = chunks.length === 1 ? first : Buffer.concat(chunks, size);
+      chunks = size > frameSize ? [frame.slice(frameSize)] : [];
+      size -= frameSize;
+      channel[kMessageBuffer] = chunks;
+      channel[kMessageBufferSize] = size;
+
+      const der = new v8.DefaultDeserializer(frame.slice(4, frameSize));
+      der.readHeader();
+      onMessage(der.readValue());
+    }
+
+    channel[kMessageBuffer] = chunks;
+    channel[kMessageBufferSize] = size;
+    channel.buffering = size !== 0;
+  },
+
+  writeChannelMessage(channel, req, message, handle) {
+    return channel.writeBuffer(req, serializeFrame(message), handle);
+  },
+
+  writeChannelHandles(channel, req, message, handles) {
+    return channel.writeHandles(req, serializeFrame(message), handles);
+  }
+};
+
+function serializeFrame(message) {
+  // Reserve the length prefix in the serializer's own buffer and fill it
+  // in afterwards, so that the serialized data is not copied again.
+  const ser = new v8.DefaultSerializer();
+  ser.writeRawBytes(kLengthPlaceholder);
+  ser.writeHeader();
+  ser.writeValue(message);
+  const frame = ser.releaseBuffer();
+  frame.writeUInt32BE(frame.length - 4, 0);
+  return frame;
+}
+
+module.exports = { json, advanced };
@@ -7,6 +7,7 @@ const { internal, sendHelper } = require('internal/cluster/utils');
 const cluster = new EventEmitter();
 const handles = {};
 const indexes = {};
+const loads = {};
 const noop = () => {};
 
 module.exports = cluster;
@@ -74,6 +75,8 @@ cluster._getServer = function(obj, options, cb) {
 
     if (handle)
       shared(reply, handle, indexesKey, cb);  // Shared listen socket.
+    else if (reply.reusePort)
+      cb(reply.errno, null);                  // Bind our own socket.
     else
       rr(reply, indexesKey, cb);              // Round-robin.
   });
@@ -131,6 +134,7 @@ function rr(message, indexesKey, cb) {
     send({ act: 'close', key });
     delete handles[key];
     delete indexes[indexesKey];
+    delete loads[key];
     key = undefined;
   }
 
@@ -153,6 +157,7 @@ function rr(message, indexesKey, cb) {
 
   assert(handles[key] === undefined);
   handles[key] = handle;
+  loads[key] = { key, received: 0, connections: 0, scheduled: false };
   cb(0, handle);
 }
 
@@ -160,12 +165,59 @@ function rr(message, indexesKey, cb) {
 function onconnection(message, handle) {
   const key = message.key;
   const server = handles[key];
-  const accepted = server !== undefined;
+  const load = loads[key];
+
+  if (server === undefined) {
+    // The server has closed. Give the connection back to the master for
+    // another worker.
+    if (process.connected) {
+      sendHelper(process, { act: 'returnconn', key }, handle, null,
+                 { keepOpen: false });
+    } else {
+      handle.close();
+    }
+    return;
+  }
+
+  load.received++;
+  server.onconnection(0, handle);
+
+  // The socket, unless the server turned the connection away.
+  const socket = handle.owner;
 
-  send({ ack: message.seq, accepted });
+  if (socket !== undefined) {
+    load.connections++;
+    socket.once('close', () => {
+      load.connections--;
+      scheduleLoad(load);
+    });
+  }
+
+  scheduleLoad(load);
+}
 
-  if (accepted)
-    server.onconnection(0, handle);
+// Tells the master how busy the server is, once for all of the connections
+// that come and go in an iteration of the event loop.
+function scheduleLoad(load) {
+  if (load.scheduled)
+    return;
+
+  load.scheduled = true;
+  setImmediate(sendLoad, load);
+}
+
+function sendLoad(load) {
+  load.scheduled = false;
+
+  if (loads[load.key] !== load)
+    return;  // Server has closed.
+
+  send({
+    act: 'load',
+    key: load.key,
+    received: load.received,
+    connections: load.connections
+  });
 }
 
 function send(message, cb) {
@@ -12,6 +12,7 @@ const cluster = new EventEmitter();
 const intercom = new EventEmitter();
 const SCHED_NONE = 1;
 const SCHED_RR = 2;
+const SCHED_REUSEPORT = 3;
 
 module.exports = cluster;
 
@@ -22,15 +23,19 @@ cluster.workers = {};
 cluster.settings = {};
 cluster.SCHED_NONE = SCHED_NONE;  // Leave it to the operating system.
 cluster.SCHED_RR = SCHED_RR;      // Master distributes connections.
+cluster.SCHED_REUSEPORT = SCHED_REUSEPORT;  // Workers bind with SO_REUSEPORT.
 
 var ids = 0;
 var debugPortOffset = 1;
 var initialized = false;
+// Server data shared between SCHED_REUSEPORT workers, keyed by address.
+const reusePortData = {};
 
 // XXX(bnoordhuis) Fold cluster.schedulingPolicy into cluster.settings?
 var schedulingPolicy = {
   'none': SCHED_NONE,
-  'rr': SCHED_RR
+  'rr': SCHED_RR,
+  'reuseport': SCHED_REUSEPORT
 }[process.env.NODE_CLUSTER_SCHED_POLICY];
 
 if (schedulingPolicy === undefined) {
@@ -67,7 +72,9 @@ cluster.setupMaster = function(options) {
 
   initialized = true;
   schedulingPolicy = cluster.schedulingPolicy;  // Freeze policy.
-  assert(schedulingPolicy === SCHED_NONE || schedulingPolicy === SCHED_RR,
+  assert(schedulingPolicy === SCHED_NONE ||
+         schedulingPolicy === SCHED_RR ||
+         schedulingPolicy === SCHED_REUSEPORT,
          `Bad cluster.schedulingPolicy: ${schedulingPolicy}`);
 
   const hasDebugArg = process.execArgv.some((argv) => {
@@ -134,7 +141,9 @@ function createWorkerProcess(id, env) {
     execArgv: execArgv,
     stdio: cluster.settings.stdio,
     gid: cluster.settings.gid,
-    uid: cluster.settings.uid
+    uid: cluster.settings.uid,
+    serialization: cluster.settings.serialization,
+    batchHandles: cluster.settings.batchHandles
   });
 }
 
@@ -252,6 +261,10 @@ function onmessage(message, handle) {
     exitedAfterDisconnect(worker, message);
   else if (message.act === 'close')
     close(worker, message);
+  else if (message.act === 'load')
+    load(worker, message);
+  else if (message.act === 'returnconn')
+    returnconn(worker, message, handle);
 }
 
 function online(worker) {
@@ -270,6 +283,29 @@ function queryServer(worker, message) {
   if (worker.exitedAfterDisconnect)
     return;
 
+  // Under SCHED_REUSEPORT the master doesn't own TCP listen sockets at all.
+  // Every worker binds its own socket with SO_REUSEPORT and the kernel
+  // distributes incoming connections across them.
+  // The first worker's server data (e.g. TLS ticket key material) is handed
+  // to every other worker listening on the same address.
+  if (schedulingPolicy === SCHED_REUSEPORT &&
+      (message.addressType === 4 || message.addressType === 6) &&
+      typeof message.fd !== 'number') {
+    const reusePortKey = [message.address,
+                          message.port,
+                          message.addressType,
+                          message.index].join(':');
+    if (reusePortData[reusePortKey] === undefined)
+      reusePortData[reusePortKey] = message.data;
+    send(worker, {
+      errno: 0,
+      ack: message.seq,
+      data: reusePortData[reusePortKey],
+      reusePort: true
+    });
+    return;
+  }
+
   const args = [message.address,
                 message.port,
                 message.addressType,
@@ -339,6 +375,24 @@ function close(worker, message) {
     delete handles[key];
 }
 
+// Round-robin. The worker's connection count for the server.
+function load(worker, message) {
+  const handle = handles[message.key];
+
+  if (handle instanceof RoundRobinHandle)
+    handle.update(worker, message.received, message.connections);
+}
+
+// Round-robin. A connection that reached a worker after its server closed.
+function returnconn(worker, message, conn) {
+  const handle = handles[message.key];
+
+  if (handle instanceof RoundRobinHandle)
+    handle.distribute(0, conn);
+  else
+    conn.close();
+}
+
 function send(worker, message, handle, cb) {
   return sendHelper(worker.process, message, handle, cb);
 }
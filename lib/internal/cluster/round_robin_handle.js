@@ -5,14 +5,19 @@ const { sendHelper } = require('internal/cluster/utils');
 const getOwnPropertyNames = Object.getOwnPropertyNames;
 const uv = process.binding('uv');
 
+// How many connections can be on their way to a worker before it reports
+// them. The others wait in the master, where any worker can still take them.
+const kMaxPending = 16;
+
 module.exports = RoundRobinHandle;
 
 function RoundRobinHandle(key, address, port, addressType, fd) {
   this.key = key;
   this.all = {};
-  this.free = [];
+  this.loads = {};
   this.handles = [];
   this.handle = null;
+  this.handoffs = 0;
   this.server = net.createServer(assert.fail);
 
   if (fd >= 0)
@@ -33,6 +38,8 @@ function RoundRobinHandle(key, address, port, addressType, fd) {
 RoundRobinHandle.prototype.add = function(worker, send) {
   assert(worker.id in this.all === false);
   this.all[worker.id] = worker;
+  // What the worker last reported, and what has been sent to it since.
+  this.loads[worker.id] = { connections: 0, received: 0, sent: 0, last: 0 };
 
   const done = () => {
     if (this.handle.getsockname) {
@@ -44,7 +51,7 @@ RoundRobinHandle.prototype.add = function(worker, send) {
       send(null, null, null);  // UNIX socket.
     }
 
-    this.handoff(worker);  // In case there are connections pending.
+    this.handoff();  // In case there are connections pending.
   };
 
   if (this.server === null)
@@ -66,10 +73,7 @@ RoundRobinHandle.prototype.remove = function(worker) {
     return false;
 
   delete this.all[worker.id];
-  const index = this.free.indexOf(worker);
-
-  if (index !== -1)
-    this.free.splice(index, 1);
+  delete this.loads[worker.id];
 
   if (getOwnPropertyNames(this.all).length !== 0)
     return false;
@@ -83,33 +87,74 @@ RoundRobinHandle.prototype.remove = function(worker) {
 };
 
 RoundRobinHandle.prototype.distribute = function(err, handle) {
-  this.handles.push(handle);
-  const worker = this.free.shift();
+  if (err)
+    return;  // Failed accept, there is no connection.
 
-  if (worker)
-    this.handoff(worker);
+  this.handles.push(handle);
+  this.handoff();
 };
 
-RoundRobinHandle.prototype.handoff = function(worker) {
-  if (worker.id in this.all === false) {
+// The worker's count of the connections it has received and of those that
+// are still open.
+RoundRobinHandle.prototype.update = function(worker, received, connections) {
+  const load = this.loads[worker.id];
+
+  if (load === undefined)
     return;  // Worker is closing (or has closed) the server.
-  }
 
-  const handle = this.handles.shift();
+  load.received = received;
+  load.connections = connections;
+  this.handoff();
+};
 
-  if (handle === undefined) {
-    this.free.push(worker);  // Add to ready queue again.
-    return;
-  }
+RoundRobinHandle.prototype.handoff = function() {
+  while (this.handles.length > 0) {
+    const worker = this.pick();
 
-  const message = { act: 'newconn', key: this.key };
+    if (worker === null)
+      return;  // Every worker is busy. Wait for one to report.
 
-  sendHelper(worker.process, message, handle, (reply) => {
-    if (reply.accepted)
-      handle.close();
-    else
-      this.distribute(0, handle);  // Worker is shutting down. Send to another.
+    const handle = this.handles.shift();
+    const load = this.loads[worker.id];
+    load.sent++;
+    load.last = ++this.handoffs;
 
-    this.handoff(worker);
-  });
+    // Nothing comes back for the connection, except in the worker's next
+    // load report. The master's copy of the handle is closed as soon as the
+    // worker has its own. A worker whose server has closed in the meantime
+    // sends the connection back, see child.js.
+    const message = { act: 'newconn', key: this.key };
+    sendHelper(worker.process, message, handle, null, { keepOpen: false });
+  }
+};
+
+// Finds the worker with the fewest connections, counting the ones that are
+// on their way to it. Of equally loaded workers, the one that got a
+// connection least recently goes first.
+RoundRobinHandle.prototype.pick = function() {
+  var best = null;
+  var bestLoad = null;
+  var bestCount = 0;
+
+  for (var id in this.all) {
+    const worker = this.all[id];
+    const load = this.loads[id];
+    const pending = load.sent - load.received;
+
+    if (pending >= kMaxPending || !worker.process.connected)
+      continue;
+
+    // A worker that closed its server and listened again can count more
+    // than it was sent since.
+    const count = load.connections + (pending > 0 ? pending : 0);
+
+    if (best === null || count < bestCount ||
+        (count === bestCount && load.last < bestLoad.last)) {
+      best = worker;
+      bestLoad = load;
+      bestCount = count;
+    }
+  }
+
+  return best;
 };
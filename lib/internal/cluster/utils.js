@@ -10,7 +10,7 @@ module.exports = {
 const callbacks = {};
 var seq = 0;
 
-function sendHelper(proc, message, handle, cb) {
+function sendHelper(proc, message, handle, cb, options) {
   if (!proc.connected)
     return false;
 
@@ -22,7 +22,7 @@ function sendHelper(proc, message, handle, cb) {
 
   message.seq = seq;
   seq += 1;
-  return proc.send(message, handle);
+  return proc.send(message, handle, options);
 }
 
 // Returns an internalMessage listener that hands off normal messages
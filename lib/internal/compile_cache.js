@@ -0,0 +1,125 @@
+'use strict';
+
+// Keeps the V8 code caches of the modules that lib/module.js compiles in the
+// directory of --compile-cache or NODE_COMPILE_CACHE, one file per module.
+// A cache file holds a header and the cached data:
+//
+//   uint32le length of the header
+//   header   JSON of { filename, mtime, size, wrapper, tag }
+//   data     the cachedData of the vm.Script of the module
+//
+// The cache of a module is only used while its file has the same mtime and
+// size, the module wrapper is the same and V8 has the same
+// cachedDataVersionTag(). V8 itself checks little more than the length of
+// the source, so all of these matter. Caches are written in the background
+// after a module is compiled, and are replaced atomically so that processes
+// can share a directory.
+
+const Buffer = require('buffer').Buffer;
+const fs = require('fs');
+const path = require('path');
+const debug = require('util').debuglog('module');
+
+const configDir = process.binding('config').compileCacheDir;
+const dir = configDir !== undefined ? path.resolve(configDir) : undefined;
+const tag = dir !== undefined ?
+  process.binding('v8').cachedDataVersionTag() : 0;
+
+var dirCreated = false;
+
+// 32-bit FNV-1a, to name the files without loading crypto.
+function hash(string) {
+  var h = 0x811c9dc5;
+  for (var i = 0; i < string.length; i++) {
+    h ^= string.charCodeAt(i);
+    h = Math.imul(h, 0x01000193);
+  }
+  return (h >>> 0).toString(16);
+}
+
+function cachePath(filename) {
+  return path.join(dir, `${hash(filename)}.cache`);
+}
+
+// Returns { key, data } for compiling |filename| with the module wrapper
+// |emptyWrapper|, which is what the wrapper makes of an empty source. |data|
+// is the cached data if there is a valid cache, |key| what write() needs if
+// there isn't, or null if |filename| is not a file.
+function read(filename, emptyWrapper) {
+  var stats;
+  try {
+    stats = fs.statSync(filename);
+  } catch (e) {
+    return { key: null, data: undefined };
+  }
+  const key = {
+    filename,
+    mtime: stats.mtime.getTime(),
+    size: stats.size,
+    wrapper: hash(emptyWrapper),
+    tag
+  };
+
+  var buffer;
+  try {
+    buffer = fs.readFileSync(cachePath(filename));
+  } catch (e) {
+    return { key, data: undefined };
+  }
+  try {
+    const headerLength = buffer.readUInt32LE(0);
+    const header = JSON.parse(buffer.toString('utf8', 4, 4 + headerLength));
+    if (header.filename === key.filename &&
+        header.mtime === key.mtime &&
+        header.size === key.size &&
+        header.wrapper === key.wrapper &&
+        header.tag === key.tag) {
+      return { key, data: buffer.slice(4 + headerLength) };
+    }
+  } catch (e) {
+    // A truncated or foreign file, replace it.
+  }
+  return { key, data: undefined };
+}
+
+// Writes |data| as the cache for |key| in the background.
+function write(key, data) {
+  const header = Buffer.from(JSON.stringify(key));
+  const length = Buffer.allocUnsafe(4);
+  length.writeUInt32LE(header.length, 0);
+  const contents = Buffer.concat([length, header, data]);
+  const target = cachePath(key.filename);
+  const temp = `${target}.${process.pid}.tmp`;
+
+  function onError(err) {
+    debug('could not write the compile cache of %s: %s', key.filename, err);
+  }
+
+  function writeFile() {
+    fs.writeFile(temp, contents, (err) => {
+      if (err)
+        return onError(err);
+      fs.rename(temp, target, (err) => {
+        if (err) {
+          onError(err);
+          fs.unlink(temp, () => {});
+        }
+      });
+    });
+  }
+
+  if (dirCreated)
+    return writeFile();
+  fs.mkdir(dir, (err) => {
+    if (err && err.code !== 'EEXIST')
+      return onError(err);
+    dirCreated = true;
+    writeFile();
+  });
+}
+
+module.exports = {
+  enabled: dir !== undefined,
+  read,
+  write
+};
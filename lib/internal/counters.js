@@ -0,0 +1,107 @@
+'use strict';
+
+const binding = process.binding('counters');
+// The loop thread's row of the registry, which only this thread writes to.
+// A value is the sum of the rows of all threads, see
+// src/node_counter_registry.h.
+const values = binding.values;
+
+const kNamePattern = /^[\w.-]+$/;
+const entries = new Map();
+
+class Counter {
+  constructor(name, id) {
+    this.name = name;
+    this._id = id;
+  }
+
+  add(value) {
+    if (value === undefined) {
+      value = 1;
+    } else if (typeof value !== 'number' || !(value >= 0) ||
+               value === Infinity) {
+      throw new RangeError('"value" argument must be a non-negative number');
+    }
+    values[this._id] += value;
+  }
+
+  get value() {
+    return binding.read(this._id);
+  }
+}
+
+class Gauge {
+  constructor(name, id) {
+    this.name = name;
+    this._id = id;
+  }
+
+  add(value) {
+    if (!Number.isFinite(value))
+      throw new TypeError('"value" argument must be a finite number');
+    values[this._id] += value;
+  }
+
+  set(value) {
+    if (!Number.isFinite(value))
+      throw new TypeError('"value" argument must be a finite number');
+    binding.set(this._id, value);
+  }
+
+  get value() {
+    return binding.read(this._id);
+  }
+}
+
+function lookup(name, type) {
+  if (typeof name !== 'string' || name.length === 0 ||
+      name.length > binding.kMaxNameLength || !kNamePattern.test(name)) {
+    throw new TypeError('Invalid counter name: ' + name);
+  }
+  const Type = type === binding.kCounter ? Counter : Gauge;
+  var entry = entries.get(name);
+  if (entry === undefined) {
+    const id = binding.register(name, type);
+    if (id === binding.kFull)
+      throw new RangeError('There is no room for more counters');
+    if (id !== binding.kWrongType) {
+      entry = new Type(name, id);
+      entries.set(name, entry);
+    }
+  }
+  if (!(entry instanceof Type)) {
+    throw new TypeError(`"${name}" is not a ` +
+                        (Type === Counter ? 'counter' : 'gauge'));
+  }
+  return entry;
+}
+
+const counters = {
+  counter(name) {
+    return lookup(name, binding.kCounter);
+  },
+
+  gauge(name) {
+    return lookup(name, binding.kGauge);
+  },
+
+  snapshot() {
+    return binding.snapshot();
+  },
+
+  file: binding.file
+};
+
+module.exports = {
+  Counter,
+  Gauge,
+  counters,
+  // For lib/, which adds to the core counters directly.
+  values,
+  kNetServerConnections: binding.kNetServerConnections,
+  kNetServerConnectionsOpen: binding.kNetServerConnectionsOpen,
+  kHttpServerRequests: binding.kHttpServerRequests,
+  kHttpServerResponses: binding.kHttpServerResponses,
+  kHttpClientRequests: binding.kHttpClientRequests,
+  kHttpClientResponses: binding.kHttpClientResponses
+};
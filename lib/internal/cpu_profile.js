@@ -0,0 +1,108 @@
+'use strict';
+
+// Reads the profiles that v8.stopCpuProfile() writes, see
+// src/cpu_profile_writer.h for the format, into the .cpuprofile format that
+// Chrome DevTools loads.
+
+const Buffer = require('buffer').Buffer;
+const { isUint8Array } = process.binding('util');
+
+const kMagic = 'NODECPU1';
+
+class Reader {
+  constructor(buffer) {
+    this.buffer = buffer;
+    this.offset = 0;
+  }
+
+  varint() {
+    const buffer = this.buffer;
+    var result = 0;
+    var scale = 1;
+    var byte;
+    do {
+      if (this.offset >= buffer.length)
+        throw new Error('Unexpected end of CPU profile');
+      byte = buffer[this.offset++];
+      result += (byte & 0x7f) * scale;
+      scale *= 128;
+    } while (byte & 0x80);
+    return result;
+  }
+
+  signedVarint() {
+    const value = this.varint();
+    return value % 2 === 0 ? value / 2 : -(value + 1) / 2;
+  }
+
+  string() {
+    const length = this.varint();
+    const end = this.offset + length;
+    if (end > this.buffer.length)
+      throw new Error('Unexpected end of CPU profile');
+    const string = this.buffer.toString('utf8', this.offset, end);
+    this.offset = end;
+    return string;
+  }
+}
+
+function toCpuProfile(buffer) {
+  if (!isUint8Array(buffer))
+    throw new TypeError('"buffer" argument must be a Buffer or Uint8Array');
+  if (!(buffer instanceof Buffer))
+    buffer = Buffer.from(buffer.buffer, buffer.byteOffset, buffer.byteLength);
+  if (buffer.length < kMagic.length ||
+      buffer.toString('latin1', 0, kMagic.length) !== kMagic) {
+    throw new Error('Not a CPU profile');
+  }
+
+  const reader = new Reader(buffer);
+  reader.offset = kMagic.length;
+  const startTime = reader.varint();
+  const endTime = startTime + reader.varint();
+
+  const strings = new Array(reader.varint());
+  for (var i = 0; i < strings.length; i++)
+    strings[i] = reader.string();
+
+  const nodes = new Array(reader.varint());
+  for (i = 0; i < nodes.length; i++) {
+    const parent = reader.varint();
+    const functionName = strings[reader.varint()];
+    const url = strings[reader.varint()];
+    const scriptId = reader.signedVarint();
+    const lineNumber = reader.signedVarint();
+    const columnNumber = reader.signedVarint();
+    const node = {
+      id: i + 1,
+      callFrame: {
+        functionName,
+        scriptId: `${scriptId}`,
+        url,
+        lineNumber: lineNumber - 1,
+        columnNumber: columnNumber - 1
+      },
+      hitCount: reader.varint(),
+      children: []
+    };
+    if (parent > i || functionName === undefined || url === undefined)
+      throw new Error('Invalid CPU profile');
+    if (parent !== 0)
+      nodes[parent - 1].children.push(node.id);
+    nodes[i] = node;
+  }
+
+  const samples = new Array(reader.varint());
+  const timeDeltas = new Array(samples.length);
+  for (i = 0; i < samples.length; i++) {
+    const index = reader.varint();
+    if (index >= nodes.length)
+      throw new Error('Invalid CPU profile');
+    samples[i] = index + 1;
+    timeDeltas[i] = reader.signedVarint();
+  }
+
+  return { nodes, startTime, endTime, samples, timeDeltas };
+}
+
+module.exports = { toCpuProfile };
@@ -0,0 +1,105 @@
+'use strict';
+
+const binding = process.binding('histogram');
+
+const kHandle = Symbol('handle');
+const kFields = Symbol('fields');
+
+// Indices into the array that handle.getFields() returns, see
+// Histogram::Fields.
+const kCount = 0;
+const kMin = 1;
+const kMax = 2;
+const kSum = 3;
+
+// Like HdrHistogram, keeps values below 2 * 10^figures exact, which keeps
+// everything else to within that many significant figures.
+function precisionFor(figures) {
+  return Math.ceil(Math.log2(2 * Math.pow(10, figures)));
+}
+
+function init(histogram, handle) {
+  histogram[kHandle] = handle;
+  // Read directly, so that these don't have to call into C++.
+  histogram[kFields] = handle.getFields();
+}
+
+class Histogram {
+  constructor(options) {
+    var highest = Number.MAX_SAFE_INTEGER;
+    var figures = 3;
+    if (options !== undefined) {
+      if (options === null || typeof options !== 'object')
+        throw new TypeError('"options" must be an object');
+      if (options.highest !== undefined) {
+        highest = options.highest;
+        if (!Number.isSafeInteger(highest) || highest < 1)
+          throw new RangeError('"highest" must be a positive integer');
+      }
+      if (options.significantFigures !== undefined) {
+        figures = options.significantFigures;
+        if (!Number.isInteger(figures) || figures < 1 || figures > 5) {
+          throw new RangeError(
+            '"significantFigures" must be an integer from 1 to 5');
+        }
+      }
+    }
+    init(this, new binding.Histogram(highest, precisionFor(figures)));
+  }
+
+  get count() {
+    return this[kFields][kCount];
+  }
+
+  get min() {
+    return this[kFields][kMin];
+  }
+
+  get max() {
+    return this[kFields][kMax];
+  }
+
+  get mean() {
+    const fields = this[kFields];
+    return fields[kCount] > 0 ? fields[kSum] / fields[kCount] : 0;
+  }
+
+  get stddev() {
+    return this[kHandle].stddev();
+  }
+
+  record(value) {
+    // Written so that NaN fails as well.
+    if (typeof value !== 'number' || !(value >= 0))
+      throw new TypeError('"value" must be a non-negative number');
+    this[kHandle].record(value);
+  }
+
+  percentile(percentile) {
+    if (typeof percentile !== 'number' ||
+        !(percentile >= 0 && percentile <= 100)) {
+      throw new RangeError('"percentile" must be a number from 0 to 100');
+    }
+    return this[kHandle].percentile(percentile);
+  }
+
+  merge(other) {
+    if (!(other instanceof Histogram))
+      throw new TypeError('"other" must be a Histogram');
+    this[kHandle].merge(other[kHandle]);
+  }
+
+  reset() {
+    this[kHandle].reset();
+  }
+}
+
+// Wraps a handle that native code returned for a histogram that it records
+// into.
+function wrapHistogram(handle) {
+  const histogram = Object.create(Histogram.prototype);
+  init(histogram, handle);
+  return histogram;
+}
+
+module.exports = { Histogram, wrapHistogram };
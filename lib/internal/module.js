@@ -52,11 +52,17 @@ function stripBOM(content) {
 
 exports.builtinLibs = [
   'assert', 'buffer', 'child_process', 'cluster', 'crypto', 'dgram', 'dns',
-  'domain', 'events', 'fs', 'http', 'https', 'net', 'os', 'path', 'punycode',
-  'querystring', 'readline', 'repl', 'stream', 'string_decoder', 'tls', 'tty',
-  'url', 'util', 'v8', 'vm', 'zlib'
+  'domain', 'events', 'fs', 'http', 'http2', 'https', 'json', 'net', 'os',
+  'path', 'punycode', 'querystring', 'readline', 'repl', 'scheduler',
+  'stream', 'string_decoder', 'tls', 'trace_events', 'tty', 'url', 'util',
+  'v8', 'vm', 'worker', 'zlib'
 ];
 
+if (process.config.variables.v8_enable_inspector === 1) {
+  exports.builtinLibs.push('inspector');
+  exports.builtinLibs.sort();
+}
+
 function addBuiltinLibsToObject(object) {
   // Make built-in modules available directly (loaded lazily).
   exports.builtinLibs.forEach((name) => {
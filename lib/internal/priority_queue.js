@@ -0,0 +1,93 @@
+'use strict';
+
+// A binary min-heap. compare(a, b) returns a negative number if a comes
+// before b. If setPosition is given, it is called as setPosition(item, pos)
+// whenever an item moves, and with a pos of null when it leaves the queue, so
+// that items can be removed or updated without searching for them.
+
+function PriorityQueue(compare, setPosition) {
+  this._compare = compare;
+  this._setPosition = setPosition;
+  this._heap = [null];  // 1-based, so that the parent of i is i >> 1.
+  this._size = 0;
+}
+
+PriorityQueue.prototype.insert = function(item) {
+  const pos = ++this._size;
+  this._heap[pos] = item;
+  this.percolateUp(pos);
+};
+
+PriorityQueue.prototype.peek = function() {
+  return this._size > 0 ? this._heap[1] : undefined;
+};
+
+PriorityQueue.prototype.shift = function() {
+  if (this._size === 0)
+    return undefined;
+  const item = this._heap[1];
+  this.removeAt(1);
+  return item;
+};
+
+PriorityQueue.prototype.removeAt = function(pos) {
+  const heap = this._heap;
+  const size = this._size--;
+  const item = heap[pos];
+  const last = heap[size];
+  heap[size] = undefined;
+  if (this._setPosition !== undefined)
+    this._setPosition(item, null);
+  if (pos === size)
+    return;
+  heap[pos] = last;
+  if (pos > 1 && this._compare(last, heap[pos >> 1]) < 0)
+    this.percolateUp(pos);
+  else
+    this.percolateDown(pos);
+};
+
+// Moves the item at |pos| towards the top after its key decreased.
+PriorityQueue.prototype.percolateUp = function(pos) {
+  const heap = this._heap;
+  const compare = this._compare;
+  const setPosition = this._setPosition;
+  const item = heap[pos];
+  while (pos > 1) {
+    const parent = heap[pos >> 1];
+    if (compare(parent, item) <= 0)
+      break;
+    heap[pos] = parent;
+    if (setPosition !== undefined)
+      setPosition(parent, pos);
+    pos >>= 1;
+  }
+  heap[pos] = item;
+  if (setPosition !== undefined)
+    setPosition(item, pos);
+};
+
+// Moves the item at |pos| towards the bottom after its key increased.
+PriorityQueue.prototype.percolateDown = function(pos) {
+  const heap = this._heap;
+  const compare = this._compare;
+  const setPosition = this._setPosition;
+  const size = this._size;
+  const item = heap[pos];
+  while (pos * 2 <= size) {
+    var child = pos * 2;
+    if (child < size && compare(heap[child + 1], heap[child]) < 0)
+      child++;
+    if (compare(item, heap[child]) <= 0)
+      break;
+    heap[pos] = heap[child];
+    if (setPosition !== undefined)
+      setPosition(heap[pos], pos);
+    pos = child;
+  }
+  heap[pos] = item;
+  if (setPosition !== undefined)
+    setPosition(item, pos);
+};
+
+module.exports = PriorityQueue;
@@ -10,8 +10,11 @@ function lazyConstants() {
 }
 
 exports.setup_cpuUsage = setup_cpuUsage;
+exports.setupResourceUsage = setupResourceUsage;
 exports.setup_hrtime = setup_hrtime;
 exports.setupMemoryUsage = setupMemoryUsage;
+exports.setupLoopMetrics = setupLoopMetrics;
+exports.setupCounters = setupCounters;
 exports.setupConfig = setupConfig;
 exports.setupKillAndExit = setupKillAndExit;
 exports.setupSignalHandlers = setupSignalHandlers;
@@ -74,6 +77,36 @@ function setup_cpuUsage() {
   };
 }
 
+function setupResourceUsage() {
+  const _resourceUsage = process.resourceUsage;
+  const resourceValues = new Float64Array(16);
+
+  process.resourceUsage = function resourceUsage() {
+    const errmsg = _resourceUsage(resourceValues);
+    if (errmsg) {
+      throw new Error('unable to obtain resource usage: ' + errmsg);
+    }
+    return {
+      userCPUTime: resourceValues[0],
+      systemCPUTime: resourceValues[1],
+      maxRSS: resourceValues[2],
+      sharedMemorySize: resourceValues[3],
+      unsharedDataSize: resourceValues[4],
+      unsharedStackSize: resourceValues[5],
+      minorPageFault: resourceValues[6],
+      majorPageFault: resourceValues[7],
+      swappedOut: resourceValues[8],
+      fsRead: resourceValues[9],
+      fsWrite: resourceValues[10],
+      ipcSent: resourceValues[11],
+      ipcReceived: resourceValues[12],
+      signalsCount: resourceValues[13],
+      voluntaryContextSwitches: resourceValues[14],
+      involuntaryContextSwitches: resourceValues[15]
+    };
+  };
+}
+
 // The 3 entries filled in by the original process.hrtime contains
 // the upper/lower 32 bits of the second part of the value,
 // and the remaining nanoseconds of the value.
@@ -100,6 +133,21 @@ function setup_hrtime() {
       hrValues[2]
     ];
   };
+
+  // Both return a plain number, so measuring doesn't allocate an array.
+  const _hrtimeNanoseconds = process._hrtimeNanoseconds;
+  const nsValue = new Float64Array(1);
+  delete process._hrtimeNanoseconds;
+
+  process.hrtime.nanoseconds = function nanoseconds() {
+    _hrtimeNanoseconds(nsValue);
+    return nsValue[0];
+  };
+
+  process.hrtime.now = function now() {
+    _hrtimeNanoseconds(nsValue);
+    return nsValue[0] / 1e6;
+  };
 }
 
 function setupMemoryUsage() {
@@ -115,6 +163,109 @@ function setupMemoryUsage() {
       external: memValues[3]
     };
   };
+
+  const _heapUsage = process._heapUsage;
+  const _rss = process._rss;
+  const _sampleRss = process._sampleRss;
+  const heapValues = new Float64Array(3);
+  delete process._heapUsage;
+  delete process._rss;
+  delete process._sampleRss;
+
+  process.memoryUsage.heap = function heap() {
+    _heapUsage(heapValues);
+    return {
+      heapTotal: heapValues[0],
+      heapUsed: heapValues[1],
+      external: heapValues[2]
+    };
+  };
+
+  process.memoryUsage.rss = function rss() {
+    return _rss();
+  };
+
+  process.memoryUsage.sampleRss = function sampleRss(interval) {
+    if (!Number.isInteger(interval) || interval < 0 || interval > 0xffffffff)
+      throw new RangeError('"interval" must be an integer >= 0');
+    _sampleRss(interval);
+  };
+}
+
+// Indices into the array that process._startLoopMetrics() returns, see
+// LoopMetrics::Fields.
+const kIterations = 0;
+const kPollTime = 1;
+const kIdleTime = 2;
+const kCallbackTime = 3;
+const kMaxBusyTime = 4;
+
+// The percentiles of the lag that process.loopMetrics() reports.
+const kLagPercentiles = [50, 75, 90, 99, 99.9];
+
+// process.counters loads its binding, which maps the registry, on first use.
+function setupCounters() {
+  var counters;
+  Object.defineProperty(process, 'counters', {
+    configurable: true,
+    enumerable: true,
+    get() {
+      if (counters === undefined)
+        counters = require('internal/counters').counters;
+      return counters;
+    }
+  });
+}
+
+function setupLoopMetrics() {
+  const startLoopMetrics = process._startLoopMetrics;
+  delete process._startLoopMetrics;
+  // The event loop is only measured once someone asks.
+  var fields = null;
+  var lag;
+  var startTime;
+
+  process.loopMetrics = function loopMetrics() {
+    if (fields === null) {
+      const { wrapHistogram } = require('internal/histogram');
+      const result = startLoopMetrics();
+      fields = result[0];
+      // In microseconds.
+      lag = wrapHistogram(result[1]);
+      startTime = process.hrtime();
+    }
+    const elapsed = process.hrtime(startTime);
+    const elapsedTime = elapsed[0] * 1e3 + elapsed[1] / 1e6;
+    const percentiles = {};
+    for (const percentile of kLagPercentiles)
+      percentiles[percentile] = lag.percentile(percentile) / 1e3;
+    return {
+      elapsedTime,
+      iterations: fields[kIterations],
+      pollTime: fields[kPollTime],
+      idleTime: fields[kIdleTime],
+      callbackTime: fields[kCallbackTime],
+      maxIterationTime: fields[kMaxBusyTime],
+      utilization: elapsedTime > 0 ?
+        Math.max(0, 1 - fields[kIdleTime] / elapsedTime) : 0,
+      lag: {
+        count: lag.count,
+        min: lag.min / 1e3,
+        max: lag.max / 1e3,
+        mean: lag.mean / 1e3,
+        stddev: lag.stddev / 1e3,
+        percentiles
+      }
+    };
+  };
+
+  process.resetLoopMetrics = function resetLoopMetrics() {
+    if (fields === null)
+      return;
+    fields.fill(0);
+    lag.reset();
+    startTime = process.hrtime();
+  };
 }
 
 function setupConfig(_source) {
@@ -234,6 +385,15 @@ function setupSignalHandlers() {
       delete signalWraps[type];
     }
   });
+
+  const heapSnapshotSignal = process.binding('config').heapSnapshotSignal;
+  if (heapSnapshotSignal !== undefined) {
+    if (!isSignal(heapSnapshotSignal))
+      throw new TypeError(`Unknown signal: ${heapSnapshotSignal}`);
+    process.on(heapSnapshotSignal, () => {
+      require('v8').writeHeapSnapshot();
+    });
+  }
 }
 
 
@@ -244,8 +404,14 @@ function setupChannel() {
     const fd = parseInt(process.env.NODE_CHANNEL_FD, 10);
     assert(fd >= 0);
 
+    const serializationMode =
+      process.env.NODE_CHANNEL_SERIALIZATION_MODE || 'json';
+    const batchHandles = process.env.NODE_CHANNEL_BATCH_HANDLES === '1';
+
     // Make sure it's not accidentally inherited by child processes.
     delete process.env.NODE_CHANNEL_FD;
+    delete process.env.NODE_CHANNEL_SERIALIZATION_MODE;
+    delete process.env.NODE_CHANNEL_BATCH_HANDLES;
 
     const cp = require('child_process');
 
@@ -254,7 +420,7 @@ function setupChannel() {
     // FIXME is this really necessary?
     process.binding('tcp_wrap');
 
-    cp._forkChild(fd);
+    cp._forkChild(fd, serializationMode, batchHandles);
     assert(process.send);
   }
 }
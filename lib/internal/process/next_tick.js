@@ -1,24 +1,81 @@
 'use strict';
 
-// This value is used to prevent the nextTickQueue from becoming too
-// large and cause the process to run out of memory. When this value
-// is reached the nextTimeQueue array will be shortend (see tickDone
-// for details).
-const kMaxCallbacksPerLoop = 1e4;
+// The nextTick queue is a linked list of circular buffers of kQueueSize
+// ticks each, so that queueing and running a tick neither shifts nor
+// reallocates an array. Ticks are queued at the head buffer and run from the
+// tail buffer, which is dropped as soon as it has been run through, so a long
+// run of ticks does not keep the memory of all of them alive.
+const kQueueSize = 2048;
+const kQueueMask = kQueueSize - 1;
+
+class FixedCircularBuffer {
+  constructor() {
+    this.bottom = 0;
+    this.top = 0;
+    this.list = new Array(kQueueSize);
+    this.next = null;
+  }
+
+  isEmpty() {
+    return this.top === this.bottom;
+  }
+
+  isFull() {
+    return ((this.top + 1) & kQueueMask) === this.bottom;
+  }
+
+  push(data) {
+    this.list[this.top] = data;
+    this.top = (this.top + 1) & kQueueMask;
+  }
+
+  shift() {
+    const nextItem = this.list[this.bottom];
+    if (nextItem === undefined)
+      return null;
+    this.list[this.bottom] = undefined;
+    this.bottom = (this.bottom + 1) & kQueueMask;
+    return nextItem;
+  }
+}
+
+class FixedQueue {
+  constructor() {
+    this.head = this.tail = new FixedCircularBuffer();
+  }
+
+  push(data) {
+    if (this.head.isFull()) {
+      // Head is full: Creates a new queue, sets the old queue's `.next` to it,
+      // and sets it as the new main queue.
+      this.head = this.head.next = new FixedCircularBuffer();
+    }
+    this.head.push(data);
+  }
+
+  shift() {
+    const tail = this.tail;
+    const next = tail.shift();
+    if (tail.isEmpty() && tail.next !== null) {
+      // If there is another queue, it forms the new tail.
+      this.tail = tail.next;
+    }
+    return next;
+  }
+}
 
 exports.setup = setupNextTick;
 
 function setupNextTick() {
   const promises = require('internal/process/promises');
   const emitPendingUnhandledRejections = promises.setup(scheduleMicrotasks);
-  var nextTickQueue = [];
+  const queue = new FixedQueue();
   var microtasksScheduled = false;
 
   // Used to run V8's micro task queue.
   var _runMicrotasks = {};
 
   // *Must* match Environment::TickInfo::Fields in src/env.h.
-  var kIndex = 0;
   var kLength = 1;
 
   process.nextTick = nextTick;
@@ -28,31 +85,20 @@ function setupNextTick() {
 
   // This tickInfo thing is used so that the C++ code in src/node.cc
   // can have easy access to our nextTick state, and avoid unnecessary
-  // calls into JS land.
+  // calls into JS land. tickInfo[kLength] is the number of queued ticks. A
+  // tick leaves the queue before it runs, so the index field stays 0.
   const tickInfo = process._setupNextTick(_tickCallback, _runMicrotasks);
 
   _runMicrotasks = _runMicrotasks.runMicrotasks;
 
-  function tickDone() {
-    if (tickInfo[kLength] !== 0) {
-      if (tickInfo[kLength] <= tickInfo[kIndex]) {
-        nextTickQueue = [];
-        tickInfo[kLength] = 0;
-      } else {
-        nextTickQueue.splice(0, tickInfo[kIndex]);
-        tickInfo[kLength] = nextTickQueue.length;
-      }
-    }
-    tickInfo[kIndex] = 0;
-  }
-
   function scheduleMicrotasks() {
     if (microtasksScheduled)
       return;
 
-    nextTickQueue.push({
+    queue.push({
       callback: runMicrotasksCallback,
-      domain: null
+      domain: null,
+      args: undefined
     });
 
     tickInfo[kLength]++;
@@ -63,8 +109,7 @@ function setupNextTick() {
     microtasksScheduled = false;
     _runMicrotasks();
 
-    if (tickInfo[kIndex] < tickInfo[kLength] ||
-        emitPendingUnhandledRejections())
+    if (tickInfo[kLength] !== 0 || emitPendingUnhandledRejections())
       scheduleMicrotasks();
   }
 
@@ -91,47 +136,37 @@ function setupNextTick() {
   // Run callbacks that have no domain.
   // Using domains will cause this to be overridden.
   function _tickCallback() {
-    var callback, args, tock;
+    var tock;
 
     do {
-      while (tickInfo[kIndex] < tickInfo[kLength]) {
-        tock = nextTickQueue[tickInfo[kIndex]++];
-        callback = tock.callback;
-        args = tock.args;
+      while ((tock = queue.shift()) !== null) {
+        tickInfo[kLength]--;
         // Using separate callback execution functions allows direct
         // callback invocation with small numbers of arguments to avoid the
         // performance hit associated with using `fn.apply()`
-        _combinedTickCallback(args, callback);
-        if (kMaxCallbacksPerLoop < tickInfo[kIndex])
-          tickDone();
+        _combinedTickCallback(tock.args, tock.callback);
       }
-      tickDone();
       _runMicrotasks();
       emitPendingUnhandledRejections();
     } while (tickInfo[kLength] !== 0);
   }
 
   function _tickDomainCallback() {
-    var callback, domain, args, tock;
+    var domain, tock;
 
     do {
-      while (tickInfo[kIndex] < tickInfo[kLength]) {
-        tock = nextTickQueue[tickInfo[kIndex]++];
-        callback = tock.callback;
+      while ((tock = queue.shift()) !== null) {
+        tickInfo[kLength]--;
         domain = tock.domain;
-        args = tock.args;
         if (domain)
           domain.enter();
         // Using separate callback execution functions allows direct
         // callback invocation with small numbers of arguments to avoid the
         // performance hit associated with using `fn.apply()`
-        _combinedTickCallback(args, callback);
-        if (kMaxCallbacksPerLoop < tickInfo[kIndex])
-          tickDone();
+        _combinedTickCallback(tock.args, tock.callback);
         if (domain)
           domain.exit();
       }
-      tickDone();
       _runMicrotasks();
       emitPendingUnhandledRejections();
     } while (tickInfo[kLength] !== 0);
@@ -151,7 +186,7 @@ function setupNextTick() {
         args[i - 1] = arguments[i];
     }
 
-    nextTickQueue.push({
+    queue.push({
       callback,
       domain: process.domain || null,
       args
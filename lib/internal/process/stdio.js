@@ -166,6 +166,12 @@ function createWritableStdioStream(fd) {
       throw new Error('Implement me. Unknown stream file type!');
   }
 
+  const stdioBuffer = process.binding('config').stdioBuffer;
+  if (stdioBuffer !== undefined &&
+      (stream._type === 'tty' || stream._type === 'pipe')) {
+    setupBufferedWrites(stream, fd, stdioBuffer);
+  }
+
   // For supporting legacy API we put the FD here.
   stream.fd = fd;
 
@@ -173,3 +179,59 @@ function createWritableStdioStream(fd) {
 
   return stream;
 }
+
+// With --stdio-buffer, the writes go to a StdioWriter that writes them out
+// from a thread of its own, so that the stream never waits for the TTY or
+// the pipe. What is still buffered is written out when the process exits.
+const kStdioBufferSize = 1024 * 1024;
+
+function setupBufferedWrites(stream, fd, policy) {
+  const binding = process.binding('stdio_writer');
+  const Buffer = require('buffer').Buffer;
+  var kind;
+  if (policy === 'drop')
+    kind = binding.kDrop;
+  else if (policy === 'block')
+    kind = binding.kBlock;
+  else
+    kind = binding.kGrow;
+  const writer = new binding.StdioWriter(fd, kStdioBufferSize, kind);
+
+  function write(chunk, encoding) {
+    if (typeof chunk === 'string')
+      chunk = Buffer.from(chunk, encoding);
+    writer.write(chunk);
+  }
+
+  stream._write = function(chunk, encoding, cb) {
+    write(chunk, encoding);
+    // Nothing would write out what the 'exit' listeners log.
+    if (process._exiting)
+      writer.flush();
+    cb();
+  };
+
+  stream._writev = function(chunks, cb) {
+    for (var i = 0; i < chunks.length; i++)
+      write(chunks[i].chunk, chunks[i].encoding);
+    if (process._exiting)
+      writer.flush();
+    cb();
+  };
+
+  // See StdioWriter::Fields.
+  const fields = new Float64Array(binding.kFieldsCount);
+  stream.getBufferStats = function getBufferStats() {
+    writer.getStats(fields);
+    return {
+      bytesWritten: fields[0],
+      bytesDropped: fields[1],
+      bytesBuffered: fields[2],
+      maxBytesBuffered: fields[3],
+      capacity: fields[4],
+      blockedTime: fields[5]
+    };
+  };
+
+  process.on('exit', () => writer.flush());
+}
@@ -15,10 +15,15 @@ module.exports = {
 
 if (process.binding('config').hasIntl) {
   const icu = process.binding('icu');
+  // Printable ASCII characters take one column each.
+  const printableASCII = /^[\x20-\x7e]*$/;
   module.exports.getStringWidth = function getStringWidth(str, options) {
     options = options || {};
-    if (!Number.isInteger(str))
+    if (!Number.isInteger(str)) {
       str = stripVTControlCharacters(String(str));
+      if (printableASCII.test(str))
+        return str.length;
+    }
     return icu.getStringWidth(str,
                               Boolean(options.ambiguousAsFullWidth),
                               Boolean(options.expandEmojiSequence));
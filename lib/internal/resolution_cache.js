@@ -0,0 +1,107 @@
+'use strict';
+
+// Keeps what Module._findPath() resolved in a file, so that a process that
+// requires the same modules again gets their filenames from a Map instead of
+// probing the file system for extensions, package.json files and index files.
+// --build-resolution-cache=file records the resolutions of a run and writes
+// them when the process exits, and --resolution-cache=file or
+// NODE_RESOLUTION_CACHE loads them at startup. The file is JSON of
+//
+//   { version, entries: { [cacheKey]: filename } }
+//
+// where cacheKey is the key of Module._pathCache, the request and the paths
+// it is looked up in. lib/module.js uses an entry only while its file still
+// exists. A module that was added since and that would be found first is not
+// picked up, so the file has to be rebuilt when the modules change.
+
+const fs = require('fs');
+const path = require('path');
+const debug = require('util').debuglog('module');
+const internalModuleReadFile = process.binding('fs').internalModuleReadFile;
+
+const config = process.binding('config');
+const useFile = config.resolutionCache !== undefined ?
+  path.resolve(config.resolutionCache) : undefined;
+const buildFile = config.buildResolutionCache !== undefined ?
+  path.resolve(config.buildResolutionCache) : undefined;
+
+// Resolutions depend on how symlinks are treated.
+const version = `${process.version} ${!!config.preserveSymlinks}`;
+
+var entries = new Map();
+const recorded = buildFile !== undefined ? new Map() : null;
+
+function load() {
+  const json = internalModuleReadFile(path._makeLong(useFile));
+  if (json === undefined) {
+    debug('resolution cache %s not found', useFile);
+    return;
+  }
+  var cache;
+  try {
+    cache = JSON.parse(json);
+  } catch (e) {
+    debug('resolution cache %s not loaded: %s', useFile, e.message);
+    return;
+  }
+  if (cache === null || cache.version !== version ||
+      typeof cache.entries !== 'object' || cache.entries === null) {
+    debug('resolution cache %s is for another version', useFile);
+    return;
+  }
+  for (const key of Object.keys(cache.entries)) {
+    if (typeof cache.entries[key] === 'string')
+      entries.set(key, cache.entries[key]);
+  }
+  debug('resolution cache %s has %d entries', useFile, entries.size);
+}
+
+function write() {
+  const cache = { version, entries: Object.create(null) };
+  for (const [key, filename] of recorded)
+    cache.entries[key] = filename;
+  // Replaced atomically, so that a process that loads the file meanwhile
+  // doesn't see half of it.
+  const tmp = `${buildFile}.${process.pid}.tmp`;
+  try {
+    fs.writeFileSync(tmp, JSON.stringify(cache));
+    fs.renameSync(tmp, buildFile);
+  } catch (e) {
+    debug('resolution cache %s not written: %s', buildFile, e.message);
+  }
+}
+
+if (useFile !== undefined)
+  load();
+if (recorded !== null)
+  process.once('exit', write);
+
+// Returns the filename that |cacheKey| resolved to, or undefined.
+function get(cacheKey) {
+  return entries.get(cacheKey);
+}
+
+// Forgets an entry that turned out to be stale.
+function remove(cacheKey) {
+  entries.delete(cacheKey);
+}
+
+// Notes a resolution for --build-resolution-cache.
+function record(cacheKey, filename) {
+  if (recorded !== null)
+    recorded.set(cacheKey, filename);
+}
+
+// Drops the loaded entries, see Module._clearResolutionCache().
+function clear() {
+  entries = new Map();
+}
+
+module.exports = {
+  enabled: useFile !== undefined,
+  building: recorded !== null,
+  get,
+  remove,
+  record,
+  clear
+};
@@ -1,22 +1,33 @@
 'use strict';
 
 const util = require('util');
-const {
-  hexTable,
-  isHexTable
-} = require('internal/querystring');
 const binding = process.binding('url');
 const context = Symbol('context');
 const cannotBeBase = Symbol('cannot-be-base');
 const special = Symbol('special');
 const searchParams = Symbol('query');
-const querystring = require('querystring');
+const kHref = Symbol('href');
+const kOffsets = Symbol('offsets');
+const kContext = Symbol('context');
 const os = require('os');
 
 const isWindows = process.platform === 'win32';
 
 const kFormat = Symbol('format');
 
+const {
+  URL_OFFSET_FLAGS: kFlags,
+  URL_OFFSET_PROTOCOL_END: kProtocolEnd,
+  URL_OFFSET_USERNAME_END: kUsernameEnd,
+  URL_OFFSET_HOST_START: kHostStart,
+  URL_OFFSET_HOST_END: kHostEnd,
+  URL_OFFSET_PATH_START: kPathStart,
+  URL_OFFSET_QUERY_START: kQueryStart,
+  URL_OFFSET_FRAGMENT_START: kFragmentStart,
+  URL_OFFSET_PATH_LENGTH: kPathLength,
+  URL_OFFSETS_LENGTH: kOffsetsLength
+} = binding;
+
 // https://tc39.github.io/ecma262/#sec-%iteratorprototype%-object
 const IteratorPrototype = Object.getPrototypeOf(
   Object.getPrototypeOf([][Symbol.iterator]())
@@ -65,38 +76,65 @@ class URLContext {
   }
 }
 
-function onParseComplete(flags, protocol, username, password,
-                         host, port, path, query, fragment) {
-  var ctx = this[context];
-  ctx.flags = flags;
-  ctx.scheme = protocol;
-  ctx.username = username;
-  ctx.password = password;
-  ctx.port = port;
-  ctx.path = path;
-  ctx.query = query;
-  ctx.fragment = fragment;
-  ctx.host = host;
-  if (!this[searchParams]) { // invoked from URL constructor
-    this[searchParams] = new URLSearchParams();
-    this[searchParams][context] = this;
-  }
-  initSearchParams(this[searchParams], query);
-}
-
-function onParseError(flags, input) {
+function onParseError(input) {
   const error = new TypeError('Invalid URL: ' + input);
   error.input = input;
   throw error;
 }
 
-// Reused by URL constructor and URL#href setter.
+// Reused by URL constructor and URL#href setter. A parsed URL only has its
+// href and the offsets of its components in it, which the getters slice. The
+// URLContext is made when a setter or the binding needs the components.
 function parse(url, input, base) {
   const base_context = base ? base[context] : undefined;
-  url[context] = new URLContext();
-  binding.parse(input.trim(), -1,
-                base_context, undefined,
-                onParseComplete.bind(url), onParseError);
+  const offsets = new Uint32Array(kOffsetsLength);
+  input = input.trim();
+  const href = binding.parseHref(input, base_context, offsets);
+  if (href === undefined)
+    onParseError(input);
+  url[kHref] = href;
+  url[kOffsets] = offsets;
+  url[kContext] = null;
+  if (!url[searchParams]) { // invoked from URL constructor
+    url[searchParams] = new URLSearchParams();
+    url[searchParams][context] = url;
+  }
+  initSearchParams(url[searchParams],
+                   href.slice(offsets[kQueryStart] + 1,
+                              offsets[kFragmentStart]));
+}
+
+// Makes the URLContext of a URL from its href and offsets.
+function splitHref(url) {
+  const href = url[kHref];
+  const offsets = url[kOffsets];
+  const flags = offsets[kFlags];
+  const ctx = new URLContext();
+  ctx.flags = flags;
+  ctx.scheme = href.slice(0, offsets[kProtocolEnd]);
+  if (flags & binding.URL_FLAGS_HAS_USERNAME)
+    ctx.username = href.slice(offsets[kProtocolEnd] + 2, offsets[kUsernameEnd]);
+  if (flags & binding.URL_FLAGS_HAS_PASSWORD)
+    ctx.password = href.slice(offsets[kUsernameEnd] + 1,
+                              offsets[kHostStart] - 1);
+  if (flags & binding.URL_FLAGS_HAS_HOST)
+    ctx.host = href.slice(offsets[kHostStart], offsets[kHostEnd]);
+  if (offsets[kPathStart] > offsets[kHostEnd])
+    ctx.port = +href.slice(offsets[kHostEnd] + 1, offsets[kPathStart]);
+  if (!(flags & binding.URL_FLAGS_HAS_PATH)) {
+    ctx.path = undefined;
+  } else if (offsets[kPathLength] > 0) {
+    const pathname = href.slice(offsets[kPathStart], offsets[kQueryStart]);
+    ctx.path = flags & binding.URL_FLAGS_CANNOT_BE_BASE ?
+      [pathname] : pathname.slice(1).split('/');
+  }
+  if (flags & binding.URL_FLAGS_HAS_QUERY)
+    ctx.query = href.slice(offsets[kQueryStart] + 1, offsets[kFragmentStart]);
+  if (flags & binding.URL_FLAGS_HAS_FRAGMENT)
+    ctx.fragment = href.slice(offsets[kFragmentStart] + 1);
+  url[kHref] = null;
+  url[kOffsets] = null;
+  url[kContext] = ctx;
 }
 
 function onParseProtocolComplete(flags, protocol, username, password,
@@ -206,12 +244,28 @@ class URL {
     parse(this, input, base);
   }
 
+  get [context]() {
+    if (typeof this[kHref] === 'string')
+      splitHref(this);
+    return this[kContext];
+  }
+
+  set [context](ctx) {
+    this[kHref] = null;
+    this[kOffsets] = null;
+    this[kContext] = ctx;
+  }
+
   get [special]() {
-    return (this[context].flags & binding.URL_FLAGS_SPECIAL) !== 0;
+    const flags = typeof this[kHref] === 'string' ?
+      this[kOffsets][kFlags] : this[context].flags;
+    return (flags & binding.URL_FLAGS_SPECIAL) !== 0;
   }
 
   get [cannotBeBase]() {
-    return (this[context].flags & binding.URL_FLAGS_CANNOT_BE_BASE) !== 0;
+    const flags = typeof this[kHref] === 'string' ?
+      this[kOffsets][kFlags] : this[context].flags;
+    return (flags & binding.URL_FLAGS_CANNOT_BE_BASE) !== 0;
   }
 
   [util.inspect.custom](depth, opts) {
@@ -310,14 +364,16 @@ Object.defineProperties(URL.prototype, {
     configurable: true,
     // eslint-disable-next-line func-name-matching
     value: function toString() {
-      return this[kFormat]({});
+      const href = this[kHref];
+      return typeof href === 'string' ? href : this[kFormat]({});
     }
   },
   href: {
     enumerable: true,
     configurable: true,
     get() {
-      return this[kFormat]({});
+      const href = this[kHref];
+      return typeof href === 'string' ? href : this[kFormat]({});
     },
     set(input) {
       // toUSVString is not needed.
@@ -330,9 +386,23 @@ Object.defineProperties(URL.prototype, {
     configurable: true,
     get() {
       // Refs: https://url.spec.whatwg.org/#concept-url-origin
-      const ctx = this[context];
-      switch (ctx.scheme) {
-        case 'blob:':
+      const href = this[kHref];
+      var scheme, host, port;
+      if (typeof href === 'string') {
+        const offsets = this[kOffsets];
+        scheme = href.slice(0, offsets[kProtocolEnd]);
+        host = href.slice(offsets[kHostStart], offsets[kHostEnd]);
+        if (offsets[kPathStart] > offsets[kHostEnd])
+          port = href.slice(offsets[kHostEnd] + 1, offsets[kPathStart]);
+      } else {
+        const ctx = this[context];
+        scheme = ctx.scheme;
+        host = ctx.host;
+        port = ctx.port;
+      }
+      switch (scheme) {
+        case 'blob:': {
+          const ctx = this[context];
           if (ctx.path.length > 0) {
             try {
               return (new URL(ctx.path[0])).origin;
@@ -341,13 +411,14 @@ Object.defineProperties(URL.prototype, {
             }
           }
           return kOpaqueOrigin;
+        }
         case 'ftp:':
         case 'gopher:':
         case 'http:':
         case 'https:':
         case 'ws:':
         case 'wss:':
-          return serializeTupleOrigin(ctx.scheme, ctx.host, ctx.port);
+          return serializeTupleOrigin(scheme, host, port);
       }
       return kOpaqueOrigin;
     }
@@ -356,6 +427,9 @@ Object.defineProperties(URL.prototype, {
     enumerable: true,
     configurable: true,
     get() {
+      const href = this[kHref];
+      if (typeof href === 'string')
+        return href.slice(0, this[kOffsets][kProtocolEnd]);
       return this[context].scheme;
     },
     set(scheme) {
@@ -371,6 +445,11 @@ Object.defineProperties(URL.prototype, {
     enumerable: true,
     configurable: true,
     get() {
+      const href = this[kHref];
+      if (typeof href === 'string') {
+        const offsets = this[kOffsets];
+        return href.slice(offsets[kProtocolEnd] + 2, offsets[kUsernameEnd]);
+      }
       return this[context].username || '';
     },
     set(username) {
@@ -392,6 +471,11 @@ Object.defineProperties(URL.prototype, {
     enumerable: true,
     configurable: true,
     get() {
+      const href = this[kHref];
+      if (typeof href === 'string') {
+        const offsets = this[kOffsets];
+        return href.slice(offsets[kUsernameEnd] + 1, offsets[kHostStart] - 1);
+      }
       return this[context].password || '';
     },
     set(password) {
@@ -413,6 +497,11 @@ Object.defineProperties(URL.prototype, {
     enumerable: true,
     configurable: true,
     get() {
+      const href = this[kHref];
+      if (typeof href === 'string') {
+        const offsets = this[kOffsets];
+        return href.slice(offsets[kHostStart], offsets[kPathStart]);
+      }
       const ctx = this[context];
       var ret = ctx.host || '';
       if (ctx.port !== undefined)
@@ -442,6 +531,11 @@ Object.defineProperties(URL.prototype, {
     enumerable: true,
     configurable: true,
     get() {
+      const href = this[kHref];
+      if (typeof href === 'string') {
+        const offsets = this[kOffsets];
+        return href.slice(offsets[kHostStart], offsets[kHostEnd]);
+      }
       return this[context].host || '';
     },
     set(host) {
@@ -467,6 +561,11 @@ Object.defineProperties(URL.prototype, {
     enumerable: true,
     configurable: true,
     get() {
+      const href = this[kHref];
+      if (typeof href === 'string') {
+        const offsets = this[kOffsets];
+        return href.slice(offsets[kHostEnd] + 1, offsets[kPathStart]);
+      }
       const port = this[context].port;
       return port === undefined ? '' : String(port);
     },
@@ -489,6 +588,11 @@ Object.defineProperties(URL.prototype, {
     enumerable: true,
     configurable: true,
     get() {
+      const href = this[kHref];
+      if (typeof href === 'string') {
+        const offsets = this[kOffsets];
+        return href.slice(offsets[kPathStart], offsets[kQueryStart]);
+      }
       const ctx = this[context];
       if (this[cannotBeBase])
         return ctx.path[0];
@@ -507,6 +611,13 @@ Object.defineProperties(URL.prototype, {
     enumerable: true,
     configurable: true,
     get() {
+      const href = this[kHref];
+      if (typeof href === 'string') {
+        const offsets = this[kOffsets];
+        const start = offsets[kQueryStart];
+        const end = offsets[kFragmentStart];
+        return end - start > 1 ? href.slice(start, end) : '';
+      }
       const ctx = this[context];
       return !ctx.query ? '' : `?${ctx.query}`;
     },
@@ -539,6 +650,11 @@ Object.defineProperties(URL.prototype, {
     enumerable: true,
     configurable: true,
     get() {
+      const href = this[kHref];
+      if (typeof href === 'string') {
+        const start = this[kOffsets][kFragmentStart];
+        return href.length - start > 1 ? href.slice(start) : '';
+      }
       const ctx = this[context];
       return !ctx.fragment ? '' : `#${ctx.fragment}`;
     },
@@ -563,7 +679,8 @@ Object.defineProperties(URL.prototype, {
     configurable: true,
     // eslint-disable-next-line func-name-matching
     value: function toJSON() {
-      return this[kFormat]({});
+      const href = this[kHref];
+      return typeof href === 'string' ? href : this[kFormat]({});
     }
   }
 });
@@ -591,199 +708,14 @@ function initSearchParams(url, init) {
   url[searchParams] = parseParams(init);
 }
 
-// application/x-www-form-urlencoded parser
+// application/x-www-form-urlencoded parser, which returns a flat array of
+// names and values.
 // Ref: https://url.spec.whatwg.org/#concept-urlencoded-parser
-function parseParams(qs) {
-  const out = [];
-  var pairStart = 0;
-  var lastPos = 0;
-  var seenSep = false;
-  var buf = '';
-  var encoded = false;
-  var encodeCheck = 0;
-  var i;
-  for (i = 0; i < qs.length; ++i) {
-    const code = qs.charCodeAt(i);
-
-    // Try matching key/value pair separator
-    if (code === 38/*&*/) {
-      if (pairStart === i) {
-        // We saw an empty substring between pair separators
-        lastPos = pairStart = i + 1;
-        continue;
-      }
-
-      if (lastPos < i)
-        buf += qs.slice(lastPos, i);
-      if (encoded)
-        buf = querystring.unescape(buf);
-      out.push(buf);
-
-      // If `buf` is the key, add an empty value.
-      if (!seenSep)
-        out.push('');
-
-      seenSep = false;
-      buf = '';
-      encoded = false;
-      encodeCheck = 0;
-      lastPos = pairStart = i + 1;
-      continue;
-    }
-
-    // Try matching key/value separator (e.g. '=') if we haven't already
-    if (!seenSep && code === 61/*=*/) {
-      // Key/value separator match!
-      if (lastPos < i)
-        buf += qs.slice(lastPos, i);
-      if (encoded)
-        buf = querystring.unescape(buf);
-      out.push(buf);
-
-      seenSep = true;
-      buf = '';
-      encoded = false;
-      encodeCheck = 0;
-      lastPos = i + 1;
-      continue;
-    }
-
-    // Handle + and percent decoding.
-    if (code === 43/*+*/) {
-      if (lastPos < i)
-        buf += qs.slice(lastPos, i);
-      buf += ' ';
-      lastPos = i + 1;
-    } else if (!encoded) {
-      // Try to match an (valid) encoded byte (once) to minimize unnecessary
-      // calls to string decoding functions
-      if (code === 37/*%*/) {
-        encodeCheck = 1;
-      } else if (encodeCheck > 0) {
-        // eslint-disable-next-line no-extra-boolean-cast
-        if (!!isHexTable[code]) {
-          if (++encodeCheck === 3)
-            encoded = true;
-        } else {
-          encodeCheck = 0;
-        }
-      }
-    }
-  }
-
-  // Deal with any leftover key or value data
-
-  // There is a trailing &. No more processing is needed.
-  if (pairStart === i)
-    return out;
-
-  if (lastPos < i)
-    buf += qs.slice(lastPos, i);
-  if (encoded)
-    buf = querystring.unescape(buf);
-  out.push(buf);
-
-  // If `buf` is the key, add an empty value.
-  if (!seenSep)
-    out.push('');
-
-  return out;
-}
-
-// Adapted from querystring's implementation.
-// Ref: https://url.spec.whatwg.org/#concept-urlencoded-byte-serializer
-const noEscape = [
-//0, 1, 2, 3, 4, 5, 6, 7, 8, 9, A, B, C, D, E, F
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x00 - 0x0F
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10 - 0x1F
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, // 0x20 - 0x2F
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, // 0x30 - 0x3F
-  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x40 - 0x4F
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, // 0x50 - 0x5F
-  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x60 - 0x6F
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0  // 0x70 - 0x7F
-];
-
-// Special version of hexTable that uses `+` for U+0020 SPACE.
-const paramHexTable = hexTable.slice();
-paramHexTable[0x20] = '+';
-
-function escapeParam(str) {
-  const len = str.length;
-  if (len === 0)
-    return '';
-
-  var out = '';
-  var lastPos = 0;
-
-  for (var i = 0; i < len; i++) {
-    var c = str.charCodeAt(i);
-
-    // ASCII
-    if (c < 0x80) {
-      if (noEscape[c] === 1)
-        continue;
-      if (lastPos < i)
-        out += str.slice(lastPos, i);
-      lastPos = i + 1;
-      out += paramHexTable[c];
-      continue;
-    }
-
-    if (lastPos < i)
-      out += str.slice(lastPos, i);
-
-    // Multi-byte characters ...
-    if (c < 0x800) {
-      lastPos = i + 1;
-      out += paramHexTable[0xC0 | (c >> 6)] +
-             paramHexTable[0x80 | (c & 0x3F)];
-      continue;
-    }
-    if (c < 0xD800 || c >= 0xE000) {
-      lastPos = i + 1;
-      out += paramHexTable[0xE0 | (c >> 12)] +
-             paramHexTable[0x80 | ((c >> 6) & 0x3F)] +
-             paramHexTable[0x80 | (c & 0x3F)];
-      continue;
-    }
-    // Surrogate pair
-    ++i;
-    var c2;
-    if (i < len)
-      c2 = str.charCodeAt(i) & 0x3FF;
-    else {
-      // This branch should never happen because all URLSearchParams entries
-      // should already be converted to USVString. But, included for
-      // completion's sake anyway.
-      c2 = 0;
-    }
-    lastPos = i + 1;
-    c = 0x10000 + (((c & 0x3FF) << 10) | c2);
-    out += paramHexTable[0xF0 | (c >> 18)] +
-           paramHexTable[0x80 | ((c >> 12) & 0x3F)] +
-           paramHexTable[0x80 | ((c >> 6) & 0x3F)] +
-           paramHexTable[0x80 | (c & 0x3F)];
-  }
-  if (lastPos === 0)
-    return str;
-  if (lastPos < len)
-    return out + str.slice(lastPos);
-  return out;
-}
+const parseParams = binding.parseSearchParams;
 
 // application/x-www-form-urlencoded serializer
 // Ref: https://url.spec.whatwg.org/#concept-urlencoded-serializer
-function serializeParams(array) {
-  const len = array.length;
-  if (len === 0)
-    return '';
-
-  var output = `${escapeParam(array[0])}=${escapeParam(array[1])}`;
-  for (var i = 2; i < len; i += 2)
-    output += `&${escapeParam(array[i])}=${escapeParam(array[i + 1])}`;
-  return output;
-}
+const serializeParams = binding.serializeSearchParams;
 
 // Mainly to mitigate func-name-matching ESLint rule
 function defineIDLClass(proto, classStr, obj) {
@@ -0,0 +1,106 @@
+'use strict';
+
+// Streams of serialized values. Each value is written as a record, a 32-bit
+// little-endian byte length followed by what v8.serialize() returned, so
+// that a reader can deserialize each value as soon as its record is
+// complete instead of waiting for all of the data.
+
+const Buffer = require('buffer').Buffer;
+const { Transform } = require('stream');
+const { serialize, deserialize } = require('v8');
+
+const kHeaderLength = 4;
+
+class SerializeStream extends Transform {
+  constructor(options) {
+    super(Object.assign({}, options, { writableObjectMode: true }));
+  }
+
+  _transform(value, encoding, callback) {
+    var data;
+    try {
+      data = serialize(value);
+    } catch (err) {
+      return callback(err);
+    }
+    const header = Buffer.allocUnsafe(kHeaderLength);
+    header.writeUInt32LE(data.length, 0, true);
+    this.push(header);
+    callback(null, data);
+  }
+}
+
+class DeserializeStream extends Transform {
+  constructor(options) {
+    super(Object.assign({}, options, { readableObjectMode: true }));
+    this._chunks = [];
+    // The number of bytes in _chunks.
+    this._buffered = 0;
+    // The length of the record being read once its header is read, or -1.
+    this._recordLength = -1;
+  }
+
+  _transform(chunk, encoding, callback) {
+    this._chunks.push(chunk);
+    this._buffered += chunk.length;
+    try {
+      var record;
+      while ((record = this._readRecord()) !== null)
+        this.push(deserialize(record));
+    } catch (err) {
+      return callback(err);
+    }
+    callback();
+  }
+
+  _flush(callback) {
+    if (this._buffered !== 0 || this._recordLength !== -1)
+      return callback(new Error('Unexpected end of serialized data'));
+    callback();
+  }
+
+  _readRecord() {
+    if (this._recordLength === -1) {
+      if (this._buffered < kHeaderLength)
+        return null;
+      this._recordLength = this._take(kHeaderLength).readUInt32LE(0, true);
+    }
+    if (this._buffered < this._recordLength)
+      return null;
+    const record = this._take(this._recordLength);
+    this._recordLength = -1;
+    return record;
+  }
+
+  // Removes the first n bytes from _chunks. They are only copied if they
+  // span more than one chunk.
+  _take(n) {
+    const chunks = this._chunks;
+    this._buffered -= n;
+    const first = chunks[0];
+    if (first.length >= n) {
+      if (first.length === n)
+        return chunks.shift();
+      chunks[0] = first.slice(n);
+      return first.slice(0, n);
+    }
+    const data = Buffer.allocUnsafe(n);
+    var offset = 0;
+    while (offset < n) {
+      const chunk = chunks[0];
+      const length = Math.min(chunk.length, n - offset);
+      chunk.copy(data, offset, 0, length);
+      offset += length;
+      if (length === chunk.length)
+        chunks.shift();
+      else
+        chunks[0] = chunk.slice(length);
+    }
+    return data;
+  }
+}
+
+module.exports = {
+  SerializeStream,
+  DeserializeStream
+};
@@ -0,0 +1,112 @@
+'use strict';
+
+// Workers are threads with their own isolate, Environment and event loop in
+// this process, see src/node_worker.h. A Worker and its thread talk through
+// a pair of MessagePorts. Messages are copied with the structured clone
+// algorithm of v8.serialize(), except for the ArrayBuffers in the
+// transferList of postMessage(), which are moved to the other side.
+
+const EventEmitter = require('events');
+const path = require('path');
+
+const binding = process.binding('worker');
+const MessagePort = binding.MessagePort;
+
+const kHandle = Symbol('kHandle');
+const kPort = Symbol('kPort');
+
+Object.setPrototypeOf(MessagePort.prototype, EventEmitter.prototype);
+
+// Called by the native side for each message.
+MessagePort.prototype.onmessage = function(payload) {
+  this.emit('message', payload);
+};
+
+// The port of a thread only keeps its event loop alive while someone listens
+// to it, so that a worker ends once its script is done with everything else.
+function refWhileListening(port) {
+  port.on('newListener', (name) => {
+    if (name === 'message' && port.listenerCount('message') === 0)
+      port.ref();
+  });
+  port.on('removeListener', (name) => {
+    if (name === 'message' && port.listenerCount('message') === 0)
+      port.unref();
+  });
+}
+
+class Worker extends EventEmitter {
+  constructor(filename) {
+    super();
+    if (typeof filename !== 'string')
+      throw new TypeError('"filename" argument must be a string');
+
+    this[kHandle] = new binding.Worker(path.resolve(filename));
+    this[kHandle].onexit = (code) => {
+      this[kHandle] = null;
+      this[kPort] = null;
+      this.emit('exit', code);
+    };
+    this[kPort] = this[kHandle].messagePort;
+    this[kPort].on('message', (payload) => this.emit('message', payload));
+    this.threadId = this[kHandle].threadId;
+    this[kHandle].startThread();
+  }
+
+  postMessage(value, transferList) {
+    if (this[kPort] !== null)
+      this[kPort].postMessage(value, transferList);
+  }
+
+  // Stops the thread as soon as possible. 'exit' is emitted with code 1
+  // unless the thread has stopped already.
+  terminate(callback) {
+    if (typeof callback === 'function')
+      this.once('exit', (code) => callback(null, code));
+    if (this[kHandle] !== null)
+      this[kHandle].stopThread();
+  }
+
+  ref() {
+    if (this[kHandle] !== null)
+      this[kHandle].ref();
+  }
+
+  unref() {
+    if (this[kHandle] !== null)
+      this[kHandle].unref();
+  }
+}
+
+function unavailable(name) {
+  return function() {
+    throw new Error(`${name} is not supported in workers`);
+  };
+}
+
+// Sets up the process object of a worker thread. What belongs to the process
+// as a whole can't be changed from a thread.
+function setupChild() {
+  process.chdir = unavailable('process.chdir()');
+  for (const name of ['setuid', 'setgid', 'seteuid', 'setegid', 'setgroups',
+                      'initgroups']) {
+    if (typeof process[name] === 'function')
+      process[name] = unavailable(`process.${name}()`);
+  }
+  const umask = process.umask;
+  process.umask = function(mask) {
+    if (mask !== undefined)
+      throw new Error('process.umask(mask) is not supported in workers');
+    return umask.call(process);
+  };
+
+  refWhileListening(binding.parentPort);
+}
+
+module.exports = {
+  Worker,
+  isMainThread: binding.isMainThread,
+  threadId: binding.threadId,
+  parentPort: binding.isMainThread ? null : binding.parentPort,
+  setupChild
+};
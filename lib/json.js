@@ -0,0 +1,110 @@
+'use strict';
+
+const Buffer = require('buffer').Buffer;
+const Transform = require('_stream_transform');
+const JSONParser = process.binding('json').JSONParser;
+
+const kDefaultMaxDepth = 1000;
+// The parser recurses on a thread pool thread, whose stack is not that of
+// the main thread.
+const kMaxDepth = 10000;
+
+function createHandle(mode, maxDepth) {
+  if (maxDepth === undefined) {
+    maxDepth = kDefaultMaxDepth;
+  } else if (!Number.isInteger(maxDepth) || maxDepth < 0 ||
+             maxDepth > kMaxDepth) {
+    throw new RangeError('Invalid maxDepth: ' + maxDepth);
+  }
+  const handle = new JSONParser(mode, maxDepth);
+  // The input that the thread pool is reading.
+  handle.buffer = null;
+  return handle;
+}
+
+// Syntax errors come as their message, anything else as an exception.
+function parserError(error) {
+  return typeof error === 'string' ? new SyntaxError(error) : error;
+}
+
+class Parser extends Transform {
+  constructor(opts) {
+    opts = Object.assign({}, opts, { readableObjectMode: true });
+    super(opts);
+
+    const mode = opts.elements ? JSONParser.ELEMENTS : JSONParser.SEQUENCE;
+    const handle = this._handle = createHandle(mode, opts.maxDepth);
+    this._callback = null;
+
+    handle.oncomplete = (values) => {
+      handle.buffer = null;
+      // null would end the stream.
+      for (var i = 0; i < values.length; i++)
+        this.push(values[i] === null ? undefined : values[i]);
+      const callback = this._callback;
+      this._callback = null;
+      callback();
+    };
+    handle.onerror = (error) => {
+      handle.buffer = null;
+      const callback = this._callback;
+      this._callback = null;
+      callback(parserError(error));
+    };
+  }
+
+  _transform(chunk, encoding, callback) {
+    if (typeof chunk === 'string')
+      chunk = Buffer.from(chunk, encoding);
+    else if (!ArrayBuffer.isView(chunk))
+      return callback(new TypeError('invalid input'));
+    this._parse(chunk, false, callback);
+  }
+
+  _flush(callback) {
+    this._parse(undefined, true, callback);
+  }
+
+  _parse(chunk, end, callback) {
+    this._callback = callback;
+    this._handle.buffer = chunk;
+    this._handle.write(chunk, end);
+  }
+}
+
+function createParser(opts) {
+  return new Parser(opts);
+}
+
+function parse(data, opts, callback) {
+  if (typeof opts === 'function') {
+    callback = opts;
+    opts = {};
+  }
+  if (typeof callback !== 'function')
+    throw new TypeError('"callback" argument must be a function');
+  if (typeof data === 'string') {
+    data = Buffer.from(data);
+  } else if (!ArrayBuffer.isView(data)) {
+    throw new TypeError('"data" argument must be a string, Buffer, ' +
+                        'TypedArray or DataView');
+  }
+
+  const handle = createHandle(JSONParser.VALUE, opts && opts.maxDepth);
+  handle.buffer = data;
+  handle.oncomplete = (values) => {
+    handle.buffer = null;
+    callback(null, values[0]);
+  };
+  handle.onerror = (error) => {
+    handle.buffer = null;
+    callback(parserError(error));
+  };
+  handle.write(data, true);
+}
+
+module.exports = {
+  Parser,
+  createParser,
+  parse
+};
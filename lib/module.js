@@ -24,6 +24,9 @@
 const NativeModule = require('native_module');
 const util = require('util');
 const internalModule = require('internal/module');
+const compileCache = require('internal/compile_cache');
+const appArchive = require('internal/app_archive');
+const resolutionCache = require('internal/resolution_cache');
 const vm = require('vm');
 const assert = require('assert').ok;
 const fs = require('fs');
@@ -31,9 +34,13 @@ const internalFS = require('internal/fs');
 const path = require('path');
 const internalModuleReadFile = process.binding('fs').internalModuleReadFile;
 const internalModuleStat = process.binding('fs').internalModuleStat;
+const clearModuleResolutionCache =
+  process.binding('fs').clearModuleResolutionCache;
 const preserveSymlinks = !!process.binding('config').preserveSymlinks;
 
 function stat(filename) {
+  if (appArchive.enabled && appArchive.contains(filename))
+    return appArchive.stat(filename);
   filename = path._makeLong(filename);
   const cache = stat.cache;
   if (cache !== null) {
@@ -87,7 +94,7 @@ const debug = Module._debug;
 //   -> a/index.<ext>
 
 // check if the directory is a package.json dir
-const packageMainCache = Object.create(null);
+var packageMainCache = Object.create(null);
 
 function readPackage(requestPath) {
   const entry = packageMainCache[requestPath];
@@ -95,7 +102,9 @@ function readPackage(requestPath) {
     return entry;
 
   const jsonPath = path.resolve(requestPath, 'package.json');
-  const json = internalModuleReadFile(path._makeLong(jsonPath));
+  const json = appArchive.enabled && appArchive.contains(jsonPath) ?
+    appArchive.readFile(jsonPath) :
+    internalModuleReadFile(path._makeLong(jsonPath));
 
   if (json === undefined) {
     return false;
@@ -127,6 +136,17 @@ function tryPackage(requestPath, exts, isMain) {
 // Set to an empty Map to reset.
 const realpathCache = new Map();
 
+// Forget what has been learned about the file system while resolving modules,
+// so that files that were added, moved or removed since are picked up by the
+// next require(). Modules that have already been loaded stay in Module._cache.
+Module._clearResolutionCache = function() {
+  Module._pathCache = Object.create(null);
+  packageMainCache = Object.create(null);
+  realpathCache.clear();
+  clearModuleResolutionCache();
+  resolutionCache.clear();
+};
+
 // check if the file exists and is not a directory
 // if using --preserve-symlinks and isMain is false,
 // keep symlinks intact, otherwise resolve to the
@@ -140,6 +160,9 @@ function tryFile(requestPath, isMain) {
 }
 
 function toRealPath(requestPath) {
+  // The archive has no symlinks.
+  if (appArchive.enabled && appArchive.contains(requestPath))
+    return path.resolve(requestPath);
   return fs.realpathSync(requestPath, {
     [internalFS.realpathCacheKey]: realpathCache
   });
@@ -171,6 +194,18 @@ Module._findPath = function(request, paths, isMain) {
   if (entry)
     return entry;
 
+  if (resolutionCache.enabled) {
+    entry = resolutionCache.get(cacheKey);
+    if (entry !== undefined) {
+      if (stat(entry) === 0) {
+        Module._pathCache[cacheKey] = entry;
+        resolutionCache.record(cacheKey, entry);
+        return entry;
+      }
+      resolutionCache.remove(cacheKey);
+    }
+  }
+
   var exts;
   var trailingSlash = request.length > 0 &&
                       request.charCodeAt(request.length - 1) === 47/*/*/;
@@ -232,6 +267,7 @@ Module._findPath = function(request, paths, isMain) {
       }
 
       Module._pathCache[cacheKey] = filename;
+      resolutionCache.record(cacheKey, filename);
       return filename;
     }
   }
@@ -568,11 +604,7 @@ Module.prototype._compile = function(content, filename) {
   // create wrapper function
   var wrapper = Module.wrap(content);
 
-  var compiledWrapper = vm.runInThisContext(wrapper, {
-    filename: filename,
-    lineOffset: 0,
-    displayErrors: true
-  });
+  var compiledWrapper = compileWrapper(wrapper, filename);
 
   var inspectorWrapper = null;
   if (process._debugWaitConnect && process._eval == null) {
@@ -612,16 +644,64 @@ Module.prototype._compile = function(content, filename) {
 };
 
 
+// Compiles the wrapped source of a module, with its code cache if it is in
+// the application archive or the compile cache is enabled.
+function compileWrapper(wrapper, filename) {
+  const options = {
+    filename: filename,
+    lineOffset: 0,
+    displayErrors: true
+  };
+  if (appArchive.enabled && appArchive.contains(filename)) {
+    options.cachedData = appArchive.codeCache(filename, Module.wrap(''));
+    const script = new vm.Script(wrapper, options);
+    if (script.cachedDataRejected !== undefined) {
+      debug('code cache of %j in the archive %s', filename,
+            script.cachedDataRejected ? 'rejected' : 'used');
+    }
+    return script.runInThisContext(options);
+  }
+  if (!compileCache.enabled)
+    return vm.runInThisContext(wrapper, options);
+
+  const cache = compileCache.read(filename, Module.wrap(''));
+  options.cachedData = cache.data;
+  options.produceCachedData = cache.key !== null && cache.data === undefined;
+  var script = new vm.Script(wrapper, options);
+  if (script.cachedDataRejected === true) {
+    debug('compile cache of %j rejected', filename);
+    options.cachedData = undefined;
+    options.produceCachedData = true;
+    script = new vm.Script(wrapper, options);
+  } else if (script.cachedDataRejected === false) {
+    debug('compile cache of %j used', filename);
+  }
+  if (script.cachedDataProduced)
+    compileCache.write(cache.key, script.cachedData);
+  return script.runInThisContext(options);
+}
+
+
+function readSource(filename) {
+  if (appArchive.enabled && appArchive.contains(filename)) {
+    const content = appArchive.readFile(filename);
+    if (content !== undefined)
+      return content;
+  }
+  return fs.readFileSync(filename, 'utf8');
+}
+
+
 // Native extension for .js
 Module._extensions['.js'] = function(module, filename) {
-  var content = fs.readFileSync(filename, 'utf8');
+  var content = readSource(filename);
   module._compile(internalModule.stripBOM(content), filename);
 };
 
 
 // Native extension for .json
 Module._extensions['.json'] = function(module, filename) {
-  var content = fs.readFileSync(filename, 'utf8');
+  var content = readSource(filename);
   try {
     module.exports = JSON.parse(internalModule.stripBOM(content));
   } catch (err) {
@@ -27,6 +27,7 @@ const timers = require('timers');
 const util = require('util');
 const internalUtil = require('internal/util');
 const internalNet = require('internal/net');
+const counters = require('internal/counters');
 const assert = require('assert');
 const cares = process.binding('cares_wrap');
 const uv = process.binding('uv');
@@ -39,6 +40,11 @@ const TCPConnectWrap = process.binding('tcp_wrap').TCPConnectWrap;
 const PipeConnectWrap = process.binding('pipe_wrap').PipeConnectWrap;
 const ShutdownWrap = process.binding('stream_wrap').ShutdownWrap;
 const WriteWrap = process.binding('stream_wrap').WriteWrap;
+const streamStatValues = process.binding('stream_wrap').getStreamStatValues();
+const streamBaseState = process.binding('stream_wrap').streamBaseState;
+// Indices into streamBaseState, see StreamBase::StreamBaseStateFields.
+const kBytesWritten = 0;
+const kLastWriteWasAsync = 1;
 
 var cluster;
 var dns;
@@ -143,20 +149,52 @@ function initSocketHandle(self) {
   self.destroyed = false;
   self._bytesDispatched = 0;
   self._sockname = null;
+  self[kQueuedWrites] = 0;
+  self[kQueuedWriteCb] = undefined;
 
   // Handle creation may be deferred to bind() or connect() time.
   if (self._handle) {
     self._handle.owner = self;
     self._handle.onread = onread;
+    self._handle.onwritecomplete = onwritecomplete;
+    self._handle.ontimeout = onhandletimeout;
 
     // If handle doesn't support writev - neither do we
     if (!self._handle.writev)
       self._writev = null;
+
+    // A timeout set before there was a handle.
+    if (self._idleTimeout >= 0 && !setHandleTimeout(self))
+      timers._unrefActive(self);
   }
 }
 
 
 const BYTES_READ = Symbol('bytesRead');
+const IO_STATS = Symbol('ioStats');
+const kQueuedWrites = Symbol('queuedWrites');
+const kQueuedWriteCb = Symbol('queuedWriteCb');
+
+
+// Field order matches StreamBase::IOStatsFields in src/stream_base.h.
+function IOStats(values) {
+  this.bytesRead = values ? values[0] : 0;
+  this.bytesWritten = values ? values[1] : 0;
+  this.reads = values ? values[2] : 0;
+  this.writes = values ? values[3] : 0;
+  this.partialWrites = values ? values[4] : 0;
+  this.bytesQueued = values ? values[5] : 0;
+  this.blockedTime = values ? values[6] : 0;
+}
+
+function addIOStats(total, stats) {
+  total.bytesRead += stats.bytesRead;
+  total.bytesWritten += stats.bytesWritten;
+  total.reads += stats.reads;
+  total.writes += stats.writes;
+  total.partialWrites += stats.partialWrites;
+  total.blockedTime += stats.blockedTime;
+}
 
 
 function Socket(options) {
@@ -167,6 +205,7 @@ function Socket(options) {
   this._handle = null;
   this._parent = null;
   this._host = null;
+  this._fastOpen = false;
 
   if (typeof options === 'number')
     options = { fd: options }; // Legacy interface.
@@ -237,8 +276,11 @@ function Socket(options) {
 util.inherits(Socket, stream.Duplex);
 
 Socket.prototype._unrefTimer = function _unrefTimer() {
-  for (var s = this; s !== null; s = s._parent)
-    timers._unrefActive(s);
+  for (var s = this; s !== null; s = s._parent) {
+    // Sockets that their handle times out have no timer to move.
+    if (s._idleTimeout >= 0)
+      timers._unrefActive(s);
+  }
 };
 
 // the user has called .end(), and all the bytes have been
@@ -355,12 +397,15 @@ Socket.prototype.listen = function() {
 Socket.prototype.setTimeout = function(msecs, callback) {
   if (msecs === 0) {
     timers.unenroll(this);
+    if (this._handle && typeof this._handle.setIdleTimeout === 'function')
+      this._handle.setIdleTimeout(0);
     if (callback) {
       this.removeListener('timeout', callback);
     }
   } else {
     timers.enroll(this, msecs);
-    timers._unrefActive(this);
+    if (!setHandleTimeout(this))
+      timers._unrefActive(this);
     if (callback) {
       this.once('timeout', callback);
     }
@@ -369,6 +414,31 @@ Socket.prototype.setTimeout = function(msecs, callback) {
 };
 
 
+// Stream handles keep track of when they last read or wrote something
+// themselves, so that reads and writes don't have to move the socket to the
+// end of a timer list. The timeout that enroll() checked and stored moves to
+// the handle then. Other handles, like those of TLS sockets, and handles that
+// fail to take the timeout work with the timer lists, and false is returned.
+function setHandleTimeout(socket) {
+  const handle = socket._handle;
+  if (!handle || typeof handle.setIdleTimeout !== 'function')
+    return false;
+  const msecs = socket._idleTimeout;
+  timers.unenroll(socket);
+  if (handle.setIdleTimeout(Math.ceil(msecs)) === 0)
+    return true;
+  timers.enroll(socket, msecs);
+  return false;
+}
+
+
+function onhandletimeout() {
+  const self = this.owner;
+  if (self._handle === this)
+    self._onTimeout();
+}
+
+
 Socket.prototype._onTimeout = function() {
   debug('_onTimeout');
   this.emit('timeout');
@@ -403,6 +473,16 @@ Socket.prototype.setKeepAlive = function(setting, msecs) {
 };
 
 
+Socket.prototype.getIOStats = function() {
+  if (this._handle && this._handle.getIOStats &&
+      this._handle.getIOStats() === 0) {
+    return new IOStats(streamStatValues);
+  }
+  // Counters from before the handle was closed, if there was one.
+  return util._extend(new IOStats(), this[IO_STATS]);
+};
+
+
 Socket.prototype.address = function() {
   return this._getsockname();
 };
@@ -527,6 +607,10 @@ Socket.prototype._destroy = function(exception, cb) {
     var isException = exception ? true : false;
     // `bytesRead` should be accessible after `.destroy()`
     this[BYTES_READ] = this._handle.bytesRead;
+    // So should the I/O stats, which also roll up into the server's.
+    this[IO_STATS] = this.getIOStats();
+    if (this.server && this.server[IO_STATS])
+      addIOStats(this.server[IO_STATS], this[IO_STATS]);
 
     this._handle.close(() => {
       debug('emit close');
@@ -545,6 +629,7 @@ Socket.prototype._destroy = function(exception, cb) {
 
   if (this._server) {
     COUNTER_NET_SERVER_CONNECTION_CLOSE(this);
+    counters.values[counters.kNetServerConnectionsOpen]--;
     debug('has server');
     this._server._connections--;
     if (this._server._emitCloseIfDrained) {
@@ -716,33 +801,55 @@ Socket.prototype._writeGeneric = function(writev, data, encoding, cb) {
     return false;
   }
 
-  var req = new WriteWrap();
-  req.handle = this._handle;
-  req.oncomplete = afterWrite;
-  req.async = false;
   var err;
 
-  if (writev) {
-    var chunks = new Array(data.length << 1);
-    for (var i = 0; i < data.length; i++) {
-      var entry = data[i];
-      chunks[i * 2] = entry.chunk;
-      chunks[i * 2 + 1] = entry.encoding;
-    }
-    err = this._handle.writev(req, chunks);
-
-    // Retain chunks
-    if (err === 0) req._chunks = chunks;
-  } else {
+  if (!writev) {
+    // Most writes complete synchronously, so don't allocate a request object
+    // up front. The handle creates one if the write has to be queued and
+    // reports its completion to onwritecomplete().
     var enc;
     if (data instanceof Buffer) {
       enc = 'buffer';
     } else {
       enc = encoding;
     }
-    err = createWriteReq(req, this._handle, data, enc);
+    err = createWriteReq(null, this._handle, data, enc);
+
+    if (err) {
+      const message = this._handle.error;
+      this._handle.error = undefined;
+      return this._destroy(errnoException(err, 'write', message), cb);
+    }
+
+    this._bytesDispatched += streamBaseState[kBytesWritten];
+
+    if (streamBaseState[kLastWriteWasAsync] === 1) {
+      this[kQueuedWrites]++;
+      if (this._handle.writeQueueSize !== 0) {
+        this[kQueuedWriteCb] = cb;
+        return;
+      }
+    }
+    cb();
+    return;
   }
 
+  var req = new WriteWrap();
+  req.handle = this._handle;
+  req.oncomplete = afterWrite;
+  req.async = false;
+
+  var chunks = new Array(data.length << 1);
+  for (var i = 0; i < data.length; i++) {
+    var entry = data[i];
+    chunks[i * 2] = entry.chunk;
+    chunks[i * 2 + 1] = entry.encoding;
+  }
+  err = this._handle.writev(req, chunks);
+
+  // Retain chunks
+  if (err === 0) req._chunks = chunks;
+
   if (err)
     return this._destroy(errnoException(err, 'write', req.error), cb);
 
@@ -821,6 +928,19 @@ protoGetter('bytesWritten', function bytesWritten() {
 });
 
 
+// Completion of a write that was started without a request object. Writes
+// complete in order, so the callback held back for the last queued write is
+// due once every queued write has completed.
+function onwritecomplete(status, handle, req, err) {
+  const self = handle.owner;
+  if (--self[kQueuedWrites] === 0) {
+    req.cb = self[kQueuedWriteCb];
+    self[kQueuedWriteCb] = undefined;
+  }
+  afterWrite(status, handle, req, err);
+}
+
+
 function afterWrite(status, handle, req, err) {
   var self = handle.owner;
   if (self !== process.stderr && self !== process.stdout)
@@ -889,9 +1009,9 @@ function internalConnect(
     req.localPort = localPort;
 
     if (addressType === 4)
-      err = self._handle.connect(req, address, port);
+      err = self._handle.connect(req, address, port, self._fastOpen);
     else
-      err = self._handle.connect6(req, address, port);
+      err = self._handle.connect6(req, address, port, self._fastOpen);
 
   } else {
     const req = new PipeConnectWrap();
@@ -960,6 +1080,7 @@ function realConnect(options, cb) {
 
   this.connecting = true;
   this.writable = true;
+  this._fastOpen = !!options.fastOpen;
 
   if (pipe) {
     internalConnect(this, options.path);
@@ -1005,7 +1126,8 @@ function lookupAndConnect(self, options) {
 
   var dnsopts = {
     family: options.family,
-    hints: options.hints || 0
+    hints: options.hints || 0,
+    resolver: options.resolver
   };
 
   if (dnsopts.family !== 4 && dnsopts.family !== 6 && dnsopts.hints === 0) {
@@ -1167,9 +1289,14 @@ function Server(options, connectionListener) {
   this._usingSlaves = false;
   this._slaves = [];
   this._unref = false;
+  this._reusePort = false;
+  this[IO_STATS] = new IOStats();
 
   this.allowHalfOpen = options.allowHalfOpen || false;
   this.pauseOnConnect = !!options.pauseOnConnect;
+  this._acceptBatch = options.acceptBatch >>> 0;
+  this._fastOpen = options.fastOpen >>> 0;
+  this._deferAccept = options.deferAccept >>> 0;
 }
 util.inherits(Server, EventEmitter);
 
@@ -1177,7 +1304,7 @@ util.inherits(Server, EventEmitter);
 function toNumber(x) { return (x = Number(x)) >= 0 ? x : false; }
 
 // Returns handle if it can be created, or error code if it can't
-function createServerHandle(address, port, addressType, fd) {
+function createServerHandle(address, port, addressType, fd, reusePort) {
   var err = 0;
   // assign handle in listen, and clean up if bind or listen fails
   var handle;
@@ -1212,16 +1339,16 @@ function createServerHandle(address, port, addressType, fd) {
     debug('bind to', address || 'any');
     if (!address) {
       // Try binding to ipv6 first
-      err = handle.bind6('::', port);
+      err = handle.bind6('::', port, reusePort);
       if (err) {
         handle.close();
         // Fallback to ipv4
-        return createServerHandle('0.0.0.0', port);
+        return createServerHandle('0.0.0.0', port, 4, undefined, reusePort);
       }
     } else if (addressType === 6) {
-      err = handle.bind6(address, port);
+      err = handle.bind6(address, port, reusePort);
     } else {
-      err = handle.bind(address, port);
+      err = handle.bind(address, port, reusePort);
     }
   }
 
@@ -1247,7 +1374,7 @@ function setupListenHandle(address, port, addressType, backlog, fd) {
 
     // Try to bind to the unspecified IPv6 address, see if IPv6 is available
     if (!address && typeof fd !== 'number') {
-      rval = createServerHandle('::', port, 6, fd);
+      rval = createServerHandle('::', port, 6, fd, this._reusePort);
 
       if (typeof rval === 'number') {
         rval = null;
@@ -1260,7 +1387,8 @@ function setupListenHandle(address, port, addressType, backlog, fd) {
     }
 
     if (rval === null)
-      rval = createServerHandle(address, port, addressType, fd);
+      rval = createServerHandle(address, port, addressType, fd,
+                                this._reusePort);
 
     if (typeof rval === 'number') {
       var error = exceptionWithHostPort(rval, 'listen', address, port);
@@ -1273,10 +1401,24 @@ function setupListenHandle(address, port, addressType, backlog, fd) {
   this._handle.onconnection = onconnection;
   this._handle.owner = this;
 
+  // Round-robin handles from the cluster master don't accept connections
+  // themselves and have no setAcceptBatch().
+  if (this._acceptBatch > 1 &&
+      typeof this._handle.setAcceptBatch === 'function')
+    this._handle.setAcceptBatch(this._acceptBatch);
+
+  // TCP Fast Open and TCP_DEFER_ACCEPT have to be set up before listen().
+  var err = 0;
+  if (this._fastOpen > 0 && this._handle.setFastOpen)
+    err = this._handle.setFastOpen(this._fastOpen);
+  if (err === 0 && this._deferAccept > 0 && this._handle.setDeferAccept)
+    err = this._handle.setDeferAccept(this._deferAccept);
+
   // Use a backlog of 512 entries. We pass 511 to the listen() call because
   // the kernel does: backlogsize = roundup_pow_of_two(backlogsize + 1);
   // which will thus give us a backlog of 512 entries.
-  var err = this._handle.listen(backlog || 511);
+  if (err === 0)
+    err = this._handle.listen(backlog || 511);
 
   if (err) {
     var ex = exceptionWithHostPort(err, 'listen', address, port);
@@ -1323,7 +1465,9 @@ function listenInCluster(server, address, port, addressType,
 
   if (!cluster) cluster = require('cluster');
 
-  if (cluster.isMaster || exclusive) {
+  // With SO_REUSEPORT every worker binds its own socket and the kernel
+  // balances connections between them, so there is no handle to share.
+  if (cluster.isMaster || exclusive || server._reusePort) {
     // Will create a new handle
     // _listen2 sets up the listened handle, it is still named like this
     // to avoid breaking code that wraps this method
@@ -1351,7 +1495,7 @@ function listenInCluster(server, address, port, addressType,
     // FIXME(bnoordhuis) Doesn't work for pipe handles, they don't have a
     // getsockname() method. Non-issue for now, the cluster module doesn't
     // really support pipes anyway.
-    if (err === 0 && port > 0 && handle.getsockname) {
+    if (err === 0 && port > 0 && handle && handle.getsockname) {
       var out = {};
       err = handle.getsockname(out);
       if (err === 0 && port !== out.port)
@@ -1363,8 +1507,11 @@ function listenInCluster(server, address, port, addressType,
       return server.emit('error', ex);
     }
 
-    // Reuse master's server handle
-    server._handle = handle;
+    // The master has told us to bind our own SO_REUSEPORT socket.
+    if (handle === null)
+      server._reusePort = true;
+    else
+      server._handle = handle;  // Reuse master's server handle
     // _listen2 sets up the listened handle, it is still named like this
     // to avoid breaking code that wraps this method
     server._listen2(address, port, addressType, backlog, fd);
@@ -1419,6 +1566,7 @@ Server.prototype.listen = function() {
       throw new RangeError('"port" argument must be >= 0 and < 65536');
     }
     const backlog = options.backlog || backlogFromArgs;
+    this._reusePort = !!options.reusePort;
     // start TCP server listening on host:port
     if (options.host) {
       lookupAndListen(this, options.port | 0, options.host, backlog,
@@ -1489,6 +1637,23 @@ function onconnection(err, clientHandle) {
     return;
   }
 
+  if (Array.isArray(clientHandle)) {
+    // Batched accept, see the acceptBatch option. A 'connection' listener
+    // may close the server part way through the batch.
+    for (var i = 0; i < clientHandle.length; i++) {
+      if (self._handle === handle)
+        acceptConnection(self, clientHandle[i]);
+      else
+        clientHandle[i].close();
+    }
+    return;
+  }
+
+  acceptConnection(self, clientHandle);
+}
+
+
+function acceptConnection(self, clientHandle) {
   if (self.maxConnections && self._connections >= self.maxConnections) {
     clientHandle.close();
     return;
@@ -1509,10 +1674,18 @@ function onconnection(err, clientHandle) {
   DTRACE_NET_SERVER_CONNECTION(socket);
   LTTNG_NET_SERVER_CONNECTION(socket);
   COUNTER_NET_SERVER_CONNECTION(socket);
+  counters.values[counters.kNetServerConnections]++;
+  counters.values[counters.kNetServerConnectionsOpen]++;
   self.emit('connection', socket);
 }
 
 
+// Totals over the connections of this server that have closed.
+Server.prototype.getIOStats = function() {
+  return util._extend(new IOStats(), this[IO_STATS]);
+};
+
+
 Server.prototype.getConnections = function(cb) {
   function end(err, connections) {
     process.nextTick(cb, err, connections);
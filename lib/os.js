@@ -24,6 +24,7 @@
 const binding = process.binding('os');
 const getCPUs = binding.getCPUs;
 const getLoadAvg = binding.getLoadAvg;
+const getStats = binding.getStats;
 const pushValToArrayMax = process.binding('util').pushValToArrayMax;
 const constants = process.binding('constants').os;
 const internalUtil = require('internal/util');
@@ -65,6 +66,24 @@ exports.cpus = function cpus() {
   return getCPUs(addCPUInfo, cpuValues, []);
 };
 
+// Fills in one Float64Array with everything at once, see doc/api/os.md for
+// the layout. The utilizations are computed against the CPU times that are
+// still in `previous`, so passing the last result back in makes them cover
+// the time in between, without allocating anything.
+exports.stats = function stats(previous) {
+  var array = previous;
+  if (array === undefined) {
+    array = new Float64Array(0);
+  } else if (!(array instanceof Float64Array)) {
+    throw new TypeError('"previous" argument must be a Float64Array');
+  }
+  var length;
+  // The length changes if CPUs go online or offline in between.
+  while ((length = getStats(array)) !== array.length)
+    array = new Float64Array(length);
+  return array;
+};
+
 Object.defineProperty(exports, 'constants', {
   configurable: false,
   enumerable: true,
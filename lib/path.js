@@ -23,144 +23,16 @@
 
 const inspect = require('util').inspect;
 
+// The . and .. segments of paths are resolved natively, with one allocation
+// for the result, and none for a path that is normalized already.
+const { normalizeString, normalizePosix } = process.binding('path');
+
 function assertPath(path) {
   if (typeof path !== 'string') {
     throw new TypeError('Path must be a string. Received ' + inspect(path));
   }
 }
 
-// Resolves . and .. elements in a path with directory names
-function normalizeStringWin32(path, allowAboveRoot) {
-  var res = '';
-  var lastSlash = -1;
-  var dots = 0;
-  var code;
-  for (var i = 0; i <= path.length; ++i) {
-    if (i < path.length)
-      code = path.charCodeAt(i);
-    else if (code === 47/*/*/ || code === 92/*\*/)
-      break;
-    else
-      code = 47/*/*/;
-    if (code === 47/*/*/ || code === 92/*\*/) {
-      if (lastSlash === i - 1 || dots === 1) {
-        // NOOP
-      } else if (lastSlash !== i - 1 && dots === 2) {
-        if (res.length < 2 ||
-            res.charCodeAt(res.length - 1) !== 46/*.*/ ||
-            res.charCodeAt(res.length - 2) !== 46/*.*/) {
-          if (res.length > 2) {
-            const start = res.length - 1;
-            var j = start;
-            for (; j >= 0; --j) {
-              if (res.charCodeAt(j) === 92/*\*/)
-                break;
-            }
-            if (j !== start) {
-              if (j === -1)
-                res = '';
-              else
-                res = res.slice(0, j);
-              lastSlash = i;
-              dots = 0;
-              continue;
-            }
-          } else if (res.length === 2 || res.length === 1) {
-            res = '';
-            lastSlash = i;
-            dots = 0;
-            continue;
-          }
-        }
-        if (allowAboveRoot) {
-          if (res.length > 0)
-            res += '\\..';
-          else
-            res = '..';
-        }
-      } else {
-        if (res.length > 0)
-          res += '\\' + path.slice(lastSlash + 1, i);
-        else
-          res = path.slice(lastSlash + 1, i);
-      }
-      lastSlash = i;
-      dots = 0;
-    } else if (code === 46/*.*/ && dots !== -1) {
-      ++dots;
-    } else {
-      dots = -1;
-    }
-  }
-  return res;
-}
-
-// Resolves . and .. elements in a path with directory names
-function normalizeStringPosix(path, allowAboveRoot) {
-  var res = '';
-  var lastSlash = -1;
-  var dots = 0;
-  var code;
-  for (var i = 0; i <= path.length; ++i) {
-    if (i < path.length)
-      code = path.charCodeAt(i);
-    else if (code === 47/*/*/)
-      break;
-    else
-      code = 47/*/*/;
-    if (code === 47/*/*/) {
-      if (lastSlash === i - 1 || dots === 1) {
-        // NOOP
-      } else if (lastSlash !== i - 1 && dots === 2) {
-        if (res.length < 2 ||
-            res.charCodeAt(res.length - 1) !== 46/*.*/ ||
-            res.charCodeAt(res.length - 2) !== 46/*.*/) {
-          if (res.length > 2) {
-            const start = res.length - 1;
-            var j = start;
-            for (; j >= 0; --j) {
-              if (res.charCodeAt(j) === 47/*/*/)
-                break;
-            }
-            if (j !== start) {
-              if (j === -1)
-                res = '';
-              else
-                res = res.slice(0, j);
-              lastSlash = i;
-              dots = 0;
-              continue;
-            }
-          } else if (res.length === 2 || res.length === 1) {
-            res = '';
-            lastSlash = i;
-            dots = 0;
-            continue;
-          }
-        }
-        if (allowAboveRoot) {
-          if (res.length > 0)
-            res += '/..';
-          else
-            res = '..';
-        }
-      } else {
-        if (res.length > 0)
-          res += '/' + path.slice(lastSlash + 1, i);
-        else
-          res = path.slice(lastSlash + 1, i);
-      }
-      lastSlash = i;
-      dots = 0;
-    } else if (code === 46/*.*/ && dots !== -1) {
-      ++dots;
-    } else {
-      dots = -1;
-    }
-  }
-  return res;
-}
-
 function _format(sep, pathObject) {
   const dir = pathObject.dir || pathObject.root;
   const base = pathObject.base ||
@@ -322,7 +194,7 @@ const win32 = {
     // fails)
 
     // Normalize the tail path
-    resolvedTail = normalizeStringWin32(resolvedTail, !resolvedAbsolute);
+    resolvedTail = normalizeString(resolvedTail, !resolvedAbsolute, true);
 
     return (resolvedDevice + (resolvedAbsolute ? '\\' : '') + resolvedTail) ||
            '.';
@@ -423,7 +295,7 @@ const win32 = {
     var trailingSeparator = (code === 47/*/*/ || code === 92/*\*/);
     var tail;
     if (rootEnd < len)
-      tail = normalizeStringWin32(path.slice(rootEnd), !isAbsolute);
+      tail = normalizeString(path.slice(rootEnd), !isAbsolute, true);
     else
       tail = '';
     if (tail.length === 0 && !isAbsolute)
@@ -1171,49 +1043,25 @@ const posix = {
         continue;
       }
 
-      resolvedPath = path + '/' + resolvedPath;
+      // A single path that is normalized already is returned as is.
+      if (resolvedPath.length > 0)
+        resolvedPath = path + '/' + resolvedPath;
+      else
+        resolvedPath = path;
       resolvedAbsolute = path.charCodeAt(0) === 47/*/*/;
     }
 
     // At this point the path should be resolved to a full absolute path, but
     // handle relative paths to be safe (might happen when process.cwd() fails)
 
-    // Normalize the path
-    resolvedPath = normalizeStringPosix(resolvedPath, !resolvedAbsolute);
-
-    if (resolvedAbsolute) {
-      if (resolvedPath.length > 0)
-        return '/' + resolvedPath;
-      else
-        return '/';
-    } else if (resolvedPath.length > 0) {
-      return resolvedPath;
-    } else {
-      return '.';
-    }
+    // Normalize the path, without a trailing separator
+    return normalizePosix(resolvedPath, false);
   },
 
 
   normalize: function normalize(path) {
     assertPath(path);
-
-    if (path.length === 0)
-      return '.';
-
-    const isAbsolute = path.charCodeAt(0) === 47/*/*/;
-    const trailingSeparator = path.charCodeAt(path.length - 1) === 47/*/*/;
-
-    // Normalize the path
-    path = normalizeStringPosix(path, !isAbsolute);
-
-    if (path.length === 0 && !isAbsolute)
-      path = '.';
-    if (path.length > 0 && trailingSeparator)
-      path += '/';
-
-    if (isAbsolute)
-      return '/' + path;
-    return path;
+    return normalizePosix(path, true);
   },
 
 
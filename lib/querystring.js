@@ -28,6 +28,10 @@ const {
   hexTable,
   isHexTable
 } = require('internal/querystring');
+const {
+  parseQueryString,
+  stringifyQueryString
+} = process.binding('url');
 const QueryString = module.exports = {
   unescapeBuffer,
   // `unescape()` is a JS global, so we need to use a different local name
@@ -237,6 +241,17 @@ function stringify(obj, sep, eq, options) {
   }
 
   if (obj !== null && typeof obj === 'object') {
+    // Without a custom encoder, all of it can be done in C++ with a single
+    // call.
+    if (encode === qsEscape && typeof sep === 'string' &&
+        typeof eq === 'string') {
+      const result = stringifyQueryString(obj, sep, eq);
+      if (result === null)
+        throw new URIError('URI malformed');
+      if (result !== undefined)
+        return result;
+    }
+
     var keys = Object.keys(obj);
     var len = keys.length;
     var flast = len - 1;
@@ -286,10 +301,8 @@ function parse(qs, sep, eq, options) {
     return obj;
   }
 
-  var sepCodes = (!sep ? defSepCodes : charCodes(sep + ''));
-  var eqCodes = (!eq ? defEqCodes : charCodes(eq + ''));
-  const sepLen = sepCodes.length;
-  const eqLen = eqCodes.length;
+  sep = (!sep ? '&' : sep + '');
+  eq = (!eq ? '=' : eq + '');
 
   var pairs = 1000;
   if (options && typeof options.maxKeys === 'number') {
@@ -308,6 +321,18 @@ function parse(qs, sep, eq, options) {
   }
   const customDecode = (decode !== qsUnescape);
 
+  // With the default decoding, all of it can be done in C++ with a single
+  // call.
+  if (!customDecode && QueryString.unescapeBuffer === unescapeBuffer) {
+    parseQueryString(obj, qs, sep, eq, pairs);
+    return obj;
+  }
+
+  const sepCodes = (sep === '&' ? defSepCodes : charCodes(sep));
+  const eqCodes = (eq === '=' ? defEqCodes : charCodes(eq));
+  const sepLen = sepCodes.length;
+  const eqLen = eqCodes.length;
+
   const keys = [];
   var lastPos = 0;
   var sepIdx = 0;
@@ -35,6 +35,7 @@ const util = require('util');
 const debug = util.debuglog('readline');
 const inherits = util.inherits;
 const Buffer = require('buffer').Buffer;
+const splitLines = process.binding('string_decoder').splitLines;
 const EventEmitter = require('events');
 const internalReadline = require('internal/readline');
 const emitKeys = internalReadline.emitKeys;
@@ -123,6 +124,7 @@ function Interface(input, output, completer, terminal) {
   }
 
   function onend() {
+    self._joinLinePieces();
     if (typeof self._line_buffer === 'string' &&
         self._line_buffer.length > 0) {
       self.emit('line', self._line_buffer);
@@ -162,6 +164,8 @@ function Interface(input, output, completer, terminal) {
     });
     var StringDecoder = require('string_decoder').StringDecoder; // lazy load
     this._decoder = new StringDecoder('utf8');
+    // The bytes of the unfinished line, when the input is Buffers.
+    this._line_pieces = [];
 
   } else {
 
@@ -375,10 +379,17 @@ Interface.prototype.write = function(d, key) {
 
 // \r\n, \n, or \r followed by something other than \n
 const lineEnding = /\r?\n|\r(?!\n)/;
+// Where splitLines() found the last line to end.
+const splitEnd = new Float64Array(1);
 Interface.prototype._normalWrite = function(b) {
   if (b === undefined) {
     return;
   }
+  if (ArrayBuffer.isView(b)) {
+    this._writeBuffer(b);
+    return;
+  }
+  this._joinLinePieces();
   var string = this._decoder.write(b);
   if (this._sawReturnAt &&
       Date.now() - this._sawReturnAt <= this.crlfDelay) {
@@ -409,6 +420,47 @@ Interface.prototype._normalWrite = function(b) {
   }
 };
 
+// Buffers are split into lines before they are decoded, in C++, which saves
+// decoding them into one string and splitting that with a regular expression.
+Interface.prototype._writeBuffer = function(b) {
+  var start = 0;
+  if (this._sawReturnAt &&
+      Date.now() - this._sawReturnAt <= this.crlfDelay) {
+    if (b[0] === 0x0a)
+      start = 1;
+    this._sawReturnAt = 0;
+  }
+
+  const pieces = this._line_pieces;
+  if (this._line_buffer) {
+    pieces.push(Buffer.from(this._line_buffer));
+    this._line_buffer = null;
+  }
+
+  const lines = splitLines(pieces.length > 0 ? pieces : null, b, start,
+                           splitEnd);
+  const end = splitEnd[0];
+  if (lines.length > 0) {
+    pieces.length = 0;
+    this._sawReturnAt = b[b.length - 1] === 0x0d ? Date.now() : 0;
+  }
+  // A copy, as the caller may reuse b.
+  if (end < b.length)
+    pieces.push(Buffer.from(b.subarray(end)));
+
+  for (var n = 0; n < lines.length; n++)
+    this._onLine(lines[n]);
+};
+
+// Turns the bytes of the unfinished line into this._line_buffer.
+Interface.prototype._joinLinePieces = function() {
+  const pieces = this._line_pieces;
+  if (pieces === undefined || pieces.length === 0)
+    return;
+  this._line_buffer = this._decoder.write(Buffer.concat(pieces));
+  pieces.length = 0;
+};
+
 Interface.prototype._insertString = function(c) {
   if (this.cursor < this.line.length) {
     var beg = this.line.slice(0, this.cursor);
@@ -0,0 +1,195 @@
+'use strict';
+
+// Runs long pieces of work in slices. A task is a function that does a bit
+// of its work each time it is called and returns true while it has more to
+// do. The tasks run from an immediate, so the I/O callbacks of each loop
+// iteration run first, and each slice runs tasks until its time is used up,
+// leaving the rest to the next iteration.
+
+const PriorityQueue = require('internal/priority_queue');
+
+const kHigh = 0;
+const kNormal = 1;
+const kLow = 2;
+
+const kDefaultSliceTime = 10;
+
+var sliceTime = kDefaultSliceTime;
+var nextSeq = 0;
+var pendingImmediate = null;
+var running = false;
+var sliceEnd = 0;
+
+const stats = {
+  slices: 0,
+  runs: 0,
+  completed: 0,
+  overdue: 0,
+  busyTime: 0,
+  longestSlice: 0
+};
+
+function now() {
+  const hr = process.hrtime();
+  return hr[0] * 1e3 + hr[1] / 1e6;
+}
+
+// Higher priority first, then the earliest deadline, then the order in which
+// the tasks were queued or yielded, so that tasks of the same priority and
+// deadline take turns.
+function compareTasks(a, b) {
+  if (a._priority !== b._priority)
+    return a._priority - b._priority;
+  if (a._deadline !== b._deadline)
+    return a._deadline < b._deadline ? -1 : 1;
+  return a._seq - b._seq;
+}
+
+function toPriority(priority) {
+  switch (priority) {
+    case 'high':
+      return kHigh;
+    case 'normal':
+      return kNormal;
+    case 'low':
+      return kLow;
+  }
+  throw new TypeError('"priority" must be high, normal or low');
+}
+
+function setPosition(task, pos) {
+  task._position = pos;
+}
+
+const queue = new PriorityQueue(compareTasks, setPosition);
+
+
+function Task(fn, priority, deadline) {
+  this._fn = fn;
+  this._priority = priority;
+  this._deadline = deadline;
+  this._seq = 0;
+  this._position = null;
+  this._cancelled = false;
+}
+
+Task.prototype.cancel = function() {
+  // A task that cancels itself while it runs is not queued again.
+  this._cancelled = true;
+  if (this._position === null)
+    return;
+  queue.removeAt(this._position);
+  if (queue.peek() === undefined && pendingImmediate !== null) {
+    clearImmediate(pendingImmediate);
+    pendingImmediate = null;
+  }
+};
+
+Object.defineProperty(Task.prototype, 'pending', {
+  configurable: true,
+  enumerable: true,
+  get() {
+    return this._position !== null;
+  }
+});
+
+
+// What a task is called with.
+function Slice(didTimeout) {
+  this.didTimeout = didTimeout;
+}
+
+Slice.prototype.timeRemaining = function() {
+  return Math.max(0, sliceEnd - now());
+};
+
+
+function enqueue(task) {
+  task._seq = nextSeq++;
+  queue.insert(task);
+  if (!running && pendingImmediate === null)
+    pendingImmediate = setImmediate(runSlice);
+}
+
+function runSlice() {
+  pendingImmediate = null;
+  const start = now();
+  sliceEnd = start + sliceTime;
+  stats.slices++;
+  running = true;
+  try {
+    do {
+      const task = queue.shift();
+      const didTimeout = task._deadline !== Infinity && task._deadline <= now();
+      if (didTimeout)
+        stats.overdue++;
+      stats.runs++;
+      // A task that throws is dropped.
+      if (task._fn(new Slice(didTimeout)) !== true)
+        stats.completed++;
+      else if (!task._cancelled)
+        enqueue(task);
+    } while (queue.peek() !== undefined && now() < sliceEnd);
+  } finally {
+    running = false;
+    const time = now() - start;
+    stats.busyTime += time;
+    if (time > stats.longestSlice)
+      stats.longestSlice = time;
+    if (queue.peek() !== undefined)
+      pendingImmediate = setImmediate(runSlice);
+  }
+}
+
+
+function postTask(fn, options) {
+  if (typeof fn !== 'function')
+    throw new TypeError('"fn" argument must be a function');
+
+  var priority = kNormal;
+  var deadline = Infinity;
+  if (options !== undefined) {
+    if (options === null || typeof options !== 'object')
+      throw new TypeError('"options" argument must be an object');
+    if (options.priority !== undefined)
+      priority = toPriority(options.priority);
+    if (options.deadline !== undefined) {
+      if (typeof options.deadline !== 'number' || !(options.deadline >= 0))
+        throw new TypeError('"deadline" must be a non-negative number');
+      deadline = now() + options.deadline;
+    }
+  }
+
+  const task = new Task(fn, priority, deadline);
+  enqueue(task);
+  return task;
+}
+
+function setSliceTime(ms) {
+  if (typeof ms !== 'number' || !(ms > 0))
+    throw new TypeError('"ms" argument must be a positive number');
+  sliceTime = ms;
+}
+
+function getSliceTime() {
+  return sliceTime;
+}
+
+function getStats() {
+  return {
+    pending: queue._size,
+    slices: stats.slices,
+    runs: stats.runs,
+    completed: stats.completed,
+    overdue: stats.overdue,
+    busyTime: stats.busyTime,
+    longestSlice: stats.longestSlice
+  };
+}
+
+module.exports = {
+  postTask,
+  setSliceTime,
+  getSliceTime,
+  getStats
+};
@@ -23,10 +23,13 @@
 
 const TimerWrap = process.binding('timer_wrap').Timer;
 const L = require('internal/linkedlist');
+const PriorityQueue = require('internal/priority_queue');
 const assert = require('assert');
 const util = require('util');
 const debug = util.debuglog('timer');
 const kOnTimeout = TimerWrap.kOnTimeout | 0;
+// How many immediates processImmediate() runs at most, see --immediate-budget.
+const immediateBudget = process.binding('config').immediateBudget | 0;
 
 // Timeout values > TIMEOUT_MAX are set to 1.
 const TIMEOUT_MAX = 2147483647; // 2^31-1
@@ -60,9 +63,12 @@ const TIMEOUT_MAX = 2147483647; // 2^31-1
 //
 // Object maps are kept which contain linked lists keyed by their duration in
 // milliseconds.
-// The linked lists within also have some meta-properties, one of which is a
-// TimerWrap C++ handle, which makes the call after the duration to process the
-// list it is attached to.
+// The linked lists within also have some meta-properties, one of which is
+// when the first timer in them expires. The lists are kept in a binary heap
+// ordered by that, and a single TimerWrap C++ handle makes the call when the
+// list at the top of the heap is due. There is one heap and TimerWrap for the
+// refed lists and one for the unrefed lists, however many durations are in
+// use.
 //
 //
 // ╔════ > Object Map
@@ -72,7 +78,7 @@ const TIMEOUT_MAX = 2147483647; // 2^31-1
 // ╚══          ┌─────────┘
 //              │
 // ╔══          │
-// ║ TimersList { _idleNext: { }, _idlePrev: (self), _timer: (TimerWrap) }
+// ║ TimersList { _idleNext: { }, _idlePrev: (self), expiry: (msecs) }
 // ║         ┌────────────────┘
 // ║    ╔══  │                              ^
 // ║    ║    { _idleNext: { },  _idlePrev: { }, _onTimeout: (callback) }
@@ -90,7 +96,8 @@ const TIMEOUT_MAX = 2147483647; // 2^31-1
 // is possible in the JavaScript layer. Any one list of timers is able to be
 // sorted by just appending to it because all timers within share the same
 // duration. Therefore, any timer added later will always have been scheduled to
-// timeout later, thus only needing to be appended.
+// timeout later, thus only needing to be appended. Appending to a list never
+// moves it in the heap either.
 // Removal from an object-property linked list is also virtually constant-time
 // as can be seen in the lib/internal/linkedlist.js implementation.
 // Timeouts only need to process any timers due to currently timeout, which will
@@ -98,12 +105,13 @@ const TIMEOUT_MAX = 2147483647; // 2^31-1
 // after the first one encountered that does not yet need to timeout will also
 // always be due to timeout at a later time.
 //
-// Less-than constant time operations are thus contained in two places:
-// TimerWrap's backing libuv timers implementation (a performant heap-based
-// queue), and the object map lookup of a specific list by the duration of
-// timers within (or creation of a new list).
+// Less-than constant time operations are thus contained in two places: the
+// heap of lists, which takes O(log n) in the number of durations when a list
+// is created, removed or processed, and the object map lookup of a specific
+// list by the duration of timers within (or creation of a new list).
 // However, these operations combined have shown to be trivial in comparison to
-// other alternative timers architectures.
+// other alternative timers architectures. In particular, servers that use many
+// different idle timeouts don't make libuv manage a timer for each of them.
 
 
 // Object maps containing linked lists of timers, keyed and sorted by their
@@ -119,6 +127,29 @@ const refedLists = Object.create(null);
 const unrefedLists = Object.create(null);
 
 
+// The lists of each of the two kinds share one TimerWrap. The lists are kept
+// in a binary heap ordered by when their first timer expires, and the
+// TimerWrap is started for the list at the top.
+function TimerListQueue(lists, unrefed) {
+  this.lists = lists;
+  this.heap = new PriorityQueue(compareTimersLists, setPosition);
+  this.unrefed = unrefed;
+  this.handle = null;
+  this.expiry = Infinity;  // When the handle fires, Infinity if it is stopped.
+}
+
+function compareTimersLists(a, b) {
+  return a.expiry - b.expiry;
+}
+
+function setPosition(list, pos) {
+  list.priorityQueuePosition = pos;
+}
+
+const refedQueue = new TimerListQueue(refedLists, false);
+const unrefedQueue = new TimerListQueue(unrefedLists, true);
+
+
 // Schedule or re-schedule a timer.
 // The item must have been enroll()'d first.
 const active = exports.active = function(item) {
@@ -135,65 +166,100 @@ exports._unrefActive = function(item) {
 // The underlying logic for scheduling or re-scheduling a timer.
 //
 // Appends a timer onto the end of an existing timers list, or creates a new
-// TimerWrap backed list if one does not already exist for the specified timeout
+// list in the queue if one does not already exist for the specified timeout
 // duration.
 function insert(item, unrefed) {
   const msecs = item._idleTimeout;
   if (msecs < 0 || msecs === undefined) return;
 
-  item._idleStart = TimerWrap.now();
+  const now = item._idleStart = TimerWrap.now();
 
-  const lists = unrefed === true ? unrefedLists : refedLists;
+  const queue = unrefed === true ? unrefedQueue : refedQueue;
 
   // Use an existing list if there is one, otherwise we need to make a new one.
-  var list = lists[msecs];
+  var list = queue.lists[msecs];
   if (!list) {
     debug('no %d list was found in insert, creating a new one', msecs);
-    lists[msecs] = list = createTimersList(msecs, unrefed);
+    queue.lists[msecs] = list = new TimersList(msecs, unrefed);
+    L.init(list);
+    list.expiry = now + msecs;
+    queue.heap.insert(list);
+    if (list.expiry < queue.expiry)
+      scheduleQueue(queue, list.expiry, now);
   }
 
+  // Appending never makes the first timer of the list expire earlier, so the
+  // list keeps its place in the heap.
   L.append(list, item);
   assert(!L.isEmpty(list)); // list is not empty
 }
 
-function createTimersList(msecs, unrefed) {
-  // Make a new linked list of timers, and create a TimerWrap to schedule
-  // processing for the list.
-  const list = new TimersList(msecs, unrefed);
-  L.init(list);
-  list._timer._list = list;
-
-  if (unrefed === true) list._timer.unref();
-  list._timer.start(msecs);
-
-  list._timer[kOnTimeout] = listOnTimeout;
-
-  return list;
-}
-
 function TimersList(msecs, unrefed) {
   this._idleNext = null; // Create the list with the linkedlist properties to
   this._idlePrev = null; // prevent any unnecessary hidden class changes.
-  this._timer = new TimerWrap();
   this._unrefed = unrefed;
   this.msecs = msecs;
-  this.nextTick = false;
+  // No later than the expiry of the first timer. Only the timers moving on
+  // make it later, which the list notices when it is processed.
+  this.expiry = 0;
+  this.priorityQueuePosition = null;
 }
 
-function listOnTimeout() {
-  var list = this._list;
-  var msecs = list.msecs;
+function scheduleQueue(queue, expiry, now) {
+  var handle = queue.handle;
+  if (handle === null) {
+    queue.handle = handle = new TimerWrap();
+    handle._queue = queue;
+    handle[kOnTimeout] = processTimers;
+    if (queue.unrefed) handle.unref();
+  } else if (!queue.unrefed && queue.expiry === Infinity) {
+    handle.ref();
+  }
+  queue.expiry = expiry;
+  handle.start(expiry > now ? expiry - now : 0);
+}
+
+function stopQueue(queue) {
+  queue.expiry = Infinity;
+  if (queue.handle === null) return;
+  queue.handle.stop();
+  // A stopped handle doesn't keep the loop alive, but it would still show up
+  // in process._getActiveHandles() while it is ref()ed.
+  if (!queue.unrefed) queue.handle.unref();
+}
+
+// Takes |list| out of its queue, unless that happened already.
+function removeList(queue, list) {
+  if (list.priorityQueuePosition !== null)
+    queue.heap.removeAt(list.priorityQueuePosition);
+  // The list for this duration may have been removed and recreated since.
+  if (queue.lists[list.msecs] === list)
+    delete queue.lists[list.msecs];
+  if (queue.heap.peek() === undefined)
+    stopQueue(queue);
+}
+
+function processTimers() {
+  const queue = this._queue;
+  queue.expiry = Infinity;
 
-  if (list.nextTick) {
-    list.nextTick = false;
-    process.nextTick(listOnTimeoutNT, list);
-    return;
+  var list;
+  while ((list = queue.heap.peek()) !== undefined) {
+    var now = TimerWrap.now();
+    debug('now: %d', now);
+    if (list.expiry > now) {
+      scheduleQueue(queue, list.expiry, now);
+      return;
+    }
+    listOnTimeout(queue, list, now);
   }
+  stopQueue(queue);
+}
 
-  debug('timeout callback %d', msecs);
+function listOnTimeout(queue, list, now) {
+  var msecs = list.msecs;
 
-  var now = TimerWrap.now();
-  debug('now: %d', now);
+  debug('timeout callback %d', msecs);
 
   var diff, timer;
   while (timer = L.peek(list)) {
@@ -202,11 +268,9 @@ function listOnTimeout() {
     // Check if this loop iteration is too early for the next timer.
     // This happens if there are more timers scheduled for later in the list.
     if (diff < msecs) {
-      var timeRemaining = msecs - (TimerWrap.now() - timer._idleStart);
-      if (timeRemaining < 0) {
-        timeRemaining = 0;
-      }
-      this.start(timeRemaining);
+      list.expiry = timer._idleStart + msecs;
+      if (list.priorityQueuePosition !== null)
+        queue.heap.percolateDown(list.priorityQueuePosition);
       debug('%d list wait because diff is %d', msecs, diff);
       return;
     }
@@ -232,7 +296,7 @@ function listOnTimeout() {
       domain.enter();
     }
 
-    tryOnTimeout(timer, list);
+    tryOnTimeout(timer, queue);
 
     if (domain)
       domain.exit();
@@ -240,31 +304,16 @@ function listOnTimeout() {
 
   // If `L.peek(list)` returned nothing, the list was either empty or we have
   // called all of the timer timeouts.
-  // As such, we can remove the list and clean up the TimerWrap C++ handle.
+  // As such, we can remove the list from its queue.
   debug('%d list empty', msecs);
   assert(L.isEmpty(list));
-
-  // Either refedLists[msecs] or unrefedLists[msecs] may have been removed and
-  // recreated since the reference to `list` was created. Make sure they're
-  // the same instance of the list before destroying.
-  if (list._unrefed === true && list === unrefedLists[msecs]) {
-    delete unrefedLists[msecs];
-  } else if (list === refedLists[msecs]) {
-    delete refedLists[msecs];
-  }
-
-  // Do not close the underlying handle if its ownership has changed
-  // (e.g it was unrefed in its callback).
-  if (this.owner)
-    return;
-
-  this.close();
+  removeList(queue, list);
 }
 
 
 // An optimization so that the try/finally only de-optimizes (since at least v8
 // 4.7) what is in this smaller function.
-function tryOnTimeout(timer, list) {
+function tryOnTimeout(timer, queue) {
   timer._called = true;
   var threw = true;
   try {
@@ -273,60 +322,48 @@ function tryOnTimeout(timer, list) {
   } finally {
     if (!threw) return;
 
-    // Postpone all later list events to next tick. We need to do this
-    // so that the events are called in the order they were created.
-    const lists = list._unrefed === true ? unrefedLists : refedLists;
-    for (var key in lists) {
-      if (key > list.msecs) {
-        lists[key].nextTick = true;
-      }
-    }
+    // The timers that are due after this one, in this list and the later
+    // ones, run in nextTick so that they are still called in the order
+    // they were created.
     // We need to continue processing after domain error handling
     // is complete, but not by using whatever domain was left over
     // when the timeout threw its exception.
     const domain = process.domain;
     process.domain = null;
-    // If we threw, we need to process the rest of the list in nextTick.
-    process.nextTick(listOnTimeoutNT, list);
+    process.nextTick(processTimersNT, queue);
     process.domain = domain;
   }
 }
 
 
-function listOnTimeoutNT(list) {
-  list._timer[kOnTimeout]();
+function processTimersNT(queue) {
+  if (queue.handle !== null)
+    processTimers.call(queue.handle);
 }
 
 
-// A convenience function for re-using TimerWrap handles more easily.
-//
-// This mostly exists to fix https://github.com/nodejs/node/issues/1264.
-// Handles in libuv take at least one `uv_run` to be registered as unreferenced.
-// Re-using an existing handle allows us to skip that, so that a second `uv_run`
-// will return no active handles, even when running `setTimeout(fn).unref()`.
-function reuse(item) {
+// Takes a timer out of its list, and the list out of its queue if it is empty
+// then, so that a cleared timer doesn't keep the queue's handle running.
+function removeFromList(item) {
   L.remove(item);
 
-  var list = refedLists[item._idleTimeout];
-  // if empty - reuse the watcher
+  const msecs = item._idleTimeout;
+  var list = refedLists[msecs];
   if (list && L.isEmpty(list)) {
-    debug('reuse hit');
-    list._timer.stop();
-    delete refedLists[item._idleTimeout];
-    return list._timer;
+    debug('removing empty %d list', msecs);
+    removeList(refedQueue, list);
+  }
+  list = unrefedLists[msecs];
+  if (list && L.isEmpty(list)) {
+    debug('removing empty unrefed %d list', msecs);
+    removeList(unrefedQueue, list);
   }
-
-  return null;
 }
 
 
 // Remove a timer. Cancels the timeout and resets the relevant timer properties.
 const unenroll = exports.unenroll = function(item) {
-  var handle = reuse(item);
-  if (handle) {
-    debug('unenroll: list empty');
-    handle.close();
-  }
+  removeFromList(item);
   // if active is called later, then we want to make sure not to insert again
   item._idleTimeout = -1;
 };
@@ -537,9 +574,9 @@ Timeout.prototype.unref = function() {
       return;
     }
 
-    var handle = reuse(this);
+    removeFromList(this);
 
-    this._handle = handle || new TimerWrap();
+    this._handle = new TimerWrap();
     this._handle.owner = this;
     this._handle[kOnTimeout] = unrefdHandle;
     this._handle.start(delay);
@@ -609,14 +646,20 @@ ImmediateList.prototype.remove = function(item) {
 // Create a single linked list instance only once at startup
 var immediateQueue = new ImmediateList();
 
+// The last of the immediates that processImmediate() took off the queue and
+// is running. clearImmediate() moves it back if that immediate is cleared, so
+// that what has not run yet can be put back in front of the queue.
+var runningTail = null;
+
 
 function processImmediate() {
   var immediate = immediateQueue.head;
-  var tail = immediateQueue.tail;
   var domain;
+  var ran = 0;
 
   // Clear the linked list early in case new `setImmediate()` calls occur while
   // immediate callbacks are executed
+  runningTail = immediateQueue.tail;
   immediateQueue.head = immediateQueue.tail = null;
 
   while (immediate) {
@@ -627,6 +670,13 @@ function processImmediate() {
       continue;
     }
 
+    // Leave the rest to the next iteration of the event loop, so that I/O is
+    // polled for in between.
+    if (immediateBudget > 0 && ran++ === immediateBudget) {
+      requeueImmediates(immediate);
+      break;
+    }
+
     if (domain)
       domain.enter();
 
@@ -635,7 +685,7 @@ function processImmediate() {
     // Save next in case `clearImmediate(immediate)` is called from callback
     var next = immediate._idleNext;
 
-    tryOnImmediate(immediate, tail);
+    tryOnImmediate(immediate);
 
     if (domain)
       domain.exit();
@@ -647,6 +697,7 @@ function processImmediate() {
     else
       immediate = next;
   }
+  runningTail = null;
 
   // Only round-trip to C++ land if we have to. Calling clearImmediate() on an
   // immediate that's in |queue| is okay. Worst case is we make a superfluous
@@ -657,9 +708,27 @@ function processImmediate() {
 }
 
 
+// Puts the immediates from |head| to |runningTail|, which processImmediate()
+// has not run yet, back in front of the queue.
+function requeueImmediates(head) {
+  const curHead = immediateQueue.head;
+  head._idlePrev = null;
+  if (curHead) {
+    curHead._idlePrev = runningTail;
+    runningTail._idleNext = curHead;
+  } else {
+    immediateQueue.tail = runningTail;
+  }
+  immediateQueue.head = head;
+  runningTail = null;
+  // A clearImmediate() from one of the callbacks may have turned this off.
+  process._needImmediateCallback = true;
+}
+
+
 // An optimization so that the try/finally only de-optimizes (since at least v8
 // 4.7) what is in this smaller function.
-function tryOnImmediate(immediate, oldTail) {
+function tryOnImmediate(immediate) {
   var threw = true;
   try {
     // make the actual call outside the try/catch to allow it to be optimized
@@ -668,18 +737,10 @@ function tryOnImmediate(immediate, oldTail) {
   } finally {
     if (threw && immediate._idleNext) {
       // Handle any remaining on next tick, assuming we're still alive to do so.
-      const curHead = immediateQueue.head;
-      const next = immediate._idleNext;
-      if (curHead) {
-        curHead._idlePrev = oldTail;
-        oldTail._idleNext = curHead;
-        next._idlePrev = null;
-        immediateQueue.head = next;
-      } else {
-        immediateQueue.head = next;
-        immediateQueue.tail = oldTail;
-      }
+      requeueImmediates(immediate._idleNext);
       process.nextTick(processImmediate);
+    } else if (threw) {
+      runningTail = null;
     }
   }
 }
@@ -765,6 +826,8 @@ exports.clearImmediate = function(immediate) {
 
   immediate._onImmediate = null;
 
+  if (immediate === runningTail)
+    runningTail = immediate._idlePrev;
   immediateQueue.remove(immediate);
 
   if (!immediateQueue.head) {
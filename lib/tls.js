@@ -253,6 +253,8 @@ exports.parseCertString = function parseCertString(s) {
 // Public API
 exports.createSecureContext = require('_tls_common').createSecureContext;
 exports.SecureContext = require('_tls_common').SecureContext;
+exports.createCAStore = require('_tls_common').createCAStore;
+exports.CAStore = require('_tls_common').CAStore;
 exports.TLSSocket = require('_tls_wrap').TLSSocket;
 exports.Server = require('_tls_wrap').Server;
 exports.createServer = require('_tls_wrap').createServer;
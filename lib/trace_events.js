@@ -0,0 +1,34 @@
+'use strict';
+
+const binding = process.binding('trace_events');
+
+function validateCategories(categories) {
+  if (!Array.isArray(categories) || categories.length === 0)
+    throw new TypeError('"categories" must be a non-empty array of strings');
+  for (const category of categories) {
+    if (typeof category !== 'string' || category.length === 0 ||
+        category.includes(',')) {
+      throw new TypeError('"categories" must be a non-empty array of strings');
+    }
+  }
+}
+
+// Starts recording the given categories, or switches to them when already
+// recording. Trace events are written to the same files as with
+// --trace-events-enabled.
+function start(categories) {
+  validateCategories(categories);
+  binding.start(categories.join(','));
+}
+
+function getEnabledCategories() {
+  const categories = binding.getEnabledCategories();
+  return categories === undefined ? [] : categories.split(',');
+}
+
+module.exports = {
+  start,
+  stop: binding.stop,
+  rotate: binding.rotate,
+  getEnabledCategories
+};
@@ -147,6 +147,9 @@ exports.format = function(f) {
 exports.deprecate = internalUtil.deprecate;
 
 
+exports.Histogram = require('internal/histogram').Histogram;
+
+
 var debugs = {};
 var debugEnviron;
 exports.debuglog = function(set) {
@@ -66,6 +66,84 @@ exports.getHeapStatistics = function() {
   };
 };
 
+// Counts the files that were named by diagnosticFilename().
+var diagnosticFileSeq = 0;
+
+function diagnosticFilename(prefix, extension) {
+  const pad = (n, width) => String(n).padStart(width, '0');
+  const now = new Date();
+  const date = pad(now.getFullYear(), 4) + pad(now.getMonth() + 1, 2) +
+               pad(now.getDate(), 2);
+  const time = pad(now.getHours(), 2) + pad(now.getMinutes(), 2) +
+               pad(now.getSeconds(), 2);
+  return `${prefix}.${date}.${time}.${process.pid}.` +
+         `${pad(++diagnosticFileSeq, 3)}.${extension}`;
+}
+
+exports.writeHeapSnapshot = function writeHeapSnapshot(filename) {
+  if (filename === undefined)
+    filename = diagnosticFilename('Heap', 'heapsnapshot');
+  else if (typeof filename !== 'string')
+    throw new TypeError('"filename" argument must be a string');
+  v8binding.writeHeapSnapshot(filename);
+  return filename;
+};
+
+function startSamplingHeapProfiler(options) {
+  var interval = 512 * 1024;
+  var stackDepth = 16;
+  if (options !== undefined) {
+    if (options === null || typeof options !== 'object')
+      throw new TypeError('"options" must be an object');
+    if (options.interval !== undefined) {
+      interval = options.interval;
+      if (!Number.isSafeInteger(interval) || interval < 1)
+        throw new RangeError('"interval" must be a positive integer');
+    }
+    if (options.stackDepth !== undefined) {
+      stackDepth = options.stackDepth;
+      if (!Number.isInteger(stackDepth) || stackDepth < 1 ||
+          stackDepth > 0x7fffffff) {
+        throw new RangeError('"stackDepth" must be a positive integer');
+      }
+    }
+  }
+  return v8binding.startSamplingHeapProfiler(interval, stackDepth);
+}
+
+exports.startSamplingHeapProfiler = startSamplingHeapProfiler;
+
+exports.startCpuProfile = function startCpuProfile(options) {
+  var interval = 1000;
+  if (options !== undefined) {
+    if (options === null || typeof options !== 'object')
+      throw new TypeError('"options" must be an object');
+    if (options.interval !== undefined) {
+      interval = options.interval;
+      if (!Number.isInteger(interval) || interval < 1 ||
+          interval > 0x7fffffff) {
+        throw new RangeError('"interval" must be a positive integer');
+      }
+    }
+  }
+  return v8binding.startCpuProfile(interval);
+};
+
+exports.stopCpuProfile = function stopCpuProfile(filename) {
+  if (filename === undefined)
+    filename = diagnosticFilename('CPU', 'nodecpuprofile');
+  else if (typeof filename !== 'string')
+    throw new TypeError('"filename" argument must be a string');
+  v8binding.stopCpuProfile(filename);
+  return filename;
+};
+
+exports.convertCpuProfile = function convertCpuProfile(buffer) {
+  return require('internal/cpu_profile').toCpuProfile(buffer);
+};
+exports.stopSamplingHeapProfiler = v8binding.stopSamplingHeapProfiler;
+exports.getAllocationProfile = v8binding.getAllocationProfile;
+
 exports.cachedDataVersionTag = v8binding.cachedDataVersionTag;
 exports.setFlagsFromString = v8binding.setFlagsFromString;
 
@@ -88,6 +166,104 @@ exports.getHeapSpaceStatistics = function() {
   return heapSpaceStatistics;
 };
 
+// Indices into the records of the ring buffer that
+// v8binding.startGCTracking() returns, see GCMetrics::Fields.
+const kGCType = 0;
+const kGCFlags = 1;
+const kGCStartTime = 2;
+const kGCDuration = 3;
+const kGCUsedHeapSizeBefore = 4;
+const kGCUsedHeapSizeAfter = 5;
+const kGCSpaceDeltas = 6;
+const kGCRecordSize = kGCSpaceDeltas + kNumberOfHeapSpaces;
+
+// v8::GCType and v8::GCCallbackFlags.
+const gcTypes = {
+  1: 'scavenge',
+  2: 'markSweepCompact',
+  4: 'incrementalMarking',
+  8: 'processWeakCallbacks'
+};
+const kGCCallbackFlagForced = 1 << 2;
+
+var gcBuffer = null;
+var gcBufferSize = 0;
+// The number of records that readGCEvents() has gone past.
+var gcRead = 0;
+var gcPauseHistogram = null;
+
+exports.startGCTracking = function startGCTracking(options) {
+  var bufferSize = 1024;
+  if (options !== undefined) {
+    if (options === null || typeof options !== 'object')
+      throw new TypeError('"options" must be an object');
+    if (options.bufferSize !== undefined) {
+      bufferSize = options.bufferSize;
+      if (!Number.isInteger(bufferSize) || bufferSize < 1 ||
+          bufferSize > 0x100000) {
+        throw new RangeError(
+          '"bufferSize" must be an integer from 1 to 1048576');
+      }
+    }
+  }
+  // A buffer of a different size starts out empty.
+  if (bufferSize !== gcBufferSize)
+    gcRead = 0;
+  gcBuffer = v8binding.startGCTracking(bufferSize);
+  gcBufferSize = bufferSize;
+};
+
+exports.stopGCTracking = function stopGCTracking() {
+  // Whatever was recorded can still be read.
+  v8binding.stopGCTracking();
+};
+
+function readGCEvent(n) {
+  const offset = 1 + (n % gcBufferSize) * kGCRecordSize;
+  const heapSpaceDeltas = {};
+  for (var i = 0; i < kNumberOfHeapSpaces; i++)
+    heapSpaceDeltas[kHeapSpaces[i]] = gcBuffer[offset + kGCSpaceDeltas + i];
+  return {
+    type: gcTypes[gcBuffer[offset + kGCType]],
+    forced: (gcBuffer[offset + kGCFlags] & kGCCallbackFlagForced) !== 0,
+    startTime: gcBuffer[offset + kGCStartTime],
+    duration: gcBuffer[offset + kGCDuration],
+    usedHeapSizeBefore: gcBuffer[offset + kGCUsedHeapSizeBefore],
+    usedHeapSizeAfter: gcBuffer[offset + kGCUsedHeapSizeAfter],
+    heapSpaceDeltas
+  };
+}
+
+exports.readGCEvents = function readGCEvents() {
+  if (gcBuffer === null)
+    return { events: [], dropped: 0 };
+  const written = gcBuffer[0];
+  // Whatever did not fit into the buffer since the last call is gone.
+  const start = Math.max(gcRead, written - gcBufferSize);
+  var dropped = start - gcRead;
+  const events = [];
+  for (var n = start; n < written; n++)
+    events.push(readGCEvent(n));
+  // Creating the events can cause collections, which may have overwritten
+  // the oldest records while they were read.
+  const overwritten = Math.min(gcBuffer[0] - gcBufferSize - start,
+                               events.length);
+  if (overwritten > 0) {
+    events.splice(0, overwritten);
+    dropped += overwritten;
+  }
+  gcRead = written;
+  return { events, dropped };
+};
+
+exports.getGCPauseHistogram = function getGCPauseHistogram() {
+  if (gcPauseHistogram === null) {
+    const { wrapHistogram } = require('internal/histogram');
+    gcPauseHistogram = wrapHistogram(v8binding.getGCPauseHistogram());
+  }
+  return gcPauseHistogram;
+};
+
 /* V8 serialization API */
 
 const Serializer = exports.Serializer = serdesBinding.Serializer;
@@ -105,7 +281,8 @@ Deserializer.prototype.readRawBytes = function(length) {
                         length);
 };
 
-/* Keep track of how to handle different ArrayBufferViews.
+/* Keep track of how to handle different ArrayBufferViews. The indices have to
+ * match HostObjectType in src/node_serdes.cc.
  * The default Serializer for Node does not use the V8 methods for serializing
  * those objects because Node's `Buffer` objects use pooled allocation in many
  * cases, and their underlying `ArrayBuffer`s would show up in the
@@ -188,15 +365,23 @@ class DefaultDeserializer extends Deserializer {
 
 exports.DefaultDeserializer = DefaultDeserializer;
 
-exports.serialize = function serialize(value) {
-  const ser = new DefaultSerializer();
-  ser.writeHeader();
-  ser.writeValue(value);
-  return ser.releaseBuffer();
+// These produce and read the same data as DefaultSerializer and
+// DefaultDeserializer, but handle the ArrayBufferViews natively instead of
+// calling back into JS for each of them.
+exports.serialize = function serialize(value, target) {
+  return serdesBinding.serialize(value, target);
 };
 
 exports.deserialize = function deserialize(buffer) {
-  const der = new DefaultDeserializer(buffer);
-  der.readHeader();
-  return der.readValue();
+  return serdesBinding.deserialize(buffer);
+};
+
+exports.createSerializeStream = function createSerializeStream(options) {
+  const { SerializeStream } = require('internal/v8_streams');
+  return new SerializeStream(options);
+};
+
+exports.createDeserializeStream = function createDeserializeStream(options) {
+  const { DeserializeStream } = require('internal/v8_streams');
+  return new DeserializeStream(options);
 };
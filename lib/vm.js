@@ -31,7 +31,9 @@ const Script = binding.ContextifyScript;
 //   - runInThisContext({ displayErrors = true } = {})
 //   - runInContext(sandbox, { displayErrors = true, timeout = undefined } = {})
 // - makeContext(sandbox)
+// - makeGlobalContext()
 // - isContext(sandbox)
+// - resetContext(contextifiedSandbox, sandbox)
 // From this we build the entire documented API.
 
 const realRunInThisContext = Script.prototype.runInThisContext;
@@ -59,7 +61,18 @@ Script.prototype.runInNewContext = function(sandbox, options) {
   return this.runInContext(context, options);
 };
 
-function createContext(sandbox) {
+function createContext(sandbox, options) {
+  if (options && options.interceptors === false) {
+    if (sandbox !== undefined && binding.isContext(sandbox))
+      throw new TypeError('sandbox argument must not be a context.');
+    // The global is the sandbox, which starts out with the properties of
+    // |sandbox|.
+    const global = binding.makeGlobalContext();
+    if (sandbox !== undefined)
+      Object.assign(global, sandbox);
+    return global;
+  }
+
   if (sandbox === undefined) {
     sandbox = {};
   } else if (binding.isContext(sandbox)) {
@@ -70,6 +83,21 @@ function createContext(sandbox) {
   return sandbox;
 }
 
+function resetContext(contextifiedSandbox, sandbox) {
+  if (!binding.isContext(contextifiedSandbox))
+    throw new TypeError('contextifiedSandbox argument must be a context.');
+  if (sandbox === undefined) {
+    sandbox = {};
+  } else if (binding.isContext(sandbox)) {
+    throw new TypeError('sandbox argument must not be a context.');
+  } else if (sandbox === null || typeof sandbox !== 'object') {
+    throw new TypeError('sandbox argument must be an object.');
+  }
+
+  binding.resetContext(contextifiedSandbox, sandbox);
+  return sandbox;
+}
+
 function createScript(code, options) {
   return new Script(code, options);
 }
@@ -124,5 +152,6 @@ module.exports = {
   runInContext,
   runInNewContext,
   runInThisContext,
-  isContext: binding.isContext
+  isContext: binding.isContext,
+  resetContext
 };
@@ -0,0 +1,10 @@
+'use strict';
+
+const worker = require('internal/worker');
+
+module.exports = {
+  Worker: worker.Worker,
+  isMainThread: worker.isMainThread,
+  threadId: worker.threadId,
+  parentPort: worker.parentPort
+};
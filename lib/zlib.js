@@ -26,6 +26,7 @@ const internalUtil = require('internal/util');
 const Transform = require('_stream_transform');
 const binding = process.binding('zlib');
 const assert = require('assert').ok;
+const os = require('os');
 const kMaxLength = require('buffer').kMaxLength;
 const kRangeErrorMessage = 'Cannot create final Buffer. It would be larger ' +
                            `than 0x${kMaxLength.toString(16)} bytes`;
@@ -33,6 +34,9 @@ const kRangeErrorMessage = 'Cannot create final Buffer. It would be larger ' +
 const constants = process.binding('constants').zlib;
 const createClassWrapper = internalUtil.createClassWrapper;
 
+// The Brotli modes only exist if node was built with --shared-brotli.
+const hasBrotli = constants.BROTLI_ENCODE !== undefined;
+
 // translation table for return codes.
 const codes = {
   Z_OK: constants.Z_OK,
@@ -77,6 +81,280 @@ function isInvalidStrategy(strategy) {
   //         constants.Z_DEFAULT_STRATEGY (0)
 }
 
+function isBrotliMode(mode) {
+  return hasBrotli && (mode === constants.BROTLI_ENCODE ||
+                       mode === constants.BROTLI_DECODE);
+}
+
+function checkOptions(opts, mode) {
+  if (opts.flush && isInvalidFlushFlag(opts.flush)) {
+    throw new RangeError('Invalid flush flag: ' + opts.flush);
+  }
+  if (opts.finishFlush && isInvalidFlushFlag(opts.finishFlush)) {
+    throw new RangeError('Invalid flush flag: ' + opts.finishFlush);
+  }
+
+  if (opts.chunkSize) {
+    if (opts.chunkSize < constants.Z_MIN_CHUNK) {
+      throw new RangeError('Invalid chunk size: ' + opts.chunkSize);
+    }
+  }
+
+  if (isBrotliMode(mode)) {
+    if (opts.windowBits) {
+      if (opts.windowBits < constants.BROTLI_MIN_WINDOW_BITS ||
+          opts.windowBits > constants.BROTLI_MAX_WINDOW_BITS) {
+        throw new RangeError('Invalid windowBits: ' + opts.windowBits);
+      }
+    }
+
+    if (opts.quality !== undefined) {
+      if (typeof opts.quality !== 'number' ||
+          opts.quality < constants.BROTLI_MIN_QUALITY ||
+          opts.quality > constants.BROTLI_MAX_QUALITY) {
+        throw new RangeError('Invalid quality: ' + opts.quality);
+      }
+    }
+
+    // The zlib options below don't apply to Brotli.
+    return;
+  }
+
+  if (opts.windowBits) {
+    if (opts.windowBits < constants.Z_MIN_WINDOWBITS ||
+        opts.windowBits > constants.Z_MAX_WINDOWBITS) {
+      throw new RangeError('Invalid windowBits: ' + opts.windowBits);
+    }
+  }
+
+  if (opts.level) {
+    if (opts.level < constants.Z_MIN_LEVEL ||
+        opts.level > constants.Z_MAX_LEVEL) {
+      throw new RangeError('Invalid compression level: ' + opts.level);
+    }
+  }
+
+  if (opts.memLevel) {
+    if (opts.memLevel < constants.Z_MIN_MEMLEVEL ||
+        opts.memLevel > constants.Z_MAX_MEMLEVEL) {
+      throw new RangeError('Invalid memLevel: ' + opts.memLevel);
+    }
+  }
+
+  if (opts.strategy && isInvalidStrategy(opts.strategy))
+    throw new TypeError('Invalid strategy: ' + opts.strategy);
+
+  if (opts.dictionary) {
+    if (!ArrayBuffer.isView(opts.dictionary) &&
+        !(opts.dictionary instanceof binding.Dictionary)) {
+      throw new TypeError(
+        'Invalid dictionary: it should be a Buffer, TypedArray, or DataView');
+    }
+  }
+}
+
+function finishFlushFlag(opts) {
+  return opts.finishFlush !== undefined ?
+    opts.finishFlush : constants.Z_FINISH;
+}
+
+function createHandle(mode, opts, level, strategy, onerror) {
+  const handle = new binding.Zlib(mode);
+  handle.onerror = onerror;
+  if (isBrotliMode(mode)) {
+    handle.initBrotli(typeof opts.quality === 'number' ?
+                        opts.quality : constants.BROTLI_DEFAULT_QUALITY,
+                      opts.windowBits || constants.BROTLI_DEFAULT_WINDOW);
+    return handle;
+  }
+  handle.init(opts.windowBits || constants.Z_DEFAULT_WINDOWBITS,
+              level,
+              opts.memLevel || constants.Z_DEFAULT_MEMLEVEL,
+              strategy,
+              opts.dictionary);
+  return handle;
+}
+
+const kDictionaryId = Symbol('dictionaryId');
+var dictionaryCount = 0;
+
+function createDictionary(data) {
+  if (typeof data === 'string')
+    data = Buffer.from(data);
+  else if (!ArrayBuffer.isView(data))
+    throw new TypeError('"data" argument must be a string, Buffer, ' +
+                        'TypedArray, or DataView');
+  const dictionary = new binding.Dictionary(data);
+  dictionary[kDictionaryId] = ++dictionaryCount;
+  return dictionary;
+}
+
+function createChecksum(update, initial) {
+  return function checksum(data, value) {
+    if (typeof data !== 'string' && !ArrayBuffer.isView(data))
+      throw new TypeError('"data" argument must be a string, Buffer, ' +
+                          'TypedArray, or DataView');
+    if (value === undefined)
+      value = initial;
+    else if (!Number.isInteger(value) || value < 0 || value > 0xffffffff)
+      throw new TypeError('"value" argument must be an unsigned 32-bit ' +
+                          'integer');
+    return update(data, value);
+  };
+}
+
+// Handles of the convenience methods are reset and kept for the next call
+// with the same settings, which saves setting up the window and hash tables
+// (and loading the dictionary) again. The pools with the oldest keys go
+// first when there are too many of them.
+const kMaxPooledHandles = 4;
+const kMaxHandlePools = 16;
+const kPoolKey = Symbol('poolKey');
+const handlePools = new Map();
+
+function handlePoolKey(mode, opts, level, strategy) {
+  // UNZIP turns into the mode it detected and Brotli has no cheap reset.
+  if (mode === constants.UNZIP || isBrotliMode(mode))
+    return null;
+  var dictionary = '';
+  if (opts.dictionary) {
+    // The contents of a plain buffer may change between calls.
+    if (!(opts.dictionary instanceof binding.Dictionary))
+      return null;
+    dictionary = opts.dictionary[kDictionaryId];
+  }
+  return `${mode}:${level}:${strategy}:` +
+         `${opts.windowBits || constants.Z_DEFAULT_WINDOWBITS}:` +
+         `${opts.memLevel || constants.Z_DEFAULT_MEMLEVEL}:${dictionary}`;
+}
+
+function createOneShotHandle(mode, opts, onerror) {
+  checkOptions(opts, mode);
+  const level = typeof opts.level === 'number' ?
+    opts.level : constants.Z_DEFAULT_COMPRESSION;
+  const strategy = typeof opts.strategy === 'number' ?
+    opts.strategy : constants.Z_DEFAULT_STRATEGY;
+
+  const key = handlePoolKey(mode, opts, level, strategy);
+  const pool = key !== null ? handlePools.get(key) : undefined;
+  var handle;
+  if (pool !== undefined && pool.length > 0) {
+    handle = pool.pop();
+    handle.onerror = onerror;
+  } else {
+    handle = createHandle(mode, opts, level, strategy, onerror);
+  }
+  handle[kPoolKey] = key;
+  return handle;
+}
+
+// Puts a handle that finished without an error back into its pool.
+function releaseOneShotHandle(handle) {
+  const key = handle[kPoolKey];
+  if (key === null)
+    return handle.close();
+
+  var failed = false;
+  handle.onerror = () => { failed = true; };
+  handle.reset();
+  if (failed)
+    return handle.close();
+
+  var pool = handlePools.get(key);
+  if (pool === undefined) {
+    if (handlePools.size >= kMaxHandlePools) {
+      // Maps iterate in insertion order.
+      const oldest = handlePools.keys().next().value;
+      handlePools.get(oldest).forEach((handle) => handle.close());
+      handlePools.delete(oldest);
+    }
+    pool = [];
+    handlePools.set(key, pool);
+  }
+  if (pool.length >= kMaxPooledHandles)
+    return handle.close();
+  pool.push(handle);
+}
+
+function zlibError(message, errno) {
+  var error = new Error(message);
+  error.errno = errno;
+  error.code = codes[errno];
+  return error;
+}
+
+// The convenience methods don't need the stream machinery. They hand all of
+// the input to the binding at once, which processes it in a single thread
+// pool job into a single output buffer. Only opts.flush, which the stream
+// path applies to the input before the final flush, still needs a stream.
+function zlibBufferOneShot(mode, buffer, opts, callback) {
+  if (typeof buffer === 'string')
+    buffer = Buffer.from(buffer);
+
+  var error = null;
+  var handle = createOneShotHandle(mode, opts, onError);
+  if (error !== null) {
+    handle.close();
+    process.nextTick(callback, error);
+    return;
+  }
+
+  handle.buffer = buffer;
+  handle.oncomplete = onComplete;
+  handle.writeAll(finishFlushFlag(opts), buffer);
+
+  function onError(message, errno) {
+    error = zlibError(message, errno);
+    // Errors of init() are reported once it returned.
+    if (handle !== undefined) {
+      handle.buffer = null;
+      handle.close();
+      callback(error);
+    }
+  }
+
+  function onComplete(result) {
+    handle.buffer = null;
+    handle.oncomplete = null;
+    if (result === undefined) {
+      handle.close();
+      callback(new RangeError(kRangeErrorMessage));
+    } else {
+      releaseOneShotHandle(handle);
+      callback(null, result);
+    }
+  }
+}
+
+function zlibBufferOneShotSync(mode, buffer, opts) {
+  var error = null;
+  const handle = createOneShotHandle(mode, opts, (message, errno) => {
+    error = zlibError(message, errno);
+  });
+
+  var result;
+  try {
+    if (typeof buffer === 'string')
+      buffer = Buffer.from(buffer);
+    else if (!ArrayBuffer.isView(buffer))
+      throw new TypeError('"buffer" argument must be a string, Buffer, ' +
+                          'TypedArray, or DataView');
+    if (error === null)
+      result = handle.writeAllSync(finishFlushFlag(opts), buffer);
+  } finally {
+    if (error === null && result !== undefined)
+      releaseOneShotHandle(handle);
+    else
+      handle.close();
+  }
+
+  if (error !== null)
+    throw error;
+  if (result === undefined)
+    throw new RangeError(kRangeErrorMessage);
+  return result;
+}
+
 function zlibBuffer(engine, buffer, callback) {
   // Streams do not support non-Buffer ArrayBufferViews yet. Convert it to a
   // Buffer without copying.
@@ -125,28 +403,13 @@ function zlibBuffer(engine, buffer, callback) {
   }
 }
 
-function zlibBufferSync(engine, buffer) {
-  if (typeof buffer === 'string')
-    buffer = Buffer.from(buffer);
-  else if (!ArrayBuffer.isView(buffer))
-    throw new TypeError('"buffer" argument must be a string, Buffer, ' +
-                        'TypedArray, or DataView');
-
-  var flushFlag = engine._finishFlushFlag;
-
-  return engine._processChunk(buffer, flushFlag);
-}
-
 function zlibOnError(message, errno) {
   // there is no way to cleanly recover.
   // continuing only obscures problems.
   _close(this);
   this._hadError = true;
 
-  var error = new Error(message);
-  error.errno = errno;
-  error.code = codes[errno];
-  this.emit('error', error);
+  this.emit('error', zlibError(message, errno));
 }
 
 function flushCallback(level, strategy, callback) {
@@ -171,57 +434,10 @@ class Zlib extends Transform {
     this._opts = opts;
     this._chunkSize = opts.chunkSize || constants.Z_DEFAULT_CHUNK;
 
-    if (opts.flush && isInvalidFlushFlag(opts.flush)) {
-      throw new RangeError('Invalid flush flag: ' + opts.flush);
-    }
-    if (opts.finishFlush && isInvalidFlushFlag(opts.finishFlush)) {
-      throw new RangeError('Invalid flush flag: ' + opts.finishFlush);
-    }
+    checkOptions(opts, mode);
 
     this._flushFlag = opts.flush || constants.Z_NO_FLUSH;
-    this._finishFlushFlag = opts.finishFlush !== undefined ?
-      opts.finishFlush : constants.Z_FINISH;
-
-    if (opts.chunkSize) {
-      if (opts.chunkSize < constants.Z_MIN_CHUNK) {
-        throw new RangeError('Invalid chunk size: ' + opts.chunkSize);
-      }
-    }
-
-    if (opts.windowBits) {
-      if (opts.windowBits < constants.Z_MIN_WINDOWBITS ||
-          opts.windowBits > constants.Z_MAX_WINDOWBITS) {
-        throw new RangeError('Invalid windowBits: ' + opts.windowBits);
-      }
-    }
-
-    if (opts.level) {
-      if (opts.level < constants.Z_MIN_LEVEL ||
-          opts.level > constants.Z_MAX_LEVEL) {
-        throw new RangeError('Invalid compression level: ' + opts.level);
-      }
-    }
-
-    if (opts.memLevel) {
-      if (opts.memLevel < constants.Z_MIN_MEMLEVEL ||
-          opts.memLevel > constants.Z_MAX_MEMLEVEL) {
-        throw new RangeError('Invalid memLevel: ' + opts.memLevel);
-      }
-    }
-
-    if (opts.strategy && isInvalidStrategy(opts.strategy))
-      throw new TypeError('Invalid strategy: ' + opts.strategy);
-
-    if (opts.dictionary) {
-      if (!ArrayBuffer.isView(opts.dictionary)) {
-        throw new TypeError(
-          'Invalid dictionary: it should be a Buffer, TypedArray, or DataView');
-      }
-    }
-
-    this._handle = new binding.Zlib(mode);
-    this._handle.onerror = zlibOnError.bind(this);
-    this._hadError = false;
+    this._finishFlushFlag = finishFlushFlag(opts);
 
     var level = constants.Z_DEFAULT_COMPRESSION;
     if (typeof opts.level === 'number') level = opts.level;
@@ -229,11 +445,9 @@ class Zlib extends Transform {
     var strategy = constants.Z_DEFAULT_STRATEGY;
     if (typeof opts.strategy === 'number') strategy = opts.strategy;
 
-    this._handle.init(opts.windowBits || constants.Z_DEFAULT_WINDOWBITS,
-                      level,
-                      opts.memLevel || constants.Z_DEFAULT_MEMLEVEL,
-                      strategy,
-                      opts.dictionary);
+    this._hadError = false;
+    this._handle = createHandle(mode, opts, level, strategy,
+                                zlibOnError.bind(this));
 
     this._buffer = Buffer.allocUnsafe(this._chunkSize);
     this._offset = 0;
@@ -268,6 +482,16 @@ class Zlib extends Transform {
     return this._handle.reset();
   }
 
+  releaseMemory() {
+    assert(this._handle, 'zlib binding closed');
+    if (!this._handle.releaseMemory())
+      return false;
+    // The output buffer is made again by the next write.
+    this._buffer = null;
+    this._offset = 0;
+    return true;
+  }
+
   // This is the _flush function called by the transform class,
   // internally, when the last chunk has been written.
   _flush(callback) {
@@ -336,6 +560,9 @@ class Zlib extends Transform {
   }
 
   _processChunk(chunk, flushFlag, cb) {
+    if (this._buffer === null)
+      this._buffer = Buffer.allocUnsafe(this._chunkSize);
+
     var availInBefore = chunk && chunk.byteLength;
     var availOutBefore = this._chunkSize - this._offset;
     var inOff = 0;
@@ -519,10 +746,191 @@ class Unzip extends Zlib {
   }
 }
 
-function createConvenienceMethod(type, sync) {
+class BrotliCompress extends Zlib {
+  constructor(opts) {
+    super(opts, constants.BROTLI_ENCODE);
+  }
+}
+
+class BrotliDecompress extends Zlib {
+  constructor(opts) {
+    super(opts, constants.BROTLI_DECODE);
+  }
+}
+
+// Gzip that compresses blocks of the input on several threads at once, like
+// pigz. Every block is primed with the end of the block before it, so the
+// output is hardly larger than that of Gzip.
+const kParallelWindow = 32 * 1024;
+const kParallelBlockSize = 128 * 1024;
+
+class ParallelGzip extends Transform {
+  constructor(opts) {
+    opts = opts || {};
+    super(opts);
+
+    checkOptions(opts, constants.GZIP);
+    if (opts.blockSize !== undefined &&
+        !(opts.blockSize >= kParallelWindow)) {
+      throw new RangeError('Invalid block size: ' + opts.blockSize);
+    }
+    if (opts.concurrency !== undefined && !(opts.concurrency >= 1)) {
+      throw new RangeError('Invalid concurrency: ' + opts.concurrency);
+    }
+
+    this._level = typeof opts.level === 'number' ?
+      opts.level : constants.Z_DEFAULT_COMPRESSION;
+    this._memLevel = opts.memLevel || constants.Z_DEFAULT_MEMLEVEL;
+    this._strategy = typeof opts.strategy === 'number' ?
+      opts.strategy : constants.Z_DEFAULT_STRATEGY;
+    this._blockSize = opts.blockSize || kParallelBlockSize;
+    this._concurrency = opts.concurrency || os.cpus().length;
+
+    this._chunks = [];
+    this._chunksLength = 0;
+    this._previous = null;
+    this._blocks = [];  // In input order, until their output is pushed.
+    this._crc = 0;
+    this._length = 0;
+    this._headerPushed = false;
+    this._callback = null;
+    this._flushing = false;
+    this._hadError = false;
+  }
+
+  _transform(chunk, encoding, callback) {
+    if (!ArrayBuffer.isView(chunk))
+      return callback(new TypeError('invalid input'));
+
+    this._chunks.push(chunk);
+    this._chunksLength += chunk.byteLength;
+    if (this._chunksLength >= this._blockSize) {
+      // Copies the input, which has to stay the same until its block and the
+      // next one are done.
+      const data = Buffer.concat(this._chunks, this._chunksLength);
+      var offset = 0;
+      for (; data.length - offset >= this._blockSize;
+           offset += this._blockSize) {
+        this._startBlock(data.slice(offset, offset + this._blockSize), false);
+      }
+      this._chunks = offset < data.length ? [data.slice(offset)] : [];
+      this._chunksLength = data.length - offset;
+    }
+
+    // Takes more input while fewer blocks than `concurrency` are pending.
+    this._callback = callback;
+    this._continue();
+  }
+
+  _flush(callback) {
+    this._startBlock(Buffer.concat(this._chunks, this._chunksLength), true);
+    this._chunks = [];
+    this._chunksLength = 0;
+    this._callback = callback;
+    this._flushing = true;
+    this._continue();
+  }
+
+  _startBlock(input, last) {
+    const handle = new binding.ZlibBlock();
+    const block = { output: null, crc: 0, length: input.length };
+    const dictionary = this._previous !== null ?
+      this._previous.slice(-kParallelWindow) : null;
+
+    handle.buffer = input;
+    handle.dictionary = dictionary;
+    handle.oncomplete = (output, crc) => {
+      handle.buffer = null;
+      handle.dictionary = null;
+      block.output = output;
+      block.crc = crc;
+      this._pushBlocks();
+    };
+    handle.onerror = (message, errno) => {
+      handle.buffer = null;
+      handle.dictionary = null;
+      this._error(zlibError(message, errno));
+    };
+    handle.deflate(input, dictionary, this._level, this._memLevel,
+                   this._strategy, last);
+
+    this._blocks.push(block);
+    this._previous = input;
+  }
+
+  _pushBlocks() {
+    if (this._hadError)
+      return;
+
+    while (this._blocks.length > 0 && this._blocks[0].output !== null) {
+      const block = this._blocks.shift();
+      if (!this._headerPushed) {
+        this.push(gzipHeader(this._level, this._strategy));
+        this._headerPushed = true;
+      }
+      this.push(block.output);
+      this._crc = binding.crc32Combine(this._crc, block.crc, block.length);
+      this._length = (this._length + block.length) % 0x100000000;
+    }
+    this._continue();
+  }
+
+  _continue() {
+    const callback = this._callback;
+    if (callback === null)
+      return;
+    if (this._flushing ? this._blocks.length > 0 :
+                         this._blocks.length >= this._concurrency) {
+      return;
+    }
+
+    this._callback = null;
+    if (this._flushing) {
+      const trailer = Buffer.allocUnsafe(8);
+      trailer.writeUInt32LE(this._crc, 0);
+      trailer.writeUInt32LE(this._length, 4);
+      this.push(trailer);
+    }
+    callback();
+  }
+
+  _error(err) {
+    if (this._hadError)
+      return;
+    this._hadError = true;
+    this._blocks = [];
+
+    const callback = this._callback;
+    this._callback = null;
+    if (callback !== null)
+      callback(err);
+    else
+      this.emit('error', err);
+  }
+}
+
+// What zlib puts in the OS field of the gzip header.
+const kGzipOsCode = process.platform === 'win32' ? 10 :
+                    process.platform === 'darwin' ? 19 : 3;
+
+// The gzip header that deflate() writes without a gzip header of the user's.
+function gzipHeader(level, strategy) {
+  if (level === constants.Z_DEFAULT_COMPRESSION)
+    level = 6;
+  const header = Buffer.alloc(10);
+  header[0] = 0x1f;
+  header[1] = 0x8b;
+  header[2] = 8;  // Z_DEFLATED
+  header[8] = level === 9 ? 2 :
+    (strategy >= constants.Z_HUFFMAN_ONLY || level < 2 ? 4 : 0);
+  header[9] = kGzipOsCode;
+  return header;
+}
+
+function createConvenienceMethod(type, mode, sync) {
   if (sync) {
     return function(buffer, opts) {
-      return zlibBufferSync(new type(opts), buffer);
+      return zlibBufferOneShotSync(mode, buffer, opts || {});
     };
   } else {
     return function(buffer, opts, callback) {
@@ -530,6 +938,11 @@ function createConvenienceMethod(type, sync) {
         callback = opts;
         opts = {};
       }
+      opts = opts || {};
+      if (!opts.flush &&
+          (typeof buffer === 'string' || ArrayBuffer.isView(buffer))) {
+        return zlibBufferOneShot(mode, buffer, opts, callback);
+      }
       return zlibBuffer(new type(opts), buffer, callback);
     };
   }
@@ -551,23 +964,34 @@ module.exports = {
   DeflateRaw: createClassWrapper(DeflateRaw),
   InflateRaw: createClassWrapper(InflateRaw),
   Unzip: createClassWrapper(Unzip),
+  ParallelGzip: createClassWrapper(ParallelGzip),
 
   // Convenience methods.
   // compress/decompress a string or buffer in one step.
-  deflate: createConvenienceMethod(Deflate, false),
-  deflateSync: createConvenienceMethod(Deflate, true),
-  gzip: createConvenienceMethod(Gzip, false),
-  gzipSync: createConvenienceMethod(Gzip, true),
-  deflateRaw: createConvenienceMethod(DeflateRaw, false),
-  deflateRawSync: createConvenienceMethod(DeflateRaw, true),
-  unzip: createConvenienceMethod(Unzip, false),
-  unzipSync: createConvenienceMethod(Unzip, true),
-  inflate: createConvenienceMethod(Inflate, false),
-  inflateSync: createConvenienceMethod(Inflate, true),
-  gunzip: createConvenienceMethod(Gunzip, false),
-  gunzipSync: createConvenienceMethod(Gunzip, true),
-  inflateRaw: createConvenienceMethod(InflateRaw, false),
-  inflateRawSync: createConvenienceMethod(InflateRaw, true)
+  deflate: createConvenienceMethod(Deflate, constants.DEFLATE, false),
+  deflateSync: createConvenienceMethod(Deflate, constants.DEFLATE, true),
+  gzip: createConvenienceMethod(Gzip, constants.GZIP, false),
+  gzipSync: createConvenienceMethod(Gzip, constants.GZIP, true),
+  deflateRaw: createConvenienceMethod(DeflateRaw, constants.DEFLATERAW, false),
+  deflateRawSync: createConvenienceMethod(DeflateRaw, constants.DEFLATERAW,
+                                          true),
+  unzip: createConvenienceMethod(Unzip, constants.UNZIP, false),
+  unzipSync: createConvenienceMethod(Unzip, constants.UNZIP, true),
+  inflate: createConvenienceMethod(Inflate, constants.INFLATE, false),
+  inflateSync: createConvenienceMethod(Inflate, constants.INFLATE, true),
+  gunzip: createConvenienceMethod(Gunzip, constants.GUNZIP, false),
+  gunzipSync: createConvenienceMethod(Gunzip, constants.GUNZIP, true),
+  inflateRaw: createConvenienceMethod(InflateRaw, constants.INFLATERAW, false),
+  inflateRawSync: createConvenienceMethod(InflateRaw, constants.INFLATERAW,
+                                          true),
+
+  // A preset dictionary that streams and convenience methods can share.
+  createDictionary: createDictionary,
+
+  // Checksums of a string or buffer, continuing from a previous value.
+  crc32: createChecksum(binding.crc32, 0),
+  crc32c: createChecksum(binding.crc32c, 0),
+  adler32: createChecksum(binding.adler32, 1)
 };
 
 Object.defineProperties(module.exports, {
@@ -578,6 +1002,7 @@ Object.defineProperties(module.exports, {
   createGzip: createProperty(module.exports.Gzip),
   createGunzip: createProperty(module.exports.Gunzip),
   createUnzip: createProperty(module.exports.Unzip),
+  createParallelGzip: createProperty(module.exports.ParallelGzip),
   constants: {
     configurable: false,
     enumerable: true,
@@ -590,6 +1015,23 @@ Object.defineProperties(module.exports, {
   }
 });
 
+if (hasBrotli) {
+  module.exports.BrotliCompress = createClassWrapper(BrotliCompress);
+  module.exports.BrotliDecompress = createClassWrapper(BrotliDecompress);
+  module.exports.brotliCompress =
+    createConvenienceMethod(BrotliCompress, constants.BROTLI_ENCODE, false);
+  module.exports.brotliCompressSync =
+    createConvenienceMethod(BrotliCompress, constants.BROTLI_ENCODE, true);
+  module.exports.brotliDecompress =
+    createConvenienceMethod(BrotliDecompress, constants.BROTLI_DECODE, false);
+  module.exports.brotliDecompressSync =
+    createConvenienceMethod(BrotliDecompress, constants.BROTLI_DECODE, true);
+  Object.defineProperties(module.exports, {
+    createBrotliCompress: createProperty(module.exports.BrotliCompress),
+    createBrotliDecompress: createProperty(module.exports.BrotliDecompress)
+  });
+}
+
 // These should be considered deprecated
 // expose all the zlib constants
 const bkeys = Object.keys(constants);
@@ -5,6 +5,8 @@
     'node_use_lttng%': 'false',
     'node_use_etw%': 'false',
     'node_use_perfctr%': 'false',
+    'node_code_cache_path%': '',
+    'node_use_code_cache%': 'false',
     'node_no_browser_globals%': 'false',
     'node_use_v8_platform%': 'true',
     'node_use_bundled_v8%': 'true',
@@ -12,6 +14,7 @@
     'force_dynamic_crt%': 0,
     'node_module_version%': '',
     'node_shared_zlib%': 'false',
+    'node_shared_brotli%': 'false',
     'node_shared_http_parser%': 'false',
     'node_shared_cares%': 'false',
     'node_shared_libuv%': 'false',
@@ -43,7 +46,10 @@
       'lib/_http_incoming.js',
       'lib/_http_outgoing.js',
       'lib/_http_server.js',
+      'lib/http2.js',
       'lib/https.js',
+      'lib/inspector.js',
+      'lib/json.js',
       'lib/module.js',
       'lib/net.js',
       'lib/os.js',
@@ -53,6 +59,7 @@
       'lib/querystring.js',
       'lib/readline.js',
       'lib/repl.js',
+      'lib/scheduler.js',
       'lib/stream.js',
       'lib/_stream_readable.js',
       'lib/_stream_writable.js',
@@ -64,6 +71,7 @@
       'lib/sys.js',
       'lib/timers.js',
       'lib/tls.js',
+      'lib/trace_events.js',
       'lib/_tls_common.js',
       'lib/_tls_legacy.js',
       'lib/_tls_wrap.js',
@@ -72,20 +80,28 @@
       'lib/util.js',
       'lib/v8.js',
       'lib/vm.js',
+      'lib/worker.js',
       'lib/zlib.js',
+      'lib/internal/app_archive.js',
       'lib/internal/buffer.js',
       'lib/internal/child_process.js',
+      'lib/internal/child_process/serialization.js',
       'lib/internal/cluster/child.js',
       'lib/internal/cluster/master.js',
       'lib/internal/cluster/round_robin_handle.js',
       'lib/internal/cluster/shared_handle.js',
       'lib/internal/cluster/utils.js',
       'lib/internal/cluster/worker.js',
+      'lib/internal/compile_cache.js',
+      'lib/internal/counters.js',
+      'lib/internal/cpu_profile.js',
       'lib/internal/errors.js',
       'lib/internal/freelist.js',
       'lib/internal/fs.js',
+      'lib/internal/histogram.js',
       'lib/internal/http.js',
       'lib/internal/linkedlist.js',
+      'lib/internal/priority_queue.js',
       'lib/internal/net.js',
       'lib/internal/module.js',
       'lib/internal/process/next_tick.js',
@@ -97,12 +113,15 @@
       'lib/internal/process/write-coverage.js',
       'lib/internal/readline.js',
       'lib/internal/repl.js',
+      'lib/internal/resolution_cache.js',
       'lib/internal/socket_list.js',
       'lib/internal/test/unicode.js',
       'lib/internal/url.js',
       'lib/internal/util.js',
       'lib/internal/v8_prof_polyfill.js',
       'lib/internal/v8_prof_processor.js',
+      'lib/internal/v8_streams.js',
+      'lib/internal/worker.js',
       'lib/internal/streams/lazy_transform.js',
       'lib/internal/streams/BufferList.js',
       'lib/internal/streams/legacy.js',
@@ -158,47 +177,78 @@
 
       'sources': [
         'src/async-wrap.cc',
+        'src/base64.cc',
+        'src/buffer_arena.cc',
         'src/cares_wrap.cc',
         'src/connection_wrap.cc',
         'src/connect_wrap.cc',
+        'src/cpu_profile_writer.cc',
         'src/debug-agent.cc',
         'src/env.cc',
         'src/fs_event_wrap.cc',
+        'src/gc_metrics.cc',
         'src/handle_wrap.cc',
+        'src/histogram.cc',
+        'src/inotify_watcher.cc',
         'src/js_stream.cc',
+        'src/loop_metrics.cc',
         'src/node.cc',
         'src/node_api.cc',
         'src/node_api.h',
         'src/node_api_types.h',
+        'src/node_app_archive.cc',
         'src/node_buffer.cc',
+        'src/node_code_cache.cc',
         'src/node_config.cc',
         'src/node_constants.cc',
         'src/node_contextify.cc',
+        'src/node_counter_registry.cc',
+        'src/node_cpu.cc',
         'src/node_debug_options.cc',
         'src/node_file.cc',
+        'src/node_histogram.cc',
         'src/node_http_parser.cc',
+        'src/node_http2.cc',
+        'src/node_http2_core.cc',
+        'src/node_http2_hpack.cc',
+        'src/node_json.cc',
+        'src/node_json_parser.cc',
+        'src/node_log_sink.cc',
         'src/node_main.cc',
+        'src/node_messaging.cc',
         'src/node_os.cc',
+        'src/node_path.cc',
+        'src/node_platform.cc',
         'src/node_revert.cc',
         'src/node_serdes.cc',
         'src/node_url.cc',
         'src/node_util.cc',
         'src/node_v8.cc',
+        'src/node_vfork.cc',
         'src/node_stat_watcher.cc',
+        'src/node_threadpool.cc',
+        'src/node_trace_events.cc',
         'src/node_watchdog.cc',
+        'src/node_worker.cc',
         'src/node_zlib.cc',
         'src/node_i18n.cc',
         'src/pipe_wrap.cc',
         'src/process_wrap.cc',
+        'src/req_freelist.cc',
         'src/signal_wrap.cc',
         'src/spawn_sync.cc',
+        'src/slab_allocator.cc',
+        'src/stdio_writer.cc',
         'src/string_bytes.cc',
         'src/string_search.cc',
         'src/stream_base.cc',
+        'src/stream_pipe.cc',
+        'src/string_decoder.cc',
         'src/stream_wrap.cc',
         'src/tcp_wrap.cc',
         'src/timer_wrap.cc',
         'src/tracing/agent.cc',
+        'src/tracing/binary_trace_writer.cc',
         'src/tracing/node_trace_buffer.cc',
         'src/tracing/node_trace_writer.cc',
         'src/tracing/trace_event.cc',
@@ -211,23 +261,42 @@
         'src/async-wrap-inl.h',
         'src/base-object.h',
         'src/base-object-inl.h',
+        'src/buffer_arena.h',
         'src/connection_wrap.h',
         'src/connect_wrap.h',
+        'src/cpu_profile_writer.h',
         'src/debug-agent.h',
         'src/env.h',
         'src/env-inl.h',
+        'src/gc_metrics.h',
         'src/handle_wrap.h',
+        'src/histogram.h',
+        'src/inotify_watcher.h',
         'src/js_stream.h',
+        'src/loop_metrics.h',
         'src/node.h',
         'src/node_buffer.h',
+        'src/node_code_cache.h',
         'src/node_constants.h',
+        'src/node_counter_registry.h',
+        'src/node_cpu.h',
         'src/node_debug_options.h',
+        'src/node_histogram.h',
+        'src/node_http2_core.h',
+        'src/node_http2_hpack.h',
         'src/node_internals.h',
+        'src/node_json_parser.h',
         'src/node_javascript.h',
+        'src/node_messaging.h',
         'src/node_mutex.h',
+        'src/node_platform.h',
+        'src/node_probes.h',
         'src/node_root_certs.h',
+        'src/node_threadpool.h',
         'src/node_version.h',
+        'src/node_vfork.h',
         'src/node_watchdog.h',
+        'src/node_worker.h',
         'src/node_wrap.h',
         'src/node_revert.h',
         'src/node_i18n.h',
@@ -237,11 +306,16 @@
         'src/udp_wrap.h',
         'src/req-wrap.h',
         'src/req-wrap-inl.h',
+        'src/req_freelist.h',
+        'src/slab_allocator.h',
         'src/string_bytes.h',
         'src/stream_base.h',
         'src/stream_base-inl.h',
+        'src/stream_pipe.h',
+        'src/string_decoder.h',
         'src/stream_wrap.h',
         'src/tracing/agent.h',
+        'src/tracing/binary_trace_writer.h',
         'src/tracing/node_trace_buffer.h',
         'src/tracing/node_trace_writer.h',
         'src/tracing/trace_event.h'
@@ -420,8 +494,91 @@
             '<@(_inputs)',
           ],
         },
+        {
+          # The same sources for mkcodecache.
+          'action_name': 'node_js2c_sources',
+          'inputs': [
+            '<@(library_files)',
+            './config.gypi',
+          ],
+          'outputs': [
+            '<(SHARED_INTERMEDIATE_DIR)/node_javascript_sources.h',
+          ],
+          'conditions': [
+            [ 'node_use_dtrace=="false" and node_use_etw=="false"', {
+              'inputs': [ 'src/notrace_macros.py' ]
+            }],
+            ['node_use_lttng=="false"', {
+              'inputs': [ 'src/nolttng_macros.py' ]
+            }],
+            [ 'node_use_perfctr=="false"', {
+              'inputs': [ 'src/perfctr_macros.py' ]
+            }]
+          ],
+          'action': [
+            'python',
+            'tools/js2c.py',
+            '--sources',
+            '<@(_outputs)',
+            '<@(_inputs)',
+          ],
+        },
       ],
     }, # end node_js2c
+    {
+      # Compiles the core modules to produce their code cache, see
+      # src/node_code_cache.h.
+      'target_name': 'mkcodecache',
+      'type': 'executable',
+
+      'dependencies': [
+        'node_js2c#host',
+        'deps/v8/src/v8.gyp:v8',
+        'deps/v8/src/v8.gyp:v8_libplatform',
+      ],
+
+      'include_dirs': [
+        'deps/v8/include',
+        '<(SHARED_INTERMEDIATE_DIR)',  # node_javascript_sources.h
+      ],
+
+      'sources': [
+        'tools/code_cache/mkcodecache.cc',
+      ],
+
+      'conditions': [
+        [ 'v8_enable_i18n_support==1', {
+          'defines': [ 'NODE_HAVE_I18N_SUPPORT=1' ],
+          'dependencies': [
+            '<(icu_gyp_path):icui18n',
+            '<(icu_gyp_path):icuuc',
+          ],
+        }],
+        [ 'node_v8_options!=""', {
+          'defines': [ 'NODE_V8_OPTIONS="<(node_v8_options)"' ],
+        }],
+      ],
+    },
+    {
+      'target_name': 'node_code_cache',
+      'type': 'none',
+      'dependencies': [ 'mkcodecache' ],
+      'actions': [
+        {
+          'action_name': 'node_code_cache',
+          'inputs': [
+            '<(PRODUCT_DIR)/<(EXECUTABLE_PREFIX)mkcodecache<(EXECUTABLE_SUFFIX)',
+          ],
+          'outputs': [
+            '<(SHARED_INTERMEDIATE_DIR)/node_code_cache.cc',
+          ],
+          'action': [
+            '<(PRODUCT_DIR)/<(EXECUTABLE_PREFIX)mkcodecache<(EXECUTABLE_SUFFIX)',
+            '<@(_outputs)',
+          ],
+        },
+      ],
+    }, # end node_code_cache
     {
       'target_name': 'node_dtrace_header',
       'type': 'none',
@@ -563,68 +720,12 @@
       'target_name': 'cctest',
       'type': 'executable',
 
-      'dependencies': [
-        '<(node_core_target_name)',
-        'deps/gtest/gtest.gyp:gtest',
-        'node_js2c#host',
-        'node_dtrace_header',
-        'node_dtrace_ustack',
-        'node_dtrace_provider',
-      ],
-
-      'variables': {
-        'OBJ_PATH': '<(OBJ_DIR)/node/src',
-        'OBJ_GEN_PATH': '<(OBJ_DIR)/node/gen',
-        'OBJ_TRACING_PATH': '<(OBJ_DIR)/node/src/tracing',
-        'OBJ_SUFFIX': 'o',
-        'conditions': [
-          ['OS=="win"', {
-            'OBJ_PATH': '<(OBJ_DIR)/node',
-            'OBJ_GEN_PATH': '<(OBJ_DIR)/node',
-            'OBJ_TRACING_PATH': '<(OBJ_DIR)/node',
-            'OBJ_SUFFIX': 'obj',
-          }],
-          ['OS=="aix"', {
-            'OBJ_PATH': '<(OBJ_DIR)/node_base/src',
-            'OBJ_GEN_PATH': '<(OBJ_DIR)/node_base/gen',
-            'OBJ_TRACING_PATH': '<(OBJ_DIR)/node_base/src/tracing',
-          }],
-         ],
-       },
-
       'includes': [
-        'node.gypi'
-      ],
-
-      'include_dirs': [
-        'src',
-        'tools/msvs/genfiles',
-        'deps/v8/include',
-        'deps/cares/include',
-        'deps/uv/include',
-        '<(SHARED_INTERMEDIATE_DIR)', # for node_natives.h
+        'cctest.gypi'
       ],
 
-      'libraries': [
-        '<(OBJ_GEN_PATH)/node_javascript.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/node_debug_options.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/async-wrap.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/env.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/node.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/node_buffer.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/node_i18n.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/node_url.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/debug-agent.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/util.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/string_bytes.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/string_search.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/stream_base.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/node_constants.<(OBJ_SUFFIX)',
-        '<(OBJ_PATH)/node_revert.<(OBJ_SUFFIX)',
-        '<(OBJ_TRACING_PATH)/agent.<(OBJ_SUFFIX)',
-        '<(OBJ_TRACING_PATH)/node_trace_buffer.<(OBJ_SUFFIX)',
-        '<(OBJ_TRACING_PATH)/node_trace_writer.<(OBJ_SUFFIX)',
-        '<(OBJ_TRACING_PATH)/trace_event.<(OBJ_SUFFIX)',
+      'dependencies': [
+        'deps/gtest/gtest.gyp:gtest',
       ],
 
       'defines': [
@@ -635,20 +736,19 @@
         'GTEST_DONT_DEFINE_ASSERT_LE=1',
         'GTEST_DONT_DEFINE_ASSERT_LT=1',
         'GTEST_DONT_DEFINE_ASSERT_NE=1',
-        'NODE_WANT_INTERNALS=1',
       ],
 
       'sources': [
         'test/cctest/test_base64.cc',
+        'test/cctest/test_buffer_arena.cc',
         'test/cctest/test_environment.cc',
+        'test/cctest/test_http2.cc',
+        'test/cctest/test_json_parser.cc',
+        'test/cctest/test_req_freelist.cc',
         'test/cctest/test_util.cc',
         'test/cctest/test_url.cc'
       ],
 
-      'sources!': [
-        'src/node_main.cc'
-      ],
-
       'conditions': [
         ['v8_enable_inspector==1', {
           'sources': [
@@ -678,24 +778,46 @@
             }]
           ]
         }],
-        [ 'node_use_v8_platform=="true"', {
+      ]
+    },
+    {
+      # Benchmarks of C++ primitives, see test/cctest/node_bench.h.
+      'target_name': 'cbench',
+      'type': 'executable',
+
+      'includes': [
+        'cctest.gypi'
+      ],
+
+      'sources': [
+        'test/cctest/node_bench.cc',
+        'test/cctest/bench_base64.cc',
+        'test/cctest/bench_string_bytes.cc',
+        'test/cctest/bench_string_search.cc',
+        'test/cctest/bench_url.cc',
+      ],
+    },
+    {
+      # Load generator for the http benchmarks, see
+      # benchmark/_http-benchmarkers.js.
+      'target_name': 'http_loadgen',
+      'type': 'executable',
+
+      'sources': [
+        'tools/http_loadgen/http_loadgen.cc',
+      ],
+
+      'conditions': [
+        [ 'node_shared_http_parser=="false"', {
           'dependencies': [
-            'deps/v8/src/v8.gyp:v8_libplatform',
-          ],
-        }],
-        [ 'node_use_dtrace=="true" and OS!="mac" and OS!="linux"', {
-          'copies': [{
-            'destination': '<(OBJ_DIR)/cctest/src',
-            'files': [
-              '<(OBJ_PATH)/node_dtrace_ustack.<(OBJ_SUFFIX)',
-              '<(OBJ_PATH)/node_dtrace_provider.<(OBJ_SUFFIX)',
-              '<(OBJ_PATH)/node_dtrace.<(OBJ_SUFFIX)',
-            ]},
-          ],
-        }],
-        ['OS=="solaris"', {
-          'ldflags': [ '-I<(SHARED_INTERMEDIATE_DIR)' ]
+            'deps/http_parser/http_parser.gyp:http_parser'
+          ]
         }],
+        [ 'node_shared_libuv=="false"', {
+          'dependencies': [
+            'deps/uv/uv.gyp:libuv'
+          ]
+        }]
       ]
     }
   ], # end targets
@@ -0,0 +1,2764 @@
+// Copyright 2011 Google Inc. All Rights Reserved.
+
+// This file was generated from .js source files by GYP.  If you
+// want to make changes to this file you should either change the
+// javascript source files or the GYP script.
+
+#include "src/v8.h"
+#include "src/snapshot/natives.h"
+#include "src/utils.h"
+
+namespace v8 {
+namespace internal {
+
+  static const char sources[] = { 10, 40, 102, 117, 110, 99, 116, 105, 111, 110, 40, 97, 44, 98, 41, 123, 10, 34,
+117, 115, 101, 32, 115, 116, 114, 105, 99, 116, 34, 59, 10, 37, 67, 104, 101,
+99, 107, 73, 115, 66, 111, 111, 116, 115, 116, 114, 97, 112, 112, 105, 110, 103,
+40, 41, 59, 10, 118, 97, 114, 32, 99, 61, 97, 46, 79, 98, 106, 101, 99, 116, 59,
+10, 118, 97, 114, 32, 100, 59, 10, 118, 97, 114, 32, 101, 61, 98, 46, 73, 109,
+112, 111, 114, 116, 78, 111, 119, 40, 34, 116, 111, 95, 115, 116, 114, 105, 110,
+103, 95, 116, 97, 103, 95, 115, 121, 109, 98, 111, 108, 34, 41, 59, 10, 98, 46,
+73, 109, 112, 111, 114, 116, 40, 102, 117, 110, 99, 116, 105, 111, 110, 40, 102,
+41, 123, 10, 100, 61, 102, 46, 77, 97, 120, 83, 105, 109, 112, 108, 101, 59, 10,
+125, 41, 59, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 67, 104, 101, 99,
+107, 83, 104, 97, 114, 101, 100, 73, 110, 116, 101, 103, 101, 114, 84, 121, 112,
+101, 100, 65, 114, 114, 97, 121, 40, 103, 41, 123, 10, 105, 102, 40, 33, 37, 73,
+115, 83, 104, 97, 114, 101, 100, 73, 110, 116, 101, 103, 101, 114, 84, 121, 112,
+101, 100, 65, 114, 114, 97, 121, 40, 103, 41, 41, 123, 10, 116, 104, 114, 111,
+119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111,
+114, 40, 55, 53, 44, 103, 41, 59, 10, 125, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 67, 104, 101, 99, 107, 83, 104, 97, 114, 101, 100, 73, 110,
+116, 101, 103, 101, 114, 51, 50, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121,
+40, 103, 41, 123, 10, 67, 104, 101, 99, 107, 83, 104, 97, 114, 101, 100, 73,
+110, 116, 101, 103, 101, 114, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 40,
+103, 41, 59, 10, 105, 102, 40, 33, 37, 73, 115, 83, 104, 97, 114, 101, 100, 73,
+110, 116, 101, 103, 101, 114, 51, 50, 84, 121, 112, 101, 100, 65, 114, 114, 97,
+121, 40, 103, 41, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107,
+101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 55, 54, 44, 103,
+41, 59, 10, 125, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 86, 97,
+108, 105, 100, 97, 116, 101, 73, 110, 100, 101, 120, 40, 104, 44, 105, 41, 123,
+10, 118, 97, 114, 32, 106, 61, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114,
+40, 104, 41, 41, 59, 10, 118, 97, 114, 32, 107, 61, 40, 37, 95, 84, 111, 73,
+110, 116, 101, 103, 101, 114, 40, 106, 41, 41, 59, 10, 105, 102, 40, 106, 33,
+61, 61, 107, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101,
+95, 114, 97, 110, 103, 101, 95, 101, 114, 114, 111, 114, 40, 49, 53, 53, 41, 59,
+10, 125, 10, 105, 102, 40, 107, 60, 48, 124, 124, 107, 62, 61, 105, 41, 123, 10,
+116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 114, 97, 110, 103, 101,
+95, 101, 114, 114, 111, 114, 40, 49, 53, 53, 41, 59, 10, 125, 10, 114, 101, 116,
+117, 114, 110, 32, 107, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 65, 116, 111, 109, 105, 99, 115, 67, 111, 109, 112, 97, 114, 101, 69, 120,
+99, 104, 97, 110, 103, 101, 74, 83, 40, 108, 44, 104, 44, 109, 44, 110, 41, 123,
+10, 67, 104, 101, 99, 107, 83, 104, 97, 114, 101, 100, 73, 110, 116, 101, 103,
+101, 114, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 40, 108, 41, 59, 10,
+104, 61, 86, 97, 108, 105, 100, 97, 116, 101, 73, 110, 100, 101, 120, 40, 104,
+44, 37, 95, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 71, 101, 116, 76,
+101, 110, 103, 116, 104, 40, 108, 41, 41, 59, 10, 109, 61, 40, 37, 95, 84, 111,
+78, 117, 109, 98, 101, 114, 40, 109, 41, 41, 59, 10, 110, 61, 40, 37, 95, 84,
+111, 78, 117, 109, 98, 101, 114, 40, 110, 41, 41, 59, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 95, 65, 116, 111, 109, 105, 99, 115, 67, 111, 109, 112, 97,
+114, 101, 69, 120, 99, 104, 97, 110, 103, 101, 40, 108, 44, 104, 44, 109, 44,
+110, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 65, 116,
+111, 109, 105, 99, 115, 65, 100, 100, 74, 83, 40, 103, 44, 104, 44, 111, 41,
+123, 10, 67, 104, 101, 99, 107, 83, 104, 97, 114, 101, 100, 73, 110, 116, 101,
+103, 101, 114, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 40, 103, 41, 59,
+10, 104, 61, 86, 97, 108, 105, 100, 97, 116, 101, 73, 110, 100, 101, 120, 40,
+104, 44, 37, 95, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 71, 101, 116,
+76, 101, 110, 103, 116, 104, 40, 103, 41, 41, 59, 10, 111, 61, 40, 37, 95, 84,
+111, 78, 117, 109, 98, 101, 114, 40, 111, 41, 41, 59, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 95, 65, 116, 111, 109, 105, 99, 115, 65, 100, 100, 40, 103,
+44, 104, 44, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 65, 116, 111, 109, 105, 99, 115, 83, 117, 98, 74, 83, 40, 103, 44, 104, 44,
+111, 41, 123, 10, 67, 104, 101, 99, 107, 83, 104, 97, 114, 101, 100, 73, 110,
+116, 101, 103, 101, 114, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 40, 103,
+41, 59, 10, 104, 61, 86, 97, 108, 105, 100, 97, 116, 101, 73, 110, 100, 101,
+120, 40, 104, 44, 37, 95, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 71,
+101, 116, 76, 101, 110, 103, 116, 104, 40, 103, 41, 41, 59, 10, 111, 61, 40, 37,
+95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 111, 41, 41, 59, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 95, 65, 116, 111, 109, 105, 99, 115, 83, 117, 98, 40,
+103, 44, 104, 44, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 65, 116, 111, 109, 105, 99, 115, 65, 110, 100, 74, 83, 40, 103, 44,
+104, 44, 111, 41, 123, 10, 67, 104, 101, 99, 107, 83, 104, 97, 114, 101, 100,
+73, 110, 116, 101, 103, 101, 114, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121,
+40, 103, 41, 59, 10, 104, 61, 86, 97, 108, 105, 100, 97, 116, 101, 73, 110, 100,
+101, 120, 40, 104, 44, 37, 95, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121,
+71, 101, 116, 76, 101, 110, 103, 116, 104, 40, 103, 41, 41, 59, 10, 111, 61, 40,
+37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 111, 41, 41, 59, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 95, 65, 116, 111, 109, 105, 99, 115, 65, 110, 100,
+40, 103, 44, 104, 44, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 65, 116, 111, 109, 105, 99, 115, 79, 114, 74, 83, 40, 103, 44,
+104, 44, 111, 41, 123, 10, 67, 104, 101, 99, 107, 83, 104, 97, 114, 101, 100,
+73, 110, 116, 101, 103, 101, 114, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121,
+40, 103, 41, 59, 10, 104, 61, 86, 97, 108, 105, 100, 97, 116, 101, 73, 110, 100,
+101, 120, 40, 104, 44, 37, 95, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121,
+71, 101, 116, 76, 101, 110, 103, 116, 104, 40, 103, 41, 41, 59, 10, 111, 61, 40,
+37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 111, 41, 41, 59, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 95, 65, 116, 111, 109, 105, 99, 115, 79, 114, 40,
+103, 44, 104, 44, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 65, 116, 111, 109, 105, 99, 115, 88, 111, 114, 74, 83, 40, 103, 44,
+104, 44, 111, 41, 123, 10, 67, 104, 101, 99, 107, 83, 104, 97, 114, 101, 100,
+73, 110, 116, 101, 103, 101, 114, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121,
+40, 103, 41, 59, 10, 104, 61, 86, 97, 108, 105, 100, 97, 116, 101, 73, 110, 100,
+101, 120, 40, 104, 44, 37, 95, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121,
+71, 101, 116, 76, 101, 110, 103, 116, 104, 40, 103, 41, 41, 59, 10, 111, 61, 40,
+37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 111, 41, 41, 59, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 95, 65, 116, 111, 109, 105, 99, 115, 88, 111, 114,
+40, 103, 44, 104, 44, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 65, 116, 111, 109, 105, 99, 115, 69, 120, 99, 104, 97, 110, 103,
+101, 74, 83, 40, 103, 44, 104, 44, 111, 41, 123, 10, 67, 104, 101, 99, 107, 83,
+104, 97, 114, 101, 100, 73, 110, 116, 101, 103, 101, 114, 84, 121, 112, 101,
+100, 65, 114, 114, 97, 121, 40, 103, 41, 59, 10, 104, 61, 86, 97, 108, 105, 100,
+97, 116, 101, 73, 110, 100, 101, 120, 40, 104, 44, 37, 95, 84, 121, 112, 101,
+100, 65, 114, 114, 97, 121, 71, 101, 116, 76, 101, 110, 103, 116, 104, 40, 103,
+41, 41, 59, 10, 111, 61, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40,
+111, 41, 41, 59, 10, 114, 101, 116, 117, 114, 110, 32, 37, 95, 65, 116, 111,
+109, 105, 99, 115, 69, 120, 99, 104, 97, 110, 103, 101, 40, 103, 44, 104, 44,
+111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 65, 116,
+111, 109, 105, 99, 115, 73, 115, 76, 111, 99, 107, 70, 114, 101, 101, 74, 83,
+40, 112, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 95, 65, 116, 111,
+109, 105, 99, 115, 73, 115, 76, 111, 99, 107, 70, 114, 101, 101, 40, 112, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 65, 116, 111, 109,
+105, 99, 115, 87, 97, 105, 116, 74, 83, 40, 103, 44, 104, 44, 111, 44, 113, 41,
+123, 10, 67, 104, 101, 99, 107, 83, 104, 97, 114, 101, 100, 73, 110, 116, 101,
+103, 101, 114, 51, 50, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 40, 103,
+41, 59, 10, 104, 61, 86, 97, 108, 105, 100, 97, 116, 101, 73, 110, 100, 101,
+120, 40, 104, 44, 37, 95, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 71,
+101, 116, 76, 101, 110, 103, 116, 104, 40, 103, 41, 41, 59, 10, 105, 102, 40,
+40, 113, 61, 61, 61, 40, 118, 111, 105, 100, 32, 48, 41, 41, 41, 123, 10, 113,
+61, 40, 49, 47, 48, 41, 59, 10, 125, 101, 108, 115, 101, 123, 10, 113, 61, 40,
+37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 113, 41, 41, 59, 10, 105, 102,
+40, 40, 33, 37, 95, 73, 115, 83, 109, 105, 40, 37, 73, 83, 95, 86, 65, 82, 40,
+113, 41, 41, 38, 38, 33, 40, 113, 61, 61, 113, 41, 41, 41, 123, 10, 113, 61, 40,
+49, 47, 48, 41, 59, 10, 125, 101, 108, 115, 101, 123, 10, 113, 61, 100, 40, 48,
+44, 113, 41, 59, 10, 125, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 37, 65,
+116, 111, 109, 105, 99, 115, 87, 97, 105, 116, 40, 103, 44, 104, 44, 111, 44,
+113, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 65, 116,
+111, 109, 105, 99, 115, 87, 97, 107, 101, 74, 83, 40, 103, 44, 104, 44, 114, 41,
+123, 10, 67, 104, 101, 99, 107, 83, 104, 97, 114, 101, 100, 73, 110, 116, 101,
+103, 101, 114, 51, 50, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 40, 103,
+41, 59, 10, 104, 61, 86, 97, 108, 105, 100, 97, 116, 101, 73, 110, 100, 101,
+120, 40, 104, 44, 37, 95, 84, 121, 112, 101, 100, 65, 114, 114, 97, 121, 71,
+101, 116, 76, 101, 110, 103, 116, 104, 40, 103, 41, 41, 59, 10, 114, 61, 100,
+40, 48, 44, 40, 37, 95, 84, 111, 73, 110, 116, 101, 103, 101, 114, 40, 114, 41,
+41, 41, 59, 10, 114, 101, 116, 117, 114, 110, 32, 37, 65, 116, 111, 109, 105,
+99, 115, 87, 97, 107, 101, 40, 103, 44, 104, 44, 114, 41, 59, 10, 125, 10, 118,
+97, 114, 32, 115, 61, 97, 46, 65, 116, 111, 109, 105, 99, 115, 59, 10, 37, 65,
+100, 100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40, 115,
+44, 101, 44, 34, 65, 116, 111, 109, 105, 99, 115, 34, 44, 49, 124, 50, 41, 59,
+10, 98, 46, 73, 110, 115, 116, 97, 108, 108, 70, 117, 110, 99, 116, 105, 111,
+110, 115, 40, 115, 44, 50, 44, 91, 10, 34, 99, 111, 109, 112, 97, 114, 101, 69,
+120, 99, 104, 97, 110, 103, 101, 34, 44, 65, 116, 111, 109, 105, 99, 115, 67,
+111, 109, 112, 97, 114, 101, 69, 120, 99, 104, 97, 110, 103, 101, 74, 83, 44,
+10, 34, 97, 100, 100, 34, 44, 65, 116, 111, 109, 105, 99, 115, 65, 100, 100, 74,
+83, 44, 10, 34, 115, 117, 98, 34, 44, 65, 116, 111, 109, 105, 99, 115, 83, 117,
+98, 74, 83, 44, 10, 34, 97, 110, 100, 34, 44, 65, 116, 111, 109, 105, 99, 115,
+65, 110, 100, 74, 83, 44, 10, 34, 111, 114, 34, 44, 65, 116, 111, 109, 105, 99,
+115, 79, 114, 74, 83, 44, 10, 34, 120, 111, 114, 34, 44, 65, 116, 111, 109, 105,
+99, 115, 88, 111, 114, 74, 83, 44, 10, 34, 101, 120, 99, 104, 97, 110, 103, 101,
+34, 44, 65, 116, 111, 109, 105, 99, 115, 69, 120, 99, 104, 97, 110, 103, 101,
+74, 83, 44, 10, 34, 105, 115, 76, 111, 99, 107, 70, 114, 101, 101, 34, 44, 65,
+116, 111, 109, 105, 99, 115, 73, 115, 76, 111, 99, 107, 70, 114, 101, 101, 74,
+83, 44, 10, 34, 119, 97, 105, 116, 34, 44, 65, 116, 111, 109, 105, 99, 115, 87,
+97, 105, 116, 74, 83, 44, 10, 34, 119, 97, 107, 101, 34, 44, 65, 116, 111, 109,
+105, 99, 115, 87, 97, 107, 101, 74, 83, 44, 10, 93, 41, 59, 10, 125, 41, 10, 10,
+10, 40, 102, 117, 110, 99, 116, 105, 111, 110, 40, 97, 44, 98, 41, 123, 10, 34,
+117, 115, 101, 32, 115, 116, 114, 105, 99, 116, 34, 59, 10, 37, 67, 104, 101,
+99, 107, 73, 115, 66, 111, 111, 116, 115, 116, 114, 97, 112, 112, 105, 110, 103,
+40, 41, 59, 10, 118, 97, 114, 32, 99, 61, 97, 46, 83, 73, 77, 68, 59, 10, 118,
+97, 114, 32, 100, 61, 98, 46, 73, 109, 112, 111, 114, 116, 78, 111, 119, 40, 34,
+116, 111, 95, 115, 116, 114, 105, 110, 103, 95, 116, 97, 103, 95, 115, 121, 109,
+98, 111, 108, 34, 41, 59, 10, 118, 97, 114, 32, 101, 61, 99, 46, 70, 108, 111,
+97, 116, 51, 50, 120, 52, 59, 10, 10, 10, 118, 97, 114, 32, 102, 61, 99, 46, 73,
+110, 116, 51, 50, 120, 52, 59, 10, 10, 118, 97, 114, 32, 103, 61, 99, 46, 73,
+110, 116, 49, 54, 120, 56, 59, 10, 10, 118, 97, 114, 32, 104, 61, 99, 46, 73,
+110, 116, 56, 120, 49, 54, 59, 10, 10, 10, 118, 97, 114, 32, 105, 61, 99, 46,
+85, 105, 110, 116, 51, 50, 120, 52, 59, 10, 10, 118, 97, 114, 32, 106, 61, 99,
+46, 85, 105, 110, 116, 49, 54, 120, 56, 59, 10, 10, 118, 97, 114, 32, 107, 61,
+99, 46, 85, 105, 110, 116, 56, 120, 49, 54, 59, 10, 10, 10, 118, 97, 114, 32,
+108, 61, 99, 46, 66, 111, 111, 108, 51, 50, 120, 52, 59, 10, 10, 118, 97, 114,
+32, 109, 61, 99, 46, 66, 111, 111, 108, 49, 54, 120, 56, 59, 10, 10, 118, 97,
+114, 32, 110, 61, 99, 46, 66, 111, 111, 108, 56, 120, 49, 54, 59, 10, 10, 10,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 67, 104, 101, 99, 107, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 67, 104, 101, 99,
+107, 40, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+70, 108, 111, 97, 116, 51, 50, 120, 52, 84, 111, 83, 116, 114, 105, 110, 103,
+40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102,
+40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102,
+40, 112, 41, 33, 61, 61, 39, 102, 108, 111, 97, 116, 51, 50, 120, 52, 39, 41,
+123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112,
+101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46, 116, 111,
+83, 116, 114, 105, 110, 103, 34, 44, 116, 104, 105, 115, 41, 59, 10, 125, 10,
+118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68, 46, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 40, 34, 59, 10, 113, 43, 61, 37, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44, 48, 41,
+59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49, 59, 114, 60, 52, 59,
+114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43, 37, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112,
+44, 114, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43, 34, 41,
+34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111,
+97, 116, 51, 50, 120, 52, 84, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105,
+110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101,
+79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101,
+111, 102, 40, 112, 41, 33, 61, 61, 39, 102, 108, 111, 97, 116, 51, 50, 120, 52,
+39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116,
+121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101,
+46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 34, 44,
+116, 104, 105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73,
+77, 68, 46, 70, 108, 111, 97, 116, 51, 50, 120, 52, 40, 34, 59, 10, 113, 43, 61,
+37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76,
+97, 110, 101, 40, 112, 44, 48, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83,
+116, 114, 105, 110, 103, 40, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32,
+114, 61, 49, 59, 114, 60, 52, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44,
+32, 34, 43, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 69, 120, 116, 114, 97,
+99, 116, 76, 97, 110, 101, 40, 112, 44, 114, 41, 46, 116, 111, 76, 111, 99, 97,
+108, 101, 83, 116, 114, 105, 110, 103, 40, 41, 59, 10, 125, 10, 114, 101, 116,
+117, 114, 110, 32, 113, 43, 34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 86, 97, 108, 117,
+101, 79, 102, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117,
+101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112,
+101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 102, 108, 111, 97, 116, 51, 50, 120,
+52, 39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95,
+116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 70,
+108, 111, 97, 116, 51, 50, 120, 52, 46, 112, 114, 111, 116, 111, 116, 121, 112,
+101, 46, 118, 97, 108, 117, 101, 79, 102, 34, 44, 116, 104, 105, 115, 41, 59,
+10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 112, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 69,
+120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 40, 115, 44, 116, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120,
+52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 115, 44, 116, 41, 59,
+10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116,
+51, 50, 120, 52, 67, 104, 101, 99, 107, 74, 83, 40, 111, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 67, 104, 101, 99,
+107, 40, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+73, 110, 116, 51, 50, 120, 52, 84, 111, 83, 116, 114, 105, 110, 103, 40, 41,
+123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116,
+104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40, 112,
+41, 33, 61, 61, 39, 105, 110, 116, 51, 50, 120, 52, 39, 41, 123, 10, 116, 104,
+114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114,
+114, 111, 114, 40, 52, 52, 44, 10, 34, 73, 110, 116, 51, 50, 120, 52, 46, 112,
+114, 111, 116, 111, 116, 121, 112, 101, 46, 116, 111, 83, 116, 114, 105, 110,
+103, 34, 44, 116, 104, 105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61,
+34, 83, 73, 77, 68, 46, 73, 110, 116, 51, 50, 120, 52, 40, 34, 59, 10, 113, 43,
+61, 37, 73, 110, 116, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97,
+110, 101, 40, 112, 44, 48, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114,
+61, 49, 59, 114, 60, 52, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32,
+34, 43, 37, 73, 110, 116, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76,
+97, 110, 101, 40, 112, 44, 114, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114,
+110, 32, 113, 43, 34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 73, 110, 116, 51, 50, 120, 52, 84, 111, 76, 111, 99, 97, 108, 101, 83,
+116, 114, 105, 110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97,
+108, 117, 101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116,
+121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 105, 110, 116, 51, 50,
+120, 52, 39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101,
+95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 73,
+110, 116, 51, 50, 120, 52, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46,
+116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 34, 44, 116,
+104, 105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77,
+68, 46, 73, 110, 116, 51, 50, 120, 52, 40, 34, 59, 10, 113, 43, 61, 37, 73, 110,
+116, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112,
+44, 48, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110,
+103, 40, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49, 59, 114,
+60, 52, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43, 37, 73,
+110, 116, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40,
+112, 44, 114, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105,
+110, 103, 40, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43,
+34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 51, 50, 120, 52, 86, 97, 108, 117, 101, 79, 102, 40, 41, 123, 10, 118, 97,
+114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105, 115,
+41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61,
+39, 105, 110, 116, 51, 50, 120, 52, 39, 41, 123, 10, 116, 104, 114, 111, 119,
+32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114,
+40, 52, 52, 44, 10, 34, 73, 110, 116, 51, 50, 120, 52, 46, 112, 114, 111, 116,
+111, 116, 121, 112, 101, 46, 118, 97, 108, 117, 101, 79, 102, 34, 44, 116, 104,
+105, 115, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 112, 59, 10,
+125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120,
+52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 40, 115, 44, 116,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120,
+52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 115, 44, 116, 41, 59,
+10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49,
+54, 120, 56, 67, 104, 101, 99, 107, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 67, 104, 101, 99, 107, 40,
+111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 49, 54, 120, 56, 84, 111, 83, 116, 114, 105, 110, 103, 40, 41, 123, 10,
+118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104,
+105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41,
+33, 61, 61, 39, 105, 110, 116, 49, 54, 120, 56, 39, 41, 123, 10, 116, 104, 114,
+111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114,
+111, 114, 40, 52, 52, 44, 10, 34, 73, 110, 116, 49, 54, 120, 56, 46, 112, 114,
+111, 116, 111, 116, 121, 112, 101, 46, 116, 111, 83, 116, 114, 105, 110, 103,
+34, 44, 116, 104, 105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34,
+83, 73, 77, 68, 46, 73, 110, 116, 49, 54, 120, 56, 40, 34, 59, 10, 113, 43, 61,
+37, 73, 110, 116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 40, 112, 44, 48, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61,
+49, 59, 114, 60, 56, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34,
+43, 37, 73, 110, 116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97,
+110, 101, 40, 112, 44, 114, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110,
+32, 113, 43, 34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 73, 110, 116, 49, 54, 120, 56, 84, 111, 76, 111, 99, 97, 108, 101, 83, 116,
+114, 105, 110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108,
+117, 101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121,
+112, 101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 105, 110, 116, 49, 54, 120, 56,
+39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116,
+121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 73, 110,
+116, 49, 54, 120, 56, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46, 116,
+111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 34, 44, 116, 104,
+105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68,
+46, 73, 110, 116, 49, 54, 120, 56, 40, 34, 59, 10, 113, 43, 61, 37, 73, 110,
+116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112,
+44, 48, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110,
+103, 40, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49, 59, 114,
+60, 56, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43, 37, 73,
+110, 116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40,
+112, 44, 114, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105,
+110, 103, 40, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43,
+34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 49, 54, 120, 56, 86, 97, 108, 117, 101, 79, 102, 40, 41, 123, 10, 118, 97,
+114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105, 115,
+41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61,
+39, 105, 110, 116, 49, 54, 120, 56, 39, 41, 123, 10, 116, 104, 114, 111, 119,
+32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114,
+40, 52, 52, 44, 10, 34, 73, 110, 116, 49, 54, 120, 56, 46, 112, 114, 111, 116,
+111, 116, 121, 112, 101, 46, 118, 97, 108, 117, 101, 79, 102, 34, 44, 116, 104,
+105, 115, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 112, 59, 10,
+125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49, 54, 120,
+56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 40, 115, 44, 116,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120,
+56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 115, 44, 116, 41, 59,
+10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56,
+120, 49, 54, 67, 104, 101, 99, 107, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 67, 104, 101, 99, 107, 40,
+111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 56, 120, 49, 54, 84, 111, 83, 116, 114, 105, 110, 103, 40, 41, 123, 10,
+118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104,
+105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41,
+33, 61, 61, 39, 105, 110, 116, 56, 120, 49, 54, 39, 41, 123, 10, 116, 104, 114,
+111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114,
+111, 114, 40, 52, 52, 44, 10, 34, 73, 110, 116, 56, 120, 49, 54, 46, 112, 114,
+111, 116, 111, 116, 121, 112, 101, 46, 116, 111, 83, 116, 114, 105, 110, 103,
+34, 44, 116, 104, 105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34,
+83, 73, 77, 68, 46, 73, 110, 116, 56, 120, 49, 54, 40, 34, 59, 10, 113, 43, 61,
+37, 73, 110, 116, 56, 120, 49, 54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 40, 112, 44, 48, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61,
+49, 59, 114, 60, 49, 54, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32,
+34, 43, 37, 73, 110, 116, 56, 120, 49, 54, 69, 120, 116, 114, 97, 99, 116, 76,
+97, 110, 101, 40, 112, 44, 114, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114,
+110, 32, 113, 43, 34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 73, 110, 116, 56, 120, 49, 54, 84, 111, 76, 111, 99, 97, 108, 101, 83,
+116, 114, 105, 110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97,
+108, 117, 101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116,
+121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 105, 110, 116, 56, 120,
+49, 54, 39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95,
+116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 73,
+110, 116, 56, 120, 49, 54, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46,
+116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 34, 44, 116,
+104, 105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77,
+68, 46, 73, 110, 116, 56, 120, 49, 54, 40, 34, 59, 10, 113, 43, 61, 37, 73, 110,
+116, 56, 120, 49, 54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112,
+44, 48, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110,
+103, 40, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49, 59, 114,
+60, 49, 54, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43, 37,
+73, 110, 116, 56, 120, 49, 54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101,
+40, 112, 44, 114, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114,
+105, 110, 103, 40, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 113,
+43, 34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73,
+110, 116, 56, 120, 49, 54, 86, 97, 108, 117, 101, 79, 102, 40, 41, 123, 10, 118,
+97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105,
+115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33,
+61, 61, 39, 105, 110, 116, 56, 120, 49, 54, 39, 41, 123, 10, 116, 104, 114, 111,
+119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111,
+114, 40, 52, 52, 44, 10, 34, 73, 110, 116, 56, 120, 49, 54, 46, 112, 114, 111,
+116, 111, 116, 121, 112, 101, 46, 118, 97, 108, 117, 101, 79, 102, 34, 44, 116,
+104, 105, 115, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 112, 59,
+10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120,
+49, 54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 40, 115, 44,
+116, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120,
+49, 54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 115, 44, 116, 41,
+59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 51, 50, 120, 52, 67, 104, 101, 99, 107, 74, 83, 40, 111, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 67,
+104, 101, 99, 107, 40, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 84, 111, 83, 116, 114, 105,
+110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101,
+79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101,
+111, 102, 40, 112, 41, 33, 61, 61, 39, 117, 105, 110, 116, 51, 50, 120, 52, 39,
+41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121,
+112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 85, 105, 110,
+116, 51, 50, 120, 52, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46, 116,
+111, 83, 116, 114, 105, 110, 103, 34, 44, 116, 104, 105, 115, 41, 59, 10, 125,
+10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68, 46, 85, 105, 110, 116, 51,
+50, 120, 52, 40, 34, 59, 10, 113, 43, 61, 37, 85, 105, 110, 116, 51, 50, 120,
+52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44, 48, 41, 59,
+10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49, 59, 114, 60, 52, 59, 114,
+43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43, 37, 85, 105, 110, 116, 51,
+50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44, 114,
+41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43, 34, 41, 34, 59,
+10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51,
+50, 120, 52, 84, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103,
+40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102,
+40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102,
+40, 112, 41, 33, 61, 61, 39, 117, 105, 110, 116, 51, 50, 120, 52, 39, 41, 123,
+10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101,
+95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 85, 105, 110, 116, 51, 50,
+120, 52, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46, 116, 111, 76, 111,
+99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 34, 44, 116, 104, 105, 115, 41,
+59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68, 46, 85, 105,
+110, 116, 51, 50, 120, 52, 40, 34, 59, 10, 113, 43, 61, 37, 85, 105, 110, 116,
+51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44,
+48, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103,
+40, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49, 59, 114, 60,
+52, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43, 37, 85, 105,
+110, 116, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40,
+112, 44, 114, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105,
+110, 103, 40, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43,
+34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 51, 50, 120, 52, 86, 97, 108, 117, 101, 79, 102, 40, 41, 123, 10, 118,
+97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105,
+115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33,
+61, 61, 39, 117, 105, 110, 116, 51, 50, 120, 52, 39, 41, 123, 10, 116, 104, 114,
+111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114,
+111, 114, 40, 52, 52, 44, 10, 34, 85, 105, 110, 116, 51, 50, 120, 52, 46, 112,
+114, 111, 116, 111, 116, 121, 112, 101, 46, 118, 97, 108, 117, 101, 79, 102, 34,
+44, 116, 104, 105, 115, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32,
+112, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110,
+116, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83,
+40, 115, 44, 116, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105,
+110, 116, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40,
+115, 44, 116, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 85, 105, 110, 116, 49, 54, 120, 56, 67, 104, 101, 99, 107, 74, 83, 40, 111,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54,
+120, 56, 67, 104, 101, 99, 107, 40, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 84, 111, 83, 116,
+114, 105, 110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108,
+117, 101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121,
+112, 101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 117, 105, 110, 116, 49, 54,
+120, 56, 39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101,
+95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 85,
+105, 110, 116, 49, 54, 120, 56, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101,
+46, 116, 111, 83, 116, 114, 105, 110, 103, 34, 44, 116, 104, 105, 115, 41, 59,
+10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68, 46, 85, 105, 110,
+116, 49, 54, 120, 56, 40, 34, 59, 10, 113, 43, 61, 37, 85, 105, 110, 116, 49,
+54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44, 48,
+41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49, 59, 114, 60, 56,
+59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43, 37, 85, 105, 110,
+116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112,
+44, 114, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43, 34, 41,
+34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110,
+116, 49, 54, 120, 56, 84, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105,
+110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101,
+79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101,
+111, 102, 40, 112, 41, 33, 61, 61, 39, 117, 105, 110, 116, 49, 54, 120, 56, 39,
+41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121,
+112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 85, 105, 110,
+116, 49, 54, 120, 56, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46, 116,
+111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 34, 44, 116, 104,
+105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68,
+46, 85, 105, 110, 116, 49, 54, 120, 56, 40, 34, 59, 10, 113, 43, 61, 37, 85,
+105, 110, 116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 40, 112, 44, 48, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114,
+105, 110, 103, 40, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49,
+59, 114, 60, 56, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43,
+37, 85, 105, 110, 116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97,
+110, 101, 40, 112, 44, 114, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83,
+116, 114, 105, 110, 103, 40, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110,
+32, 113, 43, 34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 85, 105, 110, 116, 49, 54, 120, 56, 86, 97, 108, 117, 101, 79, 102, 40, 41,
+123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116,
+104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40, 112,
+41, 33, 61, 61, 39, 117, 105, 110, 116, 49, 54, 120, 56, 39, 41, 123, 10, 116,
+104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101,
+114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 85, 105, 110, 116, 49, 54, 120, 56,
+46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46, 118, 97, 108, 117, 101, 79,
+102, 34, 44, 116, 104, 105, 115, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114,
+110, 32, 112, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85,
+105, 110, 116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 74, 83, 40, 115, 44, 116, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 85, 105, 110, 116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97,
+110, 101, 40, 115, 44, 116, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 67, 104, 101, 99, 107,
+74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105,
+110, 116, 56, 120, 49, 54, 67, 104, 101, 99, 107, 40, 111, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54,
+84, 111, 83, 116, 114, 105, 110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112,
+61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105,
+102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 117, 105,
+110, 116, 56, 120, 49, 54, 39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37,
+109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52,
+52, 44, 10, 34, 85, 105, 110, 116, 56, 120, 49, 54, 46, 112, 114, 111, 116, 111,
+116, 121, 112, 101, 46, 116, 111, 83, 116, 114, 105, 110, 103, 34, 44, 116, 104,
+105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68,
+46, 85, 105, 110, 116, 56, 120, 49, 54, 40, 34, 59, 10, 113, 43, 61, 37, 85,
+105, 110, 116, 56, 120, 49, 54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 40, 112, 44, 48, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61,
+49, 59, 114, 60, 49, 54, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32,
+34, 43, 37, 85, 105, 110, 116, 56, 120, 49, 54, 69, 120, 116, 114, 97, 99, 116,
+76, 97, 110, 101, 40, 112, 44, 114, 41, 59, 10, 125, 10, 114, 101, 116, 117,
+114, 110, 32, 113, 43, 34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 84, 111, 76, 111, 99, 97, 108,
+101, 83, 116, 114, 105, 110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61,
+37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105,
+102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 117, 105,
+110, 116, 56, 120, 49, 54, 39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37,
+109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52,
+52, 44, 10, 34, 85, 105, 110, 116, 56, 120, 49, 54, 46, 112, 114, 111, 116, 111,
+116, 121, 112, 101, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105,
+110, 103, 34, 44, 116, 104, 105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32,
+113, 61, 34, 83, 73, 77, 68, 46, 85, 105, 110, 116, 56, 120, 49, 54, 40, 34, 59,
+10, 113, 43, 61, 37, 85, 105, 110, 116, 56, 120, 49, 54, 69, 120, 116, 114, 97,
+99, 116, 76, 97, 110, 101, 40, 112, 44, 48, 41, 46, 116, 111, 76, 111, 99, 97,
+108, 101, 83, 116, 114, 105, 110, 103, 40, 41, 59, 10, 102, 111, 114, 40, 118,
+97, 114, 32, 114, 61, 49, 59, 114, 60, 49, 54, 59, 114, 43, 43, 41, 123, 10,
+113, 43, 61, 34, 44, 32, 34, 43, 37, 85, 105, 110, 116, 56, 120, 49, 54, 69,
+120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44, 114, 41, 46, 116,
+111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 40, 41, 59, 10,
+125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43, 34, 41, 34, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54,
+86, 97, 108, 117, 101, 79, 102, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37,
+86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102,
+40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 117, 105, 110,
+116, 56, 120, 49, 54, 39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97,
+107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44,
+10, 34, 85, 105, 110, 116, 56, 120, 49, 54, 46, 112, 114, 111, 116, 111, 116,
+121, 112, 101, 46, 118, 97, 108, 117, 101, 79, 102, 34, 44, 116, 104, 105, 115,
+41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 112, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54,
+69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 40, 115, 44, 116, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49,
+54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 115, 44, 116, 41, 59,
+10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111,
+108, 51, 50, 120, 52, 67, 104, 101, 99, 107, 74, 83, 40, 111, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 51, 50, 120, 52, 67, 104,
+101, 99, 107, 40, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 66, 111, 111, 108, 51, 50, 120, 52, 84, 111, 83, 116, 114, 105, 110,
+103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79,
+102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111,
+102, 40, 112, 41, 33, 61, 61, 39, 98, 111, 111, 108, 51, 50, 120, 52, 39, 41,
+123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112,
+101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 66, 111, 111, 108, 51,
+50, 120, 52, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46, 116, 111, 83,
+116, 114, 105, 110, 103, 34, 44, 116, 104, 105, 115, 41, 59, 10, 125, 10, 118,
+97, 114, 32, 113, 61, 34, 83, 73, 77, 68, 46, 66, 111, 111, 108, 51, 50, 120,
+52, 40, 34, 59, 10, 113, 43, 61, 37, 66, 111, 111, 108, 51, 50, 120, 52, 69,
+120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44, 48, 41, 59, 10, 102,
+111, 114, 40, 118, 97, 114, 32, 114, 61, 49, 59, 114, 60, 52, 59, 114, 43, 43,
+41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43, 37, 66, 111, 111, 108, 51, 50,
+120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44, 114, 41,
+59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43, 34, 41, 34, 59, 10,
+125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 51, 50,
+120, 52, 84, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 40,
+41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40,
+116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40,
+112, 41, 33, 61, 61, 39, 98, 111, 111, 108, 51, 50, 120, 52, 39, 41, 123, 10,
+116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95,
+101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 66, 111, 111, 108, 51, 50, 120,
+52, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46, 116, 111, 76, 111, 99,
+97, 108, 101, 83, 116, 114, 105, 110, 103, 34, 44, 116, 104, 105, 115, 41, 59,
+10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68, 46, 66, 111, 111,
+108, 51, 50, 120, 52, 40, 34, 59, 10, 113, 43, 61, 37, 66, 111, 111, 108, 51,
+50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44, 48,
+41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 40,
+41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49, 59, 114, 60, 52,
+59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43, 37, 66, 111, 111,
+108, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112,
+44, 114, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110,
+103, 40, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43, 34, 41,
+34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111,
+108, 51, 50, 120, 52, 86, 97, 108, 117, 101, 79, 102, 40, 41, 123, 10, 118, 97,
+114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105, 115,
+41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61,
+39, 98, 111, 111, 108, 51, 50, 120, 52, 39, 41, 123, 10, 116, 104, 114, 111,
+119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111,
+114, 40, 52, 52, 44, 10, 34, 66, 111, 111, 108, 51, 50, 120, 52, 46, 112, 114,
+111, 116, 111, 116, 121, 112, 101, 46, 118, 97, 108, 117, 101, 79, 102, 34, 44,
+116, 104, 105, 115, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 112,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108,
+51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 40,
+115, 44, 116, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111,
+108, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 115,
+44, 116, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66,
+111, 111, 108, 49, 54, 120, 56, 67, 104, 101, 99, 107, 74, 83, 40, 111, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 49, 54, 120, 56,
+67, 104, 101, 99, 107, 40, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 66, 111, 111, 108, 49, 54, 120, 56, 84, 111, 83, 116, 114,
+105, 110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117,
+101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112,
+101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 98, 111, 111, 108, 49, 54, 120, 56,
+39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116,
+121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 66, 111,
+111, 108, 49, 54, 120, 56, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46,
+116, 111, 83, 116, 114, 105, 110, 103, 34, 44, 116, 104, 105, 115, 41, 59, 10,
+125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68, 46, 66, 111, 111, 108,
+49, 54, 120, 56, 40, 34, 59, 10, 113, 43, 61, 37, 66, 111, 111, 108, 49, 54,
+120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44, 48, 41,
+59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49, 59, 114, 60, 56, 59,
+114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43, 37, 66, 111, 111,
+108, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112,
+44, 114, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43, 34, 41,
+34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111,
+108, 49, 54, 120, 56, 84, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105,
+110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101,
+79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101,
+111, 102, 40, 112, 41, 33, 61, 61, 39, 98, 111, 111, 108, 49, 54, 120, 56, 39,
+41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121,
+112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 66, 111, 111,
+108, 49, 54, 120, 56, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46, 116,
+111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 34, 44, 116, 104,
+105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68,
+46, 66, 111, 111, 108, 49, 54, 120, 56, 40, 34, 59, 10, 113, 43, 61, 37, 66,
+111, 111, 108, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 40, 112, 44, 48, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114,
+105, 110, 103, 40, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61, 49,
+59, 114, 60, 56, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32, 34, 43,
+37, 66, 111, 111, 108, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97,
+110, 101, 40, 112, 44, 114, 41, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83,
+116, 114, 105, 110, 103, 40, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110,
+32, 113, 43, 34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 66, 111, 111, 108, 49, 54, 120, 56, 86, 97, 108, 117, 101, 79, 102, 40, 41,
+123, 10, 118, 97, 114, 32, 112, 61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116,
+104, 105, 115, 41, 59, 10, 105, 102, 40, 116, 121, 112, 101, 111, 102, 40, 112,
+41, 33, 61, 61, 39, 98, 111, 111, 108, 49, 54, 120, 56, 39, 41, 123, 10, 116,
+104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101,
+114, 114, 111, 114, 40, 52, 52, 44, 10, 34, 66, 111, 111, 108, 49, 54, 120, 56,
+46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 46, 118, 97, 108, 117, 101, 79,
+102, 34, 44, 116, 104, 105, 115, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114,
+110, 32, 112, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66,
+111, 111, 108, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 74, 83, 40, 115, 44, 116, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 66, 111, 111, 108, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97,
+110, 101, 40, 115, 44, 116, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 66, 111, 111, 108, 56, 120, 49, 54, 67, 104, 101, 99, 107,
+74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111,
+111, 108, 56, 120, 49, 54, 67, 104, 101, 99, 107, 40, 111, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 56, 120, 49, 54,
+84, 111, 83, 116, 114, 105, 110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112,
+61, 37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105,
+102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 98, 111,
+111, 108, 56, 120, 49, 54, 39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37,
+109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52,
+52, 44, 10, 34, 66, 111, 111, 108, 56, 120, 49, 54, 46, 112, 114, 111, 116, 111,
+116, 121, 112, 101, 46, 116, 111, 83, 116, 114, 105, 110, 103, 34, 44, 116, 104,
+105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32, 113, 61, 34, 83, 73, 77, 68,
+46, 66, 111, 111, 108, 56, 120, 49, 54, 40, 34, 59, 10, 113, 43, 61, 37, 66,
+111, 111, 108, 56, 120, 49, 54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 40, 112, 44, 48, 41, 59, 10, 102, 111, 114, 40, 118, 97, 114, 32, 114, 61,
+49, 59, 114, 60, 49, 54, 59, 114, 43, 43, 41, 123, 10, 113, 43, 61, 34, 44, 32,
+34, 43, 37, 66, 111, 111, 108, 56, 120, 49, 54, 69, 120, 116, 114, 97, 99, 116,
+76, 97, 110, 101, 40, 112, 44, 114, 41, 59, 10, 125, 10, 114, 101, 116, 117,
+114, 110, 32, 113, 43, 34, 41, 34, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 66, 111, 111, 108, 56, 120, 49, 54, 84, 111, 76, 111, 99, 97, 108,
+101, 83, 116, 114, 105, 110, 103, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61,
+37, 86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105,
+102, 40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 98, 111,
+111, 108, 56, 120, 49, 54, 39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37,
+109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52,
+52, 44, 10, 34, 66, 111, 111, 108, 56, 120, 49, 54, 46, 112, 114, 111, 116, 111,
+116, 121, 112, 101, 46, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105,
+110, 103, 34, 44, 116, 104, 105, 115, 41, 59, 10, 125, 10, 118, 97, 114, 32,
+113, 61, 34, 83, 73, 77, 68, 46, 66, 111, 111, 108, 56, 120, 49, 54, 40, 34, 59,
+10, 113, 43, 61, 37, 66, 111, 111, 108, 56, 120, 49, 54, 69, 120, 116, 114, 97,
+99, 116, 76, 97, 110, 101, 40, 112, 44, 48, 41, 46, 116, 111, 76, 111, 99, 97,
+108, 101, 83, 116, 114, 105, 110, 103, 40, 41, 59, 10, 102, 111, 114, 40, 118,
+97, 114, 32, 114, 61, 49, 59, 114, 60, 49, 54, 59, 114, 43, 43, 41, 123, 10,
+113, 43, 61, 34, 44, 32, 34, 43, 37, 66, 111, 111, 108, 56, 120, 49, 54, 69,
+120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 112, 44, 114, 41, 46, 116,
+111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 40, 41, 59, 10,
+125, 10, 114, 101, 116, 117, 114, 110, 32, 113, 43, 34, 41, 34, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 56, 120, 49, 54,
+86, 97, 108, 117, 101, 79, 102, 40, 41, 123, 10, 118, 97, 114, 32, 112, 61, 37,
+86, 97, 108, 117, 101, 79, 102, 40, 116, 104, 105, 115, 41, 59, 10, 105, 102,
+40, 116, 121, 112, 101, 111, 102, 40, 112, 41, 33, 61, 61, 39, 98, 111, 111,
+108, 56, 120, 49, 54, 39, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97,
+107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 52, 52, 44,
+10, 34, 66, 111, 111, 108, 56, 120, 49, 54, 46, 112, 114, 111, 116, 111, 116,
+121, 112, 101, 46, 118, 97, 108, 117, 101, 79, 102, 34, 44, 116, 104, 105, 115,
+41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 112, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 56, 120, 49, 54,
+69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 40, 115, 44, 116, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 56, 120, 49,
+54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 40, 115, 44, 116, 41, 59,
+10, 125, 10, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 51, 50, 120, 52, 83, 104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83,
+99, 97, 108, 97, 114, 74, 83, 40, 115, 44, 117, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 83, 104, 105, 102, 116, 76,
+101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114, 40, 115, 44, 117, 41, 59, 10,
+125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120,
+52, 83, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97, 108,
+97, 114, 74, 83, 40, 115, 44, 117, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 73, 110, 116, 51, 50, 120, 52, 83, 104, 105, 102, 116, 82, 105, 103,
+104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 40, 115, 44, 117, 41, 59, 10, 125,
+10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49, 54, 120,
+56, 83, 104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97,
+114, 74, 83, 40, 115, 44, 117, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 73, 110, 116, 49, 54, 120, 56, 83, 104, 105, 102, 116, 76, 101, 102, 116,
+66, 121, 83, 99, 97, 108, 97, 114, 40, 115, 44, 117, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 83, 104,
+105, 102, 116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74,
+83, 40, 115, 44, 117, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73,
+110, 116, 49, 54, 120, 56, 83, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66,
+121, 83, 99, 97, 108, 97, 114, 40, 115, 44, 117, 41, 59, 10, 125, 10, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 83, 104,
+105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 40,
+115, 44, 117, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116,
+56, 120, 49, 54, 83, 104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97,
+108, 97, 114, 40, 115, 44, 117, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 83, 104, 105, 102, 116, 82,
+105, 103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 40, 115, 44, 117,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49,
+54, 83, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97, 108,
+97, 114, 40, 115, 44, 117, 41, 59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 83, 104, 105, 102, 116,
+76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 40, 115, 44, 117,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50,
+120, 52, 83, 104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108,
+97, 114, 40, 115, 44, 117, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 83, 104, 105, 102, 116, 82,
+105, 103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 40, 115, 44, 117,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50,
+120, 52, 83, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97,
+108, 97, 114, 40, 115, 44, 117, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 83, 104, 105, 102, 116,
+76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 40, 115, 44, 117,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54,
+120, 56, 83, 104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108,
+97, 114, 40, 115, 44, 117, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 83, 104, 105, 102, 116, 82,
+105, 103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 40, 115, 44, 117,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54,
+120, 56, 83, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97,
+108, 97, 114, 40, 115, 44, 117, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 83, 104, 105, 102, 116,
+76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 40, 115, 44, 117,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120,
+49, 54, 83, 104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97,
+114, 40, 115, 44, 117, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 83, 104, 105, 102, 116, 82, 105,
+103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 40, 115, 44, 117, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49,
+54, 83, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97, 108,
+97, 114, 40, 115, 44, 117, 41, 59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 65, 100, 100, 83, 97, 116,
+117, 114, 97, 116, 101, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 65, 100, 100, 83, 97, 116,
+117, 114, 97, 116, 101, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 83, 117, 98, 83, 97,
+116, 117, 114, 97, 116, 101, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 83, 117, 98, 83, 97,
+116, 117, 114, 97, 116, 101, 40, 111, 44, 118, 41, 59, 10, 125, 10, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 65, 100,
+100, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 40, 111, 44, 118, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 65, 100,
+100, 83, 97, 116, 117, 114, 97, 116, 101, 40, 111, 44, 118, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 83,
+117, 98, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 40, 111, 44, 118, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 83,
+117, 98, 83, 97, 116, 117, 114, 97, 116, 101, 40, 111, 44, 118, 41, 59, 10, 125,
+10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120,
+49, 54, 65, 100, 100, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 40, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56,
+120, 49, 54, 65, 100, 100, 83, 97, 116, 117, 114, 97, 116, 101, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 56, 120, 49, 54, 83, 117, 98, 83, 97, 116, 117, 114, 97, 116, 101, 74,
+83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85,
+105, 110, 116, 56, 120, 49, 54, 83, 117, 98, 83, 97, 116, 117, 114, 97, 116,
+101, 40, 111, 44, 118, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 65, 100, 100, 83, 97, 116,
+117, 114, 97, 116, 101, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 65, 100, 100, 83, 97,
+116, 117, 114, 97, 116, 101, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 83, 117,
+98, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 40, 111, 44, 118, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 83,
+117, 98, 83, 97, 116, 117, 114, 97, 116, 101, 40, 111, 44, 118, 41, 59, 10, 125,
+10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 78, 101, 103, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 78, 101, 103, 40, 111,
+41, 59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 51, 50, 120, 52, 78, 101, 103, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 78, 101, 103, 40, 111, 41,
+59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116,
+49, 54, 120, 56, 78, 101, 103, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 78, 101, 103, 40, 111, 41, 59,
+10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56,
+120, 49, 54, 78, 101, 103, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 78, 101, 103, 40, 111, 41, 59,
+10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111,
+108, 51, 50, 120, 52, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83,
+40, 115, 44, 116, 44, 112, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37,
+66, 111, 111, 108, 51, 50, 120, 52, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110,
+101, 40, 115, 44, 116, 44, 112, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 66, 111, 111, 108, 51, 50, 120, 52, 65, 110, 121, 84, 114,
+117, 101, 74, 83, 40, 119, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37,
+66, 111, 111, 108, 51, 50, 120, 52, 65, 110, 121, 84, 114, 117, 101, 40, 119,
+41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111,
+108, 51, 50, 120, 52, 65, 108, 108, 84, 114, 117, 101, 74, 83, 40, 119, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 51, 50, 120, 52,
+65, 108, 108, 84, 114, 117, 101, 40, 119, 41, 59, 10, 125, 10, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 49, 54, 120, 56, 82, 101,
+112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83, 40, 115, 44, 116, 44, 112, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 49, 54, 120,
+56, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 40, 115, 44, 116, 44, 112,
+41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111,
+108, 49, 54, 120, 56, 65, 110, 121, 84, 114, 117, 101, 74, 83, 40, 119, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 49, 54, 120, 56,
+65, 110, 121, 84, 114, 117, 101, 40, 119, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 49, 54, 120, 56, 65, 108, 108,
+84, 114, 117, 101, 74, 83, 40, 119, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 66, 111, 111, 108, 49, 54, 120, 56, 65, 108, 108, 84, 114, 117, 101, 40,
+119, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66,
+111, 111, 108, 56, 120, 49, 54, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110,
+101, 74, 83, 40, 115, 44, 116, 44, 112, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 66, 111, 111, 108, 56, 120, 49, 54, 82, 101, 112, 108, 97, 99, 101,
+76, 97, 110, 101, 40, 115, 44, 116, 44, 112, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 56, 120, 49, 54, 65, 110, 121,
+84, 114, 117, 101, 74, 83, 40, 119, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 66, 111, 111, 108, 56, 120, 49, 54, 65, 110, 121, 84, 114, 117, 101, 40,
+119, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111,
+111, 108, 56, 120, 49, 54, 65, 108, 108, 84, 114, 117, 101, 74, 83, 40, 119, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 56, 120, 49,
+54, 65, 108, 108, 84, 114, 117, 101, 40, 119, 41, 59, 10, 125, 10, 10, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52,
+82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83, 40, 115, 44, 116, 44,
+112, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 40, 115, 44,
+116, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 112, 41, 41, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 83, 101, 108, 101, 99, 116, 74, 83, 40, 120, 44, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 83, 101, 108, 101, 99, 116, 40, 120, 44, 111, 44, 118, 41, 59,
+10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 65, 100, 100, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 65, 100,
+100, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 117, 98, 74, 83, 40, 111,
+44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 83, 117, 98, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52,
+77, 117, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 77, 117, 108, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 77, 105, 110, 74, 83, 40, 111, 44, 118, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120,
+52, 77, 105, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 77, 97, 120, 74, 83,
+40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 77, 97, 120, 40, 111, 44, 118, 41, 59, 10, 125,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 69, 113,
+117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 78, 111, 116, 69,
+113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 78, 111, 116, 69, 113,
+117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76, 101, 115, 115,
+84, 104, 97, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76, 101, 115, 115, 84,
+104, 97, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76, 101, 115, 115,
+84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 76, 101, 115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108,
+40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 71, 114, 101, 97, 116, 101, 114, 84,
+104, 97, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 71, 114, 101, 97, 116, 101,
+114, 84, 104, 97, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 71, 114, 101,
+97, 116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 40,
+111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111,
+97, 116, 51, 50, 120, 52, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79,
+114, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76,
+111, 97, 100, 74, 83, 40, 121, 44, 122, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76, 111, 97, 100, 40, 121,
+44, 122, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70,
+108, 111, 97, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 74, 83, 40, 121, 44,
+122, 44, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111,
+97, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 40, 121, 44, 122, 44, 111, 41,
+59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 51, 50, 120, 52, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83,
+40, 115, 44, 116, 44, 112, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37,
+73, 110, 116, 51, 50, 120, 52, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101,
+40, 115, 44, 116, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 112,
+41, 41, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 51, 50, 120, 52, 83, 101, 108, 101, 99, 116, 74, 83, 40, 120, 44, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50,
+120, 52, 83, 101, 108, 101, 99, 116, 40, 120, 44, 111, 44, 118, 41, 59, 10, 125,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52,
+65, 100, 100, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 65, 100, 100, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51,
+50, 120, 52, 83, 117, 98, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 83, 117, 98, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 51, 50, 120, 52, 77, 117, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 77, 117, 108,
+40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 73, 110, 116, 51, 50, 120, 52, 77, 105, 110, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52,
+77, 105, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 77, 97, 120, 74, 83, 40, 111,
+44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51,
+50, 120, 52, 77, 97, 120, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 69, 113, 117, 97,
+108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 73, 110, 116, 51, 50, 120, 52, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51,
+50, 120, 52, 78, 111, 116, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52,
+78, 111, 116, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 76, 101,
+115, 115, 84, 104, 97, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 76, 101, 115, 115,
+84, 104, 97, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 76, 101, 115, 115, 84, 104,
+97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 76, 101,
+115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 40, 111, 44, 118,
+41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116,
+51, 50, 120, 52, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 74, 83, 40,
+111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116,
+51, 50, 120, 52, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 51, 50, 120, 52, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79,
+114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 71, 114, 101, 97,
+116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 51, 50, 120, 52, 76, 111, 97, 100, 74, 83, 40, 121, 44, 122, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 76, 111,
+97, 100, 40, 121, 44, 122, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 74, 83, 40,
+121, 44, 122, 44, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73,
+110, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 40, 121, 44, 122, 44, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 49, 54, 120, 56, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83,
+40, 115, 44, 116, 44, 112, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37,
+73, 110, 116, 49, 54, 120, 56, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101,
+40, 115, 44, 116, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 112,
+41, 41, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 49, 54, 120, 56, 83, 101, 108, 101, 99, 116, 74, 83, 40, 120, 44, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54,
+120, 56, 83, 101, 108, 101, 99, 116, 40, 120, 44, 111, 44, 118, 41, 59, 10, 125,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56,
+65, 100, 100, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 65, 100, 100, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49,
+54, 120, 56, 83, 117, 98, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 83, 117, 98, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 49, 54, 120, 56, 77, 117, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 77, 117, 108,
+40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 73, 110, 116, 49, 54, 120, 56, 77, 105, 110, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56,
+77, 105, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 77, 97, 120, 74, 83, 40, 111,
+44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49,
+54, 120, 56, 77, 97, 120, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 69, 113, 117, 97,
+108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 73, 110, 116, 49, 54, 120, 56, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49,
+54, 120, 56, 78, 111, 116, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56,
+78, 111, 116, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 76, 101,
+115, 115, 84, 104, 97, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 76, 101, 115, 115,
+84, 104, 97, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 76, 101, 115, 115, 84, 104,
+97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 76, 101,
+115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 40, 111, 44, 118,
+41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116,
+49, 54, 120, 56, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 74, 83, 40,
+111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116,
+49, 54, 120, 56, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 49, 54, 120, 56, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79,
+114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 71, 114, 101, 97,
+116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 49, 54, 120, 56, 76, 111, 97, 100, 74, 83, 40, 121, 44, 122, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 76, 111,
+97, 100, 40, 121, 44, 122, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 83, 116, 111, 114, 101, 74, 83, 40,
+121, 44, 122, 44, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73,
+110, 116, 49, 54, 120, 56, 83, 116, 111, 114, 101, 40, 121, 44, 122, 44, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 56, 120, 49, 54, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83,
+40, 115, 44, 116, 44, 112, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37,
+73, 110, 116, 56, 120, 49, 54, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101,
+40, 115, 44, 116, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 112,
+41, 41, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 56, 120, 49, 54, 83, 101, 108, 101, 99, 116, 74, 83, 40, 120, 44, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120,
+49, 54, 83, 101, 108, 101, 99, 116, 40, 120, 44, 111, 44, 118, 41, 59, 10, 125,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54,
+65, 100, 100, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 65, 100, 100, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56,
+120, 49, 54, 83, 117, 98, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 83, 117, 98, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 56, 120, 49, 54, 77, 117, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 77, 117, 108,
+40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 73, 110, 116, 56, 120, 49, 54, 77, 105, 110, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54,
+77, 105, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 77, 97, 120, 74, 83, 40, 111,
+44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56,
+120, 49, 54, 77, 97, 120, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 69, 113, 117, 97,
+108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 73, 110, 116, 56, 120, 49, 54, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56,
+120, 49, 54, 78, 111, 116, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54,
+78, 111, 116, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 76, 101,
+115, 115, 84, 104, 97, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 76, 101, 115, 115,
+84, 104, 97, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 76, 101, 115, 115, 84, 104,
+97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 76, 101,
+115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 40, 111, 44, 118,
+41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116,
+56, 120, 49, 54, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 74, 83, 40,
+111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116,
+56, 120, 49, 54, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 56, 120, 49, 54, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79,
+114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 71, 114, 101, 97,
+116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 56, 120, 49, 54, 76, 111, 97, 100, 74, 83, 40, 121, 44, 122, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 76, 111,
+97, 100, 40, 121, 44, 122, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 83, 116, 111, 114, 101, 74, 83, 40,
+121, 44, 122, 44, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73,
+110, 116, 56, 120, 49, 54, 83, 116, 111, 114, 101, 40, 121, 44, 122, 44, 111,
+41, 59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 51, 50, 120, 52, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74,
+83, 40, 115, 44, 116, 44, 112, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 85, 105, 110, 116, 51, 50, 120, 52, 82, 101, 112, 108, 97, 99, 101, 76, 97,
+110, 101, 40, 115, 44, 116, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114,
+40, 112, 41, 41, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+85, 105, 110, 116, 51, 50, 120, 52, 83, 101, 108, 101, 99, 116, 74, 83, 40, 120,
+44, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105,
+110, 116, 51, 50, 120, 52, 83, 101, 108, 101, 99, 116, 40, 120, 44, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 51, 50, 120, 52, 65, 100, 100, 74, 83, 40, 111, 44, 118, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 65,
+100, 100, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 83, 117, 98, 74, 83, 40, 111,
+44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116,
+51, 50, 120, 52, 83, 117, 98, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 77, 117,
+108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 85, 105, 110, 116, 51, 50, 120, 52, 77, 117, 108, 40, 111, 44, 118, 41, 59,
+10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51,
+50, 120, 52, 77, 105, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 77, 105, 110, 40,
+111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+85, 105, 110, 116, 51, 50, 120, 52, 77, 97, 120, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120,
+52, 77, 97, 120, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 69, 113, 117, 97, 108,
+74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85,
+105, 110, 116, 51, 50, 120, 52, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41, 59,
+10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51,
+50, 120, 52, 78, 111, 116, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120,
+52, 78, 111, 116, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52,
+76, 101, 115, 115, 84, 104, 97, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 76, 101,
+115, 115, 84, 104, 97, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 76, 101,
+115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51,
+50, 120, 52, 76, 101, 115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97,
+108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 71, 114, 101, 97, 116, 101, 114,
+84, 104, 97, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 71, 114, 101, 97, 116,
+101, 114, 84, 104, 97, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 71, 114,
+101, 97, 116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74,
+83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85,
+105, 110, 116, 51, 50, 120, 52, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97,
+110, 79, 114, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 76,
+111, 97, 100, 74, 83, 40, 121, 44, 122, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 76, 111, 97, 100, 40, 121, 44,
+122, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 74, 83, 40, 121, 44, 122, 44,
+111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51,
+50, 120, 52, 83, 116, 111, 114, 101, 40, 121, 44, 122, 44, 111, 41, 59, 10, 125,
+10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54,
+120, 56, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83, 40, 115, 44,
+116, 44, 112, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110,
+116, 49, 54, 120, 56, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 40, 115,
+44, 116, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 112, 41, 41,
+41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110,
+116, 49, 54, 120, 56, 83, 101, 108, 101, 99, 116, 74, 83, 40, 120, 44, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49,
+54, 120, 56, 83, 101, 108, 101, 99, 116, 40, 120, 44, 111, 44, 118, 41, 59, 10,
+125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54,
+120, 56, 65, 100, 100, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 65, 100, 100, 40,
+111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+85, 105, 110, 116, 49, 54, 120, 56, 83, 117, 98, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120,
+56, 83, 117, 98, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 77, 117, 108, 74, 83, 40,
+111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110,
+116, 49, 54, 120, 56, 77, 117, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 77,
+105, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 77, 105, 110, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116,
+49, 54, 120, 56, 77, 97, 120, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 77, 97, 120, 40,
+111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+85, 105, 110, 116, 49, 54, 120, 56, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49,
+54, 120, 56, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 78,
+111, 116, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 78, 111,
+116, 69, 113, 117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 76, 101,
+115, 115, 84, 104, 97, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 76, 101, 115,
+115, 84, 104, 97, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 76, 101, 115, 115,
+84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120,
+56, 76, 101, 115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 40,
+111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+85, 105, 110, 116, 49, 54, 120, 56, 71, 114, 101, 97, 116, 101, 114, 84, 104,
+97, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 71, 114, 101, 97, 116, 101, 114, 84,
+104, 97, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 71, 114, 101, 97, 116,
+101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49,
+54, 120, 56, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79, 114, 69,
+113, 117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 76, 111, 97, 100,
+74, 83, 40, 121, 44, 122, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85,
+105, 110, 116, 49, 54, 120, 56, 76, 111, 97, 100, 40, 121, 44, 122, 41, 59, 10,
+125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54,
+120, 56, 83, 116, 111, 114, 101, 74, 83, 40, 121, 44, 122, 44, 111, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 83,
+116, 111, 114, 101, 40, 121, 44, 122, 44, 111, 41, 59, 10, 125, 10, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 82,
+101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83, 40, 115, 44, 116, 44, 112,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120,
+49, 54, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 40, 115, 44, 116, 44,
+40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 112, 41, 41, 41, 59, 10,
+125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120,
+49, 54, 83, 101, 108, 101, 99, 116, 74, 83, 40, 120, 44, 111, 44, 118, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54,
+83, 101, 108, 101, 99, 116, 40, 120, 44, 111, 44, 118, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 65,
+100, 100, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 65, 100, 100, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116,
+56, 120, 49, 54, 83, 117, 98, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 83, 117, 98, 40,
+111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+85, 105, 110, 116, 56, 120, 49, 54, 77, 117, 108, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49,
+54, 77, 117, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 77, 105, 110, 74, 83, 40,
+111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110,
+116, 56, 120, 49, 54, 77, 105, 110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 77,
+97, 120, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 77, 97, 120, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116,
+56, 120, 49, 54, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 69,
+113, 117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 78, 111, 116, 69,
+113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 78, 111, 116, 69, 113,
+117, 97, 108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 76, 101, 115, 115, 84,
+104, 97, 110, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 76, 101, 115, 115, 84, 104, 97,
+110, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 76, 101, 115, 115, 84, 104, 97,
+110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 76, 101,
+115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 40, 111, 44, 118,
+41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110,
+116, 56, 120, 49, 54, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 74, 83,
+40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105,
+110, 116, 56, 120, 49, 54, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110,
+40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 85, 105, 110, 116, 56, 120, 49, 54, 71, 114, 101, 97, 116, 101, 114, 84,
+104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 40, 111, 44, 118, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54,
+71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97,
+108, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 76, 111, 97, 100, 74, 83, 40, 121,
+44, 122, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116,
+56, 120, 49, 54, 76, 111, 97, 100, 40, 121, 44, 122, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 83,
+116, 111, 114, 101, 74, 83, 40, 121, 44, 122, 44, 111, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 83, 116, 111,
+114, 101, 40, 121, 44, 122, 44, 111, 41, 59, 10, 125, 10, 10, 10, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 65, 110, 100,
+74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73,
+110, 116, 51, 50, 120, 52, 65, 110, 100, 40, 111, 44, 118, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 79,
+114, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 73, 110, 116, 51, 50, 120, 52, 79, 114, 40, 111, 44, 118, 41, 59, 10, 125,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52,
+88, 111, 114, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 88, 111, 114, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51,
+50, 120, 52, 78, 111, 116, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 78, 111, 116, 40, 111, 41, 59,
+10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49,
+54, 120, 56, 65, 110, 100, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 65, 110, 100, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 49, 54, 120, 56, 79, 114, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 79, 114, 40, 111, 44,
+118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 49, 54, 120, 56, 88, 111, 114, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 88, 111, 114,
+40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 73, 110, 116, 49, 54, 120, 56, 78, 111, 116, 74, 83, 40, 111, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 78, 111,
+116, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 73, 110, 116, 56, 120, 49, 54, 65, 110, 100, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54,
+65, 110, 100, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 79, 114, 74, 83, 40, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120,
+49, 54, 79, 114, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 88, 111, 114, 74, 83, 40, 111,
+44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56,
+120, 49, 54, 88, 111, 114, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 78, 111, 116, 74, 83,
+40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56,
+120, 49, 54, 78, 111, 116, 40, 111, 41, 59, 10, 125, 10, 10, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 65, 110, 100,
+74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85,
+105, 110, 116, 51, 50, 120, 52, 65, 110, 100, 40, 111, 44, 118, 41, 59, 10, 125,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120,
+52, 79, 114, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 79, 114, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116,
+51, 50, 120, 52, 88, 111, 114, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 88, 111, 114,
+40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 85, 105, 110, 116, 51, 50, 120, 52, 78, 111, 116, 74, 83, 40, 111, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52,
+78, 111, 116, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 65, 110, 100, 74, 83, 40, 111,
+44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116,
+49, 54, 120, 56, 65, 110, 100, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 79, 114,
+74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85,
+105, 110, 116, 49, 54, 120, 56, 79, 114, 40, 111, 44, 118, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56,
+88, 111, 114, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 88, 111, 114, 40, 111, 44, 118,
+41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110,
+116, 49, 54, 120, 56, 78, 111, 116, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 78, 111, 116, 40,
+111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85,
+105, 110, 116, 56, 120, 49, 54, 65, 110, 100, 74, 83, 40, 111, 44, 118, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54,
+65, 110, 100, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 79, 114, 74, 83, 40, 111,
+44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116,
+56, 120, 49, 54, 79, 114, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 88, 111, 114,
+74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85,
+105, 110, 116, 56, 120, 49, 54, 88, 111, 114, 40, 111, 44, 118, 41, 59, 10, 125,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49,
+54, 78, 111, 116, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 78, 111, 116, 40, 111, 41, 59, 10,
+125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108,
+51, 50, 120, 52, 65, 110, 100, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 51, 50, 120, 52, 65, 110, 100,
+40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 66, 111, 111, 108, 51, 50, 120, 52, 79, 114, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 51, 50, 120,
+52, 79, 114, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 66, 111, 111, 108, 51, 50, 120, 52, 88, 111, 114, 74, 83, 40, 111,
+44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108,
+51, 50, 120, 52, 88, 111, 114, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 51, 50, 120, 52, 78, 111,
+116, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66,
+111, 111, 108, 51, 50, 120, 52, 78, 111, 116, 40, 111, 41, 59, 10, 125, 10, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 49, 54, 120, 56,
+65, 110, 100, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 66, 111, 111, 108, 49, 54, 120, 56, 65, 110, 100, 40, 111, 44, 118,
+41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111,
+108, 49, 54, 120, 56, 79, 114, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 49, 54, 120, 56, 79, 114, 40,
+111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+66, 111, 111, 108, 49, 54, 120, 56, 88, 111, 114, 74, 83, 40, 111, 44, 118, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 49, 54, 120,
+56, 88, 111, 114, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 66, 111, 111, 108, 49, 54, 120, 56, 78, 111, 116, 74, 83, 40,
+111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 49,
+54, 120, 56, 78, 111, 116, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 66, 111, 111, 108, 56, 120, 49, 54, 65, 110, 100, 74,
+83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66,
+111, 111, 108, 56, 120, 49, 54, 65, 110, 100, 40, 111, 44, 118, 41, 59, 10, 125,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 56, 120, 49,
+54, 79, 114, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 66, 111, 111, 108, 56, 120, 49, 54, 79, 114, 40, 111, 44, 118, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108,
+56, 120, 49, 54, 88, 111, 114, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 56, 120, 49, 54, 88, 111, 114,
+40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 66, 111, 111, 108, 56, 120, 49, 54, 78, 111, 116, 74, 83, 40, 111, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 56, 120, 49, 54,
+78, 111, 116, 40, 111, 41, 59, 10, 125, 10, 10, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111, 109,
+73, 110, 116, 51, 50, 120, 52, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73,
+110, 116, 51, 50, 120, 52, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111,
+109, 85, 105, 110, 116, 51, 50, 120, 52, 74, 83, 40, 111, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114,
+111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 40, 111, 41, 59, 10, 125, 10, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 70,
+114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 74, 83, 40, 111, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 70,
+114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 40, 111, 41, 59, 10, 125,
+10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120,
+52, 70, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 74, 83, 40, 111, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52,
+70, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 40, 111, 41, 59, 10, 125,
+10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50,
+120, 52, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 74, 83, 40,
+111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51,
+50, 120, 52, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 40, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 74,
+83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110,
+116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 40, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 49, 54, 120, 56, 70, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 74,
+83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116,
+49, 54, 120, 56, 70, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 40, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 74,
+83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110,
+116, 49, 54, 120, 56, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 40, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 56, 120, 49, 54, 70, 114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 74,
+83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116,
+56, 120, 49, 54, 70, 114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 40, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 74,
+83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110,
+116, 56, 120, 49, 54, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 40, 111,
+41, 59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52,
+66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116,
+51, 50, 120, 52, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70,
+114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83,
+40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 70, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 66,
+105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73,
+110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70,
+114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 40, 111, 41,
+59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111,
+97, 116, 51, 50, 120, 52, 70, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56,
+66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111, 109, 85, 105, 110,
+116, 49, 54, 120, 56, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52,
+70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 74, 83, 40,
+111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116,
+115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111, 109, 85, 105, 110,
+116, 56, 120, 49, 54, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114,
+111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 40, 111, 41,
+59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116,
+51, 50, 120, 52, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66,
+105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 73, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109,
+85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 70,
+114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 40, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 66, 105,
+116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37,
+73, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56,
+66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 85, 105,
+110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 70, 114, 111,
+109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 40, 111, 41, 59, 10,
+125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50,
+120, 52, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115,
+74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110,
+116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105,
+116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 73, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 85, 105, 110, 116,
+56, 120, 49, 54, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 85,
+105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120,
+52, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105, 116,
+115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85,
+105, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 70, 114, 111,
+109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52,
+70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 40, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 66,
+105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 85, 105, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 49, 54,
+120, 56, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109,
+85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52,
+70, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 40,
+111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85,
+105, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49,
+54, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110,
+116, 56, 120, 49, 54, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 70,
+114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 74, 83,
+40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116,
+51, 50, 120, 52, 70, 114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105,
+116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 73, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109,
+70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105, 116, 115, 40, 111, 41, 59, 10,
+125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49, 54,
+120, 56, 70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115,
+74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110,
+116, 49, 54, 120, 56, 70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66, 105,
+116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 73, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 85, 105, 110, 116,
+51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 85,
+105, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56,
+70, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74,
+83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116,
+49, 54, 120, 56, 70, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105,
+116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 73, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 73, 110, 116, 56,
+120, 49, 54, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 73,
+110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 70,
+114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 74, 83,
+40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49,
+54, 120, 56, 70, 114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105,
+116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 70, 108, 111,
+97, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 70, 114,
+111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105, 116, 115, 40, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66,
+105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 85, 105, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 73, 110, 116, 51, 50,
+120, 52, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109,
+85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56,
+70, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 40,
+111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85,
+105, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120,
+56, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 73, 110,
+116, 49, 54, 120, 56, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 70,
+114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 74, 83, 40,
+111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49,
+54, 120, 56, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116,
+115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 85, 105, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 85, 105, 110, 116,
+56, 120, 49, 54, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109,
+85, 105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125,
+10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49,
+54, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105, 116,
+115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73,
+110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 73,
+110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 70, 114, 111,
+109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125,
+10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49,
+54, 70, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115,
+74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110,
+116, 56, 120, 49, 54, 70, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 66,
+105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 73, 110, 116,
+49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 73,
+110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120, 49, 54, 70,
+114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74, 83,
+40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56,
+120, 49, 54, 70, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105,
+116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 73, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 85, 105, 110, 116,
+56, 120, 49, 54, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 85,
+105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49,
+54, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105, 116,
+115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85,
+105, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 70, 114, 111,
+109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54,
+70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 40, 111,
+41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120,
+52, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 85, 105,
+110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125, 10, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54,
+70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 40,
+111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56,
+120, 49, 54, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 66, 105, 116,
+115, 40, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 85, 105, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 85, 105, 110, 116,
+49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 40, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109,
+85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 40, 111, 41, 59, 10, 125,
+10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120,
+49, 54, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 74,
+83, 40, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110,
+116, 56, 120, 49, 54, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105,
+116, 115, 40, 111, 41, 59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76, 111, 97, 100, 49, 74,
+83, 40, 121, 44, 122, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70,
+108, 111, 97, 116, 51, 50, 120, 52, 76, 111, 97, 100, 49, 40, 121, 44, 122, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 49, 74, 83, 40, 121, 44, 122, 44,
+111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 83, 116, 111, 114, 101, 49, 40, 121, 44, 122, 44, 111, 41, 59,
+10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 76, 111, 97, 100, 50, 74, 83, 40, 121, 44, 122, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120,
+52, 76, 111, 97, 100, 50, 40, 121, 44, 122, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 116,
+111, 114, 101, 50, 74, 83, 40, 121, 44, 122, 44, 111, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 116,
+111, 114, 101, 50, 40, 121, 44, 122, 44, 111, 41, 59, 10, 125, 10, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76,
+111, 97, 100, 51, 74, 83, 40, 121, 44, 122, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76, 111, 97, 100, 51,
+40, 121, 44, 122, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 51, 74, 83,
+40, 121, 44, 122, 44, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37,
+70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 51, 40, 121, 44,
+122, 44, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 73, 110, 116, 51, 50, 120, 52, 76, 111, 97, 100, 49, 74, 83, 40, 121, 44,
+122, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50,
+120, 52, 76, 111, 97, 100, 49, 40, 121, 44, 122, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 83, 116, 111,
+114, 101, 49, 74, 83, 40, 121, 44, 122, 44, 111, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101,
+49, 40, 121, 44, 122, 44, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 76, 111, 97, 100, 50, 74, 83,
+40, 121, 44, 122, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110,
+116, 51, 50, 120, 52, 76, 111, 97, 100, 50, 40, 121, 44, 122, 41, 59, 10, 125,
+10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52,
+83, 116, 111, 114, 101, 50, 74, 83, 40, 121, 44, 122, 44, 111, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 83, 116, 111,
+114, 101, 50, 40, 121, 44, 122, 44, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 76, 111, 97, 100, 51,
+74, 83, 40, 121, 44, 122, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73,
+110, 116, 51, 50, 120, 52, 76, 111, 97, 100, 51, 40, 121, 44, 122, 41, 59, 10,
+125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120,
+52, 83, 116, 111, 114, 101, 51, 74, 83, 40, 121, 44, 122, 44, 111, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 83, 116,
+111, 114, 101, 51, 40, 121, 44, 122, 44, 111, 41, 59, 10, 125, 10, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 76, 111,
+97, 100, 49, 74, 83, 40, 121, 44, 122, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 76, 111, 97, 100, 49, 40, 121,
+44, 122, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85,
+105, 110, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 49, 74, 83, 40, 121, 44,
+122, 44, 111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110,
+116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 49, 40, 121, 44, 122, 44, 111, 41,
+59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110,
+116, 51, 50, 120, 52, 76, 111, 97, 100, 50, 74, 83, 40, 121, 44, 122, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52,
+76, 111, 97, 100, 50, 40, 121, 44, 122, 41, 59, 10, 125, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 83, 116, 111, 114,
+101, 50, 74, 83, 40, 121, 44, 122, 44, 111, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101,
+50, 40, 121, 44, 122, 44, 111, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52, 76, 111, 97, 100, 51, 74,
+83, 40, 121, 44, 122, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85,
+105, 110, 116, 51, 50, 120, 52, 76, 111, 97, 100, 51, 40, 121, 44, 122, 41, 59,
+10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51,
+50, 120, 52, 83, 116, 111, 114, 101, 51, 74, 83, 40, 121, 44, 122, 44, 111, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51, 50, 120,
+52, 83, 116, 111, 114, 101, 51, 40, 121, 44, 122, 44, 111, 41, 59, 10, 125, 10,
+10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 83, 112, 108, 97, 116, 40, 119, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 67, 114, 101, 97, 116, 101, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 40, 119, 44, 119, 44, 119, 44, 119, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 119,
+105, 122, 122, 108, 101, 74, 83, 40, 111, 44, 65, 44, 66, 44, 67, 44, 68, 41,
+123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 83, 119, 105, 122, 122, 108, 101, 40, 111, 44, 65, 44, 66, 44, 67, 44,
+68, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 83, 104, 117, 102, 102, 108, 101, 74, 83, 40,
+111, 44, 118, 44, 65, 44, 66, 44, 67, 44, 68, 41, 123, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 104, 117, 102,
+102, 108, 101, 40, 111, 44, 118, 44, 65, 44, 66, 44, 67, 44, 68, 41, 59, 10,
+125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50,
+120, 52, 83, 112, 108, 97, 116, 40, 119, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 67, 114, 101, 97, 116, 101, 73, 110, 116, 51, 50, 120, 52, 40, 119,
+44, 119, 44, 119, 44, 119, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 83, 119, 105, 122, 122, 108, 101,
+74, 83, 40, 111, 44, 65, 44, 66, 44, 67, 44, 68, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 73, 110, 116, 51, 50, 120, 52, 83, 119, 105, 122, 122,
+108, 101, 40, 111, 44, 65, 44, 66, 44, 67, 44, 68, 41, 59, 10, 125, 10, 102,
+117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 83, 104,
+117, 102, 102, 108, 101, 74, 83, 40, 111, 44, 118, 44, 65, 44, 66, 44, 67, 44,
+68, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 51, 50,
+120, 52, 83, 104, 117, 102, 102, 108, 101, 40, 111, 44, 118, 44, 65, 44, 66, 44,
+67, 44, 68, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+85, 105, 110, 116, 51, 50, 120, 52, 83, 112, 108, 97, 116, 40, 119, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 67, 114, 101, 97, 116, 101, 85, 105, 110,
+116, 51, 50, 120, 52, 40, 119, 44, 119, 44, 119, 44, 119, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52,
+83, 119, 105, 122, 122, 108, 101, 74, 83, 40, 111, 44, 65, 44, 66, 44, 67, 44,
+68, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 51,
+50, 120, 52, 83, 119, 105, 122, 122, 108, 101, 40, 111, 44, 65, 44, 66, 44, 67,
+44, 68, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105,
+110, 116, 51, 50, 120, 52, 83, 104, 117, 102, 102, 108, 101, 74, 83, 40, 111,
+44, 118, 44, 65, 44, 66, 44, 67, 44, 68, 41, 123, 10, 114, 101, 116, 117, 114,
+110, 32, 37, 85, 105, 110, 116, 51, 50, 120, 52, 83, 104, 117, 102, 102, 108,
+101, 40, 111, 44, 118, 44, 65, 44, 66, 44, 67, 44, 68, 41, 59, 10, 125, 10, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 51, 50, 120, 52,
+83, 112, 108, 97, 116, 40, 119, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 67, 114, 101, 97, 116, 101, 66, 111, 111, 108, 51, 50, 120, 52, 40, 119, 44,
+119, 44, 119, 44, 119, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 66, 111, 111, 108, 51, 50, 120, 52, 83, 119, 105, 122, 122, 108, 101,
+74, 83, 40, 111, 44, 65, 44, 66, 44, 67, 44, 68, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 66, 111, 111, 108, 51, 50, 120, 52, 83, 119, 105, 122,
+122, 108, 101, 40, 111, 44, 65, 44, 66, 44, 67, 44, 68, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 51, 50, 120, 52,
+83, 104, 117, 102, 102, 108, 101, 74, 83, 40, 111, 44, 118, 44, 65, 44, 66, 44,
+67, 44, 68, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111,
+108, 51, 50, 120, 52, 83, 104, 117, 102, 102, 108, 101, 40, 111, 44, 118, 44,
+65, 44, 66, 44, 67, 44, 68, 41, 59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 83, 112, 108, 97, 116, 40,
+119, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 67, 114, 101, 97, 116,
+101, 73, 110, 116, 49, 54, 120, 56, 40, 119, 44, 119, 44, 119, 44, 119, 44, 119,
+44, 119, 44, 119, 44, 119, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 83, 119, 105, 122, 122, 108, 101,
+74, 83, 40, 111, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72,
+41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 49, 54, 120,
+56, 83, 119, 105, 122, 122, 108, 101, 40, 111, 44, 65, 44, 66, 44, 67, 44, 68,
+44, 69, 44, 70, 44, 71, 44, 72, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 83, 104, 117, 102, 102, 108,
+101, 74, 83, 40, 111, 44, 118, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70,
+44, 71, 44, 72, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116,
+49, 54, 120, 56, 83, 104, 117, 102, 102, 108, 101, 40, 111, 44, 118, 44, 65, 44,
+66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 41, 59, 10, 125, 10, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56,
+83, 112, 108, 97, 116, 40, 119, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 67, 114, 101, 97, 116, 101, 85, 105, 110, 116, 49, 54, 120, 56, 40, 119, 44,
+119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56,
+83, 119, 105, 122, 122, 108, 101, 74, 83, 40, 111, 44, 65, 44, 66, 44, 67, 44,
+68, 44, 69, 44, 70, 44, 71, 44, 72, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 83, 119, 105, 122, 122, 108, 101,
+40, 111, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 41, 59,
+10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 49,
+54, 120, 56, 83, 104, 117, 102, 102, 108, 101, 74, 83, 40, 111, 44, 118, 44, 65,
+44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 49, 54, 120, 56, 83, 104, 117,
+102, 102, 108, 101, 40, 111, 44, 118, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69,
+44, 70, 44, 71, 44, 72, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 66, 111, 111, 108, 49, 54, 120, 56, 83, 112, 108, 97, 116, 40,
+119, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 67, 114, 101, 97, 116,
+101, 66, 111, 111, 108, 49, 54, 120, 56, 40, 119, 44, 119, 44, 119, 44, 119, 44,
+119, 44, 119, 44, 119, 44, 119, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 66, 111, 111, 108, 49, 54, 120, 56, 83, 119, 105, 122, 122,
+108, 101, 74, 83, 40, 111, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44,
+71, 44, 72, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111,
+108, 49, 54, 120, 56, 83, 119, 105, 122, 122, 108, 101, 40, 111, 44, 65, 44, 66,
+44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 49, 54, 120, 56, 83, 104,
+117, 102, 102, 108, 101, 74, 83, 40, 111, 44, 118, 44, 65, 44, 66, 44, 67, 44,
+68, 44, 69, 44, 70, 44, 71, 44, 72, 41, 123, 10, 114, 101, 116, 117, 114, 110,
+32, 37, 66, 111, 111, 108, 49, 54, 120, 56, 83, 104, 117, 102, 102, 108, 101,
+40, 111, 44, 118, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44,
+72, 41, 59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73,
+110, 116, 56, 120, 49, 54, 83, 112, 108, 97, 116, 40, 119, 41, 123, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 67, 114, 101, 97, 116, 101, 73, 110, 116, 56,
+120, 49, 54, 40, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44,
+119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 41,
+59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56,
+120, 49, 54, 83, 119, 105, 122, 122, 108, 101, 74, 83, 40, 111, 44, 65, 44, 66,
+44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56, 44, 99, 57, 44, 99,
+49, 48, 44, 99, 49, 49, 44, 10, 99, 49, 50, 44, 99, 49, 51, 44, 99, 49, 52, 44,
+99, 49, 53, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 73, 110, 116, 56,
+120, 49, 54, 83, 119, 105, 122, 122, 108, 101, 40, 111, 44, 65, 44, 66, 44, 67,
+44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56, 44, 99, 57, 44, 99, 49, 48,
+44, 99, 49, 49, 44, 10, 99, 49, 50, 44, 99, 49, 51, 44, 99, 49, 52, 44, 99, 49,
+53, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110,
+116, 56, 120, 49, 54, 83, 104, 117, 102, 102, 108, 101, 74, 83, 40, 111, 44,
+118, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56,
+44, 99, 57, 44, 99, 49, 48, 44, 10, 99, 49, 49, 44, 99, 49, 50, 44, 99, 49, 51,
+44, 99, 49, 52, 44, 99, 49, 53, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 73, 110, 116, 56, 120, 49, 54, 83, 104, 117, 102, 102, 108, 101, 40, 111,
+44, 118, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99,
+56, 44, 99, 57, 44, 99, 49, 48, 44, 10, 99, 49, 49, 44, 99, 49, 50, 44, 99, 49,
+51, 44, 99, 49, 52, 44, 99, 49, 53, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 83, 112, 108, 97,
+116, 40, 119, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 67, 114, 101,
+97, 116, 101, 85, 105, 110, 116, 56, 120, 49, 54, 40, 119, 44, 119, 44, 119, 44,
+119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44,
+119, 44, 119, 44, 119, 44, 119, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 83, 119, 105, 122, 122,
+108, 101, 74, 83, 40, 111, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44,
+71, 44, 72, 44, 99, 56, 44, 99, 57, 44, 99, 49, 48, 44, 99, 49, 49, 44, 10, 99,
+49, 50, 44, 99, 49, 51, 44, 99, 49, 52, 44, 99, 49, 53, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 85, 105, 110, 116, 56, 120, 49, 54, 83, 119, 105,
+122, 122, 108, 101, 40, 111, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44,
+71, 44, 72, 44, 99, 56, 44, 99, 57, 44, 99, 49, 48, 44, 99, 49, 49, 44, 10, 99,
+49, 50, 44, 99, 49, 51, 44, 99, 49, 52, 44, 99, 49, 53, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54,
+83, 104, 117, 102, 102, 108, 101, 74, 83, 40, 111, 44, 118, 44, 65, 44, 66, 44,
+67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56, 44, 99, 57, 44, 99, 49,
+48, 44, 10, 99, 49, 49, 44, 99, 49, 50, 44, 99, 49, 51, 44, 99, 49, 52, 44, 99,
+49, 53, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 85, 105, 110, 116,
+56, 120, 49, 54, 83, 104, 117, 102, 102, 108, 101, 40, 111, 44, 118, 44, 65, 44,
+66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56, 44, 99, 57, 44,
+99, 49, 48, 44, 10, 99, 49, 49, 44, 99, 49, 50, 44, 99, 49, 51, 44, 99, 49, 52,
+44, 99, 49, 53, 41, 59, 10, 125, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 66, 111, 111, 108, 56, 120, 49, 54, 83, 112, 108, 97, 116, 40, 119, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 67, 114, 101, 97, 116, 101, 66, 111,
+111, 108, 56, 120, 49, 54, 40, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119,
+44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119, 44, 119,
+44, 119, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66,
+111, 111, 108, 56, 120, 49, 54, 83, 119, 105, 122, 122, 108, 101, 74, 83, 40,
+111, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56,
+44, 99, 57, 44, 99, 49, 48, 44, 99, 49, 49, 44, 10, 99, 49, 50, 44, 99, 49, 51,
+44, 99, 49, 52, 44, 99, 49, 53, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 66, 111, 111, 108, 56, 120, 49, 54, 83, 119, 105, 122, 122, 108, 101, 40,
+111, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56,
+44, 99, 57, 44, 99, 49, 48, 44, 99, 49, 49, 44, 10, 99, 49, 50, 44, 99, 49, 51,
+44, 99, 49, 52, 44, 99, 49, 53, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 66, 111, 111, 108, 56, 120, 49, 54, 83, 104, 117, 102, 102,
+108, 101, 74, 83, 40, 111, 44, 118, 44, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44,
+70, 44, 71, 44, 72, 44, 99, 56, 44, 99, 57, 44, 99, 49, 48, 44, 10, 99, 49, 49,
+44, 99, 49, 50, 44, 99, 49, 51, 44, 99, 49, 52, 44, 99, 49, 53, 41, 123, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 66, 111, 111, 108, 56, 120, 49, 54, 83,
+104, 117, 102, 102, 108, 101, 40, 111, 44, 118, 44, 65, 44, 66, 44, 67, 44, 68,
+44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56, 44, 99, 57, 44, 99, 49, 48, 44, 10,
+99, 49, 49, 44, 99, 49, 50, 44, 99, 49, 51, 44, 99, 49, 52, 44, 99, 49, 53, 41,
+59, 10, 125, 10, 10, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 67, 111, 110, 115, 116, 114, 117, 99, 116, 111,
+114, 40, 65, 44, 66, 44, 67, 44, 68, 41, 123, 10, 105, 102, 40, 33, 40, 110,
+101, 119, 46, 116, 97, 114, 103, 101, 116, 61, 61, 61, 40, 118, 111, 105, 100,
+32, 48, 41, 41, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101,
+95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 54, 54, 44, 34, 70,
+108, 111, 97, 116, 51, 50, 120, 52, 34, 41, 59, 10, 125, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 67, 114, 101, 97, 116, 101, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 40, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 65, 41, 41,
+44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 66, 41, 41, 44, 10, 40,
+37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 67, 41, 41, 44, 40, 37, 95, 84,
+111, 78, 117, 109, 98, 101, 114, 40, 68, 41, 41, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 51, 50, 120, 52, 67, 111, 110,
+115, 116, 114, 117, 99, 116, 111, 114, 40, 65, 44, 66, 44, 67, 44, 68, 41, 123,
+10, 105, 102, 40, 33, 40, 110, 101, 119, 46, 116, 97, 114, 103, 101, 116, 61,
+61, 61, 40, 118, 111, 105, 100, 32, 48, 41, 41, 41, 123, 10, 116, 104, 114, 111,
+119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111,
+114, 40, 54, 54, 44, 34, 73, 110, 116, 51, 50, 120, 52, 34, 41, 59, 10, 125, 10,
+114, 101, 116, 117, 114, 110, 32, 37, 67, 114, 101, 97, 116, 101, 73, 110, 116,
+51, 50, 120, 52, 40, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 65,
+41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 66, 41, 41, 44,
+10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 67, 41, 41, 44, 40, 37,
+95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 68, 41, 41, 41, 59, 10, 125, 10,
+102, 117, 110, 99, 116, 105, 111, 110, 32, 85, 105, 110, 116, 51, 50, 120, 52,
+67, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 40, 65, 44, 66, 44, 67, 44,
+68, 41, 123, 10, 105, 102, 40, 33, 40, 110, 101, 119, 46, 116, 97, 114, 103,
+101, 116, 61, 61, 61, 40, 118, 111, 105, 100, 32, 48, 41, 41, 41, 123, 10, 116,
+104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101,
+114, 114, 111, 114, 40, 54, 54, 44, 34, 85, 105, 110, 116, 51, 50, 120, 52, 34,
+41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 37, 67, 114, 101, 97,
+116, 101, 85, 105, 110, 116, 51, 50, 120, 52, 40, 40, 37, 95, 84, 111, 78, 117,
+109, 98, 101, 114, 40, 65, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98,
+101, 114, 40, 66, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101,
+114, 40, 67, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40,
+68, 41, 41, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66,
+111, 111, 108, 51, 50, 120, 52, 67, 111, 110, 115, 116, 114, 117, 99, 116, 111,
+114, 40, 65, 44, 66, 44, 67, 44, 68, 41, 123, 10, 105, 102, 40, 33, 40, 110,
+101, 119, 46, 116, 97, 114, 103, 101, 116, 61, 61, 61, 40, 118, 111, 105, 100,
+32, 48, 41, 41, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101,
+95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 54, 54, 44, 34, 66,
+111, 111, 108, 51, 50, 120, 52, 34, 41, 59, 10, 125, 10, 114, 101, 116, 117,
+114, 110, 32, 37, 67, 114, 101, 97, 116, 101, 66, 111, 111, 108, 51, 50, 120,
+52, 40, 65, 44, 66, 44, 67, 44, 68, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 73, 110, 116, 49, 54, 120, 56, 67, 111, 110, 115, 116, 114,
+117, 99, 116, 111, 114, 40, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71,
+44, 72, 41, 123, 10, 105, 102, 40, 33, 40, 110, 101, 119, 46, 116, 97, 114, 103,
+101, 116, 61, 61, 61, 40, 118, 111, 105, 100, 32, 48, 41, 41, 41, 123, 10, 116,
+104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101,
+114, 114, 111, 114, 40, 54, 54, 44, 34, 73, 110, 116, 49, 54, 120, 56, 34, 41,
+59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 37, 67, 114, 101, 97, 116,
+101, 73, 110, 116, 49, 54, 120, 56, 40, 40, 37, 95, 84, 111, 78, 117, 109, 98,
+101, 114, 40, 65, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114,
+40, 66, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 67,
+41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 68, 41, 41, 44,
+10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 69, 41, 41, 44, 40, 37,
+95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 70, 41, 41, 44, 10, 40, 37, 95, 84,
+111, 78, 117, 109, 98, 101, 114, 40, 71, 41, 41, 44, 40, 37, 95, 84, 111, 78,
+117, 109, 98, 101, 114, 40, 72, 41, 41, 41, 59, 10, 125, 10, 102, 117, 110, 99,
+116, 105, 111, 110, 32, 85, 105, 110, 116, 49, 54, 120, 56, 67, 111, 110, 115,
+116, 114, 117, 99, 116, 111, 114, 40, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44,
+70, 44, 71, 44, 72, 41, 123, 10, 105, 102, 40, 33, 40, 110, 101, 119, 46, 116,
+97, 114, 103, 101, 116, 61, 61, 61, 40, 118, 111, 105, 100, 32, 48, 41, 41, 41,
+123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112,
+101, 95, 101, 114, 114, 111, 114, 40, 54, 54, 44, 34, 85, 105, 110, 116, 49, 54,
+120, 56, 34, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 37, 67, 114,
+101, 97, 116, 101, 85, 105, 110, 116, 49, 54, 120, 56, 40, 40, 37, 95, 84, 111,
+78, 117, 109, 98, 101, 114, 40, 65, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117,
+109, 98, 101, 114, 40, 66, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109,
+98, 101, 114, 40, 67, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101,
+114, 40, 68, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114,
+40, 69, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 70, 41,
+41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 71, 41, 41, 44,
+40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 72, 41, 41, 41, 59, 10,
+125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111, 111, 108, 49, 54,
+120, 56, 67, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 40, 65, 44, 66,
+44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 41, 123, 10, 105, 102, 40, 33,
+40, 110, 101, 119, 46, 116, 97, 114, 103, 101, 116, 61, 61, 61, 40, 118, 111,
+105, 100, 32, 48, 41, 41, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97,
+107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 54, 54, 44,
+34, 66, 111, 111, 108, 49, 54, 120, 56, 34, 41, 59, 10, 125, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 67, 114, 101, 97, 116, 101, 66, 111, 111, 108, 49, 54,
+120, 56, 40, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 41, 59,
+10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 73, 110, 116, 56, 120,
+49, 54, 67, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 40, 65, 44, 66, 44,
+67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56, 44, 99, 57, 44, 99, 49,
+48, 44, 99, 49, 49, 44, 10, 99, 49, 50, 44, 99, 49, 51, 44, 99, 49, 52, 44, 99,
+49, 53, 41, 123, 10, 105, 102, 40, 33, 40, 110, 101, 119, 46, 116, 97, 114, 103,
+101, 116, 61, 61, 61, 40, 118, 111, 105, 100, 32, 48, 41, 41, 41, 123, 10, 116,
+104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101,
+114, 114, 111, 114, 40, 54, 54, 44, 34, 73, 110, 116, 56, 120, 49, 54, 34, 41,
+59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32, 37, 67, 114, 101, 97, 116,
+101, 73, 110, 116, 56, 120, 49, 54, 40, 40, 37, 95, 84, 111, 78, 117, 109, 98,
+101, 114, 40, 65, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114,
+40, 66, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 67,
+41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 68, 41, 41, 44,
+10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 69, 41, 41, 44, 40, 37,
+95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 70, 41, 41, 44, 10, 40, 37, 95, 84,
+111, 78, 117, 109, 98, 101, 114, 40, 71, 41, 41, 44, 40, 37, 95, 84, 111, 78,
+117, 109, 98, 101, 114, 40, 72, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117,
+109, 98, 101, 114, 40, 99, 56, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109,
+98, 101, 114, 40, 99, 57, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98,
+101, 114, 40, 99, 49, 48, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98,
+101, 114, 40, 99, 49, 49, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98,
+101, 114, 40, 99, 49, 50, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98,
+101, 114, 40, 99, 49, 51, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98,
+101, 114, 40, 99, 49, 52, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98,
+101, 114, 40, 99, 49, 53, 41, 41, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116,
+105, 111, 110, 32, 85, 105, 110, 116, 56, 120, 49, 54, 67, 111, 110, 115, 116,
+114, 117, 99, 116, 111, 114, 40, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44,
+71, 44, 72, 44, 99, 56, 44, 99, 57, 44, 99, 49, 48, 44, 99, 49, 49, 44, 10, 99,
+49, 50, 44, 99, 49, 51, 44, 99, 49, 52, 44, 99, 49, 53, 41, 123, 10, 105, 102,
+40, 33, 40, 110, 101, 119, 46, 116, 97, 114, 103, 101, 116, 61, 61, 61, 40, 118,
+111, 105, 100, 32, 48, 41, 41, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37,
+109, 97, 107, 101, 95, 116, 121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 54,
+54, 44, 34, 85, 105, 110, 116, 56, 120, 49, 54, 34, 41, 59, 10, 125, 10, 114,
+101, 116, 117, 114, 110, 32, 37, 67, 114, 101, 97, 116, 101, 85, 105, 110, 116,
+56, 120, 49, 54, 40, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 65,
+41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 66, 41, 41, 44,
+10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 67, 41, 41, 44, 40, 37,
+95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 68, 41, 41, 44, 10, 40, 37, 95, 84,
+111, 78, 117, 109, 98, 101, 114, 40, 69, 41, 41, 44, 40, 37, 95, 84, 111, 78,
+117, 109, 98, 101, 114, 40, 70, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117,
+109, 98, 101, 114, 40, 71, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98,
+101, 114, 40, 72, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101,
+114, 40, 99, 56, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114,
+40, 99, 57, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40,
+99, 49, 48, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 99,
+49, 49, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 99,
+49, 50, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 99, 49,
+51, 41, 41, 44, 10, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 99, 49,
+52, 41, 41, 44, 40, 37, 95, 84, 111, 78, 117, 109, 98, 101, 114, 40, 99, 49, 53,
+41, 41, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32, 66, 111,
+111, 108, 56, 120, 49, 54, 67, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114,
+40, 65, 44, 66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56, 44,
+99, 57, 44, 99, 49, 48, 44, 99, 49, 49, 44, 10, 99, 49, 50, 44, 99, 49, 51, 44,
+99, 49, 52, 44, 99, 49, 53, 41, 123, 10, 105, 102, 40, 33, 40, 110, 101, 119,
+46, 116, 97, 114, 103, 101, 116, 61, 61, 61, 40, 118, 111, 105, 100, 32, 48, 41,
+41, 41, 123, 10, 116, 104, 114, 111, 119, 32, 37, 109, 97, 107, 101, 95, 116,
+121, 112, 101, 95, 101, 114, 114, 111, 114, 40, 54, 54, 44, 34, 66, 111, 111,
+108, 56, 120, 49, 54, 34, 41, 59, 10, 125, 10, 114, 101, 116, 117, 114, 110, 32,
+37, 67, 114, 101, 97, 116, 101, 66, 111, 111, 108, 56, 120, 49, 54, 40, 65, 44,
+66, 44, 67, 44, 68, 44, 69, 44, 70, 44, 71, 44, 72, 44, 99, 56, 44, 99, 57, 44,
+99, 49, 48, 44, 99, 49, 49, 44, 99, 49, 50, 44, 10, 99, 49, 51, 44, 99, 49, 52,
+44, 99, 49, 53, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110, 32,
+70, 108, 111, 97, 116, 51, 50, 120, 52, 65, 98, 115, 74, 83, 40, 111, 41, 123,
+10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120,
+52, 65, 98, 115, 40, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111,
+110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 113, 114, 116, 74, 83, 40,
+111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 83, 113, 114, 116, 40, 111, 41, 59, 10, 125, 10, 102, 117, 110,
+99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 82, 101, 99,
+105, 112, 65, 112, 112, 114, 111, 120, 74, 83, 40, 111, 41, 123, 10, 114, 101,
+116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 82, 101, 99,
+105, 112, 65, 112, 112, 114, 111, 120, 40, 111, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 82,
+101, 99, 105, 112, 83, 113, 114, 116, 65, 112, 112, 114, 111, 120, 74, 83, 40,
+111, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 82, 101, 99, 105, 112, 83, 113, 114, 116, 65, 112, 112, 114,
+111, 120, 40, 111, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105, 111, 110,
+32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 68, 105, 118, 74, 83, 40, 111, 44,
+118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 68, 105, 118, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117,
+110, 99, 116, 105, 111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 77,
+105, 110, 78, 117, 109, 74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116,
+117, 114, 110, 32, 37, 70, 108, 111, 97, 116, 51, 50, 120, 52, 77, 105, 110, 78,
+117, 109, 40, 111, 44, 118, 41, 59, 10, 125, 10, 102, 117, 110, 99, 116, 105,
+111, 110, 32, 70, 108, 111, 97, 116, 51, 50, 120, 52, 77, 97, 120, 78, 117, 109,
+74, 83, 40, 111, 44, 118, 41, 123, 10, 114, 101, 116, 117, 114, 110, 32, 37, 70,
+108, 111, 97, 116, 51, 50, 120, 52, 77, 97, 120, 78, 117, 109, 40, 111, 44, 118,
+41, 59, 10, 125, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100, 80, 114, 111, 112,
+101, 114, 116, 121, 40, 99, 44, 100, 44, 39, 83, 73, 77, 68, 39, 44, 49, 124,
+50, 41, 59, 10, 37, 83, 101, 116, 67, 111, 100, 101, 40, 101, 44, 70, 108, 111,
+97, 116, 51, 50, 120, 52, 67, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114,
+41, 59, 10, 37, 70, 117, 110, 99, 116, 105, 111, 110, 83, 101, 116, 80, 114,
+111, 116, 111, 116, 121, 112, 101, 40, 101, 44, 123, 125, 41, 59, 10, 37, 65,
+100, 100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40, 101,
+46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 39, 99, 111, 110, 115, 116,
+114, 117, 99, 116, 111, 114, 39, 44, 101, 44, 10, 50, 41, 59, 10, 37, 65, 100,
+100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40, 101, 46,
+112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 100, 44, 39, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 39, 44, 10, 50, 124, 49, 41, 59, 10, 98, 46, 73, 110, 115,
+116, 97, 108, 108, 70, 117, 110, 99, 116, 105, 111, 110, 115, 40, 101, 46, 112,
+114, 111, 116, 111, 116, 121, 112, 101, 44, 50, 44, 91, 10, 39, 116, 111, 76,
+111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 39, 44, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 84, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105,
+110, 103, 44, 10, 39, 116, 111, 83, 116, 114, 105, 110, 103, 39, 44, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 84, 111, 83, 116, 114, 105, 110, 103, 44, 10, 39,
+118, 97, 108, 117, 101, 79, 102, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52,
+86, 97, 108, 117, 101, 79, 102, 44, 10, 93, 41, 59, 10, 10, 10, 37, 83, 101,
+116, 67, 111, 100, 101, 40, 102, 44, 73, 110, 116, 51, 50, 120, 52, 67, 111,
+110, 115, 116, 114, 117, 99, 116, 111, 114, 41, 59, 10, 37, 70, 117, 110, 99,
+116, 105, 111, 110, 83, 101, 116, 80, 114, 111, 116, 111, 116, 121, 112, 101,
+40, 102, 44, 123, 125, 41, 59, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100, 80,
+114, 111, 112, 101, 114, 116, 121, 40, 102, 46, 112, 114, 111, 116, 111, 116,
+121, 112, 101, 44, 39, 99, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 39,
+44, 102, 44, 10, 50, 41, 59, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100, 80,
+114, 111, 112, 101, 114, 116, 121, 40, 102, 46, 112, 114, 111, 116, 111, 116,
+121, 112, 101, 44, 100, 44, 39, 73, 110, 116, 51, 50, 120, 52, 39, 44, 10, 50,
+124, 49, 41, 59, 10, 98, 46, 73, 110, 115, 116, 97, 108, 108, 70, 117, 110, 99,
+116, 105, 111, 110, 115, 40, 102, 46, 112, 114, 111, 116, 111, 116, 121, 112,
+101, 44, 50, 44, 91, 10, 39, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114,
+105, 110, 103, 39, 44, 73, 110, 116, 51, 50, 120, 52, 84, 111, 76, 111, 99, 97,
+108, 101, 83, 116, 114, 105, 110, 103, 44, 10, 39, 116, 111, 83, 116, 114, 105,
+110, 103, 39, 44, 73, 110, 116, 51, 50, 120, 52, 84, 111, 83, 116, 114, 105,
+110, 103, 44, 10, 39, 118, 97, 108, 117, 101, 79, 102, 39, 44, 73, 110, 116, 51,
+50, 120, 52, 86, 97, 108, 117, 101, 79, 102, 44, 10, 93, 41, 59, 10, 10, 37, 83,
+101, 116, 67, 111, 100, 101, 40, 103, 44, 73, 110, 116, 49, 54, 120, 56, 67,
+111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 41, 59, 10, 37, 70, 117, 110,
+99, 116, 105, 111, 110, 83, 101, 116, 80, 114, 111, 116, 111, 116, 121, 112,
+101, 40, 103, 44, 123, 125, 41, 59, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100,
+80, 114, 111, 112, 101, 114, 116, 121, 40, 103, 46, 112, 114, 111, 116, 111,
+116, 121, 112, 101, 44, 39, 99, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114,
+39, 44, 103, 44, 10, 50, 41, 59, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100,
+80, 114, 111, 112, 101, 114, 116, 121, 40, 103, 46, 112, 114, 111, 116, 111,
+116, 121, 112, 101, 44, 100, 44, 39, 73, 110, 116, 49, 54, 120, 56, 39, 44, 10,
+50, 124, 49, 41, 59, 10, 98, 46, 73, 110, 115, 116, 97, 108, 108, 70, 117, 110,
+99, 116, 105, 111, 110, 115, 40, 103, 46, 112, 114, 111, 116, 111, 116, 121,
+112, 101, 44, 50, 44, 91, 10, 39, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116,
+114, 105, 110, 103, 39, 44, 73, 110, 116, 49, 54, 120, 56, 84, 111, 76, 111, 99,
+97, 108, 101, 83, 116, 114, 105, 110, 103, 44, 10, 39, 116, 111, 83, 116, 114,
+105, 110, 103, 39, 44, 73, 110, 116, 49, 54, 120, 56, 84, 111, 83, 116, 114,
+105, 110, 103, 44, 10, 39, 118, 97, 108, 117, 101, 79, 102, 39, 44, 73, 110,
+116, 49, 54, 120, 56, 86, 97, 108, 117, 101, 79, 102, 44, 10, 93, 41, 59, 10,
+10, 37, 83, 101, 116, 67, 111, 100, 101, 40, 104, 44, 73, 110, 116, 56, 120, 49,
+54, 67, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 41, 59, 10, 37, 70,
+117, 110, 99, 116, 105, 111, 110, 83, 101, 116, 80, 114, 111, 116, 111, 116,
+121, 112, 101, 40, 104, 44, 123, 125, 41, 59, 10, 37, 65, 100, 100, 78, 97, 109,
+101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40, 104, 46, 112, 114, 111,
+116, 111, 116, 121, 112, 101, 44, 39, 99, 111, 110, 115, 116, 114, 117, 99, 116,
+111, 114, 39, 44, 104, 44, 10, 50, 41, 59, 10, 37, 65, 100, 100, 78, 97, 109,
+101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40, 104, 46, 112, 114, 111,
+116, 111, 116, 121, 112, 101, 44, 100, 44, 39, 73, 110, 116, 56, 120, 49, 54,
+39, 44, 10, 50, 124, 49, 41, 59, 10, 98, 46, 73, 110, 115, 116, 97, 108, 108,
+70, 117, 110, 99, 116, 105, 111, 110, 115, 40, 104, 46, 112, 114, 111, 116, 111,
+116, 121, 112, 101, 44, 50, 44, 91, 10, 39, 116, 111, 76, 111, 99, 97, 108, 101,
+83, 116, 114, 105, 110, 103, 39, 44, 73, 110, 116, 56, 120, 49, 54, 84, 111, 76,
+111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 44, 10, 39, 116, 111, 83,
+116, 114, 105, 110, 103, 39, 44, 73, 110, 116, 56, 120, 49, 54, 84, 111, 83,
+116, 114, 105, 110, 103, 44, 10, 39, 118, 97, 108, 117, 101, 79, 102, 39, 44,
+73, 110, 116, 56, 120, 49, 54, 86, 97, 108, 117, 101, 79, 102, 44, 10, 93, 41,
+59, 10, 10, 10, 37, 83, 101, 116, 67, 111, 100, 101, 40, 105, 44, 85, 105, 110,
+116, 51, 50, 120, 52, 67, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 41,
+59, 10, 37, 70, 117, 110, 99, 116, 105, 111, 110, 83, 101, 116, 80, 114, 111,
+116, 111, 116, 121, 112, 101, 40, 105, 44, 123, 125, 41, 59, 10, 37, 65, 100,
+100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40, 105, 46,
+112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 39, 99, 111, 110, 115, 116,
+114, 117, 99, 116, 111, 114, 39, 44, 105, 44, 10, 50, 41, 59, 10, 37, 65, 100,
+100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40, 105, 46,
+112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 100, 44, 39, 85, 105, 110, 116,
+51, 50, 120, 52, 39, 44, 10, 50, 124, 49, 41, 59, 10, 98, 46, 73, 110, 115, 116,
+97, 108, 108, 70, 117, 110, 99, 116, 105, 111, 110, 115, 40, 105, 46, 112, 114,
+111, 116, 111, 116, 121, 112, 101, 44, 50, 44, 91, 10, 39, 116, 111, 76, 111,
+99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 39, 44, 85, 105, 110, 116, 51,
+50, 120, 52, 84, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103,
+44, 10, 39, 116, 111, 83, 116, 114, 105, 110, 103, 39, 44, 85, 105, 110, 116,
+51, 50, 120, 52, 84, 111, 83, 116, 114, 105, 110, 103, 44, 10, 39, 118, 97, 108,
+117, 101, 79, 102, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 86, 97, 108, 117,
+101, 79, 102, 44, 10, 93, 41, 59, 10, 10, 37, 83, 101, 116, 67, 111, 100, 101,
+40, 106, 44, 85, 105, 110, 116, 49, 54, 120, 56, 67, 111, 110, 115, 116, 114,
+117, 99, 116, 111, 114, 41, 59, 10, 37, 70, 117, 110, 99, 116, 105, 111, 110,
+83, 101, 116, 80, 114, 111, 116, 111, 116, 121, 112, 101, 40, 106, 44, 123, 125,
+41, 59, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101,
+114, 116, 121, 40, 106, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 39,
+99, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 39, 44, 106, 44, 10, 50,
+41, 59, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101,
+114, 116, 121, 40, 106, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44,
+100, 44, 39, 85, 105, 110, 116, 49, 54, 120, 56, 39, 44, 10, 50, 124, 49, 41,
+59, 10, 98, 46, 73, 110, 115, 116, 97, 108, 108, 70, 117, 110, 99, 116, 105,
+111, 110, 115, 40, 106, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 50,
+44, 91, 10, 39, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110,
+103, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 84, 111, 76, 111, 99, 97, 108,
+101, 83, 116, 114, 105, 110, 103, 44, 10, 39, 116, 111, 83, 116, 114, 105, 110,
+103, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 84, 111, 83, 116, 114, 105,
+110, 103, 44, 10, 39, 118, 97, 108, 117, 101, 79, 102, 39, 44, 85, 105, 110,
+116, 49, 54, 120, 56, 86, 97, 108, 117, 101, 79, 102, 44, 10, 93, 41, 59, 10,
+10, 37, 83, 101, 116, 67, 111, 100, 101, 40, 107, 44, 85, 105, 110, 116, 56,
+120, 49, 54, 67, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 41, 59, 10,
+37, 70, 117, 110, 99, 116, 105, 111, 110, 83, 101, 116, 80, 114, 111, 116, 111,
+116, 121, 112, 101, 40, 107, 44, 123, 125, 41, 59, 10, 37, 65, 100, 100, 78, 97,
+109, 101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40, 107, 46, 112, 114,
+111, 116, 111, 116, 121, 112, 101, 44, 39, 99, 111, 110, 115, 116, 114, 117, 99,
+116, 111, 114, 39, 44, 107, 44, 10, 50, 41, 59, 10, 37, 65, 100, 100, 78, 97,
+109, 101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40, 107, 46, 112, 114,
+111, 116, 111, 116, 121, 112, 101, 44, 100, 44, 39, 85, 105, 110, 116, 56, 120,
+49, 54, 39, 44, 10, 50, 124, 49, 41, 59, 10, 98, 46, 73, 110, 115, 116, 97, 108,
+108, 70, 117, 110, 99, 116, 105, 111, 110, 115, 40, 107, 46, 112, 114, 111, 116,
+111, 116, 121, 112, 101, 44, 50, 44, 91, 10, 39, 116, 111, 76, 111, 99, 97, 108,
+101, 83, 116, 114, 105, 110, 103, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54,
+84, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 44, 10, 39,
+116, 111, 83, 116, 114, 105, 110, 103, 39, 44, 85, 105, 110, 116, 56, 120, 49,
+54, 84, 111, 83, 116, 114, 105, 110, 103, 44, 10, 39, 118, 97, 108, 117, 101,
+79, 102, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 86, 97, 108, 117, 101, 79,
+102, 44, 10, 93, 41, 59, 10, 10, 10, 37, 83, 101, 116, 67, 111, 100, 101, 40,
+108, 44, 66, 111, 111, 108, 51, 50, 120, 52, 67, 111, 110, 115, 116, 114, 117,
+99, 116, 111, 114, 41, 59, 10, 37, 70, 117, 110, 99, 116, 105, 111, 110, 83,
+101, 116, 80, 114, 111, 116, 111, 116, 121, 112, 101, 40, 108, 44, 123, 125, 41,
+59, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101, 114,
+116, 121, 40, 108, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 39, 99,
+111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 39, 44, 108, 44, 10, 50, 41,
+59, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101, 114,
+116, 121, 40, 108, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 100, 44,
+39, 66, 111, 111, 108, 51, 50, 120, 52, 39, 44, 10, 50, 124, 49, 41, 59, 10, 98,
+46, 73, 110, 115, 116, 97, 108, 108, 70, 117, 110, 99, 116, 105, 111, 110, 115,
+40, 108, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 50, 44, 91, 10,
+39, 116, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 39, 44,
+66, 111, 111, 108, 51, 50, 120, 52, 84, 111, 76, 111, 99, 97, 108, 101, 83, 116,
+114, 105, 110, 103, 44, 10, 39, 116, 111, 83, 116, 114, 105, 110, 103, 39, 44,
+66, 111, 111, 108, 51, 50, 120, 52, 84, 111, 83, 116, 114, 105, 110, 103, 44,
+10, 39, 118, 97, 108, 117, 101, 79, 102, 39, 44, 66, 111, 111, 108, 51, 50, 120,
+52, 86, 97, 108, 117, 101, 79, 102, 44, 10, 93, 41, 59, 10, 10, 37, 83, 101,
+116, 67, 111, 100, 101, 40, 109, 44, 66, 111, 111, 108, 49, 54, 120, 56, 67,
+111, 110, 115, 116, 114, 117, 99, 116, 111, 114, 41, 59, 10, 37, 70, 117, 110,
+99, 116, 105, 111, 110, 83, 101, 116, 80, 114, 111, 116, 111, 116, 121, 112,
+101, 40, 109, 44, 123, 125, 41, 59, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100,
+80, 114, 111, 112, 101, 114, 116, 121, 40, 109, 46, 112, 114, 111, 116, 111,
+116, 121, 112, 101, 44, 39, 99, 111, 110, 115, 116, 114, 117, 99, 116, 111, 114,
+39, 44, 109, 44, 10, 50, 41, 59, 10, 37, 65, 100, 100, 78, 97, 109, 101, 100,
+80, 114, 111, 112, 101, 114, 116, 121, 40, 109, 46, 112, 114, 111, 116, 111,
+116, 121, 112, 101, 44, 100, 44, 39, 66, 111, 111, 108, 49, 54, 120, 56, 39, 44,
+10, 50, 124, 49, 41, 59, 10, 98, 46, 73, 110, 115, 116, 97, 108, 108, 70, 117,
+110, 99, 116, 105, 111, 110, 115, 40, 109, 46, 112, 114, 111, 116, 111, 116,
+121, 112, 101, 44, 50, 44, 91, 10, 39, 116, 111, 76, 111, 99, 97, 108, 101, 83,
+116, 114, 105, 110, 103, 39, 44, 66, 111, 111, 108, 49, 54, 120, 56, 84, 111,
+76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 44, 10, 39, 116, 111,
+83, 116, 114, 105, 110, 103, 39, 44, 66, 111, 111, 108, 49, 54, 120, 56, 84,
+111, 83, 116, 114, 105, 110, 103, 44, 10, 39, 118, 97, 108, 117, 101, 79, 102,
+39, 44, 66, 111, 111, 108, 49, 54, 120, 56, 86, 97, 108, 117, 101, 79, 102, 44,
+10, 93, 41, 59, 10, 10, 37, 83, 101, 116, 67, 111, 100, 101, 40, 110, 44, 66,
+111, 111, 108, 56, 120, 49, 54, 67, 111, 110, 115, 116, 114, 117, 99, 116, 111,
+114, 41, 59, 10, 37, 70, 117, 110, 99, 116, 105, 111, 110, 83, 101, 116, 80,
+114, 111, 116, 111, 116, 121, 112, 101, 40, 110, 44, 123, 125, 41, 59, 10, 37,
+65, 100, 100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40,
+110, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 39, 99, 111, 110, 115,
+116, 114, 117, 99, 116, 111, 114, 39, 44, 110, 44, 10, 50, 41, 59, 10, 37, 65,
+100, 100, 78, 97, 109, 101, 100, 80, 114, 111, 112, 101, 114, 116, 121, 40, 110,
+46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 100, 44, 39, 66, 111, 111,
+108, 56, 120, 49, 54, 39, 44, 10, 50, 124, 49, 41, 59, 10, 98, 46, 73, 110, 115,
+116, 97, 108, 108, 70, 117, 110, 99, 116, 105, 111, 110, 115, 40, 110, 46, 112,
+114, 111, 116, 111, 116, 121, 112, 101, 44, 50, 44, 91, 10, 39, 116, 111, 76,
+111, 99, 97, 108, 101, 83, 116, 114, 105, 110, 103, 39, 44, 66, 111, 111, 108,
+56, 120, 49, 54, 84, 111, 76, 111, 99, 97, 108, 101, 83, 116, 114, 105, 110,
+103, 44, 10, 39, 116, 111, 83, 116, 114, 105, 110, 103, 39, 44, 66, 111, 111,
+108, 56, 120, 49, 54, 84, 111, 83, 116, 114, 105, 110, 103, 44, 10, 39, 118, 97,
+108, 117, 101, 79, 102, 39, 44, 66, 111, 111, 108, 56, 120, 49, 54, 86, 97, 108,
+117, 101, 79, 102, 44, 10, 93, 41, 59, 10, 10, 10, 10, 98, 46, 73, 110, 115,
+116, 97, 108, 108, 70, 117, 110, 99, 116, 105, 111, 110, 115, 40, 101, 44, 50,
+44, 91, 10, 39, 115, 112, 108, 97, 116, 39, 44, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 83, 112, 108, 97, 116, 44, 10, 39, 99, 104, 101, 99, 107, 39, 44, 70,
+108, 111, 97, 116, 51, 50, 120, 52, 67, 104, 101, 99, 107, 74, 83, 44, 10, 39,
+101, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 39, 44, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83,
+44, 10, 39, 114, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 39, 44, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101,
+74, 83, 44, 10, 39, 110, 101, 103, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120,
+52, 78, 101, 103, 74, 83, 44, 10, 39, 97, 98, 115, 39, 44, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 65, 98, 115, 74, 83, 44, 10, 39, 115, 113, 114, 116, 39,
+44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 113, 114, 116, 74, 83, 44, 10,
+39, 114, 101, 99, 105, 112, 114, 111, 99, 97, 108, 65, 112, 112, 114, 111, 120,
+105, 109, 97, 116, 105, 111, 110, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120,
+52, 82, 101, 99, 105, 112, 65, 112, 112, 114, 111, 120, 74, 83, 44, 10, 39, 114,
+101, 99, 105, 112, 114, 111, 99, 97, 108, 83, 113, 114, 116, 65, 112, 112, 114,
+111, 120, 105, 109, 97, 116, 105, 111, 110, 39, 44, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 82, 101, 99, 105, 112, 83, 113, 114, 116, 65, 112, 112, 114, 111,
+120, 74, 83, 44, 10, 39, 97, 100, 100, 39, 44, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 65, 100, 100, 74, 83, 44, 10, 39, 115, 117, 98, 39, 44, 70, 108, 111,
+97, 116, 51, 50, 120, 52, 83, 117, 98, 74, 83, 44, 10, 39, 109, 117, 108, 39,
+44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 77, 117, 108, 74, 83, 44, 10, 39,
+100, 105, 118, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 68, 105, 118, 74,
+83, 44, 10, 39, 109, 105, 110, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52,
+77, 105, 110, 74, 83, 44, 10, 39, 109, 97, 120, 39, 44, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 77, 97, 120, 74, 83, 44, 10, 39, 109, 105, 110, 78, 117, 109,
+39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 77, 105, 110, 78, 117, 109, 74,
+83, 44, 10, 39, 109, 97, 120, 78, 117, 109, 39, 44, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 77, 97, 120, 78, 117, 109, 74, 83, 44, 10, 39, 108, 101, 115, 115,
+84, 104, 97, 110, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76, 101, 115,
+115, 84, 104, 97, 110, 74, 83, 44, 10, 39, 108, 101, 115, 115, 84, 104, 97, 110,
+79, 114, 69, 113, 117, 97, 108, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52,
+76, 101, 115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 44,
+10, 39, 103, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 39, 44, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97,
+110, 74, 83, 44, 10, 39, 103, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79,
+114, 69, 113, 117, 97, 108, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 71,
+114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108,
+74, 83, 44, 10, 39, 101, 113, 117, 97, 108, 39, 44, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39, 110, 111, 116, 69, 113,
+117, 97, 108, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 78, 111, 116, 69,
+113, 117, 97, 108, 74, 83, 44, 10, 39, 115, 101, 108, 101, 99, 116, 39, 44, 70,
+108, 111, 97, 116, 51, 50, 120, 52, 83, 101, 108, 101, 99, 116, 74, 83, 44, 10,
+39, 115, 119, 105, 122, 122, 108, 101, 39, 44, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 83, 119, 105, 122, 122, 108, 101, 74, 83, 44, 10, 39, 115, 104, 117,
+102, 102, 108, 101, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 104,
+117, 102, 102, 108, 101, 74, 83, 44, 10, 39, 102, 114, 111, 109, 73, 110, 116,
+51, 50, 120, 52, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111,
+109, 73, 110, 116, 51, 50, 120, 52, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85,
+105, 110, 116, 51, 50, 120, 52, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52,
+70, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 74, 83, 44, 10, 39, 102,
+114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 39, 44, 70,
+108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 51, 50,
+120, 52, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85, 105,
+110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 39, 44, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 70, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 66, 105,
+116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56,
+66, 105, 116, 115, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111,
+109, 73, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102,
+114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 39, 44,
+70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111, 109, 85, 105, 110, 116,
+49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 73,
+110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 39, 44, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116,
+115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54,
+66, 105, 116, 115, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 70, 114, 111,
+109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 74, 83, 44, 10, 39,
+108, 111, 97, 100, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76, 111, 97,
+100, 74, 83, 44, 10, 39, 108, 111, 97, 100, 49, 39, 44, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 76, 111, 97, 100, 49, 74, 83, 44, 10, 39, 108, 111, 97, 100,
+50, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 76, 111, 97, 100, 50, 74,
+83, 44, 10, 39, 108, 111, 97, 100, 51, 39, 44, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 76, 111, 97, 100, 51, 74, 83, 44, 10, 39, 115, 116, 111, 114, 101, 39,
+44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 74, 83, 44,
+10, 39, 115, 116, 111, 114, 101, 49, 39, 44, 70, 108, 111, 97, 116, 51, 50, 120,
+52, 83, 116, 111, 114, 101, 49, 74, 83, 44, 10, 39, 115, 116, 111, 114, 101, 50,
+39, 44, 70, 108, 111, 97, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 50, 74,
+83, 44, 10, 39, 115, 116, 111, 114, 101, 51, 39, 44, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 83, 116, 111, 114, 101, 51, 74, 83, 44, 10, 93, 41, 59, 10, 98, 46,
+73, 110, 115, 116, 97, 108, 108, 70, 117, 110, 99, 116, 105, 111, 110, 115, 40,
+102, 44, 50, 44, 91, 10, 39, 115, 112, 108, 97, 116, 39, 44, 73, 110, 116, 51,
+50, 120, 52, 83, 112, 108, 97, 116, 44, 10, 39, 99, 104, 101, 99, 107, 39, 44,
+73, 110, 116, 51, 50, 120, 52, 67, 104, 101, 99, 107, 74, 83, 44, 10, 39, 101,
+120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 39, 44, 73, 110, 116, 51, 50, 120,
+52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 44, 10, 39, 114,
+101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 39, 44, 73, 110, 116, 51, 50, 120,
+52, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83, 44, 10, 39, 110,
+101, 103, 39, 44, 73, 110, 116, 51, 50, 120, 52, 78, 101, 103, 74, 83, 44, 10,
+39, 97, 100, 100, 39, 44, 73, 110, 116, 51, 50, 120, 52, 65, 100, 100, 74, 83,
+44, 10, 39, 115, 117, 98, 39, 44, 73, 110, 116, 51, 50, 120, 52, 83, 117, 98,
+74, 83, 44, 10, 39, 109, 117, 108, 39, 44, 73, 110, 116, 51, 50, 120, 52, 77,
+117, 108, 74, 83, 44, 10, 39, 109, 105, 110, 39, 44, 73, 110, 116, 51, 50, 120,
+52, 77, 105, 110, 74, 83, 44, 10, 39, 109, 97, 120, 39, 44, 73, 110, 116, 51,
+50, 120, 52, 77, 97, 120, 74, 83, 44, 10, 39, 97, 110, 100, 39, 44, 73, 110,
+116, 51, 50, 120, 52, 65, 110, 100, 74, 83, 44, 10, 39, 111, 114, 39, 44, 73,
+110, 116, 51, 50, 120, 52, 79, 114, 74, 83, 44, 10, 39, 120, 111, 114, 39, 44,
+73, 110, 116, 51, 50, 120, 52, 88, 111, 114, 74, 83, 44, 10, 39, 110, 111, 116,
+39, 44, 73, 110, 116, 51, 50, 120, 52, 78, 111, 116, 74, 83, 44, 10, 39, 115,
+104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114, 39,
+44, 73, 110, 116, 51, 50, 120, 52, 83, 104, 105, 102, 116, 76, 101, 102, 116,
+66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 44, 10, 39, 115, 104, 105, 102, 116,
+82, 105, 103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 39, 44, 73, 110, 116,
+51, 50, 120, 52, 83, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66, 121, 83,
+99, 97, 108, 97, 114, 74, 83, 44, 10, 39, 108, 101, 115, 115, 84, 104, 97, 110,
+39, 44, 73, 110, 116, 51, 50, 120, 52, 76, 101, 115, 115, 84, 104, 97, 110, 74,
+83, 44, 10, 39, 108, 101, 115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97,
+108, 39, 44, 73, 110, 116, 51, 50, 120, 52, 76, 101, 115, 115, 84, 104, 97, 110,
+79, 114, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39, 103, 114, 101, 97, 116, 101,
+114, 84, 104, 97, 110, 39, 44, 73, 110, 116, 51, 50, 120, 52, 71, 114, 101, 97,
+116, 101, 114, 84, 104, 97, 110, 74, 83, 44, 10, 39, 103, 114, 101, 97, 116,
+101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 39, 44, 73, 110,
+116, 51, 50, 120, 52, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79,
+114, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39, 101, 113, 117, 97, 108, 39, 44,
+73, 110, 116, 51, 50, 120, 52, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39, 110,
+111, 116, 69, 113, 117, 97, 108, 39, 44, 73, 110, 116, 51, 50, 120, 52, 78, 111,
+116, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39, 115, 101, 108, 101, 99, 116, 39,
+44, 73, 110, 116, 51, 50, 120, 52, 83, 101, 108, 101, 99, 116, 74, 83, 44, 10,
+39, 115, 119, 105, 122, 122, 108, 101, 39, 44, 73, 110, 116, 51, 50, 120, 52,
+83, 119, 105, 122, 122, 108, 101, 74, 83, 44, 10, 39, 115, 104, 117, 102, 102,
+108, 101, 39, 44, 73, 110, 116, 51, 50, 120, 52, 83, 104, 117, 102, 102, 108,
+101, 74, 83, 44, 10, 39, 102, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120,
+52, 39, 44, 73, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85, 105, 110, 116,
+51, 50, 120, 52, 39, 44, 73, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 85,
+105, 110, 116, 51, 50, 120, 52, 74, 83, 44, 10, 39, 102, 114, 111, 109, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 66, 105, 116, 115, 39, 44, 73, 110, 116, 51, 50,
+120, 52, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105,
+116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85, 105, 110, 116, 51, 50,
+120, 52, 66, 105, 116, 115, 39, 44, 73, 110, 116, 51, 50, 120, 52, 70, 114, 111,
+109, 85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 44, 10, 39,
+102, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 39, 44,
+73, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56,
+66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85, 105, 110, 116,
+49, 54, 120, 56, 66, 105, 116, 115, 39, 44, 73, 110, 116, 51, 50, 120, 52, 70,
+114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74, 83,
+44, 10, 39, 102, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116,
+115, 39, 44, 73, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 56,
+120, 49, 54, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85, 105,
+110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 39, 44, 73, 110, 116, 51, 50, 120,
+52, 70, 114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115,
+74, 83, 44, 10, 39, 108, 111, 97, 100, 39, 44, 73, 110, 116, 51, 50, 120, 52,
+76, 111, 97, 100, 74, 83, 44, 10, 39, 108, 111, 97, 100, 49, 39, 44, 73, 110,
+116, 51, 50, 120, 52, 76, 111, 97, 100, 49, 74, 83, 44, 10, 39, 108, 111, 97,
+100, 50, 39, 44, 73, 110, 116, 51, 50, 120, 52, 76, 111, 97, 100, 50, 74, 83,
+44, 10, 39, 108, 111, 97, 100, 51, 39, 44, 73, 110, 116, 51, 50, 120, 52, 76,
+111, 97, 100, 51, 74, 83, 44, 10, 39, 115, 116, 111, 114, 101, 39, 44, 73, 110,
+116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 74, 83, 44, 10, 39, 115, 116, 111,
+114, 101, 49, 39, 44, 73, 110, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 49,
+74, 83, 44, 10, 39, 115, 116, 111, 114, 101, 50, 39, 44, 73, 110, 116, 51, 50,
+120, 52, 83, 116, 111, 114, 101, 50, 74, 83, 44, 10, 39, 115, 116, 111, 114,
+101, 51, 39, 44, 73, 110, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 51, 74,
+83, 44, 10, 93, 41, 59, 10, 98, 46, 73, 110, 115, 116, 97, 108, 108, 70, 117,
+110, 99, 116, 105, 111, 110, 115, 40, 105, 44, 50, 44, 91, 10, 39, 115, 112,
+108, 97, 116, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 83, 112, 108, 97, 116,
+44, 10, 39, 99, 104, 101, 99, 107, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52,
+67, 104, 101, 99, 107, 74, 83, 44, 10, 39, 101, 120, 116, 114, 97, 99, 116, 76,
+97, 110, 101, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 69, 120, 116, 114, 97,
+99, 116, 76, 97, 110, 101, 74, 83, 44, 10, 39, 114, 101, 112, 108, 97, 99, 101,
+76, 97, 110, 101, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 82, 101, 112, 108,
+97, 99, 101, 76, 97, 110, 101, 74, 83, 44, 10, 39, 97, 100, 100, 39, 44, 85,
+105, 110, 116, 51, 50, 120, 52, 65, 100, 100, 74, 83, 44, 10, 39, 115, 117, 98,
+39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 83, 117, 98, 74, 83, 44, 10, 39,
+109, 117, 108, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 77, 117, 108, 74, 83,
+44, 10, 39, 109, 105, 110, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 77, 105,
+110, 74, 83, 44, 10, 39, 109, 97, 120, 39, 44, 85, 105, 110, 116, 51, 50, 120,
+52, 77, 97, 120, 74, 83, 44, 10, 39, 97, 110, 100, 39, 44, 85, 105, 110, 116,
+51, 50, 120, 52, 65, 110, 100, 74, 83, 44, 10, 39, 111, 114, 39, 44, 85, 105,
+110, 116, 51, 50, 120, 52, 79, 114, 74, 83, 44, 10, 39, 120, 111, 114, 39, 44,
+85, 105, 110, 116, 51, 50, 120, 52, 88, 111, 114, 74, 83, 44, 10, 39, 110, 111,
+116, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 78, 111, 116, 74, 83, 44, 10,
+39, 115, 104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97,
+114, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 83, 104, 105, 102, 116, 76,
+101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 44, 10, 39, 115, 104,
+105, 102, 116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 39,
+44, 85, 105, 110, 116, 51, 50, 120, 52, 83, 104, 105, 102, 116, 82, 105, 103,
+104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 44, 10, 39, 108, 101, 115,
+115, 84, 104, 97, 110, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 76, 101, 115,
+115, 84, 104, 97, 110, 74, 83, 44, 10, 39, 108, 101, 115, 115, 84, 104, 97, 110,
+79, 114, 69, 113, 117, 97, 108, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 76,
+101, 115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 44, 10,
+39, 103, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 39, 44, 85, 105, 110,
+116, 51, 50, 120, 52, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 74, 83,
+44, 10, 39, 103, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79, 114, 69,
+113, 117, 97, 108, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 71, 114, 101, 97,
+116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 44, 10,
+39, 101, 113, 117, 97, 108, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 69, 113,
+117, 97, 108, 74, 83, 44, 10, 39, 110, 111, 116, 69, 113, 117, 97, 108, 39, 44,
+85, 105, 110, 116, 51, 50, 120, 52, 78, 111, 116, 69, 113, 117, 97, 108, 74, 83,
+44, 10, 39, 115, 101, 108, 101, 99, 116, 39, 44, 85, 105, 110, 116, 51, 50, 120,
+52, 83, 101, 108, 101, 99, 116, 74, 83, 44, 10, 39, 115, 119, 105, 122, 122,
+108, 101, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 83, 119, 105, 122, 122,
+108, 101, 74, 83, 44, 10, 39, 115, 104, 117, 102, 102, 108, 101, 39, 44, 85,
+105, 110, 116, 51, 50, 120, 52, 83, 104, 117, 102, 102, 108, 101, 74, 83, 44,
+10, 39, 102, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 39, 44, 85,
+105, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 74, 83, 44, 10, 39, 102, 114, 111, 109, 73, 110, 116, 51, 50, 120,
+52, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116,
+51, 50, 120, 52, 74, 83, 44, 10, 39, 102, 114, 111, 109, 70, 108, 111, 97, 116,
+51, 50, 120, 52, 66, 105, 116, 115, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52,
+70, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105, 116, 115,
+74, 83, 44, 10, 39, 102, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66, 105,
+116, 115, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73,
+110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111,
+109, 73, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 39, 44, 85, 105, 110,
+116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 66, 105,
+116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85, 105, 110, 116, 49, 54,
+120, 56, 66, 105, 116, 115, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 70, 114,
+111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 44, 10,
+39, 102, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 39,
+44, 85, 105, 110, 116, 51, 50, 120, 52, 70, 114, 111, 109, 73, 110, 116, 56,
+120, 49, 54, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85, 105,
+110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 39, 44, 85, 105, 110, 116, 51, 50,
+120, 52, 70, 114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105, 116,
+115, 74, 83, 44, 10, 39, 108, 111, 97, 100, 39, 44, 85, 105, 110, 116, 51, 50,
+120, 52, 76, 111, 97, 100, 74, 83, 44, 10, 39, 108, 111, 97, 100, 49, 39, 44,
+85, 105, 110, 116, 51, 50, 120, 52, 76, 111, 97, 100, 49, 74, 83, 44, 10, 39,
+108, 111, 97, 100, 50, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 76, 111, 97,
+100, 50, 74, 83, 44, 10, 39, 108, 111, 97, 100, 51, 39, 44, 85, 105, 110, 116,
+51, 50, 120, 52, 76, 111, 97, 100, 51, 74, 83, 44, 10, 39, 115, 116, 111, 114,
+101, 39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 74, 83,
+44, 10, 39, 115, 116, 111, 114, 101, 49, 39, 44, 85, 105, 110, 116, 51, 50, 120,
+52, 83, 116, 111, 114, 101, 49, 74, 83, 44, 10, 39, 115, 116, 111, 114, 101, 50,
+39, 44, 85, 105, 110, 116, 51, 50, 120, 52, 83, 116, 111, 114, 101, 50, 74, 83,
+44, 10, 39, 115, 116, 111, 114, 101, 51, 39, 44, 85, 105, 110, 116, 51, 50, 120,
+52, 83, 116, 111, 114, 101, 51, 74, 83, 44, 10, 93, 41, 59, 10, 98, 46, 73, 110,
+115, 116, 97, 108, 108, 70, 117, 110, 99, 116, 105, 111, 110, 115, 40, 108, 44,
+50, 44, 91, 10, 39, 115, 112, 108, 97, 116, 39, 44, 66, 111, 111, 108, 51, 50,
+120, 52, 83, 112, 108, 97, 116, 44, 10, 39, 99, 104, 101, 99, 107, 39, 44, 66,
+111, 111, 108, 51, 50, 120, 52, 67, 104, 101, 99, 107, 74, 83, 44, 10, 39, 101,
+120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 39, 44, 66, 111, 111, 108, 51, 50,
+120, 52, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 44, 10, 39,
+114, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 39, 44, 66, 111, 111, 108,
+51, 50, 120, 52, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83, 44,
+10, 39, 97, 110, 100, 39, 44, 66, 111, 111, 108, 51, 50, 120, 52, 65, 110, 100,
+74, 83, 44, 10, 39, 111, 114, 39, 44, 66, 111, 111, 108, 51, 50, 120, 52, 79,
+114, 74, 83, 44, 10, 39, 120, 111, 114, 39, 44, 66, 111, 111, 108, 51, 50, 120,
+52, 88, 111, 114, 74, 83, 44, 10, 39, 110, 111, 116, 39, 44, 66, 111, 111, 108,
+51, 50, 120, 52, 78, 111, 116, 74, 83, 44, 10, 39, 97, 110, 121, 84, 114, 117,
+101, 39, 44, 66, 111, 111, 108, 51, 50, 120, 52, 65, 110, 121, 84, 114, 117,
+101, 74, 83, 44, 10, 39, 97, 108, 108, 84, 114, 117, 101, 39, 44, 66, 111, 111,
+108, 51, 50, 120, 52, 65, 108, 108, 84, 114, 117, 101, 74, 83, 44, 10, 39, 115,
+119, 105, 122, 122, 108, 101, 39, 44, 66, 111, 111, 108, 51, 50, 120, 52, 83,
+119, 105, 122, 122, 108, 101, 74, 83, 44, 10, 39, 115, 104, 117, 102, 102, 108,
+101, 39, 44, 66, 111, 111, 108, 51, 50, 120, 52, 83, 104, 117, 102, 102, 108,
+101, 74, 83, 44, 10, 93, 41, 59, 10, 98, 46, 73, 110, 115, 116, 97, 108, 108,
+70, 117, 110, 99, 116, 105, 111, 110, 115, 40, 103, 44, 50, 44, 91, 10, 39, 115,
+112, 108, 97, 116, 39, 44, 73, 110, 116, 49, 54, 120, 56, 83, 112, 108, 97, 116,
+44, 10, 39, 99, 104, 101, 99, 107, 39, 44, 73, 110, 116, 49, 54, 120, 56, 67,
+104, 101, 99, 107, 74, 83, 44, 10, 39, 101, 120, 116, 114, 97, 99, 116, 76, 97,
+110, 101, 39, 44, 73, 110, 116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116,
+76, 97, 110, 101, 74, 83, 44, 10, 39, 114, 101, 112, 108, 97, 99, 101, 76, 97,
+110, 101, 39, 44, 73, 110, 116, 49, 54, 120, 56, 82, 101, 112, 108, 97, 99, 101,
+76, 97, 110, 101, 74, 83, 44, 10, 39, 110, 101, 103, 39, 44, 73, 110, 116, 49,
+54, 120, 56, 78, 101, 103, 74, 83, 44, 10, 39, 97, 100, 100, 39, 44, 73, 110,
+116, 49, 54, 120, 56, 65, 100, 100, 74, 83, 44, 10, 39, 115, 117, 98, 39, 44,
+73, 110, 116, 49, 54, 120, 56, 83, 117, 98, 74, 83, 44, 10, 39, 97, 100, 100,
+83, 97, 116, 117, 114, 97, 116, 101, 39, 44, 73, 110, 116, 49, 54, 120, 56, 65,
+100, 100, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 44, 10, 39, 115, 117, 98,
+83, 97, 116, 117, 114, 97, 116, 101, 39, 44, 73, 110, 116, 49, 54, 120, 56, 83,
+117, 98, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 44, 10, 39, 109, 117, 108,
+39, 44, 73, 110, 116, 49, 54, 120, 56, 77, 117, 108, 74, 83, 44, 10, 39, 109,
+105, 110, 39, 44, 73, 110, 116, 49, 54, 120, 56, 77, 105, 110, 74, 83, 44, 10,
+39, 109, 97, 120, 39, 44, 73, 110, 116, 49, 54, 120, 56, 77, 97, 120, 74, 83,
+44, 10, 39, 97, 110, 100, 39, 44, 73, 110, 116, 49, 54, 120, 56, 65, 110, 100,
+74, 83, 44, 10, 39, 111, 114, 39, 44, 73, 110, 116, 49, 54, 120, 56, 79, 114,
+74, 83, 44, 10, 39, 120, 111, 114, 39, 44, 73, 110, 116, 49, 54, 120, 56, 88,
+111, 114, 74, 83, 44, 10, 39, 110, 111, 116, 39, 44, 73, 110, 116, 49, 54, 120,
+56, 78, 111, 116, 74, 83, 44, 10, 39, 115, 104, 105, 102, 116, 76, 101, 102,
+116, 66, 121, 83, 99, 97, 108, 97, 114, 39, 44, 73, 110, 116, 49, 54, 120, 56,
+83, 104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114,
+74, 83, 44, 10, 39, 115, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66, 121,
+83, 99, 97, 108, 97, 114, 39, 44, 73, 110, 116, 49, 54, 120, 56, 83, 104, 105,
+102, 116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 44,
+10, 39, 108, 101, 115, 115, 84, 104, 97, 110, 39, 44, 73, 110, 116, 49, 54, 120,
+56, 76, 101, 115, 115, 84, 104, 97, 110, 74, 83, 44, 10, 39, 108, 101, 115, 115,
+84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 39, 44, 73, 110, 116, 49, 54,
+120, 56, 76, 101, 115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108,
+74, 83, 44, 10, 39, 103, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 39, 44,
+73, 110, 116, 49, 54, 120, 56, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97,
+110, 74, 83, 44, 10, 39, 103, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79,
+114, 69, 113, 117, 97, 108, 39, 44, 73, 110, 116, 49, 54, 120, 56, 71, 114, 101,
+97, 116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 44,
+10, 39, 101, 113, 117, 97, 108, 39, 44, 73, 110, 116, 49, 54, 120, 56, 69, 113,
+117, 97, 108, 74, 83, 44, 10, 39, 110, 111, 116, 69, 113, 117, 97, 108, 39, 44,
+73, 110, 116, 49, 54, 120, 56, 78, 111, 116, 69, 113, 117, 97, 108, 74, 83, 44,
+10, 39, 115, 101, 108, 101, 99, 116, 39, 44, 73, 110, 116, 49, 54, 120, 56, 83,
+101, 108, 101, 99, 116, 74, 83, 44, 10, 39, 115, 119, 105, 122, 122, 108, 101,
+39, 44, 73, 110, 116, 49, 54, 120, 56, 83, 119, 105, 122, 122, 108, 101, 74, 83,
+44, 10, 39, 115, 104, 117, 102, 102, 108, 101, 39, 44, 73, 110, 116, 49, 54,
+120, 56, 83, 104, 117, 102, 102, 108, 101, 74, 83, 44, 10, 39, 102, 114, 111,
+109, 85, 105, 110, 116, 49, 54, 120, 56, 39, 44, 73, 110, 116, 49, 54, 120, 56,
+70, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 74, 83, 44, 10, 39, 102,
+114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105, 116, 115, 39,
+44, 73, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51,
+50, 120, 52, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 73, 110,
+116, 51, 50, 120, 52, 66, 105, 116, 115, 39, 44, 73, 110, 116, 49, 54, 120, 56,
+70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 44,
+10, 39, 102, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116,
+115, 39, 44, 73, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 85, 105, 110,
+116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109,
+85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 39, 44, 73, 110, 116, 49,
+54, 120, 56, 70, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105,
+116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54,
+66, 105, 116, 115, 39, 44, 73, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 73,
+110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111,
+109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 39, 44, 73, 110,
+116, 49, 54, 120, 56, 70, 114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 66,
+105, 116, 115, 74, 83, 44, 10, 39, 108, 111, 97, 100, 39, 44, 73, 110, 116, 49,
+54, 120, 56, 76, 111, 97, 100, 74, 83, 44, 10, 39, 115, 116, 111, 114, 101, 39,
+44, 73, 110, 116, 49, 54, 120, 56, 83, 116, 111, 114, 101, 74, 83, 44, 10, 93,
+41, 59, 10, 98, 46, 73, 110, 115, 116, 97, 108, 108, 70, 117, 110, 99, 116, 105,
+111, 110, 115, 40, 106, 44, 50, 44, 91, 10, 39, 115, 112, 108, 97, 116, 39, 44,
+85, 105, 110, 116, 49, 54, 120, 56, 83, 112, 108, 97, 116, 44, 10, 39, 99, 104,
+101, 99, 107, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 67, 104, 101, 99, 107,
+74, 83, 44, 10, 39, 101, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 39, 44,
+85, 105, 110, 116, 49, 54, 120, 56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 74, 83, 44, 10, 39, 114, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 39,
+44, 85, 105, 110, 116, 49, 54, 120, 56, 82, 101, 112, 108, 97, 99, 101, 76, 97,
+110, 101, 74, 83, 44, 10, 39, 97, 100, 100, 39, 44, 85, 105, 110, 116, 49, 54,
+120, 56, 65, 100, 100, 74, 83, 44, 10, 39, 115, 117, 98, 39, 44, 85, 105, 110,
+116, 49, 54, 120, 56, 83, 117, 98, 74, 83, 44, 10, 39, 97, 100, 100, 83, 97,
+116, 117, 114, 97, 116, 101, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 65,
+100, 100, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 44, 10, 39, 115, 117, 98,
+83, 97, 116, 117, 114, 97, 116, 101, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56,
+83, 117, 98, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 44, 10, 39, 109, 117,
+108, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 77, 117, 108, 74, 83, 44, 10,
+39, 109, 105, 110, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 77, 105, 110, 74,
+83, 44, 10, 39, 109, 97, 120, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 77,
+97, 120, 74, 83, 44, 10, 39, 97, 110, 100, 39, 44, 85, 105, 110, 116, 49, 54,
+120, 56, 65, 110, 100, 74, 83, 44, 10, 39, 111, 114, 39, 44, 85, 105, 110, 116,
+49, 54, 120, 56, 79, 114, 74, 83, 44, 10, 39, 120, 111, 114, 39, 44, 85, 105,
+110, 116, 49, 54, 120, 56, 88, 111, 114, 74, 83, 44, 10, 39, 110, 111, 116, 39,
+44, 85, 105, 110, 116, 49, 54, 120, 56, 78, 111, 116, 74, 83, 44, 10, 39, 115,
+104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114, 39,
+44, 85, 105, 110, 116, 49, 54, 120, 56, 83, 104, 105, 102, 116, 76, 101, 102,
+116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 44, 10, 39, 115, 104, 105, 102,
+116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 39, 44, 85, 105,
+110, 116, 49, 54, 120, 56, 83, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66,
+121, 83, 99, 97, 108, 97, 114, 74, 83, 44, 10, 39, 108, 101, 115, 115, 84, 104,
+97, 110, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 76, 101, 115, 115, 84, 104,
+97, 110, 74, 83, 44, 10, 39, 108, 101, 115, 115, 84, 104, 97, 110, 79, 114, 69,
+113, 117, 97, 108, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 76, 101, 115,
+115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39, 103,
+114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 39, 44, 85, 105, 110, 116, 49,
+54, 120, 56, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 74, 83, 44, 10,
+39, 103, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117,
+97, 108, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 71, 114, 101, 97, 116, 101,
+114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39, 101,
+113, 117, 97, 108, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 69, 113, 117, 97,
+108, 74, 83, 44, 10, 39, 110, 111, 116, 69, 113, 117, 97, 108, 39, 44, 85, 105,
+110, 116, 49, 54, 120, 56, 78, 111, 116, 69, 113, 117, 97, 108, 74, 83, 44, 10,
+39, 115, 101, 108, 101, 99, 116, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 83,
+101, 108, 101, 99, 116, 74, 83, 44, 10, 39, 115, 119, 105, 122, 122, 108, 101,
+39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 83, 119, 105, 122, 122, 108, 101,
+74, 83, 44, 10, 39, 115, 104, 117, 102, 102, 108, 101, 39, 44, 85, 105, 110,
+116, 49, 54, 120, 56, 83, 104, 117, 102, 102, 108, 101, 74, 83, 44, 10, 39, 102,
+114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 39, 44, 85, 105, 110, 116, 49, 54,
+120, 56, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 74, 83, 44, 10, 39,
+102, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105, 116, 115,
+39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 70, 108, 111, 97,
+116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109,
+73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 39, 44, 85, 105, 110, 116, 49,
+54, 120, 56, 70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116,
+115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52,
+66, 105, 116, 115, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 70, 114, 111,
+109, 85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 44, 10, 39,
+102, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 39, 44,
+85, 105, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 73, 110, 116, 49, 54,
+120, 56, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 73, 110,
+116, 56, 120, 49, 54, 66, 105, 116, 115, 39, 44, 85, 105, 110, 116, 49, 54, 120,
+56, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 74, 83,
+44, 10, 39, 102, 114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105,
+116, 115, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 70, 114, 111, 109, 85,
+105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 74, 83, 44, 10, 39, 108, 111,
+97, 100, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56, 76, 111, 97, 100, 74, 83,
+44, 10, 39, 115, 116, 111, 114, 101, 39, 44, 85, 105, 110, 116, 49, 54, 120, 56,
+83, 116, 111, 114, 101, 74, 83, 44, 10, 93, 41, 59, 10, 98, 46, 73, 110, 115,
+116, 97, 108, 108, 70, 117, 110, 99, 116, 105, 111, 110, 115, 40, 109, 44, 50,
+44, 91, 10, 39, 115, 112, 108, 97, 116, 39, 44, 66, 111, 111, 108, 49, 54, 120,
+56, 83, 112, 108, 97, 116, 44, 10, 39, 99, 104, 101, 99, 107, 39, 44, 66, 111,
+111, 108, 49, 54, 120, 56, 67, 104, 101, 99, 107, 74, 83, 44, 10, 39, 101, 120,
+116, 114, 97, 99, 116, 76, 97, 110, 101, 39, 44, 66, 111, 111, 108, 49, 54, 120,
+56, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 44, 10, 39, 114,
+101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 39, 44, 66, 111, 111, 108, 49, 54,
+120, 56, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83, 44, 10, 39,
+97, 110, 100, 39, 44, 66, 111, 111, 108, 49, 54, 120, 56, 65, 110, 100, 74, 83,
+44, 10, 39, 111, 114, 39, 44, 66, 111, 111, 108, 49, 54, 120, 56, 79, 114, 74,
+83, 44, 10, 39, 120, 111, 114, 39, 44, 66, 111, 111, 108, 49, 54, 120, 56, 88,
+111, 114, 74, 83, 44, 10, 39, 110, 111, 116, 39, 44, 66, 111, 111, 108, 49, 54,
+120, 56, 78, 111, 116, 74, 83, 44, 10, 39, 97, 110, 121, 84, 114, 117, 101, 39,
+44, 66, 111, 111, 108, 49, 54, 120, 56, 65, 110, 121, 84, 114, 117, 101, 74, 83,
+44, 10, 39, 97, 108, 108, 84, 114, 117, 101, 39, 44, 66, 111, 111, 108, 49, 54,
+120, 56, 65, 108, 108, 84, 114, 117, 101, 74, 83, 44, 10, 39, 115, 119, 105,
+122, 122, 108, 101, 39, 44, 66, 111, 111, 108, 49, 54, 120, 56, 83, 119, 105,
+122, 122, 108, 101, 74, 83, 44, 10, 39, 115, 104, 117, 102, 102, 108, 101, 39,
+44, 66, 111, 111, 108, 49, 54, 120, 56, 83, 104, 117, 102, 102, 108, 101, 74,
+83, 44, 10, 93, 41, 59, 10, 98, 46, 73, 110, 115, 116, 97, 108, 108, 70, 117,
+110, 99, 116, 105, 111, 110, 115, 40, 104, 44, 50, 44, 91, 10, 39, 115, 112,
+108, 97, 116, 39, 44, 73, 110, 116, 56, 120, 49, 54, 83, 112, 108, 97, 116, 44,
+10, 39, 99, 104, 101, 99, 107, 39, 44, 73, 110, 116, 56, 120, 49, 54, 67, 104,
+101, 99, 107, 74, 83, 44, 10, 39, 101, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 39, 44, 73, 110, 116, 56, 120, 49, 54, 69, 120, 116, 114, 97, 99, 116, 76,
+97, 110, 101, 74, 83, 44, 10, 39, 114, 101, 112, 108, 97, 99, 101, 76, 97, 110,
+101, 39, 44, 73, 110, 116, 56, 120, 49, 54, 82, 101, 112, 108, 97, 99, 101, 76,
+97, 110, 101, 74, 83, 44, 10, 39, 110, 101, 103, 39, 44, 73, 110, 116, 56, 120,
+49, 54, 78, 101, 103, 74, 83, 44, 10, 39, 97, 100, 100, 39, 44, 73, 110, 116,
+56, 120, 49, 54, 65, 100, 100, 74, 83, 44, 10, 39, 115, 117, 98, 39, 44, 73,
+110, 116, 56, 120, 49, 54, 83, 117, 98, 74, 83, 44, 10, 39, 97, 100, 100, 83,
+97, 116, 117, 114, 97, 116, 101, 39, 44, 73, 110, 116, 56, 120, 49, 54, 65, 100,
+100, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 44, 10, 39, 115, 117, 98, 83,
+97, 116, 117, 114, 97, 116, 101, 39, 44, 73, 110, 116, 56, 120, 49, 54, 83, 117,
+98, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 44, 10, 39, 109, 117, 108, 39,
+44, 73, 110, 116, 56, 120, 49, 54, 77, 117, 108, 74, 83, 44, 10, 39, 109, 105,
+110, 39, 44, 73, 110, 116, 56, 120, 49, 54, 77, 105, 110, 74, 83, 44, 10, 39,
+109, 97, 120, 39, 44, 73, 110, 116, 56, 120, 49, 54, 77, 97, 120, 74, 83, 44,
+10, 39, 97, 110, 100, 39, 44, 73, 110, 116, 56, 120, 49, 54, 65, 110, 100, 74,
+83, 44, 10, 39, 111, 114, 39, 44, 73, 110, 116, 56, 120, 49, 54, 79, 114, 74,
+83, 44, 10, 39, 120, 111, 114, 39, 44, 73, 110, 116, 56, 120, 49, 54, 88, 111,
+114, 74, 83, 44, 10, 39, 110, 111, 116, 39, 44, 73, 110, 116, 56, 120, 49, 54,
+78, 111, 116, 74, 83, 44, 10, 39, 115, 104, 105, 102, 116, 76, 101, 102, 116,
+66, 121, 83, 99, 97, 108, 97, 114, 39, 44, 73, 110, 116, 56, 120, 49, 54, 83,
+104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74,
+83, 44, 10, 39, 115, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66, 121, 83,
+99, 97, 108, 97, 114, 39, 44, 73, 110, 116, 56, 120, 49, 54, 83, 104, 105, 102,
+116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 44, 10,
+39, 108, 101, 115, 115, 84, 104, 97, 110, 39, 44, 73, 110, 116, 56, 120, 49, 54,
+76, 101, 115, 115, 84, 104, 97, 110, 74, 83, 44, 10, 39, 108, 101, 115, 115, 84,
+104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 39, 44, 73, 110, 116, 56, 120, 49,
+54, 76, 101, 115, 115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83,
+44, 10, 39, 103, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 39, 44, 73, 110,
+116, 56, 120, 49, 54, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 74, 83,
+44, 10, 39, 103, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79, 114, 69,
+113, 117, 97, 108, 39, 44, 73, 110, 116, 56, 120, 49, 54, 71, 114, 101, 97, 116,
+101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39,
+101, 113, 117, 97, 108, 39, 44, 73, 110, 116, 56, 120, 49, 54, 69, 113, 117, 97,
+108, 74, 83, 44, 10, 39, 110, 111, 116, 69, 113, 117, 97, 108, 39, 44, 73, 110,
+116, 56, 120, 49, 54, 78, 111, 116, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39,
+115, 101, 108, 101, 99, 116, 39, 44, 73, 110, 116, 56, 120, 49, 54, 83, 101,
+108, 101, 99, 116, 74, 83, 44, 10, 39, 115, 119, 105, 122, 122, 108, 101, 39,
+44, 73, 110, 116, 56, 120, 49, 54, 83, 119, 105, 122, 122, 108, 101, 74, 83, 44,
+10, 39, 115, 104, 117, 102, 102, 108, 101, 39, 44, 73, 110, 116, 56, 120, 49,
+54, 83, 104, 117, 102, 102, 108, 101, 74, 83, 44, 10, 39, 102, 114, 111, 109,
+85, 105, 110, 116, 56, 120, 49, 54, 39, 44, 73, 110, 116, 56, 120, 49, 54, 70,
+114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 74, 83, 44, 10, 39, 102, 114,
+111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105, 116, 115, 39, 44, 73,
+110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50,
+120, 52, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 73, 110,
+116, 51, 50, 120, 52, 66, 105, 116, 115, 39, 44, 73, 110, 116, 56, 120, 49, 54,
+70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 44,
+10, 39, 102, 114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116,
+115, 39, 44, 73, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 85, 105, 110,
+116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109,
+73, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 39, 44, 73, 110, 116, 56, 120,
+49, 54, 70, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74,
+83, 44, 10, 39, 102, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66, 105,
+116, 115, 39, 44, 73, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 85, 105,
+110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111,
+109, 85, 105, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 39, 44, 73, 110,
+116, 56, 120, 49, 54, 70, 114, 111, 109, 85, 105, 110, 116, 56, 120, 49, 54, 66,
+105, 116, 115, 74, 83, 44, 10, 39, 108, 111, 97, 100, 39, 44, 73, 110, 116, 56,
+120, 49, 54, 76, 111, 97, 100, 74, 83, 44, 10, 39, 115, 116, 111, 114, 101, 39,
+44, 73, 110, 116, 56, 120, 49, 54, 83, 116, 111, 114, 101, 74, 83, 44, 10, 93,
+41, 59, 10, 98, 46, 73, 110, 115, 116, 97, 108, 108, 70, 117, 110, 99, 116, 105,
+111, 110, 115, 40, 107, 44, 50, 44, 91, 10, 39, 115, 112, 108, 97, 116, 39, 44,
+85, 105, 110, 116, 56, 120, 49, 54, 83, 112, 108, 97, 116, 44, 10, 39, 99, 104,
+101, 99, 107, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 67, 104, 101, 99, 107,
+74, 83, 44, 10, 39, 101, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 39, 44,
+85, 105, 110, 116, 56, 120, 49, 54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110,
+101, 74, 83, 44, 10, 39, 114, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 39,
+44, 85, 105, 110, 116, 56, 120, 49, 54, 82, 101, 112, 108, 97, 99, 101, 76, 97,
+110, 101, 74, 83, 44, 10, 39, 97, 100, 100, 39, 44, 85, 105, 110, 116, 56, 120,
+49, 54, 65, 100, 100, 74, 83, 44, 10, 39, 115, 117, 98, 39, 44, 85, 105, 110,
+116, 56, 120, 49, 54, 83, 117, 98, 74, 83, 44, 10, 39, 97, 100, 100, 83, 97,
+116, 117, 114, 97, 116, 101, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 65,
+100, 100, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 44, 10, 39, 115, 117, 98,
+83, 97, 116, 117, 114, 97, 116, 101, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54,
+83, 117, 98, 83, 97, 116, 117, 114, 97, 116, 101, 74, 83, 44, 10, 39, 109, 117,
+108, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 77, 117, 108, 74, 83, 44, 10,
+39, 109, 105, 110, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 77, 105, 110, 74,
+83, 44, 10, 39, 109, 97, 120, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 77,
+97, 120, 74, 83, 44, 10, 39, 97, 110, 100, 39, 44, 85, 105, 110, 116, 56, 120,
+49, 54, 65, 110, 100, 74, 83, 44, 10, 39, 111, 114, 39, 44, 85, 105, 110, 116,
+56, 120, 49, 54, 79, 114, 74, 83, 44, 10, 39, 120, 111, 114, 39, 44, 85, 105,
+110, 116, 56, 120, 49, 54, 88, 111, 114, 74, 83, 44, 10, 39, 110, 111, 116, 39,
+44, 85, 105, 110, 116, 56, 120, 49, 54, 78, 111, 116, 74, 83, 44, 10, 39, 115,
+104, 105, 102, 116, 76, 101, 102, 116, 66, 121, 83, 99, 97, 108, 97, 114, 39,
+44, 85, 105, 110, 116, 56, 120, 49, 54, 83, 104, 105, 102, 116, 76, 101, 102,
+116, 66, 121, 83, 99, 97, 108, 97, 114, 74, 83, 44, 10, 39, 115, 104, 105, 102,
+116, 82, 105, 103, 104, 116, 66, 121, 83, 99, 97, 108, 97, 114, 39, 44, 85, 105,
+110, 116, 56, 120, 49, 54, 83, 104, 105, 102, 116, 82, 105, 103, 104, 116, 66,
+121, 83, 99, 97, 108, 97, 114, 74, 83, 44, 10, 39, 108, 101, 115, 115, 84, 104,
+97, 110, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 76, 101, 115, 115, 84, 104,
+97, 110, 74, 83, 44, 10, 39, 108, 101, 115, 115, 84, 104, 97, 110, 79, 114, 69,
+113, 117, 97, 108, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 76, 101, 115,
+115, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39, 103,
+114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 39, 44, 85, 105, 110, 116, 56,
+120, 49, 54, 71, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 74, 83, 44, 10,
+39, 103, 114, 101, 97, 116, 101, 114, 84, 104, 97, 110, 79, 114, 69, 113, 117,
+97, 108, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 71, 114, 101, 97, 116, 101,
+114, 84, 104, 97, 110, 79, 114, 69, 113, 117, 97, 108, 74, 83, 44, 10, 39, 101,
+113, 117, 97, 108, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 69, 113, 117, 97,
+108, 74, 83, 44, 10, 39, 110, 111, 116, 69, 113, 117, 97, 108, 39, 44, 85, 105,
+110, 116, 56, 120, 49, 54, 78, 111, 116, 69, 113, 117, 97, 108, 74, 83, 44, 10,
+39, 115, 101, 108, 101, 99, 116, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 83,
+101, 108, 101, 99, 116, 74, 83, 44, 10, 39, 115, 119, 105, 122, 122, 108, 101,
+39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 83, 119, 105, 122, 122, 108, 101,
+74, 83, 44, 10, 39, 115, 104, 117, 102, 102, 108, 101, 39, 44, 85, 105, 110,
+116, 56, 120, 49, 54, 83, 104, 117, 102, 102, 108, 101, 74, 83, 44, 10, 39, 102,
+114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 39, 44, 85, 105, 110, 116, 56,
+120, 49, 54, 70, 114, 111, 109, 73, 110, 116, 56, 120, 49, 54, 74, 83, 44, 10,
+39, 102, 114, 111, 109, 70, 108, 111, 97, 116, 51, 50, 120, 52, 66, 105, 116,
+115, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 70, 108,
+111, 97, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114,
+111, 109, 73, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 39, 44, 85, 105,
+110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 73, 110, 116, 51, 50, 120, 52, 66,
+105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 85, 105, 110, 116, 51,
+50, 120, 52, 66, 105, 116, 115, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 70,
+114, 111, 109, 85, 105, 110, 116, 51, 50, 120, 52, 66, 105, 116, 115, 74, 83,
+44, 10, 39, 102, 114, 111, 109, 73, 110, 116, 49, 54, 120, 56, 66, 105, 116,
+115, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 70, 114, 111, 109, 73, 110,
+116, 49, 54, 120, 56, 66, 105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109,
+85, 105, 110, 116, 49, 54, 120, 56, 66, 105, 116, 115, 39, 44, 85, 105, 110,
+116, 56, 120, 49, 54, 70, 114, 111, 109, 85, 105, 110, 116, 49, 54, 120, 56, 66,
+105, 116, 115, 74, 83, 44, 10, 39, 102, 114, 111, 109, 73, 110, 116, 56, 120,
+49, 54, 66, 105, 116, 115, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 70, 114,
+111, 109, 73, 110, 116, 56, 120, 49, 54, 66, 105, 116, 115, 74, 83, 44, 10, 39,
+108, 111, 97, 100, 39, 44, 85, 105, 110, 116, 56, 120, 49, 54, 76, 111, 97, 100,
+74, 83, 44, 10, 39, 115, 116, 111, 114, 101, 39, 44, 85, 105, 110, 116, 56, 120,
+49, 54, 83, 116, 111, 114, 101, 74, 83, 44, 10, 93, 41, 59, 10, 98, 46, 73, 110,
+115, 116, 97, 108, 108, 70, 117, 110, 99, 116, 105, 111, 110, 115, 40, 110, 44,
+50, 44, 91, 10, 39, 115, 112, 108, 97, 116, 39, 44, 66, 111, 111, 108, 56, 120,
+49, 54, 83, 112, 108, 97, 116, 44, 10, 39, 99, 104, 101, 99, 107, 39, 44, 66,
+111, 111, 108, 56, 120, 49, 54, 67, 104, 101, 99, 107, 74, 83, 44, 10, 39, 101,
+120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 39, 44, 66, 111, 111, 108, 56,
+120, 49, 54, 69, 120, 116, 114, 97, 99, 116, 76, 97, 110, 101, 74, 83, 44, 10,
+39, 114, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 39, 44, 66, 111, 111,
+108, 56, 120, 49, 54, 82, 101, 112, 108, 97, 99, 101, 76, 97, 110, 101, 74, 83,
+44, 10, 39, 97, 110, 100, 39, 44, 66, 111, 111, 108, 56, 120, 49, 54, 65, 110,
+100, 74, 83, 44, 10, 39, 111, 114, 39, 44, 66, 111, 111, 108, 56, 120, 49, 54,
+79, 114, 74, 83, 44, 10, 39, 120, 111, 114, 39, 44, 66, 111, 111, 108, 56, 120,
+49, 54, 88, 111, 114, 74, 83, 44, 10, 39, 110, 111, 116, 39, 44, 66, 111, 111,
+108, 56, 120, 49, 54, 78, 111, 116, 74, 83, 44, 10, 39, 97, 110, 121, 84, 114,
+117, 101, 39, 44, 66, 111, 111, 108, 56, 120, 49, 54, 65, 110, 121, 84, 114,
+117, 101, 74, 83, 44, 10, 39, 97, 108, 108, 84, 114, 117, 101, 39, 44, 66, 111,
+111, 108, 56, 120, 49, 54, 65, 108, 108, 84, 114, 117, 101, 74, 83, 44, 10, 39,
+115, 119, 105, 122, 122, 108, 101, 39, 44, 66, 111, 111, 108, 56, 120, 49, 54,
+83, 119, 105, 122, 122, 108, 101, 74, 83, 44, 10, 39, 115, 104, 117, 102, 102,
+108, 101, 39, 44, 66, 111, 111, 108, 56, 120, 49, 54, 83, 104, 117, 102, 102,
+108, 101, 74, 83, 44, 10, 93, 41, 59, 10, 125, 41, 10, 10, 10, 40, 102, 117,
+110, 99, 116, 105, 111, 110, 40, 97, 44, 98, 41, 123, 10, 34, 117, 115, 101, 32,
+115, 116, 114, 105, 99, 116, 34, 59, 10, 37, 67, 104, 101, 99, 107, 73, 115, 66,
+111, 111, 116, 115, 116, 114, 97, 112, 112, 105, 110, 103, 40, 41, 59, 10, 118,
+97, 114, 32, 99, 61, 97, 46, 73, 110, 116, 108, 59, 10, 118, 97, 114, 32, 100,
+61, 98, 46, 73, 109, 112, 111, 114, 116, 78, 111, 119, 40, 34, 70, 111, 114,
+109, 97, 116, 68, 97, 116, 101, 84, 111, 80, 97, 114, 116, 115, 34, 41, 59, 10,
+98, 46, 73, 110, 115, 116, 97, 108, 108, 70, 117, 110, 99, 116, 105, 111, 110,
+115, 40, 99, 46, 68, 97, 116, 101, 84, 105, 109, 101, 70, 111, 114, 109, 97,
+116, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44, 50, 44, 91, 10, 39,
+102, 111, 114, 109, 97, 116, 84, 111, 80, 97, 114, 116, 115, 39, 44, 100, 10,
+93, 41, 59, 10, 125, 41, 10, 10, 10, 40, 102, 117, 110, 99, 116, 105, 111, 110,
+40, 97, 44, 98, 41, 123, 10, 34, 117, 115, 101, 32, 115, 116, 114, 105, 99, 116,
+34, 59, 10, 37, 67, 104, 101, 99, 107, 73, 115, 66, 111, 111, 116, 115, 116,
+114, 97, 112, 112, 105, 110, 103, 40, 41, 59, 10, 118, 97, 114, 32, 99, 61, 97,
+46, 83, 116, 114, 105, 110, 103, 59, 10, 118, 97, 114, 32, 100, 61, 98, 46, 79,
+118, 101, 114, 114, 105, 100, 101, 70, 117, 110, 99, 116, 105, 111, 110, 59, 10,
+118, 97, 114, 32, 101, 61, 98, 46, 73, 109, 112, 111, 114, 116, 78, 111, 119,
+40, 34, 84, 111, 76, 111, 119, 101, 114, 67, 97, 115, 101, 73, 49, 56, 78, 34,
+41, 59, 10, 118, 97, 114, 32, 102, 61, 98, 46, 73, 109, 112, 111, 114, 116, 78,
+111, 119, 40, 34, 84, 111, 85, 112, 112, 101, 114, 67, 97, 115, 101, 73, 49, 56,
+78, 34, 41, 59, 10, 118, 97, 114, 32, 103, 61, 98, 46, 73, 109, 112, 111, 114,
+116, 78, 111, 119, 40, 34, 84, 111, 76, 111, 99, 97, 108, 101, 76, 111, 119,
+101, 114, 67, 97, 115, 101, 73, 49, 56, 78, 34, 41, 59, 10, 118, 97, 114, 32,
+104, 61, 98, 46, 73, 109, 112, 111, 114, 116, 78, 111, 119, 40, 34, 84, 111, 76,
+111, 99, 97, 108, 101, 85, 112, 112, 101, 114, 67, 97, 115, 101, 73, 49, 56, 78,
+34, 41, 59, 10, 100, 40, 99, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101,
+44, 39, 116, 111, 76, 111, 119, 101, 114, 67, 97, 115, 101, 39, 44, 101, 44,
+116, 114, 117, 101, 41, 59, 10, 100, 40, 99, 46, 112, 114, 111, 116, 111, 116,
+121, 112, 101, 44, 39, 116, 111, 85, 112, 112, 101, 114, 67, 97, 115, 101, 39,
+44, 102, 44, 116, 114, 117, 101, 41, 59, 10, 100, 40, 99, 46, 112, 114, 111,
+116, 111, 116, 121, 112, 101, 44, 39, 116, 111, 76, 111, 99, 97, 108, 101, 76,
+111, 119, 101, 114, 67, 97, 115, 101, 39, 44, 10, 103, 44, 116, 114, 117, 101,
+41, 59, 10, 100, 40, 99, 46, 112, 114, 111, 116, 111, 116, 121, 112, 101, 44,
+39, 116, 111, 76, 111, 99, 97, 108, 101, 85, 112, 112, 101, 114, 67, 97, 115,
+101, 39, 44, 10, 104, 44, 116, 114, 117, 101, 41, 59, 10, 125, 41, 10, 10 };
+
+  template <>
+  int NativesCollection<EXPERIMENTAL>::GetBuiltinsCount() {
+    return 4;
+  }
+
+  template <>
+  int NativesCollection<EXPERIMENTAL>::GetDebuggerCount() {
+    return 0;
+  }
+
+  template <>
+  int NativesCollection<EXPERIMENTAL>::GetIndex(const char* name) {
+    if (strcmp(name, "harmony-atomics") == 0) return 0;
+    if (strcmp(name, "harmony-simd") == 0) return 1;
+    if (strcmp(name, "datetime-format-to-parts") == 0) return 2;
+    if (strcmp(name, "icu-case-mapping") == 0) return 3;
+    return -1;
+  }
+
+  template <>
+  Vector<const char> NativesCollection<EXPERIMENTAL>::GetScriptSource(int index) {
+    if (index == 0) return Vector<const char>(sources + 0, 2593);
+    if (index == 1) return Vector<const char>(sources + 2593, 44323);
+    if (index == 2) return Vector<const char>(sources + 46916, 186);
+    if (index == 3) return Vector<const char>(sources + 47102, 428);
+    return Vector<const char>("", 0);
+  }
+
+  template <>
+  Vector<const char> NativesCollection<EXPERIMENTAL>::GetScriptName(int index) {
+    if (index == 0) return Vector<const char>("native harmony-atomics.js", 25);
+    if (index == 1) return Vector<const char>("native harmony-simd.js", 22);
+    if (index == 2) return Vector<const char>("native datetime-format-to-parts.js", 34);
+    if (index == 3) return Vector<const char>("native icu-case-mapping.js", 26);
+    return Vector<const char>("", 0);
+  }
+
+  template <>
+  Vector<const char> NativesCollection<EXPERIMENTAL>::GetScriptsSource() {
+    return Vector<const char>(sources, 47530);
+  }
+}  // internal
+}  // v8
@@ -0,0 +1,462 @@
+0,186,184,120,218,237,61,107,111,220,56,146,127,69,48,14,136,3,116,60,
+187,123,192,221,97,119,113,128,199,78,118,188,200,195,176,147,221,3,14,249,
+160,150,216,110,78,212,82,159,168,182,211,187,152,255,126,245,226,67,18,169,
+86,59,158,231,6,24,76,220,18,69,22,201,98,189,171,248,207,147,178,217,
+228,186,54,39,127,252,223,127,158,20,205,102,147,215,37,255,104,85,183,107,
+229,133,238,212,6,254,250,231,201,191,181,106,117,242,199,147,75,250,232,228,
+135,197,73,183,223,42,120,144,183,109,190,63,89,156,212,249,6,127,218,78,
+23,39,165,50,69,171,183,157,110,106,120,254,90,155,46,107,86,153,217,109,
+183,77,219,169,50,147,150,103,39,63,124,92,156,172,97,240,74,181,56,230,
+201,178,109,30,140,106,161,139,86,213,165,106,225,207,143,174,255,59,213,93,
+38,134,184,97,176,83,67,240,15,104,119,91,172,213,38,31,125,126,221,54,
+247,26,30,101,186,94,53,237,38,199,199,89,190,108,118,93,214,173,85,182,
+109,155,174,41,154,42,51,244,249,217,9,175,0,175,18,188,220,170,182,211,
+242,83,150,198,116,173,174,239,252,218,208,63,195,97,121,54,25,190,3,56,
+23,201,143,239,97,117,240,139,196,247,242,154,167,42,93,52,203,239,85,209,
+193,23,186,244,59,55,250,222,255,194,253,233,77,149,151,12,251,68,192,146,
+56,210,239,240,229,125,94,237,120,245,90,101,118,85,119,230,39,193,15,224,
+183,96,211,141,218,52,157,122,199,112,226,24,131,174,62,23,138,33,43,85,
+151,235,202,96,87,13,61,201,171,147,63,118,237,78,185,174,149,109,123,201,
+77,253,32,47,135,111,126,240,232,164,24,88,220,150,109,222,194,179,142,145,
+48,185,13,234,243,22,38,17,221,137,151,238,85,214,53,153,237,153,55,117,
+8,116,162,119,222,177,191,180,205,110,59,234,254,118,191,89,54,149,46,178,
+59,124,77,8,3,187,149,119,89,145,215,217,82,101,59,3,24,15,3,183,
+170,82,185,81,217,6,86,90,111,43,149,113,167,102,18,144,101,211,192,87,
+181,135,68,215,69,181,43,213,5,239,249,107,93,171,243,235,171,8,242,192,
+122,109,224,165,201,30,214,10,112,167,205,228,139,12,63,201,224,155,204,172,
+155,93,85,34,132,249,61,44,127,190,4,144,202,29,206,155,144,77,57,116,
+57,14,64,163,43,85,119,35,136,174,234,140,223,100,155,166,132,222,237,222,
+27,24,12,232,74,109,135,246,195,102,121,171,178,186,233,96,225,132,108,32,
+248,101,67,207,182,57,44,43,244,162,138,29,129,152,189,131,131,214,18,153,
+248,115,1,3,252,183,81,221,53,182,121,87,59,52,251,243,55,244,38,51,
+157,219,254,193,78,110,85,161,87,154,72,13,172,155,46,214,126,132,172,104,
+234,78,125,238,112,39,129,164,32,37,10,151,40,187,146,35,106,145,53,211,
+38,107,54,186,67,184,251,203,153,61,232,170,194,101,151,110,160,1,12,135,
+109,236,16,114,220,129,66,2,64,216,193,54,191,83,19,71,76,190,187,42,
+195,179,37,112,95,184,119,199,108,34,83,145,111,247,127,3,160,199,164,241,
+239,130,82,8,36,83,14,156,45,156,64,134,22,86,8,145,42,251,235,237,
+187,183,130,228,124,32,60,198,25,68,132,229,62,195,69,81,199,225,215,157,
+170,85,11,27,120,221,170,123,173,30,224,5,14,220,234,13,116,233,191,142,
+3,188,229,111,2,64,108,111,101,6,91,17,76,232,56,152,0,207,218,191,
+40,3,107,166,142,130,199,99,151,135,168,107,21,193,147,35,22,234,78,211,
+15,88,42,28,195,34,202,135,171,227,224,203,31,114,221,1,31,221,104,147,
+222,205,17,48,248,17,45,203,150,191,148,141,133,5,106,170,123,85,58,156,
+23,20,0,172,13,144,28,16,2,207,105,158,201,176,139,76,119,207,12,162,
+184,209,40,59,56,52,169,51,56,184,77,43,178,64,140,99,41,194,45,75,
+194,225,191,187,170,89,230,149,160,22,175,68,154,237,201,248,118,95,179,191,
+227,233,195,19,131,220,185,85,223,51,206,18,34,102,122,229,230,250,0,235,
+111,223,62,33,163,196,33,128,254,20,159,224,255,109,94,40,92,39,71,126,
+159,156,139,14,246,125,192,73,7,4,186,4,132,69,234,215,6,226,6,126,
+24,204,94,158,240,116,67,114,19,46,195,111,153,212,60,1,89,25,97,249,
+121,89,102,34,102,19,115,177,8,168,187,117,118,167,239,85,237,30,201,4,
+117,121,8,231,47,114,192,241,95,190,144,87,0,152,175,118,117,129,175,223,
+213,199,35,168,221,240,38,195,158,178,149,116,149,161,200,50,16,221,14,32,
+107,66,236,179,61,94,170,162,2,208,186,168,156,239,223,89,184,28,32,2,
+25,111,151,211,216,34,123,149,183,119,59,100,24,103,30,74,124,126,46,143,
+211,106,157,253,208,68,246,102,98,28,115,150,157,35,25,236,61,3,201,20,
+116,193,165,170,26,20,1,27,154,138,65,105,246,175,64,161,110,169,171,236,
+161,105,43,226,77,248,178,131,79,85,215,163,195,191,73,41,241,103,35,101,
+44,131,126,21,155,190,138,77,199,136,77,120,210,141,39,66,1,35,41,67,
+90,197,107,194,47,228,8,103,76,20,69,147,109,86,3,92,213,53,76,88,
+211,174,3,116,41,18,48,101,165,186,102,123,204,222,26,55,154,54,77,218,
+28,187,234,207,78,64,244,150,157,158,117,198,246,49,36,43,192,83,106,39,
+50,6,31,103,167,77,93,237,237,84,65,67,71,252,131,53,55,170,90,61,
+159,96,120,90,122,188,246,6,166,197,104,182,87,253,70,189,89,255,28,252,
+22,118,170,7,239,163,217,45,111,113,184,140,43,68,197,71,241,92,127,234,
+18,115,5,178,223,131,122,0,38,192,134,173,5,38,19,2,197,172,12,249,
+5,109,178,176,180,254,38,47,232,188,193,43,248,201,6,54,132,43,43,214,
+108,96,59,2,206,188,40,64,69,105,90,15,236,59,24,117,22,97,27,77,
+194,246,213,195,84,62,200,170,131,13,251,198,208,63,207,105,98,127,202,44,
+54,134,205,61,95,196,46,225,204,42,141,244,234,151,200,53,76,140,138,221,
+140,247,19,240,48,255,17,8,150,163,55,100,159,123,103,141,179,95,112,58,
+168,163,163,206,67,100,250,212,9,42,161,216,210,73,4,158,152,91,53,32,
+6,190,181,84,206,179,157,206,178,110,54,225,74,139,85,60,13,53,43,32,
+1,228,134,245,50,47,93,218,157,164,14,251,51,217,213,87,171,191,3,23,
+5,32,95,53,237,165,90,238,238,238,200,239,208,31,236,189,66,62,231,173,
+100,240,87,151,215,5,49,92,232,3,85,109,224,196,168,200,63,112,103,132,
+118,165,116,71,48,116,160,138,175,123,131,171,26,53,241,177,13,153,30,27,
+145,50,137,164,172,198,198,65,96,212,40,134,224,19,16,61,54,112,148,8,
+105,89,214,84,3,147,220,5,75,44,86,222,84,247,40,255,103,112,122,106,
+193,98,59,18,224,43,200,137,4,128,181,37,34,253,178,102,68,18,10,245,
+102,163,74,20,122,128,206,225,44,85,78,198,75,109,168,135,17,160,189,41,
+151,218,68,231,124,201,207,231,79,122,216,107,145,183,37,76,22,228,30,245,
+178,6,156,139,144,239,75,110,133,18,78,85,241,54,6,66,63,138,242,5,
+119,64,38,107,212,87,132,223,199,232,144,213,45,84,119,1,154,76,179,225,
+179,240,138,156,70,112,6,120,15,203,228,177,24,81,63,89,115,113,179,164,
+213,237,171,210,18,1,126,58,193,184,185,65,72,9,110,237,147,159,69,3,
+111,54,91,208,183,24,134,167,247,181,72,247,147,254,51,211,236,218,66,125,
+184,121,61,38,61,244,38,219,181,149,8,189,176,177,142,115,216,149,142,114,
+104,107,174,66,223,155,233,220,236,82,214,254,135,64,51,19,144,75,25,32,
+224,94,210,155,42,159,194,117,32,189,3,153,250,121,93,7,106,236,39,152,
+244,33,140,149,13,94,175,208,68,123,200,58,117,179,251,53,120,32,97,107,
+82,199,98,250,244,11,251,9,230,118,212,161,255,87,193,164,95,163,243,245,
+55,105,181,250,197,123,148,127,93,102,181,159,214,132,246,43,53,81,1,11,
+48,150,114,245,84,26,164,66,86,51,240,178,106,24,37,4,159,118,58,18,
+175,35,207,37,54,6,17,160,65,69,36,176,93,183,210,34,20,205,69,71,
+9,79,38,96,244,70,35,224,142,70,100,163,208,25,86,175,157,106,13,42,
+70,239,19,38,65,12,130,123,4,59,184,200,152,182,225,177,135,142,80,120,
+117,99,238,106,253,127,232,130,244,138,229,136,142,225,142,173,118,45,237,169,
+244,10,244,21,150,28,148,30,160,18,173,190,211,222,200,197,32,226,90,160,
+167,147,233,251,6,102,219,238,97,40,96,216,100,194,223,83,35,182,12,32,
+188,64,73,117,7,42,132,144,75,224,108,173,204,84,126,231,164,190,209,150,
+145,210,27,192,98,132,131,232,182,167,43,246,3,178,134,36,158,34,160,110,
+61,127,236,239,233,7,94,19,65,20,191,52,113,129,146,250,26,40,214,137,
+30,157,39,173,223,163,170,119,27,140,116,187,170,87,104,68,70,227,205,219,
+252,45,252,255,69,240,228,197,239,78,62,46,226,131,127,168,13,40,37,121,
+165,255,129,180,47,78,175,174,65,107,1,109,244,94,137,207,153,137,17,108,
+51,30,42,216,105,36,84,47,184,91,132,76,164,205,65,32,155,5,212,69,
+146,89,107,47,252,185,171,75,181,194,29,135,191,61,43,221,109,150,164,66,
+123,10,98,136,117,198,230,34,180,133,30,39,204,175,248,46,78,169,44,104,
+206,154,187,171,42,252,7,216,19,69,14,222,1,154,97,175,28,220,181,201,
+241,7,48,52,54,159,2,65,108,16,74,33,142,244,55,17,17,20,194,218,
+230,243,158,255,21,106,135,64,148,60,78,122,22,102,183,156,154,136,188,206,
+214,26,181,111,43,124,241,89,99,110,203,107,108,25,44,53,166,157,51,100,
+124,59,42,140,172,168,114,99,222,198,162,13,5,26,106,144,157,34,45,133,
+142,10,88,128,231,108,107,121,106,200,242,58,176,180,223,71,17,245,166,103,
+120,146,0,9,160,202,40,70,53,24,40,209,195,99,131,164,130,152,172,252,
+60,245,230,151,86,193,153,67,205,233,121,76,117,74,30,136,44,113,34,128,
+196,43,230,65,235,28,190,226,181,160,111,101,41,22,217,114,215,177,217,164,
+91,107,103,66,220,79,72,175,187,232,201,21,241,53,118,172,143,216,245,112,
+186,35,249,53,202,15,122,38,197,216,154,165,200,88,118,138,216,81,55,245,
+139,225,246,76,57,51,102,153,235,135,155,198,242,140,4,210,224,28,242,229,
+18,31,146,72,99,87,92,6,127,28,250,38,225,221,78,90,163,101,10,12,
+188,149,203,98,219,101,15,37,217,138,174,231,244,121,209,107,154,140,232,237,
+233,174,195,29,127,211,19,20,44,255,38,227,154,101,224,129,204,18,162,64,
+116,172,139,25,208,207,139,130,94,171,28,196,183,73,131,202,58,55,223,54,
+229,62,52,243,173,172,117,109,86,80,144,124,180,212,117,25,190,181,65,32,
+71,134,20,249,240,199,149,190,59,60,254,199,175,140,180,105,127,37,156,242,
+73,104,102,10,141,27,208,167,87,85,51,214,214,222,183,20,4,184,202,76,
+179,81,65,24,156,115,64,129,144,204,134,108,55,92,95,232,206,74,80,97,
+144,51,173,116,55,136,250,25,120,192,61,97,74,184,191,183,105,159,167,205,
+217,232,67,23,31,15,13,239,135,7,83,206,60,63,29,68,20,142,44,223,
+196,81,1,208,209,226,1,42,55,206,110,225,236,20,130,76,125,252,72,17,
+212,62,45,159,227,132,180,242,84,156,61,181,99,209,102,130,196,14,183,236,
+75,136,108,52,213,196,14,16,36,155,60,33,93,90,56,207,244,151,144,168,
+236,220,186,164,89,119,38,229,52,64,192,189,248,211,41,160,181,30,57,176,
+143,59,253,113,129,244,3,72,97,47,86,128,115,117,9,42,106,95,196,16,
+197,58,38,43,189,37,209,83,154,137,232,48,33,92,80,59,191,213,179,165,
+137,223,32,185,254,152,60,18,61,170,50,235,60,196,197,71,33,37,159,212,
+126,8,34,44,208,139,74,127,82,214,49,136,36,222,82,156,244,230,65,71,
+83,123,54,9,132,144,129,17,18,198,123,139,9,19,143,62,243,200,88,248,
+180,102,65,171,24,50,191,183,128,102,160,40,54,5,147,51,103,142,153,161,
+232,12,102,53,114,179,204,53,60,62,180,186,139,122,141,133,135,250,37,157,
+132,20,246,121,143,58,94,177,206,235,59,104,112,10,231,35,119,139,208,180,
+140,139,81,189,241,60,8,113,99,131,174,106,239,49,244,192,160,5,145,226,
+99,156,105,213,14,183,200,28,246,59,42,106,15,0,195,220,42,54,112,218,
+30,78,29,37,139,0,149,92,229,59,53,223,149,53,57,15,243,197,243,48,
+95,50,15,51,57,143,20,110,176,64,190,107,15,226,7,209,28,58,126,129,
+150,30,0,56,196,14,20,37,244,42,138,64,165,170,84,47,208,167,104,90,
+16,15,183,77,93,146,110,53,67,44,68,10,174,14,1,29,2,106,214,205,
+131,201,118,91,231,223,225,14,6,41,155,78,120,172,15,192,53,251,232,229,
+230,61,249,149,38,215,86,108,247,15,249,208,11,21,115,197,204,141,113,211,
+230,221,129,97,189,56,0,51,126,168,3,247,70,218,154,225,104,161,208,64,
+110,185,136,118,201,143,68,158,164,230,33,3,155,66,101,43,13,69,177,57,
+37,121,70,66,55,167,3,82,67,244,141,154,110,143,97,18,23,77,141,161,
+62,52,29,63,128,151,18,127,74,222,144,90,161,137,32,215,196,74,13,163,
+21,123,75,150,189,239,29,49,109,234,103,29,144,177,118,147,87,32,244,221,
+107,163,209,171,168,235,208,72,130,251,31,93,235,199,27,63,7,70,201,39,
+177,91,62,181,249,113,202,92,203,9,69,95,100,243,75,109,120,47,49,101,
+108,52,22,165,60,8,64,239,101,153,156,101,47,217,219,212,215,193,116,217,
+19,74,175,74,103,202,245,134,204,152,161,183,191,112,67,163,52,114,201,90,
+188,91,64,57,200,56,234,248,229,115,60,22,155,208,13,108,5,208,30,77,
+68,108,229,232,67,150,124,99,97,14,177,128,16,116,127,198,195,238,38,37,
+227,15,214,13,232,212,236,81,39,217,213,40,188,129,65,223,79,133,140,136,
+19,45,240,116,246,66,155,56,8,36,16,127,245,225,248,141,84,188,6,217,
+68,34,161,97,67,144,184,225,100,116,88,148,44,126,183,219,228,232,137,205,
+75,218,116,146,160,185,197,146,226,37,7,222,227,52,107,117,136,109,189,233,
+187,207,151,32,127,142,65,7,221,186,44,65,251,20,20,41,50,104,169,43,
+157,183,64,187,224,131,9,211,197,112,233,46,39,12,91,131,146,15,57,250,
+218,155,138,201,56,230,93,77,241,19,143,166,195,168,167,8,134,250,232,41,
+93,78,46,63,66,60,241,53,190,94,140,194,41,4,41,239,56,248,128,24,
+144,3,198,135,96,192,22,5,137,175,209,3,39,64,84,112,90,223,90,243,
+198,208,30,85,195,254,211,59,127,94,236,80,85,83,48,162,159,254,238,197,
+18,189,215,207,167,199,1,77,115,183,169,19,35,93,208,203,163,199,26,88,
+46,249,12,94,93,166,59,120,124,236,232,76,219,202,174,173,198,150,149,155,
+215,105,136,22,18,207,65,219,250,96,195,147,109,240,70,110,122,113,76,177,
+89,7,156,154,83,159,37,243,121,53,43,243,153,62,121,143,95,4,243,246,
+207,166,66,3,45,111,89,29,151,98,61,91,115,27,39,1,88,202,246,64,
+10,152,95,203,117,190,221,170,122,82,4,120,68,36,102,130,224,140,162,29,
+71,145,92,57,69,184,142,235,233,120,128,79,209,212,141,6,168,231,108,233,
+27,171,17,198,202,94,24,255,41,58,79,16,106,212,59,106,206,56,73,16,
+190,215,27,5,187,186,25,71,243,189,117,167,107,163,171,74,27,5,235,89,
+154,204,104,140,234,7,12,179,177,250,243,68,106,43,128,68,29,238,1,82,
+58,65,37,37,88,135,8,108,67,81,230,135,119,30,113,14,199,3,89,235,
+16,180,126,52,145,28,247,90,5,100,243,41,136,227,120,132,162,71,46,195,
+49,166,196,202,87,109,108,171,232,180,147,241,143,115,27,108,28,23,225,39,
+39,9,128,194,131,248,208,212,230,24,61,224,17,78,39,32,34,170,114,38,
+139,128,156,157,101,175,48,86,202,236,235,130,31,72,236,129,152,39,114,217,
+201,97,130,56,158,45,159,175,138,239,184,139,72,218,120,144,23,206,235,148,
+244,230,20,182,137,249,34,180,63,71,72,224,204,215,205,174,23,71,23,18,
+113,154,0,136,252,133,42,9,126,187,40,139,185,84,119,155,183,172,71,68,
+72,123,10,85,110,67,150,16,201,114,95,209,220,9,87,60,98,100,150,162,
+101,240,206,228,119,74,178,206,40,153,134,209,36,65,137,37,81,231,80,28,
+248,57,168,26,15,160,163,22,146,137,60,20,193,207,78,134,5,123,210,4,
+62,148,18,199,209,147,87,198,236,44,47,134,49,35,194,190,54,22,140,126,
+114,211,120,152,174,109,246,135,231,230,99,220,75,251,73,230,39,241,84,185,
+4,225,188,162,115,114,131,79,206,202,92,84,10,176,42,162,152,5,253,35,
+158,140,62,204,30,144,109,23,252,57,42,83,182,228,93,111,52,225,145,206,
+6,55,185,114,142,217,141,4,172,0,31,186,128,35,202,130,121,38,25,27,
+123,94,38,195,212,234,90,70,31,48,118,142,66,101,203,193,112,133,165,249,
+141,186,111,62,77,164,80,13,41,42,224,160,137,16,211,27,122,28,234,108,
+15,235,253,0,168,150,135,154,230,74,83,74,14,154,195,88,141,150,174,252,
+0,139,44,55,62,244,30,246,217,102,232,201,251,15,118,21,196,206,112,118,
+96,57,221,170,77,205,193,159,125,204,103,59,191,190,66,90,21,91,75,235,
+73,172,154,59,154,212,114,71,1,166,32,173,5,209,144,15,121,91,243,82,
+151,186,229,255,127,222,160,68,97,189,50,157,208,71,194,102,242,20,231,173,
+75,162,240,63,64,175,169,242,173,33,56,84,93,218,6,76,55,57,218,114,
+165,169,67,249,235,101,93,30,235,71,126,239,204,252,106,130,177,13,132,237,
+116,193,19,115,114,160,182,201,35,68,117,11,26,109,219,38,47,67,71,224,
+35,50,91,34,224,185,51,126,204,185,143,9,66,204,120,139,124,139,117,51,
+2,141,108,4,254,35,21,170,73,76,15,179,49,113,172,130,112,184,135,224,
+146,49,116,99,131,62,199,8,222,51,65,30,246,47,13,173,52,232,209,62,
+68,224,68,245,243,70,9,159,199,68,86,64,245,25,150,184,82,11,246,178,
+249,60,7,105,118,250,60,147,170,154,44,43,219,228,211,231,209,154,155,243,
+82,135,93,226,177,117,136,72,113,39,76,171,202,46,42,77,70,83,1,152,
+18,44,96,58,54,155,137,57,47,126,143,196,114,157,99,109,3,36,227,146,
+20,140,2,113,21,122,125,120,8,148,2,100,22,26,137,81,161,244,253,96,
+179,14,230,254,246,160,14,32,14,59,49,170,251,22,40,253,167,109,131,59,
+115,94,160,1,118,126,150,109,110,219,15,195,54,30,196,136,139,35,47,125,
+255,25,127,224,82,157,198,5,181,240,61,149,141,251,6,192,207,221,47,60,
+31,97,63,226,144,139,77,231,246,147,222,158,87,21,101,89,153,249,83,49,
+240,217,129,137,96,19,206,240,50,233,25,188,201,63,193,107,4,140,48,129,
+28,38,237,14,195,65,145,75,239,237,247,167,126,54,139,144,185,149,205,38,
+96,68,170,43,158,31,74,201,244,242,157,149,94,125,215,189,180,19,159,111,
+226,103,237,155,134,148,241,219,240,105,140,222,191,22,251,82,154,214,91,11,
+212,116,4,156,107,197,24,31,0,110,243,153,112,1,155,108,183,197,213,43,
+75,221,185,122,188,49,252,253,118,255,129,52,243,248,150,63,214,56,217,145,
+35,62,4,46,239,206,158,208,108,135,83,197,108,105,19,25,233,64,190,93,
+100,164,27,140,86,138,72,109,240,20,112,15,227,9,106,71,197,0,8,51,
+3,10,60,110,206,247,35,145,11,173,243,221,54,193,51,26,198,190,144,146,
+100,67,223,76,98,42,199,89,45,222,173,86,8,163,228,189,18,157,255,226,
+109,66,131,149,238,14,103,198,99,134,39,177,158,96,40,247,173,84,129,112,
+115,94,120,42,76,105,187,84,205,198,116,205,214,146,176,160,19,27,164,16,
+84,204,84,174,140,38,86,192,105,119,81,146,115,139,217,18,129,146,223,91,
+2,33,252,206,200,237,32,179,169,99,203,125,70,200,216,210,63,20,236,118,
+150,189,163,90,28,3,46,164,137,73,47,68,255,146,250,20,112,214,140,75,
+185,55,60,73,202,237,8,241,199,157,102,236,201,165,222,57,225,221,145,1,
+139,58,206,225,157,189,18,226,181,201,187,98,29,216,46,113,88,82,62,180,
+43,151,136,253,153,221,210,160,240,2,83,231,174,61,20,55,2,67,175,104,
+135,157,148,248,174,65,108,215,32,43,132,43,72,3,152,93,123,143,124,139,
+200,122,171,170,38,47,205,47,129,46,15,136,150,221,227,73,98,122,214,99,
+223,187,188,114,196,124,49,38,239,9,66,123,72,115,246,144,140,14,165,14,
+149,231,106,98,232,127,249,131,155,15,142,238,160,100,208,166,185,87,83,59,
+114,4,38,125,140,229,143,221,171,4,108,233,34,46,83,229,227,158,74,100,
+216,54,134,227,72,130,197,114,95,158,13,75,166,73,227,64,196,61,132,186,
+183,168,94,147,229,1,227,214,24,129,243,182,88,79,15,220,71,107,82,209,
+19,56,61,84,48,202,199,140,149,157,130,140,88,237,48,12,237,185,32,46,
+10,155,140,188,136,187,138,251,181,84,25,112,147,92,128,185,177,111,104,196,
+41,151,86,93,38,232,65,162,212,151,133,216,131,217,151,253,207,50,235,107,
+33,58,77,171,140,220,0,225,225,233,251,47,131,210,144,82,199,116,104,134,
+1,214,179,83,239,155,128,116,205,166,71,246,235,172,71,10,171,105,34,56,
+138,237,162,46,76,96,234,100,61,206,5,25,56,126,75,218,91,94,172,7,
+202,27,104,215,91,172,13,17,113,86,168,45,8,92,247,82,22,129,244,12,
+46,47,59,248,250,10,104,121,226,107,146,153,123,206,10,111,186,9,199,223,
+117,169,225,119,221,200,223,49,234,130,52,153,72,7,205,214,233,103,53,90,
+105,250,238,135,200,108,144,125,199,170,2,208,227,30,17,26,184,40,143,165,
+65,183,116,186,222,160,40,113,116,237,74,119,217,10,159,80,146,71,148,25,
+232,34,248,234,138,237,73,245,163,138,207,72,239,122,186,4,141,212,75,56,
+155,227,171,4,97,168,221,167,92,98,126,196,85,115,100,121,65,204,37,190,
+85,181,209,81,11,128,171,138,104,39,100,56,249,216,216,47,142,172,115,98,
+226,106,141,27,134,74,200,26,91,162,193,23,209,33,67,46,74,180,81,238,
+139,160,137,179,137,89,173,124,143,4,202,250,66,105,43,199,178,222,116,174,
+21,218,13,122,241,18,146,123,173,74,46,102,135,86,32,27,87,128,49,56,
+64,55,255,246,134,140,114,40,97,108,57,216,96,134,131,112,194,193,120,84,
+109,28,4,245,130,3,181,147,149,72,138,93,139,238,62,182,85,242,228,216,
+100,217,148,172,79,228,43,90,241,237,182,218,219,88,101,14,254,54,73,15,
+101,184,72,236,118,172,167,130,92,201,191,122,27,177,129,186,3,49,47,184,
+36,40,232,63,61,96,218,105,99,71,156,42,67,133,198,40,26,159,171,161,
+61,134,30,32,194,60,25,41,48,125,96,198,40,43,216,62,172,136,119,12,
+42,149,237,30,64,26,245,158,201,73,13,176,130,197,106,178,150,146,26,82,
+177,179,29,208,7,77,5,217,101,187,167,74,144,226,132,183,209,146,88,0,
+84,212,189,96,4,138,84,67,166,229,186,34,172,244,120,200,81,198,227,91,
+42,74,221,151,192,217,6,146,85,142,66,77,177,147,47,115,231,15,104,196,
+207,114,70,62,134,92,15,69,50,27,197,49,137,168,222,81,223,43,121,227,
+239,103,234,87,241,119,107,16,226,237,69,240,48,38,85,18,52,104,71,109,
+59,93,236,170,188,149,123,2,104,84,151,40,178,84,119,186,174,93,242,96,
+184,89,143,57,3,61,36,24,234,18,95,122,148,17,115,5,189,250,21,151,
+231,28,234,164,220,237,123,236,133,246,37,75,205,70,234,143,153,180,27,179,
+110,106,69,89,171,69,190,187,91,163,68,3,155,48,149,215,216,113,138,228,
+32,218,158,138,162,53,117,88,93,109,147,56,145,151,20,224,109,164,144,90,
+255,27,182,185,103,23,28,63,141,118,5,148,95,68,37,103,163,148,109,139,
+209,229,12,115,216,1,213,215,8,30,156,101,87,20,191,83,165,135,67,201,
+133,45,73,184,22,222,167,60,105,250,145,100,137,135,22,89,188,119,26,169,
+99,110,113,19,20,248,73,106,41,206,97,102,246,108,191,171,195,104,175,159,
+150,78,44,126,137,87,200,177,200,56,42,177,76,117,30,119,157,183,77,194,
+239,83,152,12,166,157,1,94,232,82,10,115,113,57,4,108,19,116,195,33,
+9,168,180,227,67,198,191,113,145,104,193,198,231,63,70,205,192,113,133,213,
+145,83,53,86,50,208,214,105,151,85,46,3,147,24,26,212,86,57,21,96,
+131,86,171,188,50,234,107,5,199,175,183,181,29,115,121,152,171,46,232,8,
+203,144,183,253,45,111,117,152,134,53,211,19,104,138,102,155,114,5,74,252,
+107,144,62,64,173,51,170,77,110,224,56,24,9,68,226,199,124,251,64,134,
+247,7,100,207,208,10,84,61,91,100,207,138,170,49,187,86,61,35,76,123,
+86,160,241,224,153,124,64,5,246,8,37,137,58,160,236,251,142,214,144,94,
+163,3,70,86,16,78,159,222,238,56,167,4,254,38,57,119,250,122,83,89,
+140,104,16,181,93,169,100,8,41,251,190,165,209,48,193,190,86,15,131,76,
+55,203,67,6,119,31,197,37,35,220,64,102,12,132,174,235,166,42,141,27,
+236,203,68,71,86,99,141,77,34,91,249,57,80,121,74,55,178,189,127,64,
+118,87,22,219,82,6,127,223,45,213,148,20,79,230,102,215,69,86,223,99,
+31,201,235,8,30,201,216,151,64,28,214,243,113,112,147,127,182,95,12,35,
+10,62,235,205,110,3,228,19,222,82,114,145,11,51,102,221,0,235,184,168,
+174,19,131,14,83,169,223,89,154,68,90,150,90,173,20,69,94,0,82,74,
+216,136,43,206,128,245,85,134,29,102,167,66,171,159,71,143,167,68,197,96,
+66,186,141,53,25,119,129,10,203,39,39,154,79,215,124,255,182,130,182,203,
+230,243,53,59,168,35,18,169,211,189,250,184,158,46,193,227,123,26,232,84,
+216,142,35,11,177,172,135,84,67,177,37,149,173,154,89,172,21,222,243,199,
+210,52,86,49,39,99,182,64,153,14,254,184,81,219,10,237,61,68,254,48,
+244,218,125,98,225,97,209,124,139,49,122,112,18,106,172,193,243,170,33,183,
+251,18,90,162,49,28,101,90,12,52,65,11,237,22,230,248,13,114,164,158,
+85,74,58,65,176,156,91,20,186,114,30,18,25,234,140,108,74,56,49,140,
+190,135,110,129,188,163,95,86,64,242,117,210,129,61,72,22,33,246,244,12,
+7,134,193,128,62,41,96,125,185,132,191,45,178,21,22,75,162,2,163,70,
+174,20,128,62,185,53,168,222,207,80,53,221,213,102,71,181,10,86,187,234,
+152,125,87,229,13,157,218,99,245,170,227,77,35,35,147,48,189,188,110,140,
+158,118,78,109,165,133,73,134,252,216,253,115,155,103,139,170,186,196,147,58,
+92,251,150,45,99,189,61,10,54,72,216,138,221,240,31,105,139,50,59,113,
+164,124,120,46,164,232,18,249,115,228,5,7,89,246,113,159,236,185,108,47,
+4,252,213,173,145,64,39,32,186,146,246,237,103,122,150,241,145,11,100,18,
+155,110,22,209,254,196,229,154,174,4,236,67,233,138,124,155,47,117,165,169,
+128,22,38,214,138,116,109,132,22,114,172,193,166,185,199,31,65,52,194,194,
+29,45,146,16,65,73,244,226,222,130,42,233,54,156,37,229,237,46,240,141,
+234,10,196,54,87,203,184,119,181,201,22,47,85,175,11,206,89,113,101,142,
+163,25,10,60,221,107,138,154,56,254,166,154,32,250,65,149,79,102,24,76,
+6,40,181,189,212,151,222,224,84,36,52,175,247,7,114,143,200,142,131,74,
+70,60,196,170,225,56,158,254,0,72,221,116,221,139,74,10,45,26,8,25,
+5,130,90,219,74,126,103,230,64,193,105,160,169,236,208,71,66,114,32,198,
+157,21,172,241,220,115,35,153,92,17,83,235,68,103,137,41,188,86,245,29,
+139,6,20,13,53,213,121,74,203,179,254,14,123,7,142,75,193,158,21,74,
+237,13,8,199,36,155,175,115,179,142,213,205,32,27,52,190,60,194,16,61,
+12,52,30,66,123,254,248,244,240,163,252,84,175,1,49,208,170,60,75,91,
+122,79,190,43,27,61,98,217,132,9,116,165,65,136,51,7,187,221,179,35,
+41,195,24,169,195,53,249,227,151,182,188,201,183,177,123,91,36,44,81,80,
+125,147,111,71,245,72,4,202,254,233,159,187,62,176,169,183,193,157,49,143,
+92,33,244,158,185,171,103,98,108,4,56,146,13,38,191,215,45,122,4,96,
+42,40,39,41,38,94,182,39,137,250,226,59,153,176,248,93,101,26,224,161,
+173,40,169,40,204,126,170,125,122,141,191,231,200,178,101,138,75,165,72,110,
+100,24,54,96,168,175,22,80,211,87,148,182,251,190,33,186,255,149,236,127,
+37,251,95,201,254,175,151,236,127,165,168,33,69,93,145,43,29,173,221,72,
+32,70,27,55,10,67,180,113,184,135,168,160,143,217,27,223,175,241,165,145,
+178,231,228,38,142,69,215,61,54,36,44,88,160,48,48,52,8,125,198,59,
+11,107,113,80,219,117,39,123,122,44,188,147,172,208,229,132,25,228,73,92,
+208,23,62,148,131,74,62,14,118,86,98,81,92,18,130,245,10,254,207,119,
+55,208,213,229,187,55,240,255,151,200,59,49,54,10,69,22,66,64,95,137,
+195,37,34,18,99,20,135,131,191,5,226,70,125,175,108,93,92,186,140,100,
+194,177,152,72,70,101,207,34,191,60,138,78,148,49,162,48,46,60,76,91,
+25,163,17,195,210,205,211,225,64,223,233,126,58,197,213,165,73,198,247,172,
+117,215,143,86,77,89,190,126,158,112,129,36,214,79,35,80,47,167,165,13,
+107,10,181,148,21,197,151,209,144,47,183,192,91,95,91,157,71,66,4,199,
+193,73,7,0,144,207,122,113,131,31,15,222,105,243,109,159,164,36,201,210,
+172,75,109,46,122,38,236,25,14,210,179,169,200,126,107,81,98,110,194,97,
+45,137,74,11,97,108,236,84,213,178,219,225,13,61,195,4,107,95,180,209,
+218,60,206,66,35,134,243,137,63,82,42,125,108,90,86,223,184,54,40,133,
+242,36,73,70,253,186,81,233,241,62,62,205,134,13,76,145,199,148,42,159,
+90,195,217,149,97,98,243,8,43,53,122,167,91,230,140,232,69,191,102,199,
+198,103,51,19,25,74,206,181,23,67,48,133,157,241,35,194,122,91,128,178,
+154,235,225,162,215,71,219,136,202,24,65,208,18,89,82,62,81,220,193,100,
+157,162,183,129,18,21,43,222,194,9,216,153,77,216,25,122,53,143,194,168,
+4,121,183,99,5,196,96,226,142,148,137,68,133,3,195,207,203,231,25,27,
+223,97,231,211,146,11,249,228,46,208,159,26,137,212,114,190,214,32,97,122,
+114,1,153,132,97,67,151,185,200,252,62,250,189,207,243,135,55,71,135,229,
+248,114,174,75,197,1,30,156,242,230,234,226,58,28,64,171,131,189,232,61,
+147,244,154,228,110,114,179,132,227,117,80,242,53,86,193,14,215,172,87,164,
+60,73,137,154,109,228,100,90,249,239,174,106,150,57,154,14,200,189,141,5,
+45,52,185,45,197,201,141,127,81,136,253,226,100,9,45,62,97,205,10,123,
+27,43,6,97,96,9,253,166,220,85,234,216,90,20,183,206,95,30,219,223,
+119,246,86,30,169,98,106,99,63,9,139,184,196,19,163,0,131,63,190,226,
+2,103,225,34,57,216,29,172,131,254,12,151,120,98,249,157,215,235,79,97,
+44,67,96,68,192,111,241,106,69,218,221,22,73,84,129,65,102,32,147,213,
+70,83,128,45,195,234,138,78,83,94,99,67,69,252,217,89,77,37,196,49,
+54,53,20,52,23,201,234,11,41,172,156,169,192,214,172,64,28,113,230,197,
+43,196,64,115,172,230,100,213,138,182,123,61,77,26,30,55,178,194,50,14,
+83,57,76,147,185,141,233,114,116,174,232,221,209,34,137,179,23,245,50,7,
+18,235,142,221,250,100,145,72,191,100,31,32,31,111,208,95,178,180,86,144,
+221,50,199,18,112,27,100,178,112,113,54,229,35,95,31,89,40,195,214,24,
+97,55,25,166,127,96,17,64,220,66,91,185,43,184,45,30,141,173,121,107,
+99,198,10,42,163,209,187,225,211,75,158,242,245,121,89,250,4,222,186,161,
+147,21,189,190,126,186,48,198,16,74,116,215,75,221,227,86,98,221,184,129,
+3,154,34,142,45,45,23,209,184,7,119,63,65,13,235,246,188,145,111,199,
+96,200,21,120,107,14,142,248,56,46,126,132,229,178,216,1,74,133,179,176,
+70,27,153,139,94,80,10,171,189,45,21,118,236,117,131,97,1,160,124,231,
+36,208,248,166,110,199,173,187,242,130,103,116,172,183,50,92,247,131,225,158,
+253,69,147,208,30,91,239,36,199,46,2,26,38,173,2,137,139,63,151,101,
+155,81,58,109,176,73,68,108,121,144,190,142,151,224,98,92,114,233,123,144,
+203,28,119,170,85,247,208,180,200,176,164,239,23,249,86,83,201,165,166,101,
+88,243,237,182,192,100,62,186,22,6,86,81,206,179,1,245,178,229,43,70,
+217,146,225,247,130,137,15,118,59,105,224,48,241,136,116,89,13,31,146,190,
+24,214,152,242,197,164,108,121,169,94,213,169,244,136,21,236,118,149,30,16,
+3,11,116,183,63,190,196,176,237,225,96,5,231,35,203,100,216,109,14,43,
+79,207,85,243,170,164,39,162,175,220,57,234,77,184,235,221,112,92,14,82,
+0,56,253,253,23,168,154,243,148,204,163,225,72,86,230,236,31,170,197,244,
+145,117,186,172,165,26,215,92,55,108,42,200,97,225,35,33,62,46,166,88,
+70,132,64,15,10,247,96,89,39,192,136,43,137,36,153,31,58,167,253,23,
+145,28,27,233,54,136,80,169,179,141,46,218,70,106,212,158,77,68,17,94,
+92,127,200,164,120,90,59,238,233,44,123,35,145,129,162,202,45,21,240,81,
+21,126,69,181,155,154,182,148,128,146,182,27,229,1,99,170,248,116,58,193,
+13,245,192,87,115,98,159,103,189,155,230,164,196,155,191,163,142,30,132,105,
+104,93,179,157,38,137,201,117,77,94,194,236,107,220,215,238,2,135,129,101,
+206,106,56,17,203,122,17,104,255,145,240,81,107,208,158,127,182,214,186,187,
+104,118,245,60,175,187,175,84,76,27,170,140,171,35,71,183,238,160,136,153,
+115,6,115,179,13,75,223,89,147,70,79,147,29,64,148,182,194,175,117,85,
+2,203,56,120,77,223,5,54,100,48,116,105,142,188,120,17,26,222,196,45,
+229,239,215,214,78,142,83,98,73,6,3,93,177,235,141,254,7,87,64,9,
+244,82,119,53,143,107,144,209,157,62,237,39,142,74,40,27,140,242,178,47,
+251,190,11,177,96,189,215,197,167,88,146,234,117,240,254,10,121,212,15,139,
+228,109,31,178,136,135,55,245,188,150,8,54,239,107,179,112,100,29,2,114,
+54,121,81,12,158,153,183,124,221,219,232,126,27,124,199,104,158,125,71,129,
+202,136,12,208,181,10,171,112,47,130,82,0,24,34,135,213,113,10,46,112,
+92,184,29,141,87,56,142,92,51,233,192,73,226,19,117,23,221,229,74,18,
+213,183,1,228,198,69,233,193,88,40,40,17,147,105,154,46,56,190,9,213,
+135,8,212,123,189,73,45,141,35,108,190,74,98,132,192,166,251,7,166,114,
+160,119,10,138,157,213,183,93,163,97,56,133,9,15,59,158,106,217,140,180,
+198,202,109,35,222,23,119,208,15,14,139,179,114,156,2,133,224,238,129,229,
+224,239,243,2,21,29,11,207,112,66,124,14,105,183,74,85,117,57,59,17,
+177,76,251,189,203,175,177,123,235,54,103,98,46,184,116,151,216,209,244,116,
+14,28,142,212,193,56,234,94,139,168,24,118,107,83,110,131,186,230,191,159,
+85,215,188,19,2,115,136,188,231,29,16,202,229,46,208,217,140,31,115,138,
+46,12,9,213,44,173,218,197,86,228,97,202,72,20,148,60,43,96,213,80,
+207,27,144,172,84,121,107,81,75,100,237,111,89,158,152,93,209,87,79,22,
+141,66,107,62,119,127,38,232,117,250,124,210,180,235,188,65,143,169,217,212,
+233,46,141,84,25,189,181,81,242,57,223,74,42,57,37,82,194,101,8,103,
+172,188,67,221,121,101,209,158,24,148,198,74,46,242,96,172,64,38,105,118,
+163,94,199,37,79,250,235,255,74,215,218,172,127,196,13,120,89,151,143,218,
+131,131,194,225,207,185,79,7,109,75,7,20,5,34,121,146,91,242,157,202,
+183,108,238,140,164,14,204,13,161,161,68,149,243,202,151,159,98,8,3,233,
+249,73,135,99,251,17,172,224,29,102,182,165,74,154,100,207,184,29,14,121,
+91,231,91,179,110,220,55,207,108,237,58,155,181,226,21,68,246,124,25,249,
+0,113,156,69,189,46,255,164,106,239,39,183,185,57,124,8,164,226,72,111,
+218,248,65,56,246,175,113,190,131,41,137,225,241,47,121,187,36,3,211,164,
+206,245,242,139,115,181,123,197,3,248,225,183,123,143,65,87,135,138,43,135,
+222,200,112,85,252,45,111,79,148,192,76,151,43,234,162,151,187,140,102,135,
+193,61,101,146,127,156,109,48,85,25,152,153,56,49,204,96,149,243,178,188,
+178,245,154,253,108,15,217,14,177,165,223,70,127,177,156,100,184,82,194,10,
+23,68,11,204,195,255,246,121,148,148,28,236,210,186,191,212,147,43,249,241,
+144,61,155,230,191,82,206,88,205,106,98,88,101,33,187,215,57,66,116,106,
+148,202,36,214,41,123,109,115,165,233,90,100,52,13,216,210,51,208,210,234,
+90,230,136,18,191,235,216,58,245,175,37,181,34,34,19,229,225,85,125,131,
+5,26,45,197,225,133,242,72,61,141,204,135,98,154,109,190,50,87,198,160,
+137,249,125,239,87,200,136,92,120,24,57,114,4,223,144,83,88,163,210,108,
+250,53,210,127,198,86,169,129,230,137,25,88,119,74,68,188,158,149,105,185,
+239,80,245,186,110,180,161,59,19,180,97,233,79,28,191,116,178,172,7,209,
+105,10,172,0,72,254,165,120,145,161,241,191,255,225,63,255,227,191,164,71,
+153,231,12,139,145,51,89,209,250,206,176,31,217,245,194,189,77,216,146,220,
+146,210,177,177,166,194,224,131,67,57,81,17,25,122,44,234,2,29,9,81,
+240,98,189,171,63,205,22,180,10,106,221,195,6,116,226,118,2,160,233,135,
+150,165,248,206,124,3,100,137,117,82,38,85,149,6,39,123,76,96,239,202,
+10,151,189,89,96,144,247,45,168,145,233,99,151,212,189,134,95,78,232,228,
+254,110,131,136,23,102,21,158,85,159,230,235,61,61,86,170,238,40,24,86,
+178,34,91,117,135,85,124,246,226,17,204,93,57,49,95,94,157,2,216,141,
+242,55,0,104,206,190,30,144,55,119,23,3,213,148,130,163,194,23,191,136,
+193,86,12,232,76,39,233,238,49,234,150,83,60,8,34,202,148,21,106,76,
+36,176,203,59,243,97,91,98,90,227,64,206,224,226,9,108,211,205,73,141,
+24,174,34,127,209,211,17,6,125,30,78,101,62,104,59,52,189,222,210,118,
+47,56,4,64,129,128,35,103,47,243,98,109,127,218,171,90,72,35,93,1,
+169,226,171,92,189,149,65,198,183,102,33,219,4,158,151,234,243,130,245,101,
+178,77,132,45,243,140,80,26,171,19,112,193,48,139,15,150,158,217,110,184,
+131,110,173,219,232,247,70,255,67,245,57,194,184,139,179,167,67,67,52,107,
+34,6,102,59,222,112,28,42,68,8,59,164,153,19,39,250,93,156,129,206,
+146,108,102,92,39,251,36,22,244,20,87,83,213,234,22,150,126,140,79,85,
+80,134,21,247,198,178,49,183,43,181,84,89,225,242,179,153,53,108,199,47,
+134,137,176,147,105,187,102,96,39,79,217,197,167,76,185,169,241,70,66,175,
+229,139,180,61,243,141,188,121,229,11,169,31,103,229,245,212,161,156,228,182,
+188,60,71,204,111,194,50,247,17,251,1,241,132,234,34,193,166,108,242,239,
+155,22,90,252,30,67,176,116,77,127,255,225,228,135,31,254,31,64,170,189,
+200
\ No newline at end of file
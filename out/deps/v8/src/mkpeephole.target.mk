@@ -0,0 +1,143 @@
+# This file is generated by gyp; do not edit.
+
+TOOLSET := target
+TARGET := mkpeephole
+DEFS_Debug := \
+	'-DV8_TARGET_ARCH_X64' \
+	'-DENABLE_DISASSEMBLER' \
+	'-DV8_I18N_SUPPORT' \
+	'-DV8_ENABLE_CHECKS' \
+	'-DOBJECT_PRINT' \
+	'-DVERIFY_HEAP' \
+	'-DDEBUG' \
+	'-DTRACE_MAPS' \
+	'-D_GLIBCXX_DEBUG=1' \
+	'-DENABLE_HANDLE_ZAPPING' \
+	'-DENABLE_SLOW_DCHECKS' \
+	'-D_DEBUG'
+
+# Flags passed to all source files.
+CFLAGS_Debug := \
+	-pthread \
+	-Wall \
+	-Wextra \
+	-Wno-unused-parameter \
+	-m64 \
+	-fno-strict-aliasing \
+	-m64 \
+	-Woverloaded-virtual \
+	 \
+	-fdata-sections \
+	-ffunction-sections \
+	-g \
+	-O0
+
+# Flags passed to only C files.
+CFLAGS_C_Debug :=
+
+# Flags passed to only C++ files.
+CFLAGS_CC_Debug := \
+	-fno-rtti \
+	-fno-exceptions \
+	-std=gnu++0x
+
+INCS_Debug := \
+	-I$(srcdir)/deps/v8
+
+DEFS_Release := \
+	'-DV8_TARGET_ARCH_X64' \
+	'-DENABLE_DISASSEMBLER' \
+	'-DV8_I18N_SUPPORT'
+
+# Flags passed to all source files.
+CFLAGS_Release := \
+	-pthread \
+	-Wall \
+	-Wextra \
+	-Wno-unused-parameter \
+	-m64 \
+	-fno-strict-aliasing \
+	-m64 \
+	-fdata-sections \
+	-ffunction-sections \
+	 \
+	-O3 \
+	-O3 \
+	-fno-omit-frame-pointer
+
+# Flags passed to only C files.
+CFLAGS_C_Release :=
+
+# Flags passed to only C++ files.
+CFLAGS_CC_Release := \
+	-fno-rtti \
+	-fno-exceptions \
+	-std=gnu++0x
+
+INCS_Release := \
+	-I$(srcdir)/deps/v8
+
+OBJS := \
+	$(obj).target/$(TARGET)/deps/v8/src/interpreter/bytecode-operands.o \
+	$(obj).target/$(TARGET)/deps/v8/src/interpreter/bytecodes.o \
+	$(obj).target/$(TARGET)/deps/v8/src/interpreter/mkpeephole.o
+
+# Add to the list of files we specially track dependencies for.
+all_deps += $(OBJS)
+
+# Make sure our dependencies are built before any of us.
+$(OBJS): | $(obj).target/deps/v8/src/libv8_libbase.a
+
+# CFLAGS et al overrides must be target-local.
+# See "Target-specific Variable Values" in the GNU Make manual.
+$(OBJS): TOOLSET := $(TOOLSET)
+$(OBJS): GYP_CFLAGS := $(DEFS_$(BUILDTYPE)) $(INCS_$(BUILDTYPE))  $(CFLAGS_$(BUILDTYPE)) $(CFLAGS_C_$(BUILDTYPE))
+$(OBJS): GYP_CXXFLAGS := $(DEFS_$(BUILDTYPE)) $(INCS_$(BUILDTYPE))  $(CFLAGS_$(BUILDTYPE)) $(CFLAGS_CC_$(BUILDTYPE))
+
+# Suffix rules, putting all outputs into $(obj).
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(srcdir)/%.cc FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+# Try building from generated source, too.
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(obj).$(TOOLSET)/%.cc FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(obj)/%.cc FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+# End of this set of suffix rules
+### Rules for final target.
+LDFLAGS_Debug := \
+	-pthread \
+	-rdynamic \
+	-m64 \
+	-m64
+
+LDFLAGS_Release := \
+	-pthread \
+	-rdynamic \
+	-m64 \
+	-m64
+
+LIBS := \
+	-ldl \
+	-lrt
+
+$(builddir)/mkpeephole: GYP_LDFLAGS := $(LDFLAGS_$(BUILDTYPE))
+$(builddir)/mkpeephole: LIBS := $(LIBS)
+$(builddir)/mkpeephole: LD_INPUTS := $(OBJS) $(obj).target/deps/v8/src/libv8_libbase.a
+$(builddir)/mkpeephole: TOOLSET := $(TOOLSET)
+$(builddir)/mkpeephole: $(OBJS) $(obj).target/deps/v8/src/libv8_libbase.a FORCE_DO_CMD
+	$(call do_cmd,link)
+
+all_deps += $(builddir)/mkpeephole
+# Add target alias
+.PHONY: mkpeephole
+mkpeephole: $(builddir)/mkpeephole
+
+# Add executable to "all" target.
+.PHONY: all
+all: $(builddir)/mkpeephole
+
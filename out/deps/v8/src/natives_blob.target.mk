@@ -0,0 +1,14 @@
+# This file is generated by gyp; do not edit.
+
+TOOLSET := target
+TARGET := natives_blob
+### Rules for final target.
+$(obj).target/deps/v8/src/natives_blob.stamp: TOOLSET := $(TOOLSET)
+$(obj).target/deps/v8/src/natives_blob.stamp:  FORCE_DO_CMD
+	$(call do_cmd,touch)
+
+all_deps += $(obj).target/deps/v8/src/natives_blob.stamp
+# Add target alias
+.PHONY: natives_blob
+natives_blob: $(obj).target/deps/v8/src/natives_blob.stamp
+
@@ -0,0 +1,116 @@
+# This file is generated by gyp; do not edit.
+
+TOOLSET := host
+TARGET := node_js2c
+### Rules for action "node_js2c":
+quiet_cmd__root_repo_node_gyp_node_js2c_host_node_js2c = ACTION _root_repo_node_gyp_node_js2c_host_node_js2c $@
+cmd__root_repo_node_gyp_node_js2c_host_node_js2c = LD_LIBRARY_PATH=$(builddir)/lib.host:$(builddir)/lib.target:$$LD_LIBRARY_PATH; export LD_LIBRARY_PATH; cd $(srcdir)/.; mkdir -p $(obj)/gen; python tools/js2c.py "$(obj)/gen/node_javascript.cc" lib/internal/bootstrap_node.js lib/_debug_agent.js lib/_debugger.js lib/assert.js lib/buffer.js lib/child_process.js lib/console.js lib/constants.js lib/crypto.js lib/cluster.js lib/dgram.js lib/dns.js lib/domain.js lib/events.js lib/fs.js lib/http.js lib/_http_agent.js lib/_http_client.js lib/_http_common.js lib/_http_incoming.js lib/_http_outgoing.js lib/_http_server.js lib/https.js lib/module.js lib/net.js lib/os.js lib/path.js lib/process.js lib/punycode.js lib/querystring.js lib/readline.js lib/repl.js lib/stream.js lib/_stream_readable.js lib/_stream_writable.js lib/_stream_duplex.js lib/_stream_transform.js lib/_stream_passthrough.js lib/_stream_wrap.js lib/string_decoder.js lib/sys.js lib/timers.js lib/tls.js lib/_tls_common.js lib/_tls_legacy.js lib/_tls_wrap.js lib/tty.js lib/url.js lib/util.js lib/v8.js lib/vm.js lib/zlib.js lib/internal/buffer.js lib/internal/child_process.js lib/internal/cluster/child.js lib/internal/cluster/master.js lib/internal/cluster/round_robin_handle.js lib/internal/cluster/shared_handle.js lib/internal/cluster/utils.js lib/internal/cluster/worker.js lib/internal/errors.js lib/internal/freelist.js lib/internal/fs.js lib/internal/http.js lib/internal/linkedlist.js lib/internal/net.js lib/internal/module.js lib/internal/process/next_tick.js lib/internal/process/promises.js lib/internal/process/stdio.js lib/internal/process/warning.js lib/internal/process.js lib/internal/querystring.js lib/internal/process/write-coverage.js lib/internal/readline.js lib/internal/repl.js lib/internal/socket_list.js lib/internal/test/unicode.js lib/internal/url.js lib/internal/util.js lib/internal/v8_prof_polyfill.js lib/internal/v8_prof_processor.js lib/internal/streams/lazy_transform.js lib/internal/streams/BufferList.js lib/internal/streams/legacy.js deps/v8/tools/splaytree.js deps/v8/tools/codemap.js deps/v8/tools/consarray.js deps/v8/tools/csvparser.js deps/v8/tools/profile.js deps/v8/tools/profile_view.js deps/v8/tools/logreader.js deps/v8/tools/tickprocessor.js deps/v8/tools/SourceMap.js deps/v8/tools/tickprocessor-driver.js deps/node-inspect/lib/_inspect.js deps/node-inspect/lib/internal/inspect_client.js deps/node-inspect/lib/internal/inspect_repl.js ./config.gypi src/notrace_macros.py src/nolttng_macros.py src/perfctr_macros.py
+
+$(obj)/gen/node_javascript.cc: obj := $(abs_obj)
+$(obj)/gen/node_javascript.cc: builddir := $(abs_builddir)
+$(obj)/gen/node_javascript.cc: TOOLSET := $(TOOLSET)
+$(obj)/gen/node_javascript.cc: $(srcdir)/lib/internal/bootstrap_node.js $(srcdir)/lib/_debug_agent.js $(srcdir)/lib/_debugger.js $(srcdir)/lib/assert.js $(srcdir)/lib/buffer.js $(srcdir)/lib/child_process.js $(srcdir)/lib/console.js $(srcdir)/lib/constants.js $(srcdir)/lib/crypto.js $(srcdir)/lib/cluster.js $(srcdir)/lib/dgram.js $(srcdir)/lib/dns.js $(srcdir)/lib/domain.js $(srcdir)/lib/events.js $(srcdir)/lib/fs.js $(srcdir)/lib/http.js $(srcdir)/lib/_http_agent.js $(srcdir)/lib/_http_client.js $(srcdir)/lib/_http_common.js $(srcdir)/lib/_http_incoming.js $(srcdir)/lib/_http_outgoing.js $(srcdir)/lib/_http_server.js $(srcdir)/lib/https.js $(srcdir)/lib/module.js $(srcdir)/lib/net.js $(srcdir)/lib/os.js $(srcdir)/lib/path.js $(srcdir)/lib/process.js $(srcdir)/lib/punycode.js $(srcdir)/lib/querystring.js $(srcdir)/lib/readline.js $(srcdir)/lib/repl.js $(srcdir)/lib/stream.js $(srcdir)/lib/_stream_readable.js $(srcdir)/lib/_stream_writable.js $(srcdir)/lib/_stream_duplex.js $(srcdir)/lib/_stream_transform.js $(srcdir)/lib/_stream_passthrough.js $(srcdir)/lib/_stream_wrap.js $(srcdir)/lib/string_decoder.js $(srcdir)/lib/sys.js $(srcdir)/lib/timers.js $(srcdir)/lib/tls.js $(srcdir)/lib/_tls_common.js $(srcdir)/lib/_tls_legacy.js $(srcdir)/lib/_tls_wrap.js $(srcdir)/lib/tty.js $(srcdir)/lib/url.js $(srcdir)/lib/util.js $(srcdir)/lib/v8.js $(srcdir)/lib/vm.js $(srcdir)/lib/zlib.js $(srcdir)/lib/internal/buffer.js $(srcdir)/lib/internal/child_process.js $(srcdir)/lib/internal/cluster/child.js $(srcdir)/lib/internal/cluster/master.js $(srcdir)/lib/internal/cluster/round_robin_handle.js $(srcdir)/lib/internal/cluster/shared_handle.js $(srcdir)/lib/internal/cluster/utils.js $(srcdir)/lib/internal/cluster/worker.js $(srcdir)/lib/internal/errors.js $(srcdir)/lib/internal/freelist.js $(srcdir)/lib/internal/fs.js $(srcdir)/lib/internal/http.js $(srcdir)/lib/internal/linkedlist.js $(srcdir)/lib/internal/net.js $(srcdir)/lib/internal/module.js $(srcdir)/lib/internal/process/next_tick.js $(srcdir)/lib/internal/process/promises.js $(srcdir)/lib/internal/process/stdio.js $(srcdir)/lib/internal/process/warning.js $(srcdir)/lib/internal/process.js $(srcdir)/lib/internal/querystring.js $(srcdir)/lib/internal/process/write-coverage.js $(srcdir)/lib/internal/readline.js $(srcdir)/lib/internal/repl.js $(srcdir)/lib/internal/socket_list.js $(srcdir)/lib/internal/test/unicode.js $(srcdir)/lib/internal/url.js $(srcdir)/lib/internal/util.js $(srcdir)/lib/internal/v8_prof_polyfill.js $(srcdir)/lib/internal/v8_prof_processor.js $(srcdir)/lib/internal/streams/lazy_transform.js $(srcdir)/lib/internal/streams/BufferList.js $(srcdir)/lib/internal/streams/legacy.js $(srcdir)/deps/v8/tools/splaytree.js $(srcdir)/deps/v8/tools/codemap.js $(srcdir)/deps/v8/tools/consarray.js $(srcdir)/deps/v8/tools/csvparser.js $(srcdir)/deps/v8/tools/profile.js $(srcdir)/deps/v8/tools/profile_view.js $(srcdir)/deps/v8/tools/logreader.js $(srcdir)/deps/v8/tools/tickprocessor.js $(srcdir)/deps/v8/tools/SourceMap.js $(srcdir)/deps/v8/tools/tickprocessor-driver.js $(srcdir)/deps/node-inspect/lib/_inspect.js $(srcdir)/deps/node-inspect/lib/internal/inspect_client.js $(srcdir)/deps/node-inspect/lib/internal/inspect_repl.js $(srcdir)/config.gypi $(srcdir)/src/notrace_macros.py $(srcdir)/src/nolttng_macros.py $(srcdir)/src/perfctr_macros.py FORCE_DO_CMD
+	$(call do_cmd,_root_repo_node_gyp_node_js2c_host_node_js2c)
+
+all_deps += $(obj)/gen/node_javascript.cc
+action__root_repo_node_gyp_node_js2c_host_node_js2c_outputs := $(obj)/gen/node_javascript.cc
+
+
+DEFS_Debug := \
+	'-DDEBUG' \
+	'-D_DEBUG' \
+	'-DV8_ENABLE_CHECKS'
+
+# Flags passed to all source files.
+CFLAGS_Debug := \
+	-pthread \
+	-Wall \
+	-Wextra \
+	-Wno-unused-parameter \
+	-m64 \
+	-g \
+	-O0
+
+# Flags passed to only C files.
+CFLAGS_C_Debug :=
+
+# Flags passed to only C++ files.
+CFLAGS_CC_Debug := \
+	-fno-rtti \
+	-fno-exceptions \
+	-std=gnu++0x
+
+INCS_Debug :=
+
+DEFS_Release :=
+
+# Flags passed to all source files.
+CFLAGS_Release := \
+	-pthread \
+	-Wall \
+	-Wextra \
+	-Wno-unused-parameter \
+	-m64 \
+	-O3 \
+	-fno-omit-frame-pointer
+
+# Flags passed to only C files.
+CFLAGS_C_Release :=
+
+# Flags passed to only C++ files.
+CFLAGS_CC_Release := \
+	-fno-rtti \
+	-fno-exceptions \
+	-std=gnu++0x
+
+INCS_Release :=
+
+OBJS := \
+	$(obj).host/$(TARGET)/gen/node_javascript.o
+
+# Add to the list of files we specially track dependencies for.
+all_deps += $(OBJS)
+
+# Make sure our actions/rules run before any of us.
+$(OBJS): | $(action__root_repo_node_gyp_node_js2c_host_node_js2c_outputs)
+
+# CFLAGS et al overrides must be target-local.
+# See "Target-specific Variable Values" in the GNU Make manual.
+$(OBJS): TOOLSET := $(TOOLSET)
+$(OBJS): GYP_CFLAGS := $(DEFS_$(BUILDTYPE)) $(INCS_$(BUILDTYPE))  $(CFLAGS_$(BUILDTYPE)) $(CFLAGS_C_$(BUILDTYPE))
+$(OBJS): GYP_CXXFLAGS := $(DEFS_$(BUILDTYPE)) $(INCS_$(BUILDTYPE))  $(CFLAGS_$(BUILDTYPE)) $(CFLAGS_CC_$(BUILDTYPE))
+
+# Suffix rules, putting all outputs into $(obj).
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(srcdir)/%.cc FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+# Try building from generated source, too.
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(obj).$(TOOLSET)/%.cc FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(obj)/%.cc FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+# End of this set of suffix rules
+### Rules for final target.
+# Build our special outputs first.
+$(obj).host/node_js2c.stamp: | $(action__root_repo_node_gyp_node_js2c_host_node_js2c_outputs)
+
+# Preserve order dependency of special output on deps.
+$(action__root_repo_node_gyp_node_js2c_host_node_js2c_outputs): | 
+
+$(obj).host/node_js2c.stamp: TOOLSET := $(TOOLSET)
+$(obj).host/node_js2c.stamp:  FORCE_DO_CMD
+	$(call do_cmd,touch)
+
+all_deps += $(obj).host/node_js2c.stamp
+# Add target alias
+.PHONY: node_js2c
+node_js2c: $(obj).host/node_js2c.stamp
+
+# Add target alias to "all" target.
+.PHONY: all
+all: node_js2c
+
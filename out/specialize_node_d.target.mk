@@ -0,0 +1,18 @@
+# This file is generated by gyp; do not edit.
+
+TOOLSET := target
+TARGET := specialize_node_d
+### Rules for final target.
+$(obj).target/specialize_node_d.stamp: TOOLSET := $(TOOLSET)
+$(obj).target/specialize_node_d.stamp:  FORCE_DO_CMD
+	$(call do_cmd,touch)
+
+all_deps += $(obj).target/specialize_node_d.stamp
+# Add target alias
+.PHONY: specialize_node_d
+specialize_node_d: $(obj).target/specialize_node_d.stamp
+
+# Add target alias to "all" target.
+.PHONY: all
+all: specialize_node_d
+
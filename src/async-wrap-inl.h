@@ -51,6 +51,11 @@ inline int64_t AsyncWrap::get_uid() const {
 }
 
 
+inline int64_t AsyncWrap::get_trigger_id() const {
+  return trigger_id_;
+}
+
+
 inline v8::Local<v8::Value> AsyncWrap::MakeCallback(
     const v8::Local<v8::String> symbol,
     int argc,
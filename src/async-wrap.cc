@@ -23,6 +23,8 @@
 #include "async-wrap-inl.h"
 #include "env.h"
 #include "env-inl.h"
+#include "node_probes.h"
+#include "tracing/trace_event.h"
 #include "util.h"
 #include "util-inl.h"
 
@@ -30,8 +32,10 @@
 #include "v8.h"
 #include "v8-profiler.h"
 
+using v8::ArrayBuffer;
 using v8::Boolean;
 using v8::Context;
+using v8::Float64Array;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
@@ -56,6 +60,75 @@ static const char* const provider_names[] = {
 #undef V
 };
 
+static const char* const callback_names[] = {
+#define V(PROVIDER)                                                           \
+  #PROVIDER "_CALLBACK",
+  NODE_ASYNC_PROVIDER_TYPES(V)
+#undef V
+};
+
+
+// Returns the flag of the node.async_hooks trace category if it is recorded.
+// Each AsyncWrap is then an async event from its creation to its destruction,
+// and each of its callbacks an event on the main thread. CPU profile samples
+// can be attributed to resources by the callback events that they fall into.
+static const uint8_t* AsyncHooksTraceCategory() {
+  // There is no platform without NODE_USE_V8_PLATFORM.
+  if (tracing::TraceEventHelper::GetCurrentPlatform() == nullptr)
+    return nullptr;
+  static const uint8_t* category_enabled =
+      TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED("node.async_hooks");
+  if (!(*category_enabled & kEnabledForRecording_CategoryGroupEnabledFlags))
+    return nullptr;
+  return category_enabled;
+}
+
+
+// Makes |wrap| the current resource while its callback runs.
+class CallbackExecutionScope {
+ public:
+  explicit CallbackExecutionScope(AsyncWrap* wrap)
+      : wrap_(wrap),
+        env_(wrap->env()),
+        previous_id_(env_->current_async_id()),
+        category_enabled_(AsyncHooksTraceCategory()),
+        name_(callback_names[wrap->provider_type()]) {
+    env_->set_current_async_id(wrap->get_uid());
+    if (NODE_ASYNC_BEFORE_ENABLED())
+      NODE_ASYNC_BEFORE(wrap->get_uid(), provider_names[wrap->provider_type()]);
+    if (category_enabled_ != nullptr) {
+      handle_ = tracing::AddTraceEvent(
+          TRACE_EVENT_PHASE_COMPLETE, category_enabled_, name_,
+          tracing::kGlobalScope, tracing::kNoId, tracing::kNoId,
+          TRACE_EVENT_FLAG_NONE,
+          "asyncId", wrap->get_uid(),
+          "triggerAsyncId", wrap->get_trigger_id());
+    }
+  }
+
+  ~CallbackExecutionScope() {
+    if (category_enabled_ != nullptr) {
+      TRACE_EVENT_API_UPDATE_TRACE_EVENT_DURATION(category_enabled_, name_,
+                                                  handle_);
+    }
+    if (NODE_ASYNC_AFTER_ENABLED()) {
+      NODE_ASYNC_AFTER(wrap_->get_uid(),
+                       provider_names[wrap_->provider_type()]);
+    }
+    env_->set_current_async_id(previous_id_);
+  }
+
+ private:
+  AsyncWrap* const wrap_;
+  Environment* const env_;
+  const int64_t previous_id_;
+  const uint8_t* const category_enabled_;
+  const char* const name_;
+  uint64_t handle_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(CallbackExecutionScope);
+};
+
 
 class RetainedAsyncInfo: public RetainedObjectInfo {
  public:
@@ -126,6 +199,20 @@ RetainedObjectInfo* WrapperInfo(uint16_t class_id, Local<Value> wrapper) {
 // end RetainedAsyncInfo
 
 
+static void UpdateHookFields(Environment* env) {
+  Environment::AsyncHooks* hooks = env->async_hooks();
+  hooks->set_has_hook(Environment::AsyncHooks::kInit,
+                      !env->async_hooks_init_function().IsEmpty());
+  hooks->set_has_hook(Environment::AsyncHooks::kPre,
+                      !env->async_hooks_pre_function().IsEmpty());
+  hooks->set_has_hook(Environment::AsyncHooks::kPost,
+                      !env->async_hooks_post_function().IsEmpty());
+  hooks->set_has_hook(Environment::AsyncHooks::kDestroy,
+                      !env->async_hooks_destroy_function().IsEmpty() ||
+                      !env->async_hooks_destroy_batch_function().IsEmpty());
+}
+
+
 static void EnableHooksJS(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   Local<Function> init_fn = env->async_hooks_init_function();
@@ -163,6 +250,9 @@ static void SetupHooks(const FunctionCallbackInfo<Value>& args) {
   Local<Value> destroy_v = fn_obj->Get(
       env->context(),
       FIXED_ONE_BYTE_STRING(env->isolate(), "destroy")).ToLocalChecked();
+  Local<Value> destroy_batch_v = fn_obj->Get(
+      env->context(),
+      FIXED_ONE_BYTE_STRING(env->isolate(), "destroyBatch")).ToLocalChecked();
 
   if (!init_v->IsFunction())
     return env->ThrowTypeError("init callback must be a function");
@@ -175,6 +265,10 @@ static void SetupHooks(const FunctionCallbackInfo<Value>& args) {
     env->set_async_hooks_post_function(post_v.As<Function>());
   if (destroy_v->IsFunction())
     env->set_async_hooks_destroy_function(destroy_v.As<Function>());
+  if (destroy_batch_v->IsFunction())
+    env->set_async_hooks_destroy_batch_function(destroy_batch_v.As<Function>());
+
+  UpdateHookFields(env);
 }
 
 
@@ -201,6 +295,8 @@ void AsyncWrap::Initialize(Local<Object> target,
   env->set_async_hooks_pre_function(Local<Function>());
   env->set_async_hooks_post_function(Local<Function>());
   env->set_async_hooks_destroy_function(Local<Function>());
+  env->set_async_hooks_destroy_batch_function(Local<Function>());
+  UpdateHookFields(env);
 }
 
 
@@ -214,14 +310,33 @@ void AsyncWrap::DestroyIdsCb(uv_idle_t* handle) {
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
   Local<Function> fn = env->async_hooks_destroy_function();
+  Local<Function> batch_fn = env->async_hooks_destroy_batch_function();
 
-  if (fn.IsEmpty())
+  if (fn.IsEmpty() && batch_fn.IsEmpty())
     return env->destroy_ids_list()->clear();
 
   TryCatch try_catch(env->isolate());
 
   std::vector<int64_t> destroy_ids_list;
   destroy_ids_list.swap(*env->destroy_ids_list());
+
+  // One call for all of them, with the ids in a Float64Array.
+  if (!batch_fn.IsEmpty()) {
+    const size_t count = destroy_ids_list.size();
+    Local<ArrayBuffer> ab =
+        ArrayBuffer::New(env->isolate(), count * sizeof(double));
+    double* ids = static_cast<double*>(ab->GetContents().Data());
+    for (size_t i = 0; i < count; i++)
+      ids[i] = static_cast<double>(destroy_ids_list[i]);
+    Local<Value> argv = Float64Array::New(ab, 0, count);
+    MaybeLocal<Value> ret = batch_fn->Call(
+        env->context(), Undefined(env->isolate()), 1, &argv);
+    if (ret.IsEmpty()) {
+      ClearFatalExceptionHandlers(env);
+      FatalException(env->isolate(), try_catch);
+    }
+    return;
+  }
   for (auto current_id : destroy_ids_list) {
     // Want each callback to be cleaned up after itself, instead of cleaning
     // them all up after the while() loop completes.
@@ -255,17 +370,28 @@ AsyncWrap::AsyncWrap(Environment* env,
                      ProviderType provider,
                      AsyncWrap* parent)
     : BaseObject(env, object), bits_(static_cast<uint32_t>(provider) << 1),
-      uid_(env->get_async_wrap_uid()) {
+      uid_(env->get_async_wrap_uid()),
+      trigger_id_(parent != nullptr ? parent->get_uid() :
+                                      env->current_async_id()) {
   CHECK_NE(provider, PROVIDER_NONE);
   CHECK_GE(object->InternalFieldCount(), 1);
 
   // Shift provider value over to prevent id collision.
   persistent().SetWrapperClassId(NODE_ASYNC_ID_OFFSET + provider);
 
-  Local<Function> init_fn = env->async_hooks_init_function();
+  const uint8_t* category_enabled = AsyncHooksTraceCategory();
+  if (category_enabled != nullptr) {
+    tracing::AddTraceEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN,
+                           category_enabled, provider_names[provider],
+                           tracing::kGlobalScope, uid_, tracing::kNoId,
+                           TRACE_EVENT_FLAG_HAS_ID,
+                           "triggerAsyncId", trigger_id_);
+  }
+  if (NODE_ASYNC_INIT_ENABLED())
+    NODE_ASYNC_INIT(uid_, provider_names[provider], trigger_id_);
 
   // No init callback exists, no reason to go on.
-  if (init_fn.IsEmpty())
+  if (!env->async_hooks()->has_hook(Environment::AsyncHooks::kInit))
     return;
 
   // If async wrap callbacks are disabled and no parent was passed that has
@@ -290,6 +416,7 @@ AsyncWrap::AsyncWrap(Environment* env,
 
   TryCatch try_catch(env->isolate());
 
+  Local<Function> init_fn = env->async_hooks_init_function();
   MaybeLocal<Value> ret =
       init_fn->Call(env->context(), object, arraysize(argv), argv);
 
@@ -303,7 +430,18 @@ AsyncWrap::AsyncWrap(Environment* env,
 
 
 AsyncWrap::~AsyncWrap() {
-  if (!ran_init_callback())
+  const uint8_t* category_enabled = AsyncHooksTraceCategory();
+  if (category_enabled != nullptr) {
+    tracing::AddTraceEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_END,
+                           category_enabled, provider_names[provider_type()],
+                           tracing::kGlobalScope, uid_, tracing::kNoId,
+                           TRACE_EVENT_FLAG_HAS_ID);
+  }
+  if (NODE_ASYNC_DESTROY_ENABLED())
+    NODE_ASYNC_DESTROY(uid_, provider_names[provider_type()]);
+
+  if (!ran_init_callback() ||
+      !env()->async_hooks()->has_hook(Environment::AsyncHooks::kDestroy))
     return;
 
   if (env()->destroy_ids_list()->empty())
@@ -316,11 +454,39 @@ AsyncWrap::~AsyncWrap() {
 Local<Value> AsyncWrap::MakeCallback(const Local<Function> cb,
                                      int argc,
                                      Local<Value>* argv) {
+  return MakeCallback(object(), cb, argc, argv);
+}
+
+
+Local<Value> AsyncWrap::MakeCallback(Local<Value> recv,
+                                     const Local<Function> cb,
+                                     int argc,
+                                     Local<Value>* argv) {
   CHECK(env()->context() == env()->isolate()->GetCurrentContext());
 
-  Local<Function> pre_fn = env()->async_hooks_pre_function();
-  Local<Function> post_fn = env()->async_hooks_post_function();
-  Local<Value> uid = Number::New(env()->isolate(), get_uid());
+  // Most callbacks run without domains or hooks, see node::MakeCallback().
+  if (!env()->callback_hooks_active()) {
+    Environment::AsyncCallbackScope callback_scope(env());
+    Local<Value> ret;
+    {
+      CallbackExecutionScope execution_scope(this);
+      ret = cb->Call(recv, argc, argv);
+    }
+    if (ret.IsEmpty() || callback_scope.in_makecallback() ||
+        TickAfterCallback(env())) {
+      return ret;
+    }
+    return Local<Value>();
+  }
+
+  Environment::AsyncHooks* hooks = env()->async_hooks();
+  const bool run_pre =
+      ran_init_callback() && hooks->has_hook(Environment::AsyncHooks::kPre);
+  const bool run_post =
+      ran_init_callback() && hooks->has_hook(Environment::AsyncHooks::kPost);
+  Local<Value> uid;
+  if (run_pre || run_post)
+    uid = Number::New(env()->isolate(), get_uid());
   Local<Object> context = object();
   Local<Object> domain;
   bool has_domain = false;
@@ -347,8 +513,9 @@ Local<Value> AsyncWrap::MakeCallback(const Local<Function> cb,
     }
   }
 
-  if (ran_init_callback() && !pre_fn.IsEmpty()) {
+  if (run_pre) {
     TryCatch try_catch(env()->isolate());
+    Local<Function> pre_fn = env()->async_hooks_pre_function();
     MaybeLocal<Value> ar = pre_fn->Call(env()->context(), context, 1, &uid);
     if (ar.IsEmpty()) {
       ClearFatalExceptionHandlers(env());
@@ -357,12 +524,17 @@ Local<Value> AsyncWrap::MakeCallback(const Local<Function> cb,
     }
   }
 
-  Local<Value> ret = cb->Call(context, argc, argv);
+  Local<Value> ret;
+  {
+    CallbackExecutionScope execution_scope(this);
+    ret = cb->Call(recv, argc, argv);
+  }
 
-  if (ran_init_callback() && !post_fn.IsEmpty()) {
+  if (run_post) {
     Local<Value> did_throw = Boolean::New(env()->isolate(), ret.IsEmpty());
     Local<Value> vals[] = { uid, did_throw };
     TryCatch try_catch(env()->isolate());
+    Local<Function> post_fn = env()->async_hooks_post_function();
     MaybeLocal<Value> ar =
         post_fn->Call(env()->context(), context, arraysize(vals), vals);
     if (ar.IsEmpty()) {
@@ -390,20 +562,7 @@ Local<Value> AsyncWrap::MakeCallback(const Local<Function> cb,
     return ret;
   }
 
-  Environment::TickInfo* tick_info = env()->tick_info();
-
-  if (tick_info->length() == 0) {
-    env()->isolate()->RunMicrotasks();
-  }
-
-  Local<Object> process = env()->process_object();
-
-  if (tick_info->length() == 0) {
-    tick_info->set_index(0);
-    return ret;
-  }
-
-  if (env()->tick_callback_function()->Call(process, 0, nullptr).IsEmpty()) {
+  if (!TickAfterCallback(env())) {
     return Local<Value>();
   }
 
@@ -41,8 +41,12 @@ namespace node {
   V(FSREQWRAP)                                                                \
   V(GETADDRINFOREQWRAP)                                                       \
   V(GETNAMEINFOREQWRAP)                                                       \
+  V(HTTP2SESSION)                                                             \
   V(HTTPPARSER)                                                               \
+  V(JSONPARSER)                                                               \
   V(JSSTREAM)                                                                 \
+  V(MESSAGEPORT)                                                              \
+  V(NAPIASYNCCONTEXT)                                                         \
   V(PIPEWRAP)                                                                 \
   V(PIPECONNECTWRAP)                                                          \
   V(PROCESSWRAP)                                                              \
@@ -50,6 +54,7 @@ namespace node {
   V(SHUTDOWNWRAP)                                                             \
   V(SIGNALWRAP)                                                               \
   V(STATWATCHER)                                                              \
+  V(STREAMPIPE)                                                               \
   V(TCPWRAP)                                                                  \
   V(TCPCONNECTWRAP)                                                           \
   V(TIMERWRAP)                                                                \
@@ -57,6 +62,7 @@ namespace node {
   V(TTYWRAP)                                                                  \
   V(UDPWRAP)                                                                  \
   V(UDPSENDWRAP)                                                              \
+  V(WORKER)                                                                   \
   V(WRITEWRAP)                                                                \
   V(ZLIB)
 
@@ -87,11 +93,20 @@ class AsyncWrap : public BaseObject {
   inline ProviderType provider_type() const;
 
   inline int64_t get_uid() const;
+  // The uid of the parent, or of the AsyncWrap whose callback was running
+  // when this one was created. 0 if there was none.
+  inline int64_t get_trigger_id() const;
 
   // Only call these within a valid HandleScope.
   v8::Local<v8::Value> MakeCallback(const v8::Local<v8::Function> cb,
                                      int argc,
                                      v8::Local<v8::Value>* argv);
+  // Calls |cb| on |recv| rather than on object(), for callers like N-API
+  // whose callbacks do not belong to the wrapped object.
+  v8::Local<v8::Value> MakeCallback(v8::Local<v8::Value> recv,
+                                     const v8::Local<v8::Function> cb,
+                                     int argc,
+                                     v8::Local<v8::Value>* argv);
   inline v8::Local<v8::Value> MakeCallback(const v8::Local<v8::String> symbol,
                                             int argc,
                                             v8::Local<v8::Value>* argv);
@@ -110,6 +125,7 @@ class AsyncWrap : public BaseObject {
   // that will be used to call pre/post in MakeCallback.
   uint32_t bits_;
   const int64_t uid_;
+  const int64_t trigger_id_;
 };
 
 void LoadAsyncWrapperInfo(Environment* env);
@@ -69,7 +69,7 @@ inline void BaseObject::WeakCallback(
     const v8::WeakCallbackInfo<Type>& data) {
   Type* self = data.GetParameter();
   self->persistent().Reset();
-  delete self;
+  self->env()->QueueCollectedBaseObject(self);
 }
 
 
@@ -24,6 +24,7 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include "util.h"
 #include "v8.h"
 
 namespace node {
@@ -59,6 +60,8 @@ class BaseObject {
   inline void ClearWeak();
 
  private:
+  friend class Environment;
+
   BaseObject();
 
   template <typename Type>
@@ -67,6 +70,9 @@ class BaseObject {
 
   v8::Persistent<v8::Object> persistent_handle_;
   Environment* env_;
+  // In Environment::collected_base_objects_ from when the object was garbage
+  // collected until it's deleted.
+  ListNode<BaseObject> collected_queue_node_;
 };
 
 }  // namespace node
@@ -0,0 +1,358 @@
+#include "base64.h"
+#include "node_cpu.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace node {
+
+namespace {
+
+#if NODE_SIMD_X86
+
+// Encoding, after Wojciech Muła's pshufb method. Each 32 bit lane takes three
+// input bytes, is spread out so every 6 bit index sits in a byte of its own,
+// and the indices are turned into characters by adding an offset looked up
+// by which of the five ranges of the alphabet they fall in.
+NODE_SIMD_TARGET("ssse3")
+inline __m128i EncodeSplit(__m128i in) {
+  in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10,
+                                         7, 8, 6, 7,
+                                         4, 5, 3, 4,
+                                         1, 2, 0, 1));
+  const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(t1, t3);
+}
+
+NODE_SIMD_TARGET("ssse3")
+inline __m128i EncodeTranslate(__m128i indices) {
+  // 0 for 'a'-'z', 1-10 for '0'-'9', 11 and 12 for '+' and '/', 13 for 'A'-'Z'.
+  __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+  const __m128i offsets = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+      '/' - 63, 'A', 0, 0);
+  return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+}
+
+NODE_SIMD_TARGET("ssse3")
+size_t EncodeSSSE3(const char* src, size_t slen, char* dst) {
+  size_t i = 0;
+  size_t k = 0;
+  // Reads 16 bytes to encode 12 of them.
+  while (i + 16 <= slen) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i out = EncodeTranslate(EncodeSplit(in));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k), out);
+    i += 12;
+    k += 16;
+  }
+  return i;
+}
+
+NODE_SIMD_TARGET("avx2")
+size_t EncodeAVX2(const char* src, size_t slen, char* dst) {
+  const __m256i split_shuffle = _mm256_setr_epi8(
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  const __m256i offsets = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+      '/' - 63, 'A', 0, 0,
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+      '/' - 63, 'A', 0, 0);
+  size_t i = 0;
+  size_t k = 0;
+  // Each 128 bit lane encodes 12 bytes, the second lane reads 16 bytes from
+  // 12 bytes in.
+  while (i + 28 <= slen) {
+    const __m128i lo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    in = _mm256_shuffle_epi8(in, split_shuffle);
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 =
+        _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 =
+        _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(t1, t3);
+
+    __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    range = _mm256_or_si256(range,
+                            _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+    const __m256i out =
+        _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k), out);
+    i += 24;
+    k += 32;
+  }
+  return i;
+}
+
+
+// Decoding checks every character against the ranges of the alphabet. The
+// URL-safe '-' and '_' are accepted like the scalar decoder does. Anything
+// else, whitespace and padding included, stops the kernel so the scalar code
+// can deal with it. 6 bit values are packed back together two multiplies at
+// a time.
+NODE_SIMD_TARGET("ssse3")
+inline bool DecodeTranslate(__m128i in, __m128i* values) {
+  const __m128i upper =
+      _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), in));
+  const __m128i lower =
+      _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), in));
+  const __m128i digit =
+      _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), in));
+  const __m128i plus = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+  const __m128i dash = _mm_cmpeq_epi8(in, _mm_set1_epi8('-'));
+  const __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+  const __m128i underscore = _mm_cmpeq_epi8(in, _mm_set1_epi8('_'));
+  const __m128i valid =
+      _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), digit),
+                   _mm_or_si128(_mm_or_si128(plus, dash),
+                                _mm_or_si128(slash, underscore)));
+  if (_mm_movemask_epi8(valid) != 0xFFFF)
+    return false;
+
+  __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+  shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+  shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+  shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+  shift = _mm_or_si128(shift, _mm_and_si128(dash, _mm_set1_epi8(62 - '-')));
+  shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+  shift = _mm_or_si128(shift,
+                       _mm_and_si128(underscore, _mm_set1_epi8(63 - '_')));
+  *values = _mm_add_epi8(in, shift);
+  return true;
+}
+
+NODE_SIMD_TARGET("ssse3")
+inline __m128i DecodePack(__m128i values) {
+  // Pairs of 6 bit values into 12 bits, then pairs of those into 24 bits,
+  // and the three bytes of every 32 bit lane moved to the front in order.
+  const __m128i pairs =
+      _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  const __m128i triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+  return _mm_shuffle_epi8(triples, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                                 14, 13, 12, -1, -1, -1, -1));
+}
+
+// Stores exactly 12 bytes, the caller's buffer may end right after them.
+NODE_SIMD_TARGET("ssse3")
+inline void Store12(char* dst, __m128i bytes) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), bytes);
+  const int32_t last = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+  memcpy(dst + 8, &last, sizeof(last));
+}
+
+NODE_SIMD_TARGET("ssse3")
+size_t DecodeSSSE3(char* dst, const char* src, size_t slen) {
+  size_t i = 0;
+  size_t k = 0;
+  while (i + 16 <= slen) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i values;
+    if (!DecodeTranslate(in, &values))
+      break;
+    Store12(dst + k, DecodePack(values));
+    i += 16;
+    k += 12;
+  }
+  return i;
+}
+
+NODE_SIMD_TARGET("avx2")
+size_t DecodeAVX2(char* dst, const char* src, size_t slen) {
+  size_t i = 0;
+  size_t k = 0;
+  while (i + 32 <= slen) {
+    const __m256i in =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i upper =
+        _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('A' - 1)),
+                         _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), in));
+    const __m256i lower =
+        _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('a' - 1)),
+                         _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), in));
+    const __m256i digit =
+        _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)),
+                         _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), in));
+    const __m256i plus = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('+'));
+    const __m256i dash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('-'));
+    const __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+    const __m256i underscore = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('_'));
+    const __m256i valid = _mm256_or_si256(
+        _mm256_or_si256(_mm256_or_si256(upper, lower), digit),
+        _mm256_or_si256(_mm256_or_si256(plus, dash),
+                        _mm256_or_si256(slash, underscore)));
+    if (_mm256_movemask_epi8(valid) != -1)
+      break;
+
+    __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+    shift = _mm256_or_si256(
+        shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+    shift = _mm256_or_si256(
+        shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+    shift = _mm256_or_si256(
+        shift, _mm256_and_si256(plus, _mm256_set1_epi8(62 - '+')));
+    shift = _mm256_or_si256(
+        shift, _mm256_and_si256(dash, _mm256_set1_epi8(62 - '-')));
+    shift = _mm256_or_si256(
+        shift, _mm256_and_si256(slash, _mm256_set1_epi8(63 - '/')));
+    shift = _mm256_or_si256(
+        shift, _mm256_and_si256(underscore, _mm256_set1_epi8(63 - '_')));
+    const __m256i values = _mm256_add_epi8(in, shift);
+
+    const __m256i pairs =
+        _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    const __m256i triples =
+        _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    const __m256i packed = _mm256_shuffle_epi8(triples, _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    Store12(dst + k, _mm256_castsi256_si128(packed));
+    Store12(dst + k + 12, _mm256_extracti128_si256(packed, 1));
+    i += 32;
+    k += 24;
+  }
+  // Finish off a 16 character block that doesn't make a whole 32.
+  return i + DecodeSSSE3(dst + k, src + i, slen - i);
+}
+
+#elif NODE_SIMD_NEON
+
+inline uint8x16_t DecodeShift(uint8x16_t in, uint8x16_t* valid) {
+  const uint8x16_t upper = vcltq_u8(vsubq_u8(in, vdupq_n_u8('A')),
+                                    vdupq_n_u8(26));
+  const uint8x16_t lower = vcltq_u8(vsubq_u8(in, vdupq_n_u8('a')),
+                                    vdupq_n_u8(26));
+  const uint8x16_t digit = vcltq_u8(vsubq_u8(in, vdupq_n_u8('0')),
+                                    vdupq_n_u8(10));
+  const uint8x16_t plus = vceqq_u8(in, vdupq_n_u8('+'));
+  const uint8x16_t dash = vceqq_u8(in, vdupq_n_u8('-'));
+  const uint8x16_t slash = vceqq_u8(in, vdupq_n_u8('/'));
+  const uint8x16_t underscore = vceqq_u8(in, vdupq_n_u8('_'));
+  *valid = vandq_u8(*valid,
+                    vorrq_u8(vorrq_u8(vorrq_u8(upper, lower), digit),
+                             vorrq_u8(vorrq_u8(plus, dash),
+                                      vorrq_u8(slash, underscore))));
+  // Offsets wrap around modulo 256.
+  uint8x16_t shift = vandq_u8(upper, vdupq_n_u8(static_cast<uint8_t>(-'A')));
+  shift = vorrq_u8(shift, vandq_u8(lower, vdupq_n_u8(26 - 'a')));
+  shift = vorrq_u8(shift, vandq_u8(digit, vdupq_n_u8(52 - '0')));
+  shift = vorrq_u8(shift, vandq_u8(plus, vdupq_n_u8(62 - '+')));
+  shift = vorrq_u8(shift, vandq_u8(dash, vdupq_n_u8(62 - '-')));
+  shift = vorrq_u8(shift, vandq_u8(slash, vdupq_n_u8(63 - '/')));
+  shift = vorrq_u8(shift, vandq_u8(underscore,
+                                   vdupq_n_u8(static_cast<uint8_t>(63 - '_'))));
+  return vaddq_u8(in, shift);
+}
+
+#endif  // NODE_SIMD_NEON
+
+}  // anonymous namespace
+
+
+size_t base64_encode_simd(const char* src, size_t slen, char* dst) {
+#if NODE_SIMD_X86
+  switch (cpu::GetLevel()) {
+    case cpu::kAVX2:
+      return EncodeAVX2(src, slen, dst);
+    case cpu::kSSSE3:
+      return EncodeSSSE3(src, slen, dst);
+    case cpu::kBaseline:
+      break;
+  }
+  return 0;
+#elif NODE_SIMD_NEON
+  static const uint8_t table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                 "abcdefghijklmnopqrstuvwxyz"
+                                 "0123456789+/";
+  const uint8x16x4_t lookup = {{ vld1q_u8(table + 0), vld1q_u8(table + 16),
+                                 vld1q_u8(table + 32), vld1q_u8(table + 48) }};
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+  uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+  size_t i = 0;
+  size_t k = 0;
+  while (i + 48 <= slen) {
+    const uint8x16x3_t abc = vld3q_u8(in + i);
+    const uint8x16_t a = abc.val[0];
+    const uint8x16_t b = abc.val[1];
+    const uint8x16_t c = abc.val[2];
+    uint8x16x4_t indices;
+    indices.val[0] = vshrq_n_u8(a, 2);
+    indices.val[1] = vorrq_u8(vandq_u8(vshlq_n_u8(a, 4), vdupq_n_u8(0x30)),
+                              vshrq_n_u8(b, 4));
+    indices.val[2] = vorrq_u8(vandq_u8(vshlq_n_u8(b, 2), vdupq_n_u8(0x3c)),
+                              vshrq_n_u8(c, 6));
+    indices.val[3] = vandq_u8(c, vdupq_n_u8(0x3f));
+    uint8x16x4_t chars;
+    for (int j = 0; j < 4; j++)
+      chars.val[j] = vqtbl4q_u8(lookup, indices.val[j]);
+    vst4q_u8(out + k, chars);
+    i += 48;
+    k += 64;
+  }
+  return i;
+#else
+  return 0;
+#endif
+}
+
+
+size_t base64_decode_simd(char* dst, const char* src, size_t slen) {
+#if NODE_SIMD_X86
+  switch (cpu::GetLevel()) {
+    case cpu::kAVX2:
+      return DecodeAVX2(dst, src, slen);
+    case cpu::kSSSE3:
+      return DecodeSSSE3(dst, src, slen);
+    case cpu::kBaseline:
+      break;
+  }
+  return 0;
+#elif NODE_SIMD_NEON
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+  uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+  size_t i = 0;
+  size_t k = 0;
+  while (i + 64 <= slen) {
+    const uint8x16x4_t chars = vld4q_u8(in + i);
+    uint8x16_t valid = vdupq_n_u8(0xff);
+    const uint8x16_t v0 = DecodeShift(chars.val[0], &valid);
+    const uint8x16_t v1 = DecodeShift(chars.val[1], &valid);
+    const uint8x16_t v2 = DecodeShift(chars.val[2], &valid);
+    const uint8x16_t v3 = DecodeShift(chars.val[3], &valid);
+    if (vminvq_u8(valid) == 0)
+      break;
+    uint8x16x3_t bytes;
+    bytes.val[0] = vorrq_u8(vshlq_n_u8(v0, 2), vshrq_n_u8(v1, 4));
+    bytes.val[1] = vorrq_u8(vshlq_n_u8(v1, 4), vshrq_n_u8(v2, 2));
+    bytes.val[2] = vorrq_u8(vshlq_n_u8(v2, 6), v3);
+    vst3q_u8(out + k, bytes);
+    i += 64;
+    k += 48;
+  }
+  return i;
+#else
+  return 0;
+#endif
+}
+
+}  // namespace node
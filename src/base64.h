@@ -47,6 +47,16 @@ size_t base64_decoded_size(const TypeName* src, size_t size) {
 extern const int8_t unbase64_table[256];
 
 
+// Vectorized kernels for one byte input, defined in base64.cc. They work
+// through |src| in whole blocks and return how much of it they consumed,
+// always a multiple of three bytes for encoding and four characters for
+// decoding. Decoding stops at the first block with anything in it besides
+// the base64 alphabet and leaves that to the scalar code below. They return
+// 0 when the CPU has no suitable vector unit.
+size_t base64_encode_simd(const char* src, size_t slen, char* dst);
+size_t base64_decode_simd(char* dst, const char* src, size_t slen);
+
+
 #define unbase64(x)                                                           \
   static_cast<uint8_t>(unbase64_table[static_cast<uint8_t>(x)])
 
@@ -82,6 +92,24 @@ bool base64_decode_group_slow(char* const dst, const size_t dstlen,
 }
 
 
+// Hands the whole groups before |max_i| that fit in |max_k| to the
+// vectorized decoder.
+template <typename TypeName>
+void base64_decode_vector(char* const dst, const size_t max_k,
+                          const TypeName* const src, const size_t max_i,
+                          size_t* const i, size_t* const k) {
+  if (sizeof(TypeName) != 1 || *i >= max_i || *k >= max_k)
+    return;
+  const size_t chars = (max_i - *i) / 4 * 4;
+  const size_t room = (max_k - *k) / 3 * 4;
+  const size_t n = base64_decode_simd(dst + *k,
+                                      reinterpret_cast<const char*>(src + *i),
+                                      chars < room ? chars : room);
+  *i += n;
+  *k += n / 4 * 3;
+}
+
+
 template <typename TypeName>
 size_t base64_decode_fast(char* const dst, const size_t dstlen,
                           const TypeName* const src, const size_t srclen,
@@ -91,6 +119,7 @@ size_t base64_decode_fast(char* const dst, const size_t dstlen,
   size_t max_i = srclen / 4 * 4;
   size_t i = 0;
   size_t k = 0;
+  base64_decode_vector(dst, max_k, src, max_i, &i, &k);
   while (i < max_i && k < max_k) {
     const uint32_t v =
         unbase64(src[i + 0]) << 24 |
@@ -103,6 +132,7 @@ size_t base64_decode_fast(char* const dst, const size_t dstlen,
       if (!base64_decode_group_slow(dst, dstlen, src, srclen, &i, &k))
         return k;
       max_i = old_i + (srclen - i) / 4 * 4;  // Align max_i again.
+      base64_decode_vector(dst, max_k, src, max_i, &i, &k);
     } else {
       dst[k + 0] = ((v >> 22) & 0xFC) | ((v >> 20) & 0x03);
       dst[k + 1] = ((v >> 12) & 0xF0) | ((v >> 10) & 0x0F);
@@ -146,8 +176,8 @@ static size_t base64_encode(const char* src,
                               "abcdefghijklmnopqrstuvwxyz"
                               "0123456789+/";
 
-  i = 0;
-  k = 0;
+  i = static_cast<unsigned>(base64_encode_simd(src, slen, dst));
+  k = i / 3 * 4;
   n = slen / 3 * 3;
 
   while (i < n) {
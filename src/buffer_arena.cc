@@ -0,0 +1,169 @@
+#include "buffer_arena.h"
+#include "util.h"
+#include "util-inl.h"
+
+#include <stdlib.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace node {
+
+namespace {
+
+// Slabs are aligned to their size so that the slab of a block is found by
+// masking off the low bits of its address.
+void* AlignedAlloc(size_t size) {
+#ifdef _WIN32
+  return _aligned_malloc(size, size);
+#else
+  void* data;
+  if (posix_memalign(&data, size, size) != 0)
+    return nullptr;
+  return data;
+#endif
+}
+
+void AlignedFree(void* data) {
+#ifdef _WIN32
+  _aligned_free(data);
+#else
+  free(data);
+#endif
+}
+
+}  // anonymous namespace
+
+
+const size_t BufferArena::kMinSize;
+const size_t BufferArena::kMaxSize;
+const size_t BufferArena::kSlabSize;
+
+
+BufferArena::BufferArena() {
+  for (Slab*& slab : available_)
+    slab = nullptr;
+}
+
+
+BufferArena::~BufferArena() {
+  for (const auto& entry : slabs_) {
+    AlignedFree(entry.second->base);
+    delete entry.second;
+  }
+}
+
+
+size_t BufferArena::SizeClass(size_t size) {
+  size_t size_class = 0;
+  for (size_t block_size = kMinSize; block_size < size; block_size *= 2)
+    size_class++;
+  return size_class;
+}
+
+
+void* BufferArena::Allocate(size_t size) {
+  if (size == 0 || size > kMaxSize)
+    return nullptr;
+  const size_t size_class = SizeClass(size);
+
+  Mutex::ScopedLock lock(mutex_);
+  Slab* slab = available_[size_class];
+  if (slab == nullptr) {
+    slab = NewSlab(size_class);
+    if (slab == nullptr)
+      return nullptr;
+  }
+
+  void* block;
+  if (slab->free_list != nullptr) {
+    block = slab->free_list;
+    slab->free_list = *static_cast<void**>(block);
+  } else {
+    block = slab->base + slab->bump;
+    slab->bump += slab->block_size;
+  }
+  if (++slab->used == kSlabSize / slab->block_size)
+    Unlink(slab);
+  return block;
+}
+
+
+bool BufferArena::Free(void* data) {
+  const uintptr_t mask = ~static_cast<uintptr_t>(kSlabSize - 1);
+  const uintptr_t base = reinterpret_cast<uintptr_t>(data) & mask;
+
+  Mutex::ScopedLock lock(mutex_);
+  auto it = slabs_.find(base);
+  if (it == slabs_.end())
+    return false;
+
+  Slab* slab = it->second;
+  *static_cast<void**>(data) = slab->free_list;
+  slab->free_list = data;
+  if (slab->used-- == kSlabSize / slab->block_size)
+    Link(slab);
+  // Keep one slab with room around, so that a buffer that is allocated and
+  // freed over and over doesn't map and unmap a slab each time.
+  if (slab->used == 0 && (slab->prev != nullptr || slab->next != nullptr))
+    DeleteSlab(slab);
+  return true;
+}
+
+
+size_t BufferArena::slab_bytes() const {
+  Mutex::ScopedLock lock(mutex_);
+  return slabs_.size() * kSlabSize;
+}
+
+
+BufferArena::Slab* BufferArena::NewSlab(size_t size_class) {
+  char* base = static_cast<char*>(AlignedAlloc(kSlabSize));
+  if (base == nullptr)
+    return nullptr;
+
+  Slab* slab = new Slab();
+  slab->base = base;
+  slab->size_class = size_class;
+  slab->block_size = kMinSize << size_class;
+  slab->used = 0;
+  slab->bump = 0;
+  slab->free_list = nullptr;
+  slab->prev = nullptr;
+  slab->next = nullptr;
+  slabs_[reinterpret_cast<uintptr_t>(base)] = slab;
+  Link(slab);
+  return slab;
+}
+
+
+void BufferArena::DeleteSlab(Slab* slab) {
+  Unlink(slab);
+  slabs_.erase(reinterpret_cast<uintptr_t>(slab->base));
+  AlignedFree(slab->base);
+  delete slab;
+}
+
+
+void BufferArena::Link(Slab* slab) {
+  Slab*& head = available_[slab->size_class];
+  slab->prev = nullptr;
+  slab->next = head;
+  if (head != nullptr)
+    head->prev = slab;
+  head = slab;
+}
+
+
+void BufferArena::Unlink(Slab* slab) {
+  if (slab->prev != nullptr)
+    slab->prev->next = slab->next;
+  else
+    available_[slab->size_class] = slab->next;
+  if (slab->next != nullptr)
+    slab->next->prev = slab->prev;
+  slab->prev = nullptr;
+  slab->next = nullptr;
+}
+
+}  // namespace node
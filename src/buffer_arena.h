@@ -0,0 +1,74 @@
+#ifndef SRC_BUFFER_ARENA_H_
+#define SRC_BUFFER_ARENA_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node_mutex.h"
+#include "util.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+
+namespace node {
+
+// Serves small ArrayBuffer backing stores out of slabs that each hold blocks
+// of one size class, the powers of two from kMinSize to kMaxSize. Freed
+// blocks go on a free list of their slab and are handed out again before the
+// slab's untouched tail, and a slab that has no blocks in use is given back
+// unless it is the last one of its size class with room.
+//
+// V8 may free ArrayBuffers from its sweeper threads, so all of it is behind
+// a lock.
+class BufferArena {
+ public:
+  static const size_t kMinSize = 64;
+  static const size_t kMaxSize = 64 * 1024;
+  static const size_t kSlabSize = 256 * 1024;
+
+  BufferArena();
+  ~BufferArena();
+
+  // Returns an uninitialized block of at least |size| bytes, or nullptr when
+  // |size| is 0 or larger than kMaxSize or when there is no memory left.
+  void* Allocate(size_t size);
+
+  // Returns false, and does nothing, if |data| did not come from Allocate().
+  bool Free(void* data);
+
+  // Bytes held in slabs, whether their blocks are in use or not.
+  size_t slab_bytes() const;
+
+ private:
+  static const size_t kSizeClasses = 11;  // 64 bytes to 64 kB.
+
+  struct Slab {
+    char* base;
+    size_t size_class;
+    size_t block_size;
+    size_t used;      // Blocks handed out and not freed again.
+    size_t bump;      // Offset of the first block never handed out.
+    void* free_list;  // Freed blocks, linked through their first word.
+    Slab* prev;       // In the list of slabs of the size class with room.
+    Slab* next;
+  };
+
+  static size_t SizeClass(size_t size);
+
+  Slab* NewSlab(size_t size_class);
+  void DeleteSlab(Slab* slab);
+  void Link(Slab* slab);
+  void Unlink(Slab* slab);
+
+  Mutex mutex_;
+  Slab* available_[kSizeClasses];
+  std::unordered_map<uintptr_t, Slab*> slabs_;  // By base address.
+
+  DISALLOW_COPY_AND_ASSIGN(BufferArena);
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_BUFFER_ARENA_H_
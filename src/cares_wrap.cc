@@ -23,9 +23,12 @@
 #include "ares.h"
 #include "async-wrap.h"
 #include "async-wrap-inl.h"
+#include "base-object.h"
+#include "base-object-inl.h"
 #include "env.h"
 #include "env-inl.h"
 #include "node.h"
+#include "node_threadpool.h"
 #include "req-wrap.h"
 #include "req-wrap-inl.h"
 #include "tree.h"
@@ -37,6 +40,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #if defined(__ANDROID__) || \
     defined(__MINGW32__) || \
     defined(__OpenBSD__) || \
@@ -101,30 +108,67 @@ inline const char* ToErrorCodeString(int status) {
   return "UNKNOWN_ARES_ERROR";
 }
 
+// getaddrinfo() and getnameinfo() block, so they are run synchronously on
+// the DNS thread pool rather than on libuv's, where a slow resolver would
+// hold up file system work.
 class GetAddrInfoReqWrap : public ReqWrap<uv_getaddrinfo_t> {
  public:
-  GetAddrInfoReqWrap(Environment* env, Local<Object> req_wrap_obj);
+  GetAddrInfoReqWrap(Environment* env,
+                     Local<Object> req_wrap_obj,
+                     const char* hostname,
+                     const struct addrinfo& hints);
+
+  int Queue();
 
   size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  static void Work(uv_work_t* work_req);
+  static void AfterWork(uv_work_t* work_req, int status);
+
+  uv_work_t work_req_;
+  const std::string hostname_;
+  const struct addrinfo hints_;
+  int retcode_;
 };
 
 GetAddrInfoReqWrap::GetAddrInfoReqWrap(Environment* env,
-                                       Local<Object> req_wrap_obj)
-    : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_GETADDRINFOREQWRAP) {
+                                       Local<Object> req_wrap_obj,
+                                       const char* hostname,
+                                       const struct addrinfo& hints)
+    : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_GETADDRINFOREQWRAP),
+      hostname_(hostname),
+      hints_(hints),
+      retcode_(0) {
   Wrap(req_wrap_obj, this);
 }
 
 
 class GetNameInfoReqWrap : public ReqWrap<uv_getnameinfo_t> {
  public:
-  GetNameInfoReqWrap(Environment* env, Local<Object> req_wrap_obj);
+  GetNameInfoReqWrap(Environment* env,
+                     Local<Object> req_wrap_obj,
+                     const struct sockaddr_storage& addr);
+
+  int Queue();
 
   size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  static void Work(uv_work_t* work_req);
+  static void AfterWork(uv_work_t* work_req, int status);
+
+  uv_work_t work_req_;
+  const struct sockaddr_storage addr_;
+  int retcode_;
 };
 
 GetNameInfoReqWrap::GetNameInfoReqWrap(Environment* env,
-                                       Local<Object> req_wrap_obj)
-    : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_GETNAMEINFOREQWRAP) {
+                                       Local<Object> req_wrap_obj,
+                                       const struct sockaddr_storage& addr)
+    : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_GETNAMEINFOREQWRAP),
+      addr_(addr),
+      retcode_(0) {
   Wrap(req_wrap_obj, this);
 }
 
@@ -141,13 +185,46 @@ int cmp_ares_tasks(const node_ares_task* a, const node_ares_task* b) {
 RB_GENERATE_STATIC(node_ares_task_list, node_ares_task, node, cmp_ares_tasks)
 
 
+/* The data of ares_sockstate_cb() for a channel. The sockets of all channels */
+/* of an Environment are in its task list and share its timer. */
+struct node_ares_channel {
+  Environment* env;
+  ares_channel channel;
+};
+
+
+bool ares_channel_has_tasks(Environment* env, ares_channel channel) {
+  node_ares_task* task;
+  RB_FOREACH(task, node_ares_task_list, env->cares_task_list()) {
+    if (task->channel == channel)
+      return true;
+  }
+  return false;
+}
+
 
 /* This is called once per second by loop->timer. It is used to constantly */
 /* call back into c-ares for possibly processing timeouts. */
 void ares_timeout(uv_timer_t* handle) {
   Environment* env = Environment::from_cares_timer_handle(handle);
   CHECK_EQ(false, RB_EMPTY(env->cares_task_list()));
-  ares_process_fd(env->cares_channel(), ARES_SOCKET_BAD, ARES_SOCKET_BAD);
+
+  /* Processing a channel can close sockets and call into JS, where other */
+  /* channels can be destroyed, so the channels are collected first and */
+  /* skipped when they have no sockets left. */
+  std::vector<ares_channel> channels;
+  node_ares_task* task;
+  RB_FOREACH(task, node_ares_task_list, env->cares_task_list()) {
+    if (std::find(channels.begin(), channels.end(), task->channel) ==
+        channels.end()) {
+      channels.push_back(task->channel);
+    }
+  }
+
+  for (ares_channel channel : channels) {
+    if (ares_channel_has_tasks(env, channel))
+      ares_process_fd(channel, ARES_SOCKET_BAD, ARES_SOCKET_BAD);
+  }
 }
 
 
@@ -161,12 +238,12 @@ void ares_poll_cb(uv_poll_t* watcher, int status, int events) {
   if (status < 0) {
     /* An error happened. Just pretend that the socket is both readable and */
     /* writable. */
-    ares_process_fd(env->cares_channel(), task->sock, task->sock);
+    ares_process_fd(task->channel, task->sock, task->sock);
     return;
   }
 
   /* Process DNS responses */
-  ares_process_fd(env->cares_channel(),
+  ares_process_fd(task->channel,
                   events & UV_READABLE ? task->sock : ARES_SOCKET_BAD,
                   events & UV_WRITABLE ? task->sock : ARES_SOCKET_BAD);
 }
@@ -180,7 +257,9 @@ void ares_poll_close_cb(uv_handle_t* watcher) {
 
 
 /* Allocates and returns a new node_ares_task */
-node_ares_task* ares_task_create(Environment* env, ares_socket_t sock) {
+node_ares_task* ares_task_create(Environment* env,
+                                 ares_channel channel,
+                                 ares_socket_t sock) {
   auto task = node::UncheckedMalloc<node_ares_task>(1);
 
   if (task == nullptr) {
@@ -189,6 +268,7 @@ node_ares_task* ares_task_create(Environment* env, ares_socket_t sock) {
   }
 
   task->env = env;
+  task->channel = channel;
   task->sock = sock;
 
   if (uv_poll_init_socket(env->event_loop(), &task->poll_watcher, sock) < 0) {
@@ -206,7 +286,8 @@ void ares_sockstate_cb(void* data,
                        ares_socket_t sock,
                        int read,
                        int write) {
-  Environment* env = static_cast<Environment*>(data);
+  node_ares_channel* channel = static_cast<node_ares_channel*>(data);
+  Environment* env = channel->env;
   node_ares_task* task;
 
   node_ares_task lookup_task;
@@ -224,7 +305,7 @@ void ares_sockstate_cb(void* data,
         uv_timer_start(timer_handle, ares_timeout, 1000, 1000);
       }
 
-      task = ares_task_create(env, sock);
+      task = ares_task_create(env, channel->channel, sock);
       if (task == nullptr) {
         /* This should never happen unless we're out of memory or something */
         /* is seriously wrong. The socket won't be polled, but the query will */
@@ -289,8 +370,9 @@ Local<Array> HostentToNames(Environment* env, struct hostent* host) {
 
 class QueryWrap : public AsyncWrap {
  public:
-  QueryWrap(Environment* env, Local<Object> req_wrap_obj)
-      : AsyncWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_QUERYWRAP) {
+  QueryWrap(Environment* env, Local<Object> req_wrap_obj, ares_channel channel)
+      : AsyncWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_QUERYWRAP),
+        channel_(channel) {
     if (env->in_domain())
       req_wrap_obj->Set(env->domain_string(), env->domain_array()->Get(0));
   }
@@ -312,6 +394,8 @@ class QueryWrap : public AsyncWrap {
     return 0;
   }
 
+  ares_channel channel() const { return channel_; }
+
  protected:
   void* GetQueryArg() {
     return static_cast<void*>(this);
@@ -373,303 +457,341 @@ class QueryWrap : public AsyncWrap {
   virtual void Parse(struct hostent* host) {
     UNREACHABLE();
   }
+
+ private:
+  ares_channel channel_;
 };
 
 
-class QueryAWrap: public QueryWrap {
- public:
-  QueryAWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
-  }
+// Parses the answer to a query into `answer`, and the TTLs of A and AAAA
+// records into `extra`. Returns ARES_SUCCESS or the c-ares error.
+typedef int (*ReplyParser)(Environment* env,
+                           unsigned char* buf,
+                           int len,
+                           Local<Value>* answer,
+                           Local<Value>* extra);
 
-  int Send(const char* name) override {
-    ares_query(env()->cares_channel(),
-               name,
-               ns_c_in,
-               ns_t_a,
-               Callback,
-               GetQueryArg());
-    return 0;
-  }
 
-  size_t self_size() const override { return sizeof(*this); }
+int ParseAReply(Environment* env,
+                unsigned char* buf,
+                int len,
+                Local<Value>* answer,
+                Local<Value>* extra) {
+  hostent* host;
+  ares_addrttl addrttls[256];
+  int naddrttls = arraysize(addrttls);
 
- protected:
-  void Parse(unsigned char* buf, int len) override {
-    HandleScope handle_scope(env()->isolate());
-    Context::Scope context_scope(env()->context());
+  int status = ares_parse_a_reply(buf, len, &host, addrttls, &naddrttls);
+  if (status != ARES_SUCCESS)
+    return status;
 
-    hostent* host;
-    ares_addrttl addrttls[256];
-    int naddrttls = arraysize(addrttls);
+  Local<Array> addresses = HostentToAddresses(env, host);
+  Local<Array> ttls = Array::New(env->isolate(), naddrttls);
 
-    int status = ares_parse_a_reply(buf, len, &host, addrttls, &naddrttls);
-    if (status != ARES_SUCCESS) {
-      ParseError(status);
-      return;
-    }
+  auto context = env->context();
+  for (int i = 0; i < naddrttls; i += 1) {
+    auto value = Integer::New(env->isolate(), addrttls[i].ttl);
+    ttls->Set(context, i, value).FromJust();
+  }
+  ares_free_hostent(host);
 
-    Local<Array> addresses = HostentToAddresses(env(), host);
-    Local<Array> ttls = Array::New(env()->isolate(), naddrttls);
+  *answer = addresses;
+  *extra = ttls;
+  return ARES_SUCCESS;
+}
 
-    auto context = env()->context();
-    for (int i = 0; i < naddrttls; i += 1) {
-      auto value = Integer::New(env()->isolate(), addrttls[i].ttl);
-      ttls->Set(context, i, value).FromJust();
-    }
-    ares_free_hostent(host);
 
-    CallOnComplete(addresses, ttls);
-  }
-};
+int ParseAaaaReply(Environment* env,
+                   unsigned char* buf,
+                   int len,
+                   Local<Value>* answer,
+                   Local<Value>* extra) {
+  hostent* host;
+  ares_addr6ttl addrttls[256];
+  int naddrttls = arraysize(addrttls);
 
+  int status = ares_parse_aaaa_reply(buf, len, &host, addrttls, &naddrttls);
+  if (status != ARES_SUCCESS)
+    return status;
 
-class QueryAaaaWrap: public QueryWrap {
- public:
-  QueryAaaaWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
-  }
+  Local<Array> addresses = HostentToAddresses(env, host);
+  Local<Array> ttls = Array::New(env->isolate(), naddrttls);
 
-  int Send(const char* name) override {
-    ares_query(env()->cares_channel(),
-               name,
-               ns_c_in,
-               ns_t_aaaa,
-               Callback,
-               GetQueryArg());
-    return 0;
+  auto context = env->context();
+  for (int i = 0; i < naddrttls; i += 1) {
+    auto value = Integer::New(env->isolate(), addrttls[i].ttl);
+    ttls->Set(context, i, value).FromJust();
   }
+  ares_free_hostent(host);
 
-  size_t self_size() const override { return sizeof(*this); }
+  *answer = addresses;
+  *extra = ttls;
+  return ARES_SUCCESS;
+}
 
- protected:
-  void Parse(unsigned char* buf, int len) override {
-    HandleScope handle_scope(env()->isolate());
-    Context::Scope context_scope(env()->context());
 
-    hostent* host;
-    ares_addr6ttl addrttls[256];
-    int naddrttls = arraysize(addrttls);
+int ParseCnameReply(Environment* env,
+                    unsigned char* buf,
+                    int len,
+                    Local<Value>* answer,
+                    Local<Value>* extra) {
+  struct hostent* host;
 
-    int status = ares_parse_aaaa_reply(buf, len, &host, addrttls, &naddrttls);
-    if (status != ARES_SUCCESS) {
-      ParseError(status);
-      return;
-    }
-
-    Local<Array> addresses = HostentToAddresses(env(), host);
-    Local<Array> ttls = Array::New(env()->isolate(), naddrttls);
+  int status = ares_parse_a_reply(buf, len, &host, nullptr, nullptr);
+  if (status != ARES_SUCCESS)
+    return status;
 
-    auto context = env()->context();
-    for (int i = 0; i < naddrttls; i += 1) {
-      auto value = Integer::New(env()->isolate(), addrttls[i].ttl);
-      ttls->Set(context, i, value).FromJust();
-    }
-    ares_free_hostent(host);
+  // A cname lookup always returns a single record but we follow the
+  // common API here.
+  Local<Array> result = Array::New(env->isolate(), 1);
+  result->Set(0, OneByteString(env->isolate(), host->h_name));
+  ares_free_hostent(host);
 
-    CallOnComplete(addresses, ttls);
-  }
-};
+  *answer = result;
+  return ARES_SUCCESS;
+}
 
 
-class QueryCnameWrap: public QueryWrap {
- public:
-  QueryCnameWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
+int ParseMxReply(Environment* env,
+                 unsigned char* buf,
+                 int len,
+                 Local<Value>* answer,
+                 Local<Value>* extra) {
+  struct ares_mx_reply* mx_start;
+  int status = ares_parse_mx_reply(buf, len, &mx_start);
+  if (status != ARES_SUCCESS)
+    return status;
+
+  Local<Array> mx_records = Array::New(env->isolate());
+  Local<String> exchange_symbol = env->exchange_string();
+  Local<String> priority_symbol = env->priority_string();
+
+  ares_mx_reply* current = mx_start;
+  for (uint32_t i = 0; current != nullptr; ++i, current = current->next) {
+    Local<Object> mx_record = Object::New(env->isolate());
+    mx_record->Set(exchange_symbol,
+                   OneByteString(env->isolate(), current->host));
+    mx_record->Set(priority_symbol,
+                   Integer::New(env->isolate(), current->priority));
+    mx_records->Set(i, mx_record);
   }
 
-  int Send(const char* name) override {
-    ares_query(env()->cares_channel(),
-               name,
-               ns_c_in,
-               ns_t_cname,
-               Callback,
-               GetQueryArg());
-    return 0;
-  }
+  ares_free_data(mx_start);
 
-  size_t self_size() const override { return sizeof(*this); }
+  *answer = mx_records;
+  return ARES_SUCCESS;
+}
 
- protected:
-  void Parse(unsigned char* buf, int len) override {
-    HandleScope handle_scope(env()->isolate());
-    Context::Scope context_scope(env()->context());
-    struct hostent* host;
 
-    int status = ares_parse_a_reply(buf, len, &host, nullptr, nullptr);
-    if (status != ARES_SUCCESS) {
-      ParseError(status);
-      return;
-    }
+int ParseNsReply(Environment* env,
+                 unsigned char* buf,
+                 int len,
+                 Local<Value>* answer,
+                 Local<Value>* extra) {
+  struct hostent* host;
 
-    // A cname lookup always returns a single record but we follow the
-    // common API here.
-    Local<Array> result = Array::New(env()->isolate(), 1);
-    result->Set(0, OneByteString(env()->isolate(), host->h_name));
-    ares_free_hostent(host);
+  int status = ares_parse_ns_reply(buf, len, &host);
+  if (status != ARES_SUCCESS)
+    return status;
 
-    this->CallOnComplete(result);
-  }
-};
+  Local<Array> names = HostentToNames(env, host);
+  ares_free_hostent(host);
 
+  *answer = names;
+  return ARES_SUCCESS;
+}
 
-class QueryMxWrap: public QueryWrap {
- public:
-  QueryMxWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
-  }
 
-  int Send(const char* name) override {
-    ares_query(env()->cares_channel(),
-               name,
-               ns_c_in,
-               ns_t_mx,
-               Callback,
-               GetQueryArg());
-    return 0;
+int ParseTxtReply(Environment* env,
+                  unsigned char* buf,
+                  int len,
+                  Local<Value>* answer,
+                  Local<Value>* extra) {
+  struct ares_txt_ext* txt_out;
+
+  int status = ares_parse_txt_reply_ext(buf, len, &txt_out);
+  if (status != ARES_SUCCESS)
+    return status;
+
+  Local<Array> txt_records = Array::New(env->isolate());
+  Local<Array> txt_chunk;
+
+  struct ares_txt_ext* current = txt_out;
+  uint32_t i = 0;
+  for (uint32_t j = 0; current != nullptr; current = current->next) {
+    Local<String> txt = OneByteString(env->isolate(), current->txt);
+    // New record found - write out the current chunk
+    if (current->record_start) {
+      if (!txt_chunk.IsEmpty())
+        txt_records->Set(i++, txt_chunk);
+      txt_chunk = Array::New(env->isolate());
+      j = 0;
+    }
+    txt_chunk->Set(j++, txt);
   }
+  // Push last chunk if it isn't empty
+  if (!txt_chunk.IsEmpty())
+    txt_records->Set(i, txt_chunk);
 
-  size_t self_size() const override { return sizeof(*this); }
-
- protected:
-  void Parse(unsigned char* buf, int len) override {
-    HandleScope handle_scope(env()->isolate());
-    Context::Scope context_scope(env()->context());
-
-    struct ares_mx_reply* mx_start;
-    int status = ares_parse_mx_reply(buf, len, &mx_start);
-    if (status != ARES_SUCCESS) {
-      ParseError(status);
-      return;
-    }
+  ares_free_data(txt_out);
 
-    Local<Array> mx_records = Array::New(env()->isolate());
-    Local<String> exchange_symbol = env()->exchange_string();
-    Local<String> priority_symbol = env()->priority_string();
-
-    ares_mx_reply* current = mx_start;
-    for (uint32_t i = 0; current != nullptr; ++i, current = current->next) {
-      Local<Object> mx_record = Object::New(env()->isolate());
-      mx_record->Set(exchange_symbol,
-                     OneByteString(env()->isolate(), current->host));
-      mx_record->Set(priority_symbol,
-                     Integer::New(env()->isolate(), current->priority));
-      mx_records->Set(i, mx_record);
-    }
+  *answer = txt_records;
+  return ARES_SUCCESS;
+}
 
-    ares_free_data(mx_start);
 
-    this->CallOnComplete(mx_records);
+int ParseSrvReply(Environment* env,
+                  unsigned char* buf,
+                  int len,
+                  Local<Value>* answer,
+                  Local<Value>* extra) {
+  struct ares_srv_reply* srv_start;
+  int status = ares_parse_srv_reply(buf, len, &srv_start);
+  if (status != ARES_SUCCESS)
+    return status;
+
+  Local<Array> srv_records = Array::New(env->isolate());
+  Local<String> name_symbol = env->name_string();
+  Local<String> port_symbol = env->port_string();
+  Local<String> priority_symbol = env->priority_string();
+  Local<String> weight_symbol = env->weight_string();
+
+  ares_srv_reply* current = srv_start;
+  for (uint32_t i = 0; current != nullptr; ++i, current = current->next) {
+    Local<Object> srv_record = Object::New(env->isolate());
+    srv_record->Set(name_symbol,
+                    OneByteString(env->isolate(), current->host));
+    srv_record->Set(port_symbol,
+                    Integer::New(env->isolate(), current->port));
+    srv_record->Set(priority_symbol,
+                    Integer::New(env->isolate(), current->priority));
+    srv_record->Set(weight_symbol,
+                    Integer::New(env->isolate(), current->weight));
+    srv_records->Set(i, srv_record);
   }
-};
 
+  ares_free_data(srv_start);
 
-class QueryNsWrap: public QueryWrap {
- public:
-  QueryNsWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
-  }
-
-  int Send(const char* name) override {
-    ares_query(env()->cares_channel(),
-               name,
-               ns_c_in,
-               ns_t_ns,
-               Callback,
-               GetQueryArg());
-    return 0;
-  }
+  *answer = srv_records;
+  return ARES_SUCCESS;
+}
 
-  size_t self_size() const override { return sizeof(*this); }
 
- protected:
-  void Parse(unsigned char* buf, int len) override {
-    HandleScope handle_scope(env()->isolate());
-    Context::Scope context_scope(env()->context());
-    struct hostent* host;
+int ParsePtrReply(Environment* env,
+                  unsigned char* buf,
+                  int len,
+                  Local<Value>* answer,
+                  Local<Value>* extra) {
+  struct hostent* host;
 
-    int status = ares_parse_ns_reply(buf, len, &host);
-    if (status != ARES_SUCCESS) {
-      ParseError(status);
-      return;
-    }
+  int status = ares_parse_ptr_reply(buf, len, NULL, 0, AF_INET, &host);
+  if (status != ARES_SUCCESS)
+    return status;
 
-    Local<Array> names = HostentToNames(env(), host);
-    ares_free_hostent(host);
+  Local<Array> aliases = Array::New(env->isolate());
 
-    this->CallOnComplete(names);
+  for (uint32_t i = 0; host->h_aliases[i] != NULL; i++) {
+    aliases->Set(i, OneByteString(env->isolate(), host->h_aliases[i]));
   }
-};
 
+  ares_free_hostent(host);
 
-class QueryTxtWrap: public QueryWrap {
- public:
-  QueryTxtWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
-  }
-
-  int Send(const char* name) override {
-    ares_query(env()->cares_channel(),
-               name,
-               ns_c_in,
-               ns_t_txt,
-               Callback,
-               GetQueryArg());
-    return 0;
-  }
+  *answer = aliases;
+  return ARES_SUCCESS;
+}
 
-  size_t self_size() const override { return sizeof(*this); }
 
- protected:
-  void Parse(unsigned char* buf, int len) override {
-    HandleScope handle_scope(env()->isolate());
-    Context::Scope context_scope(env()->context());
-    struct ares_txt_ext* txt_out;
+int ParseNaptrReply(Environment* env,
+                    unsigned char* buf,
+                    int len,
+                    Local<Value>* answer,
+                    Local<Value>* extra) {
+  ares_naptr_reply* naptr_start;
+  int status = ares_parse_naptr_reply(buf, len, &naptr_start);
+  if (status != ARES_SUCCESS)
+    return status;
+
+  Local<Array> naptr_records = Array::New(env->isolate());
+  Local<String> flags_symbol = env->flags_string();
+  Local<String> service_symbol = env->service_string();
+  Local<String> regexp_symbol = env->regexp_string();
+  Local<String> replacement_symbol = env->replacement_string();
+  Local<String> order_symbol = env->order_string();
+  Local<String> preference_symbol = env->preference_string();
+
+  ares_naptr_reply* current = naptr_start;
+  for (uint32_t i = 0; current != nullptr; ++i, current = current->next) {
+    Local<Object> naptr_record = Object::New(env->isolate());
+    naptr_record->Set(flags_symbol,
+                      OneByteString(env->isolate(), current->flags));
+    naptr_record->Set(service_symbol,
+                      OneByteString(env->isolate(), current->service));
+    naptr_record->Set(regexp_symbol,
+                      OneByteString(env->isolate(), current->regexp));
+    naptr_record->Set(replacement_symbol,
+                      OneByteString(env->isolate(), current->replacement));
+    naptr_record->Set(order_symbol,
+                      Integer::New(env->isolate(), current->order));
+    naptr_record->Set(preference_symbol,
+                      Integer::New(env->isolate(), current->preference));
+    naptr_records->Set(i, naptr_record);
+  }
 
-    int status = ares_parse_txt_reply_ext(buf, len, &txt_out);
-    if (status != ARES_SUCCESS) {
-      ParseError(status);
-      return;
-    }
+  ares_free_data(naptr_start);
 
-    Local<Array> txt_records = Array::New(env()->isolate());
-    Local<Array> txt_chunk;
-
-    struct ares_txt_ext* current = txt_out;
-    uint32_t i = 0;
-    for (uint32_t j = 0; current != nullptr; current = current->next) {
-      Local<String> txt = OneByteString(env()->isolate(), current->txt);
-      // New record found - write out the current chunk
-      if (current->record_start) {
-        if (!txt_chunk.IsEmpty())
-          txt_records->Set(i++, txt_chunk);
-        txt_chunk = Array::New(env()->isolate());
-        j = 0;
-      }
-      txt_chunk->Set(j++, txt);
-    }
-    // Push last chunk if it isn't empty
-    if (!txt_chunk.IsEmpty())
-      txt_records->Set(i, txt_chunk);
+  *answer = naptr_records;
+  return ARES_SUCCESS;
+}
 
-    ares_free_data(txt_out);
 
-    this->CallOnComplete(txt_records);
-  }
-};
+int ParseSoaReply(Environment* env,
+                  unsigned char* buf,
+                  int len,
+                  Local<Value>* answer,
+                  Local<Value>* extra) {
+  ares_soa_reply* soa_out;
+  int status = ares_parse_soa_reply(buf, len, &soa_out);
+  if (status != ARES_SUCCESS)
+    return status;
+
+  Local<Object> soa_record = Object::New(env->isolate());
+
+  soa_record->Set(env->nsname_string(),
+                  OneByteString(env->isolate(), soa_out->nsname));
+  soa_record->Set(env->hostmaster_string(),
+                  OneByteString(env->isolate(), soa_out->hostmaster));
+  soa_record->Set(env->serial_string(),
+                  Integer::New(env->isolate(), soa_out->serial));
+  soa_record->Set(env->refresh_string(),
+                  Integer::New(env->isolate(), soa_out->refresh));
+  soa_record->Set(env->retry_string(),
+                  Integer::New(env->isolate(), soa_out->retry));
+  soa_record->Set(env->expire_string(),
+                  Integer::New(env->isolate(), soa_out->expire));
+  soa_record->Set(env->minttl_string(),
+                  Integer::New(env->isolate(), soa_out->minttl));
+
+  ares_free_data(soa_out);
+
+  *answer = soa_record;
+  return ARES_SUCCESS;
+}
 
 
-class QuerySrvWrap: public QueryWrap {
+template <int kType, ReplyParser kParse>
+class QueryRecordWrap: public QueryWrap {
  public:
-  explicit QuerySrvWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
+  QueryRecordWrap(Environment* env,
+                  Local<Object> req_wrap_obj,
+                  ares_channel channel)
+      : QueryWrap(env, req_wrap_obj, channel) {
   }
 
   int Send(const char* name) override {
-    ares_query(env()->cares_channel(),
+    ares_query(channel(),
                name,
                ns_c_in,
-               ns_t_srv,
+               kType,
                Callback,
                GetQueryArg());
     return 0;
@@ -682,205 +804,166 @@ class QuerySrvWrap: public QueryWrap {
     HandleScope handle_scope(env()->isolate());
     Context::Scope context_scope(env()->context());
 
-    struct ares_srv_reply* srv_start;
-    int status = ares_parse_srv_reply(buf, len, &srv_start);
+    Local<Value> answer;
+    Local<Value> extra;
+    int status = kParse(env(), buf, len, &answer, &extra);
     if (status != ARES_SUCCESS) {
       ParseError(status);
       return;
     }
 
-    Local<Array> srv_records = Array::New(env()->isolate());
-    Local<String> name_symbol = env()->name_string();
-    Local<String> port_symbol = env()->port_string();
-    Local<String> priority_symbol = env()->priority_string();
-    Local<String> weight_symbol = env()->weight_string();
-
-    ares_srv_reply* current = srv_start;
-    for (uint32_t i = 0; current != nullptr; ++i, current = current->next) {
-      Local<Object> srv_record = Object::New(env()->isolate());
-      srv_record->Set(name_symbol,
-                      OneByteString(env()->isolate(), current->host));
-      srv_record->Set(port_symbol,
-                      Integer::New(env()->isolate(), current->port));
-      srv_record->Set(priority_symbol,
-                      Integer::New(env()->isolate(), current->priority));
-      srv_record->Set(weight_symbol,
-                      Integer::New(env()->isolate(), current->weight));
-      srv_records->Set(i, srv_record);
-    }
-
-    ares_free_data(srv_start);
-
-    this->CallOnComplete(srv_records);
+    CallOnComplete(answer, extra);
   }
 };
 
-class QueryPtrWrap: public QueryWrap {
- public:
-  explicit QueryPtrWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
-  }
-
-  int Send(const char* name) override {
-    ares_query(env()->cares_channel(),
-               name,
-               ns_c_in,
-               ns_t_ptr,
-               Callback,
-               GetQueryArg());
-    return 0;
-  }
-
-  size_t self_size() const override { return sizeof(*this); }
-
- protected:
-  void Parse(unsigned char* buf, int len) override {
-    HandleScope handle_scope(env()->isolate());
-    Context::Scope context_scope(env()->context());
-
-    struct hostent* host;
-
-    int status = ares_parse_ptr_reply(buf, len, NULL, 0, AF_INET, &host);
-    if (status != ARES_SUCCESS) {
-      ParseError(status);
-      return;
-    }
-
-    Local<Array> aliases = Array::New(env()->isolate());
+typedef QueryRecordWrap<ns_t_a, ParseAReply> QueryAWrap;
+typedef QueryRecordWrap<ns_t_aaaa, ParseAaaaReply> QueryAaaaWrap;
+typedef QueryRecordWrap<ns_t_cname, ParseCnameReply> QueryCnameWrap;
+typedef QueryRecordWrap<ns_t_mx, ParseMxReply> QueryMxWrap;
+typedef QueryRecordWrap<ns_t_ns, ParseNsReply> QueryNsWrap;
+typedef QueryRecordWrap<ns_t_txt, ParseTxtReply> QueryTxtWrap;
+typedef QueryRecordWrap<ns_t_srv, ParseSrvReply> QuerySrvWrap;
+typedef QueryRecordWrap<ns_t_ptr, ParsePtrReply> QueryPtrWrap;
+typedef QueryRecordWrap<ns_t_naptr, ParseNaptrReply> QueryNaptrWrap;
+typedef QueryRecordWrap<ns_t_soa, ParseSoaReply> QuerySoaWrap;
+
+
+struct RecordType {
+  const char* name;
+  int type;
+  ReplyParser parse;
+};
 
-    for (uint32_t i = 0; host->h_aliases[i] != NULL; i++) {
-      aliases->Set(i, OneByteString(env()->isolate(), host->h_aliases[i]));
-    }
+const RecordType record_types[] = {
+  { "A", ns_t_a, ParseAReply },
+  { "AAAA", ns_t_aaaa, ParseAaaaReply },
+  { "CNAME", ns_t_cname, ParseCnameReply },
+  { "MX", ns_t_mx, ParseMxReply },
+  { "NS", ns_t_ns, ParseNsReply },
+  { "TXT", ns_t_txt, ParseTxtReply },
+  { "SRV", ns_t_srv, ParseSrvReply },
+  { "PTR", ns_t_ptr, ParsePtrReply },
+  { "NAPTR", ns_t_naptr, ParseNaptrReply },
+  { "SOA", ns_t_soa, ParseSoaReply },
+};
 
-    ares_free_hostent(host);
 
-    this->CallOnComplete(aliases);
+const RecordType* FindRecordType(const char* name) {
+  for (const RecordType& record_type : record_types) {
+    if (strcmp(record_type.name, name) == 0)
+      return &record_type;
   }
-};
+  return nullptr;
+}
+
 
-class QueryNaptrWrap: public QueryWrap {
+// Sends a batch of queries on a channel at once and calls back once, with
+// the answers of all of them, when the last one is done. This saves the
+// QueryWrap and the callback into JS of each query.
+class QueryBatchWrap : public AsyncWrap {
  public:
-  explicit QueryNaptrWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
+  QueryBatchWrap(Environment* env,
+                 Local<Object> req_wrap_obj,
+                 ares_channel channel,
+                 size_t count)
+      : AsyncWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_QUERYWRAP),
+        channel_(channel),
+        queries_(count),
+        pending_(count + 1) {
+    if (env->in_domain())
+      req_wrap_obj->Set(env->domain_string(), env->domain_array()->Get(0));
   }
 
-  int Send(const char* name) override {
-    ares_query(env()->cares_channel(),
-               name,
-               ns_c_in,
-               ns_t_naptr,
-               Callback,
-               GetQueryArg());
-    return 0;
+  ~QueryBatchWrap() override {
+    CHECK_EQ(false, persistent().IsEmpty());
+    ClearWrap(object());
+    persistent().Reset();
   }
 
-  size_t self_size() const override { return sizeof(*this); }
-
- protected:
-  void Parse(unsigned char* buf, int len) override {
-    HandleScope handle_scope(env()->isolate());
-    Context::Scope context_scope(env()->context());
-
-    ares_naptr_reply* naptr_start;
-    int status = ares_parse_naptr_reply(buf, len, &naptr_start);
-
-    if (status != ARES_SUCCESS) {
-      ParseError(status);
-      return;
-    }
-
-    Local<Array> naptr_records = Array::New(env()->isolate());
-    Local<String> flags_symbol = env()->flags_string();
-    Local<String> service_symbol = env()->service_string();
-    Local<String> regexp_symbol = env()->regexp_string();
-    Local<String> replacement_symbol = env()->replacement_string();
-    Local<String> order_symbol = env()->order_string();
-    Local<String> preference_symbol = env()->preference_string();
-
-    ares_naptr_reply* current = naptr_start;
-    for (uint32_t i = 0; current != nullptr; ++i, current = current->next) {
-      Local<Object> naptr_record = Object::New(env()->isolate());
-      naptr_record->Set(flags_symbol,
-                        OneByteString(env()->isolate(), current->flags));
-      naptr_record->Set(service_symbol,
-                        OneByteString(env()->isolate(), current->service));
-      naptr_record->Set(regexp_symbol,
-                        OneByteString(env()->isolate(), current->regexp));
-      naptr_record->Set(replacement_symbol,
-                        OneByteString(env()->isolate(), current->replacement));
-      naptr_record->Set(order_symbol,
-                        Integer::New(env()->isolate(), current->order));
-      naptr_record->Set(preference_symbol,
-                        Integer::New(env()->isolate(), current->preference));
-      naptr_records->Set(i, naptr_record);
-    }
-
-    ares_free_data(naptr_start);
+  void Send(size_t index, const char* name, const RecordType* record_type) {
+    Query* query = &queries_[index];
+    query->batch = this;
+    query->parse = record_type->parse;
+    query->status = ARES_SUCCESS;
+    ares_query(channel_, name, ns_c_in, record_type->type, Callback, query);
+  }
 
-    this->CallOnComplete(naptr_records);
+  // Called after the last Send(). Answers can come right away, so the batch
+  // is not done before.
+  void Sent() {
+    Finish();
   }
-};
 
+  size_t self_size() const override { return sizeof(*this); }
 
-class QuerySoaWrap: public QueryWrap {
- public:
-  QuerySoaWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
-  }
+ private:
+  struct Query {
+    QueryBatchWrap* batch;
+    ReplyParser parse;
+    int status;
+    std::vector<unsigned char> answer;
+  };
 
-  int Send(const char* name) override {
-    ares_query(env()->cares_channel(),
-               name,
-               ns_c_in,
-               ns_t_soa,
-               Callback,
-               GetQueryArg());
-    return 0;
+  static void Callback(void* arg, int status, int timeouts,
+                       unsigned char* answer_buf, int answer_len) {
+    Query* query = static_cast<Query*>(arg);
+    query->status = status;
+    if (status == ARES_SUCCESS)
+      query->answer.assign(answer_buf, answer_buf + answer_len);
+    query->batch->Finish();
   }
 
-  size_t self_size() const override { return sizeof(*this); }
+  void Finish() {
+    if (--pending_ > 0)
+      return;
 
- protected:
-  void Parse(unsigned char* buf, int len) override {
     HandleScope handle_scope(env()->isolate());
     Context::Scope context_scope(env()->context());
-
-    ares_soa_reply* soa_out;
-    int status = ares_parse_soa_reply(buf, len, &soa_out);
-
-    if (status != ARES_SUCCESS) {
-      ParseError(status);
-      return;
+    Local<Context> context = env()->context();
+
+    // Failed queries have their error code as their answer.
+    Local<Array> answers = Array::New(env()->isolate(), queries_.size());
+    Local<Array> extras = Array::New(env()->isolate(), queries_.size());
+    for (size_t i = 0; i < queries_.size(); i++) {
+      Query* query = &queries_[i];
+      Local<Value> answer;
+      Local<Value> extra;
+      int status = query->status;
+      if (status == ARES_SUCCESS) {
+        status = query->parse(env(),
+                              query->answer.data(),
+                              query->answer.size(),
+                              &answer,
+                              &extra);
+      }
+      if (status != ARES_SUCCESS)
+        answer = OneByteString(env()->isolate(), ToErrorCodeString(status));
+      answers->Set(context, i, answer).FromJust();
+      if (!extra.IsEmpty())
+        extras->Set(context, i, extra).FromJust();
     }
 
-    Local<Object> soa_record = Object::New(env()->isolate());
-
-    soa_record->Set(env()->nsname_string(),
-                    OneByteString(env()->isolate(), soa_out->nsname));
-    soa_record->Set(env()->hostmaster_string(),
-                    OneByteString(env()->isolate(), soa_out->hostmaster));
-    soa_record->Set(env()->serial_string(),
-                    Integer::New(env()->isolate(), soa_out->serial));
-    soa_record->Set(env()->refresh_string(),
-                    Integer::New(env()->isolate(), soa_out->refresh));
-    soa_record->Set(env()->retry_string(),
-                    Integer::New(env()->isolate(), soa_out->retry));
-    soa_record->Set(env()->expire_string(),
-                    Integer::New(env()->isolate(), soa_out->expire));
-    soa_record->Set(env()->minttl_string(),
-                    Integer::New(env()->isolate(), soa_out->minttl));
-
-    ares_free_data(soa_out);
-
-    this->CallOnComplete(soa_record);
+    Local<Value> argv[] = {
+      Integer::New(env()->isolate(), 0),
+      answers,
+      extras
+    };
+    MakeCallback(env()->oncomplete_string(), arraysize(argv), argv);
+    delete this;
   }
+
+  ares_channel channel_;
+  std::vector<Query> queries_;
+  size_t pending_;
 };
 
 
 class GetHostByAddrWrap: public QueryWrap {
  public:
-  explicit GetHostByAddrWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
+  GetHostByAddrWrap(Environment* env,
+                    Local<Object> req_wrap_obj,
+                    ares_channel channel)
+      : QueryWrap(env, req_wrap_obj, channel) {
   }
 
   int Send(const char* name) override {
@@ -897,7 +980,7 @@ class GetHostByAddrWrap: public QueryWrap {
       return UV_EINVAL;  // So errnoException() reports a proper error.
     }
 
-    ares_gethostbyaddr(env()->cares_channel(),
+    ares_gethostbyaddr(channel(),
                        address_buffer,
                        length,
                        family,
@@ -919,12 +1002,14 @@ class GetHostByAddrWrap: public QueryWrap {
 
 class GetHostByNameWrap: public QueryWrap {
  public:
-  explicit GetHostByNameWrap(Environment* env, Local<Object> req_wrap_obj)
-      : QueryWrap(env, req_wrap_obj) {
+  GetHostByNameWrap(Environment* env,
+                    Local<Object> req_wrap_obj,
+                    ares_channel channel)
+      : QueryWrap(env, req_wrap_obj, channel) {
   }
 
   int Send(const char* name, int family) override {
-    ares_gethostbyname(env()->cares_channel(),
+    ares_gethostbyname(channel(),
                        name,
                        family,
                        Callback,
@@ -932,6 +1017,8 @@ class GetHostByNameWrap: public QueryWrap {
     return 0;
   }
 
+  size_t self_size() const override { return sizeof(*this); }
+
  protected:
   void Parse(struct hostent* host) override {
     HandleScope scope(env()->isolate());
@@ -944,17 +1031,134 @@ class GetHostByNameWrap: public QueryWrap {
 };
 
 
-template <class Wrap>
-static void Query(const FunctionCallbackInfo<Value>& args) {
-  Environment* env = Environment::GetCurrent(args);
+static int library_status = ARES_ENOTINITIALIZED;
+
+static void InitLibraryOnce() {
+  library_status = ares_library_init(ARES_LIB_INIT_ALL);
+}
+
+// c-ares is initialized when the first channel is created rather than when
+// the binding is loaded, because net loads the binding on startup.
+static int InitLibrary() {
+  static uv_once_t init_once = UV_ONCE_INIT;
+  uv_once(&init_once, InitLibraryOnce);
+  return library_status;
+}
+
+
+// Returns the default channel of |env|, which is set up the first time that
+// it is used because ares_init_options() reads resolv.conf and friends. The
+// data of the channel is kept in the data of the timer of the Environment.
+// Throws and returns nullptr if the channel can't be set up.
+static ares_channel DefaultChannel(Environment* env) {
+  node_ares_channel* channel =
+      static_cast<node_ares_channel*>(env->cares_timer_handle()->data);
+  if (channel->channel != nullptr)
+    return channel->channel;
+
+  int r = InitLibrary();
+  if (r == ARES_SUCCESS) {
+    struct ares_options options;
+    memset(&options, 0, sizeof(options));
+    options.flags = ARES_FLAG_NOCHECKRESP;
+    options.sock_state_cb = ares_sockstate_cb;
+    options.sock_state_cb_data = channel;
+
+    /* We do the call to ares_init_option for caller. */
+    r = ares_init_options(env->cares_channel_ptr(),
+                          &options,
+                          ARES_OPT_FLAGS | ARES_OPT_SOCK_STATE_CB);
+  }
+  if (r != ARES_SUCCESS) {
+    env->ThrowError(ToErrorCodeString(r));
+    return nullptr;
+  }
+  channel->channel = env->cares_channel();
+  return channel->channel;
+}
+
+
+// A channel of its own, with its own servers, timeout and tries, for a
+// dns.Resolver. Its sockets are polled and its timeouts are processed along
+// with those of the default channel of the Environment.
+class ChannelWrap : public BaseObject {
+ public:
+  ~ChannelWrap() override {
+    // Queries in flight keep the object alive through their request objects,
+    // so destroying the channel does not call back into JS.
+    if (initialized_)
+      ares_destroy(data_.channel);
+  }
+
+  // new ChannelWrap(timeout, tries), with -1 for the c-ares defaults.
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    CHECK(args[0]->IsInt32());
+    CHECK(args[1]->IsInt32());
 
+    ChannelWrap* wrap = new ChannelWrap(env, args.This());
+    int r = wrap->Init(args[0]->Int32Value(), args[1]->Int32Value());
+    if (r != ARES_SUCCESS)
+      return env->ThrowError(ToErrorCodeString(r));
+  }
+
+  static void Cancel(const FunctionCallbackInfo<Value>& args) {
+    ChannelWrap* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+    ares_cancel(wrap->channel());
+  }
+
+  ares_channel channel() const { return data_.channel; }
+
+ private:
+  ChannelWrap(Environment* env, Local<Object> wrap)
+      : BaseObject(env, wrap),
+        initialized_(false) {
+    data_.env = env;
+    data_.channel = nullptr;
+    MakeWeak<ChannelWrap>(this);
+  }
+
+  int Init(int timeout, int tries) {
+    struct ares_options options;
+    memset(&options, 0, sizeof(options));
+    options.flags = ARES_FLAG_NOCHECKRESP;
+    options.sock_state_cb = ares_sockstate_cb;
+    options.sock_state_cb_data = &data_;
+    int optmask = ARES_OPT_FLAGS | ARES_OPT_SOCK_STATE_CB;
+    if (timeout >= 0) {
+      options.timeout = timeout;
+      optmask |= ARES_OPT_TIMEOUTMS;
+    }
+    if (tries >= 1) {
+      options.tries = tries;
+      optmask |= ARES_OPT_TRIES;
+    }
+
+    int r = InitLibrary();
+    if (r == ARES_SUCCESS)
+      r = ares_init_options(&data_.channel, &options, optmask);
+    initialized_ = r == ARES_SUCCESS;
+    return r;
+  }
+
+  node_ares_channel data_;
+  bool initialized_;
+};
+
+
+template <class Wrap>
+static void SendQuery(Environment* env,
+                      ares_channel channel,
+                      const FunctionCallbackInfo<Value>& args) {
   CHECK_EQ(false, args.IsConstructCall());
   CHECK(args[0]->IsObject());
   CHECK(args[1]->IsString());
 
   Local<Object> req_wrap_obj = args[0].As<Object>();
   Local<String> string = args[1].As<String>();
-  Wrap* wrap = new Wrap(env, req_wrap_obj);
+  Wrap* wrap = new Wrap(env, req_wrap_obj, channel);
 
   node::Utf8Value name(env->isolate(), string);
   int err = wrap->Send(*name);
@@ -965,6 +1169,98 @@ static void Query(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+template <class Wrap>
+static void Query(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  ares_channel channel = DefaultChannel(env);
+  if (channel != nullptr)
+    SendQuery<Wrap>(env, channel, args);
+}
+
+
+template <class Wrap>
+static void ChannelQuery(const FunctionCallbackInfo<Value>& args) {
+  ChannelWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  SendQuery<Wrap>(wrap->env(), wrap->channel(), args);
+}
+
+
+// queryBatch(req, names, types), with types named as in record_types.
+static void SendQueryBatch(Environment* env,
+                           ares_channel channel,
+                           const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsArray());
+
+  Local<Array> names = args[1].As<Array>();
+  Local<Array> types = args[2].As<Array>();
+  CHECK_EQ(names->Length(), types->Length());
+
+  QueryBatchWrap* batch =
+      new QueryBatchWrap(env, args[0].As<Object>(), channel, names->Length());
+  for (uint32_t i = 0; i < names->Length(); i++) {
+    node::Utf8Value name(env->isolate(), names->Get(i));
+    node::Utf8Value type(env->isolate(), types->Get(i));
+    const RecordType* record_type = FindRecordType(*type);
+    CHECK_NE(record_type, nullptr);
+    batch->Send(i, *name, record_type);
+  }
+  batch->Sent();
+
+  args.GetReturnValue().Set(0);
+}
+
+
+static void QueryBatch(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  ares_channel channel = DefaultChannel(env);
+  if (channel != nullptr)
+    SendQueryBatch(env, channel, args);
+}
+
+
+static void ChannelQueryBatch(const FunctionCallbackInfo<Value>& args) {
+  ChannelWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  SendQueryBatch(wrap->env(), wrap->channel(), args);
+}
+
+
+static void GetHostByName(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsString());
+  CHECK(args[2]->IsInt32());
+
+  int family;
+  switch (args[2]->Int32Value()) {
+  case 4:
+    family = AF_INET;
+    break;
+  case 6:
+    family = AF_INET6;
+    break;
+  default:
+    CHECK(0 && "bad address family");
+  }
+
+  ares_channel channel = DefaultChannel(env);
+  if (channel == nullptr)
+    return;
+  GetHostByNameWrap* wrap =
+      new GetHostByNameWrap(env, args[0].As<Object>(), channel);
+  node::Utf8Value name(env->isolate(), args[1]);
+  int err = wrap->Send(*name, family);
+  if (err)
+    delete wrap;
+
+  args.GetReturnValue().Set(err);
+}
+
+
 void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
   GetAddrInfoReqWrap* req_wrap = static_cast<GetAddrInfoReqWrap*>(req->data);
   Environment* env = req_wrap->env();
@@ -1091,6 +1387,72 @@ void AfterGetNameInfo(uv_getnameinfo_t* req,
 }
 
 
+int GetAddrInfoReqWrap::Queue() {
+  Dispatched();
+  return threadpool::QueueWork(env()->event_loop(),
+                               &work_req_,
+                               threadpool::kDnsWork,
+                               threadpool::kHighPriority,
+                               Work,
+                               AfterWork,
+                               NODE_THREADPOOL_TRACE_DNS,
+                               "getaddrinfo");
+}
+
+
+void GetAddrInfoReqWrap::Work(uv_work_t* work_req) {
+  GetAddrInfoReqWrap* w =
+      ContainerOf(&GetAddrInfoReqWrap::work_req_, work_req);
+  w->req()->addrinfo = nullptr;
+  w->retcode_ = uv_getaddrinfo(threadpool::WorkerLoop(),
+                               w->req(),
+                               nullptr,
+                               w->hostname_.c_str(),
+                               nullptr,
+                               &w->hints_);
+}
+
+
+void GetAddrInfoReqWrap::AfterWork(uv_work_t* work_req, int status) {
+  CHECK_EQ(status, 0);
+  GetAddrInfoReqWrap* w =
+      ContainerOf(&GetAddrInfoReqWrap::work_req_, work_req);
+  AfterGetAddrInfo(w->req(), w->retcode_, w->req()->addrinfo);
+}
+
+
+int GetNameInfoReqWrap::Queue() {
+  Dispatched();
+  return threadpool::QueueWork(env()->event_loop(),
+                               &work_req_,
+                               threadpool::kDnsWork,
+                               threadpool::kHighPriority,
+                               Work,
+                               AfterWork,
+                               NODE_THREADPOOL_TRACE_DNS,
+                               "getnameinfo");
+}
+
+
+void GetNameInfoReqWrap::Work(uv_work_t* work_req) {
+  GetNameInfoReqWrap* w =
+      ContainerOf(&GetNameInfoReqWrap::work_req_, work_req);
+  w->retcode_ = uv_getnameinfo(threadpool::WorkerLoop(),
+                               w->req(),
+                               nullptr,
+                               reinterpret_cast<const sockaddr*>(&w->addr_),
+                               NI_NAMEREQD);
+}
+
+
+void GetNameInfoReqWrap::AfterWork(uv_work_t* work_req, int status) {
+  CHECK_EQ(status, 0);
+  GetNameInfoReqWrap* w =
+      ContainerOf(&GetNameInfoReqWrap::work_req_, work_req);
+  AfterGetNameInfo(w->req(), w->retcode_, w->req()->host, w->req()->service);
+}
+
+
 void IsIP(const FunctionCallbackInfo<Value>& args) {
   node::Utf8Value ip(args.GetIsolate(), args[0]);
   char address_buffer[sizeof(struct in6_addr)];
@@ -1152,21 +1514,15 @@ void GetAddrInfo(const FunctionCallbackInfo<Value>& args) {
     CHECK(0 && "bad address family");
   }
 
-  GetAddrInfoReqWrap* req_wrap = new GetAddrInfoReqWrap(env, req_wrap_obj);
-
   struct addrinfo hints;
   memset(&hints, 0, sizeof(struct addrinfo));
   hints.ai_family = family;
   hints.ai_socktype = SOCK_STREAM;
   hints.ai_flags = flags;
 
-  int err = uv_getaddrinfo(env->event_loop(),
-                           req_wrap->req(),
-                           AfterGetAddrInfo,
-                           *hostname,
-                           nullptr,
-                           &hints);
-  req_wrap->Dispatched();
+  GetAddrInfoReqWrap* req_wrap =
+      new GetAddrInfoReqWrap(env, req_wrap_obj, *hostname, hints);
+  int err = req_wrap->Queue();
   if (err)
     delete req_wrap;
 
@@ -1188,14 +1544,9 @@ void GetNameInfo(const FunctionCallbackInfo<Value>& args) {
   CHECK(uv_ip4_addr(*ip, port, reinterpret_cast<sockaddr_in*>(&addr)) == 0 ||
         uv_ip6_addr(*ip, port, reinterpret_cast<sockaddr_in6*>(&addr)) == 0);
 
-  GetNameInfoReqWrap* req_wrap = new GetNameInfoReqWrap(env, req_wrap_obj);
-
-  int err = uv_getnameinfo(env->event_loop(),
-                           req_wrap->req(),
-                           AfterGetNameInfo,
-                           (struct sockaddr*)&addr,
-                           NI_NAMEREQD);
-  req_wrap->Dispatched();
+  GetNameInfoReqWrap* req_wrap =
+      new GetNameInfoReqWrap(env, req_wrap_obj, addr);
+  int err = req_wrap->Queue();
   if (err)
     delete req_wrap;
 
@@ -1203,14 +1554,13 @@ void GetNameInfo(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-void GetServers(const FunctionCallbackInfo<Value>& args) {
-  Environment* env = Environment::GetCurrent(args);
-
+Local<Array> GetChannelServers(Environment* env, ares_channel channel) {
+  EscapableHandleScope scope(env->isolate());
   Local<Array> server_array = Array::New(env->isolate());
 
   ares_addr_node* servers;
 
-  int r = ares_get_servers(env->cares_channel(), &servers);
+  int r = ares_get_servers(channel, &servers);
   CHECK_EQ(r, ARES_SUCCESS);
 
   ares_addr_node* cur = servers;
@@ -1228,23 +1578,17 @@ void GetServers(const FunctionCallbackInfo<Value>& args) {
 
   ares_free_data(servers);
 
-  args.GetReturnValue().Set(server_array);
+  return scope.Escape(server_array);
 }
 
 
-void SetServers(const FunctionCallbackInfo<Value>& args) {
-  Environment* env = Environment::GetCurrent(args);
-
-  CHECK(args[0]->IsArray());
-
-  Local<Array> arr = Local<Array>::Cast(args[0]);
-
+int SetChannelServers(Environment* env,
+                      ares_channel channel,
+                      Local<Array> arr) {
   uint32_t len = arr->Length();
 
-  if (len == 0) {
-    int rv = ares_set_servers(env->cares_channel(), nullptr);
-    return args.GetReturnValue().Set(rv);
-  }
+  if (len == 0)
+    return ares_set_servers(channel, nullptr);
 
   ares_addr_node* servers = new ares_addr_node[len];
   ares_addr_node* last = nullptr;
@@ -1289,12 +1633,48 @@ void SetServers(const FunctionCallbackInfo<Value>& args) {
   }
 
   if (err == 0)
-    err = ares_set_servers(env->cares_channel(), &servers[0]);
+    err = ares_set_servers(channel, &servers[0]);
   else
     err = ARES_EBADSTR;
 
   delete[] servers;
 
+  return err;
+}
+
+
+void GetServers(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  ares_channel channel = DefaultChannel(env);
+  if (channel != nullptr)
+    args.GetReturnValue().Set(GetChannelServers(env, channel));
+}
+
+
+void SetServers(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsArray());
+  ares_channel channel = DefaultChannel(env);
+  if (channel == nullptr)
+    return;
+  int err = SetChannelServers(env, channel, args[0].As<Array>());
+  args.GetReturnValue().Set(err);
+}
+
+
+void ChannelGetServers(const FunctionCallbackInfo<Value>& args) {
+  ChannelWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  args.GetReturnValue().Set(GetChannelServers(wrap->env(), wrap->channel()));
+}
+
+
+void ChannelSetServers(const FunctionCallbackInfo<Value>& args) {
+  ChannelWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  CHECK(args[0]->IsArray());
+  int err =
+      SetChannelServers(wrap->env(), wrap->channel(), args[0].As<Array>());
   args.GetReturnValue().Set(err);
 }
 
@@ -1316,6 +1696,7 @@ void CaresTimerCloseCb(uv_handle_t* handle) {
 void CaresTimerClose(Environment* env,
                             uv_handle_t* handle,
                             void* arg) {
+  delete static_cast<node_ares_channel*>(arg);
   uv_close(handle, CaresTimerCloseCb);
 }
 
@@ -1325,32 +1706,18 @@ void Initialize(Local<Object> target,
                 Local<Context> context) {
   Environment* env = Environment::GetCurrent(context);
 
-  int r = ares_library_init(ARES_LIB_INIT_ALL);
-  if (r != ARES_SUCCESS)
-    return env->ThrowError(ToErrorCodeString(r));
-
-  struct ares_options options;
-  memset(&options, 0, sizeof(options));
-  options.flags = ARES_FLAG_NOCHECKRESP;
-  options.sock_state_cb = ares_sockstate_cb;
-  options.sock_state_cb_data = env;
-
-  /* We do the call to ares_init_option for caller. */
-  r = ares_init_options(env->cares_channel_ptr(),
-                        &options,
-                        ARES_OPT_FLAGS | ARES_OPT_SOCK_STATE_CB);
-  if (r != ARES_SUCCESS) {
-    ares_library_cleanup();
-    return env->ThrowError(ToErrorCodeString(r));
-  }
+  node_ares_channel* channel = new node_ares_channel;
+  channel->env = env;
+  channel->channel = nullptr;
 
   /* Initialize the timeout timer. The timer won't be started until the */
   /* first socket is opened. */
   uv_timer_init(env->event_loop(), env->cares_timer_handle());
+  env->cares_timer_handle()->data = channel;
   env->RegisterHandleCleanup(
       reinterpret_cast<uv_handle_t*>(env->cares_timer_handle()),
       CaresTimerClose,
-      nullptr);
+      channel);
 
   env->SetMethod(target, "queryA", Query<QueryAWrap>);
   env->SetMethod(target, "queryAaaa", Query<QueryAaaaWrap>);
@@ -1363,6 +1730,8 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "queryNaptr", Query<QueryNaptrWrap>);
   env->SetMethod(target, "querySoa", Query<QuerySoaWrap>);
   env->SetMethod(target, "getHostByAddr", Query<GetHostByAddrWrap>);
+  env->SetMethod(target, "getHostByName", GetHostByName);
+  env->SetMethod(target, "queryBatch", QueryBatch);
 
   env->SetMethod(target, "getaddrinfo", GetAddrInfo);
   env->SetMethod(target, "getnameinfo", GetNameInfo);
@@ -1412,6 +1781,30 @@ void Initialize(Local<Object> target,
       FIXED_ONE_BYTE_STRING(env->isolate(), "QueryReqWrap"));
   target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "QueryReqWrap"),
               qrw->GetFunction());
+
+  Local<FunctionTemplate> channel_wrap =
+      env->NewFunctionTemplate(ChannelWrap::New);
+  channel_wrap->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(channel_wrap, "queryA", ChannelQuery<QueryAWrap>);
+  env->SetProtoMethod(channel_wrap, "queryAaaa", ChannelQuery<QueryAaaaWrap>);
+  env->SetProtoMethod(channel_wrap, "queryCname", ChannelQuery<QueryCnameWrap>);
+  env->SetProtoMethod(channel_wrap, "queryMx", ChannelQuery<QueryMxWrap>);
+  env->SetProtoMethod(channel_wrap, "queryNs", ChannelQuery<QueryNsWrap>);
+  env->SetProtoMethod(channel_wrap, "queryTxt", ChannelQuery<QueryTxtWrap>);
+  env->SetProtoMethod(channel_wrap, "querySrv", ChannelQuery<QuerySrvWrap>);
+  env->SetProtoMethod(channel_wrap, "queryPtr", ChannelQuery<QueryPtrWrap>);
+  env->SetProtoMethod(channel_wrap, "queryNaptr", ChannelQuery<QueryNaptrWrap>);
+  env->SetProtoMethod(channel_wrap, "querySoa", ChannelQuery<QuerySoaWrap>);
+  env->SetProtoMethod(channel_wrap, "getHostByAddr",
+                      ChannelQuery<GetHostByAddrWrap>);
+  env->SetProtoMethod(channel_wrap, "queryBatch", ChannelQueryBatch);
+  env->SetProtoMethod(channel_wrap, "getServers", ChannelGetServers);
+  env->SetProtoMethod(channel_wrap, "setServers", ChannelSetServers);
+  env->SetProtoMethod(channel_wrap, "cancel", ChannelWrap::Cancel);
+  channel_wrap->SetClassName(
+      FIXED_ONE_BYTE_STRING(env->isolate(), "ChannelWrap"));
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "ChannelWrap"),
+              channel_wrap->GetFunction());
 }
 
 }  // anonymous namespace
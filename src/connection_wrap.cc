@@ -11,8 +11,10 @@
 
 namespace node {
 
+using v8::Array;
 using v8::Boolean;
 using v8::Context;
+using v8::FunctionCallbackInfo;
 using v8::HandleScope;
 using v8::Integer;
 using v8::Local;
@@ -29,7 +31,9 @@ ConnectionWrap<WrapType, UVType>::ConnectionWrap(Environment* env,
                  object,
                  reinterpret_cast<uv_stream_t*>(&handle_),
                  provider,
-                 parent) {}
+                 parent),
+      accept_batch_limit_(1),
+      accept_check_(nullptr) {}
 
 
 template <typename WrapType, typename UVType>
@@ -67,13 +71,92 @@ void ConnectionWrap<WrapType, UVType>::OnConnection(uv_stream_t* handle,
     if (uv_accept(handle, client_handle))
       return;
 
+    if (wrap_data->accept_batch_limit_ > 1) {
+      // Hold on to the client until the end of the loop iteration, libuv
+      // keeps calling us for as long as there are pending connections.
+      wrap_data->pending_accepts_.push_back(wrap);
+      if (wrap_data->pending_accepts_.size() < wrap_data->accept_batch_limit_) {
+        uv_check_start(wrap_data->accept_check_, [](uv_check_t* handle) {
+          WrapType* wrap = static_cast<WrapType*>(handle->data);
+          HandleScope scope(wrap->env()->isolate());
+          Context::Scope context_scope(wrap->env()->context());
+          wrap->FlushAccepts();
+        });
+      } else {
+        wrap_data->FlushAccepts();
+      }
+      return;
+    }
+
     // Successful accept. Call the onconnection callback in JavaScript land.
     argv[1] = client_obj;
+  } else {
+    // Hand out what was accepted before the error first.
+    wrap_data->FlushAccepts();
   }
   wrap_data->MakeCallback(env->onconnection_string(), arraysize(argv), argv);
 }
 
 
+template <typename WrapType, typename UVType>
+void ConnectionWrap<WrapType, UVType>::FlushAccepts() {
+  if (pending_accepts_.empty())
+    return;
+
+  uv_check_stop(accept_check_);
+
+  Environment* env = this->env();
+  Local<Array> clients = Array::New(env->isolate(), pending_accepts_.size());
+  for (size_t i = 0; i < pending_accepts_.size(); i++)
+    clients->Set(env->context(), i, pending_accepts_[i]->object()).FromJust();
+  pending_accepts_.clear();
+
+  Local<Value> argv[] = {
+    Integer::New(env->isolate(), 0),
+    clients
+  };
+  MakeCallback(env->onconnection_string(), arraysize(argv), argv);
+}
+
+
+template <typename WrapType, typename UVType>
+void ConnectionWrap<WrapType, UVType>::SetAcceptBatch(
+    const FunctionCallbackInfo<Value>& args) {
+  WrapType* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  int64_t limit = args[0]->IntegerValue();
+  wrap->accept_batch_limit_ = limit > 1 ? static_cast<size_t>(limit) : 1;
+
+  if (wrap->accept_batch_limit_ > 1 && wrap->accept_check_ == nullptr) {
+    wrap->accept_check_ = new uv_check_t;
+    CHECK_EQ(0, uv_check_init(wrap->env()->event_loop(), wrap->accept_check_));
+    wrap->accept_check_->data = wrap;
+    uv_unref(reinterpret_cast<uv_handle_t*>(wrap->accept_check_));
+  }
+}
+
+
+template <typename WrapType, typename UVType>
+void ConnectionWrap<WrapType, UVType>::OnBeforeClose() {
+  // Connections that were accepted but not yet handed out are dropped.
+  std::vector<WrapType*> pending;
+  pending.swap(pending_accepts_);
+  for (WrapType* client : pending)
+    client->Close();
+
+  if (accept_check_ != nullptr) {
+    uv_close(reinterpret_cast<uv_handle_t*>(accept_check_),
+             [](uv_handle_t* handle) {
+      delete reinterpret_cast<uv_check_t*>(handle);
+    });
+    accept_check_ = nullptr;
+  }
+
+  StreamWrap::OnBeforeClose();
+}
+
+
 template <typename WrapType, typename UVType>
 void ConnectionWrap<WrapType, UVType>::AfterConnect(uv_connect_t* req,
                                                     int status) {
@@ -130,6 +213,12 @@ template void ConnectionWrap<PipeWrap, uv_pipe_t>::OnConnection(
 template void ConnectionWrap<TCPWrap, uv_tcp_t>::OnConnection(
     uv_stream_t* handle, int status);
 
+template void ConnectionWrap<PipeWrap, uv_pipe_t>::SetAcceptBatch(
+    const FunctionCallbackInfo<Value>& args);
+
+template void ConnectionWrap<TCPWrap, uv_tcp_t>::SetAcceptBatch(
+    const FunctionCallbackInfo<Value>& args);
+
 template void ConnectionWrap<PipeWrap, uv_pipe_t>::AfterConnect(
     uv_connect_t* handle, int status);
 
@@ -7,6 +7,8 @@
 #include "stream_wrap.h"
 #include "v8.h"
 
+#include <vector>
+
 namespace node {
 
 template <typename WrapType, typename UVType>
@@ -18,6 +20,10 @@ class ConnectionWrap : public StreamWrap {
 
   static void OnConnection(uv_stream_t* handle, int status);
   static void AfterConnect(uv_connect_t* req, int status);
+  // setAcceptBatch(max): with a max greater than 1, connections accepted
+  // during one loop iteration are handed to onconnection(status, clients)
+  // together, as an array of up to |max| handles.
+  static void SetAcceptBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
 
  protected:
   ConnectionWrap(Environment* env,
@@ -27,7 +33,16 @@ class ConnectionWrap : public StreamWrap {
   ~ConnectionWrap() {
   }
 
+  void OnBeforeClose() override;
+
   UVType handle_;
+
+ private:
+  void FlushAccepts();
+
+  size_t accept_batch_limit_;
+  std::vector<WrapType*> pending_accepts_;
+  uv_check_t* accept_check_;
 };
 
 
@@ -0,0 +1,202 @@
+#include "cpu_profile_writer.h"
+
+#include "env.h"
+#include "env-inl.h"
+#include "util.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unordered_map>
+#include <utility>
+
+namespace node {
+
+using v8::CpuProfile;
+using v8::CpuProfileNode;
+using v8::HandleScope;
+using v8::Isolate;
+using v8::Local;
+using v8::String;
+
+static const char kMagic[] = "NODECPU1";
+static const char kTitle[] = "node:cpu_profile_writer";
+
+
+static void WriteVarint(uint64_t value, std::vector<uint8_t>* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+
+static void WriteSignedVarint(int64_t value, std::vector<uint8_t>* out) {
+  const uint64_t zigzag = static_cast<uint64_t>(value) << 1;
+  WriteVarint(value < 0 ? ~zigzag : zigzag, out);
+}
+
+
+// Numbers the strings of the profile. V8 keeps one copy of each of the
+// function names and script names of a profile, so those are interned by
+// their address.
+class StringTable {
+ public:
+  uint32_t Intern(const char* string) {
+    auto it = indices_.find(string);
+    if (it != indices_.end())
+      return it->second;
+    const uint32_t index = strings_.size();
+    indices_.emplace(string, index);
+    strings_.push_back(string);
+    return index;
+  }
+
+  void Write(std::vector<uint8_t>* out) const {
+    WriteVarint(strings_.size(), out);
+    for (const char* string : strings_) {
+      const size_t length = strlen(string);
+      WriteVarint(length, out);
+      out->insert(out->end(), string, string + length);
+    }
+  }
+
+ private:
+  std::unordered_map<const char*, uint32_t> indices_;
+  std::vector<const char*> strings_;
+};
+
+
+CpuProfileWriter::CpuProfileWriter(Environment* env)
+    : isolate_(env->isolate()) {}
+
+
+CpuProfileWriter::~CpuProfileWriter() {
+  if (profiler_ == nullptr)
+    return;
+  if (started_) {
+    HandleScope handle_scope(isolate_);
+    profiler_->StopProfiling(OneByteString(isolate_, kTitle))->Delete();
+  }
+  profiler_->Dispose();
+}
+
+
+bool CpuProfileWriter::Start(int sampling_interval_us) {
+  if (started_)
+    return false;
+  if (profiler_ == nullptr)
+    profiler_ = v8::CpuProfiler::New(isolate_);
+  profiler_->SetSamplingInterval(sampling_interval_us);
+  profiler_->StartProfiling(OneByteString(isolate_, kTitle), true);
+  started_ = true;
+  return true;
+}
+
+
+void CpuProfileWriter::Encode(const CpuProfile* profile,
+                              std::vector<uint8_t>* out) {
+  out->insert(out->end(), kMagic, kMagic + sizeof(kMagic) - 1);
+  const int64_t start_time = profile->GetStartTime();
+  WriteVarint(start_time, out);
+  WriteVarint(profile->GetEndTime() - start_time, out);
+
+  // Number the nodes in pre-order, so that each parent comes before its
+  // children.
+  std::vector<std::pair<const CpuProfileNode*, uint32_t>> nodes;
+  std::unordered_map<const CpuProfileNode*, uint32_t> indices;
+  StringTable strings;
+  std::vector<std::pair<const CpuProfileNode*, uint32_t>> stack;
+  stack.emplace_back(profile->GetTopDownRoot(), 0);
+  while (!stack.empty()) {
+    const CpuProfileNode* node = stack.back().first;
+    const uint32_t parent = stack.back().second;
+    stack.pop_back();
+    const uint32_t index = nodes.size();
+    indices.emplace(node, index);
+    nodes.emplace_back(node, parent);
+    strings.Intern(node->GetFunctionNameStr());
+    strings.Intern(node->GetScriptResourceNameStr());
+    for (int i = node->GetChildrenCount() - 1; i >= 0; i--)
+      stack.emplace_back(node->GetChild(i), index + 1);
+  }
+
+  strings.Write(out);
+  WriteVarint(nodes.size(), out);
+  for (const auto& entry : nodes) {
+    const CpuProfileNode* node = entry.first;
+    WriteVarint(entry.second, out);
+    WriteVarint(strings.Intern(node->GetFunctionNameStr()), out);
+    WriteVarint(strings.Intern(node->GetScriptResourceNameStr()), out);
+    WriteSignedVarint(node->GetScriptId(), out);
+    WriteSignedVarint(node->GetLineNumber(), out);
+    WriteSignedVarint(node->GetColumnNumber(), out);
+    WriteVarint(node->GetHitCount(), out);
+  }
+
+  const int count = profile->GetSamplesCount();
+  WriteVarint(count, out);
+  int64_t last_time = start_time;
+  for (int i = 0; i < count; i++) {
+    const int64_t time = profile->GetSampleTimestamp(i);
+    WriteVarint(indices[profile->GetSample(i)], out);
+    WriteSignedVarint(time - last_time, out);
+    last_time = time;
+  }
+}
+
+
+static int WriteFile(const char* path,
+                     const std::vector<uint8_t>& data,
+                     const char** syscall) {
+  uv_fs_t req;
+  const int fd = uv_fs_open(nullptr, &req, path, O_WRONLY | O_CREAT | O_TRUNC,
+                            0666, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0) {
+    *syscall = "open";
+    return fd;
+  }
+
+  int err = 0;
+  size_t written = 0;
+  while (written < data.size()) {
+    uv_buf_t buf = uv_buf_init(
+        const_cast<char*>(reinterpret_cast<const char*>(data.data())) +
+            written,
+        data.size() - written);
+    err = uv_fs_write(nullptr, &req, fd, &buf, 1, -1, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (err < 0) {
+      *syscall = "write";
+      break;
+    }
+    written += err;
+    err = 0;
+  }
+
+  const int close_err = uv_fs_close(nullptr, &req, fd, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err == 0 && close_err < 0) {
+    *syscall = "close";
+    return close_err;
+  }
+  return err;
+}
+
+
+int CpuProfileWriter::Stop(const char* path, const char** syscall) {
+  CHECK(started_);
+  started_ = false;
+  HandleScope handle_scope(isolate_);
+  CpuProfile* profile =
+      profiler_->StopProfiling(OneByteString(isolate_, kTitle));
+  std::vector<uint8_t> data;
+  Encode(profile, &data);
+  profile->Delete();
+  return WriteFile(path, data, syscall);
+}
+
+}  // namespace node
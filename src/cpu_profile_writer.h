@@ -0,0 +1,58 @@
+#ifndef SRC_CPU_PROFILE_WRITER_H_
+#define SRC_CPU_PROFILE_WRITER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "v8.h"
+#include "v8-profiler.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace node {
+
+class Environment;
+
+// Samples the CPU with V8's profiler and writes the profile in a compact
+// binary format that lib/internal/cpu_profile.js turns into a .cpuprofile.
+// All integers are unsigned LEB128 varints, signed ones zigzag encoded:
+//
+//   "NODECPU1"
+//   start time, end time - start time            in microseconds
+//   string count, then for each string:          function names and URLs
+//     byte length, UTF-8 bytes
+//   node count, then for each node in pre-order:
+//     parent index + 1, 0 for the root
+//     function name string index, URL string index
+//     script ID, line number, column number      signed, the line and
+//                                                column 1-based, 0 if unknown
+//     hit count
+//   sample count, then for each sample:
+//     node index, time since the previous sample (signed)
+class CpuProfileWriter {
+ public:
+  explicit CpuProfileWriter(Environment* env);
+  ~CpuProfileWriter();
+
+  // Returns false if the profiler already runs.
+  bool Start(int sampling_interval_us);
+  // Stops the profiler and writes the profile to |path|. Returns 0, or a
+  // negative libuv error code and the system call that failed in |syscall|.
+  int Stop(const char* path, const char** syscall);
+  bool IsStarted() const { return started_; }
+
+  static void Encode(const v8::CpuProfile* profile,
+                     std::vector<uint8_t>* out);
+
+ private:
+  v8::Isolate* const isolate_;
+  v8::CpuProfiler* profiler_ = nullptr;
+  bool started_ = false;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_CPU_PROFILE_WRITER_H_
@@ -25,7 +25,13 @@
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
 #include "env.h"
+#include "cpu_profile_writer.h"
+#include "gc_metrics.h"
+#include "inotify_watcher.h"
+#include "loop_metrics.h"
 #include "node.h"
+#include "req_freelist.h"
+#include "slab_allocator.h"
 #include "util.h"
 #include "util-inl.h"
 #include "uv.h"
@@ -33,6 +39,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <utility>
 
 namespace node {
 
@@ -46,7 +53,7 @@ namespace node {
 // One byte because our strings are ASCII and we can safely skip V8's UTF-8
 // decoding step.  It's a one-time cost, but why pay it when you don't have to?
 inline IsolateData::IsolateData(v8::Isolate* isolate, uv_loop_t* event_loop,
-                                uint32_t* zero_fill_field)
+                                ArrayBufferAllocator* allocator)
     :
 #define V(PropertyName, StringValue)                                          \
     PropertyName ## _(                                                        \
@@ -70,12 +77,19 @@ inline IsolateData::IsolateData(v8::Isolate* isolate, uv_loop_t* event_loop,
             sizeof(StringValue) - 1).ToLocalChecked()),
     PER_ISOLATE_STRING_PROPERTIES(V)
 #undef V
-    event_loop_(event_loop), zero_fill_field_(zero_fill_field) {}
+    event_loop_(event_loop),
+    allocator_(allocator),
+    zero_fill_field_(allocator != nullptr ? allocator->zero_fill_field()
+                                          : nullptr) {}
 
 inline uv_loop_t* IsolateData::event_loop() const {
   return event_loop_;
 }
 
+inline ArrayBufferAllocator* IsolateData::allocator() const {
+  return allocator_;
+}
+
 inline uint32_t* IsolateData::zero_fill_field() const {
   return zero_fill_field_;
 }
@@ -100,13 +114,23 @@ inline void Environment::AsyncHooks::set_enable_callbacks(uint32_t flag) {
   fields_[kEnableCallbacks] = flag;
 }
 
+inline bool Environment::AsyncHooks::has_hook(Fields event) const {
+  return fields_[event] != 0;
+}
+
+inline void Environment::AsyncHooks::set_has_hook(Fields event, bool value) {
+  fields_[event] = value;
+}
+
 inline Environment::AsyncCallbackScope::AsyncCallbackScope(Environment* env)
     : env_(env) {
-  env_->makecallback_cntr_++;
+  if (env_->makecallback_cntr_++ == 0 && env_->loop_metrics_ != nullptr)
+    env_->loop_metrics_->EnterCallback();
 }
 
 inline Environment::AsyncCallbackScope::~AsyncCallbackScope() {
-  env_->makecallback_cntr_--;
+  if (--env_->makecallback_cntr_ == 0 && env_->loop_metrics_ != nullptr)
+    env_->loop_metrics_->ExitCallback();
 }
 
 inline bool Environment::AsyncCallbackScope::in_makecallback() {
@@ -199,6 +223,8 @@ inline Environment::Environment(IsolateData* isolate_data,
 #endif
       handle_cleanup_waiting_(0),
       http_parser_buffer_(nullptr),
+      http2_read_buffer_(nullptr),
+      stream_read_slab_allocator_(nullptr),
       fs_stats_field_array_(nullptr),
       context_(context->GetIsolate(), context) {
   // We'll be creating new objects so make sure we've entered the context.
@@ -223,6 +249,8 @@ inline Environment::Environment(IsolateData* isolate_data,
 inline Environment::~Environment() {
   v8::HandleScope handle_scope(isolate());
 
+  DeleteCollectedBaseObjects();
+
   while (HandleCleanup* hc = handle_cleanup_queue_.PopFront()) {
     handle_cleanup_waiting_++;
     hc->cb_(this, hc->handle_, hc->arg_);
@@ -254,6 +282,15 @@ inline Environment::~Environment() {
   delete[] heap_statistics_buffer_;
   delete[] heap_space_statistics_buffer_;
   delete[] http_parser_buffer_;
+  delete[] http2_read_buffer_;
+  delete stream_read_slab_allocator_;
+  delete req_freelist_;
+  delete loop_metrics_;
+  delete gc_metrics_;
+  delete cpu_profile_writer_;
+#ifdef __linux__
+  delete inotify_watcher_;
+#endif
 }
 
 inline v8::Isolate* Environment::isolate() const {
@@ -293,6 +330,24 @@ inline uv_idle_t* Environment::destroy_ids_idle_handle() {
   return &destroy_ids_idle_handle_;
 }
 
+inline void Environment::QueueCollectedBaseObject(BaseObject* object) {
+  uv_idle_t* handle = &collected_base_objects_idle_handle_;
+  // The Environment is going away, so there is no next iteration.
+  if (uv_is_closing(reinterpret_cast<uv_handle_t*>(handle))) {
+    delete object;
+    return;
+  }
+  if (collected_base_objects_.IsEmpty()) {
+    uv_idle_start(handle, [](uv_idle_t* handle) {
+      uv_idle_stop(handle);
+      Environment* env = ContainerOf(
+          &Environment::collected_base_objects_idle_handle_, handle);
+      env->DeleteCollectedBaseObjects();
+    });
+  }
+  collected_base_objects_.PushBack(object);
+}
+
 inline void Environment::RegisterHandleCleanup(uv_handle_t* handle,
                                                HandleCleanupCb cb,
                                                void *arg) {
@@ -327,6 +382,12 @@ inline bool Environment::using_domains() const {
   return using_domains_;
 }
 
+inline bool Environment::callback_hooks_active() const {
+  return using_domains_ ||
+         async_hooks_.has_hook(AsyncHooks::kPre) ||
+         async_hooks_.has_hook(AsyncHooks::kPost);
+}
+
 inline void Environment::set_using_domains(bool value) {
   using_domains_ = value;
 }
@@ -347,6 +408,14 @@ inline int64_t Environment::get_async_wrap_uid() {
   return ++async_wrap_uid_;
 }
 
+inline int64_t Environment::current_async_id() const {
+  return current_async_id_;
+}
+
+inline void Environment::set_current_async_id(int64_t id) {
+  current_async_id_ = id;
+}
+
 inline std::vector<int64_t>* Environment::destroy_ids_list() {
   return &destroy_ids_list_;
 }
@@ -381,6 +450,61 @@ inline void Environment::set_http_parser_buffer(char* buffer) {
   http_parser_buffer_ = buffer;
 }
 
+inline char* Environment::http2_read_buffer() const {
+  return http2_read_buffer_;
+}
+
+inline void Environment::set_http2_read_buffer(char* buffer) {
+  CHECK_EQ(http2_read_buffer_, nullptr);  // Should be set only once.
+  http2_read_buffer_ = buffer;
+}
+
+inline crypto::RandomPool* Environment::random_pool() const {
+  return random_pool_;
+}
+
+inline void Environment::set_random_pool(crypto::RandomPool* pool) {
+  random_pool_ = pool;
+}
+
+inline SlabAllocator* Environment::stream_read_slab_allocator() {
+  if (stream_read_slab_allocator_ == nullptr)
+    stream_read_slab_allocator_ = new SlabAllocator(this);
+  return stream_read_slab_allocator_;
+}
+
+inline ReqFreeList* Environment::req_freelist() {
+  if (req_freelist_ == nullptr)
+    req_freelist_ = new ReqFreeList();
+  return req_freelist_;
+}
+
+inline LoopMetrics* Environment::loop_metrics() {
+  if (loop_metrics_ == nullptr)
+    loop_metrics_ = new LoopMetrics(this);
+  return loop_metrics_;
+}
+
+inline GCMetrics* Environment::gc_metrics() {
+  if (gc_metrics_ == nullptr)
+    gc_metrics_ = new GCMetrics(this);
+  return gc_metrics_;
+}
+
+inline CpuProfileWriter* Environment::cpu_profile_writer() {
+  if (cpu_profile_writer_ == nullptr)
+    cpu_profile_writer_ = new CpuProfileWriter(this);
+  return cpu_profile_writer_;
+}
+
+#ifdef __linux__
+inline InotifyWatcher* Environment::inotify_watcher() {
+  if (inotify_watcher_ == nullptr)
+    inotify_watcher_ = new InotifyWatcher(this);
+  return inotify_watcher_;
+}
+#endif
+
 inline double* Environment::fs_stats_field_array() const {
   return fs_stats_field_array_;
 }
@@ -390,6 +514,65 @@ inline void Environment::set_fs_stats_field_array(double* fields) {
   fs_stats_field_array_ = fields;
 }
 
+inline double* Environment::stream_stats_field_array() const {
+  return stream_stats_field_array_.get();
+}
+
+inline void Environment::set_stream_stats_field_array(
+    std::unique_ptr<double[]> fields) {
+  CHECK(!stream_stats_field_array_);  // Should be set only once.
+  stream_stats_field_array_ = std::move(fields);
+}
+
+inline double* Environment::stream_base_state() const {
+  return stream_base_state_.get();
+}
+
+inline void Environment::set_stream_base_state(
+    std::unique_ptr<double[]> fields) {
+  CHECK(!stream_base_state_);  // Should be set only once.
+  stream_base_state_ = std::move(fields);
+}
+
+inline worker::Worker* Environment::worker_context() const {
+  return worker_context_;
+}
+
+inline void Environment::set_worker_context(worker::Worker* context) {
+  CHECK_EQ(worker_context_, nullptr);  // Should be set only once.
+  worker_context_ = context;
+}
+
+inline bool Environment::is_main_thread() const {
+  return worker_context_ == nullptr;
+}
+
+inline uint64_t Environment::thread_id() const {
+  return thread_id_;
+}
+
+inline void Environment::set_thread_id(uint64_t id) {
+  thread_id_ = id;
+}
+
+inline void Environment::add_sub_worker_context(worker::Worker* context) {
+  sub_worker_contexts_.insert(context);
+}
+
+inline void Environment::remove_sub_worker_context(worker::Worker* context) {
+  sub_worker_contexts_.erase(context);
+}
+
+inline void Environment::add_sab_lifetime_partner(
+    worker::SABLifetimePartner* partner) {
+  sab_lifetime_partners_.insert(partner);
+}
+
+inline void Environment::remove_sab_lifetime_partner(
+    worker::SABLifetimePartner* partner) {
+  sab_lifetime_partners_.erase(partner);
+}
+
 inline Environment* Environment::from_cares_timer_handle(uv_timer_t* handle) {
   return ContainerOf(&Environment::cares_timer_handle_, handle);
 }
@@ -1,6 +1,9 @@
 #include "env.h"
 #include "env-inl.h"
 #include "async-wrap.h"
+#include "base-object.h"
+#include "base-object-inl.h"
+#include "node_worker.h"
 #include "v8.h"
 #include "v8-profiler.h"
 
@@ -52,6 +55,10 @@ void Environment::Start(int argc,
   uv_idle_init(event_loop(), destroy_ids_idle_handle());
   uv_unref(reinterpret_cast<uv_handle_t*>(destroy_ids_idle_handle()));
 
+  uv_idle_t* const collected_handle = &collected_base_objects_idle_handle_;
+  uv_idle_init(event_loop(), collected_handle);
+  uv_unref(reinterpret_cast<uv_handle_t*>(collected_handle));
+
   auto close_and_finish = [](Environment* env, uv_handle_t* handle, void* arg) {
     handle->data = env;
 
@@ -76,6 +83,10 @@ void Environment::Start(int argc,
       reinterpret_cast<uv_handle_t*>(&idle_check_handle_),
       close_and_finish,
       nullptr);
+  RegisterHandleCleanup(
+      reinterpret_cast<uv_handle_t*>(collected_handle),
+      close_and_finish,
+      nullptr);
 
   if (start_profiler_idle_notifier) {
     StartProfilerIdleNotifier();
@@ -92,6 +103,15 @@ void Environment::Start(int argc,
   LoadAsyncWrapperInfo(this);
 }
 
+void Environment::DeleteCollectedBaseObjects() {
+  HandleScope handle_scope(isolate());
+  // Destructors may allocate and thereby queue more objects, which are
+  // deleted along with the others.
+  while (BaseObject* object = collected_base_objects_.PopFront())
+    delete object;
+}
+
+
 void Environment::StartProfilerIdleNotifier() {
   uv_prepare_start(&idle_prepare_handle_, [](uv_prepare_t* handle) {
     Environment* env = ContainerOf(&Environment::idle_prepare_handle_, handle);
@@ -164,4 +184,22 @@ void Environment::AtExit(void (*cb)(void* arg), void* arg) {
   at_exit_functions_.push_back(AtExitCallback{cb, arg});
 }
 
+bool Environment::is_stopping_worker() const {
+  return worker_context_ != nullptr && worker_context_->is_stopped();
+}
+
+void Environment::stop_sub_worker_contexts() {
+  while (!sub_worker_contexts_.empty()) {
+    worker::Worker* w = *sub_worker_contexts_.begin();
+    w->Exit(1);
+    w->JoinThread();
+  }
+}
+
+void Environment::release_sab_lifetime_partners() {
+  // Each partner removes itself from the set.
+  while (!sab_lifetime_partners_.empty())
+    delete *sab_lifetime_partners_.begin();
+}
+
 }  // namespace node
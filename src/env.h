@@ -37,7 +37,9 @@
 #include "v8.h"
 
 #include <list>
+#include <memory>
 #include <stdint.h>
+#include <unordered_set>
 #include <vector>
 
 // Caveat emptor: we're going slightly crazy with macros here but the end
@@ -68,13 +70,13 @@ namespace node {
 // for the sake of convenience.  Strings should be ASCII-only and have a
 // "node:" prefix to avoid name clashes with third-party code.
 #define PER_ISOLATE_PRIVATE_SYMBOL_PROPERTIES(V)                              \
-  V(alpn_buffer_private_symbol, "node:alpnBuffer")                            \
   V(arrow_message_private_symbol, "node:arrowMessage")                        \
   V(contextify_context_private_symbol, "node:contextify:context")             \
   V(contextify_global_private_symbol, "node:contextify:global")               \
   V(decorated_private_symbol, "node:decorated")                               \
   V(npn_buffer_private_symbol, "node:npnBuffer")                              \
   V(processed_private_symbol, "node:processed")                               \
+  V(sab_lifetime_partner_symbol, "node:sharedArrayBufferLifetimePartner")     \
   V(selected_npn_buffer_private_symbol, "node:selectedNpnBuffer")             \
 
 // Strings are per-isolate primitives but Environment proxies them
@@ -150,6 +152,7 @@ namespace node {
   V(mac_string, "mac")                                                        \
   V(max_buffer_string, "maxBuffer")                                           \
   V(message_string, "message")                                                \
+  V(message_port_string, "messagePort")                                       \
   V(minttl_string, "minttl")                                                  \
   V(model_string, "model")                                                    \
   V(modulus_string, "modulus")                                                \
@@ -168,9 +171,11 @@ namespace node {
   V(onhandshakedone_string, "onhandshakedone")                                \
   V(onhandshakestart_string, "onhandshakestart")                              \
   V(onmessage_string, "onmessage")                                            \
+  V(onmessages_string, "onmessages")                                          \
   V(onnewsession_string, "onnewsession")                                      \
   V(onnewsessiondone_string, "onnewsessiondone")                              \
   V(onocspresponse_string, "onocspresponse")                                  \
+  V(onprogress_string, "onprogress")                                          \
   V(onread_string, "onread")                                                  \
   V(onreadstart_string, "onreadstart")                                        \
   V(onreadstop_string, "onreadstop")                                          \
@@ -178,7 +183,10 @@ namespace node {
   V(onshutdown_string, "onshutdown")                                          \
   V(onsignal_string, "onsignal")                                              \
   V(onstop_string, "onstop")                                                  \
+  V(ontimeout_string, "ontimeout")                                            \
+  V(onunpipe_string, "onunpipe")                                              \
   V(onwrite_string, "onwrite")                                                \
+  V(onwritecomplete_string, "onwritecomplete")                                \
   V(output_string, "output")                                                  \
   V(order_string, "order")                                                    \
   V(owner_string, "owner")                                                    \
@@ -190,6 +198,7 @@ namespace node {
   V(port_string, "port")                                                      \
   V(preference_string, "preference")                                          \
   V(priority_string, "priority")                                              \
+  V(promise_string, "promise")                                                \
   V(produce_cached_data_string, "produceCachedData")                          \
   V(raw_string, "raw")                                                        \
   V(read_host_object_string, "_readHostObject")                               \
@@ -221,6 +230,7 @@ namespace node {
   V(subjectaltname_string, "subjectaltname")                                  \
   V(sys_string, "sys")                                                        \
   V(syscall_string, "syscall")                                                \
+  V(thread_id_string, "threadId")                                             \
   V(tick_callback_string, "_tickCallback")                                    \
   V(tick_domain_cb_string, "_tickDomainCallback")                             \
   V(ticketkeycallback_string, "onticketkeycallback")                          \
@@ -237,6 +247,7 @@ namespace node {
   V(value_string, "value")                                                    \
   V(verify_error_string, "verifyError")                                       \
   V(version_string, "version")                                                \
+  V(vfork_string, "vfork")                                                    \
   V(weight_string, "weight")                                                  \
   V(windows_verbatim_arguments_string, "windowsVerbatimArguments")            \
   V(wrap_string, "wrap")                                                      \
@@ -248,6 +259,7 @@ namespace node {
 
 #define ENVIRONMENT_STRONG_PERSISTENT_PROPERTIES(V)                           \
   V(as_external, v8::External)                                                \
+  V(async_hooks_destroy_batch_function, v8::Function)                         \
   V(async_hooks_destroy_function, v8::Function)                               \
   V(async_hooks_init_function, v8::Function)                                  \
   V(async_hooks_post_function, v8::Function)                                  \
@@ -256,17 +268,21 @@ namespace node {
   V(buffer_constructor_function, v8::Function)                                \
   V(buffer_prototype_object, v8::Object)                                      \
   V(context, v8::Context)                                                     \
+  V(contextify_global_names, v8::Object)                                      \
+  V(contextify_global_template, v8::ObjectTemplate)                           \
   V(domain_array, v8::Array)                                                  \
   V(domains_stack_array, v8::Array)                                           \
+  V(fs_watch_callback_function, v8::Function)                                 \
   V(generic_internal_field_template, v8::ObjectTemplate)                      \
+  V(histogram_constructor_template, v8::FunctionTemplate)                     \
   V(jsstream_constructor_template, v8::FunctionTemplate)                      \
+  V(message_port_constructor_template, v8::FunctionTemplate)                  \
   V(module_load_list_array, v8::Array)                                        \
   V(pipe_constructor_template, v8::FunctionTemplate)                          \
   V(process_object, v8::Object)                                               \
   V(promise_reject_function, v8::Function)                                    \
   V(push_values_to_array_function, v8::Function)                              \
   V(script_context_constructor_template, v8::FunctionTemplate)                \
-  V(script_data_constructor_function, v8::Function)                           \
   V(secure_context_constructor_template, v8::FunctionTemplate)                \
   V(tcp_constructor_template, v8::FunctionTemplate)                           \
   V(tick_callback_function, v8::Function)                                     \
@@ -276,11 +292,29 @@ namespace node {
   V(udp_constructor_function, v8::Function)                                   \
   V(url_constructor_function, v8::Function)                                   \
   V(write_wrap_constructor_function, v8::Function)                            \
+  V(zlib_dictionary_constructor_template, v8::FunctionTemplate)               \
 
+namespace crypto {
+class RandomPool;
+}  // namespace crypto
+
+namespace worker {
+class SABLifetimePartner;
+class Worker;
+}  // namespace worker
+
+class ArrayBufferAllocator;
 class Environment;
+class CpuProfileWriter;
+class GCMetrics;
+class InotifyWatcher;
+class LoopMetrics;
+class ReqFreeList;
+class SlabAllocator;
 
 struct node_ares_task {
   Environment* env;
+  ares_channel channel;
   ares_socket_t sock;
   uv_poll_t poll_watcher;
   RB_ENTRY(node_ares_task) node;
@@ -290,9 +324,11 @@ RB_HEAD(node_ares_task_list, node_ares_task);
 
 class IsolateData {
  public:
+  // |allocator| is the isolate's ArrayBuffer allocator, if node created it.
   inline IsolateData(v8::Isolate* isolate, uv_loop_t* event_loop,
-                     uint32_t* zero_fill_field = nullptr);
+                     ArrayBufferAllocator* allocator = nullptr);
   inline uv_loop_t* event_loop() const;
+  inline ArrayBufferAllocator* allocator() const;
   inline uint32_t* zero_fill_field() const;
 
 #define VP(PropertyName, StringValue) V(v8::Private, PropertyName)
@@ -317,6 +353,7 @@ class IsolateData {
 #undef VP
 
   uv_loop_t* const event_loop_;
+  ArrayBufferAllocator* const allocator_;
   uint32_t* const zero_fill_field_;
 
   DISALLOW_COPY_AND_ASSIGN(IsolateData);
@@ -326,21 +363,29 @@ class Environment {
  public:
   class AsyncHooks {
    public:
+    enum Fields {
+      // Set this to not zero if the init hook should be called.
+      kEnableCallbacks,
+      // Not zero if a hook is set up for the event, so that resources don't
+      // pay for the events that nothing listens to.
+      kInit,
+      kPre,
+      kPost,
+      kDestroy,
+      kFieldsCount
+    };
+
     inline uint32_t* fields();
     inline int fields_count() const;
     inline bool callbacks_enabled();
     inline void set_enable_callbacks(uint32_t flag);
+    inline bool has_hook(Fields event) const;
+    inline void set_has_hook(Fields event, bool value);
 
    private:
     friend class Environment;  // So we can call the constructor.
     inline AsyncHooks();
 
-    enum Fields {
-      // Set this to not zero if the init hook should be called.
-      kEnableCallbacks,
-      kFieldsCount
-    };
-
     uint32_t fields_[kFieldsCount];
 
     DISALLOW_COPY_AND_ASSIGN(AsyncHooks);
@@ -456,6 +501,12 @@ class Environment {
   inline uv_idle_t* immediate_idle_handle();
   inline uv_idle_t* destroy_ids_idle_handle();
 
+  // The weak callbacks of BaseObjects only queue them here, so that GC pauses
+  // don't include their destructors. The next iteration of the event loop
+  // deletes all of them at once.
+  inline void QueueCollectedBaseObject(BaseObject* object);
+  void DeleteCollectedBaseObjects();
+
   // Register clean-up cb to be called on environment destruction.
   inline void RegisterHandleCleanup(uv_handle_t* handle,
                                     HandleCleanupCb cb,
@@ -476,6 +527,9 @@ class Environment {
 
   inline bool using_domains() const;
   inline void set_using_domains(bool value);
+  // Whether MakeCallback() has work to do around the call itself, that is,
+  // domains are in use or async hooks listen for pre or post events.
+  inline bool callback_hooks_active() const;
 
   inline bool printed_error() const;
   inline void set_printed_error(bool value);
@@ -484,6 +538,9 @@ class Environment {
   inline void set_trace_sync_io(bool value);
 
   inline int64_t get_async_wrap_uid();
+  // The uid of the AsyncWrap whose callback is running, or 0.
+  inline int64_t current_async_id() const;
+  inline void set_current_async_id(int64_t id);
 
   // List of id's that have been destroyed and need the destroy() cb called.
   inline std::vector<int64_t>* destroy_ids_list();
@@ -496,10 +553,33 @@ class Environment {
 
   inline char* http_parser_buffer() const;
   inline void set_http_parser_buffer(char* buffer);
+  inline char* http2_read_buffer() const;
+  inline void set_http2_read_buffer(char* buffer);
+  inline crypto::RandomPool* random_pool() const;
+  inline void set_random_pool(crypto::RandomPool* pool);
+
+  inline SlabAllocator* stream_read_slab_allocator();
+  // Storage of WriteWrap and FSReqWrap objects.
+  inline ReqFreeList* req_freelist();
+
+  // Starts measuring the event loop on first use.
+  inline LoopMetrics* loop_metrics();
+  inline GCMetrics* gc_metrics();
+  inline CpuProfileWriter* cpu_profile_writer();
+#ifdef __linux__
+  // The inotify instance that the watchers of fs.watch() share.
+  inline InotifyWatcher* inotify_watcher();
+#endif
 
   inline double* fs_stats_field_array() const;
   inline void set_fs_stats_field_array(double* fields);
 
+  inline double* stream_stats_field_array() const;
+  inline void set_stream_stats_field_array(std::unique_ptr<double[]> fields);
+
+  inline double* stream_base_state() const;
+  inline void set_stream_base_state(std::unique_ptr<double[]> fields);
+
   inline void ThrowError(const char* errmsg);
   inline void ThrowTypeError(const char* errmsg);
   inline void ThrowRangeError(const char* errmsg);
@@ -534,6 +614,30 @@ class Environment {
   void AtExit(void (*cb)(void* arg), void* arg);
   void RunAtExitCallbacks();
 
+  // The Worker that runs this Environment, or nullptr on the main thread.
+  inline worker::Worker* worker_context() const;
+  inline void set_worker_context(worker::Worker* context);
+  inline bool is_main_thread() const;
+  // 0 on the main thread, the threadId of the Worker otherwise.
+  inline uint64_t thread_id() const;
+  inline void set_thread_id(uint64_t id);
+  // Whether this is a Worker that was told to stop, so that no more
+  // JavaScript should run.
+  bool is_stopping_worker() const;
+
+  // The Workers that were started from this Environment and are running.
+  inline void add_sub_worker_context(worker::Worker* context);
+  inline void remove_sub_worker_context(worker::Worker* context);
+  void stop_sub_worker_contexts();
+
+  // The references to shared SharedArrayBuffer memory that objects in this
+  // Environment hold, see src/node_messaging.h.
+  inline void add_sab_lifetime_partner(worker::SABLifetimePartner* partner);
+  inline void remove_sab_lifetime_partner(
+      worker::SABLifetimePartner* partner);
+  // Drops all of them, once no more JavaScript runs in this Environment.
+  void release_sab_lifetime_partners();
+
   // Strings and private symbols are shared across shared contexts
   // The getters simply proxy to the per-isolate primitive.
 #define VP(PropertyName, StringValue) V(v8::Private, PropertyName)
@@ -580,6 +684,7 @@ class Environment {
   uv_check_t immediate_check_handle_;
   uv_idle_t immediate_idle_handle_;
   uv_idle_t destroy_ids_idle_handle_;
+  uv_idle_t collected_base_objects_idle_handle_;
   uv_prepare_t idle_prepare_handle_;
   uv_check_t idle_check_handle_;
   AsyncHooks async_hooks_;
@@ -594,6 +699,7 @@ class Environment {
   bool trace_sync_io_;
   size_t makecallback_cntr_;
   int64_t async_wrap_uid_;
+  int64_t current_async_id_ = 0;
   std::vector<int64_t> destroy_ids_list_;
   debugger::Agent debugger_agent_;
 #if HAVE_INSPECTOR
@@ -601,6 +707,8 @@ class Environment {
 #endif
 
   HandleWrapQueue handle_wrap_queue_;
+  ListHead<BaseObject, &BaseObject::collected_queue_node_>
+      collected_base_objects_;
   ReqWrapQueue req_wrap_queue_;
   ListHead<HandleCleanup,
            &HandleCleanup::handle_cleanup_queue_> handle_cleanup_queue_;
@@ -610,8 +718,25 @@ class Environment {
   double* heap_space_statistics_buffer_ = nullptr;
 
   char* http_parser_buffer_;
+  char* http2_read_buffer_;
+  crypto::RandomPool* random_pool_ = nullptr;
+  SlabAllocator* stream_read_slab_allocator_;
+  ReqFreeList* req_freelist_ = nullptr;
+  LoopMetrics* loop_metrics_ = nullptr;
+  GCMetrics* gc_metrics_ = nullptr;
+  CpuProfileWriter* cpu_profile_writer_ = nullptr;
+#ifdef __linux__
+  InotifyWatcher* inotify_watcher_ = nullptr;
+#endif
 
   double* fs_stats_field_array_;
+  std::unique_ptr<double[]> stream_stats_field_array_;
+  std::unique_ptr<double[]> stream_base_state_;
+
+  worker::Worker* worker_context_ = nullptr;
+  uint64_t thread_id_ = 0;
+  std::unordered_set<worker::Worker*> sub_worker_contexts_;
+  std::unordered_set<worker::SABLifetimePartner*> sab_lifetime_partners_;
 
   struct AtExitCallback {
     void (*cb_)(void* arg);
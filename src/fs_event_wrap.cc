@@ -27,6 +27,7 @@
 #include "util-inl.h"
 #include "node.h"
 #include "handle_wrap.h"
+#include "inotify_watcher.h"
 #include "string_bytes.h"
 
 #include <stdlib.h>
@@ -34,6 +35,7 @@
 namespace node {
 
 using v8::Context;
+using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
@@ -54,6 +56,12 @@ class FSEventWrap: public HandleWrap {
   static void Start(const FunctionCallbackInfo<Value>& args);
   static void Close(const FunctionCallbackInfo<Value>& args);
 
+#ifdef __linux__
+  static void SetupSharedWatcher(const FunctionCallbackInfo<Value>& args);
+  static void StartSharedWatcher(const FunctionCallbackInfo<Value>& args);
+  static void StopSharedWatcher(const FunctionCallbackInfo<Value>& args);
+#endif
+
   size_t self_size() const override { return sizeof(*this); }
 
  private:
@@ -97,6 +105,12 @@ void FSEventWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "close", Close);
 
   target->Set(fsevent_string, t->GetFunction());
+
+#ifdef __linux__
+  env->SetMethod(target, "setupSharedWatcher", SetupSharedWatcher);
+  env->SetMethod(target, "startSharedWatcher", StartSharedWatcher);
+  env->SetMethod(target, "stopSharedWatcher", StopSharedWatcher);
+#endif
 }
 
 
@@ -216,6 +230,46 @@ void FSEventWrap::Close(const FunctionCallbackInfo<Value>& args) {
   HandleWrap::Close(args);
 }
 
+
+#ifdef __linux__
+void FSEventWrap::SetupSharedWatcher(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsFunction());
+  env->set_fs_watch_callback_function(args[0].As<Function>());
+}
+
+
+// The watchers of fs.watch() that share the inotify instance of the
+// Environment, see InotifyWatcher. Their events go to the function that
+// setupSharedWatcher() was called with, rather than to an onchange method.
+void FSEventWrap::StartSharedWatcher(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(!env->fs_watch_callback_function().IsEmpty());
+  CHECK(args[0]->IsUint32());
+  CHECK(args[5]->IsUint32());
+
+  BufferValue path(env->isolate(), args[1]);
+  if (*path == nullptr)
+    return env->ThrowTypeError("filename must be a string or Buffer");
+
+  int err = env->inotify_watcher()->Start(
+      args[0].As<Integer>()->Value(),
+      *path,
+      args[2]->IsTrue(),
+      args[3]->IsTrue(),
+      ParseEncoding(env->isolate(), args[4], kDefaultEncoding),
+      args[5].As<Integer>()->Value());
+  args.GetReturnValue().Set(err);
+}
+
+
+void FSEventWrap::StopSharedWatcher(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsUint32());
+  env->inotify_watcher()->Stop(args[0].As<Integer>()->Value());
+}
+#endif  // __linux__
+
 }  // anonymous namespace
 }  // namespace node
 
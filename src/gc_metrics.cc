@@ -0,0 +1,153 @@
+#include "gc_metrics.h"
+
+#include "env.h"
+#include "env-inl.h"
+#include "node_mutex.h"
+#include "util.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <algorithm>
+
+namespace node {
+
+using v8::GCCallbackFlags;
+using v8::GCType;
+using v8::HeapSpaceStatistics;
+using v8::HeapStatistics;
+using v8::Isolate;
+
+// GC callbacks don't get any data, so they look up the recorder of their
+// isolate in here. Each Environment, Workers' too, has its own recorder, so
+// this is shared between threads and only accessed with |recorders_mutex|
+// held. A recorder is only destroyed on the thread of its isolate, so it can
+// be used once looked up without the lock.
+static std::vector<GCMetrics*>* recorders = nullptr;
+static Mutex recorders_mutex;
+
+
+GCMetrics::GCMetrics(Environment* env)
+    : isolate_(env->isolate()),
+      space_count_(isolate_->NumberOfHeapSpaces()),
+      record_size_(kSpaceDeltas + space_count_),
+      buffer_(1),
+      current_(record_size_) {
+  Mutex::ScopedLock lock(recorders_mutex);
+  CHECK_EQ(ForIsolate(isolate_), nullptr);
+  if (recorders == nullptr)
+    recorders = new std::vector<GCMetrics*>();
+  recorders->push_back(this);
+}
+
+
+GCMetrics::~GCMetrics() {
+  Stop();
+  Mutex::ScopedLock lock(recorders_mutex);
+  recorders->erase(std::find(recorders->begin(), recorders->end(), this));
+}
+
+
+void GCMetrics::Start(size_t capacity) {
+  CHECK_GT(capacity, 0);
+  if (capacity != capacity_) {
+    capacity_ = capacity;
+    buffer_.assign(1 + capacity * record_size_, 0);
+  }
+  if (started_)
+    return;
+  started_ = true;
+  isolate_->AddGCPrologueCallback(PrologueCallback);
+  isolate_->AddGCEpilogueCallback(EpilogueCallback);
+}
+
+
+void GCMetrics::Stop() {
+  if (!started_)
+    return;
+  started_ = false;
+  depth_ = 0;
+  isolate_->RemoveGCPrologueCallback(PrologueCallback);
+  isolate_->RemoveGCEpilogueCallback(EpilogueCallback);
+}
+
+
+GCMetrics* GCMetrics::ForIsolate(Isolate* isolate) {
+  if (recorders == nullptr)
+    return nullptr;
+  for (GCMetrics* recorder : *recorders) {
+    if (recorder->isolate_ == isolate)
+      return recorder;
+  }
+  return nullptr;
+}
+
+
+void GCMetrics::PrologueCallback(Isolate* isolate,
+                                 GCType type,
+                                 GCCallbackFlags flags) {
+  GCMetrics* recorder;
+  {
+    Mutex::ScopedLock lock(recorders_mutex);
+    recorder = ForIsolate(isolate);
+  }
+  if (recorder != nullptr)
+    recorder->Prologue(type, flags);
+}
+
+
+void GCMetrics::EpilogueCallback(Isolate* isolate,
+                                 GCType type,
+                                 GCCallbackFlags flags) {
+  GCMetrics* recorder;
+  {
+    Mutex::ScopedLock lock(recorders_mutex);
+    recorder = ForIsolate(isolate);
+  }
+  if (recorder != nullptr)
+    recorder->Epilogue();
+}
+
+
+void GCMetrics::Prologue(GCType type, GCCallbackFlags flags) {
+  if (depth_++ > 0)
+    return;
+  start_time_ = uv_hrtime();
+  HeapStatistics stats;
+  isolate_->GetHeapStatistics(&stats);
+  current_[kType] = type;
+  current_[kFlags] = flags;
+  current_[kStartTime] = start_time_ / 1e6;
+  current_[kUsedHeapSizeBefore] = stats.used_heap_size();
+  // Until the epilogue, the deltas hold the sizes before the collection.
+  HeapSpaceStatistics space;
+  for (size_t i = 0; i < space_count_; i++) {
+    isolate_->GetHeapSpaceStatistics(&space, i);
+    current_[kSpaceDeltas + i] = space.space_used_size();
+  }
+}
+
+
+void GCMetrics::Epilogue() {
+  // In case recording started between the callbacks.
+  if (depth_ == 0 || --depth_ > 0)
+    return;
+  const uint64_t duration = uv_hrtime() - start_time_;
+  HeapStatistics stats;
+  isolate_->GetHeapStatistics(&stats);
+  current_[kDuration] = duration / 1e6;
+  current_[kUsedHeapSizeAfter] = stats.used_heap_size();
+  HeapSpaceStatistics space;
+  for (size_t i = 0; i < space_count_; i++) {
+    isolate_->GetHeapSpaceStatistics(&space, i);
+    current_[kSpaceDeltas + i] = space.space_used_size() -
+                                 current_[kSpaceDeltas + i];
+  }
+  pauses_.Record(duration / 1000);
+
+  const uint64_t written = static_cast<uint64_t>(buffer_[0]);
+  const size_t offset = 1 + (written % capacity_) * record_size_;
+  std::copy(current_.begin(), current_.end(), buffer_.begin() + offset);
+  buffer_[0] = written + 1;
+}
+
+}  // namespace node
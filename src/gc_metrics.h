@@ -0,0 +1,87 @@
+#ifndef SRC_GC_METRICS_H_
+#define SRC_GC_METRICS_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "histogram.h"
+#include "v8.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace node {
+
+class Environment;
+
+// Records the garbage collections of the isolate of an environment, from
+// their GC prologue to their epilogue callback, into a ring buffer that JS
+// reads from directly. buffer() holds the number of records written so far,
+// followed by capacity() records of record_size() numbers each, laid out
+// as Fields. Record n is at 1 + (n % capacity()) * record_size(). The
+// pauses are also counted in pauses(), in microseconds.
+//
+// Only collections that start between Start() and Stop() are recorded, and
+// collections that happen during another one are part of that one.
+class GCMetrics {
+ public:
+  enum Fields {
+    // A v8::GCType and v8::GCCallbackFlags.
+    kType,
+    kFlags,
+    // In milliseconds, on the clock of uv_hrtime().
+    kStartTime,
+    kDuration,
+    // In bytes.
+    kUsedHeapSizeBefore,
+    kUsedHeapSizeAfter,
+    // How much space_used_size changed in each heap space, in the order of
+    // v8::Isolate::GetHeapSpaceStatistics().
+    kSpaceDeltas
+  };
+
+  explicit GCMetrics(Environment* env);
+  ~GCMetrics();
+
+  // Clears and reallocates buffer() if |capacity| is not capacity().
+  void Start(size_t capacity);
+  void Stop();
+  bool IsStarted() const { return started_; }
+
+  double* buffer() { return buffer_.data(); }
+  size_t buffer_size() const { return buffer_.size(); }
+  size_t capacity() const { return capacity_; }
+  size_t record_size() const { return record_size_; }
+  Histogram* pauses() { return &pauses_; }
+
+ private:
+  static void PrologueCallback(v8::Isolate* isolate,
+                               v8::GCType type,
+                               v8::GCCallbackFlags flags);
+  static void EpilogueCallback(v8::Isolate* isolate,
+                               v8::GCType type,
+                               v8::GCCallbackFlags flags);
+  // Must be called with the lock of the recorders held.
+  static GCMetrics* ForIsolate(v8::Isolate* isolate);
+  void Prologue(v8::GCType type, v8::GCCallbackFlags flags);
+  void Epilogue();
+
+  v8::Isolate* const isolate_;
+  const size_t space_count_;
+  const size_t record_size_;
+  size_t capacity_ = 0;
+  bool started_ = false;
+  std::vector<double> buffer_;
+  // The record of the collection in progress, if |depth_| is not zero.
+  std::vector<double> current_;
+  uint64_t start_time_ = 0;
+  int depth_ = 0;
+  // Up to a minute, to within 1%.
+  Histogram pauses_{60 * 1000 * 1000LL, 8};
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_GC_METRICS_H_
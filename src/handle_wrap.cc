@@ -64,25 +64,29 @@ void HandleWrap::HasRef(const FunctionCallbackInfo<Value>& args) {
 
 
 void HandleWrap::Close(const FunctionCallbackInfo<Value>& args) {
-  Environment* env = Environment::GetCurrent(args);
-
   HandleWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
 
+  wrap->Close(args[0]);
+}
+
+
+void HandleWrap::Close(Local<Value> close_callback) {
   // Guard against uninitialized handle or double close.
-  if (!IsAlive(wrap))
+  if (!IsAlive(this))
     return;
 
-  if (wrap->state_ != kInitialized)
+  if (state_ != kInitialized)
     return;
 
-  CHECK_EQ(false, wrap->persistent().IsEmpty());
-  uv_close(wrap->handle_, OnClose);
-  wrap->state_ = kClosing;
+  CHECK_EQ(false, persistent().IsEmpty());
+  OnBeforeClose();
+  uv_close(handle_, OnClose);
+  state_ = kClosing;
 
-  if (args[0]->IsFunction()) {
-    wrap->object()->Set(env->onclose_string(), args[0]);
-    wrap->state_ = kClosingWithCallback;
+  if (!close_callback.IsEmpty() && close_callback->IsFunction()) {
+    object()->Set(env()->onclose_string(), close_callback);
+    state_ = kClosingWithCallback;
   }
 }
 
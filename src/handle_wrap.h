@@ -70,6 +70,10 @@ class HandleWrap : public AsyncWrap {
 
   inline uv_handle_t* GetHandle() const { return handle_; }
 
+  // Closes the handle from C++. |close_callback|, if it is a function, is
+  // called as onclose() once libuv has closed the handle.
+  void Close(v8::Local<v8::Value> close_callback = v8::Local<v8::Value>());
+
  protected:
   HandleWrap(Environment* env,
              v8::Local<v8::Object> object,
@@ -78,6 +82,10 @@ class HandleWrap : public AsyncWrap {
              AsyncWrap* parent = nullptr);
   ~HandleWrap() override;
 
+  // Called by Close() right before uv_close(), while the handle can still be
+  // used to finish off outstanding work.
+  virtual void OnBeforeClose() {}
+
  private:
   friend class Environment;
   friend void GetActiveHandles(const v8::FunctionCallbackInfo<v8::Value>&);
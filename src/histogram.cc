@@ -0,0 +1,103 @@
+#include "histogram.h"
+#include "util.h"
+
+#include <math.h>
+#include <algorithm>
+
+namespace node {
+
+Histogram::Histogram(int64_t highest, int precision)
+    : highest_(highest),
+      precision_(precision),
+      half_count_(static_cast<size_t>(1) << (precision - 1)) {
+  CHECK_GE(highest, 1);
+  CHECK_GE(precision, kMinPrecision);
+  CHECK_LE(precision, kMaxPrecision);
+  counts_.resize(IndexOf(highest) + 1);
+  Reset();
+}
+
+
+int64_t Histogram::LowestAt(size_t index) const {
+  if (index < 2 * half_count_)
+    return static_cast<int64_t>(index);
+  const size_t shift = index / half_count_ - 1;
+  return static_cast<int64_t>(index - shift * half_count_) << shift;
+}
+
+
+int64_t Histogram::HighestAt(size_t index) const {
+  if (index < 2 * half_count_)
+    return static_cast<int64_t>(index);
+  const size_t shift = index / half_count_ - 1;
+  return LowestAt(index) + (static_cast<int64_t>(1) << shift) - 1;
+}
+
+
+int64_t Histogram::Percentile(double percentile) const {
+  const uint64_t total = count();
+  if (total == 0)
+    return 0;
+  const int64_t max = static_cast<int64_t>(fields_[kMax]);
+  if (percentile <= 0)
+    return static_cast<int64_t>(fields_[kMin]);
+  if (percentile >= 100)
+    return max;
+
+  uint64_t target = static_cast<uint64_t>(ceil(percentile / 100 * total));
+  if (target == 0)
+    target = 1;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    seen += counts_[i];
+    if (seen >= target)
+      return std::min(HighestAt(i), max);
+  }
+  return max;
+}
+
+
+double Histogram::Stddev() const {
+  const uint64_t total = count();
+  if (total == 0)
+    return 0;
+  const double mean = fields_[kSum] / total;
+  double sum_of_squares = 0;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    if (counts_[i] == 0)
+      continue;
+    double value = (LowestAt(i) + HighestAt(i)) / 2.0;
+    value = std::max(fields_[kMin], std::min(value, fields_[kMax]));
+    sum_of_squares += (value - mean) * (value - mean) * counts_[i];
+  }
+  return sqrt(sum_of_squares / total);
+}
+
+
+void Histogram::Merge(const Histogram& other) {
+  if (other.count() == 0)
+    return;
+  for (size_t i = 0; i < other.counts_.size(); i++) {
+    if (other.counts_[i] == 0)
+      continue;
+    const int64_t value = std::min(other.LowestAt(i), highest_);
+    counts_[IndexOf(value)] += other.counts_[i];
+  }
+  const double highest = static_cast<double>(highest_);
+  const double min = std::min(other.fields_[kMin], highest);
+  const double max = std::min(other.fields_[kMax], highest);
+  if (fields_[kCount] == 0 || min < fields_[kMin])
+    fields_[kMin] = min;
+  if (max > fields_[kMax])
+    fields_[kMax] = max;
+  fields_[kCount] += other.fields_[kCount];
+  fields_[kSum] += other.fields_[kSum];
+}
+
+
+void Histogram::Reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  std::fill(fields_, fields_ + kFieldsCount, 0);
+}
+
+}  // namespace node
@@ -0,0 +1,104 @@
+#ifndef SRC_HISTOGRAM_H_
+#define SRC_HISTOGRAM_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace node {
+
+// Counts integer values from 0 to a given highest value in buckets whose
+// width grows with the values they hold, like HdrHistogram does. Values
+// below 2^|precision| get a bucket each, and every power of two above that
+// is split into 2^(|precision| - 1) buckets, so that any value a percentile
+// is reported as is less than 2^-(|precision| - 1) above the real one.
+//
+// The count, minimum, maximum and sum of the recorded values are kept exact
+// in fields(), which JS reads directly. Values above the highest value are
+// counted as the highest value. Not thread-safe.
+class Histogram {
+ public:
+  static const int kMinPrecision = 1;
+  static const int kMaxPrecision = 18;
+
+  enum Fields {
+    kCount,
+    kMin,
+    kMax,
+    kSum,
+    kFieldsCount
+  };
+
+  Histogram(int64_t highest, int precision);
+
+  inline void Record(int64_t value);
+
+  // The value below or at which |percentile| percent of the recorded values
+  // are, or 0 if there are none.
+  int64_t Percentile(double percentile) const;
+  // Of the recorded values, as far as the buckets tell them apart.
+  double Stddev() const;
+  // Adds all values recorded in |other|, which may have a different
+  // highest value and precision.
+  void Merge(const Histogram& other);
+  void Reset();
+
+  int64_t highest() const { return highest_; }
+  int precision() const { return precision_; }
+  uint64_t count() const { return static_cast<uint64_t>(fields_[kCount]); }
+  size_t memory_size() const { return counts_.size() * sizeof(counts_[0]); }
+  double* fields() { return fields_; }
+  const double* fields() const { return fields_; }
+
+ private:
+  inline size_t IndexOf(int64_t value) const;
+  // The lowest and highest values that are counted in bucket |index|.
+  int64_t LowestAt(size_t index) const;
+  int64_t HighestAt(size_t index) const;
+
+  const int64_t highest_;
+  const int precision_;
+  const size_t half_count_;
+  std::vector<uint64_t> counts_;
+  double fields_[kFieldsCount];
+};
+
+
+size_t Histogram::IndexOf(int64_t value) const {
+  const uint64_t v = static_cast<uint64_t>(value);
+  if (v < (static_cast<uint64_t>(1) << precision_))
+    return static_cast<size_t>(v);
+#if defined(__GNUC__)
+  const int msb = 63 - __builtin_clzll(v);
+#else
+  int msb = 0;
+  while ((v >> msb) > 1)
+    msb++;
+#endif
+  const int shift = msb - precision_ + 1;
+  return shift * half_count_ + static_cast<size_t>(v >> shift);
+}
+
+
+void Histogram::Record(int64_t value) {
+  if (value < 0)
+    value = 0;
+  else if (value > highest_)
+    value = highest_;
+  counts_[IndexOf(value)]++;
+  const double v = static_cast<double>(value);
+  if (fields_[kCount] == 0 || v < fields_[kMin])
+    fields_[kMin] = v;
+  if (v > fields_[kMax])
+    fields_[kMax] = v;
+  fields_[kCount]++;
+  fields_[kSum] += v;
+}
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_HISTOGRAM_H_
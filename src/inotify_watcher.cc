@@ -0,0 +1,436 @@
+#include "inotify_watcher.h"
+
+#ifdef __linux__
+
+#include "env.h"
+#include "env-inl.h"
+#include "node_internals.h"
+#include "string_bytes.h"
+#include "util.h"
+#include "util-inl.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace node {
+
+using v8::Array;
+using v8::Context;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::Null;
+using v8::Value;
+
+// The events that libuv watches for in uv_fs_event_start().
+static const uint32_t kEventMask = IN_ATTRIB | IN_CREATE | IN_MODIFY |
+                                   IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF |
+                                   IN_MOVED_FROM | IN_MOVED_TO;
+
+static const int kRename = 0;
+static const int kChange = 1;
+
+
+static std::string JoinPath(const std::string& dir, const char* name) {
+  return dir == "/" ? dir + name : dir + "/" + name;
+}
+
+
+// The name that the events for |path| are reported with by a watcher of
+// |root|, like libuv reports them: relative to the watched directory, or the
+// base name for the watched file or directory itself.
+static std::string RelativePath(const std::string& root,
+                                const std::string& path) {
+  if (root == "/" && path.size() > 1)
+    return path.substr(1);
+  if (path.size() > root.size() &&
+      path.compare(0, root.size(), root) == 0 &&
+      path[root.size()] == '/') {
+    return path.substr(root.size() + 1);
+  }
+  return path.substr(path.rfind('/') + 1);
+}
+
+
+InotifyWatcher::InotifyWatcher(Environment* env) : env_(env) {
+  fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd_ == -1)
+    fd_ = -errno;
+
+  uv_loop_t* loop = env->event_loop();
+  CHECK_EQ(0, uv_timer_init(loop, &timer_handle_));
+  uv_unref(reinterpret_cast<uv_handle_t*>(&timer_handle_));
+  std::vector<uv_handle_t*> handles = {
+    reinterpret_cast<uv_handle_t*>(&timer_handle_)
+  };
+  if (fd_ >= 0) {
+    CHECK_EQ(0, uv_poll_init(loop, &poll_handle_, fd_));
+    CHECK_EQ(0, uv_poll_start(&poll_handle_, UV_READABLE, OnPoll));
+    uv_unref(reinterpret_cast<uv_handle_t*>(&poll_handle_));
+    handles.push_back(reinterpret_cast<uv_handle_t*>(&poll_handle_));
+  }
+
+  for (uv_handle_t* handle : handles) {
+    env->RegisterHandleCleanup(handle, [](Environment* env,
+                                          uv_handle_t* handle,
+                                          void* arg) {
+      handle->data = env;
+      uv_close(handle, [](uv_handle_t* handle) {
+        static_cast<Environment*>(handle->data)->FinishHandleCleanup(handle);
+      });
+    }, nullptr);
+  }
+}
+
+
+InotifyWatcher::~InotifyWatcher() {
+  // The handles were closed by the handle cleanup of the Environment.
+  if (fd_ >= 0)
+    close(fd_);
+}
+
+
+int InotifyWatcher::Start(uint32_t id,
+                          const char* path,
+                          bool persistent,
+                          bool recursive,
+                          enum encoding encoding,
+                          uint32_t debounce) {
+  if (fd_ < 0)
+    return fd_;
+  CHECK_EQ(subscriptions_.count(id), 0);
+
+  std::string root = path;
+  while (root.size() > 1 && root.back() == '/')
+    root.pop_back();
+
+  Subscription* subscription = &subscriptions_[id];
+  subscription->path = root;
+  subscription->persistent = persistent;
+  subscription->recursive = recursive;
+  subscription->encoding = encoding;
+  subscription->debounce = debounce * static_cast<uint64_t>(1e6);
+
+  const int err = AddTree(id, subscription, root, false);
+  if (err != 0) {
+    Stop(id);
+    return err;
+  }
+  UpdateRef();
+  return 0;
+}
+
+
+void InotifyWatcher::Stop(uint32_t id) {
+  auto it = subscriptions_.find(id);
+  if (it == subscriptions_.end())
+    return;
+  for (int wd : it->second.watches) {
+    auto watch = watches_.find(wd);
+    CHECK(watch != watches_.end());
+    watch->second.subscriptions.erase(id);
+    if (watch->second.subscriptions.empty()) {
+      inotify_rm_watch(fd_, wd);
+      watches_.erase(watch);
+    }
+  }
+  subscriptions_.erase(it);
+  UpdateRef();
+}
+
+
+int InotifyWatcher::AddWatch(uint32_t id,
+                             Subscription* subscription,
+                             const std::string& path) {
+  const int wd = inotify_add_watch(fd_, path.c_str(), kEventMask);
+  if (wd == -1)
+    return -errno;
+  // Adding a watch for an inode that is already watched returns the same
+  // watch descriptor.
+  Watch* watch = &watches_[wd];
+  if (watch->path.empty())
+    watch->path = path;
+  watch->subscriptions.insert(id);
+  subscription->watches.insert(wd);
+  return 0;
+}
+
+
+int InotifyWatcher::AddTree(uint32_t id,
+                            Subscription* subscription,
+                            const std::string& path,
+                            bool report) {
+  int err = AddWatch(id, subscription, path);
+  if (err != 0 || !subscription->recursive)
+    return err;
+
+  std::vector<std::string> dirs = { path };
+  while (!dirs.empty()) {
+    const std::string dir = dirs.back();
+    dirs.pop_back();
+    // Not a directory, or already gone again.
+    DIR* stream = opendir(dir.c_str());
+    if (stream == nullptr)
+      continue;
+    while (const dirent* entry = readdir(stream)) {
+      if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+        continue;
+      const std::string child = JoinPath(dir, entry->d_name);
+      // The files that were created in a new directory before it was
+      // watched have not been reported yet.
+      if (report)
+        Enqueue(subscription, kRename,
+                RelativePath(subscription->path, child));
+
+      bool is_dir = entry->d_type == DT_DIR;
+      if (entry->d_type == DT_UNKNOWN) {
+        struct stat s;
+        is_dir = lstat(child.c_str(), &s) == 0 && S_ISDIR(s.st_mode);
+      }
+      if (!is_dir)
+        continue;
+      err = AddWatch(id, subscription, child);
+      // Running out of watches is worth failing for, the directories that
+      // cannot be read or are gone again are not.
+      if (err == UV_ENOSPC) {
+        closedir(stream);
+        return err;
+      }
+      if (err == 0)
+        dirs.push_back(child);
+    }
+    closedir(stream);
+  }
+  return 0;
+}
+
+
+void InotifyWatcher::RemoveWatch(int wd) {
+  auto it = watches_.find(wd);
+  if (it == watches_.end())
+    return;
+  for (uint32_t id : it->second.subscriptions)
+    subscriptions_[id].watches.erase(wd);
+  watches_.erase(it);
+}
+
+
+void InotifyWatcher::RemoveTree(const std::string& path) {
+  const std::string prefix = JoinPath(path, "");
+  std::vector<int> wds;
+  for (const auto& entry : watches_) {
+    const std::string& watch_path = entry.second.path;
+    if (watch_path == path || watch_path.compare(0, prefix.size(), prefix) == 0)
+      wds.push_back(entry.first);
+  }
+
+  for (int wd : wds) {
+    Watch* watch = &watches_[wd];
+    // Only the watches that a recursive watcher added for the directories
+    // below its path, a watcher of the directory itself keeps watching it.
+    for (auto it = watch->subscriptions.begin();
+         it != watch->subscriptions.end();) {
+      Subscription* subscription = &subscriptions_[*it];
+      if (subscription->recursive && subscription->path != watch->path) {
+        subscription->watches.erase(wd);
+        it = watch->subscriptions.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (watch->subscriptions.empty()) {
+      inotify_rm_watch(fd_, wd);
+      watches_.erase(wd);
+    }
+  }
+}
+
+
+void InotifyWatcher::Enqueue(Subscription* subscription,
+                             int type,
+                             const std::string& filename) {
+  if (type < 0) {
+    subscription->pending.push_back({ type, filename });
+    subscription->due = uv_hrtime();
+    return;
+  }
+  const std::string key = (type == kChange ? 'c' : 'r') + filename;
+  if (!subscription->pending_keys.insert(key).second)
+    return;
+  subscription->pending.push_back({ type, filename });
+  if (subscription->due == 0)
+    subscription->due = uv_hrtime() + subscription->debounce;
+}
+
+
+void InotifyWatcher::HandleEvent(int wd, uint32_t mask, const char* name) {
+  if (mask & IN_Q_OVERFLOW) {
+    for (auto& entry : subscriptions_)
+      Enqueue(&entry.second, kRename, "");
+    return;
+  }
+
+  auto it = watches_.find(wd);
+  // The events that were queued for a watch before it was removed.
+  if (it == watches_.end())
+    return;
+  if (mask & IN_IGNORED) {
+    RemoveWatch(wd);
+    return;
+  }
+
+  const std::string path =
+      *name == '\0' ? it->second.path : JoinPath(it->second.path, name);
+  const std::vector<uint32_t> ids(it->second.subscriptions.begin(),
+                                  it->second.subscriptions.end());
+  const int type = (mask & (IN_ATTRIB | IN_MODIFY)) ? kChange : kRename;
+  for (uint32_t id : ids) {
+    Subscription* subscription = &subscriptions_[id];
+    Enqueue(subscription, type, RelativePath(subscription->path, path));
+  }
+
+  if (!(mask & IN_ISDIR) || *name == '\0')
+    return;
+  if (mask & IN_MOVED_FROM)
+    RemoveTree(path);
+  if (mask & (IN_CREATE | IN_MOVED_TO)) {
+    for (uint32_t id : ids) {
+      Subscription* subscription = &subscriptions_[id];
+      if (!subscription->recursive)
+        continue;
+      const int err = AddTree(id, subscription, path, true);
+      if (err == UV_ENOSPC)
+        Enqueue(subscription, err, "");
+    }
+  }
+}
+
+
+void InotifyWatcher::Flush() {
+  const uint64_t now = uv_hrtime();
+  std::vector<std::pair<uint32_t, Subscription*>> due;
+  size_t count = 0;
+  for (auto& entry : subscriptions_) {
+    Subscription* subscription = &entry.second;
+    if (subscription->due != 0 && subscription->due <= now) {
+      due.emplace_back(entry.first, subscription);
+      count += subscription->pending.size();
+    }
+  }
+
+  if (count > 0) {
+    Isolate* isolate = env_->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env_->context());
+
+    Local<Array> events = Array::New(isolate, count * 3);
+    uint32_t index = 0;
+    for (const auto& entry : due) {
+      Subscription* subscription = entry.second;
+      Local<Value> id = Integer::NewFromUnsigned(isolate, entry.first);
+      for (const Event& event : subscription->pending) {
+        Local<Value> type;
+        if (event.type == kRename)
+          type = env_->rename_string();
+        else if (event.type == kChange)
+          type = env_->change_string();
+        else
+          type = Integer::New(isolate, event.type);
+
+        Local<Value> filename = Null(isolate);
+        if (!event.filename.empty()) {
+          const char* data = event.filename.data();
+          const size_t length = event.filename.size();
+          filename = StringBytes::Encode(isolate, data, length,
+                                         subscription->encoding);
+          if (filename.IsEmpty())
+            filename = StringBytes::Encode(isolate, data, length, BUFFER);
+        }
+
+        events->Set(index++, id);
+        events->Set(index++, type);
+        events->Set(index++, filename);
+      }
+      subscription->pending.clear();
+      subscription->pending_keys.clear();
+      subscription->due = 0;
+    }
+
+    Local<Value> argv[] = { events };
+    MakeCallback(env_, env_->process_object().As<Value>(),
+                 env_->fs_watch_callback_function(), arraysize(argv), argv);
+  }
+
+  // The callback may have started and stopped watchers.
+  uint64_t next = 0;
+  for (const auto& entry : subscriptions_) {
+    const uint64_t subscription_due = entry.second.due;
+    if (subscription_due != 0 && (next == 0 || subscription_due < next))
+      next = subscription_due;
+  }
+  if (next == 0) {
+    uv_timer_stop(&timer_handle_);
+  } else {
+    const uint64_t delay = next > now ? (next - now + 999999) / 1000000 : 0;
+    uv_timer_start(&timer_handle_, OnTimer, delay, 0);
+  }
+}
+
+
+void InotifyWatcher::UpdateRef() {
+  if (fd_ < 0)
+    return;
+  bool persistent = false;
+  for (const auto& entry : subscriptions_)
+    persistent = persistent || entry.second.persistent;
+  uv_handle_t* handle = reinterpret_cast<uv_handle_t*>(&poll_handle_);
+  if (persistent)
+    uv_ref(handle);
+  else
+    uv_unref(handle);
+}
+
+
+void InotifyWatcher::OnPoll(uv_poll_t* handle, int status, int events) {
+  InotifyWatcher* watcher =
+      ContainerOf(&InotifyWatcher::poll_handle_, handle);
+
+  if (status < 0) {
+    for (auto& entry : watcher->subscriptions_)
+      watcher->Enqueue(&entry.second, status, "");
+    watcher->Flush();
+    return;
+  }
+
+  alignas(inotify_event) char buffer[4096];
+  for (;;) {
+    const ssize_t size = read(watcher->fd_, buffer, sizeof(buffer));
+    if (size == -1 && errno == EINTR)
+      continue;
+    if (size <= 0)
+      break;
+    for (const char* p = buffer; p < buffer + size;) {
+      const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+      watcher->HandleEvent(event->wd, event->mask,
+                           event->len > 0 ? event->name : "");
+      p += sizeof(*event) + event->len;
+    }
+  }
+  watcher->Flush();
+}
+
+
+void InotifyWatcher::OnTimer(uv_timer_t* handle) {
+  InotifyWatcher* watcher =
+      ContainerOf(&InotifyWatcher::timer_handle_, handle);
+  watcher->Flush();
+}
+
+}  // namespace node
+
+#endif  // __linux__
@@ -0,0 +1,107 @@
+#ifndef SRC_INOTIFY_WATCHER_H_
+#define SRC_INOTIFY_WATCHER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#ifdef __linux__
+
+#include "node.h"
+#include "uv.h"
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace node {
+
+class Environment;
+
+// One inotify instance for all of the watchers of an Environment that
+// fs.watch() creates with the `recursive` or `debounce` options, instead of
+// a uv_fs_event_t, and so an inotify instance, per watcher. A recursive
+// watcher adds a watch for every directory below its path, and for those
+// that are created or moved there later.
+//
+// The events of a watcher are coalesced, so that an event is only reported
+// once for the same file, and held back until |debounce| milliseconds after
+// the first of them. All of the events that are due are then passed to
+// fs_watch_callback_function() in one array of (id, event type, filename)
+// triples, the event type being 'rename' or 'change', or a negative libuv
+// error code after which the watcher has stopped.
+class InotifyWatcher {
+ public:
+  explicit InotifyWatcher(Environment* env);
+  ~InotifyWatcher();
+
+  // Starts watcher |id| on |path|. Returns 0 or a negative libuv error code.
+  int Start(uint32_t id,
+            const char* path,
+            bool persistent,
+            bool recursive,
+            enum encoding encoding,
+            uint32_t debounce);
+  void Stop(uint32_t id);
+
+ private:
+  struct Event {
+    // A negative error code, or 0 for 'rename' and 1 for 'change'.
+    int type;
+    // Relative to the path of the watcher. Empty if the kernel's event
+    // queue overflowed and the events that were dropped are unknown.
+    std::string filename;
+  };
+
+  struct Subscription {
+    std::string path;
+    bool persistent;
+    bool recursive;
+    enum encoding encoding;
+    uint64_t debounce;  // In nanoseconds.
+    std::unordered_set<int> watches;
+    std::vector<Event> pending;
+    std::unordered_set<std::string> pending_keys;
+    uint64_t due = 0;
+  };
+
+  struct Watch {
+    std::string path;
+    std::unordered_set<uint32_t> subscriptions;
+  };
+
+  // Adds a watch on |path|, and if the subscription is recursive on the
+  // directories below it, reporting the files found there if |report| is
+  // set. Returns 0 or a negative libuv error code.
+  int AddTree(uint32_t id, Subscription* subscription,
+              const std::string& path, bool report);
+  int AddWatch(uint32_t id, Subscription* subscription,
+               const std::string& path);
+  void RemoveWatch(int wd);
+  // Removes the watches on |path| and the directories below it, after a
+  // directory was moved away.
+  void RemoveTree(const std::string& path);
+  void Enqueue(Subscription* subscription, int type,
+               const std::string& filename);
+  void HandleEvent(int wd, uint32_t mask, const char* name);
+  void Flush();
+  void UpdateRef();
+
+  static void OnPoll(uv_poll_t* handle, int status, int events);
+  static void OnTimer(uv_timer_t* handle);
+
+  Environment* const env_;
+  int fd_;
+  uv_poll_t poll_handle_;
+  uv_timer_t timer_handle_;
+  std::unordered_map<uint32_t, Subscription> subscriptions_;
+  std::unordered_map<int, Watch> watches_;
+};
+
+}  // namespace node
+
+#endif  // __linux__
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_INOTIFY_WATCHER_H_
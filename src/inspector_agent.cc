@@ -1,9 +1,13 @@
 #include "inspector_agent.h"
 
 #include "inspector_io.h"
+#include "base-object.h"
+#include "base-object-inl.h"
 #include "env.h"
 #include "env-inl.h"
 #include "node.h"
+#include "node_internals.h"
+#include "tracing/agent.h"
 #include "v8-inspector.h"
 #include "v8-platform.h"
 #include "util.h"
@@ -21,14 +25,19 @@
 namespace node {
 namespace inspector {
 namespace {
+using v8::Array;
 using v8::Context;
 using v8::Function;
 using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
 using v8::HandleScope;
 using v8::Isolate;
 using v8::Local;
+using v8::NewStringType;
 using v8::Object;
+using v8::Persistent;
 using v8::String;
+using v8::TryCatch;
 using v8::Value;
 
 using v8_inspector::StringBuffer;
@@ -44,6 +53,23 @@ std::unique_ptr<StringBuffer> ToProtocolString(Isolate* isolate,
   return StringBuffer::create(StringView(*buffer, buffer.length()));
 }
 
+bool Contains(const StringView& view, const char* needle) {
+  const size_t needle_length = strlen(needle);
+  if (view.length() < needle_length)
+    return false;
+  for (size_t i = 0; i <= view.length() - needle_length; i++) {
+    size_t j = 0;
+    while (j < needle_length &&
+           (view.is8Bit() ? view.characters8()[i + j] :
+                            view.characters16()[i + j]) == needle[j]) {
+      j++;
+    }
+    if (j == needle_length)
+      return true;
+  }
+  return false;
+}
+
 #ifdef __POSIX__
 static void EnableInspectorIOThreadSignalHandler(int signo) {
   uv_sem_post(&inspector_io_thread_semaphore);
@@ -310,6 +336,8 @@ class NodeInspectorClient : public v8_inspector::V8InspectorClient {
 
   void dispatchMessageFromFrontend(const StringView& message) {
     CHECK_NE(channel_, nullptr);
+    if (DispatchNodeTracingMessage(message))
+      return;
     channel_->dispatchProtocolMessage(message);
   }
 
@@ -359,6 +387,126 @@ class NodeInspectorClient : public v8_inspector::V8InspectorClient {
   }
 
  private:
+  // Handles the NodeTracing domain, which controls the same recording as
+  // the trace_events module:
+  //
+  //   NodeTracing.start   {traceConfig: {includedCategories: [string]}}
+  //   NodeTracing.stop
+  //   NodeTracing.rotate
+  //
+  // Returns false for all other messages, which are for V8.
+  bool DispatchNodeTracingMessage(const StringView& message) {
+    if (!Contains(message, "\"NodeTracing."))
+      return false;
+
+    Isolate* isolate = env_->isolate();
+    HandleScope handle_scope(isolate);
+    Local<Context> context = env_->context();
+    Context::Scope context_scope(context);
+    TryCatch try_catch(isolate);
+
+    Local<String> json;
+    if (message.is8Bit()) {
+      json = String::NewFromOneByte(isolate, message.characters8(),
+                                    NewStringType::kNormal,
+                                    message.length()).ToLocalChecked();
+    } else {
+      json = String::NewFromTwoByte(isolate, message.characters16(),
+                                    NewStringType::kNormal,
+                                    message.length()).ToLocalChecked();
+    }
+    Local<Value> value;
+    Local<Value> id;
+    Local<Value> method;
+    if (!v8::JSON::Parse(context, json).ToLocal(&value) ||
+        !value->IsObject() ||
+        !value.As<Object>()->Get(context, FIXED_ONE_BYTE_STRING(isolate, "id"))
+            .ToLocal(&id) || !id->IsInt32() ||
+        !value.As<Object>()->Get(context,
+                                 FIXED_ONE_BYTE_STRING(isolate, "method"))
+            .ToLocal(&method) || !method->IsString()) {
+      return false;
+    }
+    node::Utf8Value method_name(isolate, method);
+    if (strncmp(*method_name, "NodeTracing.", strlen("NodeTracing.")) != 0)
+      return false;
+
+    tracing::Agent* agent = GetTracingAgent();
+    int code = 0;
+    std::string error;
+    if (agent == nullptr) {
+      code = -32000;
+      error = "Tracing is not available";
+    } else if (strcmp(*method_name, "NodeTracing.start") == 0) {
+      std::string categories;
+      if (ParseIncludedCategories(value.As<Object>(), &categories)) {
+        agent->Start(categories);
+      } else {
+        code = -32602;
+        error = "Invalid traceConfig.includedCategories";
+      }
+    } else if (strcmp(*method_name, "NodeTracing.stop") == 0) {
+      agent->Stop();
+    } else if (strcmp(*method_name, "NodeTracing.rotate") == 0) {
+      agent->Rotate();
+    } else {
+      code = -32601;
+      error = std::string("'") + *method_name + "' wasn't found";
+    }
+
+    std::string response =
+        "{\"id\":" + std::to_string(id.As<v8::Int32>()->Value());
+    if (code == 0)
+      response += ",\"result\":{}}";
+    else
+      response += ",\"error\":{\"code\":" + std::to_string(code) +
+                  ",\"message\":\"" + error + "\"}}";
+    channel_->delegate()->OnMessage(
+        StringView(reinterpret_cast<const uint8_t*>(response.data()),
+                   response.size()));
+    return true;
+  }
+
+  // Joins params.traceConfig.includedCategories, which has to be a
+  // non-empty array of non-empty strings, with commas.
+  bool ParseIncludedCategories(Local<Object> message,
+                               std::string* categories) {
+    Isolate* isolate = env_->isolate();
+    Local<Context> context = env_->context();
+    Local<Value> params;
+    Local<Value> config;
+    Local<Value> included;
+    if (!message->Get(context, FIXED_ONE_BYTE_STRING(isolate, "params"))
+            .ToLocal(&params) || !params->IsObject() ||
+        !params.As<Object>()->Get(context,
+                                  FIXED_ONE_BYTE_STRING(isolate,
+                                                        "traceConfig"))
+            .ToLocal(&config) || !config->IsObject() ||
+        !config.As<Object>()->Get(context,
+                                  FIXED_ONE_BYTE_STRING(isolate,
+                                                        "includedCategories"))
+            .ToLocal(&included) || !included->IsArray()) {
+      return false;
+    }
+    Local<Array> array = included.As<Array>();
+    if (array->Length() == 0)
+      return false;
+    for (uint32_t i = 0; i < array->Length(); i++) {
+      Local<Value> category;
+      if (!array->Get(context, i).ToLocal(&category) || !category->IsString())
+        return false;
+      node::Utf8Value name(isolate, category);
+      if (name.length() == 0 || strchr(*name, ',') != nullptr ||
+          strchr(*name, '"') != nullptr) {
+        return false;
+      }
+      if (i > 0)
+        *categories += ',';
+      *categories += *name;
+    }
+    return true;
+  }
+
   node::Environment* env_;
   v8::Platform* platform_;
   bool terminated_;
@@ -633,5 +781,123 @@ void Agent::RunMessageLoop() {
   impl->client()->runMessageLoopOnPause(CONTEXT_GROUP_ID);
 }
 
+namespace {
+
+// An inspector session for lib/inspector.js. Messages are dispatched on the
+// main thread when JS posts them, and the responses and notifications are
+// handed to the JS callback right away, without the I/O thread or a socket.
+class JSBindingsConnection : public BaseObject,
+                             public InspectorSessionDelegate {
+ public:
+  JSBindingsConnection(Environment* env,
+                       Local<Object> wrap,
+                       Local<Function> callback)
+    : BaseObject(env, wrap),
+      callback_(env->isolate(), callback) {
+    MakeWeak<JSBindingsConnection>(this);
+    env->inspector_agent()->Connect(this);
+  }
+
+  ~JSBindingsConnection() override {
+    Disconnect();
+    callback_.Reset();
+  }
+
+  // A paused session has no way to receive the message that resumes it, so
+  // the debugger does not stay paused.
+  bool WaitForFrontendMessage() override {
+    return false;
+  }
+
+  void OnMessage(const StringView& message) override {
+    Isolate* isolate = env()->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env()->context());
+    Local<String> string;
+    if (message.is8Bit()) {
+      string = String::NewFromOneByte(isolate, message.characters8(),
+                                      NewStringType::kNormal,
+                                      message.length()).ToLocalChecked();
+    } else {
+      string = String::NewFromTwoByte(isolate, message.characters16(),
+                                      NewStringType::kNormal,
+                                      message.length()).ToLocalChecked();
+    }
+    Local<Value> argv[] = { string };
+    static_cast<void>(callback_.Get(isolate)->Call(env()->context(),
+                                                   object(),
+                                                   arraysize(argv),
+                                                   argv));
+  }
+
+  // A remote debugger that attaches takes over from the session, see
+  // InspectorIo::DispatchMessages().
+  bool IsConnected() {
+    Agent* agent = env()->inspector_agent();
+    return agent->IsStarted() && agent->delegate() == this;
+  }
+
+  void Disconnect() {
+    if (IsConnected())
+      env()->inspector_agent()->Disconnect();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    CHECK(args[0]->IsFunction());
+    Agent* agent = env->inspector_agent();
+    if (!agent->IsStarted())
+      return env->ThrowError("The inspector is not available");
+    if (agent->delegate() != nullptr)
+      return env->ThrowError("Another inspector session is connected");
+    new JSBindingsConnection(env, args.This(), args[0].As<Function>());
+  }
+
+  static void Dispatch(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    JSBindingsConnection* connection;
+    ASSIGN_OR_RETURN_UNWRAP(&connection, args.Holder());
+    CHECK(args[0]->IsString());
+    if (!connection->IsConnected())
+      return env->ThrowError("The inspector session is not connected");
+    TwoByteValue message(env->isolate(), args[0]);
+    env->inspector_agent()->Dispatch(StringView(*message, message.length()));
+  }
+
+  static void Disconnect(const FunctionCallbackInfo<Value>& args) {
+    JSBindingsConnection* connection;
+    ASSIGN_OR_RETURN_UNWRAP(&connection, args.Holder());
+    connection->Disconnect();
+  }
+
+ private:
+  Persistent<Function> callback_;
+};
+
+void InitInspectorBindings(Local<Object> target,
+                           Local<Value> unused,
+                           Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  Local<FunctionTemplate> connection =
+      env->NewFunctionTemplate(JSBindingsConnection::New);
+  connection->InstanceTemplate()->SetInternalFieldCount(1);
+  Local<String> name = FIXED_ONE_BYTE_STRING(env->isolate(), "Connection");
+  connection->SetClassName(name);
+  env->SetProtoMethod(connection, "dispatch", JSBindingsConnection::Dispatch);
+  env->SetProtoMethod(connection,
+                      "disconnect",
+                      JSBindingsConnection::Disconnect);
+  target->Set(env->context(),
+              name,
+              connection->GetFunction(env->context()).ToLocalChecked())
+                  .FromJust();
+}
+
+}  // anonymous namespace
+
 }  // namespace inspector
 }  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(inspector,
+                                  node::inspector::InitInspectorBindings)
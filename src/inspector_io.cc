@@ -82,6 +82,34 @@ std::string StringViewToUtf8(const StringView& view) {
   return result;
 }
 
+// Holds a message from the frontend that is all ASCII. V8 parses 8-bit
+// messages as they are, so these aren't converted to UTF-16 first.
+class AsciiStringBuffer : public StringBuffer {
+ public:
+  explicit AsciiStringBuffer(const std::string& message)
+      : message_(message),
+        view_(reinterpret_cast<const uint8_t*>(message_.data()),
+              message_.length()) {}
+
+  const StringView& string() override { return view_; }
+
+ private:
+  const std::string message_;
+  const StringView view_;
+};
+
+bool IsAscii(const std::string& message) {
+  for (char c : message) {
+    if (static_cast<unsigned char>(c) >= 0x80)
+      return false;
+  }
+  return true;
+}
+
+void ReleaseStringBuffer(void* buffer) {
+  delete static_cast<StringBuffer*>(buffer);
+}
+
 void HandleSyncCloseCb(uv_handle_t* handle) {
   *static_cast<bool*>(handle->data) = true;
 }
@@ -99,6 +127,8 @@ int CloseAsyncAndLoop(uv_async_t* async) {
 }  // namespace
 
 std::unique_ptr<StringBuffer> Utf8ToStringView(const std::string& message) {
+  if (IsAscii(message))
+    return std::unique_ptr<StringBuffer>(new AsciiStringBuffer(message));
   UnicodeString utf16 =
       UnicodeString::fromUTF8(StringPiece(message.data(), message.length()));
   StringView view(reinterpret_cast<const uint16_t*>(utf16.getBuffer()),
@@ -220,14 +250,25 @@ void InspectorIo::WriteCbIO(uv_async_t* async) {
   MessageQueue<TransportAction> outgoing_messages;
   InspectorIo* io = io_and_transport->second;
   io->SwapBehindLock(&io->outgoing_message_queue_, &outgoing_messages);
-  for (const auto& outgoing : outgoing_messages) {
+  for (auto& outgoing : outgoing_messages) {
     switch (std::get<0>(outgoing)) {
     case TransportAction::kStop:
       io_and_transport->first->Stop(nullptr);
       break;
     case TransportAction::kSendMessage:
-      std::string message = StringViewToUtf8(std::get<2>(outgoing)->string());
-      io_and_transport->first->Send(std::get<1>(outgoing), message);
+      const StringView& view = std::get<2>(outgoing)->string();
+      if (view.is8Bit()) {
+        io_and_transport->first->Send(std::get<1>(outgoing),
+                                      StringViewToUtf8(view));
+        break;
+      }
+      // Responses, like profiles and heap snapshot chunks, can be large.
+      // They are converted to UTF-8 as they are written, and the buffer is
+      // released once they have been.
+      StringBuffer* buffer = std::get<2>(outgoing).release();
+      io_and_transport->first->SendUtf16(std::get<1>(outgoing),
+                                         view.characters16(), view.length(),
+                                         ReleaseStringBuffer, buffer);
       break;
     }
   }
@@ -340,6 +381,10 @@ void InspectorIo::DispatchMessages() {
         fprintf(stderr, "Debugger attached.\n");
         session_delegate_ = std::unique_ptr<InspectorSessionDelegate>(
             new IoSessionDelegate(this));
+        // The remote debugger takes over from an in-process session that
+        // lib/inspector.js may have connected.
+        if (parent_env_->inspector_agent()->delegate() != nullptr)
+          parent_env_->inspector_agent()->Disconnect();
         parent_env_->inspector_agent()->Connect(session_delegate_.get());
         break;
       case InspectorAction::kEndSession:
@@ -12,6 +12,9 @@
 
 #define ACCEPT_KEY_LENGTH base64_encoded_size(20)
 #define BUFFER_GROWTH_CHUNK_SIZE 1024
+// UTF-16 code units of a message that inspector_write_utf16() converts at a
+// time, at most three times as many bytes of UTF-8.
+#define UTF16_CHUNK_LENGTH (16 * 1024)
 
 #define DUMP_READS 0
 #define DUMP_WRITES 0
@@ -55,11 +58,33 @@ static void remove_from_beginning(std::vector<char>* buffer, size_t count) {
   buffer->erase(buffer->begin(), buffer->begin() + count);
 }
 
+// A frame that waits in ws_state_s::queued_writes. It is either |bytes|,
+// written as they are, or a message written by inspector_write_utf16().
+struct ws_queued_write_s {
+  std::vector<char> bytes;
+  uv_write_cb write_cb;
+  const uint16_t* utf16;
+  size_t length;
+  size_t position;
+  void (*release)(void* release_data);
+  void* release_data;
+};
+
+static void release_queued_write(ws_queued_write_s* queued) {
+  if (queued->release != nullptr)
+    queued->release(queued->release_data);
+  delete queued;
+}
+
 static void dispose_inspector(uv_handle_t* handle) {
   InspectorSocket* inspector = inspector_from_stream(handle);
   inspector_cb close =
       inspector->ws_mode ? inspector->ws_state->close_cb : nullptr;
   inspector->buffer.clear();
+  if (inspector->ws_state != nullptr) {
+    for (ws_queued_write_s* queued : inspector->ws_state->queued_writes)
+      release_queued_write(queued);
+  }
   delete inspector->ws_state;
   inspector->ws_state = nullptr;
   if (close) {
@@ -81,6 +106,11 @@ struct WriteRequest {
       , storage(data, data + size)
       , buf(uv_buf_init(&storage[0], storage.size())) {}
 
+  WriteRequest(InspectorSocket* inspector, std::vector<char>&& data)
+      : inspector(inspector)
+      , storage(std::move(data))
+      , buf(uv_buf_init(&storage[0], storage.size())) {}
+
   static WriteRequest* from_write_req(uv_write_t* req) {
     return node::ContainerOf(&WriteRequest::req, req);
   }
@@ -111,6 +141,19 @@ static int write_to_client(InspectorSocket* inspector,
   return uv_write(&wr->req, stream, &wr->buf, 1, write_cb) < 0;
 }
 
+static int write_to_client(InspectorSocket* inspector,
+                           std::vector<char>&& data,
+                           uv_write_cb write_cb = write_request_cleanup) {
+#if DUMP_WRITES
+  printf("%s (%ld bytes):\n", __FUNCTION__, data.size());
+  dump_hex(&data[0], data.size());
+#endif
+
+  WriteRequest* wr = new WriteRequest(inspector, std::move(data));
+  uv_stream_t* stream = reinterpret_cast<uv_stream_t*>(&inspector->client);
+  return uv_write(&wr->req, stream, &wr->buf, 1, write_cb) < 0;
+}
+
 // Constants for hybi-10 frame format.
 
 typedef int OpCode;
@@ -135,19 +178,19 @@ const size_t kTwoBytePayloadLengthField = 126;
 const size_t kEightBytePayloadLengthField = 127;
 const size_t kMaskingKeyWidthInBytes = 4;
 
-static std::vector<char> encode_frame_hybi17(const char* message,
-                                             size_t data_length) {
-  std::vector<char> frame;
+// Appends the header of a text frame of |data_length| bytes to |frame|.
+static void encode_frame_header_hybi17(size_t data_length,
+                                       std::vector<char>* frame) {
   OpCode op_code = kOpCodeText;
-  frame.push_back(kFinalBit | op_code);
+  frame->push_back(kFinalBit | op_code);
   if (data_length <= kMaxSingleBytePayloadLength) {
-    frame.push_back(static_cast<char>(data_length));
+    frame->push_back(static_cast<char>(data_length));
   } else if (data_length <= 0xFFFF) {
-    frame.push_back(kTwoBytePayloadLengthField);
-    frame.push_back((data_length & 0xFF00) >> 8);
-    frame.push_back(data_length & 0xFF);
+    frame->push_back(kTwoBytePayloadLengthField);
+    frame->push_back((data_length & 0xFF00) >> 8);
+    frame->push_back(data_length & 0xFF);
   } else {
-    frame.push_back(kEightBytePayloadLengthField);
+    frame->push_back(kEightBytePayloadLengthField);
     char extended_payload_length[8];
     size_t remaining = data_length;
     // Fill the length into extended_payload_length in the network byte order.
@@ -155,14 +198,81 @@ static std::vector<char> encode_frame_hybi17(const char* message,
       extended_payload_length[7 - i] = remaining & 0xFF;
       remaining >>= 8;
     }
-    frame.insert(frame.end(), extended_payload_length,
-                 extended_payload_length + 8);
+    frame->insert(frame->end(), extended_payload_length,
+                  extended_payload_length + 8);
     ASSERT_EQ(0, remaining);
   }
+}
+
+static std::vector<char> encode_frame_hybi17(const char* message,
+                                             size_t data_length) {
+  std::vector<char> frame;
+  // The header is at most 10 bytes.
+  frame.reserve(data_length + 10);
+  encode_frame_header_hybi17(data_length, &frame);
   frame.insert(frame.end(), message, message + data_length);
   return frame;
 }
 
+// The number of code units in the UTF-16 sequence that starts at |unit|, 2
+// for a surrogate pair and 1 otherwise. |end| is the end of the message.
+static size_t utf16_sequence_length(const uint16_t* unit, const uint16_t* end) {
+  if (*unit >= 0xD800 && *unit <= 0xDBFF && unit + 1 < end &&
+      unit[1] >= 0xDC00 && unit[1] <= 0xDFFF) {
+    return 2;
+  }
+  return 1;
+}
+
+// The UTF-8 length of |length| UTF-16 code units, where lone surrogates
+// become U+FFFD, like ICU converts them.
+static size_t utf8_length(const uint16_t* data, size_t length) {
+  const uint16_t* end = data + length;
+  size_t result = 0;
+  while (data < end) {
+    if (*data < 0x80) {
+      result += 1;
+    } else if (*data < 0x800) {
+      result += 2;
+    } else if (utf16_sequence_length(data, end) == 2) {
+      result += 4;
+      data++;
+    } else {
+      result += 3;
+    }
+    data++;
+  }
+  return result;
+}
+
+static void append_utf8(const uint16_t* data, size_t length,
+                        std::vector<char>* output) {
+  const uint16_t* end = data + length;
+  while (data < end) {
+    uint32_t c = *data;
+    if (c < 0x80) {
+      output->push_back(static_cast<char>(c));
+    } else if (c < 0x800) {
+      output->push_back(static_cast<char>(0xC0 | (c >> 6)));
+      output->push_back(static_cast<char>(0x80 | (c & 0x3F)));
+    } else {
+      if (utf16_sequence_length(data, end) == 2) {
+        c = 0x10000 + ((c - 0xD800) << 10) + (data[1] - 0xDC00);
+        data++;
+        output->push_back(static_cast<char>(0xF0 | (c >> 18)));
+        output->push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+      } else {
+        if (c >= 0xD800 && c <= 0xDFFF)
+          c = 0xFFFD;
+        output->push_back(static_cast<char>(0xE0 | (c >> 12)));
+      }
+      output->push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+      output->push_back(static_cast<char>(0x80 | (c & 0x3F)));
+    }
+    data++;
+  }
+}
+
 static ws_decode_result decode_frame_hybi17(const std::vector<char>& buffer,
                                             bool client_frame,
                                             int* bytes_consumed,
@@ -235,14 +345,18 @@ static ws_decode_result decode_frame_hybi17(const std::vector<char>& buffer,
   }
   size_t payload_length = static_cast<size_t>(payload_length64);
 
-  if (buffer.size() - kMaskingKeyWidthInBytes < payload_length)
+  if (static_cast<size_t>(buffer.end() - it) <
+      kMaskingKeyWidthInBytes + payload_length) {
     return FRAME_INCOMPLETE;
+  }
 
   std::vector<char>::const_iterator masking_key = it;
   std::vector<char>::const_iterator payload = it + kMaskingKeyWidthInBytes;
+  size_t output_offset = output->size();
+  output->resize(output_offset + payload_length);
+  char* unmasked = output->data() + output_offset;
   for (size_t i = 0; i < payload_length; ++i)  // Unmask the payload.
-    output->insert(output->end(),
-                   payload[i] ^ masking_key[i % kMaskingKeyWidthInBytes]);
+    unmasked[i] = payload[i] ^ masking_key[i % kMaskingKeyWidthInBytes];
 
   size_t pos = it + kMaskingKeyWidthInBytes + payload_length - buffer.begin();
   *bytes_consumed = pos;
@@ -271,12 +385,83 @@ static void on_close_frame_written(uv_write_t* req, int status) {
   }
 }
 
+static void write_next_chunk(InspectorSocket* inspector);
+
+static void on_chunk_written(uv_write_t* req, int status) {
+  WriteRequest* wr = WriteRequest::from_write_req(req);
+  InspectorSocket* inspector = wr->inspector;
+  delete wr;
+  // The socket is closing, which releases what is left in the queue.
+  if (status < 0)
+    return;
+  std::deque<ws_queued_write_s*>& queued = inspector->ws_state->queued_writes;
+  ws_queued_write_s* front = queued.front();
+  if (front->position < front->length) {
+    write_next_chunk(inspector);
+    return;
+  }
+  queued.pop_front();
+  release_queued_write(front);
+  while (!queued.empty()) {
+    front = queued.front();
+    if (front->utf16 != nullptr) {
+      write_next_chunk(inspector);
+      return;
+    }
+    queued.pop_front();
+    write_to_client(inspector, std::move(front->bytes), front->write_cb);
+    delete front;
+  }
+}
+
+// Converts and writes the next chunk of the message at the front of the
+// queue, after the frame header if it is the first one.
+static void write_next_chunk(InspectorSocket* inspector) {
+  ws_queued_write_s* message = inspector->ws_state->queued_writes.front();
+  const uint16_t* end = message->utf16 + message->length;
+  size_t chunk_length = 0;
+  while (message->position + chunk_length < message->length &&
+         chunk_length < UTF16_CHUNK_LENGTH) {
+    chunk_length += utf16_sequence_length(
+        message->utf16 + message->position + chunk_length, end);
+  }
+  std::vector<char> output;
+  output.reserve(10 + 3 * chunk_length);
+  if (message->position == 0) {
+    encode_frame_header_hybi17(utf8_length(message->utf16, message->length),
+                               &output);
+  }
+  append_utf8(message->utf16 + message->position, chunk_length, &output);
+  message->position += chunk_length;
+  if (write_to_client(inspector, std::move(output), on_chunk_written) != 0) {
+    // Nothing more can be written, the rest waits for the socket to close.
+    message->position = message->length;
+  }
+}
+
+// Writes |data| once the messages that inspector_write_utf16() is writing
+// are written.
+static void write_frame(InspectorSocket* inspector, const char* data,
+                        size_t len, uv_write_cb write_cb) {
+  std::deque<ws_queued_write_s*>& queued = inspector->ws_state->queued_writes;
+  if (queued.empty()) {
+    write_to_client(inspector, data, len, write_cb);
+    return;
+  }
+  ws_queued_write_s* frame = new ws_queued_write_s();
+  frame->bytes.assign(data, data + len);
+  frame->write_cb = write_cb;
+  frame->utf16 = nullptr;
+  frame->release = nullptr;
+  queued.push_back(frame);
+}
+
 static void close_frame_received(InspectorSocket* inspector) {
   inspector->ws_state->received_close = true;
   if (!inspector->ws_state->close_sent) {
     invoke_read_callback(inspector, 0, 0);
-    write_to_client(inspector, CLOSE_FRAME, sizeof(CLOSE_FRAME),
-                    on_close_frame_written);
+    write_frame(inspector, CLOSE_FRAME, sizeof(CLOSE_FRAME),
+                on_close_frame_written);
   } else {
     shutdown_complete(inspector);
   }
@@ -583,12 +768,33 @@ void inspector_write(InspectorSocket* inspector, const char* data,
                      size_t len) {
   if (inspector->ws_mode) {
     std::vector<char> output = encode_frame_hybi17(data, len);
-    write_to_client(inspector, &output[0], output.size());
+    if (inspector->ws_state->queued_writes.empty())
+      write_to_client(inspector, std::move(output));
+    else
+      write_frame(inspector, &output[0], output.size(), write_request_cleanup);
   } else {
     write_to_client(inspector, data, len);
   }
 }
 
+void inspector_write_utf16(InspectorSocket* inspector,
+                           const uint16_t* data, size_t length,
+                           void (*release)(void* release_data),
+                           void* release_data) {
+  ASSERT(inspector->ws_mode);
+  ws_queued_write_s* message = new ws_queued_write_s();
+  message->write_cb = nullptr;
+  message->utf16 = data;
+  message->length = length;
+  message->position = 0;
+  message->release = release;
+  message->release_data = release_data;
+  std::deque<ws_queued_write_s*>& queued = inspector->ws_state->queued_writes;
+  queued.push_back(message);
+  if (queued.size() == 1)
+    write_next_chunk(inspector);
+}
+
 void inspector_close(InspectorSocket* inspector,
     inspector_cb callback) {
   // libuv throws assertions when closing stream that's already closed - we
@@ -601,8 +807,8 @@ void inspector_close(InspectorSocket* inspector,
     close_connection(inspector);
   } else {
     inspector_read_stop(inspector);
-    write_to_client(inspector, CLOSE_FRAME, sizeof(CLOSE_FRAME),
-                    on_close_frame_written);
+    write_frame(inspector, CLOSE_FRAME, sizeof(CLOSE_FRAME),
+                on_close_frame_written);
     inspector_read_start(inspector, nullptr, nullptr);
   }
 }
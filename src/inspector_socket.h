@@ -6,6 +6,7 @@
 #include "util-inl.h"
 #include "uv.h"
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -40,12 +41,17 @@ struct http_parsing_state_s {
   std::string current_header;
 };
 
+struct ws_queued_write_s;
+
 struct ws_state_s {
   uv_alloc_cb alloc_cb;
   uv_read_cb read_cb;
   inspector_cb close_cb;
   bool close_sent;
   bool received_close;
+  // Frames that wait for one that is written in chunks, see
+  // inspector_write_utf16(). The first one is being written.
+  std::deque<ws_queued_write_s*> queued_writes;
 };
 
 class InspectorSocket {
@@ -79,6 +85,16 @@ int inspector_read_start(InspectorSocket* inspector, uv_alloc_cb,
 void inspector_read_stop(InspectorSocket* inspector);
 void inspector_write(InspectorSocket* inspector,
     const char* data, size_t len);
+// Writes a text frame with the UTF-8 encoding of |length| UTF-16 code units
+// at |data|, which stay valid until |release| is called with |release_data|,
+// also if the socket closes first. A large message is converted and written
+// a chunk at a time, each once the one before it has been written, so that
+// it is neither converted nor held in one piece as UTF-8, and messages
+// written after it wait for it. Only works once the handshake is complete.
+void inspector_write_utf16(InspectorSocket* inspector,
+                           const uint16_t* data, size_t length,
+                           void (*release)(void* release_data),
+                           void* release_data);
 bool inspector_is_active(const InspectorSocket* inspector);
 
 inline InspectorSocket* inspector_from_stream(uv_tcp_t* stream) {
@@ -228,6 +228,8 @@ class SocketSession {
   InspectorSocketServer* GetServer() { return server_; }
   int Id() { return id_; }
   void Send(const std::string& message);
+  void SendUtf16(const uint16_t* data, size_t length,
+                 void (*release)(void* release_data), void* release_data);
   void SetTargetId(const std::string& target_id) {
     CHECK(target_id_.empty());
     target_id_ = target_id;
@@ -445,6 +447,18 @@ void InspectorSocketServer::Send(int session_id, const std::string& message) {
   }
 }
 
+void InspectorSocketServer::SendUtf16(int session_id,
+                                      const uint16_t* data, size_t length,
+                                      void (*release)(void* release_data),
+                                      void* release_data) {
+  auto session_iterator = connected_sessions_.find(session_id);
+  if (session_iterator != connected_sessions_.end()) {
+    session_iterator->second->SendUtf16(data, length, release, release_data);
+  } else {
+    release(release_data);
+  }
+}
+
 // static
 void InspectorSocketServer::ServerClosedCallback(uv_handle_t* server) {
   InspectorSocketServer* socket_server = InspectorSocketServer::From(server);
@@ -525,5 +539,11 @@ void SocketSession::Send(const std::string& message) {
   inspector_write(&socket_, message.data(), message.length());
 }
 
+void SocketSession::SendUtf16(const uint16_t* data, size_t length,
+                              void (*release)(void* release_data),
+                              void* release_data) {
+  inspector_write_utf16(&socket_, data, length, release, release_data);
+}
+
 }  // namespace inspector
 }  // namespace node
@@ -39,6 +39,11 @@ class InspectorSocketServer {
   bool Start(uv_loop_t* loop);
   void Stop(ServerCallback callback);
   void Send(int session_id, const std::string& message);
+  // Sends |length| UTF-16 code units as UTF-8 without converting them in one
+  // piece, see inspector_write_utf16(). |release| is called with
+  // |release_data| once |data| is no longer needed.
+  void SendUtf16(int session_id, const uint16_t* data, size_t length,
+                 void (*release)(void* release_data), void* release_data);
   void TerminateConnections(ServerCallback callback);
   int port() {
     return port_;
@@ -6,11 +6,16 @@
 #include "node_buffer.h"
 #include "stream_base.h"
 #include "stream_base-inl.h"
+#include "util.h"
+#include "util-inl.h"
 #include "v8.h"
 
+#include <string.h>
+#include <algorithm>
+
 namespace node {
 
-using v8::Array;
+using v8::ArrayBuffer;
 using v8::Context;
 using v8::External;
 using v8::FunctionCallbackInfo;
@@ -23,7 +28,8 @@ using v8::Value;
 
 JSStream::JSStream(Environment* env, Local<Object> obj, AsyncWrap* parent)
     : AsyncWrap(env, obj, AsyncWrap::PROVIDER_JSSTREAM, parent),
-      StreamBase(env) {
+      StreamBase(env),
+      writing_(false) {
   node::Wrap(obj, this);
   MakeWeak<JSStream>(this);
 }
@@ -89,21 +95,34 @@ int JSStream::DoWrite(WriteWrap* w,
 
   HandleScope scope(env()->isolate());
 
-  Local<Array> bufs_arr = Array::New(env()->isolate(), count);
-  Local<Object> buf;
-  for (size_t i = 0; i < count; i++) {
-    buf = Buffer::Copy(env(), bufs[i].base, bufs[i].len).ToLocalChecked();
-    bufs_arr->Set(i, buf);
+  // All of the buffers go to JS land as one, so that JS land writes them
+  // with one write() and completes them with one callback.
+  size_t length = 0;
+  for (size_t i = 0; i < count; i++)
+    length += bufs[i].len;
+
+  Local<Object> data;
+  if (count == 1) {
+    data = Buffer::Copy(env(), bufs[0].base, length).ToLocalChecked();
+  } else {
+    data = Buffer::New(env(), length).ToLocalChecked();
+    char* dest = Buffer::Data(data);
+    for (size_t i = 0; i < count; i++) {
+      memcpy(dest, bufs[i].base, bufs[i].len);
+      dest += bufs[i].len;
+    }
   }
 
   Local<Value> argv[] = {
     w->object(),
-    bufs_arr
+    data
   };
 
   w->Dispatched();
+  writing_ = true;
   Local<Value> res =
       MakeCallback(env()->onwrite_string(), arraysize(argv), argv);
+  writing_ = false;
 
   return res->Int32Value();
 }
@@ -171,6 +190,27 @@ void JSStream::DoAfterWrite(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// afterWrite(req, status)
+// Like doAfterWrite(req) and finishWrite(req, status), except that it returns
+// false and does nothing if it is called from within onwrite, as running the
+// next tick queue at the end of onwrite can do. The caller of DoWrite() is not
+// ready for the write to complete yet, and JS land has to try again later.
+void JSStream::AfterWrite(const FunctionCallbackInfo<Value>& args) {
+  JSStream* wrap;
+  CHECK(args[0]->IsObject());
+  WriteWrap* w;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  ASSIGN_OR_RETURN_UNWRAP(&w, args[0].As<Object>());
+
+  if (wrap->writing_)
+    return args.GetReturnValue().Set(false);
+
+  wrap->OnAfterWrite(w);
+  w->Done(args[1]->Int32Value());
+  args.GetReturnValue().Set(true);
+}
+
+
 template <class Wrap>
 void JSStream::Finish(const FunctionCallbackInfo<Value>& args) {
   Wrap* w;
@@ -181,26 +221,44 @@ void JSStream::Finish(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// readBuffer(data[, offset, length])
+// |data| is a Buffer or other ArrayBufferView, or an ArrayBuffer, of which
+// |length| bytes from |offset| on are read. It is copied straight into the
+// buffers of the consumer of the stream, such as the input BIO of a TLSWrap.
 void JSStream::ReadBuffer(const FunctionCallbackInfo<Value>& args) {
   JSStream* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
 
-  CHECK(Buffer::HasInstance(args[0]));
-  char* data = Buffer::Data(args[0]);
-  int len = Buffer::Length(args[0]);
+  const char* data;
+  size_t len;
+  if (args[0]->IsArrayBuffer()) {
+    ArrayBuffer::Contents contents = args[0].As<ArrayBuffer>()->GetContents();
+    CHECK(args[1]->IsUint32());
+    CHECK(args[2]->IsUint32());
+    const size_t offset = args[1]->Uint32Value();
+    len = args[2]->Uint32Value();
+    CHECK_LE(offset, contents.ByteLength());
+    CHECK_LE(len, contents.ByteLength() - offset);
+    data = static_cast<const char*>(contents.Data()) + offset;
+  } else {
+    SPREAD_BUFFER_ARG(args[0], view);
+    data = view_data;
+    len = view_length;
+  }
 
-  do {
+  while (len != 0) {
     uv_buf_t buf;
-    ssize_t avail = len;
     wrap->OnAlloc(len, &buf);
-    if (static_cast<ssize_t>(buf.len) < avail)
-      avail = buf.len;
+    // The consumer has gone away, or has no room.
+    if (buf.len == 0)
+      break;
+    const size_t avail = std::min(len, buf.len);
 
     memcpy(buf.base, data, avail);
     data += avail;
     len -= avail;
     wrap->OnRead(avail, &buf);
-  } while (len != 0);
+  }
 }
 
 
@@ -225,6 +283,7 @@ void JSStream::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "doRead", DoRead);
   env->SetProtoMethod(t, "doAfterWrite", DoAfterWrite);
   env->SetProtoMethod(t, "finishWrite", Finish<WriteWrap>);
+  env->SetProtoMethod(t, "afterWrite", AfterWrite);
   env->SetProtoMethod(t, "finishShutdown", Finish<ShutdownWrap>);
   env->SetProtoMethod(t, "readBuffer", ReadBuffer);
   env->SetProtoMethod(t, "emitEOF", EmitEOF);
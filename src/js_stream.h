@@ -41,11 +41,16 @@ class JSStream : public AsyncWrap, public StreamBase {
   static void DoAlloc(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DoRead(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DoAfterWrite(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void AfterWrite(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void ReadBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void EmitEOF(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   template <class Wrap>
   static void Finish(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+ private:
+  // Whether DoWrite() is calling into JS land.
+  bool writing_;
 };
 
 }  // namespace node
@@ -0,0 +1,86 @@
+#include "loop_metrics.h"
+
+#include "env.h"
+#include "env-inl.h"
+#include "util.h"
+#include "util-inl.h"
+
+namespace node {
+
+LoopMetrics::LoopMetrics(Environment* env) {
+  uv_loop_t* loop = env->event_loop();
+  CHECK_EQ(0, uv_prepare_init(loop, &prepare_handle_));
+  CHECK_EQ(0, uv_check_init(loop, &check_handle_));
+  CHECK_EQ(0, uv_timer_init(loop, &lag_timer_));
+
+  iteration_start_ = last_lag_sample_ = uv_hrtime();
+  // The check handle that was started last runs first, right after poll.
+  CHECK_EQ(0, uv_prepare_start(&prepare_handle_, PrepareCb));
+  CHECK_EQ(0, uv_check_start(&check_handle_, CheckCb));
+  CHECK_EQ(0, uv_timer_start(&lag_timer_, LagTimerCb,
+                             kLagInterval, kLagInterval));
+
+  uv_handle_t* handles[] = {
+    reinterpret_cast<uv_handle_t*>(&prepare_handle_),
+    reinterpret_cast<uv_handle_t*>(&check_handle_),
+    reinterpret_cast<uv_handle_t*>(&lag_timer_)
+  };
+  for (uv_handle_t* handle : handles) {
+    uv_unref(handle);
+    env->RegisterHandleCleanup(handle, [](Environment* env,
+                                          uv_handle_t* handle,
+                                          void* arg) {
+      handle->data = env;
+      uv_close(handle, [](uv_handle_t* handle) {
+        static_cast<Environment*>(handle->data)->FinishHandleCleanup(handle);
+      });
+    }, nullptr);
+  }
+}
+
+
+void LoopMetrics::PrepareCb(uv_prepare_t* handle) {
+  LoopMetrics* metrics = ContainerOf(&LoopMetrics::prepare_handle_, handle);
+  metrics->prepare_time_ = uv_hrtime();
+  metrics->poll_callback_time_ = 0;
+}
+
+
+void LoopMetrics::CheckCb(uv_check_t* handle) {
+  LoopMetrics* metrics = ContainerOf(&LoopMetrics::check_handle_, handle);
+  double* fields = metrics->fields_;
+  const uint64_t now = uv_hrtime();
+
+  if (metrics->prepare_time_ != 0) {
+    const uint64_t poll_time = now - metrics->prepare_time_;
+    const uint64_t idle_time = poll_time > metrics->poll_callback_time_ ?
+        poll_time - metrics->poll_callback_time_ : 0;
+    fields[kPollTime] += poll_time / 1e6;
+    fields[kIdleTime] += idle_time / 1e6;
+    metrics->iteration_idle_time_ += idle_time;
+    metrics->prepare_time_ = 0;
+  }
+
+  // An iteration runs from one check phase to the next.
+  const uint64_t iteration_time = now - metrics->iteration_start_;
+  const double busy_time =
+      (iteration_time - metrics->iteration_idle_time_) / 1e6;
+  if (busy_time > fields[kMaxBusyTime])
+    fields[kMaxBusyTime] = busy_time;
+  fields[kIterations]++;
+  metrics->iteration_start_ = now;
+  metrics->iteration_idle_time_ = 0;
+}
+
+
+void LoopMetrics::LagTimerCb(uv_timer_t* handle) {
+  LoopMetrics* metrics = ContainerOf(&LoopMetrics::lag_timer_, handle);
+  const uint64_t now = uv_hrtime();
+  const uint64_t due = metrics->last_lag_sample_ + kLagInterval * 1000000;
+  metrics->last_lag_sample_ = now;
+  // libuv runs timers by its cached millisecond clock, which can make them
+  // look a little early.
+  metrics->lag_.Record(now > due ? (now - due) / 1000 : 0);
+}
+
+}  // namespace node
@@ -0,0 +1,88 @@
+#ifndef SRC_LOOP_METRICS_H_
+#define SRC_LOOP_METRICS_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "histogram.h"
+#include "uv.h"
+
+#include <stdint.h>
+
+namespace node {
+
+class Environment;
+
+// Measures where the event loop spends its time. A prepare and a check
+// handle bracket the poll phase of every iteration, and the part of it that
+// was not spent in callbacks (see Environment::AsyncCallbackScope) was spent
+// waiting for I/O. A timer that is due every kLagInterval milliseconds tells
+// how far behind the loop is by how late it runs.
+//
+// fields() accumulates the results in milliseconds. JS reads them directly
+// and resets them by filling the array with zeroes. lag() holds the lags in
+// microseconds.
+class LoopMetrics {
+ public:
+  static const uint64_t kLagInterval = 10;
+
+  enum Fields {
+    kIterations,
+    // Time spent in the poll phase, and how much of it went to waiting.
+    kPollTime,
+    kIdleTime,
+    // Time spent in callbacks into JS, in any phase.
+    kCallbackTime,
+    // The longest iteration, not counting the time waiting for I/O.
+    kMaxBusyTime,
+    kFieldsCount
+  };
+
+  explicit LoopMetrics(Environment* env);
+
+  double* fields() { return fields_; }
+  Histogram* lag() { return &lag_; }
+
+  // Called when the outermost callback into JS starts and ends.
+  inline void EnterCallback();
+  inline void ExitCallback();
+
+ private:
+  static void PrepareCb(uv_prepare_t* handle);
+  static void CheckCb(uv_check_t* handle);
+  static void LagTimerCb(uv_timer_t* handle);
+
+  uv_prepare_t prepare_handle_;
+  uv_check_t check_handle_;
+  uv_timer_t lag_timer_;
+  // In nanoseconds. A zero |prepare_time_| means that the loop is not in
+  // the poll phase, and a zero |callback_start_| that no callback is running.
+  uint64_t prepare_time_ = 0;
+  uint64_t callback_start_ = 0;
+  uint64_t poll_callback_time_ = 0;
+  uint64_t iteration_start_;
+  uint64_t iteration_idle_time_ = 0;
+  uint64_t last_lag_sample_;
+  double fields_[kFieldsCount] = {};
+  // Up to an hour, to within 1%.
+  Histogram lag_{3600 * 1000 * 1000LL, 8};
+};
+
+void LoopMetrics::EnterCallback() {
+  callback_start_ = uv_hrtime();
+}
+
+void LoopMetrics::ExitCallback() {
+  if (callback_start_ == 0)
+    return;
+  const uint64_t elapsed = uv_hrtime() - callback_start_;
+  callback_start_ = 0;
+  fields_[kCallbackTime] += elapsed / 1e6;
+  if (prepare_time_ != 0)
+    poll_callback_time_ += elapsed;
+}
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_LOOP_METRICS_H_
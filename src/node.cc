@@ -21,8 +21,11 @@
 
 #include "node.h"
 #include "node_buffer.h"
+#include "node_code_cache.h"
 #include "node_constants.h"
+#include "node_counter_registry.h"
 #include "node_javascript.h"
+#include "node_platform.h"
 #include "node_version.h"
 #include "node_internals.h"
 #include "node_revert.h"
@@ -54,10 +57,14 @@
 #include "env.h"
 #include "env-inl.h"
 #include "handle_wrap.h"
+#include "node_histogram.h"
+#include "node_threadpool.h"
+#include "node_worker.h"
 #include "req-wrap.h"
 #include "req-wrap-inl.h"
 #include "string_bytes.h"
 #include "tracing/agent.h"
+#include "tracing/trace_event.h"
 #include "util.h"
 #include "uv.h"
 #if NODE_USE_V8_PLATFORM
@@ -143,6 +150,7 @@ using v8::ObjectTemplate;
 using v8::Promise;
 using v8::PromiseRejectMessage;
 using v8::PropertyCallbackInfo;
+using v8::ScriptCompiler;
 using v8::ScriptOrigin;
 using v8::SealHandleScope;
 using v8::String;
@@ -171,6 +179,8 @@ static node_module* modlist_linked;
 static node_module* modlist_addon;
 static bool trace_enabled = false;
 static std::string trace_enabled_categories;  // NOLINT(runtime/string)
+static bool trace_binary_format = false;
+static bool startup_profile = false;
 
 #if defined(NODE_HAVE_I18N_SUPPORT)
 // Path to ICU data (for i18n / Intl)
@@ -209,9 +219,34 @@ bool trace_warnings = false;
 // that is used by lib/module.js
 bool config_preserve_symlinks = false;
 
+// Set in node.cc by ParseArgs when --module-resolution-cache is used.
+// Used in node_file.cc to cache the lookups done by lib/module.js.
+bool config_module_resolution_cache = false;
+
 // Set in node.cc by ParseArgs when --redirect-warnings= is used.
 std::string config_warning_file;  // NOLINT(runtime/string)
 
+// Set in node.cc by ParseArgs when --compile-cache= is used.
+std::string config_compile_cache_dir;  // NOLINT(runtime/string)
+
+// Set in node.cc by ParseArgs when --app-archive= is used.
+std::string config_app_archive;  // NOLINT(runtime/string)
+
+// Set in node.cc by ParseArgs when --resolution-cache= is used.
+std::string config_resolution_cache;  // NOLINT(runtime/string)
+
+// Set in node.cc by ParseArgs when --build-resolution-cache= is used.
+std::string config_build_resolution_cache;  // NOLINT(runtime/string)
+
+// Set in node.cc by ParseArgs when --immediate-budget= is used.
+unsigned int config_immediate_budget = 0;
+
+// Set in node.cc by ParseArgs when --heapsnapshot-signal= is used.
+std::string config_heap_snapshot_signal;  // NOLINT(runtime/string)
+
+// Set in node.cc by ParseArgs when --stdio-buffer= is used.
+std::string config_stdio_buffer;  // NOLINT(runtime/string)
+
 // Set in node.cc by ParseArgs when --expose-internals or --expose_internals is
 // used.
 // Used in node_config.cc to set a constant on process.binding('config')
@@ -222,6 +257,7 @@ bool v8_initialized = false;
 
 // process-relative uptime base, initialized at start-up
 static double prog_start_time;
+static uint64_t prog_start_hrtime;
 static bool debugger_running;
 static uv_async_t dispatch_debug_messages_async;
 
@@ -233,9 +269,27 @@ static node::DebugOptions debug_options;
 static struct {
 #if NODE_USE_V8_PLATFORM
   void Initialize(int thread_pool_size) {
-    platform_ = v8::platform::CreateDefaultPlatform(thread_pool_size);
-    V8::InitializePlatform(platform_);
+    // V8's background tasks run on the CPU pool, which --v8-pool-size sizes
+    // unless NODE_THREADPOOL_CPU_SIZE is set. The default platform still
+    // starts one thread of its own, which stays idle.
+    if (thread_pool_size < 1) {
+      uv_cpu_info_t* cpus;
+      int count;
+      thread_pool_size = 1;
+      if (uv_cpu_info(&cpus, &count) == 0) {
+        if (count > 1)
+          thread_pool_size = count - 1;
+        uv_free_cpu_info(cpus, count);
+      }
+    }
+    threadpool::SetDefaultSize(threadpool::kCpuWork, thread_pool_size);
+    platform_ = v8::platform::CreateDefaultPlatform(1);
+    node_platform_ = new NodePlatform(platform_);
+    V8::InitializePlatform(node_platform_);
     tracing::TraceEventHelper::SetCurrentPlatform(platform_);
+    // Created before anything looks up a trace category, even if tracing is
+    // only started at runtime.
+    tracing_agent_ = new tracing::Agent(platform_, trace_binary_format);
   }
 
   void PumpMessageLoop(Isolate* isolate) {
@@ -243,7 +297,11 @@ static struct {
   }
 
   void Dispose() {
-    delete platform_;
+    delete tracing_agent_;
+    tracing_agent_ = nullptr;
+    // Also deletes |platform_|.
+    delete node_platform_;
+    node_platform_ = nullptr;
     platform_ = nullptr;
   }
 
@@ -255,16 +313,27 @@ static struct {
 #endif  // HAVE_INSPECTOR
 
   void StartTracingAgent() {
-    CHECK(tracing_agent_ == nullptr);
-    tracing_agent_ = new tracing::Agent();
-    tracing_agent_->Start(platform_, trace_enabled_categories);
+    tracing_agent_->Start(trace_enabled_categories);
   }
 
   void StopTracingAgent() {
-    tracing_agent_->Stop();
+    tracing_agent_->Shutdown();
+  }
+
+  tracing::Agent* GetTracingAgent() {
+    return tracing_agent_;
+  }
+
+  // Records CPU profile samples into the trace while the
+  // disabled-by-default-v8.cpu_profiler category is enabled.
+  v8::TracingCpuProfiler* CreateTracingCpuProfiler(Isolate* isolate) {
+    return v8::TracingCpuProfiler::Create(isolate).release();
   }
 
+  // The default platform, which |node_platform_| passes foreground tasks
+  // and tracing to.
   v8::Platform* platform_;
+  NodePlatform* node_platform_;
   tracing::Agent* tracing_agent_;
 #else  // !NODE_USE_V8_PLATFORM
   void Initialize(int thread_pool_size) {}
@@ -281,9 +350,67 @@ static struct {
                     "so event tracing is not available.\n");
   }
   void StopTracingAgent() {}
+  tracing::Agent* GetTracingAgent() { return nullptr; }
+  v8::TracingCpuProfiler* CreateTracingCpuProfiler(Isolate* isolate) {
+    return nullptr;
+  }
 #endif  // !NODE_USE_V8_PLATFORM
 } v8_platform;
 
+tracing::Agent* GetTracingAgent() {
+  return v8_platform.GetTracingAgent();
+}
+
+
+// Returns the flag of the node.startup trace category if it is recorded, as
+// it is with --startup-profile.
+static const uint8_t* StartupTraceCategory() {
+  if (tracing::TraceEventHelper::GetCurrentPlatform() == nullptr)
+    return nullptr;
+  static const uint8_t* category_enabled =
+      TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED("node.startup");
+  if (!(*category_enabled & kEnabledForRecording_CategoryGroupEnabledFlags))
+    return nullptr;
+  return category_enabled;
+}
+
+
+// Records a step of startup, or the loading of the binding |module|, as an
+// event of the node.startup category that lasts as long as the scope.
+class StartupTraceScope {
+ public:
+  explicit StartupTraceScope(const char* name, const char* module = nullptr)
+      : category_enabled_(StartupTraceCategory()), name_(name) {
+    if (category_enabled_ == nullptr)
+      return;
+    if (module == nullptr) {
+      handle_ = tracing::AddTraceEvent(
+          TRACE_EVENT_PHASE_COMPLETE, category_enabled_, name_,
+          tracing::kGlobalScope, tracing::kNoId, tracing::kNoId,
+          TRACE_EVENT_FLAG_NONE);
+    } else {
+      handle_ = tracing::AddTraceEvent(
+          TRACE_EVENT_PHASE_COMPLETE, category_enabled_, name_,
+          tracing::kGlobalScope, tracing::kNoId, tracing::kNoId,
+          TRACE_EVENT_FLAG_NONE, "module", TRACE_STR_COPY(module));
+    }
+  }
+
+  ~StartupTraceScope() {
+    if (category_enabled_ != nullptr) {
+      TRACE_EVENT_API_UPDATE_TRACE_EVENT_DURATION(category_enabled_, name_,
+                                                  handle_);
+    }
+  }
+
+ private:
+  const uint8_t* const category_enabled_;
+  const char* const name_;
+  uint64_t handle_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTraceScope);
+};
+
 #ifdef __POSIX__
 static const unsigned kMaxSignal = 32;
 #endif
@@ -1041,10 +1168,42 @@ Local<Value> WinapiErrnoException(Isolate* isolate,
 
 
 void* ArrayBufferAllocator::Allocate(size_t size) {
-  if (zero_fill_field_ || zero_fill_all_buffers)
+  if (!zero_fill_field_ && !zero_fill_all_buffers)
+    return AllocateUninitialized(size);
+  void* data = arena_->Allocate(size);
+  if (data == nullptr)
     return node::UncheckedCalloc(size);
-  else
+  return memset(data, 0, size);
+}
+
+
+void* ArrayBufferAllocator::AllocateUninitialized(size_t size) {
+  void* data = arena_->Allocate(size);
+  if (data == nullptr)
     return node::UncheckedMalloc(size);
+  return data;
+}
+
+
+void ArrayBufferAllocator::Free(void* data, size_t) {
+  if (!arena_->Free(data))
+    free(data);
+}
+
+
+void* ArrayBufferAllocator::Release(void* data, size_t size) {
+  // Blocks of the arena go away with it, so they are copied out. Larger
+  // backing stores never come from the arena.
+  if (size == 0 || size > BufferArena::kMaxSize)
+    return data;
+  void* copy = node::UncheckedMalloc(size);
+  if (copy == nullptr)
+    return nullptr;
+  memcpy(copy, data, size);
+  if (arena_->Free(data))
+    return copy;
+  free(copy);
+  return data;
 }
 
 namespace {
@@ -1237,18 +1396,36 @@ Local<Value> MakeCallback(Environment* env,
   // If you hit this assertion, you forgot to enter the v8::Context first.
   CHECK_EQ(env->context(), env->isolate()->GetCurrentContext());
 
-  Local<Function> pre_fn = env->async_hooks_pre_function();
-  Local<Function> post_fn = env->async_hooks_post_function();
+  // Most callbacks run without domains or hooks. Then there is nothing to do
+  // but the call itself and the tick queue afterwards.
+  if (!env->callback_hooks_active()) {
+    Environment::AsyncCallbackScope callback_scope(env);
+    Local<Value> ret = callback->Call(recv, argc, argv);
+    if (ret.IsEmpty()) {
+      return callback_scope.in_makecallback() ?
+          ret : Undefined(env->isolate()).As<Value>();
+    }
+    if (callback_scope.in_makecallback() || TickAfterCallback(env))
+      return ret;
+    return Undefined(env->isolate());
+  }
+
+  Environment::AsyncHooks* hooks = env->async_hooks();
+  const bool has_pre = hooks->has_hook(Environment::AsyncHooks::kPre);
+  const bool has_post = hooks->has_hook(Environment::AsyncHooks::kPost);
   Local<Object> object, domain;
   bool ran_init_callback = false;
   bool has_domain = false;
 
   Environment::AsyncCallbackScope callback_scope(env);
 
+  if (recv->IsObject())
+    object = recv.As<Object>();
+
   // TODO(trevnorris): Adding "_asyncQueue" to the "this" in the init callback
   // is a horrible way to detect usage. Rethink how detection should happen.
-  if (recv->IsObject()) {
-    object = recv.As<Object>();
+  // Without a pre or post hook there is nothing to detect it for.
+  if ((has_pre || has_post) && !object.IsEmpty()) {
     Local<Value> async_queue_v = object->Get(env->async_queue_string());
     if (async_queue_v->IsObject())
       ran_init_callback = true;
@@ -1275,8 +1452,9 @@ Local<Value> MakeCallback(Environment* env,
     }
   }
 
-  if (ran_init_callback && !pre_fn.IsEmpty()) {
+  if (ran_init_callback && has_pre) {
     TryCatch try_catch(env->isolate());
+    Local<Function> pre_fn = env->async_hooks_pre_function();
     MaybeLocal<Value> ar = pre_fn->Call(env->context(), object, 0, nullptr);
     if (ar.IsEmpty()) {
       ClearFatalExceptionHandlers(env);
@@ -1287,13 +1465,14 @@ Local<Value> MakeCallback(Environment* env,
 
   Local<Value> ret = callback->Call(recv, argc, argv);
 
-  if (ran_init_callback && !post_fn.IsEmpty()) {
+  if (ran_init_callback && has_post) {
     Local<Value> did_throw = Boolean::New(env->isolate(), ret.IsEmpty());
     // Currently there's no way to retrieve an uid from node::MakeCallback().
     // This needs to be fixed.
     Local<Value> vals[] =
         { Undefined(env->isolate()).As<Value>(), did_throw };
     TryCatch try_catch(env->isolate());
+    Local<Function> post_fn = env->async_hooks_post_function();
     MaybeLocal<Value> ar =
         post_fn->Call(env->context(), object, arraysize(vals), vals);
     if (ar.IsEmpty()) {
@@ -1324,24 +1503,29 @@ Local<Value> MakeCallback(Environment* env,
     return ret;
   }
 
+  if (!TickAfterCallback(env)) {
+    return Undefined(env->isolate());
+  }
+
+  return ret;
+}
+
+
+bool TickAfterCallback(Environment* env) {
   Environment::TickInfo* tick_info = env->tick_info();
 
   if (tick_info->length() == 0) {
     env->isolate()->RunMicrotasks();
   }
 
-  Local<Object> process = env->process_object();
-
+  // The microtasks may have queued ticks.
   if (tick_info->length() == 0) {
     tick_info->set_index(0);
-    return ret;
-  }
-
-  if (env->tick_callback_function()->Call(process, 0, nullptr).IsEmpty()) {
-    return Undefined(env->isolate());
+    return true;
   }
 
-  return ret;
+  Local<Object> process = env->process_object();
+  return !env->tick_callback_function()->Call(process, 0, nullptr).IsEmpty();
 }
 
 
@@ -1735,9 +1919,11 @@ static void ReportException(Environment* env, const TryCatch& try_catch) {
 
 
 // Executes a str within the current v8 context.
+// Compiles with the code cache of |cache_id| if there is one.
 static Local<Value> ExecuteString(Environment* env,
                                   Local<String> source,
-                                  Local<String> filename) {
+                                  Local<String> filename,
+                                  const char* cache_id = nullptr) {
   EscapableHandleScope scope(env->isolate());
   TryCatch try_catch(env->isolate());
 
@@ -1746,15 +1932,30 @@ static Local<Value> ExecuteString(Environment* env,
   try_catch.SetVerbose(false);
 
   ScriptOrigin origin(filename);
-  MaybeLocal<v8::Script> script =
-      v8::Script::Compile(env->context(), source, &origin);
+  const code_cache::Entry* cache =
+      cache_id != nullptr ? code_cache::Find(cache_id) : nullptr;
+  // Owned by |script_source|, but doesn't own the data.
+  ScriptCompiler::CachedData* cached_data = nullptr;
+  if (cache != nullptr) {
+    cached_data = new ScriptCompiler::CachedData(
+        cache->data, static_cast<int>(cache->length));
+  }
+  ScriptCompiler::Source script_source(source, origin, cached_data);
+  MaybeLocal<v8::Script> script = ScriptCompiler::Compile(
+      env->context(), &script_source,
+      cached_data != nullptr ? ScriptCompiler::kConsumeCodeCache :
+                               ScriptCompiler::kNoCompileOptions);
   if (script.IsEmpty()) {
+    if (env->is_stopping_worker())
+      return Local<Value>();
     ReportException(env, try_catch);
     exit(3);
   }
 
   Local<Value> result = script.ToLocalChecked()->Run();
   if (result.IsEmpty()) {
+    if (env->is_stopping_worker())
+      return Local<Value>();
     ReportException(env, try_catch);
     exit(4);
   }
@@ -2277,7 +2478,12 @@ static void WaitForInspectorDisconnect(Environment* env) {
 
 
 static void Exit(const FunctionCallbackInfo<Value>& args) {
-  WaitForInspectorDisconnect(Environment::GetCurrent(args));
+  Environment* env = Environment::GetCurrent(args);
+  // process.exit() in a Worker only ends its thread.
+  if (!env->is_main_thread())
+    return env->worker_context()->Exit(args[0]->Int32Value());
+  WaitForInspectorDisconnect(env);
+  env->stop_sub_worker_contexts();
   exit(args[0]->Int32Value());
 }
 
@@ -2293,31 +2499,171 @@ static void Uptime(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Samples the resident set size on a thread of its own, so that reading it
+// does not cost the event loop a system call (on Linux, uv_resident_set_memory
+// reads and parses /proc/self/stat). There is one for the whole process, like
+// the RSS itself.
+class RssSampler {
+ public:
+  // Starts sampling every |interval| milliseconds, or changes the interval of
+  // the sampling, or stops it if |interval| is 0.
+  void SetInterval(uint64_t interval) {
+    // Only one thread at a time starts or joins the sampling thread.
+    Mutex::ScopedLock control_lock(control_mutex_);
+    bool join = false;
+    {
+      Mutex::ScopedLock lock(mutex_);
+      interval_ = interval;
+      generation_++;
+      if (interval == 0) {
+        join = running_;
+        has_sample_ = false;
+      }
+      cond_.Signal(lock);
+    }
+    if (join) {
+      CHECK_EQ(0, uv_thread_join(&thread_));
+      running_ = false;
+    } else if (interval != 0 && !running_) {
+      running_ = true;
+      CHECK_EQ(0, uv_thread_create(&thread_, Run, this));
+    }
+  }
+
+  // Returns false if not sampling, or if the last sample failed.
+  bool Get(size_t* rss) {
+    Mutex::ScopedLock lock(mutex_);
+    *rss = rss_;
+    return has_sample_;
+  }
+
+ private:
+  static void Run(void* arg) {
+    RssSampler* sampler = static_cast<RssSampler*>(arg);
+    Mutex::ScopedLock lock(sampler->mutex_);
+    while (sampler->interval_ != 0) {
+      size_t rss;
+      int err;
+      {
+        Mutex::ScopedUnlock unlock(lock);
+        err = uv_resident_set_memory(&rss);
+      }
+      if (sampler->interval_ == 0)
+        break;
+      sampler->rss_ = rss;
+      sampler->has_sample_ = err == 0;
+
+      // Sleep until the next sample is due or the interval changes.
+      const uint64_t deadline = uv_hrtime() + sampler->interval_ * 1000000;
+      const uint64_t generation = sampler->generation_;
+      uint64_t now;
+      while (generation == sampler->generation_ &&
+             (now = uv_hrtime()) < deadline) {
+        sampler->cond_.TimedWait(lock, deadline - now);
+      }
+    }
+  }
+
+  Mutex control_mutex_;
+  bool running_ = false;
+  uv_thread_t thread_;
+
+  Mutex mutex_;
+  ConditionVariable cond_;
+  uint64_t interval_ = 0;
+  uint64_t generation_ = 0;
+  size_t rss_ = 0;
+  bool has_sample_ = false;
+};
+
+// Never destroyed, as the sampling thread may still be running at exit.
+static RssSampler* rss_sampler = new RssSampler();
+
+
+// Returns the sampled RSS if there is one, and reads it otherwise.
+static int ResidentSetMemory(size_t* rss) {
+  if (rss_sampler->Get(rss))
+    return 0;
+  return uv_resident_set_memory(rss);
+}
+
+
+static void FillHeapUsage(Isolate* isolate, double* fields) {
+  HeapStatistics v8_heap_stats;
+  isolate->GetHeapStatistics(&v8_heap_stats);
+  fields[0] = v8_heap_stats.total_heap_size();
+  fields[1] = v8_heap_stats.used_heap_size();
+  fields[2] = isolate->AdjustAmountOfExternalAllocatedMemory(0);
+}
+
+
+// Gets the double array pointer from a Float64Array argument.
+static double* GetFloat64Fields(Local<Value> value, size_t length) {
+  CHECK(value->IsFloat64Array());
+  Local<Float64Array> array = value.As<Float64Array>();
+  CHECK_EQ(array->Length(), length);
+  Local<ArrayBuffer> ab = array->Buffer();
+  return reinterpret_cast<double*>(
+      static_cast<char*>(ab->GetContents().Data()) + array->ByteOffset());
+}
+
+
 static void MemoryUsage(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
   size_t rss;
-  int err = uv_resident_set_memory(&rss);
+  int err = ResidentSetMemory(&rss);
   if (err) {
     return env->ThrowUVException(err, "uv_resident_set_memory");
   }
 
-  Isolate* isolate = env->isolate();
+  double* fields = GetFloat64Fields(args[0], 4);
+  fields[0] = rss;
   // V8 memory usage
-  HeapStatistics v8_heap_stats;
-  isolate->GetHeapStatistics(&v8_heap_stats);
+  FillHeapUsage(env->isolate(), fields + 1);
+}
 
-  // Get the double array pointer from the Float64Array argument.
-  CHECK(args[0]->IsFloat64Array());
-  Local<Float64Array> array = args[0].As<Float64Array>();
-  CHECK_EQ(array->Length(), 4);
-  Local<ArrayBuffer> ab = array->Buffer();
-  double* fields = static_cast<double*>(ab->GetContents().Data());
 
-  fields[0] = rss;
-  fields[1] = v8_heap_stats.total_heap_size();
-  fields[2] = v8_heap_stats.used_heap_size();
-  fields[3] = isolate->AdjustAmountOfExternalAllocatedMemory(0);
+// Like MemoryUsage, without the RSS, and so without a system call.
+static void HeapUsage(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  FillHeapUsage(env->isolate(), GetFloat64Fields(args[0], 3));
+}
+
+
+static void ResidentSetSize(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  size_t rss;
+  int err = ResidentSetMemory(&rss);
+  if (err) {
+    return env->ThrowUVException(err, "uv_resident_set_memory");
+  }
+
+  args.GetReturnValue().Set(Number::New(env->isolate(), rss));
+}
+
+
+// _sampleRss(interval)
+static void SampleRss(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsUint32());
+  rss_sampler->SetInterval(args[0]->Uint32Value());
+}
+
+
+// Starts measuring the event loop, if it isn't already, and returns the
+// Float64Array that LoopMetrics fills in and a histogram handle for the lag.
+static void StartLoopMetrics(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  LoopMetrics* metrics = env->loop_metrics();
+  const size_t count = LoopMetrics::kFieldsCount;
+  Local<ArrayBuffer> ab = ArrayBuffer::New(env->isolate(),
+                                           metrics->fields(),
+                                           sizeof(double) * count);
+  Local<Array> result = Array::New(env->isolate(), 2);
+  result->Set(0, Float64Array::New(ab, 0, count));
+  result->Set(1, HistogramWrap::New(env, metrics->lag()));
+  args.GetReturnValue().Set(result);
 }
 
 
@@ -2356,6 +2702,15 @@ static void Hrtime(const FunctionCallbackInfo<Value>& args) {
   fields[2] = t % NANOS_PER_SEC;
 }
 
+// Fills in the only entry of a Float64Array with the nanoseconds since the
+// process started. Counting from there keeps the value well below 2^53, which
+// a double holds exactly, for more than 100 days.
+static void HrtimeNanoseconds(const FunctionCallbackInfo<Value>& args) {
+  Local<ArrayBuffer> ab = args[0].As<Float64Array>()->Buffer();
+  double* fields = static_cast<double*>(ab->GetContents().Data());
+  fields[0] = static_cast<double>(uv_hrtime() - prog_start_hrtime);
+}
+
 // Microseconds in a second, as a float, used in CPUUsage() below
 #define MICROS_PER_SEC 1e6
 
@@ -2388,6 +2743,42 @@ static void CPUUsage(const FunctionCallbackInfo<Value>& args) {
   fields[1] = MICROS_PER_SEC * rusage.ru_stime.tv_sec + rusage.ru_stime.tv_usec;
 }
 
+// Like CPUUsage(), but fills in all of the fields of uv_rusage_t, in their
+// order, into a Float64Array of 16 elements.
+static void ResourceUsage(const FunctionCallbackInfo<Value>& args) {
+  uv_rusage_t rusage;
+
+  int err = uv_getrusage(&rusage);
+  if (err) {
+    Local<String> errmsg = OneByteString(args.GetIsolate(), uv_strerror(err));
+    args.GetReturnValue().Set(errmsg);
+    return;
+  }
+
+  CHECK(args[0]->IsFloat64Array());
+  Local<Float64Array> array = args[0].As<Float64Array>();
+  CHECK_EQ(array->Length(), 16);
+  Local<ArrayBuffer> ab = array->Buffer();
+  double* fields = static_cast<double*>(ab->GetContents().Data());
+
+  fields[0] = MICROS_PER_SEC * rusage.ru_utime.tv_sec + rusage.ru_utime.tv_usec;
+  fields[1] = MICROS_PER_SEC * rusage.ru_stime.tv_sec + rusage.ru_stime.tv_usec;
+  fields[2] = rusage.ru_maxrss;
+  fields[3] = rusage.ru_ixrss;
+  fields[4] = rusage.ru_idrss;
+  fields[5] = rusage.ru_isrss;
+  fields[6] = rusage.ru_minflt;
+  fields[7] = rusage.ru_majflt;
+  fields[8] = rusage.ru_nswap;
+  fields[9] = rusage.ru_inblock;
+  fields[10] = rusage.ru_oublock;
+  fields[11] = rusage.ru_msgsnd;
+  fields[12] = rusage.ru_msgrcv;
+  fields[13] = rusage.ru_nsignals;
+  fields[14] = rusage.ru_nvcsw;
+  fields[15] = rusage.ru_nivcsw;
+}
+
 extern "C" void node_module_register(void* m) {
   struct node_module* mp = reinterpret_cast<struct node_module*>(m);
 
@@ -2552,6 +2943,10 @@ void FatalException(Isolate* isolate,
   HandleScope scope(isolate);
 
   Environment* env = Environment::GetCurrent(isolate);
+  // A Worker that is stopping has no say in what happens, its JavaScript is
+  // being terminated.
+  if (env->is_stopping_worker())
+    return;
   Local<Object> process_object = env->process_object();
   Local<String> fatal_exception_string = env->fatal_exception_string();
   Local<Function> fatal_exception_function =
@@ -2588,9 +2983,13 @@ void FatalException(Isolate* isolate,
   }
 
   if (exit_code) {
+    // An uncaught exception in a Worker only ends its thread.
+    if (!env->is_main_thread())
+      return env->worker_context()->Exit(exit_code);
 #if HAVE_INSPECTOR
     env->inspector_agent()->FatalException(error, message);
 #endif
+    env->stop_sub_worker_contexts();
     exit(exit_code);
   }
 }
@@ -2613,20 +3012,22 @@ static void OnMessage(Local<Message> message, Local<Value> error) {
 
 void ClearFatalExceptionHandlers(Environment* env) {
   Local<Object> process = env->process_object();
-  Local<Value> events =
-      process->Get(env->context(), env->events_string()).ToLocalChecked();
+  Local<Value> events;
+  // Fails when the JavaScript of a Worker is being terminated.
+  if (!process->Get(env->context(), env->events_string()).ToLocal(&events))
+    return;
 
   if (events->IsObject()) {
     events.As<Object>()->Set(
         env->context(),
         OneByteString(env->isolate(), "uncaughtException"),
-        Undefined(env->isolate())).FromJust();
+        Undefined(env->isolate())).FromMaybe(false);
   }
 
   process->Set(
       env->context(),
       env->domain_string(),
-      Undefined(env->isolate())).FromJust();
+      Undefined(env->isolate())).FromMaybe(false);
 }
 
 // Call process.emitWarning(str), fmt is a snprintf() format string
@@ -2680,6 +3081,7 @@ static void Binding(const FunctionCallbackInfo<Value>& args) {
   uint32_t l = modules->Length();
   modules->Set(l, OneByteString(env->isolate(), buf));
 
+  StartupTraceScope trace_scope("binding", *module_v);
   node_module* mod = get_builtin_module(*module_v);
   if (mod != nullptr) {
     exports = Object::New(env->isolate());
@@ -3413,13 +3815,19 @@ void SetupProcessObject(Environment* env,
   env->SetMethod(process, "_debugEnd", DebugEnd);
 
   env->SetMethod(process, "hrtime", Hrtime);
+  env->SetMethod(process, "_hrtimeNanoseconds", HrtimeNanoseconds);
 
   env->SetMethod(process, "cpuUsage", CPUUsage);
+  env->SetMethod(process, "resourceUsage", ResourceUsage);
 
   env->SetMethod(process, "dlopen", DLOpen);
 
   env->SetMethod(process, "uptime", Uptime);
   env->SetMethod(process, "memoryUsage", MemoryUsage);
+  env->SetMethod(process, "_heapUsage", HeapUsage);
+  env->SetMethod(process, "_rss", ResidentSetSize);
+  env->SetMethod(process, "_sampleRss", SampleRss);
+  env->SetMethod(process, "_startLoopMetrics", StartLoopMetrics);
 
   env->SetMethod(process, "binding", Binding);
   env->SetMethod(process, "_linkedBinding", LinkedBinding);
@@ -3442,9 +3850,7 @@ void SetupProcessObject(Environment* env,
 
 void SignalExit(int signo) {
   uv_tty_reset_mode();
-  if (trace_enabled) {
-    v8_platform.StopTracingAgent();
-  }
+  v8_platform.StopTracingAgent();
 #ifdef __FreeBSD__
   // FreeBSD has a nasty bug, see RegisterSignalHandler for details
   struct sigaction sa;
@@ -3484,8 +3890,11 @@ void LoadEnvironment(Environment* env) {
   // 'internal_bootstrap_node_native' is the string containing that source code.
   Local<String> script_name = FIXED_ONE_BYTE_STRING(env->isolate(),
                                                     "bootstrap_node.js");
-  Local<Value> f_value = ExecuteString(env, MainSource(env), script_name);
+  Local<Value> f_value = ExecuteString(env, MainSource(env), script_name,
+                                      "internal/bootstrap_node");
   if (try_catch.HasCaught())  {
+    if (env->is_stopping_worker())
+      return;
     ReportException(env, try_catch);
     exit(10);
   }
@@ -3564,11 +3973,34 @@ static void PrintHelp() {
          "  --redirect-warnings=path\n"
          "                             write warnings to path instead of\n"
          "                             stderr\n"
+         "  --compile-cache=dir        cache the compiled code of modules\n"
+         "                             in dir\n"
+         "  --app-archive=file         load modules under the path of file\n"
+         "                             from the application archive file\n"
+         "  --resolution-cache=file    resolve modules with the resolutions\n"
+         "                             that file holds\n"
+         "  --build-resolution-cache=file\n"
+         "                             write the resolutions of modules to\n"
+         "                             file when the process exits\n"
+         "  --immediate-budget=num     run at most num setImmediate()\n"
+         "                             callbacks per event loop iteration\n"
+         "  --heapsnapshot-signal=signal\n"
+         "                             write a heap snapshot when the\n"
+         "                             process receives signal\n"
+         "  --stdio-buffer=policy      write stdout and stderr from a\n"
+         "                             thread, dropping, blocking or\n"
+         "                             growing when its buffer is full\n"
+         "  --counters-file=file       keep process.counters in file, where\n"
+         "                             other processes can read them\n"
          "  --trace-sync-io            show stack trace when use of sync IO\n"
          "                             is detected after the first tick\n"
          "  --trace-events-enabled     track trace events\n"
+         "  --startup-profile          trace the startup steps and the\n"
+         "                             bindings that they load\n"
          "  --trace-event-categories   comma separated list of trace event\n"
          "                             categories to record\n"
+         "  --trace-event-format       format of trace event log files,\n"
+         "                             json (default) or binary\n"
          "  --track-heap-objects       track heap object allocations for heap "
          "snapshots\n"
          "  --prof-process             process v8 profiler output generated\n"
@@ -3576,8 +4008,11 @@ static void PrintHelp() {
          "  --zero-fill-buffers        automatically zero-fill all newly "
          "allocated\n"
          "                             Buffer and SlowBuffer instances\n"
+         "  --module-resolution-cache  cache the file system lookups done\n"
+         "                             while resolving modules\n"
          "  --v8-options               print v8 command line options\n"
-         "  --v8-pool-size=num         set v8's thread pool size\n"
+         "  --v8-pool-size=num         set the size of the thread pool\n"
+         "                             that v8 shares with crypto and zlib\n"
 #if HAVE_OPENSSL
          "  --tls-cipher-list=val      use an alternative default TLS cipher "
          "list\n"
@@ -3613,6 +4048,10 @@ static void PrintHelp() {
          "NODE_DEBUG                   ','-separated list of core modules\n"
          "                             that should print debug information\n"
          "NODE_DISABLE_COLORS          set to 1 to disable colors in the REPL\n"
+         "NODE_MODULE_RESOLUTION_CACHE set to 1 to cache the file system\n"
+         "                             lookups done while resolving modules\n"
+         "NODE_COMPILE_CACHE           directory to cache the compiled code\n"
+         "                             of modules in\n"
          "NODE_EXTRA_CA_CERTS          path to additional CA certificates\n"
          "                             file\n"
 #if defined(NODE_HAVE_I18N_SUPPORT)
@@ -3740,12 +4179,39 @@ static void ParseArgs(int* argc,
       trace_warnings = true;
     } else if (strncmp(arg, "--redirect-warnings=", 20) == 0) {
       config_warning_file = arg + 20;
+    } else if (strncmp(arg, "--compile-cache=", 16) == 0) {
+      config_compile_cache_dir = arg + 16;
+    } else if (strncmp(arg, "--app-archive=", 14) == 0) {
+      config_app_archive = arg + 14;
+    } else if (strncmp(arg, "--resolution-cache=", 19) == 0) {
+      config_resolution_cache = arg + 19;
+    } else if (strncmp(arg, "--build-resolution-cache=", 25) == 0) {
+      config_build_resolution_cache = arg + 25;
+    } else if (strncmp(arg, "--immediate-budget=", 19) == 0) {
+      const int budget = atoi(arg + 19);
+      config_immediate_budget = budget > 0 ? budget : 0;
+    } else if (strncmp(arg, "--heapsnapshot-signal=", 22) == 0) {
+      config_heap_snapshot_signal = arg + 22;
+    } else if (strncmp(arg, "--stdio-buffer=", 15) == 0) {
+      const char* policy = arg + 15;
+      if (strcmp(policy, "drop") != 0 &&
+          strcmp(policy, "block") != 0 &&
+          strcmp(policy, "grow") != 0) {
+        fprintf(stderr, "%s: --stdio-buffer must be drop, block or grow\n",
+                argv[0]);
+        exit(9);
+      }
+      config_stdio_buffer = policy;
+    } else if (strncmp(arg, "--counters-file=", 16) == 0) {
+      counters::file_path = arg + 16;
     } else if (strcmp(arg, "--trace-deprecation") == 0) {
       trace_deprecation = true;
     } else if (strcmp(arg, "--trace-sync-io") == 0) {
       trace_sync_io = true;
     } else if (strcmp(arg, "--trace-events-enabled") == 0) {
       trace_enabled = true;
+    } else if (strcmp(arg, "--startup-profile") == 0) {
+      startup_profile = true;
     } else if (strcmp(arg, "--trace-event-categories") == 0) {
       const char* categories = argv[index + 1];
       if (categories == nullptr) {
@@ -3754,6 +4220,21 @@ static void ParseArgs(int* argc,
       }
       args_consumed += 1;
       trace_enabled_categories = categories;
+    } else if (strcmp(arg, "--trace-event-format") == 0) {
+      const char* format = argv[index + 1];
+      if (format == nullptr) {
+        fprintf(stderr, "%s: %s requires an argument\n", argv[0], arg);
+        exit(9);
+      }
+      if (strcmp(format, "binary") == 0) {
+        trace_binary_format = true;
+      } else if (strcmp(format, "json") == 0) {
+        trace_binary_format = false;
+      } else {
+        fprintf(stderr, "%s: %s must be json or binary\n", argv[0], arg);
+        exit(9);
+      }
+      args_consumed += 1;
     } else if (strcmp(arg, "--track-heap-objects") == 0) {
       track_heap_objects = true;
     } else if (strcmp(arg, "--throw-deprecation") == 0) {
@@ -3763,6 +4244,8 @@ static void ParseArgs(int* argc,
       Revert(cve);
     } else if (strcmp(arg, "--preserve-symlinks") == 0) {
       config_preserve_symlinks = true;
+    } else if (strcmp(arg, "--module-resolution-cache") == 0) {
+      config_module_resolution_cache = true;
     } else if (strcmp(arg, "--prof-process") == 0) {
       prof_process = true;
       short_circuit = true;
@@ -4161,6 +4644,7 @@ void Init(int* argc,
           const char*** exec_argv) {
   // Initialize prog_start_time to get relative uptime.
   prog_start_time = static_cast<double>(uv_now(uv_default_loop()));
+  prog_start_hrtime = uv_hrtime();
 
   // Make inherited handles noninheritable.
   uv_disable_stdio_inheritance();
@@ -4194,9 +4678,30 @@ void Init(int* argc,
         SafeGetenv("NODE_PRESERVE_SYMLINKS", &text) && text[0] == '1';
   }
 
+  if (!config_module_resolution_cache) {
+    std::string text;
+    config_module_resolution_cache =
+        SafeGetenv("NODE_MODULE_RESOLUTION_CACHE", &text) && text[0] == '1';
+  }
+
   if (config_warning_file.empty())
     SafeGetenv("NODE_REDIRECT_WARNINGS", &config_warning_file);
 
+  if (config_compile_cache_dir.empty())
+    SafeGetenv("NODE_COMPILE_CACHE", &config_compile_cache_dir);
+
+  if (config_resolution_cache.empty())
+    SafeGetenv("NODE_RESOLUTION_CACHE", &config_resolution_cache);
+
+  // --startup-profile adds node.startup to the categories that are recorded.
+  if (startup_profile) {
+    trace_enabled = true;
+    if (trace_enabled_categories.empty())
+      trace_enabled_categories = "node.startup";
+    else
+      trace_enabled_categories += ",node.startup";
+  }
+
 #if HAVE_OPENSSL
   if (openssl_config.empty())
     SafeGetenv("OPENSSL_CONF", &openssl_config);
@@ -4281,6 +4786,11 @@ void AtExit(void (*cb)(void* arg), void* arg) {
 }
 
 
+void SetThreadLocalEnvironment(Environment* env) {
+  uv_key_set(&thread_local_env, env);
+}
+
+
 void AtExit(Environment* env, void (*cb)(void* arg), void* arg) {
   CHECK_NE(env, nullptr);
   env->AtExit(cb, arg);
@@ -4300,6 +4810,30 @@ void EmitBeforeExit(Environment* env) {
 }
 
 
+void SpinEventLoop(Environment* env) {
+  Isolate* isolate = env->isolate();
+  SealHandleScope seal(isolate);
+  bool more;
+  do {
+    v8_platform.PumpMessageLoop(isolate);
+    more = uv_run(env->event_loop(), UV_RUN_ONCE);
+    if (env->is_stopping_worker())
+      break;
+
+    if (more == false) {
+      v8_platform.PumpMessageLoop(isolate);
+      EmitBeforeExit(env);
+
+      // Emit `beforeExit` if the loop became alive either after emitting
+      // event, or after running some callbacks.
+      more = uv_loop_alive(env->event_loop());
+      if (uv_run(env->event_loop(), UV_RUN_NOWAIT) != 0)
+        more = true;
+    }
+  } while (more == true && !env->is_stopping_worker());
+}
+
+
 int EmitExit(Environment* env) {
   // process.emit('exit')
   HandleScope handle_scope(env->isolate());
@@ -4359,9 +4893,11 @@ inline int Start(Isolate* isolate, IsolateData* isolate_data,
   Local<Context> context = Context::New(isolate);
   Context::Scope context_scope(context);
   Environment env(isolate_data, context);
-  CHECK_EQ(0, uv_key_create(&thread_local_env));
-  uv_key_set(&thread_local_env, &env);
-  env.Start(argc, argv, exec_argc, exec_argv, v8_is_profiling);
+  SetThreadLocalEnvironment(&env);
+  {
+    StartupTraceScope trace_scope("Environment::Start");
+    env.Start(argc, argv, exec_argc, exec_argv, v8_is_profiling);
+  }
 
   const char* path = argc > 1 ? argv[1] : nullptr;
   StartDebug(&env, path, debug_options);
@@ -4373,6 +4909,7 @@ inline int Start(Isolate* isolate, IsolateData* isolate_data,
 
   {
     Environment::AsyncCallbackScope callback_scope(&env);
+    StartupTraceScope trace_scope("LoadEnvironment");
     LoadEnvironment(&env);
   }
 
@@ -4387,31 +4924,14 @@ inline int Start(Isolate* isolate, IsolateData* isolate_data,
         "and could change at any time.");
   }
 
-  {
-    SealHandleScope seal(isolate);
-    bool more;
-    do {
-      v8_platform.PumpMessageLoop(isolate);
-      more = uv_run(env.event_loop(), UV_RUN_ONCE);
-
-      if (more == false) {
-        v8_platform.PumpMessageLoop(isolate);
-        EmitBeforeExit(&env);
-
-        // Emit `beforeExit` if the loop became alive either after emitting
-        // event, or after running some callbacks.
-        more = uv_loop_alive(env.event_loop());
-        if (uv_run(env.event_loop(), UV_RUN_NOWAIT) != 0)
-          more = true;
-      }
-    } while (more == true);
-  }
+  SpinEventLoop(&env);
 
   env.set_trace_sync_io(false);
 
   const int exit_code = EmitExit(&env);
   RunAtExit(&env);
-  uv_key_delete(&thread_local_env);
+  env.stop_sub_worker_contexts();
+  SetThreadLocalEnvironment(nullptr);
 
   WaitForInspectorDisconnect(&env);
 #if defined(LEAK_SANITIZER)
@@ -4421,24 +4941,35 @@ inline int Start(Isolate* isolate, IsolateData* isolate_data,
   return exit_code;
 }
 
-inline int Start(uv_loop_t* event_loop,
-                 int argc, const char* const* argv,
-                 int exec_argc, const char* const* exec_argv) {
+Isolate* NewIsolate(ArrayBufferAllocator* allocator) {
   Isolate::CreateParams params;
-  ArrayBufferAllocator allocator;
-  params.array_buffer_allocator = &allocator;
+  params.array_buffer_allocator = allocator;
 #ifdef NODE_ENABLE_VTUNE_PROFILING
   params.code_event_handler = vTune::GetVtuneCodeEventHandler();
 #endif
 
   Isolate* const isolate = Isolate::New(params);
   if (isolate == nullptr)
-    return 12;  // Signal internal error.
+    return nullptr;
 
+#if NODE_USE_V8_PLATFORM
+  NodePlatform::RegisterIsolate(isolate);
+#endif
   isolate->AddMessageListener(OnMessage);
   isolate->SetAbortOnUncaughtExceptionCallback(ShouldAbortOnUncaughtException);
   isolate->SetAutorunMicrotasks(false);
   isolate->SetFatalErrorHandler(OnFatalError);
+  return isolate;
+}
+
+
+inline int Start(uv_loop_t* event_loop,
+                 int argc, const char* const* argv,
+                 int exec_argc, const char* const* exec_argv) {
+  ArrayBufferAllocator allocator;
+  Isolate* const isolate = NewIsolate(&allocator);
+  if (isolate == nullptr)
+    return 12;  // Signal internal error.
 
   if (track_heap_objects) {
     isolate->GetHeapProfiler()->StartTrackingHeapObjects(true);
@@ -4455,7 +4986,9 @@ inline int Start(uv_loop_t* event_loop,
     Locker locker(isolate);
     Isolate::Scope isolate_scope(isolate);
     HandleScope handle_scope(isolate);
-    IsolateData isolate_data(isolate, event_loop, allocator.zero_fill_field());
+    std::unique_ptr<v8::TracingCpuProfiler> cpu_profiler(
+        v8_platform.CreateTracingCpuProfiler(isolate));
+    IsolateData isolate_data(isolate, event_loop, &allocator);
     exit_code = Start(isolate, &isolate_data, argc, argv, exec_argc, exec_argv);
   }
 
@@ -4510,11 +5043,11 @@ int Start(int argc, char** argv) {
   }
   V8::Initialize();
   v8_initialized = true;
+  CHECK_EQ(0, uv_key_create(&thread_local_env));
   const int exit_code =
       Start(uv_default_loop(), argc, argv, exec_argc, exec_argv);
-  if (trace_enabled) {
-    v8_platform.StopTracingAgent();
-  }
+  uv_key_delete(&thread_local_env);
+  v8_platform.StopTracingAgent();
   v8_initialized = false;
   V8::Dispose();
 
@@ -13,8 +13,19 @@
 #include <string.h>
 #include <algorithm>
 #include <cmath>
+#include <deque>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
+#include "async-wrap.h"
+#include "async-wrap-inl.h"
 #include "node_api.h"
+#include "node_internals.h"
+#include "node_mutex.h"
+#include "node_threadpool.h"
+#include "tracing/trace_event.h"
 #include "env-inl.h"
 
 static
@@ -24,18 +35,98 @@ napi_status napi_set_last_error(napi_env env, napi_status error_code,
 static
 void napi_clear_last_error(napi_env env);
 
+// An internalized property key that lives as long as the napi_env.
+struct napi_atom__ {
+  napi_atom__(v8::Isolate* isolate, v8::Local<v8::String> name)
+      : value(isolate, name) {}
+  ~napi_atom__() {
+    value.Reset();
+  }
+  v8::Persistent<v8::String> value;
+};
+
+namespace {
+namespace v8impl {
+class HandleScopeWrapper;
+class EscapableHandleScopeWrapper;
+}  // end of namespace v8impl
+}  // end of anonymous namespace
+
+// Keeps the storage of the handle scope wrappers that were closed, so that
+// opening a scope does not allocate once scopes as deeply nested have been
+// opened before.
+template <typename T>
+class ScopePool {
+ public:
+  ScopePool() {}
+  ~ScopePool() {
+    for (void* storage : free_) {
+      ::operator delete(storage);
+    }
+  }
+
+  T* New(v8::Isolate* isolate) {
+    void* storage;
+    if (free_.empty()) {
+      storage = ::operator new(sizeof(T));
+    } else {
+      storage = free_.back();
+      free_.pop_back();
+    }
+    return new(storage) T(isolate);
+  }
+
+  void Delete(T* scope) {
+    scope->~T();
+    free_.push_back(scope);
+  }
+
+ private:
+  std::vector<void*> free_;
+
+  ScopePool(const ScopePool&) = delete;
+  ScopePool& operator=(const ScopePool&) = delete;
+};
+
 struct napi_env__ {
+  // A finalizer call that has been deferred out of GC until the loop is idle.
+  struct PendingFinalizer {
+    napi_finalize callback;
+    void* data;
+    void* hint;
+  };
+
   explicit napi_env__(v8::Isolate* _isolate): isolate(_isolate),
-      has_instance_available(true), last_error() {}
+      has_instance_available(true), last_error(),
+      finalize_mode(napi_finalize_sync), finalize_idle(nullptr),
+      report_external_memory(false) {}
   ~napi_env__() {
     last_exception.Reset();
     has_instance.Reset();
+    async_context_template.Reset();
+    for (auto& entry : atoms) {
+      delete entry.second;
+    }
+    if (finalize_idle != nullptr) {
+      uv_close(reinterpret_cast<uv_handle_t*>(finalize_idle),
+               [](uv_handle_t* handle) {
+        delete reinterpret_cast<uv_idle_t*>(handle);
+      });
+    }
   }
   v8::Isolate* isolate;
   v8::Persistent<v8::Value> last_exception;
   v8::Persistent<v8::Value> has_instance;
   bool has_instance_available;
+  v8::Persistent<v8::ObjectTemplate> async_context_template;
   napi_extended_error_info last_error;
+  std::unordered_map<std::string, napi_atom> atoms;
+  napi_finalize_mode finalize_mode;
+  std::vector<PendingFinalizer> pending_finalizers;
+  uv_idle_t* finalize_idle;
+  bool report_external_memory;
+  ScopePool<v8impl::HandleScopeWrapper> handle_scopes;
+  ScopePool<v8impl::EscapableHandleScopeWrapper> escapable_handle_scopes;
 };
 
 #define RETURN_STATUS_IF_FALSE(env, condition, status)                  \
@@ -190,6 +281,41 @@ v8::Local<v8::Value> V8LocalValueFromJsValue(napi_value v) {
   return local;
 }
 
+// A napi_deferred is the persistent handle of a v8::Promise::Resolver.
+napi_deferred JsDeferredFromV8Persistent(v8::Persistent<v8::Value>* local) {
+  return reinterpret_cast<napi_deferred>(local);
+}
+
+v8::Persistent<v8::Value>* V8PersistentFromJsDeferred(napi_deferred local) {
+  return reinterpret_cast<v8::Persistent<v8::Value>*>(local);
+}
+
+// A napi_async_context is an AsyncWrap of its own, which is kept alive until
+// napi_async_destroy().
+class AsyncContext : public node::AsyncWrap {
+ public:
+  AsyncContext(node::Environment* env, v8::Local<v8::Object> object)
+      : node::AsyncWrap(env, object, PROVIDER_NAPIASYNCCONTEXT) {
+    node::Wrap(object, this);
+  }
+
+  ~AsyncContext() override {
+    v8::HandleScope scope(env()->isolate());
+    node::ClearWrap(object());
+    persistent().Reset();
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+};
+
+napi_async_context JsAsyncContextFromAsyncContext(AsyncContext* context) {
+  return reinterpret_cast<napi_async_context>(context);
+}
+
+AsyncContext* AsyncContextFromJsAsyncContext(napi_async_context context) {
+  return reinterpret_cast<AsyncContext*>(context);
+}
+
 static inline napi_status V8NameFromPropertyDescriptor(napi_env env,
                                          const napi_property_descriptor* p,
                                          v8::Local<v8::Name>* result) {
@@ -206,6 +332,42 @@ static inline napi_status V8NameFromPropertyDescriptor(napi_env env,
   return napi_ok;
 }
 
+// Runs the finalizers that were deferred out of GC, in one batch.
+static void RunPendingFinalizers(uv_idle_t* handle) {
+  napi_env env = static_cast<napi_env>(handle->data);
+  uv_idle_stop(handle);
+
+  std::vector<napi_env__::PendingFinalizer> batch;
+  batch.swap(env->pending_finalizers);
+
+  v8::HandleScope scope(env->isolate);
+  for (const napi_env__::PendingFinalizer& pending : batch) {
+    pending.callback(env, pending.data, pending.hint);
+  }
+}
+
+// Invokes a napi_finalize callback, or queues it to run on the loop thread
+// once the loop is idle if the env defers finalizers.
+static void CallFinalizer(napi_env env,
+                          napi_finalize finalize_callback,
+                          void* finalize_data,
+                          void* finalize_hint) {
+  if (finalize_callback == nullptr) {
+    return;
+  }
+
+  if (env->finalize_mode == napi_finalize_sync) {
+    finalize_callback(env, finalize_data, finalize_hint);
+    return;
+  }
+
+  if (env->pending_finalizers.empty()) {
+    uv_idle_start(env->finalize_idle, RunPendingFinalizers);
+  }
+  env->pending_finalizers.push_back(
+      { finalize_callback, finalize_data, finalize_hint });
+}
+
 // Adapter for napi_finalize callbacks.
 class Finalizer {
  protected:
@@ -235,26 +397,92 @@ class Finalizer {
     delete finalizer;
   }
 
+  // Reports |size| bytes of external memory to V8 until the finalizer runs,
+  // if the env reports the memory of external buffers.
+  void ReportExternalMemory(size_t size) {
+    if (!_env->report_external_memory || size == 0) {
+      return;
+    }
+    _external_memory = static_cast<int64_t>(size);
+    _env->isolate->AdjustAmountOfExternalAllocatedMemory(_external_memory);
+  }
+
   // node::Buffer::FreeCallback
   static void FinalizeBufferCallback(char* data, void* hint) {
     Finalizer* finalizer = static_cast<Finalizer*>(hint);
-    if (finalizer->_finalize_callback != nullptr) {
-      finalizer->_finalize_callback(
-        finalizer->_env,
-        data,
-        finalizer->_finalize_hint);
-    }
+    finalizer->ReleaseExternalMemory();
+    CallFinalizer(finalizer->_env,
+                  finalizer->_finalize_callback,
+                  data,
+                  finalizer->_finalize_hint);
 
     Delete(finalizer);
   }
 
  protected:
+  void ReleaseExternalMemory() {
+    if (_external_memory != 0) {
+      _env->isolate->AdjustAmountOfExternalAllocatedMemory(-_external_memory);
+      _external_memory = 0;
+    }
+  }
+
   napi_env _env;
   napi_finalize _finalize_callback;
   void* _finalize_data;
   void* _finalize_hint;
+  int64_t _external_memory = 0;
+};
+
+// External string resource whose data is owned by the addon. The finalize
+// callback is invoked when V8 no longer needs the data.
+template <typename ResourceType, typename CharType>
+class ExternalString : public ResourceType, private Finalizer {
+ public:
+  ExternalString(napi_env env,
+                 CharType* data,
+                 size_t length,
+                 napi_finalize finalize_callback,
+                 void* finalize_hint)
+    : Finalizer(env, finalize_callback, data, finalize_hint),
+      _data(data),
+      _length(length) {
+    _env->isolate->AdjustAmountOfExternalAllocatedMemory(ByteLength());
+  }
+
+  ~ExternalString() override {
+    _env->isolate->AdjustAmountOfExternalAllocatedMemory(-ByteLength());
+    CallFinalizer(_env, _finalize_callback, _finalize_data, _finalize_hint);
+  }
+
+  const CharType* data() const override {
+    return _data;
+  }
+
+  size_t length() const override {
+    return _length;
+  }
+
+  // Used when V8 refuses the resource, in which case the addon keeps
+  // ownership of the data.
+  void Disown() {
+    _finalize_callback = nullptr;
+  }
+
+ private:
+  int64_t ByteLength() const {
+    return _length * sizeof(CharType);
+  }
+
+  const CharType* _data;
+  const size_t _length;
 };
 
+typedef ExternalString<v8::String::ExternalOneByteStringResource, char>
+    ExternalOneByteString;
+typedef ExternalString<v8::String::ExternalStringResource, uint16_t>
+    ExternalTwoByteString;
+
 // Wrapper around v8::Persistent that implements reference counting.
 class Reference : private Finalizer {
  private:
@@ -307,6 +535,8 @@ class Reference : private Finalizer {
     delete reference;
   }
 
+  using Finalizer::ReportExternalMemory;
+
   uint32_t Ref() {
     if (++_refcount == 1) {
       _persistent.ClearWeak();
@@ -349,12 +579,12 @@ class Reference : private Finalizer {
     // delete it.
     bool delete_self = reference->_delete_self;
 
-    if (reference->_finalize_callback != nullptr) {
-      reference->_finalize_callback(
-          reference->_env,
-          reference->_finalize_data,
-          reference->_finalize_hint);
-    }
+    reference->ReleaseExternalMemory();
+
+    CallFinalizer(reference->_env,
+                  reference->_finalize_callback,
+                  reference->_finalize_data,
+                  reference->_finalize_hint);
 
     if (delete_self) {
       Delete(reference);
@@ -366,6 +596,69 @@ class Reference : private Finalizer {
   bool _delete_self;
 };
 
+// The external ArrayBuffer of a napi_buffer_region, and the count of its
+// views that are pinned. The reference to the ArrayBuffer is strong until the
+// region is deleted, and then calls the finalizer once the ArrayBuffer is
+// collected.
+class BufferRegion {
+ public:
+  BufferRegion(napi_env env,
+               v8::Local<v8::ArrayBuffer> buffer,
+               void* data,
+               size_t byte_length,
+               napi_buffer_view_release release_cb,
+               napi_finalize finalize_cb,
+               void* hint)
+      : _env(env),
+        _data(data),
+        _byte_length(byte_length),
+        _release_cb(release_cb),
+        _hint(hint),
+        _pinned(0),
+        _reference(Reference::New(
+            env, buffer, 1, true, finalize_cb, data, hint)) {}
+
+  ~BufferRegion() {
+    // Weak from now on, and deleted with the ArrayBuffer.
+    _reference->Unref();
+  }
+
+  v8::Local<v8::ArrayBuffer> Buffer() {
+    return _reference->Get().As<v8::ArrayBuffer>();
+  }
+
+  size_t ByteLength() const { return _byte_length; }
+  size_t Pinned() const { return _pinned; }
+
+  void Pin() {
+    _pinned++;
+  }
+
+  void Release(size_t byte_offset, size_t length) {
+    _pinned--;
+    if (_release_cb != nullptr) {
+      _release_cb(_env, _data, byte_offset, length, _hint);
+    }
+  }
+
+ private:
+  napi_env _env;
+  void* _data;
+  size_t _byte_length;
+  napi_buffer_view_release _release_cb;
+  void* _hint;
+  size_t _pinned;
+  Reference* _reference;
+};
+
+napi_buffer_region JsBufferRegionFromBufferRegion(BufferRegion* region) {
+  return reinterpret_cast<napi_buffer_region>(region);
+}
+
+BufferRegion* BufferRegionFromJsBufferRegion(napi_buffer_region region) {
+  return reinterpret_cast<BufferRegion*>(region);
+}
+
 class TryCatch : public v8::TryCatch {
  public:
   explicit TryCatch(napi_env env)
@@ -402,6 +695,7 @@ class CallbackWrapper {
 
   virtual bool IsConstructCall() = 0;
   virtual void Args(napi_value* buffer, size_t bufferlength) = 0;
+  virtual napi_value Arg(size_t index) = 0;
   virtual void SetReturnValue(napi_value value) = 0;
 
   napi_value This() { return _this; }
@@ -499,6 +793,15 @@ class FunctionCallbackWrapper
     }
   }
 
+  /*virtual*/
+  napi_value Arg(size_t index) override {
+    if (index < _args_length) {
+      return v8impl::JsValueFromV8LocalValue(_cbinfo[index]);
+    }
+    return v8impl::JsValueFromV8LocalValue(
+        v8::Undefined(_cbinfo.GetIsolate()));
+  }
+
   /*virtual*/
   void SetReturnValue(napi_value value) override {
     v8::Local<v8::Value> val = v8impl::V8LocalValueFromJsValue(value);
@@ -531,6 +834,12 @@ class GetterCallbackWrapper
     }
   }
 
+  /*virtual*/
+  napi_value Arg(size_t index) override {
+    return v8impl::JsValueFromV8LocalValue(
+        v8::Undefined(_cbinfo.GetIsolate()));
+  }
+
   /*virtual*/
   void SetReturnValue(napi_value value) override {
     v8::Local<v8::Value> val = v8impl::V8LocalValueFromJsValue(value);
@@ -567,6 +876,15 @@ class SetterCallbackWrapper
     }
   }
 
+  /*virtual*/
+  napi_value Arg(size_t index) override {
+    if (index == 0) {
+      return v8impl::JsValueFromV8LocalValue(_value);
+    }
+    return v8impl::JsValueFromV8LocalValue(
+        v8::Undefined(_cbinfo.GetIsolate()));
+  }
+
   /*virtual*/
   void SetReturnValue(napi_value value) override {
     node::FatalError("napi_set_return_value",
@@ -637,6 +955,89 @@ v8::Local<v8::Object> CreateAccessorCallbackData(napi_env env,
   return cbdata;
 }
 
+inline void NumberToNative(v8::Local<v8::Context> context,
+                           v8::Local<v8::Number> number,
+                           double* result) {
+  *result = number->Value();
+}
+
+inline void NumberToNative(v8::Local<v8::Context> context,
+                           v8::Local<v8::Number> number,
+                           int32_t* result) {
+  *result = number->Int32Value(context).FromJust();
+}
+
+// Copies the leading numeric elements of a JS array into a native buffer.
+template <typename T>
+napi_status CopyArrayToNative(napi_env env,
+                              napi_value array,
+                              T* buf,
+                              size_t bufsize,
+                              size_t* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, array);
+  if (bufsize > 0) {
+    CHECK_ARG(env, buf);
+  }
+
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+  v8::Local<v8::Value> val = V8LocalValueFromJsValue(array);
+  RETURN_STATUS_IF_FALSE(env, val->IsArray(), napi_array_expected);
+
+  v8::Local<v8::Array> arr = val.As<v8::Array>();
+  size_t count = std::min(bufsize, static_cast<size_t>(arr->Length()));
+
+  for (size_t i = 0; i < count; i++) {
+    v8::HandleScope scope(isolate);
+
+    auto get_maybe = arr->Get(context, static_cast<uint32_t>(i));
+    CHECK_MAYBE_EMPTY(env, get_maybe, napi_generic_failure);
+
+    v8::Local<v8::Value> element = get_maybe.ToLocalChecked();
+    RETURN_STATUS_IF_FALSE(env, element->IsNumber(), napi_number_expected);
+
+    NumberToNative(context, element.As<v8::Number>(), &buf[i]);
+  }
+
+  if (result != nullptr) {
+    *result = count;
+  }
+
+  return GET_RETURN_STATUS(env);
+}
+
+// Creates a JS array holding the given native numbers.
+template <typename T>
+napi_status CopyNativeToArray(napi_env env,
+                              const T* values,
+                              size_t length,
+                              napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, result);
+  if (length > 0) {
+    CHECK_ARG(env, values);
+  }
+
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Array> arr = v8::Array::New(isolate, length);
+
+  for (size_t i = 0; i < length; i++) {
+    v8::HandleScope scope(isolate);
+
+    auto set_maybe = arr->Set(context,
+                              static_cast<uint32_t>(i),
+                              v8::Number::New(isolate, values[i]));
+    RETURN_STATUS_IF_FALSE(env, set_maybe.FromMaybe(false),
+                           napi_generic_failure);
+  }
+
+  *result = JsValueFromV8LocalValue(arr);
+  return GET_RETURN_STATUS(env);
+}
+
 }  // end of namespace v8impl
 
 // Intercepts the Node-V8 module registration callback. Converts parameters
@@ -707,7 +1108,9 @@ const char* error_messages[] = {nullptr,
                                 "An array was expected",
                                 "Unknown failure",
                                 "An exception is pending",
-                                "The async work item was cancelled"};
+                                "The async work item was cancelled",
+                                "Thread-safe function queue is full",
+                                "Thread-safe function handle is closing"};
 
 void napi_clear_last_error(napi_env env) {
   env->last_error.error_code = napi_ok;
@@ -1044,32 +1447,51 @@ napi_status napi_get_named_property(napi_env env,
   return GET_RETURN_STATUS(env);
 }
 
-napi_status napi_set_element(napi_env env,
-                             napi_value object,
-                             uint32_t index,
-                             napi_value value) {
+napi_status napi_create_object_with_named_properties(
+    napi_env env,
+    size_t property_count,
+    const char* const* utf8names,
+    const napi_value* values,
+    napi_value* result) {
   NAPI_PREAMBLE(env);
+  CHECK_ARG(env, result);
+  if (property_count > 0) {
+    CHECK_ARG(env, utf8names);
+    CHECK_ARG(env, values);
+  }
 
   v8::Isolate* isolate = env->isolate;
   v8::Local<v8::Context> context = isolate->GetCurrentContext();
-  v8::Local<v8::Object> obj;
+  v8::Local<v8::Object> obj = v8::Object::New(isolate);
 
-  CHECK_TO_OBJECT(env, context, obj, object);
+  for (size_t i = 0; i < property_count; i++) {
+    v8::Local<v8::Name> key;
+    CHECK_NEW_FROM_UTF8(env, key, utf8names[i]);
 
-  v8::Local<v8::Value> val = v8impl::V8LocalValueFromJsValue(value);
-  auto set_maybe = obj->Set(context, index, val);
+    v8::Local<v8::Value> val = v8impl::V8LocalValueFromJsValue(values[i]);
 
-  RETURN_STATUS_IF_FALSE(env, set_maybe.FromMaybe(false), napi_generic_failure);
+    // The object is fresh, so defining the properties directly is safe and
+    // avoids the setter lookups done by v8::Object::Set().
+    v8::Maybe<bool> define_maybe = obj->CreateDataProperty(context, key, val);
 
+    RETURN_STATUS_IF_FALSE(env, define_maybe.FromMaybe(false),
+                           napi_generic_failure);
+  }
+
+  *result = v8impl::JsValueFromV8LocalValue(obj);
   return GET_RETURN_STATUS(env);
 }
 
-napi_status napi_has_element(napi_env env,
-                             napi_value object,
-                             uint32_t index,
-                             bool* result) {
+napi_status napi_get_properties(napi_env env,
+                                napi_value object,
+                                size_t property_count,
+                                const napi_value* keys,
+                                napi_value* results) {
   NAPI_PREAMBLE(env);
-  CHECK_ARG(env, result);
+  if (property_count > 0) {
+    CHECK_ARG(env, keys);
+    CHECK_ARG(env, results);
+  }
 
   v8::Isolate* isolate = env->isolate;
   v8::Local<v8::Context> context = isolate->GetCurrentContext();
@@ -1077,20 +1499,28 @@ napi_status napi_has_element(napi_env env,
 
   CHECK_TO_OBJECT(env, context, obj, object);
 
-  v8::Maybe<bool> has_maybe = obj->Has(context, index);
+  for (size_t i = 0; i < property_count; i++) {
+    v8::Local<v8::Value> k = v8impl::V8LocalValueFromJsValue(keys[i]);
+    auto get_maybe = obj->Get(context, k);
 
-  CHECK_MAYBE_NOTHING(env, has_maybe, napi_generic_failure);
+    CHECK_MAYBE_EMPTY(env, get_maybe, napi_generic_failure);
+
+    results[i] = v8impl::JsValueFromV8LocalValue(get_maybe.ToLocalChecked());
+  }
 
-  *result = has_maybe.FromMaybe(false);
   return GET_RETURN_STATUS(env);
 }
 
-napi_status napi_get_element(napi_env env,
-                             napi_value object,
-                             uint32_t index,
-                             napi_value* result) {
+napi_status napi_get_named_properties(napi_env env,
+                                      napi_value object,
+                                      size_t property_count,
+                                      const char* const* utf8names,
+                                      napi_value* results) {
   NAPI_PREAMBLE(env);
-  CHECK_ARG(env, result);
+  if (property_count > 0) {
+    CHECK_ARG(env, utf8names);
+    CHECK_ARG(env, results);
+  }
 
   v8::Isolate* isolate = env->isolate;
   v8::Local<v8::Context> context = isolate->GetCurrentContext();
@@ -1098,72 +1528,251 @@ napi_status napi_get_element(napi_env env,
 
   CHECK_TO_OBJECT(env, context, obj, object);
 
-  auto get_maybe = obj->Get(context, index);
+  for (size_t i = 0; i < property_count; i++) {
+    v8::Local<v8::Name> key;
+    CHECK_NEW_FROM_UTF8(env, key, utf8names[i]);
 
-  CHECK_MAYBE_EMPTY(env, get_maybe, napi_generic_failure);
+    auto get_maybe = obj->Get(context, key);
+
+    CHECK_MAYBE_EMPTY(env, get_maybe, napi_generic_failure);
+
+    results[i] = v8impl::JsValueFromV8LocalValue(get_maybe.ToLocalChecked());
+  }
 
-  *result = v8impl::JsValueFromV8LocalValue(get_maybe.ToLocalChecked());
   return GET_RETURN_STATUS(env);
 }
 
-napi_status napi_define_properties(napi_env env,
-                                   napi_value object,
-                                   size_t property_count,
-                                   const napi_property_descriptor* properties) {
+napi_status napi_create_atom(napi_env env,
+                             const char* utf8name,
+                             size_t length,
+                             napi_atom* result) {
   NAPI_PREAMBLE(env);
+  CHECK_ARG(env, utf8name);
+  CHECK_ARG(env, result);
 
-  v8::Isolate* isolate = env->isolate;
-  v8::Local<v8::Context> context = isolate->GetCurrentContext();
-  v8::Local<v8::Object> obj =
-      v8impl::V8LocalValueFromJsValue(object).As<v8::Object>();
+  std::string name = length == static_cast<size_t>(-1) ?
+      std::string(utf8name) : std::string(utf8name, length);
 
-  for (size_t i = 0; i < property_count; i++) {
-    const napi_property_descriptor* p = &properties[i];
+  auto it = env->atoms.find(name);
+  if (it != env->atoms.end()) {
+    *result = it->second;
+    return napi_ok;
+  }
 
-    v8::Local<v8::Name> property_name;
-    napi_status status =
-        v8impl::V8NameFromPropertyDescriptor(env, p, &property_name);
+  v8::HandleScope scope(env->isolate);
+  v8::Local<v8::String> key;
+  CHECK_NEW_FROM_UTF8_LEN(env, key, name.data(), name.size());
 
-    if (status != napi_ok) {
-      return napi_set_last_error(env, status);
-    }
+  napi_atom atom = new napi_atom__(env->isolate, key);
+  env->atoms.emplace(std::move(name), atom);
 
-    v8::PropertyAttribute attributes =
-        v8impl::V8PropertyAttributesFromDescriptor(p);
+  *result = atom;
+  return GET_RETURN_STATUS(env);
+}
 
-    if (p->getter != nullptr || p->setter != nullptr) {
-      v8::Local<v8::Object> cbdata = v8impl::CreateAccessorCallbackData(
-        env,
-        p->getter,
-        p->setter,
-        p->data);
+napi_status napi_get_atom_value(napi_env env,
+                                napi_atom atom,
+                                napi_value* result) {
+  // Omit NAPI_PREAMBLE and GET_RETURN_STATUS because V8 calls here cannot throw
+  // JS exceptions.
+  CHECK_ENV(env);
+  CHECK_ARG(env, atom);
+  CHECK_ARG(env, result);
 
-      auto set_maybe = obj->SetAccessor(
-        context,
-        property_name,
-        p->getter ? v8impl::GetterCallbackWrapper::Invoke : nullptr,
-        p->setter ? v8impl::SetterCallbackWrapper::Invoke : nullptr,
-        cbdata,
-        v8::AccessControl::DEFAULT,
-        attributes);
+  *result = v8impl::JsValueFromV8LocalValue(
+      v8::Local<v8::String>::New(env->isolate, atom->value));
 
-      if (!set_maybe.FromMaybe(false)) {
-        return napi_set_last_error(env, napi_invalid_arg);
-      }
-    } else if (p->method != nullptr) {
-      v8::Local<v8::Object> cbdata =
-          v8impl::CreateFunctionCallbackData(env, p->method, p->data);
+  return napi_ok;
+}
 
-      RETURN_STATUS_IF_FALSE(env, !cbdata.IsEmpty(), napi_generic_failure);
+napi_status napi_set_atom_property(napi_env env,
+                                   napi_value object,
+                                   napi_atom atom,
+                                   napi_value value) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, atom);
 
-      v8::Local<v8::FunctionTemplate> t = v8::FunctionTemplate::New(
-          isolate, v8impl::FunctionCallbackWrapper::Invoke, cbdata);
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Object> obj;
 
-      auto define_maybe = obj->DefineOwnProperty(
-        context, property_name, t->GetFunction(), attributes);
+  CHECK_TO_OBJECT(env, context, obj, object);
 
-      if (!define_maybe.FromMaybe(false)) {
-        return napi_set_last_error(env, napi_generic_failure);
+  v8::Local<v8::String> key = v8::Local<v8::String>::New(isolate, atom->value);
+  v8::Local<v8::Value> val = v8impl::V8LocalValueFromJsValue(value);
+
+  v8::Maybe<bool> set_maybe = obj->Set(context, key, val);
+
+  RETURN_STATUS_IF_FALSE(env, set_maybe.FromMaybe(false), napi_generic_failure);
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_has_atom_property(napi_env env,
+                                   napi_value object,
+                                   napi_atom atom,
+                                   bool* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, atom);
+  CHECK_ARG(env, result);
+
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Object> obj;
+
+  CHECK_TO_OBJECT(env, context, obj, object);
+
+  v8::Local<v8::String> key = v8::Local<v8::String>::New(isolate, atom->value);
+  v8::Maybe<bool> has_maybe = obj->Has(context, key);
+
+  CHECK_MAYBE_NOTHING(env, has_maybe, napi_generic_failure);
+
+  *result = has_maybe.FromMaybe(false);
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_get_atom_property(napi_env env,
+                                   napi_value object,
+                                   napi_atom atom,
+                                   napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, atom);
+  CHECK_ARG(env, result);
+
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Object> obj;
+
+  CHECK_TO_OBJECT(env, context, obj, object);
+
+  v8::Local<v8::String> key = v8::Local<v8::String>::New(isolate, atom->value);
+  auto get_maybe = obj->Get(context, key);
+
+  CHECK_MAYBE_EMPTY(env, get_maybe, napi_generic_failure);
+
+  *result = v8impl::JsValueFromV8LocalValue(get_maybe.ToLocalChecked());
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_set_element(napi_env env,
+                             napi_value object,
+                             uint32_t index,
+                             napi_value value) {
+  NAPI_PREAMBLE(env);
+
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Object> obj;
+
+  CHECK_TO_OBJECT(env, context, obj, object);
+
+  v8::Local<v8::Value> val = v8impl::V8LocalValueFromJsValue(value);
+  auto set_maybe = obj->Set(context, index, val);
+
+  RETURN_STATUS_IF_FALSE(env, set_maybe.FromMaybe(false), napi_generic_failure);
+
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_has_element(napi_env env,
+                             napi_value object,
+                             uint32_t index,
+                             bool* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, result);
+
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Object> obj;
+
+  CHECK_TO_OBJECT(env, context, obj, object);
+
+  v8::Maybe<bool> has_maybe = obj->Has(context, index);
+
+  CHECK_MAYBE_NOTHING(env, has_maybe, napi_generic_failure);
+
+  *result = has_maybe.FromMaybe(false);
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_get_element(napi_env env,
+                             napi_value object,
+                             uint32_t index,
+                             napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, result);
+
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Object> obj;
+
+  CHECK_TO_OBJECT(env, context, obj, object);
+
+  auto get_maybe = obj->Get(context, index);
+
+  CHECK_MAYBE_EMPTY(env, get_maybe, napi_generic_failure);
+
+  *result = v8impl::JsValueFromV8LocalValue(get_maybe.ToLocalChecked());
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_define_properties(napi_env env,
+                                   napi_value object,
+                                   size_t property_count,
+                                   const napi_property_descriptor* properties) {
+  NAPI_PREAMBLE(env);
+
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Object> obj =
+      v8impl::V8LocalValueFromJsValue(object).As<v8::Object>();
+
+  for (size_t i = 0; i < property_count; i++) {
+    const napi_property_descriptor* p = &properties[i];
+
+    v8::Local<v8::Name> property_name;
+    napi_status status =
+        v8impl::V8NameFromPropertyDescriptor(env, p, &property_name);
+
+    if (status != napi_ok) {
+      return napi_set_last_error(env, status);
+    }
+
+    v8::PropertyAttribute attributes =
+        v8impl::V8PropertyAttributesFromDescriptor(p);
+
+    if (p->getter != nullptr || p->setter != nullptr) {
+      v8::Local<v8::Object> cbdata = v8impl::CreateAccessorCallbackData(
+        env,
+        p->getter,
+        p->setter,
+        p->data);
+
+      auto set_maybe = obj->SetAccessor(
+        context,
+        property_name,
+        p->getter ? v8impl::GetterCallbackWrapper::Invoke : nullptr,
+        p->setter ? v8impl::SetterCallbackWrapper::Invoke : nullptr,
+        cbdata,
+        v8::AccessControl::DEFAULT,
+        attributes);
+
+      if (!set_maybe.FromMaybe(false)) {
+        return napi_set_last_error(env, napi_invalid_arg);
+      }
+    } else if (p->method != nullptr) {
+      v8::Local<v8::Object> cbdata =
+          v8impl::CreateFunctionCallbackData(env, p->method, p->data);
+
+      RETURN_STATUS_IF_FALSE(env, !cbdata.IsEmpty(), napi_generic_failure);
+
+      v8::Local<v8::FunctionTemplate> t = v8::FunctionTemplate::New(
+          isolate, v8impl::FunctionCallbackWrapper::Invoke, cbdata);
+
+      auto define_maybe = obj->DefineOwnProperty(
+        context, property_name, t->GetFunction(), attributes);
+
+      if (!define_maybe.FromMaybe(false)) {
+        return napi_set_last_error(env, napi_generic_failure);
       }
     } else {
       v8::Local<v8::Value> value = v8impl::V8LocalValueFromJsValue(p->value);
@@ -1205,6 +1814,36 @@ napi_status napi_get_array_length(napi_env env,
   return GET_RETURN_STATUS(env);
 }
 
+napi_status napi_get_array_elements_double(napi_env env,
+                                          napi_value array,
+                                          double* buf,
+                                          size_t bufsize,
+                                          size_t* result) {
+  return v8impl::CopyArrayToNative(env, array, buf, bufsize, result);
+}
+
+napi_status napi_get_array_elements_int32(napi_env env,
+                                         napi_value array,
+                                         int32_t* buf,
+                                         size_t bufsize,
+                                         size_t* result) {
+  return v8impl::CopyArrayToNative(env, array, buf, bufsize, result);
+}
+
+napi_status napi_create_array_from_double(napi_env env,
+                                          const double* values,
+                                          size_t length,
+                                          napi_value* result) {
+  return v8impl::CopyNativeToArray(env, values, length, result);
+}
+
+napi_status napi_create_array_from_int32(napi_env env,
+                                         const int32_t* values,
+                                         size_t length,
+                                         napi_value* result) {
+  return v8impl::CopyNativeToArray(env, values, length, result);
+}
+
 napi_status napi_strict_equals(napi_env env,
                                napi_value lhs,
                                napi_value rhs,
@@ -1320,6 +1959,68 @@ napi_status napi_create_string_utf16(napi_env env,
   return GET_RETURN_STATUS(env);
 }
 
+napi_status napi_create_external_string_latin1(
+    napi_env env,
+    char* str,
+    size_t length,
+    napi_finalize finalize_callback,
+    void* finalize_hint,
+    napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, str);
+  CHECK_ARG(env, result);
+
+  if (length == static_cast<size_t>(-1)) {
+    length = strlen(str);
+  }
+
+  v8impl::ExternalOneByteString* resource = new v8impl::ExternalOneByteString(
+      env, str, length, finalize_callback, finalize_hint);
+
+  auto str_maybe = v8::String::NewExternalOneByte(env->isolate, resource);
+  if (str_maybe.IsEmpty()) {
+    resource->Disown();
+    delete resource;
+    return napi_set_last_error(env, napi_generic_failure);
+  }
+
+  *result = v8impl::JsValueFromV8LocalValue(str_maybe.ToLocalChecked());
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_create_external_string_utf16(
+    napi_env env,
+    char16_t* str,
+    size_t length,
+    napi_finalize finalize_callback,
+    void* finalize_hint,
+    napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, str);
+  CHECK_ARG(env, result);
+
+  if (length == static_cast<size_t>(-1)) {
+    length = 0;
+    while (str[length] != 0) {
+      length++;
+    }
+  }
+
+  v8impl::ExternalTwoByteString* resource = new v8impl::ExternalTwoByteString(
+      env, reinterpret_cast<uint16_t*>(str), length,
+      finalize_callback, finalize_hint);
+
+  auto str_maybe = v8::String::NewExternalTwoByte(env->isolate, resource);
+  if (str_maybe.IsEmpty()) {
+    resource->Disown();
+    delete resource;
+    return napi_set_last_error(env, napi_generic_failure);
+  }
+
+  *result = v8impl::JsValueFromV8LocalValue(str_maybe.ToLocalChecked());
+  return GET_RETURN_STATUS(env);
+}
+
 napi_status napi_create_number(napi_env env,
                                double value,
                                napi_value* result) {
@@ -1502,6 +2203,22 @@ napi_status napi_get_cb_info(
   return napi_ok;
 }
 
+napi_status napi_get_cb_arg(napi_env env,
+                            napi_callback_info cbinfo,
+                            size_t index,
+                            napi_value* result) {
+  // Omit NAPI_PREAMBLE and GET_RETURN_STATUS because no V8 APIs are called.
+  CHECK_ENV(env);
+  CHECK_ARG(env, cbinfo);
+  CHECK_ARG(env, result);
+
+  v8impl::CallbackWrapper* info =
+      reinterpret_cast<v8impl::CallbackWrapper*>(cbinfo);
+
+  *result = info->Arg(index);
+  return napi_ok;
+}
+
 napi_status napi_is_construct_call(napi_env env,
                                    napi_callback_info cbinfo,
                                    bool* result) {
@@ -1920,7 +2637,14 @@ napi_status napi_wrap(napi_env env,
   // via napi_define_class() can be (un)wrapped.
   RETURN_STATUS_IF_FALSE(env, obj->InternalFieldCount() > 0, napi_invalid_arg);
 
-  obj->SetInternalField(0, v8::External::New(isolate, native_object));
+  // Like node::ObjectWrap, store the pointer directly in the internal field
+  // so that no v8::External has to be allocated for it. V8 can only do that
+  // for 2-byte aligned pointers, so fall back to a v8::External otherwise.
+  if ((reinterpret_cast<uintptr_t>(native_object) & 1) == 0) {
+    obj->SetAlignedPointerInInternalField(0, native_object);
+  } else {
+    obj->SetInternalField(0, v8::External::New(isolate, native_object));
+  }
 
   if (result != nullptr) {
     // The returned reference should be deleted via napi_delete_reference()
@@ -1955,10 +2679,16 @@ napi_status napi_unwrap(napi_env env, napi_value js_object, void** result) {
   // via napi_define_class() can be (un)wrapped.
   RETURN_STATUS_IF_FALSE(env, obj->InternalFieldCount() > 0, napi_invalid_arg);
 
+  // The field is undefined until the object has been wrapped; see napi_wrap()
+  // for how the pointer is stored.
   v8::Local<v8::Value> unwrappedValue = obj->GetInternalField(0);
-  RETURN_STATUS_IF_FALSE(env, unwrappedValue->IsExternal(), napi_invalid_arg);
-
-  *result = unwrappedValue.As<v8::External>()->Value();
+  if (unwrappedValue->IsExternal()) {
+    *result = unwrappedValue.As<v8::External>()->Value();
+  } else {
+    RETURN_STATUS_IF_FALSE(env, !unwrappedValue->IsUndefined(),
+                           napi_invalid_arg);
+    *result = obj->GetAlignedPointerFromInternalField(0);
+  }
 
   return napi_ok;
 }
@@ -2097,7 +2827,7 @@ napi_status napi_open_handle_scope(napi_env env, napi_handle_scope* result) {
   CHECK_ARG(env, result);
 
   *result = v8impl::JsHandleScopeFromV8HandleScope(
-      new v8impl::HandleScopeWrapper(env->isolate));
+      env->handle_scopes.New(env->isolate));
   return GET_RETURN_STATUS(env);
 }
 
@@ -2105,7 +2835,7 @@ napi_status napi_close_handle_scope(napi_env env, napi_handle_scope scope) {
   NAPI_PREAMBLE(env);
   CHECK_ARG(env, scope);
 
-  delete v8impl::V8HandleScopeFromJsHandleScope(scope);
+  env->handle_scopes.Delete(v8impl::V8HandleScopeFromJsHandleScope(scope));
   return GET_RETURN_STATUS(env);
 }
 
@@ -2116,7 +2846,7 @@ napi_status napi_open_escapable_handle_scope(
   CHECK_ARG(env, result);
 
   *result = v8impl::JsEscapableHandleScopeFromV8EscapableHandleScope(
-      new v8impl::EscapableHandleScopeWrapper(env->isolate));
+      env->escapable_handle_scopes.New(env->isolate));
   return GET_RETURN_STATUS(env);
 }
 
@@ -2126,7 +2856,8 @@ napi_status napi_close_escapable_handle_scope(
   NAPI_PREAMBLE(env);
   CHECK_ARG(env, scope);
 
-  delete v8impl::V8EscapableHandleScopeFromJsEscapableHandleScope(scope);
+  env->escapable_handle_scopes.Delete(
+      v8impl::V8EscapableHandleScopeFromJsEscapableHandleScope(scope));
   return GET_RETURN_STATUS(env);
 }
 
@@ -2284,6 +3015,7 @@ napi_status napi_instanceof(napi_env env,
 }
 
 napi_status napi_make_callback(napi_env env,
+                               napi_async_context async_context,
                                napi_value recv,
                                napi_value func,
                                size_t argc,
@@ -2296,10 +3028,17 @@ napi_status napi_make_callback(napi_env env,
       v8impl::V8LocalValueFromJsValue(recv).As<v8::Object>();
   v8::Local<v8::Function> v8func =
       v8impl::V8LocalValueFromJsValue(func).As<v8::Function>();
+  v8::Local<v8::Value>* v8argv =
+      reinterpret_cast<v8::Local<v8::Value>*>(const_cast<napi_value*>(argv));
 
-  v8::Local<v8::Value> callback_result = node::MakeCallback(
-      isolate, v8recv, v8func, argc,
-      reinterpret_cast<v8::Local<v8::Value>*>(const_cast<napi_value*>(argv)));
+  v8::Local<v8::Value> callback_result;
+  if (async_context == nullptr) {
+    callback_result = node::MakeCallback(isolate, v8recv, v8func, argc, v8argv);
+  } else {
+    callback_result =
+        v8impl::AsyncContextFromJsAsyncContext(async_context)->MakeCallback(
+            v8recv, v8func, argc, v8argv);
+  }
 
   if (result != nullptr) {
     *result = v8impl::JsValueFromV8LocalValue(callback_result);
@@ -2308,38 +3047,134 @@ napi_status napi_make_callback(napi_env env,
   return GET_RETURN_STATUS(env);
 }
 
-// Methods to support catching exceptions
-napi_status napi_is_exception_pending(napi_env env, bool* result) {
-  // NAPI_PREAMBLE is not used here: this function must execute when there is a
-  // pending exception.
+napi_status napi_get_uv_event_loop(napi_env env, uv_loop_t** loop) {
   CHECK_ENV(env);
-  CHECK_ARG(env, result);
+  CHECK_ARG(env, loop);
+
+  *loop = node::Environment::GetCurrent(env->isolate)->event_loop();
 
-  *result = !env->last_exception.IsEmpty();
   return napi_ok;
 }
 
-napi_status napi_get_and_clear_last_exception(napi_env env,
-                                              napi_value* result) {
-  // NAPI_PREAMBLE is not used here: this function must execute when there is a
-  // pending exception.
-  CHECK_ENV(env);
+napi_status napi_async_init(napi_env env,
+                            napi_value async_resource,
+                            napi_async_context* result) {
+  NAPI_PREAMBLE(env);
   CHECK_ARG(env, result);
 
-  if (env->last_exception.IsEmpty()) {
-    return napi_get_undefined(env, result);
-  } else {
-    *result = v8impl::JsValueFromV8LocalValue(
-      v8::Local<v8::Value>::New(env->isolate, env->last_exception));
-    env->last_exception.Reset();
+  v8::Isolate* isolate = env->isolate;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  node::Environment* node_env = node::Environment::GetCurrent(isolate);
+
+  if (env->async_context_template.IsEmpty()) {
+    v8::Local<v8::ObjectTemplate> tpl = v8::ObjectTemplate::New(isolate);
+    tpl->SetInternalFieldCount(1);
+    env->async_context_template.Reset(isolate, tpl);
   }
+  v8::Local<v8::ObjectTemplate> tpl =
+      v8::Local<v8::ObjectTemplate>::New(isolate, env->async_context_template);
+
+  v8::MaybeLocal<v8::Object> maybe_object = tpl->NewInstance(context);
+  CHECK_MAYBE_EMPTY(env, maybe_object, napi_generic_failure);
+  v8::Local<v8::Object> object = maybe_object.ToLocalChecked();
+
+  if (async_resource != nullptr) {
+    v8::Maybe<bool> set = object->Set(
+        context, node_env->owner_string(),
+        v8impl::V8LocalValueFromJsValue(async_resource));
+    CHECK_MAYBE_NOTHING(env, set, napi_generic_failure);
+  }
+
+  *result = v8impl::JsAsyncContextFromAsyncContext(
+      new v8impl::AsyncContext(node_env, object));
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_async_destroy(napi_env env,
+                               napi_async_context async_context) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, async_context);
+
+  delete v8impl::AsyncContextFromJsAsyncContext(async_context);
 
   return napi_ok;
 }
 
-napi_status napi_create_buffer(napi_env env,
-                               size_t length,
-                               void** data,
+napi_status napi_adjust_external_memory(napi_env env,
+                                        int64_t change_in_bytes,
+                                        int64_t* adjusted_value) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, adjusted_value);
+
+  *adjusted_value =
+      env->isolate->AdjustAmountOfExternalAllocatedMemory(change_in_bytes);
+
+  return napi_ok;
+}
+
+napi_status napi_set_external_memory_reporting(napi_env env, bool enabled) {
+  CHECK_ENV(env);
+
+  env->report_external_memory = enabled;
+  return napi_ok;
+}
+
+napi_status napi_set_finalize_mode(napi_env env, napi_finalize_mode mode) {
+  CHECK_ENV(env);
+  RETURN_STATUS_IF_FALSE(env,
+      mode == napi_finalize_sync || mode == napi_finalize_deferred,
+      napi_invalid_arg);
+
+  if (mode == napi_finalize_deferred && env->finalize_idle == nullptr) {
+    uv_loop_t* event_loop =
+      node::Environment::GetCurrent(env->isolate)->event_loop();
+
+    uv_idle_t* idle = new uv_idle_t;
+    int uv_result = uv_idle_init(event_loop, idle);
+    if (uv_result != 0) {
+      delete idle;
+      return napi_set_last_error(env, napi_generic_failure, uv_result);
+    }
+    idle->data = env;
+    env->finalize_idle = idle;
+  }
+
+  env->finalize_mode = mode;
+  return napi_ok;
+}
+
+// Methods to support catching exceptions
+napi_status napi_is_exception_pending(napi_env env, bool* result) {
+  // NAPI_PREAMBLE is not used here: this function must execute when there is a
+  // pending exception.
+  CHECK_ENV(env);
+  CHECK_ARG(env, result);
+
+  *result = !env->last_exception.IsEmpty();
+  return napi_ok;
+}
+
+napi_status napi_get_and_clear_last_exception(napi_env env,
+                                              napi_value* result) {
+  // NAPI_PREAMBLE is not used here: this function must execute when there is a
+  // pending exception.
+  CHECK_ENV(env);
+  CHECK_ARG(env, result);
+
+  if (env->last_exception.IsEmpty()) {
+    return napi_get_undefined(env, result);
+  } else {
+    *result = v8impl::JsValueFromV8LocalValue(
+      v8::Local<v8::Value>::New(env->isolate, env->last_exception));
+    env->last_exception.Reset();
+  }
+
+  return napi_ok;
+}
+
+napi_status napi_create_buffer(napi_env env,
+                               size_t length,
+                               void** data,
                                napi_value* result) {
   NAPI_PREAMBLE(env);
   CHECK_ARG(env, data);
@@ -2380,6 +3215,8 @@ napi_status napi_create_external_buffer(napi_env env,
 
   CHECK_MAYBE_EMPTY(env, maybe, napi_generic_failure);
 
+  finalizer->ReportExternalMemory(length);
+
   *result = v8impl::JsValueFromV8LocalValue(maybe.ToLocalChecked());
   return GET_RETURN_STATUS(env);
   // Tell coverity that 'finalizer' should not be freed when we return
@@ -2388,6 +3225,95 @@ napi_status napi_create_external_buffer(napi_env env,
   // coverity[leaked_storage]
 }
 
+napi_status napi_create_buffer_region(napi_env env,
+                                      void* data,
+                                      size_t byte_length,
+                                      napi_buffer_view_release release_cb,
+                                      napi_finalize finalize_cb,
+                                      void* hint,
+                                      napi_buffer_region* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, result);
+
+  v8::Local<v8::ArrayBuffer> buffer =
+      v8::ArrayBuffer::New(env->isolate, data, byte_length);
+
+  *result = v8impl::JsBufferRegionFromBufferRegion(new v8impl::BufferRegion(
+      env, buffer, data, byte_length, release_cb, finalize_cb, hint));
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_delete_buffer_region(napi_env env,
+                                      napi_buffer_region region) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, region);
+
+  v8impl::BufferRegion* r = v8impl::BufferRegionFromJsBufferRegion(region);
+  RETURN_STATUS_IF_FALSE(env, r->Pinned() == 0, napi_generic_failure);
+
+  delete r;
+  return napi_ok;
+}
+
+napi_status napi_create_buffer_view(napi_env env,
+                                    napi_buffer_region region,
+                                    size_t byte_offset,
+                                    size_t length,
+                                    napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, region);
+  CHECK_ARG(env, result);
+
+  v8impl::BufferRegion* r = v8impl::BufferRegionFromJsBufferRegion(region);
+  RETURN_STATUS_IF_FALSE(env,
+      byte_offset <= r->ByteLength() &&
+      length <= r->ByteLength() - byte_offset,
+      napi_invalid_arg);
+
+  // Like node::Buffer::New(), but over the ArrayBuffer of the region, so
+  // that there is nothing to finalize per view.
+  node::Environment* node_env = node::Environment::GetCurrent(env->isolate);
+  v8::Local<v8::Uint8Array> view =
+      v8::Uint8Array::New(r->Buffer(), byte_offset, length);
+  v8::Maybe<bool> set = view->SetPrototype(node_env->context(),
+                                           node_env->buffer_prototype_object());
+  CHECK_MAYBE_NOTHING(env, set, napi_generic_failure);
+
+  r->Pin();
+  *result = v8impl::JsValueFromV8LocalValue(view);
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_release_buffer_view(napi_env env,
+                                     napi_buffer_region region,
+                                     napi_value view) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, region);
+  CHECK_ARG(env, view);
+
+  v8impl::BufferRegion* r = v8impl::BufferRegionFromJsBufferRegion(region);
+  v8::Local<v8::Value> value = v8impl::V8LocalValueFromJsValue(view);
+  RETURN_STATUS_IF_FALSE(env, value->IsUint8Array(), napi_invalid_arg);
+  v8::Local<v8::Uint8Array> array = value.As<v8::Uint8Array>();
+  RETURN_STATUS_IF_FALSE(env, array->Buffer() == r->Buffer(),
+                         napi_invalid_arg);
+  RETURN_STATUS_IF_FALSE(env, r->Pinned() > 0, napi_generic_failure);
+
+  r->Release(array->ByteOffset(), array->ByteLength());
+  return napi_ok;
+}
+
+napi_status napi_get_buffer_region_pinned(napi_env env,
+                                          napi_buffer_region region,
+                                          size_t* result) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, region);
+  CHECK_ARG(env, result);
+
+  *result = v8impl::BufferRegionFromJsBufferRegion(region)->Pinned();
+  return napi_ok;
+}
+
 napi_status napi_create_buffer_copy(napi_env env,
                                     size_t length,
                                     const void* data,
@@ -2482,16 +3408,17 @@ napi_status napi_create_external_arraybuffer(napi_env env,
   v8::Local<v8::ArrayBuffer> buffer =
       v8::ArrayBuffer::New(isolate, external_data, byte_length);
 
-  if (finalize_cb != nullptr) {
+  if (finalize_cb != nullptr || env->report_external_memory) {
     // Create a self-deleting weak reference that invokes the finalizer
-    // callback.
-    v8impl::Reference::New(env,
+    // callback, and stops reporting the memory.
+    v8impl::Reference* reference = v8impl::Reference::New(env,
         buffer,
         0,
         true,
         finalize_cb,
         external_data,
         finalize_hint);
+    reference->ReportExternalMemory(byte_length);
   }
 
   *result = v8impl::JsValueFromV8LocalValue(buffer);
@@ -2654,6 +3581,8 @@ napi_status ConvertUVErrorCode(int code) {
   return napi_generic_failure;
 }
 
+class Executor;
+
 // Wrapper around uv_work_t which calls user-provided callbacks.
 class Work {
  private:
@@ -2664,7 +3593,9 @@ class Work {
     : _env(env),
     _data(data),
     _execute(execute),
-    _complete(complete) {
+    _complete(complete),
+    _executor(nullptr),
+    _priority(node::threadpool::kNormalPriority) {
     memset(&_request, 0, sizeof(_request));
     _request.data = this;
   }
@@ -2683,16 +3614,53 @@ class Work {
     delete work;
   }
 
+  // Must be called on the loop thread when the work is queued. While the
+  // node.threadpool trace category is enabled, the work is recorded as an
+  // async event until it completes, with a nested "wait" event for the time
+  // it spent in the queue.
+  void TraceQueued() {
+    TraceEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN, "napi_async_work");
+    TraceEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN, "wait");
+  }
+
   static void ExecuteCallback(uv_work_t* req) {
     Work* work = static_cast<Work*>(req->data);
+    work->TraceEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_END, "wait");
+    const uint8_t* category_enabled = TraceCategoryEnabled();
+    uint64_t handle = 0;
+    if (category_enabled != nullptr) {
+      handle = node::tracing::AddTraceEvent(
+          TRACE_EVENT_PHASE_COMPLETE, category_enabled, "napi_async_work",
+          node::tracing::kGlobalScope, node::tracing::kNoId,
+          node::tracing::kNoId, TRACE_EVENT_FLAG_NONE);
+    }
     work->_execute(work->_env, work->_data);
+    if (category_enabled != nullptr) {
+      TRACE_EVENT_API_UPDATE_TRACE_EVENT_DURATION(category_enabled,
+                                                  "napi_async_work", handle);
+    }
   }
 
   static void CompleteCallback(uv_work_t* req, int status) {
     Work* work = static_cast<Work*>(req->data);
 
+    // Cancelled work never got to ExecuteCallback().
+    if (status == UV_ECANCELED) {
+      work->TraceEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_END, "wait");
+    }
+    work->TraceEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_END, "napi_async_work");
+
     if (work->_complete != nullptr) {
-      work->_complete(work->_env, ConvertUVErrorCode(status), work->_data);
+      napi_env env = work->_env;
+      node::Environment* node_env = node::Environment::GetCurrent(env->isolate);
+      v8::HandleScope scope(env->isolate);
+      node::Environment::AsyncCallbackScope callback_scope(node_env);
+      work->_complete(env, ConvertUVErrorCode(status), work->_data);
+      // Promises that the callback settled, and the ticks it queued, are run
+      // now rather than after whatever callback comes next.
+      if (!callback_scope.in_makecallback()) {
+        node::TickAfterCallback(node_env);
+      }
     }
   }
 
@@ -2700,12 +3668,477 @@ class Work {
     return &_request;
   }
 
+  // The executor the work was queued on, or nullptr if it was queued on the
+  // shared libuv threadpool.
+  Executor* GetExecutor() {
+    return _executor;
+  }
+
+  void SetExecutor(Executor* executor) {
+    _executor = executor;
+  }
+
+  node::threadpool::Priority GetPriority() const {
+    return _priority;
+  }
+
+  void SetPriority(node::threadpool::Priority priority) {
+    _priority = priority;
+  }
+
  private:
+  // Returns nullptr unless node.threadpool is enabled for tracing.
+  static const uint8_t* TraceCategoryEnabled() {
+    // There is no platform without NODE_USE_V8_PLATFORM.
+    if (node::tracing::TraceEventHelper::GetCurrentPlatform() == nullptr) {
+      return nullptr;
+    }
+    static const uint8_t* category_enabled =
+        TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED("node.threadpool");
+    if (!(*category_enabled &
+          kEnabledForRecording_CategoryGroupEnabledFlags)) {
+      return nullptr;
+    }
+    return category_enabled;
+  }
+
+  void TraceEvent(char phase, const char* name) const {
+    const uint8_t* category_enabled = TraceCategoryEnabled();
+    if (category_enabled == nullptr) {
+      return;
+    }
+    node::tracing::AddTraceEvent(
+        phase, category_enabled, name, node::tracing::kGlobalScope,
+        reinterpret_cast<uintptr_t>(this), node::tracing::kNoId,
+        TRACE_EVENT_FLAG_HAS_ID);
+  }
+
   napi_env _env;
   void* _data;
   uv_work_t _request;
   napi_async_execute_callback _execute;
   napi_async_complete_callback _complete;
+  Executor* _executor;
+  node::threadpool::Priority _priority;
+};
+
+// A dedicated pool of threads that runs napi_async_work items, so that
+// CPU-heavy addon work does not compete with fs, dns, zlib and crypto for
+// the shared libuv threadpool. Completions are reported back to the loop
+// thread in batches through a uv_async_t.
+class Executor {
+ private:
+  explicit Executor(size_t thread_count)
+    : _threads(thread_count),
+    _outstanding(0),
+    _stopping(false) {
+    memset(&_async, 0, sizeof(_async));
+    _async.data = this;
+  }
+
+  ~Executor() { }
+
+ public:
+  static Executor* New(size_t thread_count) {
+    return new Executor(thread_count);
+  }
+
+  static void Delete(Executor* executor) {
+    delete executor;
+  }
+
+  // If this fails the executor has not been started and can be deleted.
+  int Init(uv_loop_t* loop) {
+    int result = 0;
+
+    for (size_t i = 0; i < _threads.size(); i++) {
+      result = uv_thread_create(&_threads[i], ThreadMain, this);
+      if (result != 0) {
+        _threads.resize(i);
+        break;
+      }
+    }
+
+    if (result == 0) {
+      result = uv_async_init(loop, &_async, AsyncCallback);
+    }
+
+    if (result != 0) {
+      StopThreads();
+      return result;
+    }
+
+    // Only keep the loop alive while there is outstanding work.
+    uv_unref(reinterpret_cast<uv_handle_t*>(&_async));
+    return 0;
+  }
+
+  // Must be called on the loop thread.
+  void Queue(Work* work) {
+    work->SetExecutor(this);
+    work->TraceQueued();
+    if (_outstanding++ == 0) {
+      uv_ref(reinterpret_cast<uv_handle_t*>(&_async));
+    }
+
+    node::Mutex::ScopedLock lock(_mutex);
+    _pending.push_back(work);
+    _cond.Signal(lock);
+  }
+
+  // Must be called on the loop thread. Fails if the work item has already
+  // started executing.
+  int Cancel(Work* work) {
+    {
+      node::Mutex::ScopedLock lock(_mutex);
+      auto it = std::find(_pending.begin(), _pending.end(), work);
+      if (it == _pending.end()) {
+        return UV_EBUSY;
+      }
+      _pending.erase(it);
+      _completed.push_back(std::make_pair(work, UV_ECANCELED));
+    }
+
+    uv_async_send(&_async);
+    return 0;
+  }
+
+  // Must be called on the loop thread. Waits for running work to finish,
+  // cancels work that has not started yet and frees the executor once the
+  // outstanding completion callbacks have run.
+  void Shutdown() {
+    StopThreads();
+
+    for (Work* work : _pending) {
+      _completed.push_back(std::make_pair(work, UV_ECANCELED));
+    }
+    _pending.clear();
+
+    DispatchCompleted();
+    uv_close(reinterpret_cast<uv_handle_t*>(&_async), HandleClosedCallback);
+  }
+
+ private:
+  void StopThreads() {
+    {
+      node::Mutex::ScopedLock lock(_mutex);
+      _stopping = true;
+      _cond.Broadcast(lock);
+    }
+
+    for (uv_thread_t& thread : _threads) {
+      CHECK_EQ(0, uv_thread_join(&thread));
+    }
+    _threads.clear();
+  }
+
+  static void ThreadMain(void* arg) {
+    Executor* executor = static_cast<Executor*>(arg);
+
+    for (;;) {
+      Work* work;
+      {
+        node::Mutex::ScopedLock lock(executor->_mutex);
+        while (executor->_pending.empty() && !executor->_stopping) {
+          executor->_cond.Wait(lock);
+        }
+        if (executor->_stopping) {
+          return;
+        }
+        work = executor->_pending.front();
+        executor->_pending.pop_front();
+      }
+
+      Work::ExecuteCallback(work->Request());
+
+      {
+        node::Mutex::ScopedLock lock(executor->_mutex);
+        executor->_completed.push_back(std::make_pair(work, 0));
+      }
+      uv_async_send(&executor->_async);
+    }
+  }
+
+  static void AsyncCallback(uv_async_t* handle) {
+    static_cast<Executor*>(handle->data)->DispatchCompleted();
+  }
+
+  void DispatchCompleted() {
+    std::vector<std::pair<Work*, int>> batch;
+    {
+      node::Mutex::ScopedLock lock(_mutex);
+      batch.swap(_completed);
+    }
+
+    for (const auto& completion : batch) {
+      Work* work = completion.first;
+      work->SetExecutor(nullptr);
+      if (--_outstanding == 0) {
+        uv_unref(reinterpret_cast<uv_handle_t*>(&_async));
+      }
+      // The completion callback may delete the work item.
+      Work::CompleteCallback(work->Request(), completion.second);
+    }
+  }
+
+  static void HandleClosedCallback(uv_handle_t* handle) {
+    Delete(static_cast<Executor*>(handle->data));
+  }
+
+  node::Mutex _mutex;
+  node::ConditionVariable _cond;
+  std::vector<uv_thread_t> _threads;
+  std::deque<Work*> _pending;
+  std::vector<std::pair<Work*, int>> _completed;
+  uv_async_t _async;
+  size_t _outstanding;
+  bool _stopping;
+};
+
+// Queue of calls made from arbitrary threads into a JavaScript function. The
+// calls are dispatched in batches on the loop thread in response to a
+// uv_async_t wakeup.
+class ThreadSafeFunction {
+ private:
+  ThreadSafeFunction(napi_env env,
+                     v8::Local<v8::Function> func,
+                     size_t max_queue_size,
+                     size_t thread_count,
+                     void* finalize_data,
+                     napi_finalize finalize_cb,
+                     void* context,
+                     napi_threadsafe_function_call_js call_js_cb)
+    : _env(env),
+    _max_queue_size(max_queue_size),
+    _thread_count(thread_count),
+    _is_closing(false),
+    _finalize_data(finalize_data),
+    _finalize_cb(finalize_cb),
+    _context(context),
+    _call_js_cb(call_js_cb) {
+    if (!func.IsEmpty()) {
+      _function.Reset(env->isolate, func);
+    }
+    memset(&_async, 0, sizeof(_async));
+    _async.data = this;
+  }
+
+  ~ThreadSafeFunction() {
+    _function.Reset();
+  }
+
+ public:
+  static ThreadSafeFunction* New(napi_env env,
+                                 v8::Local<v8::Function> func,
+                                 size_t max_queue_size,
+                                 size_t thread_count,
+                                 void* finalize_data,
+                                 napi_finalize finalize_cb,
+                                 void* context,
+                                 napi_threadsafe_function_call_js call_js_cb) {
+    return new ThreadSafeFunction(env, func, max_queue_size, thread_count,
+                                  finalize_data, finalize_cb, context,
+                                  call_js_cb);
+  }
+
+  static void Delete(ThreadSafeFunction* func) {
+    delete func;
+  }
+
+  int Init(uv_loop_t* loop) {
+    return uv_async_init(loop, &_async, AsyncCallback);
+  }
+
+  // May be called from any thread.
+  napi_status Push(void* data, napi_threadsafe_function_call_mode mode) {
+    node::Mutex::ScopedLock lock(_mutex);
+
+    while (_max_queue_size > 0 &&
+           _queue.size() >= _max_queue_size &&
+           !_is_closing) {
+      if (mode == napi_tsfn_nonblocking) {
+        return napi_queue_full;
+      }
+      _cond.Wait(lock);
+    }
+
+    if (_is_closing) {
+      if (_thread_count == 0) {
+        return napi_invalid_arg;
+      }
+      _thread_count--;
+      return napi_closing;
+    }
+
+    _queue.push(data);
+    uv_async_send(&_async);
+    return napi_ok;
+  }
+
+  // May be called from any thread.
+  napi_status Acquire() {
+    node::Mutex::ScopedLock lock(_mutex);
+
+    if (_is_closing) {
+      return napi_closing;
+    }
+
+    _thread_count++;
+    return napi_ok;
+  }
+
+  // May be called from any thread.
+  napi_status Release(napi_threadsafe_function_release_mode mode) {
+    node::Mutex::ScopedLock lock(_mutex);
+
+    if (_thread_count == 0) {
+      return napi_invalid_arg;
+    }
+
+    _thread_count--;
+
+    if (_thread_count == 0 || mode == napi_tsfn_abort) {
+      if (!_is_closing) {
+        _is_closing = (mode == napi_tsfn_abort);
+        if (_is_closing && _max_queue_size > 0) {
+          _cond.Broadcast(lock);
+        }
+        uv_async_send(&_async);
+      }
+    }
+
+    return napi_ok;
+  }
+
+  void* Context() {
+    return _context;
+  }
+
+  uv_handle_t* Handle() {
+    return reinterpret_cast<uv_handle_t*>(&_async);
+  }
+
+ private:
+  static void AsyncCallback(uv_async_t* handle) {
+    ThreadSafeFunction* func = static_cast<ThreadSafeFunction*>(handle->data);
+    func->DispatchQueue();
+  }
+
+  void DispatchQueue() {
+    std::queue<void*> batch;
+    bool aborted;
+
+    {
+      node::Mutex::ScopedLock lock(_mutex);
+      aborted = _is_closing;
+      batch.swap(_queue);
+      if (_max_queue_size > 0) {
+        _cond.Broadcast(lock);
+      }
+    }
+
+    if (aborted) {
+      DrainAborted(&batch);
+      Close();
+      return;
+    }
+
+    v8::Isolate* isolate = _env->isolate;
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Context::Scope context_scope(context);
+
+    while (!batch.empty()) {
+      void* data = batch.front();
+      batch.pop();
+      CallJs(data);
+    }
+
+    bool done;
+    {
+      node::Mutex::ScopedLock lock(_mutex);
+      done = _is_closing || (_thread_count == 0 && _queue.empty());
+      if (done) {
+        _is_closing = true;
+        batch.swap(_queue);
+      }
+    }
+
+    if (done) {
+      DrainAborted(&batch);
+      Close();
+    }
+  }
+
+  void CallJs(void* data) {
+    v8::Isolate* isolate = _env->isolate;
+    v8::HandleScope scope(isolate);
+
+    napi_value js_callback = nullptr;
+    if (!_function.IsEmpty()) {
+      js_callback = v8impl::JsValueFromV8LocalValue(
+          v8::Local<v8::Function>::New(isolate, _function));
+    }
+
+    napi_clear_last_error(_env);
+
+    if (_call_js_cb != nullptr) {
+      _call_js_cb(_env, js_callback, _context, data);
+    } else if (js_callback != nullptr) {
+      napi_value recv =
+          v8impl::JsValueFromV8LocalValue(v8::Undefined(isolate));
+      napi_call_function(_env, recv, js_callback, 0, nullptr, nullptr);
+    }
+
+    if (!_env->last_exception.IsEmpty()) {
+      v8::TryCatch try_catch(isolate);
+      isolate->ThrowException(
+          v8::Local<v8::Value>::New(isolate, _env->last_exception));
+      _env->last_exception.Reset();
+      node::FatalException(isolate, try_catch);
+    }
+  }
+
+  // Hands data that will never be dispatched back to the addon so that it
+  // can be freed.
+  void DrainAborted(std::queue<void*>* batch) {
+    while (!batch->empty()) {
+      void* data = batch->front();
+      batch->pop();
+      if (_call_js_cb != nullptr) {
+        _call_js_cb(nullptr, nullptr, _context, data);
+      }
+    }
+  }
+
+  void Close() {
+    uv_close(Handle(), HandleClosedCallback);
+  }
+
+  static void HandleClosedCallback(uv_handle_t* handle) {
+    ThreadSafeFunction* func = static_cast<ThreadSafeFunction*>(handle->data);
+
+    if (func->_finalize_cb != nullptr) {
+      v8::HandleScope scope(func->_env->isolate);
+      func->_finalize_cb(func->_env, func->_finalize_data, func->_context);
+    }
+
+    Delete(func);
+  }
+
+  napi_env _env;
+  node::Mutex _mutex;
+  node::ConditionVariable _cond;
+  std::queue<void*> _queue;
+  uv_async_t _async;
+  size_t _max_queue_size;
+  size_t _thread_count;
+  bool _is_closing;
+  v8::Persistent<v8::Function> _function;
+  void* _finalize_data;
+  napi_finalize _finalize_cb;
+  void* _context;
+  napi_threadsafe_function_call_js _call_js_cb;
 };
 
 }  // end of namespace uvimpl
@@ -2754,10 +4187,41 @@ napi_status napi_queue_async_work(napi_env env, napi_async_work work) {
 
   uvimpl::Work* w = reinterpret_cast<uvimpl::Work*>(work);
 
-  CALL_UV(env, uv_queue_work(event_loop,
-                             w->Request(),
-                             uvimpl::Work::ExecuteCallback,
-                             uvimpl::Work::CompleteCallback));
+  // The work traces itself, under the node.threadpool category alone.
+  w->TraceQueued();
+  CALL_UV(env, node::threadpool::QueueWork(event_loop,
+                                           w->Request(),
+                                           node::threadpool::kFsWork,
+                                           w->GetPriority(),
+                                           uvimpl::Work::ExecuteCallback,
+                                           uvimpl::Work::CompleteCallback,
+                                           nullptr,
+                                           nullptr));
+
+  return napi_ok;
+}
+
+napi_status napi_set_async_work_priority(napi_env env,
+                                         napi_async_work work,
+                                         napi_async_priority priority) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, work);
+
+  uvimpl::Work* w = reinterpret_cast<uvimpl::Work*>(work);
+
+  switch (priority) {
+    case napi_async_priority_high:
+      w->SetPriority(node::threadpool::kHighPriority);
+      break;
+    case napi_async_priority_normal:
+      w->SetPriority(node::threadpool::kNormalPriority);
+      break;
+    case napi_async_priority_bulk:
+      w->SetPriority(node::threadpool::kLowPriority);
+      break;
+    default:
+      return napi_set_last_error(env, napi_invalid_arg);
+  }
 
   return napi_ok;
 }
@@ -2768,7 +4232,236 @@ napi_status napi_cancel_async_work(napi_env env, napi_async_work work) {
 
   uvimpl::Work* w = reinterpret_cast<uvimpl::Work*>(work);
 
-  CALL_UV(env, uv_cancel(reinterpret_cast<uv_req_t*>(w->Request())));
+  if (w->GetExecutor() != nullptr) {
+    CALL_UV(env, w->GetExecutor()->Cancel(w));
+  } else {
+    uv_loop_t* event_loop =
+      node::Environment::GetCurrent(env->isolate)->event_loop();
+    CALL_UV(env, node::threadpool::CancelWork(event_loop, w->Request()));
+  }
+
+  return napi_ok;
+}
+
+napi_status napi_create_executor(napi_env env,
+                                 size_t thread_count,
+                                 napi_executor* result) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, result);
+  RETURN_STATUS_IF_FALSE(env, thread_count > 0, napi_invalid_arg);
+
+  uv_loop_t* event_loop =
+    node::Environment::GetCurrent(env->isolate)->event_loop();
+
+  uvimpl::Executor* executor = uvimpl::Executor::New(thread_count);
+
+  int uv_result = executor->Init(event_loop);
+  if (uv_result != 0) {
+    uvimpl::Executor::Delete(executor);
+    return napi_set_last_error(env,
+                               uvimpl::ConvertUVErrorCode(uv_result),
+                               uv_result);
+  }
+
+  *result = reinterpret_cast<napi_executor>(executor);
+
+  return napi_ok;
+}
+
+napi_status napi_delete_executor(napi_env env, napi_executor executor) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, executor);
+
+  reinterpret_cast<uvimpl::Executor*>(executor)->Shutdown();
+
+  return napi_ok;
+}
+
+napi_status napi_queue_async_work_on_executor(napi_env env,
+                                              napi_executor executor,
+                                              napi_async_work work) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, executor);
+  CHECK_ARG(env, work);
+
+  reinterpret_cast<uvimpl::Executor*>(executor)->Queue(
+      reinterpret_cast<uvimpl::Work*>(work));
+
+  return napi_ok;
+}
+
+napi_status napi_create_threadsafe_function(
+    napi_env env,
+    napi_value func,
+    size_t max_queue_size,
+    size_t initial_thread_count,
+    void* thread_finalize_data,
+    napi_finalize thread_finalize_cb,
+    void* context,
+    napi_threadsafe_function_call_js call_js_cb,
+    napi_threadsafe_function* result) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, result);
+  RETURN_STATUS_IF_FALSE(env, initial_thread_count > 0, napi_invalid_arg);
+
+  v8::Local<v8::Function> v8func;
+  if (func == nullptr) {
+    CHECK_ARG(env, call_js_cb);
+  } else {
+    v8::Local<v8::Value> v8value = v8impl::V8LocalValueFromJsValue(func);
+    RETURN_STATUS_IF_FALSE(env, v8value->IsFunction(), napi_function_expected);
+    v8func = v8value.As<v8::Function>();
+  }
+
+  uv_loop_t* event_loop =
+    node::Environment::GetCurrent(env->isolate)->event_loop();
+
+  uvimpl::ThreadSafeFunction* ts_func = uvimpl::ThreadSafeFunction::New(
+      env, v8func, max_queue_size, initial_thread_count,
+      thread_finalize_data, thread_finalize_cb, context, call_js_cb);
+
+  int uv_result = ts_func->Init(event_loop);
+  if (uv_result != 0) {
+    uvimpl::ThreadSafeFunction::Delete(ts_func);
+    return napi_set_last_error(env,
+                               uvimpl::ConvertUVErrorCode(uv_result),
+                               uv_result);
+  }
+
+  *result = reinterpret_cast<napi_threadsafe_function>(ts_func);
+
+  return napi_ok;
+}
+
+napi_status napi_get_threadsafe_function_context(napi_threadsafe_function func,
+                                                 void** result) {
+  if (func == nullptr || result == nullptr) {
+    return napi_invalid_arg;
+  }
+
+  *result = reinterpret_cast<uvimpl::ThreadSafeFunction*>(func)->Context();
+  return napi_ok;
+}
+
+napi_status napi_call_threadsafe_function(
+    napi_threadsafe_function func,
+    void* data,
+    napi_threadsafe_function_call_mode is_blocking) {
+  if (func == nullptr) {
+    return napi_invalid_arg;
+  }
+
+  return reinterpret_cast<uvimpl::ThreadSafeFunction*>(func)->Push(
+      data, is_blocking);
+}
+
+napi_status napi_acquire_threadsafe_function(napi_threadsafe_function func) {
+  if (func == nullptr) {
+    return napi_invalid_arg;
+  }
+
+  return reinterpret_cast<uvimpl::ThreadSafeFunction*>(func)->Acquire();
+}
+
+napi_status napi_release_threadsafe_function(
+    napi_threadsafe_function func,
+    napi_threadsafe_function_release_mode mode) {
+  if (func == nullptr) {
+    return napi_invalid_arg;
+  }
+
+  return reinterpret_cast<uvimpl::ThreadSafeFunction*>(func)->Release(mode);
+}
+
+napi_status napi_unref_threadsafe_function(napi_env env,
+                                           napi_threadsafe_function func) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, func);
+
+  uv_unref(reinterpret_cast<uvimpl::ThreadSafeFunction*>(func)->Handle());
+
+  return napi_ok;
+}
+
+napi_status napi_ref_threadsafe_function(napi_env env,
+                                         napi_threadsafe_function func) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, func);
+
+  uv_ref(reinterpret_cast<uvimpl::ThreadSafeFunction*>(func)->Handle());
+
+  return napi_ok;
+}
+
+napi_status napi_create_promise(napi_env env,
+                                napi_deferred* deferred,
+                                napi_value* promise) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, deferred);
+  CHECK_ARG(env, promise);
+
+  auto maybe = v8::Promise::Resolver::New(env->isolate->GetCurrentContext());
+  CHECK_MAYBE_EMPTY(env, maybe, napi_generic_failure);
+
+  v8::Local<v8::Promise::Resolver> v8_resolver = maybe.ToLocalChecked();
+  auto v8_deferred = new v8::Persistent<v8::Value>();
+  v8_deferred->Reset(env->isolate, v8_resolver);
+
+  *deferred = v8impl::JsDeferredFromV8Persistent(v8_deferred);
+  *promise = v8impl::JsValueFromV8LocalValue(v8_resolver->GetPromise());
+  return GET_RETURN_STATUS(env);
+}
+
+static napi_status ConcludeDeferred(napi_env env,
+                                    napi_deferred deferred,
+                                    napi_value result,
+                                    bool is_resolved) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, deferred);
+  CHECK_ARG(env, result);
+
+  v8::Local<v8::Context> context = env->isolate->GetCurrentContext();
+  v8::Persistent<v8::Value>* v8_deferred =
+      v8impl::V8PersistentFromJsDeferred(deferred);
+  v8::Local<v8::Value> v8_value =
+      v8::Local<v8::Value>::New(env->isolate, *v8_deferred);
+  v8::Local<v8::Promise::Resolver> v8_resolver =
+      v8_value.As<v8::Promise::Resolver>();
+
+  v8::Maybe<bool> success = is_resolved ?
+      v8_resolver->Resolve(context, v8impl::V8LocalValueFromJsValue(result)) :
+      v8_resolver->Reject(context, v8impl::V8LocalValueFromJsValue(result));
+
+  v8_deferred->Reset();
+  delete v8_deferred;
+
+  RETURN_STATUS_IF_FALSE(env, success.FromMaybe(false), napi_generic_failure);
+
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_resolve_deferred(napi_env env,
+                                  napi_deferred deferred,
+                                  napi_value resolution) {
+  return ConcludeDeferred(env, deferred, resolution, true);
+}
+
+napi_status napi_reject_deferred(napi_env env,
+                                 napi_deferred deferred,
+                                 napi_value rejection) {
+  return ConcludeDeferred(env, deferred, rejection, false);
+}
+
+napi_status napi_is_promise(napi_env env,
+                            napi_value promise,
+                            bool* is_promise) {
+  // Omit NAPI_PREAMBLE and GET_RETURN_STATUS because V8 calls here cannot
+  // throw JS exceptions.
+  CHECK_ENV(env);
+  CHECK_ARG(env, promise);
+  CHECK_ARG(env, is_promise);
+
+  *is_promise = v8impl::V8LocalValueFromJsValue(promise)->IsPromise();
 
   return napi_ok;
 }
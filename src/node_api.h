@@ -14,6 +14,8 @@
 #include <stdbool.h>
 #include "node_api_types.h"
 
+struct uv_loop_s;  // Forward declaration.
+
 #ifdef _WIN32
   #ifdef BUILDING_NODE_EXTENSION
     #ifdef EXTERNAL_NAPI
@@ -133,6 +135,23 @@ NAPI_EXTERN napi_status napi_create_string_utf16(napi_env env,
                                                  const char16_t* str,
                                                  size_t length,
                                                  napi_value* result);
+// Create strings that reference addon-owned data instead of copying it into
+// the VM heap. The data must remain valid and unchanged until finalize_cb
+// is invoked. Pass -1 as the length for null-terminated data.
+NAPI_EXTERN napi_status
+napi_create_external_string_latin1(napi_env env,
+                                   char* str,
+                                   size_t length,
+                                   napi_finalize finalize_cb,
+                                   void* finalize_hint,
+                                   napi_value* result);
+NAPI_EXTERN napi_status
+napi_create_external_string_utf16(napi_env env,
+                                  char16_t* str,
+                                  size_t length,
+                                  napi_finalize finalize_cb,
+                                  void* finalize_hint,
+                                  napi_value* result);
 NAPI_EXTERN napi_status napi_create_symbol(napi_env env,
                                            napi_value description,
                                            napi_value* result);
@@ -243,6 +262,50 @@ NAPI_EXTERN napi_status napi_get_named_property(napi_env env,
                                           napi_value object,
                                           const char* utf8name,
                                           napi_value* result);
+// Bulk variants of the property methods above. These perform a single
+// status round-trip for the whole batch, and are faster than setting or
+// getting the properties one at a time.
+NAPI_EXTERN napi_status
+napi_create_object_with_named_properties(napi_env env,
+                                         size_t property_count,
+                                         const char* const* utf8names,
+                                         const napi_value* values,
+                                         napi_value* result);
+NAPI_EXTERN napi_status napi_get_properties(napi_env env,
+                                            napi_value object,
+                                            size_t property_count,
+                                            const napi_value* keys,
+                                            napi_value* results);
+NAPI_EXTERN napi_status napi_get_named_properties(napi_env env,
+                                                  napi_value object,
+                                                  size_t property_count,
+                                                  const char* const* utf8names,
+                                                  napi_value* results);
+
+// Methods to work with atoms: internalized property keys that are created
+// once and live as long as the napi_env. Creating an atom for a name that
+// already has one returns the existing atom. Pass -1 as the length for a
+// null-terminated name.
+NAPI_EXTERN napi_status napi_create_atom(napi_env env,
+                                         const char* utf8name,
+                                         size_t length,
+                                         napi_atom* result);
+NAPI_EXTERN napi_status napi_get_atom_value(napi_env env,
+                                            napi_atom atom,
+                                            napi_value* result);
+NAPI_EXTERN napi_status napi_set_atom_property(napi_env env,
+                                               napi_value object,
+                                               napi_atom atom,
+                                               napi_value value);
+NAPI_EXTERN napi_status napi_has_atom_property(napi_env env,
+                                               napi_value object,
+                                               napi_atom atom,
+                                               bool* result);
+NAPI_EXTERN napi_status napi_get_atom_property(napi_env env,
+                                               napi_value object,
+                                               napi_atom atom,
+                                               napi_value* result);
+
 NAPI_EXTERN napi_status napi_set_element(napi_env env,
                                          napi_value object,
                                          uint32_t index,
@@ -269,6 +332,29 @@ NAPI_EXTERN napi_status napi_get_array_length(napi_env env,
                                               napi_value value,
                                               uint32_t* result);
 
+// Bulk conversion between JS arrays of numbers and native buffers. The
+// getters copy up to bufsize leading elements and fail with
+// napi_number_expected if one of them is not a number. The result argument
+// is optional and receives the number of elements copied.
+NAPI_EXTERN napi_status napi_get_array_elements_double(napi_env env,
+                                                       napi_value array,
+                                                       double* buf,
+                                                       size_t bufsize,
+                                                       size_t* result);
+NAPI_EXTERN napi_status napi_get_array_elements_int32(napi_env env,
+                                                      napi_value array,
+                                                      int32_t* buf,
+                                                      size_t bufsize,
+                                                      size_t* result);
+NAPI_EXTERN napi_status napi_create_array_from_double(napi_env env,
+                                                      const double* values,
+                                                      size_t length,
+                                                      napi_value* result);
+NAPI_EXTERN napi_status napi_create_array_from_int32(napi_env env,
+                                                     const int32_t* values,
+                                                     size_t length,
+                                                     napi_value* result);
+
 // Methods to compare values
 NAPI_EXTERN napi_status napi_strict_equals(napi_env env,
                                            napi_value lhs,
@@ -292,14 +378,33 @@ NAPI_EXTERN napi_status napi_instanceof(napi_env env,
                                         napi_value constructor,
                                         bool* result);
 
-// Napi version of node::MakeCallback(...)
+// Napi version of node::MakeCallback(...). If |async_context| is not NULL,
+// the callback runs in it, with the async hooks before and after it that
+// the callbacks of core's own handles get.
 NAPI_EXTERN napi_status napi_make_callback(napi_env env,
+                                           napi_async_context async_context,
                                            napi_value recv,
                                            napi_value func,
                                            size_t argc,
                                            const napi_value* argv,
                                            napi_value* result);
 
+// Methods for addons that run handles of their own, like a uv_poll_t for a
+// socket, on the loop of the env.
+NAPI_EXTERN napi_status napi_get_uv_event_loop(napi_env env,
+                                               struct uv_loop_s** loop);
+
+// Creates the async context that the callbacks of such a handle are made
+// in, which the async hooks see as an async resource of its own from
+// creation until napi_async_destroy(). |async_resource| may be NULL, or the
+// object that the context is for, which the hooks then find as the `owner`
+// of the resource.
+NAPI_EXTERN napi_status napi_async_init(napi_env env,
+                                        napi_value async_resource,
+                                        napi_async_context* result);
+NAPI_EXTERN napi_status napi_async_destroy(napi_env env,
+                                           napi_async_context async_context);
+
 // Methods to work with napi_callbacks
 
 // Gets all callback info in a single call. (Ugly, but faster.)
@@ -312,6 +417,13 @@ NAPI_EXTERN napi_status napi_get_cb_info(
     napi_value* this_arg,  // [out] Receives the JS 'this' arg for the call
     void** data);          // [out] Receives the data pointer for the callback.
 
+// Gets a single argument without copying the argument list. The result is
+// undefined if the index is past the end of the arguments.
+NAPI_EXTERN napi_status napi_get_cb_arg(napi_env env,
+                                        napi_callback_info cbinfo,
+                                        size_t index,
+                                        napi_value* result);
+
 NAPI_EXTERN napi_status napi_is_construct_call(napi_env env,
                                                napi_callback_info cbinfo,
                                                bool* result);
@@ -379,6 +491,25 @@ NAPI_EXTERN napi_status napi_get_reference_value(napi_env env,
                                                  napi_ref ref,
                                                  napi_value* result);
 
+// Controls when the finalize callbacks of objects owned by this env run.
+// Deferring them moves native cleanup out of garbage collection pauses, at
+// the cost of holding on to native memory until the loop is idle.
+NAPI_EXTERN napi_status napi_set_finalize_mode(napi_env env,
+                                               napi_finalize_mode mode);
+
+// Tells the garbage collector about native memory that JavaScript objects
+// keep alive, so that it is collected sooner when that grows. The change may
+// be negative. |adjusted_value| receives the total that is reported.
+NAPI_EXTERN napi_status napi_adjust_external_memory(napi_env env,
+                                                    int64_t change_in_bytes,
+                                                    int64_t* adjusted_value);
+
+// Makes napi_create_external_buffer() and napi_create_external_arraybuffer()
+// report the memory of the buffers that they create from then on, until the
+// buffers are finalized, as napi_adjust_external_memory() would.
+NAPI_EXTERN napi_status napi_set_external_memory_reporting(napi_env env,
+                                                           bool enabled);
+
 NAPI_EXTERN napi_status napi_open_handle_scope(napi_env env,
                                                napi_handle_scope* result);
 NAPI_EXTERN napi_status napi_close_handle_scope(napi_env env,
@@ -469,6 +600,39 @@ NAPI_EXTERN napi_status napi_get_typedarray_info(napi_env env,
                                                  napi_value* arraybuffer,
                                                  size_t* byte_offset);
 
+// Methods to hand out Buffers that are views into one block of addon-owned
+// memory, like the slots of a ring, without a finalizer per Buffer. A view
+// pins its part of the region until the addon calls
+// napi_release_buffer_view() for it, exactly once, which passes the part back
+// to release_cb so that it can be reused. The views must not be used from
+// JavaScript after that.
+//
+// The region can only be deleted once all of its views have been released.
+// finalize_cb is called for the memory when the region has been deleted and
+// no Buffer refers to it any more.
+NAPI_EXTERN napi_status
+napi_create_buffer_region(napi_env env,
+                          void* data,
+                          size_t byte_length,
+                          napi_buffer_view_release release_cb,
+                          napi_finalize finalize_cb,
+                          void* hint,
+                          napi_buffer_region* result);
+NAPI_EXTERN napi_status napi_delete_buffer_region(napi_env env,
+                                                  napi_buffer_region region);
+NAPI_EXTERN napi_status napi_create_buffer_view(napi_env env,
+                                                napi_buffer_region region,
+                                                size_t byte_offset,
+                                                size_t length,
+                                                napi_value* result);
+NAPI_EXTERN napi_status napi_release_buffer_view(napi_env env,
+                                                 napi_buffer_region region,
+                                                 napi_value view);
+// The number of views of the region that have not been released yet.
+NAPI_EXTERN napi_status napi_get_buffer_region_pinned(napi_env env,
+                                                      napi_buffer_region region,
+                                                      size_t* result);
+
 // Methods to manage simple async operations
 NAPI_EXTERN
 napi_status napi_create_async_work(napi_env env,
@@ -482,6 +646,88 @@ NAPI_EXTERN napi_status napi_queue_async_work(napi_env env,
                                               napi_async_work work);
 NAPI_EXTERN napi_status napi_cancel_async_work(napi_env env,
                                                napi_async_work work);
+// Work is napi_async_priority_normal unless set otherwise before it is
+// queued. Executors ignore the priority.
+NAPI_EXTERN
+napi_status napi_set_async_work_priority(napi_env env,
+                                         napi_async_work work,
+                                         napi_async_priority priority);
+
+// Methods to run async work on a dedicated pool of threads instead of the
+// shared libuv threadpool
+NAPI_EXTERN napi_status napi_create_executor(napi_env env,
+                                             size_t thread_count,
+                                             napi_executor* result);
+// Waits for running work to finish. Work that has not started yet completes
+// with napi_cancelled.
+NAPI_EXTERN napi_status napi_delete_executor(napi_env env,
+                                             napi_executor executor);
+NAPI_EXTERN
+napi_status napi_queue_async_work_on_executor(napi_env env,
+                                              napi_executor executor,
+                                              napi_async_work work);
+
+// Methods to call into JavaScript from arbitrary threads.
+// A thread-safe function collects calls made from any thread into a queue
+// that is drained in batches on the loop thread. If max_queue_size is 0 the
+// queue is unbounded; otherwise napi_tsfn_blocking calls wait for space and
+// napi_tsfn_nonblocking calls fail with napi_queue_full.
+NAPI_EXTERN napi_status
+napi_create_threadsafe_function(napi_env env,
+                                napi_value func,
+                                size_t max_queue_size,
+                                size_t initial_thread_count,
+                                void* thread_finalize_data,
+                                napi_finalize thread_finalize_cb,
+                                void* context,
+                                napi_threadsafe_function_call_js call_js_cb,
+                                napi_threadsafe_function* result);
+
+// The functions below, with the exception of napi_ref_threadsafe_function()
+// and napi_unref_threadsafe_function(), may be called from any thread.
+NAPI_EXTERN napi_status
+napi_get_threadsafe_function_context(napi_threadsafe_function func,
+                                     void** result);
+
+NAPI_EXTERN napi_status
+napi_call_threadsafe_function(napi_threadsafe_function func,
+                              void* data,
+                              napi_threadsafe_function_call_mode is_blocking);
+
+NAPI_EXTERN napi_status
+napi_acquire_threadsafe_function(napi_threadsafe_function func);
+
+// Once every thread that acquired the function has released it, remaining
+// queued calls are dispatched, the function is finalized and the handle
+// becomes invalid. napi_tsfn_abort skips the remaining calls; their data is
+// passed to call_js_cb with a NULL env so that it can be freed.
+NAPI_EXTERN napi_status
+napi_release_threadsafe_function(napi_threadsafe_function func,
+                                 napi_threadsafe_function_release_mode mode);
+
+NAPI_EXTERN napi_status
+napi_unref_threadsafe_function(napi_env env, napi_threadsafe_function func);
+
+NAPI_EXTERN napi_status
+napi_ref_threadsafe_function(napi_env env, napi_threadsafe_function func);
+
+// Methods to work with promises.
+// napi_create_promise() returns a promise together with the deferred that
+// settles it. The deferred is freed by napi_resolve_deferred() or
+// napi_reject_deferred(), exactly one of which must be called for it, for
+// instance from the complete callback of async work.
+NAPI_EXTERN napi_status napi_create_promise(napi_env env,
+                                            napi_deferred* deferred,
+                                            napi_value* promise);
+NAPI_EXTERN napi_status napi_resolve_deferred(napi_env env,
+                                              napi_deferred deferred,
+                                              napi_value resolution);
+NAPI_EXTERN napi_status napi_reject_deferred(napi_env env,
+                                             napi_deferred deferred,
+                                             napi_value rejection);
+NAPI_EXTERN napi_status napi_is_promise(napi_env env,
+                                        napi_value promise,
+                                        bool* is_promise);
 
 EXTERN_C_END
 
@@ -13,10 +13,16 @@
 typedef struct napi_env__ *napi_env;
 typedef struct napi_value__ *napi_value;
 typedef struct napi_ref__ *napi_ref;
+typedef struct napi_atom__ *napi_atom;
 typedef struct napi_handle_scope__ *napi_handle_scope;
 typedef struct napi_escapable_handle_scope__ *napi_escapable_handle_scope;
 typedef struct napi_callback_info__ *napi_callback_info;
 typedef struct napi_async_work__ *napi_async_work;
+typedef struct napi_executor__ *napi_executor;
+typedef struct napi_threadsafe_function__ *napi_threadsafe_function;
+typedef struct napi_deferred__ *napi_deferred;
+typedef struct napi_async_context__ *napi_async_context;
+typedef struct napi_buffer_region__ *napi_buffer_region;
 
 typedef enum {
   napi_default = 0,
@@ -67,9 +73,40 @@ typedef enum {
   napi_generic_failure,
   napi_pending_exception,
   napi_cancelled,
+  napi_queue_full,
+  napi_closing,
   napi_status_last
 } napi_status;
 
+typedef enum {
+  // Finalizers run synchronously inside the garbage collector's weak
+  // callbacks. They must not call into JavaScript.
+  napi_finalize_sync,
+  // Finalizers are queued and run in batches on the loop thread, outside of
+  // garbage collection pauses.
+  napi_finalize_deferred
+} napi_finalize_mode;
+
+// The order in which napi_async_work queued on the shared libuv threadpool
+// is run. At most half of the threads of the pool run bulk work at a time,
+// so that work that something is waiting on can get to a thread without
+// waiting for all of the bulk work queued before it.
+typedef enum {
+  napi_async_priority_high,
+  napi_async_priority_normal,
+  napi_async_priority_bulk
+} napi_async_priority;
+
+typedef enum {
+  napi_tsfn_release,
+  napi_tsfn_abort
+} napi_threadsafe_function_release_mode;
+
+typedef enum {
+  napi_tsfn_nonblocking,
+  napi_tsfn_blocking
+} napi_threadsafe_function_call_mode;
+
 typedef napi_value (*napi_callback)(napi_env env,
                                     napi_callback_info info);
 typedef void (*napi_finalize)(napi_env env,
@@ -80,6 +117,15 @@ typedef void (*napi_async_execute_callback)(napi_env env,
 typedef void (*napi_async_complete_callback)(napi_env env,
                                              napi_status status,
                                              void* data);
+typedef void (*napi_threadsafe_function_call_js)(napi_env env,
+                                                 napi_value js_callback,
+                                                 void* context,
+                                                 void* data);
+typedef void (*napi_buffer_view_release)(napi_env env,
+                                         void* region_data,
+                                         size_t byte_offset,
+                                         size_t length,
+                                         void* hint);
 
 typedef struct {
   // One of utf8name or name should be NULL.
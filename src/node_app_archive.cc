@@ -0,0 +1,141 @@
+#include "node.h"
+#include "env.h"
+#include "env-inl.h"
+#include "util.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace node {
+namespace app_archive {
+
+using v8::ArrayBuffer;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::Local;
+using v8::NewStringType;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+// The mappings are never undone: the sources of the modules that were loaded
+// from an archive are external strings that point into it.
+class MappedSource : public String::ExternalOneByteStringResource {
+ public:
+  MappedSource(const char* data, size_t length)
+      : data_(data), length_(length) {}
+  const char* data() const override { return data_; }
+  size_t length() const override { return length_; }
+
+ private:
+  const char* const data_;
+  const size_t length_;
+};
+
+
+// Maps |fd| copy-on-write, so that writes through the ArrayBuffer don't fault
+// and don't reach the file. Returns nullptr on failure.
+static void* MapFile(uv_file fd, size_t length) {
+#ifdef _WIN32
+  HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  HANDLE mapping =
+      CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (mapping == nullptr)
+    return nullptr;
+  void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, length);
+  CloseHandle(mapping);
+  return data;
+#else
+  void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                    0);
+  return data == MAP_FAILED ? nullptr : data;
+#endif
+}
+
+
+// map(path) maps the archive at |path| into memory and returns an
+// ArrayBuffer of it. Throws if the file can't be opened or mapped.
+static void Map(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(env->isolate(), args[0]);
+
+  uv_fs_t req;
+  const int fd = uv_fs_open(nullptr, &req, *path, O_RDONLY, 0, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0)
+    return env->ThrowUVException(fd, "open", nullptr, *path);
+
+  int err = uv_fs_fstat(nullptr, &req, fd, nullptr);
+  const size_t length = static_cast<size_t>(req.statbuf.st_size);
+  uv_fs_req_cleanup(&req);
+  void* data = nullptr;
+  if (err == 0 && length > 0) {
+    data = MapFile(fd, length);
+    if (data == nullptr)
+      err = UV_ENOMEM;
+  }
+  uv_fs_close(nullptr, &req, fd, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err != 0)
+    return env->ThrowUVException(err, "mmap", nullptr, *path);
+
+  args.GetReturnValue().Set(ArrayBuffer::New(env->isolate(), data, length));
+}
+
+
+// source(buffer, offset, length) returns the UTF-8 text at |offset| of
+// |buffer|, an ArrayBuffer that map() returned. ASCII text, which most
+// JavaScript is, is not copied onto the V8 heap.
+static void Source(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsArrayBuffer());
+  CHECK(args[1]->IsUint32());
+  CHECK(args[2]->IsUint32());
+  ArrayBuffer::Contents contents = args[0].As<ArrayBuffer>()->GetContents();
+  const size_t offset = args[1].As<v8::Uint32>()->Value();
+  const size_t length = args[2].As<v8::Uint32>()->Value();
+  CHECK_LE(offset, contents.ByteLength());
+  CHECK_LE(length, contents.ByteLength() - offset);
+  const char* data = static_cast<const char*>(contents.Data()) + offset;
+
+  bool ascii = true;
+  for (size_t i = 0; i < length && ascii; i++)
+    ascii = (data[i] & 0x80) == 0;
+
+  Local<String> source;
+  if (ascii && length > 0) {
+    MappedSource* resource = new MappedSource(data, length);
+    if (!String::NewExternalOneByte(env->isolate(), resource)
+             .ToLocal(&source)) {
+      delete resource;
+      return;
+    }
+  } else if (!String::NewFromUtf8(env->isolate(), data, NewStringType::kNormal,
+                                  length).ToLocal(&source)) {
+    return;
+  }
+  args.GetReturnValue().Set(source);
+}
+
+
+static void Initialize(Local<Object> target,
+                       Local<Value> unused,
+                       Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  env->SetMethod(target, "map", Map);
+  env->SetMethod(target, "source", Source);
+}
+
+}  // namespace app_archive
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(app_archive, node::app_archive::Initialize)
@@ -22,6 +22,8 @@
 #include "node.h"
 #include "node_buffer.h"
 
+#include "base-object.h"
+#include "base-object-inl.h"
 #include "env.h"
 #include "env-inl.h"
 #include "string_bytes.h"
@@ -33,6 +35,7 @@
 
 #include <string.h>
 #include <limits.h>
+#include <vector>
 
 #define BUFFER_ID 0xB0E4
 
@@ -64,24 +67,56 @@ inline void* BufferMalloc(size_t length) {
                                  node::UncheckedMalloc(length);
 }
 
+// For memory that is handed to V8 and freed by the isolate's allocator. When
+// node created that allocator, small buffers come out of its BufferArena.
+inline void* BufferMalloc(Environment* env,
+                          size_t length,
+                          bool zero_fill = zero_fill_all_buffers) {
+  ArrayBufferAllocator* allocator = env->isolate_data()->allocator();
+  if (allocator == nullptr) {
+    return zero_fill ? node::UncheckedCalloc(length) :
+                       node::UncheckedMalloc(length);
+  }
+  void* data = allocator->AllocateUninitialized(length);
+  if (data != nullptr && zero_fill)
+    memset(data, 0, length);
+  return data;
+}
+
+inline void BufferFree(Environment* env, void* data, size_t length) {
+  ArrayBufferAllocator* allocator = env->isolate_data()->allocator();
+  if (allocator == nullptr)
+    free(data);
+  else
+    allocator->Free(data, length);
+}
+
+// The longest string, in UTF-16 code units, that Buffer::New() transcodes to
+// UTF-8 without measuring it first.
+const size_t kMaxUtf8OverAllocation = 8 * 1024 * 1024;
+
 }  // namespace
 
 namespace Buffer {
 
+using v8::Array;
 using v8::ArrayBuffer;
 using v8::ArrayBufferCreationMode;
 using v8::ArrayBufferView;
 using v8::Context;
 using v8::EscapableHandleScope;
 using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
 using v8::Maybe;
 using v8::MaybeLocal;
+using v8::Number;
 using v8::Object;
 using v8::Persistent;
 using v8::String;
+using v8::Uint32;
 using v8::Uint32Array;
 using v8::Uint8Array;
 using v8::Value;
@@ -243,7 +278,18 @@ MaybeLocal<Object> New(Isolate* isolate,
                        enum encoding enc) {
   EscapableHandleScope scope(isolate);
 
-  const size_t length = StringBytes::Size(isolate, string, enc);
+  // UTF-8 is written in a single pass into room for the longest result, two
+  // bytes per character of a one byte string and three per UTF-16 code unit
+  // otherwise, and shrunk to fit afterwards. Measuring it first would walk the
+  // string twice. Very long strings are still measured, so as not to allocate
+  // several times the memory that they need.
+  size_t length;
+  if ((enc == UTF8 || enc == BUFFER) &&
+      static_cast<size_t>(string->Length()) <= kMaxUtf8OverAllocation) {
+    length = string->Length() * (string->IsOneByte() ? 2 : 3);
+  } else {
+    length = StringBytes::Size(isolate, string, enc);
+  }
   size_t actual = 0;
   char* data = nullptr;
 
@@ -293,7 +339,7 @@ MaybeLocal<Object> New(Environment* env, size_t length) {
 
   void* data;
   if (length > 0) {
-    data = BufferMalloc(length);
+    data = BufferMalloc(env, length);
     if (data == nullptr)
       return Local<Object>();
   } else {
@@ -312,7 +358,7 @@ MaybeLocal<Object> New(Environment* env, size_t length) {
     return scope.Escape(ui);
 
   // Object failed to be created. Clean up resources.
-  free(data);
+  BufferFree(env, data, length);
   return Local<Object>();
 }
 
@@ -338,7 +384,7 @@ MaybeLocal<Object> Copy(Environment* env, const char* data, size_t length) {
   void* new_data;
   if (length > 0) {
     CHECK_NE(data, nullptr);
-    new_data = node::UncheckedMalloc(length);
+    new_data = BufferMalloc(env, length, false);
     if (new_data == nullptr)
       return Local<Object>();
     memcpy(new_data, data, length);
@@ -358,7 +404,7 @@ MaybeLocal<Object> Copy(Environment* env, const char* data, size_t length) {
     return scope.Escape(ui);
 
   // Object failed to be created. Clean up resources.
-  free(new_data);
+  BufferFree(env, new_data, length);
   return Local<Object>();
 }
 
@@ -452,6 +498,31 @@ void CreateFromString(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// createUnsafeArrayBuffer(size) returns an ArrayBuffer of |size| bytes that
+// are not zero-filled, unless --zero-fill-buffers is on. Unlike turning off
+// zeroFill around `new ArrayBuffer()`, that leaves the allocator's state
+// alone. Sizes beyond BufferArena::kMaxSize come from malloc() either way,
+// and the zero-filled ones from calloc(), which gets fresh pages that are
+// already zero from the system for allocations that large.
+void CreateUnsafeArrayBuffer(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsNumber());
+  const double length = args[0].As<Number>()->Value();
+  if (!(length >= 0 && length <= kMaxLength))
+    return env->ThrowRangeError("Invalid array buffer length");
+
+  const size_t size = static_cast<size_t>(length);
+  void* data = BufferMalloc(env, size);
+  if (data == nullptr)
+    return env->ThrowRangeError("Array buffer allocation failed");
+  args.GetReturnValue().Set(
+      ArrayBuffer::New(env->isolate(),
+                       data,
+                       size,
+                       ArrayBufferCreationMode::kInternalized));
+}
+
+
 template <encoding encoding>
 void StringSlice(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -485,34 +556,26 @@ void StringSlice<UCS2>(const FunctionCallbackInfo<Value>& args) {
 
   const char* data = ts_obj_data + start;
   const uint16_t* buf;
-  bool release = false;
 
   // Node's "ucs2" encoding expects LE character data inside a Buffer, so we
   // need to reorder on BE platforms.  See http://nodejs.org/api/buffer.html
   // regarding Node's "ucs2" encoding specification.
+  MaybeStackBuffer<uint16_t> copy;
   const bool aligned = (reinterpret_cast<uintptr_t>(data) % sizeof(*buf) == 0);
   if (IsLittleEndian() && !aligned) {
     // Make a copy to avoid unaligned accesses in v8::String::NewFromTwoByte().
     // This applies ONLY to little endian platforms, as misalignment will be
     // handled by a byte-swapping operation in StringBytes::Encode on
-    // big endian platforms.
-    uint16_t* copy = new uint16_t[length];
-    for (size_t i = 0, k = 0; i < length; i += 1, k += 2) {
-      // Assumes that the input is little endian.
-      const uint8_t lo = static_cast<uint8_t>(data[k + 0]);
-      const uint8_t hi = static_cast<uint8_t>(data[k + 1]);
-      copy[i] = lo | hi << 8;
-    }
-    buf = copy;
-    release = true;
+    // big endian platforms. The bytes stay in the order they are in, so
+    // a memcpy() does it.
+    copy.AllocateSufficientStorage(length);
+    memcpy(*copy, data, length * sizeof(*buf));
+    buf = *copy;
   } else {
     buf = reinterpret_cast<const uint16_t*>(data);
   }
 
   args.GetReturnValue().Set(StringBytes::Encode(env->isolate(), buf, length));
-
-  if (release)
-    delete[] buf;
 }
 
 
@@ -584,6 +647,37 @@ void Copy(const FunctionCallbackInfo<Value> &args) {
 }
 
 
+// concat(list, target) copies the Uint8Arrays in |list| one after the other
+// into |target| until it is full, and returns the number of bytes copied, or
+// -1 if an element of |list| is not a Uint8Array.
+void Concat(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsArray());
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[1]);
+  Local<Array> list = args[0].As<Array>();
+  SPREAD_BUFFER_ARG(args[1], target);
+
+  const uint32_t count = list->Length();
+  size_t pos = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> value;
+    if (!list->Get(env->context(), i).ToLocal(&value))
+      return;
+    if (!value->IsUint8Array())
+      return args.GetReturnValue().Set(-1);
+    // Every element is checked, even once |target| is full.
+    if (pos == target_length)
+      continue;
+    SPREAD_BUFFER_ARG(value, chunk);
+    const size_t to_copy = MIN(chunk_length, target_length - pos);
+    memcpy(target_data + pos, chunk_data, to_copy);
+    pos += to_copy;
+  }
+  args.GetReturnValue().Set(static_cast<uint32_t>(pos));
+}
+
+
 void Fill(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -952,6 +1046,37 @@ void Compare(const FunctionCallbackInfo<Value> &args) {
 }
 
 
+// compareMany(buffer, list, results) stores what compare(buffer, list[i])
+// would return in the Int8Array |results|, for each element of |list|.
+// Returns false if an element is not a Uint8Array.
+void CompareMany(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsInt8Array());
+  SPREAD_BUFFER_ARG(args[0], obj_a);
+  Local<Array> list = args[1].As<Array>();
+  SPREAD_BUFFER_ARG(args[2], results);
+
+  const uint32_t count = list->Length();
+  CHECK_LE(count, results_length);
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> value;
+    if (!list->Get(env->context(), i).ToLocal(&value))
+      return;
+    if (!value->IsUint8Array())
+      return args.GetReturnValue().Set(false);
+    SPREAD_BUFFER_ARG(value, obj_b);
+    size_t cmp_length = MIN(obj_a_length, obj_b_length);
+    results_data[i] = static_cast<char>(normalizeCompareVal(
+        cmp_length > 0 ? memcmp(obj_a_data, obj_b_data, cmp_length) : 0,
+        obj_a_length, obj_b_length));
+  }
+  args.GetReturnValue().Set(true);
+}
+
+
 // Computes the offset for starting an indexOf or lastIndexOf search.
 // Returns either a valid offset in [0...<length - 1>], ie inside the Buffer,
 // or -1 to signal that there is no possible match.
@@ -1187,6 +1312,211 @@ void IndexOfNumber(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Searches many buffers for the same needle, see buffer.Searcher. The needle
+// is copied, and each direction keeps its own search object and shift
+// tables, so the tables are built for the first search and then reused.
+class Searcher : public BaseObject {
+ public:
+  Searcher(Environment* env,
+           Local<Object> object,
+           const char* needle,
+           size_t needle_length,
+           bool ucs2)
+      : BaseObject(env, object),
+        needle_length_(needle_length),
+        latin1_(nullptr),
+        ucs2_(nullptr) {
+    MakeWeak<Searcher>(this);
+    if (!ucs2)
+      latin1_ = new Needle<uint8_t>(needle, needle_length);
+    else if (needle_length >= 2)
+      ucs2_ = new Needle<uint16_t>(needle, needle_length / 2);
+  }
+
+  ~Searcher() override {
+    delete latin1_;
+    delete ucs2_;
+  }
+
+  // new Searcher(needle, ucs2)
+  static void New(const FunctionCallbackInfo<Value>& args);
+  // searcher.indexOf(buffer, byteOffset, isForward)
+  static void IndexOf(const FunctionCallbackInfo<Value>& args);
+  // searcher.findAll(buffer, limit) returns the offsets of the first |limit|
+  // matches that don't overlap, from the start of |buffer|.
+  static void FindAll(const FunctionCallbackInfo<Value>& args);
+
+ private:
+  template <typename Char>
+  class Needle {
+   public:
+    Needle(const char* data, size_t length)
+        : chars_(length),
+          forward_(Vector<const Char>(chars_.data(), length, true),
+                   &forward_tables_),
+          backward_(Vector<const Char>(chars_.data(), length, false),
+                    &backward_tables_) {
+      // |data| need not be aligned for Char.
+      memcpy(chars_.data(), data, length * sizeof(Char));
+    }
+
+    size_t Search(const Char* haystack,
+                  size_t haystack_length,
+                  size_t offset,
+                  bool is_forward) {
+      return SearchString(is_forward ? &forward_ : &backward_,
+                          haystack,
+                          haystack_length,
+                          chars_.size(),
+                          offset,
+                          is_forward);
+    }
+
+   private:
+    std::vector<Char> chars_;
+    stringsearch::StringSearchBase::Tables forward_tables_;
+    stringsearch::StringSearchBase::Tables backward_tables_;
+    StringSearch<Char> forward_;
+    StringSearch<Char> backward_;
+  };
+
+  // Returns the byte offset of the match, or |haystack_length| if there is
+  // none. |offset| is a byte offset within the haystack.
+  size_t Search(const char* haystack,
+                size_t haystack_length,
+                size_t offset,
+                bool is_forward) {
+    if ((is_forward && needle_length_ + offset > haystack_length) ||
+        needle_length_ > haystack_length) {
+      return haystack_length;
+    }
+    if (latin1_ != nullptr) {
+      return latin1_->Search(reinterpret_cast<const uint8_t*>(haystack),
+                             haystack_length,
+                             offset,
+                             is_forward);
+    }
+    if (ucs2_ != nullptr) {
+      size_t result = ucs2_->Search(reinterpret_cast<const uint16_t*>(haystack),
+                                    haystack_length / 2,
+                                    offset / 2,
+                                    is_forward);
+      if (result != haystack_length / 2)
+        return result * 2;
+    }
+    return haystack_length;
+  }
+
+  const size_t needle_length_;
+  Needle<uint8_t>* latin1_;
+  Needle<uint16_t>* ucs2_;
+};
+
+
+void Searcher::New(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args.IsConstructCall());
+  Environment* env = Environment::GetCurrent(args);
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+  SPREAD_BUFFER_ARG(args[0], needle);
+  CHECK_GT(needle_length, 0);
+  new Searcher(env, args.This(), needle_data, needle_length, args[1]->IsTrue());
+}
+
+
+void Searcher::IndexOf(const FunctionCallbackInfo<Value>& args) {
+  ASSERT(args[1]->IsNumber());
+  ASSERT(args[2]->IsBoolean());
+
+  Searcher* searcher;
+  ASSIGN_OR_RETURN_UNWRAP(&searcher, args.Holder());
+  THROW_AND_RETURN_UNLESS_BUFFER(Environment::GetCurrent(args), args[0]);
+  SPREAD_BUFFER_ARG(args[0], ts_obj);
+  int64_t offset_i64 = args[1]->IntegerValue();
+  bool is_forward = args[2]->IsTrue();
+
+  if (ts_obj_length == 0) {
+    return args.GetReturnValue().Set(-1);
+  }
+
+  int64_t opt_offset = IndexOfOffset(ts_obj_length, offset_i64, is_forward);
+  if (opt_offset <= -1) {
+    return args.GetReturnValue().Set(-1);
+  }
+  size_t offset = static_cast<size_t>(opt_offset);
+  CHECK_LT(offset, ts_obj_length);
+
+  size_t result =
+      searcher->Search(ts_obj_data, ts_obj_length, offset, is_forward);
+  args.GetReturnValue().Set(
+      result == ts_obj_length ? -1 : static_cast<int>(result));
+}
+
+
+void Searcher::FindAll(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Searcher* searcher;
+  ASSIGN_OR_RETURN_UNWRAP(&searcher, args.Holder());
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+  SPREAD_BUFFER_ARG(args[0], ts_obj);
+  CHECK(args[1]->IsUint32());
+  uint32_t limit = args[1].As<Uint32>()->Value();
+
+  Local<Array> matches = Array::New(env->isolate());
+  uint32_t count = 0;
+  size_t offset = 0;
+  while (count < limit && offset < ts_obj_length) {
+    size_t pos = searcher->Search(ts_obj_data, ts_obj_length, offset, true);
+    if (pos == ts_obj_length)
+      break;
+    matches->Set(env->context(),
+                 count++,
+                 Integer::NewFromUnsigned(env->isolate(), pos)).FromJust();
+    offset = pos + searcher->needle_length_;
+  }
+  args.GetReturnValue().Set(matches);
+}
+
+
+// moveToString(buffer, encoding) hands the backing store of |buffer| over to a
+// new string, if it can, and detaches the ArrayBuffer. Returns undefined if
+// it can't, which is when |buffer| doesn't span all of its ArrayBuffer, when
+// node's allocator didn't allocate the backing store, or when the encoding
+// or length isn't one that StringBytes::Adopt() takes.
+void MoveToString(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+  Local<ArrayBufferView> view = args[0].As<ArrayBufferView>();
+  Local<ArrayBuffer> ab = view->Buffer();
+  const enum encoding enc = ParseEncoding(env->isolate(), args[1], UTF8);
+  const size_t length = view->ByteLength();
+
+  if (env->isolate_data()->allocator() == nullptr ||
+      ab->IsExternal() ||
+      !ab->IsNeuterable() ||
+      view->ByteOffset() != 0 ||
+      ab->ByteLength() != length ||
+      (enc == UCS2 && IsBigEndian()) ||
+      !StringBytes::CanAdopt(length, enc)) {
+    return;
+  }
+  // Backing stores this large come from malloc(), not from the allocator's
+  // BufferArena, so the string can free() them.
+  CHECK_GT(length, BufferArena::kMaxSize);
+
+  ArrayBuffer::Contents contents = ab->Externalize();
+  ab->Neuter();
+  Local<String> str;
+  if (!StringBytes::Adopt(env->isolate(),
+                          static_cast<char*>(contents.Data()),
+                          length,
+                          enc).ToLocal(&str)) {
+    return env->ThrowError("Failed to create string");
+  }
+  args.GetReturnValue().Set(str);
+}
+
+
 void Swap16(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
@@ -1256,11 +1586,14 @@ void Initialize(Local<Object> target,
 
   env->SetMethod(target, "setupBufferJS", SetupBufferJS);
   env->SetMethod(target, "createFromString", CreateFromString);
+  env->SetMethod(target, "createUnsafeArrayBuffer", CreateUnsafeArrayBuffer);
 
   env->SetMethod(target, "byteLengthUtf8", ByteLengthUtf8);
+  env->SetMethod(target, "concat", Concat);
   env->SetMethod(target, "copy", Copy);
   env->SetMethod(target, "compare", Compare);
   env->SetMethod(target, "compareOffset", CompareOffset);
+  env->SetMethod(target, "compareMany", CompareMany);
   env->SetMethod(target, "fill", Fill);
   env->SetMethod(target, "indexOfBuffer", IndexOfBuffer);
   env->SetMethod(target, "indexOfNumber", IndexOfNumber);
@@ -1276,10 +1609,22 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "writeFloatBE", WriteFloatBE);
   env->SetMethod(target, "writeFloatLE", WriteFloatLE);
 
+  env->SetMethod(target, "moveToString", MoveToString);
+
   env->SetMethod(target, "swap16", Swap16);
   env->SetMethod(target, "swap32", Swap32);
   env->SetMethod(target, "swap64", Swap64);
 
+  Local<FunctionTemplate> searcher = env->NewFunctionTemplate(Searcher::New);
+  searcher->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(searcher, "indexOf", Searcher::IndexOf);
+  env->SetProtoMethod(searcher, "findAll", Searcher::FindAll);
+  searcher->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "Searcher"));
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "Searcher"),
+              searcher->GetFunction(env->context()).ToLocalChecked())
+      .FromJust();
+
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "kMaxLength"),
               Integer::NewFromUnsigned(env->isolate(), kMaxLength)).FromJust();
@@ -0,0 +1,57 @@
+#include "node_code_cache.h"
+#include "env.h"
+#include "env-inl.h"
+#include "util.h"
+#include "util-inl.h"
+
+#include <string.h>
+
+namespace node {
+namespace code_cache {
+
+using v8::ArrayBuffer;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::Local;
+using v8::Object;
+using v8::Uint8Array;
+using v8::Value;
+
+const Entry* Find(const char* id) {
+  for (size_t i = 0; i < entry_count; i++) {
+    if (strcmp(entries[i].id, id) == 0)
+      return &entries[i];
+  }
+  return nullptr;
+}
+
+
+// get(id) returns a Uint8Array of the cache of a native module, or undefined.
+// It is a plain Uint8Array because the first modules are compiled before
+// Buffer is set up, and it must not be written to.
+static void Get(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  node::Utf8Value id(env->isolate(), args[0]);
+  const Entry* entry = Find(*id);
+  if (entry == nullptr)
+    return;
+  Local<ArrayBuffer> ab =
+      ArrayBuffer::New(env->isolate(),
+                       const_cast<uint8_t*>(entry->data),
+                       entry->length);
+  args.GetReturnValue().Set(Uint8Array::New(ab, 0, entry->length));
+}
+
+
+static void Initialize(Local<Object> target,
+                       Local<Value> unused,
+                       Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  env->SetMethod(target, "get", Get);
+}
+
+}  // namespace code_cache
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(code_cache, node::code_cache::Initialize)
@@ -0,0 +1,40 @@
+#ifndef SRC_NODE_CODE_CACHE_H_
+#define SRC_NODE_CODE_CACHE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "v8.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace node {
+namespace code_cache {
+
+// V8 code caches of the native modules, which spare them most of their
+// compilation at startup. The build generates them with
+// tools/code_cache/mkcodecache.cc, unless it is configured with
+// --without-code-cache or cross-compiles, and then
+// src/node_code_cache_stub.cc provides none. A build configured with
+// --code-cache-path compiles in the file that tools/generate_code_cache.js
+// generated with a node binary instead. V8 rejects the cache of a module if
+// its source, the V8 version or the V8 flags differ from when it was
+// generated, and then compiles the module as usual.
+struct Entry {
+  const char* id;
+  const uint8_t* data;
+  size_t length;
+};
+
+extern const Entry* const entries;
+extern const size_t entry_count;
+
+// Returns the cache of the native module |id|, or nullptr if there is none.
+const Entry* Find(const char* id);
+
+}  // namespace code_cache
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CODE_CACHE_H_
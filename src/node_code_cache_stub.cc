@@ -0,0 +1,13 @@
+#include "node_code_cache.h"
+
+// The code cache of builds that neither generate one nor are configured
+// with --code-cache-path.
+
+namespace node {
+namespace code_cache {
+
+const Entry* const entries = nullptr;
+const size_t entry_count = 0;
+
+}  // namespace code_cache
+}  // namespace node
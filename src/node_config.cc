@@ -9,6 +9,7 @@
 namespace node {
 
 using v8::Context;
+using v8::Integer;
 using v8::Local;
 using v8::Object;
 using v8::ReadOnly;
@@ -59,6 +60,74 @@ static void InitConfig(Local<Object> target,
     target->DefineOwnProperty(env->context(), name, value).FromJust();
   }
 
+  if (!config_compile_cache_dir.empty()) {
+    Local<String> name = OneByteString(env->isolate(), "compileCacheDir");
+    Local<String> value = String::NewFromUtf8(env->isolate(),
+                                              config_compile_cache_dir.data(),
+                                              v8::NewStringType::kNormal,
+                                              config_compile_cache_dir.size())
+                                                .ToLocalChecked();
+    target->DefineOwnProperty(env->context(), name, value).FromJust();
+  }
+
+  if (!config_app_archive.empty()) {
+    Local<String> name = OneByteString(env->isolate(), "appArchive");
+    Local<String> value = String::NewFromUtf8(env->isolate(),
+                                              config_app_archive.data(),
+                                              v8::NewStringType::kNormal,
+                                              config_app_archive.size())
+                                                .ToLocalChecked();
+    target->DefineOwnProperty(env->context(), name, value).FromJust();
+  }
+
+  if (!config_resolution_cache.empty()) {
+    Local<String> name = OneByteString(env->isolate(), "resolutionCache");
+    Local<String> value = String::NewFromUtf8(env->isolate(),
+                                              config_resolution_cache.data(),
+                                              v8::NewStringType::kNormal,
+                                              config_resolution_cache.size())
+                                                .ToLocalChecked();
+    target->DefineOwnProperty(env->context(), name, value).FromJust();
+  }
+
+  if (!config_build_resolution_cache.empty()) {
+    Local<String> name =
+        OneByteString(env->isolate(), "buildResolutionCache");
+    Local<String> value =
+        String::NewFromUtf8(env->isolate(),
+                            config_build_resolution_cache.data(),
+                            v8::NewStringType::kNormal,
+                            config_build_resolution_cache.size())
+                                .ToLocalChecked();
+    target->DefineOwnProperty(env->context(), name, value).FromJust();
+  }
+
+  if (config_immediate_budget > 0) {
+    Local<String> name = OneByteString(env->isolate(), "immediateBudget");
+    Local<Integer> value =
+        Integer::NewFromUnsigned(env->isolate(), config_immediate_budget);
+    target->DefineOwnProperty(env->context(), name, value).FromJust();
+  }
+
+  if (!config_heap_snapshot_signal.empty()) {
+    Local<String> name = OneByteString(env->isolate(), "heapSnapshotSignal");
+    Local<String> value =
+        String::NewFromUtf8(env->isolate(),
+                            config_heap_snapshot_signal.data(),
+                            v8::NewStringType::kNormal,
+                            config_heap_snapshot_signal.size())
+                                .ToLocalChecked();
+    target->DefineOwnProperty(env->context(), name, value).FromJust();
+  }
+
+  if (!config_stdio_buffer.empty()) {
+    Local<String> name = OneByteString(env->isolate(), "stdioBuffer");
+    Local<String> value = OneByteString(env->isolate(),
+                                        config_stdio_buffer.data(),
+                                        config_stdio_buffer.size());
+    target->DefineOwnProperty(env->context(), name, value).FromJust();
+  }
+
   if (config_expose_internals)
     READONLY_BOOLEAN_PROPERTY("exposeInternals");
 }  // InitConfig
@@ -44,6 +44,10 @@
 # endif  // !OPENSSL_NO_ENGINE
 #endif
 
+#if NODE_HAVE_BROTLI
+# include <brotli/encode.h>
+#endif
+
 namespace node {
 
 using v8::Local;
@@ -1162,6 +1166,10 @@ void DefineSystemConstants(Local<Object> target) {
 #ifdef X_OK
   NODE_DEFINE_CONSTANT(target, X_OK);
 #endif
+
+  NODE_DEFINE_CONSTANT(target, COPYFILE_EXCL);
+  NODE_DEFINE_CONSTANT(target, COPYFILE_FICLONE);
+  NODE_DEFINE_CONSTANT(target, COPYFILE_FICLONE_FORCE);
 }
 
 void DefineUVConstants(Local<Object> target) {
@@ -1217,7 +1225,9 @@ void DefineZlibConstants(Local<Object> target) {
     GUNZIP,
     DEFLATERAW,
     INFLATERAW,
-    UNZIP
+    UNZIP,
+    BROTLI_DECODE,
+    BROTLI_ENCODE
   };
 
   NODE_DEFINE_CONSTANT(target, DEFLATE);
@@ -1228,6 +1238,18 @@ void DefineZlibConstants(Local<Object> target) {
   NODE_DEFINE_CONSTANT(target, INFLATERAW);
   NODE_DEFINE_CONSTANT(target, UNZIP);
 
+#if NODE_HAVE_BROTLI
+  // The Brotli modes are only there if node was built with Brotli.
+  NODE_DEFINE_CONSTANT(target, BROTLI_DECODE);
+  NODE_DEFINE_CONSTANT(target, BROTLI_ENCODE);
+  NODE_DEFINE_CONSTANT(target, BROTLI_MIN_QUALITY);
+  NODE_DEFINE_CONSTANT(target, BROTLI_MAX_QUALITY);
+  NODE_DEFINE_CONSTANT(target, BROTLI_DEFAULT_QUALITY);
+  NODE_DEFINE_CONSTANT(target, BROTLI_MIN_WINDOW_BITS);
+  NODE_DEFINE_CONSTANT(target, BROTLI_MAX_WINDOW_BITS);
+  NODE_DEFINE_CONSTANT(target, BROTLI_DEFAULT_WINDOW);
+#endif
+
 #define Z_MIN_WINDOWBITS 8
 #define Z_MAX_WINDOWBITS 15
 #define Z_DEFAULT_WINDOWBITS 15
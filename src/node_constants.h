@@ -64,6 +64,11 @@
                                  "!CAMELLIA"
 #endif
 
+// Flags for fs.copyFile(), see CopyFileContents() in node_file.cc.
+#define COPYFILE_EXCL 1
+#define COPYFILE_FICLONE 2
+#define COPYFILE_FICLONE_FORCE 4
+
 namespace node {
 
 #if HAVE_OPENSSL
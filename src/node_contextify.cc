@@ -51,6 +51,7 @@ using v8::MaybeLocal;
 using v8::Name;
 using v8::NamedPropertyHandlerConfiguration;
 using v8::Nothing;
+using v8::Null;
 using v8::Object;
 using v8::ObjectTemplate;
 using v8::Persistent;
@@ -61,9 +62,11 @@ using v8::Script;
 using v8::ScriptCompiler;
 using v8::ScriptOrigin;
 using v8::String;
+using v8::True;
 using v8::TryCatch;
 using v8::Uint8Array;
 using v8::UnboundScript;
+using v8::Undefined;
 using v8::Value;
 using v8::WeakCallbackInfo;
 
@@ -72,13 +75,18 @@ namespace {
 class ContextifyContext {
  protected:
   // V8 reserves the first field in context objects for the debugger. We use the
-  // second field to hold a reference to the sandbox object.
-  enum { kSandboxObjectIndex = 1 };
+  // second field to hold a reference to the sandbox object, and the third for
+  // an External of the ContextifyContext, which the interceptors of the shared
+  // global template find through the context of their holder. A new context
+  // has room for three fields.
+  enum { kSandboxObjectIndex = 1, kContextifyContextIndex = 2 };
 
   Environment* const env_;
   Persistent<Context> context_;
 
  public:
+  // Without a |sandbox_obj|, the context has no interceptors and its global
+  // is its own sandbox.
   ContextifyContext(Environment* env, Local<Object> sandbox_obj) : env_(env) {
     Local<Context> v8_context = CreateV8Context(env, sandbox_obj);
     context_.Reset(env->isolate(), v8_context);
@@ -88,6 +96,8 @@ class ContextifyContext {
       return;
     context_.SetWeak(this, WeakCallback, v8::WeakCallbackType::kParameter);
     context_.MarkIndependent();
+    v8_context->SetEmbedderData(kContextifyContextIndex,
+                                External::New(env->isolate(), this));
   }
 
 
@@ -115,6 +125,11 @@ class ContextifyContext {
     return Local<Object>::Cast(context()->GetEmbedderData(kSandboxObjectIndex));
   }
 
+
+  inline bool has_interceptors() const {
+    return sandbox() != global_proxy();
+  }
+
   // XXX(isaacs): This function only exists because of a shortcoming of
   // the V8 SetNamedPropertyHandler function.
   //
@@ -138,6 +153,8 @@ class ContextifyContext {
   // removed once there is a better way.
   void CopyProperties() {
     HandleScope scope(env()->isolate());
+    if (!has_interceptors())
+      return;
 
     Local<Context> context = PersistentToLocal(env()->isolate(), context_);
     Local<Object> global =
@@ -202,31 +219,14 @@ class ContextifyContext {
 }
 
 
-  // This is an object that just keeps an internal pointer to this
-  // ContextifyContext.  It's passed to the NamedPropertyHandler.  If we
-  // pass the main JavaScript context object we're embedded in, then the
-  // NamedPropertyHandler will store a reference to it forever and keep it
-  // from getting gc'd.
-  Local<Value> CreateDataWrapper(Environment* env) {
-    EscapableHandleScope scope(env->isolate());
-    Local<Object> wrapper =
-        env->script_data_constructor_function()
-            ->NewInstance(env->context()).FromMaybe(Local<Object>());
-    if (wrapper.IsEmpty())
-      return scope.Escape(Local<Value>::New(env->isolate(), Local<Value>()));
-
-    Wrap(wrapper, this);
-    return scope.Escape(wrapper);
-  }
-
-
-  Local<Context> CreateV8Context(Environment* env, Local<Object> sandbox_obj) {
+  static Local<ObjectTemplate> CreateGlobalTemplate(Environment* env,
+                                                    Local<String> class_name) {
     EscapableHandleScope scope(env->isolate());
     Local<FunctionTemplate> function_template =
         FunctionTemplate::New(env->isolate());
     function_template->SetHiddenPrototype(true);
 
-    function_template->SetClassName(sandbox_obj->GetConstructorName());
+    function_template->SetClassName(class_name);
 
     Local<ObjectTemplate> object_template =
         function_template->InstanceTemplate();
@@ -235,9 +235,35 @@ class ContextifyContext {
                                              GlobalPropertySetterCallback,
                                              GlobalPropertyQueryCallback,
                                              GlobalPropertyDeleterCallback,
-                                             GlobalPropertyEnumeratorCallback,
-                                             CreateDataWrapper(env));
+                                             GlobalPropertyEnumeratorCallback);
     object_template->SetHandler(config);
+    return scope.Escape(object_template);
+  }
+
+
+  // The template of the global object is named after the constructor of the
+  // sandbox. The one for plain objects, which almost all sandboxes are, is
+  // made once per Environment.
+  static Local<ObjectTemplate> GetGlobalTemplate(Environment* env,
+                                                 Local<Object> sandbox_obj) {
+    Local<String> class_name = sandbox_obj->GetConstructorName();
+    if (!class_name->StrictEquals(FIXED_ONE_BYTE_STRING(env->isolate(),
+                                                        "Object"))) {
+      return CreateGlobalTemplate(env, class_name);
+    }
+    if (env->contextify_global_template().IsEmpty()) {
+      env->set_contextify_global_template(
+          CreateGlobalTemplate(env, class_name));
+    }
+    return env->contextify_global_template();
+  }
+
+
+  Local<Context> CreateV8Context(Environment* env, Local<Object> sandbox_obj) {
+    EscapableHandleScope scope(env->isolate());
+    Local<ObjectTemplate> object_template;
+    if (!sandbox_obj.IsEmpty())
+      object_template = GetGlobalTemplate(env, sandbox_obj);
 
     Local<Context> ctx = Context::New(env->isolate(), nullptr, object_template);
 
@@ -248,12 +274,28 @@ class ContextifyContext {
 
     ctx->SetSecurityToken(env->context()->GetSecurityToken());
 
+    // What a fresh global has, for ResetContext() to remove everything else.
+    if (env->contextify_global_names().IsEmpty()) {
+      Local<Object> names = Object::New(env->isolate());
+      CHECK(names->SetPrototype(env->context(),
+                                Null(env->isolate())).FromJust());
+      Local<Array> keys = RealGlobal(ctx)->GetOwnPropertyNames(
+          ctx, v8::SKIP_SYMBOLS).ToLocalChecked();
+      for (uint32_t i = 0; i < keys->Length(); i++) {
+        names->Set(env->context(), keys->Get(i), True(env->isolate()))
+            .FromJust();
+      }
+      env->set_contextify_global_names(names);
+    }
+
     // We need to tie the lifetime of the sandbox object with the lifetime of
     // newly created context. We do this by making them hold references to each
     // other. The context can directly hold a reference to the sandbox as an
     // embedder data field. However, we cannot hold a reference to a v8::Context
     // directly in an Object, we instead hold onto the new context's global
     // object instead (which then has a reference to the context).
+    if (sandbox_obj.IsEmpty())
+      sandbox_obj = ctx->Global();
     ctx->SetEmbedderData(kSandboxObjectIndex, sandbox_obj);
     sandbox_obj->SetPrivate(env->context(),
                             env->contextify_global_private_symbol(),
@@ -265,15 +307,18 @@ class ContextifyContext {
   }
 
 
-  static void Init(Environment* env, Local<Object> target) {
-    Local<FunctionTemplate> function_template =
-        FunctionTemplate::New(env->isolate());
-    function_template->InstanceTemplate()->SetInternalFieldCount(1);
-    env->set_script_data_constructor_function(function_template->GetFunction());
+  // The global object itself, behind the global proxy.
+  static Local<Object> RealGlobal(Local<Context> context) {
+    return context->Global()->GetPrototype().As<Object>();
+  }
 
+
+  static void Init(Environment* env, Local<Object> target) {
     env->SetMethod(target, "runInDebugContext", RunInDebugContext);
     env->SetMethod(target, "makeContext", MakeContext);
+    env->SetMethod(target, "makeGlobalContext", MakeGlobalContext);
     env->SetMethod(target, "isContext", IsContext);
+    env->SetMethod(target, "resetContext", ResetContext);
   }
 
 
@@ -339,6 +384,94 @@ class ContextifyContext {
   }
 
 
+  // makeGlobalContext() returns the global of a new context that has no
+  // interceptors, contextified in place of a sandbox. Scripts access its
+  // properties without calling back into C++.
+  static void MakeGlobalContext(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+
+    TryCatch try_catch(env->isolate());
+    ContextifyContext* context =
+        new ContextifyContext(env, Local<Object>());
+
+    if (try_catch.HasCaught()) {
+      try_catch.ReThrow();
+      return;
+    }
+
+    if (context->context().IsEmpty())
+      return;
+
+    Local<Object> global = context->global_proxy();
+    global->SetPrivate(
+        env->context(),
+        env->contextify_context_private_symbol(),
+        External::New(env->isolate(), context));
+    args.GetReturnValue().Set(global);
+  }
+
+
+  // resetContext(contextifiedSandbox, sandbox) moves the context of
+  // |contextifiedSandbox| to |sandbox|. What the scripts that ran in it
+  // added to the global is removed first, and the variables that they
+  // declared, which can't be removed, are set to undefined.
+  static void ResetContext(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args[0]->IsObject());
+    CHECK(args[1]->IsObject());
+    Local<Object> old_sandbox = args[0].As<Object>();
+    Local<Object> sandbox = args[1].As<Object>();
+    ContextifyContext* contextify_context =
+        ContextFromContextifiedSandbox(env, old_sandbox);
+    CHECK_NE(contextify_context, nullptr);
+    if (!contextify_context->has_interceptors()) {
+      return env->ThrowTypeError(
+          "A context without interceptors can't be reset.");
+    }
+    CHECK(
+        !sandbox->HasPrivate(
+            env->context(),
+            env->contextify_context_private_symbol()).FromJust());
+
+    Local<Context> context = contextify_context->context();
+    // The interceptors let everything through to the global meanwhile.
+    context->SetEmbedderData(kContextifyContextIndex,
+                             Undefined(env->isolate()));
+    Local<Object> global = RealGlobal(context);
+    Local<Object> initial_names = env->contextify_global_names();
+    Local<Array> keys =
+        global->GetOwnPropertyNames(context, v8::SKIP_SYMBOLS)
+            .ToLocalChecked();
+    for (uint32_t i = 0; i < keys->Length(); i++) {
+      Local<Value> key = keys->Get(i);
+      if (initial_names->HasOwnProperty(env->context(),
+                                        key.As<Name>()).FromJust()) {
+        continue;
+      }
+      if (!global->Delete(context, key).FromMaybe(false))
+        global->Set(context, key, Undefined(env->isolate())).FromJust();
+    }
+
+    old_sandbox->DeletePrivate(env->context(),
+                               env->contextify_context_private_symbol())
+        .FromJust();
+    old_sandbox->DeletePrivate(env->context(),
+                               env->contextify_global_private_symbol())
+        .FromJust();
+    context->SetEmbedderData(kSandboxObjectIndex, sandbox);
+    sandbox->SetPrivate(env->context(),
+                        env->contextify_global_private_symbol(),
+                        context->Global()).FromJust();
+    sandbox->SetPrivate(env->context(),
+                        env->contextify_context_private_symbol(),
+                        External::New(env->isolate(), contextify_context))
+        .FromJust();
+    context->SetEmbedderData(kContextifyContextIndex,
+                             External::New(env->isolate(),
+                                           contextify_context));
+  }
+
+
   static void IsContext(const FunctionCallbackInfo<Value>& args) {
     Environment* env = Environment::GetCurrent(args);
 
@@ -377,14 +510,25 @@ class ContextifyContext {
   }
 
 
+  // Returns the ContextifyContext whose global an interceptor runs for, or
+  // nullptr if it doesn't intercept anything at the moment.
+  template <typename T>
+  static ContextifyContext* Get(const PropertyCallbackInfo<T>& args) {
+    Local<Context> context = args.Holder()->CreationContext();
+    Local<Value> data = context->GetEmbedderData(kContextifyContextIndex);
+    if (!data->IsExternal())
+      return nullptr;
+    return static_cast<ContextifyContext*>(data.As<External>()->Value());
+  }
+
+
   static void GlobalPropertyGetterCallback(
       Local<Name> property,
       const PropertyCallbackInfo<Value>& args) {
-    ContextifyContext* ctx;
-    ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Data().As<Object>());
+    ContextifyContext* ctx = Get(args);
 
-    // Still initializing
-    if (ctx->context_.IsEmpty())
+    // Still initializing, or being reset
+    if (ctx == nullptr)
       return;
 
     Local<Context> context = ctx->context();
@@ -410,11 +554,10 @@ class ContextifyContext {
       Local<Name> property,
       Local<Value> value,
       const PropertyCallbackInfo<Value>& args) {
-    ContextifyContext* ctx;
-    ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Data().As<Object>());
+    ContextifyContext* ctx = Get(args);
 
-    // Still initializing
-    if (ctx->context_.IsEmpty())
+    // Still initializing, or being reset
+    if (ctx == nullptr)
       return;
 
     auto attributes = PropertyAttribute::None;
@@ -455,11 +598,10 @@ class ContextifyContext {
   static void GlobalPropertyQueryCallback(
       Local<Name> property,
       const PropertyCallbackInfo<Integer>& args) {
-    ContextifyContext* ctx;
-    ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Data().As<Object>());
+    ContextifyContext* ctx = Get(args);
 
-    // Still initializing
-    if (ctx->context_.IsEmpty())
+    // Still initializing, or being reset
+    if (ctx == nullptr)
       return;
 
     Local<Context> context = ctx->context();
@@ -482,11 +624,10 @@ class ContextifyContext {
   static void GlobalPropertyDeleterCallback(
       Local<Name> property,
       const PropertyCallbackInfo<Boolean>& args) {
-    ContextifyContext* ctx;
-    ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Data().As<Object>());
+    ContextifyContext* ctx = Get(args);
 
-    // Still initializing
-    if (ctx->context_.IsEmpty())
+    // Still initializing, or being reset
+    if (ctx == nullptr)
       return;
 
     Maybe<bool> success = ctx->sandbox()->Delete(ctx->context(), property);
@@ -502,11 +643,10 @@ class ContextifyContext {
 
   static void GlobalPropertyEnumeratorCallback(
       const PropertyCallbackInfo<Array>& args) {
-    ContextifyContext* ctx;
-    ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Data().As<Object>());
+    ContextifyContext* ctx = Get(args);
 
-    // Still initializing
-    if (ctx->context_.IsEmpty())
+    // Still initializing, or being reset
+    if (ctx == nullptr)
       return;
 
     args.GetReturnValue().Set(ctx->sandbox()->GetPropertyNames());
@@ -0,0 +1,388 @@
+#include "node_counter_registry.h"
+#include "node_internals.h"
+#include "node_mutex.h"
+#include "env.h"
+#include "env-inl.h"
+#include "util.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace node {
+namespace counters {
+
+const char* file_path = nullptr;
+
+namespace {
+
+struct Header {
+  uint8_t magic[8];
+  uint32_t version;
+  uint32_t capacity;
+  uint32_t shards;
+  uint32_t count;
+  uint32_t pid;
+  uint32_t reserved;
+  uint64_t names_offset;
+  uint64_t values_offset;
+};
+
+struct NameEntry {
+  uint32_t type;
+  char name[kNameSize - sizeof(uint32_t)];
+};
+
+static_assert(sizeof(NameEntry) == kNameSize, "NameEntry has padding");
+
+const uint8_t kMagic[8] = { 'N', 'O', 'D', 'E', 'C', 'N', 'T', 'R' };
+const size_t kNamesOffset = 64;
+const size_t kValuesOffset = kNamesOffset + kCapacity * kNameSize;
+const size_t kRegionSize = kValuesOffset + kShards * kCapacity * sizeof(double);
+// Shared by the threads that come after all of the other rows were taken.
+const size_t kSharedShard = kShards - 1;
+
+class Registry {
+ public:
+  static Registry* Get() {
+    uv_once(&once_, Create);
+    return instance_;
+  }
+
+  int Register(const char* name, Type type) {
+    CHECK_LE(strlen(name), kMaxNameLength);
+    Mutex::ScopedLock lock(mutex_);
+    const uint32_t count = header_->count;
+    for (uint32_t id = 0; id < count; id++) {
+      if (strcmp(names_[id].name, name) == 0)
+        return names_[id].type == type ? static_cast<int>(id) : kWrongType;
+    }
+    if (count == kCapacity)
+      return kFull;
+    names_[count].type = type;
+    snprintf(names_[count].name, sizeof(names_[count].name), "%s", name);
+    // Readers in other processes don't take |mutex_|.
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->count = count + 1;
+    return static_cast<int>(count);
+  }
+
+  void Add(int id, double value) {
+    const size_t shard = Shard();
+    if (shard != kSharedShard) {
+      Row(shard)[id] += value;
+    } else {
+      Mutex::ScopedLock lock(mutex_);
+      Row(shard)[id] += value;
+    }
+  }
+
+  void Set(int id, double value) {
+    const size_t shard = Shard();
+    Mutex::ScopedLock lock(mutex_);
+    double others = 0;
+    for (size_t i = 0; i < kShards; i++) {
+      if (i != shard)
+        others += Row(i)[id];
+    }
+    Row(shard)[id] = value - others;
+  }
+
+  double Read(int id) {
+    double sum = 0;
+    for (size_t i = 0; i < kShards; i++)
+      sum += Row(i)[id];
+    return sum;
+  }
+
+  size_t Count() {
+    Mutex::ScopedLock lock(mutex_);
+    return header_->count;
+  }
+
+  const NameEntry& Entry(int id) {
+    CHECK_GE(id, 0);
+    CHECK_LT(static_cast<size_t>(id), Count());
+    return names_[id];
+  }
+
+  double* ThreadRow() {
+    const size_t shard = Shard();
+    return shard != kSharedShard ? Row(shard) : nullptr;
+  }
+
+  const char* file() const { return file_.empty() ? nullptr : file_.c_str(); }
+
+ private:
+  Registry() : region_(nullptr), next_shard_(0) {
+    if (file_path != nullptr && *file_path != '\0') {
+      region_ = MapFile(file_path);
+      if (region_ != nullptr) {
+        file_ = file_path;
+      } else {
+        fprintf(stderr, "node: could not map --counters-file=%s, counters "
+                "are kept in memory only\n", file_path);
+      }
+    }
+    if (region_ == nullptr)
+      region_ = Calloc(kRegionSize);
+    CHECK_NE(region_, nullptr);
+
+    header_ = reinterpret_cast<Header*>(region_);
+    names_ = reinterpret_cast<NameEntry*>(region_ + kNamesOffset);
+    header_->version = kVersion;
+    header_->capacity = kCapacity;
+    header_->shards = kShards;
+    header_->count = 0;
+#ifdef _WIN32
+    header_->pid = GetCurrentProcessId();
+#else
+    header_->pid = getpid();
+#endif
+    header_->names_offset = kNamesOffset;
+    header_->values_offset = kValuesOffset;
+    // The magic goes last, so that a reader that finds it finds the rest.
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header_->magic, kMagic, sizeof(kMagic));
+
+    CHECK_EQ(0, uv_key_create(&shard_key_));
+  }
+
+  static void Create() {
+    // Deliberately leaked, other threads may update counters until the
+    // process exits, and the file keeps the last values.
+    instance_ = new Registry();
+#define V(id, name, type) CHECK_EQ(id, instance_->Register(name, type));
+    NODE_CORE_COUNTERS(V)
+#undef V
+  }
+
+  // Maps a file of kRegionSize bytes at |path|, replacing what was there.
+  static char* MapFile(const char* path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      return nullptr;
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0,
+                                        static_cast<DWORD>(kRegionSize),
+                                        nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+      return nullptr;
+    void* region = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0,
+                                 kRegionSize);
+    CloseHandle(mapping);
+    return static_cast<char*>(region);
+#else
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+      return nullptr;
+    if (ftruncate(fd, kRegionSize) != 0) {
+      close(fd);
+      return nullptr;
+    }
+    void* region = mmap(nullptr, kRegionSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+    close(fd);
+    return region != MAP_FAILED ? static_cast<char*>(region) : nullptr;
+#endif
+  }
+
+  double* Row(size_t shard) {
+    return reinterpret_cast<double*>(region_ + kValuesOffset) +
+           shard * kCapacity;
+  }
+
+  // The shard of the calling thread, taking the next free one on its first
+  // call. The key holds the shard plus one, so that 0 means none yet.
+  size_t Shard() {
+    uintptr_t value = reinterpret_cast<uintptr_t>(uv_key_get(&shard_key_));
+    if (value == 0) {
+      {
+        Mutex::ScopedLock lock(mutex_);
+        value = next_shard_ + 1;
+        if (next_shard_ < kSharedShard)
+          next_shard_++;
+      }
+      uv_key_set(&shard_key_, reinterpret_cast<void*>(value));
+    }
+    return value - 1;
+  }
+
+  static uv_once_t once_;
+  static Registry* instance_;
+
+  char* region_;
+  Header* header_;
+  NameEntry* names_;
+  std::string file_;
+  uv_key_t shard_key_;
+  Mutex mutex_;
+  size_t next_shard_;
+};
+
+uv_once_t Registry::once_ = UV_ONCE_INIT;
+Registry* Registry::instance_ = nullptr;
+
+}  // anonymous namespace
+
+
+int Register(const char* name, Type type) {
+  return Registry::Get()->Register(name, type);
+}
+
+
+void Add(int id, double value) {
+  Registry::Get()->Add(id, value);
+}
+
+
+void Set(int id, double value) {
+  Registry::Get()->Set(id, value);
+}
+
+
+double Read(int id) {
+  return Registry::Get()->Read(id);
+}
+
+
+size_t Count() {
+  return Registry::Get()->Count();
+}
+
+
+const char* Name(int id) {
+  return Registry::Get()->Entry(id).name;
+}
+
+
+Type TypeOf(int id) {
+  return static_cast<Type>(Registry::Get()->Entry(id).type);
+}
+
+
+double* ThreadRow() {
+  return Registry::Get()->ThreadRow();
+}
+
+
+const char* File() {
+  return Registry::Get()->file();
+}
+
+
+namespace {
+
+using v8::ArrayBuffer;
+using v8::Context;
+using v8::Float64Array;
+using v8::FunctionCallbackInfo;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::Number;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+// The id of an entry that JS has registered.
+int IdArg(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsInt32());
+  const int id = args[0].As<Integer>()->Value();
+  CHECK_GE(id, 0);
+  CHECK_LT(static_cast<size_t>(id), Count());
+  return id;
+}
+
+void RegisterEntry(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsInt32());
+  node::Utf8Value name(args.GetIsolate(), args[0]);
+  CHECK_LE(name.length(), kMaxNameLength);
+  const int type = args[1].As<Integer>()->Value();
+  CHECK(type == kCounter || type == kGauge);
+  args.GetReturnValue().Set(Register(*name, static_cast<Type>(type)));
+}
+
+void ReadEntry(const FunctionCallbackInfo<Value>& args) {
+  args.GetReturnValue().Set(Read(IdArg(args)));
+}
+
+void SetEntry(const FunctionCallbackInfo<Value>& args) {
+  const int id = IdArg(args);
+  CHECK(args[1]->IsNumber());
+  Set(id, args[1].As<Number>()->Value());
+}
+
+void Snapshot(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Local<Object> snapshot = Object::New(env->isolate());
+  const size_t count = Count();
+  for (size_t id = 0; id < count; id++) {
+    Local<String> name = OneByteString(env->isolate(), Name(id));
+    Local<Value> value = Number::New(env->isolate(), Read(id));
+    snapshot->Set(env->context(), name, value).FromJust();
+  }
+  args.GetReturnValue().Set(snapshot);
+}
+
+void Initialize(Local<Object> target,
+                Local<Value> unused,
+                Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  Isolate* isolate = env->isolate();
+
+  env->SetMethod(target, "register", RegisterEntry);
+  env->SetMethod(target, "read", ReadEntry);
+  env->SetMethod(target, "set", SetEntry);
+  env->SetMethod(target, "snapshot", Snapshot);
+
+  // The loop thread's row, which lib/internal/counters.js adds to directly.
+  // The loop thread is among the first threads to update counters, so it
+  // always gets a row of its own.
+  double* row = ThreadRow();
+  CHECK_NE(row, nullptr);
+  Local<ArrayBuffer> array_buffer =
+      ArrayBuffer::New(isolate, row, kCapacity * sizeof(*row));
+  target->Set(FIXED_ONE_BYTE_STRING(isolate, "values"),
+              Float64Array::New(array_buffer, 0, kCapacity));
+
+  const char* file = File();
+  if (file != nullptr)
+    target->Set(FIXED_ONE_BYTE_STRING(isolate, "file"),
+                String::NewFromUtf8(isolate, file));
+
+#define V(name, value)                                                        \
+  target->Set(FIXED_ONE_BYTE_STRING(isolate, #name),                          \
+              Integer::New(isolate, value));
+  V(kCounter, kCounter)
+  V(kGauge, kGauge)
+  V(kFull, kFull)
+  V(kWrongType, kWrongType)
+  V(kMaxNameLength, kMaxNameLength)
+#define W(id, name, type) V(id, id)
+  NODE_CORE_COUNTERS(W)
+#undef W
+#undef V
+}
+
+}  // anonymous namespace
+}  // namespace counters
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(counters, node::counters::Initialize)
@@ -0,0 +1,116 @@
+#ifndef SRC_NODE_COUNTER_REGISTRY_H_
+#define SRC_NODE_COUNTER_REGISTRY_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace node {
+namespace counters {
+
+// A process wide registry of named counters and gauges that any thread can
+// update without taking a lock, and that other processes can read.
+//
+// Each thread that updates a value gets a shard of its own, a row of one
+// double per entry, and only ever writes to that row. A value is the sum of
+// its rows. Readers add up the rows without synchronizing with the writers,
+// so a value that is read while it is being updated may miss the update.
+// The names are only ever appended, behind a mutex.
+//
+// When the process is started with --counters-file=path, the registry lives
+// in that file, mapped into memory, so that monitoring agents can map it too
+// and read the values without asking the process. It is laid out as:
+//
+//   uint8_t  magic[8]        "NODECNTR"
+//   uint32_t version         kVersion
+//   uint32_t capacity        the number of entries that fit
+//   uint32_t shards          the number of rows of values
+//   uint32_t count           the number of entries registered so far
+//   uint32_t pid
+//   uint32_t reserved
+//   uint64_t names_offset    of |capacity| entries of kNameSize bytes, each
+//                            a uint32_t Type and a NUL terminated name
+//   uint64_t values_offset   of |shards| rows of |capacity| doubles
+//
+// in the byte order of the machine. |count| is only increased once the
+// entry that it makes visible has been written.
+
+enum Type {
+  kCounter = 1,  // Only goes up.
+  kGauge = 2     // Goes up and down.
+};
+
+static const uint32_t kVersion = 1;
+static const size_t kCapacity = 256;
+static const size_t kShards = 64;
+static const size_t kNameSize = 64;
+// Not counting the NUL.
+static const size_t kMaxNameLength = kNameSize - sizeof(uint32_t) - 1;
+
+// The entries that node itself keeps, registered first and in this order.
+#define NODE_CORE_COUNTERS(V)                                                 \
+  V(kNetServerConnections, "net.server.connections", kCounter)               \
+  V(kNetServerConnectionsOpen, "net.server.connections.open", kGauge)        \
+  V(kNetBytesRead, "net.bytes.read", kCounter)                                \
+  V(kNetBytesWritten, "net.bytes.written", kCounter)                          \
+  V(kPipeBytesRead, "pipe.bytes.read", kCounter)                              \
+  V(kPipeBytesWritten, "pipe.bytes.written", kCounter)                        \
+  V(kHttpServerRequests, "http.server.requests", kCounter)                    \
+  V(kHttpServerResponses, "http.server.responses", kCounter)                  \
+  V(kHttpClientRequests, "http.client.requests", kCounter)                    \
+  V(kHttpClientResponses, "http.client.responses", kCounter)                  \
+  V(kFsOperations, "fs.operations", kCounter)                                 \
+  V(kThreadpoolQueued, "threadpool.queued", kCounter)                         \
+  V(kThreadpoolCompleted, "threadpool.completed", kCounter)                   \
+  V(kThreadpoolPending, "threadpool.pending", kGauge)                         \
+  V(kThreadpoolRunning, "threadpool.running", kGauge)
+
+enum CoreCounter {
+#define V(id, name, type) id,
+  NODE_CORE_COUNTERS(V)
+#undef V
+  kCoreCounterCount
+};
+
+// Set in node.cc by ParseArgs when --counters-file= is used. Only read when
+// the registry is first used.
+extern const char* file_path;
+
+// Returns the id of the entry called |name|, registering it if there is
+// none. Returns kFull when there is no room left, and kWrongType when there
+// is an entry of another type with that name. |name| must be at most
+// kMaxNameLength bytes long.
+static const int kFull = -1;
+static const int kWrongType = -2;
+int Register(const char* name, Type type);
+
+// Adds |value| to the calling thread's row of entry |id|.
+void Add(int id, double value);
+
+// Makes entry |id| read as |value|, by setting the calling thread's row to
+// |value| less the other rows. Only exact if no other thread updates it at
+// the same time.
+void Set(int id, double value);
+
+double Read(int id);
+
+// The number of entries registered so far. Their ids are below this.
+size_t Count();
+const char* Name(int id);
+Type TypeOf(int id);
+
+// The calling thread's row, kCapacity doubles that only it writes to, or
+// nullptr if every row was taken by other threads. Such threads share the
+// last row, and Add() and Set() take a lock for them.
+double* ThreadRow();
+
+// The file that the registry lives in, or nullptr if it is in memory only.
+const char* File();
+
+}  // namespace counters
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_COUNTER_REGISTRY_H_
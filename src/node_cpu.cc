@@ -0,0 +1,43 @@
+#include "node_cpu.h"
+
+namespace node {
+namespace cpu {
+
+#if NODE_SIMD_X86
+
+static Level DetectLevel() {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  const int max_leaf = info[0];
+  __cpuid(info, 1);
+  const bool ssse3 = (info[2] & (1 << 9)) != 0;
+  // AVX2 also needs the OS to save the upper halves of the ymm registers.
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx2 = false;
+  if (max_leaf >= 7 && osxsave && (_xgetbv(0) & 6) == 6) {
+    __cpuidex(info, 7, 0);
+    avx2 = (info[1] & (1 << 5)) != 0;
+  }
+#else
+  __builtin_cpu_init();
+  const bool ssse3 = __builtin_cpu_supports("ssse3");
+  const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+  if (avx2)
+    return kAVX2;
+  if (ssse3)
+    return kSSSE3;
+  return kBaseline;
+}
+
+
+Level GetLevel() {
+  static const Level level = DetectLevel();
+  return level;
+}
+
+#endif  // NODE_SIMD_X86
+
+}  // namespace cpu
+}  // namespace node
@@ -0,0 +1,54 @@
+#ifndef SRC_NODE_CPU_H_
+#define SRC_NODE_CPU_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+// Vector kernels beyond the baseline instruction set are compiled with
+// function level target attributes and picked at run time, so the rest of
+// the binary runs on any CPU of the architecture. SSE2 is part of x86-64 and
+// NEON of arm64, those are used without checking.
+#if (defined(__x86_64__) || defined(__i386__)) &&                             \
+    ((defined(__clang__) &&                                                   \
+      (__clang_major__ > 3 ||                                                 \
+       (__clang_major__ == 3 && __clang_minor__ >= 8))) ||                    \
+     (!defined(__clang__) && defined(__GNUC__) &&                             \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define NODE_SIMD_X86 1
+#define NODE_SIMD_TARGET(arch) __attribute__((target(arch)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define NODE_SIMD_X86 1
+#define NODE_SIMD_TARGET(arch)
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define NODE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if NODE_SIMD_X86 && (defined(__SSE2__) || defined(_M_X64) ||                 \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NODE_SIMD_SSE2 1
+#endif
+
+namespace node {
+namespace cpu {
+
+#if NODE_SIMD_X86
+enum Level {
+  kBaseline,
+  kSSSE3,
+  kAVX2
+};
+
+// The best of the levels above that the CPU and the OS support, looked up
+// once.
+Level GetLevel();
+#endif  // NODE_SIMD_X86
+
+}  // namespace cpu
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CPU_H_
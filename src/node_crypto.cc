@@ -25,6 +25,7 @@
 #include "node_crypto.h"
 #include "node_crypto_bio.h"
 #include "node_crypto_groups.h"
+#include "node_threadpool.h"
 #include "tls_wrap.h"  // TLSWrap
 
 #include "async-wrap.h"
@@ -49,6 +50,9 @@
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#include <vector>
 
 #define THROW_AND_RETURN_IF_NOT_STRING_OR_BUFFER(val, prefix)                  \
   do {                                                                         \
@@ -71,6 +75,8 @@
     }                                                         \
   } while (0)
 
+static const char kCipherBusy[] = "Cipher is busy with an asynchronous update";
+
 static const char PUBLIC_KEY_PFX[] =  "-----BEGIN PUBLIC KEY-----";
 static const int PUBLIC_KEY_PFX_LEN = sizeof(PUBLIC_KEY_PFX) - 1;
 static const char PUBRSA_KEY_PFX[] =  "-----BEGIN RSA PUBLIC KEY-----";
@@ -104,12 +110,15 @@ using v8::Isolate;
 using v8::Local;
 using v8::Maybe;
 using v8::Null;
+using v8::Number;
 using v8::Object;
 using v8::Persistent;
 using v8::PropertyAttribute;
 using v8::PropertyCallbackInfo;
 using v8::ReadOnly;
 using v8::String;
+using v8::Uint32;
+using v8::Undefined;
 using v8::Value;
 
 
@@ -309,6 +318,7 @@ void SecureContext::Initialize(Environment* env, Local<Object> target) {
   env->SetProtoMethod(t, "addCACert", SecureContext::AddCACert);
   env->SetProtoMethod(t, "addCRL", SecureContext::AddCRL);
   env->SetProtoMethod(t, "addRootCerts", SecureContext::AddRootCerts);
+  env->SetProtoMethod(t, "useCertStore", SecureContext::UseCertStore);
   env->SetProtoMethod(t, "setCiphers", SecureContext::SetCiphers);
   env->SetProtoMethod(t, "setECDHCurve", SecureContext::SetECDHCurve);
   env->SetProtoMethod(t, "setDHParam", SecureContext::SetDHParam);
@@ -325,6 +335,9 @@ void SecureContext::Initialize(Environment* env, Local<Object> target) {
   env->SetProtoMethod(t,
                       "enableTicketKeyCallback",
                       SecureContext::EnableTicketKeyCallback);
+  env->SetProtoMethod(t,
+                      "enableTicketKeyRotation",
+                      SecureContext::EnableTicketKeyRotation);
   env->SetProtoMethod(t, "getCertificate", SecureContext::GetCertificate<true>);
   env->SetProtoMethod(t, "getIssuer", SecureContext::GetCertificate<false>);
 
@@ -716,6 +729,26 @@ static int X509_up_ref(X509* cert) {
   CRYPTO_add(&cert->references, 1, CRYPTO_LOCK_X509);
   return 1;
 }
+
+static STACK_OF(X509_OBJECT)* X509_STORE_get0_objects(X509_STORE* store) {
+  return store->objs;
+}
+
+static X509_VERIFY_PARAM* X509_STORE_get0_param(X509_STORE* store) {
+  return store->param;
+}
+
+static int X509_OBJECT_get_type(const X509_OBJECT* obj) {
+  return obj->type;
+}
+
+static X509* X509_OBJECT_get0_X509(const X509_OBJECT* obj) {
+  return obj->data.x509;
+}
+
+static X509_CRL* X509_OBJECT_get0_X509_CRL(X509_OBJECT* obj) {
+  return obj->data.crl;
+}
 #endif  // OPENSSL_VERSION_NUMBER < 0x10100000L && !OPENSSL_IS_BORINGSSL
 
 
@@ -747,6 +780,37 @@ static X509_STORE* NewRootCertStore() {
 }
 
 
+// Copies the certificates, CRLs and verification flags of |src|.
+static X509_STORE* CopyCertStore(X509_STORE* src) {
+  X509_STORE* store = X509_STORE_new();
+  STACK_OF(X509_OBJECT)* objs = X509_STORE_get0_objects(src);
+  for (int i = 0; i < sk_X509_OBJECT_num(objs); i++) {
+    X509_OBJECT* obj = sk_X509_OBJECT_value(objs, i);
+    if (X509_OBJECT_get_type(obj) == X509_LU_X509)
+      X509_STORE_add_cert(store, X509_OBJECT_get0_X509(obj));
+    else if (X509_OBJECT_get_type(obj) == X509_LU_CRL)
+      X509_STORE_add_crl(store, X509_OBJECT_get0_X509_CRL(obj));
+  }
+  X509_STORE_set1_param(store, X509_STORE_get0_param(src));
+  return store;
+}
+
+
+X509_STORE* SecureContext::OwnCertStore() {
+  X509_STORE* store = SSL_CTX_get_cert_store(ctx_);
+  if (!cert_store_shared_)
+    return store;
+
+  if (store == root_cert_store)
+    store = NewRootCertStore();
+  else
+    store = CopyCertStore(store);
+  SSL_CTX_set_cert_store(ctx_, store);
+  cert_store_shared_ = false;
+  return store;
+}
+
+
 void SecureContext::AddCACert(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -764,14 +828,9 @@ void SecureContext::AddCACert(const FunctionCallbackInfo<Value>& args) {
     return;
   }
 
-  X509_STORE* cert_store = SSL_CTX_get_cert_store(sc->ctx_);
   while (X509* x509 =
              PEM_read_bio_X509(bio, nullptr, CryptoPemCallback, nullptr)) {
-    if (cert_store == root_cert_store) {
-      cert_store = NewRootCertStore();
-      SSL_CTX_set_cert_store(sc->ctx_, cert_store);
-    }
-    X509_STORE_add_cert(cert_store, x509);
+    X509_STORE_add_cert(sc->OwnCertStore(), x509);
     SSL_CTX_add_client_CA(sc->ctx_, x509);
     X509_free(x509);
   }
@@ -805,12 +864,7 @@ void SecureContext::AddCRL(const FunctionCallbackInfo<Value>& args) {
     return env->ThrowError("Failed to parse CRL");
   }
 
-  X509_STORE* cert_store = SSL_CTX_get_cert_store(sc->ctx_);
-  if (cert_store == root_cert_store) {
-    cert_store = NewRootCertStore();
-    SSL_CTX_set_cert_store(sc->ctx_, cert_store);
-  }
-
+  X509_STORE* cert_store = sc->OwnCertStore();
   X509_STORE_add_crl(cert_store, crl);
   X509_STORE_set_flags(cert_store,
                        X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
@@ -878,6 +932,35 @@ void SecureContext::AddRootCerts(const FunctionCallbackInfo<Value>& args) {
   // Increment reference count so global store is not deleted along with CTX.
   X509_STORE_up_ref(root_cert_store);
   SSL_CTX_set_cert_store(sc->ctx_, root_cert_store);
+  sc->cert_store_shared_ = true;
+}
+
+
+// Shares the certificate store, and the list of CA names sent to clients, of
+// another SecureContext. Both are copied first if either context adds to its
+// store later.
+void SecureContext::UseCertStore(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  SecureContext* sc;
+  ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
+
+  if (args.Length() != 1 || !args[0]->IsObject() ||
+      !env->secure_context_constructor_template()->HasInstance(args[0])) {
+    return env->ThrowTypeError("Argument must be a SecureContext");
+  }
+  SecureContext* other;
+  ASSIGN_OR_RETURN_UNWRAP(&other, args[0].As<Object>());
+
+  X509_STORE* store = SSL_CTX_get_cert_store(other->ctx_);
+  X509_STORE_up_ref(store);
+  SSL_CTX_set_cert_store(sc->ctx_, store);
+  sc->cert_store_shared_ = true;
+  other->cert_store_shared_ = true;
+
+  STACK_OF(X509_NAME)* names = SSL_CTX_get_client_CA_list(other->ctx_);
+  if (names != nullptr)
+    SSL_CTX_set_client_CA_list(sc->ctx_, SSL_dup_CA_list(names));
 }
 
 
@@ -1087,8 +1170,6 @@ void SecureContext::LoadPKCS12(const FunctionCallbackInfo<Value>& args) {
     sc->cert_ = nullptr;
   }
 
-  X509_STORE* cert_store = SSL_CTX_get_cert_store(sc->ctx_);
-
   if (d2i_PKCS12_bio(in, &p12) &&
       PKCS12_parse(p12, pass, &pkey, &cert, &extra_certs) &&
       SSL_CTX_use_certificate_chain(sc->ctx_,
@@ -1101,11 +1182,7 @@ void SecureContext::LoadPKCS12(const FunctionCallbackInfo<Value>& args) {
     for (int i = 0; i < sk_X509_num(extra_certs); i++) {
       X509* ca = sk_X509_value(extra_certs, i);
 
-      if (cert_store == root_cert_store) {
-        cert_store = NewRootCertStore();
-        SSL_CTX_set_cert_store(sc->ctx_, cert_store);
-      }
-      X509_STORE_add_cert(cert_store, ca);
+      X509_STORE_add_cert(sc->OwnCertStore(), ca);
       SSL_CTX_add_client_CA(sc->ctx_, ca);
     }
     ret = true;
@@ -1196,6 +1273,118 @@ void SecureContext::EnableTicketKeyCallback(
 }
 
 
+// Ticket keys are derived from a secret and the current rotation epoch, so
+// every context that shares the secret (e.g. the servers of all cluster
+// workers) encrypts and decrypts tickets with the same keys without having
+// to coordinate. Tickets issued during the previous epoch are still accepted
+// but get renewed.
+void SecureContext::EnableTicketKeyRotation(
+    const FunctionCallbackInfo<Value>& args) {
+  SecureContext* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  Environment* env = wrap->env();
+
+  THROW_AND_RETURN_IF_NOT_BUFFER(args[0], "Ticket key secret");
+
+  if (Buffer::Length(args[0]) == 0)
+    return env->ThrowTypeError("Ticket key secret must not be empty");
+
+  if (!args[1]->IsUint32() || args[1]->Uint32Value() == 0)
+    return env->ThrowTypeError("Rotation interval must be a positive integer");
+
+  // Hash the secret so that keys are derived from a fixed-length value
+  // regardless of what the user passed in.
+  unsigned int secret_len = 0;
+  if (!HMAC(EVP_sha256(),
+            Buffer::Data(args[0]),
+            Buffer::Length(args[0]),
+            reinterpret_cast<const unsigned char*>("node ticket keys"),
+            16,
+            wrap->ticket_key_secret_,
+            &secret_len) ||
+      secret_len != kTicketKeySecretLength) {
+    return env->ThrowError("Failed to derive ticket key secret");
+  }
+  wrap->ticket_key_interval_ = args[1]->Uint32Value();
+
+  SSL_CTX_set_tlsext_ticket_key_cb(wrap->ctx_, RotatingTicketKeyCallback);
+}
+
+
+void SecureContext::DeriveTicketKey(uint64_t epoch,
+                                    unsigned char* name,
+                                    unsigned char* hmac_key,
+                                    unsigned char* aes_key) {
+  static const int kTicketPartSize = 16;
+  static const char kLabels[] = { 'n', 'h', 'a' };
+  unsigned char* const parts[] = { name, hmac_key, aes_key };
+
+  unsigned char msg[9];
+  for (int i = 0; i < 8; i++)
+    msg[i] = static_cast<unsigned char>(epoch >> (56 - 8 * i));
+
+  for (size_t i = 0; i < arraysize(parts); i++) {
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int md_len = 0;
+    msg[8] = kLabels[i];
+    CHECK_NE(HMAC(EVP_sha256(),
+                  ticket_key_secret_,
+                  kTicketKeySecretLength,
+                  msg,
+                  sizeof(msg),
+                  md,
+                  &md_len), nullptr);
+    memcpy(parts[i], md, kTicketPartSize);
+  }
+}
+
+
+int SecureContext::RotatingTicketKeyCallback(SSL* ssl,
+                                             unsigned char* name,
+                                             unsigned char* iv,
+                                             EVP_CIPHER_CTX* ectx,
+                                             HMAC_CTX* hctx,
+                                             int enc) {
+  static const int kTicketPartSize = 16;
+
+  SecureContext* sc = static_cast<SecureContext*>(
+      SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+
+  const uint64_t epoch = static_cast<uint64_t>(time(nullptr)) /
+                         sc->ticket_key_interval_;
+  unsigned char key_name[kTicketPartSize];
+  unsigned char hmac_key[kTicketPartSize];
+  unsigned char aes_key[kTicketPartSize];
+  int r = 1;
+
+  sc->DeriveTicketKey(epoch, key_name, hmac_key, aes_key);
+  if (enc) {
+    if (RAND_bytes(iv, kTicketPartSize) <= 0)
+      return -1;
+    memcpy(name, key_name, kTicketPartSize);
+  } else {
+    if (CRYPTO_memcmp(name, key_name, kTicketPartSize) != 0) {
+      // Accept tickets from the previous epoch, but ask for a new ticket.
+      if (epoch == 0)
+        return 0;
+      sc->DeriveTicketKey(epoch - 1, key_name, hmac_key, aes_key);
+      if (CRYPTO_memcmp(name, key_name, kTicketPartSize) != 0)
+        return 0;
+      r = 2;
+    }
+  }
+
+  HMAC_Init_ex(hctx, hmac_key, kTicketPartSize, EVP_sha256(), nullptr);
+  if (enc) {
+    EVP_EncryptInit_ex(ectx, EVP_aes_128_cbc(), nullptr, aes_key, iv);
+  } else {
+    EVP_DecryptInit_ex(ectx, EVP_aes_128_cbc(), nullptr, aes_key, iv);
+  }
+
+  return r;
+}
+
+
 int SecureContext::TicketKeyCallback(SSL* ssl,
                                      unsigned char* name,
                                      unsigned char* iv,
@@ -1315,6 +1504,7 @@ void SSLWrap<Base>::AddMethods(Environment* env, Local<FunctionTemplate> t) {
   HandleScope scope(env->isolate());
 
   env->SetProtoMethod(t, "getPeerCertificate", GetPeerCertificate);
+  env->SetProtoMethod(t, "getPeerCertificateKey", GetPeerCertificateKey);
   env->SetProtoMethod(t, "getSession", GetSession);
   env->SetProtoMethod(t, "setSession", SetSession);
   env->SetProtoMethod(t, "loadSession", LoadSession);
@@ -1397,13 +1587,13 @@ SSL_SESSION* SSLWrap<Base>::GetSessionCallback(SSL* s,
 template <class Base>
 int SSLWrap<Base>::NewSessionCallback(SSL* s, SSL_SESSION* sess) {
   Base* w = static_cast<Base*>(SSL_get_app_data(s));
+  if (!w->session_callbacks_)
+    return 0;
+
   Environment* env = w->ssl_env();
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
 
-  if (!w->session_callbacks_)
-    return 0;
-
   // Check if session is small enough to be stored
   int size = i2d_SSL_SESSION(sess, nullptr);
   if (size > SecureContext::kMaxSessionSize)
@@ -1501,6 +1691,33 @@ static bool SafeX509ExtPrint(BIO* out, X509_EXTENSION* ext) {
 }
 
 
+// Writes the colon separated |digest| fingerprint of |cert| to |fingerprint|.
+static bool GetFingerprint(X509* cert,
+                           const EVP_MD* digest,
+                           char fingerprint[EVP_MAX_MD_SIZE * 3]) {
+  unsigned int md_size, i;
+  unsigned char md[EVP_MAX_MD_SIZE];
+  if (!X509_digest(cert, digest, md, &md_size))
+    return false;
+
+  const char hex[] = "0123456789ABCDEF";
+
+  // TODO(indutny): Unify it with buffer's code
+  for (i = 0; i < md_size; i++) {
+    fingerprint[3*i] = hex[(md[i] & 0xf0) >> 4];
+    fingerprint[(3*i)+1] = hex[(md[i] & 0x0f)];
+    fingerprint[(3*i)+2] = ':';
+  }
+
+  if (md_size > 0) {
+    fingerprint[(3*(md_size-1))+2] = '\0';
+  } else {
+    fingerprint[0] = '\0';
+  }
+  return true;
+}
+
+
 static Local<Object> X509ToObject(Environment* env, X509* cert) {
   EscapableHandleScope scope(env->isolate());
 
@@ -1607,25 +1824,8 @@ static Local<Object> X509ToObject(Environment* env, X509* cert) {
                                 String::kNormalString, mem->length));
   BIO_free_all(bio);
 
-  unsigned int md_size, i;
-  unsigned char md[EVP_MAX_MD_SIZE];
-  if (X509_digest(cert, EVP_sha1(), md, &md_size)) {
-    const char hex[] = "0123456789ABCDEF";
-    char fingerprint[EVP_MAX_MD_SIZE * 3];
-
-    // TODO(indutny): Unify it with buffer's code
-    for (i = 0; i < md_size; i++) {
-      fingerprint[3*i] = hex[(md[i] & 0xf0) >> 4];
-      fingerprint[(3*i)+1] = hex[(md[i] & 0x0f)];
-      fingerprint[(3*i)+2] = ':';
-    }
-
-    if (md_size > 0) {
-      fingerprint[(3*(md_size-1))+2] = '\0';
-    } else {
-      fingerprint[0] = '\0';
-    }
-
+  char fingerprint[EVP_MAX_MD_SIZE * 3];
+  if (GetFingerprint(cert, EVP_sha1(), fingerprint)) {
     info->Set(env->fingerprint_string(),
               OneByteString(env->isolate(), fingerprint));
   }
@@ -1778,6 +1978,54 @@ void SSLWrap<Base>::GetPeerCertificate(
 }
 
 
+// Identifies what getPeerCertificate() would return, without converting any
+// certificate: the SHA-256 fingerprint of the peer certificate, or with
+// |detailed| the fingerprints of every certificate the peer sent. SHA-1 would
+// be cheaper, but then a colliding certificate could take the place of
+// another in the cache. Returns undefined when there is no peer certificate.
+template <class Base>
+void SSLWrap<Base>::GetPeerCertificateKey(
+    const FunctionCallbackInfo<Value>& args) {
+  Base* w;
+  ASSIGN_OR_RETURN_UNWRAP(&w, args.Holder());
+  Environment* env = w->ssl_env();
+
+  ClearErrorOnReturn clear_error_on_return;
+  (void) &clear_error_on_return;  // Silence unused variable warning.
+
+  // See GetPeerCertificate() for why the server is different.
+  X509* cert = w->is_server() ? SSL_get_peer_certificate(w->ssl_) : nullptr;
+  STACK_OF(X509)* ssl_certs = SSL_get_peer_cert_chain(w->ssl_);
+  const int count = ssl_certs == nullptr ? 0 : sk_X509_num(ssl_certs);
+  const bool detailed = args[0]->IsTrue();
+
+  std::string key;
+  char fingerprint[EVP_MAX_MD_SIZE * 3];
+  bool ok = true;
+  if (cert != nullptr) {
+    ok = GetFingerprint(cert, EVP_sha256(), fingerprint);
+    if (ok)
+      key = fingerprint;
+    X509_free(cert);
+    cert = nullptr;
+  }
+  for (int i = 0; ok && i < count && (detailed || key.empty()); i++) {
+    ok = GetFingerprint(sk_X509_value(ssl_certs, i),
+                        EVP_sha256(),
+                        fingerprint);
+    if (!ok)
+      break;
+    if (!key.empty())
+      key += ' ';
+    key += fingerprint;
+  }
+
+  if (ok && !key.empty())
+    args.GetReturnValue().Set(OneByteString(env->isolate(), key.data(),
+                                            key.size()));
+}
+
+
 template <class Base>
 void SSLWrap<Base>::GetSession(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -2264,18 +2512,10 @@ int SSLWrap<Base>::SelectALPNCallback(SSL* s,
                                       unsigned int inlen,
                                       void* arg) {
   Base* w = static_cast<Base*>(SSL_get_app_data(s));
-  Environment* env = w->env();
-  HandleScope handle_scope(env->isolate());
-  Context::Scope context_scope(env->context());
 
-  Local<Value> alpn_buffer =
-      w->object()->GetPrivate(
-          env->context(),
-          env->alpn_buffer_private_symbol()).ToLocalChecked();
-  CHECK(Buffer::HasInstance(alpn_buffer));
   const unsigned char* alpn_protos =
-      reinterpret_cast<const unsigned char*>(Buffer::Data(alpn_buffer));
-  unsigned alpn_protos_len = Buffer::Length(alpn_buffer);
+      reinterpret_cast<const unsigned char*>(w->alpn_protos_.data());
+  unsigned alpn_protos_len = w->alpn_protos_.size();
   int status = SSL_select_next_proto(const_cast<unsigned char**>(out), outlen,
                                      alpn_protos, alpn_protos_len, in, inlen);
 
@@ -2334,11 +2574,8 @@ void SSLWrap<Base>::SetALPNProtocols(
     int r = SSL_set_alpn_protos(w->ssl_, alpn_protos, alpn_protos_len);
     CHECK_EQ(r, 0);
   } else {
-    CHECK(
-        w->object()->SetPrivate(
-          env->context(),
-          env->alpn_buffer_private_symbol(),
-          args[0]).FromJust());
+    // Kept natively so that SelectALPNCallback doesn't need to call into V8.
+    w->alpn_protos_.assign(Buffer::Data(args[0]), Buffer::Length(args[0]));
     // Server should select ALPN protocol from list of advertised by client
     SSL_CTX_set_alpn_select_cb(SSL_get_SSL_CTX(w->ssl_), SelectALPNCallback,
                                nullptr);
@@ -2351,6 +2588,12 @@ void SSLWrap<Base>::SetALPNProtocols(
 template <class Base>
 int SSLWrap<Base>::TLSExtStatusCallback(SSL* s, void* arg) {
   Base* w = static_cast<Base*>(SSL_get_app_data(s));
+
+  // A server without an OCSP response to staple has nothing to do, and
+  // doesn't need to enter V8 for it.
+  if (w->is_server() && w->ocsp_response_.IsEmpty())
+    return SSL_TLSEXT_ERR_NOACK;
+
   Environment* env = w->env();
   HandleScope handle_scope(env->isolate());
 
@@ -2374,9 +2617,6 @@ int SSLWrap<Base>::TLSExtStatusCallback(SSL* s, void* arg) {
     return 1;
   } else {
     // Outgoing response
-    if (w->ocsp_response_.IsEmpty())
-      return SSL_TLSEXT_ERR_NOACK;
-
     Local<Object> obj = PersistentToLocal(env->isolate(), w->ocsp_response_);
     char* resp = Buffer::Data(obj);
     size_t len = Buffer::Length(obj);
@@ -3291,6 +3531,7 @@ void CipherBase::Initialize(Environment* env, Local<Object> target) {
   env->SetProtoMethod(t, "init", Init);
   env->SetProtoMethod(t, "initiv", InitIv);
   env->SetProtoMethod(t, "update", Update);
+  env->SetProtoMethod(t, "updateAsync", UpdateAsync);
   env->SetProtoMethod(t, "final", Final);
   env->SetProtoMethod(t, "setAutoPadding", SetAutoPadding);
   env->SetProtoMethod(t, "getAuthTag", GetAuthTag);
@@ -3468,6 +3709,9 @@ void CipherBase::GetAuthTag(const FunctionCallbackInfo<Value>& args) {
   CipherBase* cipher;
   ASSIGN_OR_RETURN_UNWRAP(&cipher, args.Holder());
 
+  if (cipher->busy_)
+    return env->ThrowError(kCipherBusy);
+
   char* out = nullptr;
   unsigned int out_len = 0;
 
@@ -3499,6 +3743,9 @@ void CipherBase::SetAuthTag(const FunctionCallbackInfo<Value>& args) {
   CipherBase* cipher;
   ASSIGN_OR_RETURN_UNWRAP(&cipher, args.Holder());
 
+  if (cipher->busy_)
+    return env->ThrowError(kCipherBusy);
+
   if (!cipher->SetAuthTag(Buffer::Data(args[0]), Buffer::Length(args[0])))
     env->ThrowError("Attempting to set auth tag in unsupported state");
 }
@@ -3527,6 +3774,9 @@ void CipherBase::SetAAD(const FunctionCallbackInfo<Value>& args) {
   CipherBase* cipher;
   ASSIGN_OR_RETURN_UNWRAP(&cipher, args.Holder());
 
+  if (cipher->busy_)
+    return env->ThrowError(kCipherBusy);
+
   if (!cipher->SetAAD(Buffer::Data(args[0]), Buffer::Length(args[0])))
     env->ThrowError("Attempting to set AAD in unsupported state");
 }
@@ -3550,7 +3800,7 @@ bool CipherBase::Update(const char* data,
   }
 
   *out_len = len + EVP_CIPHER_CTX_block_size(&ctx_);
-  *out = new unsigned char[*out_len];
+  *out = reinterpret_cast<unsigned char*>(node::Malloc(*out_len));
   return EVP_CipherUpdate(&ctx_,
                           *out,
                           out_len,
@@ -3567,6 +3817,9 @@ void CipherBase::Update(const FunctionCallbackInfo<Value>& args) {
 
   THROW_AND_RETURN_IF_NOT_STRING_OR_BUFFER(args[0], "Cipher data");
 
+  if (cipher->busy_)
+    return env->ThrowError(kCipherBusy);
+
   unsigned char* out = nullptr;
   bool r;
   int out_len = 0;
@@ -3584,22 +3837,184 @@ void CipherBase::Update(const FunctionCallbackInfo<Value>& args) {
   }
 
   if (!r) {
-    delete[] out;
+    free(out);
     return ThrowCryptoError(env,
                             ERR_get_error(),
                             "Trying to add data in unsupported state");
   }
 
   CHECK(out != nullptr || out_len == 0);
+  // The buffer takes ownership of the output instead of copying it.
   Local<Object> buf =
-      Buffer::Copy(env, reinterpret_cast<char*>(out), out_len).ToLocalChecked();
-  if (out)
-    delete[] out;
+      Buffer::New(env, reinterpret_cast<char*>(out), out_len).ToLocalChecked();
 
   args.GetReturnValue().Set(buf);
 }
 
 
+// Base of the operations that run on the threadpool and report back through
+// ondone(err, result). The work may only touch state that the job owns, or
+// that the job keeps alive and nothing else uses until it is done.
+class CryptoJob : public AsyncWrap {
+ public:
+  ~CryptoJob() override {
+    ClearWrap(object());
+    persistent().Reset();
+  }
+
+  // Creates the object that a job calls |callback| on.
+  static Local<Object> NewObject(Environment* env, Local<Value> callback) {
+    CHECK(callback->IsFunction());
+    Local<Object> obj = env->NewInternalFieldObject();
+    obj->Set(env->ondone_string(), callback);
+    if (env->in_domain())
+      obj->Set(env->domain_string(), env->domain_array()->Get(0));
+    return obj;
+  }
+
+  void Queue() {
+    CHECK_EQ(threadpool::QueueWork(env()->event_loop(),
+                                   &work_req_,
+                                   threadpool::kCpuWork,
+                                   threadpool::kNormalPriority,
+                                   Work,
+                                   After,
+                                   NODE_THREADPOOL_TRACE_CRYPTO,
+                                   "crypto.job"), 0);
+  }
+
+ protected:
+  CryptoJob(Environment* env, Local<Object> object, const char* default_error)
+      : AsyncWrap(env, object, AsyncWrap::PROVIDER_CRYPTO),
+        default_error_(default_error),
+        ok_(false),
+        error_(0) {
+    Wrap(object, this);
+  }
+
+  // Runs on the threadpool.
+  virtual bool DoWork() = 0;
+  // Runs on the loop thread, before the callback, whether DoWork() succeeded
+  // or not.
+  virtual void Done() {}
+  // Runs on the loop thread if DoWork() succeeded.
+  virtual Local<Value> Result() = 0;
+
+ private:
+  static void Work(uv_work_t* work_req) {
+    CryptoJob* job = ContainerOf(&CryptoJob::work_req_, work_req);
+    job->ok_ = job->DoWork();
+    // The error queue is per thread.
+    if (!job->ok_)
+      job->error_ = ERR_get_error();
+    ERR_clear_error();
+  }
+
+  static void After(uv_work_t* work_req, int status) {
+    CHECK_EQ(status, 0);
+    CryptoJob* job = ContainerOf(&CryptoJob::work_req_, work_req);
+    Environment* env = job->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    job->Done();
+
+    Local<Value> argv[2];
+    if (job->ok_) {
+      argv[0] = Null(env->isolate());
+      argv[1] = job->Result();
+    } else {
+      char message[256];
+      if (job->error_ != 0)
+        ERR_error_string_n(job->error_, message, sizeof(message));
+      else
+        snprintf(message, sizeof(message), "%s", job->default_error_);
+      argv[0] = Exception::Error(OneByteString(env->isolate(), message));
+      argv[1] = Undefined(env->isolate());
+    }
+
+    job->MakeCallback(env->ondone_string(), arraysize(argv), argv);
+    delete job;
+  }
+
+  uv_work_t work_req_;
+  const char* const default_error_;
+  bool ok_;
+  unsigned long error_;  // NOLINT(runtime/int)
+};
+
+
+// Runs CipherBase::Update() on the threadpool. The input Buffer isn't copied,
+// it is kept alive, and the cipher busy, until the job is done.
+class CipherJob : public CryptoJob {
+ public:
+  CipherJob(Environment* env,
+            Local<Object> object,
+            CipherBase* cipher,
+            Local<Object> data)
+      : CryptoJob(env, object, "Trying to add data in unsupported state"),
+        cipher_(cipher),
+        cipher_object_(env->isolate(), cipher->object()),
+        data_object_(env->isolate(), data),
+        data_(Buffer::Data(data)),
+        data_len_(Buffer::Length(data)),
+        out_(nullptr),
+        out_len_(0) {
+    cipher_->busy_ = true;
+  }
+
+  ~CipherJob() override {
+    free(out_);
+    cipher_object_.Reset();
+    data_object_.Reset();
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  bool DoWork() override {
+    return cipher_->Update(data_, data_len_, &out_, &out_len_);
+  }
+
+  void Done() override {
+    cipher_->busy_ = false;
+  }
+
+  Local<Value> Result() override {
+    Local<Object> buf = Buffer::New(env(),
+                                    reinterpret_cast<char*>(out_),
+                                    out_len_).ToLocalChecked();
+    out_ = nullptr;
+    return buf;
+  }
+
+  CipherBase* const cipher_;
+  Persistent<Object> cipher_object_;
+  Persistent<Object> data_object_;
+  const char* const data_;
+  const size_t data_len_;
+  unsigned char* out_;
+  int out_len_;
+};
+
+
+void CipherBase::UpdateAsync(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CipherBase* cipher;
+  ASSIGN_OR_RETURN_UNWRAP(&cipher, args.Holder());
+
+  THROW_AND_RETURN_IF_NOT_BUFFER(args[0], "Cipher data");
+
+  if (cipher->busy_)
+    return env->ThrowError(kCipherBusy);
+
+  Local<Object> obj = CryptoJob::NewObject(env, args[1]);
+  CipherJob* job = new CipherJob(env, obj, cipher, args[0].As<Object>());
+  job->Queue();
+}
+
+
 bool CipherBase::SetAutoPadding(bool auto_padding) {
   if (!initialised_)
     return false;
@@ -3613,6 +4028,9 @@ void CipherBase::SetAutoPadding(const FunctionCallbackInfo<Value>& args) {
   CipherBase* cipher;
   ASSIGN_OR_RETURN_UNWRAP(&cipher, args.Holder());
 
+  if (cipher->busy_)
+    return env->ThrowError(kCipherBusy);
+
   if (!cipher->SetAutoPadding(args.Length() < 1 || args[0]->BooleanValue()))
     env->ThrowError("Attempting to set auto padding in unsupported state");
 }
@@ -3652,6 +4070,9 @@ void CipherBase::Final(const FunctionCallbackInfo<Value>& args) {
   CipherBase* cipher;
   ASSIGN_OR_RETURN_UNWRAP(&cipher, args.Holder());
 
+  if (cipher->busy_)
+    return env->ThrowError(kCipherBusy);
+
   unsigned char* out_value = nullptr;
   int out_len = -1;
   Local<Value> outString;
@@ -3682,74 +4103,333 @@ void CipherBase::Final(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-void Hmac::Initialize(Environment* env, v8::Local<v8::Object> target) {
+void AEAD::Initialize(Environment* env, Local<Object> target) {
   Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
 
   t->InstanceTemplate()->SetInternalFieldCount(1);
 
-  env->SetProtoMethod(t, "init", HmacInit);
-  env->SetProtoMethod(t, "update", HmacUpdate);
-  env->SetProtoMethod(t, "digest", HmacDigest);
+  env->SetProtoMethod(t, "init", Init);
+  env->SetProtoMethod(t, "seal", Seal);
+  env->SetProtoMethod(t, "open", Open);
 
-  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "Hmac"), t->GetFunction());
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "AEAD"),
+              t->GetFunction());
 }
 
 
-void Hmac::New(const FunctionCallbackInfo<Value>& args) {
+void AEAD::New(const FunctionCallbackInfo<Value>& args) {
+  CHECK_EQ(args.IsConstructCall(), true);
   Environment* env = Environment::GetCurrent(args);
-  new Hmac(env, args.This());
+  new AEAD(env, args.This());
 }
 
 
-void Hmac::HmacInit(const char* hash_type, const char* key, int key_len) {
+void AEAD::Init(const char* cipher_type,
+                const char* key,
+                int key_len,
+                unsigned int auth_tag_len) {
   HandleScope scope(env()->isolate());
 
   CHECK_EQ(initialised_, false);
-  const EVP_MD* md = EVP_get_digestbyname(hash_type);
-  if (md == nullptr) {
-    return env()->ThrowError("Unknown message digest");
+  const EVP_CIPHER* cipher = EVP_get_cipherbyname(cipher_type);
+  if (cipher == nullptr) {
+    return env()->ThrowError("Unknown cipher");
   }
-  HMAC_CTX_init(&ctx_);
-  if (key_len == 0) {
-    key = "";
+  if (EVP_CIPHER_mode(cipher) != EVP_CIPH_GCM_MODE) {
+    return env()->ThrowError("Unsupported AEAD cipher");
   }
-  if (!HMAC_Init_ex(&ctx_, key, key_len, md, nullptr)) {
-    return ThrowCryptoError(env(), ERR_get_error());
+  if (auth_tag_len < 4 || auth_tag_len > EVP_GCM_TLS_TAG_LEN) {
+    return env()->ThrowError("Invalid auth tag length");
+  }
+
+  EVP_CIPHER_CTX_init(&ctx_);
+  EVP_CipherInit_ex(&ctx_, cipher, nullptr, nullptr, nullptr, 1);
+  if (!EVP_CIPHER_CTX_set_key_length(&ctx_, key_len)) {
+    EVP_CIPHER_CTX_cleanup(&ctx_);
+    return env()->ThrowError("Invalid key length");
   }
+
+  EVP_CipherInit_ex(&ctx_,
+                    nullptr,
+                    nullptr,
+                    reinterpret_cast<const unsigned char*>(key),
+                    nullptr,
+                    1);
+  auth_tag_len_ = auth_tag_len;
+  iv_len_ = EVP_CIPHER_CTX_iv_length(&ctx_);
   initialised_ = true;
 }
 
 
-void Hmac::HmacInit(const FunctionCallbackInfo<Value>& args) {
-  Hmac* hmac;
-  ASSIGN_OR_RETURN_UNWRAP(&hmac, args.Holder());
-  Environment* env = hmac->env();
-
-  if (args.Length() < 2) {
-    return env->ThrowError("Hash type and key arguments are mandatory");
-  }
+void AEAD::Init(const FunctionCallbackInfo<Value>& args) {
+  AEAD* aead;
+  ASSIGN_OR_RETURN_UNWRAP(&aead, args.Holder());
+  Environment* env = aead->env();
 
-  THROW_AND_RETURN_IF_NOT_STRING(args[0], "Hash type");
+  THROW_AND_RETURN_IF_NOT_STRING(args[0], "Cipher type");
   THROW_AND_RETURN_IF_NOT_BUFFER(args[1], "Key");
+  if (!args[2]->IsUint32()) {
+    return env->ThrowTypeError("Auth tag length must be an integer");
+  }
 
-  const node::Utf8Value hash_type(env->isolate(), args[0]);
-  const char* buffer_data = Buffer::Data(args[1]);
-  size_t buffer_length = Buffer::Length(args[1]);
-  hmac->HmacInit(*hash_type, buffer_data, buffer_length);
+  const node::Utf8Value cipher_type(env->isolate(), args[0]);
+  aead->Init(*cipher_type,
+             Buffer::Data(args[1]),
+             Buffer::Length(args[1]),
+             args[2]->Uint32Value(env->context()).FromJust());
 }
 
 
-bool Hmac::HmacUpdate(const char* data, int len) {
-  if (!initialised_)
+bool AEAD::SetIv(const char* iv, int iv_len, bool encrypt) {
+  if (iv_len != iv_len_) {
+    if (!EVP_CIPHER_CTX_ctrl(&ctx_, EVP_CTRL_GCM_SET_IVLEN, iv_len, nullptr))
+      return false;
+    iv_len_ = iv_len;
+  }
+  // Without a key, the key schedule from Init() is kept and only the IV and
+  // the direction change.
+  return EVP_CipherInit_ex(&ctx_,
+                           nullptr,
+                           nullptr,
+                           nullptr,
+                           reinterpret_cast<const unsigned char*>(iv),
+                           encrypt) == 1;
+}
+
+
+// |out| has room for |len| bytes and the auth tag. EVP_CipherUpdate() with no
+// input means finishing the message for GCM, so empty data and AAD are left
+// out.
+bool AEAD::Seal(const char* iv,
+                int iv_len,
+                const char* data,
+                int len,
+                const char* aad,
+                int aad_len,
+                unsigned char* out) {
+  int out_len;
+  if (!SetIv(iv, iv_len, true))
     return false;
-  int r = HMAC_Update(&ctx_, reinterpret_cast<const unsigned char*>(data), len);
-  return r == 1;
-}
-
-
-void Hmac::HmacUpdate(const FunctionCallbackInfo<Value>& args) {
-  Environment* env = Environment::GetCurrent(args);
-
+  if (aad_len > 0 &&
+      !EVP_CipherUpdate(&ctx_,
+                        nullptr,
+                        &out_len,
+                        reinterpret_cast<const unsigned char*>(aad),
+                        aad_len)) {
+    return false;
+  }
+  if (len > 0 &&
+      !EVP_CipherUpdate(&ctx_,
+                        out,
+                        &out_len,
+                        reinterpret_cast<const unsigned char*>(data),
+                        len)) {
+    return false;
+  }
+  if (!EVP_CipherFinal_ex(&ctx_, out + len, &out_len))
+    return false;
+  return EVP_CIPHER_CTX_ctrl(&ctx_,
+                             EVP_CTRL_GCM_GET_TAG,
+                             auth_tag_len_,
+                             out + len) == 1;
+}
+
+
+// |data| ends in the auth tag, and |out| has room for the rest of it.
+bool AEAD::Open(const char* iv,
+                int iv_len,
+                const char* data,
+                int len,
+                const char* aad,
+                int aad_len,
+                unsigned char* out) {
+  int out_len;
+  const int text_len = len - auth_tag_len_;
+  CHECK_GE(text_len, 0);
+  if (!SetIv(iv, iv_len, false))
+    return false;
+  if (!EVP_CIPHER_CTX_ctrl(&ctx_,
+                           EVP_CTRL_GCM_SET_TAG,
+                           auth_tag_len_,
+                           const_cast<char*>(data + text_len))) {
+    return false;
+  }
+  if (aad_len > 0 &&
+      !EVP_CipherUpdate(&ctx_,
+                        nullptr,
+                        &out_len,
+                        reinterpret_cast<const unsigned char*>(aad),
+                        aad_len)) {
+    return false;
+  }
+  if (text_len > 0 &&
+      !EVP_CipherUpdate(&ctx_,
+                        out,
+                        &out_len,
+                        reinterpret_cast<const unsigned char*>(data),
+                        text_len)) {
+    return false;
+  }
+  return EVP_CipherFinal_ex(&ctx_, out + text_len, &out_len) == 1;
+}
+
+
+// seal(iv, data[, aad]) returns the ciphertext of |data| followed by the auth
+// tag.
+void AEAD::Seal(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  AEAD* aead;
+  ASSIGN_OR_RETURN_UNWRAP(&aead, args.Holder());
+
+  THROW_AND_RETURN_IF_NOT_BUFFER(args[0], "IV");
+  THROW_AND_RETURN_IF_NOT_BUFFER(args[1], "Data");
+  const char* aad = nullptr;
+  size_t aad_len = 0;
+  if (!args[2]->IsUndefined()) {
+    THROW_AND_RETURN_IF_NOT_BUFFER(args[2], "AAD");
+    aad = Buffer::Data(args[2]);
+    aad_len = Buffer::Length(args[2]);
+  }
+
+  if (!aead->initialised_)
+    return env->ThrowError("Not initialised");
+  if (Buffer::Length(args[0]) == 0)
+    return env->ThrowError("Invalid IV length");
+
+  const size_t len = Buffer::Length(args[1]);
+  const size_t out_len = len + aead->auth_tag_len_;
+  if (out_len > Buffer::kMaxLength)
+    return env->ThrowRangeError("Data is too long");
+
+  char* out = node::Malloc(out_len);
+  if (!aead->Seal(Buffer::Data(args[0]),
+                  Buffer::Length(args[0]),
+                  Buffer::Data(args[1]),
+                  len,
+                  aad,
+                  aad_len,
+                  reinterpret_cast<unsigned char*>(out))) {
+    free(out);
+    return ThrowCryptoError(env, ERR_get_error(), "Unsupported state");
+  }
+  args.GetReturnValue().Set(Buffer::New(env, out, out_len).ToLocalChecked());
+}
+
+
+// open(iv, data[, aad]) returns the plaintext of a message that seal()
+// returned, or throws if it does not authenticate.
+void AEAD::Open(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  AEAD* aead;
+  ASSIGN_OR_RETURN_UNWRAP(&aead, args.Holder());
+
+  THROW_AND_RETURN_IF_NOT_BUFFER(args[0], "IV");
+  THROW_AND_RETURN_IF_NOT_BUFFER(args[1], "Data");
+  const char* aad = nullptr;
+  size_t aad_len = 0;
+  if (!args[2]->IsUndefined()) {
+    THROW_AND_RETURN_IF_NOT_BUFFER(args[2], "AAD");
+    aad = Buffer::Data(args[2]);
+    aad_len = Buffer::Length(args[2]);
+  }
+
+  if (!aead->initialised_)
+    return env->ThrowError("Not initialised");
+  if (Buffer::Length(args[0]) == 0)
+    return env->ThrowError("Invalid IV length");
+
+  const size_t len = Buffer::Length(args[1]);
+  if (len < aead->auth_tag_len_)
+    return env->ThrowError("Unsupported state or unable to authenticate data");
+
+  const size_t out_len = len - aead->auth_tag_len_;
+  char* out = node::Malloc(out_len);
+  if (!aead->Open(Buffer::Data(args[0]),
+                  Buffer::Length(args[0]),
+                  Buffer::Data(args[1]),
+                  len,
+                  aad,
+                  aad_len,
+                  reinterpret_cast<unsigned char*>(out))) {
+    free(out);
+    return ThrowCryptoError(env,
+                            ERR_get_error(),
+                            "Unsupported state or unable to authenticate data");
+  }
+  args.GetReturnValue().Set(Buffer::New(env, out, out_len).ToLocalChecked());
+}
+
+
+void Hmac::Initialize(Environment* env, v8::Local<v8::Object> target) {
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+
+  env->SetProtoMethod(t, "init", HmacInit);
+  env->SetProtoMethod(t, "update", HmacUpdate);
+  env->SetProtoMethod(t, "digest", HmacDigest);
+
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "Hmac"), t->GetFunction());
+}
+
+
+void Hmac::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  new Hmac(env, args.This());
+}
+
+
+void Hmac::HmacInit(const char* hash_type, const char* key, int key_len) {
+  HandleScope scope(env()->isolate());
+
+  CHECK_EQ(initialised_, false);
+  const EVP_MD* md = EVP_get_digestbyname(hash_type);
+  if (md == nullptr) {
+    return env()->ThrowError("Unknown message digest");
+  }
+  HMAC_CTX_init(&ctx_);
+  if (key_len == 0) {
+    key = "";
+  }
+  if (!HMAC_Init_ex(&ctx_, key, key_len, md, nullptr)) {
+    return ThrowCryptoError(env(), ERR_get_error());
+  }
+  initialised_ = true;
+}
+
+
+void Hmac::HmacInit(const FunctionCallbackInfo<Value>& args) {
+  Hmac* hmac;
+  ASSIGN_OR_RETURN_UNWRAP(&hmac, args.Holder());
+  Environment* env = hmac->env();
+
+  if (args.Length() < 2) {
+    return env->ThrowError("Hash type and key arguments are mandatory");
+  }
+
+  THROW_AND_RETURN_IF_NOT_STRING(args[0], "Hash type");
+  THROW_AND_RETURN_IF_NOT_BUFFER(args[1], "Key");
+
+  const node::Utf8Value hash_type(env->isolate(), args[0]);
+  const char* buffer_data = Buffer::Data(args[1]);
+  size_t buffer_length = Buffer::Length(args[1]);
+  hmac->HmacInit(*hash_type, buffer_data, buffer_length);
+}
+
+
+bool Hmac::HmacUpdate(const char* data, int len) {
+  if (!initialised_)
+    return false;
+  int r = HMAC_Update(&ctx_, reinterpret_cast<const unsigned char*>(data), len);
+  return r == 1;
+}
+
+
+void Hmac::HmacUpdate(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
   Hmac* hmac;
   ASSIGN_OR_RETURN_UNWRAP(&hmac, args.Holder());
 
@@ -4112,16 +4792,32 @@ static int Node_SignFinal(EVP_MD_CTX* mdctx, unsigned char* md,
                              pkey->pkey.ptr);
 }
 
-SignBase::Error Sign::SignFinal(const char* key_pem,
-                                int key_pem_len,
-                                const char* passphrase,
-                                unsigned char** sig,
-                                unsigned int* sig_len,
-                                int padding,
-                                int salt_len) {
+SignBase::Error SignBase::MoveContext(EVP_MD_CTX* ctx) {
   if (!initialised_)
     return kSignNotInitialised;
 
+  EVP_MD_CTX_init(ctx);
+  int r = EVP_MD_CTX_copy_ex(ctx, &mdctx_);
+  EVP_MD_CTX_cleanup(&mdctx_);
+  initialised_ = false;
+  if (!r) {
+    EVP_MD_CTX_cleanup(ctx);
+    return kSignInit;
+  }
+  return kSignOk;
+}
+
+
+// Computes the signature over the digest in |mdctx|, without cleaning it up.
+// Safe to call from the threadpool.
+static SignBase::Error SignWithContext(EVP_MD_CTX* mdctx,
+                                       const char* key_pem,
+                                       int key_pem_len,
+                                       const char* passphrase,
+                                       unsigned char** sig,
+                                       unsigned int* sig_len,
+                                       int padding,
+                                       int salt_len) {
   BIO* bp = nullptr;
   EVP_PKEY* pkey = nullptr;
   bool fatal = true;
@@ -4164,26 +4860,103 @@ SignBase::Error Sign::SignFinal(const char* key_pem,
   }
 #endif  // NODE_FIPS_MODE
 
-  if (Node_SignFinal(&mdctx_, *sig, sig_len, pkey, padding, salt_len))
+  if (Node_SignFinal(mdctx, *sig, sig_len, pkey, padding, salt_len))
     fatal = false;
 
-  initialised_ = false;
-
  exit:
   if (pkey != nullptr)
     EVP_PKEY_free(pkey);
   if (bp != nullptr)
     BIO_free_all(bp);
 
-  EVP_MD_CTX_cleanup(&mdctx_);
-
   if (fatal)
-    return kSignPrivateKey;
+    return SignBase::kSignPrivateKey;
 
-  return kSignOk;
+  return SignBase::kSignOk;
 }
 
 
+SignBase::Error Sign::SignFinal(const char* key_pem,
+                                int key_pem_len,
+                                const char* passphrase,
+                                unsigned char** sig,
+                                unsigned int* sig_len,
+                                int padding,
+                                int salt_len) {
+  if (!initialised_)
+    return kSignNotInitialised;
+
+  Error err = SignWithContext(&mdctx_,
+                              key_pem,
+                              key_pem_len,
+                              passphrase,
+                              sig,
+                              sig_len,
+                              padding,
+                              salt_len);
+  EVP_MD_CTX_cleanup(&mdctx_);
+  initialised_ = false;
+  return err;
+}
+
+
+// Signs on the threadpool. The digest state is moved out of the Sign object,
+// which is finished as soon as the job is created.
+class SignJob : public CryptoJob {
+ public:
+  SignJob(Environment* env,
+          Local<Object> object,
+          EVP_MD_CTX* mdctx,
+          Local<Value> key_pem,
+          const char* passphrase,
+          int padding,
+          int salt_len)
+      : CryptoJob(env, object, "PEM_read_bio_PrivateKey failed"),
+        mdctx_(*mdctx),
+        key_pem_(Buffer::Data(key_pem), Buffer::Length(key_pem)),
+        has_passphrase_(passphrase != nullptr),
+        passphrase_(has_passphrase_ ? passphrase : ""),
+        padding_(padding),
+        salt_len_(salt_len),
+        sig_len_(sizeof(sig_)) {
+  }
+
+  ~SignJob() override {
+    EVP_MD_CTX_cleanup(&mdctx_);
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  bool DoWork() override {
+    unsigned char* sig = sig_;
+    return SignWithContext(&mdctx_,
+                           key_pem_.data(),
+                           key_pem_.size(),
+                           has_passphrase_ ? passphrase_.c_str() : nullptr,
+                           &sig,
+                           &sig_len_,
+                           padding_,
+                           salt_len_) == SignBase::kSignOk;
+  }
+
+  Local<Value> Result() override {
+    return Buffer::Copy(env(),
+                        reinterpret_cast<char*>(sig_),
+                        sig_len_).ToLocalChecked();
+  }
+
+  EVP_MD_CTX mdctx_; /* coverity[member_decl] */
+  const std::string key_pem_;
+  const bool has_passphrase_;
+  const std::string passphrase_;
+  const int padding_;
+  const int salt_len_;
+  unsigned char sig_[8192];  // Maximum key size is 8192 bits
+  unsigned int sig_len_;
+};
+
+
 void Sign::SignFinal(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -4211,6 +4984,21 @@ void Sign::SignFinal(const FunctionCallbackInfo<Value>& args) {
   CHECK(maybe_salt_len.IsJust());
   int salt_len = maybe_salt_len.ToChecked();
 
+  const char* passphrase_value =
+      len >= 2 && !args[1]->IsNull() ? *passphrase : nullptr;
+
+  if (args[4]->IsFunction()) {
+    EVP_MD_CTX mdctx;
+    Error err = sign->MoveContext(&mdctx);
+    if (err != kSignOk)
+      return sign->CheckThrow(err);
+    Local<Object> obj = CryptoJob::NewObject(env, args[4]);
+    SignJob* job = new SignJob(env, obj, &mdctx, args[0], passphrase_value,
+                               padding, salt_len);
+    job->Queue();
+    return;
+  }
+
   md_len = 8192;  // Maximum key size is 8192 bits
   md_value = new unsigned char[md_len];
 
@@ -4220,7 +5008,7 @@ void Sign::SignFinal(const FunctionCallbackInfo<Value>& args) {
   Error err = sign->SignFinal(
       buf,
       buf_len,
-      len >= 2 && !args[1]->IsNull() ? *passphrase : nullptr,
+      passphrase_value,
       &md_value,
       &md_len,
       padding,
@@ -4327,16 +5115,16 @@ void Verify::VerifyUpdate(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-SignBase::Error Verify::VerifyFinal(const char* key_pem,
-                                    int key_pem_len,
-                                    const char* sig,
-                                    int siglen,
-                                    int padding,
-                                    int saltlen,
-                                    bool* verify_result) {
-  if (!initialised_)
-    return kSignNotInitialised;
-
+// Verifies the signature over the digest in |mdctx|, without cleaning it up.
+// Safe to call from the threadpool.
+static SignBase::Error VerifyWithContext(EVP_MD_CTX* mdctx,
+                                         const char* key_pem,
+                                         int key_pem_len,
+                                         const char* sig,
+                                         int siglen,
+                                         int padding,
+                                         int saltlen,
+                                         bool* verify_result) {
   ClearErrorOnReturn clear_error_on_return;
   (void) &clear_error_on_return;  // Silence compiler warning.
 
@@ -4382,7 +5170,7 @@ SignBase::Error Verify::VerifyFinal(const char* key_pem,
       goto exit;
   }
 
-  if (!EVP_DigestFinal_ex(&mdctx_, m, &m_len)) {
+  if (!EVP_DigestFinal_ex(mdctx, m, &m_len)) {
     goto exit;
   }
 
@@ -4395,7 +5183,7 @@ SignBase::Error Verify::VerifyFinal(const char* key_pem,
     goto err;
   if (!ApplyRSAOptions(pkey, pkctx, padding, saltlen))
     goto err;
-  if (EVP_PKEY_CTX_set_signature_md(pkctx, mdctx_.digest) <= 0)
+  if (EVP_PKEY_CTX_set_signature_md(pkctx, mdctx->digest) <= 0)
     goto err;
   r = EVP_PKEY_verify(pkctx,
                       reinterpret_cast<const unsigned char*>(sig),
@@ -4414,17 +5202,89 @@ SignBase::Error Verify::VerifyFinal(const char* key_pem,
   if (x509 != nullptr)
     X509_free(x509);
 
-  EVP_MD_CTX_cleanup(&mdctx_);
-  initialised_ = false;
-
   if (fatal)
-    return kSignPublicKey;
+    return SignBase::kSignPublicKey;
 
   *verify_result = r == 1;
-  return kSignOk;
+  return SignBase::kSignOk;
 }
 
 
+SignBase::Error Verify::VerifyFinal(const char* key_pem,
+                                    int key_pem_len,
+                                    const char* sig,
+                                    int siglen,
+                                    int padding,
+                                    int saltlen,
+                                    bool* verify_result) {
+  if (!initialised_)
+    return kSignNotInitialised;
+
+  Error err = VerifyWithContext(&mdctx_,
+                                key_pem,
+                                key_pem_len,
+                                sig,
+                                siglen,
+                                padding,
+                                saltlen,
+                                verify_result);
+  EVP_MD_CTX_cleanup(&mdctx_);
+  initialised_ = false;
+  return err;
+}
+
+
+// Verifies on the threadpool. The digest state is moved out of the Verify
+// object, which is finished as soon as the job is created.
+class VerifyJob : public CryptoJob {
+ public:
+  VerifyJob(Environment* env,
+            Local<Object> object,
+            EVP_MD_CTX* mdctx,
+            Local<Value> key_pem,
+            Local<Value> sig,
+            int padding,
+            int salt_len)
+      : CryptoJob(env, object, "PEM_read_bio_PUBKEY failed"),
+        mdctx_(*mdctx),
+        key_pem_(Buffer::Data(key_pem), Buffer::Length(key_pem)),
+        sig_(Buffer::Data(sig), Buffer::Length(sig)),
+        padding_(padding),
+        salt_len_(salt_len),
+        verify_result_(false) {
+  }
+
+  ~VerifyJob() override {
+    EVP_MD_CTX_cleanup(&mdctx_);
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  bool DoWork() override {
+    return VerifyWithContext(&mdctx_,
+                             key_pem_.data(),
+                             key_pem_.size(),
+                             sig_.data(),
+                             sig_.size(),
+                             padding_,
+                             salt_len_,
+                             &verify_result_) == SignBase::kSignOk;
+  }
+
+  Local<Value> Result() override {
+    return Boolean::New(env()->isolate(), verify_result_);
+  }
+
+  EVP_MD_CTX mdctx_; /* coverity[member_decl] */
+  const std::string key_pem_;
+  const std::string sig_;
+  const int padding_;
+  const int salt_len_;
+  bool verify_result_;
+};
+
+
 void Verify::VerifyFinal(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -4450,6 +5310,18 @@ void Verify::VerifyFinal(const FunctionCallbackInfo<Value>& args) {
   CHECK(maybe_salt_len.IsJust());
   int salt_len = maybe_salt_len.ToChecked();
 
+  if (args[4]->IsFunction()) {
+    EVP_MD_CTX mdctx;
+    Error err = verify->MoveContext(&mdctx);
+    if (err != kSignOk)
+      return verify->CheckThrow(err);
+    Local<Object> obj = CryptoJob::NewObject(env, args[4]);
+    VerifyJob* job = new VerifyJob(env, obj, &mdctx, args[0], args[1],
+                                   padding, salt_len);
+    job->Queue();
+    return;
+  }
+
   bool verify_result;
   Error err = verify->VerifyFinal(kbuf, klen, hbuf, hlen, padding, salt_len,
                                   &verify_result);
@@ -4610,6 +5482,7 @@ void DiffieHellman::Initialize(Environment* env, Local<Object> target) {
   t->InstanceTemplate()->SetInternalFieldCount(1);
 
   env->SetProtoMethod(t, "generateKeys", GenerateKeys);
+  env->SetProtoMethod(t, "generateParameters", GenerateParameters);
   env->SetProtoMethod(t, "computeSecret", ComputeSecret);
   env->SetProtoMethod(t, "getPrime", GetPrime);
   env->SetProtoMethod(t, "getGenerator", GetGenerator);
@@ -4731,6 +5604,10 @@ void DiffieHellman::New(const FunctionCallbackInfo<Value>& args) {
       new DiffieHellman(env, args.This());
   bool initialized = false;
 
+  // Without arguments, the parameters are set by generateParameters().
+  if (args.Length() == 0)
+    return;
+
   if (args.Length() == 2) {
     if (args[0]->IsInt32()) {
       if (args[1]->IsInt32()) {
@@ -4757,6 +5634,104 @@ void DiffieHellman::New(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Generates a key pair on the threadpool, for a copy of the parameters and of
+// the private key if one is set. The new keys replace those of the
+// DiffieHellman object when the job is done.
+class DHKeyJob : public CryptoJob {
+ public:
+  DHKeyJob(Environment* env, Local<Object> object, DiffieHellman* dh)
+      : CryptoJob(env, object, "Key generation failed"),
+        owner_(dh),
+        owner_object_(env->isolate(), dh->object()),
+        dh_(DH_new()) {
+    dh_->p = BN_dup(dh->dh->p);
+    dh_->g = BN_dup(dh->dh->g);
+    dh_->length = dh->dh->length;
+    if (dh->dh->priv_key != nullptr)
+      dh_->priv_key = BN_dup(dh->dh->priv_key);
+  }
+
+  ~DHKeyJob() override {
+    if (dh_ != nullptr)
+      DH_free(dh_);
+    owner_object_.Reset();
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  bool DoWork() override {
+    return dh_->p != nullptr && dh_->g != nullptr && DH_generate_key(dh_);
+  }
+
+  Local<Value> Result() override {
+    Local<Object> pub =
+        Buffer::New(env(), BN_num_bytes(dh_->pub_key)).ToLocalChecked();
+    BN_bn2bin(dh_->pub_key,
+              reinterpret_cast<unsigned char*>(Buffer::Data(pub)));
+    DH_free(owner_->dh);
+    owner_->dh = dh_;
+    dh_ = nullptr;
+    return pub;
+  }
+
+  DiffieHellman* const owner_;
+  Persistent<Object> owner_object_;
+  DH* dh_;
+};
+
+
+// Generates new parameters on the threadpool, and checks them there too, for
+// a DiffieHellman object that has none yet.
+class DHParamsJob : public CryptoJob {
+ public:
+  DHParamsJob(Environment* env,
+              Local<Object> object,
+              DiffieHellman* dh,
+              int prime_length,
+              int generator)
+      : CryptoJob(env, object, "Initialization failed"),
+        owner_(dh),
+        owner_object_(env->isolate(), dh->object()),
+        dh_(DH_new()),
+        prime_length_(prime_length),
+        generator_(generator),
+        verify_error_(0) {
+  }
+
+  ~DHParamsJob() override {
+    if (dh_ != nullptr)
+      DH_free(dh_);
+    owner_object_.Reset();
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  bool DoWork() override {
+    return DH_generate_parameters_ex(dh_, prime_length_, generator_, 0) &&
+           DH_check(dh_, &verify_error_);
+  }
+
+  Local<Value> Result() override {
+    if (owner_->dh != nullptr)
+      DH_free(owner_->dh);
+    owner_->dh = dh_;
+    owner_->verifyError_ = verify_error_;
+    owner_->initialised_ = true;
+    dh_ = nullptr;
+    return Undefined(env()->isolate());
+  }
+
+  DiffieHellman* const owner_;
+  Persistent<Object> owner_object_;
+  DH* dh_;
+  const int prime_length_;
+  const int generator_;
+  int verify_error_;
+};
+
+
 void DiffieHellman::GenerateKeys(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -4767,6 +5742,13 @@ void DiffieHellman::GenerateKeys(const FunctionCallbackInfo<Value>& args) {
     return ThrowCryptoError(env, ERR_get_error(), "Not initialized");
   }
 
+  if (args[0]->IsFunction()) {
+    Local<Object> obj = CryptoJob::NewObject(env, args[0]);
+    DHKeyJob* job = new DHKeyJob(env, obj, diffieHellman);
+    job->Queue();
+    return;
+  }
+
   if (!DH_generate_key(diffieHellman->dh)) {
     return ThrowCryptoError(env, ERR_get_error(), "Key generation failed");
   }
@@ -4781,6 +5763,27 @@ void DiffieHellman::GenerateKeys(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void DiffieHellman::GenerateParameters(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  DiffieHellman* diffieHellman;
+  ASSIGN_OR_RETURN_UNWRAP(&diffieHellman, args.Holder());
+
+  CHECK(!diffieHellman->initialised_);
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsInt32());
+
+  Local<Object> obj = CryptoJob::NewObject(env, args[2]);
+  DHParamsJob* job = new DHParamsJob(env,
+                                     obj,
+                                     diffieHellman,
+                                     args[0]->Int32Value(),
+                                     args[1]->Int32Value());
+  job->Queue();
+}
+
+
 void DiffieHellman::GetPrime(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -5044,12 +6047,58 @@ void ECDH::New(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Generates a key pair on the threadpool, into a new EC_KEY that replaces the
+// one of the ECDH object when the job is done.
+class ECDHKeyJob : public CryptoJob {
+ public:
+  ECDHKeyJob(Environment* env, Local<Object> object, ECDH* ecdh)
+      : CryptoJob(env, object, "Failed to generate EC_KEY"),
+        owner_(ecdh),
+        owner_object_(env->isolate(), ecdh->object()),
+        key_(EC_KEY_new_by_curve_name(
+            EC_GROUP_get_curve_name(ecdh->group_))) {
+  }
+
+  ~ECDHKeyJob() override {
+    if (key_ != nullptr)
+      EC_KEY_free(key_);
+    owner_object_.Reset();
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  bool DoWork() override {
+    return key_ != nullptr && EC_KEY_generate_key(key_);
+  }
+
+  Local<Value> Result() override {
+    EC_KEY_free(owner_->key_);
+    owner_->key_ = key_;
+    owner_->group_ = EC_KEY_get0_group(key_);
+    key_ = nullptr;
+    return Undefined(env()->isolate());
+  }
+
+  ECDH* const owner_;
+  Persistent<Object> owner_object_;
+  EC_KEY* key_;
+};
+
+
 void ECDH::GenerateKeys(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
   ECDH* ecdh;
   ASSIGN_OR_RETURN_UNWRAP(&ecdh, args.Holder());
 
+  if (args[0]->IsFunction()) {
+    Local<Object> obj = CryptoJob::NewObject(env, args[0]);
+    ECDHKeyJob* job = new ECDHKeyJob(env, obj, ecdh);
+    job->Queue();
+    return;
+  }
+
   if (!EC_KEY_generate_key(ecdh->key_))
     return env->ThrowError("Failed to generate EC_KEY");
 }
@@ -5520,10 +6569,14 @@ void PBKDF2(const FunctionCallbackInfo<Value>& args) {
 
     if (env->in_domain())
       obj->Set(env->domain_string(), env->domain_array()->Get(0));
-    uv_queue_work(env->event_loop(),
-                  req->work_req(),
-                  EIO_PBKDF2,
-                  EIO_PBKDF2After);
+    threadpool::QueueWork(env->event_loop(),
+                          req->work_req(),
+                          threadpool::kKdfWork,
+                          threadpool::kNormalPriority,
+                          EIO_PBKDF2,
+                          EIO_PBKDF2After,
+                          NODE_THREADPOOL_TRACE_CRYPTO,
+                          "crypto.pbkdf2");
   } else {
     env->PrintSyncTrace();
     Local<Value> argv[2];
@@ -5546,6 +6599,470 @@ void PBKDF2(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// scrypt as in RFC 7914. OpenSSL 1.0.2 has no EVP_PBE_scrypt(), so the
+// memory-hard part is done here and PKCS5_PBKDF2_HMAC() does the rest.
+namespace scrypt {
+
+inline uint32_t Rotl(uint32_t x, int n) {
+  return (x << n) | (x >> (32 - n));
+}
+
+inline void QuarterRound(uint32_t x[16], int a, int b, int c, int d) {
+  x[b] ^= Rotl(x[a] + x[d], 7);
+  x[c] ^= Rotl(x[b] + x[a], 9);
+  x[d] ^= Rotl(x[c] + x[b], 13);
+  x[a] ^= Rotl(x[d] + x[c], 18);
+}
+
+// Salsa20/8 of the 16 words at |b|, in place.
+void Salsa208(uint32_t b[16]) {
+  uint32_t x[16];
+  memcpy(x, b, sizeof(x));
+  for (int i = 0; i < 8; i += 2) {
+    QuarterRound(x, 0, 4, 8, 12);
+    QuarterRound(x, 5, 9, 13, 1);
+    QuarterRound(x, 10, 14, 2, 6);
+    QuarterRound(x, 15, 3, 7, 11);
+    QuarterRound(x, 0, 1, 2, 3);
+    QuarterRound(x, 5, 6, 7, 4);
+    QuarterRound(x, 10, 11, 8, 9);
+    QuarterRound(x, 15, 12, 13, 14);
+  }
+  for (int i = 0; i < 16; i++)
+    b[i] += x[i];
+}
+
+// scryptBlockMix of the 2 * |r| 64 byte blocks at |b| into |y|.
+void BlockMix(const uint32_t* b, uint32_t* y, uint32_t r) {
+  uint32_t x[16];
+  memcpy(x, &b[(2 * r - 1) * 16], sizeof(x));
+  for (uint32_t i = 0; i < 2 * r; i++) {
+    for (int k = 0; k < 16; k++)
+      x[k] ^= b[i * 16 + k];
+    Salsa208(x);
+    // The even blocks go into the first half and the odd ones into the
+    // second.
+    memcpy(&y[((i & 1) * r + i / 2) * 16], x, sizeof(x));
+  }
+}
+
+// scryptROMix of the 128 * |r| bytes at |b|, in place. |v| has room for |n|
+// times that and |xy| for twice that.
+void ROMix(uint8_t* b, uint32_t r, uint64_t n, uint32_t* v, uint32_t* xy) {
+  const size_t words = 32 * r;
+  uint32_t* x = xy;
+  uint32_t* y = xy + words;
+
+  for (size_t k = 0; k < words; k++) {
+    const uint8_t* p = &b[4 * k];
+    x[k] = p[0] | (p[1] << 8) | (p[2] << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+  for (uint64_t i = 0; i < n; i += 2) {
+    memcpy(&v[i * words], x, words * sizeof(*x));
+    BlockMix(x, y, r);
+    memcpy(&v[(i + 1) * words], y, words * sizeof(*y));
+    BlockMix(y, x, r);
+  }
+
+  for (uint64_t i = 0; i < n; i += 2) {
+    // Integerify(), of which |n| being a power of two needs the low bits.
+    uint64_t j = x[(2 * r - 1) * 16] & (n - 1);
+    for (size_t k = 0; k < words; k++)
+      x[k] ^= v[j * words + k];
+    BlockMix(x, y, r);
+    j = y[(2 * r - 1) * 16] & (n - 1);
+    for (size_t k = 0; k < words; k++)
+      y[k] ^= v[j * words + k];
+    BlockMix(y, x, r);
+  }
+
+  for (size_t k = 0; k < words; k++) {
+    uint8_t* p = &b[4 * k];
+    p[0] = x[k];
+    p[1] = x[k] >> 8;
+    p[2] = x[k] >> 16;
+    p[3] = x[k] >> 24;
+  }
+}
+
+// The memory that Derive() needs, which Validate() bounds.
+inline uint64_t MemoryNeeded(uint64_t n, uint32_t r, uint32_t p) {
+  return 128 * static_cast<uint64_t>(r) * (n + p + 2);
+}
+
+// Returns nullptr if the parameters are fine or the reason they are not.
+const char* Validate(uint64_t n, uint32_t r, uint32_t p, uint64_t maxmem) {
+  if (n < 2 || (n & (n - 1)) != 0)
+    return "N must be a power of two larger than 1";
+  if (r == 0 || p == 0)
+    return "r and p must be positive";
+  // RFC 7914 limits p * r to below 2^30, and N to below 2^(128 * r / 8).
+  if (static_cast<uint64_t>(p) * r >= (1 << 30))
+    return "p * r is too large";
+  if (r < 4 && n >= (static_cast<uint64_t>(1) << (16 * r)))
+    return "N is too large for r";
+  if (n > UINT64_MAX / 128 / r || MemoryNeeded(n, r, p) > maxmem)
+    return "Memory limit exceeded";
+  return nullptr;
+}
+
+// Returns false if there is no memory left.
+bool Derive(const char* pass,
+            size_t passlen,
+            const unsigned char* salt,
+            size_t saltlen,
+            uint64_t n,
+            uint32_t r,
+            uint32_t p,
+            unsigned char* key,
+            size_t keylen) {
+  const size_t block_size = 128 * r;
+  std::vector<uint8_t> b(block_size * p);
+  uint32_t* v = UncheckedMalloc<uint32_t>(static_cast<size_t>(32 * r * n));
+  uint32_t* xy = UncheckedMalloc<uint32_t>(64 * r);
+  bool ok = v != nullptr && xy != nullptr &&
+      PKCS5_PBKDF2_HMAC(pass, passlen, salt, saltlen, 1, EVP_sha256(),
+                        b.size(), b.data());
+  if (ok) {
+    for (uint32_t i = 0; i < p; i++)
+      ROMix(&b[i * block_size], r, n, v, xy);
+    ok = PKCS5_PBKDF2_HMAC(pass, passlen, b.data(), b.size(), 1,
+                           EVP_sha256(), keylen, key);
+  }
+  if (v != nullptr)
+    OPENSSL_cleanse(v, block_size * n);
+  if (xy != nullptr)
+    OPENSSL_cleanse(xy, block_size * 2);
+  OPENSSL_cleanse(b.data(), b.size());
+  free(v);
+  free(xy);
+  return ok;
+}
+
+}  // namespace scrypt
+
+
+class ScryptRequest : public AsyncWrap {
+ public:
+  ScryptRequest(Environment* env,
+                Local<Object> object,
+                const char* pass,
+                size_t passlen,
+                const char* salt,
+                size_t saltlen,
+                size_t keylen,
+                uint64_t n,
+                uint32_t r,
+                uint32_t p)
+      : AsyncWrap(env, object, AsyncWrap::PROVIDER_CRYPTO),
+        pass_(pass, pass + passlen),
+        salt_(salt, salt + saltlen),
+        key_(keylen),
+        n_(n),
+        r_(r),
+        p_(p),
+        success_(false) {
+    Wrap(object, this);
+  }
+
+  ~ScryptRequest() override {
+    OPENSSL_cleanse(pass_.data(), pass_.size());
+    OPENSSL_cleanse(salt_.data(), salt_.size());
+    OPENSSL_cleanse(key_.data(), key_.size());
+    ClearWrap(object());
+    persistent().Reset();
+  }
+
+  static void Work(uv_work_t* work_req) {
+    ScryptRequest* req = ContainerOf(&ScryptRequest::work_req_, work_req);
+    req->Derive();
+  }
+
+  static void After(uv_work_t* work_req, int status) {
+    CHECK_EQ(status, 0);
+    ScryptRequest* req = ContainerOf(&ScryptRequest::work_req_, work_req);
+    Environment* env = req->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    Local<Value> argv[2];
+    req->After(argv);
+    req->MakeCallback(env->ondone_string(), arraysize(argv), argv);
+    delete req;
+  }
+
+  void Derive() {
+    success_ = scrypt::Derive(pass_.data(), pass_.size(),
+                              reinterpret_cast<unsigned char*>(salt_.data()),
+                              salt_.size(), n_, r_, p_,
+                              reinterpret_cast<unsigned char*>(key_.data()),
+                              key_.size());
+  }
+
+  void After(Local<Value> argv[2]) {
+    Isolate* isolate = env()->isolate();
+    if (success_) {
+      argv[0] = Null(isolate);
+      argv[1] = Buffer::Copy(env(), key_.data(), key_.size()).ToLocalChecked();
+    } else {
+      argv[0] = Exception::Error(
+          FIXED_ONE_BYTE_STRING(isolate, "Scrypt key derivation failed"));
+      argv[1] = Undefined(isolate);
+    }
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+  uv_work_t work_req_;
+
+ private:
+  std::vector<char> pass_;
+  std::vector<char> salt_;
+  std::vector<char> key_;
+  const uint64_t n_;
+  const uint32_t r_;
+  const uint32_t p_;
+  bool success_;
+};
+
+
+// scrypt(password, salt, keylen, N, r, p, maxmem[, callback]). lib/crypto.js
+// checks the types, the parameters themselves are checked here.
+void Scrypt(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(Buffer::HasInstance(args[0]));
+  CHECK(Buffer::HasInstance(args[1]));
+  CHECK(args[2]->IsUint32());
+  CHECK(args[3]->IsNumber());
+  CHECK(args[4]->IsUint32());
+  CHECK(args[5]->IsUint32());
+  CHECK(args[6]->IsNumber());
+
+  const uint64_t n = args[3]->IntegerValue(env->context()).FromJust();
+  const uint32_t r = args[4].As<Uint32>()->Value();
+  const uint32_t p = args[5].As<Uint32>()->Value();
+  const uint64_t maxmem = args[6]->IntegerValue(env->context()).FromJust();
+  if (const char* error = scrypt::Validate(n, r, p, maxmem))
+    return env->ThrowRangeError(error);
+
+  Local<Object> obj = env->NewInternalFieldObject();
+  ScryptRequest* req = new ScryptRequest(env,
+                                         obj,
+                                         Buffer::Data(args[0]),
+                                         Buffer::Length(args[0]),
+                                         Buffer::Data(args[1]),
+                                         Buffer::Length(args[1]),
+                                         args[2].As<Uint32>()->Value(),
+                                         n,
+                                         r,
+                                         p);
+
+  if (args[7]->IsFunction()) {
+    obj->Set(env->ondone_string(), args[7]);
+
+    if (env->in_domain())
+      obj->Set(env->domain_string(), env->domain_array()->Get(0));
+    threadpool::QueueWork(env->event_loop(),
+                          &req->work_req_,
+                          threadpool::kKdfWork,
+                          threadpool::kNormalPriority,
+                          ScryptRequest::Work,
+                          ScryptRequest::After,
+                          NODE_THREADPOOL_TRACE_CRYPTO,
+                          "crypto.scrypt");
+  } else {
+    env->PrintSyncTrace();
+    Local<Value> argv[2];
+    req->Derive();
+    req->After(argv);
+
+    delete req;
+
+    if (argv[0]->IsObject())
+      env->isolate()->ThrowException(argv[0]);
+    else
+      args.GetReturnValue().Set(argv[1]);
+  }
+}
+
+
+// The figures of the pool that crypto.pbkdf2() and crypto.scrypt() run on.
+void GetKdfPoolInfo(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  threadpool::Stats stats;
+  CHECK(threadpool::GetStats(threadpool::kKdfWork, &stats));
+
+  Local<Object> info = Object::New(env->isolate());
+#define V(name, value)                                                        \
+  info->Set(env->context(),                                                   \
+            FIXED_ONE_BYTE_STRING(env->isolate(), name),                      \
+            Number::New(env->isolate(),                                       \
+                        static_cast<double>(value))).FromJust();
+  V("threads", stats.threads)
+  V("pending", stats.pending)
+  V("running", stats.running)
+  V("maxPending", stats.max_pending)
+  V("completed", stats.completed)
+  V("waitTime", stats.wait_time_ns / 1e6)
+#undef V
+  args.GetReturnValue().Set(info);
+}
+
+
+// Small random values are served from a pool of CSPRNG output so they don't
+// need a trip to the threadpool. Each Environment has its own pool, used from
+// its own thread; while one block is handed out, the other is refilled on the
+// threadpool.
+static const size_t kRandomPoolMaxRequest = 256;
+
+class RandomPool {
+ public:
+  static const size_t kBlockSize = 32 * 1024;
+
+  explicit RandomPool(uv_loop_t* loop)
+      : loop_(loop),
+        current_(0),
+        offset_(kBlockSize),
+        spare_ready_(false),
+        refilling_(false),
+        refill_block_(nullptr),
+        refill_status_(0),
+        refills_(0),
+        released_(false) {
+  }
+
+  static RandomPool* Get(Environment* env) {
+    RandomPool* pool = env->random_pool();
+    if (pool == nullptr) {
+      pool = new RandomPool(env->event_loop());
+      env->set_random_pool(pool);
+      env->AtExit(Release, env);
+    }
+    return pool;
+  }
+
+  // Copies |size| random bytes into |data|. Returns 0 on success, and
+  // otherwise the OpenSSL error, or -1 if RAND_bytes() is not supported.
+  unsigned long Fill(unsigned char* data, size_t size) {  // NOLINT(runtime/int)
+    CHECK_LE(size, kRandomPoolMaxRequest);
+
+    if (size > available()) {
+      if (spare_ready_) {
+        current_ ^= 1;
+        spare_ready_ = false;
+      } else {
+        // Refilling faster than the threadpool can keep up with, or the
+        // pool is just being started: fill the current block inline.
+        CheckEntropy();
+        const int r = RAND_bytes(blocks_[current_], kBlockSize);
+        if (r != 1)
+          return r == 0 ? ERR_get_error() : -1;  // NOLINT(runtime/int)
+      }
+      offset_ = 0;
+      ScheduleRefill();
+    }
+
+    unsigned char* bytes = blocks_[current_] + offset_;
+    memcpy(data, bytes, size);
+    // Never hand out the same bytes twice.
+    OPENSSL_cleanse(bytes, size);
+    offset_ += size;
+    return 0;
+  }
+
+  inline size_t available() const {
+    return kBlockSize - offset_;
+  }
+
+  inline bool spare_ready() const {
+    return spare_ready_;
+  }
+
+  inline bool refilling() const {
+    return refilling_;
+  }
+
+  inline size_t refills() const {
+    return refills_;
+  }
+
+ private:
+  void ScheduleRefill() {
+    if (spare_ready_ || refilling_)
+      return;
+    refilling_ = true;
+    refill_block_ = blocks_[current_ ^ 1];
+    refill_req_.data = this;
+    CHECK_EQ(0, threadpool::QueueWork(loop_,
+                                      &refill_req_,
+                                      threadpool::kCpuWork,
+                                      threadpool::kNormalPriority,
+                                      RefillWork,
+                                      RefillAfter,
+                                      NODE_THREADPOOL_TRACE_CRYPTO,
+                                      "crypto.randomBytes.refill"));
+  }
+
+  // A refill that is still running when the Environment goes away frees the
+  // pool once it is done. That never happens if the loop doesn't run again,
+  // like at process exit, and so the pool is leaked then.
+  static void Release(void* arg) {
+    Environment* env = static_cast<Environment*>(arg);
+    RandomPool* pool = env->random_pool();
+    env->set_random_pool(nullptr);
+    if (pool->refilling_)
+      pool->released_ = true;
+    else
+      delete pool;
+  }
+
+  static void RefillWork(uv_work_t* req) {
+    RandomPool* pool = static_cast<RandomPool*>(req->data);
+    CheckEntropy();
+    pool->refill_status_ = RAND_bytes(pool->refill_block_, kBlockSize);
+  }
+
+  static void RefillAfter(uv_work_t* req, int status) {
+    CHECK_EQ(status, 0);
+    RandomPool* pool = static_cast<RandomPool*>(req->data);
+    pool->refilling_ = false;
+    if (pool->released_) {
+      delete pool;
+      return;
+    }
+    // On failure, the next inline fill reports the error.
+    if (pool->refill_status_ == 1) {
+      pool->spare_ready_ = true;
+      pool->refills_++;
+    }
+  }
+
+  uv_loop_t* const loop_;
+  unsigned char blocks_[2][kBlockSize];
+  int current_;
+  size_t offset_;
+  bool spare_ready_;
+  bool refilling_;
+  unsigned char* refill_block_;
+  int refill_status_;
+  size_t refills_;
+  bool released_;  // By the Environment, while a refill was running.
+  uv_work_t refill_req_;
+};
+
+
+void ThrowRandomBytesError(Environment* env,
+                           unsigned long err) {  // NOLINT(runtime/int)
+  char errmsg[256] = "Operation not supported";
+  if (err != static_cast<unsigned long>(-1))  // NOLINT(runtime/int)
+    ERR_error_string_n(err, errmsg, sizeof errmsg);
+  env->isolate()->ThrowException(
+      Exception::Error(OneByteString(env->isolate(), errmsg)));
+}
+
+
 // Only instantiate within a valid HandleScope.
 class RandomBytesRequest : public AsyncWrap {
  public:
@@ -5708,6 +7225,20 @@ void RandomBytes(const FunctionCallbackInfo<Value>& args) {
   if (size < 0 || size > Buffer::kMaxLength)
     return env->ThrowRangeError("size is not a valid Smi");
 
+  if (!args[1]->IsFunction() &&
+      static_cast<size_t>(size) <= kRandomPoolMaxRequest) {
+    Local<Object> buffer;
+    if (!Buffer::New(env, size).ToLocal(&buffer))
+      return;
+    unsigned char* data =
+        reinterpret_cast<unsigned char*>(Buffer::Data(buffer));
+    unsigned long err =  // NOLINT(runtime/int)
+        RandomPool::Get(env)->Fill(data, size);
+    if (err != 0)
+      return ThrowRandomBytesError(env, err);
+    return args.GetReturnValue().Set(buffer);
+  }
+
   Local<Object> obj = env->NewInternalFieldObject();
   char* data = node::Malloc(size);
   RandomBytesRequest* req =
@@ -5722,10 +7253,14 @@ void RandomBytes(const FunctionCallbackInfo<Value>& args) {
 
     if (env->in_domain())
       obj->Set(env->domain_string(), env->domain_array()->Get(0));
-    uv_queue_work(env->event_loop(),
-                  req->work_req(),
-                  RandomBytesWork,
-                  RandomBytesAfter);
+    threadpool::QueueWork(env->event_loop(),
+                          req->work_req(),
+                          threadpool::kCpuWork,
+                          threadpool::kNormalPriority,
+                          RandomBytesWork,
+                          RandomBytesAfter,
+                          NODE_THREADPOOL_TRACE_CRYPTO,
+                          "crypto.randomBytes");
     args.GetReturnValue().Set(obj);
   } else {
     Local<Value> argv[2];
@@ -5746,6 +7281,17 @@ void RandomBytesBuffer(const FunctionCallbackInfo<Value>& args) {
   int64_t offset = args[1]->IntegerValue();
   int64_t size = args[2]->IntegerValue();
 
+  if (!args[3]->IsFunction() &&
+      static_cast<size_t>(size) <= kRandomPoolMaxRequest) {
+    unsigned char* data =
+        reinterpret_cast<unsigned char*>(Buffer::Data(args[0])) + offset;
+    unsigned long err =  // NOLINT(runtime/int)
+        RandomPool::Get(env)->Fill(data, size);
+    if (err != 0)
+      return ThrowRandomBytesError(env, err);
+    return args.GetReturnValue().Set(args[0]);
+  }
+
   Local<Object> obj = env->NewInternalFieldObject();
   obj->Set(env->context(), env->buffer_string(), args[0]).FromJust();
   char* data = Buffer::Data(args[0]);
@@ -5768,10 +7314,14 @@ void RandomBytesBuffer(const FunctionCallbackInfo<Value>& args) {
                env->domain_array()->Get(0)).FromJust();
     }
 
-    uv_queue_work(env->event_loop(),
-                  req->work_req(),
-                  RandomBytesWork,
-                  RandomBytesAfter);
+    threadpool::QueueWork(env->event_loop(),
+                          req->work_req(),
+                          threadpool::kCpuWork,
+                          threadpool::kNormalPriority,
+                          RandomBytesWork,
+                          RandomBytesAfter,
+                          NODE_THREADPOOL_TRACE_CRYPTO,
+                          "crypto.randomBytes");
     args.GetReturnValue().Set(obj);
   } else {
     Local<Value> argv[2];
@@ -5782,6 +7332,31 @@ void RandomBytesBuffer(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void GetRandomPoolInfo(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  RandomPool* pool = RandomPool::Get(env);
+
+  Local<Object> info = Object::New(env->isolate());
+  info->Set(env->context(),
+            FIXED_ONE_BYTE_STRING(env->isolate(), "blockSize"),
+            Number::New(env->isolate(), RandomPool::kBlockSize)).FromJust();
+  info->Set(env->context(),
+            FIXED_ONE_BYTE_STRING(env->isolate(), "available"),
+            Number::New(env->isolate(), pool->available())).FromJust();
+  info->Set(env->context(),
+            FIXED_ONE_BYTE_STRING(env->isolate(), "spareReady"),
+            Boolean::New(env->isolate(), pool->spare_ready())).FromJust();
+  info->Set(env->context(),
+            FIXED_ONE_BYTE_STRING(env->isolate(), "refilling"),
+            Boolean::New(env->isolate(), pool->refilling())).FromJust();
+  info->Set(env->context(),
+            FIXED_ONE_BYTE_STRING(env->isolate(), "refills"),
+            Number::New(env->isolate(),
+                        static_cast<double>(pool->refills()))).FromJust();
+  args.GetReturnValue().Set(info);
+}
+
+
 void GetSSLCiphers(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -6033,6 +7608,212 @@ void ExportChallenge(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(outString);
 }
 
+// Digest, or HMAC if |key| is not null, of a single input. Safe to call from
+// the threadpool.
+static bool ComputeDigest(const EVP_MD* md,
+                          const char* key,
+                          size_t key_len,
+                          const char* data,
+                          size_t data_len,
+                          unsigned char* md_value,
+                          unsigned int* md_len) {
+  if (key != nullptr) {
+    return HMAC(md,
+                key,
+                key_len,
+                reinterpret_cast<const unsigned char*>(data),
+                data_len,
+                md_value,
+                md_len) != nullptr;
+  }
+  return EVP_Digest(data, data_len, md_value, md_len, md, nullptr) == 1;
+}
+
+
+// Digests an input Buffer on the threadpool. The input isn't copied, the
+// Buffer is kept alive until the job is done. The key is small, so it is.
+class DigestJob : public CryptoJob {
+ public:
+  DigestJob(Environment* env,
+            Local<Object> object,
+            const EVP_MD* md,
+            Local<Value> key,
+            Local<Object> data)
+      : CryptoJob(env, object, "Digest failed"),
+        md_(md),
+        hmac_(Buffer::HasInstance(key)),
+        key_(hmac_ ? Buffer::Data(key) : nullptr,
+             hmac_ ? Buffer::Length(key) : 0),
+        data_object_(env->isolate(), data),
+        data_(Buffer::Data(data)),
+        data_len_(Buffer::Length(data)),
+        md_len_(0) {
+  }
+
+  ~DigestJob() override {
+    data_object_.Reset();
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  bool DoWork() override {
+    return ComputeDigest(md_,
+                         hmac_ ? key_.data() : nullptr,
+                         key_.size(),
+                         data_,
+                         data_len_,
+                         md_value_,
+                         &md_len_);
+  }
+
+  Local<Value> Result() override {
+    return Buffer::Copy(env(),
+                        reinterpret_cast<char*>(md_value_),
+                        md_len_).ToLocalChecked();
+  }
+
+  const EVP_MD* const md_;
+  const bool hmac_;
+  const std::string key_;
+  Persistent<Object> data_object_;
+  const char* const data_;
+  const size_t data_len_;
+  unsigned char md_value_[EVP_MAX_MD_SIZE];
+  unsigned int md_len_;
+};
+
+
+// Digest, or HMAC if a key is given, of a single input in one call, without
+// a Hash or Hmac object per digest. With a callback, the input must be a
+// Buffer and the digest is computed on the threadpool.
+void OneShotDigest(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  THROW_AND_RETURN_IF_NOT_STRING(args[0], "Hash type");
+  THROW_AND_RETURN_IF_NOT_STRING_OR_BUFFER(args[2], "Data");
+
+  const node::Utf8Value hash_type(env->isolate(), args[0]);
+  const EVP_MD* md = EVP_get_digestbyname(*hash_type);
+  if (md == nullptr)
+    return env->ThrowError("Unknown message digest");
+
+  if (args[5]->IsFunction()) {
+    THROW_AND_RETURN_IF_NOT_BUFFER(args[2], "Data");
+    Local<Object> obj = CryptoJob::NewObject(env, args[5]);
+    DigestJob* job =
+        new DigestJob(env, obj, md, args[1], args[2].As<Object>());
+    job->Queue();
+    return;
+  }
+
+  StringBytes::InlineDecoder decoder;
+  const char* data;
+  size_t data_len;
+  if (args[2]->IsString()) {
+    if (!decoder.Decode(env, args[2].As<String>(), args[3], UTF8))
+      return;
+    data = decoder.out();
+    data_len = decoder.size();
+  } else {
+    data = Buffer::Data(args[2]);
+    data_len = Buffer::Length(args[2]);
+  }
+
+  const char* key = nullptr;
+  size_t key_len = 0;
+  if (Buffer::HasInstance(args[1])) {
+    key_len = Buffer::Length(args[1]);
+    key = key_len > 0 ? Buffer::Data(args[1]) : "";
+  }
+
+  unsigned char md_value[EVP_MAX_MD_SIZE];
+  unsigned int md_len = 0;
+  if (!ComputeDigest(md, key, key_len, data, data_len, md_value, &md_len))
+    return ThrowCryptoError(env, ERR_get_error(), "Digest failed");
+
+  enum encoding encoding = ParseEncoding(env->isolate(), args[4], BUFFER);
+  Local<Value> rc = StringBytes::Encode(env->isolate(),
+                                        reinterpret_cast<const char*>(md_value),
+                                        md_len,
+                                        encoding);
+  args.GetReturnValue().Set(rc);
+}
+
+
+// Digests, or HMACs if a key is given, of an array of Buffers, written back
+// to back into a single Buffer.
+void DigestBatch(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  THROW_AND_RETURN_IF_NOT_STRING(args[0], "Hash type");
+  if (!args[2]->IsArray())
+    return env->ThrowTypeError("Data must be an array of buffers");
+
+  const node::Utf8Value hash_type(env->isolate(), args[0]);
+  const EVP_MD* md = EVP_get_digestbyname(*hash_type);
+  if (md == nullptr)
+    return env->ThrowError("Unknown message digest");
+
+  Local<Array> inputs = args[2].As<Array>();
+  const uint32_t count = inputs->Length();
+  for (uint32_t i = 0; i < count; i++) {
+    if (!Buffer::HasInstance(inputs->Get(i)))
+      return env->ThrowTypeError("Data must be an array of buffers");
+  }
+
+  const size_t md_size = EVP_MD_size(md);
+  Local<Object> out = Buffer::New(env, count * md_size).ToLocalChecked();
+  unsigned char* dst = reinterpret_cast<unsigned char*>(Buffer::Data(out));
+
+  const bool hmac = Buffer::HasInstance(args[1]);
+  HMAC_CTX hmac_ctx;
+  EVP_MD_CTX md_ctx;
+  int r = 1;
+  if (hmac) {
+    const char* key = Buffer::Data(args[1]);
+    size_t key_len = Buffer::Length(args[1]);
+    if (key_len == 0)
+      key = "";
+    HMAC_CTX_init(&hmac_ctx);
+    r = HMAC_Init_ex(&hmac_ctx, key, key_len, md, nullptr);
+  } else {
+    EVP_MD_CTX_init(&md_ctx);
+  }
+
+  // The contexts are reused for every input, only the key schedule is
+  // computed once for HMACs.
+  for (uint32_t i = 0; r == 1 && i < count; i++) {
+    Local<Value> input = inputs->Get(i);
+    const unsigned char* data =
+        reinterpret_cast<const unsigned char*>(Buffer::Data(input));
+    size_t data_len = Buffer::Length(input);
+    unsigned int md_len = 0;
+
+    if (hmac) {
+      r = (i == 0 || HMAC_Init_ex(&hmac_ctx, nullptr, 0, nullptr, nullptr)) &&
+          HMAC_Update(&hmac_ctx, data, data_len) &&
+          HMAC_Final(&hmac_ctx, dst, &md_len);
+    } else {
+      r = EVP_DigestInit_ex(&md_ctx, md, nullptr) &&
+          EVP_DigestUpdate(&md_ctx, data, data_len) &&
+          EVP_DigestFinal_ex(&md_ctx, dst, &md_len);
+    }
+    dst += md_size;
+  }
+
+  if (hmac)
+    HMAC_CTX_cleanup(&hmac_ctx);
+  else
+    EVP_MD_CTX_cleanup(&md_ctx);
+
+  if (r != 1)
+    return ThrowCryptoError(env, ERR_get_error(), "Digest failed");
+
+  args.GetReturnValue().Set(out);
+}
+
+
 void TimingSafeEqual(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -6184,6 +7965,7 @@ void InitCrypto(Local<Object> target,
   SecureContext::Initialize(env, target);
   Connection::Initialize(env, target);
   CipherBase::Initialize(env, target);
+  AEAD::Initialize(env, target);
   DiffieHellman::Initialize(env, target);
   ECDH::Initialize(env, target);
   Hmac::Initialize(env, target);
@@ -6200,9 +7982,15 @@ void InitCrypto(Local<Object> target,
   env->SetMethod(target, "getFipsCrypto", GetFipsCrypto);
   env->SetMethod(target, "setFipsCrypto", SetFipsCrypto);
   env->SetMethod(target, "PBKDF2", PBKDF2);
+  env->SetMethod(target, "scrypt", Scrypt);
+  env->SetMethod(target, "getKdfPoolInfo", GetKdfPoolInfo);
   env->SetMethod(target, "randomBytes", RandomBytes);
   env->SetMethod(target, "randomFill", RandomBytesBuffer);
+  env->SetMethod(target, "getRandomPoolInfo", GetRandomPoolInfo);
+  NODE_DEFINE_CONSTANT(target, kRandomPoolMaxRequest);
   env->SetMethod(target, "timingSafeEqual", TimingSafeEqual);
+  env->SetMethod(target, "oneShotDigest", OneShotDigest);
+  env->SetMethod(target, "digestBatch", DigestBatch);
   env->SetMethod(target, "getSSLCiphers", GetSSLCiphers);
   env->SetMethod(target, "getCiphers", GetCiphers);
   env->SetMethod(target, "getHashes", GetHashes);
@@ -38,6 +38,8 @@
 
 #include "v8.h"
 
+#include <string>
+
 #include <openssl/ssl.h>
 #include <openssl/ec.h>
 #include <openssl/ecdh.h>
@@ -112,6 +114,9 @@ class SecureContext : public BaseObject {
   static const int kTicketKeyNameIndex = 3;
   static const int kTicketKeyIVIndex = 4;
 
+  // See RotatingTicketKeyCallback
+  static const int kTicketKeySecretLength = 32;
+
  protected:
   static const int64_t kExternalSize = sizeof(SSL_CTX);
 
@@ -122,6 +127,7 @@ class SecureContext : public BaseObject {
   static void AddCACert(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void AddCRL(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void AddRootCerts(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void UseCertStore(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetCiphers(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetECDHCurve(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetDHParam(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -138,6 +144,8 @@ class SecureContext : public BaseObject {
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void EnableTicketKeyCallback(
       const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void EnableTicketKeyRotation(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void CtxGetter(v8::Local<v8::String> property,
                         const v8::PropertyCallbackInfo<v8::Value>& info);
 
@@ -150,12 +158,36 @@ class SecureContext : public BaseObject {
                                EVP_CIPHER_CTX* ectx,
                                HMAC_CTX* hctx,
                                int enc);
+  static int RotatingTicketKeyCallback(SSL* ssl,
+                                       unsigned char* name,
+                                       unsigned char* iv,
+                                       EVP_CIPHER_CTX* ectx,
+                                       HMAC_CTX* hctx,
+                                       int enc);
+  // Derives the name, HMAC and AES keys (16 bytes each) of the ticket key
+  // for the given rotation epoch from ticket_key_secret_.
+  void DeriveTicketKey(uint64_t epoch,
+                       unsigned char* name,
+                       unsigned char* hmac_key,
+                       unsigned char* aes_key);
+
+  // Returns the cert store for adding to it, after replacing it with a copy
+  // if it is shared with other contexts.
+  X509_STORE* OwnCertStore();
+
+  unsigned char ticket_key_secret_[kTicketKeySecretLength];
+  uint32_t ticket_key_interval_;
+  // Set when the cert store is the root store or was shared by
+  // useCertStore(), as the source or the user of it.
+  bool cert_store_shared_;
 
   SecureContext(Environment* env, v8::Local<v8::Object> wrap)
       : BaseObject(env, wrap),
         ctx_(nullptr),
         cert_(nullptr),
-        issuer_(nullptr) {
+        issuer_(nullptr),
+        ticket_key_interval_(0),
+        cert_store_shared_(false) {
     MakeWeak<SecureContext>(this);
     env->isolate()->AdjustAmountOfExternalAllocatedMemory(kExternalSize);
   }
@@ -246,6 +278,8 @@ class SSLWrap {
 
   static void GetPeerCertificate(
       const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetPeerCertificateKey(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetSession(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetSession(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void LoadSession(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -331,6 +365,9 @@ class SSLWrap {
   v8::Persistent<v8::Value> sni_context_;
 #endif
 
+  // Protocols a server selects from, see SelectALPNCallback.
+  std::string alpn_protos_;
+
   friend class SecureContext;
 };
 
@@ -463,6 +500,7 @@ class CipherBase : public BaseObject {
   static void Init(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void InitIv(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Update(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void UpdateAsync(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Final(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetAutoPadding(const v8::FunctionCallbackInfo<v8::Value>& args);
 
@@ -478,7 +516,8 @@ class CipherBase : public BaseObject {
         initialised_(false),
         kind_(kind),
         auth_tag_(nullptr),
-        auth_tag_len_(0) {
+        auth_tag_len_(0),
+        busy_(false) {
     MakeWeak<CipherBase>(this);
   }
 
@@ -489,6 +528,66 @@ class CipherBase : public BaseObject {
   CipherKind kind_;
   char* auth_tag_;
   unsigned int auth_tag_len_;
+  // Set while the threadpool is working on ctx_.
+  bool busy_;
+
+  friend class CipherJob;
+};
+
+// Seals and opens whole messages with an AEAD cipher, which is AES in GCM
+// mode. The key schedule is set up once by init(), so that a message costs
+// setting its IV and one pass over it. Sealed messages are the ciphertext
+// followed by the auth tag.
+class AEAD : public BaseObject {
+ public:
+  ~AEAD() override {
+    if (!initialised_)
+      return;
+    EVP_CIPHER_CTX_cleanup(&ctx_);
+  }
+
+  static void Initialize(Environment* env, v8::Local<v8::Object> target);
+
+ protected:
+  void Init(const char* cipher_type,
+            const char* key,
+            int key_len,
+            unsigned int auth_tag_len);
+  bool SetIv(const char* iv, int iv_len, bool encrypt);
+  bool Seal(const char* iv,
+            int iv_len,
+            const char* data,
+            int len,
+            const char* aad,
+            int aad_len,
+            unsigned char* out);
+  bool Open(const char* iv,
+            int iv_len,
+            const char* data,
+            int len,
+            const char* aad,
+            int aad_len,
+            unsigned char* out);
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Init(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Seal(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Open(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  AEAD(Environment* env, v8::Local<v8::Object> wrap)
+      : BaseObject(env, wrap),
+        initialised_(false),
+        auth_tag_len_(0),
+        iv_len_(0) {
+    MakeWeak<AEAD>(this);
+  }
+
+ private:
+  EVP_CIPHER_CTX ctx_; /* coverity[member_decl] */
+  bool initialised_;
+  unsigned int auth_tag_len_;
+  // The IV length that ctx_ is set up for.
+  int iv_len_;
 };
 
 class Hmac : public BaseObject {
@@ -577,6 +676,9 @@ class SignBase : public BaseObject {
 
  protected:
   void CheckThrow(Error error);
+  // Hands the digest state over to |ctx|, which the caller then owns, and
+  // leaves this object finished.
+  Error MoveContext(EVP_MD_CTX* ctx);
 
   EVP_MD_CTX mdctx_; /* coverity[member_decl] */
   bool initialised_;
@@ -681,6 +783,8 @@ class DiffieHellman : public BaseObject {
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GenerateKeys(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GenerateParameters(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetPrime(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetGenerator(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetPublicKey(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -706,6 +810,9 @@ class DiffieHellman : public BaseObject {
   bool initialised_;
   int verifyError_;
   DH* dh;
+
+  friend class DHKeyJob;
+  friend class DHParamsJob;
 };
 
 class ECDH : public BaseObject {
@@ -743,6 +850,8 @@ class ECDH : public BaseObject {
 
   EC_KEY* key_;
   const EC_GROUP* group_;
+
+  friend class ECDHKeyJob;
 };
 
 bool EntropySource(unsigned char* buffer, size_t length);
@@ -69,6 +69,23 @@ void NodeBIO::AssignEnvironment(Environment* env) {
 }
 
 
+void NodeBIO::ResumeAccounting() {
+  accounting_deferred_ = false;
+  if (deferred_external_size_ != 0) {
+    AdjustExternalSize(deferred_external_size_);
+    deferred_external_size_ = 0;
+  }
+}
+
+
+void NodeBIO::AdjustExternalSize(int64_t delta) {
+  if (accounting_deferred_)
+    deferred_external_size_ += delta;
+  else
+    env_->isolate()->AdjustAmountOfExternalAllocatedMemory(delta);
+}
+
+
 int NodeBIO::New(BIO* bio) {
   bio->ptr = new NodeBIO();
 
@@ -441,7 +458,7 @@ void NodeBIO::TryAllocateForWrite(size_t hint) {
                              kThroughputBufferLength;
     if (len < hint)
       len = hint;
-    Buffer* next = new Buffer(env_, len);
+    Buffer* next = new Buffer(this, len);
 
     if (w == nullptr) {
       next->next_ = next;
@@ -36,6 +36,8 @@ namespace node {
 class NodeBIO {
  public:
   NodeBIO() : env_(nullptr),
+              accounting_deferred_(false),
+              deferred_external_size_(0),
               initial_(kInitialBufferLength),
               length_(0),
               read_head_(nullptr),
@@ -52,6 +54,13 @@ class NodeBIO {
 
   void AssignEnvironment(Environment* env);
 
+  // The memory held by the BIO is reported to V8, which may only be done from
+  // the main thread. While accounting is deferred, changes are collected and
+  // only reported by ResumeAccounting(), so that the BIO can be used from
+  // another thread in the meantime.
+  inline void DeferAccounting() { accounting_deferred_ = true; }
+  void ResumeAccounting();
+
   // Move read head to next buffer if needed
   void TryMoveReadHead();
 
@@ -121,27 +130,30 @@ class NodeBIO {
 
   static const BIO_METHOD method;
 
+  void AdjustExternalSize(int64_t delta);
+
   class Buffer {
    public:
-    Buffer(Environment* env, size_t len) : env_(env),
-                                           read_pos_(0),
-                                           write_pos_(0),
-                                           len_(len),
-                                           next_(nullptr) {
+    Buffer(NodeBIO* bio, size_t len) : bio_(bio),
+                                       read_pos_(0),
+                                       write_pos_(0),
+                                       len_(len),
+                                       next_(nullptr) {
       data_ = new char[len];
-      if (env_ != nullptr)
-        env_->isolate()->AdjustAmountOfExternalAllocatedMemory(len);
+      if (bio_->env_ == nullptr)
+        bio_ = nullptr;
+      else
+        bio_->AdjustExternalSize(len);
     }
 
     ~Buffer() {
       delete[] data_;
-      if (env_ != nullptr) {
-        const int64_t len = static_cast<int64_t>(len_);
-        env_->isolate()->AdjustAmountOfExternalAllocatedMemory(-len);
-      }
+      if (bio_ != nullptr)
+        bio_->AdjustExternalSize(-static_cast<int64_t>(len_));
     }
 
-    Environment* env_;
+    // Only set if the buffer was accounted for.
+    NodeBIO* bio_;
     size_t read_pos_;
     size_t write_pos_;
     size_t len_;
@@ -150,6 +162,8 @@ class NodeBIO {
   };
 
   Environment* env_;
+  bool accounting_deferred_;
+  int64_t deferred_external_size_;
   size_t initial_;
   size_t length_;
   Buffer* read_head_;
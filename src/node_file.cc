@@ -21,9 +21,16 @@
 
 #include "node.h"
 #include "node_buffer.h"
+#include "node_constants.h"
+#include "node_counter_registry.h"
 #include "node_internals.h"
+#include "node_mutex.h"
+#include "node_probes.h"
 #include "node_stat_watcher.h"
+#include "node_threadpool.h"
 
+#include "base-object.h"
+#include "base-object-inl.h"
 #include "env.h"
 #include "env-inl.h"
 #include "req-wrap.h"
@@ -40,8 +47,23 @@
 
 #if defined(__MINGW32__) || defined(_MSC_VER)
 # include <io.h>
+#else
+# include <dirent.h>
+# include <sys/mman.h>
+#endif
+
+#if defined(__linux__)
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# ifndef FICLONE
+#  define FICLONE _IOW(0x94, 9, int)
+# endif
 #endif
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace node {
@@ -55,10 +77,12 @@ using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
+using v8::Int32Array;
 using v8::Integer;
 using v8::Local;
 using v8::Number;
 using v8::Object;
+using v8::Promise;
 using v8::String;
 using v8::Value;
 
@@ -90,6 +114,11 @@ class FSReqWrap: public ReqWrap<uv_fs_t> {
     }
   }
 
+  // Records the request as a node.fs trace event from when it is made until
+  // After() runs. libuv does not tell when it leaves the threadpool queue,
+  // so unlike threadpool::QueueWork() this is the total latency only.
+  void TraceEvent(char phase) const;
+
   const char* syscall() const { return syscall_; }
   const char* data() const { return data_; }
   const enum encoding encoding_;
@@ -117,6 +146,7 @@ class FSReqWrap: public ReqWrap<uv_fs_t> {
 
   const char* syscall_;
   const char* data_;
+  size_t storage_size_ = 0;  // Of the ReqFreeList block this lives in.
 
   DISALLOW_COPY_AND_ASSIGN(FSReqWrap);
 };
@@ -134,17 +164,40 @@ FSReqWrap* FSReqWrap::New(Environment* env,
   const bool copy = (data != nullptr && ownership == COPY);
   const size_t size = copy ? 1 + strlen(data) : 0;
   FSReqWrap* that;
-  char* const storage = new char[sizeof(*that) + size];
+  const size_t storage_size = sizeof(*that) + size;
+  char* const storage = env->req_freelist()->Allocate(storage_size);
   that = new(storage) FSReqWrap(env, req, syscall, data, encoding);
+  that->storage_size_ = storage_size;
   if (copy)
     that->data_ = static_cast<char*>(memcpy(that->inline_data(), data, size));
+  that->TraceEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN);
+  if (NODE_FS_START_ENABLED())
+    NODE_FS_START(that, that->syscall());
   return that;
 }
 
 
+void FSReqWrap::TraceEvent(char phase) const {
+  // There is no platform without NODE_USE_V8_PLATFORM.
+  if (tracing::TraceEventHelper::GetCurrentPlatform() == nullptr)
+    return;
+  static const uint8_t* category_enabled =
+      TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED("node.fs");
+  if (!(*category_enabled & kEnabledForRecording_CategoryGroupEnabledFlags))
+    return;
+  // |syscall_| is always a literal.
+  tracing::AddTraceEvent(phase, category_enabled, syscall_,
+                         tracing::kGlobalScope,
+                         reinterpret_cast<uintptr_t>(this), tracing::kNoId,
+                         TRACE_EVENT_FLAG_HAS_ID);
+}
+
+
 void FSReqWrap::Dispose() {
+  Environment* env = this->env();
+  const size_t storage_size = storage_size_;
   this->~FSReqWrap();
-  delete[] reinterpret_cast<char*>(this);
+  env->req_freelist()->Free(reinterpret_cast<char*>(this), storage_size);
 }
 
 
@@ -153,6 +206,41 @@ void NewFSReqWrap(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// An FSReqPromise can be passed to the bindings wherever an FSReqWrap can.
+// Instead of a per-request oncomplete closure it carries a native promise,
+// exposed as its `promise` property, that its oncomplete method settles
+// through resolve() and reject(). The resolver lives in the second internal
+// field, the first one holds the FSReqWrap.
+void NewFSReqPromise(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args.IsConstructCall());
+  Environment* env = Environment::GetCurrent(args);
+  Local<Promise::Resolver> resolver =
+      Promise::Resolver::New(env->context()).ToLocalChecked();
+  args.This()->SetInternalField(1, resolver);
+  args.This()->Set(env->context(),
+                   env->promise_string(),
+                   resolver->GetPromise()).FromJust();
+}
+
+
+static void FSReqPromiseResolve(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Local<Value> resolver = args.Holder()->GetInternalField(1);
+  CHECK(resolver->IsObject());
+  resolver.As<Promise::Resolver>()->Resolve(env->context(), args[0])
+      .FromJust();
+}
+
+
+static void FSReqPromiseReject(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Local<Value> resolver = args.Holder()->GetInternalField(1);
+  CHECK(resolver->IsObject());
+  resolver.As<Promise::Resolver>()->Reject(env->context(), args[0])
+      .FromJust();
+}
+
+
 inline bool IsInt64(double x) {
   return x == static_cast<double>(static_cast<int64_t>(x));
 }
@@ -160,6 +248,9 @@ inline bool IsInt64(double x) {
 void After(uv_fs_t *req) {
   FSReqWrap* req_wrap = static_cast<FSReqWrap*>(req->data);
   CHECK_EQ(req_wrap->req(), req);
+  req_wrap->TraceEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_END);
+  if (NODE_FS_DONE_ENABLED())
+    NODE_FS_DONE(req_wrap, req_wrap->syscall(), static_cast<int>(req->result));
   req_wrap->ReleaseEarly();  // Free memory that's no longer used now.
 
   Environment* env = req_wrap->env();
@@ -365,6 +456,7 @@ class fs_req_wrap {
   CHECK(request->IsObject());                                                 \
   FSReqWrap* req_wrap = FSReqWrap::New(env, request.As<Object>(),             \
                                        #func, dest, encoding);                \
+  counters::Add(counters::kFsOperations, 1);                                  \
   int err = uv_fs_ ## func(env->event_loop(),                                 \
                            req_wrap->req(),                                   \
                            __VA_ARGS__,                                       \
@@ -386,6 +478,7 @@ class fs_req_wrap {
 #define SYNC_DEST_CALL(func, path, dest, ...)                                 \
   fs_req_wrap req_wrap;                                                       \
   env->PrintSyncTrace();                                                      \
+  counters::Add(counters::kFsOperations, 1);                                  \
   int err = uv_fs_ ## func(env->event_loop(),                                 \
                          &req_wrap.req,                                       \
                          __VA_ARGS__,                                         \
@@ -473,22 +566,162 @@ void FillStatsArray(double* fields, const uv_stat_t* s) {
 #undef X
 }
 
-// Used to speed up module loading.  Returns the contents of the file as
-// a string or undefined when the file cannot be opened.  The speedup
-// comes from not creating Error objects on failure.
-static void InternalModuleReadFile(const FunctionCallbackInfo<Value>& args) {
+// Hints for MapFile(), passed to madvise() on POSIX systems and ignored on
+// Windows.
+enum MmapAdvice {
+  MMAP_ADVICE_NORMAL,
+  MMAP_ADVICE_RANDOM,
+  MMAP_ADVICE_SEQUENTIAL,
+  MMAP_ADVICE_WILLNEED
+};
+
+// What UnmapFile() needs to release a mapping.  The mapping starts on a page
+// boundary, so the Buffer handed to JavaScript may start past |base|.
+struct FileMapping {
+  char* base;
+  size_t length;
+};
+
+static void UnmapFile(char* data, void* hint) {
+  FileMapping* mapping = static_cast<FileMapping*>(hint);
+#ifdef _WIN32
+  UnmapViewOfFile(mapping->base);
+#else
+  munmap(mapping->base, mapping->length);
+#endif
+  delete mapping;
+}
+
+// mmap(fd, offset, length, advice)
+// Maps |length| bytes of |fd| starting at |offset| into memory, copy-on-write,
+// and returns them as a Buffer.  The mapping is released when the Buffer's
+// ArrayBuffer is garbage collected; closing |fd| doesn't affect it.
+static void MapFile(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
-  uv_loop_t* loop = env->event_loop();
 
-  CHECK(args[0]->IsString());
-  node::Utf8Value path(env->isolate(), args[0]);
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsNumber());
+  CHECK(args[2]->IsUint32());
+  CHECK(args[3]->IsUint32());
 
+  const int fd = args[0]->Int32Value();
+  const int64_t offset = static_cast<int64_t>(args[1]->NumberValue());
+  const size_t length = args[2]->Uint32Value();
+  const uint32_t advice = args[3]->Uint32Value();
+  CHECK_GE(offset, 0);
+  CHECK_LE(length, Buffer::kMaxLength);
+
+  if (length == 0) {
+    args.GetReturnValue().Set(
+        Buffer::New(env->isolate(), 0).ToLocalChecked());
+    return;
+  }
+
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  const int64_t granularity = info.dwAllocationGranularity;
+#else
+  const int64_t granularity = sysconf(_SC_PAGESIZE);
+#endif
+  const int64_t start = offset - offset % granularity;
+  const size_t skip = static_cast<size_t>(offset - start);
+
+  FileMapping* mapping = new FileMapping;
+  mapping->length = skip + length;
+
+#ifdef _WIN32
+  HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  HANDLE handle = file == INVALID_HANDLE_VALUE ? nullptr :
+      CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (handle == nullptr) {
+    delete mapping;
+    return env->isolate()->ThrowException(
+        WinapiErrnoException(env->isolate(), GetLastError(), "mmap"));
+  }
+  mapping->base = static_cast<char*>(
+      MapViewOfFile(handle,
+                    FILE_MAP_COPY,
+                    static_cast<DWORD>(start >> 32),
+                    static_cast<DWORD>(start & 0xFFFFFFFF),
+                    mapping->length));
+  // The view keeps the mapping object alive.
+  const DWORD error = GetLastError();
+  CloseHandle(handle);
+  if (mapping->base == nullptr) {
+    delete mapping;
+    return env->isolate()->ThrowException(
+        WinapiErrnoException(env->isolate(), error, "mmap"));
+  }
+#else
+  void* base = mmap(nullptr,
+                    mapping->length,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE,
+                    fd,
+                    static_cast<off_t>(start));
+  if (base == MAP_FAILED) {
+    delete mapping;
+    return env->ThrowErrnoException(errno, "mmap");
+  }
+  mapping->base = static_cast<char*>(base);
+
+  int flag;
+  switch (advice) {
+    case MMAP_ADVICE_RANDOM: flag = MADV_RANDOM; break;
+    case MMAP_ADVICE_SEQUENTIAL: flag = MADV_SEQUENTIAL; break;
+    case MMAP_ADVICE_WILLNEED: flag = MADV_WILLNEED; break;
+    default: flag = MADV_NORMAL;
+  }
+  // Only a hint, failing to apply it is harmless.
+  if (flag != MADV_NORMAL)
+    madvise(base, mapping->length, flag);
+#endif
+
+  Local<Object> buffer;
+  if (!Buffer::New(env->isolate(),
+                   mapping->base + skip,
+                   length,
+                   UnmapFile,
+                   mapping).ToLocal(&buffer)) {
+    UnmapFile(mapping->base + skip, mapping);
+    return;
+  }
+  args.GetReturnValue().Set(buffer);
+}
+
+// With --module-resolution-cache, the results of InternalModuleReadFile()
+// and InternalModuleStat() are kept until ClearModuleResolutionCache() is
+// called, so a large dependency tree doesn't cost tens of thousands of
+// system calls at startup.  Shared by the main thread and Workers, behind
+// |mutex|, which isn't held while the file system is accessed.
+struct ModuleResolutionCache {
+  Mutex mutex;
+  // Path to file contents, or to nullptr when the file couldn't be opened.
+  // Shared so that the contents outlive a clear while they're being used.
+  std::unordered_map<std::string, std::shared_ptr<const std::string>> files;
+  // Path to the InternalModuleStat() return value.
+  std::unordered_map<std::string, int> stats;
+};
+
+static ModuleResolutionCache* GetModuleResolutionCache() {
+  if (!config_module_resolution_cache)
+    return nullptr;
+  // Deliberately leaked, it lives as long as the process.
+  static ModuleResolutionCache* cache = new ModuleResolutionCache();
+  return cache;
+}
+
+// Returns the contents of |path| without a UTF-8 BOM, or nullptr when the
+// file cannot be opened.
+static std::unique_ptr<std::string> ReadModuleFile(uv_loop_t* loop,
+                                                   const char* path) {
   uv_fs_t open_req;
-  const int fd = uv_fs_open(loop, &open_req, *path, O_RDONLY, 0, nullptr);
+  const int fd = uv_fs_open(loop, &open_req, path, O_RDONLY, 0, nullptr);
   uv_fs_req_cleanup(&open_req);
 
   if (fd < 0) {
-    return;
+    return nullptr;
   }
 
   const size_t kBlockSize = 32 << 10;
@@ -520,11 +753,48 @@ static void InternalModuleReadFile(const FunctionCallbackInfo<Value>& args) {
     start = 3;  // Skip UTF-8 BOM.
   }
 
+  return std::unique_ptr<std::string>(
+      new std::string(&chars[start], offset - start));
+}
+
+// Used to speed up module loading.  Returns the contents of the file as
+// a string or undefined when the file cannot be opened.  The speedup
+// comes from not creating Error objects on failure.
+static void InternalModuleReadFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(env->isolate(), args[0]);
+
+  std::shared_ptr<const std::string> result;
+  bool cached = false;
+  ModuleResolutionCache* cache = GetModuleResolutionCache();
+  if (cache != nullptr) {
+    Mutex::ScopedLock lock(cache->mutex);
+    auto it = cache->files.find(*path);
+    if (it != cache->files.end()) {
+      result = it->second;
+      cached = true;
+    }
+  }
+
+  if (!cached) {
+    result = ReadModuleFile(env->event_loop(), *path);
+    if (cache != nullptr) {
+      Mutex::ScopedLock lock(cache->mutex);
+      cache->files.emplace(*path, result);
+    }
+  }
+
+  if (result == nullptr) {
+    return;
+  }
+
   Local<String> chars_string =
       String::NewFromUtf8(env->isolate(),
-                          &chars[start],
+                          result->data(),
                           String::kNormalString,
-                          offset - start);
+                          result->size());
   args.GetReturnValue().Set(chars_string);
 }
 
@@ -537,6 +807,14 @@ static void InternalModuleStat(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsString());
   node::Utf8Value path(env->isolate(), args[0]);
 
+  ModuleResolutionCache* cache = GetModuleResolutionCache();
+  if (cache != nullptr) {
+    Mutex::ScopedLock lock(cache->mutex);
+    auto it = cache->stats.find(*path);
+    if (it != cache->stats.end())
+      return args.GetReturnValue().Set(it->second);
+  }
+
   uv_fs_t req;
   int rc = uv_fs_stat(env->event_loop(), &req, *path, nullptr);
   if (rc == 0) {
@@ -545,9 +823,27 @@ static void InternalModuleStat(const FunctionCallbackInfo<Value>& args) {
   }
   uv_fs_req_cleanup(&req);
 
+  if (cache != nullptr) {
+    Mutex::ScopedLock lock(cache->mutex);
+    cache->stats.emplace(*path, rc);
+  }
+
   args.GetReturnValue().Set(rc);
 }
 
+// Drops everything InternalModuleReadFile() and InternalModuleStat() have
+// cached.  Returns false when the cache is not enabled.
+static void ClearModuleResolutionCache(
+    const FunctionCallbackInfo<Value>& args) {
+  ModuleResolutionCache* cache = GetModuleResolutionCache();
+  if (cache != nullptr) {
+    Mutex::ScopedLock lock(cache->mutex);
+    cache->files.clear();
+    cache->stats.clear();
+  }
+  args.GetReturnValue().Set(cache != nullptr);
+}
+
 static void Stat(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -1183,6 +1479,1253 @@ static void Read(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Reads a whole file on the thread pool: open, fstat, read until EOF and
+// close all run in one work request, so the file contents reach JS in a
+// single callback instead of one per system call.
+class ReadFileWrap : public ReqWrap<uv_work_t> {
+ public:
+  ReadFileWrap(Environment* env,
+               Local<Object> req_wrap_obj,
+               const char* path,
+               size_t path_length,
+               uv_file fd,
+               int flags)
+      : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_FSREQWRAP),
+        path_(path == nullptr ? "" : std::string(path, path_length)),
+        owns_fd_(path != nullptr),
+        fd_(fd),
+        flags_(flags),
+        syscall_(nullptr),
+        err_(0),
+        too_large_(false),
+        data_(nullptr),
+        length_(0) {
+    Wrap(req_wrap_obj, this);
+  }
+
+  ~ReadFileWrap() override {
+    free(data_);
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+  int Queue() {
+    Dispatched();
+    return threadpool::QueueWork(env()->event_loop(),
+                                 req(),
+                                 threadpool::kFsWork,
+                                 threadpool::kLowPriority,
+                                 Work,
+                                 AfterWork,
+                                 NODE_THREADPOOL_TRACE_FS,
+                                 "fs.readFile");
+  }
+
+ private:
+  // Chunk size for files whose size fstat() does not report.
+  static const size_t kChunkSize = 64 * 1024;
+
+  bool owns_fd() const { return owns_fd_; }
+
+  void Fail(const char* syscall, int err) {
+    syscall_ = syscall;
+    err_ = err;
+  }
+
+  void ReadAll() {
+    uv_fs_t stat_req;
+    int r = uv_fs_fstat(nullptr, &stat_req, fd_, nullptr);
+    const uv_stat_t* s = static_cast<const uv_stat_t*>(stat_req.ptr);
+    const bool known_size = r == 0 && (s->st_mode & S_IFMT) == S_IFREG;
+    const uint64_t size = known_size ? s->st_size : 0;
+    uv_fs_req_cleanup(&stat_req);
+
+    if (r < 0)
+      return Fail("fstat", r);
+
+    if (size > Buffer::kMaxLength) {
+      too_large_ = true;
+      return;
+    }
+
+    size_t capacity = size > 0 ? size : kChunkSize;
+    data_ = node::UncheckedMalloc(capacity);
+    if (data_ == nullptr)
+      return Fail("read", UV_ENOMEM);
+
+    for (;;) {
+      if (length_ == capacity) {
+        // Files that report no size are read until EOF, growing the
+        // buffer as needed. Regular files are done once full.
+        if (size > 0)
+          break;
+        if (capacity + kChunkSize > Buffer::kMaxLength) {
+          too_large_ = true;
+          return;
+        }
+        char* data = node::UncheckedRealloc(data_, capacity + kChunkSize);
+        if (data == nullptr)
+          return Fail("read", UV_ENOMEM);
+        data_ = data;
+        capacity += kChunkSize;
+      }
+
+      uv_buf_t buf = uv_buf_init(data_ + length_, capacity - length_);
+      uv_fs_t read_req;
+      r = uv_fs_read(nullptr, &read_req, fd_, &buf, 1, -1, nullptr);
+      uv_fs_req_cleanup(&read_req);
+      if (r < 0)
+        return Fail("read", r);
+      if (r == 0)
+        break;
+      length_ += r;
+    }
+  }
+
+  static void Work(uv_work_t* req) {
+    ReadFileWrap* w = ContainerOf(&ReadFileWrap::req_, req);
+
+    if (w->owns_fd()) {
+      uv_fs_t open_req;
+      int fd = uv_fs_open(nullptr,
+                          &open_req,
+                          w->path_.c_str(),
+                          w->flags_,
+                          0666,
+                          nullptr);
+      uv_fs_req_cleanup(&open_req);
+      if (fd < 0)
+        return w->Fail("open", fd);
+      w->fd_ = fd;
+    }
+
+    w->ReadAll();
+
+    if (w->owns_fd()) {
+      uv_fs_t close_req;
+      int r = uv_fs_close(nullptr, &close_req, w->fd_, nullptr);
+      uv_fs_req_cleanup(&close_req);
+      if (r < 0 && w->err_ == 0 && !w->too_large_)
+        w->Fail("close", r);
+    }
+  }
+
+  static void AfterWork(uv_work_t* req, int status) {
+    CHECK_EQ(status, 0);
+    ReadFileWrap* w = ContainerOf(&ReadFileWrap::req_, req);
+    Environment* env = w->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    Local<Value> argv[2];
+    int argc = 1;
+    if (w->err_ != 0) {
+      // Like fs.open(), only a failed open mentions the path; errors from
+      // reading the file descriptor don't.
+      const bool open_failed = w->owns_fd() && w->fd_ < 0;
+      argv[0] = UVException(env->isolate(),
+                            w->err_,
+                            w->syscall_,
+                            nullptr,
+                            open_failed ? w->path_.c_str() : nullptr,
+                            nullptr);
+    } else if (w->too_large_) {
+      char message[128];
+      snprintf(message,
+               sizeof(message),
+               "File size is greater than possible Buffer: 0x%x bytes",
+               Buffer::kMaxLength);
+      argv[0] = v8::Exception::RangeError(
+          OneByteString(env->isolate(), message));
+    } else {
+      char* data = w->data_;
+      w->data_ = nullptr;
+      if (w->length_ == 0) {
+        free(data);
+        data = nullptr;
+      } else {
+        // Give back the slack of the last chunk for files of unknown size.
+        data = node::Realloc(data, w->length_);
+      }
+      argv[0] = Null(env->isolate());
+      argv[1] = Buffer::New(env, data, w->length_).ToLocalChecked();
+      argc = 2;
+    }
+
+    w->MakeCallback(env->oncomplete_string(), argc, argv);
+    delete w;
+  }
+
+  const std::string path_;
+  const bool owns_fd_;
+  uv_file fd_;
+  const int flags_;
+  const char* syscall_;
+  int err_;
+  bool too_large_;
+  char* data_;
+  size_t length_;
+};
+
+
+// Wrapper for a whole-file read.
+//
+// readFile(path, flags, req)
+// 0 path      the file to read, or the file descriptor to read from. A file
+//             descriptor is read from its current position and not closed.
+// 1 flags     flags to open the file with
+// 2 req       the FSReqWrap that receives oncomplete(err, buffer)
+static void ReadFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  if (!args[1]->IsInt32())
+    return TYPE_ERROR("flags must be an int");
+  CHECK(args[2]->IsObject());
+
+  int flags = args[1]->Int32Value();
+  ReadFileWrap* req_wrap;
+  if (args[0]->IsInt32()) {
+    req_wrap = new ReadFileWrap(env,
+                                args[2].As<Object>(),
+                                nullptr,
+                                0,
+                                args[0]->Int32Value(),
+                                flags);
+  } else {
+    BufferValue path(env->isolate(), args[0]);
+    ASSERT_PATH(path)
+    req_wrap = new ReadFileWrap(env,
+                                args[2].As<Object>(),
+                                *path,
+                                path.length(),
+                                -1,
+                                flags);
+  }
+  CHECK_EQ(0, req_wrap->Queue());
+  args.GetReturnValue().Set(req_wrap->persistent());
+}
+
+
+// Copies |src| to |dest|, doing as little of the work in userspace as the
+// platform allows: CopyFileW() on Windows, and otherwise a FICLONE reflink
+// when asked for, copy_file_range(2) on Linux, and uv_fs_sendfile(), which
+// uses sendfile(2) where it can and a read/write loop where it can't.
+// Returns 0 or a libuv error code.
+static int CopyFileContents(const char* src, const char* dest, int flags) {
+#ifdef _WIN32
+  if (flags & COPYFILE_FICLONE_FORCE)
+    return UV_ENOSYS;
+
+  const int src_length = MultiByteToWideChar(CP_UTF8, 0, src, -1, nullptr, 0);
+  const int dest_length =
+      MultiByteToWideChar(CP_UTF8, 0, dest, -1, nullptr, 0);
+  if (src_length == 0 || dest_length == 0)
+    return UV_EINVAL;
+  std::vector<WCHAR> wide_src(src_length);
+  std::vector<WCHAR> wide_dest(dest_length);
+  MultiByteToWideChar(CP_UTF8, 0, src, -1, wide_src.data(), src_length);
+  MultiByteToWideChar(CP_UTF8, 0, dest, -1, wide_dest.data(), dest_length);
+
+  if (!CopyFileW(wide_src.data(),
+                 wide_dest.data(),
+                 (flags & COPYFILE_EXCL) != 0)) {
+    return uv_translate_sys_error(GetLastError());
+  }
+  return 0;
+#else
+  uv_fs_t req;
+  const int in = uv_fs_open(nullptr, &req, src, O_RDONLY, 0, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (in < 0)
+    return in;
+
+  int err = uv_fs_fstat(nullptr, &req, in, nullptr);
+  const uv_stat_t src_stat = req.statbuf;
+  uv_fs_req_cleanup(&req);
+  if (err < 0) {
+    uv_fs_close(nullptr, &req, in, nullptr);
+    uv_fs_req_cleanup(&req);
+    return err;
+  }
+
+  // Not O_TRUNC: |dest| may be |src| under another name.
+  const int oflags =
+      O_WRONLY | O_CREAT | ((flags & COPYFILE_EXCL) ? O_EXCL : 0);
+  const int out = uv_fs_open(nullptr, &req, dest, oflags,
+                             src_stat.st_mode & 0777, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (out < 0) {
+    uv_fs_close(nullptr, &req, in, nullptr);
+    uv_fs_req_cleanup(&req);
+    return out;
+  }
+
+  const int64_t size = src_stat.st_size;
+  int64_t offset = 0;
+
+  err = uv_fs_fstat(nullptr, &req, out, nullptr);
+  const bool same_file = err == 0 &&
+                         req.statbuf.st_dev == src_stat.st_dev &&
+                         req.statbuf.st_ino == src_stat.st_ino;
+  uv_fs_req_cleanup(&req);
+  if (err < 0 || same_file)
+    goto done;
+
+  err = uv_fs_ftruncate(nullptr, &req, out, 0, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err < 0)
+    goto done;
+
+  err = uv_fs_fchmod(nullptr, &req, out, src_stat.st_mode & 07777, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err < 0)
+    goto done;
+
+  if (flags & (COPYFILE_FICLONE | COPYFILE_FICLONE_FORCE)) {
+#ifdef FICLONE
+    if (ioctl(out, FICLONE, in) == 0)
+      goto done;
+    if (flags & COPYFILE_FICLONE_FORCE) {
+      err = -errno;
+      goto done;
+    }
+#else
+    if (flags & COPYFILE_FICLONE_FORCE) {
+      err = UV_ENOSYS;
+      goto done;
+    }
+#endif
+  }
+
+#if defined(__linux__) && defined(__NR_copy_file_range)
+  while (offset < size) {
+    loff_t in_offset = offset;
+    const ssize_t n = syscall(__NR_copy_file_range,
+                              in, &in_offset, out, nullptr,
+                              static_cast<size_t>(size - offset), 0);
+    if (n > 0) {
+      offset += n;
+      continue;
+    }
+    if (n == 0)  // |src| was truncated while it was being copied.
+      goto done;
+    if (errno == EINTR)
+      continue;
+    // Not supported by this kernel or file system, or across them.
+    if (offset == 0 && (errno == ENOSYS || errno == EXDEV ||
+                        errno == EINVAL || errno == EOPNOTSUPP)) {
+      break;
+    }
+    err = -errno;
+    goto done;
+  }
+#endif
+
+  while (offset < size) {
+    const int n = uv_fs_sendfile(nullptr, &req, out, in, offset,
+                                 static_cast<size_t>(size - offset), nullptr);
+    uv_fs_req_cleanup(&req);
+    if (n < 0) {
+      err = n;
+      goto done;
+    }
+    if (n == 0)
+      break;
+    offset += n;
+  }
+
+ done:
+  uv_fs_close(nullptr, &req, out, nullptr);
+  uv_fs_req_cleanup(&req);
+  uv_fs_close(nullptr, &req, in, nullptr);
+  uv_fs_req_cleanup(&req);
+  // Don't leave a partial copy behind.
+  if (err < 0 && !same_file) {
+    uv_fs_unlink(nullptr, &req, dest, nullptr);
+    uv_fs_req_cleanup(&req);
+  }
+  return err;
+#endif  // _WIN32
+}
+
+
+class CopyFileWrap : public ReqWrap<uv_work_t> {
+ public:
+  CopyFileWrap(Environment* env,
+               Local<Object> req_wrap_obj,
+               const char* src,
+               const char* dest,
+               int flags)
+      : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_FSREQWRAP),
+        src_(src),
+        dest_(dest),
+        flags_(flags),
+        err_(0) {
+    Wrap(req_wrap_obj, this);
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+  int Queue() {
+    Dispatched();
+    return threadpool::QueueWork(env()->event_loop(),
+                                 req(),
+                                 threadpool::kFsWork,
+                                 threadpool::kLowPriority,
+                                 Work,
+                                 AfterWork,
+                                 NODE_THREADPOOL_TRACE_FS,
+                                 "fs.copyFile");
+  }
+
+ private:
+  static void Work(uv_work_t* req) {
+    CopyFileWrap* w = ContainerOf(&CopyFileWrap::req_, req);
+    w->err_ = CopyFileContents(w->src_.c_str(), w->dest_.c_str(), w->flags_);
+  }
+
+  static void AfterWork(uv_work_t* req, int status) {
+    CHECK_EQ(status, 0);
+    CopyFileWrap* w = ContainerOf(&CopyFileWrap::req_, req);
+    Environment* env = w->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    Local<Value> arg = Null(env->isolate());
+    if (w->err_ != 0) {
+      arg = UVException(env->isolate(),
+                        w->err_,
+                        "copyfile",
+                        nullptr,
+                        w->src_.c_str(),
+                        w->dest_.c_str());
+    }
+    w->MakeCallback(env->oncomplete_string(), 1, &arg);
+    delete w;
+  }
+
+  const std::string src_;
+  const std::string dest_;
+  const int flags_;
+  int err_;
+};
+
+
+// Wrapper for copying a file.
+//
+// copyFile(src, dest, flags, req)
+// 0 src    source path
+// 1 dest   destination path
+// 2 flags  COPYFILE_* flags
+// 3 req    if set, the FSReqWrap that receives oncomplete(err); otherwise the
+//          copy is done synchronously
+// Not called CopyFile(), windows.h defines that as a macro.
+static void FSCopyFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  BufferValue src(env->isolate(), args[0]);
+  ASSERT_PATH(src)
+  BufferValue dest(env->isolate(), args[1]);
+  ASSERT_PATH(dest)
+  if (!args[2]->IsInt32())
+    return TYPE_ERROR("flags must be an int");
+  const int flags = args[2]->Int32Value();
+
+  if (args[3]->IsObject()) {
+    CopyFileWrap* req_wrap =
+        new CopyFileWrap(env, args[3].As<Object>(), *src, *dest, flags);
+    CHECK_EQ(0, req_wrap->Queue());
+    return args.GetReturnValue().Set(req_wrap->persistent());
+  }
+
+  env->PrintSyncTrace();
+  const int err = CopyFileContents(*src, *dest, flags);
+  if (err != 0)
+    env->ThrowUVException(err, "copyfile", nullptr, *src, *dest);
+}
+
+
+// Stats a batch of paths one after the other, from the thread pool or
+// synchronously. The results are handed to JS as one packed Float64Array with
+// FillStatsArray()'s layout for every path, and a sparse array holding the
+// errors for the paths that could not be stat()ed.
+class StatBatch {
+ public:
+  static const size_t kFieldsPerStat = 14;
+
+  explicit StatBatch(bool follow_links) : follow_links_(follow_links) {}
+
+  void AddPath(const char* path, size_t length) {
+    paths_.emplace_back(path, length);
+  }
+
+  void Run() {
+    stats_.resize(paths_.size());
+    errors_.resize(paths_.size());
+    for (size_t i = 0; i < paths_.size(); i++) {
+      uv_fs_t req;
+      int r = follow_links_ ?
+          uv_fs_stat(nullptr, &req, paths_[i].c_str(), nullptr) :
+          uv_fs_lstat(nullptr, &req, paths_[i].c_str(), nullptr);
+      if (r == 0)
+        stats_[i] = *static_cast<const uv_stat_t*>(req.ptr);
+      errors_[i] = r;
+      uv_fs_req_cleanup(&req);
+    }
+  }
+
+  void ToJS(Environment* env, Local<Value>* fields, Local<Value>* errors) {
+    const size_t count = paths_.size();
+    Local<ArrayBuffer> ab =
+        ArrayBuffer::New(env->isolate(),
+                         count * kFieldsPerStat * sizeof(double));
+    double* data = static_cast<double*>(ab->GetContents().Data());
+    Local<Array> error_array = Array::New(env->isolate());
+    for (size_t i = 0; i < count; i++) {
+      if (errors_[i] == 0) {
+        FillStatsArray(data + i * kFieldsPerStat, &stats_[i]);
+        continue;
+      }
+      Local<Value> err = UVException(env->isolate(),
+                                     errors_[i],
+                                     follow_links_ ? "stat" : "lstat",
+                                     nullptr,
+                                     paths_[i].c_str(),
+                                     nullptr);
+      error_array->Set(env->context(), i, err).FromJust();
+    }
+    *fields = Float64Array::New(ab, 0, count * kFieldsPerStat);
+    *errors = error_array;
+  }
+
+ private:
+  const bool follow_links_;
+  std::vector<std::string> paths_;
+  std::vector<uv_stat_t> stats_;
+  std::vector<int> errors_;
+};
+
+
+class StatBatchWrap : public ReqWrap<uv_work_t> {
+ public:
+  StatBatchWrap(Environment* env,
+                Local<Object> req_wrap_obj,
+                bool follow_links)
+      : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_FSREQWRAP),
+        batch_(follow_links) {
+    Wrap(req_wrap_obj, this);
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+  StatBatch* batch() { return &batch_; }
+
+  int Queue() {
+    Dispatched();
+    return threadpool::QueueWork(env()->event_loop(),
+                                 req(),
+                                 threadpool::kFsWork,
+                                 threadpool::kHighPriority,
+                                 Work,
+                                 AfterWork,
+                                 NODE_THREADPOOL_TRACE_FS,
+                                 "fs.statBatch");
+  }
+
+ private:
+  static void Work(uv_work_t* req) {
+    StatBatchWrap* w = ContainerOf(&StatBatchWrap::req_, req);
+    w->batch_.Run();
+  }
+
+  static void AfterWork(uv_work_t* req, int status) {
+    CHECK_EQ(status, 0);
+    StatBatchWrap* w = ContainerOf(&StatBatchWrap::req_, req);
+    Environment* env = w->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    Local<Value> argv[3];
+    argv[0] = Null(env->isolate());
+    w->batch_.ToJS(env, &argv[1], &argv[2]);
+    w->MakeCallback(env->oncomplete_string(), arraysize(argv), argv);
+    delete w;
+  }
+
+  StatBatch batch_;
+};
+
+
+// Wrapper for stat(2) or lstat(2) on many paths at once.
+//
+// statBatch(paths, followLinks, req)
+// 0 paths        array of paths
+// 1 followLinks  stat() the paths if true, lstat() them otherwise
+// 2 req          if set, the FSReqWrap that receives
+//                oncomplete(null, fields, errors); otherwise
+//                [fields, errors] is returned
+static void StatBatchPaths(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  if (!args[0]->IsArray())
+    return TYPE_ERROR("paths must be an array");
+
+  Local<Array> paths = args[0].As<Array>();
+  const bool follow_links = args[1]->IsTrue();
+  StatBatchWrap* req_wrap = nullptr;
+  StatBatch sync_batch(follow_links);
+  StatBatch* batch = &sync_batch;
+  if (args[2]->IsObject()) {
+    req_wrap = new StatBatchWrap(env, args[2].As<Object>(), follow_links);
+    batch = req_wrap->batch();
+  }
+
+  for (uint32_t i = 0; i < paths->Length(); i++) {
+    BufferValue path(env->isolate(),
+                     paths->Get(env->context(), i).ToLocalChecked());
+    if (*path == nullptr) {
+      if (req_wrap != nullptr) {
+        req_wrap->Dispatched();
+        delete req_wrap;
+      }
+      return TYPE_ERROR("path must be a string or Buffer");
+    }
+    batch->AddPath(*path, path.length());
+  }
+
+  if (req_wrap != nullptr) {
+    CHECK_EQ(0, req_wrap->Queue());
+    return args.GetReturnValue().Set(req_wrap->persistent());
+  }
+
+  env->PrintSyncTrace();
+  sync_batch.Run();
+  Local<Value> fields;
+  Local<Value> errors;
+  sync_batch.ToJS(env, &fields, &errors);
+  Local<Array> result = Array::New(env->isolate(), 2);
+  result->Set(env->context(), 0, fields).FromJust();
+  result->Set(env->context(), 1, errors).FromJust();
+  args.GetReturnValue().Set(result);
+}
+
+
+// Runs a batch of positioned reads and writes over any number of file
+// descriptors, from the thread pool or synchronously. Runs of operations of
+// the same kind on the same fd that follow on from each other in the file
+// are coalesced into a single preadv(2) or pwritev(2). The number of bytes
+// each operation transferred is handed to JS as an Int32Array, together with
+// a sparse array holding the errors for the operations that failed.
+class IOBatch {
+ public:
+  enum Kind { kRead, kWrite };
+  // Layout of an operation in the descriptor array handed in from JS.
+  static const size_t kFieldsPerOp = 5;  // kind, fd, offset, length, position
+
+  void AddOp(Kind kind, int fd, char* data, size_t length, int64_t position) {
+    ops_.push_back({ kind, fd, uv_buf_init(data, length), position });
+  }
+
+  void Run() {
+    results_.resize(ops_.size());
+    std::vector<uv_buf_t> bufs;
+    for (size_t i = 0; i < ops_.size(); ) {
+      const Op& first = ops_[i];
+      int64_t next = first.position + static_cast<int64_t>(first.buf.len);
+      size_t end = i + 1;
+      while (first.position >= 0 && end < ops_.size() &&
+             end - i < kMaxRun && ops_[end].kind == first.kind &&
+             ops_[end].fd == first.fd && ops_[end].position == next &&
+             next - first.position + static_cast<int64_t>(ops_[end].buf.len) <=
+                 INT_MAX) {
+        next += ops_[end].buf.len;
+        end++;
+      }
+
+      bufs.clear();
+      for (size_t j = i; j < end; j++)
+        bufs.push_back(ops_[j].buf);
+
+      uv_fs_t req;
+      int r = first.kind == kRead ?
+          uv_fs_read(nullptr, &req, first.fd, bufs.data(), bufs.size(),
+                     first.position, nullptr) :
+          uv_fs_write(nullptr, &req, first.fd, bufs.data(), bufs.size(),
+                      first.position, nullptr);
+      uv_fs_req_cleanup(&req);
+
+      // A short transfer fills the operations in order.
+      for (size_t j = i; j < end; j++) {
+        if (r < 0) {
+          results_[j] = r;
+          continue;
+        }
+        const int n = std::min(r, static_cast<int>(ops_[j].buf.len));
+        results_[j] = n;
+        r -= n;
+      }
+      i = end;
+    }
+  }
+
+  void ToJS(Environment* env, Local<Value>* results, Local<Value>* errors) {
+    const size_t count = ops_.size();
+    Local<ArrayBuffer> ab =
+        ArrayBuffer::New(env->isolate(), count * sizeof(int32_t));
+    int32_t* data = static_cast<int32_t*>(ab->GetContents().Data());
+    Local<Array> error_array = Array::New(env->isolate());
+    for (size_t i = 0; i < count; i++) {
+      data[i] = results_[i];
+      if (results_[i] >= 0)
+        continue;
+      Local<Value> err = UVException(env->isolate(),
+                                     results_[i],
+                                     ops_[i].kind == kRead ? "read" : "write");
+      error_array->Set(env->context(), i, err).FromJust();
+    }
+    *results = Int32Array::New(ab, 0, count);
+    *errors = error_array;
+  }
+
+ private:
+  // IOV_MAX is 1024 on the platforms that define it.
+  static const size_t kMaxRun = 1024;
+
+  struct Op {
+    Kind kind;
+    int fd;
+    uv_buf_t buf;
+    int64_t position;  // -1 for the fd's current position.
+  };
+
+  std::vector<Op> ops_;
+  std::vector<int> results_;
+};
+
+
+class IOBatchWrap : public ReqWrap<uv_work_t> {
+ public:
+  IOBatchWrap(Environment* env, Local<Object> req_wrap_obj)
+      : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_FSREQWRAP) {
+    Wrap(req_wrap_obj, this);
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+  IOBatch* batch() { return &batch_; }
+
+  int Queue() {
+    Dispatched();
+    return threadpool::QueueWork(env()->event_loop(),
+                                 req(),
+                                 threadpool::kFsWork,
+                                 threadpool::kNormalPriority,
+                                 Work,
+                                 AfterWork,
+                                 NODE_THREADPOOL_TRACE_FS,
+                                 "fs.ioBatch");
+  }
+
+ private:
+  static void Work(uv_work_t* req) {
+    IOBatchWrap* w = ContainerOf(&IOBatchWrap::req_, req);
+    w->batch_.Run();
+  }
+
+  static void AfterWork(uv_work_t* req, int status) {
+    CHECK_EQ(status, 0);
+    IOBatchWrap* w = ContainerOf(&IOBatchWrap::req_, req);
+    Environment* env = w->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    Local<Value> argv[3];
+    argv[0] = Null(env->isolate());
+    w->batch_.ToJS(env, &argv[1], &argv[2]);
+    w->MakeCallback(env->oncomplete_string(), arraysize(argv), argv);
+    delete w;
+  }
+
+  IOBatch batch_;
+};
+
+
+// Wrapper for many read(2) and write(2) calls at once.
+//
+// ioBatch(ops, buffers, req)
+// 0 ops      Float64Array with IOBatch::kFieldsPerOp fields per operation,
+//            checked by the caller
+// 1 buffers  array with the Buffer or Uint8Array of every operation; the
+//            caller keeps it alive until the request completes
+// 2 req      if set, the FSReqWrap that receives
+//            oncomplete(null, results, errors); otherwise
+//            [results, errors] is returned
+static void IOBatchOps(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsFloat64Array());
+  CHECK(args[1]->IsArray());
+  Local<Float64Array> ops = args[0].As<Float64Array>();
+  Local<Array> buffers = args[1].As<Array>();
+  const size_t count = buffers->Length();
+  CHECK_EQ(ops->Length(), count * IOBatch::kFieldsPerOp);
+  const double* fields = reinterpret_cast<const double*>(
+      static_cast<const char*>(ops->Buffer()->GetContents().Data()) +
+      ops->ByteOffset());
+
+  IOBatchWrap* req_wrap = nullptr;
+  IOBatch sync_batch;
+  IOBatch* batch = &sync_batch;
+  if (args[2]->IsObject()) {
+    req_wrap = new IOBatchWrap(env, args[2].As<Object>());
+    batch = req_wrap->batch();
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    const double* op = fields + i * IOBatch::kFieldsPerOp;
+    Local<Value> buffer = buffers->Get(env->context(), i).ToLocalChecked();
+    CHECK(Buffer::HasInstance(buffer));
+    const size_t offset = static_cast<size_t>(op[2]);
+    const size_t length = static_cast<size_t>(op[3]);
+    CHECK_LE(offset + length, Buffer::Length(buffer));
+    CHECK_LE(length, Buffer::kMaxLength);
+    batch->AddOp(op[0] == IOBatch::kWrite ? IOBatch::kWrite : IOBatch::kRead,
+                 static_cast<int>(op[1]),
+                 Buffer::Data(buffer) + offset,
+                 length,
+                 static_cast<int64_t>(op[4]));
+  }
+
+  if (req_wrap != nullptr) {
+    CHECK_EQ(0, req_wrap->Queue());
+    return args.GetReturnValue().Set(req_wrap->persistent());
+  }
+
+  env->PrintSyncTrace();
+  sync_batch.Run();
+  Local<Value> results;
+  Local<Value> errors;
+  sync_batch.ToJS(env, &results, &errors);
+  Local<Array> result = Array::New(env->isolate(), 2);
+  result->Set(env->context(), 0, results).FromJust();
+  result->Set(env->context(), 1, errors).FromJust();
+  args.GetReturnValue().Set(result);
+}
+
+
+struct DirEntry {
+  DirEntry(const char* name, uv_dirent_type_t type) : name(name), type(type) {}
+  std::string name;
+  uv_dirent_type_t type;
+};
+
+
+// Reads a directory a batch of entries at a time, without listing all of it
+// up front. On Windows, where there is no readdir(3), the listing is made
+// with uv_fs_scandir() when the directory is opened. The entries' types come
+// from the directory itself, and from lstat() where it does not tell.
+// Not thread safe, but it can be handed from one thread to another.
+class DirReader {
+ public:
+  DirReader() : dir_(nullptr) {}
+  ~DirReader() { Close(); }
+
+  int Open(const std::string& path) {
+    CHECK_EQ(dir_, nullptr);
+    path_ = path;
+#ifdef _WIN32
+    uv_fs_t* req = new uv_fs_t;
+    int r = uv_fs_scandir(nullptr, req, path.c_str(), 0, nullptr);
+    if (r < 0) {
+      uv_fs_req_cleanup(req);
+      delete req;
+      return r;
+    }
+    dir_ = req;
+#else
+    dir_ = opendir(path.c_str());
+    if (dir_ == nullptr)
+      return -errno;
+#endif
+    return 0;
+  }
+
+  // Appends up to |count| entries. Adds none once the end is reached.
+  int Read(size_t count, std::vector<DirEntry>* entries) {
+    CHECK_NE(dir_, nullptr);
+    const size_t end = entries->size() + count;
+    while (entries->size() < end) {
+#ifdef _WIN32
+      uv_dirent_t ent;
+      int r = uv_fs_scandir_next(dir_, &ent);
+      if (r == UV_EOF)
+        break;
+      if (r != 0)
+        return r;
+      entries->emplace_back(ent.name, ent.type);
+#else
+      errno = 0;
+      const struct dirent* ent = readdir(dir_);
+      if (ent == nullptr) {
+        if (errno != 0)
+          return -errno;
+        break;
+      }
+      if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+        continue;
+      entries->emplace_back(ent->d_name, TypeOf(ent));
+#endif
+    }
+    return 0;
+  }
+
+  int Close() {
+    if (dir_ == nullptr)
+      return 0;
+    int r = 0;
+#ifdef _WIN32
+    uv_fs_req_cleanup(dir_);
+    delete dir_;
+#else
+    if (closedir(dir_) != 0)
+      r = -errno;
+#endif
+    dir_ = nullptr;
+    return r;
+  }
+
+ private:
+#ifndef _WIN32
+  uv_dirent_type_t TypeOf(const struct dirent* ent) const {
+#ifdef HAVE_DIRENT_TYPES
+    switch (ent->d_type) {
+      case UV__DT_DIR: return UV_DIRENT_DIR;
+      case UV__DT_FILE: return UV_DIRENT_FILE;
+      case UV__DT_LINK: return UV_DIRENT_LINK;
+      case UV__DT_FIFO: return UV_DIRENT_FIFO;
+      case UV__DT_SOCKET: return UV_DIRENT_SOCKET;
+      case UV__DT_CHAR: return UV_DIRENT_CHAR;
+      case UV__DT_BLOCK: return UV_DIRENT_BLOCK;
+    }
+#endif
+    // Some file systems don't fill in d_type.
+    const std::string path = path_ + "/" + ent->d_name;
+    uv_fs_t req;
+    int r = uv_fs_lstat(nullptr, &req, path.c_str(), nullptr);
+    const uint64_t mode =
+        r == 0 ? static_cast<const uv_stat_t*>(req.ptr)->st_mode & S_IFMT : 0;
+    uv_fs_req_cleanup(&req);
+    switch (mode) {
+      case S_IFDIR: return UV_DIRENT_DIR;
+      case S_IFREG: return UV_DIRENT_FILE;
+      case S_IFLNK: return UV_DIRENT_LINK;
+      case S_IFIFO: return UV_DIRENT_FIFO;
+      case S_IFSOCK: return UV_DIRENT_SOCKET;
+      case S_IFCHR: return UV_DIRENT_CHAR;
+      case S_IFBLK: return UV_DIRENT_BLOCK;
+      default: return UV_DIRENT_UNKNOWN;
+    }
+  }
+#endif
+
+  std::string path_;
+#ifdef _WIN32
+  uv_fs_t* dir_;
+#else
+  DIR* dir_;
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(DirReader);
+};
+
+
+// Turns entries into an array of names and an array of their types. Returns
+// false if a name cannot be encoded.
+static bool DirEntriesToJS(Environment* env,
+                           const std::vector<DirEntry>& entries,
+                           enum encoding encoding,
+                           Local<Value>* names,
+                           Local<Value>* types) {
+  Local<Array> name_array = Array::New(env->isolate(), entries.size());
+  Local<Array> type_array = Array::New(env->isolate(), entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    Local<Value> name = StringBytes::Encode(env->isolate(),
+                                            entries[i].name.c_str(),
+                                            encoding);
+    if (name.IsEmpty())
+      return false;
+    name_array->Set(env->context(), i, name).FromJust();
+    type_array->Set(env->context(),
+                    i,
+                    Integer::New(env->isolate(), entries[i].type)).FromJust();
+  }
+  *names = name_array;
+  *types = type_array;
+  return true;
+}
+
+
+// An open directory, read from with read(encoding, count[, req]) until it
+// returns no more entries.
+class DirHandle : public BaseObject {
+ public:
+  DirHandle(Environment* env, Local<Object> object) : BaseObject(env, object) {
+    MakeWeak<DirHandle>(this);
+  }
+
+  DirReader* reader() { return &reader_; }
+
+  static void New(const FunctionCallbackInfo<Value>& args);
+  static void Open(const FunctionCallbackInfo<Value>& args);
+  static void Read(const FunctionCallbackInfo<Value>& args);
+  static void Close(const FunctionCallbackInfo<Value>& args);
+
+ private:
+  DirReader reader_;
+};
+
+
+// Runs a directory operation on the thread pool. kScan lists a whole
+// directory with its own reader, for fs.readdir() with file types.
+class DirReqWrap : public ReqWrap<uv_work_t> {
+ public:
+  enum Operation { kOpen, kRead, kClose, kScan };
+
+  DirReqWrap(Environment* env,
+             Local<Object> req_wrap_obj,
+             Operation op,
+             DirReader* reader,
+             const std::string& path,
+             size_t count,
+             enum encoding encoding)
+      : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_FSREQWRAP),
+        op_(op),
+        reader_(reader),
+        path_(path),
+        count_(count),
+        encoding_(encoding),
+        err_(0) {
+    Wrap(req_wrap_obj, this);
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+  int Queue() {
+    Dispatched();
+    return threadpool::QueueWork(env()->event_loop(),
+                                 req(),
+                                 threadpool::kFsWork,
+                                 threadpool::kNormalPriority,
+                                 Work,
+                                 AfterWork,
+                                 NODE_THREADPOOL_TRACE_FS,
+                                 "fs.readdir");
+  }
+
+  // Runs the operation on the calling thread. Returns the error, if any.
+  static int Run(Operation op,
+                 DirReader* reader,
+                 const std::string& path,
+                 size_t count,
+                 std::vector<DirEntry>* entries);
+
+  static const char* Syscall(Operation op) {
+    switch (op) {
+      case kOpen: return "opendir";
+      case kRead: return "readdir";
+      case kClose: return "closedir";
+      default: return "scandir";
+    }
+  }
+
+ private:
+  static void Work(uv_work_t* req) {
+    DirReqWrap* w = ContainerOf(&DirReqWrap::req_, req);
+    w->err_ = Run(w->op_, w->reader_, w->path_, w->count_, &w->entries_);
+  }
+
+  static void AfterWork(uv_work_t* req, int status) {
+    CHECK_EQ(status, 0);
+    DirReqWrap* w = ContainerOf(&DirReqWrap::req_, req);
+    Environment* env = w->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    Local<Value> argv[3];
+    int argc = 1;
+    argv[0] = Null(env->isolate());
+    if (w->err_ != 0) {
+      argv[0] = UVException(env->isolate(),
+                            w->err_,
+                            Syscall(w->op_),
+                            nullptr,
+                            w->path_.empty() ? nullptr : w->path_.c_str(),
+                            nullptr);
+    } else if (w->op_ == kRead || w->op_ == kScan) {
+      argc = 3;
+      if (!DirEntriesToJS(env, w->entries_, w->encoding_,
+                          &argv[1], &argv[2])) {
+        argc = 1;
+        argv[0] = UVException(env->isolate(),
+                              UV_EINVAL,
+                              Syscall(w->op_),
+                              "Invalid character encoding for filename",
+                              w->path_.empty() ? nullptr : w->path_.c_str(),
+                              nullptr);
+      }
+    }
+
+    w->MakeCallback(env->oncomplete_string(), argc, argv);
+    delete w;
+  }
+
+  const Operation op_;
+  DirReader* const reader_;
+  const std::string path_;
+  const size_t count_;
+  const enum encoding encoding_;
+  int err_;
+  std::vector<DirEntry> entries_;
+};
+
+
+int DirReqWrap::Run(Operation op,
+                    DirReader* reader,
+                    const std::string& path,
+                    size_t count,
+                    std::vector<DirEntry>* entries) {
+  switch (op) {
+    case kOpen:
+      return reader->Open(path);
+    case kRead:
+      return reader->Read(count, entries);
+    case kClose:
+      return reader->Close();
+    case kScan: {
+      DirReader scan_reader;
+      int r = scan_reader.Open(path);
+      while (r == 0) {
+        const size_t before = entries->size();
+        r = scan_reader.Read(1024, entries);
+        if (entries->size() == before)
+          break;
+      }
+      if (r == 0)
+        r = scan_reader.Close();
+#ifndef _WIN32
+      // Same order as fs.readdir(), which gets its entries from scandir(3).
+      std::sort(entries->begin(), entries->end(),
+                [](const DirEntry& a, const DirEntry& b) {
+                  return a.name < b.name;
+                });
+#endif
+      return r;
+    }
+  }
+  UNREACHABLE();
+}
+
+
+// Runs |op| on the thread pool if |req| is an object, and synchronously
+// otherwise, returning [names, types] for reads.
+static void DirOperation(const FunctionCallbackInfo<Value>& args,
+                         DirReqWrap::Operation op,
+                         DirReader* reader,
+                         const std::string& path,
+                         size_t count,
+                         enum encoding encoding,
+                         Local<Value> req) {
+  Environment* env = Environment::GetCurrent(args);
+
+  if (req->IsObject()) {
+    DirReqWrap* req_wrap = new DirReqWrap(env, req.As<Object>(), op, reader,
+                                          path, count, encoding);
+    CHECK_EQ(0, req_wrap->Queue());
+    return args.GetReturnValue().Set(req_wrap->persistent());
+  }
+
+  env->PrintSyncTrace();
+  std::vector<DirEntry> entries;
+  const char* path_or_null = path.empty() ? nullptr : path.c_str();
+  int err = DirReqWrap::Run(op, reader, path, count, &entries);
+  if (err != 0) {
+    return env->ThrowUVException(err, DirReqWrap::Syscall(op), nullptr,
+                                 path_or_null);
+  }
+  if (op != DirReqWrap::kRead && op != DirReqWrap::kScan)
+    return;
+
+  Local<Value> names;
+  Local<Value> types;
+  if (!DirEntriesToJS(env, entries, encoding, &names, &types)) {
+    return env->ThrowUVException(UV_EINVAL,
+                                 DirReqWrap::Syscall(op),
+                                 "Invalid character encoding for filename",
+                                 path_or_null);
+  }
+  Local<Array> result = Array::New(env->isolate(), 2);
+  result->Set(env->context(), 0, names).FromJust();
+  result->Set(env->context(), 1, types).FromJust();
+  args.GetReturnValue().Set(result);
+}
+
+
+void DirHandle::New(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args.IsConstructCall());
+  Environment* env = Environment::GetCurrent(args);
+  new DirHandle(env, args.This());
+}
+
+
+// open(path[, req])
+void DirHandle::Open(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  DirHandle* dir;
+  ASSIGN_OR_RETURN_UNWRAP(&dir, args.Holder());
+
+  BufferValue path(env->isolate(), args[0]);
+  ASSERT_PATH(path)
+  DirOperation(args, DirReqWrap::kOpen, dir->reader(),
+               std::string(*path, path.length()), 0, UTF8, args[1]);
+}
+
+
+// read(encoding, count[, req])
+void DirHandle::Read(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  DirHandle* dir;
+  ASSIGN_OR_RETURN_UNWRAP(&dir, args.Holder());
+
+  const enum encoding encoding = ParseEncoding(env->isolate(), args[0], UTF8);
+  CHECK(args[1]->IsUint32());
+  DirOperation(args, DirReqWrap::kRead, dir->reader(), std::string(),
+               args[1]->Uint32Value(), encoding, args[2]);
+}
+
+
+// close([req])
+void DirHandle::Close(const FunctionCallbackInfo<Value>& args) {
+  DirHandle* dir;
+  ASSIGN_OR_RETURN_UNWRAP(&dir, args.Holder());
+  DirOperation(args, DirReqWrap::kClose, dir->reader(), std::string(), 0,
+               UTF8, args[0]);
+}
+
+
+// readdirTypes(path, encoding[, req]) lists a directory's entries along with
+// their types.
+static void ReadDirTypes(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  BufferValue path(env->isolate(), args[0]);
+  ASSERT_PATH(path)
+
+  const enum encoding encoding = ParseEncoding(env->isolate(), args[1], UTF8);
+  DirOperation(args, DirReqWrap::kScan, nullptr,
+               std::string(*path, path.length()), 0, encoding, args[2]);
+}
+
+
 /* fs.chmod(path, mode);
  * Wrapper for chmod(1) / EIO_CHMOD
  */
@@ -1404,18 +2947,26 @@ void InitFs(Local<Object> target,
   env->SetMethod(target, "close", Close);
   env->SetMethod(target, "open", Open);
   env->SetMethod(target, "read", Read);
+  env->SetMethod(target, "readFile", ReadFile);
   env->SetMethod(target, "fdatasync", Fdatasync);
   env->SetMethod(target, "fsync", Fsync);
   env->SetMethod(target, "rename", Rename);
+  env->SetMethod(target, "copyFile", FSCopyFile);
   env->SetMethod(target, "ftruncate", FTruncate);
   env->SetMethod(target, "rmdir", RMDir);
   env->SetMethod(target, "mkdir", MKDir);
   env->SetMethod(target, "readdir", ReadDir);
+  env->SetMethod(target, "readdirTypes", ReadDirTypes);
   env->SetMethod(target, "internalModuleReadFile", InternalModuleReadFile);
   env->SetMethod(target, "internalModuleStat", InternalModuleStat);
+  env->SetMethod(target, "clearModuleResolutionCache",
+                 ClearModuleResolutionCache);
   env->SetMethod(target, "stat", Stat);
   env->SetMethod(target, "lstat", LStat);
   env->SetMethod(target, "fstat", FStat);
+  env->SetMethod(target, "mmap", MapFile);
+  env->SetMethod(target, "statBatch", StatBatchPaths);
+  env->SetMethod(target, "ioBatch", IOBatchOps);
   env->SetMethod(target, "link", Link);
   env->SetMethod(target, "symlink", Symlink);
   env->SetMethod(target, "readlink", ReadLink);
@@ -1442,6 +2993,37 @@ void InitFs(Local<Object> target,
 
   StatWatcher::Initialize(env, target);
 
+  NODE_DEFINE_CONSTANT(target, UV_DIRENT_UNKNOWN);
+  NODE_DEFINE_CONSTANT(target, UV_DIRENT_FILE);
+  NODE_DEFINE_CONSTANT(target, UV_DIRENT_DIR);
+  NODE_DEFINE_CONSTANT(target, UV_DIRENT_LINK);
+  NODE_DEFINE_CONSTANT(target, UV_DIRENT_FIFO);
+  NODE_DEFINE_CONSTANT(target, UV_DIRENT_SOCKET);
+  NODE_DEFINE_CONSTANT(target, UV_DIRENT_CHAR);
+  NODE_DEFINE_CONSTANT(target, UV_DIRENT_BLOCK);
+
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "kIOBatchRead"),
+              Integer::New(env->isolate(), IOBatch::kRead)).FromJust();
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "kIOBatchWrite"),
+              Integer::New(env->isolate(), IOBatch::kWrite)).FromJust();
+
+  NODE_DEFINE_CONSTANT(target, MMAP_ADVICE_NORMAL);
+  NODE_DEFINE_CONSTANT(target, MMAP_ADVICE_RANDOM);
+  NODE_DEFINE_CONSTANT(target, MMAP_ADVICE_SEQUENTIAL);
+  NODE_DEFINE_CONSTANT(target, MMAP_ADVICE_WILLNEED);
+
+  Local<FunctionTemplate> dir = env->NewFunctionTemplate(DirHandle::New);
+  dir->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(dir, "open", DirHandle::Open);
+  env->SetProtoMethod(dir, "read", DirHandle::Read);
+  env->SetProtoMethod(dir, "close", DirHandle::Close);
+  dir->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "DirHandle"));
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "DirHandle"),
+              dir->GetFunction(env->context()).ToLocalChecked()).FromJust();
+
   // Create FunctionTemplate for FSReqWrap
   Local<FunctionTemplate> fst =
       FunctionTemplate::New(env->isolate(), NewFSReqWrap);
@@ -1449,6 +3031,15 @@ void InitFs(Local<Object> target,
   fst->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "FSReqWrap"));
   target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "FSReqWrap"),
               fst->GetFunction());
+
+  Local<FunctionTemplate> fsp =
+      FunctionTemplate::New(env->isolate(), NewFSReqPromise);
+  fsp->InstanceTemplate()->SetInternalFieldCount(2);
+  fsp->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "FSReqPromise"));
+  env->SetProtoMethod(fsp, "resolve", FSReqPromiseResolve);
+  env->SetProtoMethod(fsp, "reject", FSReqPromiseReject);
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "FSReqPromise"),
+              fsp->GetFunction());
 }
 
 }  // end namespace node
@@ -0,0 +1,152 @@
+#include "node_histogram.h"
+#include "base-object-inl.h"
+#include "env-inl.h"
+#include "util.h"
+#include "util-inl.h"
+
+namespace node {
+
+using v8::ArrayBuffer;
+using v8::Context;
+using v8::Float64Array;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::Int32;
+using v8::Local;
+using v8::Number;
+using v8::Object;
+using v8::Value;
+
+HistogramWrap::HistogramWrap(Environment* env,
+                             Local<Object> object,
+                             Histogram* histogram,
+                             bool owned)
+    : BaseObject(env, object),
+      histogram_(histogram),
+      owned_(owned) {
+  MakeWeak<HistogramWrap>(this);
+  if (owned_)
+    env->isolate()->AdjustAmountOfExternalAllocatedMemory(Size());
+}
+
+
+HistogramWrap::~HistogramWrap() {
+  if (!owned_)
+    return;
+  env()->isolate()->AdjustAmountOfExternalAllocatedMemory(-Size());
+  delete histogram_;
+}
+
+
+int64_t HistogramWrap::Size() const {
+  return static_cast<int64_t>(histogram_->memory_size());
+}
+
+
+Local<Object> HistogramWrap::New(Environment* env, Histogram* histogram) {
+  Local<FunctionTemplate> constructor = env->histogram_constructor_template();
+  CHECK_EQ(false, constructor.IsEmpty());
+  Local<Object> object =
+      constructor->InstanceTemplate()->NewInstance(env->context())
+          .ToLocalChecked();
+  new HistogramWrap(env, object, histogram, false);
+  return object;
+}
+
+
+// new Histogram(highest, precision), both checked by the JS side.
+void HistogramWrap::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsNumber());
+  CHECK(args[1]->IsInt32());
+  const int64_t highest =
+      static_cast<int64_t>(args[0].As<Number>()->Value());
+  const int precision = args[1].As<Int32>()->Value();
+  new HistogramWrap(env, args.This(), new Histogram(highest, precision), true);
+}
+
+
+// Returns a Float64Array of the Histogram::Fields of the histogram.
+void HistogramWrap::GetFields(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  HistogramWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  const size_t count = Histogram::kFieldsCount;
+  Local<ArrayBuffer> ab = ArrayBuffer::New(env->isolate(),
+                                           wrap->histogram_->fields(),
+                                           sizeof(double) * count);
+  args.GetReturnValue().Set(Float64Array::New(ab, 0, count));
+}
+
+
+void HistogramWrap::Record(const FunctionCallbackInfo<Value>& args) {
+  HistogramWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  CHECK(args[0]->IsNumber());
+  Histogram* histogram = wrap->histogram_;
+  // Large enough numbers don't fit into an int64_t.
+  const double value = args[0].As<Number>()->Value();
+  histogram->Record(value < histogram->highest() ?
+                    static_cast<int64_t>(value) : histogram->highest());
+}
+
+
+void HistogramWrap::Percentile(const FunctionCallbackInfo<Value>& args) {
+  HistogramWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  CHECK(args[0]->IsNumber());
+  const int64_t value =
+      wrap->histogram_->Percentile(args[0].As<Number>()->Value());
+  args.GetReturnValue().Set(static_cast<double>(value));
+}
+
+
+void HistogramWrap::Stddev(const FunctionCallbackInfo<Value>& args) {
+  HistogramWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  args.GetReturnValue().Set(wrap->histogram_->Stddev());
+}
+
+
+void HistogramWrap::Merge(const FunctionCallbackInfo<Value>& args) {
+  HistogramWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  CHECK(args[0]->IsObject());
+  HistogramWrap* other;
+  ASSIGN_OR_RETURN_UNWRAP(&other, args[0].As<Object>());
+  wrap->histogram_->Merge(*other->histogram_);
+}
+
+
+void HistogramWrap::Reset(const FunctionCallbackInfo<Value>& args) {
+  HistogramWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  wrap->histogram_->Reset();
+}
+
+
+void HistogramWrap::Initialize(Local<Object> target,
+                               Local<Value> unused,
+                               Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  t->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "Histogram"));
+
+  env->SetProtoMethod(t, "getFields", GetFields);
+  env->SetProtoMethod(t, "record", Record);
+  env->SetProtoMethod(t, "percentile", Percentile);
+  env->SetProtoMethod(t, "stddev", Stddev);
+  env->SetProtoMethod(t, "merge", Merge);
+  env->SetProtoMethod(t, "reset", Reset);
+
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "Histogram"),
+              t->GetFunction(env->context()).ToLocalChecked()).FromJust();
+  env->set_histogram_constructor_template(t);
+}
+
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(histogram, node::HistogramWrap::Initialize)
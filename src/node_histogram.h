@@ -0,0 +1,49 @@
+#ifndef SRC_NODE_HISTOGRAM_H_
+#define SRC_NODE_HISTOGRAM_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "base-object.h"
+#include "env.h"
+#include "histogram.h"
+#include "v8.h"
+
+namespace node {
+
+// The native side of the Histogram class in lib/internal/histogram.js.
+class HistogramWrap : public BaseObject {
+ public:
+  static void Initialize(v8::Local<v8::Object> target,
+                         v8::Local<v8::Value> unused,
+                         v8::Local<v8::Context> context);
+
+  // Returns an object for a histogram that native code records into, which
+  // must outlive it. The histogram binding must have been loaded.
+  static v8::Local<v8::Object> New(Environment* env, Histogram* histogram);
+
+  ~HistogramWrap();
+
+ private:
+  HistogramWrap(Environment* env,
+                v8::Local<v8::Object> object,
+                Histogram* histogram,
+                bool owned);
+  int64_t Size() const;
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetFields(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Record(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Percentile(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Stddev(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Merge(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Reset(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  Histogram* const histogram_;
+  const bool owned_;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_HISTOGRAM_H_
@@ -0,0 +1,761 @@
+#include "node.h"
+#include "node_buffer.h"
+#include "node_http2_core.h"
+
+#include "async-wrap.h"
+#include "async-wrap-inl.h"
+#include "env.h"
+#include "env-inl.h"
+#include "stream_base.h"
+#include "stream_base-inl.h"
+#include "util.h"
+#include "util-inl.h"
+#include "uv.h"
+#include "v8.h"
+
+#include <string.h>
+
+namespace node {
+namespace http2 {
+
+using v8::Array;
+using v8::Boolean;
+using v8::Context;
+using v8::External;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::Number;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+class Http2Session;
+
+namespace {
+
+// Indexes of the callbacks on the JS object, which must all be set.
+const uint32_t kOnHeaders = 0;
+const uint32_t kOnData = 1;
+const uint32_t kOnStreamEnd = 2;
+const uint32_t kOnStreamClose = 3;
+const uint32_t kOnStreamDrain = 4;
+const uint32_t kOnSettings = 5;
+const uint32_t kOnPingAck = 6;
+const uint32_t kOnGoaway = 7;
+const uint32_t kOnError = 8;
+
+// The order of the settings in the arrays that are passed in and out.
+enum SettingsIndex {
+  kHeaderTableSize,
+  kEnablePush,
+  kMaxConcurrentStreams,
+  kInitialWindowSize,
+  kMaxFrameSize,
+  kMaxHeaderListSize,
+  kSettingsCount
+};
+
+// The layout of the array that getState() returns.
+enum StateIndex {
+  kStateSendWindow,
+  kStateReceiveWindow,
+  kStateStreamCount,
+  kStateLastPeerStreamId,
+  kStateWriteQueueSize,
+  kStateCount
+};
+
+const size_t kReadBufferSize = 64 * 1024;
+
+// Stored at the front of the extra storage of writes that could not be
+// completed right away.
+struct WriteHeader {
+  Http2Session* session;
+  size_t length;
+};
+
+const size_t kWriteHeaderSize =
+    ROUND_UP(sizeof(WriteHeader), WriteWrap::kAlignSize);
+
+inline WriteHeader* HeaderOf(WriteWrap* w) {
+  return reinterpret_cast<WriteHeader*>(w->Extra());
+}
+
+inline char* DataOf(WriteWrap* w) {
+  return w->Extra(kWriteHeaderSize);
+}
+
+// Header names and values are byte strings, like in the HTTP/1 parser.
+std::string ToByteString(Isolate* isolate, Local<Value> value) {
+  Local<String> string = value->ToString(isolate);
+  std::string result(string->Length(), '\0');
+  if (!result.empty()) {
+    string->WriteOneByte(reinterpret_cast<uint8_t*>(&result[0]),
+                         0,
+                         result.size(),
+                         String::NO_NULL_TERMINATION);
+  }
+  return result;
+}
+
+// |value| is a flat array of names and values.
+Headers ToHeaders(Isolate* isolate, Local<Value> value) {
+  Headers headers;
+  CHECK(value->IsArray());
+  Local<Array> array = value.As<Array>();
+  const uint32_t length = array->Length();
+  headers.reserve(length / 2);
+  for (uint32_t i = 0; i + 1 < length; i += 2) {
+    headers.push_back(Header(ToByteString(isolate, array->Get(i)),
+                             ToByteString(isolate, array->Get(i + 1))));
+  }
+  return headers;
+}
+
+Local<Array> FromHeaders(Isolate* isolate, const Headers& headers) {
+  Local<Array> array = Array::New(isolate, headers.size() * 2);
+  uint32_t index = 0;
+  for (const Header& header : headers) {
+    array->Set(index++, OneByteString(isolate,
+                                      header.name.data(),
+                                      header.name.size()));
+    array->Set(index++, OneByteString(isolate,
+                                      header.value.data(),
+                                      header.value.size()));
+  }
+  return array;
+}
+
+// Settings that JS leaves undefined keep their protocol defaults.
+Settings ToSettings(Local<Value> value) {
+  Settings settings;
+  CHECK(value->IsArray());
+  Local<Array> array = value.As<Array>();
+  uint32_t* const fields[] = {
+    &settings.header_table_size,
+    &settings.enable_push,
+    &settings.max_concurrent_streams,
+    &settings.initial_window_size,
+    &settings.max_frame_size,
+    &settings.max_header_list_size
+  };
+  for (uint32_t i = 0; i < kSettingsCount && i < array->Length(); i++) {
+    Local<Value> field = array->Get(i);
+    if (field->IsUint32())
+      *fields[i] = field->Uint32Value();
+  }
+  return settings;
+}
+
+Local<Array> FromSettings(Isolate* isolate, const Settings& settings) {
+  Local<Array> array = Array::New(isolate, kSettingsCount);
+  array->Set(kHeaderTableSize,
+             Integer::NewFromUnsigned(isolate, settings.header_table_size));
+  array->Set(kEnablePush,
+             Integer::NewFromUnsigned(isolate, settings.enable_push));
+  array->Set(kMaxConcurrentStreams,
+             Integer::NewFromUnsigned(isolate,
+                                      settings.max_concurrent_streams));
+  array->Set(kInitialWindowSize,
+             Integer::NewFromUnsigned(isolate, settings.initial_window_size));
+  array->Set(kMaxFrameSize,
+             Integer::NewFromUnsigned(isolate, settings.max_frame_size));
+  array->Set(kMaxHeaderListSize,
+             Integer::NewFromUnsigned(isolate,
+                                      settings.max_header_list_size));
+  return array;
+}
+
+}  // anonymous namespace
+
+
+// Runs a Session on top of a StreamBase, which can be a TCP socket or a
+// TLSWrap. Data is read from the stream and frames are written to it
+// natively; JS only hears about headers, data and the other events, through
+// the callbacks at the indexes above.
+//
+// Frames are written as soon as they are ready, except that DATA frames are
+// held back while more than kHighWaterMark bytes have not made it into the
+// kernel yet. Flow control on the peer's side then does the rest.
+class Http2Session : public AsyncWrap {
+ public:
+  Http2Session(Environment* env,
+               Local<Object> wrap,
+               Session::Type type,
+               const Settings& settings)
+      : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_HTTP2SESSION),
+        session_(type, settings),
+        stream_(nullptr),
+        queued_bytes_(0),
+        queued_writes_(0),
+        processing_(false),
+        destroyed_(false),
+        released_(false) {
+    Wrap(object(), this);
+  }
+
+  ~Http2Session() override {
+    CHECK(released_);
+    ClearWrap(object());
+    persistent().Reset();
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+  static void Initialize(Local<Object> target,
+                         Local<Value> unused,
+                         Local<Context> context);
+
+ private:
+  static const size_t kHighWaterMark = 64 * 1024;
+
+  static void New(const FunctionCallbackInfo<Value>& args);
+  static void Consume(const FunctionCallbackInfo<Value>& args);
+  static void Destroy(const FunctionCallbackInfo<Value>& args);
+  static void Request(const FunctionCallbackInfo<Value>& args);
+  static void Respond(const FunctionCallbackInfo<Value>& args);
+  static void Write(const FunctionCallbackInfo<Value>& args);
+  static void End(const FunctionCallbackInfo<Value>& args);
+  static void RstStream(const FunctionCallbackInfo<Value>& args);
+  static void ConsumeData(const FunctionCallbackInfo<Value>& args);
+  static void Ping(const FunctionCallbackInfo<Value>& args);
+  static void SubmitSettings(const FunctionCallbackInfo<Value>& args);
+  static void Goaway(const FunctionCallbackInfo<Value>& args);
+  static void GetLocalSettings(const FunctionCallbackInfo<Value>& args);
+  static void GetRemoteSettings(const FunctionCallbackInfo<Value>& args);
+  static void GetState(const FunctionCallbackInfo<Value>& args);
+
+  // Dispatches the session's events to JS and writes what is ready, until
+  // neither produces anything new. Calls from within a callback leave the
+  // work to the outermost call.
+  void Process();
+  void Dispatch(Event* event);
+  void Flush();
+  void Unconsume();
+  void MaybeRelease();
+
+  static void OnAllocImpl(size_t size, uv_buf_t* buf, void* ctx);
+  static void OnReadImpl(ssize_t nread,
+                         const uv_buf_t* buf,
+                         uv_handle_type pending,
+                         void* ctx);
+  static void OnStreamDestruct(void* ctx);
+  static void AfterWrite(WriteWrap* w, int status);
+
+  Session session_;
+  StreamBase* stream_;
+  StreamResource::Callback<StreamResource::AllocCb> prev_alloc_cb_;
+  StreamResource::Callback<StreamResource::ReadCb> prev_read_cb_;
+  StreamResource::Callback<StreamResource::DestructCb> prev_destruct_cb_;
+  size_t queued_bytes_;
+  size_t queued_writes_;
+  bool processing_;
+  bool destroyed_;
+  bool released_;
+};
+
+
+void Http2Session::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsInt32());
+  const Session::Type type = args[0]->Int32Value() == Session::kServer ?
+      Session::kServer : Session::kClient;
+  new Http2Session(env, args.This(), type, ToSettings(args[1]));
+}
+
+
+void Http2Session::Consume(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  CHECK(args[0]->IsExternal());
+  CHECK_EQ(session->stream_, nullptr);
+  CHECK(!session->destroyed_);
+
+  StreamBase* stream =
+      static_cast<StreamBase*>(args[0].As<External>()->Value());
+  CHECK_NE(stream, nullptr);
+  if (stream->IsConsumed())
+    return args.GetReturnValue().Set(false);
+  stream->Consume();
+
+  session->stream_ = stream;
+  session->prev_alloc_cb_ = stream->alloc_cb();
+  session->prev_read_cb_ = stream->read_cb();
+  session->prev_destruct_cb_ = stream->destruct_cb();
+  stream->set_alloc_cb({ OnAllocImpl, session });
+  stream->set_read_cb({ OnReadImpl, session });
+  stream->set_destruct_cb({ OnStreamDestruct, session });
+  stream->ReadStart();
+
+  // Sends the preface.
+  session->Process();
+  args.GetReturnValue().Set(true);
+}
+
+
+void Http2Session::Destroy(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  if (session->destroyed_)
+    return;
+  // What is ready goes out, like the GOAWAY of a session that is closing.
+  session->Flush();
+  session->destroyed_ = true;
+  session->Unconsume();
+  session->MaybeRelease();
+}
+
+
+void Http2Session::Request(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  if (session->destroyed_)
+    return args.GetReturnValue().Set(-1);
+  const int32_t id =
+      session->session_.SubmitRequest(ToHeaders(args.GetIsolate(), args[0]),
+                                      args[1]->IsTrue());
+  session->Process();
+  args.GetReturnValue().Set(id);
+}
+
+
+void Http2Session::Respond(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  CHECK(args[0]->IsInt32());
+  if (session->destroyed_)
+    return args.GetReturnValue().Set(false);
+  const bool ok =
+      session->session_.SubmitResponse(args[0]->Int32Value(),
+                                       ToHeaders(args.GetIsolate(), args[1]),
+                                       args[2]->IsTrue());
+  session->Process();
+  args.GetReturnValue().Set(ok);
+}
+
+
+// Returns how much of the stream's data is still queued afterwards, or -1
+// if the stream cannot take data.
+void Http2Session::Write(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  CHECK(args[0]->IsInt32());
+  THROW_AND_RETURN_UNLESS_BUFFER(session->env(), args[1]);
+  if (session->destroyed_)
+    return args.GetReturnValue().Set(-1);
+  const int32_t id = args[0]->Int32Value();
+  SPREAD_BUFFER_ARG(args[1], data);
+  if (!session->session_.SubmitData(id, data_data, data_length))
+    return args.GetReturnValue().Set(-1);
+  session->Process();
+  args.GetReturnValue().Set(
+      static_cast<double>(session->session_.QueuedData(id)));
+}
+
+
+void Http2Session::End(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  CHECK(args[0]->IsInt32());
+  if (session->destroyed_)
+    return args.GetReturnValue().Set(false);
+  Headers trailers;
+  if (args[1]->IsArray())
+    trailers = ToHeaders(args.GetIsolate(), args[1]);
+  const bool ok = session->session_.SubmitEnd(args[0]->Int32Value(),
+                                              &trailers);
+  session->Process();
+  args.GetReturnValue().Set(ok);
+}
+
+
+void Http2Session::RstStream(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsUint32());
+  if (session->destroyed_)
+    return;
+  session->session_.SubmitRstStream(args[0]->Int32Value(),
+                                    args[1]->Uint32Value());
+  session->Process();
+}
+
+
+void Http2Session::ConsumeData(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsUint32());
+  if (session->destroyed_)
+    return;
+  session->session_.ConsumeData(args[0]->Int32Value(),
+                                args[1]->Uint32Value());
+  session->Process();
+}
+
+
+void Http2Session::Ping(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  THROW_AND_RETURN_UNLESS_BUFFER(session->env(), args[0]);
+  SPREAD_BUFFER_ARG(args[0], payload);
+  CHECK_EQ(payload_length, 8u);
+  if (session->destroyed_)
+    return;
+  session->session_.SubmitPing(reinterpret_cast<uint8_t*>(payload_data));
+  session->Process();
+}
+
+
+void Http2Session::SubmitSettings(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  if (session->destroyed_)
+    return;
+  session->session_.SubmitSettings(ToSettings(args[0]));
+  session->Process();
+}
+
+
+void Http2Session::Goaway(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  CHECK(args[0]->IsUint32());
+  if (session->destroyed_)
+    return;
+  session->session_.SubmitGoaway(args[0]->Uint32Value());
+  session->Process();
+}
+
+
+void Http2Session::GetLocalSettings(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  args.GetReturnValue().Set(
+      FromSettings(args.GetIsolate(), session->session_.local_settings()));
+}
+
+
+void Http2Session::GetRemoteSettings(
+    const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  args.GetReturnValue().Set(
+      FromSettings(args.GetIsolate(), session->session_.remote_settings()));
+}
+
+
+void Http2Session::GetState(const FunctionCallbackInfo<Value>& args) {
+  Http2Session* session;
+  ASSIGN_OR_RETURN_UNWRAP(&session, args.Holder());
+  Isolate* isolate = args.GetIsolate();
+  const Session& s = session->session_;
+  Local<Array> state = Array::New(isolate, kStateCount);
+  state->Set(kStateSendWindow,
+             Number::New(isolate, static_cast<double>(s.send_window())));
+  state->Set(kStateReceiveWindow,
+             Number::New(isolate, static_cast<double>(s.receive_window())));
+  state->Set(kStateStreamCount,
+             Number::New(isolate, static_cast<double>(s.stream_count())));
+  state->Set(kStateLastPeerStreamId,
+             Integer::New(isolate, s.last_peer_stream_id()));
+  state->Set(kStateWriteQueueSize,
+             Number::New(isolate,
+                         static_cast<double>(session->queued_bytes_)));
+  args.GetReturnValue().Set(state);
+}
+
+
+void Http2Session::Process() {
+  if (processing_ || destroyed_)
+    return;
+  processing_ = true;
+  HandleScope scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+  // Keeps the object alive if a callback destroys the session.
+  Local<Object> obj = object();
+
+  Event event;
+  do {
+    while (!destroyed_ && session_.NextEvent(&event))
+      Dispatch(&event);
+    if (destroyed_)
+      break;
+    Flush();
+  } while (session_.has_events());
+
+  static_cast<void>(obj);
+  processing_ = false;
+}
+
+
+void Http2Session::Dispatch(Event* event) {
+  Isolate* isolate = env()->isolate();
+  HandleScope scope(isolate);
+  Local<Value> id = Integer::New(isolate, event->stream_id);
+  Local<Value> code = Integer::NewFromUnsigned(isolate, event->code);
+
+  switch (event->type) {
+    case Event::kHeaders: {
+      Local<Value> argv[] = {
+        id,
+        Integer::New(isolate, event->category),
+        FromHeaders(isolate, event->headers),
+        Boolean::New(isolate, event->end_stream)
+      };
+      MakeCallback(kOnHeaders, arraysize(argv), argv);
+      break;
+    }
+    case Event::kData: {
+      Local<Value> argv[] = {
+        id,
+        Buffer::Copy(env(), event->data.data(), event->data.size())
+            .ToLocalChecked()
+      };
+      MakeCallback(kOnData, arraysize(argv), argv);
+      break;
+    }
+    case Event::kStreamEnd:
+      MakeCallback(kOnStreamEnd, 1, &id);
+      break;
+    case Event::kStreamClose: {
+      Local<Value> argv[] = { id, code };
+      MakeCallback(kOnStreamClose, arraysize(argv), argv);
+      break;
+    }
+    case Event::kStreamDrain:
+      MakeCallback(kOnStreamDrain, 1, &id);
+      break;
+    case Event::kSettings:
+    case Event::kSettingsAck: {
+      Local<Value> ack = Boolean::New(isolate,
+                                      event->type == Event::kSettingsAck);
+      MakeCallback(kOnSettings, 1, &ack);
+      break;
+    }
+    case Event::kPingAck: {
+      Local<Value> payload =
+          Buffer::Copy(env(), event->data.data(), event->data.size())
+              .ToLocalChecked();
+      MakeCallback(kOnPingAck, 1, &payload);
+      break;
+    }
+    case Event::kGoaway: {
+      Local<Value> argv[] = {
+        code,
+        id,
+        Buffer::Copy(env(), event->data.data(), event->data.size())
+            .ToLocalChecked()
+      };
+      MakeCallback(kOnGoaway, arraysize(argv), argv);
+      break;
+    }
+    case Event::kError:
+      // The GOAWAY goes out before JS gets to close the socket.
+      Flush();
+      MakeCallback(kOnError, 1, &code);
+      break;
+  }
+}
+
+
+void Http2Session::Flush() {
+  if (stream_ == nullptr)
+    return;
+
+  const size_t max_data =
+      queued_bytes_ < kHighWaterMark ? kHighWaterMark - queued_bytes_ : 0;
+  std::string out;
+  session_.Send(max_data, &out);
+  if (out.empty())
+    return;
+
+  // Most of the time everything fits into the kernel's buffer, and only
+  // what does not is copied into a write request.
+  uv_buf_t buf = uv_buf_init(&out[0], out.size());
+  uv_buf_t* bufs = &buf;
+  size_t count = 1;
+  int err = stream_->DoTryWrite(&bufs, &count);
+  if (err == 0 && count == 0)
+    return;
+
+  if (err == 0) {
+    const size_t length = bufs[0].len;
+    Local<Object> req_wrap_obj =
+        env()->write_wrap_constructor_function()
+            ->NewInstance(env()->context()).ToLocalChecked();
+    WriteWrap* w = WriteWrap::New(env(),
+                                  req_wrap_obj,
+                                  stream_,
+                                  AfterWrite,
+                                  kWriteHeaderSize + length);
+    HeaderOf(w)->session = this;
+    HeaderOf(w)->length = length;
+    memcpy(DataOf(w), bufs[0].base, length);
+    uv_buf_t rest = uv_buf_init(DataOf(w), length);
+    err = stream_->DoWrite(w, &rest, 1, nullptr);
+    if (err == 0) {
+      queued_bytes_ += length;
+      queued_writes_++;
+      return;
+    }
+    w->Dispatched();
+    w->Dispose();
+  }
+
+  // The socket reports the error to JS itself; there is nothing left to
+  // send to.
+  Unconsume();
+}
+
+
+void Http2Session::Unconsume() {
+  if (stream_ == nullptr)
+    return;
+  stream_->set_alloc_cb(prev_alloc_cb_);
+  stream_->set_read_cb(prev_read_cb_);
+  stream_->set_destruct_cb(prev_destruct_cb_);
+  stream_ = nullptr;
+}
+
+
+void Http2Session::MaybeRelease() {
+  if (!destroyed_ || queued_writes_ > 0 || released_)
+    return;
+  released_ = true;
+  MakeWeak<Http2Session>(this);
+}
+
+
+void Http2Session::OnAllocImpl(size_t size, uv_buf_t* buf, void* ctx) {
+  Http2Session* session = static_cast<Http2Session*>(ctx);
+  Environment* env = session->env();
+
+  // Reads are processed right away, so all sessions share one buffer.
+  if (env->http2_read_buffer() == nullptr)
+    env->set_http2_read_buffer(new char[kReadBufferSize]);
+
+  buf->base = env->http2_read_buffer();
+  buf->len = kReadBufferSize;
+}
+
+
+void Http2Session::OnReadImpl(ssize_t nread,
+                              const uv_buf_t* buf,
+                              uv_handle_type pending,
+                              void* ctx) {
+  Http2Session* session = static_cast<Http2Session*>(ctx);
+
+  // The end of the stream and errors are for the socket to handle.
+  if (nread < 0) {
+    uv_buf_t tmp_buf = uv_buf_init(nullptr, 0);
+    session->prev_read_cb_.fn(nread,
+                              &tmp_buf,
+                              pending,
+                              session->prev_read_cb_.ctx);
+    return;
+  }
+  if (nread == 0 || session->destroyed_)
+    return;
+
+  session->session_.Receive(reinterpret_cast<const uint8_t*>(buf->base),
+                            nread);
+  session->Process();
+}
+
+
+void Http2Session::OnStreamDestruct(void* ctx) {
+  Http2Session* session = static_cast<Http2Session*>(ctx);
+  if (!session->prev_destruct_cb_.is_empty())
+    session->prev_destruct_cb_.fn(session->prev_destruct_cb_.ctx);
+  // The stream is being torn down; leave its callbacks alone.
+  session->stream_ = nullptr;
+}
+
+
+void Http2Session::AfterWrite(WriteWrap* w, int status) {
+  Http2Session* session = HeaderOf(w)->session;
+  const size_t length = HeaderOf(w)->length;
+
+  if (session->stream_ != nullptr)
+    session->stream_->OnAfterWrite(w);
+  w->Dispose();
+
+  CHECK_GT(session->queued_writes_, 0);
+  session->queued_writes_--;
+  session->queued_bytes_ -= length;
+
+  if (status < 0)
+    session->Unconsume();
+  else
+    session->Process();
+  session->MaybeRelease();
+}
+
+
+void Http2Session::Initialize(Local<Object> target,
+                              Local<Value> unused,
+                              Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  Isolate* isolate = env->isolate();
+
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+  t->SetClassName(FIXED_ONE_BYTE_STRING(isolate, "Http2Session"));
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+
+#define V(name, value)                                                        \
+  t->Set(FIXED_ONE_BYTE_STRING(isolate, #name), Integer::New(isolate, value));
+  V(kOnHeaders, kOnHeaders)
+  V(kOnData, kOnData)
+  V(kOnStreamEnd, kOnStreamEnd)
+  V(kOnStreamClose, kOnStreamClose)
+  V(kOnStreamDrain, kOnStreamDrain)
+  V(kOnSettings, kOnSettings)
+  V(kOnPingAck, kOnPingAck)
+  V(kOnGoaway, kOnGoaway)
+  V(kOnError, kOnError)
+  V(SERVER, Session::kServer)
+  V(CLIENT, Session::kClient)
+  V(HEADERS_REQUEST, kHeadersRequest)
+  V(HEADERS_RESPONSE, kHeadersResponse)
+  V(HEADERS_INFORMATIONAL, kHeadersInformational)
+  V(HEADERS_TRAILERS, kHeadersTrailers)
+#undef V
+
+  env->SetProtoMethod(t, "consume", Consume);
+  env->SetProtoMethod(t, "destroy", Destroy);
+  env->SetProtoMethod(t, "request", Request);
+  env->SetProtoMethod(t, "respond", Respond);
+  env->SetProtoMethod(t, "write", Write);
+  env->SetProtoMethod(t, "end", End);
+  env->SetProtoMethod(t, "rstStream", RstStream);
+  env->SetProtoMethod(t, "consumeData", ConsumeData);
+  env->SetProtoMethod(t, "ping", Ping);
+  env->SetProtoMethod(t, "settings", SubmitSettings);
+  env->SetProtoMethod(t, "goaway", Goaway);
+  env->SetProtoMethod(t, "getLocalSettings", GetLocalSettings);
+  env->SetProtoMethod(t, "getRemoteSettings", GetRemoteSettings);
+  env->SetProtoMethod(t, "getState", GetState);
+
+  target->Set(FIXED_ONE_BYTE_STRING(isolate, "Http2Session"),
+              t->GetFunction());
+
+  Local<Object> codes = Object::New(isolate);
+#define V(name, value)                                                        \
+  codes->Set(FIXED_ONE_BYTE_STRING(isolate, #name),                           \
+             Integer::New(isolate, value));
+  HTTP2_ERROR_CODES(V)
+#undef V
+  target->Set(FIXED_ONE_BYTE_STRING(isolate, "errorCodes"), codes);
+}
+
+}  // namespace http2
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(http2, node::http2::Http2Session::Initialize)
@@ -0,0 +1,1031 @@
+#include "node_http2_core.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <set>
+
+namespace node {
+namespace http2 {
+
+const char kClientPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+namespace {
+
+enum SettingsId {
+  kSettingsHeaderTableSize = 0x1,
+  kSettingsEnablePush = 0x2,
+  kSettingsMaxConcurrentStreams = 0x3,
+  kSettingsInitialWindowSize = 0x4,
+  kSettingsMaxFrameSize = 0x5,
+  kSettingsMaxHeaderListSize = 0x6
+};
+
+// Header blocks are buffered until they are complete. A peer that sends more
+// than this is not sending headers a server or client could do anything with.
+const size_t kMaxHeaderBlockLength = 1024 * 1024;
+
+inline uint32_t ReadUint32(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) |
+         (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) |
+         static_cast<uint32_t>(p[3]);
+}
+
+inline void WriteUint32(uint32_t value, std::string* out) {
+  out->push_back(static_cast<char>(value >> 24));
+  out->push_back(static_cast<char>(value >> 16));
+  out->push_back(static_cast<char>(value >> 8));
+  out->push_back(static_cast<char>(value));
+}
+
+inline void WriteFrameHeader(size_t length, uint8_t type, uint8_t flags,
+                             int32_t id, std::string* out) {
+  out->push_back(static_cast<char>(length >> 16));
+  out->push_back(static_cast<char>(length >> 8));
+  out->push_back(static_cast<char>(length));
+  out->push_back(static_cast<char>(type));
+  out->push_back(static_cast<char>(flags));
+  WriteUint32(static_cast<uint32_t>(id), out);
+}
+
+inline void WriteSetting(uint16_t id, uint32_t value, std::string* out) {
+  out->push_back(static_cast<char>(id >> 8));
+  out->push_back(static_cast<char>(id));
+  WriteUint32(value, out);
+}
+
+// Connection-specific headers have no meaning in HTTP/2 (RFC 7540, 8.1.2.2).
+const char* const kConnectionHeaders[] = {
+  "connection",
+  "keep-alive",
+  "proxy-connection",
+  "transfer-encoding",
+  "upgrade"
+};
+
+}  // anonymous namespace
+
+
+Session::Session(Type type, const Settings& settings)
+    : type_(type),
+      local_stream_count_(0),
+      peer_stream_count_(0),
+      next_stream_id_(type == kClient ? 1 : 2),
+      last_peer_stream_id_(0),
+      last_sent_id_(0),
+      send_window_(kDefaultWindowSize),
+      recv_window_(kDefaultWindowSize),
+      unacked_(0),
+      stream_window_(kDefaultWindowSize),
+      max_frame_size_(kMinFrameSize),
+      preface_remaining_(type == kServer ? kClientPrefaceLength : 0),
+      settings_received_(false),
+      header_block_id_(0),
+      header_block_end_stream_(false),
+      continuation_id_(0),
+      failed_(false),
+      goaway_received_(false),
+      goaway_sent_(false) {
+  if (type == kClient)
+    output_.append(kClientPreface, kClientPrefaceLength);
+  SubmitSettings(settings);
+}
+
+
+bool Session::Receive(const uint8_t* data, size_t length) {
+  if (failed_)
+    return false;
+
+  if (preface_remaining_ > 0) {
+    const size_t offset = kClientPrefaceLength - preface_remaining_;
+    const size_t n = std::min(length, preface_remaining_);
+    if (memcmp(data, kClientPreface + offset, n) != 0) {
+      ConnectionError(kPROTOCOL_ERROR);
+      return false;
+    }
+    preface_remaining_ -= n;
+    data += n;
+    length -= n;
+  }
+
+  // Most reads end on a frame boundary, so their data is processed where it
+  // is, and only a partial frame at the end is kept for the next read.
+  if (input_.empty()) {
+    const size_t consumed = ProcessFrames(data, length);
+    if (!failed_)
+      input_.assign(reinterpret_cast<const char*>(data) + consumed,
+                    length - consumed);
+  } else {
+    input_.append(reinterpret_cast<const char*>(data), length);
+    const size_t consumed =
+        ProcessFrames(reinterpret_cast<const uint8_t*>(input_.data()),
+                      input_.size());
+    if (!failed_)
+      input_.erase(0, consumed);
+  }
+
+  if (failed_)
+    input_.clear();
+  return !failed_;
+}
+
+
+size_t Session::ProcessFrames(const uint8_t* data, size_t length) {
+  size_t offset = 0;
+  while (!failed_ && length - offset >= kFrameHeaderLength) {
+    const uint8_t* p = data + offset;
+    const size_t frame_length = (static_cast<size_t>(p[0]) << 16) |
+                                (static_cast<size_t>(p[1]) << 8) |
+                                static_cast<size_t>(p[2]);
+    if (frame_length > max_frame_size_) {
+      ConnectionError(kFRAME_SIZE_ERROR);
+      break;
+    }
+    if (length - offset - kFrameHeaderLength < frame_length)
+      break;
+    const int32_t id = static_cast<int32_t>(ReadUint32(p + 5) & kMaxStreamId);
+    ProcessFrame(p[3], p[4], id, p + kFrameHeaderLength, frame_length);
+    offset += kFrameHeaderLength + frame_length;
+  }
+  return offset;
+}
+
+
+void Session::ProcessFrame(uint8_t type, uint8_t flags, int32_t id,
+                           const uint8_t* payload, size_t length) {
+  // The peer's part of the connection preface is a SETTINGS frame.
+  if (!settings_received_ &&
+      (type != kFrameSettings || (flags & kFlagAck) != 0)) {
+    return ConnectionError(kPROTOCOL_ERROR);
+  }
+  // Nothing may come between the frames of a header block.
+  if (continuation_id_ != 0 && type != kFrameContinuation)
+    return ConnectionError(kPROTOCOL_ERROR);
+
+  switch (type) {
+    case kFrameData:
+      return OnData(flags, id, payload, length);
+    case kFrameHeaders:
+      return OnHeaders(flags, id, payload, length);
+    case kFramePriority:
+      return OnPriority(id, length);
+    case kFrameRstStream:
+      return OnRstStream(id, payload, length);
+    case kFrameSettings:
+      return OnSettings(flags, id, payload, length);
+    case kFramePushPromise:
+      // We never allow push, so servers must not send these, and clients
+      // cannot send them at all.
+      return ConnectionError(kPROTOCOL_ERROR);
+    case kFramePing:
+      return OnPing(flags, id, payload, length);
+    case kFrameGoaway:
+      return OnGoaway(id, payload, length);
+    case kFrameWindowUpdate:
+      return OnWindowUpdate(id, payload, length);
+    case kFrameContinuation:
+      return OnContinuation(flags, id, payload, length);
+    default:
+      // Frames of unknown types are ignored (RFC 7540, 4.1).
+      return;
+  }
+}
+
+
+bool Session::RemovePadding(uint8_t flags, const uint8_t** payload,
+                            size_t* length) {
+  if ((flags & kFlagPadded) == 0)
+    return true;
+  if (*length < 1) {
+    ConnectionError(kFRAME_SIZE_ERROR);
+    return false;
+  }
+  const size_t padding = **payload;
+  *payload += 1;
+  *length -= 1;
+  if (padding > *length) {
+    ConnectionError(kPROTOCOL_ERROR);
+    return false;
+  }
+  *length -= padding;
+  return true;
+}
+
+
+void Session::OnData(uint8_t flags, int32_t id, const uint8_t* payload,
+                     size_t length) {
+  if (id == 0)
+    return ConnectionError(kPROTOCOL_ERROR);
+
+  // Padding counts against the windows as well.
+  const size_t frame_length = length;
+  if (static_cast<int64_t>(frame_length) > recv_window_)
+    return ConnectionError(kFLOW_CONTROL_ERROR);
+  recv_window_ -= frame_length;
+  if (!RemovePadding(flags, &payload, &length))
+    return;
+
+  Stream* stream = FindStream(id);
+  if (stream == nullptr || stream->remote_closed ||
+      !stream->headers_received) {
+    if (stream == nullptr && IsIdle(id))
+      return ConnectionError(kPROTOCOL_ERROR);
+    // The data is dropped, but the connection's window still has to be
+    // given back.
+    ConsumeData(0, frame_length);
+    if (stream != nullptr && !stream->headers_received)
+      return ResetStream(id, kPROTOCOL_ERROR);
+    return ResetStream(id, kSTREAM_CLOSED);
+  }
+
+  if (static_cast<int64_t>(frame_length) > stream->recv_window) {
+    ConsumeData(0, frame_length);
+    return ResetStream(id, kFLOW_CONTROL_ERROR);
+  }
+  stream->recv_window -= frame_length;
+
+  if (frame_length > length)
+    ConsumeData(id, frame_length - length);
+
+  if (length > 0) {
+    events_.push_back(Event());
+    Event& event = events_.back();
+    event.type = Event::kData;
+    event.stream_id = id;
+    event.data.assign(reinterpret_cast<const char*>(payload), length);
+  }
+
+  if ((flags & kFlagEndStream) != 0) {
+    stream->remote_closed = true;
+    Emit(Event::kStreamEnd, id);
+    MaybeCloseStream(id);
+  }
+}
+
+
+void Session::OnHeaders(uint8_t flags, int32_t id, const uint8_t* payload,
+                        size_t length) {
+  if (id == 0)
+    return ConnectionError(kPROTOCOL_ERROR);
+  if (!RemovePadding(flags, &payload, &length))
+    return;
+  if ((flags & kFlagPriority) != 0) {
+    if (length < 5)
+      return ConnectionError(kFRAME_SIZE_ERROR);
+    payload += 5;
+    length -= 5;
+  }
+
+  header_block_.assign(reinterpret_cast<const char*>(payload), length);
+  header_block_id_ = id;
+  header_block_end_stream_ = (flags & kFlagEndStream) != 0;
+  if ((flags & kFlagEndHeaders) != 0)
+    OnHeaderBlock();
+  else
+    continuation_id_ = id;
+}
+
+
+void Session::OnContinuation(uint8_t flags, int32_t id,
+                             const uint8_t* payload, size_t length) {
+  if (continuation_id_ == 0 || id != continuation_id_)
+    return ConnectionError(kPROTOCOL_ERROR);
+  if (header_block_.size() + length > kMaxHeaderBlockLength)
+    return ConnectionError(kENHANCE_YOUR_CALM);
+
+  header_block_.append(reinterpret_cast<const char*>(payload), length);
+  if ((flags & kFlagEndHeaders) != 0) {
+    continuation_id_ = 0;
+    OnHeaderBlock();
+  }
+}
+
+
+void Session::OnHeaderBlock() {
+  const int32_t id = header_block_id_;
+  const bool end_stream = header_block_end_stream_;
+
+  events_.push_back(Event());
+  Event& event = events_.back();
+  bool too_large;
+  // The block is decoded even if the stream is going to be refused, because
+  // the peer's encoder has already counted it.
+  const bool decoded =
+      decoder_.Decode(reinterpret_cast<const uint8_t*>(header_block_.data()),
+                      header_block_.size(),
+                      local_.max_header_list_size,
+                      &event.headers,
+                      &too_large);
+  header_block_.clear();
+  if (!decoded) {
+    events_.pop_back();
+    return ConnectionError(kCOMPRESSION_ERROR);
+  }
+
+  event.type = Event::kHeaders;
+  event.stream_id = id;
+  event.end_stream = end_stream;
+
+  Stream* stream = FindStream(id);
+  if (stream == nullptr) {
+    // Streams that we opened and that are gone already can still see
+    // frames that were in flight.
+    if (IsLocalId(id)) {
+      events_.pop_back();
+      if (IsIdle(id))
+        return ConnectionError(kPROTOCOL_ERROR);
+      return;
+    }
+    // Without push, servers never open streams.
+    if (type_ == kClient) {
+      events_.pop_back();
+      return ConnectionError(kPROTOCOL_ERROR);
+    }
+    if (id <= last_peer_stream_id_) {
+      events_.pop_back();
+      return ResetStream(id, kSTREAM_CLOSED);
+    }
+    last_peer_stream_id_ = id;
+
+    // Streams that the peer opens after our GOAWAY are ignored (RFC 7540,
+    // 6.8).
+    if (goaway_sent_) {
+      events_.pop_back();
+      return;
+    }
+    uint32_t code = kNO_ERROR;
+    if (too_large)
+      code = kENHANCE_YOUR_CALM;
+    else if (peer_stream_count_ >= local_.max_concurrent_streams)
+      code = kREFUSED_STREAM;
+    else if (!ValidateHeaders(event.headers, kHeadersRequest))
+      code = kPROTOCOL_ERROR;
+    if (code != kNO_ERROR) {
+      events_.pop_back();
+      return ResetStream(id, code);
+    }
+
+    stream = CreateStream(id);
+    stream->headers_received = true;
+    event.category = kHeadersRequest;
+  } else {
+    HeadersCategory category = kHeadersTrailers;
+    if (!stream->headers_received) {
+      const Header* status = nullptr;
+      if (!event.headers.empty() && event.headers[0].name == ":status")
+        status = &event.headers[0];
+      if (status != nullptr && status->value.size() == 3 &&
+          status->value[0] == '1') {
+        category = kHeadersInformational;
+      } else {
+        category = kHeadersResponse;
+      }
+    }
+
+    uint32_t code = kNO_ERROR;
+    if (stream->remote_closed)
+      code = kSTREAM_CLOSED;
+    else if (too_large)
+      code = kENHANCE_YOUR_CALM;
+    else if (!ValidateHeaders(event.headers, category))
+      code = kPROTOCOL_ERROR;
+    // Trailers end the stream, and informational responses cannot.
+    else if ((category == kHeadersTrailers) != end_stream &&
+             category != kHeadersResponse)
+      code = kPROTOCOL_ERROR;
+    if (code != kNO_ERROR) {
+      events_.pop_back();
+      return ResetStream(id, code);
+    }
+
+    if (category == kHeadersResponse)
+      stream->headers_received = true;
+    event.category = category;
+  }
+
+  if (end_stream) {
+    stream->remote_closed = true;
+    Emit(Event::kStreamEnd, id);
+    MaybeCloseStream(id);
+  }
+}
+
+
+bool Session::ValidateHeaders(const Headers& headers,
+                              HeadersCategory category) const {
+  const bool is_request = category == kHeadersRequest;
+  const bool is_response = category == kHeadersResponse ||
+                           category == kHeadersInformational;
+  std::set<std::string> pseudo;
+  bool regular_seen = false;
+
+  for (const Header& header : headers) {
+    const std::string& name = header.name;
+    if (name.empty())
+      return false;
+    for (const char c : name) {
+      if (c >= 'A' && c <= 'Z')
+        return false;
+    }
+
+    if (name[0] == ':') {
+      if (regular_seen || !pseudo.insert(name).second)
+        return false;
+      if (is_request) {
+        if (name != ":method" && name != ":scheme" && name != ":path" &&
+            name != ":authority")
+          return false;
+      } else if (!is_response || name != ":status") {
+        return false;
+      }
+      continue;
+    }
+
+    regular_seen = true;
+    for (const char* connection_header : kConnectionHeaders) {
+      if (name == connection_header)
+        return false;
+    }
+    if (name == "te" && header.value != "trailers")
+      return false;
+  }
+
+  if (is_request) {
+    // CONNECT requests name nothing but the authority (RFC 7540, 8.3).
+    for (const Header& header : headers) {
+      if (header.name != ":method")
+        continue;
+      if (header.value == "CONNECT")
+        return pseudo.size() == 2 && pseudo.count(":authority") != 0;
+      return pseudo.count(":scheme") != 0 && pseudo.count(":path") != 0;
+    }
+    return false;
+  }
+  if (is_response)
+    return pseudo.count(":status") != 0;
+  return true;
+}
+
+
+void Session::OnPriority(int32_t id, size_t length) {
+  if (id == 0)
+    return ConnectionError(kPROTOCOL_ERROR);
+  if (length != 5)
+    return ResetStream(id, kFRAME_SIZE_ERROR);
+  // Priorities are advisory, and all streams are served in turn.
+}
+
+
+void Session::OnRstStream(int32_t id, const uint8_t* payload,
+                          size_t length) {
+  if (id == 0)
+    return ConnectionError(kPROTOCOL_ERROR);
+  if (length != 4)
+    return ConnectionError(kFRAME_SIZE_ERROR);
+
+  StreamIterator it = streams_.find(id);
+  if (it == streams_.end()) {
+    if (IsIdle(id))
+      ConnectionError(kPROTOCOL_ERROR);
+    return;
+  }
+  CloseStream(it, ReadUint32(payload));
+}
+
+
+void Session::OnSettings(uint8_t flags, int32_t id, const uint8_t* payload,
+                         size_t length) {
+  if (id != 0)
+    return ConnectionError(kPROTOCOL_ERROR);
+
+  if ((flags & kFlagAck) != 0) {
+    if (length != 0)
+      return ConnectionError(kFRAME_SIZE_ERROR);
+    if (pending_settings_.empty())
+      return;
+    local_ = pending_settings_.front();
+    pending_settings_.pop_front();
+    // Smaller windows are only in effect once the peer knows about them.
+    if (local_.initial_window_size < stream_window_)
+      SetLocalWindow(local_.initial_window_size);
+    decoder_.SetMaxTableSizeLimit(local_.header_table_size);
+    return Emit(Event::kSettingsAck, 0);
+  }
+
+  if (length % 6 != 0)
+    return ConnectionError(kFRAME_SIZE_ERROR);
+
+  for (size_t i = 0; i < length; i += 6) {
+    const uint16_t setting = (payload[i] << 8) | payload[i + 1];
+    const uint32_t value = ReadUint32(payload + i + 2);
+    switch (setting) {
+      case kSettingsHeaderTableSize:
+        remote_.header_table_size = value;
+        encoder_.SetMaxTableSize(value);
+        break;
+      case kSettingsEnablePush:
+        if (value > 1)
+          return ConnectionError(kPROTOCOL_ERROR);
+        remote_.enable_push = value;
+        break;
+      case kSettingsMaxConcurrentStreams:
+        remote_.max_concurrent_streams = value;
+        break;
+      case kSettingsInitialWindowSize: {
+        if (value > kMaxWindowSize)
+          return ConnectionError(kFLOW_CONTROL_ERROR);
+        // The change applies to the windows of all open streams (RFC 7540,
+        // 6.9.2), which may even become negative.
+        const int64_t delta = static_cast<int64_t>(value) -
+                              remote_.initial_window_size;
+        for (auto& entry : streams_) {
+          entry.second.send_window += delta;
+          if (entry.second.send_window > kMaxWindowSize)
+            return ConnectionError(kFLOW_CONTROL_ERROR);
+        }
+        remote_.initial_window_size = value;
+        break;
+      }
+      case kSettingsMaxFrameSize:
+        if (value < kMinFrameSize || value > kMaxFrameSize)
+          return ConnectionError(kPROTOCOL_ERROR);
+        remote_.max_frame_size = value;
+        break;
+      case kSettingsMaxHeaderListSize:
+        remote_.max_header_list_size = value;
+        break;
+      default:
+        // Unknown settings are ignored (RFC 7540, 6.5.2).
+        break;
+    }
+  }
+
+  settings_received_ = true;
+  WriteFrameHeader(0, kFrameSettings, kFlagAck, 0, &output_);
+  Emit(Event::kSettings, 0);
+}
+
+
+void Session::OnPing(uint8_t flags, int32_t id, const uint8_t* payload,
+                     size_t length) {
+  if (id != 0)
+    return ConnectionError(kPROTOCOL_ERROR);
+  if (length != 8)
+    return ConnectionError(kFRAME_SIZE_ERROR);
+
+  if ((flags & kFlagAck) == 0) {
+    WriteFrameHeader(8, kFramePing, kFlagAck, 0, &output_);
+    output_.append(reinterpret_cast<const char*>(payload), 8);
+    return;
+  }
+
+  events_.push_back(Event());
+  Event& event = events_.back();
+  event.type = Event::kPingAck;
+  event.data.assign(reinterpret_cast<const char*>(payload), 8);
+}
+
+
+void Session::OnGoaway(int32_t id, const uint8_t* payload, size_t length) {
+  if (id != 0)
+    return ConnectionError(kPROTOCOL_ERROR);
+  if (length < 8)
+    return ConnectionError(kFRAME_SIZE_ERROR);
+
+  const int32_t last_id =
+      static_cast<int32_t>(ReadUint32(payload) & kMaxStreamId);
+  goaway_received_ = true;
+  events_.push_back(Event());
+  Event& event = events_.back();
+  event.type = Event::kGoaway;
+  event.stream_id = last_id;
+  event.code = ReadUint32(payload + 4);
+  event.data.assign(reinterpret_cast<const char*>(payload) + 8, length - 8);
+
+  // Our streams after |last_id| were not processed, and can be retried on
+  // another connection.
+  StreamIterator it = streams_.upper_bound(last_id);
+  while (it != streams_.end()) {
+    StreamIterator next = it;
+    ++next;
+    if (IsLocalId(it->first))
+      CloseStream(it, kREFUSED_STREAM);
+    it = next;
+  }
+}
+
+
+void Session::OnWindowUpdate(int32_t id, const uint8_t* payload,
+                             size_t length) {
+  if (length != 4)
+    return ConnectionError(kFRAME_SIZE_ERROR);
+  const uint32_t increment = ReadUint32(payload) & kMaxWindowSize;
+
+  if (id == 0) {
+    if (increment == 0)
+      return ConnectionError(kPROTOCOL_ERROR);
+    send_window_ += increment;
+    if (send_window_ > kMaxWindowSize)
+      return ConnectionError(kFLOW_CONTROL_ERROR);
+    return;
+  }
+
+  Stream* stream = FindStream(id);
+  if (stream == nullptr) {
+    if (IsIdle(id))
+      ConnectionError(kPROTOCOL_ERROR);
+    return;
+  }
+  if (increment == 0)
+    return ResetStream(id, kPROTOCOL_ERROR);
+  stream->send_window += increment;
+  if (stream->send_window > kMaxWindowSize)
+    return ResetStream(id, kFLOW_CONTROL_ERROR);
+}
+
+
+bool Session::NextEvent(Event* event) {
+  if (events_.empty())
+    return false;
+  std::swap(*event, events_.front());
+  events_.pop_front();
+  return true;
+}
+
+
+void Session::Send(size_t max_data, std::string* out) {
+  if (out->empty())
+    out->swap(output_);
+  else
+    out->append(output_);
+  output_.clear();
+  if (failed_ || streams_.empty())
+    return;
+
+  // Streams take turns, starting after the one that sent last time.
+  std::vector<int32_t> ids;
+  ids.reserve(streams_.size());
+  StreamIterator start = streams_.upper_bound(last_sent_id_);
+  for (StreamIterator it = start; it != streams_.end(); ++it)
+    ids.push_back(it->first);
+  for (StreamIterator it = streams_.begin(); it != start; ++it)
+    ids.push_back(it->first);
+
+  for (const int32_t id : ids) {
+    Stream* stream = FindStream(id);
+    if (stream == nullptr || stream->local_closed || !stream->headers_sent)
+      continue;
+    const size_t before = out->size();
+    SendStreamData(stream, &max_data, out);
+    if (out->size() != before)
+      last_sent_id_ = id;
+    if (stream->local_closed)
+      MaybeCloseStream(id);
+  }
+}
+
+
+void Session::SendStreamData(Stream* stream, size_t* max_data,
+                             std::string* out) {
+  const bool had_data = stream->queued > 0;
+  size_t last_frame = std::string::npos;
+
+  while (stream->queued > 0) {
+    const int64_t window = std::min(stream->send_window, send_window_);
+    if (window <= 0 || *max_data == 0)
+      break;
+    const size_t length =
+        std::min(std::min(stream->queued, static_cast<size_t>(window)),
+                 std::min(static_cast<size_t>(remote_.max_frame_size),
+                          *max_data));
+
+    last_frame = out->size();
+    WriteFrameHeader(length, kFrameData, 0, stream->id, out);
+    // Small writes share a frame.
+    size_t remaining = length;
+    while (remaining > 0) {
+      const std::string& chunk = stream->data.front();
+      const size_t n = std::min(remaining, chunk.size() - stream->offset);
+      out->append(chunk, stream->offset, n);
+      stream->offset += n;
+      remaining -= n;
+      if (stream->offset == chunk.size()) {
+        stream->data.pop_front();
+        stream->offset = 0;
+      }
+    }
+
+    stream->queued -= length;
+    stream->send_window -= length;
+    send_window_ -= length;
+    *max_data -= length;
+  }
+
+  if (stream->queued > 0)
+    return;
+  if (had_data)
+    Emit(Event::kStreamDrain, stream->id);
+  if (!stream->end_queued)
+    return;
+
+  if (stream->has_trailers) {
+    WriteHeaders(stream->id, stream->trailers, true, out);
+    stream->trailers.clear();
+  } else if (last_frame != std::string::npos) {
+    (*out)[last_frame + 4] |= kFlagEndStream;
+  } else {
+    WriteFrameHeader(0, kFrameData, kFlagEndStream, stream->id, out);
+  }
+  stream->local_closed = true;
+}
+
+
+int32_t Session::SubmitRequest(const Headers& headers, bool end_stream) {
+  if (type_ != kClient || failed_ || goaway_received_ || goaway_sent_ ||
+      next_stream_id_ > kMaxStreamId) {
+    return -1;
+  }
+  if (local_stream_count_ >= remote_.max_concurrent_streams)
+    return 0;
+
+  const int32_t id = static_cast<int32_t>(next_stream_id_);
+  next_stream_id_ += 2;
+  Stream* stream = CreateStream(id);
+  stream->headers_sent = true;
+  stream->local_closed = end_stream;
+  WriteHeaders(id, headers, end_stream, &output_);
+  return id;
+}
+
+
+bool Session::SubmitResponse(int32_t id, const Headers& headers,
+                             bool end_stream) {
+  Stream* stream = FindStream(id);
+  if (failed_ || stream == nullptr || IsLocalId(id) ||
+      stream->local_closed || stream->end_queued || stream->queued > 0)
+    return false;
+  stream->headers_sent = true;
+  stream->local_closed = end_stream;
+  WriteHeaders(id, headers, end_stream, &output_);
+  if (end_stream)
+    MaybeCloseStream(id);
+  return true;
+}
+
+
+bool Session::SubmitData(int32_t id, const char* data, size_t length) {
+  Stream* stream = FindStream(id);
+  if (failed_ || stream == nullptr || !stream->headers_sent ||
+      stream->local_closed || stream->end_queued)
+    return false;
+  if (length > 0) {
+    stream->data.push_back(std::string(data, length));
+    stream->queued += length;
+  }
+  return true;
+}
+
+
+bool Session::SubmitEnd(int32_t id, const Headers* trailers) {
+  Stream* stream = FindStream(id);
+  if (failed_ || stream == nullptr || !stream->headers_sent ||
+      stream->local_closed || stream->end_queued)
+    return false;
+  stream->end_queued = true;
+  if (trailers != nullptr && !trailers->empty()) {
+    stream->has_trailers = true;
+    stream->trailers = *trailers;
+  }
+  return true;
+}
+
+
+void Session::SubmitRstStream(int32_t id, uint32_t code) {
+  if (!failed_ && HasStream(id))
+    ResetStream(id, code);
+}
+
+
+void Session::SubmitPing(const uint8_t payload[8]) {
+  if (failed_)
+    return;
+  WriteFrameHeader(8, kFramePing, 0, 0, &output_);
+  output_.append(reinterpret_cast<const char*>(payload), 8);
+}
+
+
+void Session::SubmitSettings(const Settings& settings) {
+  if (failed_)
+    return;
+  Settings sent = settings;
+  sent.enable_push = 0;
+  sent.max_frame_size =
+      std::max(kMinFrameSize, std::min(kMaxFrameSize, sent.max_frame_size));
+  sent.initial_window_size = std::min(kMaxWindowSize,
+                                      sent.initial_window_size);
+
+  // The peer may use larger frames and windows as soon as it has seen
+  // them, before we get its acknowledgement.
+  max_frame_size_ = std::max(max_frame_size_, sent.max_frame_size);
+  if (sent.initial_window_size > stream_window_)
+    SetLocalWindow(sent.initial_window_size);
+  pending_settings_.push_back(sent);
+  WriteSettings(sent);
+}
+
+
+void Session::SubmitGoaway(uint32_t code) {
+  if (failed_)
+    return;
+  goaway_sent_ = true;
+  WriteFrameHeader(8, kFrameGoaway, 0, 0, &output_);
+  WriteUint32(static_cast<uint32_t>(last_peer_stream_id_), &output_);
+  WriteUint32(code, &output_);
+}
+
+
+void Session::ConsumeData(int32_t id, size_t length) {
+  if (failed_ || length == 0)
+    return;
+
+  // Windows are opened again in steps of half their size, rather than
+  // with an update for every frame.
+  unacked_ += length;
+  if (unacked_ >= kDefaultWindowSize / 2) {
+    WriteWindowUpdate(0, unacked_);
+    recv_window_ += unacked_;
+    unacked_ = 0;
+  }
+
+  Stream* stream = FindStream(id);
+  if (stream == nullptr || stream->remote_closed)
+    return;
+  stream->unacked += length;
+  if (stream->unacked >= stream_window_ / 2) {
+    WriteWindowUpdate(id, stream->unacked);
+    stream->recv_window += stream->unacked;
+    stream->unacked = 0;
+  }
+}
+
+
+size_t Session::QueuedData(int32_t id) const {
+  std::map<int32_t, Stream>::const_iterator it = streams_.find(id);
+  return it == streams_.end() ? 0 : it->second.queued;
+}
+
+
+bool Session::IsIdle(int32_t id) const {
+  if (IsLocalId(id))
+    return id >= next_stream_id_;
+  return id > last_peer_stream_id_;
+}
+
+
+Session::Stream* Session::FindStream(int32_t id) {
+  StreamIterator it = streams_.find(id);
+  return it == streams_.end() ? nullptr : &it->second;
+}
+
+
+Session::Stream* Session::CreateStream(int32_t id) {
+  Stream* stream =
+      &streams_.insert(std::make_pair(id, Stream(id))).first->second;
+  stream->send_window = remote_.initial_window_size;
+  stream->recv_window = stream_window_;
+  if (IsLocalId(id))
+    local_stream_count_++;
+  else
+    peer_stream_count_++;
+  return stream;
+}
+
+
+void Session::CloseStream(StreamIterator it, uint32_t code) {
+  const int32_t id = it->first;
+  if (IsLocalId(id))
+    local_stream_count_--;
+  else
+    peer_stream_count_--;
+  // Data that was received but not consumed yet no longer holds up the
+  // connection.
+  const int64_t unconsumed = static_cast<int64_t>(stream_window_) -
+                             it->second.recv_window -
+                             static_cast<int64_t>(it->second.unacked);
+  streams_.erase(it);
+  if (!failed_ && unconsumed > 0 && code != kNO_ERROR)
+    ConsumeData(0, static_cast<size_t>(unconsumed));
+  Emit(Event::kStreamClose, id, code);
+}
+
+
+void Session::MaybeCloseStream(int32_t id) {
+  StreamIterator it = streams_.find(id);
+  if (it != streams_.end() && it->second.local_closed &&
+      it->second.remote_closed) {
+    CloseStream(it, kNO_ERROR);
+  }
+}
+
+
+void Session::ResetStream(int32_t id, uint32_t code) {
+  WriteFrameHeader(4, kFrameRstStream, 0, id, &output_);
+  WriteUint32(code, &output_);
+  StreamIterator it = streams_.find(id);
+  if (it != streams_.end())
+    CloseStream(it, code);
+}
+
+
+void Session::ConnectionError(uint32_t code) {
+  if (failed_)
+    return;
+  WriteFrameHeader(8, kFrameGoaway, 0, 0, &output_);
+  WriteUint32(static_cast<uint32_t>(last_peer_stream_id_), &output_);
+  WriteUint32(code, &output_);
+  goaway_sent_ = true;
+  failed_ = true;
+  streams_.clear();
+  local_stream_count_ = 0;
+  peer_stream_count_ = 0;
+  Emit(Event::kError, 0, code);
+}
+
+
+void Session::WriteHeaders(int32_t id, const Headers& headers,
+                           bool end_stream, std::string* out) {
+  std::string block;
+  encoder_.Encode(headers, &block);
+
+  // Blocks that do not fit into one frame go on in CONTINUATION frames.
+  const size_t max_length = remote_.max_frame_size;
+  size_t offset = 0;
+  uint8_t type = kFrameHeaders;
+  uint8_t flags = end_stream ? kFlagEndStream : 0;
+  do {
+    const size_t length = std::min(max_length, block.size() - offset);
+    if (offset + length == block.size())
+      flags |= kFlagEndHeaders;
+    WriteFrameHeader(length, type, flags, id, out);
+    out->append(block, offset, length);
+    offset += length;
+    type = kFrameContinuation;
+    flags = 0;
+  } while (offset < block.size());
+}
+
+
+void Session::WriteSettings(const Settings& settings) {
+  const Settings defaults;
+  std::string payload;
+  WriteSetting(kSettingsEnablePush, settings.enable_push, &payload);
+  if (settings.header_table_size != defaults.header_table_size) {
+    WriteSetting(kSettingsHeaderTableSize, settings.header_table_size,
+                 &payload);
+  }
+  if (settings.max_concurrent_streams != defaults.max_concurrent_streams) {
+    WriteSetting(kSettingsMaxConcurrentStreams,
+                 settings.max_concurrent_streams,
+                 &payload);
+  }
+  if (settings.initial_window_size != defaults.initial_window_size) {
+    WriteSetting(kSettingsInitialWindowSize, settings.initial_window_size,
+                 &payload);
+  }
+  if (settings.max_frame_size != defaults.max_frame_size)
+    WriteSetting(kSettingsMaxFrameSize, settings.max_frame_size, &payload);
+  if (settings.max_header_list_size != defaults.max_header_list_size) {
+    WriteSetting(kSettingsMaxHeaderListSize, settings.max_header_list_size,
+                 &payload);
+  }
+  WriteFrameHeader(payload.size(), kFrameSettings, 0, 0, &output_);
+  output_.append(payload);
+}
+
+
+void Session::WriteWindowUpdate(int32_t id, size_t increment) {
+  WriteFrameHeader(4, kFrameWindowUpdate, 0, id, &output_);
+  WriteUint32(static_cast<uint32_t>(increment), &output_);
+}
+
+
+void Session::SetLocalWindow(uint32_t initial_window_size) {
+  const int64_t delta = static_cast<int64_t>(initial_window_size) -
+                        stream_window_;
+  for (auto& entry : streams_)
+    entry.second.recv_window += delta;
+  stream_window_ = initial_window_size;
+}
+
+
+void Session::Emit(Event::Type type, int32_t id, uint32_t code) {
+  events_.push_back(Event());
+  Event& event = events_.back();
+  event.type = type;
+  event.stream_id = id;
+  event.code = code;
+}
+
+}  // namespace http2
+}  // namespace node
@@ -0,0 +1,334 @@
+#ifndef SRC_NODE_HTTP2_CORE_H_
+#define SRC_NODE_HTTP2_CORE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node_http2_hpack.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace node {
+namespace http2 {
+
+// RFC 7540, 6 and 11.2.
+enum FrameType {
+  kFrameData = 0x0,
+  kFrameHeaders = 0x1,
+  kFramePriority = 0x2,
+  kFrameRstStream = 0x3,
+  kFrameSettings = 0x4,
+  kFramePushPromise = 0x5,
+  kFramePing = 0x6,
+  kFrameGoaway = 0x7,
+  kFrameWindowUpdate = 0x8,
+  kFrameContinuation = 0x9
+};
+
+enum FrameFlags {
+  kFlagEndStream = 0x1,
+  kFlagAck = 0x1,
+  kFlagEndHeaders = 0x4,
+  kFlagPadded = 0x8,
+  kFlagPriority = 0x20
+};
+
+// RFC 7540, 7.
+#define HTTP2_ERROR_CODES(V)                                                  \
+  V(NO_ERROR, 0x0)                                                            \
+  V(PROTOCOL_ERROR, 0x1)                                                      \
+  V(INTERNAL_ERROR, 0x2)                                                      \
+  V(FLOW_CONTROL_ERROR, 0x3)                                                  \
+  V(SETTINGS_TIMEOUT, 0x4)                                                    \
+  V(STREAM_CLOSED, 0x5)                                                       \
+  V(FRAME_SIZE_ERROR, 0x6)                                                    \
+  V(REFUSED_STREAM, 0x7)                                                      \
+  V(CANCEL, 0x8)                                                              \
+  V(COMPRESSION_ERROR, 0x9)                                                   \
+  V(CONNECT_ERROR, 0xa)                                                       \
+  V(ENHANCE_YOUR_CALM, 0xb)                                                   \
+  V(INADEQUATE_SECURITY, 0xc)                                                 \
+  V(HTTP_1_1_REQUIRED, 0xd)
+
+enum ErrorCode {
+#define V(name, value) k##name = value,
+  HTTP2_ERROR_CODES(V)
+#undef V
+};
+
+const size_t kFrameHeaderLength = 9;
+const uint32_t kDefaultWindowSize = 65535;
+const uint32_t kMaxWindowSize = 0x7fffffff;
+const uint32_t kMinFrameSize = 16384;
+const uint32_t kMaxFrameSize = 0xffffff;
+const int32_t kMaxStreamId = 0x7fffffff;
+
+// What a client sends before anything else (RFC 7540, 3.5).
+extern const char kClientPreface[];
+const size_t kClientPrefaceLength = 24;
+
+// RFC 7540, 6.5.2. The defaults are the protocol's initial values.
+struct Settings {
+  Settings()
+      : header_table_size(4096),
+        enable_push(1),
+        max_concurrent_streams(0xffffffff),
+        initial_window_size(kDefaultWindowSize),
+        max_frame_size(kMinFrameSize),
+        max_header_list_size(0xffffffff) {}
+
+  uint32_t header_table_size;
+  uint32_t enable_push;
+  uint32_t max_concurrent_streams;
+  uint32_t initial_window_size;
+  uint32_t max_frame_size;
+  uint32_t max_header_list_size;
+};
+
+enum HeadersCategory {
+  kHeadersRequest,
+  kHeadersResponse,
+  // A response with a 1xx status, which another response follows.
+  kHeadersInformational,
+  kHeadersTrailers
+};
+
+// Something that happened on the session, for the embedder to act on.
+struct Event {
+  enum Type {
+    // A header block arrived on |stream_id|.
+    kHeaders,
+    // |data| arrived on |stream_id|. The embedder passes its length to
+    // ConsumeData() once it has been processed, to open the window again.
+    kData,
+    // The peer ended its side of |stream_id|.
+    kStreamEnd,
+    // |stream_id| is gone, either because both sides ended it (|code| is
+    // NO_ERROR) or because it was reset with |code| by either side.
+    kStreamClose,
+    // Everything that was submitted on |stream_id| has been framed.
+    kStreamDrain,
+    kSettings,
+    kSettingsAck,
+    // An acknowledgement of a PING that carried |data|.
+    kPingAck,
+    // The peer is going away with |code|, and handled no streams after
+    // |stream_id|. |data| is the debug data it sent.
+    kGoaway,
+    // The peer broke the protocol and the session failed with |code|. A
+    // GOAWAY has been queued, and nothing else is sent or received.
+    kError
+  };
+
+  Event() : type(kError), stream_id(0), code(0), category(kHeadersRequest),
+            end_stream(false) {}
+
+  Type type;
+  int32_t stream_id;
+  uint32_t code;
+  HeadersCategory category;
+  bool end_stream;
+  Headers headers;
+  std::string data;
+};
+
+// An HTTP/2 connection endpoint without any I/O or JavaScript: bytes from
+// the peer go into Receive(), frames for the peer come out of Send(), and
+// what happened in between is queued as Events. Nothing calls back into the
+// embedder, so it is safe to submit new work while handling an event.
+//
+// Flow control is enforced in both directions. Data submitted on a stream is
+// queued until the peer's windows allow sending it, and the windows of the
+// peer are only opened again for data that the embedder has consumed.
+// Server push and stream priorities are not supported.
+class Session {
+ public:
+  enum Type { kServer, kClient };
+
+  // Queues the client preface, if any, and |settings|. ENABLE_PUSH is always
+  // sent as 0.
+  Session(Type type, const Settings& settings);
+
+  // Returns false once the session has failed.
+  bool Receive(const uint8_t* data, size_t length);
+
+  bool NextEvent(Event* event);
+  bool has_events() const { return !events_.empty(); }
+
+  // Appends the frames that are ready to |out|. Frames other than DATA are
+  // always included, DATA frames carry up to |max_data| bytes in total.
+  void Send(size_t max_data, std::string* out);
+
+  // Opens a stream and sends |headers| on it. Returns the new stream's id,
+  // 0 if the peer does not allow another stream at the moment, and -1 if no
+  // more streams can be opened on this session.
+  int32_t SubmitRequest(const Headers& headers, bool end_stream);
+  // Sends the response headers, or an informational response, on a stream
+  // that the peer opened.
+  bool SubmitResponse(int32_t id, const Headers& headers, bool end_stream);
+  bool SubmitData(int32_t id, const char* data, size_t length);
+  // Ends the local side of the stream once its queued data has been sent,
+  // with |trailers| if there are any.
+  bool SubmitEnd(int32_t id, const Headers* trailers);
+  void SubmitRstStream(int32_t id, uint32_t code);
+  void SubmitPing(const uint8_t payload[8]);
+  void SubmitSettings(const Settings& settings);
+  void SubmitGoaway(uint32_t code);
+
+  // Opens the windows again for |length| bytes of data received on |id|.
+  void ConsumeData(int32_t id, size_t length);
+
+  // The number of bytes submitted on |id| that wait for the flow control
+  // windows. Returns 0 for streams that do not exist.
+  size_t QueuedData(int32_t id) const;
+  bool HasStream(int32_t id) const { return streams_.count(id) != 0; }
+  size_t stream_count() const { return streams_.size(); }
+
+  const Settings& local_settings() const { return local_; }
+  const Settings& remote_settings() const { return remote_; }
+  int64_t send_window() const { return send_window_; }
+  int64_t receive_window() const { return recv_window_; }
+  int32_t last_peer_stream_id() const { return last_peer_stream_id_; }
+  bool failed() const { return failed_; }
+  bool goaway_received() const { return goaway_received_; }
+  bool goaway_sent() const { return goaway_sent_; }
+
+ private:
+  struct Stream {
+    explicit Stream(int32_t id)
+        : id(id),
+          local_closed(false),
+          remote_closed(false),
+          headers_sent(false),
+          headers_received(false),
+          end_queued(false),
+          has_trailers(false),
+          send_window(0),
+          recv_window(0),
+          unacked(0),
+          queued(0),
+          offset(0) {}
+
+    int32_t id;
+    // Whether END_STREAM was sent and received.
+    bool local_closed;
+    bool remote_closed;
+    bool headers_sent;
+    // Whether the request, or the final response, has arrived.
+    bool headers_received;
+    bool end_queued;
+    bool has_trailers;
+    Headers trailers;
+    int64_t send_window;
+    int64_t recv_window;
+    // Data that the embedder consumed, but that no WINDOW_UPDATE covers yet.
+    size_t unacked;
+    // Submitted data, of which the first |offset| bytes have been sent.
+    std::deque<std::string> data;
+    size_t queued;
+    size_t offset;
+  };
+
+  typedef std::map<int32_t, Stream>::iterator StreamIterator;
+
+  size_t ProcessFrames(const uint8_t* data, size_t length);
+  void ProcessFrame(uint8_t type, uint8_t flags, int32_t id,
+                    const uint8_t* payload, size_t length);
+  void OnData(uint8_t flags, int32_t id, const uint8_t* payload,
+              size_t length);
+  void OnHeaders(uint8_t flags, int32_t id, const uint8_t* payload,
+                 size_t length);
+  void OnContinuation(uint8_t flags, int32_t id, const uint8_t* payload,
+                      size_t length);
+  void OnHeaderBlock();
+  void OnPriority(int32_t id, size_t length);
+  void OnRstStream(int32_t id, const uint8_t* payload, size_t length);
+  void OnSettings(uint8_t flags, int32_t id, const uint8_t* payload,
+                  size_t length);
+  void OnPing(uint8_t flags, int32_t id, const uint8_t* payload,
+              size_t length);
+  void OnGoaway(int32_t id, const uint8_t* payload, size_t length);
+  void OnWindowUpdate(int32_t id, const uint8_t* payload, size_t length);
+
+  // Strips the padding of DATA and HEADERS frames.
+  bool RemovePadding(uint8_t flags, const uint8_t** payload, size_t* length);
+  bool ValidateHeaders(const Headers& headers, HeadersCategory category) const;
+
+  bool IsLocalId(int32_t id) const {
+    return (id % 2 == 1) == (type_ == kClient);
+  }
+  bool IsIdle(int32_t id) const;
+  Stream* FindStream(int32_t id);
+  Stream* CreateStream(int32_t id);
+  void CloseStream(StreamIterator it, uint32_t code);
+  void MaybeCloseStream(int32_t id);
+  void ResetStream(int32_t id, uint32_t code);
+  void ConnectionError(uint32_t code);
+  void SendStreamData(Stream* stream, size_t* max_data, std::string* out);
+
+  void WriteHeaders(int32_t id, const Headers& headers, bool end_stream,
+                    std::string* out);
+  void WriteSettings(const Settings& settings);
+  void WriteWindowUpdate(int32_t id, size_t increment);
+  void SetLocalWindow(uint32_t initial_window_size);
+
+  void Emit(Event::Type type, int32_t id, uint32_t code = 0);
+
+  const Type type_;
+  Settings local_;
+  Settings remote_;
+  // Settings that were sent but not acknowledged yet.
+  std::deque<Settings> pending_settings_;
+  hpack::Encoder encoder_;
+  hpack::Decoder decoder_;
+
+  std::map<int32_t, Stream> streams_;
+  size_t local_stream_count_;
+  size_t peer_stream_count_;
+  // Wider than stream ids, to tell when they have run out.
+  int64_t next_stream_id_;
+  int32_t last_peer_stream_id_;
+  // Where the next Send() starts looking for data, so that no stream gets
+  // to keep the others from sending.
+  int32_t last_sent_id_;
+
+  int64_t send_window_;
+  int64_t recv_window_;
+  size_t unacked_;
+  // The initial window that our streams are counted against, and the
+  // largest frame that we accept. Both can be ahead of local_, which only
+  // changes when the peer acknowledges our settings.
+  uint32_t stream_window_;
+  uint32_t max_frame_size_;
+
+  // Frames that do not wait for flow control.
+  std::string output_;
+  // Unprocessed data from the peer, never more than one frame.
+  std::string input_;
+  size_t preface_remaining_;
+  bool settings_received_;
+
+  // The header block that HEADERS and CONTINUATION frames are adding to,
+  // which is complete when |continuation_id_| is back to 0.
+  std::string header_block_;
+  int32_t header_block_id_;
+  bool header_block_end_stream_;
+  int32_t continuation_id_;
+
+  std::deque<Event> events_;
+  bool failed_;
+  bool goaway_received_;
+  bool goaway_sent_;
+};
+
+}  // namespace http2
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_HTTP2_CORE_H_
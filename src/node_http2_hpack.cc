@@ -0,0 +1,534 @@
+#include "node_http2_hpack.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace node {
+namespace http2 {
+namespace hpack {
+
+namespace {
+
+// RFC 7541, Appendix A.
+const struct {
+  const char* name;
+  const char* value;
+} kStaticTable[] = {
+  { ":authority", "" },
+  { ":method", "GET" },
+  { ":method", "POST" },
+  { ":path", "/" },
+  { ":path", "/index.html" },
+  { ":scheme", "http" },
+  { ":scheme", "https" },
+  { ":status", "200" },
+  { ":status", "204" },
+  { ":status", "206" },
+  { ":status", "304" },
+  { ":status", "400" },
+  { ":status", "404" },
+  { ":status", "500" },
+  { "accept-charset", "" },
+  { "accept-encoding", "gzip, deflate" },
+  { "accept-language", "" },
+  { "accept-ranges", "" },
+  { "accept", "" },
+  { "access-control-allow-origin", "" },
+  { "age", "" },
+  { "allow", "" },
+  { "authorization", "" },
+  { "cache-control", "" },
+  { "content-disposition", "" },
+  { "content-encoding", "" },
+  { "content-language", "" },
+  { "content-length", "" },
+  { "content-location", "" },
+  { "content-range", "" },
+  { "content-type", "" },
+  { "cookie", "" },
+  { "date", "" },
+  { "etag", "" },
+  { "expect", "" },
+  { "expires", "" },
+  { "from", "" },
+  { "host", "" },
+  { "if-match", "" },
+  { "if-modified-since", "" },
+  { "if-none-match", "" },
+  { "if-range", "" },
+  { "if-unmodified-since", "" },
+  { "last-modified", "" },
+  { "link", "" },
+  { "location", "" },
+  { "max-forwards", "" },
+  { "proxy-authenticate", "" },
+  { "proxy-authorization", "" },
+  { "range", "" },
+  { "referer", "" },
+  { "refresh", "" },
+  { "retry-after", "" },
+  { "server", "" },
+  { "set-cookie", "" },
+  { "strict-transport-security", "" },
+  { "transfer-encoding", "" },
+  { "user-agent", "" },
+  { "vary", "" },
+  { "via", "" },
+  { "www-authenticate", "" },
+};
+
+const size_t kStaticTableLength = sizeof(kStaticTable) / sizeof(*kStaticTable);
+
+// RFC 7541, Appendix B. The last entry is EOS.
+const struct {
+  uint32_t code;
+  uint8_t bits;
+} kHuffmanCodes[257] = {
+  { 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 },
+  { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 },
+  { 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 },
+  { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 },
+  { 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 },
+  { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 },
+  { 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 },
+  { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 },
+  { 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 }, { 0x1ff9, 13 },
+  { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 }, { 0x3fa, 10 }, { 0x3fb, 10 },
+  { 0xf9, 8 }, { 0x7fb, 11 }, { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 },
+  { 0x18, 6 }, { 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 }, { 0x1a, 6 },
+  { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 }, { 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 },
+  { 0xfb, 8 }, { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 },
+  { 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 }, { 0x5f, 7 },
+  { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 }, { 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 },
+  { 0x66, 7 }, { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 }, { 0x6b, 7 },
+  { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 }, { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 },
+  { 0x72, 7 }, { 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 },
+  { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 }, { 0x7ffd, 15 },
+  { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 }, { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 },
+  { 0x26, 6 }, { 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 }, { 0x28, 6 },
+  { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 }, { 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 },
+  { 0x8, 5 }, { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 }, { 0x79, 7 },
+  { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 }, { 0x7fc, 11 }, { 0x3ffd, 14 },
+  { 0x1ffd, 13 }, { 0xffffffc, 28 }, { 0xfffe6, 20 }, { 0x3fffd2, 22 },
+  { 0xfffe7, 20 }, { 0xfffe8, 20 }, { 0x3fffd3, 22 }, { 0x3fffd4, 22 },
+  { 0x3fffd5, 22 }, { 0x7fffd9, 23 }, { 0x3fffd6, 22 }, { 0x7fffda, 23 },
+  { 0x7fffdb, 23 }, { 0x7fffdc, 23 }, { 0x7fffdd, 23 }, { 0x7fffde, 23 },
+  { 0xffffeb, 24 }, { 0x7fffdf, 23 }, { 0xffffec, 24 }, { 0xffffed, 24 },
+  { 0x3fffd7, 22 }, { 0x7fffe0, 23 }, { 0xffffee, 24 }, { 0x7fffe1, 23 },
+  { 0x7fffe2, 23 }, { 0x7fffe3, 23 }, { 0x7fffe4, 23 }, { 0x1fffdc, 21 },
+  { 0x3fffd8, 22 }, { 0x7fffe5, 23 }, { 0x3fffd9, 22 }, { 0x7fffe6, 23 },
+  { 0x7fffe7, 23 }, { 0xffffef, 24 }, { 0x3fffda, 22 }, { 0x1fffdd, 21 },
+  { 0xfffe9, 20 }, { 0x3fffdb, 22 }, { 0x3fffdc, 22 }, { 0x7fffe8, 23 },
+  { 0x7fffe9, 23 }, { 0x1fffde, 21 }, { 0x7fffea, 23 }, { 0x3fffdd, 22 },
+  { 0x3fffde, 22 }, { 0xfffff0, 24 }, { 0x1fffdf, 21 }, { 0x3fffdf, 22 },
+  { 0x7fffeb, 23 }, { 0x7fffec, 23 }, { 0x1fffe0, 21 }, { 0x1fffe1, 21 },
+  { 0x3fffe0, 22 }, { 0x1fffe2, 21 }, { 0x7fffed, 23 }, { 0x3fffe1, 22 },
+  { 0x7fffee, 23 }, { 0x7fffef, 23 }, { 0xfffea, 20 }, { 0x3fffe2, 22 },
+  { 0x3fffe3, 22 }, { 0x3fffe4, 22 }, { 0x7ffff0, 23 }, { 0x3fffe5, 22 },
+  { 0x3fffe6, 22 }, { 0x7ffff1, 23 }, { 0x3ffffe0, 26 }, { 0x3ffffe1, 26 },
+  { 0xfffeb, 20 }, { 0x7fff1, 19 }, { 0x3fffe7, 22 }, { 0x7ffff2, 23 },
+  { 0x3fffe8, 22 }, { 0x1ffffec, 25 }, { 0x3ffffe2, 26 }, { 0x3ffffe3, 26 },
+  { 0x3ffffe4, 26 }, { 0x7ffffde, 27 }, { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 },
+  { 0xfffff1, 24 }, { 0x1ffffed, 25 }, { 0x7fff2, 19 }, { 0x1fffe3, 21 },
+  { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 }, { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 },
+  { 0x7ffffe2, 27 }, { 0xfffff2, 24 }, { 0x1fffe4, 21 }, { 0x1fffe5, 21 },
+  { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 }, { 0xffffffd, 28 }, { 0x7ffffe3, 27 },
+  { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 }, { 0xfffec, 20 }, { 0xfffff3, 24 },
+  { 0xfffed, 20 }, { 0x1fffe6, 21 }, { 0x3fffe9, 22 }, { 0x1fffe7, 21 },
+  { 0x1fffe8, 21 }, { 0x7ffff3, 23 }, { 0x3fffea, 22 }, { 0x3fffeb, 22 },
+  { 0x1ffffee, 25 }, { 0x1ffffef, 25 }, { 0xfffff4, 24 }, { 0xfffff5, 24 },
+  { 0x3ffffea, 26 }, { 0x7ffff4, 23 }, { 0x3ffffeb, 26 }, { 0x7ffffe6, 27 },
+  { 0x3ffffec, 26 }, { 0x3ffffed, 26 }, { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 },
+  { 0x7ffffe9, 27 }, { 0x7ffffea, 27 }, { 0x7ffffeb, 27 }, { 0xffffffe, 28 },
+  { 0x7ffffec, 27 }, { 0x7ffffed, 27 }, { 0x7ffffee, 27 }, { 0x7ffffef, 27 },
+  { 0x7fffff0, 27 }, { 0x3ffffee, 26 }, { 0x3fffffff, 30 },
+};
+
+const int kEOS = 256;
+
+// A binary tree over kHuffmanCodes. Internal nodes are numbered from 0 for
+// the root, and a child is either the number of an internal node or, for a
+// leaf, -1 - symbol. A complete code over 257 symbols has 256 internal nodes.
+struct HuffmanTree {
+  HuffmanTree() {
+    memset(children, 0, sizeof(children));
+    int16_t next = 1;
+    for (int symbol = 0; symbol <= kEOS; symbol++) {
+      const uint32_t code = kHuffmanCodes[symbol].code;
+      int16_t node = 0;
+      for (int bit = kHuffmanCodes[symbol].bits - 1; bit > 0; bit--) {
+        int16_t* child = &children[node][(code >> bit) & 1];
+        if (*child == 0)
+          *child = next++;
+        node = *child;
+      }
+      children[node][code & 1] = -1 - symbol;
+    }
+  }
+
+  int16_t children[256][2];
+};
+
+const HuffmanTree& GetHuffmanTree() {
+  static const HuffmanTree tree;
+  return tree;
+}
+
+// Values of these headers rarely repeat, so adding them to the dynamic
+// table would only push out more useful entries.
+const char* const kUnindexedNames[] = {
+  "content-length",
+  "etag",
+  "if-modified-since",
+  "if-none-match",
+  "last-modified",
+  "location",
+  "set-cookie"
+};
+
+bool IsSensitive(const Header& header) {
+  // Short cookies are cheap to guess one byte at a time when they are
+  // compressed together with what an attacker controls (RFC 7541, 7.1.3).
+  return header.name == "authorization" ||
+         header.name == "proxy-authorization" ||
+         (header.name == "cookie" && header.value.size() < 20);
+}
+
+bool IsUnindexed(const Header& header) {
+  for (const char* name : kUnindexedNames) {
+    if (header.name == name)
+      return true;
+  }
+  return false;
+}
+
+}  // anonymous namespace
+
+
+void EncodeInteger(uint64_t value, int prefix_bits, uint8_t first,
+                   std::string* out) {
+  const uint64_t max = (1 << prefix_bits) - 1;
+  if (value < max) {
+    out->push_back(static_cast<char>(first | value));
+    return;
+  }
+  out->push_back(static_cast<char>(first | max));
+  value -= max;
+  while (value >= 128) {
+    out->push_back(static_cast<char>(0x80 | (value & 0x7f)));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+
+bool DecodeInteger(const uint8_t** data, const uint8_t* end, int prefix_bits,
+                   uint64_t* value) {
+  const uint8_t* p = *data;
+  if (p == end)
+    return false;
+  const uint64_t max = (1 << prefix_bits) - 1;
+  uint64_t result = *p++ & max;
+  if (result == max) {
+    // Five continuation bytes hold more than any length or index that a
+    // header block can refer to.
+    for (int shift = 0; ; shift += 7) {
+      if (p == end || shift > 28)
+        return false;
+      const uint8_t byte = *p++;
+      result += static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        break;
+    }
+  }
+  *data = p;
+  *value = result;
+  return true;
+}
+
+
+void EncodeString(const std::string& value, std::string* out) {
+  const size_t length = HuffmanEncodedLength(value);
+  if (length < value.size()) {
+    EncodeInteger(length, 7, 0x80, out);
+    HuffmanEncode(value, out);
+  } else {
+    EncodeInteger(value.size(), 7, 0, out);
+    out->append(value);
+  }
+}
+
+
+bool DecodeString(const uint8_t** data, const uint8_t* end, std::string* out) {
+  if (*data == end)
+    return false;
+  const bool huffman = (**data & 0x80) != 0;
+  uint64_t length;
+  if (!DecodeInteger(data, end, 7, &length))
+    return false;
+  if (length > static_cast<uint64_t>(end - *data))
+    return false;
+  out->clear();
+  if (huffman) {
+    if (!HuffmanDecode(*data, length, out))
+      return false;
+  } else {
+    out->assign(reinterpret_cast<const char*>(*data), length);
+  }
+  *data += length;
+  return true;
+}
+
+
+size_t HuffmanEncodedLength(const std::string& value) {
+  size_t bits = 0;
+  for (const char c : value)
+    bits += kHuffmanCodes[static_cast<uint8_t>(c)].bits;
+  return (bits + 7) / 8;
+}
+
+
+void HuffmanEncode(const std::string& value, std::string* out) {
+  uint64_t pending = 0;
+  int count = 0;
+  for (const char c : value) {
+    const uint8_t symbol = static_cast<uint8_t>(c);
+    pending = (pending << kHuffmanCodes[symbol].bits) |
+              kHuffmanCodes[symbol].code;
+    count += kHuffmanCodes[symbol].bits;
+    while (count >= 8) {
+      count -= 8;
+      out->push_back(static_cast<char>(pending >> count));
+    }
+    pending &= (static_cast<uint64_t>(1) << count) - 1;
+  }
+  // Pad with the most significant bits of EOS, which are all ones.
+  if (count > 0) {
+    const uint64_t padded = (pending << (8 - count)) | (0xff >> count);
+    out->push_back(static_cast<char>(padded));
+  }
+}
+
+
+bool HuffmanDecode(const uint8_t* data, size_t length, std::string* out) {
+  const HuffmanTree& tree = GetHuffmanTree();
+  int16_t node = 0;
+  // The bits read since the last complete symbol, which have to be a
+  // padding of fewer than eight ones once the input ends.
+  int depth = 0;
+  bool ones = true;
+  for (size_t i = 0; i < length; i++) {
+    for (int shift = 7; shift >= 0; shift--) {
+      const int bit = (data[i] >> shift) & 1;
+      const int16_t next = tree.children[node][bit];
+      if (next == 0)
+        return false;
+      if (next > 0) {
+        node = next;
+        depth++;
+        ones = ones && bit == 1;
+        continue;
+      }
+      const int symbol = -1 - next;
+      if (symbol == kEOS)
+        return false;
+      out->push_back(static_cast<char>(symbol));
+      node = 0;
+      depth = 0;
+      ones = true;
+    }
+  }
+  return depth < 8 && ones;
+}
+
+
+void DynamicTable::Add(const Header& header) {
+  const size_t size = EntrySize(header);
+  // An entry that is larger than the table empties it (RFC 7541, 4.4).
+  if (size > max_size_) {
+    entries_.clear();
+    size_ = 0;
+    return;
+  }
+  Evict(max_size_ - size);
+  entries_.push_front(header);
+  size_ += size;
+}
+
+
+void DynamicTable::SetMaxSize(size_t max_size) {
+  max_size_ = max_size;
+  Evict(max_size);
+}
+
+
+void DynamicTable::Evict(size_t max_size) {
+  while (size_ > max_size) {
+    size_ -= EntrySize(entries_.back());
+    entries_.pop_back();
+  }
+}
+
+
+Encoder::Encoder(size_t max_table_size)
+    : table_(max_table_size),
+      limit_(max_table_size),
+      min_pending_size_(max_table_size),
+      size_update_pending_(false) {
+}
+
+
+void Encoder::SetMaxTableSize(size_t max_size) {
+  max_size = std::min(max_size, limit_);
+  if (max_size == table_.max_size() && !size_update_pending_)
+    return;
+  if (size_update_pending_)
+    min_pending_size_ = std::min(min_pending_size_, max_size);
+  else
+    min_pending_size_ = max_size;
+  size_update_pending_ = true;
+  table_.SetMaxSize(max_size);
+}
+
+
+void Encoder::Encode(const Headers& headers, std::string* out) {
+  // When the size went down and back up between two header blocks, the
+  // peer has to evict down to the smallest size first (RFC 7541, 4.2).
+  if (size_update_pending_) {
+    if (min_pending_size_ < table_.max_size())
+      EncodeInteger(min_pending_size_, 5, 0x20, out);
+    EncodeInteger(table_.max_size(), 5, 0x20, out);
+    size_update_pending_ = false;
+  }
+  for (const Header& header : headers)
+    EncodeHeader(header, out);
+}
+
+
+void Encoder::EncodeHeader(const Header& header, std::string* out) {
+  bool exact;
+  const size_t index = Find(header, &exact);
+  const bool sensitive = IsSensitive(header);
+  if (exact && !sensitive) {
+    EncodeInteger(index, 7, 0x80, out);
+    return;
+  }
+
+  // Entries that would take up more than half of the table are not worth
+  // the evictions.
+  const bool incremental = !sensitive && !IsUnindexed(header) &&
+                           EntrySize(header) <= table_.max_size() / 2;
+  if (incremental)
+    EncodeInteger(index, 6, 0x40, out);
+  else
+    EncodeInteger(index, 4, sensitive ? 0x10 : 0x00, out);
+  if (index == 0)
+    EncodeString(header.name, out);
+  EncodeString(header.value, out);
+  if (incremental)
+    table_.Add(header);
+}
+
+
+size_t Encoder::Find(const Header& header, bool* exact) const {
+  size_t name_index = 0;
+  *exact = false;
+  for (size_t i = 0; i < kStaticTableLength; i++) {
+    if (header.name != kStaticTable[i].name)
+      continue;
+    if (header.value == kStaticTable[i].value) {
+      *exact = true;
+      return i + 1;
+    }
+    if (name_index == 0)
+      name_index = i + 1;
+  }
+  for (size_t i = 0; i < table_.length(); i++) {
+    const Header* entry = table_.Get(i);
+    if (header.name != entry->name)
+      continue;
+    if (header.value == entry->value) {
+      *exact = true;
+      return kStaticTableLength + 1 + i;
+    }
+    if (name_index == 0)
+      name_index = kStaticTableLength + 1 + i;
+  }
+  return name_index;
+}
+
+
+Decoder::Decoder(size_t max_table_size)
+    : table_(max_table_size), limit_(max_table_size) {
+}
+
+
+bool Decoder::Lookup(uint64_t index, Header* header) const {
+  if (index == 0)
+    return false;
+  if (index <= kStaticTableLength) {
+    header->name = kStaticTable[index - 1].name;
+    header->value = kStaticTable[index - 1].value;
+    return true;
+  }
+  if (index - kStaticTableLength - 1 >= table_.length())
+    return false;
+  *header = *table_.Get(index - kStaticTableLength - 1);
+  return true;
+}
+
+
+bool Decoder::Decode(const uint8_t* data,
+                     size_t length,
+                     size_t max_list_size,
+                     Headers* headers,
+                     bool* too_large) {
+  const uint8_t* p = data;
+  const uint8_t* const end = data + length;
+  size_t list_size = 0;
+  bool seen_header = false;
+  *too_large = false;
+
+  while (p < end) {
+    const uint8_t first = *p;
+    Header header;
+    uint64_t index;
+    if ((first & 0x80) != 0) {
+      if (!DecodeInteger(&p, end, 7, &index) || !Lookup(index, &header))
+        return false;
+    } else if ((first & 0xe0) == 0x20) {
+      // Size updates only come at the start of a block.
+      if (seen_header || !DecodeInteger(&p, end, 5, &index) || index > limit_)
+        return false;
+      table_.SetMaxSize(index);
+      continue;
+    } else {
+      const bool incremental = (first & 0xc0) == 0x40;
+      if (!DecodeInteger(&p, end, incremental ? 6 : 4, &index))
+        return false;
+      if (index != 0) {
+        if (!Lookup(index, &header))
+          return false;
+      } else if (!DecodeString(&p, end, &header.name)) {
+        return false;
+      }
+      if (!DecodeString(&p, end, &header.value))
+        return false;
+      if (incremental)
+        table_.Add(header);
+    }
+
+    seen_header = true;
+    list_size += EntrySize(header);
+    if (list_size > max_list_size)
+      *too_large = true;
+    if (!*too_large)
+      headers->push_back(header);
+  }
+  return true;
+}
+
+}  // namespace hpack
+}  // namespace http2
+}  // namespace node
@@ -0,0 +1,132 @@
+#ifndef SRC_NODE_HTTP2_HPACK_H_
+#define SRC_NODE_HTTP2_HPACK_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace node {
+namespace http2 {
+
+struct Header {
+  Header() {}
+  Header(const std::string& name, const std::string& value)
+      : name(name), value(value) {}
+
+  std::string name;
+  std::string value;
+};
+
+typedef std::vector<Header> Headers;
+
+namespace hpack {
+
+// The size of a header table entry as RFC 7541 counts it: its name and value
+// plus 32 bytes of overhead.
+inline size_t EntrySize(const Header& header) {
+  return header.name.size() + header.value.size() + 32;
+}
+
+// The dynamic part of the header table. Entries are added at the front, and
+// the oldest ones are evicted from the back to stay within max_size().
+class DynamicTable {
+ public:
+  explicit DynamicTable(size_t max_size) : size_(0), max_size_(max_size) {}
+
+  // |index| counts from 0 for the newest entry.
+  const Header* Get(size_t index) const {
+    return index < entries_.size() ? &entries_[index] : nullptr;
+  }
+  size_t length() const { return entries_.size(); }
+  size_t size() const { return size_; }
+  size_t max_size() const { return max_size_; }
+
+  void Add(const Header& header);
+  void SetMaxSize(size_t max_size);
+
+ private:
+  void Evict(size_t max_size);
+
+  std::deque<Header> entries_;
+  size_t size_;
+  size_t max_size_;
+};
+
+// Turns header lists into header blocks. Values of the headers that are
+// likely to change with every message, or that carry credentials, are not
+// added to the dynamic table.
+class Encoder {
+ public:
+  explicit Encoder(size_t max_table_size = 4096);
+
+  // Called when the peer's SETTINGS_HEADER_TABLE_SIZE changes. The table
+  // never grows past the size that the encoder was created with; the next
+  // header block starts with the size updates that the peer must see.
+  void SetMaxTableSize(size_t max_size);
+
+  void Encode(const Headers& headers, std::string* out);
+
+ private:
+  void EncodeHeader(const Header& header, std::string* out);
+
+  // Returns the 1-based index of an entry that matches |header|, or of one
+  // that matches its name only. Sets |*exact| to tell the two apart.
+  size_t Find(const Header& header, bool* exact) const;
+
+  DynamicTable table_;
+  size_t limit_;
+  size_t min_pending_size_;
+  bool size_update_pending_;
+};
+
+// Turns header blocks into header lists. Any error in the encoding is fatal
+// to the connection, because the state of the two tables has diverged.
+class Decoder {
+ public:
+  explicit Decoder(size_t max_table_size = 4096);
+
+  // The largest table size that the peer is allowed to pick, which is what
+  // we sent as SETTINGS_HEADER_TABLE_SIZE.
+  void SetMaxTableSizeLimit(size_t limit) { limit_ = limit; }
+
+  // Decodes a complete header block and appends its headers to |headers|.
+  // The whole block is always decoded to keep the table in sync, but decoding
+  // stops appending once the header list grows past |max_list_size|, which
+  // is then reported through |*too_large|.
+  bool Decode(const uint8_t* data,
+              size_t length,
+              size_t max_list_size,
+              Headers* headers,
+              bool* too_large);
+
+ private:
+  bool Lookup(uint64_t index, Header* header) const;
+
+  DynamicTable table_;
+  size_t limit_;
+};
+
+// Integer and string primitives, exposed for testing.
+void EncodeInteger(uint64_t value, int prefix_bits, uint8_t first,
+                   std::string* out);
+bool DecodeInteger(const uint8_t** data, const uint8_t* end, int prefix_bits,
+                   uint64_t* value);
+void EncodeString(const std::string& value, std::string* out);
+bool DecodeString(const uint8_t** data, const uint8_t* end, std::string* out);
+
+size_t HuffmanEncodedLength(const std::string& value);
+void HuffmanEncode(const std::string& value, std::string* out);
+bool HuffmanDecode(const uint8_t* data, size_t length, std::string* out);
+
+}  // namespace hpack
+}  // namespace http2
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_HTTP2_HPACK_H_
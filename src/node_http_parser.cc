@@ -21,6 +21,7 @@
 
 #include "node.h"
 #include "node_buffer.h"
+#include "node_probes.h"
 
 #include "async-wrap.h"
 #include "async-wrap-inl.h"
@@ -33,8 +34,11 @@
 #include "util-inl.h"
 #include "v8.h"
 
+#include <limits.h>  // ULLONG_MAX
 #include <stdlib.h>  // free()
 #include <string.h>  // strdup()
+#include <string>
+#include <vector>
 
 // This is a binding to http_parser (https://github.com/nodejs/http-parser)
 // The goal is to decouple sockets from parsing for more javascript-level
@@ -61,8 +65,11 @@ using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
 using v8::Integer;
+using v8::Isolate;
 using v8::Local;
+using v8::NewStringType;
 using v8::Object;
+using v8::Persistent;
 using v8::String;
 using v8::Uint32;
 using v8::Undefined;
@@ -73,6 +80,81 @@ const uint32_t kOnHeadersComplete = 1;
 const uint32_t kOnBody = 2;
 const uint32_t kOnMessageComplete = 3;
 const uint32_t kOnExecute = 4;
+const uint32_t kOnMessages = 5;
+
+// The most requests that wait in a parser for kOnMessages.
+const uint32_t kMaxBatchedMessages = 64;
+
+// The header names that matchKnownFields() in lib/_http_incoming.js knows, in
+// the two spellings that it checks before lowercasing a name.
+#define HTTP_KNOWN_HEADERS(V)                                                 \
+  V("Content-Type", "content-type")                                           \
+  V("Content-Length", "content-length")                                       \
+  V("User-Agent", "user-agent")                                               \
+  V("Referer", "referer")                                                     \
+  V("Host", "host")                                                           \
+  V("Authorization", "authorization")                                         \
+  V("Proxy-Authorization", "proxy-authorization")                             \
+  V("If-Modified-Since", "if-modified-since")                                 \
+  V("If-Unmodified-Since", "if-unmodified-since")                             \
+  V("From", "from")                                                           \
+  V("Location", "location")                                                   \
+  V("Max-Forwards", "max-forwards")                                           \
+  V("Retry-After", "retry-after")                                             \
+  V("ETag", "etag")                                                           \
+  V("Last-Modified", "last-modified")                                         \
+  V("Server", "server")                                                       \
+  V("Age", "age")                                                             \
+  V("Expires", "expires")                                                     \
+  V("Set-Cookie", "set-cookie")                                               \
+  V("Cookie", "cookie")                                                       \
+  V("Transfer-Encoding", "transfer-encoding")                                 \
+  V("Date", "date")                                                           \
+  V("Connection", "connection")                                               \
+  V("Cache-Control", "cache-control")                                         \
+  V("Vary", "vary")                                                           \
+  V("Content-Encoding", "content-encoding")                                   \
+  V("Origin", "origin")                                                       \
+  V("Upgrade", "upgrade")                                                     \
+  V("Expect", "expect")                                                       \
+  V("If-Match", "if-match")                                                   \
+  V("If-None-Match", "if-none-match")                                         \
+  V("Accept", "accept")                                                       \
+  V("Accept-Encoding", "accept-encoding")                                     \
+  V("Accept-Language", "accept-language")                                     \
+  V("X-Forwarded-For", "x-forwarded-for")                                     \
+  V("X-Forwarded-Host", "x-forwarded-host")                                   \
+  V("X-Forwarded-Proto", "x-forwarded-proto")
+
+struct KnownHeader {
+  const char* name;
+  size_t length;
+};
+
+// Both spellings of header k are at 2 * k and 2 * k + 1.
+#define V(mixed, lower)                                                       \
+  { mixed, sizeof(mixed) - 1 },                                               \
+  { lower, sizeof(lower) - 1 },
+const KnownHeader kKnownHeaders[] = { HTTP_KNOWN_HEADERS(V) };
+#undef V
+
+
+int FindKnownHeader(const char* name, size_t length) {
+  for (size_t i = 0; i < arraysize(kKnownHeaders); i++) {
+    const KnownHeader& header = kKnownHeaders[i];
+    if (header.length == length && memcmp(header.name, name, length) == 0)
+      return i;
+  }
+  return -1;
+}
+
+// Room for header fields and values that a parser starts out with. It grows
+// as needed, so that all headers of a message are passed to JS land at once.
+const size_t kInitialHeaderCount = 32;
+
+// Values of known headers up to this length are kept and their strings reused
+// when the next message carries the same value.
+const size_t kMaxCachedValueLength = 256;
 
 
 #define HTTP_CB(name)                                                         \
@@ -92,15 +174,35 @@ const uint32_t kOnExecute = 4;
 
 
 // helper class for the Parser
+//
+// A header name or value that does not sit in one piece in the buffer that
+// is being parsed is copied to buf_. That storage is kept when the string is
+// reset, so a parser that is reused from the FreeList in lib/_http_common.js
+// does not allocate again for the headers of the next message.
 struct StringPtr {
-  StringPtr() {
+  StringPtr() : buf_(nullptr), capacity_(0) {
     on_heap_ = false;
     Reset();
   }
 
 
+  // Only moved when the Parser grows its header arrays, which leaves the
+  // source empty so that the copy on the heap has one owner.
+  StringPtr(StringPtr&& other)
+      : str_(other.str_),
+        on_heap_(other.on_heap_),
+        size_(other.size_),
+        buf_(other.buf_),
+        capacity_(other.capacity_) {
+    other.buf_ = nullptr;
+    other.capacity_ = 0;
+    other.on_heap_ = false;
+    other.Reset();
+  }
+
+
   ~StringPtr() {
-    Reset();
+    delete[] buf_;
   }
 
 
@@ -109,21 +211,24 @@ struct StringPtr {
   // to leak references. See issue #2438 and test-http-parser-bad-ref.js.
   void Save() {
     if (!on_heap_ && size_ > 0) {
-      char* s = new char[size_];
-      memcpy(s, str_, size_);
-      str_ = s;
+      Reserve(size_, 0);
+      memcpy(buf_, str_, size_);
+      str_ = buf_;
       on_heap_ = true;
     }
   }
 
 
   void Reset() {
-    if (on_heap_) {
-      delete[] str_;
-      on_heap_ = false;
+    // Don't hold on to the room that an unusually long string needed.
+    if (capacity_ > kMaxKeptCapacity) {
+      delete[] buf_;
+      buf_ = nullptr;
+      capacity_ = 0;
     }
 
     str_ = nullptr;
+    on_heap_ = false;
     size_ = 0;
   }
 
@@ -131,24 +236,38 @@ struct StringPtr {
   void Update(const char* str, size_t size) {
     if (str_ == nullptr) {
       str_ = str;
-    } else if (on_heap_ || str_ + size_ != str) {
+    } else if (on_heap_) {
+      Reserve(size_ + size, size_);
+      memcpy(buf_ + size_, str, size);
+      str_ = buf_;
+    } else if (str_ + size_ != str) {
       // Non-consecutive input, make a copy on the heap.
-      // TODO(bnoordhuis) Use slab allocation, O(n) allocs is bad.
-      char* s = new char[size_ + size];
-      memcpy(s, str_, size_);
-      memcpy(s + size_, str, size);
-
-      if (on_heap_)
-        delete[] str_;
-      else
-        on_heap_ = true;
-
-      str_ = s;
+      Reserve(size_ + size, 0);
+      memcpy(buf_, str_, size_);
+      memcpy(buf_ + size_, str, size);
+      str_ = buf_;
+      on_heap_ = true;
     }
     size_ += size;
   }
 
 
+  // Makes buf_ at least |size| bytes long, keeping its first |keep| bytes.
+  void Reserve(size_t size, size_t keep) {
+    if (size <= capacity_)
+      return;
+    size_t capacity = capacity_ > 0 ? capacity_ : kMinCapacity;
+    while (capacity < size)
+      capacity *= 2;
+    char* s = new char[capacity];
+    if (keep > 0)
+      memcpy(s, buf_, keep);
+    delete[] buf_;
+    buf_ = s;
+    capacity_ = capacity;
+  }
+
+
   Local<String> ToString(Environment* env) const {
     if (str_)
       return OneByteString(env->isolate(), str_, size_);
@@ -157,9 +276,18 @@ struct StringPtr {
   }
 
 
+  static const size_t kMinCapacity = 64;
+  static const size_t kMaxKeptCapacity = 512;
+
   const char* str_;
-  bool on_heap_;
+  bool on_heap_;  // Whether str_ points to buf_.
   size_t size_;
+  char* buf_;
+  size_t capacity_;
+
+  void operator=(const StringPtr&) = delete;
+  void operator=(StringPtr&&) = delete;
+  StringPtr(const StringPtr&) = delete;
 };
 
 
@@ -168,13 +296,20 @@ class Parser : public AsyncWrap {
   Parser(Environment* env, Local<Object> wrap, enum http_parser_type type)
       : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_HTTPPARSER),
         current_buffer_len_(0),
-        current_buffer_data_(nullptr) {
+        current_buffer_data_(nullptr),
+        batching_(false),
+        batch_length_(0),
+        batch_complete_(0) {
     Wrap(object(), this);
     Init(type);
   }
 
 
   ~Parser() override {
+    for (auto& name : known_names_)
+      name.Reset();
+    for (auto& value : known_values_)
+      value.string.Reset();
     ClearWrap(object());
     persistent().Reset();
   }
@@ -186,6 +321,8 @@ class Parser : public AsyncWrap {
 
 
   HTTP_CB(on_message_begin) {
+    if (NODE_HTTP_PARSER_BEGIN_ENABLED())
+      NODE_HTTP_PARSER_BEGIN(this, parser_.type);
     num_fields_ = num_values_ = 0;
     url_.Reset();
     status_message_.Reset();
@@ -209,16 +346,16 @@ class Parser : public AsyncWrap {
     if (num_fields_ == num_values_) {
       // start of new field name
       num_fields_++;
-      if (num_fields_ == arraysize(fields_)) {
-        // ran out of space - flush to javascript land
-        Flush();
-        num_fields_ = 1;
-        num_values_ = 0;
+      if (num_fields_ > fields_.size()) {
+        // Ran out of space. Rather than flushing what we have to JS land,
+        // make room for all of the headers so that they get there in one go.
+        fields_.resize(2 * fields_.size());
+        values_.resize(fields_.size());
       }
       fields_[num_fields_ - 1].Reset();
     }
 
-    CHECK_LT(num_fields_, arraysize(fields_));
+    CHECK_LE(num_fields_, fields_.size());
     CHECK_EQ(num_fields_, num_values_ + 1);
 
     fields_[num_fields_ - 1].Update(at, length);
@@ -234,7 +371,7 @@ class Parser : public AsyncWrap {
       values_[num_values_ - 1].Reset();
     }
 
-    CHECK_LT(num_values_, arraysize(values_));
+    CHECK_LE(num_values_, values_.size());
     CHECK_EQ(num_values_, num_fields_);
 
     values_[num_values_ - 1].Update(at, length);
@@ -243,23 +380,24 @@ class Parser : public AsyncWrap {
   }
 
 
-  HTTP_CB(on_headers_complete) {
-    // Arguments for the on-headers-complete javascript callback. This
-    // list needs to be kept in sync with the actual argument list for
-    // `parserOnHeadersComplete` in lib/_http_common.js.
-    enum on_headers_complete_arg_index {
-      A_VERSION_MAJOR = 0,
-      A_VERSION_MINOR,
-      A_HEADERS,
-      A_METHOD,
-      A_URL,
-      A_STATUS_CODE,
-      A_STATUS_MESSAGE,
-      A_UPGRADE,
-      A_SHOULD_KEEP_ALIVE,
-      A_MAX
-    };
+  // Arguments for the on-headers-complete javascript callback. This
+  // list needs to be kept in sync with the actual argument list for
+  // `parserOnHeadersComplete` in lib/_http_common.js.
+  enum on_headers_complete_arg_index {
+    A_VERSION_MAJOR = 0,
+    A_VERSION_MINOR,
+    A_HEADERS,
+    A_METHOD,
+    A_URL,
+    A_STATUS_CODE,
+    A_STATUS_MESSAGE,
+    A_UPGRADE,
+    A_SHOULD_KEEP_ALIVE,
+    A_MAX
+  };
+
 
+  HTTP_CB(on_headers_complete) {
     Local<Value> argv[A_MAX];
     Local<Object> obj = object();
     Local<Value> cb = obj->Get(kOnHeadersComplete);
@@ -271,15 +409,11 @@ class Parser : public AsyncWrap {
     for (size_t i = 0; i < arraysize(argv); i++)
       argv[i] = undefined;
 
-    if (have_flushed_) {
-      // Slow case, flush remaining headers.
-      Flush();
-    } else {
-      // Fast case, pass headers and URL to JS land.
-      argv[A_HEADERS] = CreateHeaders();
-      if (parser_.type == HTTP_REQUEST)
-        argv[A_URL] = url_.ToString(env());
-    }
+    // The header arrays grow as needed, so all headers and the URL get to
+    // JS land here, however many there are.
+    argv[A_HEADERS] = CreateHeaders();
+    if (parser_.type == HTTP_REQUEST)
+      argv[A_URL] = url_.ToString(env());
 
     num_fields_ = 0;
     num_values_ = 0;
@@ -306,6 +440,20 @@ class Parser : public AsyncWrap {
 
     argv[A_UPGRADE] = Boolean::New(env()->isolate(), parser_.upgrade);
 
+    if (CanBatch()) {
+      Local<Context> context = env()->context();
+      if (batch_.IsEmpty())
+        batch_ = Array::New(env()->isolate());
+      for (size_t i = 0; i < arraysize(argv); i++)
+        batch_->Set(context, batch_length_++, argv[i]).FromJust();
+      return 0;
+    }
+
+    // The requests before this one have to get to JS land first.
+    FlushBatch();
+    if (got_exception_)
+      return -1;
+
     Environment::AsyncCallbackScope callback_scope(env());
 
     Local<Value> head_response =
@@ -356,8 +504,18 @@ class Parser : public AsyncWrap {
 
 
   HTTP_CB(on_message_complete) {
+    if (NODE_HTTP_PARSER_COMPLETE_ENABLED())
+      NODE_HTTP_PARSER_COMPLETE(this, parser_.type);
     HandleScope scope(env()->isolate());
 
+    if (batch_length_ > batch_complete_) {
+      // The headers of this message wait in batch_, so it ends there, too.
+      batch_complete_ = batch_length_;
+      if (batch_complete_ == kMaxBatchedMessages * A_MAX)
+        FlushBatch();
+      return got_exception_ ? -1 : 0;
+    }
+
     if (num_fields_)
       Flush();  // Flush trailing HTTP headers.
 
@@ -498,6 +656,10 @@ class Parser : public AsyncWrap {
     StreamBase* stream = static_cast<StreamBase*>(stream_obj->Value());
     CHECK_NE(stream, nullptr);
 
+    // Any StreamBase works, be it a TCP or pipe handle, a TLSWrap or a
+    // JSStream, as long as nobody else took over its callbacks before.
+    if (stream->IsConsumed())
+      return args.GetReturnValue().Set(false);
     stream->Consume();
 
     parser->prev_alloc_cb_ = stream->alloc_cb();
@@ -505,6 +667,7 @@ class Parser : public AsyncWrap {
 
     stream->set_alloc_cb({ OnAllocImpl, parser });
     stream->set_read_cb({ OnReadImpl, parser });
+    args.GetReturnValue().Set(true);
   }
 
 
@@ -628,12 +791,20 @@ class Parser : public AsyncWrap {
     current_buffer_len_ = len;
     current_buffer_data_ = data;
     got_exception_ = false;
+    batching_ = object()->Get(kOnMessages)->IsFunction();
 
     size_t nparsed =
       http_parser_execute(&parser_, &settings, data, len);
 
     Save();
 
+    if (!got_exception_)
+      FlushBatch();
+    batch_.Clear();
+    batch_length_ = 0;
+    batch_complete_ = 0;
+    batching_ = false;
+
     // Unassign the 'buffer_' variable
     current_buffer_.Clear();
     current_buffer_len_ = 0;
@@ -669,8 +840,7 @@ class Parser : public AsyncWrap {
     do {
       size_t j = 0;
       while (i < num_values_ && j < arraysize(argv) / 2) {
-        argv[j * 2] = fields_[i].ToString(env());
-        argv[j * 2 + 1] = values_[i].ToString(env());
+        HeaderStrings(i, &argv[j * 2], &argv[j * 2 + 1]);
         i++;
         j++;
       }
@@ -683,7 +853,93 @@ class Parser : public AsyncWrap {
   }
 
 
-  // spill headers and request path to JS land
+  // The strings of known header names are made once, internalized, and the
+  // string of a known header's value is kept until a message comes with a
+  // different one. Parsers are reused across connections, so a server
+  // mostly hands out the same strings for the names and the values of
+  // headers like Host, Accept and User-Agent.
+  void HeaderStrings(size_t i, Local<Value>* name, Local<Value>* value) {
+    Isolate* isolate = env()->isolate();
+    const StringPtr& field = fields_[i];
+    const int known = FindKnownHeader(field.str_, field.size_);
+    if (known == -1) {
+      *name = field.ToString(env());
+      *value = values_[i].ToString(env());
+      return;
+    }
+
+    Persistent<String>& known_name = known_names_[known];
+    if (known_name.IsEmpty()) {
+      const KnownHeader& header = kKnownHeaders[known];
+      known_name.Reset(isolate,
+                       String::NewFromOneByte(
+                           isolate,
+                           reinterpret_cast<const uint8_t*>(header.name),
+                           NewStringType::kInternalized,
+                           header.length).ToLocalChecked());
+    }
+    *name = PersistentToLocal(isolate, known_name);
+
+    const StringPtr& data = values_[i];
+    CachedValue& cached = known_values_[known / 2];
+    if (data.size_ > 0 &&
+        data.size_ == cached.data.size() &&
+        memcmp(data.str_, cached.data.data(), data.size_) == 0) {
+      *value = PersistentToLocal(isolate, cached.string);
+      return;
+    }
+    Local<String> string = data.ToString(env());
+    if (data.size_ > 0 && data.size_ <= kMaxCachedValueLength) {
+      cached.data.assign(data.str_, data.size_);
+      cached.string.Reset(isolate, string);
+    }
+    *value = string;
+  }
+
+
+  // Pipelined requests without a body come in bunches. Rather than calling
+  // into JS land two times for each of them, the arguments of their
+  // onHeadersComplete calls are collected in batch_ until execute() is done
+  // with the buffer, or until a message comes that needs other callbacks.
+  bool CanBatch() const {
+    return batching_ &&
+           parser_.type == HTTP_REQUEST &&
+           !parser_.upgrade &&
+           !(parser_.flags & F_CHUNKED) &&
+           (parser_.content_length == 0 ||
+            parser_.content_length == ULLONG_MAX);
+  }
+
+
+  // kOnMessages gets the arguments that were collected in batch_ and the
+  // number of them that belong to complete messages. Only the headers of a
+  // message that ends in the next buffer can be among them, at its end.
+  void FlushBatch() {
+    if (batch_length_ == 0)
+      return;
+
+    Local<Value> argv[2] = {
+      batch_,
+      Integer::NewFromUnsigned(env()->isolate(), batch_complete_)
+    };
+    batch_.Clear();
+    batch_length_ = 0;
+    batch_complete_ = 0;
+
+    Local<Value> cb = object()->Get(kOnMessages);
+    if (!cb->IsFunction())
+      return;
+
+    Environment::AsyncCallbackScope callback_scope(env());
+
+    Local<Value> r = MakeCallback(cb.As<Function>(), arraysize(argv), argv);
+
+    if (r.IsEmpty())
+      got_exception_ = true;
+  }
+
+
+  // spill trailing headers to JS land
   void Flush() {
     HandleScope scope(env()->isolate());
 
@@ -704,33 +960,46 @@ class Parser : public AsyncWrap {
       got_exception_ = true;
 
     url_.Reset();
-    have_flushed_ = true;
   }
 
 
   void Init(enum http_parser_type type) {
     http_parser_init(&parser_, type);
+    // Parsers are reused, don't hold on to the room that a request with
+    // a lot of headers needed.
+    if (fields_.size() != kInitialHeaderCount) {
+      std::vector<StringPtr>(kInitialHeaderCount).swap(fields_);
+      std::vector<StringPtr>(kInitialHeaderCount).swap(values_);
+    }
     url_.Reset();
     status_message_.Reset();
     num_fields_ = 0;
     num_values_ = 0;
-    have_flushed_ = false;
     got_exception_ = false;
   }
 
 
   http_parser parser_;
-  StringPtr fields_[32];  // header fields
-  StringPtr values_[32];  // header values
+  std::vector<StringPtr> fields_;  // header fields
+  std::vector<StringPtr> values_;  // header values
+  struct CachedValue {
+    std::string data;
+    Persistent<String> string;
+  };
+  Persistent<String> known_names_[arraysize(kKnownHeaders)];
+  CachedValue known_values_[arraysize(kKnownHeaders) / 2];
   StringPtr url_;
   StringPtr status_message_;
   size_t num_fields_;
   size_t num_values_;
-  bool have_flushed_;
   bool got_exception_;
   Local<Object> current_buffer_;
   size_t current_buffer_len_;
   char* current_buffer_data_;
+  bool batching_;
+  Local<Array> batch_;
+  uint32_t batch_length_;
+  uint32_t batch_complete_;
   StreamResource::Callback<StreamResource::AllocCb> prev_alloc_cb_;
   StreamResource::Callback<StreamResource::ReadCb> prev_read_cb_;
   int refcount_ = 1;
@@ -754,6 +1023,152 @@ const struct http_parser_settings Parser::settings = {
 };
 
 
+// Mirror validTokens and validHdrChars in lib/_http_common.js.
+const uint8_t kValidTokenChars[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 1, 0, 1, 1, 1, 1, 1, 0, 0, 1, 1, 0, 1, 1, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 1, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+const uint8_t kValidHeaderChars[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+
+bool IsOneByteString(Local<String> string) {
+  return string->IsOneByte() || string->ContainsOnlyOneByte();
+}
+
+
+size_t WriteOneByte(Local<String> string, char* out) {
+  return string->WriteOneByte(reinterpret_cast<uint8_t*>(out),
+                              0,
+                              -1,
+                              String::NO_NULL_TERMINATION);
+}
+
+
+// serializeHeaders(firstLine, headers, validated) returns the head of a
+// message as one flat one-byte string: |firstLine|, a line for each name and
+// value pair in the flat |headers| array, and an empty line. The first
+// |validated| pairs must be HTTP tokens and field values, the values of the
+// others get CR and LF removed like escapeHeaderValue() does. Returns
+// undefined when a check fails or a string is not one-byte, and leaves it to
+// lib/_http_outgoing.js to build the string, or to throw the right error.
+void SerializeHeaders(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsUint32());
+
+  Local<String> first_line = args[0].As<String>();
+  Local<Array> headers = args[1].As<Array>();
+  const uint32_t count = headers->Length();
+  const uint32_t validated = args[2]->Uint32Value();
+  CHECK_EQ(count % 2, 0);
+
+  if (!IsOneByteString(first_line))
+    return;
+  size_t length = first_line->Length() + 2;
+  MaybeStackBuffer<Local<String>, 64> strings(count);
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> value;
+    if (!headers->Get(env->context(), i).ToLocal(&value))
+      return;
+    if (!value->IsString() || !IsOneByteString(value.As<String>()))
+      return;
+    strings[i] = value.As<String>();
+    length += strings[i]->Length() + 2;  // ": " or CRLF
+  }
+
+  MaybeStackBuffer<char, 2048> storage(length);
+  char* const out = *storage;
+  size_t pos = WriteOneByte(first_line, out);
+
+  for (uint32_t i = 0; i < count / 2; i++) {
+    char* name = out + pos;
+    const size_t name_length = WriteOneByte(strings[2 * i], name);
+    pos += name_length;
+    out[pos++] = ':';
+    out[pos++] = ' ';
+
+    uint8_t* value = reinterpret_cast<uint8_t*>(out + pos);
+    size_t value_length = WriteOneByte(strings[2 * i + 1], out + pos);
+
+    if (i < validated) {
+      if (name_length == 0)
+        return;
+      for (size_t k = 0; k < name_length; k++) {
+        if (!kValidTokenChars[static_cast<uint8_t>(name[k])])
+          return;
+      }
+      for (size_t k = 0; k < value_length; k++) {
+        if (!kValidHeaderChars[value[k]])
+          return;
+      }
+    } else {
+      // Protect against response splitting by dropping runs of CR and LF,
+      // and the spaces and tabs that follow them.
+      size_t w = 0;
+      for (size_t r = 0; r < value_length;) {
+        if (value[r] == '\r' || value[r] == '\n') {
+          while (r < value_length && (value[r] == '\r' || value[r] == '\n'))
+            r++;
+          while (r < value_length && (value[r] == ' ' || value[r] == '\t'))
+            r++;
+        } else {
+          value[w++] = value[r++];
+        }
+      }
+      value_length = w;
+    }
+
+    pos += value_length;
+    out[pos++] = '\r';
+    out[pos++] = '\n';
+  }
+  out[pos++] = '\r';
+  out[pos++] = '\n';
+  CHECK_LE(pos, length);
+
+  Local<String> result;
+  if (String::NewFromOneByte(env->isolate(),
+                             reinterpret_cast<uint8_t*>(out),
+                             NewStringType::kNormal,
+                             pos).ToLocal(&result)) {
+    args.GetReturnValue().Set(result);
+  }
+}
+
+
 void InitHttpParser(Local<Object> target,
                     Local<Value> unused,
                     Local<Context> context,
@@ -777,6 +1192,8 @@ void InitHttpParser(Local<Object> target,
          Integer::NewFromUnsigned(env->isolate(), kOnMessageComplete));
   t->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "kOnExecute"),
          Integer::NewFromUnsigned(env->isolate(), kOnExecute));
+  t->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "kOnMessages"),
+         Integer::NewFromUnsigned(env->isolate(), kOnMessages));
 
   Local<Array> methods = Array::New(env->isolate());
 #define V(num, name, string)                                                  \
@@ -784,6 +1201,7 @@ void InitHttpParser(Local<Object> target,
   HTTP_METHOD_MAP(V)
 #undef V
   target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "methods"), methods);
+  env->SetMethod(target, "serializeHeaders", SerializeHeaders);
 
   env->SetProtoMethod(t, "close", Parser::Close);
   env->SetProtoMethod(t, "execute", Parser::Execute);
@@ -46,6 +46,8 @@
 
 #include "node.h"
 #include "node_buffer.h"
+#include "base-object.h"
+#include "base-object-inl.h"
 #include "env.h"
 #include "env-inl.h"
 #include "util.h"
@@ -85,6 +87,7 @@ namespace node {
 
 using v8::Context;
 using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
 using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
@@ -354,6 +357,125 @@ void ICUErrorName(const FunctionCallbackInfo<Value>& args) {
                           v8::NewStringType::kNormal).ToLocalChecked());
 }
 
+// Transcodes input that comes in chunks. The converters are opened once, and
+// the state of a character that a chunk ends in the middle of is kept for
+// the next chunk.
+class Transcoder : public BaseObject {
+ public:
+  ~Transcoder() override {
+    Close();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    new Transcoder(env, args.This());
+  }
+
+  // open(fromEncoding, toEncoding) takes ICU converter names. Returns 0, or
+  // the ICU error code if a converter is not available.
+  static void Open(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    Transcoder* transcoder;
+    ASSIGN_OR_RETURN_UNWRAP(&transcoder, args.Holder());
+    CHECK(args[0]->IsString());
+    CHECK(args[1]->IsString());
+    CHECK_EQ(transcoder->from_, nullptr);
+
+    node::Utf8Value from(env->isolate(), args[0]);
+    node::Utf8Value to(env->isolate(), args[1]);
+    UErrorCode status = U_ZERO_ERROR;
+    transcoder->from_ = ucnv_open(*from, &status);
+    if (U_SUCCESS(status))
+      transcoder->to_ = ucnv_open(*to, &status);
+    if (U_SUCCESS(status))
+      ucnv_setSubstChars(transcoder->to_, "?", 1, &status);
+    if (U_FAILURE(status)) {
+      transcoder->Close();
+      return args.GetReturnValue().Set(status);
+    }
+    args.GetReturnValue().Set(0);
+  }
+
+  // convert(chunk, flush) returns a Buffer with what the chunk converts to,
+  // or the ICU error code. With flush, the rest of the input is converted
+  // and the transcoder starts over with the next chunk.
+  static void Convert(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    Transcoder* transcoder;
+    ASSIGN_OR_RETURN_UNWRAP(&transcoder, args.Holder());
+    CHECK_NE(transcoder->from_, nullptr);
+    THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+    SPREAD_BUFFER_ARG(args[0], chunk);
+    const bool flush = args[1]->IsTrue();
+
+    const char* source = chunk_data;
+    const char* source_limit = chunk_data + chunk_length;
+    MaybeStackBuffer<char> result(
+        (chunk_length + kPivotSize) * ucnv_getMaxCharSize(transcoder->to_));
+    char* target = *result;
+    UErrorCode status;
+    for (;;) {
+      status = U_ZERO_ERROR;
+      ucnv_convertEx(transcoder->to_, transcoder->from_,
+                     &target, *result + result.length(),
+                     &source, source_limit,
+                     transcoder->pivot_,
+                     &transcoder->pivot_source_,
+                     &transcoder->pivot_target_,
+                     transcoder->pivot_ + kPivotSize,
+                     transcoder->reset_, flush, &status);
+      transcoder->reset_ = false;
+      if (status != U_BUFFER_OVERFLOW_ERROR)
+        break;
+      const size_t used = target - *result;
+      result.SetLength(used);
+      result.AllocateSufficientStorage(2 * used);
+      target = *result + used;
+    }
+
+    if (flush || U_FAILURE(status))
+      transcoder->reset_ = true;
+    if (U_FAILURE(status))
+      return args.GetReturnValue().Set(status);
+
+    result.SetLength(target - *result);
+    Local<Object> buffer;
+    if (Buffer::New(env, &result).ToLocal(&buffer))
+      args.GetReturnValue().Set(buffer);
+  }
+
+ private:
+  static const size_t kPivotSize = 1024;
+
+  Transcoder(Environment* env, Local<Object> wrap)
+      : BaseObject(env, wrap),
+        from_(nullptr),
+        to_(nullptr),
+        pivot_source_(pivot_),
+        pivot_target_(pivot_),
+        reset_(true) {
+    MakeWeak<Transcoder>(this);
+  }
+
+  void Close() {
+    if (from_ != nullptr)
+      ucnv_close(from_);
+    if (to_ != nullptr)
+      ucnv_close(to_);
+    from_ = nullptr;
+    to_ = nullptr;
+  }
+
+  UConverter* from_;
+  UConverter* to_;
+  // Text that |from_| has turned into UTF-16 and |to_| is yet to convert.
+  UChar pivot_[kPivotSize];
+  UChar* pivot_source_;
+  UChar* pivot_target_;
+  bool reset_;
+};
+
 #define TYPE_ICU "icu"
 #define TYPE_UNICODE "unicode"
 #define TYPE_CLDR "cldr"
@@ -595,6 +717,25 @@ static int GetColumnWidth(UChar32 codepoint,
   }
 }
 
+// Column widths of BMP code points, looked up with GetColumnWidth() the first
+// time each one is seen. Bit 7 is set once an entry is filled in. Bits 0-1
+// hold the width, bits 2-3 the width with ambiguous characters counted as
+// full width.
+static uint8_t bmp_column_widths[0x10000];
+
+static inline int GetBMPColumnWidth(uint16_t ch,
+                                    bool ambiguous_as_full_width) {
+  // Printable ASCII takes one column, ASCII control characters none.
+  if (ch < 0x80)
+    return ch >= 0x20 && ch != 0x7f ? 1 : 0;
+  uint8_t entry = bmp_column_widths[ch];
+  if (entry == 0) {
+    entry = 0x80 | GetColumnWidth(ch, false) | (GetColumnWidth(ch, true) << 2);
+    bmp_column_widths[ch] = entry;
+  }
+  return ambiguous_as_full_width ? (entry >> 2) & 3 : entry & 3;
+}
+
 // Returns the column width for the given String.
 static void GetStringWidth(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -611,6 +752,19 @@ static void GetStringWidth(const FunctionCallbackInfo<Value>& args) {
     return;
   }
 
+  // Latin-1 has no emoji sequences or characters outside the BMP.
+  if (args[0]->IsString() && args[0].As<String>()->IsOneByte()) {
+    Local<String> string = args[0].As<String>();
+    const int length = string->Length();
+    MaybeStackBuffer<uint8_t> value(length);
+    string->WriteOneByte(value.out(), 0, length, String::NO_NULL_TERMINATION);
+    uint32_t width = 0;
+    for (int n = 0; n < length; n++)
+      width += GetBMPColumnWidth(value[n], ambiguous_as_full_width);
+    args.GetReturnValue().Set(width);
+    return;
+  }
+
   TwoByteValue value(env->isolate(), args[0]);
   // reinterpret_cast is required by windows to compile
   UChar* str = reinterpret_cast<UChar*>(*value);
@@ -640,7 +794,10 @@ static void GetStringWidth(const FunctionCallbackInfo<Value>& args) {
          u_hasBinaryProperty(c, UCHAR_EMOJI_MODIFIER))) {
       continue;
     }
-    width += GetColumnWidth(c, ambiguous_as_full_width);
+    if (c <= 0xffff)
+      width += GetBMPColumnWidth(c, ambiguous_as_full_width);
+    else
+      width += GetColumnWidth(c, ambiguous_as_full_width);
   }
   args.GetReturnValue().Set(width);
 }
@@ -658,6 +815,14 @@ void Init(Local<Object> target,
   // One-shot converters
   env->SetMethod(target, "icuErrName", ICUErrorName);
   env->SetMethod(target, "transcode", Transcode);
+
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(Transcoder::New);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(t, "open", Transcoder::Open);
+  env->SetProtoMethod(t, "convert", Transcoder::Convert);
+  t->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "Transcoder"));
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "Transcoder"),
+              t->GetFunction());
 }
 
 }  // namespace i18n
@@ -25,6 +25,7 @@
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
 #include "node.h"
+#include "buffer_arena.h"
 #include "util.h"
 #include "util-inl.h"
 #include "uv.h"
@@ -34,6 +35,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <memory>
 #include <string>
 
 struct sockaddr;
@@ -56,6 +58,10 @@ struct sockaddr;
 
 namespace node {
 
+namespace tracing {
+class Agent;
+}  // namespace tracing
+
 // Set in node.cc by ParseArgs with the value of --openssl-config.
 // Used in node_crypto.cc when initializing OpenSSL.
 extern std::string openssl_config;
@@ -65,6 +71,10 @@ extern std::string openssl_config;
 // that is used by lib/module.js
 extern bool config_preserve_symlinks;
 
+// Set in node.cc by ParseArgs when --module-resolution-cache is used.
+// Used in node_file.cc to cache the lookups done by lib/module.js.
+extern bool config_module_resolution_cache;
+
 // Set in node.cc by ParseArgs when --expose-internals or --expose_internals is
 // used.
 // Used in node_config.cc to set a constant on process.binding('config')
@@ -76,6 +86,38 @@ extern bool config_expose_internals;
 // it to stderr.
 extern std::string config_warning_file;  // NOLINT(runtime/string)
 
+// Set in node.cc by ParseArgs when --compile-cache= is used, or from
+// NODE_COMPILE_CACHE. lib/internal/compile_cache.js keeps the code caches of
+// the modules that lib/module.js compiles in there.
+extern std::string config_compile_cache_dir;  // NOLINT(runtime/string)
+
+// Set in node.cc by ParseArgs when --app-archive= is used.
+// lib/internal/app_archive.js maps the archive, and lib/module.js loads the
+// modules under its path out of it.
+extern std::string config_app_archive;  // NOLINT(runtime/string)
+
+// Set in node.cc by ParseArgs when --resolution-cache= is used, or from
+// NODE_RESOLUTION_CACHE, and when --build-resolution-cache= is used.
+// lib/internal/resolution_cache.js loads and writes the resolutions of
+// lib/module.js in these files.
+extern std::string config_resolution_cache;  // NOLINT(runtime/string)
+extern std::string config_build_resolution_cache;  // NOLINT(runtime/string)
+
+// Set in node.cc by ParseArgs when --immediate-budget= is used.
+// lib/timers.js runs at most this many setImmediate() callbacks per event
+// loop iteration, 0 meaning all of those that were queued before it.
+extern unsigned int config_immediate_budget;
+
+// Set in node.cc by ParseArgs when --heapsnapshot-signal= is used.
+// lib/internal/process.js writes a heap snapshot with
+// v8.writeHeapSnapshot() whenever the process receives this signal.
+extern std::string config_heap_snapshot_signal;  // NOLINT(runtime/string)
+
+// Set in node.cc by ParseArgs when --stdio-buffer= is used.
+// lib/internal/process/stdio.js writes stdout and stderr through a
+// StdioWriter with this overflow policy if they are TTYs or pipes.
+extern std::string config_stdio_buffer;  // NOLINT(runtime/string)
+
 // Tells whether it is safe to call v8::Isolate::GetCurrent().
 extern bool v8_initialized;
 
@@ -143,6 +185,10 @@ void RegisterSignalHandler(int signal,
 
 bool SafeGetenv(const char* key, std::string* text);
 
+// The agent that records trace events, or nullptr if Node.js was built
+// without NODE_USE_V8_PLATFORM.
+tracing::Agent* GetTracingAgent();
+
 template <typename T, size_t N>
 constexpr size_t arraysize(const T(&)[N]) { return N; }
 
@@ -204,20 +250,49 @@ class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
  public:
   inline uint32_t* zero_fill_field() { return &zero_fill_field_; }
 
-  virtual void* Allocate(size_t size);  // Defined in src/node.cc
-  virtual void* AllocateUninitialized(size_t size)
-    { return node::UncheckedMalloc(size); }
-  virtual void Free(void* data, size_t) { free(data); }
+  // Defined in src/node.cc
+  virtual void* Allocate(size_t size);
+  virtual void* AllocateUninitialized(size_t size);
+  virtual void Free(void* data, size_t);
+
+  // Returns memory that free() releases with the contents of |data|, which
+  // this allocator handed out for |size| bytes, for giving it to another
+  // isolate. Returns nullptr if there is no memory left, and |data| is then
+  // still valid.
+  void* Release(void* data, size_t size);
+
+  // The arena, for memory that may outlive this allocator because other
+  // isolates share it.
+  std::shared_ptr<BufferArena> arena() const { return arena_; }
 
  private:
   uint32_t zero_fill_field_ = 1;  // Boolean but exposed as uint32 to JS land.
+  // Backing stores of up to BufferArena::kMaxSize bytes come from here, the
+  // others from malloc(). Free() tells them apart, so it also frees memory
+  // that was allocated with malloc() and handed to V8.
+  std::shared_ptr<BufferArena> arena_ = std::make_shared<BufferArena>();
 };
 
+// Returns a new isolate with the callbacks that node sets on its isolates,
+// or nullptr if V8 could not create one.
+v8::Isolate* NewIsolate(ArrayBufferAllocator* allocator);
+
+// Runs the event loop of |env|, emitting 'beforeExit' whenever it runs out of
+// work, until it stays empty or |env| is a Worker that is stopping.
+void SpinEventLoop(Environment* env);
+
+// Makes |env| the Environment that AtExit() without one uses on this thread.
+void SetThreadLocalEnvironment(Environment* env);
+
 // Clear any domain and/or uncaughtException handlers to force the error's
 // propagation and shutdown the process. Use this to force the process to exit
 // by clearing all callbacks that could handle the error.
 void ClearFatalExceptionHandlers(Environment* env);
 
+// Runs the microtasks and the nextTick queue once the outermost MakeCallback()
+// of |env| is done. Returns false if the tick callback threw.
+bool TickAfterCallback(Environment* env);
+
 namespace Buffer {
 v8::MaybeLocal<v8::Object> Copy(Environment* env, const char* data, size_t len);
 v8::MaybeLocal<v8::Object> New(Environment* env, size_t size);
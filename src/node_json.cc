@@ -0,0 +1,303 @@
+#include "node.h"
+#include "node_buffer.h"
+#include "node_json_parser.h"
+#include "node_threadpool.h"
+
+#include "async-wrap.h"
+#include "async-wrap-inl.h"
+#include "env.h"
+#include "env-inl.h"
+#include "util.h"
+#include "util-inl.h"
+#include "v8.h"
+
+namespace node {
+namespace json {
+
+using v8::Array;
+using v8::Context;
+using v8::EscapableHandleScope;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::MaybeLocal;
+using v8::NewStringType;
+using v8::Null;
+using v8::Number;
+using v8::Object;
+using v8::String;
+using v8::TryCatch;
+using v8::Value;
+
+namespace {
+
+// Turns the tape of a parser into JS values. Keys are internalized, as they
+// tend to repeat across the objects of a document.
+class Materializer {
+ public:
+  Materializer(Environment* env, const Parser& parser)
+      : env_(env),
+        isolate_(env->isolate()),
+        context_(env->context()),
+        tokens_(parser.tokens()),
+        one_byte_strings_(parser.one_byte_strings()),
+        two_byte_strings_(parser.two_byte_strings()),
+        index_(0) {}
+
+  MaybeLocal<Array> Values(size_t count) {
+    EscapableHandleScope scope(isolate_);
+    Local<Array> values = Array::New(isolate_, count);
+    for (uint32_t i = 0; i < count; i++) {
+      Local<Value> value;
+      if (!Next().ToLocal(&value) ||
+          values->CreateDataProperty(context_, i, value).IsNothing()) {
+        return MaybeLocal<Array>();
+      }
+    }
+    return scope.Escape(values);
+  }
+
+ private:
+  MaybeLocal<Value> Next() {
+    const Token& token = tokens_[index_++];
+    switch (token.type) {
+      case Token::kNull:
+        return Null(isolate_);
+      case Token::kFalse:
+        return v8::False(isolate_);
+      case Token::kTrue:
+        return v8::True(isolate_);
+      case Token::kNumber:
+        return Number::New(isolate_, token.number);
+      case Token::kOneByteString:
+      case Token::kTwoByteString:
+        return MakeString(token, NewStringType::kNormal);
+      case Token::kArray:
+        return MakeArray(token.length);
+      case Token::kObject:
+        return MakeObject(token.length);
+    }
+    UNREACHABLE();
+  }
+
+  MaybeLocal<Value> MakeString(const Token& token, NewStringType type) {
+    MaybeLocal<String> string;
+    if (token.type == Token::kOneByteString) {
+      string = String::NewFromOneByte(
+          isolate_,
+          reinterpret_cast<const uint8_t*>(&one_byte_strings_[token.offset]),
+          type,
+          token.length);
+    } else {
+      string = String::NewFromTwoByte(isolate_,
+                                      &two_byte_strings_[token.offset],
+                                      type,
+                                      token.length);
+    }
+    if (string.IsEmpty()) {
+      env_->ThrowRangeError("Cannot create a string as long as one in the "
+                            "JSON input");
+      return MaybeLocal<Value>();
+    }
+    return string.ToLocalChecked();
+  }
+
+  MaybeLocal<Value> MakeArray(uint32_t length) {
+    EscapableHandleScope scope(isolate_);
+    Local<Array> array = Array::New(isolate_, length);
+    for (uint32_t i = 0; i < length; i++) {
+      Local<Value> value;
+      if (!Next().ToLocal(&value) ||
+          array->CreateDataProperty(context_, i, value).IsNothing()) {
+        return MaybeLocal<Value>();
+      }
+    }
+    return scope.Escape(array);
+  }
+
+  MaybeLocal<Value> MakeObject(uint32_t length) {
+    EscapableHandleScope scope(isolate_);
+    Local<Object> object = Object::New(isolate_);
+    for (uint32_t i = 0; i < length; i++) {
+      const Token& key_token = tokens_[index_++];
+      Local<Value> key;
+      Local<Value> value;
+      // Like JSON.parse(), the last of several properties of the same name
+      // wins, and __proto__ is an own property like any other.
+      if (!MakeString(key_token, NewStringType::kInternalized).ToLocal(&key) ||
+          !Next().ToLocal(&value) ||
+          object->CreateDataProperty(context_, key.As<String>(), value)
+              .IsNothing()) {
+        return MaybeLocal<Value>();
+      }
+    }
+    return scope.Escape(object);
+  }
+
+  Environment* const env_;
+  Isolate* const isolate_;
+  Local<Context> context_;
+  const std::vector<Token>& tokens_;
+  const std::string& one_byte_strings_;
+  const std::vector<uint16_t>& two_byte_strings_;
+  size_t index_;
+};
+
+
+/**
+ * Parses JSON text on the thread pool, a chunk at a time. The values that
+ * each chunk completes are turned into JS values on the loop thread.
+ */
+class JSONParser : public AsyncWrap {
+ public:
+  JSONParser(Environment* env,
+             Local<Object> wrap,
+             Parser::Mode mode,
+             size_t max_depth)
+      : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_JSONPARSER),
+        parser_(mode, max_depth),
+        data_(nullptr),
+        length_(0),
+        end_(false),
+        ok_(true),
+        in_progress_(false) {
+    MakeWeak<JSONParser>(this);
+  }
+
+  ~JSONParser() override {
+    CHECK_EQ(false, in_progress_ && "parse in progress");
+  }
+
+  // new JSONParser(mode, maxDepth)
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    CHECK(args[0]->IsInt32());
+    CHECK(args[1]->IsUint32());
+    const int32_t mode = args[0]->Int32Value();
+    CHECK(mode >= Parser::kValue && mode <= Parser::kElements);
+    new JSONParser(env,
+                   args.This(),
+                   static_cast<Parser::Mode>(mode),
+                   args[1]->Uint32Value());
+  }
+
+  // write(buffer, end)
+  // The caller keeps |buffer| alive until oncomplete(values) or
+  // onerror(error) is called. |error| is the message of a syntax error, or
+  // an exception. |buffer| can be undefined.
+  static void Write(const FunctionCallbackInfo<Value>& args) {
+    JSONParser* parser;
+    ASSIGN_OR_RETURN_UNWRAP(&parser, args.Holder());
+    CHECK_EQ(false, parser->in_progress_ && "write already in progress");
+
+    if (args[0]->IsUndefined()) {
+      parser->data_ = nullptr;
+      parser->length_ = 0;
+    } else {
+      CHECK(Buffer::HasInstance(args[0]));
+      parser->data_ = Buffer::Data(args[0]);
+      parser->length_ = Buffer::Length(args[0]);
+    }
+    parser->end_ = args[1]->IsTrue();
+
+    parser->in_progress_ = true;
+    parser->ClearWeak();
+    threadpool::QueueWork(parser->env()->event_loop(),
+                          &parser->work_req_,
+                          threadpool::kCpuWork,
+                          threadpool::kNormalPriority,
+                          JSONParser::Process,
+                          JSONParser::After,
+                          NODE_THREADPOOL_TRACE_JSON,
+                          "json.parse");
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  // thread pool!
+  static void Process(uv_work_t* work_req) {
+    JSONParser* parser = ContainerOf(&JSONParser::work_req_, work_req);
+    parser->ok_ = parser->parser_.Write(parser->data_, parser->length_) &&
+                  (!parser->end_ || parser->parser_.End());
+  }
+
+  // v8 land!
+  static void After(uv_work_t* work_req, int status) {
+    CHECK_EQ(status, 0);
+
+    JSONParser* parser = ContainerOf(&JSONParser::work_req_, work_req);
+    Environment* env = parser->env();
+
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    parser->in_progress_ = false;
+    parser->MakeWeak<JSONParser>(parser);
+    parser->data_ = nullptr;
+
+    if (!parser->ok_) {
+      const std::string& message = parser->parser_.error();
+      Local<Value> error =
+          String::NewFromUtf8(env->isolate(), message.data(),
+                              NewStringType::kNormal,
+                              message.size()).ToLocalChecked();
+      parser->MakeCallback(env->onerror_string(), 1, &error);
+      return;
+    }
+
+    Local<Array> values;
+    TryCatch try_catch(env->isolate());
+    Materializer materializer(env, parser->parser_);
+    if (!materializer.Values(parser->parser_.value_count()).ToLocal(&values)) {
+      parser->parser_.ClearValues();
+      Local<Value> error = try_catch.Exception();
+      try_catch.Reset();
+      parser->MakeCallback(env->onerror_string(), 1, &error);
+      return;
+    }
+    parser->parser_.ClearValues();
+    Local<Value> arg = values;
+    parser->MakeCallback(env->oncomplete_string(), 1, &arg);
+  }
+
+  Parser parser_;
+  const char* data_;
+  size_t length_;
+  bool end_;
+  bool ok_;
+  uv_work_t work_req_;
+  bool in_progress_;
+};
+
+
+void Initialize(Local<Object> target,
+                Local<Value> unused,
+                Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  Isolate* isolate = env->isolate();
+
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(JSONParser::New);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  t->SetClassName(FIXED_ONE_BYTE_STRING(isolate, "JSONParser"));
+  env->SetProtoMethod(t, "write", JSONParser::Write);
+
+#define V(name, value)                                                        \
+  t->Set(FIXED_ONE_BYTE_STRING(isolate, #name), Integer::New(isolate, value));
+  V(VALUE, Parser::kValue)
+  V(SEQUENCE, Parser::kSequence)
+  V(ELEMENTS, Parser::kElements)
+#undef V
+
+  target->Set(FIXED_ONE_BYTE_STRING(isolate, "JSONParser"), t->GetFunction());
+}
+
+}  // anonymous namespace
+}  // namespace json
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(json, node::json::Initialize)
@@ -0,0 +1,571 @@
+#include "node_json_parser.h"
+
+#include <stdlib.h>
+
+namespace node {
+namespace json {
+
+namespace {
+
+const char kUnexpectedEnd[] = "Unexpected end of JSON input";
+const uint16_t kReplacementCharacter = 0xfffd;
+
+inline bool IsWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+inline int HexValue(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+// How many bytes the UTF-8 sequence that |lead| starts has, for quoting it
+// in error messages.
+inline size_t SequenceLength(unsigned char lead) {
+  if (lead >= 0xf0)
+    return 4;
+  if (lead >= 0xe0)
+    return 3;
+  if (lead >= 0xc0)
+    return 2;
+  return 1;
+}
+
+}  // anonymous namespace
+
+
+Parser::Parser(Mode mode, size_t max_depth)
+    : mode_(mode),
+      max_depth_(max_depth),
+      input_offset_(0),
+      incomplete_length_(0),
+      elements_state_(kBeforeArray),
+      value_seen_(false),
+      value_count_(0),
+      failed_(false) {}
+
+
+bool Parser::Write(const char* data, size_t length) {
+  if (failed_)
+    return false;
+  input_.append(data, length);
+  // Not worth another attempt at the incomplete value yet.
+  if (input_.size() < 2 * incomplete_length_)
+    return true;
+  return Parse(false);
+}
+
+
+bool Parser::End() {
+  if (failed_)
+    return false;
+  if (!Parse(true))
+    return false;
+  if ((mode_ == kValue && !value_seen_) ||
+      (mode_ == kElements && elements_state_ != kAfterArray)) {
+    Fail(kUnexpectedEnd);
+    return false;
+  }
+  return true;
+}
+
+
+void Parser::ClearValues() {
+  tokens_.clear();
+  value_count_ = 0;
+  one_byte_strings_.clear();
+  two_byte_strings_.clear();
+}
+
+
+bool Parser::Parse(bool end) {
+  size_t pos = 0;
+  Result result;
+  for (;;) {
+    const size_t start = pos;
+    const size_t token_count = tokens_.size();
+    const size_t one_byte_length = one_byte_strings_.size();
+    const size_t two_byte_length = two_byte_strings_.size();
+    result = ParseRoot(&pos, end);
+    if (result == kOk)
+      continue;
+    // Whatever the attempt added belongs to a value that isn't complete.
+    tokens_.resize(token_count);
+    one_byte_strings_.resize(one_byte_length);
+    two_byte_strings_.resize(two_byte_length);
+    pos = start;
+    break;
+  }
+  if (result == kError)
+    return false;
+
+  input_offset_ += pos;
+  input_.erase(0, pos);
+  incomplete_length_ = input_.size();
+  return true;
+}
+
+
+// Parses the next value, or the next bit of the enclosing array in kElements
+// mode. Returns kIncomplete at the end of the input, also when |end| is set
+// and the input ended cleanly.
+Parser::Result Parser::ParseRoot(size_t* pos, bool end) {
+  Result result = SkipWhitespace(pos, end);
+  if (result != kOk)
+    return result;
+
+  const char c = input_[*pos];
+  switch (mode_) {
+    case kValue:
+      if (value_seen_)
+        return Unexpected(*pos, end);
+      result = ParseValue(pos, 0, end);
+      if (result == kOk) {
+        value_seen_ = true;
+        value_count_++;
+      }
+      return result;
+
+    case kSequence:
+      result = ParseValue(pos, 0, end);
+      if (result == kOk)
+        value_count_++;
+      return result;
+
+    case kElements:
+      switch (elements_state_) {
+        case kBeforeArray:
+          if (c != '[')
+            return Unexpected(*pos, end);
+          if (max_depth_ == 0)
+            return Fail("Nesting too deep in JSON at position 0");
+          ++*pos;
+          elements_state_ = kBeforeFirstElement;
+          return kOk;
+        case kBeforeFirstElement:
+        case kBeforeElement:
+          if (c == ']' && elements_state_ == kBeforeFirstElement) {
+            ++*pos;
+            elements_state_ = kAfterArray;
+            return kOk;
+          }
+          result = ParseValue(pos, 1, end);
+          if (result == kOk) {
+            elements_state_ = kAfterElement;
+            value_count_++;
+          }
+          return result;
+        case kAfterElement:
+          if (c == ',')
+            elements_state_ = kBeforeElement;
+          else if (c == ']')
+            elements_state_ = kAfterArray;
+          else
+            return Unexpected(*pos, end);
+          ++*pos;
+          return kOk;
+        case kAfterArray:
+          return Unexpected(*pos, end);
+      }
+  }
+  return Unexpected(*pos, end);
+}
+
+
+// |depth| is how many arrays and objects the value is in.
+Parser::Result Parser::ParseValue(size_t* pos, size_t depth, bool end) {
+  while (*pos < input_.size() && IsWhitespace(input_[*pos]))
+    ++*pos;
+  if (*pos == input_.size())
+    return Unexpected(*pos, end);
+
+  switch (input_[*pos]) {
+    case '[':
+    case '{':
+      if (depth >= max_depth_) {
+        return Fail("Nesting too deep in JSON at position " +
+                    std::to_string(input_offset_ + *pos));
+      }
+      return input_[*pos] == '[' ? ParseArray(pos, depth, end) :
+                                   ParseObject(pos, depth, end);
+    case '"':
+      return ParseString(pos, end);
+    case 't':
+      return ParseLiteral(pos, "true", 4, Token::kTrue, end);
+    case 'f':
+      return ParseLiteral(pos, "false", 5, Token::kFalse, end);
+    case 'n':
+      return ParseLiteral(pos, "null", 4, Token::kNull, end);
+    default:
+      return ParseNumber(pos, end);
+  }
+}
+
+
+Parser::Result Parser::ParseArray(size_t* pos, size_t depth, bool end) {
+  const size_t index = tokens_.size();
+  AddToken(Token::kArray, 0);
+  ++*pos;
+
+  Result result = SkipWhitespace(pos, end);
+  if (result != kOk)
+    return result == kIncomplete ? Unexpected(*pos, end) : result;
+  if (input_[*pos] == ']') {
+    ++*pos;
+    return kOk;
+  }
+
+  uint32_t length = 0;
+  for (;;) {
+    result = ParseValue(pos, depth + 1, end);
+    if (result != kOk)
+      return result;
+    if (++length == UINT32_MAX)
+      return Fail("Array too long in JSON");
+
+    result = SkipWhitespace(pos, end);
+    if (result != kOk)
+      return result == kIncomplete ? Unexpected(*pos, end) : result;
+    const char c = input_[*pos];
+    if (c == ']')
+      break;
+    if (c != ',')
+      return Unexpected(*pos, end);
+    ++*pos;
+  }
+  ++*pos;
+  tokens_[index].length = length;
+  return kOk;
+}
+
+
+Parser::Result Parser::ParseObject(size_t* pos, size_t depth, bool end) {
+  const size_t index = tokens_.size();
+  AddToken(Token::kObject, 0);
+  ++*pos;
+
+  Result result = SkipWhitespace(pos, end);
+  if (result != kOk)
+    return result == kIncomplete ? Unexpected(*pos, end) : result;
+  if (input_[*pos] == '}') {
+    ++*pos;
+    return kOk;
+  }
+
+  uint32_t length = 0;
+  for (;;) {
+    result = SkipWhitespace(pos, end);
+    if (result != kOk)
+      return result == kIncomplete ? Unexpected(*pos, end) : result;
+    if (input_[*pos] != '"')
+      return Unexpected(*pos, end);
+    result = ParseString(pos, end);
+    if (result != kOk)
+      return result;
+
+    result = SkipWhitespace(pos, end);
+    if (result != kOk)
+      return result == kIncomplete ? Unexpected(*pos, end) : result;
+    if (input_[*pos] != ':')
+      return Unexpected(*pos, end);
+    ++*pos;
+
+    result = ParseValue(pos, depth + 1, end);
+    if (result != kOk)
+      return result;
+    if (++length == UINT32_MAX)
+      return Fail("Object too large in JSON");
+
+    result = SkipWhitespace(pos, end);
+    if (result != kOk)
+      return result == kIncomplete ? Unexpected(*pos, end) : result;
+    const char c = input_[*pos];
+    if (c == '}')
+      break;
+    if (c != ',')
+      return Unexpected(*pos, end);
+    ++*pos;
+  }
+  ++*pos;
+  tokens_[index].length = length;
+  return kOk;
+}
+
+
+Parser::Result Parser::ParseString(size_t* pos, bool end) {
+  const unsigned char* data =
+      reinterpret_cast<const unsigned char*>(input_.data());
+  const size_t size = input_.size();
+  size_t i = *pos + 1;
+  uint16_t max = 0;
+  string_.clear();
+
+  for (;;) {
+    if (i >= size)
+      return Unexpected(size, end);
+    const unsigned char c = data[i];
+
+    if (c == '"')
+      break;
+
+    if (c >= 0x20 && c < 0x80 && c != '\\') {
+      string_.push_back(c);
+      i++;
+      continue;
+    }
+
+    if (c == '\\') {
+      if (i + 1 >= size)
+        return Unexpected(size, end);
+      uint16_t unit;
+      switch (data[i + 1]) {
+        case '"': unit = '"'; break;
+        case '\\': unit = '\\'; break;
+        case '/': unit = '/'; break;
+        case 'b': unit = '\b'; break;
+        case 'f': unit = '\f'; break;
+        case 'n': unit = '\n'; break;
+        case 'r': unit = '\r'; break;
+        case 't': unit = '\t'; break;
+        case 'u':
+          // Surrogates are taken as they are, paired or not, like
+          // JSON.parse() does.
+          unit = 0;
+          for (size_t k = i + 2; k < i + 6; k++) {
+            if (k >= size)
+              return Unexpected(size, end);
+            const int value = HexValue(data[k]);
+            if (value < 0)
+              return Unexpected(k, end);
+            unit = (unit << 4) | value;
+          }
+          i += 4;
+          break;
+        default:
+          return Unexpected(i + 1, end);
+      }
+      string_.push_back(unit);
+      if (unit > max)
+        max = unit;
+      i += 2;
+      continue;
+    }
+
+    if (c < 0x20)
+      return Unexpected(i, end);
+
+    // Decodes a UTF-8 sequence. Sequences that are not valid are replaced
+    // with U+FFFD, one for each maximal part of a valid sequence, like the
+    // Encoding Standard does.
+    size_t needed;
+    uint32_t code_point;
+    unsigned char lower = 0x80;
+    unsigned char upper = 0xbf;
+    if (c >= 0xc2 && c <= 0xdf) {
+      needed = 1;
+      code_point = c & 0x1f;
+    } else if (c >= 0xe0 && c <= 0xef) {
+      needed = 2;
+      code_point = c & 0xf;
+      if (c == 0xe0)
+        lower = 0xa0;
+      else if (c == 0xed)
+        upper = 0x9f;
+    } else if (c >= 0xf0 && c <= 0xf4) {
+      needed = 3;
+      code_point = c & 0x7;
+      if (c == 0xf0)
+        lower = 0x90;
+      else if (c == 0xf4)
+        upper = 0x8f;
+    } else {
+      string_.push_back(kReplacementCharacter);
+      max = kReplacementCharacter > max ? kReplacementCharacter : max;
+      i++;
+      continue;
+    }
+
+    size_t k = 1;
+    for (; k <= needed; k++) {
+      if (i + k >= size)
+        return Unexpected(size, end);
+      const unsigned char next = data[i + k];
+      if (next < lower || next > upper)
+        break;
+      code_point = (code_point << 6) | (next & 0x3f);
+      lower = 0x80;
+      upper = 0xbf;
+    }
+    if (k <= needed) {
+      string_.push_back(kReplacementCharacter);
+      code_point = kReplacementCharacter;
+      i += k;
+    } else if (code_point >= 0x10000) {
+      code_point -= 0x10000;
+      string_.push_back(0xd800 | (code_point >> 10));
+      string_.push_back(0xdc00 | (code_point & 0x3ff));
+      code_point = 0xffff;
+      i += k;
+    } else {
+      string_.push_back(code_point);
+      i += k;
+    }
+    if (code_point > max)
+      max = code_point;
+  }
+
+  if (string_.size() >= UINT32_MAX)
+    return Fail("String too long in JSON");
+  if (max < 0x100) {
+    AddToken(Token::kOneByteString, string_.size());
+    tokens_.back().offset = one_byte_strings_.size();
+    one_byte_strings_.append(string_.begin(), string_.end());
+  } else {
+    AddToken(Token::kTwoByteString, string_.size());
+    tokens_.back().offset = two_byte_strings_.size();
+    two_byte_strings_.insert(two_byte_strings_.end(),
+                             string_.begin(), string_.end());
+  }
+  *pos = i + 1;
+  return kOk;
+}
+
+
+Parser::Result Parser::ParseNumber(size_t* pos, bool end) {
+  const char* data = input_.data();
+  const size_t size = input_.size();
+  const size_t start = *pos;
+  size_t i = start;
+  bool integer = true;
+
+  if (data[i] == '-')
+    i++;
+  if (i >= size)
+    return Unexpected(size, end);
+  if (data[i] == '0') {
+    i++;
+  } else if (IsDigit(data[i])) {
+    while (i < size && IsDigit(data[i]))
+      i++;
+  } else {
+    return Unexpected(i, end);
+  }
+
+  if (i < size && data[i] == '.') {
+    integer = false;
+    i++;
+    if (i >= size || !IsDigit(data[i]))
+      return Unexpected(i, end);
+    while (i < size && IsDigit(data[i]))
+      i++;
+  }
+
+  if (i < size && (data[i] == 'e' || data[i] == 'E')) {
+    integer = false;
+    i++;
+    if (i < size && (data[i] == '+' || data[i] == '-'))
+      i++;
+    if (i >= size || !IsDigit(data[i]))
+      return Unexpected(i, end);
+    while (i < size && IsDigit(data[i]))
+      i++;
+  }
+
+  // More digits may follow.
+  if (i >= size && !end)
+    return kIncomplete;
+
+  double number;
+  const bool negative = data[start] == '-';
+  const size_t digits = i - start - (negative ? 1 : 0);
+  if (integer && digits <= 15) {
+    // Exactly representable, no rounding to worry about.
+    int64_t value = 0;
+    for (size_t k = negative ? start + 1 : start; k < i; k++)
+      value = value * 10 + (data[k] - '0');
+    number = static_cast<double>(value);
+    if (negative)
+      number = -number;
+  } else {
+    number_.assign(data + start, i - start);
+    number = strtod(number_.c_str(), nullptr);
+  }
+
+  AddToken(Token::kNumber, 0);
+  tokens_.back().number = number;
+  *pos = i;
+  return kOk;
+}
+
+
+Parser::Result Parser::ParseLiteral(size_t* pos,
+                                    const char* literal,
+                                    size_t length,
+                                    Token::Type type,
+                                    bool end) {
+  for (size_t k = 0; k < length; k++) {
+    if (*pos + k >= input_.size())
+      return Unexpected(input_.size(), end);
+    if (input_[*pos + k] != literal[k])
+      return Unexpected(*pos + k, end);
+  }
+  *pos += length;
+  AddToken(type, 0);
+  return kOk;
+}
+
+
+Parser::Result Parser::SkipWhitespace(size_t* pos, bool end) {
+  while (*pos < input_.size() && IsWhitespace(input_[*pos]))
+    ++*pos;
+  return *pos < input_.size() ? kOk : kIncomplete;
+}
+
+
+// Reports what is at |pos| as unexpected. The end of the input only is
+// unexpected once there is no more input.
+Parser::Result Parser::Unexpected(size_t pos, bool end) {
+  if (pos >= input_.size())
+    return end ? Fail(kUnexpectedEnd) : kIncomplete;
+
+  const char c = input_[pos];
+  std::string what;
+  if (c == '-' || IsDigit(c)) {
+    what = "number";
+  } else if (c == '"') {
+    what = "string";
+  } else {
+    const size_t length = SequenceLength(static_cast<unsigned char>(c));
+    what = "token " + input_.substr(pos, length);
+  }
+  return Fail("Unexpected " + what + " in JSON at position " +
+              std::to_string(input_offset_ + pos));
+}
+
+
+Parser::Result Parser::Fail(const std::string& message) {
+  failed_ = true;
+  error_ = message;
+  return kError;
+}
+
+
+void Parser::AddToken(Token::Type type, uint32_t length) {
+  Token token;
+  token.type = type;
+  token.length = length;
+  token.offset = 0;
+  tokens_.push_back(token);
+}
+
+}  // namespace json
+}  // namespace node
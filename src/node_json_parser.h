@@ -0,0 +1,142 @@
+#ifndef SRC_NODE_JSON_PARSER_H_
+#define SRC_NODE_JSON_PARSER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace node {
+namespace json {
+
+// One entry of the tape that the parser turns JSON text into. Values are
+// stored in the order in which they appear: an array is followed by its
+// |length| elements, an object by |length| pairs of a key, which is always a
+// string, and a value. String contents live in the parser's string tables.
+struct Token {
+  enum Type {
+    kNull,
+    kFalse,
+    kTrue,
+    kNumber,
+    // |length| Latin-1 characters at |offset| in one_byte_strings().
+    kOneByteString,
+    // |length| UTF-16 code units at |offset| in two_byte_strings().
+    kTwoByteString,
+    kArray,
+    kObject
+  };
+
+  Type type;
+  uint32_t length;
+  union {
+    double number;
+    size_t offset;
+  };
+};
+
+// An incremental JSON parser without any JavaScript. Text is fed to it in
+// pieces of any size, and the values that are complete are added to the tape
+// as they are found. It accepts what JSON.parse() accepts. The input is
+// UTF-8; like Buffer#toString(), invalid sequences within strings become
+// U+FFFD.
+//
+// A value that is not complete yet is parsed again from its start once more
+// data arrives. Attempts are spaced out so that the data is scanned about
+// twice overall, however large the value grows.
+class Parser {
+ public:
+  enum Mode {
+    // The input is exactly one value.
+    kValue,
+    // The input is any number of values, separated by whitespace if needed,
+    // as in newline delimited JSON.
+    kSequence,
+    // The input is one array, whose elements are the values.
+    kElements
+  };
+
+  Parser(Mode mode, size_t max_depth);
+
+  // Both return false on a syntax error, after which the parser takes no more
+  // input. End() tells the parser that there is no more input.
+  bool Write(const char* data, size_t length);
+  bool End();
+
+  // The values that are complete, in order, and the number of them. Each
+  // value takes up one or more tokens.
+  const std::vector<Token>& tokens() const { return tokens_; }
+  size_t value_count() const { return value_count_; }
+  const std::string& one_byte_strings() const { return one_byte_strings_; }
+  const std::vector<uint16_t>& two_byte_strings() const {
+    return two_byte_strings_;
+  }
+  // Makes room for the next values, once these have been processed.
+  void ClearValues();
+
+  // Like the messages of JSON.parse(), with positions counted in bytes.
+  const std::string& error() const { return error_; }
+  bool failed() const { return failed_; }
+
+ private:
+  enum Result { kOk, kIncomplete, kError };
+
+  // How far the input is into the array in kElements mode.
+  enum ElementsState {
+    kBeforeArray,
+    kBeforeFirstElement,
+    kBeforeElement,
+    kAfterElement,
+    kAfterArray
+  };
+
+  bool Parse(bool end);
+  Result ParseRoot(size_t* pos, bool end);
+  Result ParseValue(size_t* pos, size_t depth, bool end);
+  Result ParseArray(size_t* pos, size_t depth, bool end);
+  Result ParseObject(size_t* pos, size_t depth, bool end);
+  Result ParseString(size_t* pos, bool end);
+  Result ParseNumber(size_t* pos, bool end);
+  Result ParseLiteral(size_t* pos, const char* literal, size_t length,
+                      Token::Type type, bool end);
+  // Returns kIncomplete at the end of the input.
+  Result SkipWhitespace(size_t* pos, bool end);
+
+  Result Unexpected(size_t pos, bool end);
+  Result Fail(const std::string& message);
+
+  void AddToken(Token::Type type, uint32_t length);
+
+  const Mode mode_;
+  const size_t max_depth_;
+
+  // The input that hasn't been turned into values yet, and where it starts
+  // in the whole input.
+  std::string input_;
+  uint64_t input_offset_;
+  // How much of |input_| the last attempt at an incomplete value needed.
+  size_t incomplete_length_;
+  ElementsState elements_state_;
+  bool value_seen_;
+
+  std::vector<Token> tokens_;
+  size_t value_count_;
+  std::string one_byte_strings_;
+  std::vector<uint16_t> two_byte_strings_;
+  // The string that is being parsed.
+  std::vector<uint16_t> string_;
+  std::string number_;
+
+  std::string error_;
+  bool failed_;
+};
+
+}  // namespace json
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_JSON_PARSER_H_
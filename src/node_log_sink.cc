@@ -0,0 +1,483 @@
+#include "base-object.h"
+#include "base-object-inl.h"
+#include "env.h"
+#include "env-inl.h"
+#include "node_internals.h"
+#include "node_mutex.h"
+#include "node_threadpool.h"
+#include "util.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+namespace node {
+
+using v8::Array;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Int32;
+using v8::Integer;
+using v8::JSON;
+using v8::Local;
+using v8::Number;
+using v8::Object;
+using v8::PropertyFilter;
+using v8::String;
+using v8::Uint32;
+using v8::Value;
+
+namespace {
+
+// Formats log records as newline-delimited JSON and writes them to a file
+// descriptor from the thread pool, the way NodeTraceWriter writes trace
+// events: the records are appended to one buffer while the other is being
+// written, and the buffers are swapped when the write is done. A write is
+// started when |high_water_mark| bytes are buffered or when flush() is
+// called, which lib/fs.js does from a timer.
+//
+// After the write has finished, onwrite(err, bytesWritten) is called on the
+// object, with err being 0 or a negative libuv error code. Records that are
+// logged after writing failed are dropped.
+class LogSink : public BaseObject {
+ public:
+  static void Initialize(Local<Object> target,
+                         Local<Value> unused,
+                         Local<Context> context);
+
+  ~LogSink() override;
+
+ private:
+  LogSink(Environment* env,
+          Local<Object> object,
+          int fd,
+          size_t high_water_mark);
+
+  static void New(const FunctionCallbackInfo<Value>& args);
+  static void Log(const FunctionCallbackInfo<Value>& args);
+  static void LogFields(const FunctionCallbackInfo<Value>& args);
+  static void LogRaw(const FunctionCallbackInfo<Value>& args);
+  static void Flush(const FunctionCallbackInfo<Value>& args);
+  static void FlushSync(const FunctionCallbackInfo<Value>& args);
+
+  // Returns false if an exception is pending, in which case the record is
+  // not logged.
+  bool AppendField(Local<Context> context,
+                   Local<Value> key,
+                   Local<Value> value,
+                   bool* first);
+  bool AppendValue(Local<Context> context, Local<Value> value);
+  void AppendString(Local<Value> value);
+  void AppendNumber(double value);
+  // Ends the record that starts at |start| of the buffer, or removes it
+  // again if |ok| is false.
+  void EndRecord(size_t start, bool ok);
+  void MaybeStartWrite();
+  void StartWrite();
+
+  static int WriteOut(int fd, const std::string& data);
+  static void Work(uv_work_t* req);
+  static void AfterWork(uv_work_t* req, int status);
+
+  const int fd_;
+  const size_t high_water_mark_;
+  // What the records are appended to, and what is being written.
+  std::string buffer_;
+  std::string writing_buffer_;
+  uv_work_t work_req_;
+  bool writing_ = false;
+  bool flush_requested_ = false;
+  int error_ = 0;
+  double bytes_written_ = 0;
+  // Guard |work_done_| and |work_error_|, so that flushSync() can wait
+  // until the write in the thread pool is done before it writes the rest.
+  Mutex mutex_;
+  ConditionVariable work_cond_;
+  bool work_done_ = false;
+  int work_error_ = 0;
+};
+
+
+LogSink::LogSink(Environment* env,
+                 Local<Object> object,
+                 int fd,
+                 size_t high_water_mark)
+    : BaseObject(env, object),
+      fd_(fd),
+      high_water_mark_(high_water_mark) {
+  MakeWeak<LogSink>(this);
+  buffer_.reserve(high_water_mark);
+  writing_buffer_.reserve(high_water_mark);
+}
+
+
+LogSink::~LogSink() {
+  // The object is kept alive while a write is in flight.
+  CHECK_EQ(writing_, false);
+}
+
+
+void LogSink::AppendString(Local<Value> value) {
+  node::Utf8Value utf8(env()->isolate(), value);
+  buffer_.push_back('"');
+  for (size_t i = 0; i < utf8.length(); i++) {
+    const unsigned char c = (*utf8)[i];
+    switch (c) {
+      case '"': buffer_.append("\\\""); break;
+      case '\\': buffer_.append("\\\\"); break;
+      case '\b': buffer_.append("\\b"); break;
+      case '\f': buffer_.append("\\f"); break;
+      case '\n': buffer_.append("\\n"); break;
+      case '\r': buffer_.append("\\r"); break;
+      case '\t': buffer_.append("\\t"); break;
+      default:
+        if (c < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          buffer_.append(escaped);
+        } else {
+          buffer_.push_back(c);
+        }
+    }
+  }
+  buffer_.push_back('"');
+}
+
+
+// Like JSON.stringify(), NaN and the infinities become null. Otherwise the
+// shortest of %.15g and %.17g that reads back as the same number is used.
+void LogSink::AppendNumber(double value) {
+  if (!isfinite(value)) {
+    buffer_.append("null");
+    return;
+  }
+  if (value == 0) {
+    buffer_.push_back('0');
+    return;
+  }
+  char formatted[32];
+  snprintf(formatted, sizeof(formatted), "%.15g", value);
+  if (strtod(formatted, nullptr) != value)
+    snprintf(formatted, sizeof(formatted), "%.17g", value);
+  buffer_.append(formatted);
+}
+
+
+// Strings, numbers, booleans and null are formatted here. Other objects are
+// passed to JSON.stringify(), so that arrays, dates and toJSON() work the
+// same as they would there.
+bool LogSink::AppendValue(Local<Context> context, Local<Value> value) {
+  if (value->IsString()) {
+    AppendString(value);
+  } else if (value->IsInt32()) {
+    buffer_.append(std::to_string(value.As<Int32>()->Value()));
+  } else if (value->IsNumber()) {
+    AppendNumber(value.As<Number>()->Value());
+  } else if (value->IsTrue()) {
+    buffer_.append("true");
+  } else if (value->IsFalse()) {
+    buffer_.append("false");
+  } else if (value->IsNull()) {
+    buffer_.append("null");
+  } else {
+    Local<String> json;
+    if (!JSON::Stringify(context, value.As<Object>()).ToLocal(&json))
+      return false;
+    // A toJSON() that returns undefined.
+    if (!json.As<Value>()->IsString()) {
+      buffer_.append("null");
+      return true;
+    }
+    node::Utf8Value utf8(env()->isolate(), json);
+    buffer_.append(*utf8, utf8.length());
+  }
+  return true;
+}
+
+
+bool LogSink::AppendField(Local<Context> context,
+                          Local<Value> key,
+                          Local<Value> value,
+                          bool* first) {
+  // Skipped like JSON.stringify() skips them.
+  if (value->IsUndefined() || value->IsFunction() || value->IsSymbol())
+    return true;
+  if (!*first)
+    buffer_.push_back(',');
+  *first = false;
+  AppendString(key);
+  buffer_.push_back(':');
+  return AppendValue(context, value);
+}
+
+
+void LogSink::EndRecord(size_t start, bool ok) {
+  if (!ok || error_ != 0) {
+    buffer_.resize(start);
+    return;
+  }
+  buffer_.push_back('\n');
+  MaybeStartWrite();
+}
+
+
+void LogSink::MaybeStartWrite() {
+  if (!writing_ && buffer_.size() >= high_water_mark_)
+    StartWrite();
+}
+
+
+void LogSink::StartWrite() {
+  CHECK_EQ(writing_, false);
+  CHECK(writing_buffer_.empty());
+  if (buffer_.empty() || error_ != 0)
+    return;
+  buffer_.swap(writing_buffer_);
+  writing_ = true;
+  {
+    Mutex::ScopedLock lock(mutex_);
+    work_done_ = false;
+  }
+  ClearWeak();
+  CHECK_EQ(0, threadpool::QueueWork(env()->event_loop(),
+                                    &work_req_,
+                                    threadpool::kFsWork,
+                                    threadpool::kLowPriority,
+                                    Work,
+                                    AfterWork,
+                                    NODE_THREADPOOL_TRACE_FS,
+                                    "fs.logSink"));
+}
+
+
+// Returns 0 or a negative libuv error code.
+int LogSink::WriteOut(int fd, const std::string& data) {
+  size_t offset = 0;
+  while (offset < data.size()) {
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(data.data() + offset),
+                               data.size() - offset);
+    uv_fs_t req;
+    const int r = uv_fs_write(nullptr, &req, fd, &buf, 1, -1, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (r == UV_EINTR)
+      continue;
+    if (r < 0)
+      return r;
+    offset += r;
+  }
+  return 0;
+}
+
+
+void LogSink::Work(uv_work_t* req) {
+  LogSink* sink = ContainerOf(&LogSink::work_req_, req);
+  const int err = WriteOut(sink->fd_, sink->writing_buffer_);
+  Mutex::ScopedLock lock(sink->mutex_);
+  sink->work_error_ = err;
+  sink->work_done_ = true;
+  sink->work_cond_.Broadcast(lock);
+}
+
+
+void LogSink::AfterWork(uv_work_t* req, int status) {
+  CHECK_EQ(status, 0);
+  LogSink* sink = ContainerOf(&LogSink::work_req_, req);
+  Environment* env = sink->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  sink->writing_ = false;
+  sink->MakeWeak<LogSink>(sink);
+  int err;
+  {
+    Mutex::ScopedLock lock(sink->mutex_);
+    err = sink->work_error_;
+  }
+  if (err == 0) {
+    sink->bytes_written_ += sink->writing_buffer_.size();
+  } else if (sink->error_ == 0) {
+    sink->error_ = err;
+    sink->buffer_.clear();
+  }
+  sink->writing_buffer_.clear();
+
+  // What was logged meanwhile is written out straight away if the buffer
+  // filled up again or flush() was called while writing.
+  if (sink->flush_requested_) {
+    sink->flush_requested_ = false;
+    sink->StartWrite();
+  } else {
+    sink->MaybeStartWrite();
+  }
+
+  Local<Value> argv[] = {
+    Integer::New(env->isolate(), err),
+    Number::New(env->isolate(), sink->bytes_written_)
+  };
+  MakeCallback(env, sink->object(), env->onwrite_string(),
+               arraysize(argv), argv);
+}
+
+
+// new LogSink(fd, highWaterMark)
+void LogSink::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsUint32());
+  new LogSink(env,
+              args.This(),
+              args[0].As<Int32>()->Value(),
+              args[1].As<Uint32>()->Value());
+}
+
+
+// log(record) logs the enumerable own properties of |record|. Returns the
+// number of bytes that are buffered.
+void LogSink::Log(const FunctionCallbackInfo<Value>& args) {
+  LogSink* sink;
+  ASSIGN_OR_RETURN_UNWRAP(&sink, args.Holder());
+  CHECK(args[0]->IsObject());
+  Local<Context> context = sink->env()->context();
+  Local<Object> record = args[0].As<Object>();
+
+  const size_t start = sink->buffer_.size();
+  bool ok = true;
+  Local<Array> keys;
+  const PropertyFilter filter = static_cast<PropertyFilter>(
+      PropertyFilter::ONLY_ENUMERABLE | PropertyFilter::SKIP_SYMBOLS);
+  if (record->GetOwnPropertyNames(context, filter).ToLocal(&keys)) {
+    bool first = true;
+    sink->buffer_.push_back('{');
+    for (uint32_t i = 0; ok && i < keys->Length(); i++) {
+      Local<Value> key;
+      Local<Value> value;
+      ok = keys->Get(context, i).ToLocal(&key) &&
+           record->Get(context, key).ToLocal(&value) &&
+           sink->AppendField(context, key, value, &first);
+    }
+    sink->buffer_.push_back('}');
+  } else {
+    ok = false;
+  }
+  sink->EndRecord(start, ok);
+  args.GetReturnValue().Set(static_cast<double>(sink->buffer_.size()));
+}
+
+
+// logFields(keys, values) logs a record of keys[i]: values[i], so that the
+// keys of records that look the same need not be looked up every time.
+void LogSink::LogFields(const FunctionCallbackInfo<Value>& args) {
+  LogSink* sink;
+  ASSIGN_OR_RETURN_UNWRAP(&sink, args.Holder());
+  CHECK(args[0]->IsArray());
+  CHECK(args[1]->IsArray());
+  Local<Context> context = sink->env()->context();
+  Local<Array> keys = args[0].As<Array>();
+  Local<Array> values = args[1].As<Array>();
+  CHECK_EQ(keys->Length(), values->Length());
+
+  const size_t start = sink->buffer_.size();
+  bool ok = true;
+  bool first = true;
+  sink->buffer_.push_back('{');
+  for (uint32_t i = 0; ok && i < keys->Length(); i++) {
+    Local<Value> key;
+    Local<Value> value;
+    ok = keys->Get(context, i).ToLocal(&key) &&
+         values->Get(context, i).ToLocal(&value) &&
+         sink->AppendField(context, key, value, &first);
+  }
+  sink->buffer_.push_back('}');
+  sink->EndRecord(start, ok);
+  args.GetReturnValue().Set(static_cast<double>(sink->buffer_.size()));
+}
+
+
+// logRaw(line) logs a record that is already formatted, adding the newline
+// if it has none.
+void LogSink::LogRaw(const FunctionCallbackInfo<Value>& args) {
+  LogSink* sink;
+  ASSIGN_OR_RETURN_UNWRAP(&sink, args.Holder());
+  CHECK(args[0]->IsString());
+  if (sink->error_ == 0) {
+    node::Utf8Value line(sink->env()->isolate(), args[0]);
+    sink->buffer_.append(*line, line.length());
+    if (line.length() == 0 || (*line)[line.length() - 1] != '\n')
+      sink->buffer_.push_back('\n');
+    sink->MaybeStartWrite();
+  }
+  args.GetReturnValue().Set(static_cast<double>(sink->buffer_.size()));
+}
+
+
+// Starts writing what is buffered, or does so when the write in flight is
+// done. Returns what bytesWritten will be once everything that was logged
+// until now has been written.
+void LogSink::Flush(const FunctionCallbackInfo<Value>& args) {
+  LogSink* sink;
+  ASSIGN_OR_RETURN_UNWRAP(&sink, args.Holder());
+  const double target = sink->bytes_written_ +
+                        sink->writing_buffer_.size() +
+                        sink->buffer_.size();
+  if (sink->writing_)
+    sink->flush_requested_ = !sink->buffer_.empty();
+  else
+    sink->StartWrite();
+  args.GetReturnValue().Set(target);
+}
+
+
+// Waits for the write in flight, and then writes the rest from this thread.
+// Returns 0 or the libuv error code that writing failed with.
+void LogSink::FlushSync(const FunctionCallbackInfo<Value>& args) {
+  LogSink* sink;
+  ASSIGN_OR_RETURN_UNWRAP(&sink, args.Holder());
+  if (sink->writing_) {
+    Mutex::ScopedLock lock(sink->mutex_);
+    while (!sink->work_done_)
+      sink->work_cond_.Wait(lock);
+    if (sink->work_error_ != 0 && sink->error_ == 0) {
+      sink->error_ = sink->work_error_;
+      sink->buffer_.clear();
+    }
+  }
+  if (sink->error_ == 0 && !sink->buffer_.empty()) {
+    sink->error_ = WriteOut(sink->fd_, sink->buffer_);
+    if (sink->error_ == 0)
+      sink->bytes_written_ += sink->buffer_.size();
+    sink->buffer_.clear();
+  }
+  sink->flush_requested_ = false;
+  args.GetReturnValue().Set(sink->error_);
+}
+
+
+void LogSink::Initialize(Local<Object> target,
+                         Local<Value> unused,
+                         Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  t->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "LogSink"));
+
+  env->SetProtoMethod(t, "log", Log);
+  env->SetProtoMethod(t, "logFields", LogFields);
+  env->SetProtoMethod(t, "logRaw", LogRaw);
+  env->SetProtoMethod(t, "flush", Flush);
+  env->SetProtoMethod(t, "flushSync", FlushSync);
+
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "LogSink"),
+              t->GetFunction(env->context()).ToLocalChecked()).FromJust();
+}
+
+}  // anonymous namespace
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(log_sink, node::LogSink::Initialize)
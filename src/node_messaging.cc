@@ -0,0 +1,492 @@
+#include "node_messaging.h"
+#include "async-wrap.h"
+#include "async-wrap-inl.h"
+#include "env.h"
+#include "env-inl.h"
+#include "node_internals.h"
+#include "util.h"
+#include "util-inl.h"
+
+#include <string.h>
+
+namespace node {
+namespace worker {
+
+using v8::Array;
+using v8::ArrayBuffer;
+using v8::ArrayBufferCreationMode;
+using v8::Context;
+using v8::Exception;
+using v8::External;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Isolate;
+using v8::Just;
+using v8::Local;
+using v8::Maybe;
+using v8::MaybeLocal;
+using v8::Nothing;
+using v8::Object;
+using v8::SharedArrayBuffer;
+using v8::String;
+using v8::Value;
+using v8::ValueDeserializer;
+using v8::ValueSerializer;
+using v8::WeakCallbackInfo;
+using v8::WeakCallbackType;
+
+namespace {
+
+// Gives SharedArrayBuffers the transfer ids that follow those of the
+// transferred ArrayBuffers, which V8 looks up in the same table.
+class SerializerDelegate : public ValueSerializer::Delegate {
+ public:
+  SerializerDelegate(Environment* env,
+                     Local<Context> context,
+                     Message* message,
+                     uint32_t first_id)
+      : env_(env), context_(context), message_(message), first_id_(first_id) {}
+
+  void ThrowDataCloneError(Local<String> message) override {
+    env_->isolate()->ThrowException(Exception::Error(message));
+  }
+
+  Maybe<uint32_t> GetSharedArrayBufferId(
+      Isolate* isolate,
+      Local<SharedArrayBuffer> shared_array_buffer) override {
+    for (uint32_t i = 0; i < seen_.size(); i++) {
+      if (seen_[i] == shared_array_buffer)
+        return Just(first_id_ + i);
+    }
+    std::shared_ptr<SharedArrayBufferMetadata> reference =
+        SharedArrayBufferMetadata::ForSharedArrayBuffer(env_,
+                                                        context_,
+                                                        shared_array_buffer);
+    if (reference == nullptr)
+      return Nothing<uint32_t>();
+    seen_.push_back(shared_array_buffer);
+    message_->AddSharedArrayBuffer(reference);
+    return Just(first_id_ + static_cast<uint32_t>(seen_.size() - 1));
+  }
+
+ private:
+  Environment* const env_;
+  const Local<Context> context_;
+  Message* const message_;
+  const uint32_t first_id_;
+  std::vector<Local<SharedArrayBuffer>> seen_;
+};
+
+}  // anonymous namespace
+
+
+SharedArrayBufferMetadata::SharedArrayBufferMetadata(
+    void* data, size_t length, std::shared_ptr<BufferArena> arena)
+    : data_(data), length_(length), arena_(std::move(arena)) {}
+
+
+SharedArrayBufferMetadata::~SharedArrayBufferMetadata() {
+  if (arena_ == nullptr || !arena_->Free(data_))
+    free(data_);
+}
+
+
+std::shared_ptr<SharedArrayBufferMetadata>
+SharedArrayBufferMetadata::ForSharedArrayBuffer(
+    Environment* env,
+    Local<Context> context,
+    Local<SharedArrayBuffer> source) {
+  SABLifetimePartner* partner;
+  if (!SABLifetimePartner::Get(env, context, source).To(&partner))
+    return nullptr;
+  if (partner != nullptr)
+    return partner->reference();
+
+  if (source->IsExternal()) {
+    env->ThrowTypeError("Only SharedArrayBuffers that node allocated can be "
+                        "shared with other threads");
+    return nullptr;
+  }
+
+  // From now on the memory belongs to the references, and the arena of the
+  // allocator stays around until the last of them is gone.
+  SharedArrayBuffer::Contents contents = source->Externalize();
+  ArrayBufferAllocator* allocator = env->isolate_data()->allocator();
+  std::shared_ptr<SharedArrayBufferMetadata> reference(
+      new SharedArrayBufferMetadata(
+          contents.Data(),
+          contents.ByteLength(),
+          allocator != nullptr ? allocator->arena() : nullptr));
+  if (reference->AssignToSharedArrayBuffer(env, context, source).IsNothing())
+    return nullptr;
+  return reference;
+}
+
+
+MaybeLocal<SharedArrayBuffer> SharedArrayBufferMetadata::GetSharedArrayBuffer(
+    Environment* env, Local<Context> context) {
+  Local<SharedArrayBuffer> target =
+      SharedArrayBuffer::New(env->isolate(), data_, length_);
+  if (AssignToSharedArrayBuffer(env, context, target).IsNothing())
+    return MaybeLocal<SharedArrayBuffer>();
+  return target;
+}
+
+
+Maybe<bool> SharedArrayBufferMetadata::AssignToSharedArrayBuffer(
+    Environment* env,
+    Local<Context> context,
+    Local<SharedArrayBuffer> target) {
+  // A partner that could not be attached stays with the Environment, which
+  // is safer than freeing memory that |target| may still use.
+  SABLifetimePartner* partner =
+      new SABLifetimePartner(env, shared_from_this());
+  return partner->AttachTo(context, target);
+}
+
+
+SABLifetimePartner::SABLifetimePartner(
+    Environment* env, std::shared_ptr<SharedArrayBufferMetadata> reference)
+    : env_(env), reference_(std::move(reference)) {
+  env_->add_sab_lifetime_partner(this);
+}
+
+
+SABLifetimePartner::~SABLifetimePartner() {
+  handle_.Reset();
+  env_->remove_sab_lifetime_partner(this);
+}
+
+
+Maybe<SABLifetimePartner*> SABLifetimePartner::Get(
+    Environment* env,
+    Local<Context> context,
+    Local<SharedArrayBuffer> target) {
+  Local<Value> value;
+  if (!target->GetPrivate(context, env->sab_lifetime_partner_symbol())
+           .ToLocal(&value)) {
+    return Nothing<SABLifetimePartner*>();
+  }
+  if (!value->IsExternal())
+    return Just<SABLifetimePartner*>(nullptr);
+  return Just(static_cast<SABLifetimePartner*>(value.As<External>()->Value()));
+}
+
+
+Maybe<bool> SABLifetimePartner::AttachTo(Local<Context> context,
+                                         Local<SharedArrayBuffer> target) {
+  Local<External> external = External::New(env_->isolate(), this);
+  if (target->SetPrivate(context, env_->sab_lifetime_partner_symbol(),
+                         external).IsNothing()) {
+    return Nothing<bool>();
+  }
+  handle_.Reset(env_->isolate(), external);
+  handle_.SetWeak(this, WeakCallback, WeakCallbackType::kParameter);
+  return Just(true);
+}
+
+
+void SABLifetimePartner::WeakCallback(
+    const WeakCallbackInfo<SABLifetimePartner>& data) {
+  delete data.GetParameter();
+}
+
+
+Message::Message(Message&& other)
+    : data_(std::move(other.data_)),
+      array_buffers_(std::move(other.array_buffers_)),
+      shared_array_buffers_(std::move(other.shared_array_buffers_)) {
+  other.array_buffers_.clear();
+  other.shared_array_buffers_.clear();
+}
+
+
+Message& Message::operator=(Message&& other) {
+  CHECK(array_buffers_.empty());
+  data_ = std::move(other.data_);
+  array_buffers_ = std::move(other.array_buffers_);
+  other.array_buffers_.clear();
+  shared_array_buffers_ = std::move(other.shared_array_buffers_);
+  other.shared_array_buffers_.clear();
+  return *this;
+}
+
+
+Message::~Message() {
+  // A message that was never delivered still owns what was transferred.
+  for (const TransferredBuffer& buffer : array_buffers_)
+    free(buffer.data);
+}
+
+
+Maybe<bool> Message::Serialize(Environment* env,
+                               Local<Context> context,
+                               Local<Value> input,
+                               Local<Value> transfer_list) {
+  CHECK(data_.empty());
+  CHECK(array_buffers_.empty());
+  CHECK(shared_array_buffers_.empty());
+  std::vector<Local<ArrayBuffer>> transferred;
+  if (!transfer_list->IsUndefined()) {
+    if (!transfer_list->IsArray()) {
+      env->ThrowTypeError("transferList must be an array");
+      return Nothing<bool>();
+    }
+    Local<Array> list = transfer_list.As<Array>();
+    for (uint32_t i = 0; i < list->Length(); i++) {
+      Local<Value> entry;
+      if (!list->Get(context, i).ToLocal(&entry))
+        return Nothing<bool>();
+      // External ArrayBuffers belong to whoever created them, so their memory
+      // can't be handed to another isolate.
+      if (!entry->IsArrayBuffer() || entry.As<ArrayBuffer>()->IsExternal() ||
+          !entry.As<ArrayBuffer>()->IsNeuterable()) {
+        env->ThrowTypeError("transferList may only contain ArrayBuffers "
+                            "that can be transferred");
+        return Nothing<bool>();
+      }
+      for (Local<ArrayBuffer> other : transferred) {
+        if (other->StrictEquals(entry)) {
+          env->ThrowTypeError("transferList contains an ArrayBuffer twice");
+          return Nothing<bool>();
+        }
+      }
+      transferred.push_back(entry.As<ArrayBuffer>());
+    }
+  }
+
+  SerializerDelegate delegate(env,
+                              context,
+                              this,
+                              static_cast<uint32_t>(transferred.size()));
+  ValueSerializer serializer(env->isolate(), &delegate);
+  serializer.WriteHeader();
+  for (uint32_t i = 0; i < transferred.size(); i++)
+    serializer.TransferArrayBuffer(i, transferred[i]);
+  if (serializer.WriteValue(context, input).IsNothing())
+    return Nothing<bool>();
+
+  ArrayBufferAllocator* allocator = env->isolate_data()->allocator();
+  for (Local<ArrayBuffer> array_buffer : transferred) {
+    ArrayBuffer::Contents contents = array_buffer->Externalize();
+    array_buffer->Neuter();
+    void* data = contents.Data();
+    if (allocator != nullptr)
+      data = allocator->Release(data, contents.ByteLength());
+    if (data == nullptr && contents.ByteLength() > 0) {
+      allocator->Free(contents.Data(), contents.ByteLength());
+      env->ThrowRangeError("Out of memory for transferring an ArrayBuffer");
+      return Nothing<bool>();
+    }
+    array_buffers_.push_back(TransferredBuffer{data, contents.ByteLength()});
+  }
+
+  std::pair<uint8_t*, size_t> data = serializer.Release();
+  data_.assign(data.first, data.first + data.second);
+  free(data.first);
+  return Just(true);
+}
+
+
+MaybeLocal<Value> Message::Deserialize(Environment* env,
+                                       Local<Context> context) {
+  ValueDeserializer deserializer(env->isolate(), data_.data(), data_.size());
+  for (uint32_t i = 0; i < array_buffers_.size(); i++) {
+    // The isolate frees the memory with the ArrayBufferAllocator of node,
+    // which uses free() for what it did not allocate itself.
+    Local<ArrayBuffer> array_buffer =
+        ArrayBuffer::New(env->isolate(),
+                         array_buffers_[i].data,
+                         array_buffers_[i].length,
+                         ArrayBufferCreationMode::kInternalized);
+    deserializer.TransferArrayBuffer(i, array_buffer);
+  }
+  const uint32_t first_shared_id = static_cast<uint32_t>(array_buffers_.size());
+  array_buffers_.clear();
+  for (uint32_t i = 0; i < shared_array_buffers_.size(); i++) {
+    Local<SharedArrayBuffer> shared_array_buffer;
+    if (!shared_array_buffers_[i]->GetSharedArrayBuffer(env, context)
+             .ToLocal(&shared_array_buffer)) {
+      return MaybeLocal<Value>();
+    }
+    deserializer.TransferSharedArrayBuffer(first_shared_id + i,
+                                           shared_array_buffer);
+  }
+  shared_array_buffers_.clear();
+
+  if (deserializer.ReadHeader(context).IsNothing())
+    return MaybeLocal<Value>();
+  return deserializer.ReadValue(context);
+}
+
+
+void Message::AddSharedArrayBuffer(
+    const std::shared_ptr<SharedArrayBufferMetadata>& reference) {
+  shared_array_buffers_.push_back(reference);
+}
+
+
+MessagePortData::MessagePortData() : mutex_(std::make_shared<Mutex>()) {}
+
+
+MessagePortData::~MessagePortData() {
+  CHECK_EQ(owner_, nullptr);
+  Disentangle();
+}
+
+
+void MessagePortData::Entangle(MessagePortData* a, MessagePortData* b) {
+  CHECK_EQ(a->sibling_, nullptr);
+  CHECK_EQ(b->sibling_, nullptr);
+  a->sibling_ = b;
+  b->sibling_ = a;
+  b->mutex_ = a->mutex_;
+}
+
+
+void MessagePortData::Disentangle() {
+  // The mutex stays shared with the former sibling, which may still use it.
+  Mutex::ScopedLock lock(*mutex_);
+  if (sibling_ != nullptr) {
+    sibling_->sibling_ = nullptr;
+    sibling_ = nullptr;
+  }
+}
+
+
+void MessagePortData::PostMessage(Message&& message) {
+  Mutex::ScopedLock lock(*mutex_);
+  if (sibling_ == nullptr)
+    return;
+  sibling_->incoming_messages_.emplace_back(std::move(message));
+  if (sibling_->owner_ != nullptr)
+    sibling_->owner_->TriggerAsync();
+}
+
+
+bool MessagePortData::NextMessage(Message* message) {
+  Mutex::ScopedLock lock(*mutex_);
+  if (incoming_messages_.empty())
+    return false;
+  *message = std::move(incoming_messages_.front());
+  incoming_messages_.pop_front();
+  return true;
+}
+
+
+void MessagePortData::set_owner(MessagePort* port) {
+  Mutex::ScopedLock lock(*mutex_);
+  owner_ = port;
+  if (owner_ != nullptr && !incoming_messages_.empty())
+    owner_->TriggerAsync();
+}
+
+
+MessagePort::MessagePort(Environment* env,
+                         Local<Object> wrap,
+                         std::unique_ptr<MessagePortData> data)
+    : HandleWrap(env,
+                 wrap,
+                 reinterpret_cast<uv_handle_t*>(&async_),
+                 AsyncWrap::PROVIDER_MESSAGEPORT),
+      data_(std::move(data)) {
+  CHECK_EQ(uv_async_init(env->event_loop(), &async_, [](uv_async_t* handle) {
+    MessagePort* port = ContainerOf(&MessagePort::async_, handle);
+    port->OnMessage();
+  }), 0);
+  uv_unref(reinterpret_cast<uv_handle_t*>(&async_));
+  data_->set_owner(this);
+}
+
+
+MessagePort::~MessagePort() {
+  CHECK(data_ == nullptr);
+}
+
+
+MessagePort* MessagePort::New(Environment* env,
+                              Local<Context> context,
+                              std::unique_ptr<MessagePortData> data) {
+  Local<Object> instance;
+  if (!GetConstructorTemplate(env)->GetFunction()->NewInstance(context)
+           .ToLocal(&instance)) {
+    return nullptr;
+  }
+  if (data == nullptr)
+    data.reset(new MessagePortData());
+  return new MessagePort(env, instance, std::move(data));
+}
+
+
+void MessagePort::New(const FunctionCallbackInfo<Value>& args) {
+  // Only MessagePort::New() makes ports that are part of a channel.
+  CHECK(args.IsConstructCall());
+}
+
+
+void MessagePort::TriggerAsync() {
+  CHECK_EQ(uv_async_send(&async_), 0);
+}
+
+
+void MessagePort::OnMessage() {
+  if (data_ == nullptr)
+    return;
+  HandleScope handle_scope(env()->isolate());
+  Local<Context> context = env()->context();
+  Context::Scope context_scope(context);
+
+  Message message;
+  while (data_ != nullptr && data_->NextMessage(&message)) {
+    Local<Value> payload;
+    if (!message.Deserialize(env(), context).ToLocal(&payload))
+      continue;
+    MakeCallback(env()->onmessage_string(), 1, &payload);
+    if (env()->is_stopping_worker())
+      break;
+  }
+}
+
+
+void MessagePort::OnBeforeClose() {
+  data_->set_owner(nullptr);
+  data_.reset();
+}
+
+
+void MessagePort::PostMessage(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  MessagePort* port;
+  ASSIGN_OR_RETURN_UNWRAP(&port, args.Holder());
+  if (port->data_ == nullptr)
+    return;
+
+  Message message;
+  if (message.Serialize(env, env->context(), args[0], args[1]).IsNothing())
+    return;
+  port->data_->PostMessage(std::move(message));
+}
+
+
+Local<FunctionTemplate> MessagePort::GetConstructorTemplate(Environment* env) {
+  Local<FunctionTemplate> templ = env->message_port_constructor_template();
+  if (!templ.IsEmpty())
+    return templ;
+
+  templ = env->NewFunctionTemplate(MessagePort::New);
+  templ->InstanceTemplate()->SetInternalFieldCount(1);
+  templ->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "MessagePort"));
+
+  env->SetProtoMethod(templ, "postMessage", MessagePort::PostMessage);
+  env->SetProtoMethod(templ, "close", HandleWrap::Close);
+  env->SetProtoMethod(templ, "ref", HandleWrap::Ref);
+  env->SetProtoMethod(templ, "unref", HandleWrap::Unref);
+  env->SetProtoMethod(templ, "hasRef", HandleWrap::HasRef);
+
+  env->set_message_port_constructor_template(templ);
+  return templ;
+}
+
+}  // namespace worker
+}  // namespace node
@@ -0,0 +1,221 @@
+#ifndef SRC_NODE_MESSAGING_H_
+#define SRC_NODE_MESSAGING_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "env.h"
+#include "handle_wrap.h"
+#include "node_mutex.h"
+#include "uv.h"
+#include "v8.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace node {
+
+class BufferArena;
+
+namespace worker {
+
+// The memory of a SharedArrayBuffer that was posted to another thread. Every
+// SharedArrayBuffer over it, in any isolate, holds a reference, and the memory
+// is freed together with the last one. The memory is never copied.
+class SharedArrayBufferMetadata
+    : public std::enable_shared_from_this<SharedArrayBufferMetadata> {
+ public:
+  // Returns the memory of |source|, which is shared from then on. Throws and
+  // returns nullptr if |source| is external memory that node doesn't manage.
+  static std::shared_ptr<SharedArrayBufferMetadata> ForSharedArrayBuffer(
+      Environment* env,
+      v8::Local<v8::Context> context,
+      v8::Local<v8::SharedArrayBuffer> source);
+
+  // Returns a new SharedArrayBuffer over the memory in |env|.
+  v8::MaybeLocal<v8::SharedArrayBuffer> GetSharedArrayBuffer(
+      Environment* env, v8::Local<v8::Context> context);
+
+  ~SharedArrayBufferMetadata();
+
+ private:
+  SharedArrayBufferMetadata(void* data,
+                            size_t length,
+                            std::shared_ptr<BufferArena> arena);
+
+  // Makes |target| hold a reference to the memory.
+  v8::Maybe<bool> AssignToSharedArrayBuffer(
+      Environment* env,
+      v8::Local<v8::Context> context,
+      v8::Local<v8::SharedArrayBuffer> target);
+
+  void* const data_;
+  const size_t length_;
+  // The arena the memory came from, which must stay around as long as the
+  // memory does, or nullptr.
+  const std::shared_ptr<BufferArena> arena_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedArrayBufferMetadata);
+};
+
+// The reference of one SharedArrayBuffer to its shared memory. The
+// SharedArrayBuffer keeps a weak External that points here under a private
+// symbol, and the reference goes away with it. V8 doesn't run weak callbacks
+// when an isolate is disposed, so the Environment also keeps track of them.
+class SABLifetimePartner {
+ public:
+  SABLifetimePartner(Environment* env,
+                     std::shared_ptr<SharedArrayBufferMetadata> reference);
+  ~SABLifetimePartner();
+
+  // Returns the partner of |target|, nullptr if it has none, or Nothing if
+  // an exception is pending.
+  static v8::Maybe<SABLifetimePartner*> Get(
+      Environment* env,
+      v8::Local<v8::Context> context,
+      v8::Local<v8::SharedArrayBuffer> target);
+
+  // Stores the partner on |target|, and lets it go away with it.
+  v8::Maybe<bool> AttachTo(v8::Local<v8::Context> context,
+                           v8::Local<v8::SharedArrayBuffer> target);
+
+  const std::shared_ptr<SharedArrayBufferMetadata>& reference() const {
+    return reference_;
+  }
+
+ private:
+  static void WeakCallback(
+      const v8::WeakCallbackInfo<SABLifetimePartner>& data);
+
+  Environment* const env_;
+  const std::shared_ptr<SharedArrayBufferMetadata> reference_;
+  v8::Persistent<v8::External> handle_;
+
+  DISALLOW_COPY_AND_ASSIGN(SABLifetimePartner);
+};
+
+// A value serialized with v8::ValueSerializer, together with the contents of
+// the ArrayBuffers that were transferred rather than copied and the memory of
+// the SharedArrayBuffers in it. A Message is created on one thread and
+// deserialized on another.
+class Message {
+ public:
+  Message() = default;
+  Message(Message&& other);
+  Message& operator=(Message&& other);
+  ~Message();
+
+  // Serializes |input| in |env|. The ArrayBuffers in |transfer_list|, which is
+  // undefined or an array, are neutered and their memory moves with the
+  // message. SharedArrayBuffers in |input| are shared with the receiver.
+  // Throws and returns Nothing if |input| can't be serialized.
+  v8::Maybe<bool> Serialize(Environment* env,
+                            v8::Local<v8::Context> context,
+                            v8::Local<v8::Value> input,
+                            v8::Local<v8::Value> transfer_list);
+
+  // Deserializes the message in |env|, which then owns the memory of the
+  // transferred ArrayBuffers. A message can only be deserialized once.
+  v8::MaybeLocal<v8::Value> Deserialize(Environment* env,
+                                        v8::Local<v8::Context> context);
+
+  // Adds shared memory to the message while it is serialized.
+  void AddSharedArrayBuffer(
+      const std::shared_ptr<SharedArrayBufferMetadata>& reference);
+
+ private:
+  // The memory of a transferred ArrayBuffer, from malloc().
+  struct TransferredBuffer {
+    void* data;
+    size_t length;
+  };
+
+  std::vector<uint8_t> data_;
+  std::vector<TransferredBuffer> array_buffers_;
+  std::vector<std::shared_ptr<SharedArrayBufferMetadata>> shared_array_buffers_;
+};
+
+class MessagePort;
+
+// The queue of messages of one end of a channel. It is not tied to a thread
+// or to a MessagePort, so that the end of a channel that a Worker gets can be
+// created before the thread that uses it. Both ends of a channel share one
+// mutex, which they keep when the channel is taken apart.
+class MessagePortData {
+ public:
+  MessagePortData();
+  ~MessagePortData();
+
+  // Links |a| and |b| into a channel. Neither may be part of one yet.
+  static void Entangle(MessagePortData* a, MessagePortData* b);
+
+  // Queues |message| on the other end of the channel. Does nothing once the
+  // other end is gone.
+  void PostMessage(Message&& message);
+
+  // Takes the oldest message off this end. Returns false if there is none.
+  bool NextMessage(Message* message);
+
+  // Makes |port| the MessagePort that is notified of incoming messages, or
+  // nobody if |port| is nullptr.
+  void set_owner(MessagePort* port);
+
+ private:
+  void Disentangle();
+
+  std::shared_ptr<Mutex> mutex_;
+  MessagePortData* sibling_ = nullptr;
+  MessagePort* owner_ = nullptr;
+  std::deque<Message> incoming_messages_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessagePortData);
+};
+
+// The end of a channel that an Environment sees. postMessage(value,
+// transferList) sends |value| to the other end, whose onmessage(value) is
+// called on its own thread. A port doesn't keep the event loop alive until
+// it is ref()ed.
+class MessagePort : public HandleWrap {
+ public:
+  // Returns the port of |data| in |env|, a new channel end if |data| is
+  // nullptr, or nullptr if the object could not be created.
+  static MessagePort* New(Environment* env,
+                          v8::Local<v8::Context> context,
+                          std::unique_ptr<MessagePortData> data = nullptr);
+
+  // Returns the constructor of MessagePort objects in |env|.
+  static v8::Local<v8::FunctionTemplate> GetConstructorTemplate(
+      Environment* env);
+
+  ~MessagePort() override;
+
+  MessagePortData* data() const { return data_.get(); }
+
+  // Calls onmessage() for each queued message, in order.
+  void OnMessage();
+
+  // Wakes the port up on its own thread to handle incoming messages.
+  void TriggerAsync();
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  MessagePort(Environment* env,
+              v8::Local<v8::Object> wrap,
+              std::unique_ptr<MessagePortData> data);
+
+  void OnBeforeClose() override;
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void PostMessage(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  std::unique_ptr<MessagePortData> data_;
+  uv_async_t async_;
+};
+
+}  // namespace worker
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_MESSAGING_H_
@@ -227,6 +227,109 @@ static void GetLoadAvg(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// The layout of the Float64Array that GetStats() fills in. lib/os.js and
+// doc/api/os.md have to match it.
+enum StatsFields {
+  kLoadAvg1,
+  kLoadAvg5,
+  kLoadAvg15,
+  kFreeMem,
+  kTotalMem,
+  kUptime,
+  kProcessUserCPU,
+  kProcessSystemCPU,
+  kUtilization,
+  kCPUCount,
+  kStatsHeaderFields
+};
+
+enum CPUStatsFields {
+  kCPUUser,
+  kCPUNice,
+  kCPUSys,
+  kCPUIdle,
+  kCPUIrq,
+  kCPUUtilization,
+  kCPUStatsFields
+};
+
+// The share of |total| milliseconds, since the last sample, that a CPU was
+// not idle.
+static double Utilization(double busy, double total) {
+  return total > 0 ? busy / total : 0;
+}
+
+// Fills in the Float64Array in args[0] with the system and process
+// statistics in one go, if it has the length that they take, and returns
+// that length. The array is expected to hold the previous sample, or zeros,
+// and the utilizations are computed against the CPU times in there.
+static void GetStats(const FunctionCallbackInfo<Value>& args) {
+  uv_cpu_info_t* cpu_infos;
+  int count;
+  if (uv_cpu_info(&cpu_infos, &count) != 0) {
+    cpu_infos = nullptr;
+    count = 0;
+  }
+
+  const size_t length = kStatsHeaderFields + count * kCPUStatsFields;
+  args.GetReturnValue().Set(static_cast<double>(length));
+
+  if (!args[0]->IsFloat64Array() ||
+      args[0].As<Float64Array>()->Length() != length) {
+    if (cpu_infos != nullptr)
+      uv_free_cpu_info(cpu_infos, count);
+    return;
+  }
+
+  Local<Float64Array> array = args[0].As<Float64Array>();
+  double* fields = static_cast<double*>(array->Buffer()->GetContents().Data()) +
+                   array->ByteOffset() / sizeof(double);
+
+  uv_loadavg(fields + kLoadAvg1);
+  fields[kFreeMem] = static_cast<double>(uv_get_free_memory());
+  fields[kTotalMem] = static_cast<double>(uv_get_total_memory());
+  double uptime;
+  fields[kUptime] = uv_uptime(&uptime) == 0 ? uptime : 0;
+
+  uv_rusage_t rusage;
+  if (uv_getrusage(&rusage) == 0) {
+    fields[kProcessUserCPU] = 1e6 * rusage.ru_utime.tv_sec +
+                              rusage.ru_utime.tv_usec;
+    fields[kProcessSystemCPU] = 1e6 * rusage.ru_stime.tv_sec +
+                                rusage.ru_stime.tv_usec;
+  }
+
+  double all_busy = 0;
+  double all_total = 0;
+  for (int i = 0; i < count; i++) {
+    const auto& times = cpu_infos[i].cpu_times;
+    double* cpu = fields + kStatsHeaderFields + i * kCPUStatsFields;
+    const double busy = times.user + times.nice + times.sys + times.irq;
+    const double total = busy + times.idle;
+    const double prev_busy =
+        cpu[kCPUUser] + cpu[kCPUNice] + cpu[kCPUSys] + cpu[kCPUIrq];
+    const double prev_total = prev_busy + cpu[kCPUIdle];
+    // The counters only go back if the CPU went offline in between.
+    const double busy_delta = busy >= prev_busy ? busy - prev_busy : busy;
+    const double total_delta = total >= prev_total ? total - prev_total : total;
+
+    cpu[kCPUUser] = times.user;
+    cpu[kCPUNice] = times.nice;
+    cpu[kCPUSys] = times.sys;
+    cpu[kCPUIdle] = times.idle;
+    cpu[kCPUIrq] = times.irq;
+    cpu[kCPUUtilization] = Utilization(busy_delta, total_delta);
+    all_busy += busy_delta;
+    all_total += total_delta;
+  }
+  fields[kUtilization] = Utilization(all_busy, all_total);
+  fields[kCPUCount] = count;
+
+  if (cpu_infos != nullptr)
+    uv_free_cpu_info(cpu_infos, count);
+}
+
+
 static void GetInterfaceAddresses(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   uv_interface_address_t* interfaces;
@@ -414,6 +517,7 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "getTotalMem", GetTotalMemory);
   env->SetMethod(target, "getFreeMem", GetFreeMemory);
   env->SetMethod(target, "getCPUs", GetCPUInfo);
+  env->SetMethod(target, "getStats", GetStats);
   env->SetMethod(target, "getOSType", GetOSType);
   env->SetMethod(target, "getOSRelease", GetOSRelease);
   env->SetMethod(target, "getInterfaceAddresses", GetInterfaceAddresses);
@@ -0,0 +1,228 @@
+#include "node.h"
+#include "env.h"
+#include "env-inl.h"
+#include "util.h"
+#include "util-inl.h"
+#include "v8.h"
+
+#include <string.h>
+
+namespace node {
+namespace path {
+
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::Local;
+using v8::NewStringType;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+namespace {
+
+template <typename T>
+inline bool IsSeparator(T code, bool win32) {
+  return code == '/' || (win32 && code == '\\');
+}
+
+
+// Resolves the . and .. segments of |path| into |out|, which has room for
+// at least |length| characters, and returns the length of the result. That
+// has no leading or trailing separator, and separates segments with '\' for
+// win32 and '/' otherwise. Above the root, .. segments are kept if
+// |allow_above_root| and dropped if not.
+template <typename T>
+size_t NormalizeSegments(const T* path,
+                         size_t length,
+                         bool allow_above_root,
+                         bool win32,
+                         T* out) {
+  const T sep = win32 ? '\\' : '/';
+  size_t res = 0;
+  // Where the current segment starts, one past the separator before it.
+  size_t last_slash = 0;
+  int dots = 0;
+  T code = 0;
+  for (size_t i = 0; i <= length; ++i) {
+    if (i < length)
+      code = path[i];
+    else if (IsSeparator(code, win32))
+      break;
+    else
+      code = '/';
+
+    if (!IsSeparator(code, win32)) {
+      if (code == '.' && dots != -1)
+        ++dots;
+      else
+        dots = -1;
+      continue;
+    }
+
+    if (last_slash == i || dots == 1) {
+      // An empty or . segment.
+    } else if (dots == 2) {
+      // Unless the result already ends in a .. segment, drop its last one.
+      if (res < 2 || out[res - 1] != '.' || out[res - 2] != '.') {
+        if (res > 2) {
+          size_t j = res;
+          while (j > 0 && out[j - 1] != sep)
+            --j;
+          res = j > 0 ? j - 1 : 0;
+          last_slash = i + 1;
+          dots = 0;
+          continue;
+        } else if (res == 2 || res == 1) {
+          res = 0;
+          last_slash = i + 1;
+          dots = 0;
+          continue;
+        }
+      }
+      if (allow_above_root) {
+        if (res > 0)
+          out[res++] = sep;
+        out[res++] = '.';
+        out[res++] = '.';
+      }
+    } else {
+      if (res > 0)
+        out[res++] = sep;
+      memcpy(out + res, path + last_slash, (i - last_slash) * sizeof(*out));
+      res += i - last_slash;
+    }
+    last_slash = i + 1;
+    dots = 0;
+  }
+  return res;
+}
+
+
+// Like path.posix.normalize(), and path.posix.resolve() if
+// |keep_trailing_separator| is false.
+template <typename T>
+size_t NormalizePosixPath(const T* path,
+                          size_t length,
+                          bool keep_trailing_separator,
+                          T* out) {
+  if (length == 0) {
+    out[0] = '.';
+    return 1;
+  }
+
+  const bool is_absolute = path[0] == '/';
+  const bool trailing_separator =
+      keep_trailing_separator && path[length - 1] == '/';
+  // The leading separator of an absolute path isn't part of any segment,
+  // which leaves room for it.
+  const size_t offset = is_absolute ? 1 : 0;
+  size_t res =
+      NormalizeSegments(path, length, !is_absolute, false, out + offset);
+
+  if (res == 0 && !is_absolute)
+    out[res++] = '.';
+  if (res > 0 && trailing_separator)
+    out[offset + res++] = '/';
+  if (is_absolute)
+    out[0] = '/';
+  return offset + res;
+}
+
+
+template <typename T>
+struct Normalize {
+  explicit Normalize(bool win32, bool allow_above_root)
+      : win32(win32), allow_above_root(allow_above_root) {}
+
+  size_t operator()(const T* path, size_t length, T* out) const {
+    return NormalizeSegments(path, length, allow_above_root, win32, out);
+  }
+
+  const bool win32;
+  const bool allow_above_root;
+};
+
+
+template <typename T>
+struct PosixNormalize {
+  explicit PosixNormalize(bool keep_trailing_separator)
+      : keep_trailing_separator(keep_trailing_separator) {}
+
+  size_t operator()(const T* path, size_t length, T* out) const {
+    return NormalizePosixPath(path, length, keep_trailing_separator, out);
+  }
+
+  const bool keep_trailing_separator;
+};
+
+
+// Runs |fn| over the characters of |string|, with one-byte strings read as
+// such, and returns the result as a new string, or |string| itself if that
+// is what the result is.
+template <template <typename> class Fn, typename... Args>
+void Run(const FunctionCallbackInfo<Value>& args,
+         Local<String> string,
+         Args... fn_args) {
+  Environment* env = Environment::GetCurrent(args);
+  const size_t length = string->Length();
+  // The result is never longer than the input, or than "." for an empty
+  // input.
+  const size_t capacity = length + 1;
+
+  if (string->IsOneByte() || string->ContainsOnlyOneByte()) {
+    MaybeStackBuffer<uint8_t> in(length);
+    MaybeStackBuffer<uint8_t> out(capacity);
+    string->WriteOneByte(*in, 0, length, String::NO_NULL_TERMINATION);
+    const size_t result = Fn<uint8_t>(fn_args...)(*in, length, *out);
+    if (result == length && memcmp(*in, *out, length) == 0)
+      return args.GetReturnValue().Set(string);
+    return args.GetReturnValue().Set(
+        String::NewFromOneByte(env->isolate(),
+                               *out,
+                               NewStringType::kNormal,
+                               result).ToLocalChecked());
+  }
+
+  MaybeStackBuffer<uint16_t> in(length);
+  MaybeStackBuffer<uint16_t> out(capacity);
+  string->Write(*in, 0, length, String::NO_NULL_TERMINATION);
+  const size_t result = Fn<uint16_t>(fn_args...)(*in, length, *out);
+  if (result == length && memcmp(*in, *out, length * sizeof(**in)) == 0)
+    return args.GetReturnValue().Set(string);
+  args.GetReturnValue().Set(
+      String::NewFromTwoByte(env->isolate(),
+                             *out,
+                             NewStringType::kNormal,
+                             result).ToLocalChecked());
+}
+
+}  // anonymous namespace
+
+
+// normalizeString(path, allowAboveRoot, win32)
+void NormalizeString(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsString());
+  Run<Normalize>(args, args[0].As<String>(),
+                 args[2]->IsTrue(), args[1]->IsTrue());
+}
+
+
+// normalizePosix(path, keepTrailingSeparator)
+void NormalizePosix(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsString());
+  Run<PosixNormalize>(args, args[0].As<String>(), args[1]->IsTrue());
+}
+
+
+void Initialize(Local<Object> target,
+                Local<Value> unused,
+                Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  env->SetMethod(target, "normalizeString", NormalizeString);
+  env->SetMethod(target, "normalizePosix", NormalizePosix);
+}
+
+}  // namespace path
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(path, node::path::Initialize)
@@ -0,0 +1,161 @@
+#include "node_platform.h"
+#include "node_threadpool.h"
+#include "util.h"
+#include "util-inl.h"
+#include "uv.h"
+
+namespace node {
+
+using v8::GCCallbackFlags;
+using v8::GCType;
+using v8::Isolate;
+using v8::Task;
+
+namespace {
+
+// Set while the isolate of the calling thread collects garbage.
+uv_once_t in_gc_once = UV_ONCE_INIT;
+uv_key_t in_gc_key;
+
+void CreateInGCKey() {
+  CHECK_EQ(0, uv_key_create(&in_gc_key));
+}
+
+void OnGCPrologue(Isolate* isolate, GCType type, GCCallbackFlags flags) {
+  uv_key_set(&in_gc_key, &in_gc_key);
+}
+
+void OnGCEpilogue(Isolate* isolate, GCType type, GCCallbackFlags flags) {
+  uv_key_set(&in_gc_key, nullptr);
+}
+
+}  // anonymous namespace
+
+
+NodePlatform::NodePlatform(v8::Platform* default_platform)
+    : default_platform_(default_platform) {
+  uv_once(&in_gc_once, CreateInGCKey);
+}
+
+
+NodePlatform::~NodePlatform() {
+  delete default_platform_;
+}
+
+
+void NodePlatform::RegisterIsolate(Isolate* isolate) {
+  uv_once(&in_gc_once, CreateInGCKey);
+  isolate->AddGCPrologueCallback(OnGCPrologue);
+  isolate->AddGCEpilogueCallback(OnGCEpilogue);
+}
+
+
+size_t NodePlatform::NumberOfAvailableBackgroundThreads() {
+  return threadpool::Threads(threadpool::kCpuWork);
+}
+
+
+void NodePlatform::CallOnBackgroundThread(Task* task,
+                                          ExpectedRuntime expected_runtime) {
+  // V8 doesn't say what the task is for. Sweeping, compaction and the other
+  // tasks that a collection posts are posted from within the collection, on
+  // the thread of the isolate.
+  const bool in_gc = uv_key_get(&in_gc_key) != nullptr;
+  threadpool::PostTask(threadpool::kCpuWork,
+                       in_gc ? threadpool::kHighPriority :
+                               threadpool::kLowPriority,
+                       RunTask,
+                       task);
+}
+
+
+void NodePlatform::RunTask(void* data) {
+  Task* task = static_cast<Task*>(data);
+  task->Run();
+  delete task;
+}
+
+
+void NodePlatform::CallOnForegroundThread(Isolate* isolate, Task* task) {
+  default_platform_->CallOnForegroundThread(isolate, task);
+}
+
+
+void NodePlatform::CallDelayedOnForegroundThread(Isolate* isolate,
+                                                 Task* task,
+                                                 double delay_in_seconds) {
+  default_platform_->CallDelayedOnForegroundThread(isolate, task,
+                                                   delay_in_seconds);
+}
+
+
+void NodePlatform::CallIdleOnForegroundThread(Isolate* isolate,
+                                              v8::IdleTask* task) {
+  default_platform_->CallIdleOnForegroundThread(isolate, task);
+}
+
+
+bool NodePlatform::IdleTasksEnabled(Isolate* isolate) {
+  return default_platform_->IdleTasksEnabled(isolate);
+}
+
+
+double NodePlatform::MonotonicallyIncreasingTime() {
+  return default_platform_->MonotonicallyIncreasingTime();
+}
+
+
+const uint8_t* NodePlatform::GetCategoryGroupEnabled(const char* name) {
+  return default_platform_->GetCategoryGroupEnabled(name);
+}
+
+
+const char* NodePlatform::GetCategoryGroupName(
+    const uint8_t* category_enabled_flag) {
+  return default_platform_->GetCategoryGroupName(category_enabled_flag);
+}
+
+
+uint64_t NodePlatform::AddTraceEvent(
+    char phase, const uint8_t* category_enabled_flag, const char* name,
+    const char* scope, uint64_t id, uint64_t bind_id, int32_t num_args,
+    const char** arg_names, const uint8_t* arg_types,
+    const uint64_t* arg_values, unsigned int flags) {
+  return default_platform_->AddTraceEvent(phase, category_enabled_flag, name,
+                                          scope, id, bind_id, num_args,
+                                          arg_names, arg_types, arg_values,
+                                          flags);
+}
+
+
+uint64_t NodePlatform::AddTraceEvent(
+    char phase, const uint8_t* category_enabled_flag, const char* name,
+    const char* scope, uint64_t id, uint64_t bind_id, int32_t num_args,
+    const char** arg_names, const uint8_t* arg_types,
+    const uint64_t* arg_values,
+    std::unique_ptr<v8::ConvertableToTraceFormat>* arg_convertables,
+    unsigned int flags) {
+  return default_platform_->AddTraceEvent(phase, category_enabled_flag, name,
+                                          scope, id, bind_id, num_args,
+                                          arg_names, arg_types, arg_values,
+                                          arg_convertables, flags);
+}
+
+
+void NodePlatform::UpdateTraceEventDuration(
+    const uint8_t* category_enabled_flag, const char* name, uint64_t handle) {
+  default_platform_->UpdateTraceEventDuration(category_enabled_flag, name,
+                                              handle);
+}
+
+
+void NodePlatform::AddTraceStateObserver(TraceStateObserver* observer) {
+  default_platform_->AddTraceStateObserver(observer);
+}
+
+
+void NodePlatform::RemoveTraceStateObserver(TraceStateObserver* observer) {
+  default_platform_->RemoveTraceStateObserver(observer);
+}
+
+}  // namespace node
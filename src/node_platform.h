@@ -0,0 +1,80 @@
+#ifndef SRC_NODE_PLATFORM_H_
+#define SRC_NODE_PLATFORM_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "v8.h"
+#include "v8-platform.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace node {
+
+// The v8::Platform that node runs V8 with. V8's background tasks, the
+// parallel and concurrent parts of garbage collections and off thread
+// compilation, run on the threads of node's CPU pool, see node_threadpool.h,
+// next to crypto and compression work, instead of on threads of their own
+// that are sized and scheduled without regard to node's. The ones that V8
+// posts during a garbage collection go ahead of node's work, and the others
+// go after it.
+//
+// Everything else, the foreground tasks of each isolate and tracing, is
+// handled by |default_platform|, which has to be one that
+// v8::platform::CreateDefaultPlatform() made, and which is the platform to
+// pass to v8::platform::PumpMessageLoop() and the like.
+class NodePlatform : public v8::Platform {
+ public:
+  // Takes ownership of |default_platform|.
+  explicit NodePlatform(v8::Platform* default_platform);
+  ~NodePlatform() override;
+
+  // Lets the tasks that V8 posts while |isolate| collects garbage be told
+  // apart from the others.
+  static void RegisterIsolate(v8::Isolate* isolate);
+
+  v8::Platform* default_platform() const { return default_platform_; }
+
+  size_t NumberOfAvailableBackgroundThreads() override;
+  void CallOnBackgroundThread(v8::Task* task,
+                              ExpectedRuntime expected_runtime) override;
+  void CallOnForegroundThread(v8::Isolate* isolate, v8::Task* task) override;
+  void CallDelayedOnForegroundThread(v8::Isolate* isolate,
+                                     v8::Task* task,
+                                     double delay_in_seconds) override;
+  void CallIdleOnForegroundThread(v8::Isolate* isolate,
+                                  v8::IdleTask* task) override;
+  bool IdleTasksEnabled(v8::Isolate* isolate) override;
+  double MonotonicallyIncreasingTime() override;
+
+  const uint8_t* GetCategoryGroupEnabled(const char* name) override;
+  const char* GetCategoryGroupName(
+      const uint8_t* category_enabled_flag) override;
+  uint64_t AddTraceEvent(
+      char phase, const uint8_t* category_enabled_flag, const char* name,
+      const char* scope, uint64_t id, uint64_t bind_id, int32_t num_args,
+      const char** arg_names, const uint8_t* arg_types,
+      const uint64_t* arg_values, unsigned int flags) override;
+  uint64_t AddTraceEvent(
+      char phase, const uint8_t* category_enabled_flag, const char* name,
+      const char* scope, uint64_t id, uint64_t bind_id, int32_t num_args,
+      const char** arg_names, const uint8_t* arg_types,
+      const uint64_t* arg_values,
+      std::unique_ptr<v8::ConvertableToTraceFormat>* arg_convertables,
+      unsigned int flags) override;
+  void UpdateTraceEventDuration(const uint8_t* category_enabled_flag,
+                                const char* name, uint64_t handle) override;
+  void AddTraceStateObserver(TraceStateObserver* observer) override;
+  void RemoveTraceStateObserver(TraceStateObserver* observer) override;
+
+ private:
+  static void RunTask(void* data);
+
+  v8::Platform* const default_platform_;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_PLATFORM_H_
@@ -0,0 +1,40 @@
+#ifndef SRC_NODE_PROBES_H_
+#define SRC_NODE_PROBES_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+// The probes of src/node_provider.d that are fired from native code. With
+// --with-dtrace they are DTrace probes, or on Linux SystemTap USDT probes
+// that bpftrace can attach to, which cost a nop until something attaches.
+// Check the _ENABLED() macro of a probe before computing its arguments.
+// Without DTrace they compile to nothing.
+#ifdef HAVE_DTRACE
+#include "node_provider.h"
+#else
+#define NODE_ASYNC_INIT(arg0, arg1, arg2) do { } while (false)
+#define NODE_ASYNC_INIT_ENABLED() (false)
+#define NODE_ASYNC_BEFORE(arg0, arg1) do { } while (false)
+#define NODE_ASYNC_BEFORE_ENABLED() (false)
+#define NODE_ASYNC_AFTER(arg0, arg1) do { } while (false)
+#define NODE_ASYNC_AFTER_ENABLED() (false)
+#define NODE_ASYNC_DESTROY(arg0, arg1) do { } while (false)
+#define NODE_ASYNC_DESTROY_ENABLED() (false)
+#define NODE_FS_START(arg0, arg1) do { } while (false)
+#define NODE_FS_START_ENABLED() (false)
+#define NODE_FS_DONE(arg0, arg1, arg2) do { } while (false)
+#define NODE_FS_DONE_ENABLED() (false)
+#define NODE_HTTP_PARSER_BEGIN(arg0, arg1) do { } while (false)
+#define NODE_HTTP_PARSER_BEGIN_ENABLED() (false)
+#define NODE_HTTP_PARSER_COMPLETE(arg0, arg1) do { } while (false)
+#define NODE_HTTP_PARSER_COMPLETE_ENABLED() (false)
+#define NODE_NET_STREAM_READ(arg0, arg1, arg2) do { } while (false)
+#define NODE_NET_STREAM_READ_ENABLED() (false)
+#define NODE_NET_STREAM_WRITE(arg0, arg1, arg2) do { } while (false)
+#define NODE_NET_STREAM_WRITE_ENABLED() (false)
+#define NODE_TIMER_FIRE(arg0, arg1) do { } while (false)
+#define NODE_TIMER_FIRE_ENABLED() (false)
+#endif
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_PROBES_H_
@@ -6,14 +6,24 @@
 #include "env-inl.h"
 #include "v8.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 namespace node {
 
 using v8::Array;
 using v8::ArrayBuffer;
+using v8::ArrayBufferView;
 using v8::Context;
+using v8::DataView;
+using v8::Float32Array;
+using v8::Float64Array;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
+using v8::Int16Array;
+using v8::Int32Array;
+using v8::Int8Array;
 using v8::Integer;
 using v8::Isolate;
 using v8::Just;
@@ -24,6 +34,10 @@ using v8::Nothing;
 using v8::Object;
 using v8::SharedArrayBuffer;
 using v8::String;
+using v8::Uint16Array;
+using v8::Uint32Array;
+using v8::Uint8Array;
+using v8::Uint8ClampedArray;
 using v8::Value;
 using v8::ValueDeserializer;
 using v8::ValueSerializer;
@@ -270,7 +284,7 @@ DeserializerContext::DeserializerContext(Environment* env,
                                          Local<Object> wrap,
                                          Local<Value> buffer)
   : BaseObject(env, wrap),
-    data_(reinterpret_cast<const uint8_t*>(Buffer::Data(buffer))),
+    data_(reinterpret_cast<const uint8_t*>(Buffer::Data(buffer.As<Object>()))),
     length_(Buffer::Length(buffer)),
     deserializer_(env->isolate(), data_, length_, this) {
   object()->Set(env->context(), env->buffer_string(), buffer).FromJust();
@@ -428,6 +442,277 @@ void DeserializerContext::ReadRawBytes(
   args.GetReturnValue().Set(offset);
 }
 
+// The host object types that v8.serialize() and v8.deserialize() write and
+// read. These have to match the indices into arrayBufferViewTypes in
+// lib/v8.js, so that DefaultSerializer and DefaultDeserializer stay
+// compatible with them.
+enum HostObjectType {
+  kInt8Array,
+  kUint8Array,
+  kUint8ClampedArray,
+  kInt16Array,
+  kUint16Array,
+  kInt32Array,
+  kUint32Array,
+  kFloat32Array,
+  kFloat64Array,
+  kDataView,
+  kBuffer,
+  kHostObjectTypeCount
+};
+
+static size_t ElementSize(uint32_t type) {
+  switch (type) {
+    case kInt16Array:
+    case kUint16Array:
+      return 2;
+    case kInt32Array:
+    case kUint32Array:
+    case kFloat32Array:
+      return 4;
+    case kFloat64Array:
+      return 8;
+    default:
+      return 1;
+  }
+}
+
+static uint32_t GetHostObjectType(Environment* env,
+                                  Local<ArrayBufferView> view) {
+  if (view->IsUint8Array()) {
+    Local<Value> proto = view->GetPrototype();
+    return proto == env->buffer_prototype_object() ? kBuffer : kUint8Array;
+  }
+  if (view->IsInt8Array()) return kInt8Array;
+  if (view->IsUint8ClampedArray()) return kUint8ClampedArray;
+  if (view->IsInt16Array()) return kInt16Array;
+  if (view->IsUint16Array()) return kUint16Array;
+  if (view->IsInt32Array()) return kInt32Array;
+  if (view->IsUint32Array()) return kUint32Array;
+  if (view->IsFloat32Array()) return kFloat32Array;
+  if (view->IsFloat64Array()) return kFloat64Array;
+  CHECK(view->IsDataView());
+  return kDataView;
+}
+
+static Local<Uint8Array> NewBufferView(Environment* env,
+                                       Local<ArrayBuffer> ab,
+                                       size_t byte_offset,
+                                       size_t length) {
+  Local<Uint8Array> ui = Uint8Array::New(ab, byte_offset, length);
+  ui->SetPrototype(env->context(), env->buffer_prototype_object()).FromJust();
+  return ui;
+}
+
+// Serializes a value the way DefaultSerializer does, but without calling
+// into JS for the ArrayBufferViews. It writes into |target| for as long as
+// the data fits, and into memory from realloc() after that.
+class FastSerializer : public ValueSerializer::Delegate {
+ public:
+  FastSerializer(Environment* env, char* target, size_t target_length)
+    : env_(env),
+      target_(target),
+      target_length_(target_length),
+      serializer_(env->isolate(), this) {
+    serializer_.SetTreatArrayBufferViewsAsHostObjects(true);
+  }
+
+  void ThrowDataCloneError(Local<String> message) override;
+  Maybe<bool> WriteHostObject(Isolate* isolate, Local<Object> object) override;
+  void* ReallocateBufferMemory(void* old_buffer,
+                               size_t size,
+                               size_t* actual_size) override;
+  void FreeBufferMemory(void* buffer) override;
+
+  ValueSerializer* serializer() { return &serializer_; }
+
+ private:
+  Environment* const env_;
+  char* const target_;
+  const size_t target_length_;
+  ValueSerializer serializer_;
+};
+
+void FastSerializer::ThrowDataCloneError(Local<String> message) {
+  env_->isolate()->ThrowException(v8::Exception::Error(message));
+}
+
+Maybe<bool> FastSerializer::WriteHostObject(Isolate* isolate,
+                                            Local<Object> object) {
+  if (!object->IsArrayBufferView()) {
+    Local<String> tag;
+    if (!object->ObjectProtoToString(env_->context()).ToLocal(&tag))
+      return Nothing<bool>();
+    ThrowDataCloneError(String::Concat(
+        FIXED_ONE_BYTE_STRING(isolate, "Unknown host object type: "), tag));
+    return Nothing<bool>();
+  }
+
+  Local<ArrayBufferView> view = object.As<ArrayBufferView>();
+  const size_t byte_length = view->ByteLength();
+  const char* data =
+      static_cast<const char*>(view->Buffer()->GetContents().Data()) +
+      view->ByteOffset();
+  serializer_.WriteUint32(GetHostObjectType(env_, view));
+  serializer_.WriteUint32(byte_length);
+  serializer_.WriteRawBytes(data, byte_length);
+  return Just(true);
+}
+
+void* FastSerializer::ReallocateBufferMemory(void* old_buffer,
+                                             size_t size,
+                                             size_t* actual_size) {
+  if (target_ != nullptr && old_buffer == nullptr && size <= target_length_) {
+    *actual_size = target_length_;
+    return target_;
+  }
+  void* buffer;
+  if (target_ != nullptr && old_buffer == target_) {
+    buffer = malloc(size);
+    if (buffer != nullptr)
+      memcpy(buffer, target_, target_length_);
+  } else {
+    buffer = realloc(old_buffer, size);
+  }
+  if (buffer != nullptr)
+    *actual_size = size;
+  return buffer;
+}
+
+void FastSerializer::FreeBufferMemory(void* buffer) {
+  if (buffer != target_)
+    free(buffer);
+}
+
+// Reads what FastSerializer or DefaultSerializer wrote. Like
+// DefaultDeserializer, it returns views on |buffer| where the alignment
+// allows and copies otherwise.
+class FastDeserializer : public ValueDeserializer::Delegate {
+ public:
+  FastDeserializer(Environment* env, Local<Value> buffer)
+    : env_(env),
+      buffer_(buffer.As<Uint8Array>()),
+      data_(reinterpret_cast<const uint8_t*>(Buffer::Data(buffer))),
+      deserializer_(env->isolate(), data_, Buffer::Length(buffer), this) {}
+
+  MaybeLocal<Object> ReadHostObject(Isolate* isolate) override;
+
+  ValueDeserializer* deserializer() { return &deserializer_; }
+
+ private:
+  Environment* const env_;
+  Local<Uint8Array> buffer_;
+  const uint8_t* const data_;
+  ValueDeserializer deserializer_;
+};
+
+MaybeLocal<Object> FastDeserializer::ReadHostObject(Isolate* isolate) {
+  uint32_t type;
+  uint32_t byte_length;
+  const void* data;
+  if (!deserializer_.ReadUint32(&type) ||
+      !deserializer_.ReadUint32(&byte_length) ||
+      !deserializer_.ReadRawBytes(byte_length, &data)) {
+    env_->ThrowError("Unable to deserialize host object");
+    return MaybeLocal<Object>();
+  }
+  if (type >= kHostObjectTypeCount) {
+    env_->ThrowError("Unknown host object type");
+    return MaybeLocal<Object>();
+  }
+  const size_t element_size = ElementSize(type);
+  if (byte_length % element_size != 0) {
+    env_->ThrowRangeError("Invalid host object length");
+    return MaybeLocal<Object>();
+  }
+
+  Local<ArrayBuffer> ab = buffer_->Buffer();
+  size_t offset = buffer_->ByteOffset() +
+                  (static_cast<const uint8_t*>(data) - data_);
+  if (offset % element_size != 0) {
+    ab = ArrayBuffer::New(isolate, byte_length);
+    memcpy(ab->GetContents().Data(), data, byte_length);
+    offset = 0;
+  }
+
+  const size_t length = byte_length / element_size;
+  switch (type) {
+    case kInt8Array:
+      return Int8Array::New(ab, offset, length);
+    case kUint8Array:
+      return Uint8Array::New(ab, offset, length);
+    case kUint8ClampedArray:
+      return Uint8ClampedArray::New(ab, offset, length);
+    case kInt16Array:
+      return Int16Array::New(ab, offset, length);
+    case kUint16Array:
+      return Uint16Array::New(ab, offset, length);
+    case kInt32Array:
+      return Int32Array::New(ab, offset, length);
+    case kUint32Array:
+      return Uint32Array::New(ab, offset, length);
+    case kFloat32Array:
+      return Float32Array::New(ab, offset, length);
+    case kFloat64Array:
+      return Float64Array::New(ab, offset, length);
+    case kDataView:
+      return DataView::New(ab, offset, length);
+    default:
+      CHECK_EQ(type, kBuffer);
+      return NewBufferView(env_, ab, offset, length);
+  }
+}
+
+// serialize(value[, target]) returns a Buffer with the serialized value.
+// If it fits into |target|, the Buffer is a slice of |target|.
+void Serialize(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  char* target = nullptr;
+  size_t target_length = 0;
+  if (args[1]->IsUint8Array()) {
+    target = Buffer::Data(args[1]);
+    target_length = Buffer::Length(args[1]);
+  } else if (!args[1]->IsUndefined()) {
+    return env->ThrowTypeError("target must be a Uint8Array");
+  }
+
+  FastSerializer ctx(env, target, target_length);
+  ValueSerializer* serializer = ctx.serializer();
+  serializer->WriteHeader();
+  if (serializer->WriteValue(env->context(), args[0]).IsNothing())
+    return;
+
+  std::pair<uint8_t*, size_t> ret = serializer->Release();
+  char* data = reinterpret_cast<char*>(ret.first);
+  if (data == target && target != nullptr) {
+    Local<Uint8Array> ui = args[1].As<Uint8Array>();
+    return args.GetReturnValue().Set(
+        NewBufferView(env, ui->Buffer(), ui->ByteOffset(), ret.second));
+  }
+
+  Local<Object> buf;
+  if (Buffer::New(env, data, ret.second).ToLocal(&buf))
+    args.GetReturnValue().Set(buf);
+}
+
+void Deserialize(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  if (!args[0]->IsUint8Array()) {
+    return env->ThrowTypeError("buffer must be a Uint8Array");
+  }
+
+  FastDeserializer ctx(env, args[0]);
+  ValueDeserializer* deserializer = ctx.deserializer();
+  if (deserializer->ReadHeader(env->context()).IsNothing())
+    return;
+
+  Local<Value> value;
+  if (deserializer->ReadValue(env->context()).ToLocal(&value))
+    args.GetReturnValue().Set(value);
+}
+
 void InitializeSerdesBindings(Local<Object> target,
                               Local<Value> unused,
                               Local<Context> context) {
@@ -478,6 +763,9 @@ void InitializeSerdesBindings(Local<Object> target,
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "Deserializer"),
               des->GetFunction(env->context()).ToLocalChecked()).FromJust();
+
+  env->SetMethod(target, "serialize", Serialize);
+  env->SetMethod(target, "deserialize", Deserialize);
 }
 
 }  // anonymous namespace
@@ -0,0 +1,668 @@
+#include "node_threadpool.h"
+#include "node_counter_registry.h"
+#include "node_internals.h"
+#include "node_mutex.h"
+#include "util.h"
+#include "util-inl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace node {
+namespace threadpool {
+
+namespace {
+
+// Parses a list of CPUs like "0-3,8", as in taskset -c.
+bool ParseCpuList(const std::string& text, std::vector<unsigned>* cpus) {
+  const char* p = text.c_str();
+  for (;;) {
+    char* end;
+    const unsigned long first = strtoul(p, &end, 10);  // NOLINT(runtime/int)
+    if (end == p || first >= 1024)
+      return false;
+    unsigned long last = first;  // NOLINT(runtime/int)
+    p = end;
+    if (*p == '-') {
+      last = strtoul(p + 1, &end, 10);
+      if (end == p + 1 || last < first || last >= 1024)
+        return false;
+      p = end;
+    }
+    for (unsigned long cpu = first; cpu <= last; cpu++)  // NOLINT(runtime/int)
+      cpus->push_back(static_cast<unsigned>(cpu));
+    if (*p == '\0')
+      return true;
+    if (*p++ != ',')
+      return false;
+  }
+}
+
+// Restricts the calling thread to |cpus|, where the platform allows it.
+void PinThread(const std::vector<unsigned>& cpus) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (unsigned cpu : cpus) {
+    if (cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &set);
+  }
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+  DWORD_PTR mask = 0;
+  for (unsigned cpu : cpus) {
+    if (cpu < sizeof(mask) * 8)
+      mask |= static_cast<DWORD_PTR>(1) << cpu;
+  }
+  if (mask != 0)
+    SetThreadAffinityMask(GetCurrentThread(), mask);
+#endif
+}
+
+// A fixed number of threads, started when the first piece of work is posted,
+// that run work for any number of loops, like those of the main thread and
+// of Workers, and tasks that aren't tied to a loop.
+class Pool {
+ public:
+  Pool(const char* size_variable,
+       const char* affinity_variable,
+       unsigned default_size)
+      : size_variable_(size_variable),
+        affinity_variable_(affinity_variable),
+        default_size_(default_size),
+        pending_count_(0),
+        running_(0),
+        max_pending_(0),
+        completed_(0),
+        wait_time_ns_(0) {
+    for (size_t& skipped : skipped_)
+      skipped = 0;
+  }
+
+  int Queue(uv_loop_t* loop,
+            uv_work_t* req,
+            Priority priority,
+            uv_work_cb work,
+            uv_after_work_cb after) {
+    Completions* completions;
+    {
+      Mutex::ScopedLock lock(mutex_);
+      auto it = completions_.find(loop);
+      completions = it != completions_.end() ? it->second : nullptr;
+    }
+    if (completions == nullptr) {
+      completions = new Completions();
+      completions->pool = this;
+      completions->in_flight = 0;
+      int err = uv_async_init(loop, &completions->async, OnDone);
+      if (err != 0) {
+        delete completions;
+        return err;
+      }
+      Mutex::ScopedLock lock(mutex_);
+      completions_[loop] = completions;
+    }
+    completions->in_flight++;
+
+    Task task;
+    task.completions = completions;
+    task.req = req;
+    task.work = work;
+    task.after = after;
+    task.run = nullptr;
+    task.data = nullptr;
+    Push(task, priority);
+    return 0;
+  }
+
+  // Can be called from any thread, before there is a loop.
+  void Post(Priority priority, void (*run)(void* data), void* data) {
+    Task task;
+    task.completions = nullptr;
+    task.req = nullptr;
+    task.work = nullptr;
+    task.after = nullptr;
+    task.run = run;
+    task.data = data;
+    Push(task, priority);
+  }
+
+  void GetStats(Stats* stats) {
+    Mutex::ScopedLock lock(mutex_);
+    stats->threads = !threads_.empty() ? threads_.size() : Size();
+    stats->pending = pending_count_;
+    stats->running = running_;
+    stats->max_pending = max_pending_;
+    stats->completed = completed_;
+    stats->wait_time_ns = wait_time_ns_;
+  }
+
+  unsigned Threads() {
+    Mutex::ScopedLock lock(mutex_);
+    return !threads_.empty() ? threads_.size() : Size();
+  }
+
+  void SetDefaultSize(unsigned size) {
+    Mutex::ScopedLock lock(mutex_);
+    CHECK(threads_.empty());
+    default_size_ = size;
+  }
+
+ private:
+  struct Completions;
+
+  struct Task {
+    // Work queued with Queue(), or a task posted with Post().
+    Completions* completions;
+    uv_work_t* req;
+    uv_work_cb work;
+    uv_after_work_cb after;
+    void (*run)(void* data);
+    void* data;
+    uint64_t queued_at;
+  };
+
+  // Hands the work of one loop back to it. Created when the loop queues work
+  // while none of its work is in flight, and closed once that is the case
+  // again, so that it keeps the loop alive only while there is work in
+  // flight, the same way uv_queue_work() requests do, and nothing of it is
+  // left when the loop is closed.
+  struct Completions {
+    Pool* pool;
+    uv_async_t async;
+    size_t in_flight;  // Only used on the loop thread.
+    std::deque<Task> done;  // Behind the |mutex_| of the pool.
+  };
+
+  unsigned Size() const {
+    std::string text;
+    if (!SafeGetenv(size_variable_, &text))
+      return default_size_;
+    unsigned size = static_cast<unsigned>(atoi(text.c_str()));
+    if (size < 1)
+      return 1;
+    if (size > 128)
+      return 128;
+    return size;
+  }
+
+  void Push(Task task, Priority priority) {
+    task.queued_at = uv_hrtime();
+    counters::Add(counters::kThreadpoolQueued, 1);
+    counters::Add(counters::kThreadpoolPending, 1);
+    Mutex::ScopedLock lock(mutex_);
+    if (threads_.empty()) {
+      std::string affinity;
+      if (SafeGetenv(affinity_variable_, &affinity) &&
+          !ParseCpuList(affinity, &cpus_)) {
+        fprintf(stderr, "node: ignoring invalid %s=%s\n",
+                affinity_variable_, affinity.c_str());
+        cpus_.clear();
+      }
+      threads_.resize(Size());
+      for (uv_thread_t& thread : threads_)
+        CHECK_EQ(0, uv_thread_create(&thread, Run, this));
+    }
+    pending_[priority].push_back(task);
+    if (++pending_count_ > max_pending_)
+      max_pending_ = pending_count_;
+    cond_.Signal(lock);
+  }
+
+  static void Run(void* arg) {
+    Pool* pool = static_cast<Pool*>(arg);
+    if (!pool->cpus_.empty())
+      PinThread(pool->cpus_);
+    for (;;) {
+      Task task;
+      {
+        Mutex::ScopedLock lock(pool->mutex_);
+        while (pool->pending_count_ == 0)
+          pool->cond_.Wait(lock);
+        std::deque<Task>& queue = pool->pending_[pool->Pick()];
+        task = queue.front();
+        queue.pop_front();
+        pool->pending_count_--;
+        pool->running_++;
+        pool->wait_time_ns_ += uv_hrtime() - task.queued_at;
+      }
+      counters::Add(counters::kThreadpoolPending, -1);
+      counters::Add(counters::kThreadpoolRunning, 1);
+
+      if (task.run != nullptr)
+        task.run(task.data);
+      else
+        task.work(task.req);
+
+      counters::Add(counters::kThreadpoolRunning, -1);
+      counters::Add(counters::kThreadpoolCompleted, 1);
+      {
+        Mutex::ScopedLock lock(pool->mutex_);
+        pool->running_--;
+        pool->completed_++;
+        if (task.run != nullptr)
+          continue;
+        // Sent with the lock held, so that the loop can't see the last of its
+        // work done and close |async| before this returns.
+        task.completions->done.push_back(task);
+        uv_async_send(&task.completions->async);
+      }
+    }
+  }
+
+  // Returns the priority whose queue the next task comes from, the first one
+  // that isn't empty unless a later one has been passed over kMaxSkips times
+  // in a row, so that a steady stream of work of one priority can't starve
+  // the ones after it. Must be called with |mutex_| held.
+  size_t Pick() {
+    size_t pick = 0;
+    while (pending_[pick].empty())
+      pick++;
+    for (size_t i = pick + 1; i < kPriorityCount; i++) {
+      if (!pending_[i].empty() && skipped_[i] >= kMaxSkips) {
+        pick = i;
+        break;
+      }
+    }
+    skipped_[pick] = 0;
+    for (size_t i = pick + 1; i < kPriorityCount; i++) {
+      if (!pending_[i].empty())
+        skipped_[i]++;
+    }
+    return pick;
+  }
+
+  static void OnDone(uv_async_t* async) {
+    Completions* completions = ContainerOf(&Completions::async, async);
+    Pool* pool = completions->pool;
+    std::deque<Task> done;
+    {
+      Mutex::ScopedLock lock(pool->mutex_);
+      done.swap(completions->done);
+    }
+
+    for (const Task& task : done) {
+      completions->in_flight--;
+      task.after(task.req, 0);
+    }
+
+    // |after| may have queued more work.
+    if (completions->in_flight != 0)
+      return;
+    {
+      Mutex::ScopedLock lock(pool->mutex_);
+      pool->completions_.erase(async->loop);
+    }
+    uv_close(reinterpret_cast<uv_handle_t*>(async), [](uv_handle_t* handle) {
+      Completions* completions =
+          ContainerOf(&Completions::async,
+                      reinterpret_cast<uv_async_t*>(handle));
+      delete completions;
+    });
+  }
+
+  const char* const size_variable_;
+  const char* const affinity_variable_;
+  unsigned default_size_;
+  std::vector<uv_thread_t> threads_;
+  // The CPUs that the threads run on, all of them if empty.
+  std::vector<unsigned> cpus_;
+
+  Mutex mutex_;
+  ConditionVariable cond_;
+  static const size_t kMaxSkips = 4;
+
+  // One queue per Priority, see Pick(), and how many tasks in a row were
+  // taken from earlier queues while each of them wasn't empty.
+  std::deque<Task> pending_[kPriorityCount];
+  size_t skipped_[kPriorityCount];
+  size_t pending_count_;
+  std::unordered_map<uv_loop_t*, Completions*> completions_;
+  // For GetStats(), behind |mutex_| like the queues.
+  size_t running_;
+  size_t max_pending_;
+  uint64_t completed_;
+  uint64_t wait_time_ns_;
+};
+
+// Queued in place of the caller's request while its work is traced.
+struct TracedWork {
+  uv_work_t req;
+  uv_work_t* original;
+  uv_work_cb work;
+  uv_after_work_cb after;
+  const uint8_t* category_enabled;
+  const char* name;
+
+  uint64_t id() const { return reinterpret_cast<uintptr_t>(original); }
+
+  void AddEvent(char phase, const char* event_name) const {
+    tracing::AddTraceEvent(phase, category_enabled, event_name,
+                           tracing::kGlobalScope, id(), tracing::kNoId,
+                           TRACE_EVENT_FLAG_HAS_ID);
+  }
+
+  static void Work(uv_work_t* req) {
+    TracedWork* traced = ContainerOf(&TracedWork::req, req);
+    traced->AddEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_END, "wait");
+    uint64_t handle =
+        tracing::AddTraceEvent(TRACE_EVENT_PHASE_COMPLETE,
+                               traced->category_enabled, traced->name,
+                               tracing::kGlobalScope, tracing::kNoId,
+                               tracing::kNoId, TRACE_EVENT_FLAG_NONE);
+    traced->work(traced->original);
+    TRACE_EVENT_API_UPDATE_TRACE_EVENT_DURATION(traced->category_enabled,
+                                                traced->name, handle);
+  }
+
+  static void After(uv_work_t* req, int status) {
+    TracedWork* traced = ContainerOf(&TracedWork::req, req);
+    traced->AddEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_END, traced->name);
+    uv_work_t* original = traced->original;
+    uv_after_work_cb after = traced->after;
+    delete traced;
+    after(original, status);
+  }
+};
+
+// Holds back the bulk file system work of a loop, so that at most half of the
+// threads of libuv's pool run it at a time and the others stay free for
+// latency sensitive calls. libuv takes work first in, first out, so this is
+// done by queueing the excess here rather than by reordering libuv's queue.
+// Only the loop thread uses a lane.
+class FsLane {
+ public:
+  static int Queue(uv_loop_t* loop,
+                   uv_work_t* req,
+                   uv_work_cb work,
+                   uv_after_work_cb after) {
+    FsLane* lane = Get(loop, true);
+    LaneWork* lane_work = new LaneWork();
+    lane_work->original = req;
+    lane_work->work = work;
+    lane_work->after = after;
+    lane_work->lane = lane;
+    lane_work->cancelled = false;
+    if (lane->running_.size() < Limit())
+      return lane->Submit(lane_work);
+    lane->held_.push_back(lane_work);
+    return 0;
+  }
+
+  // Returns UV_ENOENT if |req| isn't bulk work of |loop|.
+  static int Cancel(uv_loop_t* loop, uv_work_t* req) {
+    FsLane* lane = Get(loop, false);
+    if (lane == nullptr)
+      return UV_ENOENT;
+    for (LaneWork* lane_work : lane->running_) {
+      if (lane_work->original == req)
+        return UV_EBUSY;
+    }
+    for (auto it = lane->held_.begin(); it != lane->held_.end(); ++it) {
+      LaneWork* lane_work = *it;
+      if (lane_work->original != req)
+        continue;
+      lane->held_.erase(it);
+      // The work is still completed through libuv, so that |after| is called
+      // from the loop like for any other cancelled request, but does nothing
+      // and doesn't count against the limit. The lane may be gone by then.
+      lane_work->cancelled = true;
+      lane_work->lane = nullptr;
+      CHECK_EQ(0, uv_queue_work(loop, &lane_work->req, Work, After));
+      uv_cancel(reinterpret_cast<uv_req_t*>(&lane_work->req));
+      return 0;
+    }
+    return UV_ENOENT;
+  }
+
+ private:
+  struct LaneWork {
+    uv_work_t req;
+    uv_work_t* original;
+    uv_work_cb work;
+    uv_after_work_cb after;
+    FsLane* lane;
+    bool cancelled;
+  };
+
+  explicit FsLane(uv_loop_t* loop) : loop_(loop) {}
+
+  // Half of UV_THREADPOOL_SIZE, which libuv clamps the same way.
+  static size_t Limit() {
+    static const size_t limit = []() {
+      std::string text;
+      unsigned size = 4;
+      if (SafeGetenv("UV_THREADPOOL_SIZE", &text))
+        size = std::min(std::max(atoi(text.c_str()), 1), 128);
+      return std::max(size / 2, 1u);
+    }();
+    return limit;
+  }
+
+  static FsLane* Get(uv_loop_t* loop, bool create) {
+    Mutex::ScopedLock lock(lanes_mutex_);
+    auto it = lanes_.find(loop);
+    if (it != lanes_.end())
+      return it->second;
+    if (!create)
+      return nullptr;
+    FsLane* lane = new FsLane(loop);
+    lanes_[loop] = lane;
+    return lane;
+  }
+
+  int Submit(LaneWork* lane_work) {
+    int err = uv_queue_work(loop_, &lane_work->req, Work, After);
+    if (err != 0) {
+      delete lane_work;
+      Release();
+      return err;
+    }
+    running_.push_back(lane_work);
+    return 0;
+  }
+
+  // Deletes the lane once nothing of it is left.
+  void Release() {
+    if (!running_.empty() || !held_.empty())
+      return;
+    {
+      Mutex::ScopedLock lock(lanes_mutex_);
+      lanes_.erase(loop_);
+    }
+    delete this;
+  }
+
+  static void Work(uv_work_t* req) {
+    LaneWork* lane_work = ContainerOf(&LaneWork::req, req);
+    if (!lane_work->cancelled)
+      lane_work->work(lane_work->original);
+  }
+
+  static void After(uv_work_t* req, int status) {
+    LaneWork* lane_work = ContainerOf(&LaneWork::req, req);
+    FsLane* lane = lane_work->lane;
+    uv_work_t* original = lane_work->original;
+    uv_after_work_cb after = lane_work->after;
+    if (lane_work->cancelled) {
+      status = UV_ECANCELED;
+      delete lane_work;
+    } else {
+      lane->running_.erase(std::find(lane->running_.begin(),
+                                     lane->running_.end(),
+                                     lane_work));
+      while (lane->running_.size() < Limit() && !lane->held_.empty()) {
+        LaneWork* next = lane->held_.front();
+        lane->held_.pop_front();
+        CHECK_EQ(0, lane->Submit(next));
+      }
+      delete lane_work;
+      lane->Release();
+    }
+    after(original, status);
+  }
+
+  uv_loop_t* const loop_;
+  // At most Limit() of them.
+  std::vector<LaneWork*> running_;
+  std::deque<LaneWork*> held_;
+
+  static Mutex lanes_mutex_;
+  static std::unordered_map<uv_loop_t*, FsLane*> lanes_;
+};
+
+Mutex FsLane::lanes_mutex_;
+std::unordered_map<uv_loop_t*, FsLane*> FsLane::lanes_;
+
+// Returns nullptr for kFsWork, which runs on libuv's pool.
+Pool* GetPool(WorkClass cls) {
+  switch (cls) {
+    case kFsWork:
+      return nullptr;
+    case kDnsWork: {
+      // Deliberately leaked, the threads run until the process exits.
+      static Pool* dns_pool = new Pool("NODE_THREADPOOL_DNS_SIZE",
+                                       "NODE_THREADPOOL_DNS_AFFINITY", 4);
+      return dns_pool;
+    }
+    case kCpuWork: {
+      static Pool* cpu_pool = new Pool("NODE_THREADPOOL_CPU_SIZE",
+                                       "NODE_THREADPOOL_CPU_AFFINITY", 4);
+      return cpu_pool;
+    }
+    case kKdfWork: {
+      static Pool* kdf_pool = new Pool("NODE_THREADPOOL_KDF_SIZE",
+                                       "NODE_THREADPOOL_KDF_AFFINITY", 2);
+      return kdf_pool;
+    }
+  }
+  UNREACHABLE();
+}
+
+int QueueWorkUntraced(uv_loop_t* loop,
+                      uv_work_t* req,
+                      WorkClass cls,
+                      Priority priority,
+                      uv_work_cb work,
+                      uv_after_work_cb after) {
+  Pool* pool = GetPool(cls);
+  if (pool != nullptr)
+    return pool->Queue(loop, req, priority, work, after);
+  if (priority == kLowPriority)
+    return FsLane::Queue(loop, req, work, after);
+  return uv_queue_work(loop, req, work, after);
+}
+
+uv_once_t worker_loop_once = UV_ONCE_INIT;
+uv_key_t worker_loop_key;
+
+void CreateWorkerLoopKey() {
+  CHECK_EQ(0, uv_key_create(&worker_loop_key));
+}
+
+}  // anonymous namespace
+
+
+int QueueWork(uv_loop_t* loop,
+              uv_work_t* req,
+              WorkClass cls,
+              Priority priority,
+              uv_work_cb work,
+              uv_after_work_cb after,
+              const char* category_group,
+              const char* name) {
+  // There is no platform without NODE_USE_V8_PLATFORM.
+  if (category_group == nullptr ||
+      tracing::TraceEventHelper::GetCurrentPlatform() == nullptr) {
+    return QueueWorkUntraced(loop, req, cls, priority, work, after);
+  }
+  const uint8_t* category_enabled =
+      TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED(category_group);
+  if (!(*category_enabled & kEnabledForRecording_CategoryGroupEnabledFlags))
+    return QueueWorkUntraced(loop, req, cls, priority, work, after);
+
+  TracedWork* traced = new TracedWork();
+  traced->original = req;
+  traced->work = work;
+  traced->after = after;
+  traced->category_enabled = category_enabled;
+  traced->name = name;
+  traced->AddEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN, name);
+  traced->AddEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN, "wait");
+  int err = QueueWorkUntraced(loop, &traced->req, cls, priority,
+                              TracedWork::Work, TracedWork::After);
+  if (err != 0) {
+    traced->AddEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_END, "wait");
+    traced->AddEvent(TRACE_EVENT_PHASE_NESTABLE_ASYNC_END, name);
+    delete traced;
+  }
+  return err;
+}
+
+
+int CancelWork(uv_loop_t* loop, uv_work_t* req) {
+  int err = FsLane::Cancel(loop, req);
+  if (err != UV_ENOENT)
+    return err;
+  return uv_cancel(reinterpret_cast<uv_req_t*>(req));
+}
+
+
+void PostTask(WorkClass cls,
+              Priority priority,
+              void (*run)(void* data),
+              void* data) {
+  Pool* pool = GetPool(cls);
+  CHECK_NE(pool, nullptr);
+  pool->Post(priority, run, data);
+}
+
+
+unsigned Threads(WorkClass cls) {
+  Pool* pool = GetPool(cls);
+  CHECK_NE(pool, nullptr);
+  return pool->Threads();
+}
+
+
+void SetDefaultSize(WorkClass cls, unsigned size) {
+  Pool* pool = GetPool(cls);
+  CHECK_NE(pool, nullptr);
+  pool->SetDefaultSize(size);
+}
+
+
+bool GetStats(WorkClass cls, Stats* stats) {
+  Pool* pool = GetPool(cls);
+  if (pool == nullptr)
+    return false;
+  pool->GetStats(stats);
+  return true;
+}
+
+
+uv_loop_t* WorkerLoop() {
+  uv_once(&worker_loop_once, CreateWorkerLoopKey);
+  uv_loop_t* loop = static_cast<uv_loop_t*>(uv_key_get(&worker_loop_key));
+  if (loop == nullptr) {
+    loop = new uv_loop_t;
+    CHECK_EQ(0, uv_loop_init(loop));
+    uv_key_set(&worker_loop_key, loop);
+  }
+  return loop;
+}
+
+}  // namespace threadpool
+}  // namespace node
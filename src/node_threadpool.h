@@ -0,0 +1,133 @@
+#ifndef SRC_NODE_THREADPOOL_H_
+#define SRC_NODE_THREADPOOL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "uv.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace node {
+namespace threadpool {
+
+// Work submitted to the thread pool is sorted into classes so that slow work
+// of one kind, like file system calls on an unresponsive network mount, can't
+// hold up the others. File system work runs on libuv's own thread pool,
+// sized with UV_THREADPOOL_SIZE. DNS lookups and CPU bound work like crypto
+// and compression each get a pool of their own, sized with
+// NODE_THREADPOOL_DNS_SIZE and NODE_THREADPOOL_CPU_SIZE. Key derivation from
+// passwords, which is slow on purpose, runs on a small pool sized with
+// NODE_THREADPOOL_KDF_SIZE, so that a burst of logins queues up there rather
+// than taking all of the CPU pool's threads.
+//
+// V8's background tasks share the CPU pool, see node_platform.h. The threads
+// of each of node's pools can be restricted to some CPUs, given as a list
+// like 0-3,8 in NODE_THREADPOOL_DNS_AFFINITY, NODE_THREADPOOL_CPU_AFFINITY
+// and NODE_THREADPOOL_KDF_AFFINITY, on Linux and Windows.
+enum WorkClass {
+  kFsWork,
+  kDnsWork,
+  kCpuWork,
+  kKdfWork
+};
+
+// The order in which the threads of a pool take up work: kHighPriority for
+// work that something is waiting on, like a DNS lookup or a TLS handshake,
+// kNormalPriority for most work, and kLowPriority for bulk work, like
+// compressing a stream or reading a whole file, that takes long anyway. A
+// priority is passed over only so many times in a row while later work
+// waits, so work of every priority gets to run.
+//
+// kFsWork runs on libuv's pool, which takes work in the order it is queued.
+// Instead, at most half of its threads, rounded down and at least one, run
+// kLowPriority work of a loop at a time, and the rest of it waits until one
+// of them is done.
+//
+// node::NodePlatform posts the tasks that V8 posts during garbage
+// collections, which the collection may be waiting for, with kHighPriority,
+// and its other tasks, like background compilation, with kLowPriority.
+enum Priority {
+  kHighPriority,
+  kNormalPriority,
+  kLowPriority,
+  kPriorityCount
+};
+
+// The state of the pool of a work class, see GetStats().
+struct Stats {
+  size_t threads;
+  // Work that is waiting for a thread, and work that a thread is running.
+  size_t pending;
+  size_t running;
+  size_t max_pending;
+  uint64_t completed;
+  // The total time that completed work spent waiting for a thread.
+  uint64_t wait_time_ns;
+};
+
+// Trace event category groups for QueueWork(). Each of them is recorded when
+// either node.threadpool or the category of its module is enabled.
+#define NODE_THREADPOOL_TRACE_FS "node.threadpool,node.fs"
+#define NODE_THREADPOOL_TRACE_DNS "node.threadpool,node.dns"
+#define NODE_THREADPOOL_TRACE_ZLIB "node.threadpool,node.zlib"
+#define NODE_THREADPOOL_TRACE_CRYPTO "node.threadpool,node.crypto"
+#define NODE_THREADPOOL_TRACE_JSON "node.threadpool,node.json"
+
+// Like uv_queue_work(), but runs |work| on the threads reserved for |cls|,
+// ordered by |priority|. |after| is called on the loop thread with a status
+// of 0. Work queued on the DNS, CPU and KDF pools cannot be cancelled, work
+// of kFsWork only with CancelWork().
+//
+// When |category_group| is enabled for tracing, the work is recorded as an
+// async |name| event from queueing until |after| is called, with a nested
+// "wait" event for the time it spent in the queue, and as a |name| event on
+// the thread that ran it. Both strings must be literals, or both nullptr
+// for work that is never traced. Traced work is queued through a request of
+// its own, so it cannot be cancelled either.
+int QueueWork(uv_loop_t* loop,
+              uv_work_t* req,
+              WorkClass cls,
+              Priority priority,
+              uv_work_cb work,
+              uv_after_work_cb after,
+              const char* category_group,
+              const char* name);
+
+// Like uv_cancel(), for untraced kFsWork that QueueWork() queued on |loop|.
+// Returns UV_EBUSY if the work is running or done.
+int CancelWork(uv_loop_t* loop, uv_work_t* req);
+
+// Runs |run| with |data| on one of the threads of |cls|, which must not be
+// kFsWork. Unlike QueueWork(), this can be called from any thread, and
+// nothing is called back on a loop.
+void PostTask(WorkClass cls,
+              Priority priority,
+              void (*run)(void* data),
+              void* data);
+
+// The number of threads of the pool of |cls|, which must not be kFsWork,
+// whether or not they have been started yet.
+unsigned Threads(WorkClass cls);
+
+// Sets the number of threads that the pool of |cls| starts with when its
+// size variable isn't set, before anything is posted to it.
+void SetDefaultSize(WorkClass cls, unsigned size);
+
+// Fills in |stats| for the pool of |cls|. Returns false for kFsWork, which
+// runs on libuv's pool that keeps no such figures. A pool that hasn't been
+// started yet reports the number of threads it will start with.
+bool GetStats(WorkClass cls, Stats* stats);
+
+// What work callbacks pass as the loop to libuv functions that are called
+// synchronously, like uv_getaddrinfo() without a callback, and only need a
+// loop to account for the request. The loop belongs to the calling thread
+// and is never run.
+uv_loop_t* WorkerLoop();
+
+}  // namespace threadpool
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_THREADPOOL_H_
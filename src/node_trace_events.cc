@@ -0,0 +1,81 @@
+#include "node.h"
+#include "node_internals.h"
+#include "env.h"
+#include "env-inl.h"
+#include "tracing/agent.h"
+#include "util.h"
+#include "util-inl.h"
+#include "v8.h"
+
+namespace node {
+
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::Local;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+// Returns the agent, or throws if there is none.
+static tracing::Agent* GetAgent(Environment* env) {
+  tracing::Agent* agent = GetTracingAgent();
+  if (agent == nullptr) {
+    env->ThrowError("Node compiled with NODE_USE_V8_PLATFORM=0, "
+                    "so event tracing is not available");
+  }
+  return agent;
+}
+
+
+static void Start(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  tracing::Agent* agent = GetAgent(env);
+  if (agent == nullptr)
+    return;
+  node::Utf8Value categories(env->isolate(), args[0]);
+  agent->Start(*categories);
+}
+
+
+static void Stop(const FunctionCallbackInfo<Value>& args) {
+  tracing::Agent* agent = GetAgent(Environment::GetCurrent(args));
+  if (agent != nullptr)
+    agent->Stop();
+}
+
+
+static void Rotate(const FunctionCallbackInfo<Value>& args) {
+  tracing::Agent* agent = GetAgent(Environment::GetCurrent(args));
+  if (agent != nullptr)
+    agent->Rotate();
+}
+
+
+static void GetEnabledCategories(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  tracing::Agent* agent = GetTracingAgent();
+  if (agent == nullptr || !agent->IsRecording())
+    return;
+  const std::string& categories = agent->enabled_categories();
+  args.GetReturnValue().Set(
+      String::NewFromUtf8(env->isolate(), categories.data(),
+                          v8::NewStringType::kNormal,
+                          categories.size()).ToLocalChecked());
+}
+
+
+void InitTraceEvents(Local<Object> target,
+                     Local<Value> unused,
+                     Local<Context> context,
+                     void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+  env->SetMethod(target, "start", Start);
+  env->SetMethod(target, "stop", Stop);
+  env->SetMethod(target, "rotate", Rotate);
+  env->SetMethod(target, "getEnabledCategories", GetEnabledCategories);
+}
+
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(trace_events, node::InitTraceEvents)
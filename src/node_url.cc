@@ -9,8 +9,12 @@
 #include "base-object.h"
 #include "base-object-inl.h"
 #include "node_i18n.h"
+#include "node_mutex.h"
 
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <stdio.h>
 #include <cmath>
@@ -18,18 +22,22 @@
 namespace node {
 
 using v8::Array;
+using v8::ArrayBuffer;
 using v8::Context;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
+using v8::Int32Array;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
 using v8::Null;
+using v8::Number;
 using v8::Object;
 using v8::String;
 using v8::TryCatch;
+using v8::Uint32Array;
 using v8::Undefined;
 using v8::Value;
 
@@ -99,6 +107,26 @@ enum url_cb_args {
 #undef XX
 };
 
+// Where the components of a URL begin and end in its href, which ParseHref()
+// hands back instead of one string for each component.
+#define OFFSETS(XX)                                                           \
+  XX(URL_OFFSET_FLAGS)                                                        \
+  XX(URL_OFFSET_PROTOCOL_END)                                                 \
+  XX(URL_OFFSET_USERNAME_END)                                                 \
+  XX(URL_OFFSET_HOST_START)                                                   \
+  XX(URL_OFFSET_HOST_END)                                                     \
+  XX(URL_OFFSET_PATH_START)                                                   \
+  XX(URL_OFFSET_QUERY_START)                                                  \
+  XX(URL_OFFSET_FRAGMENT_START)                                               \
+  XX(URL_OFFSET_PATH_LENGTH)                                                  \
+  XX(URL_OFFSETS_LENGTH)
+
+enum url_offsets {
+#define XX(name) name,
+  OFFSETS(XX)
+#undef XX
+};
+
 enum url_error_cb_args {
 #define XX(name) name,
   ERR_ARGS(XX)
@@ -474,6 +502,164 @@ static const uint8_t QUERY_ENCODE_SET[32] = {
     0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80
 };
 
+// What the application/x-www-form-urlencoded serializer escapes. It writes
+// U+0020 SPACE as '+', which is not in this set.
+static const uint8_t FORM_URLENCODED_ENCODE_SET[32] = {
+  // 00     01     02     03     04     05     06     07
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 08     09     0A     0B     0C     0D     0E     0F
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 10     11     12     13     14     15     16     17
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 18     19     1A     1B     1C     1D     1E     1F
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 20     21     22     23     24     25     26     27
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 28     29     2A     2B     2C     2D     2E     2F
+    0x01 | 0x02 | 0x00 | 0x08 | 0x10 | 0x00 | 0x00 | 0x80,
+  // 30     31     32     33     34     35     36     37
+    0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 38     39     3A     3B     3C     3D     3E     3F
+    0x00 | 0x00 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 40     41     42     43     44     45     46     47
+    0x01 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 48     49     4A     4B     4C     4D     4E     4F
+    0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 50     51     52     53     54     55     56     57
+    0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 58     59     5A     5B     5C     5D     5E     5F
+    0x00 | 0x00 | 0x00 | 0x08 | 0x10 | 0x20 | 0x40 | 0x00,
+  // 60     61     62     63     64     65     66     67
+    0x01 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 68     69     6A     6B     6C     6D     6E     6F
+    0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 70     71     72     73     74     75     76     77
+    0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 78     79     7A     7B     7C     7D     7E     7F
+    0x00 | 0x00 | 0x00 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 80     81     82     83     84     85     86     87
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 88     89     8A     8B     8C     8D     8E     8F
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 90     91     92     93     94     95     96     97
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 98     99     9A     9B     9C     9D     9E     9F
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // A0     A1     A2     A3     A4     A5     A6     A7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // A8     A9     AA     AB     AC     AD     AE     AF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // B0     B1     B2     B3     B4     B5     B6     B7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // B8     B9     BA     BB     BC     BD     BE     BF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // C0     C1     C2     C3     C4     C5     C6     C7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // C8     C9     CA     CB     CC     CD     CE     CF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // D0     D1     D2     D3     D4     D5     D6     D7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // D8     D9     DA     DB     DC     DD     DE     DF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // E0     E1     E2     E3     E4     E5     E6     E7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // E8     E9     EA     EB     EC     ED     EE     EF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // F0     F1     F2     F3     F4     F5     F6     F7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // F8     F9     FA     FB     FC     FD     FE     FF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80
+};
+
+// What querystring.escape() escapes: all but the characters that
+// encodeURIComponent() leaves alone, A-Z a-z 0-9 - _ . ! ~ * ' ( ).
+static const uint8_t QUERYSTRING_ENCODE_SET[32] = {
+  // 00     01     02     03     04     05     06     07
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 08     09     0A     0B     0C     0D     0E     0F
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 10     11     12     13     14     15     16     17
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 18     19     1A     1B     1C     1D     1E     1F
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 20     21     22     23     24     25     26     27
+    0x01 | 0x00 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x00,
+  // 28     29     2A     2B     2C     2D     2E     2F
+    0x00 | 0x00 | 0x00 | 0x08 | 0x10 | 0x00 | 0x00 | 0x80,
+  // 30     31     32     33     34     35     36     37
+    0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 38     39     3A     3B     3C     3D     3E     3F
+    0x00 | 0x00 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 40     41     42     43     44     45     46     47
+    0x01 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 48     49     4A     4B     4C     4D     4E     4F
+    0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 50     51     52     53     54     55     56     57
+    0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 58     59     5A     5B     5C     5D     5E     5F
+    0x00 | 0x00 | 0x00 | 0x08 | 0x10 | 0x20 | 0x40 | 0x00,
+  // 60     61     62     63     64     65     66     67
+    0x01 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 68     69     6A     6B     6C     6D     6E     6F
+    0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 70     71     72     73     74     75     76     77
+    0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00 | 0x00,
+  // 78     79     7A     7B     7C     7D     7E     7F
+    0x00 | 0x00 | 0x00 | 0x08 | 0x10 | 0x20 | 0x00 | 0x80,
+  // 80     81     82     83     84     85     86     87
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 88     89     8A     8B     8C     8D     8E     8F
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 90     91     92     93     94     95     96     97
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // 98     99     9A     9B     9C     9D     9E     9F
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // A0     A1     A2     A3     A4     A5     A6     A7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // A8     A9     AA     AB     AC     AD     AE     AF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // B0     B1     B2     B3     B4     B5     B6     B7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // B8     B9     BA     BB     BC     BD     BE     BF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // C0     C1     C2     C3     C4     C5     C6     C7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // C8     C9     CA     CB     CC     CD     CE     CF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // D0     D1     D2     D3     D4     D5     D6     D7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // D8     D9     DA     DB     DC     DD     DE     DF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // E0     E1     E2     E3     E4     E5     E6     E7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // E8     E9     EA     EB     EC     ED     EE     EF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // F0     F1     F2     F3     F4     F5     F6     F7
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80,
+  // F8     F9     FA     FB     FC     FD     FE     FF
+    0x01 | 0x02 | 0x04 | 0x08 | 0x10 | 0x20 | 0x40 | 0x80
+};
+
+// The value of each hex digit, or -1 for bytes that are not one.
+static const int8_t UNHEX[256] = {
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+   0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
 static inline bool BitAt(const uint8_t a[], const uint8_t i) {
   return !!(a[i >> 3] & (1 << (i & 7)));
 }
@@ -932,17 +1118,81 @@ static url_host_type WriteHost(url_host* host, std::string* dest) {
   return host->type;
 }
 
+// Most of the time it takes to parse a host goes to ICU, and programs tend to
+// use the same few hosts over and over. HostCache keeps the serialized hosts
+// that ParseHost() made last, or an empty string for hosts that failed.
+class HostCache {
+ public:
+  static bool Get(const std::string& input, bool unicode,
+                  bool* ok, std::string* output) {
+    Mutex::ScopedLock lock(mutex_);
+    auto it = index_.find(Key(input, unicode));
+    if (it == index_.end())
+      return false;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    *ok = it->second->ok;
+    if (*ok)
+      *output = it->second->output;
+    return true;
+  }
+
+  static void Put(const std::string& input, bool unicode,
+                  bool ok, const std::string& output) {
+    if (input.size() > kMaxInputLength)
+      return;
+    Mutex::ScopedLock lock(mutex_);
+    std::string key = Key(input, unicode);
+    if (index_.find(key) != index_.end())
+      return;
+    if (entries_.size() == kMaxEntries) {
+      index_.erase(entries_.back().key);
+      entries_.pop_back();
+    }
+    entries_.push_front(Entry{key, ok, ok ? output : std::string()});
+    index_.emplace(std::move(key), entries_.begin());
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    bool ok;
+    std::string output;
+  };
+
+  static const size_t kMaxEntries = 512;
+  static const size_t kMaxInputLength = 256;
+
+  static std::string Key(const std::string& input, bool unicode) {
+    std::string key(1, unicode ? 'u' : 'a');
+    key += input;
+    return key;
+  }
+
+  static Mutex mutex_;
+  static std::list<Entry> entries_;
+  static std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+Mutex HostCache::mutex_;
+std::list<HostCache::Entry> HostCache::entries_;
+std::unordered_map<std::string, std::list<HostCache::Entry>::iterator>
+    HostCache::index_;
+
 static bool ParseHost(std::string* input,
                       std::string* output,
                       bool unicode = false) {
   if (input->length() == 0)
     return true;
+  bool ok;
+  if (HostCache::Get(*input, unicode, &ok, output))
+    return ok;
   url_host host{{""}, HOST_TYPE_DOMAIN};
   ParseHost(&host, input->c_str(), input->length(), unicode);
-  if (host.type == HOST_TYPE_FAILED)
-    return false;
-  WriteHost(&host, output);
-  return true;
+  ok = host.type != HOST_TYPE_FAILED;
+  if (ok)
+    WriteHost(&host, output);
+  HostCache::Put(*input, unicode, ok, *output);
+  return ok;
 }
 
 static inline void Copy(Environment* env,
@@ -1854,6 +2104,118 @@ static void Parse(const FunctionCallbackInfo<Value>& args) {
         args[5]);
 }
 
+// Serializes |url| like URL#href does, and stores where each component is
+// in |offsets|. The username starts two characters after the protocol ends,
+// the password one character after the username, and the port one character
+// after the host. A component that is missing is empty.
+// Ref: https://url.spec.whatwg.org/#concept-url-serializer
+static void SerializeURL(const struct url_data* url,
+                         std::string* href,
+                         uint32_t* offsets) {
+  offsets[URL_OFFSET_FLAGS] = url->flags;
+  *href = url->scheme;
+  offsets[URL_OFFSET_PROTOCOL_END] = href->size();
+  if (url->flags & URL_FLAGS_HAS_HOST) {
+    *href += "//";
+    const bool has_username = url->flags & URL_FLAGS_HAS_USERNAME;
+    const bool has_password = (url->flags & URL_FLAGS_HAS_PASSWORD) &&
+                              !url->password.empty();
+    if (has_username)
+      *href += url->username;
+    offsets[URL_OFFSET_USERNAME_END] = href->size();
+    if (has_password) {
+      *href += ':';
+      *href += url->password;
+    }
+    if (has_username || has_password)
+      *href += '@';
+    offsets[URL_OFFSET_HOST_START] = href->size();
+    *href += url->host;
+    offsets[URL_OFFSET_HOST_END] = href->size();
+    if (url->port > -1) {
+      *href += ':';
+      *href += std::to_string(url->port);
+    }
+  } else {
+    if (url->scheme == "file:")
+      *href += "//";
+    offsets[URL_OFFSET_USERNAME_END] = href->size();
+    offsets[URL_OFFSET_HOST_START] = href->size();
+    offsets[URL_OFFSET_HOST_END] = href->size();
+  }
+
+  offsets[URL_OFFSET_PATH_START] = href->size();
+  offsets[URL_OFFSET_PATH_LENGTH] = url->path.size();
+  if (url->flags & URL_FLAGS_CANNOT_BE_BASE) {
+    if (!url->path.empty())
+      *href += url->path[0];
+  } else if (url->flags & URL_FLAGS_HAS_PATH) {
+    *href += '/';
+    for (size_t n = 0; n < url->path.size(); n++) {
+      if (n > 0)
+        *href += '/';
+      *href += url->path[n];
+    }
+  }
+
+  offsets[URL_OFFSET_QUERY_START] = href->size();
+  if (url->flags & URL_FLAGS_HAS_QUERY) {
+    *href += '?';
+    *href += url->query;
+  }
+  offsets[URL_OFFSET_FRAGMENT_START] = href->size();
+  if (url->flags & URL_FLAGS_HAS_FRAGMENT) {
+    *href += '#';
+    *href += url->fragment;
+  }
+
+  // The offsets so far count bytes of UTF-8, JS strings count UTF-16 code
+  // units. They only differ when the href has characters that aren't ASCII.
+  size_t byte = 0;
+  uint32_t units = 0;
+  for (int n = URL_OFFSET_PROTOCOL_END; n <= URL_OFFSET_FRAGMENT_START; n++) {
+    for (; byte < offsets[n]; byte++) {
+      const uint8_t ch = static_cast<uint8_t>((*href)[byte]);
+      if ((ch & 0xC0) != 0x80)
+        units += ch >= 0xF0 ? 2 : 1;
+    }
+    offsets[n] = units;
+  }
+}
+
+// Parses input for the URL constructor. Unlike Parse(), it returns the href
+// and puts the offsets of the components in a Uint32Array, so that JS can
+// slice the components out when they are asked for. Returns undefined if
+// the input is not a valid URL.
+static void ParseHref(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());  // input
+  CHECK(args[1]->IsUndefined() ||  // base context
+        args[1]->IsNull() ||
+        args[1]->IsObject());
+  CHECK(args[2]->IsUint32Array());  // offsets
+  Local<Uint32Array> array = args[2].As<Uint32Array>();
+  CHECK_EQ(array->Length(), URL_OFFSETS_LENGTH);
+  Local<ArrayBuffer> ab = array->Buffer();
+  uint32_t* offsets = reinterpret_cast<uint32_t*>(
+      static_cast<char*>(ab->GetContents().Data()) + array->ByteOffset());
+
+  Utf8Value input(env->isolate(), args[0]);
+  const bool has_base = args[1]->IsObject();
+  struct url_data base;
+  struct url_data url;
+  if (has_base)
+    HarvestBase(env, &base, args[1].As<Object>());
+
+  URL::Parse(*input, input.length(), kUnknownState, &url, &base, has_base);
+  if (url.flags & (URL_FLAGS_FAILED | URL_FLAGS_INVALID_PARSE_STATE))
+    return;
+
+  std::string href;
+  SerializeURL(&url, &href, offsets);
+  args.GetReturnValue().Set(UTF8STRING(env->isolate(), href));
+}
+
 static void EncodeAuthSet(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK_GE(args.Length(), 1);
@@ -1913,14 +2275,12 @@ static void DomainToASCII(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsString());
   Utf8Value value(env->isolate(), args[0]);
 
-  url_host host{{""}, HOST_TYPE_DOMAIN};
-  ParseHost(&host, *value, value.length());
-  if (host.type == HOST_TYPE_FAILED) {
+  std::string input(*value, value.length());
+  std::string out;
+  if (!ParseHost(&input, &out)) {
     args.GetReturnValue().Set(FIXED_ONE_BYTE_STRING(env->isolate(), ""));
     return;
   }
-  std::string out;
-  WriteHost(&host, &out);
   args.GetReturnValue().Set(
       String::NewFromUtf8(env->isolate(),
                           out.c_str(),
@@ -1933,20 +2293,716 @@ static void DomainToUnicode(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsString());
   Utf8Value value(env->isolate(), args[0]);
 
-  url_host host{{""}, HOST_TYPE_DOMAIN};
-  ParseHost(&host, *value, value.length(), true);
-  if (host.type == HOST_TYPE_FAILED) {
+  std::string input(*value, value.length());
+  std::string out;
+  if (!ParseHost(&input, &out, true)) {
     args.GetReturnValue().Set(FIXED_ONE_BYTE_STRING(env->isolate(), ""));
     return;
   }
-  std::string out;
-  WriteHost(&host, &out);
   args.GetReturnValue().Set(
       String::NewFromUtf8(env->isolate(),
                           out.c_str(),
                           v8::NewStringType::kNormal).ToLocalChecked());
 }
 
+// Splits the request-target of an HTTP request (RFC 7230, section 5.3) into
+// its path and query, without the host processing of the URL parser. The
+// fields are [pathStart, pathEnd, queryStart, queryEnd], and a start of -1
+// means that there is no such part. An absolute-form target has an empty
+// path when nothing follows its authority.
+template <typename T>
+static void SplitRequestTarget(const T* target, int32_t length,
+                               int32_t* fields) {
+  int32_t start = -1;
+  if (length > 0 && (target[0] == '/' || (length == 1 && target[0] == '*'))) {
+    start = 0;  // origin-form or asterisk-form
+  } else if (length > 0 && IsASCIIAlpha(target[0])) {
+    int32_t i = 1;
+    while (i < length && (IsASCIIAlphanumeric(target[i]) ||
+                          target[i] == '+' ||
+                          target[i] == '-' ||
+                          target[i] == '.')) {
+      i++;
+    }
+    if (i + 2 < length &&
+        target[i] == ':' && target[i + 1] == '/' && target[i + 2] == '/') {
+      // absolute-form, skip the scheme and the authority
+      start = i + 3;
+      while (start < length &&
+             target[start] != '/' &&
+             target[start] != '?' &&
+             target[start] != '#') {
+        start++;
+      }
+    }
+  }
+
+  fields[0] = fields[1] = fields[2] = fields[3] = -1;
+  if (start == -1)
+    return;  // authority-form, or not a request-target at all
+
+  int32_t end = start;
+  while (end < length && target[end] != '?' && target[end] != '#')
+    end++;
+  fields[0] = start;
+  fields[1] = end;
+  if (end < length && target[end] == '?') {
+    int32_t query_end = end + 1;
+    while (query_end < length && target[query_end] != '#')
+      query_end++;
+    fields[2] = end + 1;
+    fields[3] = query_end;
+  }
+}
+
+static void ParseRequestTarget(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsInt32Array());
+  Local<Int32Array> array = args[1].As<Int32Array>();
+  CHECK_EQ(array->Length(), 4);
+  Local<ArrayBuffer> ab = array->Buffer();
+  int32_t* fields = reinterpret_cast<int32_t*>(
+      static_cast<char*>(ab->GetContents().Data()) + array->ByteOffset());
+
+  Local<String> target = args[0].As<String>();
+  if (target->IsOneByte()) {
+    MaybeStackBuffer<uint8_t> value(target->Length());
+    target->WriteOneByte(value.out(), 0, target->Length(),
+                         String::NO_NULL_TERMINATION);
+    SplitRequestTarget(value.out(), target->Length(), fields);
+  } else {
+    TwoByteValue value(env->isolate(), target);
+    SplitRequestTarget(*value, value.length(), fields);
+  }
+}
+
+// Makes a string of a name or value of application/x-www-form-urlencoded
+// input, with '+' as U+0020 SPACE and percent-encoded bytes decoded. Bytes
+// that don't make up UTF-8 come out as U+FFFD.
+static inline Local<String> DecodeFormComponent(Isolate* isolate,
+                                                const char* input,
+                                                size_t len,
+                                                std::string* decoded) {
+  // Most names and values have nothing to decode.
+  size_t i = 0;
+  while (i < len && input[i] != '%' && input[i] != '+')
+    i++;
+  if (i == len) {
+    return String::NewFromUtf8(isolate, input, v8::NewStringType::kNormal,
+                               len).ToLocalChecked();
+  }
+
+  decoded->assign(input, i);
+  for (; i < len; i++) {
+    const char ch = input[i];
+    if (ch == '+') {
+      *decoded += ' ';
+    } else if (ch == '%' && i + 2 < len &&
+               UNHEX[static_cast<uint8_t>(input[i + 1])] >= 0 &&
+               UNHEX[static_cast<uint8_t>(input[i + 2])] >= 0) {
+      *decoded += static_cast<char>(
+          UNHEX[static_cast<uint8_t>(input[i + 1])] * 16 +
+          UNHEX[static_cast<uint8_t>(input[i + 2])]);
+      i += 2;
+    } else {
+      *decoded += ch;
+    }
+  }
+  return String::NewFromUtf8(isolate, decoded->data(),
+                             v8::NewStringType::kNormal,
+                             decoded->size()).ToLocalChecked();
+}
+
+// Parses application/x-www-form-urlencoded input into a flat array of names
+// and values, [name0, value0, name1, value1, ...].
+// Ref: https://url.spec.whatwg.org/#concept-urlencoded-parser
+static void ParseSearchParams(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  CHECK(args[0]->IsString());
+  Utf8Value value(isolate, args[0]);
+  const char* input = *value;
+  const size_t len = value.length();
+
+  Local<Array> params = Array::New(isolate);
+  uint32_t n = 0;
+  std::string decoded;
+  for (size_t start = 0; start < len;) {
+    size_t end = start;
+    while (end < len && input[end] != '&')
+      end++;
+    if (end > start) {
+      size_t eq = start;
+      while (eq < end && input[eq] != '=')
+        eq++;
+      Local<String> name =
+          DecodeFormComponent(isolate, input + start, eq - start, &decoded);
+      Local<String> val = eq < end ?
+          DecodeFormComponent(isolate, input + eq + 1, end - eq - 1,
+                              &decoded) :
+          String::Empty(isolate);
+      params->Set(env->context(), n++, name).FromJust();
+      params->Set(env->context(), n++, val).FromJust();
+    }
+    start = end + 1;
+  }
+  args.GetReturnValue().Set(params);
+}
+
+// Serializes a flat array of names and values like the one that
+// ParseSearchParams() makes.
+// Ref: https://url.spec.whatwg.org/#concept-urlencoded-serializer
+static void SerializeSearchParams(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  CHECK(args[0]->IsArray());
+  Local<Array> params = args[0].As<Array>();
+
+  std::string output;
+  const uint32_t len = params->Length();
+  for (uint32_t n = 0; n < len; n++) {
+    if (n > 0)
+      output += n % 2 == 0 ? '&' : '=';
+    Utf8Value value(isolate, params->Get(env->context(), n).ToLocalChecked());
+    for (size_t i = 0; i < value.length(); i++) {
+      const unsigned char ch = (*value)[i];
+      if (ch == ' ')
+        output += '+';
+      else
+        AppendOrEscape(&output, ch, FORM_URLENCODED_ENCODE_SET);
+    }
+  }
+  args.GetReturnValue().Set(
+      String::NewFromOneByte(isolate,
+                             reinterpret_cast<const uint8_t*>(output.data()),
+                             v8::NewStringType::kNormal,
+                             output.size()).ToLocalChecked());
+}
+
+// Appends |str| escaped like querystring.escape(), which escapes UTF-8 like
+// encodeURIComponent() but takes any code unit in D800-DFFF to start a
+// surrogate pair. Returns false where that throws a URIError. Runs of
+// characters that need no escaping are copied in one go.
+template <typename T>
+static bool EscapeQueryString(const T* str, size_t len, std::string* out) {
+  size_t i = 0;
+  while (i < len) {
+    const size_t start = i;
+    while (i < len && str[i] < 0x80 &&
+           !BitAt(QUERYSTRING_ENCODE_SET, static_cast<uint8_t>(str[i]))) {
+      i++;
+    }
+    out->append(str + start, str + i);
+    if (i == len)
+      break;
+
+    uint32_t c = str[i++];
+    if (c < 0x80) {
+      out->append(hex[c], 3);
+    } else if (c < 0x800) {
+      out->append(hex[0xC0 | (c >> 6)], 3);
+      out->append(hex[0x80 | (c & 0x3F)], 3);
+    } else if (c < 0xD800 || c >= 0xE000) {
+      out->append(hex[0xE0 | (c >> 12)], 3);
+      out->append(hex[0x80 | ((c >> 6) & 0x3F)], 3);
+      out->append(hex[0x80 | (c & 0x3F)], 3);
+    } else {
+      if (i == len)
+        return false;
+      c = 0x10000 + (((c & 0x3FF) << 10) | (str[i++] & 0x3FF));
+      out->append(hex[0xF0 | (c >> 18)], 3);
+      out->append(hex[0x80 | ((c >> 12) & 0x3F)], 3);
+      out->append(hex[0x80 | ((c >> 6) & 0x3F)], 3);
+      out->append(hex[0x80 | (c & 0x3F)], 3);
+    }
+  }
+  return true;
+}
+
+static inline int UnhexCodeUnit(uint16_t ch) {
+  return ch < 256 ? UNHEX[ch] : -1;
+}
+
+// The byte of the %XX at |input[k]|, or -1 if there is none.
+static inline int QueryStringPercentByte(const std::vector<uint16_t>& input,
+                                         size_t k) {
+  if (k + 2 >= input.size() || input[k] != '%')
+    return -1;
+  const int a = UnhexCodeUnit(input[k + 1]);
+  const int b = UnhexCodeUnit(input[k + 2]);
+  if (a < 0 || b < 0)
+    return -1;
+  return a * 16 + b;
+}
+
+// Appends decodeURIComponent(input) to |out|. Returns false where that
+// throws a URIError, for a '%' without two hex digits or for bytes that are
+// not UTF-8.
+static bool DecodeURIComponent(const std::vector<uint16_t>& input,
+                               std::vector<uint16_t>* out) {
+  const size_t len = input.size();
+  for (size_t k = 0; k < len; k++) {
+    if (input[k] != '%') {
+      out->push_back(input[k]);
+      continue;
+    }
+    int byte = QueryStringPercentByte(input, k);
+    if (byte < 0)
+      return false;
+    k += 2;
+    if (byte < 0x80) {
+      out->push_back(byte);
+      continue;
+    }
+
+    size_t n;
+    uint32_t c;
+    uint32_t min;
+    if ((byte & 0xE0) == 0xC0) {
+      n = 2;
+      c = byte & 0x1F;
+      min = 0x80;
+    } else if ((byte & 0xF0) == 0xE0) {
+      n = 3;
+      c = byte & 0x0F;
+      min = 0x800;
+    } else if ((byte & 0xF8) == 0xF0) {
+      n = 4;
+      c = byte & 0x07;
+      min = 0x10000;
+    } else {
+      return false;
+    }
+    for (size_t j = 1; j < n; j++) {
+      byte = QueryStringPercentByte(input, k + 1);
+      if (byte < 0 || (byte & 0xC0) != 0x80)
+        return false;
+      k += 3;
+      c = (c << 6) | (byte & 0x3F);
+    }
+    if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+      return false;
+    if (c >= 0x10000) {
+      c -= 0x10000;
+      out->push_back(0xD800 | (c >> 10));
+      out->push_back(0xDC00 | (c & 0x3FF));
+    } else {
+      out->push_back(c);
+    }
+  }
+  return true;
+}
+
+// Appends the bytes of querystring.unescapeBuffer(input, true) to |out|.
+// Like the Buffer that it writes to, this keeps the low byte of code units
+// above 0xFF.
+static void UnescapeQueryStringBytes(const std::vector<uint16_t>& input,
+                                     std::string* out) {
+  int state = 0;
+  int n = 0;
+  uint16_t hexchar = 0;
+  for (const uint16_t c : input) {
+    switch (state) {
+      case 0:
+        if (c == '%') {
+          state = 1;
+        } else {
+          *out += static_cast<char>(c == '+' ? ' ' : c);
+        }
+        break;
+      case 1:
+        hexchar = c;
+        n = UnhexCodeUnit(c);
+        if (n < 0) {
+          *out += '%';
+          *out += static_cast<char>(c);
+          state = 0;
+        } else {
+          state = 2;
+        }
+        break;
+      case 2: {
+        state = 0;
+        const int m = UnhexCodeUnit(c);
+        if (m < 0) {
+          *out += '%';
+          *out += static_cast<char>(hexchar);
+          *out += static_cast<char>(c);
+        } else {
+          *out += static_cast<char>(n * 16 + m);
+        }
+        break;
+      }
+    }
+  }
+  if (state > 0) {
+    *out += '%';
+    if (state == 2)
+      *out += static_cast<char>(hexchar);
+  }
+}
+
+// Splits a query string into names and values the way querystring.parse()
+// does, with the same treatment of partial separator matches, and calls
+// sink->Add(key, key_encoded, value, value_encoded) for each pair, where
+// |*_encoded| says whether the part has a %XX and is to be decoded. '+' is
+// already U+0020 SPACE. Stops early after |pairs| pairs, or where Add()
+// returns false.
+template <typename T, typename Sink>
+static void SplitQueryString(const T* qs,
+                             size_t len,
+                             const std::vector<uint16_t>& sep,
+                             const std::vector<uint16_t>& eq,
+                             double pairs,
+                             Sink* sink) {
+  const size_t sep_len = sep.size();
+  const size_t eq_len = eq.size();
+  std::vector<uint16_t> key;
+  std::vector<uint16_t> value;
+  size_t last_pos = 0;
+  size_t sep_idx = 0;
+  size_t eq_idx = 0;
+  bool key_encoded = false;
+  bool value_encoded = false;
+  int encode_check = 0;
+
+  for (size_t i = 0; i < len; ++i) {
+    const uint16_t code = qs[i];
+
+    if (sep_idx < sep_len && code == sep[sep_idx]) {
+      if (++sep_idx == sep_len) {
+        const size_t end = i - sep_idx + 1;
+        if (eq_idx < eq_len) {
+          if (last_pos < end) {
+            key.insert(key.end(), qs + last_pos, qs + end);
+          } else {
+            // An empty substring between separators.
+            if (--pairs == 0)
+              return;
+            last_pos = i + 1;
+            sep_idx = eq_idx = 0;
+            continue;
+          }
+        } else if (last_pos < end) {
+          value.insert(value.end(), qs + last_pos, qs + end);
+        } else {
+          // querystring.parse() does not decode a value that ends in '+'.
+          value_encoded = false;
+        }
+
+        if (!sink->Add(key, key_encoded, value, value_encoded))
+          return;
+        if (--pairs == 0)
+          return;
+        key_encoded = value_encoded = false;
+        key.clear();
+        value.clear();
+        encode_check = 0;
+        last_pos = i + 1;
+        sep_idx = eq_idx = 0;
+      }
+      continue;
+    }
+
+    sep_idx = 0;
+    if (eq_idx < eq_len) {
+      if (code == eq[eq_idx]) {
+        if (++eq_idx == eq_len) {
+          const size_t end = i - eq_idx + 1;
+          if (last_pos < end)
+            key.insert(key.end(), qs + last_pos, qs + end);
+          encode_check = 0;
+          last_pos = i + 1;
+        }
+        continue;
+      }
+      eq_idx = 0;
+      if (!key_encoded) {
+        if (code == '%') {
+          encode_check = 1;
+          continue;
+        } else if (encode_check > 0) {
+          if (UnhexCodeUnit(code) >= 0) {
+            if (++encode_check == 3)
+              key_encoded = true;
+            continue;
+          }
+          encode_check = 0;
+        }
+      }
+      if (code == '+') {
+        key.insert(key.end(), qs + last_pos, qs + i);
+        key.push_back(' ');
+        last_pos = i + 1;
+        continue;
+      }
+    }
+    if (code == '+') {
+      value.insert(value.end(), qs + last_pos, qs + i);
+      value.push_back(' ');
+      last_pos = i + 1;
+    } else if (!value_encoded) {
+      if (code == '%') {
+        encode_check = 1;
+      } else if (encode_check > 0) {
+        if (UnhexCodeUnit(code) >= 0) {
+          if (++encode_check == 3)
+            value_encoded = true;
+        } else {
+          encode_check = 0;
+        }
+      }
+    }
+  }
+
+  // Deal with any leftover key or value data.
+  if (last_pos < len) {
+    if (eq_idx < eq_len)
+      key.insert(key.end(), qs + last_pos, qs + len);
+    else if (sep_idx < sep_len)
+      value.insert(value.end(), qs + last_pos, qs + len);
+  } else if (eq_idx == 0) {
+    // We ended on an empty substring.
+    return;
+  }
+  sink->Add(key, key_encoded, value, value_encoded);
+}
+
+// Makes a string of a name or value from SplitQueryString(), decoded like
+// querystring.unescape() if it has to be.
+static Local<String> QueryStringPartToString(Isolate* isolate,
+                                             const std::vector<uint16_t>& part,
+                                             bool encoded,
+                                             std::vector<uint16_t>* decoded,
+                                             std::string* bytes) {
+  const std::vector<uint16_t>* units = &part;
+  if (encoded) {
+    decoded->clear();
+    if (!DecodeURIComponent(part, decoded)) {
+      bytes->clear();
+      UnescapeQueryStringBytes(part, bytes);
+      return String::NewFromUtf8(isolate, bytes->data(),
+                                 v8::NewStringType::kNormal,
+                                 bytes->size()).ToLocalChecked();
+    }
+    units = decoded;
+  }
+  return String::NewFromTwoByte(isolate, units->data(),
+                                v8::NewStringType::kNormal,
+                                units->size()).ToLocalChecked();
+}
+
+// Adds the pairs of a query string to an object, a name that comes again
+// gets an array of its values.
+class QueryStringObjectSink {
+ public:
+  QueryStringObjectSink(Environment* env, Local<Object> obj)
+      : env_(env), obj_(obj) {}
+
+  bool Add(const std::vector<uint16_t>& key,
+           bool key_encoded,
+           const std::vector<uint16_t>& value,
+           bool value_encoded) {
+    Isolate* isolate = env_->isolate();
+    Local<Context> context = env_->context();
+    Local<String> name =
+        QueryStringPartToString(isolate, key, key_encoded, &decoded_, &bytes_);
+    Local<String> val = QueryStringPartToString(isolate, value, value_encoded,
+                                                &decoded_, &bytes_);
+
+    bool has;
+    if (!obj_->HasOwnProperty(context, name).To(&has))
+      return false;
+    if (!has)
+      return obj_->CreateDataProperty(context, name, val).IsJust();
+
+    Local<Value> current;
+    if (!obj_->Get(context, name).ToLocal(&current))
+      return false;
+    if (current->IsArray()) {
+      Local<Array> values = current.As<Array>();
+      return values->Set(context, values->Length(), val).IsJust();
+    }
+    Local<Array> values = Array::New(isolate, 2);
+    return values->Set(context, 0, current).IsJust() &&
+           values->Set(context, 1, val).IsJust() &&
+           obj_->CreateDataProperty(context, name, values).IsJust();
+  }
+
+ private:
+  Environment* const env_;
+  Local<Object> obj_;
+  std::vector<uint16_t> decoded_;
+  std::string bytes_;
+};
+
+static inline void StringToCodeUnits(Isolate* isolate,
+                                     Local<Value> string,
+                                     std::vector<uint16_t>* out) {
+  TwoByteValue value(isolate, string);
+  out->assign(*value, *value + value.length());
+}
+
+// parseQueryString(obj, qs, sep, eq, pairs)
+// Adds the pairs of |qs| to |obj| like querystring.parse() with the default
+// decoding. |pairs| is the number of pairs after which to stop, or -1.
+static void ParseQueryString(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsString());
+  CHECK(args[2]->IsString());
+  CHECK(args[3]->IsString());
+  CHECK(args[4]->IsNumber());
+
+  std::vector<uint16_t> sep;
+  std::vector<uint16_t> eq;
+  StringToCodeUnits(isolate, args[2], &sep);
+  StringToCodeUnits(isolate, args[3], &eq);
+  const double pairs = args[4].As<Number>()->Value();
+  QueryStringObjectSink sink(env, args[0].As<Object>());
+
+  Local<String> qs = args[1].As<String>();
+  if (qs->IsOneByte()) {
+    MaybeStackBuffer<uint8_t> value(qs->Length());
+    qs->WriteOneByte(value.out(), 0, qs->Length(),
+                     String::NO_NULL_TERMINATION);
+    SplitQueryString(value.out(), value.length(), sep, eq, pairs, &sink);
+  } else {
+    TwoByteValue value(isolate, qs);
+    SplitQueryString(*value, value.length(), sep, eq, pairs, &sink);
+  }
+}
+
+// Appends |value| to |out| as querystring.stringify() does, escaped after
+// stringifyPrimitive(). Returns false where escaping fails.
+static bool AppendQueryStringValue(Environment* env,
+                                   Local<Value> value,
+                                   std::string* out) {
+  Local<String> string;
+  if (value->IsString()) {
+    string = value.As<String>();
+  } else if (value->IsNumber() &&
+             std::isfinite(value.As<Number>()->Value())) {
+    string = value->ToString(env->context()).ToLocalChecked();
+  } else if (value->IsBoolean()) {
+    out->append(value->IsTrue() ? "true" : "false");
+    return true;
+  } else {
+    return true;
+  }
+
+  const int length = string->Length();
+  if (string->IsOneByte()) {
+    MaybeStackBuffer<uint8_t> data(length);
+    string->WriteOneByte(data.out(), 0, length, String::NO_NULL_TERMINATION);
+    return EscapeQueryString(data.out(), data.length(), out);
+  }
+  TwoByteValue data(env->isolate(), string);
+  return EscapeQueryString(*data, data.length(), out);
+}
+
+// Like Array.isArray(), which looks through proxies.
+static inline bool IsArrayOrArrayProxy(Local<Value> value) {
+  while (value->IsProxy())
+    value = value.As<v8::Proxy>()->GetTarget();
+  return value->IsArray();
+}
+
+// stringifyQueryString(obj, sep, eq)
+// Does querystring.stringify() with the default escaping in one go, and
+// returns null where querystring.escape() would throw a URIError. Returns
+// undefined, having done nothing, for separators beyond U+00FF.
+static void StringifyQueryString(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsString());
+  CHECK(args[2]->IsString());
+
+  Local<String> sep_string = args[1].As<String>();
+  Local<String> eq_string = args[2].As<String>();
+  if (!sep_string->ContainsOnlyOneByte() || !eq_string->ContainsOnlyOneByte())
+    return;
+  std::string sep(sep_string->Length(), '\0');
+  std::string eq(eq_string->Length(), '\0');
+  sep_string->WriteOneByte(reinterpret_cast<uint8_t*>(&sep[0]), 0, -1,
+                           String::NO_NULL_TERMINATION);
+  eq_string->WriteOneByte(reinterpret_cast<uint8_t*>(&eq[0]), 0, -1,
+                          String::NO_NULL_TERMINATION);
+
+  // Object.keys(obj)
+  Local<Object> obj = args[0].As<Object>();
+  Local<Array> keys;
+  if (!obj->GetOwnPropertyNames(
+          context,
+          static_cast<v8::PropertyFilter>(v8::ONLY_ENUMERABLE |
+                                          v8::SKIP_SYMBOLS)).ToLocal(&keys)) {
+    return;
+  }
+
+  std::string fields;
+  std::string ks;
+  const uint32_t len = keys->Length();
+  for (uint32_t i = 0; i < len; ++i) {
+    Local<Value> k;
+    Local<Value> v;
+    if (!keys->Get(context, i).ToLocal(&k) ||
+        !k->ToString(context).ToLocal(&k) ||
+        !obj->Get(context, k).ToLocal(&v)) {
+      return;
+    }
+    ks.clear();
+    if (!AppendQueryStringValue(env, k, &ks))
+      return args.GetReturnValue().SetNull();
+    ks += eq;
+
+    if (IsArrayOrArrayProxy(v)) {
+      Local<Object> array = v.As<Object>();
+      double vlen;
+      if (v->IsArray()) {
+        vlen = array.As<Array>()->Length();
+      } else {
+        Local<Value> length;
+        if (!array->Get(context, FIXED_ONE_BYTE_STRING(isolate, "length"))
+                 .ToLocal(&length) ||
+            !length->NumberValue(context).To(&vlen)) {
+          return;
+        }
+      }
+      for (double j = 0; j < vlen; ++j) {
+        Local<Value> element;
+        if (!array->Get(context, static_cast<uint32_t>(j)).ToLocal(&element))
+          return;
+        fields += ks;
+        if (!AppendQueryStringValue(env, element, &fields))
+          return args.GetReturnValue().SetNull();
+        if (j < vlen - 1)
+          fields += sep;
+      }
+      if (vlen != 0 && !std::isnan(vlen) && i + 1 < len)
+        fields += sep;
+    } else {
+      fields += ks;
+      if (!AppendQueryStringValue(env, v, &fields))
+        return args.GetReturnValue().SetNull();
+      if (i + 1 < len)
+        fields += sep;
+    }
+  }
+
+  Local<String> result;
+  if (!String::NewFromOneByte(isolate,
+                              reinterpret_cast<const uint8_t*>(fields.data()),
+                              v8::NewStringType::kNormal,
+                              fields.size()).ToLocal(&result)) {
+    return env->ThrowRangeError("Invalid string length");
+  }
+  args.GetReturnValue().Set(result);
+}
+
 // This function works by calling out to a JS function that creates and
 // returns the JS URL object. Be mindful of the JS<->Native boundary
 // crossing that is required.
@@ -2005,10 +3061,16 @@ static void Init(Local<Object> target,
                  void* priv) {
   Environment* env = Environment::GetCurrent(context);
   env->SetMethod(target, "parse", Parse);
+  env->SetMethod(target, "parseHref", ParseHref);
   env->SetMethod(target, "encodeAuth", EncodeAuthSet);
   env->SetMethod(target, "toUSVString", ToUSVString);
   env->SetMethod(target, "domainToASCII", DomainToASCII);
   env->SetMethod(target, "domainToUnicode", DomainToUnicode);
+  env->SetMethod(target, "parseRequestTarget", ParseRequestTarget);
+  env->SetMethod(target, "parseSearchParams", ParseSearchParams);
+  env->SetMethod(target, "serializeSearchParams", SerializeSearchParams);
+  env->SetMethod(target, "parseQueryString", ParseQueryString);
+  env->SetMethod(target, "stringifyQueryString", StringifyQueryString);
   env->SetMethod(target, "setURLConstructor", SetURLConstructor);
 
 #define XX(name, _) NODE_DEFINE_CONSTANT(target, name);
@@ -2018,6 +3080,10 @@ static void Init(Local<Object> target,
 #define XX(name) NODE_DEFINE_CONSTANT(target, name);
   PARSESTATES(XX)
 #undef XX
+
+#define XX(name) NODE_DEFINE_CONSTANT(target, name);
+  OFFSETS(XX)
+#undef XX
 }
 }  // namespace url
 }  // namespace node
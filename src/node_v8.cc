@@ -20,18 +20,34 @@
 // USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "node.h"
+#include "node_internals.h"
+#include "cpu_profile_writer.h"
 #include "env.h"
 #include "env-inl.h"
+#include "gc_metrics.h"
+#include "node_histogram.h"
 #include "util.h"
 #include "util-inl.h"
+#include "uv.h"
 #include "v8.h"
+#include "v8-profiler.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
 
 namespace node {
 
+using v8::AllocationProfile;
 using v8::Array;
 using v8::ArrayBuffer;
 using v8::Context;
+using v8::Float64Array;
 using v8::FunctionCallbackInfo;
+using v8::HeapProfiler;
+using v8::HeapSnapshot;
 using v8::HeapSpaceStatistics;
 using v8::HeapStatistics;
 using v8::Integer;
@@ -39,6 +55,7 @@ using v8::Isolate;
 using v8::Local;
 using v8::NewStringType;
 using v8::Object;
+using v8::OutputStream;
 using v8::ScriptCompiler;
 using v8::String;
 using v8::Uint32;
@@ -113,6 +130,241 @@ void UpdateHeapSpaceStatisticsBuffer(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Starts recording garbage collections into a ring buffer of args[0]
+// records, and returns a Float64Array of it, see GCMetrics.
+void StartGCTracking(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsUint32());
+  GCMetrics* metrics = env->gc_metrics();
+  metrics->Start(args[0].As<Uint32>()->Value());
+  Local<ArrayBuffer> ab = ArrayBuffer::New(env->isolate(),
+                                           metrics->buffer(),
+                                           sizeof(double) *
+                                               metrics->buffer_size());
+  args.GetReturnValue().Set(
+      Float64Array::New(ab, 0, metrics->buffer_size()));
+}
+
+
+void StopGCTracking(const FunctionCallbackInfo<Value>& args) {
+  Environment::GetCurrent(args)->gc_metrics()->Stop();
+}
+
+
+// Returns a histogram handle for the GC pauses, in microseconds.
+void GetGCPauseHistogram(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  args.GetReturnValue().Set(
+      HistogramWrap::New(env, env->gc_metrics()->pauses()));
+}
+
+
+// Writes a heap snapshot to a file, collecting the chunks that V8 hands out
+// into large writes.
+class HeapSnapshotFileStream : public OutputStream {
+ public:
+  explicit HeapSnapshotFileStream(uv_file file)
+    : file_(file), buffer_(kBufferSize), used_(0), err_(0) {}
+
+  int GetChunkSize() override { return kChunkSize; }
+
+  WriteResult WriteAsciiChunk(char* data, int size) override {
+    if (used_ + static_cast<size_t>(size) > buffer_.size() && !Flush())
+      return kAbort;
+    memcpy(buffer_.data() + used_, data, size);
+    used_ += size;
+    return kContinue;
+  }
+
+  void EndOfStream() override {
+    Flush();
+  }
+
+  // A negative libuv error code if a write failed, 0 otherwise.
+  int error() const { return err_; }
+
+ private:
+  static const size_t kBufferSize = 1 << 20;
+  static const int kChunkSize = 64 * 1024;
+
+  bool Flush() {
+    size_t written = 0;
+    while (written < used_) {
+      uv_fs_t req;
+      uv_buf_t buf = uv_buf_init(buffer_.data() + written, used_ - written);
+      int r = uv_fs_write(nullptr, &req, file_, &buf, 1, -1, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (r < 0) {
+        err_ = r;
+        return false;
+      }
+      written += r;
+    }
+    used_ = 0;
+    return true;
+  }
+
+  const uv_file file_;
+  std::vector<char> buffer_;
+  size_t used_;
+  int err_;
+};
+
+
+// Takes a heap snapshot and writes it to the file args[0] on the main
+// thread, without going through the inspector.
+void WriteHeapSnapshot(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(env->isolate(), args[0]);
+
+  uv_fs_t req;
+  int fd = uv_fs_open(nullptr, &req, *path, O_WRONLY | O_CREAT | O_TRUNC,
+                      0666, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0)
+    return env->ThrowUVException(fd, "open", nullptr, *path);
+
+  const HeapSnapshot* snapshot =
+      env->isolate()->GetHeapProfiler()->TakeHeapSnapshot();
+  HeapSnapshotFileStream stream(fd);
+  snapshot->Serialize(&stream, HeapSnapshot::kJSON);
+  const_cast<HeapSnapshot*>(snapshot)->Delete();
+
+  int err = uv_fs_close(nullptr, &req, fd, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (stream.error() < 0)
+    return env->ThrowUVException(stream.error(), "write", nullptr, *path);
+  if (err < 0)
+    return env->ThrowUVException(err, "close", nullptr, *path);
+}
+
+
+// Starts sampling an allocation every args[0] bytes on average, with at most
+// args[1] frames of stack. Returns false if the profiler already runs.
+void StartSamplingHeapProfiler(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsNumber());
+  CHECK(args[1]->IsInt32());
+  const uint64_t interval = args[0].As<v8::Number>()->Value();
+  const int stack_depth = args[1].As<v8::Int32>()->Value();
+  HeapProfiler* profiler = env->isolate()->GetHeapProfiler();
+  args.GetReturnValue().Set(
+      profiler->StartSamplingHeapProfiler(interval, stack_depth));
+}
+
+
+void StopSamplingHeapProfiler(const FunctionCallbackInfo<Value>& args) {
+  Environment::GetCurrent(args)->isolate()->GetHeapProfiler()
+      ->StopSamplingHeapProfiler();
+}
+
+
+static void AppendJSONString(Isolate* isolate,
+                             Local<String> value,
+                             std::string* out) {
+  out->push_back('"');
+  if (!value.IsEmpty()) {
+    node::Utf8Value utf8(isolate, value);
+    for (size_t i = 0; i < utf8.length(); i++) {
+      const unsigned char c = (*utf8)[i];
+      if (c == '"' || c == '\\') {
+        out->push_back('\\');
+        out->push_back(c);
+      } else if (c < 0x20) {
+        char escaped[8];
+        snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        out->append(escaped);
+      } else {
+        out->push_back(c);
+      }
+    }
+  }
+  out->push_back('"');
+}
+
+
+// Appends |node| and its children in the format of the .heapprofile files
+// that Chrome DevTools loads, the same that the inspector's
+// HeapProfiler.getSamplingProfile returns. |id| numbers the nodes.
+static void AppendAllocationNode(Isolate* isolate,
+                                 const AllocationProfile::Node* node,
+                                 int* id,
+                                 std::string* out) {
+  size_t self_size = 0;
+  for (const AllocationProfile::Allocation& allocation : node->allocations)
+    self_size += allocation.size * allocation.count;
+
+  out->append("{\"callFrame\":{\"functionName\":");
+  AppendJSONString(isolate, node->name, out);
+  out->append(",\"scriptId\":\"");
+  out->append(std::to_string(node->script_id));
+  out->append("\",\"url\":");
+  AppendJSONString(isolate, node->script_name, out);
+  out->append(",\"lineNumber\":");
+  out->append(std::to_string(node->line_number - 1));
+  out->append(",\"columnNumber\":");
+  out->append(std::to_string(node->column_number - 1));
+  out->append("},\"selfSize\":");
+  out->append(std::to_string(self_size));
+  out->append(",\"id\":");
+  out->append(std::to_string(++*id));
+  out->append(",\"children\":[");
+  for (size_t i = 0; i < node->children.size(); i++) {
+    if (i > 0)
+      out->push_back(',');
+    AppendAllocationNode(isolate, node->children[i], id, out);
+  }
+  out->append("]}");
+}
+
+
+// Returns a Buffer with the JSON of the allocations that were sampled and
+// are still alive, or null if the sampling heap profiler does not run.
+void GetAllocationProfile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  std::unique_ptr<AllocationProfile> profile(
+      env->isolate()->GetHeapProfiler()->GetAllocationProfile());
+  if (!profile)
+    return args.GetReturnValue().SetNull();
+
+  std::string json = "{\"head\":";
+  int id = 0;
+  AppendAllocationNode(env->isolate(), profile->GetRootNode(), &id, &json);
+  json.push_back('}');
+
+  Local<Object> buffer;
+  if (Buffer::Copy(env, json.data(), json.size()).ToLocal(&buffer))
+    args.GetReturnValue().Set(buffer);
+}
+
+
+// Starts sampling the CPU every args[0] microseconds. Returns false if the
+// profiler already runs.
+void StartCpuProfile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsInt32());
+  args.GetReturnValue().Set(
+      env->cpu_profile_writer()->Start(args[0].As<v8::Int32>()->Value()));
+}
+
+
+// Stops the profiler and writes what it sampled to the file args[0], see
+// CpuProfileWriter for the format.
+void StopCpuProfile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  CpuProfileWriter* writer = env->cpu_profile_writer();
+  if (!writer->IsStarted())
+    return env->ThrowError("The CPU profiler is not running");
+  node::Utf8Value path(env->isolate(), args[0]);
+  const char* syscall = nullptr;
+  const int err = writer->Stop(*path, &syscall);
+  if (err < 0)
+    return env->ThrowUVException(err, syscall, nullptr, *path);
+}
+
+
 void SetFlagsFromString(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -203,6 +455,19 @@ void InitializeV8Bindings(Local<Object> target,
   HEAP_SPACE_STATISTICS_PROPERTIES(V)
 #undef V
 
+  env->SetMethod(target, "startGCTracking", StartGCTracking);
+  env->SetMethod(target, "stopGCTracking", StopGCTracking);
+  env->SetMethod(target, "getGCPauseHistogram", GetGCPauseHistogram);
+
+  env->SetMethod(target, "writeHeapSnapshot", WriteHeapSnapshot);
+  env->SetMethod(target,
+                 "startSamplingHeapProfiler",
+                 StartSamplingHeapProfiler);
+  env->SetMethod(target, "stopSamplingHeapProfiler", StopSamplingHeapProfiler);
+  env->SetMethod(target, "getAllocationProfile", GetAllocationProfile);
+  env->SetMethod(target, "startCpuProfile", StartCpuProfile);
+  env->SetMethod(target, "stopCpuProfile", StopCpuProfile);
+
   env->SetMethod(target, "setFlagsFromString", SetFlagsFromString);
 }
 
@@ -0,0 +1,354 @@
+#include "node_vfork.h"
+#include "util.h"
+#include "util-inl.h"
+
+#include <errno.h>
+#include <string.h>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace node {
+
+#ifdef __linux__
+
+namespace {
+
+// Everything below up to Spawn() runs in the child, on the memory and the
+// stack of the parent, and so may change nothing but what belongs to the
+// child itself, like its file descriptors, and must not allocate.
+
+void WriteError(int error_fd, int err) {
+  while (write(error_fd, &err, sizeof(err)) == -1 && errno == EINTR) {}
+}
+
+
+// A child created with vfork() could run the parent's signal handlers, on
+// the parent's memory, until it has called exec(). The parent blocks all
+// signals around vfork(), the child restores the default handlers before it
+// unblocks them.
+void ResetSignals(const sigset_t* sigmask) {
+  for (int n = 1; n < NSIG; n++) {
+    if (n == SIGKILL || n == SIGSTOP)
+      continue;
+    struct sigaction act;
+    if (sigaction(n, nullptr, &act) != 0)
+      continue;
+    if (act.sa_handler == SIG_DFL || act.sa_handler == SIG_IGN)
+      continue;
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = SIG_DFL;
+    sigaction(n, &act, nullptr);
+  }
+  sigprocmask(SIG_SETMASK, sigmask, nullptr);
+}
+
+
+// execvp(), except that it must not change `environ`, which belongs to the
+// parent, so it looks for the file in the PATH of the child's environment
+// itself.
+void Exec(const uv_process_options_t* options) {
+  if (options->env == nullptr) {
+    execvp(options->file, options->args);
+    return;
+  }
+
+  if (strchr(options->file, '/') != nullptr) {
+    execve(options->file, options->args, options->env);
+    return;
+  }
+
+  // The default of glibc when PATH is not set.
+  const char* dirs = "/bin:/usr/bin";
+  for (char** env = options->env; *env != nullptr; env++) {
+    if (strncmp(*env, "PATH=", 5) == 0)
+      dirs = *env + 5;
+  }
+
+  char path[4096];
+  const size_t file_len = strlen(options->file);
+  int err = ENOENT;
+  for (;;) {
+    const char* end = strchr(dirs, ':');
+    if (end == nullptr)
+      end = dirs + strlen(dirs);
+    size_t dir_len = end - dirs;
+
+    if (dir_len + file_len + 2 <= sizeof(path)) {
+      // An empty entry is the current directory.
+      memcpy(path, dirs, dir_len);
+      if (dir_len == 0)
+        path[dir_len++] = '.';
+      path[dir_len] = '/';
+      memcpy(path + dir_len + 1, options->file, file_len + 1);
+      execve(path, options->args, options->env);
+
+      if (errno == EACCES)
+        err = EACCES;
+      else if (errno != ENOENT && errno != ENOTDIR)
+        return;
+    }
+
+    if (*end == '\0')
+      break;
+    dirs = end + 1;
+  }
+  errno = err;
+}
+
+
+// Sets up the child like uv_spawn() does. |fds| holds the descriptor that
+// goes to each stdio slot, or -1, and is scratch space of the child's.
+void ChildInit(const uv_process_options_t* options,
+               int stdio_count,
+               int* fds,
+               int error_fd,
+               const sigset_t* sigmask) {
+  ResetSignals(sigmask);
+
+  if (options->flags & UV_PROCESS_DETACHED)
+    setsid();
+
+  // First duplicate low numbered fds, since they could get replaced, like
+  // when stdout and stderr are swapped.
+  for (int fd = 0; fd < stdio_count; fd++) {
+    const int use_fd = fds[fd];
+    if (use_fd < 0 || use_fd >= fd)
+      continue;
+    fds[fd] = fcntl(use_fd, F_DUPFD_CLOEXEC, stdio_count);
+    if (fds[fd] == -1)
+      return WriteError(error_fd, -errno);
+  }
+
+  for (int fd = 0; fd < stdio_count; fd++) {
+    int use_fd = fds[fd];
+    int close_fd = -1;
+
+    if (use_fd < 0) {
+      if (fd >= 3)
+        continue;
+      // stdin, stdout and stderr go to /dev/null even when ignored.
+      use_fd = open("/dev/null", fd == 0 ? O_RDONLY : O_RDWR);
+      if (use_fd == -1)
+        return WriteError(error_fd, -errno);
+      close_fd = use_fd;
+    }
+
+    int r;
+    if (fd == use_fd)
+      r = fcntl(use_fd, F_SETFD, fcntl(use_fd, F_GETFD) & ~FD_CLOEXEC);
+    else
+      r = dup2(use_fd, fd);
+    if (r == -1)
+      return WriteError(error_fd, -errno);
+
+    if (fd <= 2)
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+
+    if (close_fd >= stdio_count)
+      close(close_fd);
+  }
+
+  for (int fd = 0; fd < stdio_count; fd++) {
+    if (fds[fd] >= stdio_count)
+      close(fds[fd]);
+  }
+
+  if (options->cwd != nullptr && chdir(options->cwd) != 0)
+    return WriteError(error_fd, -errno);
+
+  Exec(options);
+  WriteError(error_fd, -errno);
+}
+
+}  // anonymous namespace
+
+
+bool VforkProcess::CanSpawn(const uv_process_options_t* options) {
+  return !(options->flags & (UV_PROCESS_SETUID | UV_PROCESS_SETGID));
+}
+
+
+int VforkProcess::Spawn(uv_loop_t* loop,
+                        const uv_process_options_t* options,
+                        ExitCallback exit_cb) {
+  CHECK(CanSpawn(options));
+  // The loop's own SIGCHLD handle already set up what this needs.
+  CHECK_EQ(0, uv_signal_init(loop, &signal_));
+  exit_cb_ = exit_cb;
+  pid_ = 0;
+
+  const int stdio_count = options->stdio_count < 3 ? 3 : options->stdio_count;
+  // The end of each stdio pipe that stays with the parent, and the
+  // descriptor that each stdio slot of the child gets.
+  std::vector<int> parent_fds(stdio_count, -1);
+  std::vector<int> child_fds(stdio_count, -1);
+  int err = 0;
+
+  for (int i = 0; i < options->stdio_count && err == 0; i++) {
+    const uv_stdio_container_t& container = options->stdio[i];
+    switch (container.flags & (UV_IGNORE | UV_CREATE_PIPE |
+                               UV_INHERIT_FD | UV_INHERIT_STREAM)) {
+      case UV_IGNORE:
+        break;
+      case UV_CREATE_PIPE: {
+        CHECK_NE(container.data.stream, nullptr);
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+          err = -errno;
+          break;
+        }
+        parent_fds[i] = fds[0];
+        child_fds[i] = fds[1];
+        break;
+      }
+      case UV_INHERIT_FD:
+        child_fds[i] = container.data.fd;
+        break;
+      case UV_INHERIT_STREAM: {
+        uv_os_fd_t fd;
+        err = uv_fileno(reinterpret_cast<uv_handle_t*>(container.data.stream),
+                        &fd);
+        child_fds[i] = fd;
+        break;
+      }
+      default:
+        err = UV_EINVAL;
+    }
+  }
+
+  int error_pipe[2] = { -1, -1 };
+  if (err == 0 && pipe2(error_pipe, O_CLOEXEC) != 0)
+    err = -errno;
+  if (err == 0)
+    err = uv_signal_start(&signal_, OnSignal, SIGCHLD);
+
+  int pid = -1;
+  if (err == 0) {
+    // The child mutates its own copy of the descriptors.
+    std::vector<int> scratch_fds(child_fds);
+    sigset_t sigmask_all;
+    sigset_t sigmask;
+    sigfillset(&sigmask_all);
+    pthread_sigmask(SIG_SETMASK, &sigmask_all, &sigmask);
+    pid = vfork();
+    if (pid == 0) {
+      ChildInit(options, stdio_count, scratch_fds.data(), error_pipe[1],
+                &sigmask);
+      _exit(127);
+    }
+    if (pid == -1)
+      err = -errno;
+    pthread_sigmask(SIG_SETMASK, &sigmask, nullptr);
+  }
+
+  if (error_pipe[1] != -1)
+    close(error_pipe[1]);
+  for (int i = 0; i < options->stdio_count; i++) {
+    if ((options->stdio[i].flags & UV_CREATE_PIPE) && child_fds[i] != -1)
+      close(child_fds[i]);
+  }
+
+  int exec_err = 0;
+  if (pid > 0) {
+    // The parent only runs again once the child has called exec() or
+    // exited, by when the error, if any, has been written.
+    ssize_t r;
+    do {
+      r = read(error_pipe[0], &exec_err, sizeof(exec_err));
+    } while (r == -1 && errno == EINTR);
+
+    if (r == sizeof(exec_err)) {
+      int status;
+      while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {}
+      uv_signal_stop(&signal_);
+    } else {
+      exec_err = 0;
+    }
+    pid_ = pid;
+
+    // Like uv_spawn(), the pipes are opened even when exec() failed, so
+    // that they read EOF.
+    for (int i = 0; i < options->stdio_count; i++) {
+      if (parent_fds[i] == -1)
+        continue;
+      uv_pipe_t* pipe = reinterpret_cast<uv_pipe_t*>(
+          options->stdio[i].data.stream);
+      CHECK_EQ(0, uv_pipe_open(pipe, parent_fds[i]));
+      parent_fds[i] = -1;
+    }
+  } else {
+    uv_signal_stop(&signal_);
+  }
+
+  if (error_pipe[0] != -1)
+    close(error_pipe[0]);
+  for (int fd : parent_fds) {
+    if (fd != -1)
+      close(fd);
+  }
+
+  return err != 0 ? err : exec_err;
+}
+
+
+int VforkProcess::Kill(int signum) {
+  return uv_kill(pid_, signum);
+}
+
+
+void VforkProcess::OnSignal(uv_signal_t* handle, int signum) {
+  VforkProcess* process = ContainerOf(&VforkProcess::signal_, handle);
+  int status;
+  int r;
+  do {
+    r = waitpid(process->pid_, &status, WNOHANG);
+  } while (r == -1 && errno == EINTR);
+
+  // Still running, or not a child of this process anymore.
+  if (r != process->pid_)
+    return;
+
+  uv_signal_stop(handle);
+  int64_t exit_status = 0;
+  int term_signal = 0;
+  if (WIFEXITED(status))
+    exit_status = WEXITSTATUS(status);
+  if (WIFSIGNALED(status))
+    term_signal = WTERMSIG(status);
+  process->exit_cb_(process, exit_status, term_signal);
+}
+
+#else  // !__linux__
+
+bool VforkProcess::CanSpawn(const uv_process_options_t* options) {
+  return false;
+}
+
+
+int VforkProcess::Spawn(uv_loop_t* loop,
+                        const uv_process_options_t* options,
+                        ExitCallback exit_cb) {
+  UNREACHABLE();
+}
+
+
+int VforkProcess::Kill(int signum) {
+  UNREACHABLE();
+}
+
+
+void VforkProcess::OnSignal(uv_signal_t* handle, int signum) {
+  UNREACHABLE();
+}
+
+#endif  // __linux__
+
+}  // namespace node
@@ -0,0 +1,60 @@
+#ifndef SRC_NODE_VFORK_H_
+#define SRC_NODE_VFORK_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "uv.h"
+
+#include <stdint.h>
+
+namespace node {
+
+// A child process created with vfork() instead of the fork() of uv_spawn(),
+// so that spawning doesn't copy the page tables of the parent and costs the
+// same however large its heap is. Its exit is watched for with a SIGCHLD
+// handle, which takes the place of the uv_process_t of uv_spawn(): the
+// handle is initialized by Spawn(), whatever it returns, and is closed like
+// any other once the process is done with.
+//
+// Has no constructor so that it can share storage with a uv_process_t, whose
+// handle is where signal_ is.
+class VforkProcess {
+ public:
+  typedef void (*ExitCallback)(VforkProcess* process,
+                               int64_t exit_status,
+                               int term_signal);
+
+  // Whether Spawn() can create the child for |options|. Only on Linux, and
+  // not with a uid or gid to change to, as setuid() and setgid() signal the
+  // threads of the parent, whose memory the child runs on until exec().
+  static bool CanSpawn(const uv_process_options_t* options);
+
+  // Like uv_spawn(), with |exit_cb| in place of |options->exit_cb|.
+  int Spawn(uv_loop_t* loop,
+            const uv_process_options_t* options,
+            ExitCallback exit_cb);
+
+  // Like uv_process_kill().
+  int Kill(int signum);
+
+  inline uv_handle_t* handle() {
+    return reinterpret_cast<uv_handle_t*>(&signal_);
+  }
+
+  inline int pid() const {
+    return pid_;
+  }
+
+ private:
+  static void OnSignal(uv_signal_t* handle, int signum);
+
+  uv_signal_t signal_;
+  ExitCallback exit_cb_;
+  int pid_;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_VFORK_H_
@@ -27,29 +27,13 @@
 
 namespace node {
 
-Watchdog::Watchdog(v8::Isolate* isolate, uint64_t ms) : isolate_(isolate),
-                                                        timed_out_(false),
-                                                        destroyed_(false) {
-  int rc;
-  loop_ = new uv_loop_t;
-  CHECK(loop_);
-  rc = uv_loop_init(loop_);
-  if (rc != 0) {
-    FatalError("node::Watchdog::Watchdog()",
-               "Failed to initialize uv loop.");
-  }
-
-  rc = uv_async_init(loop_, &async_, &Watchdog::Async);
-  CHECK_EQ(0, rc);
-
-  rc = uv_timer_init(loop_, &timer_);
-  CHECK_EQ(0, rc);
-
-  rc = uv_timer_start(&timer_, &Watchdog::Timer, ms, 0);
-  CHECK_EQ(0, rc);
-
-  rc = uv_thread_create(&thread_, &Watchdog::Run, this);
-  CHECK_EQ(0, rc);
+Watchdog::Watchdog(v8::Isolate* isolate, uint64_t ms)
+    : isolate_(isolate),
+      deadline_(uv_hrtime() + ms * 1000000),
+      heap_index_(WatchdogHelper::kNotArmed),
+      timed_out_(false),
+      destroyed_(false) {
+  WatchdogHelper::GetInstance()->Arm(this);
 }
 
 
@@ -63,55 +47,151 @@ void Watchdog::Dispose() {
 }
 
 
+bool Watchdog::HasTimedOut() {
+  return WatchdogHelper::GetInstance()->HasTimedOut(this);
+}
+
+
 void Watchdog::Destroy() {
   if (destroyed_) {
     return;
   }
 
-  uv_async_send(&async_);
-  uv_thread_join(&thread_);
+  WatchdogHelper::GetInstance()->Disarm(this);
+  destroyed_ = true;
+}
 
-  uv_close(reinterpret_cast<uv_handle_t*>(&async_), nullptr);
 
-  // UV_RUN_DEFAULT so that libuv has a chance to clean up.
-  uv_run(loop_, UV_RUN_DEFAULT);
+void WatchdogHelper::Arm(Watchdog* wd) {
+  Mutex::ScopedLock lock(mutex_);
 
-  int rc = uv_loop_close(loop_);
-  CHECK_EQ(0, rc);
-  delete loop_;
-  loop_ = nullptr;
+  if (!has_running_thread_) {
+    CHECK_EQ(0, uv_thread_create(&thread_, Run, this));
+    has_running_thread_ = true;
+  }
 
-  destroyed_ = true;
+  heap_.push_back(wd);
+  Place(heap_.size() - 1, wd);
+  SiftUp(wd->heap_index_);
+  // The thread only needs to know when the nearest deadline changes.
+  if (wd->heap_index_ == 0)
+    cond_.Signal(lock);
 }
 
 
-void Watchdog::Run(void* arg) {
-  Watchdog* wd = static_cast<Watchdog*>(arg);
+void WatchdogHelper::Disarm(Watchdog* wd) {
+  Mutex::ScopedLock lock(mutex_);
+
+  // Once this returns, the thread does not touch |wd| any more. If the
+  // nearest deadline goes away, the thread wakes up for nothing.
+  if (wd->heap_index_ != kNotArmed)
+    Remove(wd->heap_index_);
+}
+
 
-  // UV_RUN_DEFAULT the loop will be stopped either by the async or the
-  // timer handle.
-  uv_run(wd->loop_, UV_RUN_DEFAULT);
+bool WatchdogHelper::HasTimedOut(Watchdog* wd) {
+  Mutex::ScopedLock lock(mutex_);
 
-  // Loop ref count reaches zero when both handles are closed.
-  // Close the timer handle on this side and let Destroy() close async_
-  uv_close(reinterpret_cast<uv_handle_t*>(&wd->timer_), nullptr);
+  return wd->timed_out_;
 }
 
 
-void Watchdog::Async(uv_async_t* async) {
-  Watchdog* w = ContainerOf(&Watchdog::async_, async);
-  uv_stop(w->loop_);
+void WatchdogHelper::Run(void* arg) {
+  WatchdogHelper* helper = static_cast<WatchdogHelper*>(arg);
+  Mutex::ScopedLock lock(helper->mutex_);
+
+  while (!helper->stopping_) {
+    if (helper->heap_.empty()) {
+      helper->cond_.Wait(lock);
+      continue;
+    }
+
+    Watchdog* wd = helper->heap_[0];
+    const uint64_t now = uv_hrtime();
+    if (now < wd->deadline_) {
+      helper->cond_.TimedWait(lock, wd->deadline_ - now);
+      continue;
+    }
+
+    helper->Remove(0);
+    wd->timed_out_ = true;
+    wd->isolate()->TerminateExecution();
+  }
+}
+
+
+void WatchdogHelper::Place(size_t index, Watchdog* wd) {
+  heap_[index] = wd;
+  wd->heap_index_ = index;
+}
+
+
+void WatchdogHelper::SiftUp(size_t index) {
+  Watchdog* wd = heap_[index];
+  while (index > 0) {
+    const size_t parent = (index - 1) / 2;
+    if (heap_[parent]->deadline_ <= wd->deadline_)
+      break;
+    Place(index, heap_[parent]);
+    index = parent;
+  }
+  Place(index, wd);
 }
 
 
-void Watchdog::Timer(uv_timer_t* timer) {
-  Watchdog* w = ContainerOf(&Watchdog::timer_, timer);
-  w->timed_out_ = true;
-  uv_stop(w->loop_);
-  w->isolate()->TerminateExecution();
+void WatchdogHelper::SiftDown(size_t index) {
+  Watchdog* wd = heap_[index];
+  const size_t size = heap_.size();
+  for (;;) {
+    size_t child = 2 * index + 1;
+    if (child >= size)
+      break;
+    if (child + 1 < size &&
+        heap_[child + 1]->deadline_ < heap_[child]->deadline_) {
+      child++;
+    }
+    if (wd->deadline_ <= heap_[child]->deadline_)
+      break;
+    Place(index, heap_[child]);
+    index = child;
+  }
+  Place(index, wd);
 }
 
 
+void WatchdogHelper::Remove(size_t index) {
+  Watchdog* wd = heap_[index];
+  Watchdog* last = heap_.back();
+  heap_.pop_back();
+  wd->heap_index_ = kNotArmed;
+  if (last == wd)
+    return;
+  // |last| takes the place of |wd|, and moves to where it belongs.
+  Place(index, last);
+  SiftUp(index);
+  SiftDown(last->heap_index_);
+}
+
+
+WatchdogHelper::WatchdogHelper()
+    : has_running_thread_(false),
+      stopping_(false) {}
+
+
+WatchdogHelper::~WatchdogHelper() {
+  {
+    Mutex::ScopedLock lock(mutex_);
+    if (!has_running_thread_)
+      return;
+    stopping_ = true;
+    cond_.Signal(lock);
+  }
+  CHECK_EQ(0, uv_thread_join(&thread_));
+}
+
+WatchdogHelper WatchdogHelper::instance;
+
+
 SigintWatchdog::~SigintWatchdog() {
   Destroy();
 }
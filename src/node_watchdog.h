@@ -43,23 +43,56 @@ class Watchdog {
   void Dispose();
 
   v8::Isolate* isolate() { return isolate_; }
-  bool HasTimedOut() { return timed_out_; }
+  bool HasTimedOut();
  private:
-  void Destroy();
+  friend class WatchdogHelper;
 
-  static void Run(void* arg);
-  static void Async(uv_async_t* async);
-  static void Timer(uv_timer_t* timer);
+  void Destroy();
 
   v8::Isolate* isolate_;
-  uv_thread_t thread_;
-  uv_loop_t* loop_;
-  uv_async_t async_;
-  uv_timer_t timer_;
+  // In uv_hrtime() nanoseconds.
+  uint64_t deadline_;
+  // Where in the heap of WatchdogHelper it is, while it is armed.
+  size_t heap_index_;
   bool timed_out_;
   bool destroyed_;
 };
 
+// The one thread that runs the timeouts of all Watchdogs, so that a timeout
+// costs no thread of its own. The Watchdogs are kept in a binary heap by
+// deadline, which makes arming and disarming one O(log n); the thread sleeps
+// until the nearest deadline and terminates the execution of the isolate of
+// each Watchdog whose deadline passes.
+class WatchdogHelper {
+ public:
+  static WatchdogHelper* GetInstance() { return &instance; }
+  void Arm(Watchdog* watchdog);
+  void Disarm(Watchdog* watchdog);
+  bool HasTimedOut(Watchdog* watchdog);
+
+  static const size_t kNotArmed = static_cast<size_t>(-1);
+
+ private:
+  WatchdogHelper();
+  ~WatchdogHelper();
+
+  static void Run(void* arg);
+
+  void Place(size_t index, Watchdog* watchdog);
+  void SiftUp(size_t index);
+  void SiftDown(size_t index);
+  void Remove(size_t index);
+
+  static WatchdogHelper instance;
+
+  Mutex mutex_;
+  ConditionVariable cond_;
+  std::vector<Watchdog*> heap_;
+  uv_thread_t thread_;
+  bool has_running_thread_;
+  bool stopping_;
+};
+
 class SigintWatchdog {
  public:
   explicit SigintWatchdog(v8::Isolate* isolate);
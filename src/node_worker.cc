@@ -0,0 +1,274 @@
+#include "node_worker.h"
+#include "async-wrap.h"
+#include "async-wrap-inl.h"
+#include "env.h"
+#include "env-inl.h"
+#include "node_internals.h"
+#include "util.h"
+#include "util-inl.h"
+
+namespace node {
+namespace worker {
+
+using v8::Boolean;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::Locker;
+using v8::Number;
+using v8::Object;
+using v8::SealHandleScope;
+using v8::Value;
+
+namespace {
+
+Mutex next_thread_id_mutex;
+uint64_t next_thread_id = 1;
+
+uint64_t NextThreadId() {
+  Mutex::ScopedLock lock(next_thread_id_mutex);
+  return next_thread_id++;
+}
+
+}  // anonymous namespace
+
+
+Worker::Worker(Environment* env,
+               Local<Object> wrap,
+               const std::string& filename)
+    : HandleWrap(env,
+                 wrap,
+                 reinterpret_cast<uv_handle_t*>(&thread_exit_async_),
+                 AsyncWrap::PROVIDER_WORKER),
+      filename_(filename),
+      thread_id_(NextThreadId()) {
+  CHECK_EQ(uv_async_init(env->event_loop(),
+                         &thread_exit_async_,
+                         [](uv_async_t* handle) {
+    Worker* w = ContainerOf(&Worker::thread_exit_async_, handle);
+    w->OnThreadStopped();
+  }), 0);
+
+  parent_port_ = MessagePort::New(env, env->context());
+  CHECK_NE(parent_port_, nullptr);
+  child_port_data_.reset(new MessagePortData());
+  MessagePortData::Entangle(parent_port_->data(), child_port_data_.get());
+
+  object()->Set(env->message_port_string(), parent_port_->object());
+  object()->Set(env->thread_id_string(),
+                Number::New(env->isolate(), static_cast<double>(thread_id_)));
+}
+
+
+Worker::~Worker() {
+  CHECK(thread_joined_);
+}
+
+
+void Worker::Run() {
+  ArrayBufferAllocator allocator;
+  Isolate* isolate = NewIsolate(&allocator);
+  CHECK_NE(isolate, nullptr);
+  CHECK_EQ(uv_loop_init(&loop_), 0);
+  CHECK_EQ(uv_async_init(&loop_, &stop_async_, [](uv_async_t* handle) {
+    uv_stop(handle->loop);
+  }), 0);
+  uv_unref(reinterpret_cast<uv_handle_t*>(&stop_async_));
+
+  char exec_path[PATH_MAX];
+  size_t exec_path_len = sizeof(exec_path);
+  if (uv_exepath(exec_path, &exec_path_len) != 0)
+    snprintf(exec_path, sizeof(exec_path), "node");
+
+  {
+    Locker locker(isolate);
+    Isolate::Scope isolate_scope(isolate);
+    {
+      Mutex::ScopedLock lock(mutex_);
+      isolate_ = isolate;
+      if (stopped_)
+        isolate->TerminateExecution();
+    }
+
+    HandleScope handle_scope(isolate);
+    IsolateData isolate_data(isolate, &loop_, &allocator);
+    Local<Context> context = Context::New(isolate);
+    Context::Scope context_scope(context);
+    {
+      Environment env(&isolate_data, context);
+      env.set_worker_context(this);
+      env.set_thread_id(thread_id_);
+      SetThreadLocalEnvironment(&env);
+
+      const char* argv[] = { exec_path, filename_.c_str() };
+      env.Start(arraysize(argv), argv, 0, nullptr, false);
+      if (!is_stopped()) {
+        Environment::AsyncCallbackScope callback_scope(&env);
+        LoadEnvironment(&env);
+      }
+      if (!is_stopped())
+        SpinEventLoop(&env);
+      if (!is_stopped()) {
+        const int exit_code = EmitExit(&env);
+        Mutex::ScopedLock lock(mutex_);
+        if (!stopped_) {
+          stopped_ = true;
+          exit_code_ = exit_code;
+        }
+      }
+      RunAtExit(&env);
+
+      // No more JavaScript runs. Close what the script left open and let
+      // pending requests finish, so that the Environment can go away.
+      isolate->TerminateExecution();
+      env.stop_sub_worker_contexts();
+      uv_idle_stop(env.immediate_idle_handle());
+      for (HandleWrap* wrap : *env.handle_wrap_queue())
+        wrap->Close();
+      {
+        SealHandleScope seal(isolate);
+        uv_run(&loop_, UV_RUN_DEFAULT);
+      }
+      env.release_sab_lifetime_partners();
+      SetThreadLocalEnvironment(nullptr);
+    }
+  }
+
+  {
+    Mutex::ScopedLock lock(mutex_);
+    isolate_ = nullptr;
+  }
+  isolate->Dispose();
+
+  uv_close(reinterpret_cast<uv_handle_t*>(&stop_async_), nullptr);
+  uv_run(&loop_, UV_RUN_DEFAULT);
+  CHECK_EQ(uv_loop_close(&loop_), 0);
+
+  CHECK_EQ(uv_async_send(&thread_exit_async_), 0);
+}
+
+
+void Worker::Exit(int code) {
+  Mutex::ScopedLock lock(mutex_);
+  if (stopped_)
+    return;
+  stopped_ = true;
+  exit_code_ = code;
+  if (isolate_ != nullptr) {
+    isolate_->TerminateExecution();
+    CHECK_EQ(uv_async_send(&stop_async_), 0);
+  }
+}
+
+
+bool Worker::is_stopped() const {
+  Mutex::ScopedLock lock(mutex_);
+  return stopped_;
+}
+
+
+void Worker::JoinThread() {
+  if (thread_joined_)
+    return;
+  CHECK_EQ(uv_thread_join(&tid_), 0);
+  thread_joined_ = true;
+  env()->remove_sub_worker_context(this);
+}
+
+
+void Worker::OnThreadStopped() {
+  JoinThread();
+
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+
+  // What the thread posted before it ended arrives before 'exit'.
+  MessagePort* port = parent_port_;
+  parent_port_ = nullptr;
+  port->OnMessage();
+  port->Close();
+
+  Local<Value> code = Integer::New(env()->isolate(), exit_code_);
+  MakeCallback(env()->onexit_string(), 1, &code);
+  Close();
+}
+
+
+void Worker::OnBeforeClose() {
+  // The Environment of the Worker is going away while the thread runs.
+  Exit(1);
+  JoinThread();
+}
+
+
+void Worker::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsString());
+  node::Utf8Value filename(env->isolate(), args[0]);
+  new Worker(env, args.This(), *filename);
+}
+
+
+void Worker::StartThread(const FunctionCallbackInfo<Value>& args) {
+  Worker* w;
+  ASSIGN_OR_RETURN_UNWRAP(&w, args.Holder());
+  CHECK(w->thread_joined_);
+  CHECK_EQ(uv_thread_create(&w->tid_, [](void* arg) {
+    static_cast<Worker*>(arg)->Run();
+  }, static_cast<void*>(w)), 0);
+  w->thread_joined_ = false;
+  w->env()->add_sub_worker_context(w);
+}
+
+
+void Worker::StopThread(const FunctionCallbackInfo<Value>& args) {
+  Worker* w;
+  ASSIGN_OR_RETURN_UNWRAP(&w, args.Holder());
+  w->Exit(1);
+}
+
+
+void Worker::Initialize(Local<Object> target,
+                        Local<Value> unused,
+                        Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+
+  Local<FunctionTemplate> w = env->NewFunctionTemplate(Worker::New);
+  w->InstanceTemplate()->SetInternalFieldCount(1);
+  w->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "Worker"));
+  env->SetProtoMethod(w, "startThread", StartThread);
+  env->SetProtoMethod(w, "stopThread", StopThread);
+  env->SetProtoMethod(w, "ref", HandleWrap::Ref);
+  env->SetProtoMethod(w, "unref", HandleWrap::Unref);
+  env->SetProtoMethod(w, "hasRef", HandleWrap::HasRef);
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "Worker"),
+              w->GetFunction());
+
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "MessagePort"),
+              MessagePort::GetConstructorTemplate(env)->GetFunction());
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "isMainThread"),
+              Boolean::New(env->isolate(), env->is_main_thread()));
+  target->Set(env->thread_id_string(),
+              Number::New(env->isolate(),
+                          static_cast<double>(env->thread_id())));
+
+  if (!env->is_main_thread()) {
+    Worker* worker = env->worker_context();
+    MessagePort* port =
+        MessagePort::New(env, context, std::move(worker->child_port_data_));
+    if (port != nullptr) {
+      target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "parentPort"),
+                  port->object());
+    }
+  }
+}
+
+}  // namespace worker
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(worker, node::worker::Worker::Initialize)
@@ -0,0 +1,85 @@
+#ifndef SRC_NODE_WORKER_H_
+#define SRC_NODE_WORKER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "env.h"
+#include "handle_wrap.h"
+#include "node_messaging.h"
+#include "node_mutex.h"
+#include "uv.h"
+#include "v8.h"
+
+#include <memory>
+#include <string>
+
+namespace node {
+namespace worker {
+
+// A thread with its own isolate, Environment and event loop that runs a
+// script, the native side of the Worker class in lib/internal/worker.js.
+// The Worker object lives in the Environment that started it. Its handle
+// keeps that event loop alive until the thread has ended, and onexit(code)
+// is called then. The two Environments talk through a pair of MessagePorts:
+// the messagePort property of the Worker, and parentPort of the worker
+// binding in the thread.
+class Worker : public HandleWrap {
+ public:
+  static void Initialize(v8::Local<v8::Object> target,
+                         v8::Local<v8::Value> unused,
+                         v8::Local<v8::Context> context);
+
+  ~Worker() override;
+
+  // Makes the thread stop running JavaScript and end with |code|, unless it
+  // is stopping already. Can be called from any thread.
+  void Exit(int code);
+  bool is_stopped() const;
+
+  // Waits for the thread to end. Called on the thread that started it.
+  void JoinThread();
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  Worker(Environment* env,
+         v8::Local<v8::Object> wrap,
+         const std::string& filename);
+
+  // The body of the thread.
+  void Run();
+  void OnThreadStopped();
+  void OnBeforeClose() override;
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void StartThread(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void StopThread(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  const std::string filename_;
+  const uint64_t thread_id_;
+  uv_thread_t tid_;
+  bool thread_joined_ = true;
+
+  // Signalled by the thread when it has ended, in the parent's loop.
+  uv_async_t thread_exit_async_;
+  // The loop of the thread, and a handle in it that Exit() wakes it with.
+  uv_loop_t loop_;
+  uv_async_t stop_async_;
+
+  mutable Mutex mutex_;
+  // The isolate of the thread while it can run JavaScript.
+  v8::Isolate* isolate_ = nullptr;
+  bool stopped_ = false;
+  int exit_code_ = 0;
+
+  MessagePort* parent_port_ = nullptr;
+  // The other end of the channel, until the thread makes its port of it.
+  std::unique_ptr<MessagePortData> child_port_data_;
+};
+
+}  // namespace worker
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_WORKER_H_
@@ -21,9 +21,13 @@
 
 #include "node.h"
 #include "node_buffer.h"
+#include "node_mutex.h"
+#include "node_threadpool.h"
 
 #include "async-wrap.h"
 #include "async-wrap-inl.h"
+#include "base-object.h"
+#include "base-object-inl.h"
 #include "env.h"
 #include "env-inl.h"
 #include "util.h"
@@ -32,10 +36,26 @@
 #include "v8.h"
 #include "zlib.h"
 
+#if NODE_HAVE_BROTLI
+#include "brotli/decode.h"
+#include "brotli/encode.h"
+#endif
+
 #include <errno.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#include <nmmintrin.h>
+#endif
 
 namespace node {
 
@@ -48,6 +68,8 @@ using v8::Integer;
 using v8::Local;
 using v8::Number;
 using v8::Object;
+using v8::Persistent;
+using v8::Undefined;
 using v8::Value;
 
 namespace {
@@ -60,12 +82,187 @@ enum node_zlib_mode {
   GUNZIP,
   DEFLATERAW,
   INFLATERAW,
-  UNZIP
+  UNZIP,
+  BROTLI_DECODE,
+  BROTLI_ENCODE
 };
 
+#if NODE_HAVE_BROTLI
+static const node_zlib_mode kLastMode = BROTLI_ENCODE;
+#else
+static const node_zlib_mode kLastMode = UNZIP;
+#endif
+
 #define GZIP_HEADER_ID1 0x1f
 #define GZIP_HEADER_ID2 0x8b
 
+/**
+ * zlib and Brotli allocate their state through ZMemory. A stream allocates
+ * the same few large blocks (window, hash chains, pending output) whenever it
+ * is set up, so blocks that large go to a pool shared by all contexts when a
+ * stream ends, and the next stream that wants the same size takes one from
+ * there. Streams also allocate on the thread pool, so the pool is locked and
+ * the bytes in use are only counted here; the owner of the counter reports
+ * them to the isolate from the main thread.
+ */
+class ZMemory {
+ public:
+  // |opaque| points to the size_t that counts the bytes in use.
+  static void* Allocate(void* opaque, size_t size) {
+    char* block = nullptr;
+    if (size >= kMinPooledSize) {
+      Mutex::ScopedLock lock(mutex_);
+      auto it = blocks_.find(size);
+      if (it != blocks_.end() && !it->second.empty()) {
+        block = it->second.back();
+        it->second.pop_back();
+        pooled_bytes_ -= size;
+      }
+    }
+    if (block == nullptr)
+      block = static_cast<char*>(malloc(kHeaderSize + size));
+    if (block == nullptr)
+      return nullptr;
+
+    *reinterpret_cast<size_t*>(block) = size;
+    *static_cast<size_t*>(opaque) += size;
+    return block + kHeaderSize;
+  }
+
+  static void* AllocateForZlib(void* opaque, uInt items, uInt size) {
+    return Allocate(opaque, static_cast<size_t>(items) * size);
+  }
+
+  static void Free(void* opaque, void* pointer) {
+    if (pointer == nullptr)
+      return;
+
+    char* block = static_cast<char*>(pointer) - kHeaderSize;
+    const size_t size = *reinterpret_cast<size_t*>(block);
+    *static_cast<size_t*>(opaque) -= size;
+    if (size >= kMinPooledSize) {
+      Mutex::ScopedLock lock(mutex_);
+      if (pooled_bytes_ + size <= kMaxPooledBytes) {
+        blocks_[size].push_back(block);
+        pooled_bytes_ += size;
+        return;
+      }
+    }
+    free(block);
+  }
+
+ private:
+  static const size_t kHeaderSize = 2 * sizeof(size_t);  // Keeps alignment.
+  static const size_t kMinPooledSize = 4096;
+  static const size_t kMaxPooledBytes = 16 * 1024 * 1024;
+
+  static Mutex mutex_;
+  static std::unordered_map<size_t, std::vector<char*>> blocks_;
+  static size_t pooled_bytes_;
+};
+
+Mutex ZMemory::mutex_;
+std::unordered_map<size_t, std::vector<char*>> ZMemory::blocks_;
+size_t ZMemory::pooled_bytes_ = 0;
+
+
+/**
+ * A preset dictionary that any number of contexts can use without copying it.
+ * deflateSetDictionary() has to hash the whole dictionary, so for deflate the
+ * dictionary also keeps streams that have it loaded already, one for each set
+ * of parameters, and contexts start out as a copy of one of those.
+ */
+class ZDictionary : public BaseObject {
+ public:
+  ZDictionary(Environment* env, Local<Object> wrap, const char* data,
+              size_t len)
+      : BaseObject(env, wrap),
+        data_(data, data + len),
+        memory_(0) {
+    MakeWeak<ZDictionary>(this);
+    env->isolate()->AdjustAmountOfExternalAllocatedMemory(len);
+  }
+
+  ~ZDictionary() override {
+    int64_t change_in_bytes = -static_cast<int64_t>(data_.size() + memory_);
+    for (PrimedStream* primed : primed_) {
+      (void)deflateEnd(&primed->strm);
+      delete primed;
+    }
+    env()->isolate()->AdjustAmountOfExternalAllocatedMemory(change_in_bytes);
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    CHECK(Buffer::HasInstance(args[0]));
+    new ZDictionary(env, args.This(), Buffer::Data(args[0]),
+                    Buffer::Length(args[0]));
+  }
+
+  static bool HasInstance(Environment* env, Local<Value> value) {
+    return env->zlib_dictionary_constructor_template()->HasInstance(value);
+  }
+
+  Bytef* data() { return data_.empty() ? nullptr : &data_[0]; }
+  size_t length() const { return data_.size(); }
+
+  // Returns a deflate stream with the dictionary loaded for these parameters,
+  // or nullptr if there is none and one cannot be made.
+  z_stream* Primed(int level, int window_bits, int mem_level, int strategy) {
+    for (PrimedStream* primed : primed_) {
+      if (primed->level == level && primed->window_bits == window_bits &&
+          primed->mem_level == mem_level && primed->strategy == strategy) {
+        return &primed->strm;
+      }
+    }
+
+    if (primed_.size() >= kMaxPrimedStreams || data_.empty())
+      return nullptr;
+
+    const size_t memory_before = memory_;
+    PrimedStream* primed = new PrimedStream();
+    primed->level = level;
+    primed->window_bits = window_bits;
+    primed->mem_level = mem_level;
+    primed->strategy = strategy;
+    primed->strm.zalloc = ZMemory::AllocateForZlib;
+    primed->strm.zfree = ZMemory::Free;
+    primed->strm.opaque = &memory_;
+    if (deflateInit2(&primed->strm, level, Z_DEFLATED, window_bits, mem_level,
+                     strategy) != Z_OK) {
+      delete primed;
+      return nullptr;
+    }
+    if (deflateSetDictionary(&primed->strm, data(), data_.size()) != Z_OK) {
+      (void)deflateEnd(&primed->strm);
+      delete primed;
+      return nullptr;
+    }
+
+    primed_.push_back(primed);
+    env()->isolate()->AdjustAmountOfExternalAllocatedMemory(
+        memory_ - memory_before);
+    return &primed->strm;
+  }
+
+ private:
+  struct PrimedStream {
+    int level;
+    int window_bits;
+    int mem_level;
+    int strategy;
+    z_stream strm;
+  };
+
+  static const size_t kMaxPrimedStreams = 8;
+
+  std::vector<Bytef> data_;
+  std::vector<PrimedStream*> primed_;
+  size_t memory_;  // Used by the primed streams.
+};
+
+
 /**
  * Deflate/Inflate
  */
@@ -75,6 +272,7 @@ class ZCtx : public AsyncWrap {
       : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_ZLIB),
         dictionary_(nullptr),
         dictionary_len_(0),
+        dictionary_loaded_(false),
         err_(0),
         flush_(0),
         init_done_(false),
@@ -86,7 +284,17 @@ class ZCtx : public AsyncWrap {
         write_in_progress_(false),
         pending_close_(false),
         refs_(0),
-        gzip_id_bytes_read_(0) {
+        gzip_id_bytes_read_(0),
+        out_(nullptr),
+        out_size_(0),
+        out_too_large_(false),
+        zlib_memory_(0),
+        reported_memory_(0),
+        released_(false) {
+#if NODE_HAVE_BROTLI
+    brotli_encoder_ = nullptr;
+    brotli_decoder_ = nullptr;
+#endif
     MakeWeak<ZCtx>(this);
   }
 
@@ -104,24 +312,22 @@ class ZCtx : public AsyncWrap {
 
     pending_close_ = false;
     CHECK(init_done_ && "close before init");
-    CHECK_LE(mode_, UNZIP);
+    CHECK_LE(mode_, kLastMode);
 
-    if (mode_ == DEFLATE || mode_ == GZIP || mode_ == DEFLATERAW) {
-      (void)deflateEnd(&strm_);
-      int64_t change_in_bytes = -static_cast<int64_t>(kDeflateContextSize);
-      env()->isolate()->AdjustAmountOfExternalAllocatedMemory(change_in_bytes);
-    } else if (mode_ == INFLATE || mode_ == GUNZIP || mode_ == INFLATERAW ||
-               mode_ == UNZIP) {
-      (void)inflateEnd(&strm_);
-      int64_t change_in_bytes = -static_cast<int64_t>(kInflateContextSize);
-      env()->isolate()->AdjustAmountOfExternalAllocatedMemory(change_in_bytes);
-    }
+    if (!released_)
+      EndStream(this);
+    released_ = false;
     mode_ = NONE;
+    ReportMemory();
 
-    if (dictionary_ != nullptr) {
+    // A shared dictionary belongs to its ZDictionary, which outlives the use.
+    if (dictionary_object_.IsEmpty())
       delete[] dictionary_;
-      dictionary_ = nullptr;
-    }
+    dictionary_object_.Reset();
+    dictionary_ = nullptr;
+
+    free(out_);
+    out_ = nullptr;
   }
 
 
@@ -132,6 +338,30 @@ class ZCtx : public AsyncWrap {
   }
 
 
+  // releaseMemory()
+  // Frees the state of a stream that is between writes, which loses what it
+  // would have remembered from earlier input. The next write sets the state
+  // up again, so this is like reset() except for the memory. Returns false
+  // if a write is in progress.
+  static void ReleaseMemory(const FunctionCallbackInfo<Value>& args) {
+    ZCtx* ctx;
+    ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
+    CHECK(ctx->init_done_ && "releaseMemory before init");
+
+    if (ctx->write_in_progress_ || ctx->mode_ == NONE) {
+      args.GetReturnValue().Set(false);
+      return;
+    }
+
+    if (!ctx->released_) {
+      EndStream(ctx);
+      ctx->released_ = true;
+      ctx->ReportMemory();
+    }
+    args.GetReturnValue().Set(true);
+  }
+
+
   // write(flush, in, in_off, in_len, out, out_off, out_len)
   template <bool async>
   static void Write(const FunctionCallbackInfo<Value>& args) {
@@ -144,6 +374,11 @@ class ZCtx : public AsyncWrap {
 
     CHECK_EQ(false, ctx->write_in_progress_ && "write already in progress");
     CHECK_EQ(false, ctx->pending_close_ && "close is pending");
+    if (!Restore(ctx)) {
+      if (async)
+        args.GetReturnValue().Set(ctx->object());
+      return;
+    }
     ctx->write_in_progress_ = true;
     ctx->Ref();
 
@@ -201,21 +436,195 @@ class ZCtx : public AsyncWrap {
       // sync version
       ctx->env()->PrintSyncTrace();
       Process(work_req);
+      ctx->ReportMemory();
       if (CheckError(ctx))
         AfterSync(ctx, args);
       return;
     }
 
     // async version
-    uv_queue_work(ctx->env()->event_loop(),
-                  work_req,
-                  ZCtx::Process,
-                  ZCtx::After);
+    threadpool::QueueWork(ctx->env()->event_loop(),
+                          work_req,
+                          threadpool::kCpuWork,
+                          threadpool::kLowPriority,
+                          ZCtx::Process,
+                          ZCtx::After,
+                          NODE_THREADPOOL_TRACE_ZLIB,
+                          "zlib.write");
 
     args.GetReturnValue().Set(ctx->object());
   }
 
 
+  // writeAll(flush, in)
+  // Processes all of |in| in one go, with |flush| as the only flush, into an
+  // output buffer that grows as needed. The async version queues a single
+  // job and calls oncomplete(buffer) when it is done, the sync version
+  // returns the buffer. The buffer is undefined if the output would be
+  // larger than kMaxLength.
+  template <bool async>
+  static void WriteAll(const FunctionCallbackInfo<Value>& args) {
+    CHECK_EQ(args.Length(), 2);
+
+    ZCtx* ctx;
+    ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
+    CHECK(ctx->init_done_ && "write before init");
+    CHECK(ctx->mode_ != NONE && "already finalized");
+
+    CHECK_EQ(false, ctx->write_in_progress_ && "write already in progress");
+    CHECK_EQ(false, ctx->pending_close_ && "close is pending");
+    if (!Restore(ctx))
+      return;
+    ctx->write_in_progress_ = true;
+    ctx->Ref();
+
+    ctx->flush_ = args[0]->Uint32Value();
+    CHECK(ctx->flush_ >= Z_NO_FLUSH && ctx->flush_ <= Z_BLOCK &&
+          "Invalid flush value");
+    CHECK(Buffer::HasInstance(args[1]));
+    Local<Object> in_buf = args[1].As<Object>();
+    ctx->strm_.avail_in = Buffer::Length(in_buf);
+    ctx->strm_.next_in = reinterpret_cast<Bytef*>(Buffer::Data(in_buf));
+    ctx->strm_.avail_out = 0;
+    ctx->strm_.next_out = nullptr;
+
+    if (!async) {
+      ctx->env()->PrintSyncTrace();
+      ProcessAll(&ctx->work_req_);
+      ctx->ReportMemory();
+      Local<Value> result;
+      if (ctx->FinishAll(&result))
+        args.GetReturnValue().Set(result);
+      return;
+    }
+
+    threadpool::QueueWork(ctx->env()->event_loop(),
+                          &ctx->work_req_,
+                          threadpool::kCpuWork,
+                          threadpool::kLowPriority,
+                          ZCtx::ProcessAll,
+                          ZCtx::AfterAll,
+                          NODE_THREADPOOL_TRACE_ZLIB,
+                          "zlib.writeAll");
+  }
+
+
+  // thread pool!
+  // Calls Process() until the output stops filling up whatever room it was
+  // given, which is the same condition the stream path in lib/zlib.js uses.
+  static void ProcessAll(uv_work_t* work_req) {
+    ZCtx* ctx = ContainerOf(&ZCtx::work_req_, work_req);
+    const size_t in_len = ctx->strm_.avail_in;
+
+    do {
+      if (!ctx->GrowOutput(in_len))
+        return;
+      Process(work_req);
+    } while (ctx->strm_.avail_out == 0 &&
+             (ctx->err_ == Z_OK ||
+              ctx->err_ == Z_BUF_ERROR ||
+              ctx->err_ == Z_STREAM_END));
+  }
+
+
+  // Deflate and Brotli output is allocated at its bound right away. Inflate
+  // output starts at a multiple of the input and doubles whenever it is full.
+  bool GrowOutput(size_t in_len) {
+    const size_t used = out_size_ - strm_.avail_out;
+    size_t size;
+    if (out_size_ == 0 && (mode_ == DEFLATE || mode_ == GZIP ||
+                           mode_ == DEFLATERAW)) {
+      size = deflateBound(&strm_, in_len);
+#if NODE_HAVE_BROTLI
+    } else if (out_size_ == 0 && mode_ == BROTLI_ENCODE &&
+               BrotliEncoderMaxCompressedSize(in_len) != 0) {
+      size = BrotliEncoderMaxCompressedSize(in_len);
+#endif
+    } else if (out_size_ == 0) {
+      if (in_len < kMinOutputSize / 4)
+        size = kMinOutputSize;
+      else if (in_len < Buffer::kMaxLength / 4)
+        size = in_len * 4;
+      else
+        size = Buffer::kMaxLength;
+    } else {
+      size = out_size_ * 2;
+    }
+    if (size > Buffer::kMaxLength)
+      size = Buffer::kMaxLength;
+    if (size <= out_size_) {
+      out_too_large_ = true;
+      return false;
+    }
+
+    // Not node::Realloc(), which would touch the isolate on failure.
+    Bytef* out = static_cast<Bytef*>(realloc(out_, size));
+    if (out == nullptr) {
+      err_ = Z_MEM_ERROR;
+      return false;
+    }
+    out_ = out;
+    out_size_ = size;
+    strm_.next_out = out_ + used;
+    strm_.avail_out = size - used;
+    return true;
+  }
+
+
+  // Hands the output over to a Buffer, or reports the error. Returns false
+  // if the error callback was called.
+  bool FinishAll(Local<Value>* result) {
+    const size_t used = out_size_ - strm_.avail_out;
+    char* data = reinterpret_cast<char*>(out_);
+    out_ = nullptr;
+    out_size_ = 0;
+
+    if (out_too_large_) {
+      out_too_large_ = false;
+      free(data);
+      *result = Undefined(env()->isolate());
+    } else if (!CheckError(this)) {
+      free(data);
+      return false;
+    } else if (used == 0) {
+      free(data);
+      *result = Buffer::New(env()->isolate(), 0).ToLocalChecked();
+    } else {
+      // Give back what deflateBound() or the last doubling overestimated.
+      char* shrunk = static_cast<char*>(realloc(data, used));
+      if (shrunk != nullptr)
+        data = shrunk;
+      *result = Buffer::New(env()->isolate(), data, used).ToLocalChecked();
+    }
+
+    write_in_progress_ = false;
+    Unref();
+    return true;
+  }
+
+
+  // v8 land!
+  static void AfterAll(uv_work_t* work_req, int status) {
+    CHECK_EQ(status, 0);
+
+    ZCtx* ctx = ContainerOf(&ZCtx::work_req_, work_req);
+    Environment* env = ctx->env();
+
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    ctx->ReportMemory();
+    Local<Value> result;
+    if (!ctx->FinishAll(&result))
+      return;
+
+    ctx->MakeCallback(env->oncomplete_string(), 1, &result);
+
+    if (ctx->pending_close_)
+      ctx->Close();
+  }
+
+
   static void AfterSync(ZCtx* ctx, const FunctionCallbackInfo<Value>& args) {
     Environment* env = ctx->env();
     Local<Integer> avail_out = Integer::New(env->isolate(),
@@ -335,6 +744,12 @@ class ZCtx : public AsyncWrap {
           ctx->err_ = inflate(&ctx->strm_, ctx->flush_);
         }
         break;
+#if NODE_HAVE_BROTLI
+      case BROTLI_ENCODE:
+      case BROTLI_DECODE:
+        ProcessBrotli(ctx);
+        break;
+#endif
       default:
         CHECK(0 && "wtf?");
     }
@@ -347,6 +762,61 @@ class ZCtx : public AsyncWrap {
   }
 
 
+#if NODE_HAVE_BROTLI
+  // Brotli works on the same in and out pointers as zlib, and its results
+  // are turned into the zlib status codes that mean the same to
+  // CheckError() and to the loop in lib/zlib.js.
+  static void ProcessBrotli(ZCtx* ctx) {
+    size_t avail_in = ctx->strm_.avail_in;
+    const uint8_t* next_in = ctx->strm_.next_in;
+    size_t avail_out = ctx->strm_.avail_out;
+    uint8_t* next_out = ctx->strm_.next_out;
+
+    if (ctx->mode_ == BROTLI_ENCODE) {
+      BrotliEncoderOperation op = BROTLI_OPERATION_PROCESS;
+      if (ctx->flush_ == Z_FINISH)
+        op = BROTLI_OPERATION_FINISH;
+      else if (ctx->flush_ != Z_NO_FLUSH)
+        op = BROTLI_OPERATION_FLUSH;
+      if (!BrotliEncoderCompressStream(ctx->brotli_encoder_, op,
+                                       &avail_in, &next_in,
+                                       &avail_out, &next_out, nullptr)) {
+        ctx->err_ = Z_STREAM_ERROR;
+        ctx->strm_.msg = const_cast<char*>("Brotli compression failed");
+      } else if (BrotliEncoderIsFinished(ctx->brotli_encoder_)) {
+        ctx->err_ = Z_STREAM_END;
+      } else {
+        ctx->err_ = Z_OK;
+      }
+    } else {
+      switch (BrotliDecoderDecompressStream(ctx->brotli_decoder_,
+                                            &avail_in, &next_in,
+                                            &avail_out, &next_out,
+                                            nullptr)) {
+        case BROTLI_DECODER_RESULT_SUCCESS:
+          ctx->err_ = Z_STREAM_END;
+          break;
+        case BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT:
+          ctx->err_ = Z_BUF_ERROR;
+          break;
+        case BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT:
+          ctx->err_ = Z_OK;
+          break;
+        default:
+          ctx->err_ = Z_DATA_ERROR;
+          ctx->strm_.msg = const_cast<char*>("Brotli decompression failed");
+          break;
+      }
+    }
+
+    ctx->strm_.avail_in = avail_in;
+    ctx->strm_.next_in = const_cast<Bytef*>(next_in);
+    ctx->strm_.avail_out = avail_out;
+    ctx->strm_.next_out = next_out;
+  }
+#endif
+
+
   static bool CheckError(ZCtx* ctx) {
     // Acceptable error states depend on the type of zlib stream.
     switch (ctx->err_) {
@@ -385,6 +855,7 @@ class ZCtx : public AsyncWrap {
     HandleScope handle_scope(env->isolate());
     Context::Scope context_scope(env->context());
 
+    ctx->ReportMemory();
     if (!CheckError(ctx))
       return;
 
@@ -437,7 +908,7 @@ class ZCtx : public AsyncWrap {
     }
     node_zlib_mode mode = static_cast<node_zlib_mode>(args[0]->Int32Value());
 
-    if (mode < DEFLATE || mode > UNZIP) {
+    if (mode < DEFLATE || mode > kLastMode) {
       return env->ThrowTypeError("Bad argument");
     }
 
@@ -470,7 +941,15 @@ class ZCtx : public AsyncWrap {
 
     char* dictionary = nullptr;
     size_t dictionary_len = 0;
-    if (args.Length() >= 5 && Buffer::HasInstance(args[4])) {
+    ZDictionary* shared = nullptr;
+    if (args.Length() >= 5 &&
+        ZDictionary::HasInstance(ctx->env(), args[4])) {
+      Local<Object> dictionary_object = args[4].As<Object>();
+      ASSIGN_OR_RETURN_UNWRAP(&shared, dictionary_object);
+      ctx->dictionary_object_.Reset(args.GetIsolate(), dictionary_object);
+      dictionary = reinterpret_cast<char*>(shared->data());
+      dictionary_len = shared->length();
+    } else if (args.Length() >= 5 && Buffer::HasInstance(args[4])) {
       Local<Object> dictionary_ = args[4]->ToObject(args.GetIsolate());
 
       dictionary_len = Buffer::Length(dictionary_);
@@ -480,10 +959,40 @@ class ZCtx : public AsyncWrap {
     }
 
     Init(ctx, level, windowBits, memLevel, strategy,
-         dictionary, dictionary_len);
+         dictionary, dictionary_len, shared);
     SetDictionary(ctx);
   }
 
+  // initBrotli(quality, windowBits)
+  static void InitBrotli(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.Length() == 2 && "initBrotli(quality, windowBits)");
+
+    ZCtx* ctx;
+    ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
+    CHECK(ctx->mode_ == BROTLI_ENCODE || ctx->mode_ == BROTLI_DECODE);
+
+    ctx->level_ = args[0]->Int32Value();
+    ctx->windowBits_ = args[1]->Int32Value();
+#if NODE_HAVE_BROTLI
+    CHECK((ctx->level_ >= BROTLI_MIN_QUALITY &&
+           ctx->level_ <= BROTLI_MAX_QUALITY) && "invalid quality");
+    CHECK((ctx->windowBits_ >= BROTLI_MIN_WINDOW_BITS &&
+           ctx->windowBits_ <= BROTLI_MAX_WINDOW_BITS) &&
+          "invalid windowBits");
+#endif
+
+    ctx->strm_.msg = nullptr;
+    ctx->flush_ = Z_NO_FLUSH;
+    ctx->err_ = Z_OK;
+    InitBrotli(ctx);
+    ctx->ReportMemory();
+    if (ctx->err_ != Z_OK)
+      ZCtx::Error(ctx, "Init error");
+
+    ctx->write_in_progress_ = false;
+    ctx->init_done_ = true;
+  }
+
   static void Params(const FunctionCallbackInfo<Value>& args) {
     CHECK(args.Length() == 2 && "params(level, strategy)");
     ZCtx* ctx;
@@ -494,20 +1003,25 @@ class ZCtx : public AsyncWrap {
   static void Reset(const FunctionCallbackInfo<Value> &args) {
     ZCtx* ctx;
     ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
+    // A released stream starts out fresh anyway.
+    if (ctx->released_)
+      return;
     Reset(ctx);
     SetDictionary(ctx);
+    ctx->ReportMemory();
   }
 
   static void Init(ZCtx *ctx, int level, int windowBits, int memLevel,
-                   int strategy, char* dictionary, size_t dictionary_len) {
+                   int strategy, char* dictionary, size_t dictionary_len,
+                   ZDictionary* shared = nullptr) {
     ctx->level_ = level;
     ctx->windowBits_ = windowBits;
     ctx->memLevel_ = memLevel;
     ctx->strategy_ = strategy;
 
-    ctx->strm_.zalloc = Z_NULL;
-    ctx->strm_.zfree = Z_NULL;
-    ctx->strm_.opaque = Z_NULL;
+    ctx->strm_.zalloc = ZMemory::AllocateForZlib;
+    ctx->strm_.zfree = ZMemory::Free;
+    ctx->strm_.opaque = &ctx->zlib_memory_;
 
     ctx->flush_ = Z_NO_FLUSH;
 
@@ -525,41 +1039,115 @@ class ZCtx : public AsyncWrap {
       ctx->windowBits_ *= -1;
     }
 
+    InitStream(ctx, shared);
+    ctx->ReportMemory();
+
+    if (ctx->err_ != Z_OK) {
+      ZCtx::Error(ctx, "Init error");
+    }
+
+
+    ctx->dictionary_ = reinterpret_cast<Bytef *>(dictionary);
+    ctx->dictionary_len_ = dictionary_len;
+
+    ctx->write_in_progress_ = false;
+    ctx->init_done_ = true;
+  }
+
+  // Sets up strm_ for the mode and parameters. Sets err_ if that fails.
+  static void InitStream(ZCtx* ctx, ZDictionary* shared) {
+    z_stream* primed = nullptr;
+    if (shared != nullptr &&
+        (ctx->mode_ == DEFLATE || ctx->mode_ == DEFLATERAW)) {
+      primed = shared->Primed(ctx->level_, ctx->windowBits_, ctx->memLevel_,
+                              ctx->strategy_);
+    }
+
     switch (ctx->mode_) {
       case DEFLATE:
       case GZIP:
       case DEFLATERAW:
-        ctx->err_ = deflateInit2(&ctx->strm_,
-                                 ctx->level_,
-                                 Z_DEFLATED,
-                                 ctx->windowBits_,
-                                 ctx->memLevel_,
-                                 ctx->strategy_);
-        ctx->env()->isolate()
-            ->AdjustAmountOfExternalAllocatedMemory(kDeflateContextSize);
+        if (primed != nullptr) {
+          // Saves hashing the dictionary again in SetDictionary(). The copy
+          // is allocated through the opaque pointer that it copies.
+          void* opaque = primed->opaque;
+          primed->opaque = &ctx->zlib_memory_;
+          ctx->err_ = deflateCopy(&ctx->strm_, primed);
+          primed->opaque = opaque;
+          ctx->dictionary_loaded_ = ctx->err_ == Z_OK;
+        } else {
+          ctx->err_ = deflateInit2(&ctx->strm_,
+                                   ctx->level_,
+                                   Z_DEFLATED,
+                                   ctx->windowBits_,
+                                   ctx->memLevel_,
+                                   ctx->strategy_);
+        }
         break;
       case INFLATE:
       case GUNZIP:
       case INFLATERAW:
       case UNZIP:
         ctx->err_ = inflateInit2(&ctx->strm_, ctx->windowBits_);
-        ctx->env()->isolate()
-            ->AdjustAmountOfExternalAllocatedMemory(kInflateContextSize);
         break;
       default:
         CHECK(0 && "wtf?");
     }
+  }
 
-    if (ctx->err_ != Z_OK) {
-      ZCtx::Error(ctx, "Init error");
+  static void EndStream(ZCtx* ctx) {
+    switch (ctx->mode_) {
+      case DEFLATE:
+      case GZIP:
+      case DEFLATERAW:
+        (void)deflateEnd(&ctx->strm_);
+        break;
+      case INFLATE:
+      case GUNZIP:
+      case INFLATERAW:
+      case UNZIP:
+        (void)inflateEnd(&ctx->strm_);
+        break;
+      case BROTLI_ENCODE:
+      case BROTLI_DECODE:
+        EndBrotli(ctx);
+        break;
+      default:
+        break;
     }
+  }
 
+  // Sets the state up again if releaseMemory() freed it. Returns false if
+  // the error callback was called.
+  static bool Restore(ZCtx* ctx) {
+    if (!ctx->released_)
+      return true;
 
-    ctx->dictionary_ = reinterpret_cast<Bytef *>(dictionary);
-    ctx->dictionary_len_ = dictionary_len;
+    ctx->released_ = false;
+    ctx->err_ = Z_OK;
+    ctx->strm_.msg = nullptr;
+    if (ctx->mode_ == BROTLI_ENCODE || ctx->mode_ == BROTLI_DECODE) {
+      InitBrotli(ctx);
+    } else {
+      ZDictionary* shared = nullptr;
+      if (!ctx->dictionary_object_.IsEmpty()) {
+        shared = Unwrap<ZDictionary>(
+            PersistentToLocal(ctx->env()->isolate(), ctx->dictionary_object_));
+      }
+      ctx->dictionary_loaded_ = false;
+      InitStream(ctx, shared);
+    }
+    ctx->ReportMemory();
 
-    ctx->write_in_progress_ = false;
-    ctx->init_done_ = true;
+    if (ctx->err_ != Z_OK) {
+      EndStream(ctx);
+      ctx->released_ = true;
+      ZCtx::Error(ctx, "Init error");
+      return false;
+    }
+
+    SetDictionary(ctx);
+    return ctx->err_ == Z_OK;
   }
 
   static void SetDictionary(ZCtx* ctx) {
@@ -571,9 +1159,11 @@ class ZCtx : public AsyncWrap {
     switch (ctx->mode_) {
       case DEFLATE:
       case DEFLATERAW:
-        ctx->err_ = deflateSetDictionary(&ctx->strm_,
-                                         ctx->dictionary_,
-                                         ctx->dictionary_len_);
+        if (!ctx->dictionary_loaded_) {
+          ctx->err_ = deflateSetDictionary(&ctx->strm_,
+                                           ctx->dictionary_,
+                                           ctx->dictionary_len_);
+        }
         break;
       case INFLATERAW:
         // The other inflate cases will have the dictionary set when inflate()
@@ -597,7 +1187,13 @@ class ZCtx : public AsyncWrap {
     switch (ctx->mode_) {
       case DEFLATE:
       case DEFLATERAW:
-        ctx->err_ = deflateParams(&ctx->strm_, level, strategy);
+        // Restore() uses these.
+        if (!ctx->released_)
+          ctx->err_ = deflateParams(&ctx->strm_, level, strategy);
+        if (ctx->err_ == Z_OK || ctx->err_ == Z_BUF_ERROR) {
+          ctx->level_ = level;
+          ctx->strategy_ = strategy;
+        }
         break;
       default:
         break;
@@ -610,6 +1206,7 @@ class ZCtx : public AsyncWrap {
 
   static void Reset(ZCtx* ctx) {
     ctx->err_ = Z_OK;
+    ctx->dictionary_loaded_ = false;
 
     switch (ctx->mode_) {
       case DEFLATE:
@@ -622,6 +1219,12 @@ class ZCtx : public AsyncWrap {
       case GUNZIP:
         ctx->err_ = inflateReset(&ctx->strm_);
         break;
+      case BROTLI_ENCODE:
+      case BROTLI_DECODE:
+        // Brotli has no reset, start over with a new state.
+        EndBrotli(ctx);
+        InitBrotli(ctx);
+        break;
       default:
         break;
     }
@@ -631,9 +1234,55 @@ class ZCtx : public AsyncWrap {
     }
   }
 
+  // Creates the state for the current quality and window size. Sets err_ if
+  // that fails.
+  static void InitBrotli(ZCtx* ctx) {
+#if NODE_HAVE_BROTLI
+    if (ctx->mode_ == BROTLI_ENCODE) {
+      ctx->brotli_encoder_ =
+          BrotliEncoderCreateInstance(ZMemory::Allocate, ZMemory::Free,
+                                      &ctx->zlib_memory_);
+      if (ctx->brotli_encoder_ == nullptr ||
+          !BrotliEncoderSetParameter(ctx->brotli_encoder_,
+                                     BROTLI_PARAM_QUALITY, ctx->level_) ||
+          !BrotliEncoderSetParameter(ctx->brotli_encoder_,
+                                     BROTLI_PARAM_LGWIN, ctx->windowBits_)) {
+        ctx->err_ = Z_MEM_ERROR;
+      }
+    } else {
+      ctx->brotli_decoder_ =
+          BrotliDecoderCreateInstance(ZMemory::Allocate, ZMemory::Free,
+                                      &ctx->zlib_memory_);
+      if (ctx->brotli_decoder_ == nullptr)
+        ctx->err_ = Z_MEM_ERROR;
+    }
+#endif
+  }
+
+  static void EndBrotli(ZCtx* ctx) {
+#if NODE_HAVE_BROTLI
+    if (ctx->brotli_encoder_ != nullptr)
+      BrotliEncoderDestroyInstance(ctx->brotli_encoder_);
+    if (ctx->brotli_decoder_ != nullptr)
+      BrotliDecoderDestroyInstance(ctx->brotli_decoder_);
+    ctx->brotli_encoder_ = nullptr;
+    ctx->brotli_decoder_ = nullptr;
+#endif
+  }
+
   size_t self_size() const override { return sizeof(*this); }
 
  private:
+  // zlib allocates on the thread pool too, so the isolate hears about the
+  // memory from here rather than from the allocator.
+  void ReportMemory() {
+    const int64_t change_in_bytes = static_cast<int64_t>(zlib_memory_) -
+                                    static_cast<int64_t>(reported_memory_);
+    reported_memory_ = zlib_memory_;
+    if (change_in_bytes != 0)
+      env()->isolate()->AdjustAmountOfExternalAllocatedMemory(change_in_bytes);
+  }
+
   void Ref() {
     if (++refs_ == 1) {
       ClearWeak();
@@ -647,11 +1296,12 @@ class ZCtx : public AsyncWrap {
     }
   }
 
-  static const int kDeflateContextSize = 16384;  // approximate
-  static const int kInflateContextSize = 10240;  // approximate
+  static const size_t kMinOutputSize = 1024;
 
   Bytef* dictionary_;
   size_t dictionary_len_;
+  Persistent<Object> dictionary_object_;  // Set if dictionary_ is shared.
+  bool dictionary_loaded_;  // Set if strm_ was copied with the dictionary.
   int err_;
   int flush_;
   bool init_done_;
@@ -666,9 +1316,380 @@ class ZCtx : public AsyncWrap {
   bool pending_close_;
   unsigned int refs_;
   unsigned int gzip_id_bytes_read_;
+  Bytef* out_;  // Output of writeAll().
+  size_t out_size_;
+  bool out_too_large_;
+  size_t zlib_memory_;  // Allocated by zlib or Brotli through ZMemory.
+  size_t reported_memory_;
+  bool released_;  // Set by releaseMemory() until the next write.
+#if NODE_HAVE_BROTLI
+  BrotliEncoderState* brotli_encoder_;
+  BrotliDecoderState* brotli_decoder_;
+#endif
 };
 
 
+/**
+ * Compresses one block of a parallel gzip stream on the thread pool. The
+ * output is raw deflate, primed with the end of the previous block and
+ * flushed to a byte boundary unless it is the last block, so that the
+ * outputs of all blocks make up one deflate stream. The CRC-32 of the block
+ * is computed along with it, for the gzip trailer.
+ */
+class ZBlock : public AsyncWrap {
+ public:
+  ZBlock(Environment* env, Local<Object> wrap)
+      : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_ZLIB),
+        in_(nullptr),
+        in_len_(0),
+        dictionary_(nullptr),
+        dictionary_len_(0),
+        level_(0),
+        mem_level_(0),
+        strategy_(0),
+        last_(false),
+        err_(Z_OK),
+        msg_(nullptr),
+        out_(nullptr),
+        out_len_(0),
+        crc_(0),
+        in_progress_(false) {
+    MakeWeak<ZBlock>(this);
+  }
+
+  ~ZBlock() override {
+    CHECK_EQ(false, in_progress_ && "deflate in progress");
+    free(out_);
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    new ZBlock(env, args.This());
+  }
+
+  // deflate(in, dictionary, level, memLevel, strategy, last)
+  // The caller keeps |in| and |dictionary| alive until oncomplete(buffer, crc)
+  // or onerror(message, errno) is called.
+  static void Deflate(const FunctionCallbackInfo<Value>& args) {
+    CHECK_EQ(args.Length(), 6);
+
+    ZBlock* block;
+    ASSIGN_OR_RETURN_UNWRAP(&block, args.Holder());
+    CHECK_EQ(false, block->in_progress_ && "deflate already in progress");
+
+    CHECK(Buffer::HasInstance(args[0]));
+    block->in_ = reinterpret_cast<Bytef*>(Buffer::Data(args[0]));
+    block->in_len_ = Buffer::Length(args[0]);
+    if (Buffer::HasInstance(args[1])) {
+      block->dictionary_ = reinterpret_cast<Bytef*>(Buffer::Data(args[1]));
+      block->dictionary_len_ = Buffer::Length(args[1]);
+    } else {
+      block->dictionary_ = nullptr;
+      block->dictionary_len_ = 0;
+    }
+
+    block->level_ = args[2]->Int32Value();
+    CHECK((block->level_ >= -1 && block->level_ <= 9) &&
+          "invalid compression level");
+    block->mem_level_ = args[3]->Int32Value();
+    CHECK((block->mem_level_ >= 1 && block->mem_level_ <= 9) &&
+          "invalid memlevel");
+    block->strategy_ = args[4]->Int32Value();
+    CHECK((block->strategy_ >= Z_DEFAULT_STRATEGY &&
+           block->strategy_ <= Z_FIXED) && "invalid strategy");
+    block->last_ = args[5]->IsTrue();
+
+    block->in_progress_ = true;
+    block->ClearWeak();
+    threadpool::QueueWork(block->env()->event_loop(),
+                          &block->work_req_,
+                          threadpool::kCpuWork,
+                          threadpool::kLowPriority,
+                          ZBlock::Process,
+                          ZBlock::After,
+                          NODE_THREADPOOL_TRACE_ZLIB,
+                          "zlib.block");
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  // thread pool!
+  static void Process(uv_work_t* work_req) {
+    ZBlock* block = ContainerOf(&ZBlock::work_req_, work_req);
+    block->crc_ = crc32(0, block->in_, block->in_len_);
+
+    // The state only lives as long as the block, so its memory isn't
+    // reported, but it does come from the pool that streams use.
+    size_t memory = 0;
+    z_stream strm;
+    strm.zalloc = ZMemory::AllocateForZlib;
+    strm.zfree = ZMemory::Free;
+    strm.opaque = &memory;
+    block->err_ = deflateInit2(&strm, block->level_, Z_DEFLATED, -MAX_WBITS,
+                               block->mem_level_, block->strategy_);
+    if (block->err_ != Z_OK) {
+      block->msg_ = strm.msg;
+      return;
+    }
+    if (block->dictionary_ != nullptr) {
+      block->err_ = deflateSetDictionary(&strm, block->dictionary_,
+                                         block->dictionary_len_);
+    }
+
+    // The bound is for Z_FINISH, a sync flush adds a few bytes.
+    size_t out_size = deflateBound(&strm, block->in_len_) + 16;
+    const int flush = block->last_ ? Z_FINISH : Z_SYNC_FLUSH;
+    strm.next_in = block->in_;
+    strm.avail_in = block->in_len_;
+    strm.next_out = nullptr;
+    strm.avail_out = 0;
+    while (block->err_ == Z_OK && strm.avail_out == 0) {
+      Bytef* out = static_cast<Bytef*>(realloc(block->out_, out_size));
+      if (out == nullptr) {
+        block->err_ = Z_MEM_ERROR;
+        break;
+      }
+      block->out_ = out;
+      strm.next_out = out + block->out_len_;
+      strm.avail_out = out_size - block->out_len_;
+      block->err_ = deflate(&strm, flush);
+      block->out_len_ = out_size - strm.avail_out;
+      out_size *= 2;
+    }
+
+    if (block->err_ == Z_STREAM_END ||
+        (block->err_ == Z_BUF_ERROR && flush == Z_SYNC_FLUSH)) {
+      block->err_ = Z_OK;
+    } else if (block->err_ != Z_OK) {
+      block->msg_ = block->err_ == Z_MEM_ERROR ? nullptr : strm.msg;
+    } else if (flush == Z_FINISH) {
+      block->err_ = Z_BUF_ERROR;  // deflate() should have finished.
+    }
+    (void)deflateEnd(&strm);
+  }
+
+  // v8 land!
+  static void After(uv_work_t* work_req, int status) {
+    CHECK_EQ(status, 0);
+
+    ZBlock* block = ContainerOf(&ZBlock::work_req_, work_req);
+    Environment* env = block->env();
+
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    block->in_progress_ = false;
+    block->MakeWeak<ZBlock>(block);
+    block->in_ = nullptr;
+    block->dictionary_ = nullptr;
+
+    if (block->err_ != Z_OK) {
+      free(block->out_);
+      block->out_ = nullptr;
+      block->out_len_ = 0;
+      Local<Value> args[2] = {
+        OneByteString(env->isolate(),
+                      block->msg_ != nullptr ? block->msg_ : "Zlib error"),
+        Number::New(env->isolate(), block->err_)
+      };
+      block->MakeCallback(env->onerror_string(), arraysize(args), args);
+      return;
+    }
+
+    char* data = reinterpret_cast<char*>(block->out_);
+    const size_t len = block->out_len_;
+    block->out_ = nullptr;
+    block->out_len_ = 0;
+    Local<Value> args[2] = {
+      Buffer::New(env->isolate(), data, len).ToLocalChecked(),
+      Integer::NewFromUnsigned(env->isolate(),
+                               static_cast<uint32_t>(block->crc_))
+    };
+    block->MakeCallback(env->oncomplete_string(), arraysize(args), args);
+  }
+
+  Bytef* in_;
+  size_t in_len_;
+  Bytef* dictionary_;
+  size_t dictionary_len_;
+  int level_;
+  int mem_level_;
+  int strategy_;
+  bool last_;
+  int err_;
+  const char* msg_;
+  Bytef* out_;
+  size_t out_len_;
+  uLong crc_;
+  uv_work_t work_req_;
+  bool in_progress_;
+};
+
+
+// crc32Combine(crc1, crc2, len2)
+// The CRC-32 of two pieces of data put together, from the CRC-32 of each and
+// the length of the second.
+void Crc32Combine(const FunctionCallbackInfo<Value>& args) {
+  const uLong crc = crc32_combine(args[0]->Uint32Value(),
+                                  args[1]->Uint32Value(),
+                                  args[2]->Uint32Value());
+  args.GetReturnValue().Set(static_cast<uint32_t>(crc));
+}
+
+
+// CRC-32C, the Castagnoli polynomial that iSCSI, ext4 and others use. zlib
+// doesn't have it. It is computed with the crc32 instruction of SSE4.2 where
+// the CPU has one, and eight bytes at a time with tables otherwise.
+class Crc32c {
+ public:
+  static uint32_t Update(uint32_t crc, const uint8_t* data, size_t length) {
+    static const Impl impl = Select();
+    return ~impl(~crc, data, length);
+  }
+
+ private:
+  typedef uint32_t (*Impl)(uint32_t crc, const uint8_t* data, size_t length);
+
+  static const uint32_t kPolynomial = 0x82f63b78;  // Reversed.
+
+  static Impl Select() {
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+      return Sse42;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 1);
+    if (info[2] & (1 << 20))
+      return Sse42;
+#endif
+    return Tables;
+  }
+
+  // |crc| is inverted in the Impl functions.
+  static uint32_t Tables(uint32_t crc, const uint8_t* data, size_t length) {
+    static const std::vector<uint32_t> tables = MakeTables();
+    const uint32_t* t = tables.data();
+    while (length > 0 && (reinterpret_cast<uintptr_t>(data) & 7) != 0) {
+      crc = t[(crc ^ *data++) & 0xff] ^ (crc >> 8);
+      length--;
+    }
+    while (length >= 8) {
+      const uint32_t lo = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) |
+                                 (static_cast<uint32_t>(data[3]) << 24));
+      const uint32_t hi = data[4] | (data[5] << 8) | (data[6] << 16) |
+                          (static_cast<uint32_t>(data[7]) << 24);
+      crc = t[7 * 256 + (lo & 0xff)] ^ t[6 * 256 + ((lo >> 8) & 0xff)] ^
+            t[5 * 256 + ((lo >> 16) & 0xff)] ^ t[4 * 256 + (lo >> 24)] ^
+            t[3 * 256 + (hi & 0xff)] ^ t[2 * 256 + ((hi >> 8) & 0xff)] ^
+            t[1 * 256 + ((hi >> 16) & 0xff)] ^ t[hi >> 24];
+      data += 8;
+      length -= 8;
+    }
+    while (length-- > 0)
+      crc = t[(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    return crc;
+  }
+
+  // Table k holds the CRC of a byte followed by k zero bytes.
+  static std::vector<uint32_t> MakeTables() {
+    std::vector<uint32_t> tables(8 * 256);
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++)
+        crc = (crc >> 1) ^ (kPolynomial & (0 - (crc & 1)));
+      tables[i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+      for (int k = 1; k < 8; k++) {
+        const uint32_t prev = tables[(k - 1) * 256 + i];
+        tables[k * 256 + i] = tables[prev & 0xff] ^ (prev >> 8);
+      }
+    }
+    return tables;
+  }
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+  __attribute__((target("sse4.2")))
+#endif
+#if defined(__x86_64__) || defined(__i386__) || \
+    defined(_M_X64) || defined(_M_IX86)
+  static uint32_t Sse42(uint32_t crc, const uint8_t* data, size_t length) {
+    while (length > 0 && (reinterpret_cast<uintptr_t>(data) & 7) != 0) {
+      crc = _mm_crc32_u8(crc, *data++);
+      length--;
+    }
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t crc64 = crc;
+    for (; length >= 8; data += 8, length -= 8) {
+      uint64_t word;
+      memcpy(&word, data, sizeof(word));
+      crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    for (; length >= 4; data += 4, length -= 4) {
+      uint32_t word;
+      memcpy(&word, data, sizeof(word));
+      crc = _mm_crc32_u32(crc, word);
+    }
+    while (length-- > 0)
+      crc = _mm_crc32_u8(crc, *data++);
+    return crc;
+  }
+#endif
+};
+
+
+// zlib takes the lengths as uInt.
+uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t length) {
+  while (length > 0) {
+    const uInt chunk = static_cast<uInt>(std::min<size_t>(length, 1 << 30));
+    crc = crc32(crc, data, chunk);
+    data += chunk;
+    length -= chunk;
+  }
+  return crc;
+}
+
+
+uint32_t Adler32(uint32_t adler, const uint8_t* data, size_t length) {
+  while (length > 0) {
+    const uInt chunk = static_cast<uInt>(std::min<size_t>(length, 1 << 30));
+    adler = adler32(adler, data, chunk);
+    data += chunk;
+    length -= chunk;
+  }
+  return adler;
+}
+
+
+// crc32(data, value), crc32c(data, value) and adler32(data, value) continue
+// the checksum |value| of what came before with |data|, which is an
+// ArrayBufferView or a string that is checksummed as UTF-8.
+template <uint32_t (*Update)(uint32_t, const uint8_t*, size_t)>
+void Checksum(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[1]->IsUint32());
+  const uint32_t value = args[1].As<v8::Uint32>()->Value();
+  uint32_t result;
+  if (args[0]->IsString()) {
+    node::Utf8Value data(args.GetIsolate(), args[0]);
+    result = Update(value,
+                    reinterpret_cast<const uint8_t*>(*data),
+                    data.length());
+  } else {
+    CHECK(args[0]->IsArrayBufferView());
+    result = Update(value,
+                    reinterpret_cast<const uint8_t*>(Buffer::Data(args[0])),
+                    Buffer::Length(args[0]));
+  }
+  args.GetReturnValue().Set(result);
+}
+
+
 void InitZlib(Local<Object> target,
               Local<Value> unused,
               Local<Context> context,
@@ -680,14 +1701,37 @@ void InitZlib(Local<Object> target,
 
   env->SetProtoMethod(z, "write", ZCtx::Write<true>);
   env->SetProtoMethod(z, "writeSync", ZCtx::Write<false>);
+  env->SetProtoMethod(z, "writeAll", ZCtx::WriteAll<true>);
+  env->SetProtoMethod(z, "writeAllSync", ZCtx::WriteAll<false>);
   env->SetProtoMethod(z, "init", ZCtx::Init);
+  env->SetProtoMethod(z, "initBrotli", ZCtx::InitBrotli);
   env->SetProtoMethod(z, "close", ZCtx::Close);
   env->SetProtoMethod(z, "params", ZCtx::Params);
   env->SetProtoMethod(z, "reset", ZCtx::Reset);
+  env->SetProtoMethod(z, "releaseMemory", ZCtx::ReleaseMemory);
 
   z->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "Zlib"));
   target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "Zlib"), z->GetFunction());
 
+  Local<FunctionTemplate> d = env->NewFunctionTemplate(ZDictionary::New);
+  d->InstanceTemplate()->SetInternalFieldCount(1);
+  d->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "Dictionary"));
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "Dictionary"),
+              d->GetFunction());
+  env->set_zlib_dictionary_constructor_template(d);
+
+  Local<FunctionTemplate> b = env->NewFunctionTemplate(ZBlock::New);
+  b->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(b, "deflate", ZBlock::Deflate);
+  b->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "ZlibBlock"));
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "ZlibBlock"),
+              b->GetFunction());
+
+  env->SetMethod(target, "crc32Combine", Crc32Combine);
+  env->SetMethod(target, "crc32", Checksum<Crc32>);
+  env->SetMethod(target, "crc32c", Checksum<Crc32c::Update>);
+  env->SetMethod(target, "adler32", Checksum<Adler32>);
+
   target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "ZLIB_VERSION"),
               FIXED_ONE_BYTE_STRING(env->isolate(), ZLIB_VERSION));
 }
@@ -82,6 +82,7 @@ void PipeWrap::Initialize(Local<Object> target,
 
   env->SetProtoMethod(t, "bind", Bind);
   env->SetProtoMethod(t, "listen", Listen);
+  env->SetProtoMethod(t, "setAcceptBatch", SetAcceptBatch);
   env->SetProtoMethod(t, "connect", Connect);
   env->SetProtoMethod(t, "open", Open);
 
@@ -22,6 +22,7 @@
 #include "env.h"
 #include "env-inl.h"
 #include "handle_wrap.h"
+#include "node_vfork.h"
 #include "node_wrap.h"
 #include "util.h"
 #include "util-inl.h"
@@ -84,7 +85,8 @@ class ProcessWrap : public HandleWrap {
       : HandleWrap(env,
                    object,
                    reinterpret_cast<uv_handle_t*>(&process_),
-                   AsyncWrap::PROVIDER_PROCESSWRAP) {
+                   AsyncWrap::PROVIDER_PROCESSWRAP),
+        vfork_(false) {
   }
 
   static void ParseStdioOptions(Environment* env,
@@ -221,12 +223,26 @@ class ProcessWrap : public HandleWrap {
       options.flags |= UV_PROCESS_DETACHED;
     }
 
-    int err = uv_spawn(env->event_loop(), &wrap->process_, &options);
+    // options.vfork
+    wrap->vfork_ = js_options->Get(env->vfork_string())->IsTrue() &&
+                   VforkProcess::CanSpawn(&options);
+
+    int err;
+    int pid;
+    if (wrap->vfork_) {
+      err = wrap->vfork_process_.Spawn(env->event_loop(),
+                                       &options,
+                                       OnVforkExit);
+      pid = wrap->vfork_process_.pid();
+    } else {
+      err = uv_spawn(env->event_loop(), &wrap->process_, &options);
+      pid = wrap->process_.pid;
+    }
 
     if (err == 0) {
       CHECK_EQ(wrap->process_.data, wrap);
       wrap->object()->Set(env->pid_string(),
-                          Integer::New(env->isolate(), wrap->process_.pid));
+                          Integer::New(env->isolate(), pid));
     }
 
     if (options.args) {
@@ -248,7 +264,8 @@ class ProcessWrap : public HandleWrap {
     ProcessWrap* wrap;
     ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
     int signal = args[0]->Int32Value();
-    int err = uv_process_kill(&wrap->process_, signal);
+    int err = wrap->vfork_ ? wrap->vfork_process_.Kill(signal) :
+                             uv_process_kill(&wrap->process_, signal);
     args.GetReturnValue().Set(err);
   }
 
@@ -258,8 +275,20 @@ class ProcessWrap : public HandleWrap {
     ProcessWrap* wrap = static_cast<ProcessWrap*>(handle->data);
     CHECK_NE(wrap, nullptr);
     CHECK_EQ(&wrap->process_, handle);
+    wrap->EmitExit(exit_status, term_signal);
+  }
+
+  static void OnVforkExit(VforkProcess* process,
+                          int64_t exit_status,
+                          int term_signal) {
+    ProcessWrap* wrap = static_cast<ProcessWrap*>(process->handle()->data);
+    CHECK_NE(wrap, nullptr);
+    CHECK_EQ(&wrap->vfork_process_, process);
+    wrap->EmitExit(exit_status, term_signal);
+  }
 
-    Environment* env = wrap->env();
+  void EmitExit(int64_t exit_status, int term_signal) {
+    Environment* env = this->env();
     HandleScope handle_scope(env->isolate());
     Context::Scope context_scope(env->context());
 
@@ -268,10 +297,15 @@ class ProcessWrap : public HandleWrap {
       OneByteString(env->isolate(), signo_string(term_signal))
     };
 
-    wrap->MakeCallback(env->onexit_string(), arraysize(argv), argv);
+    MakeCallback(env->onexit_string(), arraysize(argv), argv);
   }
 
-  uv_process_t process_;
+  // The handle is one or the other, depending on |vfork_|.
+  union {
+    uv_process_t process_;
+    VforkProcess vfork_process_;
+  };
+  bool vfork_;
 };
 
 
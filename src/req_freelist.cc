@@ -0,0 +1,66 @@
+#include "req_freelist.h"
+
+namespace node {
+
+const size_t ReqFreeList::kGranularity;
+const size_t ReqFreeList::kMaxSize;
+const size_t ReqFreeList::kMaxFreeBlocks;
+
+
+ReqFreeList::ReqFreeList() {
+  for (size_t i = 0; i < kSizeClasses; i++) {
+    free_[i] = nullptr;
+    free_count_[i] = 0;
+  }
+}
+
+
+ReqFreeList::~ReqFreeList() {
+  for (Block* block : free_) {
+    while (block != nullptr) {
+      Block* next = block->next;
+      delete[] reinterpret_cast<char*>(block);
+      block = next;
+    }
+  }
+}
+
+
+char* ReqFreeList::Allocate(size_t size) {
+  if (size == 0 || size > kMaxSize)
+    return new char[size];
+  const size_t size_class = (size - 1) / kGranularity;
+  Block* block = free_[size_class];
+  if (block == nullptr)
+    return new char[(size_class + 1) * kGranularity];
+  free_[size_class] = block->next;
+  free_count_[size_class]--;
+  return reinterpret_cast<char*>(block);
+}
+
+
+void ReqFreeList::Free(char* data, size_t size) {
+  if (size == 0 || size > kMaxSize) {
+    delete[] data;
+    return;
+  }
+  const size_t size_class = (size - 1) / kGranularity;
+  if (free_count_[size_class] == kMaxFreeBlocks) {
+    delete[] data;
+    return;
+  }
+  Block* block = reinterpret_cast<Block*>(data);
+  block->next = free_[size_class];
+  free_[size_class] = block;
+  free_count_[size_class]++;
+}
+
+
+size_t ReqFreeList::free_blocks() const {
+  size_t count = 0;
+  for (size_t n : free_count_)
+    count += n;
+  return count;
+}
+
+}  // namespace node
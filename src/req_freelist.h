@@ -0,0 +1,53 @@
+#ifndef SRC_REQ_FREELIST_H_
+#define SRC_REQ_FREELIST_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "util.h"
+
+#include <stddef.h>
+
+namespace node {
+
+// Keeps the storage of finished requests for the next ones, so that the
+// WriteWrap and FSReqWrap objects of busy streams and file system calls don't
+// go through operator new[] and delete[] each time. Blocks are kept by size
+// class, the multiples of kGranularity up to kMaxSize, and at most
+// kMaxFreeBlocks of each size class are kept.
+//
+// Only used on the thread of the Environment that owns it.
+class ReqFreeList {
+ public:
+  static const size_t kGranularity = 64;
+  static const size_t kMaxSize = 1024;
+  static const size_t kMaxFreeBlocks = 64;
+
+  ReqFreeList();
+  ~ReqFreeList();
+
+  // Returns uninitialized storage of at least |size| bytes, which has to be
+  // given back to Free() along with the same |size|.
+  char* Allocate(size_t size);
+  void Free(char* data, size_t size);
+
+  // Blocks kept for reuse.
+  size_t free_blocks() const;
+
+ private:
+  static const size_t kSizeClasses = kMaxSize / kGranularity;
+
+  struct Block {
+    Block* next;
+  };
+
+  Block* free_[kSizeClasses];
+  size_t free_count_[kSizeClasses];
+
+  DISALLOW_COPY_AND_ASSIGN(ReqFreeList);
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_REQ_FREELIST_H_
@@ -0,0 +1,103 @@
+#include "slab_allocator.h"
+
+#include "env.h"
+#include "env-inl.h"
+#include "node_buffer.h"
+#include "util.h"
+#include "util-inl.h"
+#include "v8.h"
+
+namespace node {
+
+using v8::ArrayBuffer;
+using v8::ArrayBufferCreationMode;
+using v8::EscapableHandleScope;
+using v8::HandleScope;
+using v8::Local;
+using v8::Maybe;
+using v8::MaybeLocal;
+using v8::Object;
+using v8::Uint8Array;
+
+
+SlabAllocator::SlabAllocator(Environment* env, size_t slab_size)
+    : env_(env),
+      slab_size_(slab_size),
+      slab_data_(nullptr),
+      offset_(0) {
+}
+
+
+SlabAllocator::~SlabAllocator() {
+  slab_.Reset();
+}
+
+
+char* SlabAllocator::Allocate(size_t size) {
+  // Reads that would not leave room for anything else get their own slab so
+  // they do not waste the tail of the current one.
+  if (size > slab_size_ / 2)
+    return node::Malloc(size);
+
+  if (slab_data_ == nullptr || slab_size_ - offset_ < size) {
+    HandleScope handle_scope(env_->isolate());
+    char* data = node::Malloc(slab_size_);
+    Local<ArrayBuffer> ab =
+        ArrayBuffer::New(env_->isolate(),
+                         data,
+                         slab_size_,
+                         ArrayBufferCreationMode::kInternalized);
+    slab_.Reset(env_->isolate(), ab);
+    slab_data_ = data;
+    offset_ = 0;
+  }
+
+  char* base = slab_data_ + offset_;
+  offset_ += size;
+  return base;
+}
+
+
+MaybeLocal<Object> SlabAllocator::Shrink(char* base, size_t length) {
+  EscapableHandleScope scope(env_->isolate());
+
+  if (!Owns(base)) {
+    Local<Object> obj;
+    if (Buffer::New(env_, node::Realloc(base, length), length).ToLocal(&obj))
+      return scope.Escape(obj);
+    return MaybeLocal<Object>();
+  }
+
+  const size_t start = base - slab_data_;
+  CHECK_LE(start + length, offset_);
+  offset_ = start + length;
+
+  Local<ArrayBuffer> ab = PersistentToLocal(env_->isolate(), slab_);
+  Local<Uint8Array> ui = Uint8Array::New(ab, start, length);
+  Maybe<bool> mb =
+      ui->SetPrototype(env_->context(), env_->buffer_prototype_object());
+  if (mb.FromMaybe(false))
+    return scope.Escape(ui);
+  return MaybeLocal<Object>();
+}
+
+
+void SlabAllocator::Release(char* base) {
+  if (!Owns(base)) {
+    free(base);
+    return;
+  }
+
+  const size_t start = base - slab_data_;
+  CHECK_LE(start, offset_);
+  offset_ = start;
+}
+
+
+bool SlabAllocator::Owns(const char* base) const {
+  return slab_data_ != nullptr &&
+         base >= slab_data_ &&
+         base < slab_data_ + slab_size_;
+}
+
+}  // namespace node
@@ -0,0 +1,50 @@
+#ifndef SRC_SLAB_ALLOCATOR_H_
+#define SRC_SLAB_ALLOCATOR_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "v8.h"
+
+namespace node {
+
+class Environment;
+
+// Carves stream read buffers out of large shared slabs. Every Buffer handed
+// out by Shrink() is a view onto the slab's ArrayBuffer, so the slab stays
+// alive until the last slice that references it has been garbage collected.
+//
+// Allocations are reserved and shrunk one at a time, which matches the way
+// libuv calls the alloc and read callbacks back to back on the loop thread.
+class SlabAllocator {
+ public:
+  static const size_t kDefaultSlabSize = 1024 * 1024;
+
+  explicit SlabAllocator(Environment* env,
+                         size_t slab_size = kDefaultSlabSize);
+  ~SlabAllocator();
+
+  // Reserves |size| bytes, starting a new slab if the current one is short.
+  char* Allocate(size_t size);
+
+  // Gives the unused tail of the last allocation back to the slab and wraps
+  // the |length| bytes that were used in a Buffer that references the slab.
+  v8::MaybeLocal<v8::Object> Shrink(char* base, size_t length);
+
+  // Gives the whole of the last allocation back to the slab.
+  void Release(char* base);
+
+ private:
+  bool Owns(const char* base) const;
+
+  Environment* const env_;
+  const size_t slab_size_;
+  v8::Persistent<v8::ArrayBuffer> slab_;
+  char* slab_data_;
+  size_t offset_;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_SLAB_ALLOCATOR_H_
@@ -46,50 +46,67 @@ using v8::Value;
 
 
 SyncProcessOutputBuffer::SyncProcessOutputBuffer()
-    : used_(0),
-      next_(nullptr) {
+    : data_(nullptr),
+      size_(0),
+      used_(0) {
 }
 
 
-void SyncProcessOutputBuffer::OnAlloc(size_t suggested_size,
-                                      uv_buf_t* buf) const {
-  if (used() == kBufferSize)
-    *buf = uv_buf_init(nullptr, 0);
-  else
-    *buf = uv_buf_init(data_ + used(), available());
+SyncProcessOutputBuffer::~SyncProcessOutputBuffer() {
+  free(data_);
 }
 
 
-void SyncProcessOutputBuffer::OnRead(const uv_buf_t* buf, size_t nread) {
-  // If we hand out the same chunk twice, this should catch it.
-  CHECK_EQ(buf->base, data_ + used());
-  used_ += static_cast<unsigned int>(nread);
-}
-
+void SyncProcessOutputBuffer::OnAlloc(size_t suggested_size, uv_buf_t* buf) {
+  if (available() == 0) {
+    // Doubling the size keeps the number of reallocations, and the bytes
+    // they move, proportional to the size of the output.
+    const size_t size = size_ == 0 ? kInitialSize : 2 * size_;
+    char* data = node::UncheckedRealloc(data_, size);
+    if (data == nullptr) {
+      *buf = uv_buf_init(nullptr, 0);
+      return;
+    }
+    data_ = data;
+    size_ = size;
+  }
 
-size_t SyncProcessOutputBuffer::Copy(char* dest) const {
-  memcpy(dest, data_, used());
-  return used();
+  // Use unsigned int because that's what `uv_buf_init` takes.
+  const size_t max_length = static_cast<unsigned int>(-1);
+  const size_t length = available() < max_length ? available() : max_length;
+  *buf = uv_buf_init(data_ + used(), static_cast<unsigned int>(length));
 }
 
 
-unsigned int SyncProcessOutputBuffer::available() const {
-  return sizeof data_ - used();
+void SyncProcessOutputBuffer::OnRead(const uv_buf_t* buf, size_t nread) {
+  // If we hand out the same chunk twice, this should catch it.
+  CHECK_EQ(buf->base, data_ + used());
+  used_ += nread;
 }
 
 
-unsigned int SyncProcessOutputBuffer::used() const {
-  return used_;
+char* SyncProcessOutputBuffer::Release() {
+  char* data = data_;
+  if (used() < size_) {
+    // Give back what was not used, realloc() rarely moves when shrinking.
+    char* shrunk = node::UncheckedRealloc(data, used());
+    if (shrunk != nullptr || used() == 0)
+      data = shrunk;
+  }
+  data_ = nullptr;
+  size_ = 0;
+  used_ = 0;
+  return data;
 }
 
 
-SyncProcessOutputBuffer* SyncProcessOutputBuffer::next() const {
-  return next_;
+size_t SyncProcessOutputBuffer::available() const {
+  return size_ - used();
 }
 
 
-void SyncProcessOutputBuffer::set_next(SyncProcessOutputBuffer* next) {
-  next_ = next;
+size_t SyncProcessOutputBuffer::used() const {
+  return used_;
 }
 
 
@@ -102,9 +119,6 @@ SyncProcessStdioPipe::SyncProcessStdioPipe(SyncProcessRunner* process_handler,
       writable_(writable),
       input_buffer_(input_buffer),
 
-      first_output_buffer_(nullptr),
-      last_output_buffer_(nullptr),
-
       uv_pipe_(),
       write_req_(),
       shutdown_req_(),
@@ -116,14 +130,6 @@ SyncProcessStdioPipe::SyncProcessStdioPipe(SyncProcessRunner* process_handler,
 
 SyncProcessStdioPipe::~SyncProcessStdioPipe() {
   CHECK(lifecycle_ == kUninitialized || lifecycle_ == kClosed);
-
-  SyncProcessOutputBuffer* buf;
-  SyncProcessOutputBuffer* next;
-
-  for (buf = first_output_buffer_; buf != nullptr; buf = next) {
-    next = buf->next();
-    delete buf;
-  }
 }
 
 
@@ -185,11 +191,10 @@ void SyncProcessStdioPipe::Close() {
 }
 
 
-Local<Object> SyncProcessStdioPipe::GetOutputAsBuffer(Environment* env) const {
-  size_t length = OutputLength();
-  Local<Object> js_buffer = Buffer::New(env, length).ToLocalChecked();
-  CopyOutput(Buffer::Data(js_buffer));
-  return js_buffer;
+Local<Object> SyncProcessStdioPipe::GetOutputAsBuffer(Environment* env) {
+  size_t length = output_buffer_.used();
+  char* data = output_buffer_.Release();
+  return Buffer::New(env, data, length).ToLocalChecked();
 }
 
 
@@ -232,45 +237,12 @@ uv_handle_t* SyncProcessStdioPipe::uv_handle() const {
 }
 
 
-size_t SyncProcessStdioPipe::OutputLength() const {
-  SyncProcessOutputBuffer* buf;
-  size_t size = 0;
-
-  for (buf = first_output_buffer_; buf != nullptr; buf = buf->next())
-    size += buf->used();
-
-  return size;
-}
-
-
-void SyncProcessStdioPipe::CopyOutput(char* dest) const {
-  SyncProcessOutputBuffer* buf;
-  size_t offset = 0;
-
-  for (buf = first_output_buffer_; buf != nullptr; buf = buf->next())
-    offset += buf->Copy(dest + offset);
-}
-
-
 void SyncProcessStdioPipe::OnAlloc(size_t suggested_size, uv_buf_t* buf) {
   // This function assumes that libuv will never allocate two buffers for the
   // same stream at the same time. There's an assert in
   // SyncProcessOutputBuffer::OnRead that would fail if this assumption was
   // ever violated.
-
-  if (last_output_buffer_ == nullptr) {
-    // Allocate the first capture buffer.
-    first_output_buffer_ = new SyncProcessOutputBuffer();
-    last_output_buffer_ = first_output_buffer_;
-
-  } else if (last_output_buffer_->available() == 0) {
-    // The current capture buffer is full so get us a new one.
-    SyncProcessOutputBuffer* buf = new SyncProcessOutputBuffer();
-    last_output_buffer_->set_next(buf);
-    last_output_buffer_ = buf;
-  }
-
-  last_output_buffer_->OnAlloc(suggested_size, buf);
+  output_buffer_.OnAlloc(suggested_size, buf);
 }
 
 
@@ -284,7 +256,7 @@ void SyncProcessStdioPipe::OnRead(const uv_buf_t* buf, ssize_t nread) {
     uv_read_stop(uv_stream());
 
   } else {
-    last_output_buffer_->OnRead(buf, nread);
+    output_buffer_.OnRead(buf, nread);
     process_handler_->IncrementBufferSizeAndCheckOverflow(nread);
   }
 }
@@ -396,6 +368,7 @@ SyncProcessRunner::SyncProcessRunner(Environment* env)
       cwd_buffer_(nullptr),
 
       uv_process_(),
+      vfork_(false),
       killed_(false),
 
       buffered_output_size_(0),
@@ -489,7 +462,13 @@ void SyncProcessRunner::TryInitializeAndRunLoop(Local<Value> options) {
   }
 
   uv_process_options_.exit_cb = ExitCallback;
-  r = uv_spawn(uv_loop_, &uv_process_, &uv_process_options_);
+  if (vfork_) {
+    r = vfork_process_.Spawn(uv_loop_,
+                             &uv_process_options_,
+                             VforkExitCallback);
+  } else {
+    r = uv_spawn(uv_loop_, &uv_process_, &uv_process_options_);
+  }
   if (r < 0)
     return SetError(r);
   uv_process_.data = this;
@@ -526,7 +505,8 @@ void SyncProcessRunner::CloseHandlesAndDeleteLoop() {
     // Close the process handle if it is still open. The handle type also
     // needs to be checked because TryInitializeAndRunLoop() won't spawn a
     // process if input validation fails.
-    if (uv_process_handle->type == UV_PROCESS &&
+    const uv_handle_type type = vfork_ ? UV_SIGNAL : UV_PROCESS;
+    if (uv_process_handle->type == type &&
         !uv_is_closing(uv_process_handle))
       uv_close(uv_process_handle, nullptr);
 
@@ -583,6 +563,13 @@ void SyncProcessRunner::CloseKillTimer() {
 }
 
 
+int SyncProcessRunner::KillProcess(int signum) {
+  if (vfork_)
+    return vfork_process_.Kill(signum);
+  return uv_process_kill(&uv_process_, signum);
+}
+
+
 void SyncProcessRunner::Kill() {
   // Only attempt to kill once.
   if (killed_)
@@ -595,7 +582,7 @@ void SyncProcessRunner::Kill() {
   // a signal to the process, however we will still close our end of the stdio
   // pipes so this situation won't make us hang.
   if (exit_status_ < 0) {
-    int r = uv_process_kill(&uv_process_, kill_signal_);
+    int r = KillProcess(kill_signal_);
 
     // If uv_kill failed with an error that isn't ESRCH, the user probably
     // specified an invalid or unsupported signal. Signal this to the user as
@@ -603,7 +590,7 @@ void SyncProcessRunner::Kill() {
     if (r < 0 && r != UV_ESRCH) {
       SetError(r);
 
-      r = uv_process_kill(&uv_process_, SIGKILL);
+      r = KillProcess(SIGKILL);
       CHECK(r >= 0 || r == UV_ESRCH);
     }
   }
@@ -695,7 +682,8 @@ Local<Object> SyncProcessRunner::BuildResultObject() {
     js_result->Set(env()->output_string(), Null(env()->isolate()));
 
   js_result->Set(env()->pid_string(),
-                 Number::New(env()->isolate(), uv_process_.pid));
+                 Number::New(env()->isolate(),
+                             vfork_ ? vfork_process_.pid() : uv_process_.pid));
 
   return scope.Escape(js_result);
 }
@@ -777,6 +765,9 @@ int SyncProcessRunner::ParseOptions(Local<Value> js_value) {
   if (js_options->Get(env()->detached_string())->BooleanValue())
     uv_process_options_.flags |= UV_PROCESS_DETACHED;
 
+  if (js_options->Get(env()->vfork_string())->BooleanValue())
+    vfork_ = VforkProcess::CanSpawn(&uv_process_options_);
+
   Local<String> wba = env()->windows_verbatim_arguments_string();
 
   if (js_options->Get(wba)->BooleanValue())
@@ -1030,6 +1021,16 @@ void SyncProcessRunner::ExitCallback(uv_process_t* handle,
 }
 
 
+void SyncProcessRunner::VforkExitCallback(VforkProcess* process,
+                                          int64_t exit_status,
+                                          int term_signal) {
+  SyncProcessRunner* self =
+      reinterpret_cast<SyncProcessRunner*>(process->handle()->data);
+  uv_close(process->handle(), nullptr);
+  self->OnExit(exit_status, term_signal);
+}
+
+
 void SyncProcessRunner::KillTimerCallback(uv_timer_t* handle) {
   SyncProcessRunner* self = reinterpret_cast<SyncProcessRunner*>(handle->data);
   self->OnKillTimerTimeout();
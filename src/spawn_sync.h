@@ -26,6 +26,7 @@
 
 #include "node.h"
 #include "node_buffer.h"
+#include "node_vfork.h"
 
 namespace node {
 
@@ -48,29 +49,28 @@ class SyncProcessStdioPipe;
 class SyncProcessRunner;
 
 
+// Collects the output of a pipe in one block of memory that doubles in size
+// when it is full, so that it can become a Buffer without being copied.
 class SyncProcessOutputBuffer {
-  static const unsigned int kBufferSize = 65536;
+  static const size_t kInitialSize = 65536;
 
  public:
   inline SyncProcessOutputBuffer();
+  inline ~SyncProcessOutputBuffer();
 
-  inline void OnAlloc(size_t suggested_size, uv_buf_t* buf) const;
+  inline void OnAlloc(size_t suggested_size, uv_buf_t* buf);
   inline void OnRead(const uv_buf_t* buf, size_t nread);
 
-  inline size_t Copy(char* dest) const;
-
-  inline unsigned int available() const;
-  inline unsigned int used() const;
+  // Hands the memory over to the caller, who has to free() it.
+  inline char* Release();
 
-  inline SyncProcessOutputBuffer* next() const;
-  inline void set_next(SyncProcessOutputBuffer* next);
+  inline size_t available() const;
+  inline size_t used() const;
 
  private:
-  // Use unsigned int because that's what `uv_buf_init` takes.
-  mutable char data_[kBufferSize];
-  unsigned int used_;
-
-  SyncProcessOutputBuffer* next_;
+  char* data_;
+  size_t size_;
+  size_t used_;
 };
 
 
@@ -94,7 +94,7 @@ class SyncProcessStdioPipe {
   int Start();
   void Close();
 
-  Local<Object> GetOutputAsBuffer(Environment* env) const;
+  Local<Object> GetOutputAsBuffer(Environment* env);
 
   inline bool readable() const;
   inline bool writable() const;
@@ -105,9 +105,6 @@ class SyncProcessStdioPipe {
   inline uv_handle_t* uv_handle() const;
 
  private:
-  inline size_t OutputLength() const;
-  inline void CopyOutput(char* dest) const;
-
   inline void OnAlloc(size_t suggested_size, uv_buf_t* buf);
   inline void OnRead(const uv_buf_t* buf, ssize_t nread);
   inline void OnWriteDone(int result);
@@ -132,8 +129,7 @@ class SyncProcessStdioPipe {
   bool writable_;
   uv_buf_t input_buffer_;
 
-  SyncProcessOutputBuffer* first_output_buffer_;
-  SyncProcessOutputBuffer* last_output_buffer_;
+  SyncProcessOutputBuffer output_buffer_;
 
   mutable uv_pipe_t uv_pipe_;
   uv_write_t write_req_;
@@ -172,6 +168,7 @@ class SyncProcessRunner {
   void CloseKillTimer();
 
   void Kill();
+  int KillProcess(int signum);
   void IncrementBufferSizeAndCheckOverflow(ssize_t length);
 
   void OnExit(int64_t exit_status, int term_signal);
@@ -202,6 +199,9 @@ class SyncProcessRunner {
   static void ExitCallback(uv_process_t* handle,
                            int64_t exit_status,
                            int term_signal);
+  static void VforkExitCallback(VforkProcess* process,
+                                int64_t exit_status,
+                                int term_signal);
   static void KillTimerCallback(uv_timer_t* handle);
   static void KillTimerCloseCallback(uv_handle_t* handle);
 
@@ -222,7 +222,12 @@ class SyncProcessRunner {
   char* env_buffer_;
   const char* cwd_buffer_;
 
-  uv_process_t uv_process_;
+  // The handle is one or the other, depending on |vfork_|.
+  union {
+    uv_process_t uv_process_;
+    VforkProcess vfork_process_;
+  };
+  bool vfork_;
   bool killed_;
 
   size_t buffered_output_size_;
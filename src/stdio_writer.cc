@@ -0,0 +1,343 @@
+#include "base-object.h"
+#include "base-object-inl.h"
+#include "env.h"
+#include "env-inl.h"
+#include "node_buffer.h"
+#include "node_mutex.h"
+#include "util.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#ifdef __POSIX__
+#include <poll.h>
+#endif
+
+namespace node {
+
+using v8::Context;
+using v8::Float64Array;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::Int32;
+using v8::Local;
+using v8::Object;
+using v8::Uint32;
+using v8::Value;
+
+namespace {
+
+// Writes stdout or stderr from a thread of its own, so that a slow terminal
+// or a stalled pipe holds up that thread rather than the event loop. The
+// writes are copied into a ring buffer of |capacity| bytes, and what happens
+// when it is full is up to the policy: the write is dropped, the event loop
+// waits until there is room, or the buffer grows.
+//
+// flush() waits until the buffer has been written out, which lib/internal/
+// process/stdio.js does when the process exits.
+class StdioWriter : public BaseObject {
+ public:
+  enum Policy {
+    kDrop,
+    kBlock,
+    kGrow
+  };
+
+  // Filled in by getStats(), see the JS side.
+  enum Fields {
+    kBytesWritten,
+    kBytesDropped,
+    kBytesBuffered,
+    kMaxBytesBuffered,
+    kCapacity,
+    // The time that write() waited for room, in milliseconds.
+    kBlockedTime,
+    kFieldsCount
+  };
+
+  static void Initialize(Local<Object> target,
+                         Local<Value> unused,
+                         Local<Context> context);
+
+  ~StdioWriter() override;
+
+ private:
+  // The most that the thread writes at once.
+  static const size_t kChunkSize = 64 * 1024;
+
+  StdioWriter(Environment* env,
+              Local<Object> object,
+              int fd,
+              size_t capacity,
+              Policy policy);
+
+  static void New(const FunctionCallbackInfo<Value>& args);
+  static void Write(const FunctionCallbackInfo<Value>& args);
+  static void Flush(const FunctionCallbackInfo<Value>& args);
+  static void GetStats(const FunctionCallbackInfo<Value>& args);
+
+  bool Append(const char* data, size_t length);
+  // Copies |length| bytes to the end of the ring, which has room for them.
+  void CopyIn(const char* data, size_t length);
+  void Grow(size_t capacity);
+
+  static void ThreadMain(void* arg);
+  int WriteOut(const char* data, size_t length);
+
+  const int fd_;
+  const Policy policy_;
+  uv_thread_t thread_;
+  Mutex mutex_;
+  // Signalled when there is data for the thread, and when it has made room.
+  ConditionVariable data_cond_;
+  ConditionVariable room_cond_;
+  std::vector<char> ring_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+  // The chunk the thread is writing, which is not counted in |size_|.
+  size_t writing_ = 0;
+  // The error that writing failed with, after which everything is dropped.
+  int error_ = 0;
+  bool stopping_ = false;
+  double fields_[kFieldsCount] = {};
+};
+
+
+StdioWriter::StdioWriter(Environment* env,
+                         Local<Object> object,
+                         int fd,
+                         size_t capacity,
+                         Policy policy)
+    : BaseObject(env, object),
+      fd_(fd),
+      policy_(policy),
+      ring_(capacity) {
+  MakeWeak<StdioWriter>(this);
+  fields_[kCapacity] = capacity;
+  CHECK_EQ(0, uv_thread_create(&thread_, ThreadMain, this));
+}
+
+
+StdioWriter::~StdioWriter() {
+  {
+    Mutex::ScopedLock lock(mutex_);
+    stopping_ = true;
+    data_cond_.Signal(lock);
+  }
+  CHECK_EQ(0, uv_thread_join(&thread_));
+}
+
+
+void StdioWriter::CopyIn(const char* data, size_t length) {
+  const size_t capacity = ring_.size();
+  const size_t tail = (head_ + size_) % capacity;
+  const size_t first = std::min(length, capacity - tail);
+  memcpy(&ring_[tail], data, first);
+  memcpy(&ring_[0], data + first, length - first);
+  size_ += length;
+}
+
+
+void StdioWriter::Grow(size_t capacity) {
+  std::vector<char> ring(capacity);
+  const size_t first = std::min(size_, ring_.size() - head_);
+  memcpy(&ring[0], &ring_[head_], first);
+  memcpy(&ring[first], &ring_[0], size_ - first);
+  ring_.swap(ring);
+  head_ = 0;
+  fields_[kCapacity] = capacity;
+}
+
+
+// Returns false if the data was dropped.
+bool StdioWriter::Append(const char* data, size_t length) {
+  Mutex::ScopedLock lock(mutex_);
+  if (error_ != 0 || (policy_ == kDrop && size_ + length > ring_.size())) {
+    fields_[kBytesDropped] += length;
+    return false;
+  }
+
+  if (policy_ == kGrow && size_ + length > ring_.size())
+    Grow(std::max(ring_.size() * 2, size_ + length));
+
+  // Blocking, in pieces of at most the capacity if the data is larger.
+  uint64_t blocked_since = 0;
+  while (length > 0) {
+    const size_t room = ring_.size() - size_;
+    if (room == 0) {
+      if (blocked_since == 0)
+        blocked_since = uv_hrtime();
+      room_cond_.Wait(lock);
+      if (error_ != 0) {
+        fields_[kBytesDropped] += length;
+        break;
+      }
+      continue;
+    }
+    const size_t count = std::min(room, length);
+    CopyIn(data, count);
+    data += count;
+    length -= count;
+    data_cond_.Signal(lock);
+  }
+  if (blocked_since != 0)
+    fields_[kBlockedTime] += (uv_hrtime() - blocked_since) / 1e6;
+
+  fields_[kBytesBuffered] = size_ + writing_;
+  if (fields_[kBytesBuffered] > fields_[kMaxBytesBuffered])
+    fields_[kMaxBytesBuffered] = fields_[kBytesBuffered];
+  return error_ == 0;
+}
+
+
+// Returns 0 or a negative libuv error code.
+int StdioWriter::WriteOut(const char* data, size_t length) {
+  while (length > 0) {
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(data), length);
+    uv_fs_t req;
+    const int r = uv_fs_write(nullptr, &req, fd_, &buf, 1, -1, nullptr);
+    uv_fs_req_cleanup(&req);
+#ifdef __POSIX__
+    // libuv makes the fds of pipes non-blocking.
+    if (r == UV_EAGAIN) {
+      pollfd fds = { fd_, POLLOUT, 0 };
+      poll(&fds, 1, -1);
+      continue;
+    }
+#endif
+    if (r == UV_EINTR)
+      continue;
+    if (r < 0)
+      return r;
+    data += r;
+    length -= r;
+  }
+  return 0;
+}
+
+
+void StdioWriter::ThreadMain(void* arg) {
+  StdioWriter* writer = static_cast<StdioWriter*>(arg);
+  std::vector<char> chunk(kChunkSize);
+  Mutex::ScopedLock lock(writer->mutex_);
+  for (;;) {
+    while (writer->size_ == 0 && !writer->stopping_)
+      writer->data_cond_.Wait(lock);
+    if (writer->size_ == 0)
+      break;
+
+    // Copied out, so that the ring can grow meanwhile.
+    const size_t capacity = writer->ring_.size();
+    const size_t length = std::min(writer->size_, kChunkSize);
+    const size_t first = std::min(length, capacity - writer->head_);
+    memcpy(&chunk[0], &writer->ring_[writer->head_], first);
+    memcpy(&chunk[first], &writer->ring_[0], length - first);
+    writer->head_ = (writer->head_ + length) % capacity;
+    writer->size_ -= length;
+    writer->writing_ = length;
+    writer->room_cond_.Broadcast(lock);
+
+    int err;
+    {
+      Mutex::ScopedUnlock unlock(lock);
+      err = writer->WriteOut(&chunk[0], length);
+    }
+
+    writer->writing_ = 0;
+    if (err == 0) {
+      writer->fields_[kBytesWritten] += length;
+    } else {
+      writer->error_ = err;
+      writer->fields_[kBytesDropped] += length + writer->size_;
+      writer->size_ = 0;
+    }
+    writer->fields_[kBytesBuffered] = writer->size_;
+    writer->room_cond_.Broadcast(lock);
+  }
+}
+
+
+// new StdioWriter(fd, capacity, policy)
+void StdioWriter::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsUint32());
+  CHECK(args[2]->IsInt32());
+  CHECK_GT(args[1].As<Uint32>()->Value(), 0);
+  new StdioWriter(env,
+                  args.This(),
+                  args[0].As<Int32>()->Value(),
+                  args[1].As<Uint32>()->Value(),
+                  static_cast<Policy>(args[2].As<Int32>()->Value()));
+}
+
+
+// write(buffer) returns false if the data was dropped, because the buffer
+// was full or writing failed.
+void StdioWriter::Write(const FunctionCallbackInfo<Value>& args) {
+  StdioWriter* writer;
+  ASSIGN_OR_RETURN_UNWRAP(&writer, args.Holder());
+  CHECK(Buffer::HasInstance(args[0]));
+  const bool written =
+      writer->Append(Buffer::Data(args[0]), Buffer::Length(args[0]));
+  args.GetReturnValue().Set(written);
+}
+
+
+// Waits until everything has been written out. Returns 0, or the libuv
+// error code that writing failed with.
+void StdioWriter::Flush(const FunctionCallbackInfo<Value>& args) {
+  StdioWriter* writer;
+  ASSIGN_OR_RETURN_UNWRAP(&writer, args.Holder());
+  Mutex::ScopedLock lock(writer->mutex_);
+  while (writer->size_ + writer->writing_ > 0 && writer->error_ == 0)
+    writer->room_cond_.Wait(lock);
+  args.GetReturnValue().Set(writer->error_);
+}
+
+
+void StdioWriter::GetStats(const FunctionCallbackInfo<Value>& args) {
+  StdioWriter* writer;
+  ASSIGN_OR_RETURN_UNWRAP(&writer, args.Holder());
+  CHECK(args[0]->IsFloat64Array());
+  Local<Float64Array> array = args[0].As<Float64Array>();
+  CHECK_EQ(array->Length(), kFieldsCount);
+  double* fields = static_cast<double*>(array->Buffer()->GetContents().Data());
+  Mutex::ScopedLock lock(writer->mutex_);
+  memcpy(fields, writer->fields_, sizeof(writer->fields_));
+}
+
+
+void StdioWriter::Initialize(Local<Object> target,
+                             Local<Value> unused,
+                             Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  t->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "StdioWriter"));
+
+  env->SetProtoMethod(t, "write", Write);
+  env->SetProtoMethod(t, "flush", Flush);
+  env->SetProtoMethod(t, "getStats", GetStats);
+
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "StdioWriter"),
+              t->GetFunction(env->context()).ToLocalChecked()).FromJust();
+
+#define V(name)                                                               \
+  NODE_DEFINE_CONSTANT(target, name);
+  V(kDrop)
+  V(kBlock)
+  V(kGrow)
+  V(kFieldsCount)
+#undef V
+}
+
+}  // anonymous namespace
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(stdio_writer, node::StdioWriter::Initialize)
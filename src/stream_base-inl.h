@@ -53,6 +53,9 @@ void StreamBase::AddMethods(Environment* env,
                                      attributes);
 
   env->SetProtoMethod(t, "readStart", JSMethod<Base, &StreamBase::ReadStart>);
+  env->SetProtoMethod(t,
+                      "getIOStats",
+                      JSMethod<Base, &StreamBase::GetIOStats>);
   env->SetProtoMethod(t, "readStop", JSMethod<Base, &StreamBase::ReadStop>);
   if ((flags & kFlagNoShutdown) == 0)
     env->SetProtoMethod(t, "shutdown", JSMethod<Base, &StreamBase::Shutdown>);
@@ -61,6 +64,9 @@ void StreamBase::AddMethods(Environment* env,
   env->SetProtoMethod(t,
                       "writeBuffer",
                       JSMethod<Base, &StreamBase::WriteBuffer>);
+  env->SetProtoMethod(t,
+                      "writeHandles",
+                      JSMethod<Base, &StreamBase::WriteHandles>);
   env->SetProtoMethod(t,
                       "writeAsciiString",
                       JSMethod<Base, &StreamBase::WriteString<ASCII> >);
@@ -144,15 +150,17 @@ WriteWrap* WriteWrap::New(Environment* env,
                           DoneCb cb,
                           size_t extra) {
   size_t storage_size = ROUND_UP(sizeof(WriteWrap), kAlignSize) + extra;
-  char* storage = new char[storage_size];
+  char* storage = env->req_freelist()->Allocate(storage_size);
 
   return new(storage) WriteWrap(env, obj, wrap, cb, storage_size);
 }
 
 
 void WriteWrap::Dispose() {
+  Environment* env = this->env();
+  const size_t storage_size = storage_size_;
   this->~WriteWrap();
-  delete[] reinterpret_cast<char*>(this);
+  env->req_freelist()->Free(reinterpret_cast<char*>(this), storage_size);
 }
 
 
@@ -18,6 +18,7 @@ namespace node {
 
 using v8::Array;
 using v8::Context;
+using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
 using v8::Integer;
@@ -168,6 +169,8 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
     bytes += str_size;
   }
 
+  CountWrite(0);
+  QueueWrite(req_wrap, bytes);
   int err = DoWrite(req_wrap, *bufs, count, nullptr);
 
   req_wrap_obj->Set(env->async(), True(env->isolate()));
@@ -178,57 +181,152 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
     ClearError();
   }
 
-  if (err)
+  if (err) {
+    DequeueWrite(req_wrap, err);
     req_wrap->Dispose();
+  }
 
   return err;
 }
 
 
-
-
 int StreamBase::WriteBuffer(const FunctionCallbackInfo<Value>& args) {
-  CHECK(args[0]->IsObject());
   CHECK(Buffer::HasInstance(args[1]));
   Environment* env = Environment::GetCurrent(args);
 
-  Local<Object> req_wrap_obj = args[0].As<Object>();
+  // Without a request object from JavaScript one is only created once the
+  // write has to be queued.
+  Local<Object> req_wrap_obj;
+  if (args[0]->IsObject())
+    req_wrap_obj = args[0].As<Object>();
   const char* data = Buffer::Data(args[1]);
   size_t length = Buffer::Length(args[1]);
 
-  WriteWrap* req_wrap;
+  // Like WriteString(), IPC pipes can send a handle along.
+  uv_handle_t* send_handle = nullptr;
+  if (IsIPCPipe() && args[2]->IsObject()) {
+    HandleWrap* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args[2].As<Object>(), UV_EINVAL);
+    send_handle = wrap->GetHandle();
+  }
+
+  WriteWrap* req_wrap = nullptr;
   uv_buf_t buf;
   buf.base = const_cast<char*>(data);
   buf.len = length;
 
+  uv_buf_t* bufs = &buf;
+  size_t count = 1;
+  int err = 0;
+
   // Try writing immediately without allocation
+  if (send_handle == nullptr) {
+    err = DoTryWrite(&bufs, &count);
+    if (err != 0)
+      goto done;
+    if (count == 0) {
+      CountWrite(length);
+      goto done;
+    }
+    CHECK_EQ(count, 1);
+    CountWrite(length - bufs[0].len);
+    partial_writes_++;
+  } else {
+    CountWrite(0);
+  }
+
+  // Allocate, or write rest
+  if (req_wrap_obj.IsEmpty())
+    req_wrap_obj = NewWriteReqObject(env);
+  req_wrap = WriteWrap::New(env, req_wrap_obj, this, AfterWrite);
+
+  QueueWrite(req_wrap, bufs[0].len);
+  err = DoWrite(req_wrap,
+                bufs,
+                count,
+                reinterpret_cast<uv_stream_t*>(send_handle));
+  req_wrap_obj->Set(env->async(), True(env->isolate()));
+  req_wrap_obj->Set(env->buffer_string(), args[1]);
+  // Reference the handle to prevent it from being garbage collected before
+  // `AfterWrite` is called.
+  if (send_handle != nullptr)
+    req_wrap_obj->Set(env->handle_string(), args[2]);
+
+  if (err) {
+    DequeueWrite(req_wrap, err);
+    req_wrap->Dispose();
+    req_wrap = nullptr;
+  }
+
+ done:
+  FinishWrite(env, req_wrap_obj, length, req_wrap != nullptr);
+  return err;
+}
+
+
+// writeHandles(req, buffer, handles)
+// Sends all of |handles| with |buffer|, where writeBuffer() sends one handle
+// per write. Returns UV_EAGAIN, having sent nothing, if that cannot be done
+// right away, for example while earlier writes are still queued. The caller
+// can then send the handles one at a time instead.
+int StreamBase::WriteHandles(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsObject());
+  CHECK(Buffer::HasInstance(args[1]));
+  CHECK(args[2]->IsArray());
+  Environment* env = Environment::GetCurrent(args);
+
+  Local<Object> req_wrap_obj = args[0].As<Object>();
+  Local<Array> handles = args[2].As<Array>();
+  const size_t length = Buffer::Length(args[1]);
+  const size_t handle_count = handles->Length();
+  if (!IsIPCPipe() || length == 0 || handle_count == 0 ||
+      handle_count > kMaxSendHandles) {
+    return UV_EINVAL;
+  }
+
+  uv_handle_t* send_handles[kMaxSendHandles];
+  for (size_t i = 0; i < handle_count; i++) {
+    Local<Value> handle = handles->Get(i);
+    if (!handle->IsObject())
+      return UV_EINVAL;
+    HandleWrap* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, handle.As<Object>(), UV_EINVAL);
+    send_handles[i] = wrap->GetHandle();
+  }
+
+  WriteWrap* req_wrap = nullptr;
+  uv_buf_t buf;
+  buf.base = Buffer::Data(args[1]);
+  buf.len = length;
+
   uv_buf_t* bufs = &buf;
   size_t count = 1;
-  int err = DoTryWrite(&bufs, &count);
+  int err = DoTrySendHandles(&bufs, &count, send_handles, handle_count);
   if (err != 0)
+    return err;
+  if (count == 0) {
+    CountWrite(length);
     goto done;
-  if (count == 0)
-    goto done;
+  }
   CHECK_EQ(count, 1);
+  CountWrite(length - bufs[0].len);
+  partial_writes_++;
 
-  // Allocate, or write rest
+  // Write the rest, the handles have gone out already.
   req_wrap = WriteWrap::New(env, req_wrap_obj, this, AfterWrite);
-
+  QueueWrite(req_wrap, bufs[0].len);
   err = DoWrite(req_wrap, bufs, count, nullptr);
   req_wrap_obj->Set(env->async(), True(env->isolate()));
   req_wrap_obj->Set(env->buffer_string(), args[1]);
 
-  if (err)
+  if (err) {
+    DequeueWrite(req_wrap, err);
     req_wrap->Dispose();
+    req_wrap = nullptr;
+  }
 
  done:
-  const char* msg = Error();
-  if (msg != nullptr) {
-    req_wrap_obj->Set(env->error_string(), OneByteString(env->isolate(), msg));
-    ClearError();
-  }
-  req_wrap_obj->Set(env->bytes_string(),
-                    Integer::NewFromUnsigned(env->isolate(), length));
+  FinishWrite(env, req_wrap_obj, length, req_wrap != nullptr);
   return err;
 }
 
@@ -236,10 +334,12 @@ int StreamBase::WriteBuffer(const FunctionCallbackInfo<Value>& args) {
 template <enum encoding enc>
 int StreamBase::WriteString(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
-  CHECK(args[0]->IsObject());
   CHECK(args[1]->IsString());
 
-  Local<Object> req_wrap_obj = args[0].As<Object>();
+  // See WriteBuffer() for writes without a request object.
+  Local<Object> req_wrap_obj;
+  if (args[0]->IsObject())
+    req_wrap_obj = args[0].As<Object>();
   Local<String> string = args[1].As<String>();
   Local<Object> send_handle_obj;
   if (args[2]->IsObject())
@@ -260,7 +360,7 @@ int StreamBase::WriteString(const FunctionCallbackInfo<Value>& args) {
     return UV_ENOBUFS;
 
   // Try writing immediately if write size isn't too big
-  WriteWrap* req_wrap;
+  WriteWrap* req_wrap = nullptr;
   char* data;
   char stack_storage[16384];  // 16kb
   size_t data_size;
@@ -285,13 +385,21 @@ int StreamBase::WriteString(const FunctionCallbackInfo<Value>& args) {
       goto done;
 
     // Success
-    if (count == 0)
+    if (count == 0) {
+      CountWrite(data_size);
       goto done;
+    }
 
     // Partial write
     CHECK_EQ(count, 1);
+    CountWrite(data_size - buf.len);
+    partial_writes_++;
+  } else {
+    CountWrite(0);
   }
 
+  if (req_wrap_obj.IsEmpty())
+    req_wrap_obj = NewWriteReqObject(env);
   req_wrap = WriteWrap::New(env, req_wrap_obj, this, AfterWrite, storage_size);
 
   data = req_wrap->Extra();
@@ -312,6 +420,7 @@ int StreamBase::WriteString(const FunctionCallbackInfo<Value>& args) {
   CHECK_LE(data_size, storage_size);
 
   buf = uv_buf_init(data, data_size);
+  QueueWrite(req_wrap, data_size);
 
   if (!IsIPCPipe()) {
     err = DoWrite(req_wrap, &buf, 1, nullptr);
@@ -337,18 +446,70 @@ int StreamBase::WriteString(const FunctionCallbackInfo<Value>& args) {
 
   req_wrap_obj->Set(env->async(), True(env->isolate()));
 
-  if (err)
+  if (err) {
+    DequeueWrite(req_wrap, err);
     req_wrap->Dispose();
+    req_wrap = nullptr;
+  }
 
  done:
+  FinishWrite(env, req_wrap_obj, data_size, req_wrap != nullptr);
+  return err;
+}
+
+
+Local<Object> StreamBase::NewWriteReqObject(Environment* env) {
+  Local<Function> constructor = env->write_wrap_constructor_function();
+  CHECK_EQ(constructor.IsEmpty(), false);
+  return constructor->NewInstance(env->context()).ToLocalChecked();
+}
+
+
+void StreamBase::FinishWrite(Environment* env,
+                             Local<Object> req_wrap_obj,
+                             size_t bytes,
+                             bool async) {
+  double* state = env->stream_base_state();
+  if (state != nullptr) {
+    state[kBytesWritten] = static_cast<double>(bytes);
+    state[kLastWriteWasAsync] = async ? 1 : 0;
+  }
+
+  // Writes that completed synchronously may have no request object, their
+  // error message goes on the stream object instead.
   const char* msg = Error();
   if (msg != nullptr) {
-    req_wrap_obj->Set(env->error_string(), OneByteString(env->isolate(), msg));
+    Local<Object> target = req_wrap_obj.IsEmpty() ? GetObject() : req_wrap_obj;
+    target->Set(env->error_string(), OneByteString(env->isolate(), msg));
     ClearError();
   }
-  req_wrap_obj->Set(env->bytes_string(),
-                    Integer::NewFromUnsigned(env->isolate(), data_size));
-  return err;
+
+  if (!req_wrap_obj.IsEmpty()) {
+    req_wrap_obj->Set(env->bytes_string(),
+                      Integer::NewFromUnsigned(env->isolate(), bytes));
+  }
+}
+
+
+int StreamBase::GetIOStats(const FunctionCallbackInfo<Value>& args) {
+  // The array is set up by the stream_wrap binding's getStreamStatValues().
+  double* fields = env_->stream_stats_field_array();
+  if (fields == nullptr)
+    return UV_EINVAL;
+
+  uint64_t blocked_time = blocked_time_;
+  if (bytes_queued_ > 0)
+    blocked_time += uv_hrtime() - blocked_since_;
+
+  fields[kStatsBytesRead] = static_cast<double>(bytes_read_);
+  fields[kStatsBytesWritten] = static_cast<double>(bytes_written_);
+  fields[kStatsReadCalls] = static_cast<double>(read_calls_);
+  fields[kStatsWriteCalls] = static_cast<double>(write_calls_);
+  fields[kStatsPartialWrites] = static_cast<double>(partial_writes_);
+  fields[kStatsBytesQueued] = static_cast<double>(bytes_queued_);
+  // In milliseconds, like the other times that node reports.
+  fields[kStatsBlockedTime] = blocked_time / 1e6;
+  return 0;
 }
 
 
@@ -365,6 +526,7 @@ void StreamBase::AfterWrite(WriteWrap* req_wrap, int status) {
   // Unref handle property
   Local<Object> req_wrap_obj = req_wrap->object();
   req_wrap_obj->Delete(env->context(), env->handle_string()).FromJust();
+  wrap->DequeueWrite(req_wrap, status);
   wrap->OnAfterWrite(req_wrap);
 
   Local<Value> argv[] = {
@@ -380,15 +542,26 @@ void StreamBase::AfterWrite(WriteWrap* req_wrap, int status) {
     wrap->ClearError();
   }
 
-  if (req_wrap_obj->Has(env->context(), env->oncomplete_string()).FromJust())
+  // Request objects that StreamBase created itself report to the stream's
+  // onwritecomplete() instead.
+  Local<Value> onwritecomplete;
+  if (req_wrap_obj->Has(env->context(), env->oncomplete_string()).FromJust()) {
     req_wrap->MakeCallback(env->oncomplete_string(), arraysize(argv), argv);
+  } else if (wrap->GetObject()->Get(env->context(),
+                                    env->onwritecomplete_string())
+                 .ToLocal(&onwritecomplete) &&
+             onwritecomplete->IsFunction()) {
+    req_wrap->MakeCallback(onwritecomplete.As<Function>(),
+                           arraysize(argv),
+                           argv);
+  }
 
   req_wrap->Dispose();
 }
 
 
 void StreamBase::EmitData(ssize_t nread,
-                          Local<Object> buf,
+                          Local<Value> buf,
                           Local<Object> handle) {
   Environment* env = env_;
 
@@ -443,6 +616,14 @@ int StreamResource::DoTryWrite(uv_buf_t** bufs, size_t* count) {
 }
 
 
+int StreamResource::DoTrySendHandles(uv_buf_t** bufs,
+                                     size_t* count,
+                                     uv_handle_t** handles,
+                                     size_t handle_count) {
+  return UV_ENOSYS;
+}
+
+
 const char* StreamResource::Error() const {
   return nullptr;
 }
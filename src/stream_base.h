@@ -81,6 +81,10 @@ class WriteWrap: public ReqWrap<uv_write_t>,
 
   inline StreamBase* wrap() const { return wrap_; }
 
+  // Bytes that were still to be written when the request was dispatched.
+  inline size_t queued_bytes() const { return queued_bytes_; }
+  inline void set_queued_bytes(size_t bytes) { queued_bytes_ = bytes; }
+
   size_t self_size() const override { return storage_size_; }
 
   static void NewWriteWrap(const v8::FunctionCallbackInfo<v8::Value>& args) {
@@ -102,7 +106,8 @@ class WriteWrap: public ReqWrap<uv_write_t>,
       : ReqWrap(env, obj, AsyncWrap::PROVIDER_WRITEWRAP),
         StreamReq<WriteWrap>(cb),
         wrap_(wrap),
-        storage_size_(storage_size) {
+        storage_size_(storage_size),
+        queued_bytes_(0) {
     Wrap(obj, this);
   }
 
@@ -120,6 +125,7 @@ class WriteWrap: public ReqWrap<uv_write_t>,
 
   StreamBase* const wrap_;
   const size_t storage_size_;
+  size_t queued_bytes_;
 };
 
 class StreamResource {
@@ -148,7 +154,18 @@ class StreamResource {
                          void* ctx);
   typedef void (*DestructCb)(void* ctx);
 
-  StreamResource() : bytes_read_(0) {
+  // The most handles that DoTrySendHandles() takes. libuv accepts up to 64
+  // with each read.
+  static const size_t kMaxSendHandles = 64;
+
+  StreamResource() : bytes_read_(0),
+                     bytes_written_(0),
+                     read_calls_(0),
+                     write_calls_(0),
+                     partial_writes_(0),
+                     bytes_queued_(0),
+                     blocked_time_(0),
+                     blocked_since_(0) {
   }
   virtual ~StreamResource() {
     if (!destruct_cb_.is_empty())
@@ -157,6 +174,14 @@ class StreamResource {
 
   virtual int DoShutdown(ShutdownWrap* req_wrap) = 0;
   virtual int DoTryWrite(uv_buf_t** bufs, size_t* count);
+  // Sends |handles| along with the start of the data, without a queued
+  // write, and slices off what was sent like DoTryWrite(). Returns an error,
+  // having sent nothing, if it cannot be done right away; UV_EAGAIN means
+  // that it might work later.
+  virtual int DoTrySendHandles(uv_buf_t** bufs,
+                               size_t* count,
+                               uv_handle_t** handles,
+                               size_t handle_count);
   virtual int DoWrite(WriteWrap* w,
                       uv_buf_t* bufs,
                       size_t count,
@@ -178,8 +203,10 @@ class StreamResource {
   inline void OnRead(ssize_t nread,
                      const uv_buf_t* buf,
                      uv_handle_type pending = UV_UNKNOWN_HANDLE) {
-    if (nread > 0)
+    if (nread > 0) {
       bytes_read_ += static_cast<uint64_t>(nread);
+      read_calls_++;
+    }
     if (!read_cb_.is_empty())
       read_cb_.fn(nread, buf, pending, read_cb_.ctx);
   }
@@ -198,11 +225,48 @@ class StreamResource {
   inline Callback<DestructCb> destruct_cb() { return destruct_cb_; }
 
  private:
+  // Write accounting for writes that come in through StreamBase. |written|
+  // bytes went out right away, QueueWrite() charges what is left to the
+  // request until DequeueWrite().
+  inline void CountWrite(size_t written) {
+    write_calls_++;
+    bytes_written_ += written;
+  }
+
+  inline void QueueWrite(WriteWrap* w, size_t bytes) {
+    if (bytes == 0)
+      return;
+    if (bytes_queued_ == 0)
+      blocked_since_ = uv_hrtime();
+    bytes_queued_ += bytes;
+    w->set_queued_bytes(bytes);
+  }
+
+  inline void DequeueWrite(WriteWrap* w, int status) {
+    size_t bytes = w->queued_bytes();
+    if (bytes == 0)
+      return;
+    w->set_queued_bytes(0);
+    bytes_queued_ -= bytes;
+    if (status == 0)
+      bytes_written_ += bytes;
+    if (bytes_queued_ == 0)
+      blocked_time_ += uv_hrtime() - blocked_since_;
+  }
+
   Callback<AfterWriteCb> after_write_cb_;
   Callback<AllocCb> alloc_cb_;
   Callback<ReadCb> read_cb_;
   Callback<DestructCb> destruct_cb_;
   uint64_t bytes_read_;
+  uint64_t bytes_written_;
+  uint64_t read_calls_;
+  uint64_t write_calls_;
+  uint64_t partial_writes_;
+  uint64_t bytes_queued_;
+  // Nanoseconds during which writes were queued up behind the kernel.
+  uint64_t blocked_time_;
+  uint64_t blocked_since_;
 
   friend class StreamBase;
 };
@@ -215,6 +279,28 @@ class StreamBase : public StreamResource {
     kFlagNoShutdown = 0x2
   };
 
+  // Layout of the streamBaseState array through which the write methods
+  // report the number of bytes written and whether the write was queued.
+  // Together they let JavaScript write without a request object: one is
+  // only created, and reported to onwritecomplete(), if the write queues.
+  enum StreamBaseStateFields {
+    kBytesWritten,
+    kLastWriteWasAsync,
+    kStreamBaseStateFieldsCount
+  };
+
+  // Layout of the stream stats array that getIOStats() fills in.
+  enum IOStatsFields {
+    kStatsBytesRead,
+    kStatsBytesWritten,
+    kStatsReadCalls,
+    kStatsWriteCalls,
+    kStatsPartialWrites,
+    kStatsBytesQueued,
+    kStatsBlockedTime,
+    kStatsFieldsCount
+  };
+
   template <class Base>
   static inline void AddMethods(Environment* env,
                                 v8::Local<v8::FunctionTemplate> target,
@@ -234,11 +320,14 @@ class StreamBase : public StreamResource {
     consumed_ = true;
   }
 
+  // A stream stays consumed after its consumer gives the callbacks back.
+  inline bool IsConsumed() const { return consumed_; }
+
   template <class Outer>
   inline Outer* Cast() { return static_cast<Outer*>(Cast()); }
 
   void EmitData(ssize_t nread,
-                v8::Local<v8::Object> buf,
+                v8::Local<v8::Value> buf,
                 v8::Local<v8::Object> handle);
 
  protected:
@@ -261,6 +350,14 @@ class StreamBase : public StreamResource {
   int Shutdown(const v8::FunctionCallbackInfo<v8::Value>& args);
   int Writev(const v8::FunctionCallbackInfo<v8::Value>& args);
   int WriteBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
+  int WriteHandles(const v8::FunctionCallbackInfo<v8::Value>& args);
+  int GetIOStats(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  v8::Local<v8::Object> NewWriteReqObject(Environment* env);
+  void FinishWrite(Environment* env,
+                   v8::Local<v8::Object> req_wrap_obj,
+                   size_t bytes,
+                   bool async);
   template <enum encoding enc>
   int WriteString(const v8::FunctionCallbackInfo<v8::Value>& args);
 
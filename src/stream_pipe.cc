@@ -0,0 +1,452 @@
+#include "stream_pipe.h"
+
+#include "async-wrap.h"
+#include "async-wrap-inl.h"
+#include "env.h"
+#include "env-inl.h"
+#include "node_internals.h"
+#include "stream_base.h"
+#include "stream_base-inl.h"
+#include "util.h"
+#include "util-inl.h"
+#include "uv.h"
+#include "v8.h"
+
+#include <algorithm>
+
+namespace node {
+
+using v8::Context;
+using v8::External;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Local;
+using v8::Object;
+using v8::Value;
+
+namespace {
+
+// Stored at the front of every chunk's extra storage, so that AfterWrite()
+// can find its way back to the pipe.
+struct ChunkHeader {
+  StreamPipe* pipe;
+  size_t length;
+};
+
+const size_t kChunkHeaderSize =
+    ROUND_UP(sizeof(ChunkHeader), WriteWrap::kAlignSize);
+
+inline ChunkHeader* HeaderOf(WriteWrap* w) {
+  return reinterpret_cast<ChunkHeader*>(w->Extra());
+}
+
+inline char* DataOf(WriteWrap* w) {
+  return w->Extra(kChunkHeaderSize);
+}
+
+// Chunks that never reach DoWrite() are released here.
+inline void DisposeChunk(WriteWrap* w) {
+  if (w == nullptr)
+    return;
+  w->Dispatched();
+  w->Dispose();
+}
+
+}  // anonymous namespace
+
+
+StreamPipe::StreamPipe(Environment* env,
+                       Local<Object> object,
+                       StreamBase* sink)
+    : AsyncWrap(env, object, AsyncWrap::PROVIDER_STREAMPIPE),
+      sink_(sink),
+      source_(nullptr),
+      fd_(-1),
+      position_(-1),
+      remaining_(-1),
+      file_read_active_(false),
+      chunk_(nullptr),
+      queued_bytes_(0),
+      queued_writes_(0),
+      started_(false),
+      paused_(false),
+      finished_(false),
+      notify_(false),
+      released_(false),
+      status_(0) {
+  Wrap(object, this);
+}
+
+
+StreamPipe::~StreamPipe() {
+  CHECK(released_);
+  ClearWrap(object());
+  persistent().Reset();
+}
+
+
+void StreamPipe::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsExternal());
+
+  StreamBase* sink = static_cast<StreamBase*>(args[0].As<External>()->Value());
+  CHECK_NE(sink, nullptr);
+  new StreamPipe(env, args.This(), sink);
+}
+
+
+void StreamPipe::FromStream(const FunctionCallbackInfo<Value>& args) {
+  StreamPipe* pipe;
+  ASSIGN_OR_RETURN_UNWRAP(&pipe, args.Holder());
+  CHECK(args[0]->IsExternal());
+  CHECK(!pipe->started_);
+
+  StreamBase* source =
+      static_cast<StreamBase*>(args[0].As<External>()->Value());
+  CHECK_NE(source, nullptr);
+  CHECK_NE(source, pipe->sink_);
+
+  pipe->started_ = true;
+  pipe->source_ = source;
+  pipe->prev_alloc_cb_ = source->alloc_cb();
+  pipe->prev_read_cb_ = source->read_cb();
+  pipe->prev_source_destruct_cb_ = source->destruct_cb();
+  source->set_alloc_cb({ OnAllocImpl, pipe });
+  source->set_read_cb({ OnReadImpl, pipe });
+  source->set_destruct_cb({ OnSourceDestruct, pipe });
+  pipe->prev_sink_destruct_cb_ = pipe->sink_->destruct_cb();
+  pipe->sink_->set_destruct_cb({ OnSinkDestruct, pipe });
+
+  int err = source->ReadStart();
+  if (err != 0) {
+    pipe->Finish(err, false);
+    pipe->MaybeNotify();
+  }
+  args.GetReturnValue().Set(err);
+}
+
+
+void StreamPipe::FromFile(const FunctionCallbackInfo<Value>& args) {
+  StreamPipe* pipe;
+  ASSIGN_OR_RETURN_UNWRAP(&pipe, args.Holder());
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsNumber());
+  CHECK(args[2]->IsNumber());
+  CHECK(!pipe->started_);
+
+  pipe->started_ = true;
+  pipe->fd_ = args[0]->Int32Value();
+  // A negative position reads from the current file position, a negative
+  // length reads until the end of the file.
+  pipe->position_ = args[1]->IntegerValue();
+  pipe->remaining_ = args[2]->IntegerValue();
+  if (pipe->position_ < 0)
+    pipe->position_ = -1;
+  if (pipe->remaining_ < 0)
+    pipe->remaining_ = -1;
+  pipe->prev_sink_destruct_cb_ = pipe->sink_->destruct_cb();
+  pipe->sink_->set_destruct_cb({ OnSinkDestruct, pipe });
+
+  if (pipe->remaining_ == 0) {
+    pipe->Finish(0, false);
+    pipe->MaybeNotify();
+    return args.GetReturnValue().Set(0);
+  }
+
+  int err = pipe->ReadFile();
+  if (err != 0) {
+    pipe->Finish(err, false);
+    pipe->MaybeNotify();
+  }
+  args.GetReturnValue().Set(err);
+}
+
+
+void StreamPipe::Unpipe(const FunctionCallbackInfo<Value>& args) {
+  StreamPipe* pipe;
+  ASSIGN_OR_RETURN_UNWRAP(&pipe, args.Holder());
+
+  pipe->Finish(0, false);
+  pipe->MaybeNotify();
+}
+
+
+WriteWrap* StreamPipe::NewChunk() {
+  HandleScope scope(env()->isolate());
+  Local<Object> req_wrap_obj =
+      env()->write_wrap_constructor_function()
+          ->NewInstance(env()->context()).ToLocalChecked();
+  WriteWrap* w = WriteWrap::New(env(),
+                                req_wrap_obj,
+                                sink_,
+                                AfterWrite,
+                                kChunkHeaderSize + kChunkSize);
+  HeaderOf(w)->pipe = this;
+  HeaderOf(w)->length = 0;
+  return w;
+}
+
+
+void StreamPipe::WriteChunk(WriteWrap* w, size_t length) {
+  uv_buf_t buf = uv_buf_init(DataOf(w), length);
+  uv_buf_t* bufs = &buf;
+  size_t count = 1;
+
+  int err = sink_->DoTryWrite(&bufs, &count);
+  if (err == 0 && count == 0) {
+    DisposeChunk(w);
+    return;
+  }
+
+  if (err == 0) {
+    HeaderOf(w)->length = bufs[0].len;
+    err = sink_->DoWrite(w, bufs, count, nullptr);
+    if (err == 0) {
+      queued_bytes_ += bufs[0].len;
+      queued_writes_++;
+      return;
+    }
+  }
+
+  DisposeChunk(w);
+  Finish(err, true);
+}
+
+
+int StreamPipe::ReadFile() {
+  CHECK(!file_read_active_);
+
+  size_t length = kChunkSize;
+  if (remaining_ >= 0)
+    length = std::min(length, static_cast<size_t>(remaining_));
+
+  chunk_ = NewChunk();
+  uv_buf_t buf = uv_buf_init(DataOf(chunk_), length);
+  read_req_.data = this;
+  int err = uv_fs_read(env()->event_loop(),
+                       &read_req_,
+                       fd_,
+                       &buf,
+                       1,
+                       position_,
+                       OnFileRead);
+  if (err != 0) {
+    DisposeChunk(chunk_);
+    chunk_ = nullptr;
+    return err;
+  }
+
+  file_read_active_ = true;
+  return 0;
+}
+
+
+void StreamPipe::Pause() {
+  paused_ = true;
+  if (source_ != nullptr)
+    source_->ReadStop();
+}
+
+
+void StreamPipe::Resume() {
+  paused_ = false;
+
+  int err = 0;
+  if (source_ != nullptr)
+    err = source_->ReadStart();
+  else if (fd_ >= 0 && !file_read_active_)
+    err = ReadFile();
+
+  if (err != 0)
+    Finish(err, true);
+}
+
+
+void StreamPipe::Finish(int status, bool notify) {
+  if (finished_)
+    return;
+
+  finished_ = true;
+  notify_ = notify;
+  status_ = status;
+
+  if (source_ != nullptr) {
+    if (source_->IsAlive())
+      source_->ReadStop();
+    source_->set_alloc_cb(prev_alloc_cb_);
+    source_->set_read_cb(prev_read_cb_);
+    source_->set_destruct_cb(prev_source_destruct_cb_);
+    source_ = nullptr;
+  }
+
+  // Queued writes still complete through AfterWrite(), and the sink cannot
+  // go away before they have.
+  if (sink_ != nullptr && started_)
+    sink_->set_destruct_cb(prev_sink_destruct_cb_);
+}
+
+
+void StreamPipe::MaybeNotify() {
+  if (!finished_ || queued_writes_ > 0 || file_read_active_ || released_)
+    return;
+
+  released_ = true;
+
+  if (notify_) {
+    HandleScope scope(env()->isolate());
+    Context::Scope context_scope(env()->context());
+    Local<Value> argv[] = { Integer::New(env()->isolate(), status_) };
+    MakeCallback(env()->onunpipe_string(), arraysize(argv), argv);
+  }
+
+  MakeWeak<StreamPipe>(this);
+}
+
+
+void StreamPipe::OnAllocImpl(size_t size, uv_buf_t* buf, void* ctx) {
+  StreamPipe* pipe = static_cast<StreamPipe*>(ctx);
+  CHECK_EQ(pipe->chunk_, nullptr);
+
+  pipe->chunk_ = pipe->NewChunk();
+  buf->base = DataOf(pipe->chunk_);
+  buf->len = kChunkSize;
+}
+
+
+void StreamPipe::OnReadImpl(ssize_t nread,
+                            const uv_buf_t* buf,
+                            uv_handle_type pending,
+                            void* ctx) {
+  StreamPipe* pipe = static_cast<StreamPipe*>(ctx);
+  HandleScope scope(pipe->env()->isolate());
+  Context::Scope context_scope(pipe->env()->context());
+
+  WriteWrap* w = pipe->chunk_;
+  pipe->chunk_ = nullptr;
+
+  if (nread <= 0) {
+    DisposeChunk(w);
+    if (nread < 0) {
+      pipe->Finish(nread == UV_EOF ? 0 : nread, true);
+      pipe->MaybeNotify();
+    }
+    return;
+  }
+
+  CHECK_NE(w, nullptr);
+  pipe->WriteChunk(w, nread);
+  if (!pipe->finished_ && pipe->queued_bytes_ >= kHighWaterMark)
+    pipe->Pause();
+  pipe->MaybeNotify();
+}
+
+
+void StreamPipe::OnFileRead(uv_fs_t* req) {
+  StreamPipe* pipe = static_cast<StreamPipe*>(req->data);
+  HandleScope scope(pipe->env()->isolate());
+  Context::Scope context_scope(pipe->env()->context());
+
+  const ssize_t result = req->result;
+  uv_fs_req_cleanup(req);
+  pipe->file_read_active_ = false;
+
+  WriteWrap* w = pipe->chunk_;
+  pipe->chunk_ = nullptr;
+
+  if (pipe->finished_ || result <= 0) {
+    DisposeChunk(w);
+    pipe->Finish(result, true);
+    pipe->MaybeNotify();
+    return;
+  }
+
+  if (pipe->position_ >= 0)
+    pipe->position_ += result;
+  if (pipe->remaining_ > 0)
+    pipe->remaining_ -= result;
+
+  pipe->WriteChunk(w, result);
+
+  if (!pipe->finished_) {
+    if (pipe->remaining_ == 0) {
+      pipe->Finish(0, true);
+    } else if (pipe->queued_bytes_ >= kHighWaterMark) {
+      pipe->paused_ = true;
+    } else {
+      int err = pipe->ReadFile();
+      if (err != 0)
+        pipe->Finish(err, true);
+    }
+  }
+  pipe->MaybeNotify();
+}
+
+
+void StreamPipe::AfterWrite(WriteWrap* w, int status) {
+  StreamPipe* pipe = HeaderOf(w)->pipe;
+  const size_t length = HeaderOf(w)->length;
+
+  if (pipe->sink_ != nullptr)
+    pipe->sink_->OnAfterWrite(w);
+  w->Dispose();
+
+  CHECK_GT(pipe->queued_writes_, 0);
+  pipe->queued_writes_--;
+  pipe->queued_bytes_ -= length;
+
+  if (status < 0)
+    pipe->Finish(status, true);
+  else if (!pipe->finished_ && pipe->paused_ &&
+           pipe->queued_bytes_ <= kHighWaterMark / 2)
+    pipe->Resume();
+
+  pipe->MaybeNotify();
+}
+
+
+void StreamPipe::OnSourceDestruct(void* ctx) {
+  StreamPipe* pipe = static_cast<StreamPipe*>(ctx);
+  if (!pipe->prev_source_destruct_cb_.is_empty())
+    pipe->prev_source_destruct_cb_.fn(pipe->prev_source_destruct_cb_.ctx);
+
+  // The source is being torn down; leave its callbacks alone.
+  pipe->source_ = nullptr;
+  pipe->Finish(UV_ECANCELED, false);
+  pipe->MaybeNotify();
+}
+
+
+void StreamPipe::OnSinkDestruct(void* ctx) {
+  StreamPipe* pipe = static_cast<StreamPipe*>(ctx);
+  if (!pipe->prev_sink_destruct_cb_.is_empty())
+    pipe->prev_sink_destruct_cb_.fn(pipe->prev_sink_destruct_cb_.ctx);
+
+  pipe->sink_ = nullptr;
+  pipe->Finish(UV_ECANCELED, false);
+  pipe->MaybeNotify();
+}
+
+
+void StreamPipe::Initialize(Local<Object> target,
+                            Local<Value> unused,
+                            Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+  t->SetClassName(FIXED_ONE_BYTE_STRING(env->isolate(), "StreamPipe"));
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+
+  env->SetProtoMethod(t, "fromStream", FromStream);
+  env->SetProtoMethod(t, "fromFile", FromFile);
+  env->SetProtoMethod(t, "unpipe", Unpipe);
+
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "StreamPipe"),
+              t->GetFunction());
+}
+
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(stream_pipe, node::StreamPipe::Initialize)
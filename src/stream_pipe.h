@@ -0,0 +1,95 @@
+#ifndef SRC_STREAM_PIPE_H_
+#define SRC_STREAM_PIPE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "async-wrap.h"
+#include "env.h"
+#include "stream_base.h"
+#include "uv.h"
+#include "v8.h"
+
+namespace node {
+
+// Moves data from a readable StreamBase, or from a file descriptor, into a
+// writable StreamBase without a round trip through JavaScript for every
+// chunk. Backpressure is handled natively by pausing the source while too
+// much data is queued on the sink.
+//
+// JavaScript only hears about the end of the pipe: onunpipe(status) is
+// called once the source has ended (status 0) or reading or writing failed
+// (a negative errno), after every queued write has completed. It is not
+// called when the pipe is stopped through unpipe() or because the source
+// was closed.
+class StreamPipe : public AsyncWrap {
+ public:
+  static void Initialize(v8::Local<v8::Object> target,
+                         v8::Local<v8::Value> unused,
+                         v8::Local<v8::Context> context);
+
+  ~StreamPipe() override;
+
+  size_t self_size() const override { return sizeof(*this); }
+
+ private:
+  // Data read from the source is written straight from the extra storage of
+  // the WriteWrap that the chunk was read into.
+  static const size_t kChunkSize = 64 * 1024;
+  // Reading pauses once this many bytes are queued on the sink, and resumes
+  // when the queue has drained to half of it.
+  static const size_t kHighWaterMark = 4 * kChunkSize;
+
+  StreamPipe(Environment* env, v8::Local<v8::Object> object, StreamBase* sink);
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void FromStream(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void FromFile(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Unpipe(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  WriteWrap* NewChunk();
+  void WriteChunk(WriteWrap* w, size_t length);
+  int ReadFile();
+  void Pause();
+  void Resume();
+  void Finish(int status, bool notify);
+  void MaybeNotify();
+
+  static void OnAllocImpl(size_t size, uv_buf_t* buf, void* ctx);
+  static void OnReadImpl(ssize_t nread,
+                         const uv_buf_t* buf,
+                         uv_handle_type pending,
+                         void* ctx);
+  static void OnFileRead(uv_fs_t* req);
+  static void AfterWrite(WriteWrap* w, int status);
+  static void OnSourceDestruct(void* ctx);
+  static void OnSinkDestruct(void* ctx);
+
+  StreamBase* sink_;
+  StreamBase* source_;
+  StreamResource::Callback<StreamResource::AllocCb> prev_alloc_cb_;
+  StreamResource::Callback<StreamResource::ReadCb> prev_read_cb_;
+  StreamResource::Callback<StreamResource::DestructCb> prev_source_destruct_cb_;
+  StreamResource::Callback<StreamResource::DestructCb> prev_sink_destruct_cb_;
+
+  uv_file fd_;
+  int64_t position_;
+  int64_t remaining_;
+  uv_fs_t read_req_;
+  bool file_read_active_;
+
+  WriteWrap* chunk_;
+  size_t queued_bytes_;
+  size_t queued_writes_;
+  bool started_;
+  bool paused_;
+  bool finished_;
+  bool notify_;
+  bool released_;
+  int status_;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_STREAM_PIPE_H_
@@ -28,9 +28,13 @@
 #include "handle_wrap.h"
 #include "node_buffer.h"
 #include "node_counters.h"
+#include "node_counter_registry.h"
+#include "node_probes.h"
+#include "node_threadpool.h"
 #include "pipe_wrap.h"
 #include "req-wrap.h"
 #include "req-wrap-inl.h"
+#include "slab_allocator.h"
 #include "tcp_wrap.h"
 #include "udp_wrap.h"
 #include "util.h"
@@ -40,20 +44,49 @@
 #include <string.h>  // memcpy()
 #include <limits.h>  // INT_MAX
 
+#ifndef _WIN32
+#include <sys/socket.h>  // sendmsg()
+#include <unistd.h>  // close(), dup()
+#endif
+
 
 namespace node {
 
+using v8::Array;
+using v8::ArrayBuffer;
 using v8::Context;
 using v8::EscapableHandleScope;
+using v8::Float64Array;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
 using v8::Integer;
 using v8::Local;
+using v8::Number;
 using v8::Object;
+using v8::Undefined;
 using v8::Value;
 
 
+// Returns the array that handle.getIOStats() fills in. It is shared by all
+// streams so that reading the counters doesn't allocate.
+static void GetStreamStatValues(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  const size_t count = StreamBase::kStatsFieldsCount;
+  // Freed along with the environment.
+  double* fields = env->stream_stats_field_array();
+  if (fields == nullptr) {
+    env->set_stream_stats_field_array(
+        std::unique_ptr<double[]>(new double[count]()));
+    fields = env->stream_stats_field_array();
+  }
+  Local<ArrayBuffer> ab = ArrayBuffer::New(env->isolate(),
+                                           fields,
+                                           sizeof(double) * count);
+  args.GetReturnValue().Set(Float64Array::New(ab, 0, count));
+}
+
+
 void StreamWrap::Initialize(Local<Object> target,
                             Local<Value> unused,
                             Local<Context> context) {
@@ -73,6 +106,20 @@ void StreamWrap::Initialize(Local<Object> target,
   target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "WriteWrap"),
               ww->GetFunction());
   env->set_write_wrap_constructor_function(ww->GetFunction());
+
+  env->SetMethod(target, "getStreamStatValues", GetStreamStatValues);
+
+  const size_t state_count = StreamBase::kStreamBaseStateFieldsCount;
+  double* state = env->stream_base_state();
+  if (state == nullptr) {
+    env->set_stream_base_state(
+        std::unique_ptr<double[]>(new double[state_count]()));
+    state = env->stream_base_state();
+  }
+  Local<ArrayBuffer> state_ab =
+      ArrayBuffer::New(env->isolate(), state, sizeof(double) * state_count);
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "streamBaseState"),
+              Float64Array::New(state_ab, 0, state_count));
 }
 
 
@@ -87,7 +134,18 @@ StreamWrap::StreamWrap(Environment* env,
                  provider,
                  parent),
       StreamBase(env),
-      stream_(stream) {
+      stream_(stream),
+      read_buffer_data_(nullptr),
+      read_buffer_length_(0),
+      read_buffer_offset_(0),
+      write_coalesce_limit_(0),
+      coalesced_bytes_(0),
+      flush_check_(nullptr),
+      flush_idle_(nullptr),
+      idle_timeout_(0),
+      last_activity_(0),
+      idle_timer_(nullptr),
+      send_file_(nullptr) {
   set_after_write_cb({ OnAfterWriteImpl, this });
   set_alloc_cb({ OnAllocImpl, this });
   set_read_cb({ OnReadImpl, this });
@@ -98,6 +156,10 @@ void StreamWrap::AddMethods(Environment* env,
                             v8::Local<v8::FunctionTemplate> target,
                             int flags) {
   env->SetProtoMethod(target, "setBlocking", SetBlocking);
+  env->SetProtoMethod(target, "setIdleTimeout", SetIdleTimeout);
+  env->SetProtoMethod(target, "setReadBuffer", SetReadBuffer);
+  env->SetProtoMethod(target, "setWriteCoalescing", SetWriteCoalescing);
+  env->SetProtoMethod(target, "sendFile", SendFile);
   StreamBase::AddMethods<StreamWrap>(env, target, flags);
 }
 
@@ -140,7 +202,8 @@ bool StreamWrap::IsIPCPipe() {
 void StreamWrap::UpdateWriteQueueSize() {
   HandleScope scope(env()->isolate());
   Local<Integer> write_queue_size =
-      Integer::NewFromUnsigned(env()->isolate(), stream()->write_queue_size);
+      Integer::NewFromUnsigned(env()->isolate(),
+                               stream()->write_queue_size + coalesced_bytes_);
   object()->Set(env()->write_queue_size_string(), write_queue_size);
 }
 
@@ -169,7 +232,18 @@ void StreamWrap::OnAlloc(uv_handle_t* handle,
 
 
 void StreamWrap::OnAllocImpl(size_t size, uv_buf_t* buf, void* ctx) {
-  buf->base = node::Malloc(size);
+  StreamWrap* wrap = static_cast<StreamWrap*>(ctx);
+
+  if (wrap->read_buffer_data_ != nullptr) {
+    // Start over at the front once the previous reads have filled it up.
+    if (wrap->read_buffer_offset_ == wrap->read_buffer_length_)
+      wrap->read_buffer_offset_ = 0;
+    buf->base = wrap->read_buffer_data_ + wrap->read_buffer_offset_;
+    buf->len = wrap->read_buffer_length_ - wrap->read_buffer_offset_;
+    return;
+  }
+
+  buf->base = wrap->env()->stream_read_slab_allocator()->Allocate(size);
   buf->len = size;
 }
 
@@ -195,6 +269,18 @@ static Local<Object> AcceptHandle(Environment* env, StreamWrap* parent) {
 }
 
 
+static Local<Object> AcceptPendingHandle(Environment* env,
+                                         StreamWrap* parent,
+                                         uv_handle_type pending) {
+  if (pending == UV_TCP)
+    return AcceptHandle<TCPWrap, uv_tcp_t>(env, parent);
+  if (pending == UV_NAMED_PIPE)
+    return AcceptHandle<PipeWrap, uv_pipe_t>(env, parent);
+  CHECK_EQ(pending, UV_UDP);
+  return AcceptHandle<UDPWrap, uv_udp_t>(env, parent);
+}
+
+
 void StreamWrap::OnReadImpl(ssize_t nread,
                             const uv_buf_t* buf,
                             uv_handle_type pending,
@@ -205,35 +291,54 @@ void StreamWrap::OnReadImpl(ssize_t nread,
   Context::Scope context_scope(env->context());
 
   Local<Object> pending_obj;
+  SlabAllocator* allocator = env->stream_read_slab_allocator();
+  const bool user_buffer = wrap->read_buffer_data_ != nullptr;
 
   if (nread < 0)  {
-    if (buf->base != nullptr)
-      free(buf->base);
+    if (buf->base != nullptr && !user_buffer)
+      allocator->Release(buf->base);
     wrap->EmitData(nread, Local<Object>(), pending_obj);
     return;
   }
 
   if (nread == 0) {
-    if (buf->base != nullptr)
-      free(buf->base);
+    if (buf->base != nullptr && !user_buffer)
+      allocator->Release(buf->base);
     return;
   }
 
   CHECK_LE(static_cast<size_t>(nread), buf->len);
-  char* base = node::Realloc(buf->base, nread);
-
-  if (pending == UV_TCP) {
-    pending_obj = AcceptHandle<TCPWrap, uv_tcp_t>(env, wrap);
-  } else if (pending == UV_NAMED_PIPE) {
-    pending_obj = AcceptHandle<PipeWrap, uv_pipe_t>(env, wrap);
-  } else if (pending == UV_UDP) {
-    pending_obj = AcceptHandle<UDPWrap, uv_udp_t>(env, wrap);
+  Local<Value> data;
+  if (user_buffer) {
+    const size_t offset = buf->base - wrap->read_buffer_data_;
+    wrap->read_buffer_offset_ = offset + nread;
+    data = Integer::NewFromUnsigned(env->isolate(), offset);
   } else {
-    CHECK_EQ(pending, UV_UNKNOWN_HANDLE);
+    data = allocator->Shrink(buf->base, nread).ToLocalChecked();
   }
 
-  Local<Object> obj = Buffer::New(env, base, nread).ToLocalChecked();
-  wrap->EmitData(nread, obj, pending_obj);
+  if (pending != UV_UNKNOWN_HANDLE) {
+    pending_obj = AcceptPendingHandle(env, wrap, pending);
+
+    // A writeHandles() on the other end passes several handles with one
+    // message. libuv queues them all with the read, onread() gets them as
+    // an array.
+    uv_pipe_t* pipe = reinterpret_cast<uv_pipe_t*>(wrap->stream());
+    if (uv_pipe_pending_count(pipe) > 0) {
+      Local<Array> handles = Array::New(env->isolate());
+      handles->Set(0, pending_obj.IsEmpty() ?
+          Undefined(env->isolate()).As<Value>() : pending_obj.As<Value>());
+      for (uint32_t i = 1; uv_pipe_pending_count(pipe) > 0; i++) {
+        Local<Object> handle =
+            AcceptPendingHandle(env, wrap, uv_pipe_pending_type(pipe));
+        handles->Set(i, handle.IsEmpty() ?
+            Undefined(env->isolate()).As<Value>() : handle.As<Value>());
+      }
+      pending_obj = handles;
+    }
+  }
+
+  wrap->EmitData(nread, data, pending_obj);
 }
 
 
@@ -252,11 +357,18 @@ void StreamWrap::OnReadCommon(uv_stream_t* handle,
   if (nread > 0) {
     if (wrap->is_tcp()) {
       NODE_COUNT_NET_BYTES_RECV(nread);
+      counters::Add(counters::kNetBytesRead, nread);
     } else if (wrap->is_named_pipe()) {
       NODE_COUNT_PIPE_BYTES_RECV(nread);
+      counters::Add(counters::kPipeBytesRead, nread);
     }
   }
 
+  if (NODE_NET_STREAM_READ_ENABLED())
+    NODE_NET_STREAM_READ(wrap, wrap->GetFD(), static_cast<int64_t>(nread));
+
+  wrap->MarkActive();
+
   static_cast<StreamBase*>(wrap)->OnRead(nread, buf, pending);
 }
 
@@ -289,7 +401,373 @@ void StreamWrap::SetBlocking(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void StreamWrap::SetIdleTimeout(const FunctionCallbackInfo<Value>& args) {
+  StreamWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  CHECK(args[0]->IsUint32());
+  if (!wrap->IsAlive() || wrap->IsClosing())
+    return args.GetReturnValue().Set(UV_EINVAL);
+
+  const uint32_t timeout = args[0]->Uint32Value();
+  wrap->idle_timeout_ = timeout;
+  if (timeout == 0) {
+    if (wrap->idle_timer_ != nullptr)
+      uv_timer_stop(wrap->idle_timer_);
+    return args.GetReturnValue().Set(0);
+  }
+
+  if (wrap->idle_timer_ == nullptr) {
+    wrap->idle_timer_ = new uv_timer_t;
+    CHECK_EQ(0, uv_timer_init(wrap->env()->event_loop(), wrap->idle_timer_));
+    wrap->idle_timer_->data = wrap;
+    // Like the timers of socket.setTimeout() always were, this one doesn't
+    // keep the loop alive.
+    uv_unref(reinterpret_cast<uv_handle_t*>(wrap->idle_timer_));
+  }
+
+  // Setting the timeout counts as activity, and the new timeout applies
+  // from now on.
+  wrap->last_activity_ = uv_now(wrap->env()->event_loop());
+  uv_timer_start(wrap->idle_timer_, OnIdleTimer, timeout, 0);
+  args.GetReturnValue().Set(0);
+}
+
+
+void StreamWrap::MarkActive() {
+  if (idle_timeout_ == 0)
+    return;
+  last_activity_ = uv_now(env()->event_loop());
+  // The timer stops after ontimeout(), until the stream is active again.
+  if (!uv_is_active(reinterpret_cast<uv_handle_t*>(idle_timer_)))
+    uv_timer_start(idle_timer_, OnIdleTimer, idle_timeout_, 0);
+}
+
+
+void StreamWrap::OnIdleTimer(uv_timer_t* handle) {
+  StreamWrap* wrap = static_cast<StreamWrap*>(handle->data);
+  const uint64_t idle = uv_now(handle->loop) - wrap->last_activity_;
+  if (idle < wrap->idle_timeout_) {
+    uv_timer_start(handle, OnIdleTimer, wrap->idle_timeout_ - idle, 0);
+    return;
+  }
+
+  Environment* env = wrap->env();
+  HandleScope scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  wrap->MakeCallback(env->ontimeout_string(), 0, nullptr);
+}
+
+
+void StreamWrap::SetReadBuffer(const FunctionCallbackInfo<Value>& args) {
+  StreamWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  // Passing anything other than a non-empty buffer switches back to
+  // allocating a new Buffer per read. Setting a buffer again, even the same
+  // one, rewinds the next read to offset 0.
+  wrap->read_buffer_.Reset();
+  wrap->read_buffer_data_ = nullptr;
+  wrap->read_buffer_length_ = 0;
+  wrap->read_buffer_offset_ = 0;
+
+  if (!Buffer::HasInstance(args[0]) || Buffer::Length(args[0]) == 0)
+    return;
+
+  Local<Object> buffer = args[0].As<Object>();
+  wrap->read_buffer_.Reset(args.GetIsolate(), buffer);
+  wrap->read_buffer_data_ = Buffer::Data(buffer);
+  wrap->read_buffer_length_ = Buffer::Length(buffer);
+}
+
+
+void StreamWrap::SetWriteCoalescing(const FunctionCallbackInfo<Value>& args) {
+  StreamWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  CHECK(args[0]->IsUint32());
+  if (!wrap->IsAlive() || wrap->IsClosing())
+    return args.GetReturnValue().Set(UV_EINVAL);
+
+  const size_t limit = args[0]->Uint32Value();
+  if (limit > 0 && wrap->flush_check_ == nullptr) {
+    uv_loop_t* loop = wrap->env()->event_loop();
+    wrap->flush_check_ = new uv_check_t;
+    wrap->flush_idle_ = new uv_idle_t;
+    CHECK_EQ(0, uv_check_init(loop, wrap->flush_check_));
+    CHECK_EQ(0, uv_idle_init(loop, wrap->flush_idle_));
+    wrap->flush_check_->data = wrap;
+    // Held-back writes are flushed before close, so the flush handles
+    // never keep the loop alive by themselves.
+    uv_unref(reinterpret_cast<uv_handle_t*>(wrap->flush_check_));
+    uv_unref(reinterpret_cast<uv_handle_t*>(wrap->flush_idle_));
+  }
+
+  if (limit < wrap->coalesced_bytes_ || limit == 0)
+    wrap->FlushCoalescedWrites();
+  wrap->write_coalesce_limit_ = limit;
+  args.GetReturnValue().Set(0);
+}
+
+
+// Sends part of a file over a stream with sendfile(2). Each chunk is sent from
+// the thread pool, as reading the file may block, for as long as the socket
+// takes it. When its send buffer is full, the loop waits for the socket to
+// become writable before the rest of the chunk is queued again, so no pool
+// thread is held while the peer is slow. Progress is reported back to JS
+// after every chunk.
+//
+// The worker sends through, and the loop polls, a dup() of the stream's file
+// descriptor, so the descriptor number cannot be recycled under them if the
+// stream is closed in the meantime. Closing the stream cancels the transfer
+// at the next chunk, or right away while waiting for the socket.
+class SendFileWrap : public ReqWrap<uv_work_t> {
+ public:
+  SendFileWrap(Environment* env,
+               Local<Object> req_wrap_obj,
+               StreamWrap* stream,
+               int out_fd,
+               uv_file in_fd,
+               int64_t offset,
+               int64_t length)
+      : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_WRITEWRAP),
+        stream_(stream),
+        out_fd_(out_fd),
+        in_fd_(in_fd),
+        offset_(offset),
+        remaining_(length),
+        total_sent_(0),
+        chunk_sent_(0),
+        status_(0),
+        poll_initialized_(false) {
+    Wrap(req_wrap_obj, this);
+  }
+
+  ~SendFileWrap() override {
+#ifndef _WIN32
+    close(out_fd_);
+#endif
+  }
+
+  size_t self_size() const override { return sizeof(*this); }
+
+  int Queue() {
+    Dispatched();
+    return threadpool::QueueWork(env()->event_loop(),
+                                 req(),
+                                 threadpool::kFsWork,
+                                 threadpool::kLowPriority,
+                                 Work,
+                                 AfterWork,
+                                 NODE_THREADPOOL_TRACE_FS,
+                                 "fs.sendfile");
+  }
+
+  void Cancel() {
+    stream_ = nullptr;
+    if (poll_initialized_ &&
+        uv_is_active(reinterpret_cast<uv_handle_t*>(&poll_))) {
+      Finish(UV_ECANCELED);
+    }
+  }
+
+ private:
+  static const int64_t kChunkSize = 4 * 1024 * 1024;
+
+  static void Work(uv_work_t* req) {
+#ifndef _WIN32
+    SendFileWrap* w = ContainerOf(&SendFileWrap::req_, req);
+    const int64_t target =
+        w->remaining_ < kChunkSize ? w->remaining_ : kChunkSize;
+    w->chunk_sent_ = 0;
+    w->status_ = 0;
+
+    while (w->chunk_sent_ < target) {
+      uv_fs_t fs_req;
+      int r = uv_fs_sendfile(nullptr,
+                             &fs_req,
+                             w->out_fd_,
+                             w->in_fd_,
+                             w->offset_ + w->chunk_sent_,
+                             target - w->chunk_sent_,
+                             nullptr);
+      uv_fs_req_cleanup(&fs_req);
+
+      if (r > 0) {
+        w->chunk_sent_ += r;
+        continue;
+      }
+
+      // The file is shorter than requested when nothing could be sent.
+      // UV_EAGAIN, from the non-blocking socket, sends the loop waiting.
+      w->status_ = r == 0 ? UV_EOF : r;
+      return;
+    }
+#endif
+  }
+
+  static void AfterWork(uv_work_t* req, int status) {
+    SendFileWrap* w = ContainerOf(&SendFileWrap::req_, req);
+    Environment* env = w->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    w->offset_ += w->chunk_sent_;
+    w->remaining_ -= w->chunk_sent_;
+    w->total_sent_ += w->chunk_sent_;
+    if (w->chunk_sent_ > 0 && w->stream_ != nullptr)
+      w->stream_->MarkActive();
+
+    int err = status != 0 ? status : w->status_;
+    const bool would_block = err == UV_EAGAIN;
+    if (would_block)
+      err = 0;
+    if (err == 0 && w->stream_ == nullptr)
+      err = UV_ECANCELED;
+
+    if (err == 0 && w->remaining_ > 0) {
+      Local<Value> argv[] = {
+        Number::New(env->isolate(), static_cast<double>(w->total_sent_))
+      };
+      Local<Object> req_wrap_obj = w->object();
+      if (w->chunk_sent_ > 0 &&
+          req_wrap_obj->Has(env->context(),
+                            env->onprogress_string()).FromJust()) {
+        w->MakeCallback(env->onprogress_string(), arraysize(argv), argv);
+      }
+
+      // The progress callback may have closed the stream.
+      if (w->stream_ == nullptr)
+        err = UV_ECANCELED;
+      else if (would_block)
+        err = w->PollWritable();
+      else
+        err = w->Queue();
+      if (err == 0)
+        return;
+    }
+
+    w->Finish(err);
+  }
+
+  int PollWritable() {
+    if (!poll_initialized_) {
+      int err = uv_poll_init(env()->event_loop(), &poll_, out_fd_);
+      if (err != 0)
+        return err;
+      poll_initialized_ = true;
+    }
+    return uv_poll_start(&poll_, UV_WRITABLE, OnWritable);
+  }
+
+  static void OnWritable(uv_poll_t* handle, int status, int events) {
+    SendFileWrap* w = ContainerOf(&SendFileWrap::poll_, handle);
+    uv_poll_stop(handle);
+    int err = status != 0 ? status : w->Queue();
+    if (err != 0)
+      w->Finish(err);
+  }
+
+  // Completes the request, once the poll handle, if any, is closed.
+  void Finish(int status) {
+    if (stream_ != nullptr) {
+      stream_->send_file_ = nullptr;
+      stream_ = nullptr;
+    }
+    status_ = status;
+    if (!poll_initialized_) {
+      Complete();
+      return;
+    }
+    uv_close(reinterpret_cast<uv_handle_t*>(&poll_), [](uv_handle_t* handle) {
+      SendFileWrap* w =
+          ContainerOf(&SendFileWrap::poll_,
+                      reinterpret_cast<uv_poll_t*>(handle));
+      HandleScope handle_scope(w->env()->isolate());
+      Context::Scope context_scope(w->env()->context());
+      w->Complete();
+    });
+  }
+
+  void Complete() {
+    Environment* env = this->env();
+    Local<Value> argv[] = {
+      Integer::New(env->isolate(), status_),
+      Number::New(env->isolate(), static_cast<double>(total_sent_))
+    };
+    MakeCallback(env->oncomplete_string(), arraysize(argv), argv);
+    delete this;
+  }
+
+  StreamWrap* stream_;
+  const int out_fd_;
+  const uv_file in_fd_;
+  int64_t offset_;
+  int64_t remaining_;
+  int64_t total_sent_;
+  int64_t chunk_sent_;
+  int status_;
+  bool poll_initialized_;
+  uv_poll_t poll_;
+};
+
+
+void StreamWrap::SendFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  StreamWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsInt32());
+  CHECK(args[2]->IsNumber());
+  CHECK(args[3]->IsNumber());
+
+#ifdef _WIN32
+  return args.GetReturnValue().Set(UV_ENOSYS);
+#else
+  if (!wrap->IsAlive() || wrap->IsClosing())
+    return args.GetReturnValue().Set(UV_EINVAL);
+
+  // The file data must not overtake, or interleave with, earlier writes.
+  wrap->FlushCoalescedWrites();
+  if (wrap->send_file_ != nullptr || wrap->stream()->write_queue_size != 0)
+    return args.GetReturnValue().Set(UV_EBUSY);
+
+  const int64_t offset = args[2]->IntegerValue();
+  const int64_t length = args[3]->IntegerValue();
+  if (offset < 0 || length < 0)
+    return args.GetReturnValue().Set(UV_EINVAL);
+
+  int fd = wrap->GetFD();
+  if (fd < 0)
+    return args.GetReturnValue().Set(UV_EBADF);
+  int out_fd = dup(fd);
+  if (out_fd < 0)
+    return args.GetReturnValue().Set(-errno);
+
+  SendFileWrap* req_wrap = new SendFileWrap(env,
+                                            args[0].As<Object>(),
+                                            wrap,
+                                            out_fd,
+                                            args[1]->Int32Value(),
+                                            offset,
+                                            length);
+  int err = req_wrap->Queue();
+  if (err != 0) {
+    delete req_wrap;
+    return args.GetReturnValue().Set(err);
+  }
+
+  wrap->send_file_ = req_wrap;
+  args.GetReturnValue().Set(0);
+#endif
+}
+
+
 int StreamWrap::DoShutdown(ShutdownWrap* req_wrap) {
+  if (send_file_ != nullptr)
+    return UV_EBUSY;
+  FlushCoalescedWrites();
   int err;
   err = uv_shutdown(req_wrap->req(), stream(), AfterShutdown);
   req_wrap->Dispatched();
@@ -316,12 +794,30 @@ int StreamWrap::DoTryWrite(uv_buf_t** bufs, size_t* count) {
   uv_buf_t* vbufs = *bufs;
   size_t vcount = *count;
 
+  if (send_file_ != nullptr)
+    return UV_EBUSY;
+
+  MarkActive();
+
+  // Leave small writes alone so that DoWrite() can coalesce them.
+  if (write_coalesce_limit_ > 0) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < vcount; i++)
+      bytes += vbufs[i].len;
+    if (coalesced_bytes_ + bytes <= write_coalesce_limit_ && !IsClosing())
+      return 0;
+    FlushCoalescedWrites();
+  }
+
   err = uv_try_write(stream(), vbufs, vcount);
   if (err == UV_ENOSYS || err == UV_EAGAIN)
     return 0;
   if (err < 0)
     return err;
 
+  if (NODE_NET_STREAM_WRITE_ENABLED())
+    NODE_NET_STREAM_WRITE(this, GetFD(), static_cast<int64_t>(err));
+
   // Slice off the buffers: skip all written buffers and slice the one that
   // was partially written.
   written = err;
@@ -346,10 +842,105 @@ int StreamWrap::DoTryWrite(uv_buf_t** bufs, size_t* count) {
 }
 
 
+// Like DoTryWrite(), but with a single sendmsg() that passes all of |handles|
+// along with the data. Nothing is sent unless the data can go out right
+// away, ahead of nothing else.
+int StreamWrap::DoTrySendHandles(uv_buf_t** bufs,
+                                 size_t* count,
+                                 uv_handle_t** handles,
+                                 size_t handle_count) {
+#ifdef _WIN32
+  return UV_ENOSYS;
+#else
+  if (!is_named_pipe_ipc() || IsClosing())
+    return UV_EINVAL;
+  if (send_file_ != nullptr)
+    return UV_EBUSY;
+  CHECK_LE(handle_count, kMaxSendHandles);
+
+  // Like sendFile(), this must not overtake earlier writes.
+  FlushCoalescedWrites();
+  if (stream()->write_queue_size != 0)
+    return UV_EAGAIN;
+
+  int fds[kMaxSendHandles];
+  for (size_t i = 0; i < handle_count; i++) {
+    int err = uv_fileno(handles[i], &fds[i]);
+    if (err != 0)
+      return err;
+  }
+
+  union {
+    char data[CMSG_SPACE(sizeof(fds))];
+    struct cmsghdr alignment;
+  } control;
+  memset(&control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  // uv_buf_t is laid out like struct iovec on Unix.
+  msg.msg_iov = reinterpret_cast<struct iovec*>(*bufs);
+  msg.msg_iovlen = *count;
+  msg.msg_control = control.data;
+  msg.msg_controllen = CMSG_SPACE(sizeof(fds[0]) * handle_count);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(fds[0]) * handle_count);
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(fds[0]) * handle_count);
+
+  ssize_t written;
+  do {
+    written = sendmsg(GetFD(), &msg, 0);
+  } while (written == -1 && errno == EINTR);
+  if (written == -1) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+      return UV_EAGAIN;
+    return -errno;
+  }
+
+  if (NODE_NET_STREAM_WRITE_ENABLED())
+    NODE_NET_STREAM_WRITE(this, GetFD(), static_cast<int64_t>(written));
+
+  // The handles went out with the first byte. Slice off what was written,
+  // the rest can follow like any other write.
+  uv_buf_t* vbufs = *bufs;
+  size_t vcount = *count;
+  size_t left = written;
+  for (; vcount > 0; vbufs++, vcount--) {
+    if (vbufs[0].len > left) {
+      vbufs[0].base += left;
+      vbufs[0].len -= left;
+      break;
+    }
+    left -= vbufs[0].len;
+  }
+
+  *bufs = vbufs;
+  *count = vcount;
+
+  return 0;
+#endif
+}
+
+
 int StreamWrap::DoWrite(WriteWrap* w,
                         uv_buf_t* bufs,
                         size_t count,
                         uv_stream_t* send_handle) {
+  if (send_file_ != nullptr) {
+    w->Dispatched();
+    return UV_EBUSY;
+  }
+
+  MarkActive();
+
+  if (send_handle == nullptr && CoalesceWrite(w, bufs, count))
+    return 0;
+
+  FlushCoalescedWrites();
+
   int r;
   if (send_handle == nullptr) {
     r = uv_write(w->req(), stream(), bufs, count, AfterWrite);
@@ -363,9 +954,13 @@ int StreamWrap::DoWrite(WriteWrap* w,
       bytes += bufs[i].len;
     if (stream()->type == UV_TCP) {
       NODE_COUNT_NET_BYTES_SENT(bytes);
+      counters::Add(counters::kNetBytesWritten, bytes);
     } else if (stream()->type == UV_NAMED_PIPE) {
       NODE_COUNT_PIPE_BYTES_SENT(bytes);
+      counters::Add(counters::kPipeBytesWritten, bytes);
     }
+    if (NODE_NET_STREAM_WRITE_ENABLED())
+      NODE_NET_STREAM_WRITE(this, GetFD(), static_cast<int64_t>(bytes));
   }
 
   w->Dispatched();
@@ -384,8 +979,136 @@ void StreamWrap::AfterWrite(uv_write_t* req, int status) {
 }
 
 
+struct StreamWrap::CoalescedWrite {
+  uv_write_t req;
+  std::vector<WriteWrap*> reqs;
+};
+
+
+bool StreamWrap::CoalesceWrite(WriteWrap* w, uv_buf_t* bufs, size_t count) {
+  if (write_coalesce_limit_ == 0 || IsClosing())
+    return false;
+
+  size_t bytes = 0;
+  for (size_t i = 0; i < count; i++)
+    bytes += bufs[i].len;
+  if (coalesced_bytes_ + bytes > write_coalesce_limit_)
+    return false;
+
+  // The data stays where the caller put it: in the request's extra storage
+  // or in a Buffer that the request object keeps alive.
+  coalesced_reqs_.push_back(w);
+  coalesced_bufs_.insert(coalesced_bufs_.end(), bufs, bufs + count);
+  coalesced_bytes_ += bytes;
+  w->Dispatched();
+
+  if (coalesced_reqs_.size() == 1) {
+    uv_check_start(flush_check_, [](uv_check_t* handle) {
+      StreamWrap* wrap = static_cast<StreamWrap*>(handle->data);
+      HandleScope scope(wrap->env()->isolate());
+      Context::Scope context_scope(wrap->env()->context());
+      wrap->FlushCoalescedWrites();
+    });
+    // Keep the loop from blocking in poll while writes are held back.
+    uv_idle_start(flush_idle_, [](uv_idle_t*) {});
+  }
+
+  UpdateWriteQueueSize();
+  return true;
+}
+
+
+void StreamWrap::FlushCoalescedWrites() {
+  if (coalesced_reqs_.empty())
+    return;
+
+  uv_check_stop(flush_check_);
+  uv_idle_stop(flush_idle_);
+
+  CoalescedWrite* batch = new CoalescedWrite;
+  batch->reqs.swap(coalesced_reqs_);
+  std::vector<uv_buf_t> bufs;
+  bufs.swap(coalesced_bufs_);
+  coalesced_bytes_ = 0;
+
+  // uv_write() copies the buffer list and tries to write right away, so the
+  // whole batch costs at most one write syscall up front.
+  int err = uv_write(&batch->req,
+                     stream(),
+                     bufs.data(),
+                     bufs.size(),
+                     AfterCoalescedWrite);
+  if (err == 0) {
+    size_t bytes = 0;
+    for (const uv_buf_t& buf : bufs)
+      bytes += buf.len;
+    if (stream()->type == UV_TCP) {
+      NODE_COUNT_NET_BYTES_SENT(bytes);
+      counters::Add(counters::kNetBytesWritten, bytes);
+    } else if (stream()->type == UV_NAMED_PIPE) {
+      NODE_COUNT_PIPE_BYTES_SENT(bytes);
+      counters::Add(counters::kPipeBytesWritten, bytes);
+    }
+    if (NODE_NET_STREAM_WRITE_ENABLED())
+      NODE_NET_STREAM_WRITE(this, GetFD(), static_cast<int64_t>(bytes));
+    UpdateWriteQueueSize();
+    return;
+  }
+
+  // uv_write() only fails up front when the stream cannot be written to at
+  // all. Fail every request in the batch.
+  HandleScope scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+  for (WriteWrap* w : batch->reqs)
+    w->Done(err);
+  delete batch;
+}
+
+
+void StreamWrap::AfterCoalescedWrite(uv_write_t* req, int status) {
+  CoalescedWrite* batch = ContainerOf(&CoalescedWrite::req, req);
+  for (WriteWrap* w : batch->reqs) {
+    HandleScope scope(w->env()->isolate());
+    Context::Scope context_scope(w->env()->context());
+    w->Done(status);
+  }
+  delete batch;
+}
+
+
+void StreamWrap::OnBeforeClose() {
+  FlushCoalescedWrites();
+
+  if (send_file_ != nullptr)
+    send_file_->Cancel();
+
+  if (flush_check_ != nullptr) {
+    uv_close(reinterpret_cast<uv_handle_t*>(flush_check_),
+             [](uv_handle_t* handle) {
+      delete reinterpret_cast<uv_check_t*>(handle);
+    });
+    uv_close(reinterpret_cast<uv_handle_t*>(flush_idle_),
+             [](uv_handle_t* handle) {
+      delete reinterpret_cast<uv_idle_t*>(handle);
+    });
+    flush_check_ = nullptr;
+    flush_idle_ = nullptr;
+  }
+
+  if (idle_timer_ != nullptr) {
+    uv_close(reinterpret_cast<uv_handle_t*>(idle_timer_),
+             [](uv_handle_t* handle) {
+      delete reinterpret_cast<uv_timer_t*>(handle);
+    });
+    idle_timer_ = nullptr;
+    idle_timeout_ = 0;
+  }
+}
+
+
 void StreamWrap::OnAfterWriteImpl(WriteWrap* w, void* ctx) {
   StreamWrap* wrap = static_cast<StreamWrap*>(ctx);
+  wrap->MarkActive();
   wrap->UpdateWriteQueueSize();
 }
 
@@ -31,9 +31,12 @@
 #include "string_bytes.h"
 #include "v8.h"
 
+#include <vector>
+
 namespace node {
 
 // Forward declaration
+class SendFileWrap;
 class StreamWrap;
 
 class StreamWrap : public HandleWrap, public StreamBase {
@@ -55,6 +58,10 @@ class StreamWrap : public HandleWrap, public StreamBase {
   // Resource implementation
   int DoShutdown(ShutdownWrap* req_wrap) override;
   int DoTryWrite(uv_buf_t** bufs, size_t* count) override;
+  int DoTrySendHandles(uv_buf_t** bufs,
+                       size_t* count,
+                       uv_handle_t** handles,
+                       size_t handle_count) override;
   int DoWrite(WriteWrap* w,
               uv_buf_t* bufs,
               size_t count,
@@ -85,10 +92,12 @@ class StreamWrap : public HandleWrap, public StreamBase {
              AsyncWrap* parent = nullptr);
 
   ~StreamWrap() {
+    read_buffer_.Reset();
   }
 
   AsyncWrap* GetAsyncWrap() override;
   void UpdateWriteQueueSize();
+  void OnBeforeClose() override;
 
   static void AddMethods(Environment* env,
                          v8::Local<v8::FunctionTemplate> target,
@@ -96,6 +105,19 @@ class StreamWrap : public HandleWrap, public StreamBase {
 
  private:
   static void SetBlocking(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetIdleTimeout(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetReadBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetWriteCoalescing(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendFile(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  // Notes that the stream read or wrote something, for setIdleTimeout().
+  inline void MarkActive();
+  static void OnIdleTimer(uv_timer_t* handle);
+
+  struct CoalescedWrite;
+  bool CoalesceWrite(WriteWrap* w, uv_buf_t* bufs, size_t count);
+  void FlushCoalescedWrites();
 
   // Callbacks for libuv
   static void OnAlloc(uv_handle_t* handle,
@@ -110,6 +132,7 @@ class StreamWrap : public HandleWrap, public StreamBase {
                            const uv_buf_t* buf,
                            uv_handle_type pending);
   static void AfterWrite(uv_write_t* req, int status);
+  static void AfterCoalescedWrite(uv_write_t* req, int status);
   static void AfterShutdown(uv_shutdown_t* req, int status);
 
   // Resource interface implementation
@@ -121,6 +144,37 @@ class StreamWrap : public HandleWrap, public StreamBase {
                          void* ctx);
 
   uv_stream_t* const stream_;
+
+  // Set through setReadBuffer(). While set, reads land in this buffer and
+  // onread() receives the offset of the data instead of a new Buffer.
+  v8::Persistent<v8::Object> read_buffer_;
+  char* read_buffer_data_;
+  size_t read_buffer_length_;
+  size_t read_buffer_offset_;
+
+  // Set through setWriteCoalescing(). While non-zero, small writes are held
+  // back until the end of the loop iteration, or until they add up to this
+  // many bytes, and then go out together in a single uv_write().
+  size_t write_coalesce_limit_;
+  size_t coalesced_bytes_;
+  std::vector<WriteWrap*> coalesced_reqs_;
+  std::vector<uv_buf_t> coalesced_bufs_;
+  uv_check_t* flush_check_;
+  uv_idle_t* flush_idle_;
+
+  // Set through setIdleTimeout(). While non-zero, ontimeout() is called
+  // once nothing has been read or written for this many milliseconds.
+  // Reads and writes only note the time; the timer checks it when it
+  // expires and starts over for what is left.
+  uint64_t idle_timeout_;
+  uint64_t last_activity_;
+  uv_timer_t* idle_timer_;
+
+  // The sendFile() transfer in progress, if any. Regular writes and shutdown
+  // fail with UV_EBUSY until it completes.
+  SendFileWrap* send_file_;
+
+  friend class SendFileWrap;
 };
 
 
@@ -22,6 +22,7 @@
 #include "string_bytes.h"
 
 #include "base64.h"
+#include "node_cpu.h"
 #include "node.h"
 #include "node_buffer.h"
 #include "v8.h"
@@ -189,13 +190,118 @@ static inline unsigned unhex(uint8_t x) {
   return unhex_table[x];
 }
 
+// Vectorized hex decoding of one byte strings. Stops at the first block of
+// 32 characters with a character that isn't a hex digit in it and returns
+// the number of bytes written, the scalar code takes it from there.
+#if NODE_SIMD_X86
+NODE_SIMD_TARGET("ssse3")
+static inline bool unhex_block_ssse3(__m128i in, __m128i* values) {
+  const __m128i digit =
+      _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), in));
+  const __m128i lower =
+      _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), in));
+  const __m128i upper =
+      _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('F' + 1), in));
+  if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(digit, lower), upper)) !=
+      0xFFFF) {
+    return false;
+  }
+  __m128i shift = _mm_and_si128(digit, _mm_set1_epi8(-'0'));
+  shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(10 - 'a')));
+  shift = _mm_or_si128(shift, _mm_and_si128(upper, _mm_set1_epi8(10 - 'A')));
+  // Every pair of nibbles into a 16 bit lane as high * 16 + low.
+  *values = _mm_maddubs_epi16(_mm_add_epi8(in, shift),
+                              _mm_set1_epi16(0x0110));
+  return true;
+}
+
+
+NODE_SIMD_TARGET("ssse3")
+static size_t hex_decode_ssse3(char* buf, size_t len,
+                               const char* src, size_t srcLen) {
+  size_t i = 0;
+  while (i + 16 <= len && (i + 16) * 2 <= srcLen) {
+    __m128i lo;
+    __m128i hi;
+    const __m128i* in = reinterpret_cast<const __m128i*>(src + i * 2);
+    if (!unhex_block_ssse3(_mm_loadu_si128(in + 0), &lo) ||
+        !unhex_block_ssse3(_mm_loadu_si128(in + 1), &hi)) {
+      break;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(buf + i),
+                     _mm_packus_epi16(lo, hi));
+    i += 16;
+  }
+  return i;
+}
+#elif NODE_SIMD_NEON
+static inline bool unhex_block_neon(uint8x16_t in, uint8x16_t* values) {
+  const uint8x16_t digit = vcltq_u8(vsubq_u8(in, vdupq_n_u8('0')),
+                                    vdupq_n_u8(10));
+  const uint8x16_t lower = vcltq_u8(vsubq_u8(in, vdupq_n_u8('a')),
+                                    vdupq_n_u8(6));
+  const uint8x16_t upper = vcltq_u8(vsubq_u8(in, vdupq_n_u8('A')),
+                                    vdupq_n_u8(6));
+  if (vminvq_u8(vorrq_u8(vorrq_u8(digit, lower), upper)) == 0)
+    return false;
+  // Offsets wrap around modulo 256.
+  uint8x16_t shift = vandq_u8(digit, vdupq_n_u8(static_cast<uint8_t>(-'0')));
+  shift = vorrq_u8(shift, vandq_u8(lower, vdupq_n_u8(10 - 'a')));
+  shift = vorrq_u8(shift, vandq_u8(upper, vdupq_n_u8(10 - 'A')));
+  *values = vaddq_u8(in, shift);
+  return true;
+}
+
+
+static size_t hex_decode_neon(char* buf, size_t len,
+                              const char* src, size_t srcLen) {
+  uint8_t* out = reinterpret_cast<uint8_t*>(buf);
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+  size_t i = 0;
+  while (i + 16 <= len && (i + 16) * 2 <= srcLen) {
+    // Splits the high and the low nibble characters apart.
+    const uint8x16x2_t chars = vld2q_u8(in + i * 2);
+    uint8x16_t hi;
+    uint8x16_t lo;
+    if (!unhex_block_neon(chars.val[0], &hi) ||
+        !unhex_block_neon(chars.val[1], &lo)) {
+      break;
+    }
+    vst1q_u8(out + i, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    i += 16;
+  }
+  return i;
+}
+#endif
+
+
+static size_t hex_decode_simd(char* buf, size_t len,
+                              const char* src, size_t srcLen) {
+#if NODE_SIMD_X86
+  if (cpu::GetLevel() >= cpu::kSSSE3)
+    return hex_decode_ssse3(buf, len, src, srcLen);
+  return 0;
+#elif NODE_SIMD_NEON
+  return hex_decode_neon(buf, len, src, srcLen);
+#else
+  return 0;
+#endif
+}
+
+
 template <typename TypeName>
 static size_t hex_decode(char* buf,
                          size_t len,
                          const TypeName* src,
                          const size_t srcLen) {
-  size_t i;
-  for (i = 0; i < len && i * 2 + 1 < srcLen; ++i) {
+  size_t i = 0;
+  if (sizeof(TypeName) == 1) {
+    i = hex_decode_simd(buf, len, reinterpret_cast<const char*>(src), srcLen);
+  }
+  for (; i < len && i * 2 + 1 < srcLen; ++i) {
     unsigned a = unhex(src[i * 2 + 0]);
     unsigned b = unhex(src[i * 2 + 1]);
     if (!~a || !~b)
@@ -207,6 +313,124 @@ static size_t hex_decode(char* buf,
 }
 
 
+// Returns how many bytes at the start of |src|, in whole vectors, are known
+// to be ASCII. What's left is for the word at a time loop below.
+static size_t ascii_prefix_length(const char* src, size_t len) {
+  size_t i = 0;
+#if NODE_SIMD_SSE2
+  while (i + 64 <= len) {
+    const __m128i* in = reinterpret_cast<const __m128i*>(src + i);
+    const __m128i bits =
+        _mm_or_si128(_mm_or_si128(_mm_loadu_si128(in + 0),
+                                  _mm_loadu_si128(in + 1)),
+                     _mm_or_si128(_mm_loadu_si128(in + 2),
+                                  _mm_loadu_si128(in + 3)));
+    if (_mm_movemask_epi8(bits) != 0)
+      break;
+    i += 64;
+  }
+#elif NODE_SIMD_NEON
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+  while (i + 64 <= len) {
+    const uint8x16_t bits =
+        vorrq_u8(vorrq_u8(vld1q_u8(in + i), vld1q_u8(in + i + 16)),
+                 vorrq_u8(vld1q_u8(in + i + 32), vld1q_u8(in + i + 48)));
+    if (vmaxvq_u8(bits) >= 0x80)
+      break;
+    i += 64;
+  }
+#endif
+  return i;
+}
+
+
+// Writes Latin-1 text to |dst| as UTF-16 in host byte order, a vector at a
+// time. |dst| need not be aligned.
+static void widen_latin1(const uint8_t* src, size_t len, char* dst) {
+  size_t i = 0;
+#if NODE_SIMD_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  while (i + 16 <= len) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i* out = reinterpret_cast<__m128i*>(dst + i * 2);
+    _mm_storeu_si128(out + 0, _mm_unpacklo_epi8(in, zero));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(in, zero));
+    i += 16;
+  }
+#elif NODE_SIMD_NEON
+  uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+  while (i + 16 <= len) {
+    uint8x16x2_t chars;
+    chars.val[0] = vld1q_u8(src + i);
+    chars.val[1] = vdupq_n_u8(0);
+    vst2q_u8(out + i * 2, chars);
+    i += 16;
+  }
+#endif
+  for (; i < len; i++) {
+    const uint16_t c = src[i];
+    memcpy(dst + i * 2, &c, sizeof(c));
+  }
+}
+
+
+// Writes Latin-1 text to |dst| as UTF-8, whole characters only, the way
+// String::WriteUtf8() does. Returns the number of bytes written.
+static size_t latin1_to_utf8(const uint8_t* src, size_t len,
+                             char* dst, size_t dstlen, size_t* nchars) {
+  size_t i = 0;
+  size_t k = 0;
+  for (; i < len; i++) {
+    const uint8_t c = src[i];
+    if (c < 0x80) {
+      if (k == dstlen)
+        break;
+      dst[k++] = c;
+    } else {
+      if (dstlen - k < 2)
+        break;
+      dst[k++] = static_cast<char>(0xC0 | (c >> 6));
+      dst[k++] = static_cast<char>(0x80 | (c & 0x3F));
+    }
+  }
+  *nchars = i;
+  return k;
+}
+
+
+// One byte strings are Latin-1, which is its own UTF-8 for as long as it's
+// ASCII. The characters are copied straight to |buf| and only the part after
+// the first non-ASCII one is transcoded.
+static size_t WriteOneByteAsUtf8(char* buf,
+                                 size_t buflen,
+                                 Local<String> str,
+                                 int flags,
+                                 int* chars_written) {
+  uint8_t* const dst = reinterpret_cast<uint8_t*>(buf);
+  const size_t n = str->WriteOneByte(dst, 0, buflen, flags);
+  size_t ascii = ascii_prefix_length(buf, n);
+  while (ascii < n && dst[ascii] < 0x80)
+    ascii++;
+
+  size_t nbytes = ascii;
+  size_t nchars = ascii;
+  if (ascii < n) {
+    // UTF-8 takes up more room than Latin-1, so the rest is transcoded from
+    // a copy.
+    std::vector<uint8_t> rest(dst + ascii, dst + n);
+    size_t rest_chars;
+    nbytes += latin1_to_utf8(&rest[0], rest.size(),
+                             buf + ascii, buflen - ascii, &rest_chars);
+    nchars += rest_chars;
+  }
+
+  if (chars_written != nullptr)
+    *chars_written = static_cast<int>(nchars);
+  return nbytes;
+}
+
+
 bool StringBytes::GetExternalParts(Isolate* isolate,
                                    Local<Value> val,
                                    const char** data,
@@ -318,7 +542,11 @@ size_t StringBytes::Write(Isolate* isolate,
 
     case BUFFER:
     case UTF8:
-      nbytes = str->WriteUtf8(buf, buflen, chars_written, flags);
+      if (str->IsOneByte()) {
+        nbytes = WriteOneByteAsUtf8(buf, buflen, str, flags, chars_written);
+      } else {
+        nbytes = str->WriteUtf8(buf, buflen, chars_written, flags);
+      }
       break;
 
     case UCS2: {
@@ -327,6 +555,14 @@ size_t StringBytes::Write(Isolate* isolate,
       if (is_extern && !str->IsOneByte()) {
         memcpy(buf, data, nbytes);
         nchars = nbytes / sizeof(uint16_t);
+      } else if (is_extern) {
+        // Widened straight into |buf|, which WriteUCS2() can only do through
+        // an aligned copy when |buf| is not aligned.
+        nchars = external_nbytes;
+        if (nchars > buflen / sizeof(uint16_t))
+          nchars = buflen / sizeof(uint16_t);
+        widen_latin1(reinterpret_cast<const uint8_t*>(data), nchars, buf);
+        nbytes = nchars * sizeof(uint16_t);
       } else {
         nbytes = WriteUCS2(buf, buflen, nbytes, data, str, flags, &nchars);
       }
@@ -500,6 +736,10 @@ static bool contains_non_ascii_slow(const char* buf, size_t len) {
 
 
 static bool contains_non_ascii(const char* src, size_t len) {
+  const size_t ascii = ascii_prefix_length(src, len);
+  src += ascii;
+  len -= ascii;
+
   if (len < 16) {
     return contains_non_ascii_slow(src, len);
   }
@@ -541,6 +781,139 @@ static bool contains_non_ascii(const char* src, size_t len) {
 }
 
 
+// Copies |src| to |dst| as Latin-1 for as long as every character fits in a
+// byte, and returns how many characters were copied.
+static size_t narrow_latin1(const uint16_t* src, size_t len, char* dst) {
+  size_t i = 0;
+#if NODE_SIMD_SSE2
+  const __m128i high = _mm_set1_epi16(static_cast<int16_t>(0xff00));
+  while (i + 16 <= len) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+    const __m128i wide = _mm_and_si128(_mm_or_si128(a, b), high);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(wide, _mm_setzero_si128())) != 0xFFFF)
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packus_epi16(a, b));
+    i += 16;
+  }
+#elif NODE_SIMD_NEON
+  uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+  while (i + 16 <= len) {
+    const uint16x8_t a = vld1q_u16(src + i);
+    const uint16x8_t b = vld1q_u16(src + i + 8);
+    if (vmaxvq_u16(vorrq_u16(a, b)) > 0xff)
+      break;
+    vst1q_u8(out + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    i += 16;
+  }
+#endif
+  for (; i < len && src[i] < 0x100; i++)
+    dst[i] = static_cast<char>(src[i]);
+  return i;
+}
+
+
+// Decodes UTF-8 to UTF-16, runs of ASCII a vector at a time. |dst| needs
+// room for |len| characters. Returns false for anything that isn't well
+// formed UTF-8 so that V8 can substitute U+FFFD the way it always has.
+static bool utf8_to_utf16(const uint8_t* src, size_t len, uint16_t* dst,
+                          size_t* nchars, bool* latin1) {
+  size_t i = 0;
+  size_t k = 0;
+  unsigned all = 0;
+  while (i < len) {
+#if NODE_SIMD_SSE2
+    if (i + 16 <= len) {
+      const __m128i in =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      if (_mm_movemask_epi8(in) == 0) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i* out = reinterpret_cast<__m128i*>(dst + k);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi8(in, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(in, zero));
+        i += 16;
+        k += 16;
+        continue;
+      }
+    }
+#elif NODE_SIMD_NEON
+    if (i + 16 <= len) {
+      const uint8x16_t in = vld1q_u8(src + i);
+      if (vmaxvq_u8(in) < 0x80) {
+        vst1q_u16(dst + k, vmovl_u8(vget_low_u8(in)));
+        vst1q_u16(dst + k + 8, vmovl_u8(vget_high_u8(in)));
+        i += 16;
+        k += 16;
+        continue;
+      }
+    }
+#endif
+
+    // The rest of the block, one character at a time.
+    const size_t end = i + 16 < len ? i + 16 : len;
+    while (i < end) {
+      const unsigned c = src[i];
+      if (c < 0x80) {
+        dst[k++] = c;
+        i += 1;
+        continue;
+      }
+
+      // The well-formed byte sequences of table 3-7 in the Unicode standard,
+      // no overlong forms, surrogates or code points past U+10FFFF.
+      size_t n;
+      unsigned cp;
+      unsigned lo = 0x80;
+      unsigned hi = 0xBF;
+      if (c >= 0xC2 && c <= 0xDF) {
+        n = 2;
+        cp = c & 0x1F;
+      } else if (c >= 0xE0 && c <= 0xEF) {
+        n = 3;
+        cp = c & 0x0F;
+        if (c == 0xE0)
+          lo = 0xA0;
+        else if (c == 0xED)
+          hi = 0x9F;
+      } else if (c >= 0xF0 && c <= 0xF4) {
+        n = 4;
+        cp = c & 0x07;
+        if (c == 0xF0)
+          lo = 0x90;
+        else if (c == 0xF4)
+          hi = 0x8F;
+      } else {
+        return false;
+      }
+      if (len - i < n || src[i + 1] < lo || src[i + 1] > hi)
+        return false;
+      cp = (cp << 6) | (src[i + 1] & 0x3F);
+      for (size_t j = 2; j < n; j++) {
+        if ((src[i + j] & 0xC0) != 0x80)
+          return false;
+        cp = (cp << 6) | (src[i + j] & 0x3F);
+      }
+      i += n;
+      all |= cp;
+
+      if (cp >= 0x10000) {
+        cp -= 0x10000;
+        dst[k++] = static_cast<uint16_t>(0xD800 + (cp >> 10));
+        dst[k++] = static_cast<uint16_t>(0xDC00 + (cp & 0x3FF));
+      } else {
+        dst[k++] = static_cast<uint16_t>(cp);
+      }
+    }
+  }
+  *nchars = k;
+  *latin1 = all < 0x100;
+  return true;
+}
+
+
 static void force_ascii_slow(const char* src, char* dst, size_t len) {
   for (size_t i = 0; i < len; ++i) {
     dst[i] = src[i] & 0x7f;
@@ -593,13 +966,61 @@ static void force_ascii(const char* src, char* dst, size_t len) {
 }
 
 
+// Vectorized hex encoding, returns how many bytes of |src| it encoded.
+#if NODE_SIMD_X86
+NODE_SIMD_TARGET("ssse3")
+static size_t hex_encode_ssse3(const char* src, size_t slen, char* dst) {
+  const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+  while (i + 16 <= slen) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi = _mm_shuffle_epi8(
+        digits, _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+    const __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(in, nibble));
+    __m128i* out = reinterpret_cast<__m128i*>(dst + i * 2);
+    _mm_storeu_si128(out + 0, _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(hi, lo));
+    i += 16;
+  }
+  return i;
+}
+#elif NODE_SIMD_NEON
+static size_t hex_encode_neon(const char* src, size_t slen, char* dst) {
+  static const uint8_t hex[] = "0123456789abcdef";
+  const uint8x16_t digits = vld1q_u8(hex);
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+  uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+  size_t i = 0;
+  while (i + 16 <= slen) {
+    const uint8x16_t bytes = vld1q_u8(in + i);
+    uint8x16x2_t chars;
+    chars.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(bytes, 4));
+    chars.val[1] = vqtbl1q_u8(digits, vandq_u8(bytes, vdupq_n_u8(0x0f)));
+    vst2q_u8(out + i * 2, chars);
+    i += 16;
+  }
+  return i;
+}
+#endif
+
+
 static size_t hex_encode(const char* src, size_t slen, char* dst, size_t dlen) {
   // We know how much we'll write, just make sure that there's space.
   CHECK(dlen >= slen * 2 &&
       "not enough space provided for hex encode");
 
   dlen = slen * 2;
-  for (uint32_t i = 0, k = 0; k < dlen; i += 1, k += 2) {
+  size_t i = 0;
+#if NODE_SIMD_X86
+  if (cpu::GetLevel() >= cpu::kSSSE3)
+    i = hex_encode_ssse3(src, slen, dst);
+#elif NODE_SIMD_NEON
+  i = hex_encode_neon(src, slen, dst);
+#endif
+  for (size_t k = i * 2; k < dlen; i += 1, k += 2) {
     static const char hex[] = "0123456789abcdef";
     uint8_t val = static_cast<uint8_t>(src[i]);
     dst[k + 0] = hex[val >> 4];
@@ -611,6 +1032,46 @@ static size_t hex_encode(const char* src, size_t slen, char* dst, size_t dlen) {
 
 
 
+// Turns well-formed UTF-8 into a string, a one byte string when it fits in
+// Latin-1. Returns an empty handle for anything else.
+static Local<String> DecodeUtf8(Isolate* isolate,
+                                const char* buf,
+                                size_t buflen) {
+  uint16_t* dst = node::UncheckedMalloc<uint16_t>(buflen);
+  if (dst == nullptr)
+    return Local<String>();
+
+  size_t nchars;
+  bool latin1;
+  if (!utf8_to_utf16(reinterpret_cast<const uint8_t*>(buf),
+                     buflen, dst, &nchars, &latin1)) {
+    free(dst);
+    return Local<String>();
+  }
+
+  Local<String> val;
+  if (latin1) {
+    // Narrowed in place, each character is written no later than it's read.
+    char* narrow = reinterpret_cast<char*>(dst);
+    CHECK_EQ(narrow_latin1(dst, nchars, narrow), nchars);
+    if (nchars < EXTERN_APEX) {
+      val = OneByteString(isolate, narrow, nchars);
+      free(dst);
+    } else {
+      char* data = node::Realloc(narrow, nchars);
+      val = ExternOneByteString::New(isolate, data, nchars);
+    }
+  } else if (nchars < EXTERN_APEX) {
+    val = String::NewFromTwoByte(isolate, dst, String::kNormalString, nchars);
+    free(dst);
+  } else {
+    dst = node::Realloc(dst, nchars);
+    val = ExternTwoByteString::New(isolate, dst, nchars);
+  }
+  return val;
+}
+
+
 Local<Value> StringBytes::Encode(Isolate* isolate,
                                  const char* buf,
                                  size_t buflen,
@@ -653,10 +1114,21 @@ Local<Value> StringBytes::Encode(Isolate* isolate,
       break;
 
     case UTF8:
-      val = String::NewFromUtf8(isolate,
-                                buf,
-                                String::kNormalString,
-                                buflen);
+      // ASCII reads the same as Latin-1, there is nothing to transcode.
+      if (!contains_non_ascii(buf, buflen)) {
+        if (buflen < EXTERN_APEX)
+          val = OneByteString(isolate, buf, buflen);
+        else
+          val = ExternOneByteString::NewFromCopy(isolate, buf, buflen);
+        break;
+      }
+      val = DecodeUtf8(isolate, buf, buflen);
+      if (val.IsEmpty()) {
+        val = String::NewFromUtf8(isolate,
+                                  buf,
+                                  String::kNormalString,
+                                  buflen);
+      }
       break;
 
     case LATIN1:
@@ -712,6 +1184,54 @@ Local<Value> StringBytes::Encode(Isolate* isolate,
 }
 
 
+bool StringBytes::CanAdopt(size_t buflen, enum encoding encoding) {
+  switch (encoding) {
+    case ASCII:
+    case LATIN1:
+      return buflen >= EXTERN_APEX && buflen <= String::kMaxLength;
+    case UCS2:
+      return buflen % 2 == 0 &&
+             buflen / 2 >= EXTERN_APEX &&
+             buflen / 2 <= String::kMaxLength;
+    default:
+      return false;
+  }
+}
+
+
+MaybeLocal<String> StringBytes::Adopt(Isolate* isolate,
+                                      char* buf,
+                                      size_t buflen,
+                                      enum encoding encoding) {
+  EscapableHandleScope scope(isolate);
+  CHECK(CanAdopt(buflen, encoding));
+
+  Local<String> val;
+  switch (encoding) {
+    case ASCII:
+      if (contains_non_ascii(buf, buflen))
+        force_ascii(buf, buf, buflen);
+      val = ExternOneByteString::New(isolate, buf, buflen);
+      break;
+
+    case LATIN1:
+      val = ExternOneByteString::New(isolate, buf, buflen);
+      break;
+
+    case UCS2:
+      CHECK_EQ(reinterpret_cast<uintptr_t>(buf) % sizeof(uint16_t), 0);
+      val = ExternTwoByteString::New(isolate,
+                                     reinterpret_cast<uint16_t*>(buf),
+                                     buflen / 2);
+      break;
+
+    default:
+      UNREACHABLE();
+  }
+  return scope.Escape(val);
+}
+
+
 Local<Value> StringBytes::Encode(Isolate* isolate,
                                  const uint16_t* buf,
                                  size_t buflen) {
@@ -728,6 +1248,23 @@ Local<Value> StringBytes::Encode(Isolate* isolate,
   }
 
   Local<String> val;
+  // Text that fits in Latin-1 takes half the memory as a one byte string.
+  if (buflen >= 16) {
+    char* narrow = node::UncheckedMalloc(buflen);
+    if (narrow != nullptr) {
+      if (narrow_latin1(buf, buflen, narrow) == buflen) {
+        if (buflen < EXTERN_APEX) {
+          val = OneByteString(isolate, narrow, buflen);
+          free(narrow);
+        } else {
+          val = ExternOneByteString::New(isolate, narrow, buflen);
+        }
+        return val;
+      }
+      free(narrow);
+    }
+  }
+
   if (buflen < EXTERN_APEX) {
     val = String::NewFromTwoByte(isolate,
                                  buf,
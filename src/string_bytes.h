@@ -119,6 +119,20 @@ class StringBytes {
                                      const char* buf,
                                      enum encoding encoding);
 
+  // Can Adopt() turn |buflen| bytes into a string? Only LATIN1, ASCII and
+  // UCS2 can be, and only when |buflen| is long enough that Encode() would
+  // also create an external string.
+  static bool CanAdopt(size_t buflen, enum encoding encoding);
+
+  // Like Encode(), but the string uses |buf| as its storage instead of a
+  // copy of it and frees it with free() when it is garbage collected. It
+  // takes ownership of |buf| even when it fails. For ASCII, the high bits
+  // are cleared in place, and for UCS2 |buf| must be in host endianness.
+  static v8::MaybeLocal<v8::String> Adopt(v8::Isolate* isolate,
+                                          char* buf,
+                                          size_t buflen,
+                                          enum encoding encoding);
+
  private:
   static size_t WriteUCS2(char* buf,
                           size_t buflen,
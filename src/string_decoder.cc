@@ -0,0 +1,415 @@
+#include "string_decoder.h"
+
+#include "env.h"
+#include "env-inl.h"
+#include "node.h"
+#include "node_buffer.h"
+#include "node_internals.h"
+#include "string_bytes.h"
+#include "util.h"
+#include "util-inl.h"
+#include "v8.h"
+
+#include <string.h>
+
+namespace node {
+
+using v8::Array;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+namespace {
+
+const char kReplacementChar[] = "\xEF\xBF\xBD";  // U+FFFD in UTF-8.
+
+
+// Checks the type of a UTF-8 byte, whether it's ASCII, a leading byte, or a
+// continuation byte. If an invalid byte is detected, -2 is returned.
+int Utf8CheckByte(uint8_t byte) {
+  if (byte <= 0x7F)
+    return 0;
+  else if (byte >> 5 == 0x06)
+    return 2;
+  else if (byte >> 4 == 0x0E)
+    return 3;
+  else if (byte >> 3 == 0x1E)
+    return 4;
+  return byte >> 6 == 0x02 ? -1 : -2;
+}
+
+
+// Checks at most 3 bytes at the end of |data|, but none before |start|, for
+// an incomplete multi-byte UTF-8 character. Returns the total number of bytes
+// of that character and stores the number still missing in kLastNeed.
+size_t Utf8CheckIncomplete(uint8_t* state,
+                           const uint8_t* data,
+                           size_t length,
+                           size_t start) {
+  size_t j = length - 1;
+  int nb = Utf8CheckByte(data[j]);
+  if (nb >= 0) {
+    if (nb > 0)
+      state[StringDecoder::kLastNeed] = nb - 1;
+    return nb;
+  }
+  if (j == start || nb == -2)
+    return 0;
+  nb = Utf8CheckByte(data[--j]);
+  if (nb >= 0) {
+    if (nb > 0)
+      state[StringDecoder::kLastNeed] = nb - 2;
+    return nb;
+  }
+  if (j == start || nb == -2)
+    return 0;
+  nb = Utf8CheckByte(data[--j]);
+  if (nb >= 0) {
+    if (nb > 0) {
+      if (nb == 2)
+        nb = 0;
+      else
+        state[StringDecoder::kLastNeed] = nb - 3;
+    }
+    return nb;
+  }
+  return 0;
+}
+
+
+// Finds the line endings of a chunk. memchr() is vectorized by the C libraries
+// that matter; \n and \r are each looked for once per chunk, not per line.
+class LineEndingScanner {
+ public:
+  LineEndingScanner(const char* data, const char* end)
+      : end_(end), lf_(Find('\n', data)), cr_(Find('\r', data)) {}
+
+  // Returns the first \n or \r at or after |p|, or the end of the chunk.
+  const char* Next(const char* p) {
+    if (lf_ < p)
+      lf_ = Find('\n', p);
+    if (cr_ < p)
+      cr_ = Find('\r', p);
+    return lf_ < cr_ ? lf_ : cr_;
+  }
+
+ private:
+  const char* Find(char c, const char* p) const {
+    const void* found = memchr(p, c, end_ - p);
+    return found != nullptr ? static_cast<const char*>(found) : end_;
+  }
+
+  const char* const end_;
+  const char* lf_;
+  const char* cr_;
+};
+
+
+// splitLines(pieces, chunk, start, end) splits |chunk| from |start| on at
+// each \r\n, \n and \r, like the lineEnding of lib/readline.js, and returns
+// the lines as an Array of strings, decoded from UTF-8. |pieces| is null or
+// an Array of Buffers that hold the start of the first line. The offset of
+// what is left of |chunk| after the last line ending is stored in end[0].
+//
+// Neither \r nor \n is ever part of a multi-byte UTF-8 character, so the
+// lines can be decoded on their own, and a character that spans chunks is
+// in the rest that the next call gets as one of its |pieces|.
+void SplitLines(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+  SPREAD_BUFFER_ARG(args[1], chunk);
+  CHECK(args[2]->IsUint32());
+  const size_t start = args[2]->Uint32Value();
+  CHECK_LE(start, chunk_length);
+  CHECK(args[3]->IsFloat64Array());
+  SPREAD_BUFFER_ARG(args[3], end_obj);
+  CHECK_GE(end_obj_length, sizeof(double));
+
+  const char* const end = chunk_data + chunk_length;
+  const char* p = chunk_data + start;
+  LineEndingScanner scanner(p, end);
+  Local<Array> lines = Array::New(isolate);
+  uint32_t count = 0;
+
+  for (const char* eol = scanner.Next(p); eol != end; eol = scanner.Next(p)) {
+    Local<Value> line;
+    if (count == 0 && args[0]->IsArray()) {
+      Local<Array> pieces = args[0].As<Array>();
+      size_t length = eol - p;
+      for (uint32_t i = 0; i < pieces->Length(); i++)
+        length += Buffer::Length(pieces->Get(context, i).ToLocalChecked());
+      MaybeStackBuffer<char> joined(length);
+      char* out = *joined;
+      for (uint32_t i = 0; i < pieces->Length(); i++) {
+        Local<Value> piece = pieces->Get(context, i).ToLocalChecked();
+        memcpy(out, Buffer::Data(piece), Buffer::Length(piece));
+        out += Buffer::Length(piece);
+      }
+      memcpy(out, p, eol - p);
+      line = StringBytes::Encode(isolate, *joined, length, UTF8);
+    } else {
+      line = StringBytes::Encode(isolate, p, eol - p, UTF8);
+    }
+    if (line.IsEmpty())
+      return env->ThrowError("\"toString()\" failed");
+    lines->Set(context, count++, line).FromJust();
+
+    p = eol + 1;
+    if (*eol == '\r' && p != end && *p == '\n')
+      p++;
+  }
+
+  reinterpret_cast<double*>(end_obj_data)[0] = p - chunk_data;
+  args.GetReturnValue().Set(lines);
+}
+
+}  // anonymous namespace
+
+
+void StringDecoder::Output::Add(const void* data, size_t length) {
+  CHECK_LT(count_, arraysize(chunks_));
+  chunks_[count_].data = static_cast<const uint8_t*>(data);
+  chunks_[count_].length = length;
+  count_++;
+}
+
+
+void StringDecoder::Output::AddCopy(const void* data, size_t length) {
+  CHECK_LE(length, sizeof(copy_));
+  memcpy(copy_, data, length);
+  Add(copy_, length);
+}
+
+
+bool StringDecoder::FillLast(uint8_t* state,
+                             const uint8_t* data,
+                             size_t length,
+                             Output* out) {
+  const size_t need = state[kLastNeed];
+  const size_t pos = state[kLastTotal] - need;
+
+  // A byte that is not a continuation byte where one is expected ends the
+  // character. Like V8, replace the bytes seen so far with a single U+FFFD;
+  // kLastNeed is left at the number of bytes of |data| that were used up.
+  if (state[kEncodingField] == UTF8) {
+    for (size_t i = 0; i < need && i < length; i++) {
+      if ((data[i] & 0xC0) != 0x80) {
+        state[kLastNeed] = i;
+        out->Add(kReplacementChar, sizeof(kReplacementChar) - 1);
+        return true;
+      }
+    }
+  }
+
+  if (need <= length) {
+    memcpy(state + kLastChar + pos, data, need);
+    out->AddCopy(state + kLastChar, state[kLastTotal]);
+    return true;
+  }
+  memcpy(state + kLastChar + pos, data, length);
+  state[kLastNeed] -= length;
+  return false;
+}
+
+
+void StringDecoder::Text(uint8_t* state,
+                         const uint8_t* data,
+                         size_t length,
+                         size_t start,
+                         Output* out) {
+  switch (state[kEncodingField]) {
+    case UTF8: {
+      const size_t total = Utf8CheckIncomplete(state, data, length, start);
+      if (state[kLastNeed] == 0)
+        return out->Add(data + start, length - start);
+      state[kLastTotal] = total;
+      const size_t end = length - (total - state[kLastNeed]);
+      memcpy(state + kLastChar, data + end, length - end);
+      return out->Add(data + start, end - start);
+    }
+
+    case UCS2:
+      // Even with an even number of bytes, the last two can be a high
+      // surrogate that needs the next two to make a character.
+      if ((length - start) % 2 == 0) {
+        const uint16_t last = data[length - 2] | data[length - 1] << 8;
+        if (last >= 0xD800 && last <= 0xDBFF) {
+          state[kLastNeed] = 2;
+          state[kLastTotal] = 4;
+          memcpy(state + kLastChar, data + length - 2, 2);
+          return out->Add(data + start, length - start - 2);
+        }
+        return out->Add(data + start, length - start);
+      }
+      state[kLastNeed] = 1;
+      state[kLastTotal] = 2;
+      state[kLastChar] = data[length - 1];
+      return out->Add(data + start, length - start - 1);
+
+    case BASE64: {
+      const size_t rest = (length - start) % 3;
+      if (rest != 0) {
+        state[kLastNeed] = 3 - rest;
+        state[kLastTotal] = 3;
+        memcpy(state + kLastChar, data + length - rest, rest);
+      }
+      return out->Add(data + start, length - start - rest);
+    }
+
+    default:
+      UNREACHABLE();
+  }
+}
+
+
+void StringDecoder::Write(uint8_t* state,
+                          const uint8_t* data,
+                          size_t length,
+                          Output* out) {
+  if (length == 0)
+    return;
+  size_t start = 0;
+  if (state[kLastNeed] != 0) {
+    if (!FillLast(state, data, length, out))
+      return;
+    start = state[kLastNeed];
+    state[kLastNeed] = 0;
+  }
+  if (start < length)
+    Text(state, data, length, start, out);
+}
+
+
+void StringDecoder::Finish(uint8_t* state, Output* out) {
+  if (state[kLastNeed] == 0)
+    return;
+  switch (state[kEncodingField]) {
+    case UTF8:
+      return out->Add(kReplacementChar, sizeof(kReplacementChar) - 1);
+    case UCS2:
+      return out->Add(state + kLastChar,
+                      state[kLastTotal] - state[kLastNeed]);
+    case BASE64:
+      return out->Add(state + kLastChar, 3 - state[kLastNeed]);
+    default:
+      UNREACHABLE();
+  }
+}
+
+
+Local<String> StringDecoder::ToString(Isolate* isolate,
+                                      const Output& out,
+                                      enum encoding encoding) {
+  Local<String> result = String::Empty(isolate);
+  for (size_t i = 0; i < out.count(); i++) {
+    const uint8_t* data = out.data(i);
+    const size_t length = out.length(i);
+    if (length == 0)
+      continue;
+
+    Local<Value> chunk;
+    if (encoding == UCS2) {
+      // The data is little endian and need not be aligned; see UCS2 slicing
+      // in node_buffer.cc.
+      const size_t chars = length / 2;
+      if (chars == 0)
+        continue;
+      const bool aligned =
+          reinterpret_cast<uintptr_t>(data) % sizeof(uint16_t) == 0;
+      if (IsLittleEndian() && aligned) {
+        chunk = StringBytes::Encode(
+            isolate, reinterpret_cast<const uint16_t*>(data), chars);
+      } else {
+        // Encode() takes the bytes in little endian order, as they are.
+        MaybeStackBuffer<uint16_t> copy(chars);
+        memcpy(*copy, data, chars * sizeof(uint16_t));
+        chunk = StringBytes::Encode(isolate, *copy, chars);
+      }
+    } else {
+      chunk = StringBytes::Encode(isolate,
+                                  reinterpret_cast<const char*>(data),
+                                  length,
+                                  encoding);
+    }
+    if (chunk.IsEmpty())
+      return Local<String>();
+    result = String::Concat(result, chunk.As<String>());
+  }
+  return result;
+}
+
+
+// decode(state, buffer) returns the complete characters in |buffer| and
+// keeps the bytes of an incomplete one at its end in |state|.
+void StringDecoder::Decode(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  SPREAD_BUFFER_ARG(args[0], state_obj);
+  CHECK_EQ(state_obj_length, kNumFields);
+  if (!args[1]->IsArrayBufferView())
+    return env->ThrowTypeError("argument should be a Buffer");
+  SPREAD_BUFFER_ARG(args[1], buf);
+
+  uint8_t* const state = reinterpret_cast<uint8_t*>(state_obj_data);
+  Output out;
+  Write(state, reinterpret_cast<const uint8_t*>(buf_data), buf_length, &out);
+  Local<String> result = ToString(
+      env->isolate(), out, static_cast<enum encoding>(state[kEncodingField]));
+  if (result.IsEmpty())
+    return env->ThrowError("\"toString()\" failed");
+  args.GetReturnValue().Set(result);
+}
+
+
+// flush(state) returns what end() appends for an incomplete character.
+void StringDecoder::Flush(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  SPREAD_BUFFER_ARG(args[0], state_obj);
+  CHECK_EQ(state_obj_length, kNumFields);
+
+  uint8_t* const state = reinterpret_cast<uint8_t*>(state_obj_data);
+  Output out;
+  Finish(state, &out);
+  Local<String> result = ToString(
+      env->isolate(), out, static_cast<enum encoding>(state[kEncodingField]));
+  if (result.IsEmpty())
+    return env->ThrowError("\"toString()\" failed");
+  args.GetReturnValue().Set(result);
+}
+
+
+void StringDecoder::Initialize(Local<Object> target,
+                               Local<Value> unused,
+                               Local<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  Isolate* isolate = env->isolate();
+
+#define SET_DECODER_CONSTANT(name, value)                                     \
+  target->Set(context,                                                        \
+              FIXED_ONE_BYTE_STRING(isolate, name),                           \
+              Integer::New(isolate, value)).FromJust()
+
+  SET_DECODER_CONSTANT("kLastChar", kLastChar);
+  SET_DECODER_CONSTANT("kLastNeed", kLastNeed);
+  SET_DECODER_CONSTANT("kLastTotal", kLastTotal);
+  SET_DECODER_CONSTANT("kEncodingField", kEncodingField);
+  SET_DECODER_CONSTANT("kNumFields", kNumFields);
+  SET_DECODER_CONSTANT("UTF8", UTF8);
+  SET_DECODER_CONSTANT("UCS2", UCS2);
+  SET_DECODER_CONSTANT("BASE64", BASE64);
+#undef SET_DECODER_CONSTANT
+
+  env->SetMethod(target, "decode", Decode);
+  env->SetMethod(target, "flush", Flush);
+  env->SetMethod(target, "splitLines", SplitLines);
+}
+
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(string_decoder,
+                                  node::StringDecoder::Initialize)
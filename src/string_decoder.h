@@ -0,0 +1,84 @@
+#ifndef SRC_STRING_DECODER_H_
+#define SRC_STRING_DECODER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node.h"
+#include "util.h"
+#include "v8.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace node {
+
+// The incremental part of lib/string_decoder.js for the encodings whose
+// characters can span chunks: UTF-8, UTF-16LE and base64. The state of a
+// decoder is a small Buffer that the JS object owns, so that each write()
+// is a single call that decodes the carried-over bytes and the new chunk.
+class StringDecoder {
+ public:
+  // Layout of the state buffer.
+  enum Field {
+    kLastChar = 0,        // Up to 4 bytes of an incomplete character.
+    kLastNeed = 4,        // Bytes still missing from it.
+    kLastTotal = 5,       // Its length once complete.
+    kEncodingField = 6,   // UTF8, UCS2 or BASE64.
+    kNumFields = 7
+  };
+
+  static void Initialize(v8::Local<v8::Object> target,
+                         v8::Local<v8::Value> unused,
+                         v8::Local<v8::Context> context);
+
+ private:
+  // The pieces of a result, in order. They point into the chunk being
+  // decoded or the state buffer, and are decoded and joined in one go.
+  class Output {
+   public:
+    Output() : count_(0) {}
+    void Add(const void* data, size_t length);
+    // For bytes of the state buffer, which the rest of the chunk may reuse.
+    void AddCopy(const void* data, size_t length);
+    size_t count() const { return count_; }
+    const uint8_t* data(size_t index) const { return chunks_[index].data; }
+    size_t length(size_t index) const { return chunks_[index].length; }
+
+   private:
+    struct Chunk {
+      const uint8_t* data;
+      size_t length;
+    };
+    Chunk chunks_[2];  // What was carried over, and the new chunk.
+    size_t count_;
+    uint8_t copy_[4];
+  };
+
+  // Returns false when |data| did not complete the carried-over character.
+  static bool FillLast(uint8_t* state,
+                       const uint8_t* data,
+                       size_t length,
+                       Output* out);
+  static void Text(uint8_t* state,
+                   const uint8_t* data,
+                   size_t length,
+                   size_t start,
+                   Output* out);
+  static void Write(uint8_t* state,
+                    const uint8_t* data,
+                    size_t length,
+                    Output* out);
+  static void Finish(uint8_t* state, Output* out);
+  static v8::Local<v8::String> ToString(v8::Isolate* isolate,
+                                        const Output& out,
+                                        enum encoding encoding);
+
+  static void Decode(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Flush(const v8::FunctionCallbackInfo<v8::Value>& args);
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_STRING_DECODER_H_
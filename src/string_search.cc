@@ -1,4 +1,9 @@
 #include "string_search.h"
+#include "node_cpu.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace node {
 namespace stringsearch {
@@ -7,5 +12,95 @@ int StringSearchBase::kBadCharShiftTable[kUC16AlphabetSize];
 int StringSearchBase::kGoodSuffixShiftTable[kBMMaxShift + 1];
 int StringSearchBase::kSuffixTable[kBMMaxShift + 1];
 
+
+static inline unsigned CountTrailingZeros(uint32_t value) {
+#if defined(_MSC_VER)
+  unsigned long index;  // NOLINT(runtime/int)
+  _BitScanForward(&index, value);
+  return index;
+#else
+  return __builtin_ctz(value);
+#endif
+}
+
+
+#if NODE_SIMD_X86
+NODE_SIMD_TARGET("avx2")
+static bool FindAnchorsAVX2(const uint8_t* subject, size_t length,
+                            uint8_t first, uint8_t last, size_t gap,
+                            size_t* index) {
+  size_t i = *index;
+  const __m256i first_v = _mm256_set1_epi8(static_cast<char>(first));
+  const __m256i last_v = _mm256_set1_epi8(static_cast<char>(last));
+  while (i + gap + 32 <= length) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(subject + i));
+    const __m256i b = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(subject + i + gap));
+    const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(a, first_v),
+                         _mm256_cmpeq_epi8(b, last_v))));
+    if (mask != 0) {
+      *index = i + CountTrailingZeros(mask);
+      return true;
+    }
+    i += 32;
+  }
+  *index = i;
+  return false;
+}
+#endif
+
+
+size_t FindAnchors(const uint8_t* subject, size_t length,
+                   uint8_t first, uint8_t last, size_t gap, size_t index) {
+  size_t i = index;
+#if NODE_SIMD_X86
+  if (cpu::GetLevel() >= cpu::kAVX2 &&
+      FindAnchorsAVX2(subject, length, first, last, gap, &i)) {
+    return i;
+  }
+#endif
+#if NODE_SIMD_SSE2
+  const __m128i first_v = _mm_set1_epi8(static_cast<char>(first));
+  const __m128i last_v = _mm_set1_epi8(static_cast<char>(last));
+  while (i + gap + 16 <= length) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(subject + i));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(subject + i + gap));
+    const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(a, first_v),
+                      _mm_cmpeq_epi8(b, last_v))));
+    if (mask != 0)
+      return i + CountTrailingZeros(mask);
+    i += 16;
+  }
+#elif NODE_SIMD_NEON
+  const uint8x16_t first_v = vdupq_n_u8(first);
+  const uint8x16_t last_v = vdupq_n_u8(last);
+  // One bit per lane, in order, so the lowest set bit is the first match.
+  const uint8x16_t bits = {1, 2, 4, 8, 16, 32, 64, 128,
+                           1, 2, 4, 8, 16, 32, 64, 128};
+  while (i + gap + 16 <= length) {
+    const uint8x16_t match =
+        vandq_u8(vceqq_u8(vld1q_u8(subject + i), first_v),
+                 vceqq_u8(vld1q_u8(subject + i + gap), last_v));
+    if (vmaxvq_u8(match) != 0) {
+      const uint8x16_t lanes = vandq_u8(match, bits);
+      const uint32_t mask = vaddv_u8(vget_low_u8(lanes)) |
+                            (vaddv_u8(vget_high_u8(lanes)) << 8);
+      return i + CountTrailingZeros(mask);
+    }
+    i += 16;
+  }
+#endif
+  for (; i + gap < length; i++) {
+    if (subject[i] == first && subject[i + gap] == last)
+      return i;
+  }
+  return length;
+}
+
 }  // namespace stringsearch
 }  // namespace node
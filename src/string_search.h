@@ -62,6 +62,9 @@ class Vector {
 // Class holding constants and methods that apply to all string search variants,
 // independently of subject and pattern char size.
 class StringSearchBase {
+ public:
+  struct Tables;
+
  protected:
   // Cap on the maximal shift in the Boyer-Moore implementation. By setting a
   // limit, we can fix the size of tables. For a needle longer than this limit,
@@ -93,17 +96,33 @@ class StringSearchBase {
   static int kSuffixTable[kBMMaxShift + 1];
 };
 
+// Shift tables owned by a single search object, for searches that outlive
+// one call and must not share the static tables with other searches.
+struct StringSearchBase::Tables {
+  int bad_char_shift[kUC16AlphabetSize];
+  int good_suffix_shift[kBMMaxShift + 1];
+  int suffix[kBMMaxShift + 1];
+};
+
 template <typename Char>
 class StringSearch : private StringSearchBase {
  public:
-  explicit StringSearch(Vector<const Char> pattern)
-      : pattern_(pattern), start_(0) {
+  // With |tables|, the search keeps its shift tables there instead of in the
+  // static ones, so it can be reused for any number of subjects without the
+  // tables being rebuilt in between.
+  explicit StringSearch(Vector<const Char> pattern,
+                        StringSearchBase::Tables* tables = nullptr)
+      : pattern_(pattern), tables_(tables), start_(0) {
     if (pattern.length() >= kBMMaxShift) {
       start_ = pattern.length() - kBMMaxShift;
     }
 
     size_t pattern_length = pattern_.length();
     CHECK_GT(pattern_length, 0);
+    if (sizeof(Char) == 1 && pattern.forward() && pattern_length > 1) {
+      strategy_ = &AnchoredSearch;
+      return;
+    }
     if (pattern_length < kBMMinPatternLength) {
       if (pattern_length == 1) {
         strategy_ = &SingleCharSearch;
@@ -151,6 +170,10 @@ class StringSearch : private StringSearchBase {
                               Vector<const Char> subject,
                               size_t start_index);
 
+  static size_t AnchoredSearch(StringSearch<Char>* search,
+                               Vector<const Char> subject,
+                               size_t start_index);
+
   static size_t BoyerMooreHorspoolSearch(
       StringSearch<Char>* search,
       Vector<const Char> subject,
@@ -177,13 +200,17 @@ class StringSearch : private StringSearchBase {
   // Store for the BoyerMoore(Horspool) bad char shift table.
   // Return a table covering the last kBMMaxShift+1 positions of
   // pattern.
-  int* bad_char_table() { return kBadCharShiftTable; }
+  int* bad_char_table() {
+    return tables_ != nullptr ? tables_->bad_char_shift : kBadCharShiftTable;
+  }
 
   // Store for the BoyerMoore good suffix shift table.
   int* good_suffix_shift_table() {
     // Return biased pointer that maps the range  [start_..pattern_.length()
     // to the kGoodSuffixShiftTable array.
-    return kGoodSuffixShiftTable - start_;
+    int* table = tables_ != nullptr ? tables_->good_suffix_shift
+                                    : kGoodSuffixShiftTable;
+    return table - start_;
   }
 
   // Table used temporarily while building the BoyerMoore good suffix
@@ -191,13 +218,16 @@ class StringSearch : private StringSearchBase {
   int* suffix_table() {
     // Return biased pointer that maps the range  [start_..pattern_.length()
     // to the kSuffixTable array.
-    return kSuffixTable - start_;
+    int* table = tables_ != nullptr ? tables_->suffix : kSuffixTable;
+    return table - start_;
   }
 
   // The pattern to search for.
   Vector<const Char> pattern_;
   // Pointer to implementation of the search.
   SearchFunction strategy_;
+  // Tables of this search, or nullptr to use the static ones.
+  StringSearchBase::Tables* tables_;
   // Cache value of Max(0, pattern_length() - kBMMaxShift)
   size_t start_;
 };
@@ -311,6 +341,39 @@ inline size_t FindFirstCharacter(Vector<const uint8_t> pattern,
   return subject.forward() ? raw_pos : (subj_len - raw_pos - 1);
 }
 
+// Finds the first position at or after |index| where |first| occurs with
+// |last| |gap| bytes further on, a vector of positions at a time. Returns
+// |length| if there is none. Defined in string_search.cc.
+size_t FindAnchors(const uint8_t* subject, size_t length,
+                   uint8_t first, uint8_t last, size_t gap, size_t index);
+
+
+// Finds the first occurrence of pattern[0] that is followed by the last
+// character of the pattern in the right place. Does not check the characters
+// in between.
+template <typename Char>
+inline size_t FindFirstAndLastCharacter(Vector<const Char> pattern,
+                                        Vector<const Char> subject,
+                                        size_t index) {
+  const size_t gap = pattern.length() - 1;
+  for (size_t i = index; i + gap < subject.length(); i++) {
+    if (subject[i] == pattern[0] && subject[i + gap] == pattern[gap])
+      return i;
+  }
+  return subject.length();
+}
+
+
+template <>
+inline size_t FindFirstAndLastCharacter(Vector<const uint8_t> pattern,
+                                        Vector<const uint8_t> subject,
+                                        size_t index) {
+  CHECK(subject.forward());
+  const size_t gap = pattern.length() - 1;
+  return FindAnchors(subject.start(), subject.length(),
+                     pattern[0], pattern[gap], gap, index);
+}
+
 //---------------------------------------------------------------------
 // Single Character Pattern Search Strategy
 //---------------------------------------------------------------------
@@ -612,6 +675,44 @@ size_t StringSearch<Char>::InitialSearch(
   return subject.length();
 }
 
+//---------------------------------------------------------------------
+// Anchored Search Strategy
+//---------------------------------------------------------------------
+
+// Forward search of one byte subjects. Only positions where both the first
+// and the last character of the pattern match get compared in full, and the
+// filter for those runs over many positions at once. Upgrades to
+// BoyerMooreHorspool when too many candidates turn out not to match.
+template <typename Char>
+size_t StringSearch<Char>::AnchoredSearch(
+    StringSearch<Char>* search,
+    Vector<const Char> subject,
+    size_t index) {
+  Vector<const Char> pattern = search->pattern_;
+  const size_t pattern_length = pattern.length();
+  CHECK_GT(pattern_length, 1);
+  int64_t badness = -10 - (pattern_length << 2);
+
+  for (size_t i = index, n = subject.length() - pattern_length; i <= n; i++) {
+    i = FindFirstAndLastCharacter(pattern, subject, i);
+    if (i == subject.length())
+      return subject.length();
+    ASSERT_LE(i, n);
+    size_t j = 1;
+    while (j < pattern_length - 1 && pattern[j] == subject[i + j])
+      j++;
+    if (j == pattern_length - 1)
+      return i;
+    badness += j;
+    if (badness > 0 && pattern_length >= kBMMinPatternLength) {
+      search->PopulateBoyerMooreHorspoolTable();
+      search->strategy_ = &BoyerMooreHorspoolSearch;
+      return BoyerMooreHorspoolSearch(search, subject, i + 1);
+    }
+  }
+  return subject.length();
+}
+
 // Perform a a single stand-alone search.
 // If searching multiple times for the same pattern, a search
 // object should be constructed once and the Search function then called
@@ -629,19 +730,23 @@ size_t SearchString(Vector<const Char> subject,
 namespace node {
 using node::stringsearch::Vector;
 
+using node::stringsearch::StringSearch;
+
+// Searches |haystack| with a search object built for a needle of
+// |needle_length| characters, reversed when |is_forward| is false, so callers
+// that search for the same needle many times build it only once.
 template <typename Char>
-size_t SearchString(const Char* haystack,
+size_t SearchString(StringSearch<Char>* search,
+                    const Char* haystack,
                     size_t haystack_length,
-                    const Char* needle,
                     size_t needle_length,
                     size_t start_index,
                     bool is_forward) {
   // To do a reverse search (lastIndexOf instead of indexOf) without redundant
-  // code, create two vectors that are reversed views into the input strings.
-  // For example, v_needle[0] would return the *last* character of the needle.
-  // So we're searching for the first instance of rev(needle) in rev(haystack)
-  Vector<const Char> v_needle = Vector<const Char>(
-      needle, needle_length, is_forward);
+  // code, the search and the haystack are reversed views into the input
+  // strings. For example, v_haystack[0] would return the *last* character of
+  // the haystack. So we're searching for the first instance of rev(needle)
+  // in rev(haystack).
   Vector<const Char> v_haystack = Vector<const Char>(
       haystack, haystack_length, is_forward);
   ASSERT(haystack_length >= needle_length);
@@ -654,14 +759,26 @@ size_t SearchString(const Char* haystack,
   } else {
     relative_start_index = diff - start_index;
   }
-  size_t pos = node::stringsearch::SearchString(
-      v_haystack, v_needle, relative_start_index);
+  size_t pos = search->Search(v_haystack, relative_start_index);
   if (pos == haystack_length) {
     // not found
     return pos;
   }
   return is_forward ? pos : (haystack_length - needle_length - pos);
 }
+
+template <typename Char>
+size_t SearchString(const Char* haystack,
+                    size_t haystack_length,
+                    const Char* needle,
+                    size_t needle_length,
+                    size_t start_index,
+                    bool is_forward) {
+  StringSearch<Char> search(
+      Vector<const Char>(needle, needle_length, is_forward));
+  return SearchString(&search, haystack, haystack_length, needle_length,
+                      start_index, is_forward);
+}
 }  // namespace node
 
 #endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
@@ -34,6 +34,13 @@
 
 #include <stdlib.h>
 
+#ifndef _WIN32
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#endif
+
 
 namespace node {
 
@@ -96,6 +103,7 @@ void TCPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "open", Open);
   env->SetProtoMethod(t, "bind", Bind);
   env->SetProtoMethod(t, "listen", Listen);
+  env->SetProtoMethod(t, "setAcceptBatch", SetAcceptBatch);
   env->SetProtoMethod(t, "connect", Connect);
   env->SetProtoMethod(t, "bind6", Bind6);
   env->SetProtoMethod(t, "connect6", Connect6);
@@ -105,6 +113,8 @@ void TCPWrap::Initialize(Local<Object> target,
                       GetSockOrPeerName<TCPWrap, uv_tcp_getpeername>);
   env->SetProtoMethod(t, "setNoDelay", SetNoDelay);
   env->SetProtoMethod(t, "setKeepAlive", SetKeepAlive);
+  env->SetProtoMethod(t, "setFastOpen", SetFastOpen);
+  env->SetProtoMethod(t, "setDeferAccept", SetDeferAccept);
 
 #ifdef _WIN32
   env->SetProtoMethod(t, "setSimultaneousAccepts", SetSimultaneousAccepts);
@@ -207,6 +217,82 @@ void TCPWrap::Open(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+#ifndef _WIN32
+// Stores the socket of |handle| in |*fd|, creating it first if the handle
+// does not have one yet, so that options can be set before bind() or
+// connect() is called.
+static int EnsureSocket(uv_tcp_t* handle, int family, uv_os_fd_t* fd) {
+  if (uv_fileno(reinterpret_cast<uv_handle_t*>(handle), fd) == 0)
+    return 0;
+  int type = SOCK_STREAM;
+#ifdef SOCK_CLOEXEC
+  type |= SOCK_CLOEXEC;
+#endif
+  *fd = socket(family, type, 0);
+  if (*fd == -1)
+    return -errno;
+  int err = uv_tcp_open(handle, *fd);
+  if (err != 0)
+    close(*fd);
+  return err;
+}
+#endif  // _WIN32
+
+
+// Sets SO_REUSEPORT on the socket of |handle|. This has to happen before
+// bind() so that several processes can bind to the same address and port
+// and have the kernel spread incoming connections across them.
+static int SetReusePort(uv_tcp_t* handle, int family) {
+#if defined(SO_REUSEPORT) && !defined(_WIN32)
+  uv_os_fd_t fd;
+  int err = EnsureSocket(handle, family, &fd);
+  if (err != 0)
+    return err;
+  int on = 1;
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0)
+    return -errno;
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
+// Sets TCP_FASTOPEN_CONNECT on the socket of |handle| before connect(). The
+// kernel then defers the SYN until the first write, and sends that data in
+// the SYN when it has a Fast Open cookie for the peer.
+static int SetFastOpenConnect(uv_tcp_t* handle, int family) {
+#if defined(TCP_FASTOPEN_CONNECT) && !defined(_WIN32)
+  uv_os_fd_t fd;
+  int err = EnsureSocket(handle, family, &fd);
+  if (err != 0)
+    return err;
+  int on = 1;
+  if (setsockopt(fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &on, sizeof(on)) != 0)
+    return -errno;
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
+// Sets an integer IPPROTO_TCP option on a socket that already exists.
+static int SetTCPOption(uv_tcp_t* handle, int name, int value) {
+#ifndef _WIN32
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(handle), &fd);
+  if (err != 0)
+    return err;
+  if (setsockopt(fd, IPPROTO_TCP, name, &value, sizeof(value)) != 0)
+    return -errno;
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
 void TCPWrap::Bind(const FunctionCallbackInfo<Value>& args) {
   TCPWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap,
@@ -216,6 +302,8 @@ void TCPWrap::Bind(const FunctionCallbackInfo<Value>& args) {
   int port = args[1]->Int32Value();
   sockaddr_in addr;
   int err = uv_ip4_addr(*ip_address, port, &addr);
+  if (err == 0 && args[2]->IsTrue())
+    err = SetReusePort(&wrap->handle_, AF_INET);
   if (err == 0) {
     err = uv_tcp_bind(&wrap->handle_,
                       reinterpret_cast<const sockaddr*>(&addr),
@@ -234,6 +322,8 @@ void TCPWrap::Bind6(const FunctionCallbackInfo<Value>& args) {
   int port = args[1]->Int32Value();
   sockaddr_in6 addr;
   int err = uv_ip6_addr(*ip6_address, port, &addr);
+  if (err == 0 && args[2]->IsTrue())
+    err = SetReusePort(&wrap->handle_, AF_INET6);
   if (err == 0) {
     err = uv_tcp_bind(&wrap->handle_,
                       reinterpret_cast<const sockaddr*>(&addr),
@@ -243,6 +333,35 @@ void TCPWrap::Bind6(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void TCPWrap::SetFastOpen(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+#ifdef TCP_FASTOPEN
+  int qlen = args[0]->Int32Value();
+  args.GetReturnValue().Set(SetTCPOption(&wrap->handle_, TCP_FASTOPEN, qlen));
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
+void TCPWrap::SetDeferAccept(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+#ifdef TCP_DEFER_ACCEPT
+  int secs = args[0]->Int32Value();
+  args.GetReturnValue().Set(
+      SetTCPOption(&wrap->handle_, TCP_DEFER_ACCEPT, secs));
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
 void TCPWrap::Listen(const FunctionCallbackInfo<Value>& args) {
   TCPWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap,
@@ -274,6 +393,8 @@ void TCPWrap::Connect(const FunctionCallbackInfo<Value>& args) {
 
   sockaddr_in addr;
   int err = uv_ip4_addr(*ip_address, port, &addr);
+  if (err == 0 && args[3]->IsTrue())
+    err = SetFastOpenConnect(&wrap->handle_, AF_INET);
 
   if (err == 0) {
     ConnectWrap* req_wrap =
@@ -309,6 +430,8 @@ void TCPWrap::Connect6(const FunctionCallbackInfo<Value>& args) {
 
   sockaddr_in6 addr;
   int err = uv_ip6_addr(*ip_address, port, &addr);
+  if (err == 0 && args[3]->IsTrue())
+    err = SetFastOpenConnect(&wrap->handle_, AF_INET6);
 
   if (err == 0) {
     ConnectWrap* req_wrap =
@@ -24,6 +24,7 @@
 #include "env.h"
 #include "env-inl.h"
 #include "handle_wrap.h"
+#include "node_probes.h"
 #include "util.h"
 #include "util-inl.h"
 
@@ -114,6 +115,8 @@ class TimerWrap : public HandleWrap {
     Environment* env = wrap->env();
     HandleScope handle_scope(env->isolate());
     Context::Scope context_scope(env->context());
+    if (NODE_TIMER_FIRE_ENABLED())
+      NODE_TIMER_FIRE(wrap, wrap->get_uid());
     wrap->MakeCallback(kOnTimeout, 0, nullptr);
   }
 
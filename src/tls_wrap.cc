@@ -29,6 +29,7 @@
 #include "node_crypto_clienthello-inl.h"
 #include "node_counters.h"
 #include "node_internals.h"
+#include "node_threadpool.h"
 #include "stream_base.h"
 #include "stream_base-inl.h"
 #include "util.h"
@@ -44,6 +45,7 @@ using v8::Exception;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
+using v8::HandleScope;
 using v8::Local;
 using v8::Object;
 using v8::String;
@@ -70,7 +72,20 @@ TLSWrap::TLSWrap(Environment* env,
       shutdown_(false),
       error_(nullptr),
       cycle_depth_(0),
-      eof_(false) {
+      eof_(false),
+      async_handshake_(false),
+      handshake_offloaded_(false),
+      handshake_work_active_(false),
+      handshake_work_pending_(false),
+      destroy_ssl_pending_(false),
+      handshake_info_(0),
+      handshake_error_(SSL_ERROR_NONE),
+      pending_enc_in_(nullptr),
+      record_size_small_(0),
+      record_size_threshold_(0),
+      record_size_idle_timeout_(0),
+      record_bytes_written_(0),
+      last_record_time_(0) {
   node::Wrap(object(), this);
   MakeWeak(this);
 
@@ -99,6 +114,8 @@ TLSWrap::~TLSWrap() {
   enc_out_ = nullptr;
   delete clear_in_;
   clear_in_ = nullptr;
+  delete pending_enc_in_;
+  pending_enc_in_ = nullptr;
 
   sc_ = nullptr;
 
@@ -164,7 +181,7 @@ void TLSWrap::InitSSL() {
 
   InitNPN(sc_);
 
-  SSL_set_cert_cb(ssl_, SSLWrap<TLSWrap>::SSLCertCallback, this);
+  SSL_set_cert_cb(ssl_, SSLCertCallback, this);
 
   if (is_server()) {
     SSL_set_accept_state(ssl_);
@@ -260,31 +277,208 @@ void TLSWrap::SSLInfoCallback(const SSL* ssl_, int where, int ret) {
   // a non-const SSL* in OpenSSL <= 0.9.7e.
   SSL* ssl = const_cast<SSL*>(ssl_);
   TLSWrap* c = static_cast<TLSWrap*>(SSL_get_app_data(ssl));
-  Environment* env = c->env();
-  Local<Object> object = c->object();
+
+  // JS can't be called from the threadpool, the callbacks are replayed once
+  // the handshake work is done.
+  if (c->handshake_work_active_) {
+    c->handshake_info_ |=
+        where & (SSL_CB_HANDSHAKE_START | SSL_CB_HANDSHAKE_DONE);
+    return;
+  }
+
+  c->OnHandshakeInfo(where);
+}
+
+
+void TLSWrap::OnHandshakeInfo(int where) {
+  Local<Object> object = this->object();
 
   if (where & SSL_CB_HANDSHAKE_START) {
-    Local<Value> callback = object->Get(env->onhandshakestart_string());
+    Local<Value> callback = object->Get(env()->onhandshakestart_string());
     if (callback->IsFunction()) {
-      c->MakeCallback(callback.As<Function>(), 0, nullptr);
+      MakeCallback(callback.As<Function>(), 0, nullptr);
     }
   }
 
   if (where & SSL_CB_HANDSHAKE_DONE) {
-    c->established_ = true;
-    Local<Value> callback = object->Get(env->onhandshakedone_string());
+    established_ = true;
+    Local<Value> callback = object->Get(env()->onhandshakedone_string());
     if (callback->IsFunction()) {
-      c->MakeCallback(callback.As<Function>(), 0, nullptr);
+      MakeCallback(callback.As<Function>(), 0, nullptr);
     }
   }
 }
 
 
+int TLSWrap::SSLCertCallback(SSL* s, void* arg) {
+  TLSWrap* w = static_cast<TLSWrap*>(arg);
+
+  int rv = SSLWrap<TLSWrap>::SSLCertCallback(s, arg);
+
+  // OpenSSL only gets here for full handshakes, right before it picks the
+  // cipher and starts on the server's flight. Pause the handshake and have
+  // the threadpool continue from here.
+  if (rv != 1 ||
+      !w->async_handshake_ ||
+      w->handshake_offloaded_ ||
+      !w->CanOffloadHandshake()) {
+    return rv;
+  }
+
+  w->handshake_offloaded_ = true;
+  w->handshake_work_pending_ = true;
+  return -1;
+}
+
+
+bool TLSWrap::CanOffloadHandshake() {
+  // Everything that OpenSSL still calls back into during the handshake has
+  // to be safe to run off the main thread, which excludes the callbacks that
+  // need to enter V8.
+  if (!is_server() || session_callbacks_)
+    return false;
+
+#ifdef NODE__HAVE_TLSEXT_STATUS_CB
+  if (!ocsp_response_.IsEmpty())
+    return false;
+#endif  // NODE__HAVE_TLSEXT_STATUS_CB
+
+#ifndef OPENSSL_NO_NEXTPROTONEG
+  if (ssl_->s3->next_proto_neg_seen)
+    return false;
+#endif  // OPENSSL_NO_NEXTPROTONEG
+
+  return true;
+}
+
+
+void TLSWrap::StartHandshakeWork() {
+  // A flight that is still being written is only committed to enc_out_ by
+  // EncOutCb, which tries again.
+  if (handshake_work_active_ ||
+      !handshake_work_pending_ ||
+      established_ ||
+      ssl_ == nullptr ||
+      write_size_ != 0) {
+    return;
+  }
+
+  if (pending_enc_in_ == nullptr) {
+    pending_enc_in_ = new NodeBIO();
+    pending_enc_in_->AssignEnvironment(env());
+  }
+
+  handshake_work_pending_ = false;
+  handshake_work_active_ = true;
+  NodeBIO::FromBIO(enc_in_)->DeferAccounting();
+  NodeBIO::FromBIO(enc_out_)->DeferAccounting();
+
+  // Keep the wrap alive until the work is done.
+  ClearWeak();
+  CHECK_EQ(0, threadpool::QueueWork(env()->event_loop(),
+                                    &handshake_req_,
+                                    threadpool::kCpuWork,
+                                    threadpool::kHighPriority,
+                                    HandshakeWork,
+                                    AfterHandshakeWork,
+                                    NODE_THREADPOOL_TRACE_CRYPTO,
+                                    "tls.handshake"));
+}
+
+
+void TLSWrap::HandshakeWork(uv_work_t* req) {
+  TLSWrap* w = ContainerOf(&TLSWrap::handshake_req_, req);
+
+  // The error queue is per thread, so errors are reported from here.
+  ERR_clear_error();
+
+  int ret = SSL_do_handshake(w->ssl_);
+  w->handshake_error_ =
+      ret == 1 ? SSL_ERROR_NONE : SSL_get_error(w->ssl_, ret);
+
+  if (w->handshake_error_ == SSL_ERROR_SSL ||
+      w->handshake_error_ == SSL_ERROR_SYSCALL) {
+    BIO* bio = BIO_new(BIO_s_mem());
+    ERR_print_errors(bio);
+
+    BUF_MEM* mem;
+    BIO_get_mem_ptr(bio, &mem);
+    w->handshake_error_message_.assign(mem->data, mem->length);
+    BIO_free_all(bio);
+  }
+
+  ERR_clear_error();
+}
+
+
+void TLSWrap::AfterHandshakeWork(uv_work_t* req, int status) {
+  CHECK_EQ(status, 0);
+  TLSWrap* w = ContainerOf(&TLSWrap::handshake_req_, req);
+  Environment* env = w->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  w->handshake_work_active_ = false;
+  w->MakeWeak(w);
+
+  NodeBIO* enc_in = NodeBIO::FromBIO(w->enc_in_);
+  enc_in->ResumeAccounting();
+  NodeBIO::FromBIO(w->enc_out_)->ResumeAccounting();
+
+  // Hand over the input that was received in the meantime
+  while (w->pending_enc_in_->Length() > 0) {
+    size_t avail = 0;
+    char* data = w->pending_enc_in_->Peek(&avail);
+    enc_in->Write(data, avail);
+    w->pending_enc_in_->Read(nullptr, avail);
+  }
+
+  if (w->destroy_ssl_pending_) {
+    w->SSLWrap<TLSWrap>::DestroySSL();
+    delete w->clear_in_;
+    w->clear_in_ = nullptr;
+    return;
+  }
+
+  const int info = w->handshake_info_;
+  w->handshake_info_ = 0;
+  if (info != 0) {
+    w->OnHandshakeInfo(info);
+    // The callbacks may have destroyed the SSL structure.
+    if (w->ssl_ == nullptr)
+      return;
+  }
+
+  const int err = w->handshake_error_;
+  w->handshake_error_ = SSL_ERROR_NONE;
+  if (err == SSL_ERROR_SSL || err == SSL_ERROR_SYSCALL) {
+    // Flush the alert before the connection is destroyed.
+    if (BIO_pending(w->enc_out_) != 0)
+      w->EncOut();
+
+    Local<String> message =
+        OneByteString(env->isolate(),
+                      w->handshake_error_message_.data(),
+                      w->handshake_error_message_.size());
+    w->handshake_error_message_.clear();
+    Local<Value> arg = Exception::Error(message);
+    w->MakeCallback(env->onerror_string(), 1, &arg);
+    return;
+  }
+
+  w->Cycle();
+}
+
+
 void TLSWrap::EncOut() {
   // Ignore cycling data if ClientHello wasn't yet parsed
   if (!hello_parser_.IsEnded())
     return;
 
+  // The threadpool is writing the next flight
+  if (handshake_work_active_)
+    return;
+
   // Write in progress
   if (write_size_ != 0)
     return;
@@ -364,6 +558,9 @@ void TLSWrap::EncOutCb(WriteWrap* req_wrap, int status) {
   // Try writing more data
   wrap->write_size_ = 0;
   wrap->EncOut();
+
+  // The handshake may have been waiting for the write to finish
+  wrap->StartHandshakeWork();
 }
 
 
@@ -423,28 +620,34 @@ void TLSWrap::ClearOut() {
   if (eof_)
     return;
 
-  if (ssl_ == nullptr)
+  if (ssl_ == nullptr || handshake_work_active_)
     return;
 
+  if (handshake_offloaded_ && !established_)
+    return StartHandshakeWork();
+
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
-  char out[kClearOutChunkSize];
   int read;
   for (;;) {
-    read = SSL_read(ssl_, out, sizeof(out));
+    // Have OpenSSL decrypt the next record without handing out any data yet,
+    // so that the plaintext can then be read straight into a buffer from the
+    // consumer instead of being copied there from an intermediate one.
+    char peek;
+    read = SSL_peek(ssl_, &peek, sizeof(peek));
 
     if (read <= 0)
       break;
 
-    char* current = out;
-    while (read > 0) {
-      int avail = read;
-
+    int pending = SSL_pending(ssl_);
+    while (pending > 0) {
       uv_buf_t buf;
-      OnAlloc(avail, &buf);
+      OnAlloc(pending, &buf);
+      int avail = pending;
       if (static_cast<int>(buf.len) < avail)
         avail = buf.len;
-      memcpy(buf.base, current, avail);
+      read = SSL_read(ssl_, buf.base, avail);
+      CHECK_EQ(read, avail);
       OnRead(avail, &buf);
 
       // Caveat emptor: OnRead() calls into JS land which can result in
@@ -453,8 +656,7 @@ void TLSWrap::ClearOut() {
       if (ssl_ == nullptr)
         return;
 
-      read -= avail;
-      current += avail;
+      pending -= avail;
     }
   }
 
@@ -482,8 +684,13 @@ void TLSWrap::ClearOut() {
         EncOut();
 
       MakeCallback(env()->onerror_string(), 1, &arg);
+      return;
     }
   }
+
+  // The cert callback may have paused the handshake to offload it
+  if (handshake_offloaded_)
+    StartHandshakeWork();
 }
 
 
@@ -492,7 +699,7 @@ bool TLSWrap::ClearIn() {
   if (!hello_parser_.IsEnded())
     return false;
 
-  if (ssl_ == nullptr)
+  if (ssl_ == nullptr || handshake_work_active_)
     return false;
 
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
@@ -500,12 +707,12 @@ bool TLSWrap::ClearIn() {
   int written = 0;
   while (clear_in_->Length() > 0) {
     size_t avail = 0;
+    size_t consumed = 0;
     char* data = clear_in_->Peek(&avail);
-    written = SSL_write(ssl_, data, avail);
-    CHECK(written == -1 || written == static_cast<int>(avail));
+    written = WriteRecords(data, avail, &consumed);
+    clear_in_->Read(nullptr, consumed);
     if (written == -1)
       break;
-    clear_in_->Read(nullptr, avail);
   }
 
   // All written
@@ -529,6 +736,36 @@ bool TLSWrap::ClearIn() {
 }
 
 
+int TLSWrap::WriteRecords(const char* data, size_t len, size_t* written) {
+  *written = 0;
+  if (len == 0)
+    return SSL_write(ssl_, data, 0);
+
+  if (record_size_small_ != 0) {
+    uint64_t now = uv_now(env()->event_loop());
+    if (now - last_record_time_ >= record_size_idle_timeout_)
+      record_bytes_written_ = 0;
+    last_record_time_ = now;
+  }
+
+  while (*written < len) {
+    size_t size = len - *written;
+    if (record_size_small_ != 0 &&
+        record_bytes_written_ < record_size_threshold_ &&
+        size > record_size_small_) {
+      size = record_size_small_;
+    }
+    int rv = SSL_write(ssl_, data + *written, size);
+    CHECK(rv == -1 || rv == static_cast<int>(size));
+    if (rv == -1)
+      return -1;
+    *written += size;
+    record_bytes_written_ += size;
+  }
+  return static_cast<int>(len);
+}
+
+
 void* TLSWrap::Cast() {
   return reinterpret_cast<void*>(this);
 }
@@ -600,7 +837,7 @@ int TLSWrap::DoWrite(WriteWrap* w,
     ClearOut();
     // However, if there is any data that should be written to the socket,
     // the callback should not be invoked immediately
-    if (BIO_pending(enc_out_) == 0)
+    if (!handshake_work_active_ && BIO_pending(enc_out_) == 0)
       return stream_->DoWrite(w, bufs, count, send_handle);
   }
 
@@ -635,9 +872,9 @@ int TLSWrap::DoWrite(WriteWrap* w,
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
   int written = 0;
+  size_t consumed = 0;
   for (i = 0; i < count; i++) {
-    written = SSL_write(ssl_, bufs[i].base, bufs[i].len);
-    CHECK(written == -1 || written == static_cast<int>(bufs[i].len));
+    written = WriteRecords(bufs[i].base, bufs[i].len, &consumed);
     if (written == -1)
       break;
   }
@@ -649,7 +886,8 @@ int TLSWrap::DoWrite(WriteWrap* w,
       return UV_EPROTO;
 
     // No errors, queue rest
-    for (; i < count; i++)
+    clear_in_->Write(bufs[i].base + consumed, bufs[i].len - consumed);
+    for (i++; i < count; i++)
       clear_in_->Write(bufs[i].base, bufs[i].len);
   }
 
@@ -673,8 +911,10 @@ void TLSWrap::OnAllocImpl(size_t suggested_size, uv_buf_t* buf, void* ctx) {
     return;
   }
 
+  NodeBIO* enc_in = wrap->handshake_work_active_ ?
+      wrap->pending_enc_in_ : NodeBIO::FromBIO(wrap->enc_in_);
   size_t size = 0;
-  buf->base = NodeBIO::FromBIO(wrap->enc_in_)->PeekWritable(&size);
+  buf->base = enc_in->PeekWritable(&size);
   buf->len = size;
 }
 
@@ -737,8 +977,11 @@ void TLSWrap::DoRead(ssize_t nread,
   }
 
   // Commit read data
-  NodeBIO* enc_in = NodeBIO::FromBIO(enc_in_);
+  NodeBIO* enc_in = handshake_work_active_ ?
+      pending_enc_in_ : NodeBIO::FromBIO(enc_in_);
   enc_in->Commit(nread);
+  if (handshake_offloaded_)
+    handshake_work_pending_ = true;
 
   // Parse ClientHello first
   if (!hello_parser_.IsEnded()) {
@@ -756,7 +999,7 @@ void TLSWrap::DoRead(ssize_t nread,
 int TLSWrap::DoShutdown(ShutdownWrap* req_wrap) {
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
-  if (ssl_ != nullptr && SSL_shutdown(ssl_) == 0)
+  if (ssl_ != nullptr && !handshake_work_active_ && SSL_shutdown(ssl_) == 0)
     SSL_shutdown(ssl_);
 
   shutdown_ = true;
@@ -825,6 +1068,12 @@ void TLSWrap::DestroySSL(const FunctionCallbackInfo<Value>& args) {
   // And destroy
   wrap->InvokeQueued(UV_ECANCELED, "Canceled because of SSL destruction");
 
+  // The threadpool is still using it, finish once it is done
+  if (wrap->handshake_work_active_) {
+    wrap->destroy_ssl_pending_ = true;
+    return;
+  }
+
   // Destroy the SSL structure and friends
   wrap->SSLWrap<TLSWrap>::DestroySSL();
 
@@ -840,6 +1089,29 @@ void TLSWrap::EnableCertCb(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void TLSWrap::EnableAsyncHandshake(const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  if (wrap->is_server())
+    wrap->async_handshake_ = true;
+}
+
+
+void TLSWrap::SetDynamicRecordSizing(
+    const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  CHECK(args[0]->IsUint32());
+  CHECK(args[1]->IsNumber());
+  CHECK(args[2]->IsNumber());
+  wrap->record_size_small_ = args[0]->Uint32Value();
+  wrap->record_size_threshold_ = args[1]->IntegerValue();
+  wrap->record_size_idle_timeout_ = args[2]->IntegerValue();
+  wrap->record_bytes_written_ = 0;
+}
+
+
 void TLSWrap::OnClientHelloParseEnd(void* arg) {
   TLSWrap* c = static_cast<TLSWrap*>(arg);
   c->Cycle();
@@ -945,6 +1217,8 @@ void TLSWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "enableSessionCallbacks", EnableSessionCallbacks);
   env->SetProtoMethod(t, "destroySSL", DestroySSL);
   env->SetProtoMethod(t, "enableCertCb", EnableCertCb);
+  env->SetProtoMethod(t, "enableAsyncHandshake", EnableAsyncHandshake);
+  env->SetProtoMethod(t, "setDynamicRecordSizing", SetDynamicRecordSizing);
 
   StreamBase::AddMethods<TLSWrap>(env, t, StreamBase::kFlagHasWritev);
   SSLWrap<TLSWrap>::AddMethods(env, t);
@@ -35,6 +35,8 @@
 
 #include <openssl/ssl.h>
 
+#include <string>
+
 namespace node {
 
 // Forward-declarations
@@ -78,8 +80,6 @@ class TLSWrap : public AsyncWrap,
   void clear_stream() { stream_ = nullptr; }
 
  protected:
-  static const int kClearOutChunkSize = 16384;
-
   // Maximum number of bytes for hello parser
   static const int kMaxHelloLength = 16384;
 
@@ -108,14 +108,30 @@ class TLSWrap : public AsyncWrap,
           crypto::SecureContext* sc);
 
   static void SSLInfoCallback(const SSL* ssl_, int where, int ret);
+  void OnHandshakeInfo(int where);
+  static int SSLCertCallback(SSL* s, void* arg);
   void InitSSL();
   void EncOut();
   static void EncOutCb(WriteWrap* req_wrap, int status);
   bool ClearIn();
+  // Passes |data| to SSL_write(), in records of record_size_small_ bytes
+  // while dynamic record sizing asks for small records. Returns -1 if a
+  // SSL_write() failed, with the number of bytes written before it in
+  // |written|.
+  int WriteRecords(const char* data, size_t len, size_t* written);
   void ClearOut();
   void MakePending();
   bool InvokeQueued(int status, const char* error_str = nullptr);
 
+  // Asynchronous handshakes: once the ClientHello of a full handshake has
+  // been processed, the server pauses the handshake and drives the rest of
+  // it, including the private key operations, from the threadpool. The SSL
+  // structure and its BIOs are left alone on the main thread meanwhile.
+  bool CanOffloadHandshake();
+  void StartHandshakeWork();
+  static void HandshakeWork(uv_work_t* req);
+  static void AfterHandshakeWork(uv_work_t* req, int status);
+
   inline void Cycle() {
     // Prevent recursion
     if (++cycle_depth_ > 1)
@@ -161,6 +177,10 @@ class TLSWrap : public AsyncWrap,
   static void EnableCertCb(
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DestroySSL(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void EnableAsyncHandshake(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetDynamicRecordSizing(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
 
 #ifdef SSL_CTRL_SET_TLSEXT_SERVERNAME_CB
   static void GetServername(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -186,6 +206,30 @@ class TLSWrap : public AsyncWrap,
   // If true - delivered EOF to the js-land, either after `close_notify`, or
   // after the `UV_EOF` on socket.
   bool eof_;
+
+  bool async_handshake_;
+  // The handshake of this connection is continued on the threadpool.
+  bool handshake_offloaded_;
+  bool handshake_work_active_;
+  // New input arrived, or the handshake paused, since the last work item.
+  bool handshake_work_pending_;
+  bool destroy_ssl_pending_;
+  // Info callbacks that fired on the threadpool, replayed afterwards.
+  int handshake_info_;
+  int handshake_error_;
+  std::string handshake_error_message_;
+  // Encrypted input that is received while the work item runs.
+  NodeBIO* pending_enc_in_;
+  uv_work_t handshake_req_;
+
+  // Dynamic record sizing: records of record_size_small_ bytes, or 0 when
+  // disabled, until record_size_threshold_ bytes have been written since
+  // the connection started or was idle for record_size_idle_timeout_ ms.
+  size_t record_size_small_;
+  uint64_t record_size_threshold_;
+  uint64_t record_size_idle_timeout_;
+  uint64_t record_bytes_written_;
+  uint64_t last_record_time_;
 };
 
 }  // namespace node
@@ -12,19 +12,53 @@ namespace tracing {
 using v8::platform::tracing::TraceConfig;
 using std::string;
 
-Agent::Agent() {}
-
-void Agent::Start(v8::Platform* platform, const string& enabled_categories) {
-  platform_ = platform;
-
-  int err = uv_loop_init(&tracing_loop_);
-  CHECK_EQ(err, 0);
+namespace {
+
+// Stands in for the NodeTraceBuffer until recording is first started. The
+// controller only hands out category flags while it has a buffer, and the
+// flags that call sites cache before then have to be the real ones.
+class DisabledTraceBuffer : public TraceBuffer {
+ public:
+  TraceObject* AddTraceEvent(uint64_t* handle) override {
+    *handle = 0;
+    return nullptr;
+  }
+  TraceObject* GetEventByHandle(uint64_t handle) override { return nullptr; }
+  bool Flush() override { return true; }
+};
 
-  NodeTraceWriter* trace_writer = new NodeTraceWriter(&tracing_loop_);
-  TraceBuffer* trace_buffer = new NodeTraceBuffer(
-      NodeTraceBuffer::kBufferChunks, trace_writer, &tracing_loop_);
+}  // anonymous namespace
 
+Agent::Agent(v8::Platform* platform, bool binary_format)
+    : platform_(platform), binary_format_(binary_format) {
   tracing_controller_ = new TracingController();
+  tracing_controller_->Initialize(new DisabledTraceBuffer());
+  v8::platform::SetTracingController(platform, tracing_controller_);
+}
+
+void Agent::Start(const string& enabled_categories) {
+  if (tracing_controller_ == nullptr) {
+    // Already shut down.
+    return;
+  }
+  if (!IsStarted()) {
+    int err = uv_loop_init(&tracing_loop_);
+    CHECK_EQ(err, 0);
+
+    trace_writer_ = new NodeTraceWriter(&tracing_loop_, binary_format_);
+    TraceBuffer* trace_buffer = new NodeTraceBuffer(
+        NodeTraceBuffer::kBufferChunks, trace_writer_, &tracing_loop_);
+
+    // This thread should be created *after* async handles are created
+    // (within NodeTraceWriter and NodeTraceBuffer constructors).
+    // Otherwise the thread could shut down prematurely.
+    err = uv_thread_create(&thread_, ThreadCb, this);
+    CHECK_EQ(err, 0);
+
+    // Nothing can have been added to the buffer that this replaces, every
+    // category has been disabled so far.
+    tracing_controller_->Initialize(trace_buffer);
+  }
 
   TraceConfig* trace_config = new TraceConfig();
   if (!enabled_categories.empty()) {
@@ -34,31 +68,50 @@ void Agent::Start(v8::Platform* platform, const string& enabled_categories) {
       getline(category_list, category, ',');
       trace_config->AddIncludedCategory(category.c_str());
     }
+    enabled_categories_ = enabled_categories;
   } else {
     trace_config->AddIncludedCategory("v8");
     trace_config->AddIncludedCategory("node");
+    enabled_categories_ = "v8,node";
   }
 
-  // This thread should be created *after* async handles are created
-  // (within NodeTraceWriter and NodeTraceBuffer constructors).
-  // Otherwise the thread could shut down prematurely.
-  err = uv_thread_create(&thread_, ThreadCb, this);
-  CHECK_EQ(err, 0);
-
-  tracing_controller_->Initialize(trace_buffer);
+  // Updates the flags of all categories, so that a change of categories
+  // while recording takes effect right away.
   tracing_controller_->StartTracing(trace_config);
-  v8::platform::SetTracingController(platform, tracing_controller_);
+  recording_ = true;
 }
 
 void Agent::Stop() {
+  if (!recording_) {
+    return;
+  }
+  recording_ = false;
+  enabled_categories_.clear();
+  // Flushes the TraceBuffer.
+  tracing_controller_->StopTracing();
+  trace_writer_->Rotate();
+}
+
+void Agent::Rotate() {
+  if (IsStarted()) {
+    trace_writer_->Rotate();
+  }
+}
+
+void Agent::Shutdown() {
+  // If recording never started, the platform disposes of the controller.
   if (!IsStarted()) {
     return;
   }
+  if (recording_) {
+    recording_ = false;
+    tracing_controller_->StopTracing();
+  }
   // Perform final Flush on TraceBuffer. We don't want the tracing controller
   // to flush the buffer again on destruction of the V8::Platform.
-  tracing_controller_->StopTracing();
   tracing_controller_->Initialize(nullptr);
   tracing_controller_ = nullptr;
+  trace_writer_ = nullptr;
 
   // Thread should finish when the tracing loop is stopped.
   uv_thread_join(&thread_);
@@ -6,23 +6,46 @@
 #include "uv.h"
 #include "v8.h"
 
+#include <string>
+
 namespace node {
 namespace tracing {
 
+// Owns the tracing controller of the platform for the lifetime of the
+// process, so that the category flags that the TRACE_EVENT macros cache stay
+// valid while recording is started, stopped and reconfigured at runtime.
+// Until recording is first started there is no tracing thread and every
+// category is disabled. All methods must be called on the main thread.
 class Agent {
  public:
-  explicit Agent();
-  void Start(v8::Platform* platform, const std::string& enabled_categories);
+  Agent(v8::Platform* platform, bool binary_format);
+
+  // Starts recording |enabled_categories|, a comma separated list, or
+  // switches to them if already recording. "v8,node" if empty.
+  void Start(const std::string& enabled_categories);
+  // Stops recording and ends the current log file.
   void Stop();
+  // Ends the current log file, later events are written to a new one.
+  void Rotate();
+  // Stops recording for good and uninstalls the tracing controller.
+  void Shutdown();
+
+  bool IsRecording() const { return recording_; }
+  const std::string& enabled_categories() const { return enabled_categories_; }
 
  private:
-  bool IsStarted() { return platform_ != nullptr; }
+  bool IsStarted() const { return trace_writer_ != nullptr; }
   static void ThreadCb(void* arg);
 
   uv_thread_t thread_;
   uv_loop_t tracing_loop_;
-  v8::Platform* platform_ = nullptr;
+  v8::Platform* platform_;
+  bool binary_format_;
+  bool recording_ = false;
+  std::string enabled_categories_;
   TracingController* tracing_controller_ = nullptr;
+  // Owned by the trace buffer, which is owned by tracing_controller_.
+  NodeTraceWriter* trace_writer_ = nullptr;
 };
 
 }  // namespace tracing
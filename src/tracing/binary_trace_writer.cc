@@ -0,0 +1,158 @@
+#include "tracing/binary_trace_writer.h"
+
+#include <string.h>
+
+#include "tracing/trace_event_common.h"
+#include "util.h"
+
+namespace node {
+namespace tracing {
+
+using v8::platform::tracing::TracingController;
+
+const char BinaryTraceWriter::kMagic[4] = { 'N', 'T', 'R', 'C' };
+
+BinaryTraceWriter::BinaryTraceWriter(std::ostream& stream) : stream_(stream) {
+  stream_.write(kMagic, sizeof(kMagic));
+  stream_.put(static_cast<char>(kVersion));
+}
+
+void BinaryTraceWriter::WriteVarint(std::string* out, uint64_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void BinaryTraceWriter::WriteSignedVarint(std::string* out, int64_t value) {
+  uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^
+                    static_cast<uint64_t>(value >> 63);
+  WriteVarint(out, zigzag);
+}
+
+void BinaryTraceWriter::WriteInlineString(std::string* out, const char* str) {
+  if (str == nullptr) {
+    WriteVarint(out, 0);
+    return;
+  }
+  size_t length = strlen(str);
+  WriteVarint(out, length + 1);
+  out->append(str, length);
+}
+
+uint32_t BinaryTraceWriter::AddString(const char* str, size_t length) {
+  uint32_t id = next_string_id_++;
+  string_records_.push_back(static_cast<char>(kStringRecord));
+  WriteVarint(&string_records_, id);
+  WriteVarint(&string_records_, length);
+  string_records_.append(str, length);
+  return id;
+}
+
+uint32_t BinaryTraceWriter::Intern(const char* str) {
+  if (str == nullptr)
+    return 0;
+  size_t length = strlen(str);
+  auto it = strings_.find(std::string(str, length));
+  if (it != strings_.end())
+    return it->second;
+  uint32_t id = AddString(str, length);
+  strings_.emplace(std::string(str, length), id);
+  return id;
+}
+
+uint32_t BinaryTraceWriter::InternStatic(const char* str) {
+  if (str == nullptr)
+    return 0;
+  auto it = static_strings_.find(str);
+  if (it != static_strings_.end())
+    return it->second;
+  uint32_t id = Intern(str);
+  static_strings_.emplace(str, id);
+  return id;
+}
+
+void BinaryTraceWriter::AppendTraceEvent(TraceObject* trace_event) {
+  // Names are only copied into the event when they might not outlive it.
+  const bool copied = (trace_event->flags() & TRACE_EVENT_FLAG_COPY) != 0;
+  auto intern_name = [&](const char* str) {
+    return copied ? Intern(str) : InternStatic(str);
+  };
+
+  std::string* out = &event_record_;
+  out->push_back(static_cast<char>(kEventRecord));
+  out->push_back(trace_event->phase());
+  WriteVarint(out, trace_event->pid());
+  WriteVarint(out, trace_event->tid());
+  WriteSignedVarint(out, trace_event->ts() - last_ts_);
+  WriteSignedVarint(out, trace_event->tts() - last_tts_);
+  last_ts_ = trace_event->ts();
+  last_tts_ = trace_event->tts();
+  WriteVarint(out, trace_event->duration());
+  WriteVarint(out, trace_event->cpu_duration());
+  WriteVarint(out, InternStatic(TracingController::GetCategoryGroupName(
+      trace_event->category_enabled_flag())));
+  WriteVarint(out, intern_name(trace_event->name()));
+  WriteVarint(out, trace_event->flags());
+  if (trace_event->flags() & TRACE_EVENT_FLAG_HAS_ID) {
+    WriteVarint(out, intern_name(trace_event->scope()));
+    WriteVarint(out, trace_event->id());
+  }
+
+  const int num_args = trace_event->num_args();
+  const char** arg_names = trace_event->arg_names();
+  const uint8_t* arg_types = trace_event->arg_types();
+  TraceObject::ArgValue* arg_values = trace_event->arg_values();
+  out->push_back(static_cast<char>(num_args));
+  for (int i = 0; i < num_args; i++) {
+    WriteVarint(out, intern_name(arg_names[i]));
+    out->push_back(static_cast<char>(arg_types[i]));
+    const TraceObject::ArgValue& value = arg_values[i];
+    switch (arg_types[i]) {
+      case TRACE_VALUE_TYPE_BOOL:
+        out->push_back(value.as_bool ? 1 : 0);
+        break;
+      case TRACE_VALUE_TYPE_UINT:
+        WriteVarint(out, value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        WriteSignedVarint(out, value.as_int);
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE: {
+        uint64_t bits;
+        memcpy(&bits, &value.as_double, sizeof(bits));
+        for (int shift = 0; shift < 64; shift += 8)
+          out->push_back(static_cast<char>(bits >> shift));
+        break;
+      }
+      case TRACE_VALUE_TYPE_POINTER:
+        WriteVarint(out, reinterpret_cast<uintptr_t>(value.as_pointer));
+        break;
+      case TRACE_VALUE_TYPE_STRING:
+        WriteVarint(out, InternStatic(value.as_string));
+        break;
+      case TRACE_VALUE_TYPE_COPY_STRING:
+        WriteInlineString(out, value.as_string);
+        break;
+      case TRACE_VALUE_TYPE_CONVERTABLE: {
+        std::string json;
+        trace_event->arg_convertables()[i]->AppendAsTraceFormat(&json);
+        WriteInlineString(out, json.c_str());
+        break;
+      }
+      default:
+        UNREACHABLE();
+    }
+  }
+
+  stream_.write(string_records_.data(), string_records_.size());
+  stream_.write(event_record_.data(), event_record_.size());
+  string_records_.clear();
+  event_record_.clear();
+}
+
+void BinaryTraceWriter::Flush() {}
+
+}  // namespace tracing
+}  // namespace node
@@ -0,0 +1,75 @@
+#ifndef SRC_TRACING_BINARY_TRACE_WRITER_H_
+#define SRC_TRACING_BINARY_TRACE_WRITER_H_
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "libplatform/v8-tracing.h"
+
+namespace node {
+namespace tracing {
+
+using v8::platform::tracing::TraceObject;
+using v8::platform::tracing::TraceWriter;
+
+// Writes trace events in a compact binary format instead of JSON. Integers
+// are LEB128 varints (zigzag encoded when signed), and names of events,
+// categories and arguments are only written out the first time they are
+// seen and referred to by an id afterwards. tools/trace-to-json.js turns
+// such a file back into the JSON format.
+//
+// A file starts with kMagic and a version byte, followed by records that
+// each start with a tag byte:
+//
+//   kStringRecord: id, length, bytes
+//   kEventRecord:  phase (byte), pid, tid, ts and tts (signed, relative to
+//                  the previous event), dur, tdur, category id, name id,
+//                  flags, [scope id (0 if none), id,] number of args (byte),
+//                  args
+//
+// Each argument is a name id and a TRACE_VALUE_TYPE_* byte followed by the
+// value. Doubles are 8 little-endian bytes. Strings with static lifetime are
+// interned (id 0 is NULL), copied strings and convertable values are written
+// inline as length + 1 (0 is NULL) and bytes.
+//
+// There is no trailer, so a file that was cut off can still be read up to
+// the last complete record.
+class BinaryTraceWriter : public TraceWriter {
+ public:
+  explicit BinaryTraceWriter(std::ostream& stream);
+
+  void AppendTraceEvent(TraceObject* trace_event) override;
+  void Flush() override;
+
+  static const char kMagic[4];
+  static const uint8_t kVersion = 1;
+  static const uint8_t kStringRecord = 1;
+  static const uint8_t kEventRecord = 2;
+
+ private:
+  uint32_t InternStatic(const char* str);
+  uint32_t Intern(const char* str);
+  uint32_t AddString(const char* str, size_t length);
+  static void WriteVarint(std::string* out, uint64_t value);
+  static void WriteSignedVarint(std::string* out, int64_t value);
+  static void WriteInlineString(std::string* out, const char* str);
+
+  std::ostream& stream_;
+  // Records of the event being appended and of the strings it introduces,
+  // which have to come before it.
+  std::string string_records_;
+  std::string event_record_;
+  // Strings that are not copied into their events, such as category groups
+  // and most names, are looked up by address before looking at content.
+  std::unordered_map<const char*, uint32_t> static_strings_;
+  std::unordered_map<std::string, uint32_t> strings_;
+  uint32_t next_string_id_ = 1;
+  int64_t last_ts_ = 0;
+  int64_t last_tts_ = 0;
+};
+
+}  // namespace tracing
+}  // namespace node
+
+#endif  // SRC_TRACING_BINARY_TRACE_WRITER_H_
@@ -3,98 +3,15 @@
 namespace node {
 namespace tracing {
 
-InternalTraceBuffer::InternalTraceBuffer(size_t max_chunks, uint32_t id,
-                                         NodeTraceWriter* trace_writer)
-    : flushing_(false), max_chunks_(max_chunks),
-      trace_writer_(trace_writer), id_(id) {
-  chunks_.resize(max_chunks);
-}
-
-TraceObject* InternalTraceBuffer::AddTraceEvent(uint64_t* handle) {
-  Mutex::ScopedLock scoped_lock(mutex_);
-  // Create new chunk if last chunk is full or there is no chunk.
-  if (total_chunks_ == 0 || chunks_[total_chunks_ - 1]->IsFull()) {
-    auto& chunk = chunks_[total_chunks_++];
-    if (chunk) {
-      chunk->Reset(current_chunk_seq_++);
-    } else {
-      chunk.reset(new TraceBufferChunk(current_chunk_seq_++));
-    }
-  }
-  auto& chunk = chunks_[total_chunks_ - 1];
-  size_t event_index;
-  TraceObject* trace_object = chunk->AddTraceEvent(&event_index);
-  *handle = MakeHandle(total_chunks_ - 1, chunk->seq(), event_index);
-  return trace_object;
-}
-
-TraceObject* InternalTraceBuffer::GetEventByHandle(uint64_t handle) {
-  Mutex::ScopedLock scoped_lock(mutex_);
-  if (handle == 0) {
-    // A handle value of zero never has a trace event associated with it.
-    return NULL;
-  }
-  size_t chunk_index, event_index;
-  uint32_t buffer_id, chunk_seq;
-  ExtractHandle(handle, &buffer_id, &chunk_index, &chunk_seq, &event_index);
-  if (buffer_id != id_ || chunk_index >= total_chunks_) {
-    // Either the chunk belongs to the other buffer, or is outside the current
-    // range of chunks loaded in memory (the latter being true suggests that
-    // the chunk has already been flushed and is no longer in memory.)
-    return NULL;
-  }
-  auto& chunk = chunks_[chunk_index];
-  if (chunk->seq() != chunk_seq) {
-    // Chunk is no longer in memory.
-    return NULL;
-  }
-  return chunk->GetEventAt(event_index);
-}
-
-void InternalTraceBuffer::Flush(bool blocking) {
-  {
-    Mutex::ScopedLock scoped_lock(mutex_);
-    if (total_chunks_ > 0) {
-      flushing_ = true;
-      for (size_t i = 0; i < total_chunks_; ++i) {
-        auto& chunk = chunks_[i];
-        for (size_t j = 0; j < chunk->size(); ++j) {
-          trace_writer_->AppendTraceEvent(chunk->GetEventAt(j));
-        }
-      }
-      total_chunks_ = 0;
-      flushing_ = false;
-    }
-  }
-  trace_writer_->Flush(blocking);
-}
-
-uint64_t InternalTraceBuffer::MakeHandle(
-    size_t chunk_index, uint32_t chunk_seq, size_t event_index) const {
-  return ((static_cast<uint64_t>(chunk_seq) * Capacity() +
-          chunk_index * TraceBufferChunk::kChunkSize + event_index) << 1) + id_;
-}
-
-void InternalTraceBuffer::ExtractHandle(
-    uint64_t handle, uint32_t* buffer_id, size_t* chunk_index,
-    uint32_t* chunk_seq, size_t* event_index) const {
-  *buffer_id = static_cast<uint32_t>(handle & 0x1);
-  handle >>= 1;
-  *chunk_seq = static_cast<uint32_t>(handle / Capacity());
-  size_t indices = handle % Capacity();
-  *chunk_index = indices / TraceBufferChunk::kChunkSize;
-  *event_index = indices % TraceBufferChunk::kChunkSize;
-}
-
 NodeTraceBuffer::NodeTraceBuffer(size_t max_chunks,
     NodeTraceWriter* trace_writer, uv_loop_t* tracing_loop)
     : tracing_loop_(tracing_loop), trace_writer_(trace_writer),
-      buffer1_(max_chunks, 0, trace_writer),
-      buffer2_(max_chunks, 1, trace_writer) {
-  current_buf_.store(&buffer1_);
+      max_chunks_(max_chunks) {
+  int err = uv_key_create(&thread_key_);
+  CHECK_EQ(err, 0);
 
   flush_signal_.data = this;
-  int err = uv_async_init(tracing_loop_, &flush_signal_, NonBlockingFlushSignalCb);
+  err = uv_async_init(tracing_loop_, &flush_signal_, NonBlockingFlushSignalCb);
   CHECK_EQ(err, 0);
 
   exit_signal_.data = this;
@@ -108,57 +25,149 @@ NodeTraceBuffer::~NodeTraceBuffer() {
   while(!exited_) {
     exit_cond_.Wait(scoped_lock);
   }
+  for (auto& thread_buffer : thread_buffers_)
+    delete thread_buffer->chunk;
+  uv_key_delete(&thread_key_);
+}
+
+NodeTraceBuffer::ThreadBuffer* NodeTraceBuffer::GetThreadBuffer() {
+  ThreadBuffer* thread_buffer =
+      static_cast<ThreadBuffer*>(uv_key_get(&thread_key_));
+  if (thread_buffer == nullptr) {
+    thread_buffer = new ThreadBuffer();
+    uv_key_set(&thread_key_, thread_buffer);
+    Mutex::ScopedLock scoped_lock(mutex_);
+    thread_buffers_.emplace_back(thread_buffer);
+  }
+  return thread_buffer;
+}
+
+// Hands over full_chunk (if any) for writing and returns an empty chunk, or
+// nullptr if all max_chunks_ chunks are in use.
+TraceBufferChunk* NodeTraceBuffer::ReplaceChunk(TraceBufferChunk* full_chunk) {
+  bool should_flush = false;
+  TraceBufferChunk* chunk = nullptr;
+  {
+    Mutex::ScopedLock scoped_lock(mutex_);
+    if (full_chunk != nullptr) {
+      full_chunks_.emplace_back(full_chunk);
+      should_flush = full_chunks_.size() >= max_chunks_ / 2;
+    }
+    if (!free_chunks_.empty()) {
+      chunk = free_chunks_.back().release();
+      free_chunks_.pop_back();
+      chunk->Reset(next_chunk_seq_++);
+    } else if (total_chunks_ < max_chunks_) {
+      chunk = new TraceBufferChunk(next_chunk_seq_++);
+      total_chunks_++;
+    } else {
+      should_flush = true;
+    }
+    if (chunk != nullptr)
+      live_chunks_[chunk->seq()] = chunk;
+  }
+  if (should_flush)
+    uv_async_send(&flush_signal_);  // trigger flush on a separate thread
+  return chunk;
 }
 
 TraceObject* NodeTraceBuffer::AddTraceEvent(uint64_t* handle) {
-  // If the buffer is full, attempt to perform a flush.
-  if (!TryLoadAvailableBuffer()) {
-    // Assign a value of zero as the trace event handle.
-    // This is equivalent to calling InternalTraceBuffer::MakeHandle(0, 0, 0),
-    // and will cause GetEventByHandle to return NULL if passed as an argument.
-    *handle = 0;
-    return nullptr;
+  ThreadBuffer* thread_buffer = GetThreadBuffer();
+  TraceBufferChunk* chunk = thread_buffer->chunk;
+  if (chunk == nullptr || chunk->IsFull()) {
+    chunk = thread_buffer->chunk = ReplaceChunk(chunk);
+    if (chunk == nullptr) {
+      // Assign a value of zero as the trace event handle, which will cause
+      // GetEventByHandle to return NULL if passed as an argument.
+      *handle = 0;
+      return nullptr;
+    }
   }
-  return current_buf_.load()->AddTraceEvent(handle);
+  size_t event_index;
+  TraceObject* trace_object = chunk->AddTraceEvent(&event_index);
+  *handle = MakeHandle(chunk->seq(), event_index);
+  return trace_object;
 }
 
 TraceObject* NodeTraceBuffer::GetEventByHandle(uint64_t handle) {
-  return current_buf_.load()->GetEventByHandle(handle);
+  if (handle == 0) {
+    // A handle value of zero never has a trace event associated with it.
+    return NULL;
+  }
+  uint32_t chunk_seq =
+      static_cast<uint32_t>(handle / TraceBufferChunk::kChunkSize);
+  size_t event_index = handle % TraceBufferChunk::kChunkSize;
+
+  // Most events are looked up again by their own thread, so that their
+  // duration can be set, while it is still filling the same chunk.
+  ThreadBuffer* thread_buffer =
+      static_cast<ThreadBuffer*>(uv_key_get(&thread_key_));
+  if (thread_buffer != nullptr && thread_buffer->chunk != nullptr &&
+      thread_buffer->chunk->seq() == chunk_seq) {
+    return thread_buffer->chunk->GetEventAt(event_index);
+  }
+
+  Mutex::ScopedLock scoped_lock(mutex_);
+  auto it = live_chunks_.find(chunk_seq);
+  if (it == live_chunks_.end()) {
+    // The chunk has already been flushed and is no longer in memory.
+    return NULL;
+  }
+  return it->second->GetEventAt(event_index);
 }
 
 bool NodeTraceBuffer::Flush() {
-  buffer1_.Flush(true);
-  buffer2_.Flush(true);
+  FlushPrivate(true);
   return true;
 }
 
-// Attempts to set current_buf_ such that it references a buffer that can
-// can write at least one trace event. If both buffers are unavailable this
-// method returns false; otherwise it returns true.
-bool NodeTraceBuffer::TryLoadAvailableBuffer() {
-  InternalTraceBuffer* prev_buf = current_buf_.load();
-  if (prev_buf->IsFull()) {
-    uv_async_send(&flush_signal_); // trigger flush on a separate thread
-    InternalTraceBuffer* other_buf = prev_buf == &buffer1_ ?
-      &buffer2_ : &buffer1_;
-    if (!other_buf->IsFull()) {
-      current_buf_.store(other_buf);
-    } else {
-      return false;
+void NodeTraceBuffer::FlushPrivate(bool blocking) {
+  {
+    Mutex::ScopedLock flush_scoped_lock(flush_mutex_);
+    std::vector<std::unique_ptr<TraceBufferChunk>> chunks;
+    {
+      Mutex::ScopedLock scoped_lock(mutex_);
+      chunks.swap(full_chunks_);
+      if (blocking) {
+        // This is the final flush, which also takes the chunks that threads
+        // are still filling.
+        for (auto& thread_buffer : thread_buffers_) {
+          if (thread_buffer->chunk != nullptr) {
+            chunks.emplace_back(thread_buffer->chunk);
+            thread_buffer->chunk = nullptr;
+          }
+        }
+      }
+    }
+
+    // Threads can keep adding events while these are written.
+    for (auto& chunk : chunks) {
+      for (size_t j = 0; j < chunk->size(); ++j) {
+        trace_writer_->AppendTraceEvent(chunk->GetEventAt(j));
+      }
+    }
+
+    Mutex::ScopedLock scoped_lock(mutex_);
+    for (auto& chunk : chunks) {
+      live_chunks_.erase(chunk->seq());
+      free_chunks_.push_back(std::move(chunk));
     }
   }
-  return true;
+  // A blocking flush waits for the tracing thread, which may be about to
+  // take flush_mutex_ itself.
+  trace_writer_->Flush(blocking);
+}
+
+uint64_t NodeTraceBuffer::MakeHandle(uint32_t chunk_seq, size_t event_index) {
+  // Sequence numbers start at 1, so that no event gets a handle of zero.
+  return static_cast<uint64_t>(chunk_seq) * TraceBufferChunk::kChunkSize +
+         event_index;
 }
 
 // static
 void NodeTraceBuffer::NonBlockingFlushSignalCb(uv_async_t* signal) {
   NodeTraceBuffer* buffer = reinterpret_cast<NodeTraceBuffer*>(signal->data);
-  if (buffer->buffer1_.IsFull() && !buffer->buffer1_.IsFlushing()) {
-    buffer->buffer1_.Flush(false);
-  }
-  if (buffer->buffer2_.IsFull() && !buffer->buffer2_.IsFlushing()) {
-    buffer->buffer2_.Flush(false);
-  }
+  buffer->FlushPrivate(false);
 }
 
 // static
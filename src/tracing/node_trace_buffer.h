@@ -4,8 +4,11 @@
 #include "node_mutex.h"
 #include "tracing/node_trace_writer.h"
 #include "libplatform/v8-tracing.h"
+#include "uv.h"
 
-#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace node {
 namespace tracing {
@@ -14,41 +17,10 @@ using v8::platform::tracing::TraceBuffer;
 using v8::platform::tracing::TraceBufferChunk;
 using v8::platform::tracing::TraceObject;
 
-// forward declaration
-class NodeTraceBuffer;
-
-class InternalTraceBuffer {
- public:
-  InternalTraceBuffer(size_t max_chunks, uint32_t id,
-                      NodeTraceWriter* trace_writer);
-
-  TraceObject* AddTraceEvent(uint64_t* handle);
-  TraceObject* GetEventByHandle(uint64_t handle);
-  void Flush(bool blocking);
-  bool IsFull() const {
-    return total_chunks_ == max_chunks_ && chunks_[total_chunks_ - 1]->IsFull();
-  }
-  bool IsFlushing() const {
-    return flushing_;
-  }
-
- private:
-  uint64_t MakeHandle(size_t chunk_index, uint32_t chunk_seq,
-                      size_t event_index) const;
-  void ExtractHandle(uint64_t handle, uint32_t* buffer_id, size_t* chunk_index,
-                     uint32_t* chunk_seq, size_t* event_index) const;
-  size_t Capacity() const { return max_chunks_ * TraceBufferChunk::kChunkSize; }
-
-  Mutex mutex_;
-  bool flushing_;
-  size_t max_chunks_;
-  NodeTraceWriter* trace_writer_;
-  std::vector<std::unique_ptr<TraceBufferChunk>> chunks_;
-  size_t total_chunks_ = 0;
-  uint32_t current_chunk_seq_ = 1;
-  uint32_t id_;
-};
-
+// Each thread that adds trace events fills a TraceBufferChunk of its own
+// without locking, and only takes mutex_ to hand a full chunk over and take
+// an empty one, once every TraceBufferChunk::kChunkSize events. Chunks that
+// have been handed over are written out on the tracing thread.
 class NodeTraceBuffer : public TraceBuffer {
  public:
   NodeTraceBuffer(size_t max_chunks, NodeTraceWriter* trace_writer,
@@ -59,10 +31,18 @@ class NodeTraceBuffer : public TraceBuffer {
   TraceObject* GetEventByHandle(uint64_t handle) override;
   bool Flush() override;
 
-  static const size_t kBufferChunks = 1024;
+  static const size_t kBufferChunks = 2048;
 
  private:
-  bool TryLoadAvailableBuffer();
+  struct ThreadBuffer {
+    // Only read or written by its thread, except by the final Flush().
+    TraceBufferChunk* chunk = nullptr;
+  };
+
+  ThreadBuffer* GetThreadBuffer();
+  TraceBufferChunk* ReplaceChunk(TraceBufferChunk* full_chunk);
+  void FlushPrivate(bool blocking);
+  static uint64_t MakeHandle(uint32_t chunk_seq, size_t event_index);
   static void NonBlockingFlushSignalCb(uv_async_t* signal);
   static void ExitSignalCb(uv_async_t* signal);
 
@@ -75,10 +55,22 @@ class NodeTraceBuffer : public TraceBuffer {
   // Used to wait until async handles have been closed.
   ConditionVariable exit_cond_;
   std::unique_ptr<NodeTraceWriter> trace_writer_;
-  // TODO: Change std::atomic to something less contentious.
-  std::atomic<InternalTraceBuffer*> current_buf_;
-  InternalTraceBuffer buffer1_;
-  InternalTraceBuffer buffer2_;
+  // Keeps flushes on the tracing thread and the final one apart.
+  Mutex flush_mutex_;
+  uv_key_t thread_key_;
+
+  // Everything below is protected by mutex_.
+  Mutex mutex_;
+  size_t max_chunks_;
+  size_t total_chunks_ = 0;
+  uint32_t next_chunk_seq_ = 1;
+  std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers_;
+  std::vector<std::unique_ptr<TraceBufferChunk>> free_chunks_;
+  // Full chunks that are waiting to be written.
+  std::vector<std::unique_ptr<TraceBufferChunk>> full_chunks_;
+  // Chunks that have not been written yet, by sequence number, so that
+  // GetEventByHandle() can still find events after their thread moved on.
+  std::unordered_map<uint32_t, TraceBufferChunk*> live_chunks_;
 };
 
 }  // namespace tracing
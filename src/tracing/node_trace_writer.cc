@@ -3,13 +3,14 @@
 #include <string.h>
 #include <fcntl.h>
 
+#include "tracing/binary_trace_writer.h"
 #include "util.h"
 
 namespace node {
 namespace tracing {
 
-NodeTraceWriter::NodeTraceWriter(uv_loop_t* tracing_loop)
-    : tracing_loop_(tracing_loop) {
+NodeTraceWriter::NodeTraceWriter(uv_loop_t* tracing_loop, bool binary_format)
+    : tracing_loop_(tracing_loop), binary_format_(binary_format) {
   flush_signal_.data = this;
   int err = uv_async_init(tracing_loop_, &flush_signal_, FlushSignalCb);
   CHECK_EQ(err, 0);
@@ -28,8 +29,8 @@ void NodeTraceWriter::WriteSuffix() {
     Mutex::ScopedLock scoped_lock(stream_mutex_);
     if (total_traces_ > 0) {
       total_traces_ = 0; // so we don't write it again in FlushPrivate
-      // Appends "]}" to stream_.
-      delete json_trace_writer_;
+      // Appends "]}" to stream_ in the JSON format.
+      delete trace_writer_;
       should_flush = true;
     }
   }
@@ -58,7 +59,8 @@ void NodeTraceWriter::OpenNewFileForStreaming() {
   ++file_num_;
   uv_fs_t req;
   std::ostringstream log_file;
-  log_file << "node_trace." << file_num_ << ".log";
+  log_file << "node_trace." << file_num_
+           << (binary_format_ ? ".bin" : ".log");
   fd_ = uv_fs_open(tracing_loop_, &req, log_file.str().c_str(),
       O_CREAT | O_WRONLY | O_TRUNC, 0644, NULL);
   CHECK_NE(fd_, -1);
@@ -74,35 +76,51 @@ void NodeTraceWriter::AppendTraceEvent(TraceObject* trace_event) {
     // to stream_.
     // In other words, the constructor initializes the serialization stream
     // to a state where we can start writing trace events to it.
-    // Repeatedly constructing and destroying json_trace_writer_ allows
+    // Repeatedly constructing and destroying trace_writer_ allows
     // us to use V8's JSON writer instead of implementing our own.
-    json_trace_writer_ = TraceWriter::CreateJSONTraceWriter(stream_);
+    // The binary writer starts a file with its header the same way, and
+    // begins a new table of interned strings with every file.
+    if (binary_format_)
+      trace_writer_ = new BinaryTraceWriter(stream_);
+    else
+      trace_writer_ = TraceWriter::CreateJSONTraceWriter(stream_);
   }
   ++total_traces_;
-  json_trace_writer_->AppendTraceEvent(trace_event);
+  trace_writer_->AppendTraceEvent(trace_event);
 }
 
 void NodeTraceWriter::FlushPrivate() {
   std::string str;
+  int fd;
+  bool end_file = false;
   int highest_request_id;
   {
     Mutex::ScopedLock stream_scoped_lock(stream_mutex_);
-    if (total_traces_ >= kTracesPerFile) {
+    if (total_traces_ >= kTracesPerFile ||
+        (rotate_requested_ && total_traces_ > 0)) {
       total_traces_ = 0;
       // Destroying the member JSONTraceWriter object appends "]}" to
       // stream_ - in other words, ending a JSON file.
-      delete json_trace_writer_;
+      delete trace_writer_;
+      trace_writer_ = nullptr;
+      end_file = true;
     }
+    rotate_requested_ = false;
     // str() makes a copy of the contents of the stream.
     str = stream_.str();
     stream_.str("");
     stream_.clear();
+    // The next trace event opens a new file, which must not get what is
+    // left of this one.
+    fd = fd_;
+    if (end_file)
+      fd_ = -1;
   }
   {
     Mutex::ScopedLock request_scoped_lock(request_mutex_);
     highest_request_id = num_write_requests_;
   }
-  WriteToFile(std::move(str), highest_request_id);
+  WriteToFile(std::move(str), fd, end_file, highest_request_id);
 }
 
 void NodeTraceWriter::FlushSignalCb(uv_async_t* signal) {
@@ -118,9 +136,6 @@ void NodeTraceWriter::Flush() {
 
 void NodeTraceWriter::Flush(bool blocking) {
   Mutex::ScopedLock scoped_lock(request_mutex_);
-  if (!json_trace_writer_) {
-    return;
-  }
   int request_id = ++num_write_requests_;
   int err = uv_async_send(&flush_signal_);
   CHECK_EQ(err, 0);
@@ -134,11 +149,36 @@ void NodeTraceWriter::Flush(bool blocking) {
   }
 }
 
-void NodeTraceWriter::WriteToFile(std::string&& str, int highest_request_id) {
+void NodeTraceWriter::Rotate() {
+  {
+    Mutex::ScopedLock scoped_lock(stream_mutex_);
+    if (total_traces_ == 0)
+      return;
+    rotate_requested_ = true;
+  }
+  Flush(true);
+}
+
+void NodeTraceWriter::WriteToFile(std::string&& str, int fd, bool close_fd,
+                                  int highest_request_id) {
+  if (fd == -1) {
+    // Nothing has been appended since the last file was ended, there is
+    // only this request to complete.
+    Mutex::ScopedLock scoped_lock(request_mutex_);
+    if (write_req_queue_.empty()) {
+      highest_request_id_completed_ = highest_request_id;
+      request_cond_.Broadcast(scoped_lock);
+    } else {
+      write_req_queue_.back()->highest_request_id = highest_request_id;
+    }
+    return;
+  }
   WriteRequest* write_req = new WriteRequest();
   write_req->str = std::move(str);
   write_req->writer = this;
   write_req->highest_request_id = highest_request_id;
+  write_req->fd = fd;
+  write_req->close_fd = close_fd;
   uv_buf_t uv_buf = uv_buf_init(const_cast<char*>(write_req->str.c_str()),
       write_req->str.length());
   request_mutex_.Lock();
@@ -149,7 +189,7 @@ void NodeTraceWriter::WriteToFile(std::string&& str, int highest_request_id) {
   write_req_queue_.push(write_req);
   request_mutex_.Unlock();
   int err = uv_fs_write(tracing_loop_, reinterpret_cast<uv_fs_t*>(write_req),
-      fd_, &uv_buf, 1, -1, WriteCb);
+      fd, &uv_buf, 1, -1, WriteCb);
   CHECK_EQ(err, 0);
 }
 
@@ -158,12 +198,18 @@ void NodeTraceWriter::WriteCb(uv_fs_t* req) {
   CHECK_GE(write_req->req.result, 0);
 
   NodeTraceWriter* writer = write_req->writer;
-  int highest_request_id = write_req->highest_request_id;
+  if (write_req->close_fd) {
+    uv_fs_t close_req;
+    int err = uv_fs_close(writer->tracing_loop_, &close_req, write_req->fd,
+                          nullptr);
+    CHECK_EQ(err, 0);
+    uv_fs_req_cleanup(&close_req);
+  }
   {
     Mutex::ScopedLock scoped_lock(writer->request_mutex_);
     CHECK_EQ(write_req, writer->write_req_queue_.front());
     writer->write_req_queue_.pop();
-    writer->highest_request_id_completed_ = highest_request_id;
+    writer->highest_request_id_completed_ = write_req->highest_request_id;
     writer->request_cond_.Broadcast(scoped_lock);
   }
   delete write_req;
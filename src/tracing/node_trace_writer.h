@@ -17,12 +17,15 @@ using v8::platform::tracing::TracingController;
 
 class NodeTraceWriter : public TraceWriter {
  public:
-  NodeTraceWriter(uv_loop_t* tracing_loop);
+  NodeTraceWriter(uv_loop_t* tracing_loop, bool binary_format);
   ~NodeTraceWriter();
 
   void AppendTraceEvent(TraceObject* trace_event) override;
   void Flush() override;
   void Flush(bool blocking);
+  // Ends the current file once what has been appended so far is written,
+  // so that the next trace event starts a new one.
+  void Rotate();
 
   static const int kTracesPerFile = 1 << 19;
 
@@ -32,11 +35,15 @@ class NodeTraceWriter : public TraceWriter {
     NodeTraceWriter* writer;
     std::string str;
     int highest_request_id;
+    int fd;
+    // Set for the last write to a file that has been ended.
+    bool close_fd;
   };
 
   static void WriteCb(uv_fs_t* req);
   void OpenNewFileForStreaming();
-  void WriteToFile(std::string&& str, int highest_request_id);
+  void WriteToFile(std::string&& str, int fd, bool close_fd,
+                   int highest_request_id);
   void WriteSuffix();
   static void FlushSignalCb(uv_async_t* signal);
   void FlushPrivate();
@@ -63,8 +70,11 @@ class NodeTraceWriter : public TraceWriter {
   int highest_request_id_completed_ = 0;
   int total_traces_ = 0;
   int file_num_ = 0;
+  bool rotate_requested_ = false;
   std::ostringstream stream_;
-  TraceWriter* json_trace_writer_ = nullptr;
+  // Either a JSONTraceWriter or a BinaryTraceWriter.
+  TraceWriter* trace_writer_ = nullptr;
+  bool binary_format_;
   bool exited_ = false;
 };
 
@@ -30,6 +30,19 @@
 #include "util-inl.h"
 
 #include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#if defined(__linux__) && !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
 
 
 namespace node {
@@ -38,6 +51,7 @@ using v8::Array;
 using v8::Context;
 using v8::EscapableHandleScope;
 using v8::External;
+using v8::False;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
@@ -76,6 +90,30 @@ inline bool SendWrap::have_callback() const {
 }
 
 
+class SendBatchWrap : public ReqWrap<uv_udp_send_t> {
+ public:
+  SendBatchWrap(Environment* env, Local<Object> req_wrap_obj, size_t count);
+  // req() sends the first datagram, these send the others.
+  std::vector<uv_udp_send_t> reqs;
+  size_t pending;
+  size_t msg_size;
+  int status;
+  size_t self_size() const override { return sizeof(*this); }
+};
+
+
+SendBatchWrap::SendBatchWrap(Environment* env,
+                             Local<Object> req_wrap_obj,
+                             size_t count)
+    : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_UDPSENDWRAP),
+      reqs(count - 1),
+      pending(0),
+      msg_size(0),
+      status(0) {
+  Wrap(req_wrap_obj, this);
+}
+
+
 static void NewSendWrap(const FunctionCallbackInfo<Value>& args) {
   CHECK(args.IsConstructCall());
 }
@@ -85,12 +123,20 @@ UDPWrap::UDPWrap(Environment* env, Local<Object> object, AsyncWrap* parent)
     : HandleWrap(env,
                  object,
                  reinterpret_cast<uv_handle_t*>(&handle_),
-                 AsyncWrap::PROVIDER_UDPWRAP) {
+                 AsyncWrap::PROVIDER_UDPWRAP),
+      batch_size_(0),
+      batch_data_(nullptr),
+      connected_(false) {
   int r = uv_udp_init(env->event_loop(), &handle_);
   CHECK_EQ(r, 0);  // can't fail anyway
 }
 
 
+UDPWrap::~UDPWrap() {
+  free(batch_data_);
+}
+
+
 void UDPWrap::Initialize(Local<Object> target,
                          Local<Value> unused,
                          Local<Context> context) {
@@ -113,6 +159,11 @@ void UDPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "send", Send);
   env->SetProtoMethod(t, "bind6", Bind6);
   env->SetProtoMethod(t, "send6", Send6);
+  env->SetProtoMethod(t, "sendBatch", SendBatch);
+  env->SetProtoMethod(t, "sendBatch6", SendBatch6);
+  env->SetProtoMethod(t, "connect", Connect);
+  env->SetProtoMethod(t, "connect6", Connect6);
+  env->SetProtoMethod(t, "sendConnected", SendConnected);
   env->SetProtoMethod(t, "close", Close);
   env->SetProtoMethod(t, "recvStart", RecvStart);
   env->SetProtoMethod(t, "recvStop", RecvStop);
@@ -124,6 +175,7 @@ void UDPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "setMulticastLoopback", SetMulticastLoopback);
   env->SetProtoMethod(t, "setBroadcast", SetBroadcast);
   env->SetProtoMethod(t, "setTTL", SetTTL);
+  env->SetProtoMethod(t, "setSegmentSize", SetSegmentSize);
 
   env->SetProtoMethod(t, "ref", HandleWrap::Ref);
   env->SetProtoMethod(t, "unref", HandleWrap::Unref);
@@ -216,6 +268,23 @@ void UDPWrap::Bind6(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Makes the kernel split each datagram that is sent into datagrams of `size`
+// bytes, the last one can be shorter. 0 turns it off.
+static int SetUDPSegment(uv_udp_t* handle, int size) {
+#ifdef __linux__
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(handle), &fd);
+  if (err)
+    return err;
+  if (setsockopt(fd, IPPROTO_UDP, UDP_SEGMENT, &size, sizeof(size)))
+    return -errno;
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
 #define X(name, fn)                                                           \
   void UDPWrap::name(const FunctionCallbackInfo<Value>& args) {               \
     UDPWrap* wrap = Unwrap<UDPWrap>(args.Holder());                           \
@@ -229,6 +298,7 @@ X(SetTTL, uv_udp_set_ttl)
 X(SetBroadcast, uv_udp_set_broadcast)
 X(SetMulticastTTL, uv_udp_set_multicast_ttl)
 X(SetMulticastLoopback, uv_udp_set_multicast_loop)
+X(SetSegmentSize, SetUDPSegment)
 
 #undef X
 
@@ -352,11 +422,322 @@ void UDPWrap::Send6(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// The kernel remembers the peer of a connected socket, so sends need no
+// address and only see datagrams from it.
+static int ConnectSocket(uv_udp_t* handle, const sockaddr* addr) {
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(handle), &fd);
+  if (err)
+    return err;
+
+  const int addrlen = addr->sa_family == AF_INET6 ?
+      sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+#ifdef _WIN32
+  if (connect(reinterpret_cast<SOCKET>(fd), addr, addrlen) == SOCKET_ERROR)
+    return uv_translate_sys_error(WSAGetLastError());
+#else
+  if (connect(fd, addr, addrlen) != 0)
+    return uv_translate_sys_error(errno);
+#endif
+  return 0;
+}
+
+
+void UDPWrap::DoConnect(const FunctionCallbackInfo<Value>& args, int family) {
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+
+  // connect(ip, port)
+  CHECK_EQ(args.Length(), 2);
+
+  node::Utf8Value address(args.GetIsolate(), args[0]);
+  const int port = args[1]->Uint32Value();
+  sockaddr_storage addr;
+  int err;
+
+  switch (family) {
+  case AF_INET:
+    err = uv_ip4_addr(*address, port, reinterpret_cast<sockaddr_in*>(&addr));
+    break;
+  case AF_INET6:
+    err = uv_ip6_addr(*address, port, reinterpret_cast<sockaddr_in6*>(&addr));
+    break;
+  default:
+    CHECK(0 && "unexpected address family");
+    ABORT();
+  }
+
+  if (err == 0)
+    err = ConnectSocket(&wrap->handle_, reinterpret_cast<sockaddr*>(&addr));
+
+  if (err == 0) {
+    wrap->peer_ = addr;
+    wrap->connected_ = true;
+  }
+
+  args.GetReturnValue().Set(err);
+}
+
+
+void UDPWrap::Connect(const FunctionCallbackInfo<Value>& args) {
+  DoConnect(args, AF_INET);
+}
+
+
+void UDPWrap::Connect6(const FunctionCallbackInfo<Value>& args) {
+  DoConnect(args, AF_INET6);
+}
+
+
+void UDPWrap::SendConnected(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+
+  if (!wrap->connected_)
+    return args.GetReturnValue().Set(UV_ENOTCONN);
+
+  // sendConnected(req, list, list.length, hasCallback)
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsUint32());
+  CHECK(args[3]->IsBoolean());
+
+  Local<Object> req_wrap_obj = args[0].As<Object>();
+  Local<Array> chunks = args[1].As<Array>();
+  size_t count = args[2]->Uint32Value();
+  const bool have_callback = args[3]->IsTrue();
+
+  MaybeStackBuffer<uv_buf_t, 16> bufs(count);
+  size_t msg_size = 0;
+  for (size_t i = 0; i < count; i++) {
+    Local<Value> chunk = chunks->Get(i);
+    bufs[i] = uv_buf_init(Buffer::Data(chunk), Buffer::Length(chunk));
+    msg_size += bufs[i].len;
+  }
+
+#ifndef _WIN32
+  // Without an address the kernel uses the route it has cached for the
+  // peer. Errors from earlier datagrams, like ECONNREFUSED after an ICMP
+  // port unreachable, are reported here.
+  uv_os_fd_t fd;
+  if (wrap->handle_.send_queue_count == 0 &&
+      uv_fileno(reinterpret_cast<uv_handle_t*>(&wrap->handle_), &fd) == 0) {
+    msghdr h;
+    memset(&h, 0, sizeof(h));
+    // uv_buf_t has the layout of struct iovec on POSIX systems.
+    h.msg_iov = reinterpret_cast<iovec*>(*bufs);
+    h.msg_iovlen = count;
+
+    ssize_t r;
+    do {
+      r = sendmsg(fd, &h, 0);
+    } while (r == -1 && errno == EINTR);
+
+    if (r != -1) {
+      req_wrap_obj->Set(env->async(), False(env->isolate()));
+      return args.GetReturnValue().Set(0);
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK)
+      return args.GetReturnValue().Set(uv_translate_sys_error(errno));
+  }
+#endif
+
+  SendWrap* req_wrap = new SendWrap(env, req_wrap_obj, have_callback);
+  req_wrap->msg_size = msg_size;
+
+  int err = uv_udp_send(req_wrap->req(),
+                        &wrap->handle_,
+                        *bufs,
+                        count,
+                        reinterpret_cast<const sockaddr*>(&wrap->peer_),
+                        OnSend);
+
+  req_wrap->Dispatched();
+  if (err)
+    delete req_wrap;
+
+  args.GetReturnValue().Set(err);
+}
+
+
+// Sends as many of the datagrams as the socket takes right now, with one
+// sendmmsg() where there is one. The ones that are not sent are left to
+// uv_udp_send().
+static int TrySendBatch(uv_udp_t* handle,
+                        const uv_buf_t* bufs,
+                        size_t count,
+                        const sockaddr* addr,
+                        size_t* sent) {
+#ifdef __linux__
+  uv_os_fd_t fd;
+  if (uv_fileno(reinterpret_cast<uv_handle_t*>(handle), &fd) != 0)
+    return 0;
+
+  MaybeStackBuffer<mmsghdr, 16> msgs(count);
+  memset(*msgs, 0, count * sizeof(msgs[0]));
+  for (size_t i = 0; i < count; i++) {
+    msgs[i].msg_hdr.msg_name = const_cast<sockaddr*>(addr);
+    msgs[i].msg_hdr.msg_namelen = addr->sa_family == AF_INET6 ?
+        sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+    // uv_buf_t has the layout of struct iovec on POSIX systems.
+    msgs[i].msg_hdr.msg_iov =
+        reinterpret_cast<iovec*>(const_cast<uv_buf_t*>(&bufs[i]));
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  while (*sent < count) {
+    const size_t n = count - *sent;
+    const int r = sendmmsg(fd, &msgs[*sent], n < 1024 ? n : 1024, 0);
+    if (r == -1) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        return 0;
+      return -errno;
+    }
+    *sent += r;
+  }
+#else
+  while (*sent < count) {
+    const int r = uv_udp_try_send(handle, &bufs[*sent], 1, addr);
+    if (r == UV_EAGAIN)
+      return 0;
+    if (r < 0)
+      return r;
+    *sent += 1;
+  }
+#endif
+  return 0;
+}
+
+
+void UDPWrap::DoSendBatch(const FunctionCallbackInfo<Value>& args,
+                          int family) {
+  Environment* env = Environment::GetCurrent(args);
+
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+
+  // sendBatch(req, messages, port, address)
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsUint32());
+  CHECK(args[3]->IsString());
+
+  Local<Object> req_wrap_obj = args[0].As<Object>();
+  Local<Array> messages = args[1].As<Array>();
+  const size_t count = messages->Length();
+  const unsigned short port = args[2]->Uint32Value();
+  node::Utf8Value address(env->isolate(), args[3]);
+  CHECK_GT(count, 0);
+
+  MaybeStackBuffer<uv_buf_t, 16> bufs(count);
+  size_t msg_size = 0;
+  for (size_t i = 0; i < count; i++) {
+    Local<Value> message = messages->Get(i);
+    bufs[i] = uv_buf_init(Buffer::Data(message), Buffer::Length(message));
+    msg_size += bufs[i].len;
+  }
+
+  char addr[sizeof(sockaddr_in6)];
+  int err;
+
+  switch (family) {
+  case AF_INET:
+    err = uv_ip4_addr(*address, port, reinterpret_cast<sockaddr_in*>(&addr));
+    break;
+  case AF_INET6:
+    err = uv_ip6_addr(*address, port, reinterpret_cast<sockaddr_in6*>(&addr));
+    break;
+  default:
+    CHECK(0 && "unexpected address family");
+    ABORT();
+  }
+
+  // Datagrams can only go out directly when none are waiting, or they
+  // would be reordered.
+  size_t sent = 0;
+  if (err == 0 && wrap->handle_.send_queue_count == 0) {
+    err = TrySendBatch(&wrap->handle_,
+                       *bufs,
+                       count,
+                       reinterpret_cast<const sockaddr*>(&addr),
+                       &sent);
+  }
+
+  if (err != 0 || sent == count) {
+    if (err == 0)
+      req_wrap_obj->Set(env->async(), False(env->isolate()));
+    args.GetReturnValue().Set(err);
+    return;
+  }
+
+  SendBatchWrap* req_wrap = new SendBatchWrap(env, req_wrap_obj, count - sent);
+  req_wrap->msg_size = msg_size;
+
+  for (size_t i = sent; i < count; i++) {
+    uv_udp_send_t* req =
+        i == sent ? req_wrap->req() : &req_wrap->reqs[i - sent - 1];
+    req->data = req_wrap;
+    err = uv_udp_send(req,
+                      &wrap->handle_,
+                      &bufs[i],
+                      1,
+                      reinterpret_cast<const sockaddr*>(&addr),
+                      OnSendBatch);
+    if (err)
+      break;
+    req_wrap->pending++;
+  }
+
+  req_wrap->Dispatched();
+  if (req_wrap->pending == 0) {
+    delete req_wrap;
+    args.GetReturnValue().Set(err);
+    return;
+  }
+
+  // The datagrams that were queued are still sent, the error is reported
+  // when they are done.
+  req_wrap->status = err;
+  args.GetReturnValue().Set(0);
+}
+
+
+void UDPWrap::SendBatch(const FunctionCallbackInfo<Value>& args) {
+  DoSendBatch(args, AF_INET);
+}
+
+
+void UDPWrap::SendBatch6(const FunctionCallbackInfo<Value>& args) {
+  DoSendBatch(args, AF_INET6);
+}
+
+
 void UDPWrap::RecvStart(const FunctionCallbackInfo<Value>& args) {
   UDPWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap,
                           args.Holder(),
                           args.GetReturnValue().Set(UV_EBADF));
+
+  // recvStart([batchSize])
+  const size_t batch_size = args[0]->IsUint32() ? args[0]->Uint32Value() : 0;
+  if (batch_size != wrap->batch_size_) {
+    free(wrap->batch_data_);
+    wrap->batch_data_ = nullptr;
+    if (batch_size > 1)
+      wrap->batch_data_ = node::Malloc((batch_size - 1) * kMaxDatagramSize);
+    wrap->batch_size_ = batch_size;
+  }
+
   int err = uv_udp_recv_start(&wrap->handle_, OnAlloc, OnRecv);
   // UV_EALREADY means that the socket is already bound but that's okay
   if (err == UV_EALREADY)
@@ -391,6 +772,25 @@ void UDPWrap::OnSend(uv_udp_send_t* req, int status) {
 }
 
 
+void UDPWrap::OnSendBatch(uv_udp_send_t* req, int status) {
+  SendBatchWrap* req_wrap = static_cast<SendBatchWrap*>(req->data);
+  if (req_wrap->status == 0)
+    req_wrap->status = status;
+  if (--req_wrap->pending > 0)
+    return;
+
+  Environment* env = req_wrap->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  Local<Value> arg[] = {
+    Integer::New(env->isolate(), req_wrap->status),
+    Integer::New(env->isolate(), req_wrap->msg_size),
+  };
+  req_wrap->MakeCallback(env->oncomplete_string(), arraysize(arg), arg);
+  delete req_wrap;
+}
+
+
 void UDPWrap::OnAlloc(uv_handle_t* handle,
                       size_t suggested_size,
                       uv_buf_t* buf) {
@@ -431,6 +831,13 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
     return;
   }
 
+#ifdef __linux__
+  if (wrap->batch_size_ > 0) {
+    wrap->OnRecvBatch(buf->base, nread, addr);
+    return;
+  }
+#endif
+
   char* base = node::UncheckedRealloc(buf->base, nread);
   argv[2] = Buffer::New(env, base, nread).ToLocalChecked();
   argv[3] = AddressToJS(env, addr);
@@ -438,6 +845,91 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
 }
 
 
+#ifdef __linux__
+// Called with the datagram that libuv received, in a buffer of
+// kMaxDatagramSize bytes. Everything is passed to JS in one buffer with the
+// offset where each datagram ends:
+// onmessages(handle, buffer, ends, rinfos)
+void UDPWrap::OnRecvBatch(char* base,
+                          ssize_t nread,
+                          const struct sockaddr* addr) {
+  Environment* env = this->env();
+  const size_t more = batch_size_ - 1;
+  MaybeStackBuffer<mmsghdr, 32> msgs(more);
+  MaybeStackBuffer<iovec, 32> iovs(more);
+  MaybeStackBuffer<sockaddr_storage, 32> addresses(more);
+  size_t count = 0;
+  int err = 0;
+
+  uv_os_fd_t fd;
+  if (more > 0 &&
+      uv_fileno(reinterpret_cast<uv_handle_t*>(&handle_), &fd) == 0) {
+    memset(*msgs, 0, more * sizeof(msgs[0]));
+    for (size_t i = 0; i < more; i++) {
+      iovs[i].iov_base = batch_data_ + i * kMaxDatagramSize;
+      iovs[i].iov_len = kMaxDatagramSize;
+      msgs[i].msg_hdr.msg_name = &addresses[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int r;
+    do {
+      r = recvmmsg(fd, *msgs, more, MSG_DONTWAIT, nullptr);
+    } while (r == -1 && errno == EINTR);
+
+    if (r > 0)
+      count = r;
+    else if (r == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+      err = -errno;
+  }
+
+  size_t total = nread;
+  for (size_t i = 0; i < count; i++)
+    total += msgs[i].msg_len;
+
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  Local<Array> ends = Array::New(env->isolate(), count + 1);
+  Local<Array> rinfos = Array::New(env->isolate(), count + 1);
+  ends->Set(0, Integer::NewFromUnsigned(env->isolate(), nread));
+  rinfos->Set(0, AddressToJS(env, addr));
+
+  base = node::UncheckedRealloc(base, total);
+  size_t offset = nread;
+  for (size_t i = 0; i < count; i++) {
+    memcpy(base + offset, iovs[i].iov_base, msgs[i].msg_len);
+    offset += msgs[i].msg_len;
+    ends->Set(i + 1, Integer::NewFromUnsigned(env->isolate(), offset));
+    rinfos->Set(i + 1,
+                AddressToJS(env,
+                            reinterpret_cast<sockaddr*>(&addresses[i])));
+  }
+
+  Local<Value> argv[] = {
+    object(),
+    Buffer::New(env, base, total).ToLocalChecked(),
+    ends,
+    rinfos
+  };
+  MakeCallback(env->onmessages_string(), arraysize(argv), argv);
+
+  // recvmmsg() took the error that the next read would have reported.
+  if (err != 0 && IsAlive(this)) {
+    Local<Value> argv[] = {
+      Integer::New(env->isolate(), err),
+      object(),
+      Undefined(env->isolate()),
+      Undefined(env->isolate())
+    };
+    MakeCallback(env->onmessage_string(), arraysize(argv), argv);
+  }
+}
+#endif  // __linux__
+
+
 Local<Object> UDPWrap::Instantiate(Environment* env, AsyncWrap* parent) {
   EscapableHandleScope scope(env->isolate());
   // If this assert fires then Initialize hasn't been called yet.
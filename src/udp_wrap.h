@@ -46,6 +46,11 @@ class UDPWrap: public HandleWrap {
   static void Send(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Bind6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Send6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Connect(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Connect6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendConnected(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RecvStart(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RecvStop(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void AddMembership(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -55,15 +60,20 @@ class UDPWrap: public HandleWrap {
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetBroadcast(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetTTL(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetSegmentSize(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   static v8::Local<v8::Object> Instantiate(Environment* env, AsyncWrap* parent);
   uv_udp_t* UVHandle();
 
+  ~UDPWrap() override;
+
   size_t self_size() const override { return sizeof(*this); }
 
  private:
   typedef uv_udp_t HandleType;
 
+  static const size_t kMaxDatagramSize = 64 * 1024;
+
   template <typename T,
             int (*F)(const typename T::HandleType*, sockaddr*, int*)>
   friend void GetSockOrPeerName(const v8::FunctionCallbackInfo<v8::Value>&);
@@ -74,6 +84,10 @@ class UDPWrap: public HandleWrap {
                      int family);
   static void DoSend(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
+  static void DoSendBatch(const v8::FunctionCallbackInfo<v8::Value>& args,
+                          int family);
+  static void DoConnect(const v8::FunctionCallbackInfo<v8::Value>& args,
+                        int family);
   static void SetMembership(const v8::FunctionCallbackInfo<v8::Value>& args,
                             uv_membership membership);
 
@@ -81,13 +95,26 @@ class UDPWrap: public HandleWrap {
                       size_t suggested_size,
                       uv_buf_t* buf);
   static void OnSend(uv_udp_send_t* req, int status);
+  static void OnSendBatch(uv_udp_send_t* req, int status);
   static void OnRecv(uv_udp_t* handle,
                      ssize_t nread,
                      const uv_buf_t* buf,
                      const struct sockaddr* addr,
                      unsigned int flags);
 
+  void OnRecvBatch(char* base, ssize_t nread, const struct sockaddr* addr);
+
   uv_udp_t handle_;
+
+  // With a batch size, OnRecv() reads the datagrams that are waiting after
+  // the one libuv received into batch_data_, which has room for the largest
+  // datagram for each of them, and passes them all to JS at once.
+  size_t batch_size_;
+  char* batch_data_;
+
+  // Set by connect(), sendConnected() sends to it.
+  bool connected_;
+  sockaddr_storage peer_;
 };
 
 }  // namespace node
@@ -20,10 +20,36 @@
 // USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "util.h"
+#include "util-inl.h"
 #include "string_bytes.h"
 #include "node_buffer.h"
+#include "node_cpu.h"
 #include "node_internals.h"
 #include <stdio.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BSWAP_2(x) _byteswap_ushort(x)
+#define BSWAP_4(x) _byteswap_ulong(x)
+#define BSWAP_8(x) _byteswap_uint64(x)
+#else
+#define BSWAP_2(x) ((x) << 8) | ((x) >> 8)
+#define BSWAP_4(x)                                                            \
+  (((x) & 0xFF) << 24) |                                                      \
+  (((x) & 0xFF00) << 8) |                                                     \
+  (((x) >> 8) & 0xFF00) |                                                     \
+  (((x) >> 24) & 0xFF)
+#define BSWAP_8(x)                                                            \
+  (((x) & 0xFF00000000000000ull) >> 56) |                                     \
+  (((x) & 0x00FF000000000000ull) >> 40) |                                     \
+  (((x) & 0x0000FF0000000000ull) >> 24) |                                     \
+  (((x) & 0x000000FF00000000ull) >> 8) |                                      \
+  (((x) & 0x00000000FF000000ull) << 8) |                                      \
+  (((x) & 0x0000000000FF0000ull) << 24) |                                     \
+  (((x) & 0x000000000000FF00ull) << 40) |                                     \
+  (((x) & 0x00000000000000FFull) << 56)
+#endif
 
 namespace node {
 
@@ -97,6 +123,132 @@ BufferValue::BufferValue(Isolate* isolate, Local<Value> value) {
   }
 }
 
+// Vectorized byte swapping, a shuffle of each 16 or 32 bytes. The kernels
+// return how many bytes they swapped, the rest is left to the scalar loops.
+#if NODE_SIMD_X86
+static const int8_t kSwap16Order[] =
+    { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+static const int8_t kSwap32Order[] =
+    { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+static const int8_t kSwap64Order[] =
+    { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+
+NODE_SIMD_TARGET("ssse3")
+static size_t SwapBytesSSSE3(char* data, size_t nbytes, const int8_t* order) {
+  const __m128i shuffle =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(order));
+  size_t i = 0;
+  for (; i + 16 <= nbytes; i += 16) {
+    __m128i* p = reinterpret_cast<__m128i*>(data + i);
+    _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), shuffle));
+  }
+  return i;
+}
+
+NODE_SIMD_TARGET("avx2")
+static size_t SwapBytesAVX2(char* data, size_t nbytes, const int8_t* order) {
+  const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(order)));
+  size_t i = 0;
+  for (; i + 32 <= nbytes; i += 32) {
+    __m256i* p = reinterpret_cast<__m256i*>(data + i);
+    _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), shuffle));
+  }
+  return i + SwapBytesSSSE3(data + i, nbytes - i, order);
+}
+
+static size_t SwapBytesSIMD(char* data, size_t nbytes, const int8_t* order) {
+  switch (cpu::GetLevel()) {
+    case cpu::kAVX2:
+      return SwapBytesAVX2(data, nbytes, order);
+    case cpu::kSSSE3:
+      return SwapBytesSSSE3(data, nbytes, order);
+    default:
+      break;
+  }
+#if NODE_SIMD_SSE2
+  // Without pshufb, 16 bit elements can still be swapped with shifts.
+  if (order == kSwap16Order) {
+    size_t i = 0;
+    for (; i + 16 <= nbytes; i += 16) {
+      __m128i* p = reinterpret_cast<__m128i*>(data + i);
+      const __m128i in = _mm_loadu_si128(p);
+      _mm_storeu_si128(p, _mm_or_si128(_mm_slli_epi16(in, 8),
+                                       _mm_srli_epi16(in, 8)));
+    }
+    return i;
+  }
+#endif
+  return 0;
+}
+
+static size_t SwapBytes16SIMD(char* data, size_t nbytes) {
+  return SwapBytesSIMD(data, nbytes, kSwap16Order);
+}
+
+static size_t SwapBytes32SIMD(char* data, size_t nbytes) {
+  return SwapBytesSIMD(data, nbytes, kSwap32Order);
+}
+
+static size_t SwapBytes64SIMD(char* data, size_t nbytes) {
+  return SwapBytesSIMD(data, nbytes, kSwap64Order);
+}
+#elif NODE_SIMD_NEON
+#define V(bits, rev)                                                          \
+  static size_t SwapBytes##bits##SIMD(char* data, size_t nbytes) {            \
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(data);                        \
+    size_t i = 0;                                                             \
+    for (; i + 16 <= nbytes; i += 16)                                         \
+      vst1q_u8(bytes + i, rev(vld1q_u8(bytes + i)));                          \
+    return i;                                                                 \
+  }
+V(16, vrev16q_u8)
+V(32, vrev32q_u8)
+V(64, vrev64q_u8)
+#undef V
+#else
+static size_t SwapBytes16SIMD(char* data, size_t nbytes) { return 0; }
+static size_t SwapBytes32SIMD(char* data, size_t nbytes) { return 0; }
+static size_t SwapBytes64SIMD(char* data, size_t nbytes) { return 0; }
+#endif
+
+
+void SwapBytes16(char* data, size_t nbytes) {
+  CHECK_EQ(nbytes % 2, 0);
+
+  uint16_t temp;
+  size_t i = SwapBytes16SIMD(data, nbytes);
+  for (; i < nbytes; i += sizeof(temp)) {
+    memcpy(&temp, &data[i], sizeof(temp));
+    temp = BSWAP_2(temp);
+    memcpy(&data[i], &temp, sizeof(temp));
+  }
+}
+
+void SwapBytes32(char* data, size_t nbytes) {
+  CHECK_EQ(nbytes % 4, 0);
+
+  uint32_t temp;
+  size_t i = SwapBytes32SIMD(data, nbytes);
+  for (; i < nbytes; i += sizeof(temp)) {
+    memcpy(&temp, &data[i], sizeof(temp));
+    temp = BSWAP_4(temp);
+    memcpy(&data[i], &temp, sizeof(temp));
+  }
+}
+
+void SwapBytes64(char* data, size_t nbytes) {
+  CHECK_EQ(nbytes % 8, 0);
+
+  uint64_t temp;
+  size_t i = SwapBytes64SIMD(data, nbytes);
+  for (; i < nbytes; i += sizeof(temp)) {
+    memcpy(&temp, &data[i], sizeof(temp));
+    temp = BSWAP_8(temp);
+    memcpy(&data[i], &temp, sizeof(temp));
+  }
+}
+
 void LowMemoryNotification() {
   if (v8_initialized) {
     auto isolate = v8::Isolate::GetCurrent();
@@ -276,10 +276,10 @@ template <typename TypeName>
 inline TypeName* Unwrap(v8::Local<v8::Object> object);
 
 // Swaps bytes in place. nbytes is the number of bytes to swap and must be a
-// multiple of the word size (checked by function).
-inline void SwapBytes16(char* data, size_t nbytes);
-inline void SwapBytes32(char* data, size_t nbytes);
-inline void SwapBytes64(char* data, size_t nbytes);
+// multiple of the word size (checked by function). data need not be aligned.
+void SwapBytes16(char* data, size_t nbytes);
+void SwapBytes32(char* data, size_t nbytes);
+void SwapBytes64(char* data, size_t nbytes);
 
 // tolower() is locale-sensitive.  Use ToLower() instead.
 inline char ToLower(char c);
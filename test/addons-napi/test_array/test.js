@@ -35,3 +35,19 @@ array.forEach(function(element, index) {
 
 
 assert.deepStrictEqual(test_array.New(array), array);
+
+// Bulk numeric conversion
+const numbers = [0, 1.5, -2.25, 1e300, -0, NaN, Infinity];
+assert.deepStrictEqual(test_array.RoundTripDouble(numbers), numbers);
+assert.deepStrictEqual(test_array.RoundTripDouble([]), []);
+assert.deepStrictEqual(test_array.RoundTripInt32([1, -1, 2.7, 4294967297]),
+                       [1, -1, 2, 1]);
+
+const long = [];
+for (let i = 0; i < 32; i++)
+  long.push(i);
+assert.deepStrictEqual(test_array.RoundTripDouble(long), long.slice(0, 16));
+
+assert.throws(() => test_array.RoundTripDouble([1, 'two']),
+              /A number was expected/);
+assert.throws(() => test_array.RoundTripInt32({}), /An array was expected/);
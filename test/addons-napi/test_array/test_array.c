@@ -80,10 +80,52 @@ napi_value New(napi_env env, napi_callback_info info) {
   return ret;
 }
 
+#define MAX_ELEMENTS 16
+
+// Round-trips an array of numbers through a native double buffer.
+napi_value RoundTripDouble(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value args[1];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+
+  NAPI_ASSERT(env, argc >= 1, "Wrong number of arguments");
+
+  double values[MAX_ELEMENTS];
+  size_t copied;
+  NAPI_CALL(env, napi_get_array_elements_double(
+    env, args[0], values, MAX_ELEMENTS, &copied));
+
+  napi_value ret;
+  NAPI_CALL(env, napi_create_array_from_double(env, values, copied, &ret));
+
+  return ret;
+}
+
+// Round-trips an array of numbers through a native int32 buffer.
+napi_value RoundTripInt32(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value args[1];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+
+  NAPI_ASSERT(env, argc >= 1, "Wrong number of arguments");
+
+  int32_t values[MAX_ELEMENTS];
+  size_t copied;
+  NAPI_CALL(env, napi_get_array_elements_int32(
+    env, args[0], values, MAX_ELEMENTS, &copied));
+
+  napi_value ret;
+  NAPI_CALL(env, napi_create_array_from_int32(env, values, copied, &ret));
+
+  return ret;
+}
+
 void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
   napi_property_descriptor descriptors[] = {
     DECLARE_NAPI_PROPERTY("Test", Test),
     DECLARE_NAPI_PROPERTY("New", New),
+    DECLARE_NAPI_PROPERTY("RoundTripDouble", RoundTripDouble),
+    DECLARE_NAPI_PROPERTY("RoundTripInt32", RoundTripInt32),
   };
 
   NAPI_CALL_RETURN_VOID(env, napi_define_properties(
@@ -8,3 +8,14 @@ test_async(5, common.mustCall(function(err, val) {
   assert.strictEqual(val, 10);
   process.nextTick(common.mustCall(function() {}));
 }));
+
+test_async.executor(7, common.mustCall(function(err, val) {
+  assert.strictEqual(err, null);
+  assert.strictEqual(val, 14);
+  process.nextTick(common.mustCall(function() {}));
+}));
+
+test_async.bulk(9, common.mustCall(function(err, val) {
+  assert.strictEqual(err, null);
+  assert.strictEqual(val, 18);
+}));
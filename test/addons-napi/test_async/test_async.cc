@@ -15,6 +15,9 @@ typedef struct {
 } carrier;
 
 carrier the_carrier;
+carrier executor_carrier;
+carrier bulk_carrier;
+napi_executor the_executor;
 
 struct AutoHandleScope {
   explicit AutoHandleScope(napi_env env)
@@ -40,7 +43,7 @@ void Execute(napi_env env, void* data) {
 #endif
   carrier* c = static_cast<carrier*>(data);
 
-  if (c != &the_carrier) {
+  if (c != &the_carrier && c != &executor_carrier && c != &bulk_carrier) {
     napi_throw_type_error(env, "Wrong data parameter to Execute.");
     return;
   }
@@ -52,7 +55,7 @@ void Complete(napi_env env, napi_status status, void* data) {
   AutoHandleScope scope(env);
   carrier* c = static_cast<carrier*>(data);
 
-  if (c != &the_carrier) {
+  if (c != &the_carrier && c != &executor_carrier && c != &bulk_carrier) {
     napi_throw_type_error(env, "Wrong data parameter to Complete.");
     return;
   }
@@ -78,9 +81,13 @@ void Complete(napi_env env, napi_status status, void* data) {
 
   NAPI_CALL_RETURN_VOID(env, napi_delete_reference(env, c->_callback));
   NAPI_CALL_RETURN_VOID(env, napi_delete_async_work(env, c->_request));
+
+  if (c == &executor_carrier) {
+    NAPI_CALL_RETURN_VOID(env, napi_delete_executor(env, the_executor));
+  }
 }
 
-napi_value Test(napi_env env, napi_callback_info info) {
+napi_value StartWork(napi_env env, napi_callback_info info, carrier* c) {
   size_t argc = 2;
   napi_value argv[2];
   napi_value _this;
@@ -97,24 +104,56 @@ napi_value Test(napi_env env, napi_callback_info info) {
   NAPI_ASSERT(env, t == napi_function,
     "Wrong second argument, function expected.");
 
-  the_carrier._output = 0;
+  c->_output = 0;
 
   NAPI_CALL(env,
-    napi_get_value_int32(env, argv[0], &the_carrier._input));
+    napi_get_value_int32(env, argv[0], &c->_input));
   NAPI_CALL(env,
-    napi_create_reference(env, argv[1], 1, &the_carrier._callback));
+    napi_create_reference(env, argv[1], 1, &c->_callback));
   NAPI_CALL(env, napi_create_async_work(
-    env, Execute, Complete, &the_carrier, &the_carrier._request));
-  NAPI_CALL(env,
-    napi_queue_async_work(env, the_carrier._request));
+    env, Execute, Complete, c, &c->_request));
+
+  if (c == &executor_carrier) {
+    NAPI_CALL(env, napi_create_executor(env, 2, &the_executor));
+    NAPI_CALL(env, napi_queue_async_work_on_executor(
+      env, the_executor, c->_request));
+  } else {
+    if (c == &bulk_carrier) {
+      NAPI_CALL(env, napi_set_async_work_priority(
+        env, c->_request, napi_async_priority_bulk));
+    }
+    NAPI_CALL(env, napi_queue_async_work(env, c->_request));
+  }
 
   return nullptr;
 }
 
+napi_value Test(napi_env env, napi_callback_info info) {
+  return StartWork(env, info, &the_carrier);
+}
+
+napi_value TestExecutor(napi_env env, napi_callback_info info) {
+  return StartWork(env, info, &executor_carrier);
+}
+
+napi_value TestBulk(napi_env env, napi_callback_info info) {
+  return StartWork(env, info, &bulk_carrier);
+}
+
 void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
   napi_value test;
   NAPI_CALL_RETURN_VOID(env,
     napi_create_function(env, "Test", Test, nullptr, &test));
+  napi_value test_executor;
+  NAPI_CALL_RETURN_VOID(env, napi_create_function(
+    env, "TestExecutor", TestExecutor, nullptr, &test_executor));
+  NAPI_CALL_RETURN_VOID(env,
+    napi_set_named_property(env, test, "executor", test_executor));
+  napi_value test_bulk;
+  NAPI_CALL_RETURN_VOID(env,
+    napi_create_function(env, "TestBulk", TestBulk, nullptr, &test_bulk));
+  NAPI_CALL_RETURN_VOID(env,
+    napi_set_named_property(env, test, "bulk", test_bulk));
   NAPI_CALL_RETURN_VOID(env,
     napi_set_named_property(env, module, "exports", test));
 }
@@ -23,3 +23,15 @@ buffer = null;
 global.gc();
 console.log('gc2');
 assert.strictEqual(binding.getDeleterCallCount(), 2, 'deleter was not called');
+
+// With deferred finalizers the deleter runs after the GC, once the loop is idle
+binding.deferFinalizers();
+binding.staticBuffer();
+binding.staticBuffer();
+global.gc();
+assert.strictEqual(binding.getDeleterCallCount(), 2,
+                   'deleter ran synchronously');
+setImmediate(common.mustCall(() => {
+  assert.strictEqual(binding.getDeleterCallCount(), 4,
+                     'deferred deleter was not called');
+}));
@@ -119,6 +119,11 @@ napi_value staticBuffer(napi_env env, napi_callback_info info) {
   return theBuffer;
 }
 
+napi_value deferFinalizers(napi_env env, napi_callback_info info) {
+  NAPI_CALL(env, napi_set_finalize_mode(env, napi_finalize_deferred));
+  return NULL;
+}
+
 void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
   napi_value theValue;
 
@@ -135,6 +140,7 @@ void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
     DECLARE_NAPI_PROPERTY("bufferHasInstance", bufferHasInstance),
     DECLARE_NAPI_PROPERTY("bufferInfo", bufferInfo),
     DECLARE_NAPI_PROPERTY("staticBuffer", staticBuffer),
+    DECLARE_NAPI_PROPERTY("deferFinalizers", deferFinalizers),
   };
 
   NAPI_CALL_RETURN_VOID(env, napi_define_properties(
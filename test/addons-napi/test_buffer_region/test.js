@@ -0,0 +1,39 @@
+'use strict';
+const common = require('../../common');
+const assert = require('assert');
+const ring = require(`./build/${common.buildType}/test_buffer_region`);
+
+ring.create();
+
+// The views are Buffers over the same memory.
+const views = [ring.acquire(), ring.acquire(), ring.acquire(), ring.acquire()];
+assert.strictEqual(ring.acquire(), null);
+assert.strictEqual(ring.getPinned(), 4);
+views.forEach((view, i) => {
+  assert.ok(view instanceof Buffer);
+  assert.strictEqual(view.byteOffset, i * 16);
+  assert.strictEqual(view.toString(), String.fromCharCode(97 + i).repeat(16));
+  assert.strictEqual(view.buffer, views[0].buffer);
+});
+assert.strictEqual(views[0].buffer.byteLength, 64);
+
+// Releasing a view passes its slot back, to be handed out again.
+ring.release(views[2]);
+assert.strictEqual(ring.getReleases(), 1);
+assert.strictEqual(ring.getPinned(), 3);
+const again = ring.acquire();
+assert.strictEqual(again.byteOffset, 32);
+assert.strictEqual(again.toString(), 'c'.repeat(16));
+
+// Views of other memory are not released.
+const invalidArg = /^Error: Invalid pointer passed as argument$/;
+assert.throws(() => ring.release(Buffer.alloc(16)), invalidArg);
+assert.throws(() => ring.release({}), invalidArg);
+assert.strictEqual(ring.viewOutOfRange(), true);
+
+// The region cannot be deleted while views are pinned.
+assert.strictEqual(ring.delete(), false);
+[views[0], views[1], again, views[3]].forEach((view) => ring.release(view));
+assert.strictEqual(ring.getReleases(), 5);
+assert.strictEqual(ring.getPinned(), 0);
+assert.strictEqual(ring.delete(), true);
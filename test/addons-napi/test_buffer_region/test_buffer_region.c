@@ -0,0 +1,105 @@
+#include <node_api.h>
+#include <string.h>
+#include "../common.h"
+
+// A ring of slots that are handed to JavaScript as views of one region.
+#define SLOT_COUNT 4
+#define SLOT_SIZE 16
+
+static char ring[SLOT_COUNT * SLOT_SIZE];
+static int slot_used[SLOT_COUNT];
+static int releases = 0;
+static napi_buffer_region region = NULL;
+
+static void ReleaseSlot(napi_env env,
+                        void* data,
+                        size_t byte_offset,
+                        size_t length,
+                        void* hint) {
+  slot_used[byte_offset / SLOT_SIZE] = 0;
+  releases++;
+}
+
+napi_value Create(napi_env env, napi_callback_info info) {
+  NAPI_CALL(env, napi_create_buffer_region(
+      env, ring, sizeof(ring), ReleaseSlot, NULL, NULL, &region));
+  return NULL;
+}
+
+// Fills the free slot with its number and returns a view of it, or null if
+// all of them are pinned.
+napi_value Acquire(napi_env env, napi_callback_info info) {
+  for (int i = 0; i < SLOT_COUNT; i++) {
+    if (slot_used[i]) {
+      continue;
+    }
+    slot_used[i] = 1;
+    memset(ring + i * SLOT_SIZE, 'a' + i, SLOT_SIZE);
+    napi_value view;
+    NAPI_CALL(env, napi_create_buffer_view(
+        env, region, i * SLOT_SIZE, SLOT_SIZE, &view));
+    return view;
+  }
+  napi_value null;
+  NAPI_CALL(env, napi_get_null(env, &null));
+  return null;
+}
+
+napi_value Release(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value view;
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, &view, NULL, NULL));
+  NAPI_CALL(env, napi_release_buffer_view(env, region, view));
+  return NULL;
+}
+
+napi_value ViewOutOfRange(napi_env env, napi_callback_info info) {
+  napi_value view;
+  napi_status status = napi_create_buffer_view(
+      env, region, sizeof(ring) - 1, 2, &view);
+  napi_value result;
+  NAPI_CALL(env, napi_get_boolean(env, status == napi_invalid_arg, &result));
+  return result;
+}
+
+napi_value GetPinned(napi_env env, napi_callback_info info) {
+  size_t pinned;
+  NAPI_CALL(env, napi_get_buffer_region_pinned(env, region, &pinned));
+  napi_value result;
+  NAPI_CALL(env, napi_create_number(env, (double)pinned, &result));
+  return result;
+}
+
+napi_value GetReleases(napi_env env, napi_callback_info info) {
+  napi_value result;
+  NAPI_CALL(env, napi_create_number(env, releases, &result));
+  return result;
+}
+
+// Returns whether the region could be deleted.
+napi_value Delete(napi_env env, napi_callback_info info) {
+  napi_status status = napi_delete_buffer_region(env, region);
+  if (status == napi_ok) {
+    region = NULL;
+  }
+  napi_value result;
+  NAPI_CALL(env, napi_get_boolean(env, status == napi_ok, &result));
+  return result;
+}
+
+void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
+  napi_property_descriptor descriptors[] = {
+    DECLARE_NAPI_PROPERTY("create", Create),
+    DECLARE_NAPI_PROPERTY("acquire", Acquire),
+    DECLARE_NAPI_PROPERTY("release", Release),
+    DECLARE_NAPI_PROPERTY("viewOutOfRange", ViewOutOfRange),
+    DECLARE_NAPI_PROPERTY("getPinned", GetPinned),
+    DECLARE_NAPI_PROPERTY("getReleases", GetReleases),
+    DECLARE_NAPI_PROPERTY("delete", Delete),
+  };
+
+  NAPI_CALL_RETURN_VOID(env, napi_define_properties(
+    env, exports, sizeof(descriptors) / sizeof(*descriptors), descriptors));
+}
+
+NAPI_MODULE(addon, Init)
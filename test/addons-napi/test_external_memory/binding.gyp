@@ -0,0 +1,8 @@
+{
+  "targets": [
+    {
+      "target_name": "test_external_memory",
+      "sources": [ "test_external_memory.c" ]
+    }
+  ]
+}
@@ -0,0 +1,34 @@
+'use strict';
+// Flags: --expose-gc
+
+const common = require('../../common');
+const assert = require('assert');
+const test = require(`./build/${common.buildType}/test_external_memory`);
+
+// The total is returned, so that the change can be seen in it.
+const base = test.adjust(0);
+assert.strictEqual(test.adjust(1024 * 1024), base + 1024 * 1024);
+assert.strictEqual(test.adjust(-1024 * 1024), base);
+
+// With reporting, the memory of external buffers counts from creation until
+// they are finalized.
+test.setReporting(true);
+[false, true].forEach((arraybuffer) => {
+  const before = test.adjust(0);
+  const finalized = test.getFinalizeCount();
+  test.createExternal(4096, arraybuffer);
+  assert.strictEqual(test.adjust(0), before + 4096);
+
+  global.gc();
+  assert.strictEqual(test.getFinalizeCount(), finalized + 1);
+  assert.strictEqual(test.adjust(0), before);
+});
+
+// Without it, nothing is reported.
+test.setReporting(false);
+{
+  const before = test.adjust(0);
+  const external = test.createExternal(4096, false);
+  assert.strictEqual(test.adjust(0), before);
+  assert.strictEqual(external.length, 4096);
+}
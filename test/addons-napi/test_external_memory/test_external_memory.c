@@ -0,0 +1,82 @@
+#include <node_api.h>
+#include <stdlib.h>
+#include "../common.h"
+
+static int finalize_count = 0;
+
+static void FreeData(napi_env env, void* data, void* hint) {
+  free(data);
+  finalize_count++;
+}
+
+napi_value Adjust(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+
+  int64_t change;
+  NAPI_CALL(env, napi_get_value_int64(env, argv[0], &change));
+
+  int64_t adjusted;
+  NAPI_CALL(env, napi_adjust_external_memory(env, change, &adjusted));
+
+  napi_value result;
+  NAPI_CALL(env, napi_create_number(env, (double)adjusted, &result));
+  return result;
+}
+
+napi_value SetReporting(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+
+  bool enabled;
+  NAPI_CALL(env, napi_get_value_bool(env, argv[0], &enabled));
+  NAPI_CALL(env, napi_set_external_memory_reporting(env, enabled));
+  return NULL;
+}
+
+// createExternal(size, arraybuffer)
+napi_value CreateExternal(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+
+  uint32_t size;
+  NAPI_CALL(env, napi_get_value_uint32(env, argv[0], &size));
+  bool arraybuffer;
+  NAPI_CALL(env, napi_get_value_bool(env, argv[1], &arraybuffer));
+
+  void* data = calloc(size, 1);
+  NAPI_ASSERT(env, data != NULL, "calloc() failed");
+
+  napi_value result;
+  if (arraybuffer) {
+    NAPI_CALL(env, napi_create_external_arraybuffer(
+        env, data, size, FreeData, NULL, &result));
+  } else {
+    NAPI_CALL(env, napi_create_external_buffer(
+        env, size, data, FreeData, NULL, &result));
+  }
+  return result;
+}
+
+napi_value GetFinalizeCount(napi_env env, napi_callback_info info) {
+  napi_value result;
+  NAPI_CALL(env, napi_create_number(env, finalize_count, &result));
+  return result;
+}
+
+void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
+  napi_property_descriptor descriptors[] = {
+    DECLARE_NAPI_PROPERTY("adjust", Adjust),
+    DECLARE_NAPI_PROPERTY("setReporting", SetReporting),
+    DECLARE_NAPI_PROPERTY("createExternal", CreateExternal),
+    DECLARE_NAPI_PROPERTY("getFinalizeCount", GetFinalizeCount),
+  };
+
+  NAPI_CALL_RETURN_VOID(env, napi_define_properties(
+    env, exports, sizeof(descriptors) / sizeof(*descriptors), descriptors));
+}
+
+NAPI_MODULE(addon, Init)
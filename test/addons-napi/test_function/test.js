@@ -26,3 +26,8 @@ function func4(input) {
   return func3(input);
 }
 assert.strictEqual(test_function.Test(func4, 1), 2);
+
+assert.strictEqual(test_function.GetArg(0), 0);
+assert.strictEqual(test_function.GetArg(1, 'a', 'b'), 'a');
+assert.strictEqual(test_function.GetArg(2, 'a', 'b'), 'b');
+assert.strictEqual(test_function.GetArg(3, 'a', 'b'), undefined);
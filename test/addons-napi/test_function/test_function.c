@@ -26,10 +26,29 @@ napi_value Test(napi_env env, napi_callback_info info) {
   return result;
 }
 
+// Returns the argument at the index given by the first argument.
+napi_value GetArg(napi_env env, napi_callback_info info) {
+  napi_value index_value;
+  NAPI_CALL(env, napi_get_cb_arg(env, info, 0, &index_value));
+
+  uint32_t index;
+  NAPI_CALL(env, napi_get_value_uint32(env, index_value, &index));
+
+  napi_value result;
+  NAPI_CALL(env, napi_get_cb_arg(env, info, index, &result));
+
+  return result;
+}
+
 void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
   napi_value fn;
   NAPI_CALL_RETURN_VOID(env, napi_create_function(env, NULL, Test, NULL, &fn));
   NAPI_CALL_RETURN_VOID(env, napi_set_named_property(env, exports, "Test", fn));
+
+  NAPI_CALL_RETURN_VOID(env,
+    napi_create_function(env, "GetArg", GetArg, NULL, &fn));
+  NAPI_CALL_RETURN_VOID(env,
+    napi_set_named_property(env, exports, "GetArg", fn));
 }
 
 NAPI_MODULE(addon, Init)
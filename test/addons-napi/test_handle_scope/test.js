@@ -8,3 +8,6 @@ const testHandleScope =
 
 testHandleScope.NewScope();
 assert.ok(testHandleScope.NewScopeEscape() instanceof Object);
+
+const numbers = Array.from({ length: 10000 }, (v, i) => i);
+assert.strictEqual(testHandleScope.SumInScopes(numbers), 49995000);
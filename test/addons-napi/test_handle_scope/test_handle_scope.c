@@ -29,10 +29,44 @@ napi_value NewScopeEscape(napi_env env, napi_callback_info info) {
   return escapee;
 }
 
+// Sums the elements of an array, opening a scope per element and an
+// escapable one nested in it, the way an addon iterating a large array
+// would. The scopes are closed in order, and their storage is reused.
+napi_value SumInScopes(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value array;
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, &array, NULL, NULL));
+
+  uint32_t length;
+  NAPI_CALL(env, napi_get_array_length(env, array, &length));
+
+  double sum = 0;
+  for (uint32_t i = 0; i < length; i++) {
+    napi_handle_scope scope;
+    napi_escapable_handle_scope inner;
+    napi_value element, escaped;
+    double value;
+
+    NAPI_CALL(env, napi_open_handle_scope(env, &scope));
+    NAPI_CALL(env, napi_open_escapable_handle_scope(env, &inner));
+    NAPI_CALL(env, napi_get_element(env, array, i, &element));
+    NAPI_CALL(env, napi_escape_handle(env, inner, element, &escaped));
+    NAPI_CALL(env, napi_close_escapable_handle_scope(env, inner));
+    NAPI_CALL(env, napi_get_value_double(env, escaped, &value));
+    NAPI_CALL(env, napi_close_handle_scope(env, scope));
+    sum += value;
+  }
+
+  napi_value result;
+  NAPI_CALL(env, napi_create_number(env, sum, &result));
+  return result;
+}
+
 void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
   napi_property_descriptor properties[] = {
     DECLARE_NAPI_PROPERTY("NewScope", NewScope),
     DECLARE_NAPI_PROPERTY("NewScopeEscape", NewScopeEscape),
+    DECLARE_NAPI_PROPERTY("SumInScopes", SumInScopes),
   };
 
   NAPI_CALL_RETURN_VOID(env, napi_define_properties(
@@ -63,3 +63,23 @@ assert(test_object.Has(object2, 'string'));
 assert(test_object.Has(object2, sym4));
 assert.strictEqual(test_object.Get(object2, 'string'), 'value');
 assert.strictEqual(test_object.Get(object2, sym4), 123);
+
+// Testing the bulk property APIs
+const point = test_object.NewPoint(1, 'two', sym1);
+assert.deepStrictEqual(point, {x: 1, y: 'two', z: sym1});
+assert.deepStrictEqual(Object.keys(point), ['x', 'y', 'z']);
+assert.deepStrictEqual(test_object.GetPoint(point), [1, 'two', sym1]);
+assert.deepStrictEqual(test_object.GetPoint({y: 2}), [undefined, 2, undefined]);
+assert.deepStrictEqual(test_object.GetValues(object2, [sym1, 'string', sym4]),
+                       ['@@iterator', 'value', 123]);
+assert.deepStrictEqual(test_object.GetValues(object2, []), []);
+
+// Testing the atom APIs
+const atomTarget = {};
+assert.deepStrictEqual(test_object.SetWithAtom(atomTarget, 'count', 42),
+                       ['count', 42]);
+assert.deepStrictEqual(test_object.SetWithAtom(atomTarget, 'count', 43),
+                       ['count', 43]);
+assert.deepStrictEqual(test_object.SetWithAtom(atomTarget, 'λ', 'lambda'),
+                       ['λ', 'lambda']);
+assert.deepStrictEqual(atomTarget, {count: 43, 'λ': 'lambda'});
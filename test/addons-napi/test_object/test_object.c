@@ -138,6 +138,108 @@ napi_value Inflate(napi_env env, napi_callback_info info) {
   return obj;
 }
 
+static const char* const point_names[] = { "x", "y", "z" };
+
+napi_value NewPoint(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value args[3];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+
+  NAPI_ASSERT(env, argc >= 3, "Wrong number of arguments");
+
+  napi_value ret;
+  NAPI_CALL(env,
+    napi_create_object_with_named_properties(env, 3, point_names, args, &ret));
+
+  return ret;
+}
+
+napi_value GetPoint(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value args[1];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+
+  NAPI_ASSERT(env, argc >= 1, "Wrong number of arguments");
+
+  napi_value values[3];
+  NAPI_CALL(env, napi_get_named_properties(env, args[0], 3, point_names,
+                                           values));
+
+  napi_value ret;
+  NAPI_CALL(env, napi_create_array_with_length(env, 3, &ret));
+
+  uint32_t i;
+  for (i = 0; i < 3; i++) {
+    NAPI_CALL(env, napi_set_element(env, ret, i, values[i]));
+  }
+
+  return ret;
+}
+
+napi_value GetValues(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+
+  NAPI_ASSERT(env, argc >= 2, "Wrong number of arguments");
+
+  uint32_t i, length;
+  NAPI_CALL(env, napi_get_array_length(env, args[1], &length));
+  NAPI_ASSERT(env, length <= 8, "Too many keys");
+
+  napi_value keys[8];
+  for (i = 0; i < length; i++) {
+    NAPI_CALL(env, napi_get_element(env, args[1], i, &keys[i]));
+  }
+
+  napi_value values[8];
+  NAPI_CALL(env, napi_get_properties(env, args[0], length, keys, values));
+
+  napi_value ret;
+  NAPI_CALL(env, napi_create_array_with_length(env, length, &ret));
+
+  for (i = 0; i < length; i++) {
+    NAPI_CALL(env, napi_set_element(env, ret, i, values[i]));
+  }
+
+  return ret;
+}
+
+napi_value SetWithAtom(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value args[3];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+
+  NAPI_ASSERT(env, argc >= 3, "Wrong number of arguments");
+
+  char name[64];
+  size_t name_length;
+  NAPI_CALL(env, napi_get_value_string_utf8(
+    env, args[1], name, sizeof(name), &name_length));
+
+  napi_atom atom, same_atom;
+  NAPI_CALL(env, napi_create_atom(env, name, name_length, &atom));
+  NAPI_CALL(env, napi_create_atom(env, name, (size_t)-1, &same_atom));
+  NAPI_ASSERT(env, atom == same_atom, "Atoms should be interned");
+
+  NAPI_CALL(env, napi_set_atom_property(env, args[0], atom, args[2]));
+
+  bool has_property;
+  NAPI_CALL(env, napi_has_atom_property(env, args[0], atom, &has_property));
+  NAPI_ASSERT(env, has_property, "Property should have been set");
+
+  napi_value key, value;
+  NAPI_CALL(env, napi_get_atom_value(env, atom, &key));
+  NAPI_CALL(env, napi_get_atom_property(env, args[0], atom, &value));
+
+  napi_value ret;
+  NAPI_CALL(env, napi_create_array_with_length(env, 2, &ret));
+  NAPI_CALL(env, napi_set_element(env, ret, 0, key));
+  NAPI_CALL(env, napi_set_element(env, ret, 1, value));
+
+  return ret;
+}
+
 void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
   napi_property_descriptor descriptors[] = {
     DECLARE_NAPI_PROPERTY("Get", Get),
@@ -145,6 +247,10 @@ void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
     DECLARE_NAPI_PROPERTY("Has", Has),
     DECLARE_NAPI_PROPERTY("New", New),
     DECLARE_NAPI_PROPERTY("Inflate", Inflate),
+    DECLARE_NAPI_PROPERTY("NewPoint", NewPoint),
+    DECLARE_NAPI_PROPERTY("GetPoint", GetPoint),
+    DECLARE_NAPI_PROPERTY("GetValues", GetValues),
+    DECLARE_NAPI_PROPERTY("SetWithAtom", SetWithAtom),
   };
 
   NAPI_CALL_RETURN_VOID(env, napi_define_properties(
@@ -0,0 +1,116 @@
+#include <node_api.h>
+#include "../common.h"
+
+napi_deferred deferred = nullptr;
+
+napi_value createPromise(napi_env env, napi_callback_info info) {
+  napi_value promise;
+
+  // We do not overwrite an existing deferred.
+  if (deferred != nullptr) {
+    return nullptr;
+  }
+
+  NAPI_CALL(env, napi_create_promise(env, &deferred, &promise));
+
+  return promise;
+}
+
+napi_value concludeCurrentPromise(napi_env env, napi_callback_info info) {
+  napi_value argv[2];
+  size_t argc = 2;
+  bool resolution;
+
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+  NAPI_CALL(env, napi_get_value_bool(env, argv[1], &resolution));
+  if (resolution) {
+    NAPI_CALL(env, napi_resolve_deferred(env, deferred, argv[0]));
+  } else {
+    NAPI_CALL(env, napi_reject_deferred(env, deferred, argv[0]));
+  }
+
+  deferred = nullptr;
+
+  return nullptr;
+}
+
+napi_value isPromise(napi_env env, napi_callback_info info) {
+  napi_value promise, result;
+  size_t argc = 1;
+  bool is_promise;
+
+  NAPI_CALL(env,
+    napi_get_cb_info(env, info, &argc, &promise, nullptr, nullptr));
+  NAPI_CALL(env, napi_is_promise(env, promise, &is_promise));
+  NAPI_CALL(env, napi_get_boolean(env, is_promise, &result));
+
+  return result;
+}
+
+// A promise that is settled from the complete callback of async work, the
+// way an addon with an asynchronous API would return one.
+typedef struct {
+  int32_t input;
+  int32_t output;
+  napi_deferred deferred;
+  napi_async_work work;
+} carrier;
+
+void Execute(napi_env env, void* data) {
+  carrier* c = static_cast<carrier*>(data);
+  c->output = c->input * 2;
+}
+
+void Complete(napi_env env, napi_status status, void* data) {
+  carrier* c = static_cast<carrier*>(data);
+  napi_handle_scope scope;
+  NAPI_CALL_RETURN_VOID(env, napi_open_handle_scope(env, &scope));
+
+  napi_value result;
+  if (c->input < 0) {
+    napi_value message;
+    NAPI_CALL_RETURN_VOID(env,
+      napi_create_string_utf8(env, "negative input", -1, &message));
+    NAPI_CALL_RETURN_VOID(env, napi_create_error(env, message, &result));
+    NAPI_CALL_RETURN_VOID(env, napi_reject_deferred(env, c->deferred, result));
+  } else {
+    NAPI_CALL_RETURN_VOID(env, napi_create_number(env, c->output, &result));
+    NAPI_CALL_RETURN_VOID(env,
+      napi_resolve_deferred(env, c->deferred, result));
+  }
+
+  NAPI_CALL_RETURN_VOID(env, napi_delete_async_work(env, c->work));
+  delete c;
+  NAPI_CALL_RETURN_VOID(env, napi_close_handle_scope(env, scope));
+}
+
+napi_value doubleAsync(napi_env env, napi_callback_info info) {
+  napi_value argv[1];
+  size_t argc = 1;
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  carrier* c = new carrier();
+  NAPI_CALL(env, napi_get_value_int32(env, argv[0], &c->input));
+
+  napi_value promise;
+  NAPI_CALL(env, napi_create_promise(env, &c->deferred, &promise));
+  NAPI_CALL(env,
+    napi_create_async_work(env, Execute, Complete, c, &c->work));
+  NAPI_CALL(env, napi_queue_async_work(env, c->work));
+
+  return promise;
+}
+
+void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
+  napi_property_descriptor descriptors[] = {
+    DECLARE_NAPI_PROPERTY("createPromise", createPromise),
+    DECLARE_NAPI_PROPERTY("concludeCurrentPromise", concludeCurrentPromise),
+    DECLARE_NAPI_PROPERTY("isPromise", isPromise),
+    DECLARE_NAPI_PROPERTY("doubleAsync", doubleAsync),
+  };
+
+  NAPI_CALL_RETURN_VOID(env, napi_define_properties(
+    env, exports, sizeof(descriptors) / sizeof(*descriptors), descriptors));
+}
+
+NAPI_MODULE(addon, Init)
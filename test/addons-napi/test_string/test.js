@@ -1,4 +1,5 @@
 'use strict';
+// Flags: --expose-gc
 const common = require('../../common');
 const assert = require('assert');
 
@@ -69,3 +70,11 @@ assert.strictEqual(test_string.TestUtf8Insufficient(str6), str6.slice(0, 1));
 assert.strictEqual(test_string.TestUtf16Insufficient(str6), str6.slice(0, 3));
 assert.strictEqual(test_string.Length(str6), 5);
 assert.strictEqual(test_string.Utf8Length(str6), 14);
+
+// Testing external strings
+assert.strictEqual(test_string.TestExternalLatin1(str1), str1);
+assert.strictEqual(test_string.TestExternalLatin1(str5), str5);
+assert.strictEqual(test_string.TestExternalUtf16(str2), str2);
+assert.strictEqual(test_string.TestExternalUtf16(str6), str6);
+global.gc();
+assert.strictEqual(test_string.ExternalFinalizeCount(), 4);
@@ -1,6 +1,14 @@
 #include <node_api.h>
+#include <stdlib.h>
 #include "../common.h"
 
+static uint32_t external_finalize_count = 0;
+
+static void FreeExternal(napi_env env, void* data, void* hint) {
+  free(data);
+  external_finalize_count++;
+}
+
 napi_value TestLatin1(napi_env env, napi_callback_info info) {
   size_t argc = 1;
   napi_value args[1];
@@ -201,6 +209,58 @@ napi_value Utf8Length(napi_env env, napi_callback_info info) {
   return output;
 }
 
+napi_value TestExternalLatin1(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value args[1];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+
+  NAPI_ASSERT(env, argc >= 1, "Wrong number of arguments");
+
+  size_t length;
+  NAPI_CALL(env,
+    napi_get_value_string_latin1(env, args[0], NULL, 0, &length));
+
+  char* buffer = malloc(length + 1);
+  NAPI_CALL(env,
+    napi_get_value_string_latin1(env, args[0], buffer, length + 1, NULL));
+
+  napi_value output;
+  NAPI_CALL(env, napi_create_external_string_latin1(
+    env, buffer, length, FreeExternal, NULL, &output));
+
+  return output;
+}
+
+napi_value TestExternalUtf16(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value args[1];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+
+  NAPI_ASSERT(env, argc >= 1, "Wrong number of arguments");
+
+  size_t length;
+  NAPI_CALL(env,
+    napi_get_value_string_utf16(env, args[0], NULL, 0, &length));
+
+  char16_t* buffer = malloc((length + 1) * sizeof(*buffer));
+  NAPI_CALL(env,
+    napi_get_value_string_utf16(env, args[0], buffer, length + 1, NULL));
+
+  // Exercise the null-terminated form.
+  napi_value output;
+  NAPI_CALL(env, napi_create_external_string_utf16(
+    env, buffer, (size_t)-1, FreeExternal, NULL, &output));
+
+  return output;
+}
+
+napi_value ExternalFinalizeCount(napi_env env, napi_callback_info info) {
+  napi_value output;
+  NAPI_CALL(env, napi_create_number(env, external_finalize_count, &output));
+
+  return output;
+}
+
 void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
   napi_property_descriptor properties[] = {
     DECLARE_NAPI_PROPERTY("TestLatin1", TestLatin1),
@@ -211,6 +271,9 @@ void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
     DECLARE_NAPI_PROPERTY("TestUtf16Insufficient", TestUtf16Insufficient),
     DECLARE_NAPI_PROPERTY("Length", Length),
     DECLARE_NAPI_PROPERTY("Utf8Length", Utf8Length),
+    DECLARE_NAPI_PROPERTY("TestExternalLatin1", TestExternalLatin1),
+    DECLARE_NAPI_PROPERTY("TestExternalUtf16", TestExternalUtf16),
+    DECLARE_NAPI_PROPERTY("ExternalFinalizeCount", ExternalFinalizeCount),
   };
 
   NAPI_CALL_RETURN_VOID(env, napi_define_properties(
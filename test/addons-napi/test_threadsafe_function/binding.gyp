@@ -0,0 +1,8 @@
+{
+  "targets": [
+    {
+      "target_name": "test_threadsafe_function",
+      "sources": [ "test_threadsafe_function.c" ]
+    }
+  ]
+}
@@ -0,0 +1,27 @@
+'use strict';
+const common = require('../../common');
+const assert = require('assert');
+const binding = require(`./build/${common.buildType}/test_threadsafe_function`);
+
+const expected = [];
+for (let i = 0; i < binding.ARRAY_LENGTH; i++)
+  expected.push(i);
+
+function testWithOptions(isBlocking, maxQueueSize) {
+  return new Promise(function(resolve) {
+    const received = [];
+    binding.StartThread(function(value) {
+      received.push(value);
+    }, isBlocking, maxQueueSize, common.mustCall(function() {
+      assert.deepStrictEqual(received, expected);
+      resolve();
+    }));
+  });
+}
+
+testWithOptions(true, 0)
+  .then(() => testWithOptions(true, 1))
+  .then(() => testWithOptions(true, 100))
+  .then(() => testWithOptions(false, 1))
+  .then(() => testWithOptions(false, 100))
+  .then(common.mustCall());
@@ -0,0 +1,113 @@
+#include <node_api.h>
+#include <uv.h>
+#include "../common.h"
+
+#define ARRAY_LENGTH 10000
+
+static uv_thread_t uv_thread;
+static napi_threadsafe_function ts_fn;
+static napi_ref js_finalize_cb = NULL;
+static int ints[ARRAY_LENGTH];
+static bool is_blocking;
+
+static void data_source_thread(void* data) {
+  napi_threadsafe_function ts_fn = data;
+  napi_threadsafe_function_call_mode mode =
+      is_blocking ? napi_tsfn_blocking : napi_tsfn_nonblocking;
+  int index;
+  napi_status status;
+
+  for (index = 0; index < ARRAY_LENGTH; index++) {
+    do {
+      status = napi_call_threadsafe_function(ts_fn, &ints[index], mode);
+    } while (status == napi_queue_full);
+
+    if (status != napi_ok) {
+      break;
+    }
+  }
+
+  napi_release_threadsafe_function(ts_fn, napi_tsfn_release);
+}
+
+// Runs on the loop thread.
+static void call_js(napi_env env, napi_value cb, void* hint, void* data) {
+  if (env == NULL) {
+    return;
+  }
+
+  napi_value argv[1], undefined;
+  NAPI_CALL_RETURN_VOID(env, napi_create_number(env, *(int*)data, &argv[0]));
+  NAPI_CALL_RETURN_VOID(env, napi_get_undefined(env, &undefined));
+  NAPI_CALL_RETURN_VOID(env,
+    napi_call_function(env, undefined, cb, 1, argv, NULL));
+}
+
+static void join_the_thread(napi_env env, void* data, void* hint) {
+  uv_thread_t* the_thread = data;
+  uv_thread_join(the_thread);
+
+  napi_value js_cb, undefined;
+  NAPI_CALL_RETURN_VOID(env,
+    napi_get_reference_value(env, js_finalize_cb, &js_cb));
+  NAPI_CALL_RETURN_VOID(env, napi_get_undefined(env, &undefined));
+  NAPI_CALL_RETURN_VOID(env,
+    napi_call_function(env, undefined, js_cb, 0, NULL, NULL));
+  NAPI_CALL_RETURN_VOID(env, napi_delete_reference(env, js_finalize_cb));
+  js_finalize_cb = NULL;
+}
+
+// StartThread(callback, isBlocking, maxQueueSize, onFinalize)
+static napi_value StartThread(napi_env env, napi_callback_info info) {
+  size_t argc = 4;
+  napi_value argv[4];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NAPI_ASSERT(env, argc >= 4, "Not enough arguments, expected 4.");
+  NAPI_ASSERT(env, js_finalize_cb == NULL, "Thread is already running.");
+
+  uint32_t max_queue_size;
+  NAPI_CALL(env, napi_get_value_bool(env, argv[1], &is_blocking));
+  NAPI_CALL(env, napi_get_value_uint32(env, argv[2], &max_queue_size));
+  NAPI_CALL(env, napi_create_reference(env, argv[3], 1, &js_finalize_cb));
+
+  NAPI_CALL(env, napi_create_threadsafe_function(env,
+                                                 argv[0],
+                                                 max_queue_size,
+                                                 1,
+                                                 &uv_thread,
+                                                 join_the_thread,
+                                                 NULL,
+                                                 call_js,
+                                                 &ts_fn));
+
+  void* context;
+  NAPI_CALL(env, napi_get_threadsafe_function_context(ts_fn, &context));
+  NAPI_ASSERT(env, context == NULL, "Unexpected context.");
+
+  NAPI_ASSERT(env,
+    uv_thread_create(&uv_thread, data_source_thread, ts_fn) == 0,
+    "Failed to start thread");
+
+  return NULL;
+}
+
+void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
+  size_t index;
+  for (index = 0; index < ARRAY_LENGTH; index++) {
+    ints[index] = index;
+  }
+
+  napi_value js_array_length;
+  NAPI_CALL_RETURN_VOID(env,
+    napi_create_number(env, ARRAY_LENGTH, &js_array_length));
+
+  napi_property_descriptor properties[] = {
+    { "ARRAY_LENGTH", 0, 0, 0, 0, js_array_length, napi_enumerable, 0 },
+    DECLARE_NAPI_PROPERTY("StartThread", StartThread),
+  };
+
+  NAPI_CALL_RETURN_VOID(env, napi_define_properties(
+    env, exports, sizeof(properties) / sizeof(*properties), properties));
+}
+
+NAPI_MODULE(addon, Init)
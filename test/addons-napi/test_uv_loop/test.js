@@ -0,0 +1,47 @@
+'use strict';
+const common = require('../../common');
+const assert = require('assert');
+const async_wrap = process.binding('async_wrap');
+const test_uv_loop = require(`./build/${common.buildType}/test_uv_loop`);
+
+const { NAPIASYNCCONTEXT } = async_wrap.Providers;
+const events = [];
+let contextUid = null;
+
+async_wrap.setupHooks({
+  init(uid, provider) {
+    if (provider !== NAPIASYNCCONTEXT)
+      return;
+    assert.strictEqual(this.owner, resource);
+    contextUid = uid;
+    events.push('init');
+  },
+  pre(uid) {
+    if (uid === contextUid)
+      events.push('pre');
+  },
+  post(uid, didThrow) {
+    if (uid === contextUid)
+      events.push(`post ${didThrow}`);
+  },
+  destroy(uid) {
+    if (uid === contextUid)
+      events.push('destroy');
+  }
+});
+async_wrap.enable();
+
+const resource = {};
+test_uv_loop.setTimeout(resource, 10, common.mustCall(function() {
+  assert.strictEqual(this, resource);
+  events.push('callback');
+  process.nextTick(common.mustCall(() => events.push('tick')));
+}));
+async_wrap.disable();
+
+// The destroy hooks run once the loop is idle.
+process.on('beforeExit', common.mustCall(() => {
+  assert.deepStrictEqual(events, [
+    'init', 'pre', 'callback', 'post false', 'tick', 'destroy'
+  ]);
+}));
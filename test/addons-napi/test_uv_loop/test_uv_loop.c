@@ -0,0 +1,79 @@
+#include <node_api.h>
+#include <stdlib.h>
+#include <uv.h>
+#include "../common.h"
+
+// A timer that the addon runs on the loop of the env itself, calling back
+// into JavaScript in an async context of its own.
+typedef struct {
+  uv_timer_t handle;
+  napi_env env;
+  napi_ref resource;
+  napi_ref callback;
+  napi_async_context context;
+} addon_timer;
+
+static void OnClose(uv_handle_t* handle) {
+  free(handle);
+}
+
+static void OnTimer(uv_timer_t* handle) {
+  addon_timer* timer = (addon_timer*)handle;
+  napi_env env = timer->env;
+  napi_handle_scope scope;
+  NAPI_CALL_RETURN_VOID(env, napi_open_handle_scope(env, &scope));
+
+  napi_value resource, callback, result;
+  NAPI_CALL_RETURN_VOID(env,
+    napi_get_reference_value(env, timer->resource, &resource));
+  NAPI_CALL_RETURN_VOID(env,
+    napi_get_reference_value(env, timer->callback, &callback));
+  NAPI_CALL_RETURN_VOID(env, napi_make_callback(
+    env, timer->context, resource, callback, 0, NULL, &result));
+
+  NAPI_CALL_RETURN_VOID(env, napi_async_destroy(env, timer->context));
+  NAPI_CALL_RETURN_VOID(env, napi_delete_reference(env, timer->resource));
+  NAPI_CALL_RETURN_VOID(env, napi_delete_reference(env, timer->callback));
+  uv_close((uv_handle_t*)handle, OnClose);
+
+  NAPI_CALL_RETURN_VOID(env, napi_close_handle_scope(env, scope));
+}
+
+// setTimeout(resource, delay, callback) calls callback on resource after
+// delay milliseconds.
+napi_value SetTimeout(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+
+  uint32_t delay;
+  NAPI_CALL(env, napi_get_value_uint32(env, argv[1], &delay));
+
+  uv_loop_t* loop;
+  NAPI_CALL(env, napi_get_uv_event_loop(env, &loop));
+  NAPI_ASSERT(env, loop != NULL, "no loop");
+
+  addon_timer* timer = malloc(sizeof(*timer));
+  NAPI_ASSERT(env, timer != NULL, "malloc() failed");
+  timer->env = env;
+  NAPI_CALL(env, napi_create_reference(env, argv[0], 1, &timer->resource));
+  NAPI_CALL(env, napi_create_reference(env, argv[2], 1, &timer->callback));
+  NAPI_CALL(env, napi_async_init(env, argv[0], &timer->context));
+
+  NAPI_ASSERT(env, uv_timer_init(loop, &timer->handle) == 0,
+              "uv_timer_init() failed");
+  NAPI_ASSERT(env, uv_timer_start(&timer->handle, OnTimer, delay, 0) == 0,
+              "uv_timer_start() failed");
+  return NULL;
+}
+
+void Init(napi_env env, napi_value exports, napi_value module, void* priv) {
+  napi_property_descriptor descriptors[] = {
+    DECLARE_NAPI_PROPERTY("setTimeout", SetTimeout),
+  };
+
+  NAPI_CALL_RETURN_VOID(env, napi_define_properties(
+    env, exports, sizeof(descriptors) / sizeof(*descriptors), descriptors));
+}
+
+NAPI_MODULE(addon, Init)
@@ -0,0 +1,75 @@
+#include "base64.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "node_bench.h"
+
+using node::base64_decode;
+using node::base64_encode;
+using node::bench::DoNotOptimize;
+using node::bench::State;
+
+namespace {
+
+std::vector<char> Bytes(size_t length) {
+  std::vector<char> bytes(length);
+  for (size_t i = 0; i < length; i++)
+    bytes[i] = static_cast<char>(i * 7 + (i >> 8));
+  return bytes;
+}
+
+std::vector<char> Encoded(size_t length) {
+  const std::vector<char> bytes = Bytes(length);
+  std::vector<char> encoded(base64_encoded_size(length));
+  base64_encode(bytes.data(), bytes.size(), encoded.data(), encoded.size());
+  return encoded;
+}
+
+void Encode(State* state) {
+  const size_t length = state->arg();
+  const std::vector<char> bytes = Bytes(length);
+  std::vector<char> encoded(base64_encoded_size(length));
+  while (state->KeepRunning()) {
+    DoNotOptimize(base64_encode(bytes.data(), bytes.size(),
+                                encoded.data(), encoded.size()));
+  }
+  state->SetBytesProcessed(state->iterations() * length);
+}
+
+void Decode(State* state) {
+  const size_t length = state->arg();
+  const std::vector<char> encoded = Encoded(length);
+  std::vector<char> bytes(length);
+  while (state->KeepRunning()) {
+    DoNotOptimize(base64_decode(bytes.data(), bytes.size(),
+                                encoded.data(), encoded.size()));
+  }
+  state->SetBytesProcessed(state->iterations() * length);
+}
+
+// Line breaks take decoding off the fast path.
+void DecodeLines(State* state) {
+  const size_t length = state->arg();
+  const std::vector<char> unbroken = Encoded(length);
+  std::vector<char> encoded;
+  for (size_t i = 0; i < unbroken.size(); i += 76) {
+    encoded.insert(encoded.end(), unbroken.begin() + i,
+                   unbroken.begin() + std::min(i + 76, unbroken.size()));
+    encoded.push_back('\n');
+  }
+  std::vector<char> bytes(length);
+  while (state->KeepRunning()) {
+    DoNotOptimize(base64_decode(bytes.data(), bytes.size(),
+                                encoded.data(), encoded.size()));
+  }
+  state->SetBytesProcessed(state->iterations() * length);
+}
+
+}  // anonymous namespace
+
+NODE_BENCHMARK("base64/encode", Encode)->Arg("len", 64, 256 * 1024);
+NODE_BENCHMARK("base64/decode", Decode)->Arg("len", 64, 256 * 1024);
+NODE_BENCHMARK("base64/decode-lines", DecodeLines)->Arg("len", 64, 256 * 1024);
@@ -0,0 +1,131 @@
+#include "string_bytes.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "libplatform/libplatform.h"
+#include "node_bench.h"
+#include "v8.h"
+
+using node::StringBytes;
+using node::bench::DoNotOptimize;
+using node::bench::State;
+using v8::HandleScope;
+using v8::Isolate;
+using v8::Local;
+using v8::String;
+using v8::Value;
+
+namespace {
+
+// The isolate that the strings live in. It is made once, on first use, and
+// kept until the process exits.
+Isolate* GetIsolate() {
+  static Isolate* isolate = nullptr;
+  if (isolate == nullptr) {
+    v8::V8::InitializePlatform(v8::platform::CreateDefaultPlatform());
+    v8::V8::Initialize();
+    Isolate::CreateParams params;
+    params.array_buffer_allocator =
+        v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+    isolate = Isolate::New(params);
+    isolate->Enter();
+  }
+  return isolate;
+}
+
+// |ascii| bytes are below 0x80, the others are Latin-1 bytes above it.
+std::vector<char> Bytes(size_t length, bool ascii) {
+  std::vector<char> bytes(length);
+  for (size_t i = 0; i < length; i++)
+    bytes[i] = static_cast<char>(ascii ? 'a' + i % 26 : 0xc0 + i % 64);
+  return bytes;
+}
+
+void Encode(State* state, node::encoding encoding, bool ascii) {
+  Isolate* isolate = GetIsolate();
+  const size_t length = state->arg();
+  const std::vector<char> bytes = Bytes(length, ascii);
+  while (state->KeepRunning()) {
+    HandleScope handle_scope(isolate);
+    DoNotOptimize(*StringBytes::Encode(isolate, bytes.data(), bytes.size(),
+                                       encoding));
+  }
+  state->SetBytesProcessed(state->iterations() * length);
+}
+
+// Writes a string that Encode() made from the bytes back into them.
+void Write(State* state, node::encoding encoding, bool ascii) {
+  Isolate* isolate = GetIsolate();
+  HandleScope handle_scope(isolate);
+  const size_t length = state->arg();
+  std::vector<char> bytes = Bytes(length, ascii);
+  Local<Value> string =
+      StringBytes::Encode(isolate, bytes.data(), bytes.size(), encoding);
+  while (state->KeepRunning()) {
+    DoNotOptimize(StringBytes::Write(isolate, bytes.data(), bytes.size(),
+                                     string, encoding));
+  }
+  state->SetBytesProcessed(state->iterations() * length);
+}
+
+// Like Buffer.from(string, 'ucs2') and buf.toString('ucs2').
+void WriteUCS2(State* state) {
+  Isolate* isolate = GetIsolate();
+  HandleScope handle_scope(isolate);
+  const size_t length = state->arg();
+  const std::vector<char> chars = Bytes(length, true);
+  std::vector<char> bytes(length * 2);
+  Local<String> string =
+      String::NewFromOneByte(isolate,
+                             reinterpret_cast<const uint8_t*>(chars.data()),
+                             v8::NewStringType::kNormal,
+                             length).ToLocalChecked();
+  while (state->KeepRunning()) {
+    DoNotOptimize(StringBytes::Write(isolate, bytes.data(), bytes.size(),
+                                     string, node::UCS2));
+  }
+  state->SetBytesProcessed(state->iterations() * bytes.size());
+}
+
+void EncodeUCS2(State* state) {
+  Isolate* isolate = GetIsolate();
+  const size_t length = state->arg();
+  std::vector<uint16_t> units(length);
+  for (size_t i = 0; i < length; i++)
+    units[i] = 0x400 + i % 256;
+  while (state->KeepRunning()) {
+    HandleScope handle_scope(isolate);
+    DoNotOptimize(*StringBytes::Encode(isolate, units.data(), units.size()));
+  }
+  state->SetBytesProcessed(state->iterations() * length * 2);
+}
+
+void EncodeHex(State* state) { Encode(state, node::HEX, false); }
+void EncodeBase64(State* state) { Encode(state, node::BASE64, false); }
+void EncodeLatin1(State* state) { Encode(state, node::LATIN1, false); }
+void EncodeUTF8(State* state) { Encode(state, node::UTF8, true); }
+void EncodeASCII(State* state) { Encode(state, node::ASCII, true); }
+void WriteHex(State* state) { Write(state, node::HEX, false); }
+void WriteBase64(State* state) { Write(state, node::BASE64, false); }
+void WriteLatin1(State* state) { Write(state, node::LATIN1, false); }
+void WriteUTF8(State* state) { Write(state, node::UTF8, true); }
+
+}  // anonymous namespace
+
+#define V(name, function)                                                     \
+  NODE_BENCHMARK("string_bytes/" name, function)->Arg("len", 64, 256 * 1024);
+V("encode-hex", EncodeHex)
+V("encode-base64", EncodeBase64)
+V("encode-latin1", EncodeLatin1)
+V("encode-utf8", EncodeUTF8)
+V("encode-ascii", EncodeASCII)
+V("encode-ucs2", EncodeUCS2)
+V("write-hex", WriteHex)
+V("write-base64", WriteBase64)
+V("write-latin1", WriteLatin1)
+V("write-utf8", WriteUTF8)
+V("write-ucs2", WriteUCS2)
+#undef V
@@ -0,0 +1,86 @@
+#include "string_search.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "node_bench.h"
+
+using node::SearchString;
+using node::bench::DoNotOptimize;
+using node::bench::State;
+
+namespace {
+
+// Text in which the needles below do not occur, so that every search scans
+// all of it.
+std::string Haystack(size_t length) {
+  static const char words[] =
+      "the quick brown fox jumps over the lazy dog and keeps on running "
+      "through fields of wheat, past rivers and hills, towards the sea. ";
+  std::string haystack;
+  haystack.reserve(length);
+  while (haystack.size() < length)
+    haystack.append(words, std::min(sizeof(words) - 1,
+                                    length - haystack.size()));
+  return haystack;
+}
+
+void Search(State* state, const std::string& needle, bool forward) {
+  const size_t length = state->arg();
+  const std::string haystack = Haystack(length);
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(haystack.data());
+  const uint8_t* pattern = reinterpret_cast<const uint8_t*>(needle.data());
+  // A backward search starts at the end, as buf.lastIndexOf() does.
+  const size_t start = forward ? 0 : haystack.size();
+  while (state->KeepRunning()) {
+    DoNotOptimize(SearchString(data, haystack.size(),
+                               pattern, needle.size(),
+                               start, forward));
+  }
+  state->SetBytesProcessed(state->iterations() * length);
+}
+
+void OneByte(State* state) {
+  Search(state, "#", true);
+}
+
+void Short(State* state) {
+  Search(state, "fox!", true);
+}
+
+void Long(State* state) {
+  Search(state, "towards the sea, through fields of corn", true);
+}
+
+void LongBackward(State* state) {
+  Search(state, "towards the sea, through fields of corn", false);
+}
+
+// The search of Buffer#indexOf() for a two-byte needle.
+void TwoByte(State* state) {
+  const size_t length = state->arg();
+  const std::string narrow = Haystack(length);
+  const std::vector<uint16_t> haystack(narrow.begin(), narrow.end());
+  const std::string narrow_needle = "over the lazy cat";
+  const std::vector<uint16_t> needle(narrow_needle.begin(),
+                                     narrow_needle.end());
+  while (state->KeepRunning()) {
+    DoNotOptimize(SearchString(haystack.data(), haystack.size(),
+                               needle.data(), needle.size(),
+                               0, true));
+  }
+  state->SetBytesProcessed(state->iterations() * length * 2);
+}
+
+}  // anonymous namespace
+
+NODE_BENCHMARK("string_search/one-byte", OneByte)->Arg("len", 64, 256 * 1024);
+NODE_BENCHMARK("string_search/short", Short)->Arg("len", 64, 256 * 1024);
+NODE_BENCHMARK("string_search/long", Long)->Arg("len", 64, 256 * 1024);
+NODE_BENCHMARK("string_search/long-backward", LongBackward)
+    ->Arg("len", 64, 256 * 1024);
+NODE_BENCHMARK("string_search/two-byte", TwoByte)->Arg("len", 64, 256 * 1024);
@@ -0,0 +1,204 @@
+#include "node_bench.h"
+
+#include "uv.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Runs the benchmarks that are registered with NODE_BENCHMARK(). Options:
+//
+//   --filter=STRING  only run the benchmarks whose names contain STRING
+//   --runs=N         run each configuration N times, 5 by default
+//   --time=SECONDS   time each run for at least SECONDS, 0.5 by default
+//   --binary=LABEL   what to put in the binary column, "new" by default
+//   --no-header      do not print the csv header
+//   --list           list the benchmarks instead of running them
+//
+// To compare two builds:
+//
+//   $ old/cbench --binary=old > compare.csv
+//   $ new/cbench --binary=new --no-header >> compare.csv
+//   $ cat compare.csv | Rscript benchmark/compare.R
+
+namespace node {
+namespace bench {
+
+namespace {
+
+std::vector<Benchmark*>* benchmarks;
+
+struct Options {
+  const char* filter = "";
+  int runs = 5;
+  double time = 0.5;
+  const char* binary = "new";
+  bool header = true;
+  bool list = false;
+};
+
+bool ParseOption(const char* arg, Options* options) {
+  if (strncmp(arg, "--filter=", 9) == 0) {
+    options->filter = arg + 9;
+  } else if (strncmp(arg, "--runs=", 7) == 0) {
+    options->runs = atoi(arg + 7);
+    return options->runs > 0;
+  } else if (strncmp(arg, "--time=", 7) == 0) {
+    options->time = atof(arg + 7);
+    return options->time > 0;
+  } else if (strncmp(arg, "--binary=", 9) == 0) {
+    options->binary = arg + 9;
+  } else if (strcmp(arg, "--no-header") == 0) {
+    options->header = false;
+  } else if (strcmp(arg, "--list") == 0) {
+    options->list = true;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Runs |benchmark| for as many iterations as it takes to fill |seconds|,
+// and returns the last, timed state.
+State Measure(const Benchmark& benchmark, int64_t arg, double seconds) {
+  const uint64_t target = static_cast<uint64_t>(seconds * 1e9);
+  uint64_t iterations = 1;
+  for (;;) {
+    State state(iterations, arg);
+    benchmark.function()(&state);
+    const uint64_t elapsed = state.elapsed();
+    if (elapsed >= target || iterations >= (UINT64_C(1) << 40))
+      return state;
+    // Aim a little beyond the target, so that the next run is the last one
+    // even if it is a bit faster, but grow by at most 10x at a time, as very
+    // short runs say little about the rate.
+    uint64_t next = elapsed == 0 ?
+        iterations * 10 :
+        static_cast<uint64_t>(1.2 * target / elapsed * iterations);
+    next = std::min(next, iterations * 10);
+    iterations = std::max(next, iterations + 1);
+  }
+}
+
+void Report(const Options& options,
+            const Benchmark& benchmark,
+            const std::string& configuration,
+            const State& state) {
+  const double seconds = state.elapsed() / 1e9;
+  const uint64_t work = state.bytes_processed() > 0 ?
+      state.bytes_processed() : state.iterations();
+  printf("\"%s\", \"%s\", \"%s\", %.2f, %.9f, NA\n",
+         options.binary,
+         benchmark.name(),
+         configuration.c_str(),
+         work / seconds,
+         seconds);
+  fflush(stdout);
+}
+
+}  // anonymous namespace
+
+
+bool State::KeepRunning() {
+  if (remaining_ == iterations_)
+    start_ = uv_hrtime();
+  if (remaining_ > 0) {
+    remaining_--;
+    return true;
+  }
+  end_ = uv_hrtime();
+  return false;
+}
+
+
+Benchmark::Benchmark(const char* name, Function function)
+    : name_(name), function_(function), arg_name_(nullptr) {
+  if (benchmarks == nullptr)
+    benchmarks = new std::vector<Benchmark*>();
+  benchmarks->push_back(this);
+}
+
+
+Benchmark* Benchmark::Arg(const char* arg_name, int64_t value) {
+  arg_name_ = arg_name;
+  args_.push_back(value);
+  return this;
+}
+
+
+Benchmark* Benchmark::Arg(const char* arg_name, int64_t first, int64_t last) {
+  for (int64_t value = first; value < last; value *= 8)
+    Arg(arg_name, value);
+  return Arg(arg_name, last);
+}
+
+
+#if !defined(__GNUC__)
+void UseValue(const volatile void* value) {}
+#endif
+
+}  // namespace bench
+}  // namespace node
+
+
+int main(int argc, char** argv) {
+  using node::bench::Benchmark;
+  using node::bench::Options;
+
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (!node::bench::ParseOption(argv[i], &options)) {
+      fprintf(stderr, "%s: bad option: %s\n", argv[0], argv[i]);
+      return 9;
+    }
+  }
+
+  std::vector<Benchmark*> benchmarks;
+  if (node::bench::benchmarks != nullptr) {
+    for (Benchmark* benchmark : *node::bench::benchmarks) {
+      if (strstr(benchmark->name(), options.filter) != nullptr)
+        benchmarks.push_back(benchmark);
+    }
+  }
+  // The order of the files of the target is not one to rely on.
+  std::stable_sort(benchmarks.begin(), benchmarks.end(),
+                   [](const Benchmark* a, const Benchmark* b) {
+                     return strcmp(a->name(), b->name()) < 0;
+                   });
+
+  if (options.list) {
+    for (const Benchmark* benchmark : benchmarks)
+      printf("%s\n", benchmark->name());
+    return 0;
+  }
+
+  if (options.header)
+    printf("\"binary\", \"filename\", \"configuration\", \"rate\", \"time\", "
+           "\"p99\"\n");
+
+  for (const Benchmark* benchmark : benchmarks) {
+    std::vector<int64_t> args = benchmark->args();
+    if (args.empty())
+      args.push_back(0);
+    for (int64_t arg : args) {
+      std::string configuration;
+      if (benchmark->arg_name() != nullptr) {
+        char value[32];
+        snprintf(value, sizeof(value), "%" PRId64, arg);
+        configuration = std::string(benchmark->arg_name()) + "=" + value;
+      }
+      for (int run = 0; run < options.runs; run++) {
+        node::bench::State state =
+            node::bench::Measure(*benchmark, arg, options.time);
+        node::bench::Report(options, *benchmark, configuration, state);
+      }
+    }
+  }
+
+  return 0;
+}
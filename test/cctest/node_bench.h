@@ -0,0 +1,111 @@
+#ifndef TEST_CCTEST_NODE_BENCH_H_
+#define TEST_CCTEST_NODE_BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// A small harness for benchmarks of C++ primitives, in the style of Google
+// Benchmark:
+//
+//   static void Base64Encode(node::bench::State* state) {
+//     const size_t length = state->arg();
+//     ...set up...
+//     while (state->KeepRunning())
+//       node::bench::DoNotOptimize(base64_encode(...));
+//     state->SetBytesProcessed(state->iterations() * length);
+//   }
+//   NODE_BENCHMARK("base64/encode", Base64Encode)->Arg("len", 64, 65536);
+//
+// Only the loop is timed. The rate that is reported is bytes per second if
+// the benchmark sets the bytes it processed, and iterations per second
+// otherwise. The results are printed as the csv that benchmark/compare.js
+// prints, so that they can be fed to benchmark/compare.R.
+
+namespace node {
+namespace bench {
+
+class State {
+ public:
+  State(uint64_t iterations, int64_t arg)
+      : iterations_(iterations),
+        remaining_(iterations),
+        arg_(arg),
+        bytes_processed_(0),
+        start_(0),
+        end_(0) {}
+
+  // The timing starts when this is first called, and ends when it returns
+  // false.
+  bool KeepRunning();
+
+  uint64_t iterations() const { return iterations_; }
+  int64_t arg() const { return arg_; }
+
+  void SetBytesProcessed(uint64_t bytes) { bytes_processed_ = bytes; }
+  uint64_t bytes_processed() const { return bytes_processed_; }
+
+  // In nanoseconds.
+  uint64_t elapsed() const { return end_ - start_; }
+
+ private:
+  const uint64_t iterations_;
+  uint64_t remaining_;
+  const int64_t arg_;
+  uint64_t bytes_processed_;
+  uint64_t start_;
+  uint64_t end_;
+};
+
+typedef void (*Function)(State* state);
+
+class Benchmark {
+ public:
+  Benchmark(const char* name, Function function);
+
+  // Runs the benchmark with |value| as state->arg(), which is reported as
+  // |arg_name|=|value|.
+  Benchmark* Arg(const char* arg_name, int64_t value);
+  // The same, for each of |first|, |first| * 8, ... up to |last|.
+  Benchmark* Arg(const char* arg_name, int64_t first, int64_t last);
+
+  const char* name() const { return name_; }
+  Function function() const { return function_; }
+  const char* arg_name() const { return arg_name_; }
+  const std::vector<int64_t>& args() const { return args_; }
+
+ private:
+  const char* const name_;
+  const Function function_;
+  const char* arg_name_;
+  std::vector<int64_t> args_;
+};
+
+#if !defined(__GNUC__)
+void UseValue(const volatile void* value);
+#endif
+
+// Keeps the compiler from optimizing away the computation of |value|.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");  // NOLINT(whitespace/parens)
+#else
+  UseValue(&value);
+#endif
+}
+
+}  // namespace bench
+}  // namespace node
+
+#define NODE_BENCHMARK_CONCAT2(a, b) a ## b
+#define NODE_BENCHMARK_CONCAT(a, b) NODE_BENCHMARK_CONCAT2(a, b)
+
+#define NODE_BENCHMARK(name, function)                                        \
+  static node::bench::Benchmark* NODE_BENCHMARK_CONCAT(benchmark_,            \
+                                                       __LINE__) =            \
+      (new node::bench::Benchmark(name, function))
+
+#endif  // TEST_CCTEST_NODE_BENCH_H_
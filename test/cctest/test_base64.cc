@@ -125,3 +125,46 @@ TEST(Base64Test, Decode) {
        "dCBjdXBpZGF0YXQgbm9uIHByb2lkZW50LCBzdW50IGluIGN1bHBhIHF1aSBvZmZpY2lh\n"
        "IGRlc2VydW50IG1vbGxpdCBhbmltIGlkIGVzdCBsYWJvcnVtLg", text);
 }
+
+TEST(Base64Test, RoundTripLong) {
+  // Long enough for every vectorized kernel, at every alignment of the tail.
+  for (size_t len = 0; len < 200; len++) {
+    char* const data = new char[len];
+    for (size_t i = 0; i < len; i++)
+      data[i] = static_cast<char>(i * 37 + len);
+    const size_t encoded_len = base64_encoded_size(len);
+    char* const encoded = new char[encoded_len];
+    base64_encode(data, len, encoded, encoded_len);
+    char* const decoded = new char[len + 1];
+    EXPECT_EQ(len, base64_decode(decoded, len, encoded, encoded_len));
+    EXPECT_EQ(0, memcmp(data, decoded, len));
+    delete[] decoded;
+    delete[] encoded;
+    delete[] data;
+  }
+}
+
+TEST(Base64Test, DecodeUrlSafeLong) {
+  const char* url = "-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_"
+                    "-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_";
+  const char* std = "+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/"
+                    "+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/";
+  const size_t len = strlen(url) / 4 * 3;
+  char a[72];
+  char b[72];
+  EXPECT_EQ(len, base64_decode(a, sizeof(a), url, strlen(url)));
+  EXPECT_EQ(len, base64_decode(b, sizeof(b), std, strlen(std)));
+  EXPECT_EQ(0, memcmp(a, b, len));
+}
+
+TEST(Base64Test, DecodeIntoShortBuffer) {
+  // The bytes after the end of the destination are left alone.
+  const char* base64 = "QUJD" "QUJD" "QUJD" "QUJD" "QUJD" "QUJD" "QUJD" "QUJD"
+                       "QUJD" "QUJD" "QUJD" "QUJD" "QUJD" "QUJD" "QUJD" "QUJD";
+  char buffer[48];
+  memset(buffer, '.', sizeof(buffer));
+  EXPECT_EQ(31u, base64_decode(buffer, 31, base64, strlen(base64)));
+  EXPECT_EQ(0, memcmp(buffer, "ABCABCABCABCABCABCABCABCABCABCA", 31));
+  for (size_t i = 31; i < sizeof(buffer); i++)
+    EXPECT_EQ('.', buffer[i]);
+}
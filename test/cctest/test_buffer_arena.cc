@@ -0,0 +1,78 @@
+#include "buffer_arena.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::BufferArena;
+
+TEST(BufferArenaTest, SizeClasses) {
+  BufferArena arena;
+  EXPECT_EQ(nullptr, arena.Allocate(0));
+  EXPECT_EQ(nullptr, arena.Allocate(BufferArena::kMaxSize + 1));
+
+  // Blocks of one size class are packed into the same slab, a block size
+  // apart.
+  char* a = static_cast<char*>(arena.Allocate(100));
+  char* b = static_cast<char*>(arena.Allocate(128));
+  ASSERT_NE(nullptr, a);
+  ASSERT_NE(nullptr, b);
+  EXPECT_EQ(128, b - a);
+  EXPECT_EQ(BufferArena::kSlabSize, arena.slab_bytes());
+
+  void* c = arena.Allocate(BufferArena::kMaxSize);
+  ASSERT_NE(nullptr, c);
+  memset(c, 0, BufferArena::kMaxSize);
+  EXPECT_EQ(2 * BufferArena::kSlabSize, arena.slab_bytes());
+
+  EXPECT_TRUE(arena.Free(a));
+  EXPECT_TRUE(arena.Free(b));
+  EXPECT_TRUE(arena.Free(c));
+}
+
+TEST(BufferArenaTest, ReusesFreedBlocks) {
+  BufferArena arena;
+  void* a = arena.Allocate(1000);
+  void* b = arena.Allocate(1000);
+  EXPECT_TRUE(arena.Free(a));
+  EXPECT_EQ(a, arena.Allocate(1024));
+  EXPECT_TRUE(arena.Free(a));
+  EXPECT_TRUE(arena.Free(b));
+  // The last slab with room of a size class is kept.
+  EXPECT_EQ(BufferArena::kSlabSize, arena.slab_bytes());
+}
+
+TEST(BufferArenaTest, ReleasesEmptySlabs) {
+  BufferArena arena;
+  const size_t size = BufferArena::kMaxSize;
+  const size_t per_slab = BufferArena::kSlabSize / size;
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < 3 * per_slab; i++) {
+    void* block = arena.Allocate(size);
+    ASSERT_NE(nullptr, block);
+    memset(block, static_cast<int>(i), size);
+    blocks.push_back(block);
+  }
+  EXPECT_EQ(3 * BufferArena::kSlabSize, arena.slab_bytes());
+
+  // Nothing was handed out twice.
+  for (size_t i = 0; i < blocks.size(); i++)
+    EXPECT_EQ(static_cast<char>(i), *static_cast<char*>(blocks[i]));
+
+  for (void* block : blocks)
+    EXPECT_TRUE(arena.Free(block));
+  EXPECT_EQ(BufferArena::kSlabSize, arena.slab_bytes());
+}
+
+TEST(BufferArenaTest, FreeOfForeignMemory) {
+  BufferArena arena;
+  void* block = arena.Allocate(64);
+  void* data = malloc(64);
+  EXPECT_FALSE(arena.Free(data));
+  EXPECT_FALSE(arena.Free(nullptr));
+  free(data);
+  EXPECT_TRUE(arena.Free(block));
+}
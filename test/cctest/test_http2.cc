@@ -0,0 +1,260 @@
+#include "node_http2_core.h"
+#include "node_http2_hpack.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using node::http2::Event;
+using node::http2::Header;
+using node::http2::Headers;
+using node::http2::Session;
+using node::http2::Settings;
+
+namespace hpack = node::http2::hpack;
+
+namespace {
+
+std::string FromHex(const char* hex) {
+  std::string out;
+  for (; hex[0] != '\0' && hex[1] != '\0'; hex += 2)
+    out.push_back(static_cast<char>(strtol(std::string(hex, 2).c_str(),
+                                           nullptr, 16)));
+  return out;
+}
+
+bool Decode(hpack::Decoder* decoder, const std::string& block,
+            Headers* headers) {
+  bool too_large = false;
+  headers->clear();
+  const bool ok =
+      decoder->Decode(reinterpret_cast<const uint8_t*>(block.data()),
+                      block.size(), 1 << 20, headers, &too_large);
+  return ok && !too_large;
+}
+
+// Moves frames between the two sessions until neither has anything to send.
+void Pump(Session* a, Session* b) {
+  for (;;) {
+    std::string from_a;
+    std::string from_b;
+    a->Send(1 << 20, &from_a);
+    b->Send(1 << 20, &from_b);
+    if (from_a.empty() && from_b.empty())
+      return;
+    b->Receive(reinterpret_cast<const uint8_t*>(from_a.data()),
+               from_a.size());
+    a->Receive(reinterpret_cast<const uint8_t*>(from_b.data()),
+               from_b.size());
+  }
+}
+
+}  // anonymous namespace
+
+TEST(Http2HpackTest, RequestExamplesWithHuffman) {
+  // RFC 7541, C.4.1 and C.4.2.
+  hpack::Encoder encoder;
+  hpack::Decoder decoder;
+  Headers first = {
+    Header(":method", "GET"),
+    Header(":scheme", "http"),
+    Header(":path", "/"),
+    Header(":authority", "www.example.com")
+  };
+  std::string block;
+  encoder.Encode(first, &block);
+  EXPECT_EQ(FromHex("828684418cf1e3c2e5f23a6ba0ab90f4ff"), block);
+
+  Headers decoded;
+  ASSERT_TRUE(Decode(&decoder, block, &decoded));
+  ASSERT_EQ(4u, decoded.size());
+  EXPECT_EQ(":authority", decoded[3].name);
+  EXPECT_EQ("www.example.com", decoded[3].value);
+
+  Headers second = first;
+  second.push_back(Header("cache-control", "no-cache"));
+  block.clear();
+  encoder.Encode(second, &block);
+  EXPECT_EQ(FromHex("828684be5886a8eb10649cbf"), block);
+  ASSERT_TRUE(Decode(&decoder, block, &decoded));
+  ASSERT_EQ(5u, decoded.size());
+  EXPECT_EQ("no-cache", decoded[4].value);
+}
+
+TEST(Http2HpackTest, SensitiveHeadersAreNotIndexed) {
+  hpack::Encoder encoder;
+  hpack::Decoder decoder;
+  Headers headers = { Header("authorization", "secret") };
+  std::string first;
+  std::string second;
+  encoder.Encode(headers, &first);
+  encoder.Encode(headers, &second);
+  // Sent literally both times, as "never indexed".
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(0x10, static_cast<uint8_t>(first[0]) & 0xf0);
+}
+
+TEST(Http2HpackTest, TableSizeUpdates) {
+  hpack::Encoder encoder;
+  hpack::Decoder decoder;
+  Headers headers = { Header("x-custom", "value") };
+  std::string block;
+  encoder.Encode(headers, &block);
+  Headers decoded;
+  ASSERT_TRUE(Decode(&decoder, block, &decoded));
+
+  // The peer has to see the smallest size before the final one.
+  encoder.SetMaxTableSize(0);
+  encoder.SetMaxTableSize(100);
+  block.clear();
+  encoder.Encode(headers, &block);
+  EXPECT_EQ(0x20, static_cast<uint8_t>(block[0]));
+  ASSERT_TRUE(Decode(&decoder, block, &decoded));
+  ASSERT_EQ(1u, decoded.size());
+  EXPECT_EQ("value", decoded[0].value);
+
+  // Sizes beyond what was allowed through SETTINGS are errors.
+  decoder.SetMaxTableSizeLimit(50);
+  EXPECT_FALSE(Decode(&decoder, FromHex("3f4582"), &decoded));
+}
+
+TEST(Http2HpackTest, HuffmanRoundTrip) {
+  uint32_t seed = 1;
+  for (int i = 0; i < 2000; i++) {
+    std::string value;
+    seed = seed * 1103515245 + 12345;
+    const size_t length = (seed >> 16) % 64;
+    for (size_t j = 0; j < length; j++) {
+      seed = seed * 1103515245 + 12345;
+      value.push_back(static_cast<char>(seed >> 24));
+    }
+    std::string encoded;
+    hpack::HuffmanEncode(value, &encoded);
+    EXPECT_EQ(hpack::HuffmanEncodedLength(value), encoded.size());
+    std::string decoded;
+    ASSERT_TRUE(hpack::HuffmanDecode(
+        reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size(),
+        &decoded));
+    EXPECT_EQ(value, decoded);
+  }
+
+  // Padding longer than 7 bits, or not made of ones, is an error.
+  std::string decoded;
+  const uint8_t bad_padding[] = { 0x1f, 0x00 };
+  EXPECT_FALSE(hpack::HuffmanDecode(bad_padding, sizeof(bad_padding),
+                                    &decoded));
+  const uint8_t long_padding[] = { 0xff };
+  EXPECT_FALSE(hpack::HuffmanDecode(long_padding, sizeof(long_padding),
+                                    &decoded));
+}
+
+TEST(Http2SessionTest, ExchangeWithFlowControl) {
+  Settings settings;
+  Session client(Session::kClient, settings);
+  Session server(Session::kServer, settings);
+
+  Headers request = {
+    Header(":method", "POST"),
+    Header(":scheme", "http"),
+    Header(":path", "/"),
+    Header(":authority", "localhost")
+  };
+  const int32_t id = client.SubmitRequest(request, false);
+  ASSERT_EQ(1, id);
+
+  // Several times the initial windows.
+  std::string body(300000, '\0');
+  for (size_t i = 0; i < body.size(); i++)
+    body[i] = 'a' + i % 26;
+  ASSERT_TRUE(client.SubmitData(id, body.data(), body.size()));
+  ASSERT_TRUE(client.SubmitEnd(id, nullptr));
+
+  std::string received;
+  std::string response;
+  bool trailers = false;
+  uint32_t close_code = 0xff;
+  Event event;
+  for (int i = 0; i < 100 && close_code == 0xff; i++) {
+    Pump(&client, &server);
+    while (server.NextEvent(&event)) {
+      ASSERT_NE(Event::kError, event.type);
+      if (event.type == Event::kHeaders) {
+        EXPECT_EQ(node::http2::kHeadersRequest, event.category);
+        Headers headers = { Header(":status", "200") };
+        ASSERT_TRUE(server.SubmitResponse(event.stream_id, headers, false));
+      } else if (event.type == Event::kData) {
+        received += event.data;
+        server.ConsumeData(event.stream_id, event.data.size());
+      } else if (event.type == Event::kStreamEnd) {
+        ASSERT_TRUE(server.SubmitData(event.stream_id, received.data(),
+                                      received.size()));
+        Headers headers = { Header("x-trailer", "1") };
+        ASSERT_TRUE(server.SubmitEnd(event.stream_id, &headers));
+      }
+    }
+    while (client.NextEvent(&event)) {
+      ASSERT_NE(Event::kError, event.type);
+      if (event.type == Event::kHeaders &&
+          event.category == node::http2::kHeadersTrailers) {
+        trailers = true;
+      } else if (event.type == Event::kData) {
+        response += event.data;
+        client.ConsumeData(event.stream_id, event.data.size());
+      } else if (event.type == Event::kStreamClose) {
+        close_code = event.code;
+      }
+    }
+  }
+
+  EXPECT_EQ(body, received);
+  EXPECT_EQ(body, response);
+  EXPECT_TRUE(trailers);
+  EXPECT_EQ(static_cast<uint32_t>(node::http2::kNO_ERROR), close_code);
+  EXPECT_EQ(0u, client.stream_count());
+  EXPECT_EQ(0u, server.stream_count());
+}
+
+TEST(Http2SessionTest, UnconsumedDataStopsThePeer) {
+  Settings settings;
+  Session client(Session::kClient, settings);
+  Session server(Session::kServer, settings);
+
+  Headers request = {
+    Header(":method", "PUT"),
+    Header(":scheme", "http"),
+    Header(":path", "/"),
+    Header(":authority", "localhost")
+  };
+  const int32_t id = client.SubmitRequest(request, false);
+  std::string body(200000, 'x');
+  ASSERT_TRUE(client.SubmitData(id, body.data(), body.size()));
+  Pump(&client, &server);
+
+  size_t received = 0;
+  Event event;
+  while (server.NextEvent(&event)) {
+    if (event.type == Event::kData)
+      received += event.data.size();
+  }
+  EXPECT_EQ(node::http2::kDefaultWindowSize, received);
+  EXPECT_EQ(body.size() - received, client.QueuedData(id));
+
+  server.ConsumeData(id, received);
+  Pump(&client, &server);
+  while (server.NextEvent(&event)) {
+    if (event.type == Event::kData)
+      received += event.data.size();
+  }
+  EXPECT_LT(node::http2::kDefaultWindowSize, received);
+}
+
+TEST(Http2SessionTest, InvalidPrefaceFailsTheSession) {
+  Settings settings;
+  Session server(Session::kServer, settings);
+  const char request[] = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  EXPECT_FALSE(server.Receive(reinterpret_cast<const uint8_t*>(request),
+                              sizeof(request) - 1));
+  EXPECT_TRUE(server.failed());
+}
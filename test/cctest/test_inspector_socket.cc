@@ -886,6 +886,63 @@ TEST_F(InspectorSocketTest, Send1Mb) {
                          reinterpret_cast<uv_handle_t*>(&client_socket)));
 }
 
+static int released_utf16_messages = 0;
+
+static void release_utf16_message(void* data) {
+  released_utf16_messages++;
+}
+
+TEST_F(InspectorSocketTest, SendsUtf16InChunks) {
+  ASSERT_TRUE(connected);
+  ASSERT_FALSE(inspector_ready);
+  do_write(const_cast<char*>(HANDSHAKE_REQ), sizeof(HANDSHAKE_REQ) - 1);
+  SPIN_WHILE(!inspector_ready);
+  expect_handshake();
+
+  // 'a', U+00E9, U+20AC and U+1F600, 5 code units and 10 bytes of UTF-8.
+  // Chunks end in the middle of a surrogate pair. The message ends with a
+  // lone surrogate.
+  const uint16_t PATTERN[] = { 'a', 0xE9, 0x20AC, 0xD83D, 0xDE00 };
+  const char PATTERN_UTF8[] = "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+  const size_t REPEAT = 20000;
+  std::vector<uint16_t> message;
+  std::string utf8;
+  for (size_t i = 0; i < REPEAT; i++) {
+    message.insert(message.end(), PATTERN, PATTERN + 5);
+    utf8.append(PATTERN_UTF8, sizeof(PATTERN_UTF8) - 1);
+  }
+  message.push_back(0xD800);
+  utf8.append("\xEF\xBF\xBD");
+
+  // 200003 is 0x30D43 hex
+  const char EXPECTED_FRAME_HEADER[] = {
+    '\x81', '\x7f', '\x00', '\x00', '\x00', '\x00', '\x00', '\x03',
+    '\x0D', '\x43'
+  };
+  std::string expected(EXPECTED_FRAME_HEADER, sizeof(EXPECTED_FRAME_HEADER));
+  expected.append(utf8);
+  // Written after the message, not in between its chunks.
+  const char NEXT_FRAME[] = {'\x81', '\x04', 'a', 'b', 'c', 'd'};
+  expected.append(NEXT_FRAME, sizeof(NEXT_FRAME));
+
+  released_utf16_messages = 0;
+  inspector_write_utf16(&inspector, message.data(), message.size(),
+                        release_utf16_message, nullptr);
+  inspector_write(&inspector, "abcd", 4);
+  expect_on_client(&expected[0], expected.size());
+  EXPECT_EQ(1, released_utf16_messages);
+
+  // 3. Close
+  setup_inspector_expecting();
+  const char CLIENT_CLOSE_FRAME[] = {'\x88', '\x80', '\x2D',
+                                     '\x0E', '\x1E', '\xFA'};
+  const char SERVER_CLOSE_FRAME[] = {'\x88', '\x00'};
+  do_write(CLIENT_CLOSE_FRAME, sizeof(CLIENT_CLOSE_FRAME));
+  expect_on_client(SERVER_CLOSE_FRAME, sizeof(SERVER_CLOSE_FRAME));
+  GTEST_ASSERT_EQ(0, uv_is_active(
+                         reinterpret_cast<uv_handle_t*>(&client_socket)));
+}
+
 static ssize_t err;
 
 void ErrorCleansUpTheSocket_cb(uv_stream_t* stream, ssize_t read,
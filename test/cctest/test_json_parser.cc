@@ -0,0 +1,233 @@
+#include "node_json_parser.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::json::Parser;
+using node::json::Token;
+
+namespace {
+
+// Writes the tape back out as compact JSON, with strings as their code units
+// in hex so that two-byte strings are easy to check.
+class Printer {
+ public:
+  explicit Printer(const Parser& parser) : parser_(parser), index_(0) {}
+
+  std::string Values() {
+    std::string out;
+    for (size_t i = 0; i < parser_.value_count(); i++) {
+      if (i > 0)
+        out += ' ';
+      Next(&out);
+    }
+    return out;
+  }
+
+ private:
+  void Next(std::string* out) {
+    const Token& token = parser_.tokens()[index_++];
+    switch (token.type) {
+      case Token::kNull:
+        *out += "null";
+        break;
+      case Token::kFalse:
+        *out += "false";
+        break;
+      case Token::kTrue:
+        *out += "true";
+        break;
+      case Token::kNumber: {
+        char number[32];
+        snprintf(number, sizeof(number), "%.17g", token.number);
+        *out += number;
+        break;
+      }
+      case Token::kOneByteString:
+        *out += '"';
+        out->append(parser_.one_byte_strings(), token.offset, token.length);
+        *out += '"';
+        break;
+      case Token::kTwoByteString: {
+        *out += "u\"";
+        for (uint32_t i = 0; i < token.length; i++) {
+          char unit[8];
+          snprintf(unit, sizeof(unit), "%s%04x", i > 0 ? " " : "",
+                   parser_.two_byte_strings()[token.offset + i]);
+          *out += unit;
+        }
+        *out += '"';
+        break;
+      }
+      case Token::kArray:
+        *out += '[';
+        for (uint32_t i = 0; i < token.length; i++) {
+          if (i > 0)
+            *out += ',';
+          Next(out);
+        }
+        *out += ']';
+        break;
+      case Token::kObject:
+        *out += '{';
+        for (uint32_t i = 0; i < token.length; i++) {
+          if (i > 0)
+            *out += ',';
+          Next(out);
+          *out += ':';
+          Next(out);
+        }
+        *out += '}';
+        break;
+    }
+  }
+
+  const Parser& parser_;
+  size_t index_;
+};
+
+// Parses |input| in pieces of |piece| bytes and returns the values, or the
+// error message.
+std::string Parse(Parser::Mode mode, const std::string& input,
+                  size_t piece = 0, size_t max_depth = 100) {
+  Parser parser(mode, max_depth);
+  std::string out;
+  if (piece == 0)
+    piece = input.size() + 1;
+  for (size_t i = 0; i < input.size(); i += piece) {
+    if (!parser.Write(input.data() + i, std::min(piece, input.size() - i)))
+      return parser.error();
+    if (parser.value_count() > 0) {
+      if (!out.empty())
+        out += ' ';
+      out += Printer(parser).Values();
+      parser.ClearValues();
+    }
+  }
+  if (!parser.End())
+    return parser.error();
+  if (parser.value_count() > 0) {
+    if (!out.empty())
+      out += ' ';
+    out += Printer(parser).Values();
+  }
+  return out;
+}
+
+}  // anonymous namespace
+
+
+TEST(JSONParserTest, Values) {
+  EXPECT_EQ("null", Parse(Parser::kValue, " null "));
+  EXPECT_EQ("[true,false,[],{}]", Parse(Parser::kValue, "[true,false,[],{}]"));
+  EXPECT_EQ("{\"a\":[1,-2.5,1000],\"b\":{\"c\":\"d\"}}",
+            Parse(Parser::kValue,
+                  "{ \"a\" : [ 1 , -2.5 , 1e3 ] , "
+                  "\"b\" : { \"c\" : \"d\" } }"));
+  EXPECT_EQ("\"a\"/\\\b\f\n\r\t\"",
+            Parse(Parser::kValue, "\"a\\\"\\/\\\\\\b\\f\\n\\r\\t\""));
+  EXPECT_EQ("123456789012345", Parse(Parser::kValue, "123456789012345"));
+  EXPECT_EQ("9007199254740992", Parse(Parser::kValue, "9007199254740993"));
+  EXPECT_EQ("-0", Parse(Parser::kValue, "-0"));
+  EXPECT_EQ("0.10000000000000001", Parse(Parser::kValue, "0.1"));
+}
+
+TEST(JSONParserTest, Strings) {
+  // Latin-1 fits in one byte.
+  EXPECT_EQ("\"\xe9\"", Parse(Parser::kValue, "\"\xc3\xa9\""));
+  EXPECT_EQ("u\"20ac\"", Parse(Parser::kValue, "\"\xe2\x82\xac\""));
+  EXPECT_EQ("u\"d83d de00\"", Parse(Parser::kValue, "\"\xf0\x9f\x98\x80\""));
+  // U+10000 is two-byte, even though its low bits are all zero.
+  EXPECT_EQ("u\"d800 dc00\"", Parse(Parser::kValue, "\"\xf0\x90\x80\x80\""));
+  // Lone surrogates from escapes are kept.
+  EXPECT_EQ("u\"d800 0061\"", Parse(Parser::kValue, "\"\\ud800a\""));
+  // Invalid UTF-8 becomes U+FFFD, once per maximal subpart.
+  EXPECT_EQ("u\"fffd 0061\"", Parse(Parser::kValue, "\"\xff" "a\""));
+  EXPECT_EQ("u\"fffd 0061\"", Parse(Parser::kValue, "\"\xe2\x82" "a\""));
+  EXPECT_EQ("u\"fffd fffd fffd\"", Parse(Parser::kValue, "\"\xed\xa0\x80\""));
+}
+
+TEST(JSONParserTest, Pieces) {
+  const std::string input =
+      "[{\"name\":\"\xe2\x82\xac\",\"values\":[1.5,true,null]},"
+      " 12345 , \"\\u00e9x\" ,false]";
+  const std::string expected = Parse(Parser::kElements, input);
+  EXPECT_EQ("{\"name\":u\"20ac\",\"values\":[1.5,true,null]} 12345 "
+            "\"\xe9x\" false", expected);
+  for (size_t piece = 1; piece < input.size(); piece++)
+    EXPECT_EQ(expected, Parse(Parser::kElements, input, piece)) << piece;
+}
+
+TEST(JSONParserTest, Sequence) {
+  EXPECT_EQ("{\"a\":1} {\"a\":2} 3 4 \"x\"",
+            Parse(Parser::kSequence, "{\"a\":1}\n{\"a\":2}\n3 4\"x\"\n"));
+  EXPECT_EQ("1 2", Parse(Parser::kSequence, "1\n2", 1));
+  EXPECT_EQ("", Parse(Parser::kSequence, " \n "));
+  EXPECT_EQ("", Parse(Parser::kElements, " [ ] "));
+}
+
+TEST(JSONParserTest, Errors) {
+  EXPECT_EQ("Unexpected end of JSON input", Parse(Parser::kValue, ""));
+  EXPECT_EQ("Unexpected end of JSON input", Parse(Parser::kValue, "[1,"));
+  EXPECT_EQ("Unexpected end of JSON input", Parse(Parser::kElements, "[1"));
+  EXPECT_EQ("Unexpected token } in JSON at position 5",
+            Parse(Parser::kValue, "[1, 2}"));
+  EXPECT_EQ("Unexpected number in JSON at position 2",
+            Parse(Parser::kValue, "1 2"));
+  EXPECT_EQ("Unexpected string in JSON at position 6",
+            Parse(Parser::kValue, "{\"a\":1\"b\":2}"));
+  EXPECT_EQ("Unexpected token \xe2\x82\xac in JSON at position 1",
+            Parse(Parser::kValue, "[\xe2\x82\xac]"));
+  EXPECT_EQ("Unexpected token \n in JSON at position 2",
+            Parse(Parser::kValue, "\"a\n\""));
+  EXPECT_EQ("Unexpected token x in JSON at position 3",
+            Parse(Parser::kValue, "tru"  "x"));
+  EXPECT_EQ("Unexpected number in JSON at position 0",
+            Parse(Parser::kElements, "1"));
+  EXPECT_EQ("Unexpected token [ in JSON at position 3",
+            Parse(Parser::kElements, "[] []"));
+  // Positions count from the start of the whole input.
+  EXPECT_EQ("Unexpected token ] in JSON at position 11",
+            Parse(Parser::kSequence, "[1]\n[2]\n[3,]", 3));
+
+  Parser parser(Parser::kValue, 100);
+  EXPECT_FALSE(parser.Write("x", 1));
+  EXPECT_TRUE(parser.failed());
+  EXPECT_FALSE(parser.Write("1", 1));
+  EXPECT_FALSE(parser.End());
+}
+
+TEST(JSONParserTest, MaxDepth) {
+  EXPECT_EQ("[[[1]]]", Parse(Parser::kValue, "[[[1]]]", 0, 3));
+  EXPECT_EQ("Nesting too deep in JSON at position 3",
+            Parse(Parser::kValue, "[[[[1]]]]", 0, 3));
+  EXPECT_EQ("[[1]]", Parse(Parser::kElements, "[[[1]]]", 0, 3));
+  EXPECT_EQ("Nesting too deep in JSON at position 0",
+            Parse(Parser::kElements, "[]", 0, 0));
+}
+
+TEST(JSONParserTest, LargeValue) {
+  // One value that grows across many writes is complete exactly once.
+  std::string input = "[";
+  for (int i = 0; i < 100000; i++)
+    input += "\"abcdefghij\",";
+  input += "0]";
+  Parser parser(Parser::kValue, 100);
+  for (size_t i = 0; i < input.size(); i += 1000) {
+    ASSERT_TRUE(parser.Write(input.data() + i,
+                             std::min<size_t>(1000, input.size() - i)));
+    ASSERT_EQ(0u, parser.value_count());
+  }
+  ASSERT_TRUE(parser.End());
+  ASSERT_EQ(1u, parser.value_count());
+  EXPECT_EQ(100001u, parser.tokens()[0].length);
+  EXPECT_EQ(100002u, parser.tokens().size());
+  EXPECT_EQ(1000000u, parser.one_byte_strings().size());
+}
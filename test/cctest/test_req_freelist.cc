@@ -0,0 +1,51 @@
+#include "req_freelist.h"
+
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::ReqFreeList;
+
+TEST(ReqFreeListTest, ReusesFreedBlocks) {
+  ReqFreeList freelist;
+  char* a = freelist.Allocate(100);
+  ASSERT_NE(nullptr, a);
+  memset(a, 0, 100);
+  freelist.Free(a, 100);
+  EXPECT_EQ(1u, freelist.free_blocks());
+
+  // Any size of the same size class gets the block back.
+  char* b = freelist.Allocate(128);
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(0u, freelist.free_blocks());
+  memset(b, 0, 128);
+
+  // Other size classes don't.
+  freelist.Free(b, 128);
+  char* c = freelist.Allocate(129);
+  EXPECT_NE(b, c);
+  memset(c, 0, 129);
+  freelist.Free(c, 129);
+  EXPECT_EQ(2u, freelist.free_blocks());
+}
+
+TEST(ReqFreeListTest, LargeBlocksAreNotKept) {
+  ReqFreeList freelist;
+  const size_t size = ReqFreeList::kMaxSize + 1;
+  char* a = freelist.Allocate(size);
+  ASSERT_NE(nullptr, a);
+  memset(a, 0, size);
+  freelist.Free(a, size);
+  EXPECT_EQ(0u, freelist.free_blocks());
+}
+
+TEST(ReqFreeListTest, KeepsAtMostMaxFreeBlocks) {
+  ReqFreeList freelist;
+  std::vector<char*> blocks;
+  for (size_t i = 0; i < 2 * ReqFreeList::kMaxFreeBlocks; i++)
+    blocks.push_back(freelist.Allocate(64));
+  for (char* block : blocks)
+    freelist.Free(block, 64);
+  EXPECT_EQ(ReqFreeList::kMaxFreeBlocks, freelist.free_blocks());
+}
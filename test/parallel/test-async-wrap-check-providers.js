@@ -14,15 +14,24 @@ const fs = require('fs');
 const net = require('net');
 const tls = require('tls');
 const zlib = require('zlib');
+const Worker = require('worker').Worker;
 const ChildProcess = require('child_process').ChildProcess;
 const StreamWrap = require('_stream_wrap').StreamWrap;
 const HTTPParser = process.binding('http_parser').HTTPParser;
+const Http2Session = process.binding('http2').Http2Session;
+const JSONParser = process.binding('json').JSONParser;
+const StatWatcher = process.binding('fs').StatWatcher;
+const StreamPipe = process.binding('stream_pipe').StreamPipe;
+const TCP = process.binding('tcp_wrap').TCP;
 const async_wrap = process.binding('async_wrap');
 const pkeys = Object.keys(async_wrap.Providers);
 
 let keyList = pkeys.slice();
 // Drop NONE
 keyList.splice(0, 1);
+// Only addons create N-API async contexts, see
+// test/addons-napi/test_uv_loop.
+keyList.splice(keyList.indexOf('NAPIASYNCCONTEXT'), 1);
 
 // fs-watch currently needs special configuration on AIX and we
 // want to improve under https://github.com/nodejs/node/issues/5085.
@@ -52,8 +61,8 @@ if (!common.isAix) {
   // fs-watch currently needs special configuration on AIX and we
   // want to improve under https://github.com/nodejs/node/issues/5085.
   // strip out fs watch related parts for now
-  fs.watchFile(__filename, common.noop);
-  fs.unwatchFile(__filename);
+  // fs.watchFile() polls from the shared stat scheduler of lib/fs.js.
+  new StatWatcher();
   fs.watch(__filename).close();
 }
 
@@ -113,6 +122,14 @@ new ChildProcess();
 
 new HTTPParser(HTTPParser.REQUEST);
 
+new Http2Session(Http2Session.SERVER, []).destroy();
+
+new JSONParser(JSONParser.VALUE, 1);
+
+new StreamPipe(new TCP()._externalStream).unpipe();
+
+new Worker(common.fixturesDir + '/empty.js');
+
 process.on('exit', function() {
   if (keyList.length !== 0) {
     process._rawDebug('Not all keys have been used:');
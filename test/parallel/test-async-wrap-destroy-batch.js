@@ -0,0 +1,44 @@
+'use strict';
+
+const common = require('../common');
+const fs = require('fs');
+const assert = require('assert');
+const async_wrap = process.binding('async_wrap');
+
+// With a destroyBatch hook, the uids of the destroyed resources are passed
+// together in a Float64Array instead of one destroy call each.
+
+// Give the event loop time to clear out the final uv_close().
+let si_cntr = 3;
+process.on('beforeExit', () => {
+  if (--si_cntr > 0) setImmediate(common.noop);
+});
+
+const created = [];
+const destroyed = [];
+let batches = 0;
+
+async_wrap.setupHooks({ init, destroy: common.mustNotCall(), destroyBatch });
+async_wrap.enable();
+
+function init(uid) {
+  created.push(uid);
+}
+
+function destroyBatch(uids) {
+  assert(uids instanceof Float64Array);
+  assert(uids.length > 0);
+  batches++;
+  destroyed.push(...uids);
+}
+
+fs.access(__filename, common.mustCall(assert.ifError));
+fs.access(__filename, common.mustCall(assert.ifError));
+
+async_wrap.disable();
+
+process.once('exit', function() {
+  assert.strictEqual(created.length, 2);
+  assert.deepStrictEqual(destroyed.sort(), created.sort());
+  assert(batches >= 1 && batches <= 2);
+});
@@ -0,0 +1,42 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+
+const key = Buffer.from('key-b');
+const list = [
+  Buffer.from('key-a'),
+  Buffer.from('key-b'),
+  Buffer.from('key-c'),
+  Buffer.from('key'),
+  Buffer.from('key-bb'),
+  Buffer.alloc(0),
+  new Uint8Array(Buffer.from('key-b')),
+  Buffer.alloc(100, 'z')
+];
+
+const results = Buffer.compareMany(key, list);
+assert(results instanceof Int8Array);
+assert.deepStrictEqual(Array.from(results),
+                       list.map((buf) => Buffer.compare(key, buf)));
+assert.deepStrictEqual(Array.from(results), [1, 0, -1, 1, -1, 1, 0, -1]);
+
+// Results can be stored in an existing, longer array.
+{
+  const out = new Int8Array(10).fill(7);
+  assert.strictEqual(Buffer.compareMany(key, list, out), out);
+  assert.deepStrictEqual(Array.from(out),
+                         [1, 0, -1, 1, -1, 1, 0, -1, 7, 7]);
+}
+
+assert.deepStrictEqual(Buffer.compareMany(key, []), new Int8Array(0));
+
+assert.throws(() => Buffer.compareMany('key', list),
+              /^TypeError: "buf" argument must be a Buffer or Uint8Array$/);
+assert.throws(() => Buffer.compareMany(key, key),
+              /^TypeError: "list" argument must be an Array of Buffer or/);
+assert.throws(() => Buffer.compareMany(key, [key, 'key']),
+              /^TypeError: "list" argument must be an Array of Buffer or/);
+assert.throws(() => Buffer.compareMany(key, list, new Uint8Array(8)),
+              /^TypeError: "results" argument must be an Int8Array$/);
+assert.throws(() => Buffer.compareMany(key, list, new Int8Array(7)),
+              /^RangeError: "results" argument must be at least as long/);
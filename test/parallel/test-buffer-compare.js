@@ -36,3 +36,23 @@ assert.throws(() => Buffer.compare('abc', Buffer.alloc(1)),
 
 assert.throws(() => Buffer.alloc(1).compare('abc'),
               /^TypeError: Argument must be a Buffer or Uint8Array$/);
+
+// Short buffers are compared in JS and long ones in C++, with the same
+// results either way.
+for (let length = 0; length < 40; length++) {
+  const x = Buffer.alloc(length, 0x61);
+  for (let i = 0; i < length; i++) {
+    const y = Buffer.from(x);
+    y[i] = 0x62;
+    assert.strictEqual(Buffer.compare(x, y), -1);
+    assert.strictEqual(Buffer.compare(y, x), 1);
+    assert.strictEqual(x.compare(y), -1);
+    assert.strictEqual(x.equals(y), false);
+  }
+  const longer = Buffer.alloc(length + 1, 0x61);
+  assert.strictEqual(Buffer.compare(x, longer), -1);
+  assert.strictEqual(Buffer.compare(longer, x), 1);
+  assert.strictEqual(x.equals(longer), false);
+  assert.strictEqual(x.equals(Buffer.from(x)), true);
+  assert.strictEqual(Buffer.compare(new Uint8Array(x), Buffer.from(x)), 0);
+}
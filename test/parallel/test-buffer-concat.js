@@ -86,3 +86,23 @@ assert.deepStrictEqual(
 assert.deepStrictEqual(Buffer.concat([new Uint8Array([0x41, 0x42]),
                                       new Uint8Array([0x43, 0x44])]),
                        Buffer.from('ABCD'));
+
+// Many small pieces, some of them views into the middle of larger buffers.
+{
+  const pieces = [];
+  let expected = '';
+  for (let i = 0; i < 300; i++) {
+    const text = `chunk${i};`;
+    const padded = Buffer.from(`__${text}__`);
+    pieces.push(i % 2 ? padded.slice(2, -2) : Buffer.from(text));
+    expected += text;
+  }
+  assert.strictEqual(Buffer.concat(pieces).toString(), expected);
+  assert.strictEqual(Buffer.concat(pieces, 100).toString(),
+                     expected.slice(0, 100));
+}
+
+// Elements after the result is full are still checked.
+assertWrongList([random10, 'hello']);
+assert.throws(() => Buffer.concat([random10, random10, {}], 10),
+              /^TypeError: "list" argument must be an Array of Buffer/);
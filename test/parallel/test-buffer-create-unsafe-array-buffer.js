@@ -0,0 +1,27 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const binding = process.binding('buffer');
+
+// Small sizes come from the allocator's arena, large ones from malloc().
+for (const size of [0, 1, 64, 1000, 64 * 1024, 64 * 1024 + 1, 1024 * 1024]) {
+  const ab = binding.createUnsafeArrayBuffer(size);
+  assert.ok(ab instanceof ArrayBuffer);
+  assert.strictEqual(ab.byteLength, size);
+  new Uint8Array(ab).fill(0xff);
+}
+
+assert.throws(() => binding.createUnsafeArrayBuffer(-1),
+              /^RangeError: Invalid array buffer length$/);
+assert.throws(() => binding.createUnsafeArrayBuffer(binding.kMaxLength + 1),
+              /^RangeError: Invalid array buffer length$/);
+
+// Uninitialized allocations do not leave zero-filling turned off for the
+// ArrayBuffers that JS creates in between.
+for (let i = 0; i < 100; i++) {
+  const unsafe = Buffer.allocUnsafe(65);
+  unsafe.fill(0xff);
+  Buffer.allocUnsafeSlow(100 * 1024).fill(0xff);
+  assert.ok(new Uint8Array(65).every((byte) => byte === 0));
+  assert.ok(new Uint8Array(100 * 1024).every((byte) => byte === 0));
+}
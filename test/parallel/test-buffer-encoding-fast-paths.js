@@ -0,0 +1,87 @@
+'use strict';
+require('../common');
+
+// Long inputs go through vectorized hex, ASCII and Latin-1 code. They must
+// give the same results as the byte at a time code for every length.
+
+const assert = require('assert');
+
+function hex(buf) {
+  let s = '';
+  for (const byte of buf)
+    s += (byte < 16 ? '0' : '') + byte.toString(16);
+  return s;
+}
+
+for (let len = 0; len < 100; len++) {
+  const buf = Buffer.alloc(len);
+  for (let i = 0; i < len; i++)
+    buf[i] = i * 97 + len;
+  const str = hex(buf);
+  assert.strictEqual(buf.toString('hex'), str);
+  assert(Buffer.from(str, 'hex').equals(buf));
+  assert(Buffer.from(str.toUpperCase(), 'hex').equals(buf));
+}
+
+// Decoding hex stops at the first pair that is not hex.
+{
+  const str = 'ab'.repeat(40) + 'zz' + 'cd'.repeat(40);
+  assert(Buffer.from(str, 'hex').equals(Buffer.alloc(40, 0xab)));
+  const buf = Buffer.alloc(100, 0);
+  assert.strictEqual(buf.write(str, 'hex'), 40);
+  assert(buf.slice(40).equals(Buffer.alloc(60, 0)));
+}
+
+// Writing hex into a short buffer leaves what comes after it alone.
+{
+  const buf = Buffer.alloc(64, 0xee);
+  assert.strictEqual(buf.write('11'.repeat(64), 3, 20, 'hex'), 20);
+  assert(buf.slice(3, 23).equals(Buffer.alloc(20, 0x11)));
+  assert(buf.slice(23).equals(Buffer.alloc(41, 0xee)));
+}
+
+// UTF-8 that is all ASCII, with and without a multi-byte character in it.
+for (const len of [15, 64, 65, 1000, 2 * 1024 * 1024]) {
+  const ascii = 'x'.repeat(len);
+  assert.strictEqual(Buffer.from(ascii).toString('utf8'), ascii);
+  const mixed = ascii.slice(1) + 'é';
+  assert.strictEqual(Buffer.from(mixed).toString('utf8'), mixed);
+  const late = ascii + '€' + ascii;
+  assert.strictEqual(Buffer.from(late).toString('utf8'), late);
+}
+
+// UTF-16 within Latin-1 and with a wider character at each position.
+{
+  let latin1 = '';
+  for (let i = 0; i < 300; i++)
+    latin1 += String.fromCharCode(i & 0xff);
+  assert.strictEqual(Buffer.from(latin1, 'ucs2').toString('ucs2'), latin1);
+  for (let i = 0; i < 40; i++) {
+    const str = latin1.slice(0, i) + 'Ā' + latin1.slice(i + 1, 40);
+    assert.strictEqual(Buffer.from(str, 'ucs2').toString('ucs2'), str);
+  }
+  const big = latin1.repeat(4000);
+  assert.strictEqual(Buffer.from(big, 'ucs2').toString('ucs2'), big);
+}
+
+// UCS-2 at any alignment, with long strings and strings that are external.
+{
+  const latin1 = 'café '.repeat(400);
+  const twoByte = '€é'.repeat(800);
+  const external = Buffer.from(latin1, 'latin1').toString('latin1');
+  for (const str of [latin1, twoByte, external]) {
+    const expected = Buffer.alloc(str.length * 2);
+    for (let i = 0; i < str.length; i++)
+      expected.writeUInt16LE(str.charCodeAt(i), i * 2);
+    for (const offset of [0, 1]) {
+      const buf = Buffer.alloc(offset + expected.length + 1);
+      assert.strictEqual(buf.write(str, offset, 'ucs2'), expected.length);
+      assert(buf.slice(offset, offset + expected.length).equals(expected));
+      assert.strictEqual(buf.toString('ucs2', offset,
+                                      offset + expected.length), str);
+      // Only whole characters are written.
+      const short = Buffer.alloc(offset + 101);
+      assert.strictEqual(short.write(str, offset, 'ucs2'), 100);
+    }
+  }
+}
@@ -0,0 +1,61 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+
+// Buffer.from(string) writes UTF-8 into room for the longest result and keeps
+// only what was written, both in the pool and for strings too long for it.
+// The lengths cover both sides of the pool limit and of the native side's
+// limit for over-allocating.
+const lengths = [1, 2, 100, 1000, Buffer.poolSize >>> 3, Buffer.poolSize >>> 1,
+                 Buffer.poolSize, 100000, 8 * 1024 * 1024 + 1];
+const pieces = [
+  'a',  // ASCII
+  'é',  // One byte, but two bytes of UTF-8
+  '€',  // Three bytes of UTF-8
+  '😀',  // A surrogate pair, four bytes of UTF-8
+  '\ud800'  // A lone surrogate, written as U+FFFD
+];
+
+function expectedBytes(piece) {
+  switch (piece) {
+    case 'a': return [0x61];
+    case 'é': return [0xc3, 0xa9];
+    case '€': return [0xe2, 0x82, 0xac];
+    case '😀': return [0xf0, 0x9f, 0x98, 0x80];
+    case '\ud800': return [0xef, 0xbf, 0xbd];
+  }
+}
+
+for (const piece of pieces) {
+  const bytes = expectedBytes(piece);
+  for (const length of lengths) {
+    const count = Math.max(1, Math.floor(length / piece.length));
+    const string = piece.repeat(count);
+    for (const encoding of [undefined, 'utf8']) {
+      const buf = Buffer.from(string, encoding);
+      assert.strictEqual(buf.length, count * bytes.length);
+      assert.strictEqual(buf.length, Buffer.byteLength(string));
+      assert.deepStrictEqual(Array.from(buf.slice(0, bytes.length)), bytes);
+      assert.deepStrictEqual(Array.from(buf.slice(-bytes.length)), bytes);
+      if (piece !== '\ud800')
+        assert.strictEqual(buf.toString(), string);
+    }
+  }
+}
+
+// Strings that are written into the pool one after another do not overlap.
+{
+  const strings = [];
+  for (let i = 0; i < 200; i++)
+    strings.push(`${i}é${'€'.repeat(i % 7)}`);
+  const bufs = strings.map((string) => Buffer.from(string));
+  bufs.forEach((buf, i) => assert.strictEqual(buf.toString(), strings[i]));
+}
+
+// A mix of one byte and two byte content in the same string.
+{
+  const string = 'x'.repeat(300) + 'ÿĀ' + 'y'.repeat(300);
+  assert.strictEqual(Buffer.from(string).toString(), string);
+  const long = string.repeat(100);
+  assert.strictEqual(Buffer.from(long).toString(), long);
+}
@@ -0,0 +1,58 @@
+'use strict';
+require('../common');
+
+// buffer.moveToString() hands large buffers over to the string without a
+// copy, and falls back to buf.toString() for everything else.
+
+const assert = require('assert');
+const buffer = require('buffer');
+
+const size = 2 * 1024 * 1024;
+
+{
+  const buf = Buffer.alloc(size, 'a');
+  buf[size - 1] = 0xe9;
+  const other = new Uint8Array(buf.buffer);
+  const str = buffer.moveToString(buf, 'latin1');
+  assert.strictEqual(str.length, size);
+  assert.strictEqual(str, 'a'.repeat(size - 1) + 'é');
+  // The memory now belongs to the string.
+  assert.strictEqual(buf.length, 0);
+  assert.strictEqual(other.length, 0);
+}
+
+{
+  const buf = Buffer.alloc(size, 'b');
+  buf[0] = 0xe2;
+  const str = buffer.moveToString(buf, 'ascii');
+  assert.strictEqual(str, 'b'.repeat(size));
+  assert.strictEqual(buf.length, 0);
+}
+
+{
+  const text = 'x€'.repeat(size / 2);
+  const buf = Buffer.from(text, 'utf16le');
+  assert.strictEqual(buffer.moveToString(buf, 'ucs2'), text);
+  assert.strictEqual(buf.length, 0);
+}
+
+// Copies, which leave the buffer alone.
+function copies(buf, encoding) {
+  const expected = Buffer.from(buf).toString(encoding);
+  assert.strictEqual(buffer.moveToString(buf, encoding), expected);
+  assert.notStrictEqual(buf.length, 0);
+}
+
+copies(Buffer.from('short'), 'latin1');
+copies(Buffer.alloc(size, 'a'), 'utf8');
+copies(Buffer.alloc(size, 'a'), 'hex');
+copies(Buffer.alloc(size, 'a'));
+copies(Buffer.alloc(size + 1, 'a'), 'ucs2');
+// A slice of a larger ArrayBuffer.
+copies(Buffer.alloc(size + 1, 'a').slice(1), 'latin1');
+copies(new Uint8Array(Buffer.from('plain Uint8Array')), 'latin1');
+
+assert.throws(() => buffer.moveToString('str', 'latin1'),
+              /^TypeError: "buf" argument must be a Buffer or Uint8Array$/);
+assert.throws(() => buffer.moveToString(Buffer.alloc(1), 'nope'),
+              /^TypeError: Unknown encoding: nope$/);
@@ -0,0 +1,95 @@
+'use strict';
+require('../common');
+
+// A Rope reads like the concatenation of the chunks appended to it.
+
+const assert = require('assert');
+const { Rope } = require('buffer');
+
+const parts = ['ab', 'c', 'defg', 'hi'].map((s) => Buffer.from(s));
+const whole = Buffer.concat(parts);
+
+function make() {
+  const rope = new Rope();
+  for (const part of parts)
+    assert.strictEqual(rope.append(part), rope);
+  return rope;
+}
+
+{
+  const rope = make();
+  assert.strictEqual(rope.length, whole.length);
+  assert.strictEqual(rope.toString(), 'abcdefghi');
+  assert.strictEqual(rope.toString('hex', 1, 3), '6263');
+
+  for (let start = -11; start <= 11; start++) {
+    for (let end = -11; end <= 11; end++)
+      assert.deepStrictEqual(rope.slice(start, end), whole.slice(start, end));
+  }
+
+  // Within one chunk, slices share its memory.
+  const slice = rope.slice(3, 6);
+  slice[0] = 0x44;
+  assert.strictEqual(parts[2][0], 0x44);
+  parts[2][0] = 0x64;
+
+  // Across chunks, they are copies.
+  const copy = rope.slice(1, 4);
+  copy[0] = 0x42;
+  assert.strictEqual(parts[0][1], 0x62);
+}
+
+{
+  const rope = make();
+  for (const value of ['a', 'bc', 'cdefgh', 'ghi', 'fgx', 'i', '', 0x63,
+                       Buffer.from('efgh'), new Uint8Array([0x64])]) {
+    for (let offset = -11; offset <= 11; offset++) {
+      assert.strictEqual(rope.indexOf(value, offset),
+                         whole.indexOf(value, offset));
+    }
+  }
+  assert.strictEqual(rope.indexOf('6465', 'hex'), 3);
+  assert.strictEqual(rope.indexOf('ZGVm', 0, 'base64'), 3);
+  assert.strictEqual(rope.includes('hi'), true);
+  assert.strictEqual(rope.includes('ab', 1), false);
+  assert.throws(() => rope.indexOf({}), TypeError);
+  assert.throws(() => rope.indexOf('a', 0, 'nope'), TypeError);
+}
+
+{
+  const rope = make();
+  for (const method of ['readUInt8', 'readInt8',
+                        'readUInt16LE', 'readUInt16BE',
+                        'readInt16LE', 'readInt16BE',
+                        'readUInt32LE', 'readUInt32BE',
+                        'readInt32LE', 'readInt32BE']) {
+    const size = +method.match(/\d+/)[0] / 8;
+    for (let offset = 0; offset + size <= whole.length; offset++)
+      assert.strictEqual(rope[method](offset), whole[method](offset));
+    assert.throws(() => rope[method](whole.length - size + 1),
+                  /^RangeError: Index out of range$/);
+  }
+}
+
+{
+  const rope = make();
+  assert.strictEqual(rope.consume(0), rope);
+  assert.strictEqual(rope.length, 9);
+  rope.consume(1);
+  assert.strictEqual(rope.toString(), 'bcdefghi');
+  // The first two chunks are done with now.
+  rope.consume(3);
+  assert.strictEqual(rope._chunks.length, 2);
+  assert.strictEqual(rope.toString(), 'efghi');
+  assert.strictEqual(rope.readUInt16BE(3), 0x6869);
+  rope.consume(100);
+  assert.strictEqual(rope.length, 0);
+  assert.strictEqual(rope.indexOf('a'), -1);
+  assert.strictEqual(rope.slice().length, 0);
+
+  rope.append(Buffer.alloc(0));
+  rope.append(new Uint8Array([1, 2]));
+  assert(rope.slice(0, 1) instanceof Buffer);
+  assert.strictEqual(rope.readUInt16LE(0), 0x0201);
+  assert.throws(() => rope.append('x'), TypeError);
+}
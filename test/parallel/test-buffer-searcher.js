@@ -0,0 +1,120 @@
+'use strict';
+require('../common');
+
+// buffer.Searcher, and forward searches long enough to go through the
+// vectorized first and last byte filter.
+
+const assert = require('assert');
+const Searcher = require('buffer').Searcher;
+
+const body = Buffer.from('a'.repeat(100) + '--boundary--' + 'b'.repeat(50) +
+                         '--boundary--' + '--bound');
+
+const searcher = new Searcher('--boundary--');
+assert.strictEqual(searcher.length, 12);
+assert.strictEqual(searcher.indexOf(body), 100);
+assert.strictEqual(searcher.indexOf(body, 101), 162);
+assert.strictEqual(searcher.indexOf(body, 163), -1);
+assert.strictEqual(searcher.indexOf(body, -19), 162);
+assert.strictEqual(searcher.indexOf(body, -18), -1);
+assert.strictEqual(searcher.lastIndexOf(body), 162);
+assert.strictEqual(searcher.lastIndexOf(body, 161), 100);
+assert.strictEqual(searcher.includes(body), true);
+assert.strictEqual(searcher.includes(Buffer.from('--boundary-')), false);
+assert.strictEqual(searcher.indexOf(new Uint8Array(body)), 100);
+
+// Every search gives the same result as Buffer#indexOf().
+for (let i = 0; i < body.length; i++) {
+  assert.strictEqual(searcher.indexOf(body, i),
+                     body.indexOf('--boundary--', i));
+}
+
+// The value is copied.
+{
+  const value = Buffer.from('ab');
+  const copied = new Searcher(value);
+  value[0] = 0x7a;
+  assert.strictEqual(copied.indexOf(Buffer.from('zab')), 1);
+}
+
+// Other encodings.
+assert.strictEqual(new Searcher('2d2d', 'hex').indexOf(body), 100);
+{
+  // 00 01 01 01 00 01, 01 01 is found at an odd offset only as bytes.
+  const utf16 = Buffer.from('ĀāĀ', 'utf16le');
+  const bytes = Buffer.from([0x01, 0x01]);
+  assert.strictEqual(new Searcher('āĀ', 'utf16le').indexOf(utf16), 2);
+  assert.strictEqual(new Searcher(bytes, 'utf16le').indexOf(utf16), 2);
+  assert.strictEqual(new Searcher(bytes).indexOf(utf16), 1);
+}
+
+assert.throws(() => new Searcher(''),
+              /^RangeError: "value" argument must not be empty$/);
+assert.throws(() => new Searcher(1),
+              /^TypeError: "value" argument must be string, Buffer or/);
+assert.throws(() => new Searcher('a', 'nope'),
+              /^TypeError: "encoding" must be a valid string encoding$/);
+assert.throws(() => searcher.indexOf('string'),
+              /^TypeError: argument should be a Buffer$/);
+
+// Patterns whose first and last bytes show up often, so that the search
+// falls back to Boyer-Moore-Horspool part way through.
+{
+  const haystack = Buffer.from('ab'.repeat(1000) + 'abcxab' + 'ab'.repeat(10));
+  assert.strictEqual(haystack.indexOf('abcxab'), 2000);
+  assert.strictEqual(haystack.indexOf('abababab', 1999), 2004);
+  for (let len = 2; len < 40; len++) {
+    const needle = 'x'.repeat(len - 1) + 'y';
+    const h = Buffer.from('x'.repeat(200) + needle + 'x'.repeat(len));
+    assert.strictEqual(h.indexOf(needle), 200);
+    assert.strictEqual(h.indexOf(needle, 201), -1);
+  }
+}
+
+// A long value searched for in many buffers reuses the Boyer-Moore tables
+// built for the first search, in both directions.
+{
+  const needle = 'abcdefghij'.repeat(3) + 'x';
+  const long = new Searcher(needle);
+  for (let i = 0; i < 50; i++) {
+    const h = Buffer.from('abcdefghij'.repeat(i) + needle + 'abcdefghij');
+    assert.strictEqual(long.indexOf(h), i * 10);
+    assert.strictEqual(long.lastIndexOf(h), i * 10);
+    assert.strictEqual(long.indexOf(h, i * 10 + 1), -1);
+    assert.strictEqual(h.indexOf(needle), i * 10);
+  }
+}
+
+// Backward searches give the same results as Buffer#lastIndexOf().
+for (let i = -body.length; i < body.length; i++) {
+  assert.strictEqual(searcher.lastIndexOf(body, i),
+                     body.lastIndexOf('--boundary--', i));
+}
+
+// split()
+{
+  const crlf = new Searcher('\r\n');
+  const split = (buf, limit) => crlf.split(buf, limit).map(String);
+  assert.deepStrictEqual(split(Buffer.from('a\r\nbc\r\n\r\nd')),
+                         ['a', 'bc', '', 'd']);
+  assert.deepStrictEqual(split(Buffer.from('\r\na\r\n')), ['', 'a', '']);
+  assert.deepStrictEqual(split(Buffer.from('abc')), ['abc']);
+  assert.deepStrictEqual(split(Buffer.alloc(0)), ['']);
+  assert.deepStrictEqual(split(Buffer.from('a\r\nb\r\nc'), 2), ['a', 'b']);
+  assert.deepStrictEqual(split(Buffer.from('a\r\nb'), 2), ['a', 'b']);
+  assert.deepStrictEqual(split(Buffer.from('a\r\nb'), 0), []);
+  const aa = new Searcher('aa').split(Buffer.from('aaaaa'));
+  assert.deepStrictEqual(aa.map(String), ['', '', 'a']);
+
+  // The parts are Buffers sharing memory with what was split.
+  const buf = Buffer.from('xx\r\nyy');
+  const parts = crlf.split(new Uint8Array(buf.buffer, buf.byteOffset, 6));
+  assert(Buffer.isBuffer(parts[1]));
+  parts[1][0] = 0x7a;
+  assert.strictEqual(buf.toString(), 'xx\r\nzy');
+
+  const utf16 = new Searcher('\n', 'utf16le');
+  assert.deepStrictEqual(
+    utf16.split(Buffer.from('a\nb', 'utf16le')).map((b) => b.toString('ucs2')),
+    ['a', 'b']);
+}
@@ -136,3 +136,23 @@ assert.throws(() => buf3.slice(1, 3).swap32(), re32);
 assert.throws(() => Buffer.alloc(1025).swap32(), re32);
 assert.throws(() => buf3.slice(1, 3).swap64(), re64);
 assert.throws(() => Buffer.alloc(1025).swap64(), re64);
+
+// Long buffers are swapped a vector at a time, at any alignment, with the
+// elements that are left over swapped one at a time.
+for (const size of [2, 4, 8]) {
+  const method = `swap${size * 8}`;
+  for (const offset of [0, 1, 3, 7]) {
+    for (const length of [192, 200, 256, 1000, 1024 + size]) {
+      const buf = Buffer.alloc(offset + length);
+      for (let i = 0; i < buf.length; i++)
+        buf[i] = i * 31;
+      const expected = Buffer.from(buf);
+      for (let i = offset; i < buf.length; i += size) {
+        for (let k = 0; k < size; k++)
+          expected[i + k] = buf[i + size - 1 - k];
+      }
+      buf.slice(offset)[method]();
+      assert.deepStrictEqual(buf, expected);
+    }
+  }
+}
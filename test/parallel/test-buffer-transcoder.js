@@ -0,0 +1,83 @@
+'use strict';
+
+const common = require('../common');
+
+if (!common.hasIntl) {
+  common.skip('missing Intl');
+  return;
+}
+
+// A Transcoder converts input chunk by chunk, also when characters are split
+// between chunks.
+
+const assert = require('assert');
+const { Transcoder, transcode } = require('buffer');
+
+const text = 'tést €, 日本語 and 😀 '.repeat(500);
+
+function transcodeInChunks(input, from, to, size) {
+  const transcoder = new Transcoder(from, to);
+  const output = [];
+  for (let i = 0; i < input.length; i += size)
+    output.push(transcoder.write(input.slice(i, i + size)));
+  output.push(transcoder.end());
+  return Buffer.concat(output);
+}
+
+[
+  ['utf8', 'ucs2'],
+  ['utf16le', 'utf-8'],
+  ['UTF-8', 'latin1'],
+  ['latin1', 'utf8'],
+  ['utf8', 'ascii']
+].forEach(([from, to]) => {
+  const input = from === 'latin1' ?
+    Buffer.from(text, 'latin1') : transcode(Buffer.from(text), 'utf8', from);
+  const expected = transcode(input, from, to);
+  for (const size of [1, 2, 3, 7, 1000, input.length])
+    assert.deepStrictEqual(transcodeInChunks(input, from, to, size), expected);
+});
+
+{
+  const transcoder = new Transcoder('utf8', 'utf16le');
+
+  // The first byte of a character gives nothing yet.
+  assert.strictEqual(transcoder.write(Buffer.from([0xe2])).length, 0);
+  assert.strictEqual(transcoder.write(Buffer.from([0x82, 0xac])).toString(
+    'utf16le'), '€');
+
+  // end() converts what is left over, then the transcoder starts over.
+  transcoder.write(Buffer.from([0xe2, 0x82]));
+  assert.strictEqual(transcoder.end().toString('utf16le'), '�');
+  assert.strictEqual(transcoder.end(Buffer.from('abc')).toString('utf16le'),
+                     'abc');
+  assert.strictEqual(
+    transcoder.write(new Uint8Array([0xc3, 0xa9])).toString('utf16le'), 'é');
+
+  assert.throws(() => transcoder.write('abc'),
+                /^TypeError: "chunk" argument must be a Buffer or Uint8Array$/);
+}
+
+assert.throws(() => new Transcoder('utf8', 'hex'),
+              /^TypeError: Unknown encoding: hex$/);
+assert.throws(() => new Transcoder(null, 'utf8'),
+              /^TypeError: "encoding" argument must be a string$/);
+assert.throws(() => new Transcoder('utf8', 'no such encoding'),
+              (err) => err.code === 'U_FILE_ACCESS_ERROR');
+
+// Legacy encodings need the full ICU data.
+let shiftJIS;
+try {
+  shiftJIS = new Transcoder('Shift_JIS', 'utf8');
+} catch (err) {
+  assert.strictEqual(err.code, 'U_FILE_ACCESS_ERROR');
+}
+if (shiftJIS) {
+  assert.strictEqual(shiftJIS.write(Buffer.from([0x93, 0xfa, 0x96])).toString(),
+                     '日');
+  assert.strictEqual(shiftJIS.end(Buffer.from([0x7b])).toString(), '本');
+
+  const windows1252 = new Transcoder('windows-1252', 'utf8');
+  assert.strictEqual(windows1252.end(Buffer.from([0x80, 0xe9])).toString(),
+                     '€é');
+}
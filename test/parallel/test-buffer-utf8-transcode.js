@@ -0,0 +1,47 @@
+'use strict';
+require('../common');
+
+// UTF-8 decoding and encoding that bypasses V8 for well-formed input and
+// one byte strings.
+
+const assert = require('assert');
+
+// Decoding, at lengths around the vector width and past the size where
+// strings become external.
+const samples = ['a', 'é', 'ÿ', '€', '\u{1f600}', '￿', '\u{10ffff}'];
+for (const sample of samples) {
+  for (const len of [1, 15, 16, 17, 100, 600000]) {
+    const str = 'x'.repeat(len) + sample + 'y'.repeat(len % 7);
+    assert.strictEqual(Buffer.from(str).toString(), str);
+    const repeated = sample.repeat(len);
+    assert.strictEqual(Buffer.from(repeated).toString(), repeated);
+  }
+}
+
+// Malformed input is still decoded with replacement characters.
+for (const bytes of [[0x80], [0xc0, 0x80], [0xed, 0xa0, 0x80],
+                     [0xf4, 0x90, 0x80, 0x80], [0xe2, 0x82]]) {
+  const buf = Buffer.concat([Buffer.alloc(20, 'a'), Buffer.from(bytes)]);
+  const str = buf.toString();
+  assert(str.startsWith('a'.repeat(20)));
+  assert(str.includes('�'));
+}
+
+// Encoding one byte strings only ever writes whole characters.
+{
+  const latin1 = 'abc'.repeat(10) + 'éèê' + 'xyz'.repeat(10);
+  const expected = Buffer.from(latin1);
+  for (let size = 0; size <= expected.length + 2; size++) {
+    const buf = Buffer.alloc(size, 0xff);
+    const written = buf.write(latin1);
+    assert(written <= size);
+    assert(expected.slice(0, written).equals(buf.slice(0, written)));
+    assert(buf.slice(written).equals(Buffer.alloc(size - written, 0xff)));
+    // The next character would not have fit.
+    const chars = buf.slice(0, written).toString().length;
+    if (written < expected.length)
+      assert(written + Buffer.byteLength(latin1[chars]) > size);
+  }
+  assert.strictEqual(Buffer.byteLength(latin1), expected.length);
+  assert(Buffer.from(latin1).equals(expected));
+}
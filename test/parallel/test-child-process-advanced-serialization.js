@@ -0,0 +1,76 @@
+'use strict';
+const common = require('../common');
+
+// With `serialization: 'advanced'`, messages are sent with the V8 serializer
+// and keep types that JSON would lose, in order and also when they are large.
+
+const assert = require('assert');
+const child_process = require('child_process');
+const net = require('net');
+
+if (process.argv[2] === 'child') {
+  process.on('message', (message, handle) => {
+    if (handle) {
+      handle.close();
+      process.send('got handle');
+      return;
+    }
+    process.send(message);
+  });
+  return;
+}
+
+assert.throws(() => child_process.fork(__filename, ['child'], {
+  serialization: 'xml'
+}), /^TypeError: "serialization" must be "json" or "advanced"$/);
+
+const messages = [
+  { map: new Map([[1, 'one'], ['two', { 2: 2 }]]), set: new Set([1, 2, 3]) },
+  Buffer.from('A buffer'),
+  new Uint16Array([1, 2, 3, 4]),
+  new Date(1500000000000),
+  /^a regexp$/gi,
+  { undefined: undefined, nested: [null, -0, Infinity] },
+  Buffer.alloc(4 * 1024 * 1024, 'x'),
+  'a string\nwith a line break',
+  { cmd: 'not internal' }
+];
+
+const child = child_process.fork(__filename, ['child'], {
+  serialization: 'advanced'
+});
+
+const received = [];
+child.on('message', common.mustCall((message) => {
+  if (message === 'got handle') {
+    child.disconnect();
+    return;
+  }
+
+  received.push(message);
+  if (received.length < messages.length)
+    return;
+
+  assert.deepStrictEqual(received, messages);
+  assert(received[0].map instanceof Map);
+  assert(received[0].set instanceof Set);
+  assert(received[1] instanceof Buffer);
+  assert(received[2] instanceof Uint16Array);
+  assert(received[3] instanceof Date);
+  assert.strictEqual(received[4].flags, 'gi');
+  assert(Object.keys(received[5]).includes('undefined'));
+  assert(Object.is(received[5].nested[1], -0));
+
+  // Handles are passed along with their messages as well.
+  const server = net.createServer();
+  server.listen(0, common.mustCall(() => {
+    child.send('server', server, common.mustCall(() => server.close()));
+  }));
+}, messages.length + 1));
+
+for (const message of messages)
+  child.send(message);
+
+assert.throws(() => child.send({ fn() {} }), /could not be cloned/);
+
+child.on('exit', common.mustCall((code) => assert.strictEqual(code, 0)));
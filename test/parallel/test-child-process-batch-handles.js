@@ -0,0 +1,58 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fork = require('child_process').fork;
+const net = require('net');
+
+// More handles than fit in one NODE_HANDLES message, with a message without
+// a handle among them.
+const N = 150;
+const kPlain = 80;
+
+if (process.argv[2] === 'child') {
+  let expected = 0;
+  process.on('message', (message, socket) => {
+    assert.strictEqual(message.index, expected++);
+    if (message.index === kPlain) {
+      assert.strictEqual(socket, undefined);
+    } else {
+      assert(socket instanceof net.Socket);
+      socket.end('ok');
+    }
+  });
+  return;
+}
+
+const child = fork(__filename, ['child'], { batchHandles: true });
+const sockets = [];
+let ended = 0;
+
+const server = net.createServer(common.mustCall((socket) => {
+  sockets.push(socket);
+  if (sockets.length < N)
+    return;
+
+  // Send them all in the same tick.
+  for (let i = 0; i <= N; i++) {
+    if (i === kPlain)
+      child.send({ index: i }, common.mustCall());
+    else
+      child.send({ index: i }, sockets.shift(), common.mustCall());
+  }
+}, N));
+
+server.listen(0, common.mustCall(() => {
+  for (let i = 0; i < N; i++) {
+    const client = net.connect(server.address().port);
+    let data = '';
+    client.setEncoding('utf8');
+    client.on('data', (chunk) => data += chunk);
+    client.on('end', common.mustCall(() => {
+      assert.strictEqual(data, 'ok');
+      if (++ended === N) {
+        server.close();
+        child.disconnect();
+      }
+    }));
+  }
+}));
@@ -0,0 +1,49 @@
+'use strict';
+const common = require('../common');
+
+// With the vfork option, children get their environment, working directory
+// and stdio as usual, and failures to start them are reported the same way.
+
+const assert = require('assert');
+const fs = require('fs');
+const { spawn, spawnSync } = require('child_process');
+
+assert.throws(() => spawn(process.execPath, [], { vfork: 1 }),
+              /^TypeError: "vfork" must be a boolean$/);
+
+const script = 'console.log(process.env.FOO, process.cwd())';
+const options = {
+  vfork: true,
+  cwd: common.fixturesDir,
+  env: { FOO: 'bar', PATH: process.env.PATH }
+};
+const expected = `bar ${fs.realpathSync(common.fixturesDir)}\n`;
+
+const child = spawn(process.execPath, ['-e', script], options);
+let output = '';
+child.stdout.setEncoding('utf8');
+child.stdout.on('data', (data) => output += data);
+child.on('close', common.mustCall((code) => {
+  assert.strictEqual(code, 0);
+  assert.strictEqual(output, expected);
+}));
+
+const result = spawnSync(process.execPath, ['-e', script], options);
+assert.strictEqual(result.status, 0);
+assert.strictEqual(result.stdout.toString(), expected);
+
+spawn('no-such-command', { vfork: true })
+  .on('error', common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ENOENT');
+  }));
+assert.strictEqual(spawnSync('no-such-command', { vfork: true }).error.code,
+                   'ENOENT');
+
+// The command is looked for in the PATH of the child.
+if (!common.isWindows) {
+  const shell = spawnSync('sh', ['-c', 'exit 7'], {
+    vfork: true,
+    env: { PATH: '/no/such/dir::/usr/bin:/bin' }
+  });
+  assert.strictEqual(shell.status, 7);
+}
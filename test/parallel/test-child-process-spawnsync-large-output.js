@@ -0,0 +1,22 @@
+'use strict';
+require('../common');
+
+// Output of any size comes back in one piece, also when it does not fit
+// the first block that spawnSync() collects it in.
+
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+
+const size = 3 * 1024 * 1024 + 17;
+const script = `process.stdout.write(Buffer.alloc(${size}, 'abc'));
+                process.stderr.write('done');`;
+const child = spawnSync(process.execPath, ['-e', script]);
+
+assert.strictEqual(child.status, 0);
+assert.strictEqual(child.stdout.length, size);
+assert(child.stdout.equals(Buffer.alloc(size, 'abc')));
+assert.strictEqual(child.stderr.toString(), 'done');
+
+const empty = spawnSync(process.execPath, ['-e', '']);
+assert.strictEqual(empty.stdout.length, 0);
+assert.strictEqual(empty.stderr.length, 0);
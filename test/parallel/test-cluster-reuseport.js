@@ -0,0 +1,36 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cluster = require('cluster');
+const net = require('net');
+
+if (common.isWindows) {
+  common.skip('SO_REUSEPORT is not supported on Windows');
+  return;
+}
+
+if (cluster.isMaster) {
+  // Each worker binds its own socket to the same port, nothing is shared
+  // through the master.
+  cluster.schedulingPolicy = cluster.SCHED_REUSEPORT;
+  let listening = 0;
+
+  for (let i = 0; i < 2; i++) {
+    const worker = cluster.fork();
+    worker.on('listening', common.mustCall((address) => {
+      assert.strictEqual(address.port, common.PORT);
+      if (++listening === 2) {
+        for (const id in cluster.workers)
+          cluster.workers[id].disconnect();
+      }
+    }));
+    worker.on('exit', common.mustCall((exitCode) => {
+      assert.strictEqual(exitCode, 0);
+    }));
+  }
+} else {
+  const server = net.createServer(common.mustNotCall());
+  server.listen(common.PORT, common.mustCall(() => {
+    assert.strictEqual(server.address().port, common.PORT);
+  }));
+}
@@ -0,0 +1,66 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cluster = require('cluster');
+const net = require('net');
+
+// With SCHED_RR, a connection goes to the worker with the fewest open
+// connections, going by what the workers report.
+
+cluster.schedulingPolicy = cluster.SCHED_RR;
+
+if (cluster.isWorker) {
+  const hold = process.env.TEST_MODE === 'hold';
+  net.createServer((socket) => {
+    if (hold) {
+      process.send('hold');
+      return;
+    }
+    socket.end();
+    socket.on('close', () => {
+      // After the worker has reported the closed connection.
+      setImmediate(() => setImmediate(() => process.send('close')));
+    });
+  }).listen(0);
+  return;
+}
+
+const kConnections = 6;
+const sockets = [];
+const tags = [];
+let port;
+
+// The first worker gets the first connection, and keeps it open.
+cluster.fork({ TEST_MODE: 'hold' });
+cluster.fork({ TEST_MODE: 'close' });
+
+cluster.on('listening', common.mustCall((worker, address) => {
+  port = address.port;
+  if (Object.keys(cluster.workers).every((id) => {
+    return cluster.workers[id].state === 'listening';
+  })) {
+    connect();
+  }
+}, 2));
+
+cluster.on('message', common.mustCall((worker, tag) => {
+  tags.push(tag);
+  if (tags.length < kConnections) {
+    connect();
+    return;
+  }
+
+  // Plain round-robin would alternate between the workers.
+  assert.deepStrictEqual(tags,
+                         ['hold', 'close', 'close', 'close', 'close', 'close']);
+  for (const socket of sockets)
+    socket.destroy();
+  cluster.disconnect();
+}, kConnections));
+
+function connect() {
+  const socket = net.connect(port);
+  socket.on('error', common.noop);
+  socket.resume();
+  sockets.push(socket);
+}
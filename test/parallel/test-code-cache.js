@@ -0,0 +1,29 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const vm = require('vm');
+const wrap = require('module').wrap;
+
+// Builds have a code cache for the core modules unless they are configured
+// without one, and V8 accepts it when node runs with its default flags.
+
+const codeCache = process.binding('code_cache');
+const natives = process.binding('natives');
+
+assert.strictEqual(codeCache.get('not/a/core/module'), undefined);
+
+for (const id of Object.keys(natives)) {
+  const cache = codeCache.get(id);
+  if (cache !== undefined) {
+    assert(cache instanceof Uint8Array);
+    assert(cache.length > 0);
+  }
+}
+
+const variables = process.config.variables;
+if (variables.node_use_code_cache || variables.node_code_cache_path) {
+  const cachedData = codeCache.get('fs');
+  assert(cachedData instanceof Uint8Array);
+  const script = new vm.Script(wrap(natives.fs), { cachedData });
+  assert.strictEqual(script.cachedDataRejected, false);
+}
@@ -0,0 +1,101 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+const crypto = require('crypto');
+
+const kAuthError = /^Error: Unsupported state or unable to authenticate data$/;
+
+// Test cases 1 and 2 of the GCM specification.
+{
+  const aead = crypto.createAEAD('aes-128-gcm', Buffer.alloc(16));
+  const iv = Buffer.alloc(12);
+  assert.strictEqual(aead.authTagLength, 16);
+  assert.strictEqual(aead.seal(iv, Buffer.alloc(0)).toString('hex'),
+                     '58e2fccefa7e3061367f1d57a4e7455a');
+  const sealed = aead.seal(iv, Buffer.alloc(16));
+  assert.strictEqual(sealed.toString('hex'),
+                     '0388dace60b6a392f328c2b971b2fe78' +
+                     'ab6e47d42cec13bdf53a67b21257bddf');
+  assert.deepStrictEqual(aead.open(iv, sealed), Buffer.alloc(16));
+  assert.deepStrictEqual(aead.open(iv, aead.seal(iv, '')), Buffer.alloc(0));
+}
+
+// Messages sealed one after another, in both directions and with IVs of
+// different lengths, match what Cipheriv and Decipheriv produce.
+{
+  const key = crypto.randomBytes(32);
+  const aead = crypto.createAEAD('aes-256-gcm', key);
+  for (let i = 0; i < 50; i++) {
+    const iv = crypto.randomBytes(i % 3 === 0 ? 16 : 12);
+    const data = crypto.randomBytes(i * 7);
+    const aad = i % 2 === 0 ? crypto.randomBytes(i) : undefined;
+
+    const cipher = crypto.createCipheriv('aes-256-gcm', key, iv);
+    if (aad !== undefined)
+      cipher.setAAD(aad);
+    const expected = Buffer.concat([cipher.update(data), cipher.final(),
+                                    cipher.getAuthTag()]);
+    const sealed = aead.seal(iv, data, aad);
+    assert.deepStrictEqual(sealed, expected);
+    assert.deepStrictEqual(aead.open(iv, sealed, aad), data);
+  }
+}
+
+// Anything that was not sealed with the same IV, AAD and tag fails to open,
+// and the object can be used afterwards.
+{
+  const aead = crypto.createAEAD('aes-192-gcm', crypto.randomBytes(24));
+  const iv = crypto.randomBytes(12);
+  const sealed = aead.seal(iv, 'secret', 'header');
+
+  const tampered = Buffer.from(sealed);
+  tampered[0] ^= 1;
+  assert.throws(() => aead.open(iv, tampered, 'header'), kAuthError);
+  const badTag = Buffer.from(sealed);
+  badTag[badTag.length - 1] ^= 1;
+  assert.throws(() => aead.open(iv, badTag, 'header'), kAuthError);
+  assert.throws(() => aead.open(iv, sealed, 'other'), kAuthError);
+  assert.throws(() => aead.open(iv, sealed), kAuthError);
+  assert.throws(() => aead.open(crypto.randomBytes(12), sealed, 'header'),
+                kAuthError);
+  assert.throws(() => aead.open(iv, sealed.slice(0, 15), 'header'),
+                kAuthError);
+
+  assert.strictEqual(aead.open(iv, sealed, 'header').toString(), 'secret');
+}
+
+// Shorter auth tags.
+{
+  const aead = crypto.createAEAD('aes-128-gcm', crypto.randomBytes(16),
+                                 { authTagLength: 8 });
+  assert.strictEqual(aead.authTagLength, 8);
+  const iv = crypto.randomBytes(12);
+  const sealed = aead.seal(iv, 'hello');
+  assert.strictEqual(sealed.length, 5 + 8);
+  assert.strictEqual(aead.open(iv, sealed).toString(), 'hello');
+}
+
+assert.throws(() => crypto.createAEAD('aes-128-cbc', Buffer.alloc(16)),
+              /^Error: Unsupported AEAD cipher$/);
+assert.throws(() => crypto.createAEAD('nope', Buffer.alloc(16)),
+              /^Error: Unknown cipher$/);
+assert.throws(() => crypto.createAEAD('aes-128-gcm', Buffer.alloc(15)),
+              /^Error: Invalid key length$/);
+assert.throws(() => crypto.createAEAD('aes-128-gcm', Buffer.alloc(16),
+                                      { authTagLength: 17 }),
+              /^Error: Invalid auth tag length$/);
+assert.throws(() => crypto.createAEAD('aes-128-gcm', Buffer.alloc(16),
+                                      { authTagLength: 'x' }),
+              /^TypeError: Auth tag length must be an integer$/);
+{
+  const aead = crypto.createAEAD('aes-128-gcm', Buffer.alloc(16));
+  assert.throws(() => aead.seal(Buffer.alloc(0), 'data'),
+                /^Error: Invalid IV length$/);
+  assert.throws(() => aead.seal(Buffer.alloc(12), 5),
+                /^TypeError: Data must be a buffer$/);
+}
@@ -0,0 +1,112 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+const assert = require('assert');
+const fs = require('fs');
+const crypto = require('crypto');
+
+const certPem = fs.readFileSync(`${common.fixturesDir}/test_cert.pem`, 'ascii');
+const keyPem = fs.readFileSync(`${common.fixturesDir}/test_key.pem`, 'ascii');
+
+// Signatures computed on the threadpool match synchronous ones, and verify
+// both ways.
+{
+  const expected = crypto.createSign('RSA-SHA256')
+                         .update('Test123')
+                         .sign(keyPem, 'base64');
+
+  const sign = crypto.createSign('RSA-SHA256').update('Test123');
+  sign.sign(keyPem, 'base64', common.mustCall((err, signature) => {
+    assert.ifError(err);
+    assert.strictEqual(signature, expected);
+
+    const verify = (data, expected) => {
+      crypto.createVerify('RSA-SHA256').update(data).verify(
+        certPem, signature, 'base64', common.mustCall((err, ok) => {
+          assert.ifError(err);
+          assert.strictEqual(ok, expected);
+        }));
+    };
+    verify('Test123', true);
+    verify('Test124', false);
+  }));
+
+  // The Sign object is finished as soon as the job is queued.
+  assert.throws(() => sign.sign(keyPem), /^Error: Not initialised$/);
+}
+
+// Many signatures run in parallel.
+{
+  const n = 8;
+  let pending = n;
+  for (let i = 0; i < n; i++) {
+    crypto.createSign('RSA-SHA1').update(`${i}`).sign(
+      { key: keyPem, padding: crypto.constants.RSA_PKCS1_PSS_PADDING },
+      common.mustCall((err, signature) => {
+        assert.ifError(err);
+        assert(Buffer.isBuffer(signature));
+        const ok = crypto.createVerify('RSA-SHA1').update(`${i}`).verify(
+          { key: certPem, padding: crypto.constants.RSA_PKCS1_PSS_PADDING },
+          signature);
+        assert.strictEqual(ok, true);
+        pending--;
+      }));
+  }
+  process.on('exit', () => assert.strictEqual(pending, 0));
+}
+
+// Key errors are passed to the callback.
+crypto.createSign('RSA-SHA1').update('x').sign('not a key', common.mustCall(
+  (err) => {
+    assert(err instanceof Error);
+  }));
+
+// Diffie-Hellman key generation and parameters.
+{
+  const dh1 = crypto.getDiffieHellman('modp5');
+  const dh2 = crypto.getDiffieHellman('modp5');
+  dh1.generateKeys('hex', common.mustCall((err, key1) => {
+    assert.ifError(err);
+    assert.strictEqual(key1, dh1.getPublicKey('hex'));
+    dh2.generateKeys(common.mustCall((err, key2) => {
+      assert.ifError(err);
+      assert.strictEqual(dh1.computeSecret(key2).toString('hex'),
+                         dh2.computeSecret(key1, 'hex', 'hex'));
+    }));
+  }));
+
+  crypto.generateDiffieHellman(256, common.mustCall((err, dh) => {
+    assert.ifError(err);
+    assert(dh instanceof crypto.DiffieHellman);
+    assert.strictEqual(dh.getPrime().length, 32);
+    assert.strictEqual(dh.verifyError, 0);
+    const other = crypto.createDiffieHellman(dh.getPrime(),
+                                             dh.getGenerator());
+    const key = other.generateKeys();
+    assert.deepStrictEqual(dh.computeSecret(key),
+                           other.computeSecret(dh.generateKeys()));
+  }));
+
+  assert.throws(() => crypto.generateDiffieHellman('256', common.mustNotCall()),
+                /^TypeError: "primeLength" argument must be an integer$/);
+  assert.throws(() => crypto.generateDiffieHellman(256),
+                /^TypeError: "callback" argument must be a function$/);
+}
+
+// ECDH key generation.
+{
+  const ecdh1 = crypto.createECDH('prime256v1');
+  const ecdh2 = crypto.createECDH('prime256v1');
+  ecdh1.generateKeys('hex', 'compressed', common.mustCall((err, key1) => {
+    assert.ifError(err);
+    assert.strictEqual(key1, ecdh1.getPublicKey('hex', 'compressed'));
+    ecdh2.generateKeys(common.mustCall((err, key2) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(ecdh1.computeSecret(key2),
+                             ecdh2.computeSecret(ecdh1.getPublicKey()));
+    }));
+  }));
+}
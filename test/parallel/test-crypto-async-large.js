@@ -0,0 +1,105 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+const assert = require('assert');
+const crypto = require('crypto');
+
+const key = Buffer.alloc(32, 'k');
+const iv = Buffer.alloc(16, 'i');
+const small = Buffer.from('small input');
+const large = Buffer.alloc(1024 * 1024);
+for (let i = 0; i < large.length; i++)
+  large[i] = i & 0xff;
+
+function encryptSync(data) {
+  const cipher = crypto.createCipheriv('aes-256-cbc', key, iv);
+  return Buffer.concat([cipher.update(data), cipher.final()]);
+}
+
+// Large and small inputs give the same result as the synchronous methods.
+[small, large].forEach((data) => {
+  const expected = encryptSync(data);
+  const cipher = crypto.createCipheriv('aes-256-cbc', key, iv);
+  let sync = true;
+  cipher.update(data, common.mustCall((err, head) => {
+    assert.ifError(err);
+    assert.strictEqual(sync, false);
+    cipher.final(common.mustCall((err, tail) => {
+      assert.ifError(err);
+      const encrypted = Buffer.concat([head, tail]);
+      assert.deepStrictEqual(encrypted, expected);
+
+      const decipher = crypto.createDecipheriv('aes-256-cbc', key, iv);
+      decipher.update(encrypted, common.mustCall((err, head) => {
+        assert.ifError(err);
+        decipher.final(common.mustCall((err, tail) => {
+          assert.ifError(err);
+          assert.deepStrictEqual(Buffer.concat([head, tail]), data);
+        }));
+      }));
+    }));
+  }));
+  sync = false;
+});
+
+// Output encodings are applied to asynchronous results.
+{
+  const expected = encryptSync(large).toString('hex');
+  const cipher = crypto.createCipheriv('aes-256-cbc', key, iv);
+  cipher.update(large, null, 'hex', common.mustCall((err, head) => {
+    assert.ifError(err);
+    cipher.final('hex', common.mustCall((err, tail) => {
+      assert.ifError(err);
+      assert.strictEqual(head + tail, expected);
+    }));
+  }));
+}
+
+// The cipher cannot be used while the threadpool is working on it.
+{
+  const cipher = crypto.createCipheriv('aes-256-cbc', key, iv);
+  cipher.update(large, common.mustCall((err) => {
+    assert.ifError(err);
+  }));
+  assert.throws(() => cipher.update(small), /^Error: Cipher is busy/);
+  assert.throws(() => cipher.final(), /^Error: Cipher is busy/);
+  cipher.update(small, common.mustCall((err) => {
+    assert(/^Error: Cipher is busy/.test(err));
+  }));
+}
+
+// Decryption errors are passed to the callback.
+{
+  const decipher = crypto.createDecipheriv('aes-256-cbc', key, iv);
+  decipher.update(large, common.mustCall((err) => {
+    assert.ifError(err);
+    decipher.final(common.mustCall((err) => {
+      assert(err instanceof Error);
+    }));
+  }));
+}
+
+// One-shot digests on the threadpool.
+{
+  const hash = crypto.createHash('sha256').update(large).digest('hex');
+  crypto.hash('sha256', large, 'hex', common.mustCall((err, digest) => {
+    assert.ifError(err);
+    assert.strictEqual(digest, hash);
+  }));
+  crypto.hash('sha256', 'abc', common.mustCall((err, digest) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(digest, crypto.hash('sha256', 'abc'));
+  }));
+
+  const hmac = crypto.createHmac('sha1', key).update(large).digest('base64');
+  crypto.hmac('sha1', key, large, 'base64', common.mustCall((err, digest) => {
+    assert.ifError(err);
+    assert.strictEqual(digest, hmac);
+  }));
+
+  assert.throws(() => crypto.hash('nope', large, common.mustNotCall()),
+                /^Error: Unknown message digest$/);
+}
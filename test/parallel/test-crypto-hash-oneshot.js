@@ -0,0 +1,57 @@
+'use strict';
+const common = require('../common');
+
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+
+const assert = require('assert');
+const crypto = require('crypto');
+
+const inputs = ['', 'abc', 'Ünïcödé', 'x'.repeat(1000)];
+
+for (const algorithm of ['md5', 'sha1', 'sha256', 'sha512']) {
+  for (const input of inputs) {
+    assert.deepStrictEqual(
+      crypto.hash(algorithm, input),
+      crypto.createHash(algorithm).update(input).digest());
+    assert.strictEqual(
+      crypto.hash(algorithm, Buffer.from(input), 'hex'),
+      crypto.createHash(algorithm).update(input).digest('hex'));
+
+    for (const key of ['', 'secret', Buffer.alloc(200, 'k')]) {
+      assert.strictEqual(
+        crypto.hmac(algorithm, key, input, 'base64'),
+        crypto.createHmac(algorithm, key).update(input).digest('base64'));
+    }
+  }
+
+  const buffers = inputs.map((input) => Buffer.from(input));
+  const size = crypto.hash(algorithm, '').length;
+
+  const digests = crypto.hashBatch(algorithm, buffers);
+  assert.strictEqual(digests.length, buffers.length * size);
+  buffers.forEach((buf, i) => {
+    assert.deepStrictEqual(digests.slice(i * size, (i + 1) * size),
+                           crypto.hash(algorithm, buf));
+  });
+
+  const hmacs = crypto.hmacBatch(algorithm, 'secret', buffers);
+  assert.strictEqual(hmacs.length, buffers.length * size);
+  buffers.forEach((buf, i) => {
+    assert.deepStrictEqual(hmacs.slice(i * size, (i + 1) * size),
+                           crypto.hmac(algorithm, 'secret', buf));
+  });
+
+  assert.strictEqual(crypto.hashBatch(algorithm, []).length, 0);
+}
+
+assert.throws(() => crypto.hash('nonexistent', 'abc'),
+              /^Error: Unknown message digest$/);
+assert.throws(() => crypto.hash('sha1', 42),
+              /^TypeError: Data must be a string or a buffer$/);
+assert.throws(() => crypto.hashBatch('sha1', ['abc']),
+              /^TypeError: Data must be an array of buffers$/);
+assert.throws(() => crypto.hmacBatch('sha1', 'key', 'abc'),
+              /^TypeError: Data must be an array of buffers$/);
@@ -0,0 +1,55 @@
+'use strict';
+const common = require('../common');
+
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+
+// Small synchronous requests are served from the random pool.
+
+const assert = require('assert');
+const crypto = require('crypto');
+
+const info = crypto.getRandomPoolInfo();
+assert.strictEqual(typeof info.blockSize, 'number');
+assert.strictEqual(typeof info.available, 'number');
+assert.strictEqual(typeof info.spareReady, 'boolean');
+assert.strictEqual(typeof info.refilling, 'boolean');
+assert.strictEqual(typeof info.refills, 'number');
+assert.strictEqual(typeof info.maxRequestSize, 'number');
+assert(info.maxRequestSize > 16);
+
+// Consecutive values are never the same bytes.
+const seen = new Set();
+for (let i = 0; i < 1000; i++) {
+  const hex = crypto.randomBytes(16).toString('hex');
+  assert(!seen.has(hex));
+  seen.add(hex);
+}
+
+const buf = Buffer.alloc(32);
+assert.strictEqual(crypto.randomFillSync(buf, 8, 16), buf);
+assert(buf.slice(0, 8).equals(Buffer.alloc(8)));
+assert(buf.slice(24).equals(Buffer.alloc(8)));
+assert(!buf.slice(8, 24).equals(Buffer.alloc(16)));
+
+const size = info.maxRequestSize;
+assert.strictEqual(crypto.randomBytes(size).length, size);
+assert.strictEqual(crypto.randomBytes(size + 1).length, size + 1);
+assert.strictEqual(crypto.randomBytes(0).length, 0);
+
+// Using up a whole block triggers a background refill.
+for (let i = 0; i < info.blockSize / size + 1; i++)
+  crypto.randomBytes(size);
+assert.strictEqual(crypto.getRandomPoolInfo().spareReady, false);
+
+setTimeout(common.mustCall(function check() {
+  const now = crypto.getRandomPoolInfo();
+  if (now.refilling) {
+    setTimeout(common.mustCall(check), 10);
+    return;
+  }
+  assert(now.refills > info.refills);
+  assert.strictEqual(now.spareReady, true);
+}), 10);
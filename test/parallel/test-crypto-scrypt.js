@@ -0,0 +1,102 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+const crypto = require('crypto');
+
+// The test vectors of RFC 7914, and a few with odd parameters.
+const vectors = [
+  {
+    password: '', salt: '', keylen: 64, options: { N: 16, r: 1, p: 1 },
+    expected: '77d6576238657b203b19ca42c18a0497f16b4844e3074ae8dfdffa3fede2' +
+              '1442fcd0069ded0948f8326a753a0fc81f17e8d3e0fb2e0d3628cf35e20c' +
+              '38d18906'
+  },
+  {
+    password: 'password', salt: 'NaCl', keylen: 64,
+    options: { N: 1024, r: 8, p: 16 },
+    expected: 'fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b37' +
+              '31622eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdf' +
+              'a2cc0640'
+  },
+  {
+    password: 'pleaseletmein', salt: 'SodiumChloride', keylen: 64,
+    options: { N: 16384, r: 8, p: 1 },
+    expected: '7023bdcb3afd7348461c06cd81fd38ebfda8fbba904f8e3ea9b543f6545d' +
+              'a1f2d5432955613f0fcf62d49705242a9af9e61e85dc0d651e40dfcf017b' +
+              '45575887'
+  },
+  {
+    password: Buffer.from('pass'), salt: Buffer.from('salt'), keylen: 17,
+    options: { N: 4, r: 3, p: 2 },
+    expected: '401359a0dfcd4e5f5b54fe9f2679779287'
+  }
+];
+
+for (const { password, salt, keylen, options, expected } of vectors) {
+  const key = crypto.scryptSync(password, salt, keylen, options);
+  assert.strictEqual(key.toString('hex'), expected);
+  crypto.scrypt(password, salt, keylen, options,
+                common.mustCall((err, key) => {
+                  assert.ifError(err);
+                  assert.strictEqual(key.toString('hex'), expected);
+                }));
+}
+
+// The defaults are N = 16384, r = 8 and p = 1.
+{
+  const expected = crypto.scryptSync('pleaseletmein', 'SodiumChloride', 64);
+  assert.strictEqual(expected.toString('hex'), vectors[2].expected);
+  crypto.scrypt('pleaseletmein', 'SodiumChloride', 64,
+                common.mustCall((err, key) => {
+                  assert.ifError(err);
+                  assert.deepStrictEqual(key, expected);
+                }));
+  assert.strictEqual(crypto.scryptSync('', '', 0).length, 0);
+}
+
+// Derivations run on the KDF pool, which keeps figures about its queue.
+{
+  const before = crypto.getKdfPoolInfo();
+  assert.ok(before.threads >= 1);
+  for (const name of ['pending', 'running', 'maxPending', 'completed',
+                      'waitTime']) {
+    assert.strictEqual(typeof before[name], 'number');
+  }
+  const count = 2 * before.threads + 1;
+  for (let i = 0; i < count; i++) {
+    crypto.pbkdf2('password', 'salt', 1, 20, 'sha1', common.mustCall());
+    crypto.scrypt('password', 'salt', 16, { N: 1024 }, common.mustCall());
+  }
+  assert.ok(crypto.getKdfPoolInfo().maxPending >= 1);
+  setImmediate(function check() {
+    const info = crypto.getKdfPoolInfo();
+    if (info.completed < before.completed + 2 * count)
+      return setImmediate(check);
+    assert.strictEqual(info.pending, 0);
+    assert.strictEqual(info.running, 0);
+  });
+}
+
+assert.throws(() => crypto.scrypt('', '', 16),
+              /^TypeError: "callback" argument must be a function$/);
+assert.throws(() => crypto.scryptSync(1, '', 16),
+              /^TypeError: "password" must be a string or a buffer$/);
+assert.throws(() => crypto.scryptSync('', '', -1),
+              /^TypeError: "keylen" must be a non-negative integer$/);
+assert.throws(() => crypto.scryptSync('', '', 16, { r: 0 }),
+              /^TypeError: "r" must be a positive integer$/);
+assert.throws(() => crypto.scryptSync('', '', 16, { N: 3 }),
+              /^RangeError: N must be a power of two larger than 1$/);
+assert.throws(() => crypto.scryptSync('', '', 16, { N: 65536, r: 1 }),
+              /^RangeError: N is too large for r$/);
+assert.throws(() => crypto.scryptSync('', '', 16, { N: 1 << 20, r: 8 }),
+              /^RangeError: Memory limit exceeded$/);
+assert.strictEqual(
+  crypto.scryptSync('', '', 16, { N: 1 << 16, r: 8, maxmem: 128 << 20 })
+    .length,
+  16);
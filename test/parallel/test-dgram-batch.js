@@ -0,0 +1,55 @@
+'use strict';
+const common = require('../common');
+
+// socket.sendBatch() sends each message as a datagram, and with
+// `recvBatchSize` they are read several at once and still emitted one by one.
+
+const assert = require('assert');
+const dgram = require('dgram');
+
+assert.throws(() => dgram.createSocket({ type: 'udp4', recvBatchSize: 0 }),
+              /^RangeError: "recvBatchSize" option must be an integer from 1/);
+assert.throws(() => dgram.createSocket({ type: 'udp4', recvBatchSize: 65 }),
+              /^RangeError: "recvBatchSize" option must be an integer from 1/);
+
+const messages = [];
+for (let i = 0; i < 40; i++)
+  messages.push(Buffer.alloc(i * 10, i));
+messages[1] = 'a string';
+
+const server = dgram.createSocket({ type: 'udp4', recvBatchSize: 8 });
+const received = [];
+server.on('message', common.mustCall((msg, rinfo) => {
+  assert.strictEqual(rinfo.size, msg.length);
+  assert.strictEqual(rinfo.address, common.localhostIPv4);
+  received.push(msg);
+  if (received.length < messages.length)
+    return;
+
+  assert.deepStrictEqual(received, messages.map((msg) => Buffer.from(msg)));
+  server.close();
+}, messages.length));
+
+server.bind(0, common.localhostIPv4, common.mustCall(() => {
+  const client = dgram.createSocket('udp4');
+  const port = server.address().port;
+
+  assert.throws(() => client.sendBatch('abc', port),
+                /^TypeError: "messages" argument must be an array$/);
+  assert.throws(() => client.sendBatch([{}], port),
+                /^TypeError: Messages must be buffers or strings$/);
+  assert.throws(() => client.sendBatch(['abc'], 0),
+                /^RangeError: Port should be > 0 and < 65536$/);
+
+  const bytes = messages.reduce((sum, msg) => sum + msg.length, 0);
+  client.sendBatch([], port, common.localhostIPv4, common.mustCall((err, n) => {
+    assert.ifError(err);
+    assert.strictEqual(n, 0);
+    client.sendBatch(messages, port, common.localhostIPv4,
+                     common.mustCall((err, n) => {
+                       assert.ifError(err);
+                       assert.strictEqual(n, bytes);
+                       client.close();
+                     }));
+  }));
+}));
@@ -0,0 +1,67 @@
+'use strict';
+const common = require('../common');
+
+// A connected socket sends to its peer without a port or address, and gets
+// the errors that the peer reports.
+
+const assert = require('assert');
+const dgram = require('dgram');
+
+const server = dgram.createSocket('udp4');
+const client = dgram.createSocket('udp4');
+
+assert.throws(() => client.connect(0),
+              /^RangeError: Port should be > 0 and < 65536$/);
+assert.throws(() => client.remoteAddress(),
+              /^Error: Socket is not connected$/);
+
+server.on('message', common.mustCall((msg, rinfo) => {
+  assert.strictEqual(rinfo.port, client.address().port);
+  if (msg.toString() === 'second')
+    return refused();
+  assert.strictEqual(msg.toString(), 'first');
+}, 2));
+
+server.bind(0, common.localhostIPv4, common.mustCall(() => {
+  const port = server.address().port;
+  client.connect(port, common.localhostIPv4, common.mustCall(() => {
+    assert.deepStrictEqual(client.remoteAddress(), {
+      address: common.localhostIPv4,
+      family: 'IPv4',
+      port
+    });
+    assert.throws(() => client.connect(port),
+                  /^Error: Socket is already connected$/);
+    assert.throws(() => client.send('x', port, common.localhostIPv4),
+                  /^Error: Socket is connected, send\(\) takes no port/);
+    client.send(Buffer.from('a second b'), 2, 6, common.mustCall((err, n) => {
+      assert.ifError(err);
+      assert.strictEqual(n, 6);
+    }));
+  }));
+
+  // Sent once the socket is connected.
+  client.send('first', common.mustCall((err, n) => {
+    assert.ifError(err);
+    assert.strictEqual(n, 5);
+  }));
+}));
+
+function refused() {
+  const port = server.address().port;
+  server.close();
+  client.close();
+
+  // Windows does not report ICMP errors for UDP sockets.
+  if (common.isWindows)
+    return;
+
+  const socket = dgram.createSocket('udp4');
+  socket.on('error', common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ECONNREFUSED');
+    socket.close();
+  }));
+  socket.connect(port, common.localhostIPv4, common.mustCall(() => {
+    socket.send('hello');
+  }));
+}
@@ -0,0 +1,54 @@
+'use strict';
+const common = require('../common');
+
+// With socket.setSegmentSize(), the kernel splits each datagram that is sent
+// into datagrams of that size.
+
+const assert = require('assert');
+const dgram = require('dgram');
+
+const client = dgram.createSocket('udp4');
+
+assert.throws(() => client.setSegmentSize(-1),
+              /^RangeError: Segment size must be an integer from 0 to 65535$/);
+assert.throws(() => client.setSegmentSize(1.5),
+              /^RangeError: Segment size must be an integer from 0 to 65535$/);
+
+if (!common.isLinux) {
+  client.bind(0, common.mustCall(() => {
+    assert.throws(() => client.setSegmentSize(100), /ENOTSUP/);
+    client.close();
+  }));
+  return;
+}
+
+const server = dgram.createSocket('udp4');
+const received = [];
+server.on('message', (msg, rinfo) => {
+  received.push(msg.length);
+  if (received.length < 4)
+    return;
+  assert.deepStrictEqual(received, [100, 100, 100, 50]);
+  server.close();
+  client.close();
+});
+
+server.bind(0, common.localhostIPv4, common.mustCall(() => {
+  client.bind(0, common.localhostIPv4, common.mustCall(() => {
+    try {
+      client.setSegmentSize(100);
+    } catch (err) {
+      // UDP_SEGMENT is new in Linux 4.18.
+      assert.strictEqual(err.code, 'ENOPROTOOPT');
+      server.close();
+      client.close();
+      common.skip('UDP_SEGMENT is not supported');
+      return;
+    }
+    client.send(Buffer.alloc(350), server.address().port,
+                common.localhostIPv4, common.mustCall((err, bytes) => {
+                  assert.ifError(err);
+                  assert.strictEqual(bytes, 350);
+                }));
+  }));
+}));
@@ -0,0 +1,114 @@
+'use strict';
+const common = require('../common');
+
+// With dns.setCache(), concurrent lookups of a host share a getaddrinfo(),
+// its result is used for `ttl` ms and then, for `staleTtl` ms more, while it
+// is looked up again.
+
+const assert = require('assert');
+const cares = process.binding('cares_wrap');
+const uv = process.binding('uv');
+const dns = require('dns');
+
+const queries = [];
+cares.getaddrinfo = (req, hostname, family, hints) => {
+  queries.push({ req, hostname, family, hints });
+  return 0;
+};
+
+function answer(err, addresses) {
+  const { req } = queries.shift();
+  req.oncomplete(err, addresses);
+}
+
+assert.throws(() => dns.setCache(null),
+              /^TypeError: "options" argument must be an object$/);
+assert.throws(() => dns.setCache({ ttl: -1 }),
+              /^TypeError: Invalid argument: ttl must be a non-negative/);
+assert.throws(() => dns.setCache({ staleTtl: 1.5 }),
+              /^TypeError: Invalid argument: staleTtl must be a non-negative/);
+assert.throws(() => dns.setCache({ maxEntries: 0 }),
+              /^TypeError: Invalid argument: maxEntries must be a positive/);
+
+dns.setCache({ ttl: 50, staleTtl: 10 * 60 * 1000 });
+
+dns.lookup('example.com', common.mustCall((err, address, family) => {
+  assert.ifError(err);
+  assert.strictEqual(address, '10.0.0.1');
+  assert.strictEqual(family, 4);
+}));
+dns.lookup('example.com', { all: true }, common.mustCall((err, addresses) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(addresses, [{ address: '10.0.0.1', family: 4 },
+                                     { address: '::1', family: 6 }]);
+  addresses.pop();
+}));
+dns.lookup('example.com', 6, common.mustCall((err) => {
+  assert.strictEqual(err.code, 'ENOTFOUND');
+  assert.strictEqual(err.hostname, 'example.com');
+}));
+
+assert.deepStrictEqual(queries.map((q) => [q.hostname, q.family]),
+                       [['example.com', 0], ['example.com', 6]]);
+answer(0, ['10.0.0.1', '::1']);
+answer(uv.UV_EAI_NONAME);
+
+setImmediate(common.mustCall(() => {
+  // Errors are not kept.
+  dns.lookup('example.com', 6, common.mustCall((err) => {
+    assert.strictEqual(err.code, 'EAI_AGAIN');
+  }));
+  answer(uv.UV_EAI_AGAIN);
+
+  dns.lookup('example.com', { all: true }, common.mustCall((err, addresses) => {
+    assert.ifError(err);
+    assert.strictEqual(addresses.length, 2);
+  }));
+  assert.strictEqual(queries.length, 0);
+
+  setTimeout(common.mustCall(revalidate), 100);
+}));
+
+function revalidate() {
+  dns.lookup('example.com', common.mustCall((err, address) => {
+    assert.ifError(err);
+    assert.strictEqual(address, '10.0.0.1');
+  }));
+  dns.lookup('example.com', common.mustCall((err, address) => {
+    assert.ifError(err);
+    assert.strictEqual(address, '10.0.0.1');
+  }));
+  assert.strictEqual(queries.length, 1);
+  answer(0, ['10.0.0.2']);
+  dns.lookup('example.com', common.mustCall((err, address) => {
+    assert.ifError(err);
+    assert.strictEqual(address, '10.0.0.2');
+    evict();
+  }));
+  assert.strictEqual(queries.length, 0);
+}
+
+function evict() {
+  dns.setCache({ ttl: 60 * 1000, maxEntries: 2 });
+  for (const hostname of ['a.example', 'b.example', 'a.example', 'c.example'])
+    dns.lookup(hostname, common.mustCall());
+  assert.deepStrictEqual(queries.map((q) => q.hostname),
+                         ['a.example', 'b.example', 'c.example']);
+  answer(0, ['10.0.0.1']);
+  answer(0, ['10.0.0.2']);
+  answer(0, ['10.0.0.3']);
+
+  // b.example was used the longest time ago.
+  dns.lookup('a.example', common.mustCall());
+  dns.lookup('b.example', common.mustCall());
+  assert.deepStrictEqual(queries.map((q) => q.hostname), ['b.example']);
+  answer(0, ['10.0.0.2']);
+
+  // Without a TTL nothing is kept.
+  dns.setCache({});
+  dns.lookup('a.example', common.mustCall());
+  dns.lookup('a.example', common.mustCall());
+  assert.strictEqual(queries.length, 2);
+  answer(0, ['10.0.0.1']);
+  answer(0, ['10.0.0.1']);
+}
@@ -0,0 +1,104 @@
+'use strict';
+const common = require('../common');
+
+// With `resolver: 'cares'`, dns.lookup() asks c-ares for each address family
+// instead of calling getaddrinfo() on the threadpool.
+
+const assert = require('assert');
+const cares = process.binding('cares_wrap');
+const dns = require('dns');
+const net = require('net');
+
+cares.getaddrinfo = common.mustNotCall();
+
+const queries = [];
+let answers = null;
+cares.getHostByName = (req, hostname, family) => {
+  if (answers !== null)
+    req.oncomplete(0, answers[family], family);
+  else
+    queries.push({ req, hostname, family });
+  return 0;
+};
+
+function answer(family, result) {
+  const i = queries.findIndex((query) => query.family === family);
+  const { req } = queries.splice(i, 1)[0];
+  if (typeof result === 'string')
+    req.oncomplete(result);
+  else
+    req.oncomplete(0, result, family === 4 ? cares.AF_INET : cares.AF_INET6);
+}
+
+assert.throws(() => dns.lookup('example.com', { resolver: 'x' }, () => {}),
+              /^TypeError: Invalid argument: resolver must be "getaddrinfo"/);
+
+const options = { resolver: 'cares', all: true };
+dns.lookup('example.com', options, common.mustCall((err, addresses) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(addresses, [{ address: '10.0.0.1', family: 4 },
+                                     { address: '::2', family: 6 },
+                                     { address: '::3', family: 6 }]);
+}));
+assert.deepStrictEqual(queries.map((query) => query.family), [4, 6]);
+answer(6, ['::2', '::3']);
+answer(4, ['10.0.0.1']);
+
+// One of the families is enough.
+dns.lookup('example.com', options, common.mustCall((err, addresses) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(addresses, [{ address: '::2', family: 6 }]);
+}));
+answer(4, 'ENODATA');
+answer(6, ['::2']);
+
+dns.lookup('example.com', options, common.mustCall((err) => {
+  assert.strictEqual(err.code, 'ENOTFOUND');
+  assert.strictEqual(err.syscall, 'getaddrinfo');
+  assert.strictEqual(err.hostname, 'example.com');
+}));
+answer(4, 'ENOTFOUND');
+answer(6, 'ENODATA');
+
+// AI_V4MAPPED maps IPv4 addresses when there are no IPv6 ones.
+dns.lookup('example.com', {
+  resolver: 'cares',
+  family: 6,
+  hints: dns.V4MAPPED
+}, common.mustCall((err, address, family) => {
+  assert.ifError(err);
+  assert.strictEqual(address, '::ffff:10.0.0.1');
+  assert.strictEqual(family, 6);
+}));
+answer(6, 'ENODATA');
+answer(4, ['10.0.0.1']);
+assert.strictEqual(queries.length, 0);
+
+// Answers from the hosts file come right away, callbacks still do not.
+answers = { 4: ['127.0.0.1'], 6: ['::1'] };
+let returned = false;
+dns.lookup('localhost', { resolver: 'cares', family: 4 },
+           common.mustCall((err, address, family) => {
+             assert.ifError(err);
+             assert.strictEqual(address, '127.0.0.1');
+             assert.strictEqual(family, 4);
+             assert(returned);
+           }));
+returned = true;
+
+// Connections can use it.
+const server = net.createServer(common.mustCall((socket) => socket.end()));
+server.listen(0, '127.0.0.1', common.mustCall(() => {
+  const socket = net.connect({
+    host: 'localhost',
+    port: server.address().port,
+    family: 4,
+    resolver: 'cares'
+  });
+  socket.on('lookup', common.mustCall((err, address) => {
+    assert.ifError(err);
+    assert.strictEqual(address, '127.0.0.1');
+  }));
+  socket.resume();
+  socket.on('end', common.mustCall(() => server.close()));
+}));
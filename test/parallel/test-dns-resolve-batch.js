@@ -0,0 +1,72 @@
+'use strict';
+const common = require('../common');
+
+// dns.resolveBatch() sends all of its queries at once and calls back once,
+// with a result for each of them in the same order.
+
+const assert = require('assert');
+const dns = require('dns');
+
+assert.throws(() => dns.resolveBatch('example.com', common.mustNotCall()),
+              /^Error: "queries" argument must be an array$/);
+assert.throws(() => dns.resolveBatch([['example.com']]),
+              /^Error: "callback" argument must be a function$/);
+assert.throws(() => dns.resolveBatch(['example.com'], common.mustNotCall()),
+              /^Error: Each query must be a \[name, rrtype\] array$/);
+assert.throws(() => dns.resolveBatch([['example.com', 'X']],
+                                     common.mustNotCall()),
+              /^Error: Unknown type "X"$/);
+
+dns.resolveBatch([], common.mustCall((err, results) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(results, []);
+}));
+
+// Nothing answers, the queries wait until they are cancelled.
+const resolver = new dns.Resolver();
+resolver.setServers(['127.0.0.1']);
+const queries = [
+  ['_http._tcp.example.com', 'SRV'],
+  ['a.example.com'],
+  ['a.example.com', 'AAAA'],
+  ['example.com', 'TXT']
+];
+resolver.resolveBatch(queries, common.mustCall((err, results) => {
+  assert.ifError(err);
+  assert.strictEqual(results.length, queries.length);
+  results.forEach((result, i) => {
+    assert.strictEqual(result.name, queries[i][0]);
+    assert.strictEqual(result.type, queries[i][1] || 'A');
+    assert.strictEqual(result.records, null);
+    assert.strictEqual(result.error.code, 'ECANCELLED');
+    assert.strictEqual(result.error.hostname, queries[i][0]);
+  });
+  assert.strictEqual(results[0].error.syscall, 'querySrv');
+  assert.strictEqual(results[2].error.syscall, 'queryAaaa');
+}));
+resolver.cancel();
+
+// With the ttl option, A and AAAA records come with their TTLs.
+const cares = process.binding('cares_wrap');
+cares.queryBatch = common.mustCall((req, names, types) => {
+  assert.deepStrictEqual(names, ['example.com', 'example.com', 'example.org']);
+  assert.deepStrictEqual(types, ['A', 'MX', 'AAAA']);
+  req.oncomplete(0, [
+    ['10.0.0.1', '10.0.0.2'],
+    [{ exchange: 'mx.example.com', priority: 10 }],
+    'ENODATA'
+  ], [[60, 300]]);
+});
+dns.resolveBatch([['example.com', 'A'], ['example.com', 'MX'],
+                  ['example.org', 'AAAA']], { ttl: true },
+                 common.mustCall((err, results) => {
+                   assert.ifError(err);
+                   assert.deepStrictEqual(results[0].records, [
+                     { address: '10.0.0.1', ttl: 60 },
+                     { address: '10.0.0.2', ttl: 300 }
+                   ]);
+                   assert.deepStrictEqual(results[1].records, [
+                     { exchange: 'mx.example.com', priority: 10 }
+                   ]);
+                   assert.strictEqual(results[2].error.code, 'ENODATA');
+                 }));
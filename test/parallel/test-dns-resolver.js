@@ -0,0 +1,51 @@
+'use strict';
+const common = require('../common');
+
+// A dns.Resolver has its own servers, and cancel() only cancels its own
+// queries.
+
+const assert = require('assert');
+const dns = require('dns');
+
+assert.throws(() => new dns.Resolver(null),
+              /^TypeError: "options" argument must be an object$/);
+assert.throws(() => new dns.Resolver({ timeout: 1.5 }),
+              /^TypeError: Invalid argument: timeout must be an integer$/);
+assert.throws(() => new dns.Resolver({ tries: 0 }),
+              /^TypeError: Invalid argument: tries must be a positive/);
+
+const servers = dns.getServers();
+const resolver = new dns.Resolver({ timeout: 5000, tries: 2 });
+assert.deepStrictEqual(resolver.getServers(), servers);
+
+resolver.setServers(['192.0.2.1', '[2001:db8::1]:53']);
+assert.deepStrictEqual(resolver.getServers(), ['192.0.2.1', '2001:db8::1']);
+assert.deepStrictEqual(dns.getServers(), servers);
+assert.deepStrictEqual(new dns.Resolver().getServers(), servers);
+
+assert.throws(() => resolver.setServers(['not an ip']),
+              /^Error: IP address is not properly formatted: not an ip$/);
+assert.deepStrictEqual(resolver.getServers(), ['192.0.2.1', '2001:db8::1']);
+
+function cancelled(err) {
+  assert.strictEqual(err.code, 'ECANCELLED');
+  assert.strictEqual(err.hostname, 'example.com');
+}
+
+// Nothing answers, the queries wait until they are cancelled.
+resolver.setServers(['127.0.0.1']);
+resolver.resolve4('example.com', common.mustCall(cancelled));
+resolver.resolve('example.com', 'MX', common.mustCall(cancelled));
+resolver.resolveTxt('example.com', common.mustCall(cancelled));
+
+let otherCancelled = false;
+const other = new dns.Resolver();
+other.setServers(['127.0.0.1']);
+other.resolve4('example.com', common.mustCall((err) => {
+  assert(otherCancelled);
+  cancelled(err);
+}));
+
+resolver.cancel();
+otherCancelled = true;
+other.cancel();
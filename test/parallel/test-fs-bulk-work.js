@@ -0,0 +1,52 @@
+'use strict';
+const common = require('../common');
+
+// Bulk file system work, like fs.readFile() and fs.copyFile(), runs on at
+// most half of the threads of libuv's pool, and the rest of it waits for one
+// of them. With a pool of two threads, all of it runs one at a time, next to
+// other calls that don't wait for it.
+
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+if (process.argv[2] === 'child') {
+  const file = process.argv[3];
+  const data = fs.readFileSync(file);
+  let pending = 0;
+  const check = common.mustCall(() => {
+    if (--pending === 0)
+      console.log('ok');
+  }, 41);
+  for (let i = 0; i < 20; i++) {
+    pending++;
+    fs.readFile(file, common.mustCall((err, buf) => {
+      assert.ifError(err);
+      assert(buf.equals(data));
+      check();
+    }));
+    pending++;
+    fs.copyFile(file, `${file}.${i}`, common.mustCall((err) => {
+      assert.ifError(err);
+      assert(fs.readFileSync(`${file}.${i}`).equals(data));
+      check();
+    }));
+  }
+  pending++;
+  fs.stat(file, common.mustCall((err, stats) => {
+    assert.ifError(err);
+    assert.strictEqual(stats.size, data.length);
+    check();
+  }));
+  return;
+}
+
+common.refreshTmpDir();
+const file = path.join(common.tmpDir, 'bulk.bin');
+fs.writeFileSync(file, Buffer.alloc(256 * 1024, 'x'));
+
+const env = Object.assign({}, process.env, { UV_THREADPOOL_SIZE: '2' });
+const child = spawnSync(process.execPath, [__filename, 'child', file], { env });
+assert.strictEqual(child.status, 0, child.stderr.toString());
+assert.strictEqual(child.stdout.toString(), 'ok\n');
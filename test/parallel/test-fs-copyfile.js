@@ -0,0 +1,67 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+common.refreshTmpDir();
+
+const src = path.join(common.tmpDir, 'copy-src.bin');
+const dest = path.join(common.tmpDir, 'copy-dest.bin');
+const data = Buffer.alloc(300 * 1024);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 253;
+fs.writeFileSync(src, data);
+fs.chmodSync(src, 0o640);
+
+const { COPYFILE_EXCL, COPYFILE_FICLONE, COPYFILE_FICLONE_FORCE } =
+  fs.constants;
+assert.strictEqual(typeof COPYFILE_EXCL, 'number');
+assert.strictEqual(typeof COPYFILE_FICLONE, 'number');
+assert.strictEqual(typeof COPYFILE_FICLONE_FORCE, 'number');
+
+function verify() {
+  assert(fs.readFileSync(dest).equals(data));
+  if (!common.isWindows)
+    assert.strictEqual(fs.statSync(dest).mode & 0o777, 0o640);
+}
+
+fs.copyFileSync(src, dest);
+verify();
+
+// An existing, longer destination is replaced.
+fs.writeFileSync(dest, Buffer.alloc(data.length * 2, 'x'));
+fs.copyFileSync(src, dest, COPYFILE_FICLONE);
+verify();
+
+assert.throws(() => fs.copyFileSync(src, dest, COPYFILE_EXCL), (err) => {
+  return err.code === 'EEXIST' && err.syscall === 'copyfile' &&
+         err.path === src && err.dest === dest;
+});
+
+// Copying a file onto itself leaves it alone.
+fs.copyFileSync(src, src);
+assert(fs.readFileSync(src).equals(data));
+
+assert.throws(() => {
+  fs.copyFileSync(path.join(common.tmpDir, 'missing'), dest);
+}, /^Error: ENOENT: no such file or directory, copyfile/);
+
+fs.unlinkSync(dest);
+fs.copyFile(src, dest, common.mustCall((err) => {
+  assert.ifError(err);
+  verify();
+
+  fs.copyFile(src, dest, COPYFILE_EXCL, common.mustCall((err) => {
+    assert.strictEqual(err.code, 'EEXIST');
+  }));
+}));
+
+// A forced reflink either works or fails, but never makes a plain copy.
+const reflink = path.join(common.tmpDir, 'copy-reflink.bin');
+fs.copyFile(src, reflink, COPYFILE_FICLONE_FORCE, common.mustCall((err) => {
+  if (err)
+    assert.strictEqual(fs.existsSync(reflink), false);
+  else
+    assert(fs.readFileSync(reflink).equals(data));
+}));
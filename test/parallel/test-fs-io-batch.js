@@ -0,0 +1,70 @@
+'use strict';
+const common = require('../common');
+
+// fs.ioBatch() runs many reads and writes as one request.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+common.refreshTmpDir();
+
+const file = path.join(common.tmpDir, 'io-batch.bin');
+const data = Buffer.alloc(8192);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+fs.writeFileSync(file, data);
+
+const fd = fs.openSync(file, 'r+');
+
+// Adjacent reads are coalesced but still land in their own buffers.
+{
+  const bufs = [Buffer.alloc(10), Buffer.alloc(20), Buffer.alloc(30)];
+  const { results, errors } = fs.ioBatchSync([
+    { type: 'read', fd, buffer: bufs[0], position: 100 },
+    { type: 'read', fd, buffer: bufs[1], position: 110 },
+    { type: 'read', fd, buffer: bufs[2], position: 5000 }
+  ]);
+  assert(results instanceof Int32Array);
+  assert.deepStrictEqual(Array.from(results), [10, 20, 30]);
+  assert.strictEqual(errors.length, 0);
+  assert(bufs[0].equals(data.slice(100, 110)));
+  assert(bufs[1].equals(data.slice(110, 130)));
+  assert(bufs[2].equals(data.slice(5000, 5030)));
+}
+
+// Short reads at the end of the file, and failures, are reported per
+// operation.
+{
+  const { results, errors } = fs.ioBatchSync([
+    { type: 'read', fd, buffer: Buffer.alloc(100), position: 8150 },
+    { type: 'read', fd, buffer: Buffer.alloc(100), position: 8250 },
+    { type: 'read', fd: 12345, buffer: Buffer.alloc(1), position: 0 }
+  ]);
+  assert.strictEqual(results[0], 42);
+  assert.strictEqual(results[1], 0);
+  assert(results[2] < 0);
+  assert.strictEqual(errors[0], undefined);
+  assert.strictEqual(errors[2].code, 'EBADF');
+  assert.strictEqual(errors[2].syscall, 'read');
+}
+
+fs.ioBatch([
+  { type: 'write', fd, buffer: Buffer.from('hello'), position: 0 },
+  { type: 'write', fd, buffer: Buffer.from('world'), offset: 1, length: 3,
+    position: 5 },
+  { type: 'read', fd, buffer: Buffer.alloc(8), position: 0 }
+], common.mustCall((err, batch) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(Array.from(batch.results), [5, 3, 8]);
+  assert.strictEqual(fs.readFileSync(file, 'latin1').slice(0, 8), 'helloorl');
+  fs.closeSync(fd);
+}));
+
+assert.throws(() => fs.ioBatchSync({}),
+              /^TypeError: "ops" argument must be an array$/);
+assert.throws(() => fs.ioBatchSync([{ type: 'seek', fd }]),
+              /^TypeError: "type" must be 'read' or 'write'$/);
+assert.throws(() => {
+  fs.ioBatchSync([{ type: 'read', fd, buffer: Buffer.alloc(4), length: 5 }]);
+}, /^RangeError: "length" is outside of the buffer$/);
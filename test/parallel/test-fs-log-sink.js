@@ -0,0 +1,131 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+common.refreshTmpDir();
+
+function readRecords(file) {
+  const lines = fs.readFileSync(file, 'utf8').split('\n');
+  assert.strictEqual(lines.pop(), '');
+  return lines.map((line) => JSON.parse(line));
+}
+
+// The records are formatted as JSON.stringify() formats them.
+{
+  const file = path.join(common.tmpDir, 'format.log');
+  const sink = fs.createLogSink(file);
+  const records = [
+    { level: 'info', msg: 'hello', n: 42 },
+    { s: 'quote " backslash \\ newline \n tab \t ctrl \u0001 unicode é' },
+    { float: 0.1, neg: -1.5e-10, big: 1e21, max: Number.MAX_VALUE },
+    { nan: NaN, inf: -Infinity, zero: -0, t: true, f: false, nil: null },
+    { skipped: undefined, fn() {}, sym: Symbol('x'), kept: 1 },
+    { arr: [1, 'two', { three: 3 }], date: new Date(0) },
+    { toJSON() { return 'custom'; } },
+    { 0: 'index', 'weird key "\n': 'value' },
+    {}
+  ];
+  records.forEach((record) => sink.log(record));
+  sink.logFields(['time', 'level'], [1234, 'warn']);
+  sink.write('{"raw":true}');
+  sink.write('{"raw":false}\n');
+
+  sink.close(common.mustCall((err) => {
+    assert.ifError(err);
+    const expected = records.map((record) => {
+      // Only for the comparison, log() ignores toJSON() on the record.
+      const copy = Object.assign({}, record);
+      delete copy.toJSON;
+      return JSON.parse(JSON.stringify(copy));
+    });
+    expected.push({ time: 1234, level: 'warn' }, { raw: true }, { raw: false });
+    assert.deepStrictEqual(readRecords(file), expected);
+
+    const text = fs.readFileSync(file, 'utf8');
+    assert.ok(text.includes('"zero":0,'));
+    assert.ok(text.includes('"float":0.1,'));
+
+    assert.throws(() => sink.log({}), /^Error: LogSink is closed$/);
+  }));
+}
+
+// Many records are written in batches, in order, and flush() calls back once
+// everything logged before it has been written.
+{
+  const file = path.join(common.tmpDir, 'batches.log');
+  const sink = fs.createLogSink(file, { highWaterMark: 1024 });
+  const keys = ['i', 'msg'];
+  const count = 10000;
+  for (let i = 0; i < count; i++)
+    sink.logFields(keys, [i, `record ${i}`]);
+
+  sink.flush(common.mustCall((err) => {
+    assert.ifError(err);
+    assert.strictEqual(sink.bytesWritten, fs.statSync(file).size);
+    const records = readRecords(file);
+    assert.strictEqual(records.length, count);
+    records.forEach((record, i) => {
+      assert.deepStrictEqual(record, { i, msg: `record ${i}` });
+    });
+    sink.close(common.mustCall());
+  }));
+}
+
+// An exception thrown while formatting a record drops only that record.
+{
+  const file = path.join(common.tmpDir, 'throws.log');
+  const sink = fs.createLogSink(file);
+  const circular = {};
+  circular.self = circular;
+  sink.log({ before: 1 });
+  assert.throws(() => sink.log({ a: 1, circular }), TypeError);
+  assert.throws(() => sink.log({ get a() { throw new Error('getter'); } }),
+                /^Error: getter$/);
+  sink.log({ after: 2 });
+  sink.flushSync();
+  assert.deepStrictEqual(readRecords(file), [{ before: 1 }, { after: 2 }]);
+  sink.close(common.mustCall());
+}
+
+// Records are written within flushInterval, and a file descriptor that is
+// passed in is not closed.
+{
+  const file = path.join(common.tmpDir, 'interval.log');
+  const fd = fs.openSync(file, 'w');
+  const sink = fs.createLogSink(fd, { flushInterval: 10 });
+  sink.log({ timer: true });
+  const interval = setInterval(() => {
+    if (fs.readFileSync(file, 'utf8') !== '{"timer":true}\n')
+      return;
+    clearInterval(interval);
+    sink.close(common.mustCall(() => {
+      fs.fstatSync(fd);
+      fs.closeSync(fd);
+    }));
+  }, 5);
+}
+
+// Writing to a file descriptor that is not writable emits 'error'.
+{
+  const file = path.join(common.tmpDir, 'readonly.log');
+  fs.writeFileSync(file, '');
+  const fd = fs.openSync(file, 'r');
+  const sink = fs.createLogSink(fd);
+  sink.on('error', common.mustCall((err) => {
+    assert.strictEqual(err.code, 'EBADF');
+  }));
+  sink.log({ x: 1 });
+  sink.flush(common.mustCall((err) => {
+    assert.strictEqual(err.code, 'EBADF');
+    fs.closeSync(fd);
+  }));
+}
+
+assert.throws(() => fs.createLogSink(path.join(common.tmpDir, 'x'),
+                                     { highWaterMark: 0 }),
+              /^TypeError: "highWaterMark" must be a positive integer$/);
+assert.throws(() => fs.createLogSink(path.join(common.tmpDir, 'x'),
+                                     { flushInterval: -1 }),
+              /^TypeError: "flushInterval" must be a non-negative integer$/);
@@ -0,0 +1,50 @@
+'use strict';
+const common = require('../common');
+
+// fs.mmapSync() maps a file into memory as an ArrayBuffer.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+common.refreshTmpDir();
+
+const file = path.join(common.tmpDir, 'mmap.bin');
+const data = Buffer.alloc(3 * 65536 + 123);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+fs.writeFileSync(file, data);
+
+const fd = fs.openSync(file, 'r');
+
+const whole = fs.mmapSync(fd);
+assert(whole instanceof ArrayBuffer);
+assert(Buffer.from(whole).equals(data));
+
+// Offsets don't have to be on a page boundary.
+for (const advice of ['normal', 'random', 'sequential', 'willneed']) {
+  const part = fs.mmapSync(fd, { offset: 65537, length: 1000, advice });
+  assert(Buffer.from(part).equals(data.slice(65537, 66537)));
+}
+assert.strictEqual(fs.mmapSync(fd, { offset: data.length }).byteLength, 0);
+
+// Writes stay in memory and the mapping outlives the file descriptor.
+const view = new Uint8Array(fs.mmapSync(fd, { length: 16 }));
+fs.closeSync(fd);
+view[0] = 42;
+assert.strictEqual(view[0], 42);
+assert.strictEqual(fs.readFileSync(file)[0], 0);
+assert.strictEqual(view[1], 1);
+
+const fd2 = fs.openSync(file, 'r');
+assert.throws(() => fs.mmapSync(fd2, { offset: -1 }),
+              /^RangeError: "offset" must be a non-negative integer$/);
+assert.throws(() => fs.mmapSync(fd2, { length: 1.5 }),
+              /^RangeError: "length" must be an integer between 0 and \d+$/);
+assert.throws(() => fs.mmapSync(fd2, { length: data.length + 1 }),
+              /^RangeError: "offset" and "length" must be within the file$/);
+assert.throws(() => fs.mmapSync(fd2, { advice: 'never' }),
+              /^TypeError: Unknown advice: never$/);
+assert.throws(() => fs.mmapSync('fd'),
+              /^TypeError: "fd" must be a file descriptor$/);
+fs.closeSync(fd2);
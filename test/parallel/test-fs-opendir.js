@@ -0,0 +1,100 @@
+'use strict';
+const common = require('../common');
+
+// fs.readdir() with file types, and reading directories a batch at a time.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+common.refreshTmpDir();
+
+const dirPath = path.join(common.tmpDir, 'opendir');
+fs.mkdirSync(dirPath);
+const files = [];
+for (let i = 0; i < 100; i++) {
+  files.push(`file${i}`);
+  fs.writeFileSync(path.join(dirPath, `file${i}`), '');
+}
+fs.mkdirSync(path.join(dirPath, 'subdir'));
+const names = files.concat('subdir').sort();
+
+function checkDirents(dirents) {
+  assert.deepStrictEqual(dirents.map((d) => d.name).sort(), names);
+  for (const dirent of dirents) {
+    assert(dirent instanceof fs.Dirent);
+    assert.strictEqual(dirent.isDirectory(), dirent.name === 'subdir');
+    assert.strictEqual(dirent.isFile(), dirent.name !== 'subdir');
+    assert.strictEqual(dirent.isSymbolicLink(), false);
+  }
+}
+
+// readdir() lists the same entries in the same order with file types.
+const withTypes = fs.readdirSync(dirPath, { withFileTypes: true });
+checkDirents(withTypes);
+assert.deepStrictEqual(withTypes.map((d) => d.name), fs.readdirSync(dirPath));
+
+fs.readdir(dirPath, { withFileTypes: true }, common.mustCall((err, dirents) => {
+  assert.ifError(err);
+  checkDirents(dirents);
+}));
+
+fs.readdir(path.join(dirPath, 'missing'), { withFileTypes: true },
+           common.mustCall((err) => {
+             assert.strictEqual(err.code, 'ENOENT');
+           }));
+
+// Synchronous iteration.
+{
+  const dir = fs.opendirSync(dirPath, { bufferSize: 7 });
+  assert.strictEqual(dir.path, dirPath);
+  const dirents = [];
+  let dirent;
+  while ((dirent = dir.readSync()) !== null)
+    dirents.push(dirent);
+  checkDirents(dirents);
+  assert.strictEqual(dir.readSync(), null);
+  dir.closeSync();
+  assert.throws(() => dir.readSync(), /^Error: Directory handle was closed$/);
+}
+
+// Asynchronous iteration, with reads queued up before the close.
+fs.opendir(dirPath, common.mustCall((err, dir) => {
+  assert.ifError(err);
+  const dirents = [];
+  dir.read(function next(err, dirent) {
+    assert.ifError(err);
+    if (dirent === null) {
+      checkDirents(dirents);
+      dir.close(common.mustCall((err) => assert.ifError(err)));
+      return;
+    }
+    dirents.push(dirent);
+    // Entries that are already buffered are handed out asynchronously too.
+    let sync = true;
+    dir.read(function(err, dirent) {
+      assert.strictEqual(sync, false);
+      next(err, dirent);
+    });
+    sync = false;
+  });
+}));
+
+fs.opendir(dirPath, { encoding: 'buffer' }, common.mustCall((err, dir) => {
+  assert.ifError(err);
+  dir.read(common.mustCall((err, dirent) => {
+    assert.ifError(err);
+    assert(Buffer.isBuffer(dirent.name));
+  }));
+  dir.close(common.mustCall((err) => assert.ifError(err)));
+}));
+
+fs.opendir(path.join(dirPath, 'missing'), common.mustCall((err, dir) => {
+  assert.strictEqual(err.code, 'ENOENT');
+  assert.strictEqual(err.syscall, 'opendir');
+  assert.strictEqual(dir, undefined);
+}));
+
+assert.throws(() => {
+  fs.opendirSync(dirPath, { bufferSize: 0 });
+}, /^RangeError: "bufferSize" must be an integer between 1 and 4096$/);
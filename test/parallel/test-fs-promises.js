@@ -0,0 +1,72 @@
+'use strict';
+const common = require('../common');
+
+// fs.promises settles native promises instead of calling callbacks.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { promises } = fs;
+
+common.refreshTmpDir();
+
+const dir = path.join(common.tmpDir, 'promises');
+const file = path.join(dir, 'file.txt');
+const copy = path.join(dir, 'copy.txt');
+
+promises.mkdir(dir)
+  .then(() => promises.open(file, 'w+'))
+  .then((fd) => {
+    return promises.write(fd, Buffer.from('hello world'))
+      .then(({ bytesWritten }) => {
+        assert.strictEqual(bytesWritten, 11);
+        return promises.write(fd, '!', 11);
+      })
+      .then(({ bytesWritten }) => {
+        assert.strictEqual(bytesWritten, 1);
+        return promises.fstat(fd);
+      })
+      .then((stats) => {
+        assert(stats instanceof fs.Stats);
+        assert.strictEqual(stats.size, 12);
+        const buffer = Buffer.alloc(5);
+        return promises.read(fd, buffer, 0, 5, 6);
+      })
+      .then(({ bytesRead, buffer }) => {
+        assert.strictEqual(bytesRead, 5);
+        assert.strictEqual(buffer.toString(), 'world');
+        return promises.close(fd);
+      });
+  })
+  .then(() => promises.readFile(file, 'utf8'))
+  .then((contents) => {
+    assert.strictEqual(contents, 'hello world!');
+    return promises.copyFile(file, copy);
+  })
+  .then(() => Promise.all([promises.stat(copy), promises.lstat(file)]))
+  .then(([copyStats, fileStats]) => {
+    // Concurrent stats don't clobber each other's results.
+    assert(copyStats.isFile());
+    assert.strictEqual(copyStats.size, fileStats.size);
+    return promises.readdir(dir, { withFileTypes: true });
+  })
+  .then((dirents) => {
+    assert.deepStrictEqual(dirents.map((d) => d.name).sort(),
+                           ['copy.txt', 'file.txt']);
+    assert(dirents.every((d) => d.isFile()));
+    return promises.access(path.join(dir, 'missing'));
+  })
+  .then(common.mustNotCall(), common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ENOENT');
+    assert.strictEqual(err.syscall, 'access');
+    return promises.rename(copy, path.join(dir, 'renamed.txt'));
+  }))
+  .then(() => promises.unlink(path.join(dir, 'renamed.txt')))
+  .then(() => promises.unlink(file))
+  .then(() => promises.rmdir(dir))
+  .then(common.mustCall(() => {
+    assert.strictEqual(fs.existsSync(dir), false);
+  }))
+  .catch(common.mustNotCall());
+
+assert.throws(() => promises.stat(), /^TypeError: path must be a string/);
@@ -0,0 +1,48 @@
+'use strict';
+const common = require('../common');
+
+// fs.readFile() reads the whole file in a single request on the thread pool.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+common.refreshTmpDir();
+
+const file = path.join(common.tmpDir, 'native.bin');
+const data = Buffer.alloc(200 * 1024);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 253;
+fs.writeFileSync(file, data);
+
+fs.readFile(file, common.mustCall((err, buf) => {
+  assert.ifError(err);
+  assert(buf.equals(data));
+}));
+
+fs.readFile(file, 'hex', common.mustCall((err, str) => {
+  assert.ifError(err);
+  assert.strictEqual(str, data.toString('hex'));
+}));
+
+// A file descriptor is read from its current position and left open.
+const fd = fs.openSync(file, 'r');
+fs.readSync(fd, Buffer.alloc(1000), 0, 1000, null);
+fs.readFile(fd, common.mustCall((err, buf) => {
+  assert.ifError(err);
+  assert(buf.equals(data.slice(1000)));
+  fs.closeSync(fd);
+}));
+
+fs.readFile(path.join(common.tmpDir, 'missing'), common.mustCall((err) => {
+  assert.strictEqual(err.code, 'ENOENT');
+  assert.strictEqual(err.syscall, 'open');
+}));
+
+// Reading a directory fails, except on platforms that allow it.
+fs.readFile(common.tmpDir, common.mustCall((err, buf) => {
+  if (err)
+    assert.strictEqual(err.code, 'EISDIR');
+  else
+    assert(Buffer.isBuffer(buf));
+}));
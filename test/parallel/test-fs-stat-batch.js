@@ -0,0 +1,65 @@
+'use strict';
+const common = require('../common');
+
+// fs.statBatch() stats many paths in one request.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+common.refreshTmpDir();
+
+const file = path.join(common.tmpDir, 'file');
+const link = path.join(common.tmpDir, 'link');
+const missing = path.join(common.tmpDir, 'missing');
+fs.writeFileSync(file, 'hello');
+
+let canSymlink = true;
+try {
+  fs.symlinkSync(file, link);
+} catch (err) {
+  canSymlink = false;
+}
+
+function check(stats) {
+  assert.strictEqual(stats.length, 3);
+  assert(stats[0] instanceof fs.Stats);
+  assert(stats[0].isFile());
+  assert.strictEqual(stats[0].size, 5);
+  assert.deepStrictEqual(stats[0], fs.statSync(file));
+  assert(stats[1] instanceof fs.Stats);
+  assert(stats[1].isDirectory());
+  assert(stats[2] instanceof Error);
+  assert.strictEqual(stats[2].code, 'ENOENT');
+  assert.strictEqual(stats[2].syscall, 'stat');
+}
+
+const paths = [file, Buffer.from(common.tmpDir), missing];
+check(fs.statBatchSync(paths));
+fs.statBatch(paths, common.mustCall((err, stats) => {
+  assert.ifError(err);
+  check(stats);
+}));
+
+fs.statBatch([], common.mustCall((err, stats) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(stats, []);
+}));
+
+if (canSymlink) {
+  const stats = fs.statBatchSync([link, link], { followSymlinks: false });
+  assert(stats[0].isSymbolicLink());
+  assert(stats[1].isSymbolicLink());
+  fs.statBatch([link], common.mustCall((err, stats) => {
+    assert.ifError(err);
+    assert(stats[0].isFile());
+  }));
+}
+
+assert.throws(() => fs.statBatchSync('file'),
+              /^TypeError: "paths" argument must be an array$/);
+assert.throws(() => fs.statBatchSync(['a\u0000b']),
+              /^Error: Path must be a string without null bytes$/);
+fs.statBatch(['a\u0000b'], common.mustCall((err) => {
+  assert.strictEqual(err.code, 'ENOENT');
+}));
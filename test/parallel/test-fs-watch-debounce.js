@@ -0,0 +1,48 @@
+'use strict';
+
+const common = require('../common');
+
+if (!common.isLinux) {
+  common.skip('debounce option is linux specific');
+  return;
+}
+
+const assert = require('assert');
+const path = require('path');
+const fs = require('fs');
+
+common.refreshTmpDir();
+
+assert.throws(() => fs.watch(common.tmpDir, { debounce: -1 }),
+              /^RangeError: "debounce" must be a non-negative integer$/);
+assert.throws(() => fs.watch(common.tmpDir, { debounce: 1.5 }),
+              /^RangeError: "debounce" must be a non-negative integer$/);
+
+const filename = 'watch.txt';
+const subdir = 'subdir';
+const nested = path.join(subdir, 'nested.txt');
+const seen = [];
+
+const watcher = fs.watch(common.tmpDir, { recursive: true, debounce: 50 });
+watcher.on('change', (eventType, name) => {
+  assert.ok(eventType === 'rename' || eventType === 'change');
+  seen.push(`${eventType} ${name}`);
+  if (name === nested)
+    watcher.close();
+});
+
+for (let i = 0; i < 10; i++)
+  fs.writeFileSync(path.join(common.tmpDir, filename), `${i}`);
+// Created before the watch on the new directory was added, and reported
+// when it was.
+fs.mkdirSync(path.join(common.tmpDir, subdir));
+fs.writeFileSync(path.join(common.tmpDir, nested), 'nested');
+
+process.on('exit', () => {
+  assert.ok(seen.includes(`rename ${filename}`), seen);
+  assert.ok(seen.includes(`rename ${subdir}`), seen);
+  assert.ok(seen.includes(`rename ${nested}`), seen);
+  // The ten writes are reported together.
+  const changes = seen.filter((event) => event === `change ${filename}`);
+  assert.ok(changes.length > 0 && changes.length < 10, seen);
+});
@@ -2,8 +2,8 @@
 
 const common = require('../common');
 
-if (!(common.isOSX || common.isWindows)) {
-  common.skip('recursive option is darwin/windows specific');
+if (!(common.isOSX || common.isWindows || common.isLinux)) {
+  common.skip('recursive option is darwin/windows/linux specific');
   return;
 }
 
@@ -0,0 +1,41 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+// Many files that are watched with the same interval are polled together,
+// and only the ones that change are reported.
+
+common.refreshTmpDir();
+
+const count = 600;
+const files = [];
+for (let i = 0; i < count; i++) {
+  const file = path.join(common.tmpDir, `watched-${i}`);
+  fs.writeFileSync(file, 'x');
+  files.push(file);
+}
+
+const changed = new Set([7, 300, 599]);
+const seen = new Set();
+files.forEach((file, i) => {
+  fs.watchFile(file, { interval: 20 }, (curr, prev) => {
+    assert.ok(changed.has(i), `${file} did not change`);
+    assert.strictEqual(prev.size, 1);
+    assert.strictEqual(curr.size, 3);
+    seen.add(i);
+    if (seen.size === changed.size)
+      files.forEach((file) => fs.unwatchFile(file));
+  });
+});
+
+// After the first stat() of every file.
+setTimeout(common.mustCall(() => {
+  for (const i of changed)
+    fs.writeFileSync(files[i], 'xyz');
+}), 100);
+
+process.on('exit', () => {
+  assert.strictEqual(seen.size, changed.size);
+});
@@ -0,0 +1,78 @@
+'use strict';
+const common = require('../common');
+
+// With flushInterval, fs.WriteStream holds small writes back and writes them
+// out together.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+common.refreshTmpDir();
+
+// Writes are held back until the interval passes.
+{
+  const file = path.join(common.tmpDir, 'coalesce-interval.txt');
+  const stream = fs.createWriteStream(file, { flushInterval: 50 });
+  const writev = stream._writev;
+  let batches = 0;
+  stream._writev = function(data, cb) {
+    batches++;
+    return writev.call(this, data, cb);
+  };
+
+  stream.once('open', common.mustCall(() => {
+    for (let i = 0; i < 100; i++)
+      stream.write(`line ${i}\n`);
+    assert.strictEqual(stream.bytesWritten, 0);
+
+    setTimeout(common.mustCall(() => {
+      assert.strictEqual(batches, 1);
+      assert.strictEqual(stream.bytesWritten,
+                         fs.readFileSync(file).length);
+      stream.end('last\n');
+    }), 200);
+  }));
+
+  stream.on('finish', common.mustCall(() => {
+    const lines = fs.readFileSync(file, 'utf8').split('\n');
+    assert.strictEqual(lines.length, 102);
+    assert.strictEqual(lines[99], 'line 99');
+    assert.strictEqual(lines[100], 'last');
+  }));
+}
+
+// Crossing the threshold writes right away, end() flushes what is left.
+{
+  const file = path.join(common.tmpDir, 'coalesce-threshold.txt');
+  const stream = fs.createWriteStream(file, {
+    flushInterval: common.platformTimeout(60 * 1000),
+    flushThreshold: 10
+  });
+  stream.once('open', common.mustCall(() => {
+    stream.write('12345');
+    stream.write('67890');
+    stream.write('abc');
+    stream.end();
+  }));
+  stream.on('finish', common.mustCall(() => {
+    assert.strictEqual(fs.readFileSync(file, 'utf8'), '1234567890abc');
+  }));
+}
+
+// flush() writes out held back data.
+{
+  const file = path.join(common.tmpDir, 'coalesce-flush.txt');
+  const stream = fs.createWriteStream(file, {
+    flushInterval: common.platformTimeout(60 * 1000)
+  });
+  stream.write('held', common.mustCall(() => {
+    assert.strictEqual(fs.readFileSync(file, 'utf8'), 'held');
+    stream.destroy();
+  }));
+  stream.flush();
+}
+
+assert.throws(() => {
+  fs.createWriteStream(path.join(common.tmpDir, 'x'), { flushInterval: -1 });
+}, /^TypeError: "flushInterval" must be a non-negative integer$/);
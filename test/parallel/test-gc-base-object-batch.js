@@ -0,0 +1,25 @@
+'use strict';
+// Flags: --expose-gc
+require('../common');
+const vm = require('vm');
+
+// The wraps of collected objects are deleted on the next loop iteration
+// rather than during GC. Collect a lot of them at different times, including
+// right before the process exits.
+
+function createScripts(count) {
+  for (let i = 0; i < count; i++)
+    new vm.Script(`${i}`);
+}
+
+createScripts(1000);
+global.gc();
+
+setImmediate(() => {
+  createScripts(1000);
+  global.gc();
+  setImmediate(() => {
+    createScripts(1000);
+    global.gc();
+  });
+});
@@ -0,0 +1,56 @@
+'use strict';
+const common = require('../common');
+
+// Free sockets are reused last in, first out, and the ones that stay free for
+// longer than freeSocketTimeout are destroyed.
+
+const assert = require('assert');
+const http = require('http');
+
+const agent = new http.Agent({ keepAlive: true, freeSocketTimeout: 100 });
+
+const server = http.createServer(common.mustCall((req, res) => {
+  res.end('ok');
+}, 3));
+
+function get(cb) {
+  http.get({ port: server.address().port, agent }, (res) => {
+    const socket = res.socket;
+    res.resume();
+    res.on('end', () => setImmediate(cb, socket));
+  });
+}
+
+server.listen(0, common.mustCall(() => {
+  const name = `localhost:${server.address().port}:`;
+  const freed = [];
+  const done = common.mustCall(() => {
+    assert.strictEqual(agent.freeSockets[name].length, 2);
+    assert.deepStrictEqual(agent.poolStats,
+                           { hits: 0, misses: 2, expired: 0 });
+
+    get(common.mustCall((socket) => {
+      assert.strictEqual(socket, freed[1]);
+      assert.deepStrictEqual(agent.poolStats,
+                             { hits: 1, misses: 2, expired: 0 });
+      waitForExpiry();
+    }));
+  });
+
+  for (let i = 0; i < 2; i++) {
+    get(common.mustCall((socket) => {
+      freed.push(socket);
+      if (freed.length === 2)
+        done();
+    }));
+  }
+
+  function waitForExpiry() {
+    if (agent.freeSockets[name] !== undefined)
+      return setTimeout(waitForExpiry, 20);
+    assert.strictEqual(agent.poolStats.expired, 2);
+    assert(freed[0].destroyed);
+    assert(freed[1].destroyed);
+    server.close();
+  }
+}));
@@ -0,0 +1,55 @@
+'use strict';
+const common = require('../common');
+
+// Check the framing of chunks on the wire, for strings and buffers, with
+// sizes whose size line is cached and sizes whose size line is not.
+
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+
+const chunks = [
+  'a',
+  Buffer.from('b'),
+  'a',
+  'é',
+  Buffer.alloc(1024, 'c'),
+  Buffer.alloc(1025, 'd'),
+  'e'.repeat(4096),
+  Buffer.from('ff', 'hex'),
+  ['ff', 'hex'],
+  ['YQ==', 'base64']
+];
+
+let expected = '';
+chunks.forEach((chunk) => {
+  const data = Array.isArray(chunk) ? Buffer.from(chunk[0], chunk[1]) :
+                                      Buffer.from(chunk);
+  expected += `${data.length.toString(16)}\r\n${data.toString('latin1')}\r\n`;
+});
+expected += '0\r\n\r\n';
+
+const server = http.createServer(common.mustCall((req, res) => {
+  chunks.forEach((chunk) => {
+    if (Array.isArray(chunk))
+      res.write(chunk[0], chunk[1]);
+    else
+      res.write(chunk);
+  });
+  res.end();
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port, () => {
+    client.end('GET / HTTP/1.1\r\nHost: a\r\nConnection: close\r\n\r\n');
+  });
+  let response = '';
+  client.setEncoding('latin1');
+  client.on('data', (data) => response += data);
+  client.on('end', common.mustCall(() => {
+    const head = response.slice(0, response.indexOf('\r\n\r\n'));
+    assert(/\r\nTransfer-Encoding: chunked/.test(head));
+    assert.strictEqual(response.slice(head.length + 4), expected);
+    server.close();
+  }));
+}));
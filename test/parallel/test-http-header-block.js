@@ -0,0 +1,78 @@
+'use strict';
+const common = require('../common');
+
+// The header block of a message is put together in C++ unless a header is
+// invalid or not one-byte. Both ways have to give the same result.
+
+const assert = require('assert');
+const http = require('http');
+
+const cases = [
+  {
+    check(res) {
+      res.setHeader('X-Set', 'a');
+      res.setHeader('Set-Cookie', ['a=1', 'b=2']);
+      res.writeHead(200, { 'Content-Length': 2, 'X-Obj': 'ö' });
+      return 'HTTP/1.1 200 OK\r\n' +
+             'X-Set: a\r\n' +
+             'Set-Cookie: a=1\r\n' +
+             'Set-Cookie: b=2\r\n' +
+             'Content-Length: 2\r\n' +
+             'X-Obj: ö\r\n' +
+             'Connection: close\r\n\r\n';
+    }
+  },
+  {
+    check(res) {
+      res.writeHead(201, 'Créé', [['X-A', '1'], ['X-A', ['2', '3']]]);
+      return 'HTTP/1.1 201 Créé\r\n' +
+             'X-A: 1\r\n' +
+             'X-A: 2\r\n' +
+             'X-A: 3\r\n' +
+             'Connection: close\r\n' +
+             'Transfer-Encoding: chunked\r\n\r\n';
+    }
+  },
+  {
+    check(res) {
+      assert.throws(() => res.writeHead(200, { 'X-Good': 'a', 'X Bad': 'b' }),
+                    /^TypeError: Header name must be a valid HTTP Token/);
+      assert.throws(() => res.writeHead(200, { 'X-Good': 'a\nb' }),
+                    /^TypeError: The header content contains invalid/);
+      assert.throws(() => res.writeHead(200, { 'X-Good': undefined }),
+                    /^Error: Header "%s" value must not be undefined$/);
+      assert.throws(() => res.writeHead(200, { 'X-Good': 'ā' }),
+                    /^TypeError: The header content contains invalid/);
+      res.writeHead(200, { 'X-Ok': 'a' });
+      return 'HTTP/1.1 200 OK\r\n' +
+             'X-Ok: a\r\n' +
+             'Connection: close\r\n' +
+             'Transfer-Encoding: chunked\r\n\r\n';
+    }
+  }
+];
+
+let n = 0;
+const server = http.createServer(common.mustCall((req, res) => {
+  res.sendDate = false;
+  const expected = cases[n++].check(res);
+  assert.strictEqual(res._header, expected);
+  res.end('ok');
+  if (n === cases.length)
+    server.close();
+}, cases.length));
+
+server.listen(0, common.mustCall(() => {
+  (function next() {
+    http.get({
+      port: server.address().port,
+      agent: false
+    }, common.mustCall((res) => {
+      res.resume();
+      res.on('end', () => {
+        if (n < cases.length)
+          next();
+      });
+    }));
+  })();
+}));
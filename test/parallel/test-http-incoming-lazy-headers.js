@@ -0,0 +1,39 @@
+'use strict';
+require('../common');
+
+// `headers` and `trailers` of an IncomingMessage are made from rawHeaders and
+// rawTrailers when they are first used.
+
+const assert = require('assert');
+const IncomingMessage = require('http').IncomingMessage;
+
+let msg = new IncomingMessage(null);
+assert.deepStrictEqual(msg.headers, {});
+assert.deepStrictEqual(msg.trailers, {});
+
+// Only the first n entries count, like with maxHeadersCount.
+msg = new IncomingMessage(null);
+msg._addHeaderLines(['Host', 'a', 'X-Foo', '1', 'x-foo', '2', 'X-Bar', '3'], 6);
+assert.deepStrictEqual(msg.rawHeaders,
+                       ['Host', 'a', 'X-Foo', '1', 'x-foo', '2', 'X-Bar', '3']);
+assert.deepStrictEqual(msg.headers, { host: 'a', 'x-foo': '1, 2' });
+assert.strictEqual(msg.headers, msg.headers);
+
+msg.complete = true;
+msg._addHeaderLines(['X-Trailer', 'b'], 2);
+assert.deepStrictEqual(msg.trailers, { 'x-trailer': 'b' });
+assert.deepStrictEqual(msg.headers, { host: 'a', 'x-foo': '1, 2' });
+
+// Headers that come after `headers` was made are added to it.
+msg = new IncomingMessage(null);
+assert.deepStrictEqual(msg.headers, {});
+msg._addHeaderLines(['Host', 'a'], 2);
+assert.deepStrictEqual(msg.headers, { host: 'a' });
+
+// Both can be replaced.
+msg = new IncomingMessage(null);
+msg._addHeaderLines(['Host', 'a'], 2);
+msg.headers = { host: 'b' };
+msg.trailers = { foo: 'bar' };
+assert.deepStrictEqual(msg.headers, { host: 'b' });
+assert.deepStrictEqual(msg.trailers, { foo: 'bar' });
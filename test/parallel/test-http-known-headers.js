@@ -0,0 +1,40 @@
+'use strict';
+const common = require('../common');
+
+// The parser keeps the strings of known header names and of their last
+// values. Check that messages on the same connection still see their own
+// names and values, in the spelling they were sent with.
+
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+
+const requests = [
+  ['Host: a', 'User-Agent: ua', 'content-type: text/plain', 'X-Foo: 1'],
+  ['host: a', 'User-Agent: ua', 'Content-Type: text/html', 'X-Foo: 1'],
+  ['Host: b', 'user-agent: ua', 'Content-Type: text/html', 'Age: '],
+  ['HOST: b', 'User-Agent: ua2', 'ETag: "x"', 'Age: 1']
+];
+
+let n = 0;
+const server = http.createServer(common.mustCall((req, res) => {
+  const expected = [];
+  requests[n++].forEach((line) => {
+    const [name, value] = line.split(': ');
+    expected.push(name, value);
+  });
+  assert.deepStrictEqual(req.rawHeaders, expected);
+  for (let i = 0; i < expected.length; i += 2)
+    assert.strictEqual(req.headers[expected[i].toLowerCase()], expected[i + 1]);
+  res.end();
+}, requests.length));
+
+server.listen(0, common.mustCall(() => {
+  const socket = net.connect(server.address().port, () => {
+    socket.end(requests.map((headers) => {
+      return `GET / HTTP/1.1\r\n${headers.join('\r\n')}\r\n\r\n`;
+    }).join(''));
+  });
+  socket.resume();
+  socket.on('end', common.mustCall(() => server.close()));
+}));
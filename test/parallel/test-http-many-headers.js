@@ -0,0 +1,44 @@
+'use strict';
+const common = require('../common');
+
+// All headers of a message reach the 'request' listener in order, also when
+// there are more than the parser has room for at first and they arrive in
+// small pieces.
+
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+
+const N = 200;
+const expected = ['Host', 'localhost'];
+for (let i = 0; i < N; i++)
+  expected.push(`X-Header-${i}`, `value ${i}`);
+
+let head = 'GET /many HTTP/1.1\r\n';
+for (let i = 0; i < expected.length; i += 2)
+  head += `${expected[i]}: ${expected[i + 1]}\r\n`;
+head += '\r\n';
+
+const server = http.createServer(common.mustCall((req, res) => {
+  assert.strictEqual(req.url, '/many');
+  assert.deepStrictEqual(req.rawHeaders, expected);
+  assert.strictEqual(Object.keys(req.headers).length, N + 1);
+  assert.strictEqual(req.headers[`x-header-${N - 1}`], `value ${N - 1}`);
+  res.end();
+}, 2));
+
+server.listen(0, common.mustCall(() => {
+  const socket = net.connect(server.address().port, () => {
+    // Once in one piece, and once in pieces that cut through the headers.
+    socket.write(head);
+    let offset = 0;
+    (function writeChunk() {
+      if (offset >= head.length)
+        return socket.end();
+      socket.write(head.slice(offset, offset += 97));
+      setImmediate(writeChunk);
+    })();
+  });
+  socket.resume();
+  socket.on('end', common.mustCall(() => server.close()));
+}));
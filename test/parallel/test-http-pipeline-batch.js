@@ -0,0 +1,73 @@
+'use strict';
+const common = require('../common');
+
+// Pipelined requests without a body reach JS land together. Requests with a
+// body in between must still be handled in order, and the responses that are
+// written right away should go out in fewer writes than there are requests.
+
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+
+const paths = [];
+let requests = '';
+for (let i = 0; i < 20; i++) {
+  paths.push(`/${i}`);
+  if (i % 7 === 3) {
+    requests += `POST /${i} HTTP/1.1\r\nContent-Length: 4\r\n\r\nbody`;
+  } else {
+    requests += `GET /${i} HTTP/1.1\r\nHost: a\r\n\r\n`;
+  }
+}
+
+let writes = 0;
+const seen = [];
+const server = http.createServer(common.mustCall((req, res) => {
+  seen.push(req.url);
+  if (req.method === 'GET')
+    return res.end(req.url);
+  let body = '';
+  req.setEncoding('utf8');
+  req.on('data', (chunk) => body += chunk);
+  req.on('end', common.mustCall(() => {
+    assert.strictEqual(body, 'body');
+    res.end(req.url);
+  }));
+}, paths.length));
+
+server.on('connection', common.mustCall((socket) => {
+  const write = socket._write;
+  const writev = socket._writev;
+  socket._write = function() {
+    writes++;
+    return write.apply(this, arguments);
+  };
+  socket._writev = function() {
+    writes++;
+    return writev.apply(this, arguments);
+  };
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port, () => {
+    client.write(requests);
+  });
+  let response = '';
+  client.setEncoding('utf8');
+  client.on('data', (chunk) => {
+    response += chunk;
+    if (response.split('\r\n\r\n').length > paths.length &&
+        response.endsWith(paths[paths.length - 1])) {
+      client.end();
+    }
+  });
+  client.on('end', common.mustCall(() => {
+    const bodies = response.split('HTTP/1.1 200 OK\r\n').slice(1).map((r) => {
+      return r.slice(r.indexOf('\r\n\r\n') + 4);
+    });
+    assert.deepStrictEqual(seen, paths);
+    assert.deepStrictEqual(bodies, paths);
+    assert(writes < paths.length, `${writes} writes`);
+    server.close();
+  }));
+}));
@@ -0,0 +1,67 @@
+'use strict';
+const common = require('../common');
+
+// request.pathname and request.query are split from request.url on demand.
+
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+
+const targets = [
+  ['/', '/', null],
+  ['/a/b?x=1&y=2', '/a/b', 'x=1&y=2'],
+  ['/a?', '/a', ''],
+  ['/a?b?c#d', '/a', 'b?c'],
+  ['/a#b?c', '/a', null],
+  ['*', '*', null],
+  ['http://example.com', '/', null],
+  ['http://example.com?x', '/', 'x'],
+  ['https://user@example.com:8080/p/q?r', '/p/q', 'r'],
+  ['example.com:443', null, null],
+  ['/é?é', '/é', 'é'],
+  ['/€?€#€', '/€', '€']
+];
+
+{
+  const IncomingMessage = http.IncomingMessage;
+  targets.forEach(([url, pathname, query]) => {
+    const msg = new IncomingMessage(null);
+    msg.url = url;
+    assert.strictEqual(msg.pathname, pathname, url);
+    assert.strictEqual(msg.query, query, url);
+  });
+
+  // A message without a URL, like a response, has neither.
+  const msg = new IncomingMessage(null);
+  assert.strictEqual(msg.pathname, null);
+  assert.strictEqual(msg.query, null);
+
+  // Changing the URL changes both, setting them overrides them.
+  msg.url = '/a?b';
+  assert.strictEqual(msg.pathname, '/a');
+  msg.url = '/c/d';
+  assert.strictEqual(msg.pathname, '/c/d');
+  assert.strictEqual(msg.query, null);
+  msg.query = { x: '1' };
+  msg.pathname = '/e';
+  assert.deepStrictEqual(msg.query, { x: '1' });
+  assert.strictEqual(msg.pathname, '/e');
+  assert.strictEqual(new IncomingMessage(null).query, null);
+}
+
+const server = http.createServer(common.mustCall((req, res) => {
+  const [, pathname, query] = targets.find(([url]) => url === req.url);
+  assert.strictEqual(req.pathname, pathname);
+  assert.strictEqual(req.query, query);
+  res.end();
+}, 3));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port, () => {
+    client.end('GET /a/b?x=1&y=2 HTTP/1.1\r\n\r\n' +
+               'GET * HTTP/1.1\r\n\r\n' +
+               'GET http://example.com?x HTTP/1.1\r\n\r\n');
+  });
+  client.resume();
+  client.on('end', common.mustCall(() => server.close()));
+}));
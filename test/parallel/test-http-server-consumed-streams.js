@@ -0,0 +1,79 @@
+'use strict';
+const common = require('../common');
+
+// The HTTP server has its parser read straight from the socket's handle for
+// TLS sockets and for sockets around a JS stream, too.
+
+const assert = require('assert');
+const fs = require('fs');
+const http = require('http');
+const net = require('net');
+const StreamWrap = require('_stream_wrap');
+
+function onRequest(req, res) {
+  assert.strictEqual(req.socket.parser._consumed, true);
+  let body = '';
+  req.setEncoding('utf8');
+  req.on('data', (chunk) => body += chunk);
+  req.on('end', common.mustCall(() => res.end(`${req.url} ${body}`)));
+}
+
+// A JS stream, wrapping a TCP socket.
+{
+  const server = http.createServer(common.mustCall(onRequest, 2));
+  const tcp = net.createServer(common.mustCall((socket) => {
+    server.emit('connection', new StreamWrap(socket));
+  }));
+
+  tcp.listen(0, common.mustCall(() => {
+    const agent = new http.Agent({ keepAlive: true, maxSockets: 1 });
+    let done = 0;
+    ['/a', '/b'].forEach((path) => {
+      const req = http.request({
+        port: tcp.address().port,
+        method: 'POST',
+        path,
+        agent
+      }, common.mustCall((res) => {
+        let data = '';
+        res.setEncoding('utf8');
+        res.on('data', (chunk) => data += chunk);
+        res.on('end', common.mustCall(() => {
+          assert.strictEqual(data, `${path} body of ${path}`);
+          if (++done === 2) {
+            agent.destroy();
+            tcp.close();
+          }
+        }));
+      }));
+      req.end(`body of ${path}`);
+    });
+  }));
+}
+
+// TLS
+if (common.hasCrypto) {
+  const https = require('https');
+  const server = https.createServer({
+    key: fs.readFileSync(common.fixturesDir + '/keys/agent1-key.pem'),
+    cert: fs.readFileSync(common.fixturesDir + '/keys/agent1-cert.pem')
+  }, common.mustCall(onRequest));
+
+  server.listen(0, common.mustCall(() => {
+    const req = https.request({
+      port: server.address().port,
+      method: 'POST',
+      path: '/tls',
+      rejectUnauthorized: false
+    }, common.mustCall((res) => {
+      let data = '';
+      res.setEncoding('utf8');
+      res.on('data', (chunk) => data += chunk);
+      res.on('end', common.mustCall(() => {
+        assert.strictEqual(data, '/tls ' + 'x'.repeat(100000));
+        server.close();
+      }));
+    }));
+    req.end('x'.repeat(100000));
+  }));
+}
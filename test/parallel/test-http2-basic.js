@@ -0,0 +1,92 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const http2 = require('http2');
+
+function onEcho(stream, headers, flags) {
+  assert.strictEqual(Object.getPrototypeOf(headers), null);
+  assert.strictEqual(headers[':method'], 'POST');
+  assert.strictEqual(headers[':scheme'], 'http');
+  assert.strictEqual(headers['x-multi'], 'a, b');
+  assert.strictEqual(headers.cookie, 'a=1; b=2');
+  assert.strictEqual(flags, 0);
+  assert.strictEqual(stream.id, 1);
+  assert.strictEqual(stream.headersSent, false);
+
+  stream.setEncoding('utf8');
+  let body = '';
+  stream.on('data', (chunk) => body += chunk);
+  stream.on('end', common.mustCall(() => {
+    assert.strictEqual(body, 'hello world');
+    stream.respond({
+      ':status': 201,
+      'Content-Type': 'text/plain',
+      'set-cookie': ['x=1', 'y=2']
+    });
+    assert.strictEqual(stream.headersSent, true);
+    assert.throws(() => stream.respond(), /already been initiated/);
+    stream.write(body.toUpperCase());
+    stream.sendTrailers({ 'x-checksum': 'abc' });
+  }));
+  stream.on('close', common.mustCall((code) => {
+    assert.strictEqual(code, http2.constants.NO_ERROR);
+  }));
+}
+
+function onHead(stream, headers, flags) {
+  assert.strictEqual(headers[':method'], 'HEAD');
+  assert.strictEqual(flags, http2.constants.FLAG_END_STREAM);
+  stream.respond({ 'content-length': 10 });
+}
+
+const server = http2.createServer();
+server.on('stream', common.mustCall((stream, headers, flags) => {
+  if (headers[':path'] === '/echo')
+    onEcho(stream, headers, flags);
+  else
+    onHead(stream, headers, flags);
+}, 2));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`);
+  client.on('connect', common.mustCall());
+
+  const req = client.request({
+    ':method': 'POST',
+    ':path': '/echo',
+    'x-multi': ['a', 'b'],
+    cookie: ['a=1', 'b=2']
+  });
+  req.on('response', common.mustCall((headers, flags) => {
+    assert.strictEqual(headers[':status'], '201');
+    assert.strictEqual(headers['content-type'], 'text/plain');
+    assert.deepStrictEqual(headers['set-cookie'], ['x=1', 'y=2']);
+    assert.strictEqual(flags, 0);
+  }));
+  req.on('trailers', common.mustCall((headers) => {
+    assert.strictEqual(headers['x-checksum'], 'abc');
+  }));
+  req.setEncoding('utf8');
+  let body = '';
+  req.on('data', (chunk) => body += chunk);
+  req.on('end', common.mustCall(() => {
+    assert.strictEqual(body, 'HELLO WORLD');
+  }));
+  req.write('hello ');
+  req.end('world');
+
+  req.on('close', common.mustCall(() => {
+    // Responses to HEAD requests never have a body.
+    const head = client.request({ ':method': 'HEAD', ':path': '/head' },
+                                { endStream: true });
+    head.on('response', common.mustCall((headers, flags) => {
+      assert.strictEqual(headers[':status'], '200');
+      assert.strictEqual(headers['content-length'], '10');
+      assert.strictEqual(flags, http2.constants.FLAG_END_STREAM);
+    }));
+    head.resume();
+    head.on('end', common.mustCall(() => {
+      client.close(common.mustCall(() => server.close()));
+    }));
+  }));
+}));
@@ -0,0 +1,55 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const crypto = require('crypto');
+const http2 = require('http2');
+
+// Bodies much larger than the windows, with a reader that only keeps up after
+// a while, make both sides wait for WINDOW_UPDATE frames.
+const size = 4 * 1024 * 1024;
+const settings = { initialWindowSize: 16384 };
+
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+const body = crypto.randomBytes(size);
+
+function collect(stream, callback) {
+  const chunks = [];
+  stream.pause();
+  setTimeout(() => {
+    stream.on('data', (chunk) => chunks.push(chunk));
+    stream.resume();
+  }, 100);
+  stream.on('end', () => callback(Buffer.concat(chunks)));
+}
+
+const server = http2.createServer({ settings });
+server.on('stream', common.mustCall((stream) => {
+  collect(stream, common.mustCall((data) => {
+    assert(data.equals(body));
+    assert.strictEqual(stream.session.state.streamCount, 1);
+    stream.end(data);
+  }));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`,
+                               { settings });
+  const req = client.request({ ':method': 'PUT' });
+  let written = 0;
+  (function write() {
+    while (written < size) {
+      const chunk = body.slice(written, written + 65536);
+      written += chunk.length;
+      if (!req.write(chunk))
+        return req.once('drain', write);
+    }
+    req.end();
+  })();
+  collect(req, common.mustCall((data) => {
+    assert(data.equals(body));
+    client.close(common.mustCall(() => server.close()));
+  }));
+}));
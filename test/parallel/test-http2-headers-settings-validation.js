@@ -0,0 +1,69 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const http2 = require('http2');
+
+assert.deepStrictEqual(http2.getDefaultSettings(), {
+  headerTableSize: 4096,
+  enablePush: false,
+  maxConcurrentStreams: 100,
+  initialWindowSize: 65535,
+  maxFrameSize: 16384,
+  maxHeaderListSize: 65535
+});
+
+[
+  { headerTableSize: -1 },
+  { headerTableSize: 2 ** 32 },
+  { initialWindowSize: 2 ** 31 },
+  { maxFrameSize: 16383 },
+  { maxFrameSize: 2 ** 24 },
+  { maxConcurrentStreams: 1.5 },
+  { maxHeaderListSize: 'a lot' }
+].forEach((settings) => {
+  assert.throws(() => http2.createServer({ settings }),
+                /^RangeError: ".+" must be an integer from \d+ to \d+$/);
+});
+assert.throws(() => http2.createServer({ settings: { enablePush: 1 } }),
+              /^TypeError: "enablePush" must be a boolean$/);
+assert.throws(() => http2.connect('ftp://localhost'), /not supported/);
+
+const server = http2.createServer(common.mustCall((stream) => {
+  assert.throws(() => stream.respond({ ':status': 99 }),
+                /^RangeError: Invalid status code: 99$/);
+  assert.throws(() => stream.respond({ connection: 'close' }),
+                /^TypeError: Header "connection" is not valid in HTTP\/2$/);
+  assert.throws(() => stream.additionalHeaders({ ':status': 200 }),
+                /^RangeError: Invalid status code: 200$/);
+  stream.additionalHeaders({ ':status': 103, link: '</a.css>' });
+  stream.respond({ ':status': 204 });
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`);
+
+  [
+    { 'transfer-encoding': 'chunked' },
+    { 'keep-alive': 'timeout=5' },
+    { upgrade: 'h2c' },
+    { te: 'gzip' },
+    { ':foo': 'bar' },
+    { ':path': ['/a', '/b'] }
+  ].forEach((headers) => {
+    assert.throws(() => client.request(headers), TypeError);
+  });
+
+  const req = client.request({ te: 'trailers' }, { endStream: true });
+  req.on('headers', common.mustCall((headers) => {
+    assert.strictEqual(headers[':status'], '103');
+    assert.strictEqual(headers.link, '</a.css>');
+  }));
+  req.on('response', common.mustCall((headers, flags) => {
+    assert.strictEqual(headers[':status'], '204');
+    assert.strictEqual(flags, http2.constants.FLAG_END_STREAM);
+  }));
+  req.resume();
+  req.on('end', common.mustCall(() => {
+    client.close(common.mustCall(() => server.close()));
+  }));
+}));
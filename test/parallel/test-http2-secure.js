@@ -0,0 +1,49 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+const fs = require('fs');
+const http2 = require('http2');
+const tls = require('tls');
+
+const key = fs.readFileSync(`${common.fixturesDir}/keys/agent1-key.pem`);
+const cert = fs.readFileSync(`${common.fixturesDir}/keys/agent1-cert.pem`);
+const ca = fs.readFileSync(`${common.fixturesDir}/keys/ca1-cert.pem`);
+
+const server = http2.createSecureServer({ key, cert });
+server.on('stream', common.mustCall((stream, headers) => {
+  assert.strictEqual(headers[':scheme'], 'https');
+  assert.strictEqual(stream.session.socket.alpnProtocol, 'h2');
+  stream.end('secure');
+}));
+
+// Clients that cannot speak HTTP/2 are reported.
+server.on('unknownProtocol', common.mustCall((socket) => {
+  socket.destroy();
+}));
+
+server.listen(0, common.mustCall(() => {
+  const port = server.address().port;
+  const client = http2.connect(`https://localhost:${port}`,
+                               { ca, servername: 'agent1' });
+  const req = client.request({}, { endStream: true });
+  req.setEncoding('utf8');
+  let body = '';
+  req.on('data', (chunk) => body += chunk);
+  req.on('end', common.mustCall(() => {
+    assert.strictEqual(body, 'secure');
+    client.close();
+
+    const socket = tls.connect(port, {
+      ca,
+      servername: 'agent1',
+      ALPNProtocols: ['http/1.1']
+    });
+    socket.on('close', common.mustCall(() => server.close()));
+    socket.resume();
+  }));
+}));
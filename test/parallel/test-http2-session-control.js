@@ -0,0 +1,89 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const http2 = require('http2');
+
+const server = http2.createServer({ settings: { maxConcurrentStreams: 1 } });
+
+server.on('session', common.mustCall((session) => {
+  session.on('localSettings', common.mustCall((settings) => {
+    assert.strictEqual(settings.maxConcurrentStreams, 1);
+    assert.strictEqual(settings.enablePush, false);
+  }));
+  session.on('remoteSettings', common.mustCall((settings) => {
+    assert.strictEqual(settings.headerTableSize, 1024);
+  }));
+}));
+
+server.on('stream', common.mustCall((stream, headers) => {
+  // The client only gets to send the next request once this one is closed.
+  assert.strictEqual(stream.session.state.streamCount, 1);
+  switch (headers[':path']) {
+    case '/reset':
+      stream.close(http2.constants.ENHANCE_YOUR_CALM);
+      break;
+    case '/cancelled':
+      stream.on('aborted', common.mustCall());
+      stream.on('error', common.mustCall((err) => {
+        assert.strictEqual(err.errno, http2.constants.CANCEL);
+      }));
+      stream.on('close', common.mustCall((code) => {
+        assert.strictEqual(code, http2.constants.CANCEL);
+        assert.strictEqual(stream.rstCode, http2.constants.CANCEL);
+      }));
+      stream.resume();
+      break;
+    default:
+      stream.end('ok');
+  }
+}, 3));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`, {
+    settings: { headerTableSize: 1024 }
+  });
+
+  const payload = Buffer.from('pingpong');
+  client.ping(payload, common.mustCall((err, duration, received) => {
+    assert.ifError(err);
+    assert.strictEqual(typeof duration, 'number');
+    assert(received.equals(payload));
+  }));
+  assert.throws(() => client.ping(Buffer.alloc(7), common.mustNotCall()),
+                /^TypeError: "payload" must be a Buffer of 8 bytes$/);
+
+  // Once the client knows about the server's limit.
+  client.once('remoteSettings', common.mustCall(() => makeRequests(client)));
+}));
+
+function makeRequests(client) {
+  const reset = client.request({ ':path': '/reset' }, { endStream: true });
+  reset.on('error', common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ERR_HTTP2_STREAM_ERROR');
+    assert.strictEqual(err.errno, http2.constants.ENHANCE_YOUR_CALM);
+    assert.strictEqual(err.message,
+                       'Stream closed with error code ENHANCE_YOUR_CALM');
+  }));
+  reset.on('close', common.mustCall((code) => {
+    assert.strictEqual(code, http2.constants.ENHANCE_YOUR_CALM);
+  }));
+
+  // Queued until the first request is closed.
+  const cancelled = client.request({ ':path': '/cancelled' });
+  assert.strictEqual(cancelled.id, undefined);
+  cancelled.write('x', common.mustCall(() => {
+    assert.strictEqual(cancelled.id, 3);
+    cancelled.close(http2.constants.CANCEL);
+  }));
+  cancelled.on('error', common.mustNotCall());
+
+  cancelled.on('close', common.mustCall(() => {
+    const req = client.request({}, { endStream: true });
+    req.resume();
+    req.on('end', common.mustCall(() => {
+      assert.strictEqual(client.remoteSettings.maxConcurrentStreams, 1);
+      client.on('close', common.mustCall(() => server.close()));
+      client.destroy();
+    }));
+  }));
+}
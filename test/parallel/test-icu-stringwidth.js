@@ -41,3 +41,19 @@ assert.strictEqual(
 
 // Control chars and combining chars are zero
 assert.strictEqual(readline.getStringWidth('\u200E\n\u220A\u20D2'), 1);
+
+// Strings of Latin-1 characters, and the same characters in strings that are
+// stored as two-byte strings.
+for (const suffix of ['', '丁']) {
+  const width = suffix ? 2 : 0;
+  assert.strictEqual(readline.getStringWidth(`hello world${suffix}`),
+                     11 + width);
+  assert.strictEqual(readline.getStringWidth(`café\t\u0085${suffix}`),
+                     4 + width);
+  assert.strictEqual(readline.getStringWidth(`¡${suffix}`), 1 + width);
+  assert.strictEqual(
+    readline.getStringWidth(`¡${suffix}`, {ambiguousAsFullWidth: true}),
+    2 + width);
+  assert.strictEqual(readline.getStringWidth(`\u001b[31m×\u001b[39m${suffix}`),
+                     1 + width);
+}
@@ -0,0 +1,64 @@
+'use strict';
+const common = require('../common');
+common.skipIfInspectorDisabled();
+
+const assert = require('assert');
+const inspector = require('inspector');
+
+const session = new inspector.Session();
+
+assert.throws(() => session.post('Runtime.evaluate'),
+              /^Error: Session is not connected$/);
+
+session.connect();
+assert.throws(() => session.connect(), /^Error: Already connected$/);
+assert.throws(() => new inspector.Session().connect(),
+              /^Error: Another inspector session is connected$/);
+
+// The response arrives before post() returns.
+let result;
+session.post('Runtime.evaluate', { expression: '2 + 2' }, (err, response) => {
+  assert.ifError(err);
+  result = response.result;
+});
+assert.deepStrictEqual(result, { type: 'number', value: 4, description: '4' });
+
+session.post('Unknown.method', common.mustCall((err, response) => {
+  assert.ok(err instanceof Error);
+  assert.strictEqual(response, undefined);
+}));
+
+// Notifications are emitted under their method, and as a whole.
+session.on('Runtime.consoleAPICalled', common.mustCall(({ params }) => {
+  assert.strictEqual(params.type, 'log');
+}));
+let notifications = 0;
+session.on('inspectorNotification', () => notifications++);
+session.post('Runtime.enable');
+session.post('Runtime.evaluate', { expression: 'console.log(1)' });
+session.post('Runtime.disable');
+assert.ok(notifications > 0);
+
+// CPU profiles can be collected without a debugger.
+session.post('Profiler.enable');
+session.post('Profiler.start');
+for (let i = 0; i < 1e5; i++);
+session.post('Profiler.stop', common.mustCall((err, { profile }) => {
+  assert.ifError(err);
+  assert.ok(Array.isArray(profile.nodes));
+}));
+
+assert.throws(() => session.post(1), /^TypeError: "method" argument must be/);
+assert.throws(() => session.post('Runtime.evaluate', 'params'),
+              /^TypeError: "params" argument must be an object$/);
+assert.throws(() => session.post('Runtime.evaluate', {}, 'callback'),
+              /^TypeError: "callback" argument must be a function$/);
+
+session.disconnect();
+assert.throws(() => session.post('Runtime.evaluate'),
+              /^Error: Session is not connected$/);
+
+// Another session can connect once this one has disconnected.
+const other = new inspector.Session();
+other.connect();
+other.disconnect();
@@ -0,0 +1,62 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const json = require('json');
+
+const text = '{"a":[1,-2.5,1e300,null,true,false],' +
+             '"b":{"c":"é€😀","d":"\\u0000"},"__proto__":1}';
+
+json.parse(text, common.mustCall((err, result) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(result, JSON.parse(text));
+  // An own property, as with JSON.parse().
+  assert.strictEqual(Object.getPrototypeOf(result), Object.prototype);
+}));
+
+json.parse(Buffer.from(text), {}, common.mustCall((err, result) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(result, JSON.parse(text));
+}));
+
+json.parse(new Uint8Array(Buffer.from(' null ')),
+           common.mustCall((err, result) => {
+             assert.ifError(err);
+             assert.strictEqual(result, null);
+           }));
+
+// Duplicate keys: the last one wins.
+json.parse('{"a":1,"a":2}', common.mustCall((err, result) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(result, { a: 2 });
+}));
+
+// Invalid UTF-8 becomes U+FFFD, like Buffer#toString() does.
+json.parse(Buffer.from([0x22, 0xff, 0x61, 0x22]),
+           common.mustCall((err, result) => {
+             assert.ifError(err);
+             assert.strictEqual(result, '�a');
+           }));
+
+[
+  ['', 'Unexpected end of JSON input'],
+  ['1 2', 'Unexpected number in JSON at position 2'],
+  ['{"a":1"b":2}', 'Unexpected string in JSON at position 6'],
+  ['[1, 2}', 'Unexpected token } in JSON at position 5'],
+  ['[€]', 'Unexpected token € in JSON at position 1']
+].forEach(([text, message]) => {
+  json.parse(text, common.mustCall((err, result) => {
+    assert.ok(err instanceof SyntaxError);
+    assert.strictEqual(err.message, message);
+    assert.strictEqual(result, undefined);
+  }));
+});
+
+json.parse('[[1]]', { maxDepth: 1 }, common.mustCall((err) => {
+  assert.strictEqual(err.message, 'Nesting too deep in JSON at position 1');
+}));
+
+assert.throws(() => json.parse('1'), /^TypeError: "callback" argument/);
+assert.throws(() => json.parse(1, common.noop), /^TypeError: "data" argument/);
+assert.throws(() => json.parse('1', { maxDepth: -1 }, common.noop),
+              /^RangeError: Invalid maxDepth: -1$/);
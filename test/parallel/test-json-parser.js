@@ -0,0 +1,89 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const json = require('json');
+
+function parse(chunks, options, callback) {
+  const parser = json.createParser(options);
+  const values = [];
+  parser.on('data', (value) => values.push(value));
+  parser.on('end', common.mustCall(() => callback(values)));
+  for (const chunk of chunks)
+    parser.write(chunk);
+  parser.end();
+}
+
+// The elements of an array, in pieces that split tokens and UTF-8 sequences.
+{
+  const records = [];
+  for (let i = 0; i < 100; i++)
+    records.push({ id: i, name: `€${i}😀`, tags: ['a', i] });
+  records.push(1.5, 'x', true, false, [], {});
+  const text = Buffer.from(JSON.stringify(records));
+
+  for (const size of [1, 3, 7, 64, text.length]) {
+    const chunks = [];
+    for (let i = 0; i < text.length; i += size)
+      chunks.push(text.slice(i, i + size));
+    parse(chunks, { elements: true }, common.mustCall((values) => {
+      assert.deepStrictEqual(values, records);
+    }));
+  }
+}
+
+// null can't be pushed to the stream, and comes out as undefined.
+parse(['[1, null, 2]'], { elements: true }, common.mustCall((values) => {
+  assert.deepStrictEqual(values, [1, undefined, 2]);
+}));
+
+// Newline delimited JSON, and strings as input.
+parse(['{"a":1}\n{"a"', ':2}\n3 4"x"\n'], {}, common.mustCall((values) => {
+  assert.deepStrictEqual(values, [{ a: 1 }, { a: 2 }, 3, 4, 'x']);
+}));
+
+// Values that were complete before an error are emitted.
+{
+  const parser = json.createParser();
+  const values = [];
+  parser.on('data', (value) => values.push(value));
+  parser.on('error', common.mustCall((err) => {
+    assert.ok(err instanceof SyntaxError);
+    assert.strictEqual(err.message,
+                       'Unexpected token ] in JSON at position 11');
+    assert.deepStrictEqual(values, [[1], [2]]);
+  }));
+  parser.write('[1]\n[2]\n');
+  parser.end('[3,]');
+}
+
+[
+  ['[1', { elements: true }, 'Unexpected end of JSON input'],
+  ['1', { elements: true }, 'Unexpected number in JSON at position 0'],
+  ['[] []', { elements: true }, 'Unexpected token [ in JSON at position 3'],
+  ['{"a" 1}', {}, 'Unexpected number in JSON at position 5'],
+  ['"€\n"', {}, 'Unexpected token \n in JSON at position 4'],
+  ['[[[1]]]', { maxDepth: 2 }, 'Nesting too deep in JSON at position 2'],
+  ['[[[1]]]', { elements: true, maxDepth: 2 },
+   'Nesting too deep in JSON at position 2']
+].forEach(([text, options, message]) => {
+  const parser = json.createParser(options);
+  parser.on('data', common.noop);
+  parser.on('error', common.mustCall((err) => {
+    assert.ok(err instanceof SyntaxError);
+    assert.strictEqual(err.message, message);
+  }));
+  parser.end(text);
+});
+
+parse(['[[[1]]]'], { elements: true, maxDepth: 3 },
+      common.mustCall((values) => {
+        assert.deepStrictEqual(values, [[[1]]]);
+      }));
+
+[-1, 1.5, 10001, '1'].forEach((maxDepth) => {
+  assert.throws(() => json.createParser({ maxDepth }),
+                /^RangeError: Invalid maxDepth: /);
+});
+
+assert.ok(json.createParser() instanceof json.Parser);
@@ -28,3 +28,23 @@ assert.ok(r.rss > 0);
 assert.ok(r.heapTotal > 0);
 assert.ok(r.heapUsed > 0);
 assert.ok(r.external > 0);
+
+const heap = process.memoryUsage.heap();
+assert.deepStrictEqual(Object.keys(heap),
+                       ['heapTotal', 'heapUsed', 'external']);
+assert.ok(heap.heapTotal > 0);
+assert.ok(heap.heapUsed > 0);
+
+assert.ok(process.memoryUsage.rss() > 0);
+
+assert.throws(() => process.memoryUsage.sampleRss(-1), RangeError);
+assert.throws(() => process.memoryUsage.sampleRss('1'), RangeError);
+
+process.memoryUsage.sampleRss(1);
+process.memoryUsage.sampleRss(5);
+setTimeout(() => {
+  assert.ok(process.memoryUsage.rss() > 0);
+  assert.ok(process.memoryUsage().rss > 0);
+  process.memoryUsage.sampleRss(0);
+  assert.ok(process.memoryUsage.rss() > 0);
+}, 20);
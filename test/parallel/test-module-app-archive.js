@@ -0,0 +1,52 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+// Modules under the path of the archive of --app-archive are loaded out of
+// it, with their code caches.
+
+common.refreshTmpDir();
+const appDir = path.join(common.tmpDir, 'app');
+const depDir = path.join(appDir, 'node_modules', 'dep');
+const archive = path.join(common.tmpDir, 'app.nar');
+fs.mkdirSync(appDir);
+fs.mkdirSync(path.dirname(depDir));
+fs.mkdirSync(depDir);
+fs.writeFileSync(path.join(appDir, 'package.json'), '{"main": "main.js"}');
+fs.writeFileSync(path.join(appDir, 'main.js'), `#!/usr/bin/env node
+const answer = require('dep').answer;
+console.log(answer, require('./data.json').name, process.argv[2]);
+`);
+fs.writeFileSync(path.join(appDir, 'data.json'), '{"name": "café"}');
+fs.writeFileSync(path.join(depDir, 'index.js'), 'exports.answer = 42;\n');
+
+const packer = path.join(__dirname, '..', '..', 'tools', 'pack_app_archive.js');
+cp.execFileSync(process.execPath, [packer, appDir, archive]);
+
+// The sources are only in the archive.
+fs.unlinkSync(path.join(appDir, 'main.js'));
+
+function run(args) {
+  const result = cp.spawnSync(process.execPath, args, {
+    env: Object.assign({}, process.env, { NODE_DEBUG: 'module' })
+  });
+  assert.strictEqual(result.status, 0, result.stderr.toString());
+  return result;
+}
+
+const result = run([`--app-archive=${archive}`, archive, 'arg']);
+assert.strictEqual(result.stdout.toString(), '42 café arg\n');
+const mainPath = path.join(archive, 'main.js');
+assert(result.stderr.toString().includes(
+  `code cache of ${JSON.stringify(mainPath)} in the archive used`));
+
+// The archive itself is just a file without the flag.
+const plain = cp.spawnSync(process.execPath, [mainPath]);
+assert.notStrictEqual(plain.status, 0);
+
+const notArchive = cp.spawnSync(process.execPath,
+                                [`--app-archive=${__filename}`, '-e', '0']);
+assert(/is not an application archive/.test(notArchive.stderr.toString()));
@@ -0,0 +1,40 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+// The first run writes the code cache of the module, later runs use it until
+// the module changes.
+
+common.refreshTmpDir();
+const cacheDir = path.join(common.tmpDir, 'cache');
+const modulePath = path.join(common.tmpDir, 'module.js');
+fs.writeFileSync(modulePath, 'module.exports = function() { return 42; };\n');
+
+function run(args, env) {
+  const result = cp.spawnSync(process.execPath, args.concat([
+    '-e', `if (require(${JSON.stringify(modulePath)})() !== 42) throw 0;`
+  ]), { env: Object.assign({}, process.env, { NODE_DEBUG: 'module' }, env) });
+  assert.strictEqual(result.status, 0, result.stderr.toString());
+  return result.stderr.toString();
+}
+
+const used = `compile cache of ${JSON.stringify(modulePath)} used`;
+
+assert(!run([`--compile-cache=${cacheDir}`]).includes(used));
+assert.strictEqual(fs.readdirSync(cacheDir).length, 1);
+assert(run([`--compile-cache=${cacheDir}`]).includes(used));
+assert(run([], { NODE_COMPILE_CACHE: cacheDir }).includes(used));
+
+// Without the flag, the cache is not used.
+assert(!run([]).includes(used));
+
+// A changed module is compiled without the cache, which is then replaced.
+fs.writeFileSync(modulePath,
+                 'module.exports = function() { return 40 + 2; };\n');
+const time = new Date(Date.now() + 5000);
+fs.utimesSync(modulePath, time, time);
+assert(!run([`--compile-cache=${cacheDir}`]).includes(used));
+assert(run([`--compile-cache=${cacheDir}`]).includes(used));
@@ -0,0 +1,58 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+// --build-resolution-cache writes what the requests of a run resolved to, and
+// --resolution-cache resolves them with that in later runs.
+
+common.refreshTmpDir();
+const cacheFile = path.join(common.tmpDir, 'app.resolutions');
+const pkgDir = path.join(common.tmpDir, 'node_modules', 'pkg');
+const other = path.join(common.tmpDir, 'other.js');
+const appPath = path.join(common.tmpDir, 'app.js');
+fs.mkdirSync(path.join(common.tmpDir, 'node_modules'));
+fs.mkdirSync(pkgDir);
+fs.mkdirSync(path.join(pkgDir, 'lib'));
+fs.writeFileSync(path.join(pkgDir, 'package.json'), '{"main":"lib/main"}');
+fs.writeFileSync(path.join(pkgDir, 'lib', 'main.js'),
+                 'module.exports = "pkg";\n');
+fs.writeFileSync(other, 'module.exports = "other";\n');
+fs.writeFileSync(appPath, 'process.stdout.write(require("pkg"));\n');
+
+function run(args, env) {
+  const result = cp.spawnSync(process.execPath, args.concat([appPath]), {
+    env: Object.assign({}, process.env, env)
+  });
+  assert.strictEqual(result.status, 0, result.stderr.toString());
+  return result.stdout.toString();
+}
+
+assert.strictEqual(run([`--build-resolution-cache=${cacheFile}`]), 'pkg');
+const cache = JSON.parse(fs.readFileSync(cacheFile, 'utf8'));
+const keys = Object.keys(cache.entries).filter((key) => {
+  return key.startsWith('pkg\u0000');
+});
+assert.strictEqual(keys.length, 1);
+assert.strictEqual(cache.entries[keys[0]],
+                   fs.realpathSync(path.join(pkgDir, 'lib', 'main.js')));
+assert.strictEqual(run([`--resolution-cache=${cacheFile}`]), 'pkg');
+
+// The request is resolved with the entry, without looking for the package.
+cache.entries[keys[0]] = other;
+fs.writeFileSync(cacheFile, JSON.stringify(cache));
+assert.strictEqual(run([`--resolution-cache=${cacheFile}`]), 'other');
+assert.strictEqual(run([], { NODE_RESOLUTION_CACHE: cacheFile }), 'other');
+assert.strictEqual(run([]), 'pkg');
+
+// Entries whose file is gone are ignored.
+fs.unlinkSync(other);
+assert.strictEqual(run([`--resolution-cache=${cacheFile}`]), 'pkg');
+
+// So are files of another version.
+cache.version = 'v0.0.0';
+cache.entries[keys[0]] = appPath;
+fs.writeFileSync(cacheFile, JSON.stringify(cache));
+assert.strictEqual(run([`--resolution-cache=${cacheFile}`]), 'pkg');
@@ -0,0 +1,47 @@
+'use strict';
+const common = require('../common');
+
+// With --module-resolution-cache, module lookups that failed keep failing
+// until the cache is cleared.
+
+const assert = require('assert');
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const Module = require('module');
+const path = require('path');
+
+if (process.argv[2] === 'child') {
+  const dir = path.join(common.tmpDir, 'resolution-cache');
+  const file = path.join(dir, 'late.js');
+  const pkgDir = path.join(dir, 'pkg');
+
+  assert.throws(() => require(file), /^Error: Cannot find module/);
+  fs.writeFileSync(file, 'module.exports = "late";');
+  fs.mkdirSync(pkgDir);
+  fs.writeFileSync(path.join(pkgDir, 'package.json'), '{"main":"main.js"}');
+  fs.writeFileSync(path.join(pkgDir, 'main.js'), 'module.exports = "pkg";');
+
+  const cached = process.execArgv.includes('--module-resolution-cache') ||
+                 process.env.NODE_MODULE_RESOLUTION_CACHE === '1';
+  if (cached)
+    assert.throws(() => require(file), /^Error: Cannot find module/);
+  assert.strictEqual(require(pkgDir), 'pkg');
+
+  Module._clearResolutionCache();
+  assert.strictEqual(require(file), 'late');
+  process.stdout.write('ok');
+  return;
+}
+
+function run(execArgv, env) {
+  common.refreshTmpDir();
+  fs.mkdirSync(path.join(common.tmpDir, 'resolution-cache'));
+  const out = execFileSync(process.execPath,
+                           execArgv.concat(__filename, 'child'),
+                           { env: Object.assign({}, process.env, env) });
+  assert.strictEqual(out.toString(), 'ok');
+}
+
+run([], { NODE_MODULE_RESOLUTION_CACHE: '' });
+run(['--module-resolution-cache'], {});
+run([], { NODE_MODULE_RESOLUTION_CACHE: '1' });
@@ -0,0 +1,46 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+if (!common.isLinux) {
+  common.skip('TCP_FASTOPEN and TCP_DEFER_ACCEPT are tested on Linux only');
+  return;
+}
+
+let supported = true;
+let received = '';
+
+const server = net.createServer({ fastOpen: 16, deferAccept: 1 }, (socket) => {
+  socket.setEncoding('utf8');
+  socket.on('data', (data) => received += data);
+  socket.on('end', () => server.close());
+});
+
+server.on('error', (err) => {
+  // Kernels built without TCP Fast Open support.
+  assert.strictEqual(err.code, 'ENOTSUP');
+  supported = false;
+});
+
+server.listen(0, '127.0.0.1', () => {
+  const client = net.connect({
+    port: server.address().port,
+    host: '127.0.0.1',
+    fastOpen: true
+  });
+  client.on('error', (err) => {
+    // TCP_FASTOPEN_CONNECT was added in Linux 4.11.
+    assert.strictEqual(err.code, 'ENOTSUP');
+    supported = false;
+    server.close();
+  });
+  // Written before the connection is established so that it can go out
+  // along with the SYN.
+  client.end('hello');
+});
+
+process.on('exit', () => {
+  if (supported)
+    assert.strictEqual(received, 'hello');
+});
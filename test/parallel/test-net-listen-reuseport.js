@@ -0,0 +1,27 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+if (common.isWindows) {
+  common.skip('SO_REUSEPORT is not supported on Windows');
+  return;
+}
+
+// Two servers can listen on the same port when both ask for SO_REUSEPORT,
+// but a third one that doesn't must still fail with EADDRINUSE.
+const first = net.createServer(common.mustNotCall());
+first.listen({ port: 0, reusePort: true }, common.mustCall(() => {
+  const port = first.address().port;
+  const second = net.createServer(common.mustNotCall());
+  second.listen({ port, reusePort: true }, common.mustCall(() => {
+    assert.strictEqual(second.address().port, port);
+    const third = net.createServer(common.mustNotCall());
+    third.listen({ port }, common.mustNotCall());
+    third.on('error', common.mustCall((err) => {
+      assert.strictEqual(err.code, 'EADDRINUSE');
+      second.close();
+      first.close();
+    }));
+  }));
+}));
@@ -0,0 +1,36 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+const N = 20;
+const BATCH = 8;
+let connections = 0;
+let batches = 0;
+
+const server = net.createServer({ acceptBatch: BATCH }, (socket) => {
+  socket.end();
+  if (++connections === N)
+    server.close();
+});
+
+server.listen(0, common.mustCall(() => {
+  // Every accepted connection is delivered through an array of at most
+  // BATCH client handles.
+  const onconnection = server._handle.onconnection;
+  server._handle.onconnection = function(err, clients) {
+    assert.strictEqual(err, 0);
+    assert(Array.isArray(clients));
+    assert(clients.length > 0 && clients.length <= BATCH);
+    batches++;
+    return onconnection.apply(this, arguments);
+  };
+
+  for (let i = 0; i < N; i++)
+    net.connect(server.address().port).resume();
+}));
+
+process.on('exit', () => {
+  assert.strictEqual(connections, N);
+  assert(batches > 0 && batches <= N);
+});
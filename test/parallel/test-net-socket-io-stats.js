@@ -0,0 +1,40 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+const payload = Buffer.alloc(1024, 'x');
+
+const server = net.createServer(common.mustCall((socket) => {
+  socket.on('data', () => {
+    const stats = socket.getIOStats();
+    assert(stats.reads >= 1);
+    assert(stats.bytesRead > 0);
+  });
+  socket.on('end', common.mustCall(() => {
+    socket.end();
+  }));
+  socket.on('close', common.mustCall(() => {
+    const stats = socket.getIOStats();
+    assert.strictEqual(stats.bytesRead, payload.length);
+    assert.strictEqual(stats.bytesQueued, 0);
+    server.close();
+    assert.strictEqual(server.getIOStats().bytesRead, payload.length);
+  }));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port, common.mustCall(() => {
+    client.end(payload);
+  }));
+  client.resume();
+  client.on('close', common.mustCall(() => {
+    // Still available once the handle is gone.
+    const stats = client.getIOStats();
+    assert.strictEqual(stats.bytesWritten, payload.length);
+    assert.strictEqual(stats.writes, 1);
+    assert.strictEqual(stats.bytesQueued, 0);
+    assert(stats.partialWrites <= stats.writes);
+    assert(stats.blockedTime >= 0);
+  }));
+}));
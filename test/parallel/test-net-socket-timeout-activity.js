@@ -0,0 +1,48 @@
+'use strict';
+const common = require('../common');
+
+// Reads put off the timeout of a socket, which its handle keeps track of,
+// and it fires once they stop. That goes for a timeout set before the socket
+// has a handle too.
+
+const assert = require('assert');
+const net = require('net');
+
+const timeout = common.platformTimeout(200);
+const writes = 10;
+
+const server = net.createServer(common.mustCall((conn) => {
+  let written = 0;
+  const interval = setInterval(() => {
+    conn.write('x');
+    if (++written === writes)
+      clearInterval(interval);
+  }, timeout / 5);
+  conn.on('error', () => {});
+}, 2));
+
+server.listen(0, common.mustCall(() => {
+  const { port } = server.address();
+  let closed = 0;
+
+  function check(client) {
+    let received = 0;
+    client.on('data', (data) => {
+      received += data.length;
+    });
+    client.on('timeout', common.mustCall(() => {
+      assert.strictEqual(received, writes);
+      client.destroy();
+      if (++closed === 2)
+        server.close();
+    }));
+  }
+
+  const first = net.connect(port);
+  first.setTimeout(timeout);
+  assert.strictEqual(first._idleTimeout, -1);
+  check(first);
+
+  const second = net.connect({ port, timeout });
+  check(second);
+}));
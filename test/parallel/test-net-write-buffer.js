@@ -0,0 +1,63 @@
+'use strict';
+const common = require('../common');
+
+// socket.write(buffer) calls handle.writeBuffer() without a request object,
+// which is only created in C++ once a write has to wait, over TCP, pipes and
+// TLS.
+
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+
+const chunks = [Buffer.from('hello '), Buffer.alloc(1024 * 1024, 'x'),
+                Buffer.from(' world')];
+const expected = Buffer.concat(chunks);
+
+function writeTo(socket) {
+  for (const chunk of chunks)
+    socket.write(chunk, common.mustCall());
+  socket.end();
+}
+
+function readFrom(socket, done) {
+  const received = [];
+  socket.on('data', (data) => received.push(data));
+  socket.on('end', common.mustCall(() => {
+    assert(Buffer.concat(received).equals(expected));
+    done();
+  }));
+}
+
+function testNet(listenArg) {
+  const server = net.createServer(common.mustCall((socket) => {
+    readFrom(socket, () => server.close());
+  }));
+  server.listen(listenArg, common.mustCall(() => {
+    const address = server.address();
+    const client = net.connect(
+      typeof address === 'string' ? address : address.port);
+    client.on('connect', common.mustCall(() => writeTo(client)));
+  }));
+}
+
+testNet(0);
+
+common.refreshTmpDir();
+testNet(common.PIPE);
+
+if (common.hasCrypto) {
+  const tls = require('tls');
+  const options = {
+    key: fs.readFileSync(`${common.fixturesDir}/keys/agent1-key.pem`),
+    cert: fs.readFileSync(`${common.fixturesDir}/keys/agent1-cert.pem`)
+  };
+  const server = tls.createServer(options, common.mustCall((socket) => {
+    readFrom(socket, () => server.close());
+  }));
+  server.listen(0, common.mustCall(() => {
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false
+    }, common.mustCall(() => writeTo(client)));
+  }));
+}
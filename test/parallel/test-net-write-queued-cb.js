@@ -0,0 +1,38 @@
+'use strict';
+const common = require('../common');
+
+// Writes that can't complete right away, because the other side doesn't
+// read yet, are queued by the handle without a request object. Their
+// callbacks still run once the data is out.
+
+const assert = require('assert');
+const net = require('net');
+
+const chunk = Buffer.alloc(1024 * 1024, 'x');
+const writes = 16;
+
+const server = net.createServer(common.mustCall((conn) => {
+  let received = 0;
+  conn.pause();
+  setTimeout(() => conn.resume(), common.platformTimeout(50));
+  conn.on('data', (data) => {
+    received += data.length;
+  });
+  conn.on('end', common.mustCall(() => {
+    assert.strictEqual(received, chunk.length * writes + 5);
+    server.close();
+  }));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port);
+  let done = 0;
+  const onWrite = common.mustCall((err) => {
+    assert.ifError(err);
+    if (++done === writes + 1)
+      client.end();
+  }, writes + 1);
+  for (let i = 0; i < writes; i++)
+    client.write(chunk, onWrite);
+  client.write('hello', 'latin1', onWrite);
+}));
@@ -0,0 +1,39 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+// Buffer and string writes are dispatched without a request object. Make
+// sure that callbacks still fire once, in order, whether the write completed
+// synchronously or had to be queued.
+const { streamBaseState } = process.binding('stream_wrap');
+assert(streamBaseState instanceof Float64Array);
+
+const small = 'x'.repeat(16);
+const large = Buffer.alloc(4 * 1024 * 1024, 'y');
+const writes = [small, large, small, large.toString('latin1'), small];
+const expected = writes.reduce((n, w) => n + Buffer.byteLength(w, 'latin1'), 0);
+let received = 0;
+
+const server = net.createServer((socket) => {
+  socket.on('data', (data) => received += data.length);
+  socket.on('end', common.mustCall(() => {
+    assert.strictEqual(received, expected);
+    server.close();
+  }));
+});
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port, common.mustCall(() => {
+    let next = 0;
+    writes.forEach((chunk, i) => {
+      client.write(chunk, 'latin1', common.mustCall(() => {
+        assert.strictEqual(next++, i);
+        if (i === writes.length - 1) {
+          assert.strictEqual(client.bytesWritten, expected);
+          client.end();
+        }
+      }));
+    });
+  }));
+}));
@@ -0,0 +1,33 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+
+// The queue is made of buffers of 2048 ticks. Queue enough ticks to fill
+// several of them, while more ticks are queued as it drains and one of the
+// ticks throws, and check that all of them run once and in order.
+
+const count = 10000;
+const order = [];
+
+process.once('uncaughtException', common.mustCall((err) => {
+  assert.strictEqual(err.message, 'tick 5000');
+}));
+
+for (let i = 0; i < count; i++) {
+  process.nextTick((n) => {
+    order.push(n);
+    if (n % 1000 === 0)
+      process.nextTick(() => order.push(`nested ${n}`));
+    if (n === 5000)
+      throw new Error('tick 5000');
+  }, i);
+}
+
+process.on('exit', () => {
+  const expected = [];
+  for (let i = 0; i < count; i++)
+    expected.push(i);
+  for (let i = 0; i < count; i += 1000)
+    expected.push(`nested ${i}`);
+  assert.deepStrictEqual(order, expected);
+});
@@ -0,0 +1,49 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const os = require('os');
+
+const cpus = os.cpus().length;
+
+const stats = os.stats();
+assert.ok(stats instanceof Float64Array);
+assert.strictEqual(stats[9], cpus);
+assert.strictEqual(stats.length, 10 + 6 * cpus);
+
+assert.ok(stats[3] > 0);
+assert.ok(stats[3] <= stats[4]);
+assert.ok(stats[5] > 0);
+assert.ok(stats[6] > 0);
+assert.ok(stats[7] >= 0);
+if (!common.isWindows)
+  assert.ok(stats[0] >= 0);
+
+function checkUtilization(stats) {
+  assert.ok(stats[8] >= 0 && stats[8] <= 1, stats[8]);
+  for (let i = 0; i < stats[9]; i++) {
+    const cpu = 10 + 6 * i;
+    for (let j = 0; j < 5; j++)
+      assert.ok(stats[cpu + j] >= 0);
+    assert.ok(stats[cpu + 5] >= 0 && stats[cpu + 5] <= 1, stats[cpu + 5]);
+  }
+}
+checkUtilization(stats);
+
+// The array that is passed in is filled in and returned again.
+const user = stats[6];
+for (let i = 0; i < 1e6; i++);
+assert.strictEqual(os.stats(stats), stats);
+assert.ok(stats[6] >= user);
+checkUtilization(stats);
+
+// An array of the wrong length is not filled in.
+const short = new Float64Array(1);
+const fresh = os.stats(short);
+assert.notStrictEqual(fresh, short);
+assert.strictEqual(short[0], 0);
+assert.strictEqual(fresh.length, stats.length);
+
+[null, 0, 'stats', [], new Float32Array(stats.length)].forEach((value) => {
+  assert.throws(() => os.stats(value),
+                /^TypeError: "previous" argument must be a Float64Array$/);
+});
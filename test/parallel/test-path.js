@@ -415,6 +415,14 @@ assert.strictEqual(path.posix.normalize('a//b//./c'), 'a/b/c');
 assert.strictEqual(path.posix.normalize('a//b//.'), 'a/b');
 assert.strictEqual(path.posix.normalize('/a/b/c/../../../x/y/z'), '/x/y/z');
 assert.strictEqual(path.posix.normalize('///..//./foo/.//bar'), '/foo/bar');
+assert.strictEqual(path.posix.normalize('/a/b/'), '/a/b/');
+assert.strictEqual(path.posix.normalize('./'), './');
+assert.strictEqual(path.posix.normalize('/\u00e9t\u00e9/../caf\u00e9/.'),
+                   '/caf\u00e9');
+assert.strictEqual(path.posix.normalize('\u6587\u4ef6//./\u5939/'),
+                   '\u6587\u4ef6/\u5939/');
+assert.strictEqual(path.win32.normalize('c:\\\u6587\u4ef6\\..\\\u5939'),
+                   'c:\\\u5939');
 
 
 // path.resolve tests
@@ -0,0 +1,140 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const child_process = require('child_process');
+const fs = require('fs');
+const http = require('http');
+const path = require('path');
+
+const counters = process.counters;
+assert.strictEqual(counters.file, undefined);
+
+// User defined counters and gauges.
+{
+  const jobs = counters.counter('test.jobs');
+  assert.strictEqual(jobs.name, 'test.jobs');
+  assert.strictEqual(jobs.value, 0);
+  jobs.add();
+  jobs.add(2.5);
+  assert.strictEqual(jobs.value, 3.5);
+  assert.strictEqual(counters.counter('test.jobs'), jobs);
+  assert.throws(() => jobs.add(-1), RangeError);
+  assert.throws(() => jobs.add('1'), RangeError);
+  assert.throws(() => jobs.add(Infinity), RangeError);
+
+  const queued = counters.gauge('test.queued');
+  queued.add(5);
+  queued.add(-2);
+  assert.strictEqual(queued.value, 3);
+  queued.set(10);
+  assert.strictEqual(queued.value, 10);
+  assert.throws(() => queued.add(NaN), TypeError);
+  assert.throws(() => queued.set('1'), TypeError);
+
+  const snapshot = counters.snapshot();
+  assert.strictEqual(snapshot['test.jobs'], 3.5);
+  assert.strictEqual(snapshot['test.queued'], 10);
+
+  assert.throws(() => counters.gauge('test.jobs'), TypeError);
+  assert.throws(() => counters.counter('test.queued'), TypeError);
+  assert.throws(() => counters.gauge('fs.operations'), TypeError);
+  for (const name of ['', 'a b', 'x'.repeat(60), 1, undefined])
+    assert.throws(() => counters.counter(name), TypeError);
+  counters.counter('x'.repeat(59));
+}
+
+// The core counters.
+{
+  const before = counters.snapshot();
+  for (const name of ['net.server.connections', 'net.server.connections.open',
+                      'net.bytes.read', 'net.bytes.written',
+                      'pipe.bytes.read', 'pipe.bytes.written',
+                      'http.server.requests', 'http.server.responses',
+                      'http.client.requests', 'http.client.responses',
+                      'fs.operations', 'threadpool.queued',
+                      'threadpool.completed', 'threadpool.pending',
+                      'threadpool.running']) {
+    assert.strictEqual(typeof before[name], 'number', name);
+  }
+
+  fs.statSync(__filename);
+  assert.strictEqual(counters.snapshot()['fs.operations'],
+                     before['fs.operations'] + 1);
+
+  const server = http.createServer(common.mustCall((req, res) => {
+    const during = counters.snapshot();
+    assert.strictEqual(during['net.server.connections.open'],
+                       before['net.server.connections.open'] + 1);
+    res.end('ok');
+  }));
+  server.listen(0, common.mustCall(() => {
+    http.get({
+      port: server.address().port,
+      agent: false
+    }, common.mustCall((res) => {
+      res.resume();
+      res.on('end', common.mustCall(() => {
+        server.close(common.mustCall(() => {
+          const after = counters.snapshot();
+          for (const name of ['net.server.connections',
+                              'http.server.requests',
+                              'http.server.responses',
+                              'http.client.requests',
+                              'http.client.responses']) {
+            assert.strictEqual(after[name], before[name] + 1, name);
+          }
+          assert.strictEqual(after['net.server.connections.open'],
+                             before['net.server.connections.open']);
+          assert(after['net.bytes.read'] > before['net.bytes.read']);
+          assert(after['net.bytes.written'] > before['net.bytes.written']);
+        }));
+      }));
+    }));
+  }));
+}
+
+// Another process can read the values from the file.
+{
+  common.refreshTmpDir();
+  const file = path.join(common.tmpDir, 'counters');
+  const script = 'process.counters.counter("test.file").add(42);' +
+                 'process.counters.gauge("test.gauge").set(-7);' +
+                 'console.log(process.counters.file);';
+  child_process.execFile(process.execPath,
+                         ['--counters-file=' + file, '-e', script],
+                         common.mustCall((err, stdout) => {
+                           assert.ifError(err);
+                           assert.strictEqual(stdout, file + '\n');
+                           checkFile(fs.readFileSync(file));
+                         }));
+
+  function checkFile(data) {
+    assert.strictEqual(data.toString('latin1', 0, 8), 'NODECNTR');
+    const le = require('os').endianness() === 'LE';
+    const u32 = (le ? data.readUInt32LE : data.readUInt32BE).bind(data);
+    const f64 = (le ? data.readDoubleLE : data.readDoubleBE).bind(data);
+    assert.strictEqual(u32(8), 1);
+    const capacity = u32(12);
+    const shards = u32(16);
+    const count = u32(20);
+    const namesOffset = u32(32);
+    const valuesOffset = u32(40);
+    assert.strictEqual(data.length, valuesOffset + 8 * capacity * shards);
+
+    const values = {};
+    for (let i = 0; i < count; i++) {
+      const entry = namesOffset + 64 * i;
+      const type = u32(entry);
+      assert(type === 1 || type === 2);
+      const end = data.indexOf(0, entry + 4);
+      const name = data.toString('latin1', entry + 4, end);
+      let value = 0;
+      for (let shard = 0; shard < shards; shard++)
+        value += f64(valuesOffset + 8 * (capacity * shard + i));
+      values[name] = value;
+    }
+    assert.strictEqual(values['test.file'], 42);
+    assert.strictEqual(values['test.gauge'], -7);
+    assert.strictEqual(typeof values['net.server.connections'], 'number');
+  }
+}
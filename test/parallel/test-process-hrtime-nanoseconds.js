@@ -0,0 +1,32 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+
+const ns = process.hrtime.nanoseconds();
+assert.strictEqual(typeof ns, 'number');
+assert.ok(ns > 0);
+assert.ok(Number.isSafeInteger(ns));
+
+const ms = process.hrtime.now();
+assert.strictEqual(typeof ms, 'number');
+assert.ok(ms >= ns / 1e6);
+
+// It ticks along with process.hrtime().
+const before = process.hrtime();
+const nsBefore = process.hrtime.nanoseconds();
+const start = Date.now();
+while (Date.now() - start < 20);
+const nsElapsed = process.hrtime.nanoseconds() - nsBefore;
+const diff = process.hrtime(before);
+assert.ok(nsElapsed >= 15e6);
+assert.ok(nsElapsed <= diff[0] * 1e9 + diff[1]);
+
+// It is monotonic.
+let last = process.hrtime.now();
+for (let i = 0; i < 1000; i++) {
+  const now = process.hrtime.now();
+  assert.ok(now >= last);
+  last = now;
+}
+
+assert.strictEqual(process._hrtimeNanoseconds, undefined);
@@ -0,0 +1,45 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+
+// The event loop is only measured from the first call on.
+const initial = process.loopMetrics();
+assert.strictEqual(initial.iterations, 0);
+assert.strictEqual(initial.lag.count, 0);
+assert.deepStrictEqual(Object.keys(initial.lag.percentiles),
+                       ['50', '75', '90', '99', '99.9']);
+
+function busyWait(ms) {
+  const start = Date.now();
+  while (Date.now() - start < ms);
+}
+
+// Wait for a while, and then block the loop for a while.
+setTimeout(common.mustCall(() => {
+  busyWait(100);
+  setTimeout(common.mustCall(() => {
+    const metrics = process.loopMetrics();
+    assert(metrics.elapsedTime >= 300);
+    assert(metrics.iterations > 0);
+    assert(metrics.idleTime > 100);
+    assert(metrics.idleTime <= metrics.pollTime);
+    assert(metrics.callbackTime >= 100);
+    assert(metrics.maxIterationTime >= 100);
+    assert(metrics.utilization > 0 && metrics.utilization < 1);
+
+    const lag = metrics.lag;
+    assert(lag.count > 0);
+    assert(lag.min <= lag.mean && lag.mean <= lag.max);
+    // The timer that was due while the loop was blocked ran late.
+    assert(lag.max >= 50);
+    assert(lag.percentiles[50] <= lag.percentiles[99.9]);
+    assert(lag.percentiles[99.9] <= lag.max);
+
+    process.resetLoopMetrics();
+    const reset = process.loopMetrics();
+    assert.strictEqual(reset.iterations, 0);
+    assert.strictEqual(reset.maxIterationTime, 0);
+    assert.strictEqual(reset.lag.count, 0);
+    assert(reset.elapsedTime < metrics.elapsedTime);
+  }), 50);
+}), 200);
@@ -0,0 +1,50 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const fs = require('fs');
+
+const keys = [
+  'userCPUTime',
+  'systemCPUTime',
+  'maxRSS',
+  'sharedMemorySize',
+  'unsharedDataSize',
+  'unsharedStackSize',
+  'minorPageFault',
+  'majorPageFault',
+  'swappedOut',
+  'fsRead',
+  'fsWrite',
+  'ipcSent',
+  'ipcReceived',
+  'signalsCount',
+  'voluntaryContextSwitches',
+  'involuntaryContextSwitches'
+];
+
+const before = process.resourceUsage();
+assert.deepStrictEqual(Object.keys(before), keys);
+for (const key of keys) {
+  assert(Number.isInteger(before[key]) && before[key] >= 0,
+         `${key} is ${before[key]}`);
+}
+assert(before.maxRSS > 0);
+
+// Spin the CPU and touch the file system, so that the counters move.
+const start = Date.now();
+while (Date.now() - start < 50);
+fs.readFileSync(__filename);
+
+const after = process.resourceUsage();
+for (const key of keys) {
+  if (key !== 'maxRSS')
+    assert(after[key] >= before[key], `${key} went down`);
+}
+assert(after.userCPUTime + after.systemCPUTime >
+       before.userCPUTime + before.systemCPUTime);
+
+// The CPU times are those of process.cpuUsage().
+const cpu = process.cpuUsage();
+const usage = process.resourceUsage();
+assert(usage.userCPUTime >= cpu.user);
+assert(usage.systemCPUTime >= cpu.system);
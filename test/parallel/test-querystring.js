@@ -263,6 +263,19 @@ assert.strictEqual('foo=3', qs.stringify({ foo: 3 }));
 assert.strictEqual('foo=-72.42', qs.stringify({ foo: -72.42 }));
 assert.strictEqual('foo=', qs.stringify({ foo: NaN }));
 assert.strictEqual('foo=', qs.stringify({ foo: Infinity }));
+assert.strictEqual('foo=1e%2B21', qs.stringify({ foo: 1e21 }));
+
+// an empty array still leaves its separator
+assert.strictEqual('a=1&', qs.stringify({ a: 1, b: [] }));
+
+// proxied arrays are arrays
+assert.strictEqual('a=1&a=b%20c',
+                   qs.stringify({ a: new Proxy([1, 'b c'], {}) }));
+
+// separators outside Latin-1
+assert.strictEqual('a\u2192b\u20acc\u2192d',
+                   qs.stringify({ a: 'b', c: 'd' }, '\u20ac', '\u2192'));
+check(qs.parse('a\u2192b\u20acc', '\u20ac', '\u2192'), { a: 'b', c: '' });
 
 // nested
 {
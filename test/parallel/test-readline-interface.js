@@ -222,6 +222,23 @@ function isWarned(emitter) {
   assert.strictEqual(callCount, expectedLines.length);
   rli.close();
 
+  // Buffers split anywhere, within characters and \r\n too, make the same
+  // lines.
+  {
+    const input = Buffer.from('foo\r\nb\u00e4r\n\n\u20ac\rbaz\r\n\ud83d\ude00');
+    const expected = ['foo', 'b\u00e4r', '', '\u20ac', 'baz', '\ud83d\ude00'];
+    for (let size = 1; size <= input.length; size++) {
+      fi = new FakeInput();
+      rli = new readline.Interface({ input: fi, output: fi, terminal: false });
+      const lines = [];
+      rli.on('line', (line) => lines.push(line));
+      for (let i = 0; i < input.length; i += size)
+        fi.emit('data', input.slice(i, i + size));
+      fi.emit('end');
+      assert.deepStrictEqual(lines, expected);
+    }
+  }
+
   // \r should behave like \n when alone
   fi = new FakeInput();
   rli = new readline.Interface({ input: fi, output: fi, terminal: true });
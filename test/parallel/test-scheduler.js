@@ -0,0 +1,60 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const scheduler = require('scheduler');
+
+assert.strictEqual(scheduler.getSliceTime(), 10);
+assert.throws(() => scheduler.postTask(), TypeError);
+assert.throws(() => scheduler.postTask(() => {}, { priority: 'urgent' }),
+              TypeError);
+assert.throws(() => scheduler.postTask(() => {}, { deadline: -1 }),
+              TypeError);
+assert.throws(() => scheduler.setSliceTime(0), TypeError);
+scheduler.setSliceTime(5);
+
+const order = [];
+
+// Posted first, but runs after everything of a higher priority.
+let steps = 0;
+const long = scheduler.postTask(common.mustCall((slice) => {
+  assert.strictEqual(slice.didTimeout, false);
+  // Use up the slice, so that the loop gets to run the timer in between.
+  while (slice.timeRemaining() > 0);
+  order.push(`low ${steps}`);
+  return ++steps < 3;
+}, 3), { priority: 'low' });
+assert.strictEqual(long.pending, true);
+
+scheduler.postTask(common.mustCall(() => order.push('normal')));
+scheduler.postTask(common.mustCall(() => order.push('high, later')),
+                   { priority: 'high', deadline: 1000 });
+scheduler.postTask(common.mustCall(() => order.push('high, sooner')),
+                   { priority: 'high', deadline: 500 });
+scheduler.postTask(common.mustNotCall()).cancel();
+
+scheduler.postTask(common.mustCall((slice) => {
+  assert.strictEqual(slice.didTimeout, true);
+}), { deadline: 0 });
+
+const self = scheduler.postTask(common.mustCall(() => {
+  self.cancel();
+  return true;
+}));
+
+setTimeout(common.mustCall(() => order.push('timeout')), 1);
+
+process.on('exit', () => {
+  assert.deepStrictEqual(order.filter((entry) => entry !== 'timeout'), [
+    'high, sooner', 'high, later', 'normal', 'low 0', 'low 1', 'low 2'
+  ]);
+  // The timer ran while the low priority task was still going.
+  assert.ok(order.indexOf('timeout') < order.indexOf('low 2'));
+
+  const stats = scheduler.getStats();
+  assert.strictEqual(stats.pending, 0);
+  assert.strictEqual(stats.runs, 8);
+  assert.strictEqual(stats.completed, 5);
+  assert.strictEqual(stats.overdue, 1);
+  assert.ok(stats.slices >= 3);
+  assert.strictEqual(long.pending, false);
+});
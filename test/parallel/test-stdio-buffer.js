@@ -0,0 +1,52 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { spawn, spawnSync } = require('child_process');
+
+if (process.argv[2] === 'child') {
+  const line = 'x'.repeat(99) + '\n';
+  for (let i = 0; i < 20000; i++)
+    process.stdout.write(line);
+  const stats = process.stdout.getBufferStats();
+  assert.strictEqual(stats.bytesDropped, 0);
+  assert.ok(stats.capacity >= 1024 * 1024);
+  process.on('exit', () => {
+    // Written out although the process is exiting.
+    console.error(JSON.stringify(process.stdout.getBufferStats()));
+  });
+  return;
+}
+
+{
+  const child = spawn(process.execPath,
+                      ['--stdio-buffer=grow', __filename, 'child']);
+  let stdout = 0;
+  let stderr = '';
+  child.stdout.on('data', (chunk) => stdout += chunk.length);
+  child.stderr.setEncoding('utf8');
+  child.stderr.on('data', (chunk) => stderr += chunk);
+  child.on('close', common.mustCall((code) => {
+    assert.strictEqual(code, 0, stderr);
+    assert.strictEqual(stdout, 20000 * 100);
+    const stats = JSON.parse(stderr);
+    assert.strictEqual(stats.bytesWritten, 20000 * 100);
+    assert.strictEqual(stats.bytesBuffered, 0);
+    assert.ok(stats.maxBytesBuffered > 0);
+  }));
+}
+
+{
+  const child = spawnSync(process.execPath,
+                          ['--stdio-buffer=block', '-e', 'console.log("ok")']);
+  assert.strictEqual(child.status, 0);
+  assert.strictEqual(child.stdout.toString(), 'ok\n');
+}
+
+{
+  const child = spawnSync(process.execPath,
+                          ['--stdio-buffer=sometimes', '-e', '0']);
+  assert.strictEqual(child.status, 9);
+  assert.ok(/--stdio-buffer must be drop, block or grow/.test(child.stderr));
+}
+
+assert.strictEqual(process.stdout.getBufferStats, undefined);
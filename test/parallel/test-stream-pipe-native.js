@@ -0,0 +1,81 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+const path = require('path');
+const StreamPipe = process.binding('stream_pipe').StreamPipe;
+
+// Data moved by a native StreamPipe must arrive complete and in order, both
+// from another stream and from a file. Large payloads make the pipe pause
+// and resume its source.
+
+const payload = Buffer.alloc(4 * 1024 * 1024);
+for (let i = 0; i < payload.length; i++)
+  payload[i] = i % 251;
+
+const file = path.join(common.fixturesDir, 'elipses.txt');
+const fileContents = fs.readFileSync(file);
+
+function collect(onDone) {
+  const server = net.createServer(common.mustCall((socket) => {
+    const chunks = [];
+    socket.on('data', (chunk) => chunks.push(chunk));
+    socket.on('end', common.mustCall(() => {
+      server.close();
+      onDone(Buffer.concat(chunks));
+    }));
+  }));
+  return server;
+}
+
+// Stream to stream.
+{
+  const source = net.createServer(common.mustCall((socket) => {
+    socket.end(payload);
+    source.close();
+  }));
+
+  const sink = collect(common.mustCall((data) => {
+    assert.strictEqual(data.length, payload.length);
+    assert(data.equals(payload));
+  }));
+
+  source.listen(0, common.mustCall(() => {
+    sink.listen(0, common.mustCall(() => {
+      const input = net.connect(source.address().port, common.mustCall(() => {
+        input.pause();
+        const output = net.connect(sink.address().port, common.mustCall(() => {
+          const pipe = new StreamPipe(output._handle._externalStream);
+          pipe.onunpipe = common.mustCall((status) => {
+            assert.strictEqual(status, 0);
+            output.end();
+            input.destroy();
+          });
+          const stream = input._handle._externalStream;
+          assert.strictEqual(pipe.fromStream(stream), 0);
+        }));
+      }));
+    }));
+  }));
+}
+
+// File to stream.
+{
+  const sink = collect(common.mustCall((data) => {
+    assert(data.equals(fileContents));
+  }));
+
+  sink.listen(0, common.mustCall(() => {
+    const output = net.connect(sink.address().port, common.mustCall(() => {
+      const fd = fs.openSync(file, 'r');
+      const pipe = new StreamPipe(output._handle._externalStream);
+      pipe.onunpipe = common.mustCall((status) => {
+        assert.strictEqual(status, 0);
+        fs.closeSync(fd);
+        output.end();
+      });
+      assert.strictEqual(pipe.fromFile(fd, 0, -1), 0);
+    }));
+  }));
+}
@@ -0,0 +1,61 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { Readable } = require('stream');
+
+// A single 'data' listener is called directly, but everything that emit()
+// would do still happens.
+
+function createStream() {
+  const r = new Readable({ read() {} });
+  process.nextTick(() => {
+    r.push('a');
+    r.push('b');
+    r.push(null);
+  });
+  return r;
+}
+
+{
+  const r = createStream();
+  const chunks = [];
+  r.on('data', common.mustCall(function(chunk) {
+    assert.strictEqual(this, r);
+    chunks.push(chunk.toString());
+  }, 2));
+  r.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(chunks, ['a', 'b']);
+  }));
+}
+
+// More than one listener.
+{
+  const r = createStream();
+  r.on('data', common.mustCall(2));
+  r.on('data', common.mustCall(2));
+}
+
+// A once() listener only sees the first chunk.
+{
+  const r = createStream();
+  r.once('data', common.mustCall((chunk) => {
+    assert.strictEqual(chunk.toString(), 'a');
+  }));
+  r.resume();
+}
+
+// emit() overridden on the instance still sees every 'data' event.
+{
+  const r = createStream();
+  const emit = r.emit;
+  const events = [];
+  r.emit = function(type, ...args) {
+    if (type === 'data')
+      events.push(args[0].toString());
+    return emit.call(this, type, ...args);
+  };
+  r.on('data', common.mustCall(2));
+  r.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(events, ['a', 'b']);
+  }));
+}
@@ -0,0 +1,90 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const Readable = require('stream').Readable;
+
+// A flowing stream with nothing buffered hands pushed Buffers to the 'data'
+// listener right away, and calls _read() again for the next one.
+{
+  const chunks = [];
+  let reads = 0;
+  const r = new Readable({
+    read() {
+      reads++;
+    }
+  });
+  r.on('data', (chunk) => chunks.push(chunk));
+  r.on('end', common.mustCall(() => {
+    // 'b' was put back once, and is seen twice.
+    assert.strictEqual(Buffer.concat(chunks).toString(), 'abbc');
+  }));
+
+  setImmediate(() => {
+    const before = reads;
+    assert.strictEqual(r.push(Buffer.from('a')), true);
+    assert.deepStrictEqual(chunks, [Buffer.from('a')]);
+    assert.strictEqual(reads, before + 1);
+    assert.strictEqual(r._readableState.reading, true);
+    assert.strictEqual(r._readableState.needReadable, true);
+
+    // A listener that puts data back leaves it for read(0) to deal with.
+    r.once('data', (chunk) => {
+      r.pause();
+      r.unshift(chunk);
+      setImmediate(() => {
+        assert.strictEqual(r._readableState.length, 1);
+        r.resume();
+        setImmediate(() => {
+          r.push(Buffer.from('c'));
+          r.push(null);
+        });
+      });
+    });
+    r.push(Buffer.from('b'));
+  });
+}
+
+// Pausing from the listener stops the flow, and what is pushed next is
+// buffered up to the highWaterMark.
+{
+  let i = 0;
+  const r = new Readable({
+    highWaterMark: 4,
+    read() {
+      if (i < 8)
+        setImmediate(() => this.push(Buffer.from([i++])));
+      else
+        this.push(null);
+    }
+  });
+  const received = [];
+  r.on('data', common.mustCall((chunk) => {
+    received.push(chunk[0]);
+    if (received.length === 2) {
+      r.pause();
+      setTimeout(() => {
+        assert(r._readableState.length <= 4);
+        assert(r._readableState.length > 0);
+        r.resume();
+      }, common.platformTimeout(50));
+    }
+  }, 8));
+  r.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(received, [0, 1, 2, 3, 4, 5, 6, 7]);
+  }));
+}
+
+// Decoded and object mode streams keep going through the general path.
+{
+  const r = new Readable({ read() {}, encoding: 'utf8' });
+  const euro = Buffer.from('€');
+  let text = '';
+  r.on('data', (chunk) => text += chunk);
+  r.on('end', common.mustCall(() => assert.strictEqual(text, '€€')));
+  setImmediate(() => {
+    r.push(euro.slice(0, 1));
+    r.push(euro.slice(1));
+    r.push(euro);
+    r.push(null);
+  });
+}
@@ -124,6 +124,39 @@ assert.strictEqual(decoder.write(Buffer.from('3DD8', 'hex')), '');
 assert.strictEqual(decoder.write(Buffer.from('4D', 'hex')), '');
 assert.strictEqual(decoder.end(), '\ud83d');
 
+// The carried-over character is visible as lastNeed, lastTotal and lastChar
+decoder = new StringDecoder('utf8');
+assert.strictEqual(decoder.write(Buffer.from('E282', 'hex')), '');
+assert.strictEqual(decoder.lastNeed, 1);
+assert.strictEqual(decoder.lastTotal, 3);
+assert.deepStrictEqual(decoder.lastChar.slice(0, 2),
+                       Buffer.from('E282', 'hex'));
+assert.strictEqual(decoder.write(Buffer.from('AC', 'hex')), '€');
+assert.strictEqual(decoder.lastNeed, 0);
+assert.strictEqual(new StringDecoder('hex').lastNeed, undefined);
+
+// A carried-over character is completed by a chunk that ends in another one
+decoder = new StringDecoder('utf16le');
+assert.strictEqual(decoder.write(Buffer.from('41', 'hex')), '');
+assert.strictEqual(decoder.write(Buffer.from('0042', 'hex')), 'A');
+assert.strictEqual(decoder.end(Buffer.from('00', 'hex')), 'B');
+
+decoder = new StringDecoder('base64');
+assert.strictEqual(decoder.write(Buffer.from('ab')), '');
+assert.strictEqual(decoder.write(Buffer.from('cde')), 'YWJj');
+assert.strictEqual(decoder.end(), 'ZGU=');
+
+// Uint8Arrays and strings can be written, too
+decoder = new StringDecoder('utf8');
+assert.strictEqual(decoder.write(new Uint8Array([0xE2, 0x82])), '');
+assert.strictEqual(decoder.write(new Uint8Array([0xAC, 0x41])), '€A');
+assert.strictEqual(decoder.write('abc'), 'abc');
+assert.strictEqual(decoder.end(), '');
+
+assert.throws(() => {
+  new StringDecoder('utf8').write(null);
+}, /^TypeError: "buf" argument must be a Buffer or Uint8Array$/);
+
 assert.throws(() => {
   new StringDecoder(1);
 }, /^Error: Unknown encoding: 1$/);
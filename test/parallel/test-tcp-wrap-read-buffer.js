@@ -0,0 +1,43 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+// With setReadBuffer(), reads land in the supplied buffer and onread()
+// receives the offset of the data instead of a new Buffer.
+
+const payload = Buffer.from('0123456789abcdef');
+const readBuffer = Buffer.alloc(10);
+
+const server = net.createServer(common.mustCall((socket) => {
+  socket.end(payload);
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port, common.mustCall(() => {
+    const handle = client._handle;
+    const chunks = [];
+    let expectedOffset = 0;
+    const onEnd = common.mustCall(() => {
+      assert.strictEqual(Buffer.concat(chunks).toString(),
+                         payload.toString());
+      client.destroy();
+      server.close();
+    });
+
+    handle.setReadBuffer(readBuffer);
+    handle.onread = (nread, offset) => {
+      if (nread < 0)
+        return onEnd();
+      assert.strictEqual(typeof offset, 'number');
+      // Reads continue where the previous one stopped, and start over at
+      // the front once the buffer is full.
+      if (expectedOffset === readBuffer.length)
+        expectedOffset = 0;
+      assert.strictEqual(offset, expectedOffset);
+      assert(offset + nread <= readBuffer.length);
+      chunks.push(Buffer.from(readBuffer.slice(offset, offset + nread)));
+      expectedOffset = offset + nread;
+    };
+  }));
+}));
@@ -0,0 +1,41 @@
+'use strict';
+const common = require('../common');
+if (common.isWindows) {
+  common.skip('sendFile() is not supported on Windows');
+  return;
+}
+
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+const path = require('path');
+const { UV_ECANCELED } = process.binding('uv');
+const WriteWrap = process.binding('stream_wrap').WriteWrap;
+
+// A transfer to a peer that doesn't read waits on the loop for the socket to
+// become writable, and closing the socket then cancels it.
+
+common.refreshTmpDir();
+const file = path.join(common.tmpDir, 'sendfile-cancel.bin');
+fs.writeFileSync(file, Buffer.alloc(64 * 1024 * 1024));
+
+const server = net.createServer(common.mustCall((socket) => {
+  const fd = fs.openSync(file, 'r');
+  const req = new WriteWrap();
+  req.oncomplete = common.mustCall((status, sent) => {
+    assert.strictEqual(status, UV_ECANCELED);
+    assert(sent > 0);
+    fs.closeSync(fd);
+    server.close();
+  });
+  assert.strictEqual(
+    socket._handle.sendFile(req, fd, 0, 64 * 1024 * 1024), 0);
+  setTimeout(() => socket.destroy(), common.platformTimeout(200));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port);
+  client.pause();
+  client.on('error', () => {});
+  server.on('close', () => client.destroy());
+}));
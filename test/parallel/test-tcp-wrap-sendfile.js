@@ -0,0 +1,56 @@
+'use strict';
+const common = require('../common');
+if (common.isWindows) {
+  common.skip('sendFile() is not supported on Windows');
+  return;
+}
+
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+const path = require('path');
+const WriteWrap = process.binding('stream_wrap').WriteWrap;
+
+// sendFile() moves a file range to a socket and reports completion, and the
+// progress of transfers that span more than one chunk, with the number of
+// bytes sent so far.
+
+common.refreshTmpDir();
+const file = path.join(common.tmpDir, 'sendfile.bin');
+const contents = Buffer.alloc(9 * 1024 * 1024);
+for (let i = 0; i < contents.length; i++)
+  contents[i] = i % 253;
+fs.writeFileSync(file, contents);
+
+const offset = 1000;
+const length = contents.length - 2 * offset;
+const expected = contents.slice(offset, offset + length);
+
+const server = net.createServer(common.mustCall((socket) => {
+  const fd = fs.openSync(file, 'r');
+  const req = new WriteWrap();
+  let lastProgress = 0;
+  req.onprogress = (sent) => {
+    assert(sent > lastProgress);
+    assert(sent < length);
+    lastProgress = sent;
+  };
+  req.oncomplete = common.mustCall((status, sent) => {
+    assert.strictEqual(status, 0);
+    assert.strictEqual(sent, length);
+    assert(lastProgress > 0);
+    fs.closeSync(fd);
+    socket.end();
+  });
+  assert.strictEqual(socket._handle.sendFile(req, fd, offset, length), 0);
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port);
+  const chunks = [];
+  client.on('data', (chunk) => chunks.push(chunk));
+  client.on('end', common.mustCall(() => {
+    assert(Buffer.concat(chunks).equals(expected));
+    server.close();
+  }));
+}));
@@ -0,0 +1,35 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+// With setWriteCoalescing(), small writes are held back and sent together.
+// Every write must still complete, in order, and no data may be lost when
+// the socket is ended right after writing.
+
+const chunks = ['a', 'bb', Buffer.from('ccc'), 'dddd', Buffer.alloc(2048, 'e')];
+const expected = chunks.map(String).join('');
+
+const server = net.createServer(common.mustCall((socket) => {
+  let received = '';
+  socket.setEncoding('utf8');
+  socket.on('data', (data) => received += data);
+  socket.on('end', common.mustCall(() => {
+    assert.strictEqual(received, expected);
+    server.close();
+  }));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port, common.mustCall(() => {
+    assert.strictEqual(client._handle.setWriteCoalescing(64), 0);
+
+    let completed = 0;
+    chunks.forEach((chunk, i) => {
+      client.write(chunk, common.mustCall(() => {
+        assert.strictEqual(completed++, i);
+      }));
+    });
+    client.end();
+  }));
+}));
@@ -0,0 +1,63 @@
+'use strict';
+const common = require('../common');
+
+// NODE_THREADPOOL_CPU_AFFINITY restricts the threads of the CPU pool, which
+// also run V8's background tasks, to a list of CPUs.
+
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const zlib = require('zlib');
+
+if (process.argv[2] === 'child') {
+  // Garbage collections hand work to the pool too.
+  let garbage = [];
+  for (let i = 0; i < 1e5; i++)
+    garbage.push({ i });
+  garbage = null;
+  global.gc();
+
+  const input = Buffer.alloc(64 * 1024, 'x');
+  zlib.deflate(input, common.mustCall((err, deflated) => {
+    assert.ifError(err);
+    if (common.isLinux) {
+      const cpus = fs.readdirSync('/proc/self/task').map((task) => {
+        const status = fs.readFileSync(`/proc/self/task/${task}/status`,
+                                       'latin1');
+        return /^Cpus_allowed_list:\s*(.*)$/m.exec(status)[1];
+      });
+      console.log(JSON.stringify(cpus));
+    }
+  }));
+  return;
+}
+
+function run(affinity) {
+  const env = Object.assign({}, process.env, {
+    NODE_THREADPOOL_CPU_SIZE: '2',
+    NODE_THREADPOOL_CPU_AFFINITY: affinity
+  });
+  const child = spawnSync(process.execPath,
+                          ['--expose-gc', __filename, 'child'],
+                          { env });
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  return child;
+}
+
+{
+  const child = run('0');
+  assert.strictEqual(child.stderr.toString(), '');
+  if (common.isLinux && os.cpus().length > 1) {
+    const cpus = JSON.parse(child.stdout);
+    // The two threads of the pool, and not the main thread.
+    assert.strictEqual(cpus.filter((list) => list === '0').length, 2);
+    assert.notStrictEqual(cpus[0], '0');
+  }
+}
+
+for (const affinity of ['junk', '1-0', '0,', '99999']) {
+  const child = run(affinity);
+  assert(child.stderr.toString().includes(
+    `ignoring invalid NODE_THREADPOOL_CPU_AFFINITY=${affinity}`));
+}
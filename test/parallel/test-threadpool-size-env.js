@@ -0,0 +1,55 @@
+'use strict';
+const common = require('../common');
+
+// DNS lookups, CPU bound work and key derivation run on thread pools of their
+// own, sized with NODE_THREADPOOL_DNS_SIZE, NODE_THREADPOOL_CPU_SIZE and
+// NODE_THREADPOOL_KDF_SIZE.
+
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const dns = require('dns');
+const zlib = require('zlib');
+
+if (process.argv[2] === 'child') {
+  dns.lookup('127.0.0.1', common.mustCall((err, address) => {
+    assert.ifError(err);
+    assert.strictEqual(address, '127.0.0.1');
+  }));
+  dns.lookupService('127.0.0.1', 0, common.mustCall());
+
+  const input = Buffer.alloc(64 * 1024, 'x');
+  for (let i = 0; i < 4; i++) {
+    zlib.deflate(input, common.mustCall((err, deflated) => {
+      assert.ifError(err);
+      zlib.inflate(deflated, common.mustCall((err, inflated) => {
+        assert.ifError(err);
+        assert(inflated.equals(input));
+      }));
+    }));
+  }
+
+  if (common.hasCrypto) {
+    const crypto = require('crypto');
+    crypto.pbkdf2('password', 'salt', 1, 20, 'sha1', common.mustCall((err) => {
+      assert.ifError(err);
+    }));
+    crypto.scrypt('password', 'salt', 16, { N: 16 }, common.mustCall((err) => {
+      assert.ifError(err);
+    }));
+    crypto.randomBytes(1024, common.mustCall((err, buf) => {
+      assert.ifError(err);
+      assert.strictEqual(buf.length, 1024);
+    }));
+  }
+  return;
+}
+
+for (const size of ['1', '2', '0', '1000', 'junk']) {
+  const env = Object.assign({}, process.env, {
+    NODE_THREADPOOL_DNS_SIZE: size,
+    NODE_THREADPOOL_CPU_SIZE: size,
+    NODE_THREADPOOL_KDF_SIZE: size
+  });
+  const child = spawnSync(process.execPath, [__filename, 'child'], { env });
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+}
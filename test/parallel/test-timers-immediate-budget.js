@@ -0,0 +1,29 @@
+'use strict';
+// Flags: --immediate-budget=2
+const common = require('../common');
+const assert = require('assert');
+
+// With a budget of 2, the immediates that are left over run in the next
+// iteration of the event loop, after the timers that are due by then.
+
+assert.strictEqual(process.binding('config').immediateBudget, 2);
+
+const order = [];
+
+setTimeout(common.mustCall(() => order.push('timeout')), 1);
+
+setImmediate(common.mustCall(() => {
+  order.push('a');
+  // Make sure that the timer is due in the next iteration.
+  const start = Date.now();
+  while (Date.now() - start < 5);
+  setImmediate(common.mustCall(() => order.push('e')));
+}));
+setImmediate(common.mustCall(() => order.push('b')));
+const c = setImmediate(common.mustNotCall());
+setImmediate(common.mustCall(() => order.push('d')));
+clearImmediate(c);
+
+process.on('exit', () => {
+  assert.deepStrictEqual(order, ['a', 'b', 'timeout', 'd', 'e']);
+});
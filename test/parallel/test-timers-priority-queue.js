@@ -0,0 +1,54 @@
+'use strict';
+
+// Flags: --expose-internals
+
+require('../common');
+const assert = require('assert');
+const PriorityQueue = require('internal/priority_queue');
+
+{
+  // Items come out in order.
+  const queue = new PriorityQueue((a, b) => a - b);
+  const values = [5, 1, 9, 3, 3, 7, 0, 8, 2, 6, 4];
+  values.forEach((value) => queue.insert(value));
+  assert.strictEqual(queue.peek(), 0);
+  const sorted = [];
+  let value;
+  while ((value = queue.shift()) !== undefined)
+    sorted.push(value);
+  assert.deepStrictEqual(sorted, values.slice().sort((a, b) => a - b));
+  assert.strictEqual(queue.peek(), undefined);
+}
+
+{
+  // Positions allow removing and updating items in place.
+  const queue = new PriorityQueue((a, b) => a.key - b.key,
+                                  (item, pos) => { item.pos = pos; });
+  const items = [];
+  for (let i = 0; i < 20; i++) {
+    const item = { key: (i * 7) % 20, pos: null };
+    items.push(item);
+    queue.insert(item);
+  }
+  items.forEach((item) => assert.strictEqual(queue._heap[item.pos], item));
+
+  const removed = items[3];
+  queue.removeAt(removed.pos);
+  assert.strictEqual(removed.pos, null);
+
+  const updated = queue.peek();
+  updated.key = 100;
+  queue.percolateDown(updated.pos);
+
+  const keys = [];
+  let item;
+  while ((item = queue.shift()) !== undefined) {
+    assert.strictEqual(item.pos, null);
+    keys.push(item.key);
+  }
+  const expected = items.filter((item) => item !== removed)
+                        .map((item) => item.key)
+                        .sort((a, b) => a - b);
+  assert.deepStrictEqual(keys, expected);
+  assert.strictEqual(keys[keys.length - 1], 100);
+}
@@ -0,0 +1,51 @@
+'use strict';
+const common = require('../common');
+
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+
+// Handshakes continued on the threadpool must complete, negotiate ALPN and
+// carry data like synchronous ones, also when many of them overlap.
+
+const assert = require('assert');
+const fs = require('fs');
+const tls = require('tls');
+
+const connections = 10;
+
+const server = tls.createServer({
+  key: fs.readFileSync(`${common.fixturesDir}/keys/agent1-key.pem`),
+  cert: fs.readFileSync(`${common.fixturesDir}/keys/agent1-cert.pem`),
+  ALPNProtocols: ['a', 'b'],
+  asyncHandshake: true
+}, common.mustCall((socket) => {
+  assert.strictEqual(socket.alpnProtocol, 'b');
+  socket.pipe(socket);
+}, connections));
+
+assert.strictEqual(server.asyncHandshake, true);
+
+server.listen(0, common.mustCall(() => {
+  let pending = connections;
+  for (let i = 0; i < connections; i++) {
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false,
+      ALPNProtocols: ['b']
+    }, common.mustCall(() => {
+      assert.strictEqual(client.alpnProtocol, 'b');
+      client.end(`hello ${i}`);
+    }));
+
+    let data = '';
+    client.setEncoding('utf8');
+    client.on('data', (chunk) => data += chunk);
+    client.on('end', common.mustCall(() => {
+      assert.strictEqual(data, `hello ${i}`);
+      if (--pending === 0)
+        server.close();
+    }));
+  }
+}));
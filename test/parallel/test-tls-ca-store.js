@@ -0,0 +1,69 @@
+'use strict';
+const common = require('../common');
+
+// A CAStore can be shared by any number of secure contexts as their `ca`.
+
+const join = require('path').join;
+const {
+  assert, connect, keys, tls
+} = require(join(common.fixturesDir, 'tls-connect'));
+
+const ca1 = tls.createCAStore(keys.agent1.ca);
+const ca2 = tls.createCAStore([keys.agent3.ca]);
+assert(ca1 instanceof tls.CAStore);
+assert.notStrictEqual(`${ca1}`, `${ca2}`);
+
+function checkServerIdentity() {}
+
+// Both ends use the same store, and the client certificate is verified too.
+connect({
+  client: {
+    key: keys.agent6.key,
+    cert: keys.agent6.cert,
+    ca: ca1,
+    checkServerIdentity,
+  },
+  server: {
+    key: keys.agent1.key,
+    cert: keys.agent1.cert,
+    ca: ca1,
+    requestCert: true,
+  },
+}, function(err, pair, cleanup) {
+  assert.ifError(err);
+  assert.strictEqual(pair.client.conn.authorized, true);
+  assert.strictEqual(pair.server.conn.authorized, true);
+
+  cleanup();
+});
+
+// A store with other CAs does not trust the server.
+{
+  const server = tls.createServer(keys.agent1, common.mustNotCall());
+  server.listen(0, common.mustCall(() => {
+    tls.connect({
+      port: server.address().port,
+      ca: ca2,
+      checkServerIdentity,
+    }, common.mustNotCall()).on('error', common.mustCall((err) => {
+      assert.strictEqual(err.code, 'UNABLE_TO_VERIFY_LEAF_SIGNATURE');
+      server.close();
+    }));
+  }));
+}
+
+// Adding a CRL to a context copies the store instead of changing it for the
+// other contexts.
+{
+  const crl = require('fs').readFileSync(
+    join(common.fixturesDir, 'keys', 'ca2-crl.pem'));
+  tls.createSecureContext({ ca: ca2, crl });
+  connect({
+    client: { ca: ca2, checkServerIdentity },
+    server: keys.agent4,
+  }, function(err, pair, cleanup) {
+    assert.ifError(err);
+    assert.strictEqual(pair.client.conn.authorized, true);
+    cleanup();
+  });
+}
@@ -0,0 +1,63 @@
+'use strict';
+const common = require('../common');
+
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+
+// Data written in small records at the start of a connection, and in full
+// size records past the threshold, arrives intact.
+
+const assert = require('assert');
+const fs = require('fs');
+const tls = require('tls');
+
+const key = fs.readFileSync(`${common.fixturesDir}/keys/agent1-key.pem`);
+const cert = fs.readFileSync(`${common.fixturesDir}/keys/agent1-cert.pem`);
+
+assert.throws(() => {
+  tls.createSecureContext({ dynamicRecordSizing: 'yes' });
+}, /^TypeError: dynamicRecordSizing must be a boolean or an object$/);
+assert.throws(() => {
+  tls.createSecureContext({ dynamicRecordSizing: { threshold: -1 } });
+}, /^TypeError: dynamicRecordSizing\.threshold must be a positive integer$/);
+assert.throws(() => {
+  tls.createSecureContext({ dynamicRecordSizing: { recordSize: 16385 } });
+}, /^RangeError: dynamicRecordSizing\.recordSize must not exceed 16384$/);
+
+assert.deepStrictEqual(
+  tls.createSecureContext({ dynamicRecordSizing: true }).dynamicRecordSizing,
+  { recordSize: 1369, threshold: 1024 * 1024, idleTimeout: 1000 });
+assert.strictEqual(tls.createSecureContext({}).dynamicRecordSizing, null);
+
+const payload = Buffer.alloc(256 * 1024);
+for (let i = 0; i < payload.length; i++)
+  payload[i] = i % 251;
+
+const server = tls.createServer({
+  key,
+  cert,
+  dynamicRecordSizing: { recordSize: 1000, threshold: 64 * 1024 }
+}, common.mustCall((socket) => {
+  socket.write(payload.slice(0, 10));
+  socket.end(payload.slice(10));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = tls.connect({
+    port: server.address().port,
+    rejectUnauthorized: false
+  }, common.mustCall(() => {
+    // Switching sizing on or off mid-connection only affects later writes.
+    client.setDynamicRecordSizing({ recordSize: 512 });
+    client.setDynamicRecordSizing(false);
+  }));
+
+  const chunks = [];
+  client.on('data', (chunk) => chunks.push(chunk));
+  client.on('end', common.mustCall(() => {
+    assert(Buffer.concat(chunks).equals(payload));
+    server.close();
+  }));
+}));
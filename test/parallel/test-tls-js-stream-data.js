@@ -0,0 +1,69 @@
+'use strict';
+const common = require('../common');
+
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+
+// Data that goes through TLS over a JS stream does so intact and in order,
+// however it is split into writes.
+
+const assert = require('assert');
+const crypto = require('crypto');
+const fs = require('fs');
+const net = require('net');
+const stream = require('stream');
+const tls = require('tls');
+
+const server = tls.createServer({
+  key: fs.readFileSync(common.fixturesDir + '/keys/agent1-key.pem'),
+  cert: fs.readFileSync(common.fixturesDir + '/keys/agent1-cert.pem')
+}, (c) => c.pipe(c)).listen(0, common.mustCall(() => {
+  const raw = net.connect(server.address().port);
+
+  const p = new stream.Duplex({
+    read() {
+      raw.resume();
+    },
+    write(data, enc, cb) {
+      raw.write(data, enc, cb);
+    }
+  });
+  raw.on('data', (chunk) => {
+    if (!p.push(chunk))
+      raw.pause();
+  });
+  raw.on('end', () => p.push(null));
+
+  const chunks = [];
+  for (let i = 0; i < 200; i++)
+    chunks.push(crypto.randomBytes(1 + (i * 997) % 20000));
+  const expected = Buffer.concat(chunks);
+
+  const socket = tls.connect({
+    socket: p,
+    rejectUnauthorized: false
+  }, common.mustCall(() => {
+    // Several chunks at once make writev()s.
+    for (let i = 0; i < chunks.length; i += 10) {
+      socket.cork();
+      for (let j = i; j < i + 10; j++)
+        socket.write(chunks[j]);
+      socket.uncork();
+    }
+  }));
+
+  const received = [];
+  let length = 0;
+  socket.on('data', (chunk) => {
+    received.push(chunk);
+    length += chunk.length;
+    if (length === expected.length) {
+      assert.ok(Buffer.concat(received).equals(expected));
+      socket.destroy();
+      raw.destroy();
+      server.close();
+    }
+  });
+}));
@@ -0,0 +1,52 @@
+'use strict';
+const common = require('../common');
+
+// getPeerCertificate() caches converted certificates per secure context, but
+// hands out a new copy of them every time.
+
+const join = require('path').join;
+const {
+  assert, connect, keys
+} = require(join(common.fixturesDir, 'tls-connect'));
+
+connect({
+  client: {rejectUnauthorized: false},
+  server: keys.agent1,
+}, common.mustCall(function(err, pair, cleanup) {
+  assert.ifError(err);
+  const socket = pair.client.conn;
+
+  const first = socket.getPeerCertificate();
+  const second = socket.getPeerCertificate();
+  assert.notStrictEqual(first, second);
+  assert.deepStrictEqual(first, second);
+  assert.strictEqual(first.serialNumber, '9A84ABCFB8A72AC0');
+  assert.ok(!first.issuerCertificate);
+
+  // Modifying a returned certificate, or the values nested in it, does not
+  // affect later calls.
+  const subjectCN = first.subject.CN;
+  first.serialNumber = 'modified';
+  first.subject.CN = 'modified';
+  first.raw[0] ^= 0xff;
+  const third = socket.getPeerCertificate();
+  assert.strictEqual(third.serialNumber, '9A84ABCFB8A72AC0');
+  assert.strictEqual(third.subject.CN, subjectCN);
+  assert.deepStrictEqual(third.raw, second.raw);
+  assert.notStrictEqual(third.raw, second.raw);
+
+  // Detailed certificates are cached separately, with their issuers.
+  const detailed = socket.getPeerCertificate(true);
+  const issuer = detailed.issuerCertificate;
+  assert.ok(issuer);
+  assert.strictEqual(issuer.issuerCertificate, issuer);
+  delete issuer.issuerCertificate;
+
+  const again = socket.getPeerCertificate(true);
+  assert.notStrictEqual(again.issuerCertificate, issuer);
+  assert.strictEqual(again.issuerCertificate.issuerCertificate,
+                     again.issuerCertificate);
+  assert.strictEqual(again.issuerCertificate.serialNumber, '8DF21C01468AF393');
+
+  return cleanup();
+}));
@@ -0,0 +1,64 @@
+'use strict';
+const common = require('../common');
+
+if (!common.hasCrypto) {
+  common.skip('missing crypto');
+  return;
+}
+
+// Servers that share a ticketKeySecret derive the same ticket keys, so a
+// session created by one can be resumed on the other.
+
+const assert = require('assert');
+const fs = require('fs');
+const tls = require('tls');
+
+const secret = Buffer.alloc(32, 'secret');
+const options = {
+  key: fs.readFileSync(`${common.fixturesDir}/keys/agent1-key.pem`),
+  cert: fs.readFileSync(`${common.fixturesDir}/keys/agent1-cert.pem`),
+  ticketKeyRotation: 3600,
+  ticketKeySecret: secret
+};
+
+assert.throws(() => tls.createServer(Object.assign({}, options, {
+  ticketKeyRotation: -1
+})), /^TypeError: ticketKeyRotation must be a positive integer$/);
+
+assert.deepStrictEqual(
+  tls.createServer(options)._getServerData().ticketKeySecret,
+  secret.toString('hex'));
+
+function connect(server, session, cb) {
+  server.listen(0, common.mustCall(() => {
+    const c = tls.connect(server.address().port, {
+      session: session,
+      rejectUnauthorized: false
+    }, common.mustCall(() => {
+      const reused = c.isSessionReused();
+      const newSession = c.getSession();
+      c.end();
+      server.close(common.mustCall(() => cb(reused, newSession)));
+    }));
+  }));
+}
+
+function createServer(opts) {
+  return tls.createServer(opts, (c) => c.end());
+}
+
+connect(createServer(options), null, common.mustCall((reused, session) => {
+  assert.strictEqual(reused, false);
+
+  connect(createServer(options), session, common.mustCall((reused) => {
+    assert.strictEqual(reused, true);
+
+    // A server with a different secret can't decrypt the ticket.
+    const other = Object.assign({}, options, {
+      ticketKeySecret: Buffer.alloc(32, 'other')
+    });
+    connect(createServer(other), session, common.mustCall((reused) => {
+      assert.strictEqual(reused, false);
+    }));
+  }));
+}));
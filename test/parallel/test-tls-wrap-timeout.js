@@ -28,7 +28,6 @@ const server = tls.createServer(options, common.mustCall((c) => {
 }));
 
 let socket;
-let lastIdleStart;
 
 server.listen(0, () => {
   socket = net.connect(server.address().port, function() {
@@ -37,9 +36,6 @@ server.listen(0, () => {
     });
     assert.ok(s instanceof net.Socket);
 
-    assert.notStrictEqual(socket._idleTimeout, -1);
-    lastIdleStart = socket._idleStart;
-
     const tsocket = tls.connect({
       socket: socket,
       rejectUnauthorized: false
@@ -49,6 +45,42 @@ server.listen(0, () => {
 });
 
 process.on('exit', () => {
+  // The TCP handle times the socket out, so the activity of the TLS socket
+  // needs no timer list.
   assert.strictEqual(socket._idleTimeout, -1);
-  assert(lastIdleStart < socket._idleStart);
 });
+
+// TLS traffic over the TCP handle pushes its idle timeout back: the socket
+// only times out once the server has stopped sending.
+{
+  const timeout = common.platformTimeout(100);
+  const pings = 8;
+  let sent = 0;
+  let received = 0;
+
+  const pingServer = tls.createServer(options, common.mustCall((c) => {
+    const interval = setInterval(() => {
+      c.write('ping');
+      if (++sent === pings)
+        clearInterval(interval);
+    }, timeout / 4);
+    c.on('error', () => {});
+  }));
+
+  pingServer.listen(0, common.mustCall(() => {
+    const raw = net.connect(pingServer.address().port, common.mustCall(() => {
+      raw.setTimeout(timeout, common.mustCall(() => {
+        assert.strictEqual(received, 'ping'.length * pings);
+        assert.strictEqual(raw._idleTimeout, -1);
+        tsocket.destroy();
+        pingServer.close();
+      }));
+
+      const tsocket = tls.connect({
+        socket: raw,
+        rejectUnauthorized: false
+      });
+      tsocket.on('data', (data) => received += data.length);
+    }));
+  }));
+}
@@ -0,0 +1,50 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+
+// Async resources are recorded from their creation until they are destroyed,
+// and their callbacks with the ids that tie them to their trigger.
+
+const CODE = `setTimeout(() => {
+                require('fs').stat(__filename, () => {});
+              }, 1);`;
+const FILE_NAME = 'node_trace.1.log';
+
+common.refreshTmpDir();
+process.chdir(common.tmpDir);
+
+const proc = cp.spawn(process.execPath, [
+  '--trace-events-enabled', '--trace-event-categories', 'node.async_hooks',
+  '-e', CODE
+]);
+
+proc.once('exit', common.mustCall(() => {
+  assert(common.fileExists(FILE_NAME));
+  fs.readFile(FILE_NAME, common.mustCall((err, data) => {
+    assert.ifError(err);
+    const traces = JSON.parse(data.toString()).traceEvents
+      .filter((trace) => trace.pid === proc.pid);
+    assert(traces.every((trace) => trace.cat === 'node.async_hooks'));
+
+    const timer = traces.find((trace) => trace.ph === 'b' &&
+                                         trace.name === 'TIMERWRAP');
+    assert(timer);
+    const timerCallback = traces.find((trace) => {
+      return trace.ph === 'X' && trace.name === 'TIMERWRAP_CALLBACK';
+    });
+    assert(timerCallback);
+    assert.strictEqual(timerCallback.args.asyncId, parseInt(timer.id, 16));
+
+    // The stat request is created while the timer callback runs.
+    const stat = traces.find((trace) => trace.ph === 'b' &&
+                                        trace.name === 'FSREQWRAP');
+    assert(stat);
+    assert.strictEqual(stat.args.triggerAsyncId, timerCallback.args.asyncId);
+    assert(traces.some((trace) => trace.ph === 'X' &&
+                                  trace.name === 'FSREQWRAP_CALLBACK' &&
+                                  trace.args.triggerAsyncId ===
+                                    stat.args.triggerAsyncId));
+  }));
+}));
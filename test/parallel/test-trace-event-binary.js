@@ -0,0 +1,49 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const traceToJSON = require('../../tools/trace-to-json');
+
+// With `--trace-event-format binary` trace events are written in the binary
+// format, which tools/trace-to-json.js converts back into the JSON one.
+
+const CODE = 'for (var i = 0; i < 100000; i++) { "test" + i }';
+const FILE_NAME = 'node_trace.1.bin';
+
+common.refreshTmpDir();
+process.chdir(common.tmpDir);
+
+const proc = cp.spawn(process.execPath, [
+  '--trace-events-enabled', '--trace-event-format', 'binary', '-e', CODE
+]);
+
+proc.once('exit', common.mustCall(() => {
+  assert(common.fileExists(FILE_NAME));
+  assert(!common.fileExists('node_trace.1.log'));
+  fs.readFile(FILE_NAME, common.mustCall((err, data) => {
+    assert.ifError(err);
+    const traces = traceToJSON(data).traceEvents;
+    assert(traces.length > 0);
+    assert(traces.some((trace) => {
+      return trace.pid === proc.pid &&
+             trace.cat === 'v8' &&
+             trace.name === 'V8.ScriptCompiler' &&
+             typeof trace.ts === 'number';
+    }));
+
+    // A file that is cut off is read up to its last complete record.
+    const truncated = traceToJSON(data.slice(0, data.length - 1)).traceEvents;
+    assert.strictEqual(truncated.length, traces.length - 1);
+    assert.deepStrictEqual(truncated, traces.slice(0, -1));
+
+    assert.throws(() => traceToJSON(Buffer.from('{"traceEvents":[]}')),
+                  /^Error: Not a binary trace event log$/);
+  }));
+}));
+
+const bad = cp.spawnSync(process.execPath, [
+  '--trace-event-format', 'xml', '-e', ''
+]);
+assert.strictEqual(bad.status, 9);
+assert(/--trace-event-format must be json or binary/.test(bad.stderr));
@@ -0,0 +1,34 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+
+// --startup-profile records the steps of startup and the bindings that they
+// load. Loading net does not set up c-ares until it resolves a name.
+
+const CODE = `require('net');
+              if (process.binding('cares_wrap').isIP('::1') !== 6)
+                throw new Error('isIP');`;
+const FILE_NAME = 'node_trace.1.log';
+
+common.refreshTmpDir();
+process.chdir(common.tmpDir);
+
+const proc = cp.spawn(process.execPath, ['--startup-profile', '-e', CODE]);
+
+proc.once('exit', common.mustCall((exitCode) => {
+  assert.strictEqual(exitCode, 0);
+  assert(common.fileExists(FILE_NAME));
+  fs.readFile(FILE_NAME, common.mustCall((err, data) => {
+    assert.ifError(err);
+    const traces = JSON.parse(data.toString()).traceEvents
+      .filter((trace) => trace.pid === proc.pid);
+    assert(traces.every((trace) => trace.cat === 'node.startup'));
+    assert(traces.some((trace) => trace.name === 'LoadEnvironment'));
+    const bindings = traces.filter((trace) => trace.name === 'binding')
+      .map((trace) => trace.args.module);
+    assert(bindings.includes('fs'));
+    assert(bindings.includes('cares_wrap'));
+  }));
+}));
@@ -0,0 +1,44 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+
+// Threadpool work is recorded with the time it spent waiting in the queue
+// and the time it took to run.
+
+const CODE = `require('zlib').deflate('x', () => {});
+              require('fs').stat(__filename, () => {});`;
+const FILE_NAME = 'node_trace.1.log';
+
+common.refreshTmpDir();
+process.chdir(common.tmpDir);
+
+const proc = cp.spawn(process.execPath, [
+  '--trace-events-enabled', '--trace-event-categories', 'node.threadpool',
+  '-e', CODE
+]);
+
+proc.once('exit', common.mustCall(() => {
+  assert(common.fileExists(FILE_NAME));
+  fs.readFile(FILE_NAME, common.mustCall((err, data) => {
+    assert.ifError(err);
+    const traces = JSON.parse(data.toString()).traceEvents
+      .filter((trace) => trace.pid === proc.pid);
+    const zlib = traces.filter((trace) => {
+      return trace.cat === 'node.threadpool,node.zlib';
+    });
+    const begin = zlib.find((trace) => trace.ph === 'b' &&
+                                       trace.name !== 'wait');
+    assert(begin);
+    for (const [ph, name] of [['b', 'wait'], ['e', 'wait'],
+                              ['X', begin.name], ['e', begin.name]]) {
+      assert(zlib.some((trace) => trace.ph === ph && trace.name === name &&
+                                  (ph === 'X' || trace.id === begin.id)),
+             `missing ${ph} ${name} event`);
+    }
+
+    // Plain fs requests are only recorded in node.fs.
+    assert(!traces.some((trace) => trace.cat === 'node.fs'));
+  }));
+}));
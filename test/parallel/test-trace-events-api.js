@@ -0,0 +1,59 @@
+'use strict';
+const common = require('../common');
+
+// Recording can be started, reconfigured and stopped at runtime, without
+// --trace-events-enabled.
+
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const trace_events = require('trace_events');
+
+if (process.argv[2] === 'child') {
+  assert.deepStrictEqual(trace_events.getEnabledCategories(), []);
+  trace_events.start(['node.zlib']);
+  assert.deepStrictEqual(trace_events.getEnabledCategories(), ['node.zlib']);
+  trace_events.start(['node.zlib', 'node.crypto']);
+  assert.deepStrictEqual(trace_events.getEnabledCategories(),
+                         ['node.zlib', 'node.crypto']);
+  require('zlib').deflate('x', common.mustCall(() => {
+    trace_events.stop();
+    assert.deepStrictEqual(trace_events.getEnabledCategories(), []);
+    // Nothing is recorded after stop() and the next start() begins a new
+    // file.
+    require('zlib').deflate('y', common.mustCall(() => {
+      trace_events.start(['node.crypto']);
+      require('crypto').pbkdf2('a', 'b', 1, 8, 'sha1', common.mustCall());
+    }));
+  }));
+  return;
+}
+
+const invalidCategories =
+  /^TypeError: "categories" must be a non-empty array of strings$/;
+for (const categories of [undefined, 'node', [], [''], ['a,b'], [1]])
+  assert.throws(() => trace_events.start(categories), invalidCategories);
+
+common.refreshTmpDir();
+
+const proc = cp.fork(__filename, ['child'], { cwd: common.tmpDir });
+proc.once('exit', common.mustCall((code) => {
+  assert.strictEqual(code, 0);
+  const read = (name) => {
+    const data = fs.readFileSync(path.join(common.tmpDir, name), 'utf8');
+    return JSON.parse(data).traceEvents.filter((t) => {
+      return t.pid === proc.pid && t.cat !== '__metadata';
+    });
+  };
+
+  const first = read('node_trace.1.log');
+  assert(first.length > 0);
+  assert(first.every((t) => t.cat === 'node.threadpool,node.zlib'));
+  assert(first.some((t) => t.ph === 'X' && t.name.startsWith('zlib.')));
+
+  const second = read('node_trace.2.log');
+  assert(second.length > 0);
+  assert(second.every((t) => t.cat === 'node.threadpool,node.crypto'));
+  assert(second.some((t) => t.name === 'crypto.pbkdf2'));
+}));
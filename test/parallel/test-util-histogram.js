@@ -0,0 +1,82 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const { Histogram } = require('util');
+
+{
+  const histogram = new Histogram();
+  assert.strictEqual(histogram.count, 0);
+  assert.strictEqual(histogram.min, 0);
+  assert.strictEqual(histogram.max, 0);
+  assert.strictEqual(histogram.mean, 0);
+  assert.strictEqual(histogram.stddev, 0);
+  assert.strictEqual(histogram.percentile(50), 0);
+
+  for (let i = 1; i <= 10000; i++)
+    histogram.record(i);
+  assert.strictEqual(histogram.count, 10000);
+  assert.strictEqual(histogram.min, 1);
+  assert.strictEqual(histogram.max, 10000);
+  assert.strictEqual(histogram.mean, 5000.5);
+  assert(Math.abs(histogram.stddev - 2886.75) < 5);
+  assert.strictEqual(histogram.percentile(0), 1);
+  assert.strictEqual(histogram.percentile(100), 10000);
+  // Three significant figures.
+  for (const percentile of [1, 25, 50, 90, 99, 99.9]) {
+    const value = histogram.percentile(percentile);
+    const exact = percentile * 100;
+    assert(value >= exact && value <= exact * 1.001, `${percentile}: ${value}`);
+  }
+
+  histogram.reset();
+  assert.strictEqual(histogram.count, 0);
+  assert.strictEqual(histogram.percentile(50), 0);
+}
+
+{
+  // Values above the highest one are counted as it, fractions are dropped.
+  const histogram = new Histogram({ highest: 100, significantFigures: 1 });
+  histogram.record(1e300);
+  histogram.record(1.9);
+  assert.strictEqual(histogram.max, 100);
+  assert.strictEqual(histogram.min, 1);
+  assert.strictEqual(histogram.percentile(100), 100);
+}
+
+{
+  const a = new Histogram();
+  const b = new Histogram({ highest: 1e6, significantFigures: 2 });
+  a.record(10);
+  b.record(20);
+  b.record(30);
+  a.merge(b);
+  assert.strictEqual(a.count, 3);
+  assert.strictEqual(a.min, 10);
+  assert.strictEqual(a.max, 30);
+  assert.strictEqual(a.mean, 20);
+  assert.strictEqual(a.percentile(50), 20);
+  assert.strictEqual(b.count, 2);
+}
+
+{
+  const histogram = new Histogram();
+  for (const value of [-1, NaN, '1', undefined]) {
+    assert.throws(() => histogram.record(value),
+                  /^TypeError: "value" must be a non-negative number$/);
+  }
+  for (const percentile of [-1, 101, NaN, '50']) {
+    assert.throws(() => histogram.percentile(percentile),
+                  /^RangeError: "percentile" must be a number from 0 to 100$/);
+  }
+  assert.throws(() => histogram.merge({}),
+                /^TypeError: "other" must be a Histogram$/);
+  assert.throws(() => new Histogram(null),
+                /^TypeError: "options" must be an object$/);
+  for (const highest of [0, 1.5, Infinity]) {
+    assert.throws(() => new Histogram({ highest }),
+                  /^RangeError: "highest" must be a positive integer$/);
+  }
+  for (const significantFigures of [0, 6, 2.5]) {
+    assert.throws(() => new Histogram({ significantFigures }), RangeError);
+  }
+}
@@ -0,0 +1,69 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const v8 = require('v8');
+
+common.refreshTmpDir();
+process.chdir(common.tmpDir);
+
+function spinForCpuProfile(ms) {
+  const end = Date.now() + ms;
+  let x = 0;
+  while (Date.now() < end)
+    x += Math.sqrt(x + 1);
+  return x;
+}
+
+{
+  assert.strictEqual(v8.startCpuProfile({ interval: 100 }), true);
+  assert.strictEqual(v8.startCpuProfile(), false);
+  spinForCpuProfile(200);
+  const filename = path.join(common.tmpDir, 'explicit.nodecpuprofile');
+  assert.strictEqual(v8.stopCpuProfile(filename), filename);
+
+  const profile = v8.convertCpuProfile(fs.readFileSync(filename));
+  assert.ok(profile.endTime >= profile.startTime);
+  assert.ok(profile.samples.length > 0);
+  assert.strictEqual(profile.samples.length, profile.timeDeltas.length);
+  assert.strictEqual(profile.nodes[0].id, 1);
+  assert.strictEqual(profile.nodes[0].callFrame.functionName, '(root)');
+
+  const ids = new Set(profile.nodes.map((node) => node.id));
+  for (const id of profile.samples)
+    assert.ok(ids.has(id));
+  const spin = profile.nodes.find((node) => {
+    return node.callFrame.functionName === 'spinForCpuProfile';
+  });
+  assert.ok(spin);
+  assert.strictEqual(spin.callFrame.url, __filename);
+  assert.strictEqual(typeof spin.callFrame.scriptId, 'string');
+  assert.strictEqual(spin.callFrame.lineNumber, 10);
+
+  // The result is what Chrome DevTools loads.
+  JSON.parse(JSON.stringify(profile));
+}
+
+{
+  v8.startCpuProfile();
+  const filename = v8.stopCpuProfile();
+  assert.ok(/^CPU\.\d{8}\.\d{6}\.\d+\.\d{3}\.nodecpuprofile$/.test(filename),
+            filename);
+  assert.ok(fs.existsSync(filename));
+}
+
+assert.throws(() => v8.stopCpuProfile(),
+              /^Error: The CPU profiler is not running$/);
+
+[0, -1, 1.5, '1000', NaN].forEach((interval) => {
+  assert.throws(() => v8.startCpuProfile({ interval }),
+                /^RangeError: "interval" must be a positive integer$/);
+});
+
+assert.throws(() => v8.convertCpuProfile(Buffer.from('garbage!garbage!')),
+              /^Error: Not a CPU profile$/);
+assert.throws(() => v8.convertCpuProfile(Buffer.from('NODECPU1')),
+              /^Error: Unexpected end of CPU profile$/);
+assert.throws(() => v8.convertCpuProfile('NODECPU1'),
+              /^TypeError: "buffer" argument must be a Buffer or Uint8Array$/);
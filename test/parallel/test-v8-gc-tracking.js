@@ -0,0 +1,64 @@
+'use strict';
+// Flags: --expose-gc
+require('../common');
+const assert = require('assert');
+const v8 = require('v8');
+
+// Nothing is recorded before tracking starts.
+global.gc();
+assert.deepStrictEqual(v8.readGCEvents(), { events: [], dropped: 0 });
+
+const spaceNames = v8.getHeapSpaceStatistics().map((space) => space.space_name);
+const pauses = v8.getGCPauseHistogram();
+assert.strictEqual(v8.getGCPauseHistogram(), pauses);
+assert.strictEqual(pauses.count, 0);
+
+const before = process.hrtime();
+v8.startGCTracking();
+global.gc();
+global.gc();
+{
+  const { events, dropped } = v8.readGCEvents();
+  assert.strictEqual(dropped, 0);
+  // There may also have been other collections in between.
+  const forced = events.filter((event) => event.forced);
+  assert.strictEqual(forced.length, 2);
+  assert.strictEqual(forced[0].type, 'markSweepCompact');
+  const startTime = before[0] * 1e3 + before[1] / 1e6;
+  for (const event of events) {
+    assert.strictEqual(typeof event.type, 'string');
+    assert(event.startTime >= startTime);
+    assert(event.duration >= 0);
+    assert(event.usedHeapSizeBefore > 0);
+    assert(event.usedHeapSizeAfter > 0);
+    assert.deepStrictEqual(Object.keys(event.heapSpaceDeltas), spaceNames);
+  }
+  assert(forced[0].startTime <= forced[1].startTime);
+  assert.strictEqual(pauses.count, events.length);
+}
+
+// Only new collections are returned.
+assert.strictEqual(v8.readGCEvents().events.filter((e) => e.forced).length, 0);
+
+// Collections that don't fit into the buffer are counted.
+v8.startGCTracking({ bufferSize: 2 });
+for (let i = 0; i < 5; i++)
+  global.gc();
+{
+  const { events, dropped } = v8.readGCEvents();
+  assert(events.length + dropped >= 5);
+  assert(events.length <= 2);
+  assert(dropped >= 3);
+}
+
+v8.stopGCTracking();
+global.gc();
+assert.strictEqual(v8.readGCEvents().events.filter((e) => e.forced).length, 0);
+
+assert.throws(() => v8.startGCTracking(null),
+              /^TypeError: "options" must be an object$/);
+for (const bufferSize of [0, 1.5, 0x100001, '1']) {
+  assert.throws(
+    () => v8.startGCTracking({ bufferSize }),
+    /^RangeError: "bufferSize" must be an integer from 1 to 1048576$/);
+}
@@ -0,0 +1,51 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const v8 = require('v8');
+
+assert.strictEqual(v8.getAllocationProfile(), null);
+
+assert.strictEqual(v8.startSamplingHeapProfiler({ interval: 128 }), true);
+assert.strictEqual(v8.startSamplingHeapProfiler(), false);
+
+const retained = [];
+function allocateStrings() {
+  for (let i = 0; i < 10000; i++)
+    retained.push({ value: `allocation ${i}` });
+}
+allocateStrings();
+
+const profile = v8.getAllocationProfile();
+assert.ok(profile instanceof Buffer);
+const { head } = JSON.parse(profile.toString());
+
+function find(node, name) {
+  if (node.callFrame.functionName === name)
+    return node;
+  for (const child of node.children) {
+    const found = find(child, name);
+    if (found !== undefined)
+      return found;
+  }
+}
+
+assert.strictEqual(typeof head.callFrame.scriptId, 'string');
+const node = find(head, 'allocateStrings');
+assert.ok(node, 'allocateStrings is in the profile');
+assert.ok(node.selfSize > 0);
+assert.strictEqual(node.callFrame.url, __filename);
+assert.ok(node.callFrame.lineNumber >= 0);
+
+v8.stopSamplingHeapProfiler();
+assert.strictEqual(v8.getAllocationProfile(), null);
+
+[null, 'options'].forEach((options) => {
+  assert.throws(() => v8.startSamplingHeapProfiler(options),
+                /^TypeError: "options" must be an object$/);
+});
+[0, -1, 1.5, '1'].forEach((value) => {
+  assert.throws(() => v8.startSamplingHeapProfiler({ interval: value }),
+                /^RangeError: "interval" must be a positive integer$/);
+  assert.throws(() => v8.startSamplingHeapProfiler({ stackDepth: value }),
+                /^RangeError: "stackDepth" must be a positive integer$/);
+});
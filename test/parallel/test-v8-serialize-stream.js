@@ -0,0 +1,74 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const v8 = require('v8');
+
+const values = [
+  1,
+  'two',
+  { three: [3] },
+  undefined,
+  Buffer.from('buffer'),
+  new Float64Array([Math.PI]),
+  'x'.repeat(100000)
+];
+
+function serialize(values) {
+  const chunks = [];
+  const ser = v8.createSerializeStream();
+  ser.on('data', (chunk) => chunks.push(chunk));
+  values.forEach((value) => ser.write(value));
+  ser.end();
+  return Buffer.concat(chunks);
+}
+
+// Each record is the length of the serialized value followed by it.
+{
+  const data = serialize([{ a: 1 }]);
+  const expected = v8.serialize({ a: 1 });
+  assert.strictEqual(data.readUInt32LE(0), expected.length);
+  assert.deepStrictEqual(data.slice(4), expected);
+}
+
+const data = serialize(values);
+
+// Values come out however the data is split into chunks.
+[1, 3, 7, 1000, data.length].forEach((chunkSize) => {
+  const des = v8.createDeserializeStream();
+  const result = [];
+  des.on('data', (value) => result.push(value));
+  des.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(result, values);
+  }));
+  for (let i = 0; i < data.length; i += chunkSize)
+    des.write(data.slice(i, i + chunkSize));
+  des.end();
+});
+
+// A value is pushed as soon as its record is complete.
+{
+  const des = v8.createDeserializeStream();
+  const first = serialize(['first']);
+  des.write(Buffer.concat([first, serialize(['second']).slice(0, 5)]));
+  assert.strictEqual(des.read(), 'first');
+  assert.strictEqual(des.read(), null);
+}
+
+// The data ends in the middle of a record.
+{
+  const des = v8.createDeserializeStream();
+  des.on('error', common.mustCall((err) => {
+    assert.strictEqual(err.message, 'Unexpected end of serialized data');
+  }));
+  des.resume();
+  des.end(data.slice(0, data.length - 1));
+}
+
+// Values that cannot be serialized are an error.
+{
+  const ser = v8.createSerializeStream();
+  ser.on('error', common.mustCall((err) => {
+    assert.ok(/could not be cloned/.test(err.message), err.message);
+  }));
+  ser.write(() => {});
+}
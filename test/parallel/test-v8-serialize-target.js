@@ -0,0 +1,80 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const v8 = require('v8');
+
+const value = {
+  a: [1, 'two', { three: 3 }],
+  buffer: Buffer.from('buffer'),
+  int8: new Int8Array([-1, 2]),
+  uint8: new Uint8Array([1, 2]),
+  uint8Clamped: new Uint8ClampedArray([255, 0]),
+  int16: new Int16Array([-1000, 1000]),
+  uint16: new Uint16Array([1000, 2000]),
+  int32: new Int32Array([-1e6, 1e6]),
+  uint32: new Uint32Array([1e9, 2e9]),
+  float32: new Float32Array([0.5, -0.25]),
+  float64: new Float64Array([Math.PI, -Math.E]),
+  dataView: new DataView(new ArrayBuffer(3))
+};
+
+function defaultSerialize(value) {
+  const ser = new v8.DefaultSerializer();
+  ser.writeHeader();
+  ser.writeValue(value);
+  return ser.releaseBuffer();
+}
+
+function defaultDeserialize(buffer) {
+  const des = new v8.DefaultDeserializer(buffer);
+  des.readHeader();
+  return des.readValue();
+}
+
+// v8.serialize() writes what DefaultSerializer writes, and each can read
+// what the other wrote.
+const serialized = v8.serialize(value);
+assert.ok(serialized instanceof Buffer);
+assert.deepStrictEqual(serialized, defaultSerialize(value));
+assert.deepStrictEqual(v8.deserialize(serialized), value);
+assert.deepStrictEqual(defaultDeserialize(serialized), value);
+assert.deepStrictEqual(v8.deserialize(defaultSerialize(value)), value);
+
+{
+  const result = v8.deserialize(serialized);
+  assert.ok(result.buffer instanceof Buffer);
+  assert.strictEqual(Object.getPrototypeOf(result.uint8), Uint8Array.prototype);
+}
+
+// The typed arrays are copied out of a buffer that they are not aligned in.
+{
+  const unaligned = Buffer.alloc(serialized.length + 1);
+  serialized.copy(unaligned, 1);
+  assert.deepStrictEqual(v8.deserialize(unaligned.slice(1)), value);
+}
+
+// The data is written into the target if it fits.
+{
+  const target = Buffer.alloc(serialized.length + 10);
+  const result = v8.serialize(value, target);
+  assert.deepStrictEqual(result, serialized);
+  assert.strictEqual(result.buffer, target.buffer);
+  assert.strictEqual(result.byteOffset, target.byteOffset);
+  assert.deepStrictEqual(v8.deserialize(result), value);
+}
+
+{
+  const target = new Uint8Array(8);
+  const result = v8.serialize(value, target);
+  assert.ok(result instanceof Buffer);
+  assert.notStrictEqual(result.buffer, target.buffer);
+  assert.deepStrictEqual(result, serialized);
+}
+
+[null, 'target', {}, new Uint16Array(100)].forEach((target) => {
+  assert.throws(() => v8.serialize(value, target),
+                /^TypeError: target must be a Uint8Array$/);
+});
+
+assert.throws(() => v8.deserialize('buffer'),
+              /^TypeError: buffer must be a Uint8Array$/);
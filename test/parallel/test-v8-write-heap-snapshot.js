@@ -0,0 +1,56 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const v8 = require('v8');
+
+common.refreshTmpDir();
+process.chdir(common.tmpDir);
+
+function checkSnapshot(filename) {
+  const snapshot = JSON.parse(fs.readFileSync(filename, 'utf8'));
+  assert.ok(snapshot.snapshot.node_count > 0);
+  assert.ok(Array.isArray(snapshot.nodes));
+  assert.ok(Array.isArray(snapshot.strings));
+}
+
+{
+  const filename = v8.writeHeapSnapshot();
+  assert.ok(/^Heap\.\d{8}\.\d{6}\.\d+\.001\.heapsnapshot$/.test(filename),
+            filename);
+  checkSnapshot(filename);
+  assert.ok(/\.002\.heapsnapshot$/.test(v8.writeHeapSnapshot()));
+}
+
+{
+  const filename = path.join(common.tmpDir, 'explicit.heapsnapshot');
+  assert.strictEqual(v8.writeHeapSnapshot(filename), filename);
+  checkSnapshot(filename);
+}
+
+assert.throws(() => v8.writeHeapSnapshot(1),
+              /^TypeError: "filename" argument must be a string$/);
+assert.throws(() => v8.writeHeapSnapshot(path.join('missing', 'file')),
+              /^Error: ENOENT: no such file or directory, open /);
+
+if (!common.isWindows) {
+  const dir = path.join(common.tmpDir, 'signal');
+  fs.mkdirSync(dir);
+  const child = spawnSync(process.execPath, [
+    '--heapsnapshot-signal=SIGUSR2',
+    '-e', 'process.kill(process.pid, "SIGUSR2"); setTimeout(() => {}, 100);'
+  ], { cwd: dir });
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  const files = fs.readdirSync(dir);
+  assert.strictEqual(files.length, 1);
+  checkSnapshot(path.join(dir, files[0]));
+}
+
+{
+  const child = spawnSync(process.execPath,
+                          ['--heapsnapshot-signal=SIGFOO', '-e', '0']);
+  assert.notStrictEqual(child.status, 0);
+  assert.ok(/Unknown signal: SIGFOO/.test(child.stderr.toString()));
+}
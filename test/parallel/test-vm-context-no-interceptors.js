@@ -0,0 +1,33 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const vm = require('vm');
+
+// With interceptors: false, the global of the context is the contextified
+// object, and starts out with the properties of the sandbox.
+
+const sandbox = { count: 1 };
+const context = vm.createContext(sandbox, { interceptors: false });
+assert.notStrictEqual(context, sandbox);
+assert(vm.isContext(context));
+assert(!vm.isContext(sandbox));
+
+assert.strictEqual(vm.runInContext('count', context), 1);
+vm.runInContext('var declared = 2; count++; this.added = 3;', context);
+assert.strictEqual(context.count, 2);
+assert.strictEqual(context.declared, 2);
+assert.strictEqual(context.added, 3);
+assert.strictEqual(sandbox.count, 1);
+assert.strictEqual(vm.runInContext('this', context), context);
+
+context.fromOutside = 4;
+assert.strictEqual(vm.runInContext('fromOutside', context), 4);
+assert.strictEqual(vm.runInContext('typeof Array', context), 'function');
+assert.notStrictEqual(vm.runInContext('Array', context), Array);
+
+const empty = vm.createContext(undefined, { interceptors: false });
+assert.strictEqual(vm.runInContext('typeof count', empty), 'undefined');
+
+assert.throws(() => vm.resetContext(context), TypeError);
+assert.throws(() => vm.createContext(context, { interceptors: false }),
+              TypeError);
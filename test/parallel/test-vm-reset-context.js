@@ -0,0 +1,45 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const vm = require('vm');
+
+// A context moves to the new sandbox, without what earlier scripts added to
+// its global.
+
+const first = vm.createContext({ a: 1 });
+vm.runInContext('var declared = 1; this.added = 2; b = a + 1;', first);
+vm.runInContext('Object.defineProperty(this, "defined", { value: 3, ' +
+                'configurable: true });', first);
+assert.strictEqual(first.b, 2);
+const getGlobal = vm.runInContext('(function() { return this; })', first);
+
+const second = vm.resetContext(first, { a: 10 });
+assert(!vm.isContext(first));
+assert(vm.isContext(second));
+assert.deepStrictEqual(Object.keys(first).sort(), ['a', 'added', 'b',
+                                                   'declared']);
+assert.strictEqual(vm.runInContext('typeof added', second), 'undefined');
+assert.strictEqual(vm.runInContext('typeof defined', second), 'undefined');
+assert.strictEqual(vm.runInContext('typeof declared', second), 'undefined');
+assert.strictEqual(vm.runInContext('typeof b', second), 'undefined');
+assert.strictEqual(vm.runInContext('a', second), 10);
+assert.strictEqual(vm.runInContext('Array.isArray([])', second), true);
+assert.strictEqual(vm.runInContext('c = a * 2', second), 20);
+assert.strictEqual(second.c, 20);
+
+// Functions of earlier scripts run in the same context.
+assert.strictEqual(getGlobal().a, 10);
+
+const third = vm.resetContext(second);
+assert.deepStrictEqual(Object.keys(third), []);
+assert.strictEqual(vm.runInContext('typeof c', third), 'undefined');
+
+assert.throws(() => vm.resetContext({}), TypeError);
+assert.throws(() => vm.resetContext(third, third), TypeError);
+assert.throws(() => vm.resetContext(third, 1), TypeError);
+
+// Contexts of sandboxes that are not plain objects keep working.
+class Sandbox {}
+const custom = vm.createContext(new Sandbox());
+vm.runInContext('x = 1', custom);
+assert.strictEqual(custom.x, 1);
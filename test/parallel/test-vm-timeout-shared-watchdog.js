@@ -0,0 +1,38 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const vm = require('vm');
+
+// All timeouts share one watchdog thread. Scripts that finish in time are
+// not terminated by the deadlines of those that came before them.
+for (let i = 0; i < 1000; i++)
+  assert.strictEqual(vm.runInThisContext(`${i} + 1`, { timeout: 1000 + i % 5 }),
+                     i + 1);
+
+// A timeout still terminates its script after many have been armed and
+// disarmed.
+for (let i = 0; i < 3; i++) {
+  assert.throws(function() {
+    vm.runInNewContext('while(true) {}', {}, { timeout: 10 });
+  }, /^Error: Script execution timed out\.$/);
+}
+
+// The nearest deadline is the one that fires, whatever order the timeouts
+// were armed in.
+const context = {
+  vm,
+  inner: () => vm.runInNewContext('while(true) {}', {}, { timeout: 10 })
+};
+assert.throws(function() {
+  vm.runInNewContext('vm.runInNewContext("inner()", { inner }, ' +
+                     '{ timeout: 10000 })', context, { timeout: 100000 });
+}, /^Error: Script execution timed out\.$/);
+
+// A short deadline of an outer script fires while a longer one of an inner
+// script is armed.
+const start = Date.now();
+assert.throws(function() {
+  vm.runInNewContext('vm.runInNewContext("while(true) {}", {}, ' +
+                     '{ timeout: 100000 })', { vm }, { timeout: 50 });
+}, /^Error: Script execution timed out\.$/);
+assert(Date.now() - start < 10000);
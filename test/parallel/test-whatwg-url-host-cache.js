@@ -0,0 +1,40 @@
+'use strict';
+const common = require('../common');
+
+if (!common.hasIntl) {
+  common.skip('missing Intl');
+  return;
+}
+
+// Parsed hosts are cached. Results come out the same when they are cached,
+// when they are not anymore, and for ASCII and Unicode serialization of the
+// same input.
+
+const assert = require('assert');
+const { URL, domainToASCII, domainToUnicode } = require('url');
+
+function check() {
+  assert.strictEqual(domainToASCII('Ñ.Example'), 'xn--ida.example');
+  assert.strictEqual(domainToUnicode('Ñ.Example'), 'ñ.example');
+  assert.strictEqual(domainToASCII('\ufffd.com'), '');
+  assert.strictEqual(new URL('http://0x7F.1/').host, '127.0.0.1');
+  assert.strictEqual(new URL('http://[0:0::1]/').host, '[::1]');
+  assert.strictEqual(new URL('http://%E2%82%AC.Example/').host,
+                     'xn--lzg.example');
+  assert.throws(() => new URL('http://a%00b/'), /^TypeError: Invalid URL/);
+}
+
+check();
+check();
+
+// More hosts than are kept.
+for (let i = 0; i < 2000; i++)
+  assert.strictEqual(domainToASCII(`Host${i}.Example`), `host${i}.example`);
+check();
+
+// Hosts too long to be kept.
+const long = 'a'.repeat(300);
+for (let i = 0; i < 2; i++) {
+  assert.strictEqual(domainToASCII(long), '');
+  assert.throws(() => new URL(`http://${long}/`), /^TypeError: Invalid URL/);
+}
@@ -0,0 +1,44 @@
+'use strict';
+require('../common');
+
+// URLSearchParams parses and serializes application/x-www-form-urlencoded
+// strings natively.
+
+const assert = require('assert');
+const URLSearchParams = require('url').URLSearchParams;
+
+function entries(init) {
+  const out = [];
+  for (const [name, value] of new URLSearchParams(init))
+    out.push(name, value);
+  return out;
+}
+
+assert.deepStrictEqual(entries(''), []);
+assert.deepStrictEqual(entries('&&'), []);
+assert.deepStrictEqual(entries('a&b=&=c&=&a=b=c'),
+                       ['a', '', 'b', '', '', 'c', '', '', 'a', 'b=c']);
+assert.deepStrictEqual(
+  entries('%C3%A9=%E2%82%AC&%FF=%C3&x=%Zz%2&+=%2B'),
+  ['é', '€', '�', '�', 'x', '%Zz%2', ' ', '+']);
+
+// Characters that are not ASCII are encoded as UTF-8 before percent-encoded
+// bytes are decoded, also when the bytes are not valid UTF-8.
+assert.deepStrictEqual(entries('é=%C3%A9&€%20=%E2%82%AC'),
+                       ['é', 'é', '€ ', '€']);
+assert.deepStrictEqual(entries('%FFé=1'), ['�é', '1']);
+assert.deepStrictEqual(entries('😀=\ud800'),
+                       ['😀', '�']);
+
+{
+  const params = new URLSearchParams();
+  params.append('a b', 'c+d');
+  params.append('*-._~!', 'é€😀');
+  params.append('', '=');
+  params.append('&%', '\n');
+  const serialized =
+    'a+b=c%2Bd&*-._%7E%21=%C3%A9%E2%82%AC%F0%9F%98%80&=%3D&%26%25=%0A';
+  assert.strictEqual(params.toString(), serialized);
+  assert.strictEqual(new URLSearchParams(serialized).toString(), serialized);
+  assert.strictEqual(new URLSearchParams().toString(), '');
+}
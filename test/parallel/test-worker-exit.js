@@ -0,0 +1,44 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const worker = require('worker');
+
+if (worker.isMainThread) {
+  // process.exit() only ends the thread it is called on.
+  const exiting = new worker.Worker(__filename);
+  exiting.postMessage('exit');
+  exiting.on('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 42);
+  }));
+
+  // terminate() stops a worker that never yields.
+  const spinning = new worker.Worker(__filename);
+  spinning.postMessage('spin');
+  spinning.on('message', common.mustCall((message) => {
+    assert.strictEqual(message, 'spinning');
+    spinning.terminate(common.mustCall((err, code) => {
+      assert.ifError(err);
+      assert.strictEqual(code, 1);
+    }));
+  }));
+
+  // An uncaught exception ends the thread with 1.
+  const throwing = new worker.Worker(__filename);
+  throwing.postMessage('throw');
+  throwing.on('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 1);
+  }));
+} else {
+  worker.parentPort.once('message', (command) => {
+    switch (command) {
+      case 'exit':
+        process.exit(42);
+        break;
+      case 'spin':
+        worker.parentPort.postMessage('spinning');
+        for (;;);
+      case 'throw':
+        throw new Error('uncaught in a worker');
+    }
+  });
+}
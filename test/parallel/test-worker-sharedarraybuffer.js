@@ -0,0 +1,43 @@
+/*global SharedArrayBuffer, Atomics*/
+'use strict';
+// Flags: --harmony-sharedarraybuffer
+
+const common = require('../common');
+const assert = require('assert');
+const worker = require('worker');
+
+if (worker.isMainThread) {
+  // Small ones come from the arena of the allocator, large ones don't.
+  const small = new SharedArrayBuffer(16);
+  const large = new SharedArrayBuffer(1024 * 1024);
+  const w = new worker.Worker(__filename);
+
+  new Int32Array(small)[0] = 1;
+  new Uint8Array(large).fill(3);
+  w.postMessage({ small, large, again: small });
+  // Nothing is neutered or copied.
+  assert.strictEqual(small.byteLength, 16);
+
+  w.on('message', common.mustCall((message) => {
+    assert.strictEqual(message, 'done');
+    const view = new Int32Array(small);
+    assert.strictEqual(Atomics.load(view, 0), 2);
+    assert.strictEqual(Atomics.load(view, 1), 1024 * 1024 * 3);
+  }));
+  w.on('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 0);
+    // The memory outlives the thread that used it last.
+    assert.strictEqual(new Int32Array(small)[0], 2);
+  }));
+} else {
+  worker.parentPort.once('message', common.mustCall((message) => {
+    // One SharedArrayBuffer stays one object on the receiving side.
+    assert.strictEqual(message.again, message.small);
+    const view = new Int32Array(message.small);
+    assert.strictEqual(Atomics.load(view, 0), 1);
+    const sum = new Uint8Array(message.large).reduce((a, b) => a + b, 0);
+    Atomics.store(view, 1, sum);
+    Atomics.add(view, 0, 1);
+    worker.parentPort.postMessage('done');
+  }));
+}
@@ -0,0 +1,41 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const crypto = require('crypto');
+const worker = require('worker');
+
+// Work queued from several loops at once goes back to the loop that queued
+// it, and a Worker's small random values come from its own pool.
+function queueWork(done) {
+  let pending = 2;
+  crypto.pbkdf2('password', 'salt', 1000, 32, 'sha256', (err, key) => {
+    assert.ifError(err);
+    assert.strictEqual(key.length, 32);
+    if (--pending === 0) done();
+  });
+  for (let i = 0; i < 1000; i++)
+    assert.strictEqual(crypto.randomBytes(64).length, 64);
+  crypto.randomBytes(1024, (err, bytes) => {
+    assert.ifError(err);
+    assert.strictEqual(bytes.length, 1024);
+    if (--pending === 0) done();
+  });
+}
+
+if (worker.isMainThread) {
+  for (let i = 0; i < 4; i++) {
+    const w = new worker.Worker(__filename);
+    w.on('message', common.mustCall((message) => {
+      assert.strictEqual(message, 'done');
+    }));
+    w.on('exit', common.mustCall((code) => {
+      assert.strictEqual(code, 0);
+    }));
+  }
+  queueWork(common.mustCall());
+} else {
+  queueWork(() => worker.parentPort.postMessage('done'));
+}
@@ -0,0 +1,51 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const worker = require('worker');
+
+if (worker.isMainThread) {
+  assert.strictEqual(worker.parentPort, null);
+  assert.strictEqual(worker.threadId, 0);
+
+  const w = new worker.Worker(__filename);
+  assert.ok(w.threadId > 0);
+
+  const buffer = new ArrayBuffer(16);
+  new Uint8Array(buffer).fill(7);
+  w.postMessage({ greeting: 'hello', nested: [1, { two: 2 }], buffer },
+                [buffer]);
+  // The memory of a transferred ArrayBuffer moves to the other thread.
+  assert.strictEqual(buffer.byteLength, 0);
+
+  assert.throws(() => w.postMessage({ f() {} }), /could not be cloned/);
+  assert.throws(() => w.postMessage(null, [new Uint8Array(1)]), TypeError);
+
+  w.on('message', common.mustCall((message) => {
+    assert.strictEqual(message.greeting, 'hello');
+    assert.deepStrictEqual(message.nested, [1, { two: 2 }]);
+    assert.strictEqual(message.sum, 16 * 7);
+    assert.strictEqual(message.threadId, w.threadId);
+    assert.strictEqual(message.reply.byteLength, 4);
+    assert.deepStrictEqual(Array.from(new Uint8Array(message.reply)),
+                           [1, 2, 3, 4]);
+  }));
+  w.on('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 0);
+  }));
+} else {
+  assert.ok(worker.threadId > 0);
+  assert.throws(() => process.chdir('..'), /not supported in workers/);
+
+  // The worker ends once it stops listening.
+  worker.parentPort.once('message', common.mustCall((message) => {
+    const view = new Uint8Array(message.buffer);
+    const reply = new Uint8Array([1, 2, 3, 4]).buffer;
+    worker.parentPort.postMessage({
+      greeting: message.greeting,
+      nested: message.nested,
+      sum: view.reduce((a, b) => a + b, 0),
+      threadId: worker.threadId,
+      reply
+    }, [reply]);
+  }));
+}
@@ -0,0 +1,63 @@
+'use strict';
+const common = require('../common');
+
+const zlib = require('zlib');
+if (typeof zlib.brotliCompress !== 'function') {
+  common.skip('missing Brotli support');
+  return;
+}
+
+const assert = require('assert');
+
+const input = Buffer.from('{"hello":"world","n":12345}'.repeat(1000));
+
+// One shot, both sync and async, with all qualities.
+for (let quality = zlib.constants.BROTLI_MIN_QUALITY;
+  quality <= zlib.constants.BROTLI_MAX_QUALITY;
+  quality++) {
+  const compressed = zlib.brotliCompressSync(input, { quality });
+  assert(compressed.length < input.length);
+  assert.deepStrictEqual(zlib.brotliDecompressSync(compressed), input);
+}
+
+zlib.brotliCompress(input, common.mustCall((err, compressed) => {
+  assert.ifError(err);
+  zlib.brotliDecompress(compressed, common.mustCall((err, result) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(result, input);
+  }));
+}));
+
+// Streams, with small chunks and a flush in between.
+{
+  const compress = zlib.createBrotliCompress({ quality: 4, chunkSize: 64 });
+  const decompress = zlib.createBrotliDecompress({ chunkSize: 64 });
+  const chunks = [];
+  decompress.on('data', (chunk) => chunks.push(chunk));
+  decompress.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(Buffer.concat(chunks), input);
+  }));
+  compress.pipe(decompress);
+  compress.write(input.slice(0, 1000));
+  compress.flush(common.mustCall(() => {
+    compress.end(input.slice(1000));
+  }));
+}
+
+// Truncated and corrupt input.
+const compressed = zlib.brotliCompressSync(input);
+assert.throws(() => zlib.brotliDecompressSync(compressed.slice(0, 10)),
+              /^Error: unexpected end of file$/);
+zlib.brotliDecompress(Buffer.from('not brotli at all'),
+                      common.mustCall((err) => {
+                        assert.strictEqual(err.code, 'Z_DATA_ERROR');
+                      }));
+
+// Options.
+assert.throws(() => zlib.brotliCompressSync(input, { quality: 12 }),
+              /^RangeError: Invalid quality: 12$/);
+assert.throws(() => zlib.brotliCompressSync(input, { windowBits: 9 }),
+              /^RangeError: Invalid windowBits: 9$/);
+assert.deepStrictEqual(
+  zlib.brotliDecompressSync(zlib.brotliCompressSync(input, { windowBits: 24 })),
+  input);
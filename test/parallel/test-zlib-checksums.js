@@ -0,0 +1,59 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const zlib = require('zlib');
+
+const check = '123456789';
+assert.strictEqual(zlib.crc32(check), 0xcbf43926);
+assert.strictEqual(zlib.crc32c(check), 0xe3069283);
+assert.strictEqual(zlib.adler32(check), 0x091e01de);
+
+for (const fn of [zlib.crc32, zlib.crc32c, zlib.adler32]) {
+  const empty = fn === zlib.adler32 ? 1 : 0;
+  assert.strictEqual(fn(''), empty);
+  assert.strictEqual(fn(Buffer.alloc(0)), empty);
+  assert.strictEqual(fn('', 1234), 1234);
+
+  // Strings are checksummed as UTF-8, and all kinds of views the same way.
+  const text = 'grüße, 世界';
+  const buffer = Buffer.from(text);
+  const expected = fn(buffer);
+  assert.strictEqual(fn(text), expected);
+  assert.strictEqual(fn(new Uint8Array(buffer)), expected);
+  const offset = Buffer.concat([Buffer.from('xyz'), buffer]).slice(3);
+  assert.strictEqual(fn(new DataView(offset.buffer, offset.byteOffset,
+                                     offset.length)), expected);
+
+  // Checksumming in pieces, of every alignment and length, gives the same
+  // result as all at once.
+  const data = Buffer.alloc(1000);
+  for (let i = 0; i < data.length; i++)
+    data[i] = (i * 31 + 7) & 0xff;
+  const whole = fn(data);
+  for (let split = 0; split <= 40; split++) {
+    const first = fn(data.slice(0, split));
+    assert.strictEqual(fn(data.slice(split), first), whole);
+  }
+  let value;
+  for (let i = 0; i < data.length; i += 13)
+    value = fn(data.slice(i, i + 13), value);
+  assert.strictEqual(value, whole);
+
+  assert.throws(() => fn(42),
+                /^TypeError: "data" argument must be a string, Buffer, /);
+  assert.throws(() => fn('', -1),
+                /^TypeError: "value" argument must be an unsigned 32-bit/);
+  assert.throws(() => fn('', 2 ** 32),
+                /^TypeError: "value" argument must be an unsigned 32-bit/);
+}
+
+// The CRC-32 that gzip streams end with.
+{
+  const input = Buffer.from('x'.repeat(10000) + 'end');
+  const gzipped = zlib.gzipSync(input);
+  assert.strictEqual(gzipped.readUInt32LE(gzipped.length - 8),
+                     zlib.crc32(input));
+  const deflated = zlib.deflateSync(input);
+  assert.strictEqual(deflated.readUInt32BE(deflated.length - 4),
+                     zlib.adler32(input));
+}
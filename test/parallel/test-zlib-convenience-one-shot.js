@@ -0,0 +1,58 @@
+'use strict';
+const common = require('../common');
+
+// The convenience methods process their input in one go. Check output that
+// is much larger than the input, errors, and that they agree with the
+// streams.
+
+const assert = require('assert');
+const zlib = require('zlib');
+
+const zeros = Buffer.alloc(4 * 1024 * 1024);
+const text = Buffer.from('{"hello":"world","n":12345}'.repeat(1000));
+
+[zeros, text, Buffer.alloc(0)].forEach((input) => {
+  const deflated = zlib.deflateSync(input);
+  assert.deepStrictEqual(zlib.inflateSync(deflated), input);
+  assert.deepStrictEqual(zlib.unzipSync(zlib.gzipSync(input)), input);
+
+  zlib.gzip(input, common.mustCall((err, gzipped) => {
+    assert.ifError(err);
+    zlib.gunzip(gzipped, common.mustCall((err, result) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(result, input);
+    }));
+  }));
+
+  // opts.flush still goes through a stream, with the same result.
+  zlib.deflate(input, { flush: zlib.constants.Z_SYNC_FLUSH },
+               common.mustCall((err, result) => {
+                 assert.ifError(err);
+                 assert.deepStrictEqual(zlib.inflateSync(result), input);
+               }));
+});
+
+// A truncated input is an error, unless the final flush says otherwise.
+const truncated = zlib.gzipSync(text).slice(0, 100);
+assert.throws(() => zlib.gunzipSync(truncated),
+              /^Error: unexpected end of file$/);
+assert.strictEqual(
+  text.indexOf(zlib.gunzipSync(truncated, {
+    finishFlush: zlib.constants.Z_SYNC_FLUSH
+  })), 0);
+
+let sync = true;
+zlib.gunzip(truncated, common.mustCall((err, result) => {
+  assert.strictEqual(sync, false);
+  assert.strictEqual(err.code, 'Z_BUF_ERROR');
+  assert.strictEqual(result, undefined);
+}));
+zlib.inflate(Buffer.from('not zlib'), common.mustCall((err) => {
+  assert.strictEqual(sync, false);
+  assert.strictEqual(err.code, 'Z_DATA_ERROR');
+}));
+sync = false;
+
+// Options are checked before the input.
+assert.throws(() => zlib.deflateSync(null, { level: 42 }),
+              /^RangeError: Invalid compression level: 42$/);
@@ -0,0 +1,74 @@
+'use strict';
+const common = require('../common');
+
+// ParallelGzip compresses blocks at the same time and puts their output
+// together into one gzip stream.
+
+const assert = require('assert');
+const zlib = require('zlib');
+
+assert.throws(() => zlib.createParallelGzip({ blockSize: 1024 }),
+              /^RangeError: Invalid block size: 1024$/);
+assert.throws(() => zlib.createParallelGzip({ concurrency: 0.5 }),
+              /^RangeError: Invalid concurrency: 0\.5$/);
+assert.throws(() => zlib.createParallelGzip({ level: 42 }),
+              /^RangeError: Invalid compression level: 42$/);
+
+// Records that compress about as well as typical exports.
+let records = '';
+let seed = 1;
+for (let id = 0; records.length < 1024 * 1024; id++) {
+  seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+  records += `{"id":${id},"name":"user ${seed % 1000}","score":${seed}}\n`;
+}
+const input = Buffer.from(records);
+
+function compress(opts, data, chunkSize, callback) {
+  const gzip = zlib.createParallelGzip(opts);
+  const chunks = [];
+  gzip.on('data', (chunk) => chunks.push(chunk));
+  gzip.on('end', common.mustCall(() => callback(Buffer.concat(chunks))));
+  for (let i = 0; i < data.length; i += chunkSize)
+    gzip.write(data.slice(i, i + chunkSize));
+  gzip.end();
+}
+
+[
+  [{}, 64 * 1024],
+  [{ blockSize: 32 * 1024, concurrency: 2 }, 7777],
+  [{ blockSize: 100000, level: 9 }, 1024 * 1024],
+  [{ level: 1, strategy: zlib.constants.Z_FILTERED }, 3000],
+  [{ level: 0 }, 128 * 1024]
+].forEach(([opts, chunkSize]) => {
+  compress(opts, input, chunkSize, (compressed) => {
+    const expected = zlib.gzipSync(input, opts);
+    // Same header, and same trailer with CRC-32 and length.
+    assert.deepStrictEqual(compressed.slice(0, 10), expected.slice(0, 10));
+    assert.deepStrictEqual(compressed.slice(-8), expected.slice(-8));
+    assert.deepStrictEqual(zlib.gunzipSync(compressed), input);
+    // Priming each block with the one before keeps the output close in size.
+    if (opts.level !== 0)
+      assert(compressed.length < expected.length * 1.1);
+  });
+});
+
+// Empty input, and input that fits in a block.
+compress({}, Buffer.alloc(0), 1, (compressed) => {
+  assert.deepStrictEqual(zlib.gunzipSync(compressed), Buffer.alloc(0));
+});
+compress({}, Buffer.from('hello'), 1, (compressed) => {
+  assert.strictEqual(zlib.gunzipSync(compressed).toString(), 'hello');
+});
+
+// It is a stream like the others.
+{
+  const gzip = zlib.createParallelGzip({ blockSize: 32 * 1024 });
+  const gunzip = zlib.createGunzip();
+  const chunks = [];
+  gzip.pipe(gunzip);
+  gunzip.on('data', (chunk) => chunks.push(chunk));
+  gunzip.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(Buffer.concat(chunks), input);
+  }));
+  gzip.end(input);
+}
@@ -0,0 +1,58 @@
+'use strict';
+const common = require('../common');
+
+// releaseMemory() frees the state of idle streams, which start over with the
+// next write like after reset().
+
+const assert = require('assert');
+const zlib = require('zlib');
+
+const messages = ['hello hello', 'world world', 'hello hello'];
+const opts = { finishFlush: zlib.constants.Z_SYNC_FLUSH };
+
+function roundTrip(stream, input, callback) {
+  const chunks = [];
+  const onData = (chunk) => chunks.push(chunk);
+  stream.on('data', onData);
+  stream.write(input);
+  stream.flush(zlib.constants.Z_SYNC_FLUSH, common.mustCall(() => {
+    stream.removeListener('data', onData);
+    callback(Buffer.concat(chunks));
+  }));
+}
+
+const deflate = zlib.createDeflateRaw();
+const inflate = zlib.createInflateRaw(opts);
+const compressed = [];
+
+(function next(i) {
+  if (i === messages.length) {
+    // A released stream compresses like a new one.
+    assert.deepStrictEqual(compressed[2], compressed[0]);
+    assert.deepStrictEqual(compressed[0],
+                           zlib.deflateRawSync(messages[0], opts));
+
+    // Nothing is freed while a write is in progress.
+    deflate.write('one more');
+    assert.strictEqual(deflate.releaseMemory(), false);
+    deflate.end();
+    deflate.resume();
+    deflate.on('end', common.mustCall());
+    inflate.end();
+    return;
+  }
+
+  roundTrip(deflate, messages[i], (output) => {
+    compressed.push(output);
+    assert.strictEqual(zlib.inflateRawSync(output, opts).toString(),
+                       messages[i]);
+    assert.strictEqual(deflate.releaseMemory(), true);
+    assert.strictEqual(deflate.releaseMemory(), true);
+
+    roundTrip(inflate, output, (result) => {
+      assert.strictEqual(result.toString(), messages[i]);
+      assert.strictEqual(inflate.releaseMemory(), true);
+      next(i + 1);
+    });
+  });
+})(0);
@@ -0,0 +1,89 @@
+'use strict';
+const common = require('../common');
+
+// A dictionary from zlib.createDictionary() works like the buffer it was made
+// from, for streams and for the convenience methods, whose handles are reused
+// between calls.
+
+const assert = require('assert');
+const zlib = require('zlib');
+
+const data = Buffer.from('{"id":,"name":"","tags":["a","b"]}');
+const dictionary = zlib.createDictionary(data);
+const input = Buffer.from('{"id":1,"name":"abc","tags":["a","b"]}');
+
+assert.throws(() => zlib.createDictionary(42),
+              /^TypeError: "data" argument must be a string, Buffer, /);
+assert.throws(() => zlib.deflateSync(input, { dictionary: {} }),
+              /^TypeError: Invalid dictionary: it should be a Buffer, /);
+
+[
+  ['deflateSync', 'inflateSync', {}],
+  ['deflateRawSync', 'inflateRawSync', {}],
+  ['deflateSync', 'inflateSync', { level: 1, windowBits: 10 }],
+  ['deflateRawSync', 'inflateRawSync', { strategy: zlib.constants.Z_RLE }]
+].forEach(([deflate, inflate, opts]) => {
+  const withBuffer = Object.assign({ dictionary: data }, opts);
+  const withShared = Object.assign({ dictionary }, opts);
+  const expected = zlib[deflate](input, withBuffer);
+
+  // Same output the first time, when the dictionary is loaded, and later,
+  // when the handle is a reset one.
+  for (let i = 0; i < 3; i++) {
+    const compressed = zlib[deflate](input, withShared);
+    assert.deepStrictEqual(compressed, expected);
+    assert.deepStrictEqual(zlib[inflate](compressed, withShared), input);
+    assert.deepStrictEqual(zlib[inflate](compressed, withBuffer), input);
+  }
+  assert(expected.length < zlib[deflate](input, opts).length);
+});
+
+// Data compressed with a dictionary can't be inflated without it or with
+// another one, and a failed call does not break the next one.
+{
+  const compressed = zlib.deflateSync(input, { dictionary });
+  const other = zlib.createDictionary('something else');
+  assert.throws(() => zlib.inflateSync(compressed),
+                /^Error: Missing dictionary$/);
+  assert.throws(() => zlib.inflateSync(compressed, { dictionary: other }),
+                /^Error: Bad dictionary$/);
+  assert.throws(() => zlib.inflateSync(Buffer.from('garbage'),
+                                       { dictionary }),
+                /^Error: incorrect header check$/);
+  assert.deepStrictEqual(zlib.inflateSync(compressed, { dictionary }), input);
+}
+
+// The async methods, several at once so that more handles are in use than
+// are kept.
+for (let i = 0; i < 8; i++) {
+  zlib.deflate(input, { dictionary }, common.mustCall((err, compressed) => {
+    assert.ifError(err);
+    zlib.inflate(compressed, { dictionary }, common.mustCall((err, result) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(result, input);
+    }));
+  }));
+}
+
+// Streams.
+{
+  const deflate = zlib.createDeflate({ dictionary });
+  const inflate = zlib.createInflate({ dictionary });
+  const chunks = [];
+  deflate.pipe(inflate);
+  inflate.on('data', (chunk) => chunks.push(chunk));
+  inflate.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(Buffer.concat(chunks),
+                           Buffer.concat([input, input]));
+  }));
+  deflate.write(input);
+  deflate.end(input);
+}
+
+// More kinds of options than pools are kept.
+for (let level = 1; level <= 9; level++) {
+  for (let memLevel = 8; memLevel <= 9; memLevel++) {
+    const opts = { level, memLevel };
+    assert.deepStrictEqual(zlib.gunzipSync(zlib.gzipSync(input, opts)), input);
+  }
+}
@@ -0,0 +1,168 @@
+// Generates the V8 code caches of the core modules at build time, as the
+// C++ file that src/node_code_cache.h describes. It compiles the sources
+// that js2c embeds into node, in a V8 with the flags that node sets by
+// default, so that node accepts the caches when it runs with V8's defaults.
+//
+// Usage: mkcodecache <output file>
+
+#include "libplatform/libplatform.h"
+#include "v8.h"
+
+#include "node_javascript_sources.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+using node::code_cache::NativeSource;
+using node::code_cache::native_sources;
+
+// NativeModule.wrapper in lib/internal/bootstrap_node.js.
+const char kWrapperBegin[] =
+    "(function (exports, require, module, __filename, __dirname) { ";
+const char kWrapperEnd[] = "\n});";
+
+// The bootstrap script is compiled as is rather than as a module.
+const char kBootstrapId[] = "internal/bootstrap_node";
+
+class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
+ public:
+  void* Allocate(size_t size) override { return calloc(size, 1); }
+  void* AllocateUninitialized(size_t size) override { return malloc(size); }
+  void Free(void* data, size_t) override { free(data); }
+};
+
+// The flags that node::Init() sets before any user flags. The cache is
+// rejected if the V8 flags differ.
+void SetNodeFlags() {
+#if defined(NODE_HAVE_I18N_SUPPORT)
+  const char icu_case_mapping[] = "--icu_case_mapping";
+  v8::V8::SetFlagsFromString(icu_case_mapping, sizeof(icu_case_mapping) - 1);
+#endif
+#if defined(NODE_V8_OPTIONS)
+  v8::V8::SetFlagsFromString(NODE_V8_OPTIONS, sizeof(NODE_V8_OPTIONS) - 1);
+#endif
+  const char no_typed_array_heap[] = "--typed_array_max_size_in_heap=0";
+  v8::V8::SetFlagsFromString(no_typed_array_heap,
+                             sizeof(no_typed_array_heap) - 1);
+}
+
+// Returns an empty string if |source| doesn't compile, like the config.
+std::string ProduceCache(v8::Isolate* isolate, const NativeSource& source) {
+  std::string code;
+  if (strcmp(source.id, kBootstrapId) != 0)
+    code += kWrapperBegin;
+  code.append(reinterpret_cast<const char*>(source.data), source.length);
+  if (strcmp(source.id, kBootstrapId) != 0)
+    code += kWrapperEnd;
+
+  v8::HandleScope handle_scope(isolate);
+  v8::TryCatch try_catch(isolate);
+  v8::Local<v8::String> code_string =
+      v8::String::NewFromUtf8(isolate, code.data(), v8::NewStringType::kNormal,
+                              static_cast<int>(code.size())).ToLocalChecked();
+  const std::string name = std::string(source.id) + ".js";
+  v8::Local<v8::String> filename =
+      v8::String::NewFromUtf8(isolate, name.c_str(),
+                              v8::NewStringType::kNormal).ToLocalChecked();
+  v8::ScriptOrigin origin(filename);
+  v8::ScriptCompiler::Source script_source(code_string, origin);
+  v8::MaybeLocal<v8::UnboundScript> script =
+      v8::ScriptCompiler::CompileUnboundScript(
+          isolate, &script_source, v8::ScriptCompiler::kProduceCodeCache);
+  const v8::ScriptCompiler::CachedData* cached_data =
+      script_source.GetCachedData();
+  if (script.IsEmpty() || cached_data == nullptr)
+    return std::string();
+  return std::string(reinterpret_cast<const char*>(cached_data->data),
+                     cached_data->length);
+}
+
+void WriteArray(FILE* out, size_t index, const std::string& data) {
+  fprintf(out, "static const uint8_t cache_%zu[] = {\n", index);
+  for (size_t i = 0; i < data.size(); i++) {
+    fprintf(out, "%s%u,", i % 16 == 0 ? "  " : "",
+            static_cast<uint8_t>(data[i]));
+    if (i % 16 == 15 || i + 1 == data.size())
+      fputc('\n', out);
+  }
+  fputs("};\n\n", out);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s <output file>\n", argv[0]);
+    return 1;
+  }
+
+  v8::V8::InitializeICUDefaultLocation(argv[0]);
+  v8::Platform* platform = v8::platform::CreateDefaultPlatform();
+  v8::V8::InitializePlatform(platform);
+  SetNodeFlags();
+  v8::V8::Initialize();
+
+  ArrayBufferAllocator allocator;
+  v8::Isolate::CreateParams params;
+  params.array_buffer_allocator = &allocator;
+  v8::Isolate* isolate = v8::Isolate::New(params);
+
+  std::vector<std::pair<const char*, std::string>> caches;
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    for (const NativeSource& source : native_sources) {
+      std::string cache = ProduceCache(isolate, source);
+      if (!cache.empty())
+        caches.emplace_back(source.id, cache);
+    }
+  }
+  isolate->Dispose();
+  v8::V8::Dispose();
+  v8::V8::ShutdownPlatform();
+  delete platform;
+
+  if (caches.empty()) {
+    fprintf(stderr, "%s: V8 produced no code cache\n", argv[0]);
+    return 1;
+  }
+
+  FILE* out = fopen(argv[1], "w");
+  if (out == nullptr) {
+    perror(argv[1]);
+    return 1;
+  }
+  fprintf(out,
+          "// Generated by tools/code_cache/mkcodecache.cc for V8 %s. "
+          "Do not edit.\n\n"
+          "#include \"node_code_cache.h\"\n\n"
+          "namespace node {\n"
+          "namespace code_cache {\n\n",
+          v8::V8::GetVersion());
+  for (size_t i = 0; i < caches.size(); i++)
+    WriteArray(out, i, caches[i].second);
+  fputs("static const Entry all_entries[] = {\n", out);
+  for (size_t i = 0; i < caches.size(); i++) {
+    fprintf(out, "  { \"%s\", cache_%zu, sizeof(cache_%zu) },\n",
+            caches[i].first, i, i);
+  }
+  fputs("};\n\n"
+        "const Entry* const entries = all_entries;\n"
+        "const size_t entry_count = "
+        "sizeof(all_entries) / sizeof(all_entries[0]);\n\n"
+        "}  // namespace code_cache\n"
+        "}  // namespace node\n", out);
+  if (fclose(out) != 0) {
+    perror(argv[1]);
+    return 1;
+  }
+  return 0;
+}
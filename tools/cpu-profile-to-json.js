@@ -0,0 +1,18 @@
+'use strict';
+
+// Converts a CPU profile written by v8.stopCpuProfile() into the
+// .cpuprofile format that Chrome DevTools loads. See
+// src/cpu_profile_writer.h for a description of the binary format.
+//
+// Usage: node tools/cpu-profile-to-json.js CPU.nodecpuprofile > CPU.cpuprofile
+
+const fs = require('fs');
+const v8 = require('v8');
+
+if (process.argv.length !== 3) {
+  console.error('Usage: node tools/cpu-profile-to-json.js <profile>');
+  process.exit(1);
+}
+
+const profile = v8.convertCpuProfile(fs.readFileSync(process.argv[2]));
+process.stdout.write(JSON.stringify(profile));
@@ -0,0 +1,75 @@
+'use strict';
+
+// Generates the V8 code caches of the core modules of the node binary that
+// runs this script, as a C++ file for src/node_code_cache.h. Build node,
+// generate the file with it, then configure the next build to compile it in:
+//
+//   out/Release/node tools/generate_code_cache.js out/node_code_cache.cc
+//   ./configure --code-cache-path out/node_code_cache.cc && make
+//
+// The caches only help a binary with the same core modules and V8, and V8
+// rejects them if it runs with different V8 flags than this script.
+
+const fs = require('fs');
+const vm = require('vm');
+const wrap = require('module').wrap;
+
+const natives = process.binding('natives');
+
+if (process.argv.length !== 3) {
+  console.error('Usage: node tools/generate_code_cache.js <output file>');
+  process.exit(1);
+}
+
+function toArray(name, data) {
+  const lines = [];
+  for (let i = 0; i < data.length; i += 16)
+    lines.push(`  ${Array.prototype.join.call(data.slice(i, i + 16), ',')},`);
+  return `static const uint8_t ${name}[] = {\n${lines.join('\n')}\n};\n`;
+}
+
+const arrays = [];
+const entries = [];
+
+for (const id of Object.keys(natives).sort()) {
+  // The bootstrap script is compiled as is, everything else the way
+  // NativeModule compiles it, which is all that the cache depends on.
+  const source = id === 'internal/bootstrap_node' ?
+    natives[id] : wrap(natives[id]);
+  let script;
+  try {
+    script = new vm.Script(source, {
+      filename: `${id}.js`,
+      produceCachedData: true
+    });
+  } catch (e) {
+    // Not a script, like the config.
+    continue;
+  }
+  if (!script.cachedDataProduced)
+    continue;
+  const name = `cache_${entries.length}`;
+  arrays.push(toArray(name, script.cachedData));
+  entries.push(`  { "${id}", ${name}, sizeof(${name}) },`);
+}
+
+fs.writeFileSync(process.argv[2], `\
+// Generated by tools/generate_code_cache.js for Node.js ${process.version}
+// and V8 ${process.versions.v8}. Do not edit.
+
+#include "node_code_cache.h"
+
+namespace node {
+namespace code_cache {
+
+${arrays.join('\n')}
+static const Entry all_entries[] = {
+${entries.join('\n')}
+};
+
+const Entry* const entries = all_entries;
+const size_t entry_count = sizeof(all_entries) / sizeof(all_entries[0]);
+
+}  // namespace code_cache
+}  // namespace node
+`);
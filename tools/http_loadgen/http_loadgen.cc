@@ -0,0 +1,425 @@
+// A small HTTP/1.1 load generator for the benchmarks in benchmark/http. It
+// keeps a number of keep-alive connections busy with GET requests, optionally
+// pipelined, for a fixed time, and prints the throughput and the percentiles
+// of the response latency as JSON. See benchmark/_http-benchmarkers.js.
+
+#include "http_parser.h"
+#include "uv.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Records values with a relative error of at most 1/2048, in the layout of an
+// HdrHistogram with three significant digits: values below kSubBuckets have a
+// bucket each, and every further power of two is split into kSubBuckets / 2
+// buckets.
+class Histogram {
+ public:
+  Histogram() : counts_(kSubBuckets + kMaxShift * kSubBuckets / 2),
+                total_(0),
+                sum_(0),
+                max_(0) {}
+
+  void Record(uint64_t value) {
+    counts_[Index(value)]++;
+    total_++;
+    sum_ += value;
+    if (value > max_)
+      max_ = value;
+  }
+
+  // The highest value that is equivalent to the one at |percentile|.
+  uint64_t Percentile(double percentile) const {
+    if (total_ == 0)
+      return 0;
+    uint64_t target = static_cast<uint64_t>(percentile / 100 * total_ + 0.5);
+    if (target == 0)
+      target = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+      seen += counts_[i];
+      if (seen >= target) {
+        const uint64_t highest = HighestEquivalent(i);
+        return highest < max_ ? highest : max_;
+      }
+    }
+    return max_;
+  }
+
+  double Mean() const {
+    return total_ == 0 ? 0 : static_cast<double>(sum_) / total_;
+  }
+
+  uint64_t max() const { return max_; }
+  uint64_t total() const { return total_; }
+
+ private:
+  static const int kSubBucketBits = 11;
+  static const uint64_t kSubBuckets = 1 << kSubBucketBits;
+  static const int kMaxShift = 64 - kSubBucketBits;
+
+  static size_t Index(uint64_t value) {
+    if (value < kSubBuckets)
+      return value;
+    int shift = 0;
+    while ((value >> shift) >= kSubBuckets)
+      shift++;
+    return shift * kSubBuckets / 2 + (value >> shift);
+  }
+
+  static uint64_t HighestEquivalent(size_t index) {
+    if (index < kSubBuckets)
+      return index;
+    const int shift = (index - kSubBuckets / 2) / (kSubBuckets / 2);
+    const uint64_t sub = index - shift * kSubBuckets / 2;
+    return ((sub + 1) << shift) - 1;
+  }
+
+  std::vector<uint64_t> counts_;
+  uint64_t total_;
+  uint64_t sum_;
+  uint64_t max_;
+};
+
+
+struct Options {
+  int connections = 100;
+  double duration = 10;
+  int pipelining = 1;
+  std::string host;
+  std::string port;
+  std::string path;
+};
+
+
+class Connection;
+
+class Runner {
+ public:
+  Runner(uv_loop_t* loop, const Options& options, const sockaddr* addr);
+  ~Runner();
+
+  void Start();
+  void Print() const;
+
+  uv_loop_t* loop() const { return loop_; }
+  const sockaddr* addr() const { return addr_; }
+  const std::string& request() const { return request_; }
+  int pipelining() const { return options_.pipelining; }
+  bool running() const { return running_; }
+
+  void OnResponse(uint64_t latency, int status) {
+    latency_.Record(latency);
+    if (status < 200 || status > 299)
+      non2xx_++;
+  }
+
+  void OnError() { errors_++; }
+
+ private:
+  static void OnTimer(uv_timer_t* timer);
+
+  uv_loop_t* loop_;
+  Options options_;
+  const sockaddr* addr_;
+  std::string request_;
+  std::vector<Connection*> connections_;
+  uv_timer_t timer_;
+  bool running_;
+  uint64_t start_;
+  uint64_t end_;
+  uint64_t errors_;
+  uint64_t non2xx_;
+  Histogram latency_;  // In microseconds.
+};
+
+
+class Connection {
+ public:
+  explicit Connection(Runner* runner) : runner_(runner) {}
+
+  void Connect() {
+    in_flight_.clear();
+    http_parser_init(&parser_, HTTP_RESPONSE);
+    parser_.data = this;
+    uv_tcp_init(runner_->loop(), &handle_);
+    handle_.data = this;
+    const int err = uv_tcp_connect(&connect_req_, &handle_, runner_->addr(),
+                                   OnConnect);
+    if (err != 0)
+      Fail();
+  }
+
+  void Close() {
+    if (!uv_is_closing(reinterpret_cast<uv_handle_t*>(&handle_)))
+      uv_close(reinterpret_cast<uv_handle_t*>(&handle_), OnClose);
+  }
+
+ private:
+  // Requests are only written while the benchmark runs. Each one gets its
+  // own start time, also when it is pipelined behind others.
+  void Send(int count) {
+    if (!runner_->running())
+      return;
+    std::vector<uv_buf_t> bufs(count);
+    const std::string& request = runner_->request();
+    const uint64_t now = uv_hrtime();
+    for (int i = 0; i < count; i++) {
+      bufs[i] = uv_buf_init(const_cast<char*>(request.data()),
+                            static_cast<unsigned int>(request.size()));
+      in_flight_.push_back(now);
+    }
+    uv_write_t* req = new uv_write_t;
+    req->data = this;
+    const int err = uv_write(req, reinterpret_cast<uv_stream_t*>(&handle_),
+                             bufs.data(), bufs.size(), OnWrite);
+    if (err != 0) {
+      delete req;
+      Fail();
+    }
+  }
+
+  // The server closed the connection or something went wrong. A new
+  // connection takes its place while the benchmark runs.
+  void Fail() {
+    runner_->OnError();
+    reconnect_ = true;
+    Close();
+  }
+
+  static void OnConnect(uv_connect_t* req, int status) {
+    Connection* conn = static_cast<Connection*>(req->handle->data);
+    if (status != 0)
+      return conn->Fail();
+    const int err = uv_read_start(req->handle, OnAlloc, OnRead);
+    if (err != 0)
+      return conn->Fail();
+    conn->Send(conn->runner_->pipelining());
+  }
+
+  static void OnWrite(uv_write_t* req, int status) {
+    Connection* conn = static_cast<Connection*>(req->data);
+    delete req;
+    if (status != 0 && status != UV_ECANCELED)
+      conn->Fail();
+  }
+
+  static void OnAlloc(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+    Connection* conn = static_cast<Connection*>(handle->data);
+    *buf = uv_buf_init(conn->read_buf_, sizeof(conn->read_buf_));
+  }
+
+  static void OnRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    Connection* conn = static_cast<Connection*>(stream->data);
+    if (nread < 0)
+      return conn->Fail();
+    const size_t parsed =
+        http_parser_execute(&conn->parser_, &settings_, buf->base, nread);
+    if (parsed != static_cast<size_t>(nread))
+      conn->Fail();
+  }
+
+  static void OnClose(uv_handle_t* handle) {
+    Connection* conn = static_cast<Connection*>(handle->data);
+    if (conn->reconnect_ && conn->runner_->running()) {
+      conn->reconnect_ = false;
+      conn->Connect();
+    }
+  }
+
+  static int OnMessageComplete(http_parser* parser) {
+    Connection* conn = static_cast<Connection*>(parser->data);
+    if (conn->in_flight_.empty())
+      return -1;
+    const uint64_t latency = (uv_hrtime() - conn->in_flight_.front()) / 1000;
+    conn->in_flight_.pop_front();
+    if (conn->runner_->running()) {
+      conn->runner_->OnResponse(latency, parser->status_code);
+      conn->Send(1);
+    }
+    return 0;
+  }
+
+  static const http_parser_settings settings_;
+
+  Runner* runner_;
+  uv_tcp_t handle_;
+  uv_connect_t connect_req_;
+  http_parser parser_;
+  std::deque<uint64_t> in_flight_;  // Start times of pending requests.
+  bool reconnect_ = false;
+  char read_buf_[64 * 1024];
+};
+
+
+const http_parser_settings Connection::settings_ = {
+  nullptr,  // on_message_begin
+  nullptr,  // on_url
+  nullptr,  // on_status
+  nullptr,  // on_header_field
+  nullptr,  // on_header_value
+  nullptr,  // on_headers_complete
+  nullptr,  // on_body
+  Connection::OnMessageComplete,
+  nullptr,  // on_chunk_header
+  nullptr   // on_chunk_complete
+};
+
+
+Runner::Runner(uv_loop_t* loop, const Options& options, const sockaddr* addr)
+    : loop_(loop),
+      options_(options),
+      addr_(addr),
+      running_(false),
+      start_(0),
+      end_(0),
+      errors_(0),
+      non2xx_(0) {
+  request_ = "GET " + options.path + " HTTP/1.1\r\n"
+             "Host: " + options.host + ":" + options.port + "\r\n"
+             "\r\n";
+}
+
+
+Runner::~Runner() {
+  for (Connection* conn : connections_)
+    delete conn;
+}
+
+
+void Runner::Start() {
+  uv_timer_init(loop_, &timer_);
+  timer_.data = this;
+  uv_timer_start(&timer_, OnTimer,
+                 static_cast<uint64_t>(options_.duration * 1000), 0);
+
+  running_ = true;
+  start_ = uv_hrtime();
+  for (int i = 0; i < options_.connections; i++) {
+    Connection* conn = new Connection(this);
+    connections_.push_back(conn);
+    conn->Connect();
+  }
+}
+
+
+void Runner::OnTimer(uv_timer_t* timer) {
+  Runner* runner = static_cast<Runner*>(timer->data);
+  runner->running_ = false;
+  runner->end_ = uv_hrtime();
+  for (Connection* conn : runner->connections_)
+    conn->Close();
+  uv_close(reinterpret_cast<uv_handle_t*>(timer), nullptr);
+}
+
+
+void Runner::Print() const {
+  const double duration = (end_ - start_) / 1e9;
+  printf("{\"requests\":%llu,\"duration\":%.3f,\"throughput\":%.2f,"
+         "\"errors\":%llu,\"non2xx\":%llu,"
+         "\"latency\":{\"mean\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,"
+         "\"p999\":%.3f,\"max\":%.3f}}\n",
+         static_cast<unsigned long long>(latency_.total()),  // NOLINT
+         duration,
+         latency_.total() / duration,
+         static_cast<unsigned long long>(errors_),  // NOLINT
+         static_cast<unsigned long long>(non2xx_),  // NOLINT
+         latency_.Mean() / 1000,
+         latency_.Percentile(50) / 1000.0,
+         latency_.Percentile(90) / 1000.0,
+         latency_.Percentile(99) / 1000.0,
+         latency_.Percentile(99.9) / 1000.0,
+         latency_.max() / 1000.0);
+}
+
+
+// Only http://host[:port][/path] is understood.
+bool ParseURL(const char* url, Options* options) {
+  const char kScheme[] = "http://";
+  if (strncmp(url, kScheme, sizeof(kScheme) - 1) != 0)
+    return false;
+  std::string rest(url + sizeof(kScheme) - 1);
+  const size_t slash = rest.find('/');
+  std::string authority = rest.substr(0, slash);
+  options->path = slash == std::string::npos ? "/" : rest.substr(slash);
+  const size_t colon = authority.rfind(':');
+  if (colon == std::string::npos) {
+    options->host = authority;
+    options->port = "80";
+  } else {
+    options->host = authority.substr(0, colon);
+    options->port = authority.substr(colon + 1);
+  }
+  return !options->host.empty() && !options->port.empty();
+}
+
+
+void PrintUsage(const char* argv0) {
+  fprintf(stderr,
+          "usage: %s [options] <url>\n"
+          "  -c <connections>  keep-alive connections to use (100)\n"
+          "  -d <duration>     seconds to run for (10)\n"
+          "  -p <pipelining>   requests in flight per connection (1)\n",
+          argv0);
+}
+
+}  // anonymous namespace
+
+
+int main(int argc, char** argv) {
+  Options options;
+  const char* url = nullptr;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    if (i + 1 < argc && strcmp(arg, "-c") == 0) {
+      options.connections = atoi(argv[++i]);
+    } else if (i + 1 < argc && strcmp(arg, "-d") == 0) {
+      options.duration = atof(argv[++i]);
+    } else if (i + 1 < argc && strcmp(arg, "-p") == 0) {
+      options.pipelining = atoi(argv[++i]);
+    } else if (url == nullptr && arg[0] != '-') {
+      url = arg;
+    } else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (url == nullptr ||
+      !ParseURL(url, &options) ||
+      options.connections < 1 ||
+      options.pipelining < 1 ||
+      options.duration <= 0) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  uv_loop_t* loop = uv_default_loop();
+
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  uv_getaddrinfo_t resolved;
+  int err = uv_getaddrinfo(loop, &resolved, nullptr, options.host.c_str(),
+                           options.port.c_str(), &hints);
+  if (err != 0) {
+    fprintf(stderr, "%s: %s\n", options.host.c_str(), uv_strerror(err));
+    return 1;
+  }
+
+  Runner runner(loop, options, resolved.addrinfo->ai_addr);
+  runner.Start();
+  uv_run(loop, UV_RUN_DEFAULT);
+  runner.Print();
+
+  uv_freeaddrinfo(resolved.addrinfo);
+  return 0;
+}
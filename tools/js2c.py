@@ -219,6 +219,41 @@ CHECK(target->Set(env->context(),
 """
 
 
+SOURCES_TEMPLATE = """
+// The sources of the core modules for tools/code_cache/mkcodecache.cc, as
+// UTF-8, the same as node_javascript.cc holds them.
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace node {{
+namespace code_cache {{
+
+struct NativeSource {{
+  const char* id;
+  const uint8_t* data;
+  size_t length;
+}};
+
+{definitions}
+
+static const NativeSource native_sources[] = {{
+{initializers}
+}};
+
+}}  // namespace code_cache
+}}  // namespace node
+"""
+
+SOURCE_DEFINITION = """
+static const uint8_t raw_{var}[] = {{ {data} }};
+"""
+
+SOURCE_INITIALIZER = """\
+  {{ "{name}", raw_{var}, sizeof(raw_{var}) }},
+"""
+
+
 def Render(var, data):
   # Treat non-ASCII as UTF-8 and convert it to UTF-16.
   if any(ord(c) > 127 for c in data):
@@ -232,7 +267,7 @@ def Render(var, data):
   return template.format(var=var, data=data)
 
 
-def JS2C(source, target):
+def JS2C(source, target, sources_only=False):
   modules = []
   consts = {}
   macros = {}
@@ -266,20 +301,32 @@ def JS2C(source, target):
     key = '%s_key' % var
     value = '%s_value' % var
 
+    if sources_only:
+      definitions.append(SOURCE_DEFINITION.format(var=value,
+                                                  data=ToCString(lines)))
+      initializers.append(SOURCE_INITIALIZER.format(name=name, var=value))
+      continue
+
     definitions.append(Render(key, name))
     definitions.append(Render(value, lines))
     initializers.append(INITIALIZER.format(key=key, value=value))
 
   # Emit result
+  template = SOURCES_TEMPLATE if sources_only else TEMPLATE
   output = open(str(target[0]), "w")
-  output.write(TEMPLATE.format(definitions=''.join(definitions),
+  output.write(template.format(definitions=''.join(definitions),
                                initializers=''.join(initializers)))
   output.close()
 
 def main():
+  # With --sources, writes the processed sources into a header for
+  # tools/code_cache/mkcodecache.cc instead of node_javascript.cc.
+  sources_only = sys.argv[1] == '--sources'
+  if sources_only:
+    del sys.argv[1]
   natives = sys.argv[1]
   source_files = sys.argv[2:]
-  JS2C(source_files, [natives])
+  JS2C(source_files, [natives], sources_only)
 
 if __name__ == "__main__":
   main()
@@ -0,0 +1,88 @@
+'use strict';
+
+// Packs a directory into an application archive for --app-archive, with the
+// V8 code caches of its .js files next to their sources. See
+// lib/internal/app_archive.js for the layout.
+//
+//   node tools/pack_app_archive.js app/ app.nar
+//   node --app-archive=app.nar app.nar
+//
+// The code caches only help the node binary that packed the archive, or one
+// with the same V8 that runs with the same V8 flags. Others compile the
+// sources without them. Native addons can't be loaded out of an archive.
+
+const fs = require('fs');
+const path = require('path');
+const vm = require('vm');
+const wrap = require('module').wrap;
+
+if (process.argv.length !== 4) {
+  console.error('Usage: node tools/pack_app_archive.js <directory> <archive>');
+  process.exit(1);
+}
+
+const MAGIC = 'NODEAR01';
+
+// What Module.prototype._compile() compiles of a file.
+function moduleSource(content) {
+  if (content.charCodeAt(0) === 0xFEFF)
+    content = content.slice(1);
+  if (content.startsWith('#!')) {
+    const end = content.search(/[\r\n]/);
+    content = end === -1 ? '' : content.slice(end);
+  }
+  return wrap(content);
+}
+
+function codeCache(filename, content) {
+  try {
+    const script = new vm.Script(moduleSource(content), {
+      filename,
+      produceCachedData: true
+    });
+    return script.cachedDataProduced ? script.cachedData : undefined;
+  } catch (e) {
+    console.error(`${filename}: not cached: ${e.message}`);
+    return undefined;
+  }
+}
+
+const source = path.resolve(process.argv[2]);
+const target = path.resolve(process.argv[3]);
+const files = {};
+const chunks = [];
+var offset = 0;
+
+function add(data) {
+  chunks.push(data);
+  offset += data.length;
+  return [offset - data.length, data.length];
+}
+
+function pack(dir, prefix) {
+  for (const name of fs.readdirSync(dir).sort()) {
+    const filename = path.join(dir, name);
+    if (filename === target)
+      continue;
+    const key = prefix + name;
+    if (fs.statSync(filename).isDirectory()) {
+      pack(filename, `${key}/`);
+      continue;
+    }
+    const data = fs.readFileSync(filename);
+    const entry = files[key] = add(data);
+    if (path.extname(name) === '.js') {
+      const cache = codeCache(path.join(target, key), data.toString('utf8'));
+      if (cache !== undefined)
+        entry.push(...add(cache));
+    }
+  }
+}
+
+pack(source, '');
+
+const index = Buffer.from(JSON.stringify({ wrapper: wrap(''), files }));
+const header = Buffer.alloc(MAGIC.length + 4);
+header.write(MAGIC, 0, 'latin1');
+header.writeUInt32LE(index.length, MAGIC.length);
+fs.writeFileSync(target, Buffer.concat([header, index].concat(chunks)));
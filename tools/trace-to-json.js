@@ -0,0 +1,212 @@
+'use strict';
+
+// Converts a trace event log written with `--trace-event-format binary` into
+// the JSON format that `chrome://tracing` reads. See
+// src/tracing/binary_trace_writer.h for a description of the binary format.
+//
+// Usage: node tools/trace-to-json.js node_trace.1.bin > node_trace.1.json
+
+const fs = require('fs');
+
+const MAGIC = 'NTRC';
+const VERSION = 1;
+
+const STRING_RECORD = 1;
+const EVENT_RECORD = 2;
+
+const TRACE_EVENT_FLAG_HAS_ID = 1 << 1;
+
+const TRACE_VALUE_TYPE_BOOL = 1;
+const TRACE_VALUE_TYPE_UINT = 2;
+const TRACE_VALUE_TYPE_INT = 3;
+const TRACE_VALUE_TYPE_DOUBLE = 4;
+const TRACE_VALUE_TYPE_POINTER = 5;
+const TRACE_VALUE_TYPE_STRING = 6;
+const TRACE_VALUE_TYPE_COPY_STRING = 7;
+const TRACE_VALUE_TYPE_CONVERTABLE = 8;
+
+function toHex(hi, lo) {
+  if (hi === 0)
+    return lo.toString(16);
+  return hi.toString(16) + ('0000000' + lo.toString(16)).slice(-8);
+}
+
+function convert(data) {
+  if (data.length < 5 || data.toString('latin1', 0, 4) !== MAGIC)
+    throw new Error('Not a binary trace event log');
+  if (data[4] !== VERSION)
+    throw new Error(`Unsupported binary trace version ${data[4]}`);
+
+  let pos = 5;
+  const strings = [null];
+  const traceEvents = [];
+  let ts = 0;
+  let tts = 0;
+
+  // Returns the high and low 32 bits of an unsigned varint.
+  function readVarint64() {
+    let lo = 0;
+    let hi = 0;
+    let shift = 0;
+    let byte;
+    do {
+      if (pos >= data.length)
+        throw new RangeError('Truncated record');
+      byte = data[pos++];
+      const bits = byte & 0x7f;
+      if (shift < 28) {
+        lo |= bits << shift;
+      } else if (shift === 28) {
+        lo |= (bits & 0x0f) << 28;
+        hi |= bits >>> 4;
+      } else {
+        hi |= bits << (shift - 32);
+      }
+      shift += 7;
+    } while (byte & 0x80);
+    return [hi >>> 0, lo >>> 0];
+  }
+
+  function readVarint() {
+    const [hi, lo] = readVarint64();
+    return hi * 0x100000000 + lo;
+  }
+
+  function readSignedVarint() {
+    const value = readVarint();
+    return value % 2 === 0 ? value / 2 : -(value + 1) / 2;
+  }
+
+  function readByte() {
+    if (pos >= data.length)
+      throw new RangeError('Truncated record');
+    return data[pos++];
+  }
+
+  function readBytes(length) {
+    if (pos + length > data.length)
+      throw new RangeError('Truncated record');
+    const str = data.toString('utf8', pos, pos + length);
+    pos += length;
+    return str;
+  }
+
+  function readString() {
+    const id = readVarint();
+    if (id >= strings.length)
+      throw new Error(`Unknown string id ${id}`);
+    return strings[id];
+  }
+
+  function readInlineString() {
+    const length = readVarint();
+    return length === 0 ? null : readBytes(length - 1);
+  }
+
+  function readDouble() {
+    if (pos + 8 > data.length)
+      throw new RangeError('Truncated record');
+    const value = data.readDoubleLE(pos);
+    pos += 8;
+    // Same as the JSON writer, which cannot write these as numbers.
+    if (Number.isNaN(value))
+      return 'NaN';
+    if (value === Infinity)
+      return 'Infinity';
+    if (value === -Infinity)
+      return '-Infinity';
+    return value;
+  }
+
+  function readArgValue(type) {
+    switch (type) {
+      case TRACE_VALUE_TYPE_BOOL:
+        return readByte() !== 0;
+      case TRACE_VALUE_TYPE_UINT:
+        return readVarint();
+      case TRACE_VALUE_TYPE_INT:
+        return readSignedVarint();
+      case TRACE_VALUE_TYPE_DOUBLE:
+        return readDouble();
+      case TRACE_VALUE_TYPE_POINTER:
+        return '0x' + toHex(...readVarint64());
+      case TRACE_VALUE_TYPE_STRING: {
+        const str = readString();
+        return str === null ? 'NULL' : str;
+      }
+      case TRACE_VALUE_TYPE_COPY_STRING: {
+        const str = readInlineString();
+        return str === null ? 'NULL' : str;
+      }
+      case TRACE_VALUE_TYPE_CONVERTABLE:
+        return JSON.parse(readInlineString());
+      default:
+        throw new Error(`Unknown argument type ${type}`);
+    }
+  }
+
+  function readEvent() {
+    const event = {};
+    event.ph = String.fromCharCode(readByte());
+    event.pid = readVarint();
+    event.tid = readVarint();
+    ts += readSignedVarint();
+    tts += readSignedVarint();
+    event.ts = ts;
+    event.tts = tts;
+    event.dur = readVarint();
+    event.tdur = readVarint();
+    event.cat = readString();
+    event.name = readString();
+    const flags = readVarint();
+    if (flags & TRACE_EVENT_FLAG_HAS_ID) {
+      const scope = readString();
+      if (scope !== null)
+        event.scope = scope;
+      event.id = '0x' + toHex(...readVarint64());
+    }
+    event.args = {};
+    const numArgs = readByte();
+    for (let i = 0; i < numArgs; i++) {
+      const name = readString();
+      event.args[name] = readArgValue(readByte());
+    }
+    return event;
+  }
+
+  while (pos < data.length) {
+    const start = pos;
+    try {
+      const tag = readByte();
+      if (tag === STRING_RECORD) {
+        const id = readVarint();
+        if (id !== strings.length)
+          throw new Error(`Unexpected string id ${id}`);
+        strings.push(readBytes(readVarint()));
+      } else if (tag === EVENT_RECORD) {
+        traceEvents.push(readEvent());
+      } else {
+        throw new Error(`Unknown record type ${tag} at offset ${start}`);
+      }
+    } catch (err) {
+      // The last record of a file that was still being written may be
+      // incomplete, everything before it is still good.
+      if (err instanceof RangeError)
+        break;
+      throw err;
+    }
+  }
+
+  return { traceEvents };
+}
+
+module.exports = convert;
+
+if (require.main === module) {
+  if (process.argv.length !== 3) {
+    console.error('Usage: node trace-to-json.js <binary trace file>');
+    process.exit(1);
+  }
+  const result = convert(fs.readFileSync(process.argv[2]));
+  process.stdout.write(JSON.stringify(result));
+}